@@ -82,7 +82,7 @@ endif
 
 # Add arch-specific dependencies for the library to ensure the library is built.
 # Use the $(LIBNAME)_BUILDDIR as build directory, if set.
-$$(notdir $(1))_BUILDDIR ?= $(1)/build
+$$(notdir $(1))_BUILDDIR ?= $(1)/build$$(call OPT_BUILDDIR_SUFFIX_FN,$$(or $$($(notdir $(1))_OPT_PROFILE),$$(OPT_PROFILE)))
 $$(foreach arch, $$(TOCK_ARCHS), $$(eval LIBS_$$(arch) += $$($(notdir $(1))_BUILDDIR)/$$(arch)/$(notdir $(1)).a))
 
 # Generate rule for building the library.
@@ -164,6 +164,22 @@ OBJS_$(1) += $$(patsubst %.cc,$$(BUILDDIR)/$(1)/%.o,$$(filter %.cc, $$(CXX_SRCS)
 OBJS_$(1) += $$(patsubst %.cpp,$$(BUILDDIR)/$(1)/%.o,$$(filter %.cpp, $$(CXX_SRCS)))
 OBJS_$(1) += $$(patsubst %.cxx,$$(BUILDDIR)/$(1)/%.o,$$(filter %.cxx, $$(CXX_SRCS)))
 
+# Per-object size report. Set `SIZE_BASELINE` to the build directory of an
+# earlier build, e.g. one copied aside before changing `OPT_PROFILE`, to print
+# what changed instead.
+.PHONY: size-objects-$(1)
+size-objects-$(1): $$(OBJS_$(1)) $$(LIBS_$(1)) | $$(BUILDDIR)/$(1)
+	$$(Q)$$(TOOLCHAIN_$(1))$$(SIZE) $$^ > $$(BUILDDIR)/$(1)/objects.size
+ifdef SIZE_BASELINE
+	@echo Object size changes for $(1) since $$(SIZE_BASELINE):
+	$$(Q)$$(TOCK_USERLAND_BASE_DIR)/tools/size_diff.py $$(SIZE_BASELINE)/$(1)/objects.size $$(BUILDDIR)/$(1)/objects.size
+else
+	@echo Object sizes for $(1):
+	$$(Q)cat $$(BUILDDIR)/$(1)/objects.size
+endif
+
+size-objects:: size-objects-$(1)
+
 endef
 
 
@@ -357,6 +373,9 @@ all:	$(BUILDDIR)/$(PACKAGE_NAME).tab $(SIZE_RULES)
 # The size target accumulates dependencies in the platform build rule creation
 .PHONY: size
 
+# Per-object sizes for each architecture, see `size-objects-<arch>`.
+.PHONY: size-objects
+
 # Generate helpful output for debugging userland applications.
 .PHONY: debug
 debug:	$(foreach platform, $(TOCK_TARGETS), $(BUILDDIR)/$(call ARCH_FN,$(platform))/$(call OUTPUT_NAME_FN,$(platform)).userland_debug.lst)
@@ -146,6 +146,81 @@ else
 endif
 
 
+# Optimization profile.
+#
+# `OPT_PROFILE` selects the optimization flags for every app and library:
+#
+# - `size` (default): `-Os`, the smallest code.
+# - `balanced`: `-O2` without inlining functions that are not marked `inline`,
+#   most of the speed of `speed` for less code growth.
+# - `speed`: `-O2`.
+#
+# A single library can use a different profile by setting
+# `<library>_OPT_PROFILE`, for example `libtock_OPT_PROFILE=speed` or
+# `lvgl_OPT_PROFILE=speed`. Libraries outside libtock and libtock-sync are
+# built by a separate make invocation, so their override must be given on the
+# command line or in the library's Makefile. A library built with anything but
+# the default flags goes to its own build directory, e.g. `build-speed/`, so
+# switching profiles never links objects built for another one.
+#
+# Setting `LTO=1` additionally enables link-time optimization. This needs a GCC
+# toolchain, which provides the `gcc-ar` archiver wrappers.
+OPT_PROFILE ?= size
+
+OPT_FLAGS_size     := -Os
+OPT_FLAGS_balanced := -O2 -fno-inline-functions
+OPT_FLAGS_speed    := -O2
+
+ifeq ($(OPT_FLAGS_$(OPT_PROFILE)),)
+  $(error Unknown OPT_PROFILE "$(OPT_PROFILE)", use size, balanced or speed)
+endif
+
+# Suffix for the build directory of a library built with profile $(1).
+OPT_BUILDDIR_SUFFIX_FN = $(if $(filter-out size,$(1))$(LTO),-$(1)$(if $(LTO),-lto))
+
+ifneq ($(LTO),)
+  override CPPFLAGS += -flto
+  override WLFLAGS  += -flto
+  # Archives of LTO objects need the linker plugin to build their index.
+  AR     := -gcc-ar
+  RANLIB := -gcc-ranlib
+endif
+
+# Newlib variant.
+#
+# `NEWLIB_VARIANT=speed` links the targets that benefit, Cortex-M3/M4/M7 and
+# rv32imac, against a newlib built with `-O2`, which has newlib's word-wise
+# and assembly `memcpy`, `memset`, `strlen` and friends instead of the
+# byte-at-a-time versions the default `-Os` build uses. Smaller cores keep the
+# default build, and the headers are the same either way. The variant is
+# built with `make -C newlib NEWLIB_VARIANT=speed` and is expected in
+# `lib/libtock-newlib-<version>-speed`.
+#
+# Hard-float variants are not offered: the kernel does not preserve FPU
+# registers across context switches, so apps must use the soft-float ABI.
+NEWLIB_VARIANT ?=
+ifeq ($(NEWLIB_VARIANT),)
+  NEWLIB_VARIANT_SUFFIX :=
+else ifeq ($(NEWLIB_VARIANT),speed)
+  NEWLIB_VARIANT_SUFFIX := -speed
+else
+  $(error Unknown NEWLIB_VARIANT "$(NEWLIB_VARIANT)", use speed or leave it empty)
+endif
+
+# Per-app libtock configuration.
+#
+# `LIBTOCK_CONFIG` names a header of build-time options, see
+# `libtock/config.h`. It is passed to everything the app builds, and libtock
+# and libtock-sync are rebuilt with it in the `build/` directory next to the
+# header instead of using their shared build.
+ifneq ($(LIBTOCK_CONFIG),)
+  LIBTOCK_CONFIG_PATH := $(abspath $(LIBTOCK_CONFIG))
+  ifeq ($(wildcard $(LIBTOCK_CONFIG_PATH)),)
+    $(error LIBTOCK_CONFIG "$(LIBTOCK_CONFIG)" does not exist)
+  endif
+  override CPPFLAGS += -DLIBTOCK_CONFIG_FILE=\"$(LIBTOCK_CONFIG_PATH)\"
+endif
+
 # Flags for building app Assembly, C, and C++ files used by all architectures.
 # n.b. CPPFLAGS are shared for C and C++ sources (it's short for C PreProcessor,
 # and C++ uses the C preprocessor). To specify flags for only C or C++, use
@@ -159,7 +234,7 @@ override CFLAGS  += -std=gnu11
 override CPPFLAGS += \
       -frecord-gcc-switches\
       -gdwarf-2\
-      -Os\
+      $(OPT_FLAGS_$(OPT_PROFILE))\
       -fdata-sections -ffunction-sections\
       -fstack-usage\
       -D_FORTIFY_SOURCE=2\
@@ -260,6 +335,7 @@ NEWLIB_VERSION_rv32i    := $(NEWLIB_VERSION_rv32)
 NEWLIB_VERSION_rv32imc  := $(NEWLIB_VERSION_rv32)
 NEWLIB_VERSION_rv32imac := $(NEWLIB_VERSION_rv32)
 NEWLIB_BASE_DIR_rv32 := $(TOCK_USERLAND_BASE_DIR)/lib/libtock-newlib-$(NEWLIB_VERSION_rv32)
+NEWLIB_TUNED_DIR_rv32 := $(NEWLIB_BASE_DIR_rv32)$(NEWLIB_VARIANT_SUFFIX)
 
 # Match compiler version to supported libtock-libc++ versions.
 ifeq ($(CC_rv32_version_major),10)
@@ -348,8 +424,8 @@ override SYSTEM_LIBS_CXX_rv32imc += \
       $(LIBCPP_BASE_DIR_rv32)/riscv/lib/gcc/riscv64-unknown-elf/$(LIBCPP_VERSION_rv32)/rv32im/ilp32/libgcc.a
 
 override SYSTEM_LIBS_rv32imac += \
-      $(NEWLIB_BASE_DIR_rv32)/riscv/riscv64-unknown-elf/lib/rv32imac/ilp32/libc.a \
-      $(NEWLIB_BASE_DIR_rv32)/riscv/riscv64-unknown-elf/lib/rv32imac/ilp32/libm.a
+      $(NEWLIB_TUNED_DIR_rv32)/riscv/riscv64-unknown-elf/lib/rv32imac/ilp32/libc.a \
+      $(NEWLIB_TUNED_DIR_rv32)/riscv/riscv64-unknown-elf/lib/rv32imac/ilp32/libm.a
 
 override SYSTEM_LIBS_CXX_rv32imac += \
       $(LIBCPP_BASE_DIR_rv32)/riscv/riscv64-unknown-elf/lib/rv32imac/ilp32/libstdc++.a \
@@ -401,6 +477,7 @@ NEWLIB_VERSION_cortex-m3 := $(NEWLIB_VERSION_cortex-m)
 NEWLIB_VERSION_cortex-m4 := $(NEWLIB_VERSION_cortex-m)
 NEWLIB_VERSION_cortex-m7 := $(NEWLIB_VERSION_cortex-m)
 NEWLIB_BASE_DIR_cortex-m := $(TOCK_USERLAND_BASE_DIR)/lib/libtock-newlib-$(NEWLIB_VERSION_cortex-m)
+NEWLIB_TUNED_DIR_cortex-m := $(NEWLIB_BASE_DIR_cortex-m)$(NEWLIB_VARIANT_SUFFIX)
 
 # Match compiler version to supported libtock-libc++ versions.
 ifeq ($(CC_cortex-m_version_major),10)
@@ -469,8 +546,8 @@ override SYSTEM_LIBS_CXX_cortex-m0 += \
       $(LIBCPP_BASE_DIR_cortex-m)/arm/lib/gcc/arm-none-eabi/$(LIBCPP_VERSION_cortex-m)/thumb/v6-m/nofp/libgcc.a
 
 override SYSTEM_LIBS_cortex-m3 += \
-      $(NEWLIB_BASE_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7-m/nofp/libc.a \
-      $(NEWLIB_BASE_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7-m/nofp/libm.a
+      $(NEWLIB_TUNED_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7-m/nofp/libc.a \
+      $(NEWLIB_TUNED_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7-m/nofp/libm.a
 
 override SYSTEM_LIBS_CXX_cortex-m3 += \
       $(LIBCPP_BASE_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7-m/nofp/libstdc++.a \
@@ -478,8 +555,8 @@ override SYSTEM_LIBS_CXX_cortex-m3 += \
       $(LIBCPP_BASE_DIR_cortex-m)/arm/lib/gcc/arm-none-eabi/$(LIBCPP_VERSION_cortex-m)/thumb/v7-m/nofp/libgcc.a
 
 override SYSTEM_LIBS_cortex-m4 += \
-      $(NEWLIB_BASE_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7e-m/nofp/libc.a \
-      $(NEWLIB_BASE_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7e-m/nofp/libm.a
+      $(NEWLIB_TUNED_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7e-m/nofp/libc.a \
+      $(NEWLIB_TUNED_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7e-m/nofp/libm.a
 
 override SYSTEM_LIBS_CXX_cortex-m4 += \
       $(LIBCPP_BASE_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7e-m/nofp/libstdc++.a \
@@ -487,8 +564,8 @@ override SYSTEM_LIBS_CXX_cortex-m4 += \
       $(LIBCPP_BASE_DIR_cortex-m)/arm/lib/gcc/arm-none-eabi/$(LIBCPP_VERSION_cortex-m)/thumb/v7e-m/nofp/libgcc.a
 
 override SYSTEM_LIBS_cortex-m7 += \
-      $(NEWLIB_BASE_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7e-m/nofp/libc.a \
-      $(NEWLIB_BASE_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7e-m/nofp/libm.a
+      $(NEWLIB_TUNED_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7e-m/nofp/libc.a \
+      $(NEWLIB_TUNED_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7e-m/nofp/libm.a
 
 override SYSTEM_LIBS_CXX_cortex-m7 += \
       $(LIBCPP_BASE_DIR_cortex-m)/arm/arm-none-eabi/lib/thumb/v7e-m/nofp/libstdc++.a \
@@ -34,7 +34,14 @@ ifeq ($(strip $($(LIBNAME)_SRCS)),)
 endif
 
 # directory for built output
-$(LIBNAME)_BUILDDIR := $($(LIBNAME)_DIR)/build
+#
+# libtock and libtock-sync built for an app's `LIBTOCK_CONFIG` are specific to
+# that app, so they go next to its configuration header.
+ifneq ($(and $(LIBTOCK_CONFIG_PATH),$(filter libtock libtock-sync,$(LIBNAME))),)
+  $(LIBNAME)_BUILDDIR := $(dir $(LIBTOCK_CONFIG_PATH))build/$(LIBNAME)$(call OPT_BUILDDIR_SUFFIX_FN,$(or $($(LIBNAME)_OPT_PROFILE),$(OPT_PROFILE)))
+else
+  $(LIBNAME)_BUILDDIR := $($(LIBNAME)_DIR)/build$(call OPT_BUILDDIR_SUFFIX_FN,$(or $($(LIBNAME)_OPT_PROFILE),$(OPT_PROFILE)))
+endif
 
 # Handle complex paths.
 #
@@ -98,6 +105,16 @@ endef
 # actually generate the rules
 $(foreach hdrdir,$($(LIBNAME)_SRCS_DIRS),$(eval $(call LIB_HEADER_INCLUDES,$(hdrdir))))
 
+# Per-library optimization profile, see `OPT_PROFILE` in Configuration.mk.
+# These flags follow the global ones on the command line, so their `-O` wins.
+ifdef $(LIBNAME)_OPT_PROFILE
+  ifeq ($(OPT_FLAGS_$($(LIBNAME)_OPT_PROFILE)),)
+    $(error Unknown $(LIBNAME)_OPT_PROFILE "$($(LIBNAME)_OPT_PROFILE)", use size, balanced or speed)
+  endif
+  # Expand now, LIBNAME changes when the next library is included.
+  $(eval CPPFLAGS_$(LIBNAME) += $(OPT_FLAGS_$($(LIBNAME)_OPT_PROFILE)))
+endif
+
 # Rules to generate libraries for a given Architecture
 # These will be used to create the different architecture versions of libraries.
 #
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libtock/services/alarm.h>
+#include <libtock/services/time.h>
+#include <libtock/tock.h>
+
+// Samples collected per scenario.
+#define SAMPLES 200
+
+// Alarms outstanding at once in the concurrent scenario.
+#define CONCURRENT 32
+
+static uint32_t samples[SAMPLES];
+static int sample_count;
+
+static void record(uint32_t now, uint32_t scheduled) {
+  if (sample_count < SAMPLES) {
+    samples[sample_count++] = now - scheduled;
+  }
+}
+
+static int cmp_u32(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*) a;
+  uint32_t y = *(const uint32_t*) b;
+  return (x > y) - (x < y);
+}
+
+static void report(const char* name) {
+  qsort(samples, sample_count, sizeof(samples[0]), cmp_u32);
+
+  uint64_t total = 0;
+  for (int i = 0; i < sample_count; i++) {
+    total += samples[i];
+  }
+  uint32_t min = samples[0];
+  uint32_t max = samples[sample_count - 1];
+  uint32_t avg = (uint32_t) (total / sample_count);
+  uint32_t p99 = samples[(sample_count * 99) / 100];
+
+  printf("%-10s n=%-3d min %4lu avg %4lu p99 %4lu max %4lu ticks (max %lu us)\n",
+         name, sample_count,
+         (unsigned long) min, (unsigned long) avg, (unsigned long) p99, (unsigned long) max,
+         (unsigned long) libtock_time_ticks_to_us64(max));
+}
+
+// One-shot: arm a single alarm, wait for it, repeat.
+static bool oneshot_fired;
+
+static void oneshot_cb(uint32_t now, uint32_t scheduled, __attribute__ ((unused)) void* opaque) {
+  record(now, scheduled);
+  oneshot_fired = true;
+}
+
+static void bench_oneshot(void) {
+  libtock_alarm_t alarm;
+  sample_count = 0;
+  for (int i = 0; i < SAMPLES; i++) {
+    oneshot_fired = false;
+    libtock_alarm_in_ms(2 + (i % 5), oneshot_cb, NULL, &alarm);
+    yield_for(&oneshot_fired);
+  }
+  report("one-shot");
+}
+
+// Repeating: a single periodic alarm.
+static void repeating_cb(uint32_t now, uint32_t scheduled, __attribute__ ((unused)) void* opaque) {
+  record(now, scheduled);
+}
+
+static void bench_repeating(void) {
+  libtock_alarm_t alarm;
+  sample_count = 0;
+  libtock_alarm_repeating_every_ms(5, repeating_cb, NULL, &alarm);
+  while (sample_count < SAMPLES) {
+    yield();
+  }
+  libtock_alarm_ms_cancel(&alarm);
+  report("repeating");
+}
+
+// Concurrent: many alarms outstanding at once with nearby expirations, each
+// re-armed as soon as it fires.
+static libtock_alarm_t concurrent[CONCURRENT];
+static uint32_t lcg_state = 1;
+
+static uint32_t lcg_next(void) {
+  lcg_state = lcg_state * 1664525 + 1013904223;
+  return lcg_state;
+}
+
+static void concurrent_cb(uint32_t now, uint32_t scheduled, void* opaque) {
+  record(now, scheduled);
+  if (sample_count < SAMPLES) {
+    libtock_alarm_in_ms(1 + (lcg_next() % 20), concurrent_cb, opaque, (libtock_alarm_t*) opaque);
+  }
+}
+
+static void bench_concurrent(void) {
+  sample_count = 0;
+  for (int i = 0; i < CONCURRENT; i++) {
+    libtock_alarm_in_ms(1 + (lcg_next() % 20), concurrent_cb, &concurrent[i], &concurrent[i]);
+  }
+  while (sample_count < SAMPLES) {
+    yield();
+  }
+  for (int i = 0; i < CONCURRENT; i++) {
+    libtock_alarm_ms_cancel(&concurrent[i]);
+  }
+  report("concurrent");
+}
+
+int main(void) {
+  printf("Alarm latency benchmark (%lu Hz clock, scheduled -> fired)\n",
+         (unsigned long) libtock_time_frequency());
+  bench_oneshot();
+  bench_repeating();
+  bench_concurrent();
+  return 0;
+}
@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock-sync/crypto/aes.h>
+#include <libtock-sync/crypto/hmac.h>
+#include <libtock-sync/crypto/sha.h>
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+#include <libtock/services/time.h>
+
+#define MIN_SIZE 16
+#define MAX_SIZE 16384
+// Sizes measured, doubling from MIN_SIZE to MAX_SIZE.
+#define SIZES 11
+// Chunk the AES driver is fed in, through a double-buffered stream.
+#define AES_CHUNK 1024
+
+#if LIBTOCK_SHA_SOFT_THRESHOLD != 0 || LIBTOCK_HMAC_SOFT_THRESHOLD != 0 || LIBTOCK_AES_SOFT_THRESHOLD != 0
+#error Build the benchmark without the software thresholds so it measures the kernel drivers.
+#endif
+
+static uint8_t data[MAX_SIZE];
+static uint8_t work[4 * AES_CHUNK];
+static uint8_t hash[32];
+
+static const uint8_t key[16] = {
+  0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+static const uint8_t iv[16] = {
+  0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+
+static uint32_t now(void) {
+  uint32_t ticks;
+  libtock_alarm_command_read(&ticks);
+  return ticks;
+}
+
+static returncode_t sha_kernel(uint32_t len) {
+  return libtocksync_sha_simple_hash(LIBTOCK_SHA256, data, len, hash, sizeof(hash));
+}
+
+static returncode_t sha_soft(uint32_t len) {
+  libtock_sha256_soft(data, len, hash);
+  return RETURNCODE_SUCCESS;
+}
+
+static returncode_t hmac_kernel(uint32_t len) {
+  return libtocksync_hmac_simple(LIBTOCK_HMAC_SHA256, (uint8_t*) key, sizeof(key), data, len, hash, sizeof(hash));
+}
+
+// What the software HMAC costs: the padded key block through the inner and
+// outer hashes around the message.
+static returncode_t hmac_soft(uint32_t len) {
+  libtock_sha256_soft_t sha;
+  libtock_sha256_soft_init(&sha);
+  libtock_sha256_soft_update(&sha, data, LIBTOCK_SHA256_SOFT_BLOCK);
+  libtock_sha256_soft_update(&sha, data, len);
+  libtock_sha256_soft_finish(&sha, hash);
+  libtock_sha256_soft_init(&sha);
+  libtock_sha256_soft_update(&sha, data, LIBTOCK_SHA256_SOFT_BLOCK);
+  libtock_sha256_soft_update(&sha, hash, sizeof(hash));
+  libtock_sha256_soft_finish(&sha, hash);
+  return RETURNCODE_SUCCESS;
+}
+
+// The AES driver is fed from `data` through a stream; the output is
+// discarded.
+static uint32_t aes_offset;
+static uint32_t aes_len;
+
+static uint32_t aes_fill(uint8_t* buf, uint32_t len, __attribute__ ((unused)) void* opaque) {
+  uint32_t n = aes_len - aes_offset < len ? aes_len - aes_offset : len;
+  memcpy(buf, data + aes_offset, n);
+  aes_offset += n;
+  return n;
+}
+
+static void aes_drain(__attribute__ ((unused)) const uint8_t* buf, __attribute__ ((unused)) uint32_t len,
+                      __attribute__ ((unused)) void* opaque) {}
+
+static returncode_t aes_kernel(libtock_aes_algorithm_t operation, uint32_t len) {
+  aes_offset = 0;
+  aes_len    = len;
+  uint32_t chunk = len < AES_CHUNK ? len : AES_CHUNK;
+  return libtocksync_aes_stream(operation, true, key, iv, work, chunk, aes_fill, aes_drain, NULL);
+}
+
+static returncode_t ctr_kernel(uint32_t len) {
+  return aes_kernel(LIBTOCK_AES128Ctr, len);
+}
+
+static returncode_t cbc_kernel(uint32_t len) {
+  return aes_kernel(LIBTOCK_AES128CBC, len);
+}
+
+static returncode_t ecb_kernel(uint32_t len) {
+  return aes_kernel(LIBTOCK_AES128ECB, len);
+}
+
+// In place in software, including the key expansion each call as the
+// driver does.
+static returncode_t aes_soft(libtock_aes_algorithm_t operation, uint32_t len) {
+  libtock_aes128_soft_t ctx;
+  uint8_t chain[16];
+  memcpy(chain, iv, sizeof(chain));
+  libtock_aes128_soft_init(&ctx, key);
+  switch (operation) {
+    case LIBTOCK_AES128Ctr:
+      libtock_aes128_soft_ctr(&ctx, chain, data, data, len);
+      break;
+    case LIBTOCK_AES128CBC:
+      libtock_aes128_soft_cbc(&ctx, true, chain, data, data, len);
+      break;
+    default:
+      libtock_aes128_soft_ecb(&ctx, true, data, data, len);
+      break;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+static returncode_t ctr_soft(uint32_t len) {
+  return aes_soft(LIBTOCK_AES128Ctr, len);
+}
+
+static returncode_t cbc_soft(uint32_t len) {
+  return aes_soft(LIBTOCK_AES128CBC, len);
+}
+
+static returncode_t ecb_soft(uint32_t len) {
+  return aes_soft(LIBTOCK_AES128ECB, len);
+}
+
+typedef struct {
+  const char* name;
+  // Threshold macro the crossover is reported for.
+  const char* macro;
+  bool (*exists)(void);
+  returncode_t (*kernel)(uint32_t len);
+  returncode_t (*soft)(uint32_t len);
+} primitive_t;
+
+static const primitive_t primitives[] = {
+  { "sha256", "LIBTOCK_SHA_SOFT_THRESHOLD", libtock_sha_exists, sha_kernel, sha_soft },
+  { "hmac_sha256", "LIBTOCK_HMAC_SOFT_THRESHOLD", libtock_hmac_exists, hmac_kernel, hmac_soft },
+  { "aes128_ctr", "LIBTOCK_AES_SOFT_THRESHOLD", libtock_aes_exists, ctr_kernel, ctr_soft },
+  { "aes128_cbc", "LIBTOCK_AES_SOFT_THRESHOLD", libtock_aes_exists, cbc_kernel, cbc_soft },
+  { "aes128_ecb", "LIBTOCK_AES_SOFT_THRESHOLD", libtock_aes_exists, ecb_kernel, ecb_soft },
+};
+
+// Average nanoseconds per call at each size, for the fit.
+static uint64_t avg_ns[SIZES];
+
+// Calls timed at `len`: enough to cover the timer resolution for small
+// messages without taking long for large ones.
+static int calls_for(uint32_t len) {
+  return len <= 1024 ? 32 : 8;
+}
+
+// Time `op` at every size and print a row for each. Returns false if the
+// operation failed.
+static bool measure(const char* name, const char* impl, returncode_t (*op)(uint32_t)) {
+  int i = 0;
+  for (uint32_t len = MIN_SIZE; len <= MAX_SIZE; len *= 2, i++) {
+    int calls      = calls_for(len);
+    uint32_t min   = UINT32_MAX;
+    uint32_t max   = 0;
+    uint32_t first = now();
+    for (int c = 0; c < calls; c++) {
+      uint32_t start = now();
+      returncode_t ret = op(len);
+      uint32_t ticks   = now() - start;
+      if (ret != RETURNCODE_SUCCESS) {
+        printf("# %s %s failed at %lu bytes: %s\n", name, impl, (unsigned long) len, tock_strrcode(ret));
+        return false;
+      }
+      if (ticks < min) min = ticks;
+      if (ticks > max) max = ticks;
+    }
+    uint64_t total_us = libtock_time_ticks_to_us64(now() - first);
+    avg_ns[i] = total_us * 1000 / calls;
+
+    uint64_t kib_per_s = total_us == 0 ? 0 : (uint64_t) len * calls * 1000000 / 1024 / total_us;
+    printf("%s,%s,%lu,%d,%lu,%lu,%lu,%lu\n", name, impl, (unsigned long) len, calls, (unsigned long) kib_per_s,
+           (unsigned long) libtock_time_ticks_to_us64(min), (unsigned long) (avg_ns[i] / 1000),
+           (unsigned long) libtock_time_ticks_to_us64(max));
+  }
+  return true;
+}
+
+// Least squares fit of the average time against size, splitting it into a
+// fixed cost per call and a cost per byte.
+static void fit(const char* name, const char* impl, int64_t* setup_ns, int64_t* byte_ps) {
+  double mean_n = 0, mean_t = 0;
+  double n[SIZES];
+  for (int i = 0; i < SIZES; i++) {
+    n[i]    = (double) (MIN_SIZE << i);
+    mean_n += n[i] / SIZES;
+    mean_t += (double) avg_ns[i] / SIZES;
+  }
+  double cov = 0, var = 0;
+  for (int i = 0; i < SIZES; i++) {
+    cov += (n[i] - mean_n) * ((double) avg_ns[i] - mean_t);
+    var += (n[i] - mean_n) * (n[i] - mean_n);
+  }
+  double slope = cov / var;
+  *setup_ns = (int64_t) (mean_t - slope * mean_n);
+  *byte_ps  = (int64_t) (slope * 1000);
+  printf("# %s %s: %ld us per call + %ld ns per byte\n", name, impl, (long) (*setup_ns / 1000),
+         (long) (*byte_ps / 1000));
+}
+
+// Compare the two fits: below the returned size software is faster.
+static uint32_t crossover(int64_t kernel_setup, int64_t kernel_byte, int64_t soft_setup, int64_t soft_byte) {
+  if (soft_setup >= kernel_setup) return 0;
+  if (soft_byte <= kernel_byte) return MAX_SIZE;
+  int64_t n = (kernel_setup - soft_setup) * 1000 / (soft_byte - kernel_byte);
+  return n > MAX_SIZE ? MAX_SIZE : (uint32_t) n;
+}
+
+int main(void) {
+  for (int i = 0; i < MAX_SIZE; i++) {
+    data[i] = i * 7;
+  }
+
+  printf("# Crypto benchmark, kernel drivers against software\n");
+  printf("op,impl,size,calls,kib_per_s,min_us,avg_us,max_us\n");
+  for (unsigned p = 0; p < sizeof(primitives) / sizeof(primitives[0]); p++) {
+    const primitive_t* prim = &primitives[p];
+    int64_t soft_setup, soft_byte, kernel_setup, kernel_byte;
+
+    measure(prim->name, "soft", prim->soft);
+    fit(prim->name, "soft", &soft_setup, &soft_byte);
+    if (!prim->exists()) {
+      printf("# %s: no driver, software is always used\n", prim->name);
+      continue;
+    }
+    if (!measure(prim->name, "kernel", prim->kernel)) continue;
+    fit(prim->name, "kernel", &kernel_setup, &kernel_byte);
+    printf("# %s: CFLAGS += -D%s=%lu\n", prim->name, prim->macro,
+           (unsigned long) crossover(kernel_setup, kernel_byte, soft_setup, soft_byte));
+  }
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock-sync/display/screen.h>
+#include <libtock/services/time.h>
+
+#include <lvgl-tock.h>
+#include <lvgl/lvgl.h>
+
+// Screen lines written per `write` in the full-frame test.
+#define BAND_LINES 8
+// Side of the square written in the partial-update test.
+#define PARTIAL 32
+#define FILLS 10
+#define FRAMES 5
+#define PARTIALS 50
+#define LVGL_FRAMES 20
+
+static uint8_t* buffer;
+static uint32_t buffer_len;
+static uint32_t width, height;
+
+static uint32_t elapsed_us(uint64_t start) {
+  return (uint32_t) (libtock_time_now_us64() - start);
+}
+
+// Time to fill the whole screen with one color.
+static uint32_t bench_fill(void) {
+  uint64_t start = libtock_time_now_us64();
+  for (int i = 0; i < FILLS; i++) {
+    libtocksync_screen_set_frame(0, 0, width, height);
+    libtocksync_screen_fill(buffer, buffer_len, i & 1 ? 0xFFFF : 0);
+  }
+  return elapsed_us(start) / FILLS;
+}
+
+// Time to write every pixel of the screen from RAM, a band of lines at a time.
+static uint32_t bench_frame(int bits) {
+  uint32_t band_bytes = width * BAND_LINES * bits / 8;
+  uint64_t start      = libtock_time_now_us64();
+  for (int i = 0; i < FRAMES; i++) {
+    memset(buffer, i & 1 ? 0xFF : 0x00, band_bytes);
+    for (uint32_t y = 0; y < height; y += BAND_LINES) {
+      uint32_t lines = height - y < BAND_LINES ? height - y : BAND_LINES;
+      libtocksync_screen_set_frame(0, y, width, lines);
+      libtocksync_screen_write(buffer, buffer_len, width * lines * bits / 8);
+    }
+  }
+  return elapsed_us(start) / FRAMES;
+}
+
+// Time to write a small square, as for a widget update.
+static uint32_t bench_partial(int bits) {
+  uint32_t bytes = PARTIAL * PARTIAL * bits / 8;
+  uint64_t start = libtock_time_now_us64();
+  for (int i = 0; i < PARTIALS; i++) {
+    uint16_t x = (i * 7) % (width - PARTIAL + 1);
+    uint16_t y = (i * 5) % (height - PARTIAL + 1);
+    libtocksync_screen_set_frame(x, y, PARTIAL, PARTIAL);
+    libtocksync_screen_write(buffer, buffer_len, bytes);
+  }
+  return elapsed_us(start) / PARTIALS;
+}
+
+// Frames per second, times 10, of lvgl redrawing the whole screen through the
+// double-buffered port.
+static uint32_t bench_lvgl(void) {
+  if (lvgl_tock_init(10) != RETURNCODE_SUCCESS) return 0;
+
+  lv_obj_t* scr   = lv_disp_get_scr_act(NULL);
+  lv_obj_t* label = lv_label_create(scr);
+  lv_obj_center(label);
+  lv_refr_now(NULL);
+
+  uint64_t start = libtock_time_now_us64();
+  for (int i = 0; i < LVGL_FRAMES; i++) {
+    lv_label_set_text_fmt(label, "Frame %d", i);
+    lv_obj_invalidate(scr);
+    lv_refr_now(NULL);
+  }
+  uint32_t us = elapsed_us(start);
+  return us == 0 ? 0 : (uint32_t) (LVGL_FRAMES * 10000000ULL / us);
+}
+
+int main(void) {
+  if (libtock_screen_get_resolution(&width, &height) != RETURNCODE_SUCCESS || width < PARTIAL ||
+      height < PARTIAL) {
+    printf("No usable screen\n");
+    return -1;
+  }
+  // Big enough for a band of 32-bit pixels and for the partial square.
+  buffer_len = width * BAND_LINES * 4;
+  if (buffer_len < PARTIAL * PARTIAL * 4) buffer_len = PARTIAL * PARTIAL * 4;
+  if (libtock_screen_buffer_init(buffer_len, &buffer) != TOCK_STATUSCODE_SUCCESS) {
+    printf("Out of memory\n");
+    return -1;
+  }
+  libtocksync_screen_set_brightness(100);
+
+  printf("# Display benchmark, %lu x %lu\n", width, height);
+  printf("format,bpp,fill_us,fill_kpx_per_s,frame_us,frame_fps_x10,partial_%dx%d_us\n", PARTIAL, PARTIAL);
+
+  uint32_t formats = 0;
+  libtock_screen_get_supported_pixel_formats(&formats);
+  for (uint32_t idx = 0; idx < formats; idx++) {
+    libtock_screen_format_t format;
+    if (libtock_screen_get_supported_pixel_format(idx, &format) != RETURNCODE_SUCCESS) continue;
+    if (libtocksync_screen_set_pixel_format(format) != RETURNCODE_SUCCESS) continue;
+    int bits = libtock_screen_get_bits_per_pixel(format);
+
+    uint32_t fill    = bench_fill();
+    uint32_t frame   = bench_frame(bits);
+    uint32_t partial = bench_partial(bits);
+    uint32_t pixels  = width * height;
+    printf("%d,%d,%lu,%lu,%lu,%lu,%lu\n", format, bits, fill, fill ? (uint32_t) (pixels * 1000ULL / fill) : 0,
+           frame, frame ? 10000000 / frame : 0, partial);
+  }
+
+  // lvgl is built for 16-bit color.
+  if (libtocksync_screen_set_pixel_format(RGB_565) == RETURNCODE_SUCCESS) {
+    printf("lvgl_fps_x10,%lu\n", bench_lvgl());
+  }
+  return 0;
+}
@@ -0,0 +1,62 @@
+#include <string.h>
+
+#include <libtock-sync/services/benchmark.h>
+#include <libtock/kernel/read_only_state.h>
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+#include <libtock/services/time.h>
+#include <libtock/tock.h>
+
+static uint8_t src[1024];
+static uint8_t dst[1024];
+
+static void bench_empty(void) {}
+
+static void bench_memcpy_1k(void) {
+  memcpy(dst, src, sizeof(dst));
+  BENCH_KEEP(dst);
+}
+
+static void bench_memset_1k(void) {
+  memset(dst, 0x5a, sizeof(dst));
+  BENCH_KEEP(dst);
+}
+
+static void bench_command(void) {
+  syscall_return_t ret = command(DRIVER_NUM_ALARM, 2, 0, 0);
+  BENCH_KEEP(ret.data[0]);
+}
+
+static void bench_yield_no_wait(void) {
+  yield_no_wait();
+}
+
+// With a read-only state region allocated, `yield_no_wait()` reads the
+// pending task count instead of trapping.
+static void bench_yield_no_wait_ros(void) {
+  yield_no_wait();
+}
+
+static void bench_time_now(void) {
+  BENCH_KEEP((uint32_t) libtock_time_now_ticks64());
+}
+
+int main(void) {
+  libtocksync_benchmark_t benches[] = {
+    BENCH(empty, 1000),
+    BENCH(memcpy_1k, 16),
+    BENCH(memset_1k, 16),
+    BENCH(command, 100),
+    BENCH(yield_no_wait, 100),
+    BENCH(time_now, 100),
+  };
+  libtocksync_benchmark_run(benches, sizeof(benches) / sizeof(benches[0]));
+
+  static uint8_t ros[LIBTOCK_READ_ONLY_STATE_BUFFER_LEN];
+  if (libtock_read_only_state_allocate_region(ros, sizeof(ros)) == RETURNCODE_SUCCESS) {
+    libtocksync_benchmark_t ros_benches[] = {
+      BENCH(yield_no_wait_ros, 100),
+    };
+    libtocksync_benchmark_run(ros_benches, sizeof(ros_benches) / sizeof(ros_benches[0]));
+  }
+  return 0;
+}
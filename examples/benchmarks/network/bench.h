@@ -0,0 +1,124 @@
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock/services/time.h>
+
+// Packet format and reporting shared by the network benchmarks.
+//
+// Every benchmark is a pair of apps. The sender first streams
+// BENCH_PACKETS data packets back to back, then sends an end packet, then
+// sends BENCH_PINGS pings one at a time and waits up to BENCH_TIMEOUT_MS
+// for each pong. The receiver counts the stream, prints its row when the
+// end packet arrives, and answers every ping.
+//
+// Rows are CSV under a single header:
+//
+//   stack,role,payload,packets,lost,pps,goodput_bps,rtt_min_us,rtt_avg_us,rtt_max_us
+//
+// `payload` is the bytes per packet handed to the stack, including the
+// 8-byte benchmark header. The `tx` row counts sends the stack reported as
+// failed as lost, the `rx` row counts gaps in the sequence numbers, and the
+// `rtt` row counts pings that got no pong in time. Fields that do not apply
+// to a row are 0.
+
+#ifndef BENCH_PAYLOAD
+#define BENCH_PAYLOAD 64
+#endif
+
+#ifndef BENCH_PACKETS
+#define BENCH_PACKETS 200
+#endif
+
+#ifndef BENCH_PINGS
+#define BENCH_PINGS 20
+#endif
+
+#ifndef BENCH_TIMEOUT_MS
+#define BENCH_TIMEOUT_MS 500
+#endif
+
+enum {
+  BENCH_DATA = 1,
+  BENCH_END  = 2,
+  BENCH_PING = 3,
+  BENCH_PONG = 4,
+};
+
+typedef struct {
+  uint32_t seq;
+  uint8_t kind;
+  uint8_t reserved[3];
+} bench_packet_t;
+
+_Static_assert(BENCH_PAYLOAD >= sizeof(bench_packet_t), "BENCH_PAYLOAD must hold the benchmark header");
+
+typedef struct {
+  uint64_t start_us;
+  uint64_t end_us;
+  uint32_t packets;
+  uint32_t lost;
+  uint32_t rtt_min_us;
+  uint32_t rtt_max_us;
+  uint64_t rtt_total_us;
+  uint32_t rtt_count;
+} bench_stats_t;
+
+static inline uint64_t bench_now_us(void) {
+  return libtock_time_now_us64();
+}
+
+// Write a packet of `len` bytes into `buf`.
+static inline void bench_fill(uint8_t* buf, size_t len, uint8_t kind, uint32_t seq) {
+  bench_packet_t header = { .seq = seq, .kind = kind };
+  memcpy(buf, &header, sizeof(header));
+  for (size_t i = sizeof(header); i < len; i++) {
+    buf[i] = (uint8_t) i;
+  }
+}
+
+// Read the header of a received packet. Returns false if it is too short.
+static inline bool bench_parse(const uint8_t* buf, size_t len, bench_packet_t* header) {
+  if (len < sizeof(*header)) return false;
+  memcpy(header, buf, sizeof(*header));
+  return true;
+}
+
+static inline void bench_header(const char* title) {
+  printf("# %s, %d byte payload\n", title, BENCH_PAYLOAD);
+  printf("stack,role,payload,packets,lost,pps,goodput_bps,rtt_min_us,rtt_avg_us,rtt_max_us\n");
+}
+
+static inline void bench_stats_reset(bench_stats_t* stats) {
+  memset(stats, 0, sizeof(*stats));
+  stats->rtt_min_us = UINT32_MAX;
+}
+
+static inline void bench_record_rtt(bench_stats_t* stats, uint32_t us) {
+  if (us < stats->rtt_min_us) stats->rtt_min_us = us;
+  if (us > stats->rtt_max_us) stats->rtt_max_us = us;
+  stats->rtt_total_us += us;
+  stats->rtt_count++;
+}
+
+static inline void bench_report(const char* stack, const char* role, const bench_stats_t* stats) {
+  uint64_t us     = stats->end_us - stats->start_us;
+  uint32_t pps    = us == 0 ? 0 : (uint32_t) ((uint64_t) stats->packets * 1000000 / us);
+  uint32_t bps    = us == 0 ? 0 : (uint32_t) ((uint64_t) stats->packets * BENCH_PAYLOAD * 8 * 1000000 / us);
+  uint32_t rtt_min = stats->rtt_count == 0 ? 0 : stats->rtt_min_us;
+  uint32_t rtt_avg = stats->rtt_count == 0 ? 0 : (uint32_t) (stats->rtt_total_us / stats->rtt_count);
+
+  printf("%s,%s,%d,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", stack, role, BENCH_PAYLOAD,
+         (unsigned long) stats->packets, (unsigned long) stats->lost, (unsigned long) pps, (unsigned long) bps,
+         (unsigned long) rtt_min, (unsigned long) rtt_avg, (unsigned long) stats->rtt_max_us);
+}
+
+// Receiver side of the stream: count a data packet with `seq` at `now`.
+static inline void bench_count(bench_stats_t* stats, uint32_t seq, uint64_t now, uint32_t* next_seq) {
+  if (stats->packets == 0) stats->start_us = now;
+  stats->end_us = now;
+  stats->packets++;
+  if (seq > *next_seq) stats->lost += seq - *next_seq;
+  if (seq >= *next_seq) *next_seq = seq + 1;
+}
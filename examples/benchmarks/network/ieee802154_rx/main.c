@@ -0,0 +1,84 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <libtock-sync/net/ieee802154.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock/net/ieee802154.h>
+
+#include "../bench.h"
+
+// Receiver half of the 802.15.4 benchmark. Pair with `ieee802154_tx`.
+
+#define LOCAL_ADDR 0x0802
+#define PAN        0xABCD
+#define RX_FRAMES  8
+
+static uint8_t rx_storage[libtock_ieee802154_RING_BUFFER_LEN_FOR(RX_FRAMES)];
+static libtock_ieee802154_ring_t rx_ring;
+
+static bench_stats_t stats;
+static uint32_t next_seq;
+
+static bool ping_pending;
+static uint32_t ping_seq;
+static uint16_t ping_src;
+
+static void frame_received(__attribute__ ((unused)) int   pans,
+                           __attribute__ ((unused)) int   dst_addr,
+                           __attribute__ ((unused)) int   src_addr,
+                           __attribute__ ((unused)) void* ud) {
+  uint64_t now = bench_now_us();
+  libtock_ieee802154_ring_reset(NULL, NULL, NULL);
+
+  libtock_ieee802154_header_t hdr;
+  while (libtock_ieee802154_ring_next_parsed(&rx_ring, &hdr) != NULL) {
+    bench_packet_t packet;
+    if (!bench_parse(hdr.payload, hdr.payload_length, &packet)) continue;
+
+    switch (packet.kind) {
+      case BENCH_DATA:
+        bench_count(&stats, packet.seq, now, &next_seq);
+        break;
+      case BENCH_END:
+        if (packet.seq > next_seq) stats.lost += packet.seq - next_seq;
+        bench_report("ieee802154", "rx", &stats);
+        bench_stats_reset(&stats);
+        next_seq = 0;
+        break;
+      case BENCH_PING:
+        ping_pending = true;
+        ping_seq     = packet.seq;
+        ping_src     = hdr.src_short;
+        break;
+    }
+  }
+
+  // The pong is sent from the main loop, after the ring is back with the
+  // kernel, so frames that arrive meanwhile are not lost.
+  libtock_ieee802154_ring_reset(&rx_ring, frame_received, NULL);
+}
+
+int main(void) {
+  static uint8_t pong[BENCH_PAYLOAD];
+
+  libtock_ieee802154_ring_init(&rx_ring, rx_storage, sizeof(rx_storage));
+  libtock_ieee802154_set_address_short(LOCAL_ADDR);
+  libtock_ieee802154_set_pan(PAN);
+  libtock_ieee802154_config_commit();
+  returncode_t ret = libtocksync_ieee802154_up();
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Error: could not enable radio (%d)\n", ret);
+    return -1;
+  }
+
+  bench_stats_reset(&stats);
+  libtock_ieee802154_ring_reset(&rx_ring, frame_received, NULL);
+  bench_header("802.15.4 receiver");
+
+  while (1) {
+    yield_for(&ping_pending);
+    ping_pending = false;
+    bench_fill(pong, sizeof(pong), BENCH_PONG, ping_seq);
+    libtocksync_ieee802154_send(ping_src, SEC_LEVEL_NONE, 0, NULL, pong, sizeof(pong));
+  }
+}
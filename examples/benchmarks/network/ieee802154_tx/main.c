@@ -0,0 +1,117 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <libtock-sync/net/ieee802154.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock/net/ieee802154.h>
+
+#include "../bench.h"
+
+// Sender half of the 802.15.4 benchmark. Pair with `ieee802154_rx`.
+
+#define LOCAL_ADDR  0x1540
+#define REMOTE_ADDR 0x0802
+#define PAN         0xABCD
+#define RX_FRAMES   4
+
+static uint8_t rx_storage[libtock_ieee802154_RING_BUFFER_LEN_FOR(RX_FRAMES)];
+static libtock_ieee802154_ring_t rx_ring;
+static uint8_t packet[BENCH_PAYLOAD];
+
+static bool received;
+
+static void frame_received(__attribute__ ((unused)) int   pans,
+                           __attribute__ ((unused)) int   dst_addr,
+                           __attribute__ ((unused)) int   src_addr,
+                           __attribute__ ((unused)) void* ud) {
+  received = true;
+}
+
+// Take the ring back and look for the pong to `seq`.
+static bool take_pong(uint32_t seq) {
+  bool found = false;
+  libtock_ieee802154_ring_reset(NULL, NULL, NULL);
+
+  libtock_ieee802154_header_t hdr;
+  while (libtock_ieee802154_ring_next_parsed(&rx_ring, &hdr) != NULL) {
+    bench_packet_t pong;
+    if (bench_parse(hdr.payload, hdr.payload_length, &pong) && pong.kind == BENCH_PONG && pong.seq == seq) {
+      found = true;
+    }
+  }
+
+  libtock_ieee802154_ring_reset(&rx_ring, frame_received, NULL);
+  return found;
+}
+
+static void stream(void) {
+  bench_stats_t stats;
+  bench_stats_reset(&stats);
+
+  stats.start_us = bench_now_us();
+  for (uint32_t seq = 0; seq < BENCH_PACKETS; seq++) {
+    bench_fill(packet, sizeof(packet), BENCH_DATA, seq);
+    returncode_t ret = libtocksync_ieee802154_send(REMOTE_ADDR, SEC_LEVEL_NONE, 0, NULL, packet, sizeof(packet));
+    if (ret == RETURNCODE_SUCCESS) {
+      stats.packets++;
+    } else {
+      stats.lost++;
+    }
+  }
+  stats.end_us = bench_now_us();
+
+  bench_fill(packet, sizeof(packet), BENCH_END, BENCH_PACKETS);
+  libtocksync_ieee802154_send(REMOTE_ADDR, SEC_LEVEL_NONE, 0, NULL, packet, sizeof(packet));
+  bench_report("ieee802154", "tx", &stats);
+}
+
+static void ping(void) {
+  bench_stats_t stats;
+  bench_stats_reset(&stats);
+
+  for (uint32_t seq = 0; seq < BENCH_PINGS; seq++) {
+    bench_fill(packet, sizeof(packet), BENCH_PING, seq);
+    received = false;
+
+    uint64_t start   = bench_now_us();
+    returncode_t ret = libtocksync_ieee802154_send(REMOTE_ADDR, SEC_LEVEL_NONE, 0, NULL, packet, sizeof(packet));
+    bool ponged      = false;
+    while (ret == RETURNCODE_SUCCESS && !ponged) {
+      uint64_t waited = (bench_now_us() - start) / 1000;
+      if (waited >= BENCH_TIMEOUT_MS ||
+          libtocksync_alarm_yield_for_with_timeout(&received, BENCH_TIMEOUT_MS - waited) != RETURNCODE_SUCCESS) {
+        break;
+      }
+      received = false;
+      ponged   = take_pong(seq);
+    }
+
+    if (ponged) {
+      stats.packets++;
+      bench_record_rtt(&stats, (uint32_t) (bench_now_us() - start));
+    } else {
+      stats.lost++;
+    }
+  }
+  bench_report("ieee802154", "rtt", &stats);
+}
+
+int main(void) {
+  libtock_ieee802154_ring_init(&rx_ring, rx_storage, sizeof(rx_storage));
+  libtock_ieee802154_set_address_short(LOCAL_ADDR);
+  libtock_ieee802154_set_pan(PAN);
+  libtock_ieee802154_config_commit();
+  returncode_t ret = libtocksync_ieee802154_up();
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Error: could not enable radio (%d)\n", ret);
+    return -1;
+  }
+  libtock_ieee802154_ring_reset(&rx_ring, frame_received, NULL);
+
+  bench_header("802.15.4 sender");
+  stream();
+  // Let the receiver print before the pings arrive.
+  libtocksync_alarm_delay_ms(100);
+  ping();
+  return 0;
+}
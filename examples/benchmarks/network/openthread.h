@@ -0,0 +1,94 @@
+#pragma once
+
+#include <assert.h>
+#include <string.h>
+
+#include <libopenthread/platform/openthread-system.h>
+#include <openthread/dataset_ftd.h>
+#include <openthread/instance.h>
+#include <openthread/ip6.h>
+#include <openthread/message.h>
+#include <openthread/thread.h>
+#include <openthread/udp.h>
+
+#include "bench.h"
+
+// Thread network and UDP socket shared by the OpenThread benchmarks. The
+// dataset matches the one in `examples/openthread`.
+
+#define BENCH_OT_PORT 1212
+
+static otUdpSocket bench_ot_socket;
+
+static void bench_ot_dataset(otInstance* instance) {
+  otOperationalDataset dataset;
+  memset(&dataset, 0, sizeof(dataset));
+
+  dataset.mChannel = 26;
+  dataset.mComponents.mIsChannelPresent = true;
+  dataset.mPanId = (otPanId) 0xabcd;
+  dataset.mComponents.mIsPanIdPresent = true;
+
+  uint8_t key[OT_NETWORK_KEY_SIZE] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                       0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+  memcpy(dataset.mNetworkKey.m8, key, sizeof(dataset.mNetworkKey));
+  dataset.mComponents.mIsNetworkKeyPresent = true;
+
+  otError error = otDatasetSetActive(instance, &dataset);
+  assert(error == OT_ERROR_NONE);
+}
+
+// Bring up the Thread interface, open the benchmark socket with `receive`,
+// and run the stack until the device has joined the network.
+static otInstance* bench_ot_start(otUdpReceive receive) {
+  otSysInit(0, NULL);
+  otInstance* instance = otInstanceInitSingle();
+  assert(instance);
+
+  bench_ot_dataset(instance);
+  otIp6SetEnabled(instance, true);
+
+  otSockAddr local;
+  memset(&bench_ot_socket, 0, sizeof(bench_ot_socket));
+  memset(&local, 0, sizeof(local));
+  local.mPort = BENCH_OT_PORT;
+  otUdpOpen(instance, &bench_ot_socket, receive, instance);
+  otUdpBind(instance, &bench_ot_socket, &local, OT_NETIF_THREAD);
+
+  otThreadSetEnabled(instance, true);
+  while (otThreadGetDeviceRole(instance) < OT_DEVICE_ROLE_CHILD) {
+    otTockProcess(instance);
+  }
+  return instance;
+}
+
+// Queue a benchmark packet to `peer`, running the stack while its message
+// buffers are full. Returns false if the packet could not be queued.
+static bool bench_ot_send(otInstance* instance, const otIp6Address* peer, uint8_t kind, uint32_t seq) {
+  static uint8_t packet[BENCH_PAYLOAD];
+  bench_fill(packet, sizeof(packet), kind, seq);
+
+  otMessageInfo info;
+  memset(&info, 0, sizeof(info));
+  info.mPeerAddr = *peer;
+  info.mPeerPort = BENCH_OT_PORT;
+
+  while (1) {
+    otMessage* message = otUdpNewMessage(instance, NULL);
+    if (message != NULL) {
+      otError error = otMessageAppend(message, packet, sizeof(packet));
+      if (error == OT_ERROR_NONE) error = otUdpSend(instance, &bench_ot_socket, message, &info);
+      if (error == OT_ERROR_NONE) return true;
+      otMessageFree(message);
+      if (error != OT_ERROR_NO_BUFS) return false;
+    }
+    otTockProcess(instance);
+  }
+}
+
+// Read the benchmark header of a received message.
+static bool bench_ot_parse(const otMessage* message, bench_packet_t* header) {
+  uint8_t buf[sizeof(*header)];
+  uint16_t len = otMessageRead(message, otMessageGetOffset(message), buf, sizeof(buf));
+  return bench_parse(buf, len, header);
+}
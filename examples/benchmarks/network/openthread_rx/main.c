@@ -0,0 +1,52 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "../openthread.h"
+
+// Receiver half of the OpenThread benchmark. Pair with `openthread_tx`.
+
+static bench_stats_t stats;
+static uint32_t next_seq;
+
+static bool ping_pending;
+static uint32_t ping_seq;
+static otIp6Address ping_src;
+
+static void udp_received(__attribute__ ((unused)) void* context, otMessage* message, const otMessageInfo* info) {
+  bench_packet_t packet;
+  if (!bench_ot_parse(message, &packet)) return;
+
+  switch (packet.kind) {
+    case BENCH_DATA:
+      bench_count(&stats, packet.seq, bench_now_us(), &next_seq);
+      break;
+    case BENCH_END:
+      if (packet.seq > next_seq) stats.lost += packet.seq - next_seq;
+      bench_report("openthread", "rx", &stats);
+      bench_stats_reset(&stats);
+      next_seq = 0;
+      break;
+    case BENCH_PING:
+      // The pong is queued from the main loop rather than from inside the
+      // stack's receive path.
+      ping_pending = true;
+      ping_seq     = packet.seq;
+      ping_src     = info->mPeerAddr;
+      break;
+  }
+}
+
+int main(void) {
+  otInstance* instance = bench_ot_start(udp_received);
+
+  bench_stats_reset(&stats);
+  bench_header("OpenThread receiver");
+
+  while (1) {
+    otTockProcess(instance);
+    if (ping_pending) {
+      ping_pending = false;
+      bench_ot_send(instance, &ping_src, BENCH_PONG, ping_seq);
+    }
+  }
+}
@@ -0,0 +1,82 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "../openthread.h"
+
+// Sender half of the OpenThread benchmark. Pair with `openthread_rx`.
+//
+// The stream goes to the realm-local all-nodes address, which Thread sends
+// without link-layer ACKs, and the pings go to the same address. The `tx`
+// rate is the rate at which the stack accepted the packets.
+
+static const char DEST_ADDR[] = "ff03::1";
+
+static bool ponged;
+static uint32_t ping_seq;
+
+static void udp_received(__attribute__ ((unused)) void*                 context,
+                         otMessage*                                     message,
+                         __attribute__ ((unused)) const otMessageInfo* info) {
+  bench_packet_t pong;
+  if (bench_ot_parse(message, &pong) && pong.kind == BENCH_PONG && pong.seq == ping_seq) ponged = true;
+}
+
+static void stream(otInstance* instance, const otIp6Address* dest) {
+  bench_stats_t stats;
+  bench_stats_reset(&stats);
+
+  stats.start_us = bench_now_us();
+  for (uint32_t seq = 0; seq < BENCH_PACKETS; seq++) {
+    if (bench_ot_send(instance, dest, BENCH_DATA, seq)) {
+      stats.packets++;
+    } else {
+      stats.lost++;
+    }
+  }
+  stats.end_us = bench_now_us();
+
+  bench_ot_send(instance, dest, BENCH_END, BENCH_PACKETS);
+  bench_report("openthread", "tx", &stats);
+}
+
+static void ping(otInstance* instance, const otIp6Address* dest) {
+  bench_stats_t stats;
+  bench_stats_reset(&stats);
+
+  for (uint32_t seq = 0; seq < BENCH_PINGS; seq++) {
+    ping_seq = seq;
+    ponged   = false;
+
+    uint64_t start = bench_now_us();
+    bool sent      = bench_ot_send(instance, dest, BENCH_PING, seq);
+    while (sent && !ponged && bench_now_us() - start < BENCH_TIMEOUT_MS * 1000ull) {
+      otTockProcess(instance);
+    }
+
+    if (ponged) {
+      stats.packets++;
+      bench_record_rtt(&stats, (uint32_t) (bench_now_us() - start));
+    } else {
+      stats.lost++;
+    }
+  }
+  bench_report("openthread", "rtt", &stats);
+}
+
+int main(void) {
+  otInstance* instance = bench_ot_start(udp_received);
+
+  otIp6Address dest;
+  otIp6AddressFromString(DEST_ADDR, &dest);
+
+  bench_header("OpenThread sender");
+  stream(instance, &dest);
+
+  // Let the stream drain and the receiver print before the pings.
+  uint64_t start = bench_now_us();
+  while (bench_now_us() - start < 500000) otTockProcess(instance);
+  ping(instance, &dest);
+
+  otTockRun(instance);
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <libtock-sync/net/ieee802154.h>
+#include <libtock-sync/net/udp.h>
+#include <libtock/net/ieee802154.h>
+#include <libtock/net/udp.h>
+#include <libtock/services/udp_sockets.h>
+
+#include "../bench.h"
+
+// Receiver half of the UDP benchmark. Pair with `udp_tx`.
+
+#define LOCAL_PORT 16123
+#define SLOTS      8
+
+static uint8_t storage[LIBTOCK_UDP_SOCKET_STORAGE_LEN(SLOTS, BENCH_PAYLOAD)];
+static libtock_udp_socket_t sock;
+
+static bench_stats_t stats;
+static uint32_t next_seq;
+
+static bool ping_pending;
+static uint32_t ping_seq;
+static sock_addr_t ping_src;
+
+static void datagram_received(__attribute__ ((unused)) libtock_udp_socket_t* s,
+                              __attribute__ ((unused)) void*                 opaque) {
+  uint64_t now = bench_now_us();
+  size_t len;
+  sock_addr_t src;
+  const uint8_t* data;
+  while ((data = libtock_udp_socket_peek(&sock, &len, &src)) != NULL) {
+    bench_packet_t packet;
+    bool valid = bench_parse(data, len, &packet);
+    libtock_udp_socket_release(&sock);
+    if (!valid) continue;
+
+    switch (packet.kind) {
+      case BENCH_DATA:
+        bench_count(&stats, packet.seq, now, &next_seq);
+        break;
+      case BENCH_END:
+        if (packet.seq > next_seq) stats.lost += packet.seq - next_seq;
+        bench_report("udp", "rx", &stats);
+        printf("# %lu datagrams dropped by the socket queue\n", (unsigned long) libtock_udp_socket_dropped(&sock));
+        bench_stats_reset(&stats);
+        next_seq = 0;
+        break;
+      case BENCH_PING:
+        ping_pending = true;
+        ping_seq     = packet.seq;
+        ping_src     = src;
+        break;
+    }
+  }
+}
+
+int main(void) {
+  static uint8_t pong[BENCH_PAYLOAD];
+
+  ipv6_addr_t ifaces[10];
+  libtock_udp_list_ifaces(ifaces, 10);
+
+  if (libtock_ieee802154_driver_exists()) {
+    libtock_ieee802154_set_address_short(49138); // Corresponds to the dst mac addr set in kernel
+    libtock_ieee802154_set_pan(0xABCD);
+    libtock_ieee802154_config_commit();
+    libtocksync_ieee802154_up();
+  }
+
+  bench_stats_reset(&stats);
+  libtock_udp_socket_open(&sock, NULL, storage, sizeof(storage), SLOTS, datagram_received, NULL);
+
+  sock_addr_t local = { ifaces[1], LOCAL_PORT };
+  returncode_t ret  = libtock_udp_sockets_start(&local);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Error binding port %d: %d\n", LOCAL_PORT, ret);
+    return -1;
+  }
+  bench_header("UDP receiver");
+
+  while (1) {
+    yield_for(&ping_pending);
+    ping_pending = false;
+    bench_fill(pong, sizeof(pong), BENCH_PONG, ping_seq);
+    libtocksync_udp_send(pong, sizeof(pong), &ping_src);
+  }
+}
@@ -0,0 +1,119 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <libtock-sync/net/udp.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock/net/udp.h>
+#include <libtock/services/udp_sockets.h>
+
+#include "../bench.h"
+
+// Sender half of the UDP benchmark. Pair with `udp_rx`.
+
+#define LOCAL_PORT  16124
+#define REMOTE_PORT 16123
+#define SLOTS       4
+
+static uint8_t storage[LIBTOCK_UDP_SOCKET_STORAGE_LEN(SLOTS, BENCH_PAYLOAD)];
+static libtock_udp_socket_t sock;
+static uint8_t packet[BENCH_PAYLOAD];
+
+static bool received;
+
+// Set the below address to be the IP address of your receiver. The current
+// address corresponds to the default src address set in the udp_rx app.
+static sock_addr_t destination = {
+  { { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f } },
+  REMOTE_PORT
+};
+
+static void datagram_received(__attribute__ ((unused)) libtock_udp_socket_t* s,
+                              __attribute__ ((unused)) void*                 opaque) {
+  received = true;
+}
+
+// Drain the socket and look for the pong to `seq`.
+static bool take_pong(uint32_t seq) {
+  bool found = false;
+  size_t len;
+  const uint8_t* data;
+  while ((data = libtock_udp_socket_peek(&sock, &len, NULL)) != NULL) {
+    bench_packet_t pong;
+    if (bench_parse(data, len, &pong) && pong.kind == BENCH_PONG && pong.seq == seq) found = true;
+    libtock_udp_socket_release(&sock);
+  }
+  return found;
+}
+
+static void stream(void) {
+  bench_stats_t stats;
+  bench_stats_reset(&stats);
+
+  stats.start_us = bench_now_us();
+  for (uint32_t seq = 0; seq < BENCH_PACKETS; seq++) {
+    bench_fill(packet, sizeof(packet), BENCH_DATA, seq);
+    if (libtocksync_udp_send(packet, sizeof(packet), &destination) == RETURNCODE_SUCCESS) {
+      stats.packets++;
+    } else {
+      stats.lost++;
+    }
+  }
+  stats.end_us = bench_now_us();
+
+  bench_fill(packet, sizeof(packet), BENCH_END, BENCH_PACKETS);
+  libtocksync_udp_send(packet, sizeof(packet), &destination);
+  bench_report("udp", "tx", &stats);
+}
+
+static void ping(void) {
+  bench_stats_t stats;
+  bench_stats_reset(&stats);
+
+  for (uint32_t seq = 0; seq < BENCH_PINGS; seq++) {
+    bench_fill(packet, sizeof(packet), BENCH_PING, seq);
+    take_pong(seq);
+    received = false;
+
+    uint64_t start   = bench_now_us();
+    returncode_t ret = libtocksync_udp_send(packet, sizeof(packet), &destination);
+    bool ponged      = false;
+    while (ret == RETURNCODE_SUCCESS && !ponged) {
+      uint64_t waited = (bench_now_us() - start) / 1000;
+      if (waited >= BENCH_TIMEOUT_MS ||
+          libtocksync_alarm_yield_for_with_timeout(&received, BENCH_TIMEOUT_MS - waited) != RETURNCODE_SUCCESS) {
+        break;
+      }
+      received = false;
+      ponged   = take_pong(seq);
+    }
+
+    if (ponged) {
+      stats.packets++;
+      bench_record_rtt(&stats, (uint32_t) (bench_now_us() - start));
+    } else {
+      stats.lost++;
+    }
+  }
+  bench_report("udp", "rtt", &stats);
+}
+
+int main(void) {
+  ipv6_addr_t ifaces[10];
+  libtock_udp_list_ifaces(ifaces, 10);
+
+  libtock_udp_socket_open(&sock, NULL, storage, sizeof(storage), SLOTS, datagram_received, NULL);
+
+  sock_addr_t local = { ifaces[0], LOCAL_PORT };
+  returncode_t ret  = libtock_udp_sockets_start(&local);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Error binding port %d: %d\n", LOCAL_PORT, ret);
+    return -1;
+  }
+
+  bench_header("UDP sender");
+  stream();
+  // Let the receiver print before the pings arrive.
+  libtocksync_alarm_delay_ms(100);
+  ping();
+  return 0;
+}
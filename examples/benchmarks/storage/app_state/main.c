@@ -0,0 +1,71 @@
+#include <string.h>
+
+#include <libtock-sync/storage/app_state.h>
+
+#include "../bench.h"
+
+#define OPS 16
+// Pages of state. Each save rewrites only the pages that changed.
+#define PAGES 8
+
+struct bench_state_t {
+  uint8_t data[PAGES * LIBTOCK_APP_STATE_PAGE_SIZE];
+};
+
+LIBTOCK_APP_STATE_DECLARE(struct bench_state_t, state);
+
+// Save after changing one byte in `changed` pages, spread over the state
+// one after the other or at random.
+static void run_save(bool random, uint32_t changed) {
+  bench_start();
+  for (int i = 0; i < OPS; i++) {
+    for (uint32_t p = 0; p < changed; p++) {
+      uint32_t page = random ? bench_random() % PAGES : (i * changed + p) % PAGES;
+      state.data[page * LIBTOCK_APP_STATE_PAGE_SIZE + i % LIBTOCK_APP_STATE_PAGE_SIZE]++;
+    }
+
+    uint32_t start   = bench_now();
+    returncode_t ret = libtocksync_app_state_save();
+    if (ret != RETURNCODE_SUCCESS) {
+      bench_error("app_state", "save", ret);
+      return;
+    }
+    bench_record(start);
+  }
+  bench_report("app_state", "save", random ? "random" : "seq", changed * LIBTOCK_APP_STATE_PAGE_SIZE);
+}
+
+static void run_load(void) {
+  bench_start();
+  for (int i = 0; i < OPS; i++) {
+    uint32_t start   = bench_now();
+    returncode_t ret = libtock_app_state_load();
+    if (ret != RETURNCODE_SUCCESS) {
+      bench_error("app_state", "load", ret);
+      return;
+    }
+    bench_record(start);
+  }
+  bench_report("app_state", "load", "seq", sizeof(state));
+}
+
+int main(void) {
+  if (!libtock_app_state_exists()) {
+    printf("# No app state driver\n");
+    return 0;
+  }
+
+  returncode_t ret = libtock_app_state_load();
+  if (ret != RETURNCODE_SUCCESS) {
+    bench_error("app_state", "load", ret);
+    return -1;
+  }
+
+  bench_header("App state benchmark");
+  run_load();
+  run_save(false, 1);
+  run_save(true, 1);
+  run_save(false, PAGES / 2);
+  run_save(false, PAGES);
+  return 0;
+}
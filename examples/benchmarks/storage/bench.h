@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+#include <libtock/services/time.h>
+
+// Timing and reporting shared by the storage benchmarks.
+//
+// Every benchmark prints one CSV row per driver, operation, access pattern
+// and size, under a single header row:
+//
+//   driver,op,pattern,size,ops,kib_per_s,min_us,avg_us,p99_us,max_us
+//
+// `size` is the bytes moved by one operation and `kib_per_s` the throughput
+// over all `ops` operations.
+
+// Most operations timed per row.
+#define BENCH_SAMPLES 64
+
+static uint32_t bench_samples[BENCH_SAMPLES];
+static int bench_sample_count;
+static uint32_t bench_lcg_state = 1;
+
+static uint32_t bench_now(void) {
+  uint32_t ticks;
+  libtock_alarm_command_read(&ticks);
+  return ticks;
+}
+
+// Pseudo-random numbers for the random access patterns, the same sequence on
+// every board.
+static uint32_t bench_random(void) {
+  bench_lcg_state = bench_lcg_state * 1664525 + 1013904223;
+  return bench_lcg_state >> 8;
+}
+
+static void bench_header(const char* title) {
+  printf("# %s (%lu Hz clock)\n", title, (unsigned long) libtock_time_frequency());
+  printf("driver,op,pattern,size,ops,kib_per_s,min_us,avg_us,p99_us,max_us\n");
+}
+
+static void bench_start(void) {
+  bench_sample_count = 0;
+}
+
+// Record one operation started at `start` ticks.
+static void bench_record(uint32_t start) {
+  uint32_t elapsed = bench_now() - start;
+  if (bench_sample_count < BENCH_SAMPLES) {
+    bench_samples[bench_sample_count++] = elapsed;
+  }
+}
+
+static int bench_cmp_u32(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*) a;
+  uint32_t y = *(const uint32_t*) b;
+  return (x > y) - (x < y);
+}
+
+static void bench_report(const char* driver, const char* op, const char* pattern, uint32_t size) {
+  if (bench_sample_count == 0) return;
+  qsort(bench_samples, bench_sample_count, sizeof(bench_samples[0]), bench_cmp_u32);
+
+  uint64_t total = 0;
+  for (int i = 0; i < bench_sample_count; i++) {
+    total += bench_samples[i];
+  }
+  uint64_t total_us = libtock_time_ticks_to_us64(total);
+  uint64_t bytes    = (uint64_t) size * bench_sample_count;
+  uint32_t kib_s    = total_us == 0 ? 0 : (uint32_t) (bytes * 1000000 / 1024 / total_us);
+
+  printf("%s,%s,%s,%lu,%d,%lu,%lu,%lu,%lu,%lu\n", driver, op, pattern, (unsigned long) size,
+         bench_sample_count, (unsigned long) kib_s,
+         (unsigned long) libtock_time_ticks_to_us64(bench_samples[0]),
+         (unsigned long) (total_us / bench_sample_count),
+         (unsigned long) libtock_time_ticks_to_us64(bench_samples[(bench_sample_count * 99) / 100]),
+         (unsigned long) libtock_time_ticks_to_us64(bench_samples[bench_sample_count - 1]));
+}
+
+// Report a failed operation as a comment line, so the table stays
+// parseable.
+static void bench_error(const char* driver, const char* op, returncode_t ret) {
+  printf("# %s %s failed: %s\n", driver, op, tock_strrcode(ret));
+}
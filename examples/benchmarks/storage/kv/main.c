@@ -0,0 +1,70 @@
+#include <string.h>
+
+#include <libtock-sync/storage/kv.h>
+
+#include "../bench.h"
+
+#define OPS      32
+#define KEYS     32
+#define MAX_SIZE 256
+
+static const uint32_t sizes[] = { 8, 64, 256 };
+static uint8_t value[MAX_SIZE];
+
+static uint32_t make_key(uint8_t* key, uint32_t n) {
+  return snprintf((char*) key, 16, "bench-%02lu", (unsigned long) n);
+}
+
+// Key of operation `i`: the keys in turn for the sequential pattern,
+// otherwise any of them.
+static uint32_t key_of(int i, bool random, uint8_t* key) {
+  return make_key(key, random ? bench_random() % KEYS : (uint32_t) i % KEYS);
+}
+
+static returncode_t kv_op(const char* op, const uint8_t* key, uint32_t key_len, uint32_t size) {
+  uint32_t length;
+  if (strcmp(op, "set") == 0) return libtocksync_kv_set(key, key_len, value, size);
+  if (strcmp(op, "update") == 0) return libtocksync_kv_update(key, key_len, value, size);
+  if (strcmp(op, "get") == 0) return libtocksync_kv_get(key, key_len, value, sizeof(value), &length);
+  return libtocksync_kv_delete(key, key_len);
+}
+
+static void run(const char* op, bool random, uint32_t size) {
+  bench_start();
+  for (int i = 0; i < OPS; i++) {
+    uint8_t key[16];
+    uint32_t key_len = key_of(i, random, key);
+    memset(value, i, size);
+
+    uint32_t start   = bench_now();
+    returncode_t ret = kv_op(op, key, key_len, size);
+    if (ret != RETURNCODE_SUCCESS) {
+      bench_error("kv", op, ret);
+      return;
+    }
+    bench_record(start);
+  }
+  bench_report("kv", op, random ? "random" : "seq", size);
+}
+
+int main(void) {
+  if (!libtock_kv_exists()) {
+    printf("# No KV driver\n");
+    return 0;
+  }
+
+  bench_header("KV benchmark");
+  for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    // Start from no keys, so `set` stores new ones.
+    for (uint32_t n = 0; n < KEYS; n++) {
+      uint8_t key[16];
+      libtocksync_kv_delete(key, make_key(key, n));
+    }
+    run("set", false, sizes[s]);
+    run("get", false, sizes[s]);
+    run("update", true, sizes[s]);
+    run("get", true, sizes[s]);
+    run("delete", false, sizes[s]);
+  }
+  return 0;
+}
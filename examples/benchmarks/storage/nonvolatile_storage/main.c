@@ -0,0 +1,63 @@
+#include <libtock-sync/storage/nonvolatile_storage.h>
+
+#include "../bench.h"
+
+#define OPS      32
+#define MAX_SIZE 1024
+
+static const uint32_t sizes[] = { 16, 64, 256, 1024 };
+static uint8_t buffer[MAX_SIZE];
+static uint32_t storage_size;
+
+// Offset of operation `i`: consecutive for the sequential pattern, otherwise
+// anywhere in storage aligned to the size.
+static uint32_t offset_of(int i, uint32_t size, bool random) {
+  uint32_t slots = storage_size / size;
+  return (random ? bench_random() % slots : (uint32_t) i % slots) * size;
+}
+
+static void run(bool write, bool random, uint32_t size) {
+  const char* op = write ? "write" : "read";
+  bench_start();
+  for (int i = 0; i < OPS; i++) {
+    uint32_t offset = offset_of(i, size, random);
+    int length;
+    for (uint32_t j = 0; write && j < size; j++) {
+      buffer[j] = i + j;
+    }
+
+    uint32_t start   = bench_now();
+    returncode_t ret = write ?
+                       libtocksync_nonvolatile_storage_write(offset, size, buffer, sizeof(buffer), &length) :
+                       libtocksync_nonvolatile_storage_read(offset, size, buffer, sizeof(buffer), &length);
+    if (ret != RETURNCODE_SUCCESS) {
+      bench_error("nonvolatile_storage", op, ret);
+      return;
+    }
+    bench_record(start);
+  }
+  bench_report("nonvolatile_storage", op, random ? "random" : "seq", size);
+}
+
+int main(void) {
+  if (!libtock_nonvolatile_storage_exists()) {
+    printf("# No nonvolatile storage driver\n");
+    return 0;
+  }
+
+  returncode_t ret = libtock_nonvolatile_storage_get_number_bytes(&storage_size);
+  if (ret != RETURNCODE_SUCCESS) {
+    bench_error("nonvolatile_storage", "size", ret);
+    return -1;
+  }
+
+  bench_header("Nonvolatile storage benchmark");
+  for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    if (sizes[s] > storage_size) break;
+    run(true, false, sizes[s]);
+    run(false, false, sizes[s]);
+    run(true, true, sizes[s]);
+    run(false, true, sizes[s]);
+  }
+  return 0;
+}
@@ -0,0 +1,74 @@
+#include <libtock-sync/storage/sdcard.h>
+
+#include "../bench.h"
+
+#define OPS        32
+#define BLOCK_SIZE 512
+#define MAX_BLOCKS 16
+// Blocks from here on are overwritten.
+#define FIRST_SECTOR 2048
+#define SECTORS      65536
+
+static const uint32_t block_counts[] = { 1, 4, 16 };
+static uint8_t buffer[MAX_BLOCKS * BLOCK_SIZE];
+
+static uint32_t sector_of(int i, uint32_t count, bool random) {
+  uint32_t runs = SECTORS / count;
+  return FIRST_SECTOR + (random ? bench_random() % runs : (uint32_t) i % runs) * count;
+}
+
+static void run(bool write, bool random, uint32_t count) {
+  const char* op = write ? "write" : "read";
+  uint32_t len   = count * BLOCK_SIZE;
+  bench_start();
+  for (int i = 0; i < OPS; i++) {
+    uint32_t sector = sector_of(i, count, random);
+    for (uint32_t j = 0; write && j < len; j++) {
+      buffer[j] = i + j;
+    }
+
+    uint32_t start = bench_now();
+    returncode_t ret;
+    if (count == 1) {
+      ret = write ? libtocksync_sdcard_write_block(sector, buffer, len) :
+            libtocksync_sdcard_read_block(sector, buffer, len);
+    } else {
+      ret = write ? libtocksync_sdcard_write_blocks(sector, count, buffer, len) :
+            libtocksync_sdcard_read_blocks(sector, count, buffer, len);
+    }
+    if (ret != RETURNCODE_SUCCESS) {
+      bench_error("sdcard", op, ret);
+      return;
+    }
+    bench_record(start);
+  }
+  bench_report("sdcard", op, random ? "random" : "seq", len);
+}
+
+int main(void) {
+  if (!libtock_sdcard_exists()) {
+    printf("# No SD card driver\n");
+    return 0;
+  }
+
+  uint32_t block_size = 0;
+  uint32_t size_in_kB = 0;
+  returncode_t ret    = libtocksync_sdcard_initialize(&block_size, &size_in_kB);
+  if (ret != RETURNCODE_SUCCESS) {
+    bench_error("sdcard", "initialize", ret);
+    return -1;
+  }
+  if (block_size != BLOCK_SIZE || size_in_kB < (FIRST_SECTOR + SECTORS) / 2) {
+    printf("# Need %d-byte blocks and at least %d kB\n", BLOCK_SIZE, (FIRST_SECTOR + SECTORS) / 2);
+    return -1;
+  }
+
+  bench_header("SD card benchmark");
+  for (unsigned c = 0; c < sizeof(block_counts) / sizeof(block_counts[0]); c++) {
+    run(true, false, block_counts[c]);
+    run(false, false, block_counts[c]);
+    run(true, true, block_counts[c]);
+    run(false, true, block_counts[c]);
+  }
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include <libtock-sync/services/benchmark.h>
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+#include <libtock/services/time.h>
+#include <libtock/tock.h>
+#include <libtock/tock_inline.h>
+
+// Each benchmark makes one raw system call through `tock_inline.h`, which
+// bypasses libtock's caches, so the numbers are the trap and the kernel's
+// dispatch alone. The alarm driver exists on every board.
+
+static uint8_t buffer[16];
+
+static void bench_command(void) {
+  syscall_return_t ret = tock_inline_command(DRIVER_NUM_ALARM, 2, 0, 0);
+  BENCH_KEEP(ret.data[0]);
+}
+
+// The alarm upcall libtock installed. The subscribe benchmark puts the same
+// one back each time, so the kernel keeps matching libtock's subscribe cache.
+static subscribe_upcall* alarm_upcall;
+static void* alarm_userdata;
+
+static void bench_subscribe(void) {
+  subscribe_return_t ret = tock_inline_subscribe(DRIVER_NUM_ALARM, 0, alarm_upcall, alarm_userdata);
+  BENCH_KEEP(ret.success);
+}
+
+static void bench_allow_readwrite(void) {
+  allow_rw_return_t ret = tock_inline_allow_readwrite(DRIVER_NUM_ALARM, 0, buffer, sizeof(buffer));
+  BENCH_KEEP(ret.success);
+}
+
+static void bench_allow_readonly(void) {
+  allow_ro_return_t ret = tock_inline_allow_readonly(DRIVER_NUM_ALARM, 0, buffer, sizeof(buffer));
+  BENCH_KEEP(ret.success);
+}
+
+static void bench_yield_no_wait(void) {
+  BENCH_KEEP(yield_no_wait());
+}
+
+int main(void) {
+  // The harness's clock sets its wrap alarm first. Take the upcall out of
+  // the kernel to learn it, and put it straight back.
+  libtock_time_frequency();
+  subscribe_return_t installed = tock_inline_subscribe(DRIVER_NUM_ALARM, 0, NULL, NULL);
+  alarm_upcall   = installed.callback;
+  alarm_userdata = installed.userdata;
+  tock_inline_subscribe(DRIVER_NUM_ALARM, 0, alarm_upcall, alarm_userdata);
+
+  libtocksync_benchmark_t benches[] = {
+    BENCH(command, 100),
+    BENCH(subscribe, 100),
+    BENCH(allow_readwrite, 100),
+    BENCH(allow_readonly, 100),
+    BENCH(yield_no_wait, 100),
+  };
+  libtocksync_benchmark_run(benches, sizeof(benches) / sizeof(benches[0]));
+  return 0;
+}
@@ -18,6 +18,7 @@
 #include <libtock/interface/console.h>
 #include <libtock/tock.h>
 
+#include "ble_notify_queue.h"
 #include "ble_nus.h"
 #include "nrf.h"
 
@@ -34,8 +35,8 @@ simple_ble_config_t ble_config = {
   .device_id         = DEVICE_ID_DEFAULT,
   .adv_name          = "tock-uart",
   .adv_interval      = MSEC_TO_UNITS(500, UNIT_0_625_MS),
-  .min_conn_interval = MSEC_TO_UNITS(1000, UNIT_1_25_MS),
-  .max_conn_interval = MSEC_TO_UNITS(1250, UNIT_1_25_MS)
+  .min_conn_interval = MSEC_TO_UNITS(15, UNIT_1_25_MS),
+  .max_conn_interval = MSEC_TO_UNITS(30, UNIT_1_25_MS)
 };
 
 // State for UART library.
@@ -53,6 +54,9 @@ void ble_evt_user_handler(ble_evt_t* p_ble_evt) {
   conn_params.slave_latency     = SLAVE_LATENCY;
   conn_params.conn_sup_timeout  = CONN_SUP_TIMEOUT;
 
+  // Console bytes go out as notifications of the NUS RX characteristic.
+  ble_notify_queue_on_ble_evt(p_ble_evt);
+
   switch (p_ble_evt->header.evt_id) {
     case BLE_GAP_EVT_CONN_PARAM_UPDATE:
       // just update them right now
@@ -99,6 +103,23 @@ void services_init(void) {
   nus_init.data_handler = nus_data_handler;
   err_code = ble_nus_init(&m_nus, &nus_init);
   APP_ERROR_CHECK(err_code);
+
+  ble_notify_queue_init(m_nus.rx_handles.value_handle);
+}
+
+/*******************************************************************************
+ * CONSOLE
+ ******************************************************************************/
+
+static uint8_t console_byte;
+
+// Forward each byte typed on the console. Bytes queue up while the
+// SoftDevice's transmit buffers are full and leave in full notifications.
+static void console_read_done(returncode_t ret, uint32_t len) {
+  if (ret == RETURNCODE_SUCCESS && len == 1) {
+    ble_notify_queue_write(&console_byte, 1);
+  }
+  libtock_console_read(&console_byte, 1, console_read_done);
 }
 
 
@@ -116,6 +137,8 @@ int main(void) {
   ble_uuid_t adv_uuid = {0x0001, BLE_UUID_TYPE_VENDOR_BEGIN};
   simple_adv_service(&adv_uuid);
 
+  libtock_console_read(&console_byte, 1, console_read_done);
+
   while (1) {
     yield();
   }
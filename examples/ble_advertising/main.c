@@ -3,6 +3,7 @@
 
 #include <gap.h>
 
+#include <libtock-sync/services/alarm.h>
 #include <libtock/net/ble.h>
 #include <libtock/tock.h>
 
@@ -56,12 +57,13 @@ int main(void) {
     printf("ble_advertise_manufacturer_specific_data, error: %s\r\n",
            tock_strrcode(err));
 
-  // configure service data
+  // reserve service data, which is updated in place below
   printf(" - Setting service data...\n");
-  err = gap_add_service_data(&adv_data, uuids[1], fake_temperature_data,
-                             FAKE_TEMPERATURE_DATA_SIZE);
-  if (err < RETURNCODE_SUCCESS)
-    printf("ble_advertise_service_data, error: %s\r\n", tock_strrcode(err));
+  int temperature_offset = gap_reserve_service_data(&adv_data, uuids[1],
+                                                    FAKE_TEMPERATURE_DATA_SIZE);
+  if (temperature_offset < RETURNCODE_SUCCESS)
+    printf("ble_advertise_service_data, error: %s\r\n",
+           tock_strrcode(temperature_offset));
 
   // start advertising
   printf(" - Begin advertising! %s\n", device_name);
@@ -73,7 +75,13 @@ int main(void) {
   printf("Now advertising every %d ms as '%s'\n", advertising_interval_ms,
          device_name);
 
+  // rotate the fake temperature every second without restarting advertising
   while (1) {
-    yield();
+    libtocksync_alarm_delay_ms(1000);
+    fake_temperature_data[0]++;
+    if (temperature_offset >= 0) {
+      gap_update_field(&adv_data, temperature_offset, fake_temperature_data,
+                       FAKE_TEMPERATURE_DATA_SIZE);
+    }
   }
 }
@@ -16,6 +16,14 @@ Advertisement::Advertisement(const unsigned char* buf, int len) {
   std::memcpy(&data_, &buf[DATA_START], data_len);
 }
 
+Advertisement::Advertisement(const libtock_ble_scan_report_t& report) {
+  std::memset(&data_, 0, DATA_MAX_SIZE);
+  header_[0] = report.pdu_type | (report.random_address ? PDU_TXADD_HEADER_MASK : 0);
+  header_[1] = ADDRESS_SIZE + report.data_len;
+  std::memcpy(&address_, report.address, ADDRESS_SIZE);
+  std::memcpy(&data_, report.data, report.data_len);
+}
+
 bool Advertisement::device_detected(const Advertisement& other) const {
   return std::memcmp(&address_, &other.address_, ADDRESS_SIZE) == 0;
 }
@@ -3,6 +3,8 @@
 #include <cstdio>
 #include <cstring>
 
+#include <libtock/services/ble_scan.h>
+
 const unsigned char HEADER_START = 0;
 const unsigned char HEADER_SIZE = 2;
 const unsigned char ADDRESS_START = 2;
@@ -27,6 +29,7 @@ class Advertisement {
   public:
     // Constructors
     Advertisement(const unsigned char* buf, int len);
+    explicit Advertisement(const libtock_ble_scan_report_t& report);
     Advertisement();
 
     // Methods
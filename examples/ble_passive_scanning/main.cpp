@@ -1,6 +1,6 @@
 #include <stdio.h>
 
-#include <libtock/net/ble.h>
+#include <libtock/services/ble_scan.h>
 
 #include "advertisement.h"
 #include "advertisement_list.h"
@@ -8,41 +8,46 @@
 /*
  * BLE Demo Application
  * Passive scanner for Bluetooth Low Energy advertisements
+ *
+ * Advertisements are queued by the scan service, which drops repeats of the
+ * same advertisement within DEDUP_MS so busy environments do not swamp the
+ * app.
  */
 
-const int BUF_SIZE = 39;
-static unsigned char scan[BUF_SIZE];
+const int REPORTS  = 8;
+const int DEDUP_MS = 1000;
+static libtock_ble_scan_report_t reports[REPORTS];
 AdvertisementList list;
 
-static void callback(int result, int len, __attribute__((unused)) int unused2,
-                     __attribute__((unused)) void* ud) {
-  if (result == RETURNCODE_SUCCESS) {
-    if (Advertisement::checkScanResult(scan, len)) {
-      Advertisement advertisement(scan, len);
-
-      if (list.tryAdd(advertisement)) {
-        list.printList();
-      }
-      // FIXME: add this to get dynamic behavior i.e, update every time new advertisement is detected
-      // but might it fill the print buffer, use at your own risk
-      // else if (list.tryUpdateData(advertisement)) {
-      //   list.printList();
-      // }
-    }
-  }
-}
-
 int main(void) {
   printf("[Tutorial] BLE Passive Scanner\r\n");
 
+  libtock_ble_scan_filter_t filter = {};
+  filter.dedup_ms = DEDUP_MS;
+
   // using the pre-configured advertisement interval
-  int err = ble_start_passive_scan(scan, BUF_SIZE, callback);
+  int err = libtock_ble_scan_start(reports, REPORTS, &filter, NULL);
 
   if (err < RETURNCODE_SUCCESS) {
-    printf("ble_start_passive_scan, error: %s\r\n", tock_strrcode(static_cast<returncode_t>(err)));
+    printf("libtock_ble_scan_start, error: %s\r\n", tock_strrcode(static_cast<returncode_t>(err)));
   }
 
   while (1) {
     yield();
+
+    const libtock_ble_scan_report_t* report;
+    while ((report = libtock_ble_scan_peek()) != NULL) {
+      Advertisement advertisement(*report);
+      libtock_ble_scan_release();
+
+      if (list.tryAdd(advertisement)) {
+        list.printList();
+      }
+      // FIXME: add this to get dynamic behavior i.e, update every time new advertisement is detected
+      // but might it fill the print buffer, use at your own risk
+      // else if (list.tryUpdateData(advertisement)) {
+      //   list.printList();
+      // }
+    }
   }
 }
@@ -1,24 +1,25 @@
-#include <libtock/interface/button.h>
 #include <libtock/interface/led.h>
+#include <libtock/services/button_debounce.h>
 
-// Callback for button presses.
-static void button_callback(__attribute__ ((unused)) returncode_t ret, int btn_num, bool pressed) {
-  if (pressed) {
-    libtock_led_toggle(btn_num);
+// Callback for debounced button events.
+static void button_callback(int btn_num, libtock_button_event_t event) {
+  switch (event) {
+    case LIBTOCK_BUTTON_PRESS:
+      libtock_led_toggle(btn_num);
+      break;
+    case LIBTOCK_BUTTON_LONG_PRESS:
+      // A long press turns the LED off, whatever the press toggled it to.
+      libtock_led_off(btn_num);
+      break;
+    default:
+      break;
   }
 }
 
 int main(void) {
-  int err;
-
   // Enable interrupts on each button.
-  int count;
-  err = libtock_button_count(&count);
-  if (err < 0) return err;
-
-  for (int i = 0; i < count; i++) {
-    libtock_button_notify_on_press(i, button_callback);
-  }
+  returncode_t err = libtock_button_debounce_start(button_callback);
+  if (err != RETURNCODE_SUCCESS) return err;
 
   while (1) {
     yield();
@@ -0,0 +1,46 @@
+#include <chrono>
+#include <cstdio>
+
+#include <libtock++/chrono.hpp>
+#include <libtock/interface/led.h>
+#include <libtock/tock.h>
+
+using namespace std::chrono_literals;
+
+static libtock::Timer blink_timer;
+static libtock::Timer stop_timer;
+static int blinks  = 0;
+static bool stopped = false;
+
+static void blink(void*) {
+  libtock_led_toggle(0);
+  blinks++;
+  blink_timer.start(250ms, blink, nullptr);
+}
+
+static void stop(void*) {
+  blink_timer.cancel();
+  stopped = true;
+}
+
+int main(void) {
+  printf("[cxx_chrono] clock runs at %lu Hz\n", libtock::steady_clock::frequency());
+
+  // Time a busy loop.
+  auto start = libtock::steady_clock::now();
+  volatile uint32_t sum = 0;
+  for (uint32_t i = 0; i < 100000; i++) {
+    sum = sum + i;
+  }
+  auto took = libtock::steady_clock::now() - start;
+  printf("[cxx_chrono] loop took %ld us\n", static_cast<long>(took.count()));
+
+  // Two timers share the alarm queue: one blinks, the other stops it.
+  blink_timer.start(250ms, blink, nullptr);
+  stop_timer.start_at(libtock::steady_clock::now() + 3s, stop, nullptr);
+  yield_for(&stopped);
+
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(libtock::steady_clock::now() - start);
+  printf("[cxx_chrono] %d blinks, %ld ms after start\n", blinks, static_cast<long>(ms.count()));
+  return 0;
+}
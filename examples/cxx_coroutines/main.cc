@@ -0,0 +1,44 @@
+#include <stdio.h>
+
+#include <libtock++/task.hpp>
+
+// Prints a tick every `period_ms` milliseconds, `count` times.
+static libtock::Task<int> ticker(const char* name, uint32_t period_ms, int count) {
+  for (int i = 0; i < count; i++) {
+    co_await libtock::alarm_ms(period_ms);
+    printf("[%s] tick %d\n", name, i);
+  }
+  co_return count;
+}
+
+// Runs two tickers back to back.
+static libtock::Task<> sequence() {
+  int total = co_await ticker("seq-a", 300, 3);
+  total += co_await ticker("seq-b", 200, 3);
+  printf("[sequence] done after %d ticks\n", total);
+}
+
+// Echoes console input until a 'q' is received.
+static libtock::Task<> echo() {
+  uint8_t c = 0;
+  while (c != 'q') {
+    auto r = co_await libtock::console_read(&c, 1);
+    if (r.ret != RETURNCODE_SUCCESS) {
+      printf("[echo] read failed: %d\n", r.ret);
+      co_return;
+    }
+    printf("[echo] got '%c'\n", c);
+  }
+}
+
+int main() {
+  printf("[cxx_coroutines] type characters, 'q' to stop echoing\n");
+
+  auto fast = ticker("fast", 100, 10);
+  auto seq  = sequence();
+  auto in   = echo();
+  libtock::run(fast, seq, in);
+
+  printf("[cxx_coroutines] all tasks finished\n");
+  return 0;
+}
@@ -0,0 +1,51 @@
+#include <cstdio>
+
+#include <libtock++/driver.hpp>
+#include <libtock-sync/services/alarm.h>
+#include <libtock/interface/syscalls/console_syscalls.h>
+#include <libtock/interface/syscalls/led_syscalls.h>
+
+using Console = libtock::Driver<DRIVER_NUM_CONSOLE>;
+using Led     = libtock::Driver<DRIVER_NUM_LED>;
+
+static bool write_done = false;
+
+static void write_upcall(int, int, int, void*) {
+  write_done = true;
+}
+
+// Write `msg` to the console without going through `printf()`.
+static returncode_t console_write(std::span<const char> msg) {
+  returncode_t ret = Console::subscribe<1>(write_upcall);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  libtock::ReadOnlyAllow<Console, 1> allow(msg);
+  if (!allow) return allow.status();
+
+  write_done = false;
+  ret        = Console::command<1>(static_cast<int>(msg.size()));
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  yield_for(&write_done);
+  return RETURNCODE_SUCCESS;
+}
+
+int main() {
+  // The same buffer is written every time, so keep it shared.
+  Console::set_persistent_ro<1>();
+
+  static constexpr char hello[] = "Hello from C++\n";
+  std::span<const char> msg(hello, sizeof(hello) - 1);
+  console_write(msg);
+
+  auto leds = Led::command_u32<0>();
+  if (!leds || *leds == 0) {
+    printf("No LEDs: %s\n", tock_strrcode(leds.ret));
+    return 0;
+  }
+
+  while (true) {
+    Led::command<3>(0);
+    console_write(msg);
+    libtocksync_alarm_delay_ms(500);
+  }
+}
@@ -1,7 +1,7 @@
-#include <math.h>
 #include <stdio.h>
 
 #include <libtock-sync/sensors/ninedof.h>
+#include <libtock/dsp/vector.h>
 #include <libtock/interface/led.h>
 
 int main(void) {
@@ -27,16 +27,16 @@ int main(void) {
     }
     printf("x: %d, y: %d, z: %d\n", x, y, z);
 
-    // Compute the X-Y angle of the board.
-    double angle = atan2((double) y, (double) x);
+    // Compute the X-Y angle of the board, in hundredths of a degree.
+    int angle = libtock_dsp_atan2_cdeg(y, x);
     if (y > 0) {
-      angle = 90 - angle * (180 / M_PI);
+      angle = 9000 - angle;
     } else {
-      angle = 270 - angle * (180 / M_PI);
+      angle = 27000 - angle;
     }
 
     // Turn the LED on if the board is pointing in a certain range.
-    if (angle > 50 && angle < 310) {
+    if (angle > 5000 && angle < 31000) {
       libtock_led_off(led);
     } else {
       libtock_led_on(led);
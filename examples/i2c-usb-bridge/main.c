@@ -4,6 +4,7 @@
 #include <unistd.h>
 
 #include <libtock-sync/interface/console.h>
+#include <libtock-sync/services/usb_cdc.h>
 #include <libtock/peripherals/i2c_master.h>
 
 #define DATA_LEN 64
@@ -148,6 +149,161 @@ static void write_data(char* command) {
   printf("Application Operation complete\n");
 }
 
+// ***** Batch mode *****
+
+// After the `b` command the console becomes a binary channel, run by
+// `usb_cdc`, and each frame from the host carries a batch of I2C operations
+// that are all run before one response frame returns their results. See the
+// README for the frame format.
+
+#define FRAME_MAGIC 0xB5
+#define FRAME_HEADER_LEN 4
+#define FRAME_PAYLOAD_MAX 512
+#define RESPONSE_PAYLOAD_MAX 1024
+
+// Host frames are padded to whole USB packets, so every read completes.
+#define FRAME_PADDING 64
+
+#define OP_WRITE 'w'
+#define OP_READ 'r'
+#define OP_WRITE_READ 'x'
+#define OP_HEADER_LEN 4
+
+// Bytes received and not yet handled. The receive callback only appends; the
+// frames are run from the main loop, which can wait on the bus.
+static uint8_t rx_buf[FRAME_HEADER_LEN + FRAME_PAYLOAD_MAX + FRAME_PADDING];
+static uint32_t rx_len;
+static bool rx_overflow;
+
+static uint8_t response[FRAME_HEADER_LEN + 1 + RESPONSE_PAYLOAD_MAX];
+static uint8_t op_buf[UINT8_MAX];
+
+static void batch_rx(const uint8_t* data, uint32_t len) {
+  if (len > sizeof(rx_buf) - rx_len) {
+    rx_overflow = true;
+    return;
+  }
+  memcpy(rx_buf + rx_len, data, len);
+  rx_len += len;
+}
+
+static uint32_t padded(uint32_t len) {
+  return (len + FRAME_PADDING - 1) / FRAME_PADDING * FRAME_PADDING;
+}
+
+// Check that the payload is a list of whole operations and that their
+// results fit a response. Returns the number of operations, or -1.
+static int validate(const uint8_t* payload, uint32_t len) {
+  uint32_t pos = 0, out = 0;
+  int ops      = 0;
+  while (pos < len) {
+    if (len - pos < OP_HEADER_LEN) return -1;
+    uint8_t kind = payload[pos];
+    uint8_t wlen = payload[pos + 2];
+    uint8_t rlen = payload[pos + 3];
+    if (kind != OP_WRITE && kind != OP_READ && kind != OP_WRITE_READ) return -1;
+    if (len - pos - OP_HEADER_LEN < wlen) return -1;
+
+    pos += OP_HEADER_LEN + wlen;
+    out += 1 + rlen;
+    ops++;
+  }
+  return out <= RESPONSE_PAYLOAD_MAX ? ops : -1;
+}
+
+static int run_op(uint8_t kind, uint8_t address, const uint8_t* wdata, uint8_t wlen, uint8_t rlen) {
+  memcpy(op_buf, wdata, wlen);
+  switch (kind) {
+    case OP_WRITE:
+      return i2c_master_write_sync(address, op_buf, wlen);
+    case OP_READ:
+      return i2c_master_read_sync(address, op_buf, rlen);
+    default:
+      return i2c_master_write_read_sync(address, op_buf, wlen, rlen);
+  }
+}
+
+static void send_response(uint8_t seq, uint32_t payload_len) {
+  response[0] = FRAME_MAGIC;
+  response[1] = seq;
+  response[2] = (uint8_t) payload_len;
+  response[3] = (uint8_t) (payload_len >> 8);
+  libtocksync_usb_cdc_write(response, FRAME_HEADER_LEN + payload_len);
+}
+
+// Run the operations of one frame and send its response.
+static void run_frame(uint8_t seq, const uint8_t* payload, uint32_t len) {
+  uint8_t* out = response + FRAME_HEADER_LEN;
+  if (validate(payload, len) < 0) {
+    out[0] = (uint8_t) RETURNCODE_EINVAL;
+    send_response(seq, 1);
+    return;
+  }
+
+  out[0] = RETURNCODE_SUCCESS;
+  uint32_t n = 1;
+  for (uint32_t pos = 0; pos < len; ) {
+    uint8_t kind    = payload[pos];
+    uint8_t address = payload[pos + 1];
+    uint8_t wlen    = payload[pos + 2];
+    uint8_t rlen    = payload[pos + 3];
+    const uint8_t* wdata = payload + pos + OP_HEADER_LEN;
+    pos += OP_HEADER_LEN + wlen;
+    if (kind == OP_WRITE) rlen = 0;
+
+    int ret = run_op(kind, address, wdata, wlen, rlen);
+    out[n++] = (uint8_t) ret;
+    // Results keep their length on errors, so the host can always parse them.
+    if (ret == RETURNCODE_SUCCESS) {
+      memcpy(out + n, op_buf, rlen);
+    } else {
+      memset(out + n, 0, rlen);
+    }
+    n += rlen;
+  }
+  send_response(seq, n);
+}
+
+static void batch_mode(void) {
+  printf("OK batch\n");
+  if (libtock_usb_cdc_start(FRAME_PADDING, batch_rx, NULL) != RETURNCODE_SUCCESS) return;
+
+  while (1) {
+    yield();
+    if (rx_overflow) {
+      // Lost bytes leave the stream unaligned; drop everything and let the
+      // host resend.
+      rx_len      = 0;
+      rx_overflow = false;
+    }
+
+    while (rx_len >= FRAME_HEADER_LEN) {
+      if (rx_buf[0] != FRAME_MAGIC) {
+        // Resynchronize at the next packet.
+        uint32_t skip = rx_len < FRAME_PADDING ? rx_len : FRAME_PADDING;
+        memmove(rx_buf, rx_buf + skip, rx_len - skip);
+        rx_len -= skip;
+        continue;
+      }
+
+      uint32_t len   = rx_buf[2] | ((uint32_t) rx_buf[3] << 8);
+      uint32_t frame = padded(FRAME_HEADER_LEN + len);
+      if (len > FRAME_PAYLOAD_MAX) {
+        response[FRAME_HEADER_LEN] = (uint8_t) RETURNCODE_ESIZE;
+        send_response(rx_buf[1], 1);
+        frame = rx_len < FRAME_PADDING ? rx_len : FRAME_PADDING;
+      } else if (rx_len < frame) {
+        break;
+      } else {
+        run_frame(rx_buf[1], rx_buf + FRAME_HEADER_LEN, len);
+      }
+
+      memmove(rx_buf, rx_buf + frame, rx_len - frame);
+      rx_len -= frame;
+    }
+  }
+}
+
 int main(void) {
   printf("I2C USB Bridge\n");
 
@@ -163,6 +319,9 @@ int main(void) {
       read_data(command_buf);
     } else if (strncmp(command_buf, "w", 1) == 0) {
       write_data(command_buf);
+    } else if (strncmp(command_buf, "b", 1) == 0) {
+      batch_mode();
+      printf("Unable to start batch mode\n");
     } else {
       printf("Invalid command: %s\n", command_buf);
       printf("Check the app README for instructinos\n");
@@ -0,0 +1,61 @@
+#include <stdio.h>
+
+#include <libtock-sync/net/ieee802154.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock/net/udp.h>
+#include <libtock/services/telemetry.h>
+
+static unsigned char BUF_BIND_CFG[2 * sizeof(sock_addr_t)];
+
+int main(void) {
+  printf("[IPv6_Telemetry] Starting IPv6 Telemetry App.\n");
+
+  libtock_ieee802154_set_pan(0xABCD);
+  libtock_ieee802154_config_commit();
+  libtocksync_ieee802154_up();
+
+  ipv6_addr_t ifaces[10];
+  libtock_udp_list_ifaces(ifaces, 10);
+
+  sock_handle_t handle;
+  sock_addr_t addr = {
+    ifaces[0],
+    15123
+  };
+  int bind_return = libtock_udp_bind(&handle, &addr, BUF_BIND_CFG);
+  if (bind_return < 0) {
+    printf("Failed to bind to port: failure=%d\n", bind_return);
+    return -1;
+  }
+
+  static sock_addr_t destination;
+  destination.addr = ifaces[1];
+  destination.port = 16123;
+
+  libtock_sensor_sampler_enable(LIBTOCK_SENSOR_TEMPERATURE, 1000);
+  libtock_sensor_sampler_enable(LIBTOCK_SENSOR_HUMIDITY, 1000);
+  libtock_sensor_sampler_enable(LIBTOCK_SENSOR_AMBIENT_LIGHT, 1000);
+
+  libtock_telemetry_config_t config = {
+    .dst                  = &destination,
+    .tick_ms              = 1000,
+    .slack_ms             = 50,
+    .records_per_datagram = 8,
+    .datagrams_per_batch  = 2,
+    .buffers              = 4,
+  };
+  returncode_t ret = libtock_telemetry_start(&config);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Failed to start telemetry: %d\n", ret);
+    return -1;
+  }
+
+  while (1) {
+    libtocksync_alarm_delay_ms(16000);
+    libtock_telemetry_stats_t stats;
+    libtock_telemetry_stats(&stats);
+    printf("%lu records, %lu datagrams sent, %lu dropped, %lu send errors\n",
+           (unsigned long) stats.records, (unsigned long) stats.datagrams_sent,
+           (unsigned long) stats.records_dropped, (unsigned long) stats.send_errors);
+  }
+}
@@ -0,0 +1,32 @@
+#include <stdio.h>
+
+#include <lua/lauxlib.h>
+#include <lua/lua.h>
+#include <lua/lualib.h>
+
+#include <ltockalloc.h>
+#include <ltocklib.h>
+#include <ltockscripts.h>
+
+static ltock_alloc_t alloc;
+
+int main(void) {
+  lua_State* L = ltock_newstate(&alloc, NULL);
+  if (L == NULL) {
+    printf("Could not create the Lua state\n");
+    return -1;
+  }
+
+  luaL_requiref(L, "_G", luaopen_base, true);
+  luaL_requiref(L, LUA_COLIBNAME, luaopen_coroutine, true);
+  luaL_requiref(L, LUA_TOCKLIBNAME, luaopen_tock, true);
+  lua_pop(L, 3);
+
+  // The script spawns its tasks and runs them with `tock.run()`, which only
+  // returns if a task fails.
+  if (ltock_load_script(L, "main") != LUA_OK || lua_pcall(L, 0, 0, 0) != LUA_OK) {
+    printf("Lua error: %s\n", lua_tostring(L, -1));
+    return -1;
+  }
+  return 0;
+}
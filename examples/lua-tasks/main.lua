@@ -0,0 +1,42 @@
+-- Each task waits on its own driver; none holds up the others.
+
+-- Blink GPIO pin 0.
+tock.spawn(function ()
+  tock.gpio.output(0)
+  while true do
+    tock.gpio.toggle(0)
+    tock.alarm.delay_ms(250)
+  end
+end)
+
+-- Report the temperature every two seconds.
+tock.spawn(function ()
+  while true do
+    local t, err = tock.sensors.temperature()
+    print("temperature: " .. tostring(t or err))
+    tock.alarm.delay_ms(2000)
+  end
+end)
+
+-- Echo console input a character at a time.
+tock.spawn(function ()
+  local c = tock.buffer(1)
+  while true do
+    if tock.console.read(c) then
+      tock.console.write(c)
+    else
+      tock.alarm.delay_ms(100)
+    end
+  end
+end)
+
+-- Count falling edges on GPIO pin 1, e.g. a button to ground.
+tock.spawn(function (pin)
+  local presses = 0
+  while tock.gpio.wait(pin, "low", "up") do
+    presses = presses + 1
+    print("presses: " .. presses)
+  end
+end, 1)
+
+tock.run()
@@ -0,0 +1,50 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+
+#include <lua/lauxlib.h>
+#include <lua/lua.h>
+#include <lua/lualib.h>
+
+#include <ltockalloc.h>
+#include <ltocklib.h>
+#include <ltockscripts.h>
+
+static ltock_alloc_t alloc;
+static ltock_gc_stats_t gc_stats;
+
+int main(void) {
+  lua_State* L = ltock_newstate(&alloc, NULL);
+  if (L == NULL) {
+    printf("Could not create the Lua state\n");
+    return -1;
+  }
+
+  luaL_requiref(L, "_G", luaopen_base, true);
+  luaL_requiref(L, LUA_TOCKLIBNAME, luaopen_tock, true);
+  lua_pop(L, 2);
+
+  if (ltock_load_script(L, "main") != LUA_OK || lua_pcall(L, 0, 0, 0) != LUA_OK) {
+    printf("Lua error: %s\n", lua_tostring(L, -1));
+    return -1;
+  }
+
+  for (uint32_t n = 1; ; n++) {
+    lua_getglobal(L, "tick");
+    if (lua_pcall(L, 0, 0, 0) != LUA_OK) {
+      printf("Lua error: %s\n", lua_tostring(L, -1));
+      lua_pop(L, 1);
+    }
+
+    // Collect while idle, in the smallest steps, so the script itself rarely
+    // has to.
+    while (!ltock_gc_step(L, 0, &gc_stats)) {}
+
+    if (n % 10 == 0) {
+      printf("> heap %lu B (peak %lu), %lu large, %lu overflowed, GC pause max %lu us\n",
+             alloc.bytes, alloc.peak, alloc.large, alloc.overflows, gc_stats.max_pause_us);
+    }
+    libtocksync_alarm_delay_ms(1000);
+  }
+}
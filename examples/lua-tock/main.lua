@@ -0,0 +1,11 @@
+local report = tock.buffer(16)
+report:write(1, "temperature: ")
+tock.gpio.output(0)
+
+-- Called by the app once a second.
+function tick()
+  local t, err = tock.sensors.temperature()
+  tock.console.write(report, 13)
+  print(t or err)
+  tock.gpio.toggle(0)
+end
@@ -1,4 +0,0 @@
-#pragma once
-
-int lvgl_driver_init (int buffer_size);
-void lvgl_driver_event (int mills);
@@ -1,29 +1,32 @@
 #include <stdio.h>
 
 #include <libtock-sync/display/screen.h>
-#include <libtock-sync/services/alarm.h>
 
+#include <lvgl-tock.h>
 #include <lvgl/lvgl.h>
 
-#include "lvgl_driver.h"
+static unsigned int seconds = 0;
 
 static void event_handler(lv_event_t* e) {
-  lv_event_code_t code  = lv_event_get_code(e);
-  unsigned int* seconds = (unsigned int*)lv_event_get_user_data(e);
+  lv_event_code_t code = lv_event_get_code(e);
 
   if (code == LV_EVENT_CLICKED) {
     LV_LOG_USER("Clicked");
-    *seconds = 0;
+    seconds = 0;
   } else if (code == LV_EVENT_VALUE_CHANGED) {
     LV_LOG_USER("Toggled");
   }
 }
 
-int main(void) {
-  unsigned int seconds = 0;
+static void second_elapsed(lv_timer_t* timer) {
+  lv_obj_t* label = (lv_obj_t*) timer->user_data;
+  seconds++;
+  lv_label_set_text_fmt(label, "Seconds: %u", seconds);
+}
 
+int main(void) {
   libtocksync_screen_set_brightness(100);
-  int status = lvgl_driver_init(5);
+  int status = lvgl_tock_init(5);
   if (status == RETURNCODE_SUCCESS) {
     /* LittlevGL's Hello World tutorial example */
 
@@ -41,23 +44,18 @@ int main(void) {
     lv_obj_align(label1, LV_ALIGN_CENTER, 0, 0);
 
     lv_obj_t* btn1 = lv_btn_create(scr);
-    lv_obj_add_event_cb(btn1, event_handler, LV_EVENT_ALL, &seconds);
+    lv_obj_add_event_cb(btn1, event_handler, LV_EVENT_ALL, NULL);
     lv_obj_align(btn1, LV_ALIGN_CENTER, 0, -40);
 
     lv_obj_t* label = lv_label_create(btn1);
     lv_label_set_text(label, "Reset");
     lv_obj_center(label);
 
-    /* main loop */
+    lv_timer_create(second_elapsed, 1000, label1);
+
+    /* main loop, sleeping between lvgl's timers */
     while (1) {
-      seconds++;
-      if (seconds % 200 == 0) {
-        char buffer[100];
-        snprintf(buffer, 99, "Seconds: %d", seconds / 200);
-        lv_label_set_text(label1, buffer);
-      }
-      libtocksync_alarm_delay_ms(5);
-      lvgl_driver_event(5);
+      lvgl_tock_step();
     }
   } else {
     printf("lvgl init error: %s\n", tock_strrcode(status));
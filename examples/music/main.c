@@ -1,37 +1,47 @@
 #include <stdio.h>
-#include <stdlib.h>
 
-#include <libtock-sync/interface/buzzer.h>
-#include <libtock-sync/services/alarm.h>
+#include <libtock/services/tone_player.h>
 
 // Adapted from https://github.com/robsoncouto/arduino-songs
 
-// Notes in the form of (note_frequency, note_delay in musical terms)
-int melody[] = {
-
-  NOTE_E6, 4,  NOTE_E6, 4,  NOTE_F6, 4,  NOTE_G6, 4,
-  NOTE_G6, 4,  NOTE_F6, 4,  NOTE_E6, 4,  NOTE_D6, 4,
-  NOTE_C6, 4,  NOTE_C6, 4,  NOTE_D6, 4,  NOTE_E6, 4,
-  NOTE_E6, -4, NOTE_D6, 8,  NOTE_D6, 2,
-
-  NOTE_E6, 4,  NOTE_E6, 4,  NOTE_F6, 4,  NOTE_G6, 4,
-  NOTE_G6, 4,  NOTE_F6, 4,  NOTE_E6, 4,  NOTE_D6, 4,
-  NOTE_C6, 4,  NOTE_C6, 4,  NOTE_D6, 4,  NOTE_E6, 4,
-  NOTE_D6, -4,  NOTE_C6, 8,  NOTE_C6, 2,
-
-  NOTE_D6, 4,  NOTE_D6, 4,  NOTE_E6, 4,  NOTE_C6, 4,
-  NOTE_D6, 4,  NOTE_E6, 8,  NOTE_F6, 8,  NOTE_E6, 4, NOTE_C6, 4,
-  NOTE_D6, 4,  NOTE_E6, 8,  NOTE_F6, 8,  NOTE_E6, 4, NOTE_D6, 4,
-  NOTE_C6, 4,  NOTE_D6, 4,  NOTE_G5, 2,
-
-  NOTE_E6, 4,  NOTE_E6, 4,  NOTE_F6, 4,  NOTE_G6, 4,
-  NOTE_G6, 4,  NOTE_F6, 4,  NOTE_E6, 4,  NOTE_D6, 4,
-  NOTE_C6, 4,  NOTE_C6, 4,  NOTE_D6, 4,  NOTE_E6, 4,
-  NOTE_D6, -4,  NOTE_C6, 8,  NOTE_C6, 2
+#define TEMPO 114
 
+// Length of a whole note, and of notes that are 1/`divider` of one, which
+// sound for 90% of their length with a pause for the rest. Dotted notes are
+// half as long again.
+#define WHOLE_NOTE_MS ((60000 * 4) / TEMPO)
+#define TONE(freq, ms) { (freq), (ms) * 9 / 10, (ms) - (ms) * 9 / 10 }
+#define NOTE(freq, divider) TONE(freq, WHOLE_NOTE_MS / (divider))
+#define DOTTED(freq, divider) TONE(freq, WHOLE_NOTE_MS / (divider) * 3 / 2)
+
+static const libtock_tone_t melody[] = {
+  NOTE(NOTE_E6, 4), NOTE(NOTE_E6, 4), NOTE(NOTE_F6, 4), NOTE(NOTE_G6, 4),
+  NOTE(NOTE_G6, 4), NOTE(NOTE_F6, 4), NOTE(NOTE_E6, 4), NOTE(NOTE_D6, 4),
+  NOTE(NOTE_C6, 4), NOTE(NOTE_C6, 4), NOTE(NOTE_D6, 4), NOTE(NOTE_E6, 4),
+  DOTTED(NOTE_E6, 4), NOTE(NOTE_D6, 8), NOTE(NOTE_D6, 2),
+
+  NOTE(NOTE_E6, 4), NOTE(NOTE_E6, 4), NOTE(NOTE_F6, 4), NOTE(NOTE_G6, 4),
+  NOTE(NOTE_G6, 4), NOTE(NOTE_F6, 4), NOTE(NOTE_E6, 4), NOTE(NOTE_D6, 4),
+  NOTE(NOTE_C6, 4), NOTE(NOTE_C6, 4), NOTE(NOTE_D6, 4), NOTE(NOTE_E6, 4),
+  DOTTED(NOTE_D6, 4), NOTE(NOTE_C6, 8), NOTE(NOTE_C6, 2),
+
+  NOTE(NOTE_D6, 4), NOTE(NOTE_D6, 4), NOTE(NOTE_E6, 4), NOTE(NOTE_C6, 4),
+  NOTE(NOTE_D6, 4), NOTE(NOTE_E6, 8), NOTE(NOTE_F6, 8), NOTE(NOTE_E6, 4), NOTE(NOTE_C6, 4),
+  NOTE(NOTE_D6, 4), NOTE(NOTE_E6, 8), NOTE(NOTE_F6, 8), NOTE(NOTE_E6, 4), NOTE(NOTE_D6, 4),
+  NOTE(NOTE_C6, 4), NOTE(NOTE_D6, 4), NOTE(NOTE_G5, 2),
+
+  NOTE(NOTE_E6, 4), NOTE(NOTE_E6, 4), NOTE(NOTE_F6, 4), NOTE(NOTE_G6, 4),
+  NOTE(NOTE_G6, 4), NOTE(NOTE_F6, 4), NOTE(NOTE_E6, 4), NOTE(NOTE_D6, 4),
+  NOTE(NOTE_C6, 4), NOTE(NOTE_C6, 4), NOTE(NOTE_D6, 4), NOTE(NOTE_E6, 4),
+  DOTTED(NOTE_D6, 4), NOTE(NOTE_C6, 8), NOTE(NOTE_C6, 2)
 };
 
-#define TEMPO 114
+static bool done = false;
+
+static void song_done(returncode_t ret) {
+  if (ret != RETURNCODE_SUCCESS) printf("Playing failed: %d\n", ret);
+  done = true;
+}
 
 int main(void) {
   if (!libtock_buzzer_exists()) {
@@ -40,23 +50,8 @@ int main(void) {
   }
 
   printf("Ode of Joy\n");
-  int notes     = sizeof(melody) / sizeof(melody[0]) / 2;
-  int wholenote = (60000 * 4) / TEMPO;
-  for (int note = 0; note < notes * 2; note = note + 2) {
-
-    // calculates the duration of each note
-    int divider       = melody[note + 1];
-    int note_duration = 0;
-    if (divider > 0) {
-      // regular note, just proceed
-      note_duration = (wholenote) / divider;
-    } else if (divider < 0) {
-      // dotted notes are represented with negative durations!!
-      note_duration  = (wholenote) / abs(divider);
-      note_duration *= 1.5; // increases the duration in half for dotted notes
-    }
-
-    // we only play the note for 90% of the duration, leaving 10% as a pause
-    libtocksync_buzzer_tone(melody[note], note_duration * 0.9);
-  }
+  // The song plays in the background; the app only wakes for its alarms.
+  libtock_tone_player_play(melody, sizeof(melody) / sizeof(melody[0]), song_done);
+  yield_for(&done);
+  return 0;
 }
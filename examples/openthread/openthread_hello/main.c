@@ -53,15 +53,7 @@ int main(__attribute__((unused)) int argc, __attribute__((unused)) char* argv[])
   /* Start the Thread stack (CLI cmd -> thread start) */
   otThreadSetEnabled(instance, true);
 
-  for ( ;;) {
-    otTaskletsProcess(instance);
-    otSysProcessDrivers(instance);
-
-    if (!otTaskletsArePending(instance) && !openthread_platform_pending_work()) {
-      yield();
-    }
-
-  }
+  otTockRun(instance);
 
   return 0;
 }
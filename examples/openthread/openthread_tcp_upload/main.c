@@ -0,0 +1,187 @@
+#include <assert.h>
+
+#include <libopenthread/platform/openthread-system.h>
+#include <libopenthread/platform/plat.h>
+#include <libopenthread/platform/tock_tcp.h>
+#include <openthread/dataset_ftd.h>
+#include <openthread/instance.h>
+#include <openthread/ip6.h>
+#include <openthread/platform/alarm-milli.h>
+#include <openthread/tasklet.h>
+#include <openthread/thread.h>
+
+#include <libtock/tock.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TCP_PORT 30000
+
+// Upload this many bytes, from `CHUNKS` buffers of `CHUNK_SIZE` bytes that
+// are refilled as the peer acknowledges them.
+#define UPLOAD_SIZE (64U * 1024U)
+#define CHUNKS 3
+#define CHUNK_SIZE 512
+
+static otTockTcp sStream;
+static uint8_t sReceiveBuffer[OT_TCP_RECEIVE_BUFFER_SIZE_FEW_HOPS];
+static uint8_t sChunks[CHUNKS][CHUNK_SIZE];
+
+// Bytes handed to the stream so far, and acknowledged by the peer.
+static uint32_t sQueued;
+static uint32_t sAcked;
+static uint32_t sStartMs;
+static bool sStarted;
+
+// helper utility demonstrating network config setup
+static void setNetworkConfiguration(otInstance* aInstance);
+
+// callback for Thread state change events
+static void stateChangeCallback(uint32_t flags, void* context);
+
+// Fill `chunk` with the next part of the upload and queue it.
+static void queueChunk(uint8_t* chunk) {
+  uint32_t left = UPLOAD_SIZE - sQueued;
+  size_t len    = left < CHUNK_SIZE ? left : CHUNK_SIZE;
+  if (len == 0) return;
+
+  for (size_t i = 0; i < len; i++) {
+    chunk[i] = (uint8_t) (sQueued + i);
+  }
+
+  bool more     = sQueued + len < UPLOAD_SIZE;
+  otError error = otTockTcpSend(&sStream, chunk, len, more);
+  if (error != OT_ERROR_NONE) {
+    printf("[TCP] send failed: %d\n", error);
+    return;
+  }
+  sQueued += len;
+  if (!more) otTockTcpShutdown(&sStream);
+}
+
+static void connected(__attribute__((unused)) otTockTcp* aStream) {
+  printf("[TCP] connected, uploading %u bytes\n", UPLOAD_SIZE);
+  sStartMs = otPlatAlarmMilliGetNow();
+  for (int i = 0; i < CHUNKS; i++) {
+    queueChunk(sChunks[i]);
+  }
+}
+
+static void sent(__attribute__((unused)) otTockTcp* aStream, const uint8_t* aData, size_t aLength) {
+  sAcked += aLength;
+  if (sAcked == UPLOAD_SIZE) {
+    uint32_t ms = otPlatAlarmMilliGetNow() - sStartMs;
+    printf("[TCP] uploaded %u bytes in %lu ms\n", UPLOAD_SIZE, (unsigned long) ms);
+    return;
+  }
+  // The chunk is the app's again, so reuse it for the next part.
+  queueChunk((uint8_t*) aData);
+}
+
+static void received(__attribute__((unused)) otTockTcp* aStream, const uint8_t* aData, size_t aLength, bool aEnd) {
+  if (aLength > 0) printf("[TCP] %.*s\n", (int) aLength, (const char*) aData);
+  if (aEnd) printf("[TCP] peer finished\n");
+}
+
+static void closed(__attribute__((unused)) otTockTcp* aStream, otTcpDisconnectedReason aReason) {
+  printf("[TCP] closed (%d) after %lu of %u bytes\n", aReason, (unsigned long) sAcked, UPLOAD_SIZE);
+}
+
+static const otTockTcpCallbacks sCallbacks = {
+  .connected = connected,
+  .sent      = sent,
+  .received  = received,
+  .closed    = closed,
+};
+
+// Upload to the leader, which is the router set up in the README.
+static void startUpload(otInstance* aInstance) {
+  otSockAddr peer;
+  memset(&peer, 0, sizeof(peer));
+  if (otThreadGetLeaderRloc(aInstance, &peer.mAddress) != OT_ERROR_NONE) return;
+  peer.mPort = TCP_PORT;
+
+  sQueued = 0;
+  sAcked  = 0;
+  otError error = otTockTcpConnect(&sStream, aInstance, &peer, sReceiveBuffer, sizeof(sReceiveBuffer),
+                                   &sCallbacks, NULL);
+  if (error != OT_ERROR_NONE) {
+    printf("[TCP] connect failed: %d\n", error);
+    return;
+  }
+  sStarted = true;
+}
+
+int main(__attribute__((unused)) int argc, __attribute__((unused)) char* argv[]) {
+  otSysInit(argc, argv);
+  otInstance* instance;
+  instance = otInstanceInitSingle();
+  assert(instance);
+
+  setNetworkConfiguration(instance);
+
+  // set child timeout to 60 seconds
+  otThreadSetChildTimeout(instance, 60);
+
+  /* Start the Thread network interface (CLI cmd -> ifconfig up) */
+  otIp6SetEnabled(instance, true);
+
+  otSetStateChangedCallback(instance, stateChangeCallback, instance);
+
+  /* Start the Thread stack (CLI cmd -> thread start) */
+  otThreadSetEnabled(instance, true);
+
+  for ( ;;) {
+    // main loop work
+    otTockProcess(instance);
+  }
+
+  return 0;
+}
+
+void setNetworkConfiguration(otInstance* aInstance) {
+  otOperationalDataset aDataset;
+
+  memset(&aDataset, 0, sizeof(otOperationalDataset));
+
+  /* Set Channel to 26 */
+  aDataset.mChannel = 26;
+  aDataset.mComponents.mIsChannelPresent = true;
+
+  /* Set Pan ID to abcd */
+  aDataset.mPanId = (otPanId)0xabcd;
+  aDataset.mComponents.mIsPanIdPresent = true;
+
+  /* Set network key to 00112233445566778899aabbccddeeff */
+  uint8_t key[OT_NETWORK_KEY_SIZE] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+  memcpy(aDataset.mNetworkKey.m8, key, sizeof(aDataset.mNetworkKey));
+  aDataset.mComponents.mIsNetworkKeyPresent = true;
+
+  otError error = otDatasetSetActive(aInstance, &aDataset);
+  assert(error == 0);
+
+}
+
+static void stateChangeCallback(uint32_t flags, void* context) {
+  otInstance* instance = (otInstance*)context;
+  if (!(flags & OT_CHANGED_THREAD_ROLE)) {
+    return;
+  }
+
+  switch (otThreadGetDeviceRole(instance)) {
+    case OT_DEVICE_ROLE_DISABLED:
+      printf("[State Change] - Disabled.\n");
+      break;
+    case OT_DEVICE_ROLE_DETACHED:
+      printf("[State Change] - Detached.\n");
+      break;
+    case OT_DEVICE_ROLE_CHILD:
+      printf("[State Change] - Child.\n");
+      printf("Successfully attached to Thread network as a child.\n");
+      if (!sStarted) startUpload(instance);
+      break;
+    default:
+      break;
+  }
+}
@@ -79,13 +79,7 @@ int main(__attribute__((unused)) int argc, __attribute__((unused)) char* argv[])
     }
 
     // main loop work
-    otTaskletsProcess(instance);
-    otSysProcessDrivers(instance);
-
-    if (!otTaskletsArePending(instance) && !openthread_platform_pending_work()) {
-      yield();
-    }
-
+    otTockProcess(instance);
   }
 
   return 0;
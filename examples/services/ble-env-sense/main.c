@@ -15,6 +15,7 @@
 
 #include <libtock/kernel/ipc.h>
 #include <libtock/net/nrf51_serialization.h>
+#include <libtock/services/alarm.h>
 #include <libtock/tock.h>
 
 #include "env_sense_service.h"
@@ -25,6 +26,9 @@
 
 uint16_t conn_handle = BLE_CONN_HANDLE_INVALID;
 
+// Readings are sent at most once per connection interval.
+#define CONN_INTERVAL_MS 1250
+
 // Intervals for advertising and connections
 simple_ble_config_t ble_config = {
   .platform_id       = 0x00,                // used as 4th octect in device BLE address
@@ -32,7 +36,7 @@ simple_ble_config_t ble_config = {
   .adv_name          = "TOCK-ESS",
   .adv_interval      = MSEC_TO_UNITS(500, UNIT_0_625_MS),
   .min_conn_interval = MSEC_TO_UNITS(1000, UNIT_1_25_MS),
-  .max_conn_interval = MSEC_TO_UNITS(1250, UNIT_1_25_MS)
+  .max_conn_interval = MSEC_TO_UNITS(CONN_INTERVAL_MS, UNIT_1_25_MS)
 };
 
 void ble_address_set(void) {
@@ -86,6 +90,9 @@ typedef enum {
   SENSOR_TEMPERATURE = 0,
   SENSOR_IRRADIANCE  = 1,
   SENSOR_HUMIDITY    = 2,
+  SENSOR_COUNT,
+  // The message is a batch: `value` updates follow this one.
+  SENSOR_BATCH = 0xff,
 } sensor_type_e;
 
 typedef struct {
@@ -93,6 +100,52 @@ typedef struct {
   int value; // sensor reading
 } sensor_update_t;
 
+// Latest reading of each sensor not yet sent. Readings of the same sensor
+// within a connection interval replace each other, so each characteristic is
+// notified at most once per interval.
+static struct {
+  bool dirty[SENSOR_COUNT];
+  int value[SENSOR_COUNT];
+  bool armed;
+  libtock_alarm_t alarm;
+} batch;
+
+static void flush(__attribute__ ((unused)) uint32_t now,
+                  __attribute__ ((unused)) uint32_t scheduled,
+                  __attribute__ ((unused)) void*    opaque) {
+  batch.armed = false;
+  if (conn_handle == BLE_CONN_HANDLE_INVALID) {
+    memset(batch.dirty, 0, sizeof(batch.dirty));
+    return;
+  }
+
+  for (int type = 0; type < SENSOR_COUNT; type++) {
+    if (!batch.dirty[type]) continue;
+    batch.dirty[type] = false;
+    switch (type) {
+      case SENSOR_TEMPERATURE:
+        env_sense_update_temperature(conn_handle, batch.value[type]);
+        break;
+      case SENSOR_IRRADIANCE:
+        env_sense_update_irradiance(conn_handle, batch.value[type]);
+        break;
+      case SENSOR_HUMIDITY:
+        env_sense_update_humidity(conn_handle, batch.value[type]);
+        break;
+    }
+  }
+}
+
+static void stage(const sensor_update_t* update) {
+  if (update->type < 0 || update->type >= SENSOR_COUNT) return;
+
+  batch.dirty[update->type] = true;
+  batch.value[update->type] = update->value;
+  if (!batch.armed && conn_handle != BLE_CONN_HANDLE_INVALID) {
+    batch.armed = true;
+    libtock_alarm_in_ms(CONN_INTERVAL_MS, flush, NULL, &batch.alarm);
+  }
+}
 
 static void ipc_callback(int pid, int len, int buf, __attribute__ ((unused)) void* ud) {
   if (len < (int) sizeof(sensor_update_t)) {
@@ -103,18 +156,15 @@ static void ipc_callback(int pid, int len, int buf, __attribute__ ((unused)) voi
 
   sensor_update_t* update = (sensor_update_t*) buf;
 
-  if (conn_handle != BLE_CONN_HANDLE_INVALID) {
-    switch (update->type) {
-      case SENSOR_TEMPERATURE:
-        env_sense_update_temperature(conn_handle, update->value);
-        break;
-      case SENSOR_IRRADIANCE:
-        env_sense_update_irradiance(conn_handle,  update->value);
-        break;
-      case SENSOR_HUMIDITY:
-        env_sense_update_humidity(conn_handle,  update->value);
-        break;
+  if (update->type == SENSOR_BATCH) {
+    int count = update->value;
+    int max   = len / (int) sizeof(sensor_update_t) - 1;
+    if (count > max) count = max;
+    for (int i = 1; i <= count; i++) {
+      stage(&update[i]);
     }
+  } else {
+    stage(update);
   }
   ipc_notify_client(pid);
 }
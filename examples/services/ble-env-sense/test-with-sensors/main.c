@@ -16,6 +16,7 @@ typedef enum {
   SENSOR_TEMPERATURE = 0,
   SENSOR_IRRADIANCE  = 1,
   SENSOR_HUMIDITY    = 2,
+  SENSOR_BATCH       = 0xff,
 } sensor_type_e;
 
 typedef struct {
@@ -40,7 +41,9 @@ static void do_sensing_cb(__attribute__ ((unused)) uint32_t now,
 
   printf("[BLE ESS Test] Sampling Sensors\n");
 
+  // All readings go to the service in one batch, so it is notified once.
   sensor_update_t* update = (sensor_update_t*) buf;
+  int count = 0;
 
   int light = 0;
   int temp  = 0;
@@ -49,33 +52,33 @@ static void do_sensing_cb(__attribute__ ((unused)) uint32_t now,
   if (driver_exists(DRIVER_NUM_AMBIENT_LIGHT)) {
     libtocksync_ambient_light_read_intensity(&light);
 
-    update->type  = SENSOR_IRRADIANCE;
-    update->value = light;
-    ipc_notify_service(_svc_num);
-    _ipc_done = false;
-    yield_for(&_ipc_done);
+    count++;
+    update[count].type  = SENSOR_IRRADIANCE;
+    update[count].value = light;
   }
 
   if (driver_exists(DRIVER_NUM_TEMPERATURE)) {
     libtocksync_temperature_read(&temp);
 
-    update->type  = SENSOR_TEMPERATURE;
-    update->value = temp;
-    ipc_notify_service(_svc_num);
-    _ipc_done = false;
-    yield_for(&_ipc_done);
+    count++;
+    update[count].type  = SENSOR_TEMPERATURE;
+    update[count].value = temp;
   }
 
   if (driver_exists(DRIVER_NUM_HUMIDITY)) {
     libtocksync_humidity_read(&humi);
 
-    update->type  = SENSOR_HUMIDITY;
-    update->value = humi;
-    ipc_notify_service(_svc_num);
-    _ipc_done = false;
-    yield_for(&_ipc_done);
+    count++;
+    update[count].type  = SENSOR_HUMIDITY;
+    update[count].value = humi;
   }
 
+  update[0].type  = SENSOR_BATCH;
+  update[0].value = count;
+  ipc_notify_service(_svc_num);
+  _ipc_done = false;
+  yield_for(&_ipc_done);
+
   printf("Setting ESS to:\n");
   printf("  light: %i\n", light);
   printf("  temp:  %i\n", temp);
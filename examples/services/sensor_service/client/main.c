@@ -0,0 +1,27 @@
+#include <stdio.h>
+
+#include <libtock/services/shared_sensors.h>
+
+static void new_record(__attribute__ ((unused)) void* opaque) {
+  libtock_sensor_sample_t sample;
+  if (libtock_shared_sensors_read(&sample) != RETURNCODE_SUCCESS) return;
+
+  printf("[Sensor Client] %lu ms:", (uint32_t) (sample.us / 1000));
+  if (sample.valid & (1u << LIBTOCK_SENSOR_TEMPERATURE)) printf(" temp %d", sample.temperature);
+  if (sample.valid & (1u << LIBTOCK_SENSOR_HUMIDITY)) printf(" humidity %d", sample.humidity);
+  if (sample.valid & (1u << LIBTOCK_SENSOR_PRESSURE)) printf(" pressure %d", sample.pressure);
+  if (sample.valid & (1u << LIBTOCK_SENSOR_AMBIENT_LIGHT)) printf(" light %d", sample.ambient_light);
+  printf("\n");
+}
+
+int main(void) {
+  returncode_t ret = libtock_shared_sensors_subscribe(new_record, NULL);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[Sensor Client] No sensor service: %s\n", tock_strrcode(ret));
+    return ret;
+  }
+
+  while (1) {
+    yield();
+  }
+}
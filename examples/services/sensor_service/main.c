@@ -0,0 +1,46 @@
+#include <stdio.h>
+
+#include <libtock/kernel/ipc_pubsub.h>
+#include <libtock/sensors/ambient_light.h>
+#include <libtock/sensors/humidity.h>
+#include <libtock/sensors/ninedof.h>
+#include <libtock/sensors/pressure.h>
+#include <libtock/sensors/temperature.h>
+#include <libtock/services/sensor_sampler.h>
+#include <libtock/services/shared_sensors.h>
+
+// How often each sensor is sampled.
+#define PERIOD_MS 1000
+
+// Header plus one record, rounded up to the power of two `ipc_share()` needs.
+static uint8_t slot[128] __attribute__((aligned(128)));
+static ipc_pubsub_publisher_t pub;
+
+static void record_cb(const libtock_sensor_sample_t* sample) {
+  // One write however many clients there are.
+  ipc_pubsub_publish(&pub, sample, sizeof(*sample), true);
+}
+
+int main(void) {
+  _Static_assert(sizeof(ipc_pubsub_slot_t) + sizeof(libtock_sensor_sample_t) <= sizeof(slot),
+                 "the slot must hold a record");
+
+  int ret = ipc_pubsub_publisher_init(&pub, LIBTOCK_SHARED_SENSORS_SERVICE, slot, sizeof(slot));
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[Sensor Service] Could not register: %s\n", tock_strrcode(ret));
+    return ret;
+  }
+
+  if (libtock_temperature_exists()) libtock_sensor_sampler_enable(LIBTOCK_SENSOR_TEMPERATURE, PERIOD_MS);
+  if (libtock_humidity_exists()) libtock_sensor_sampler_enable(LIBTOCK_SENSOR_HUMIDITY, PERIOD_MS);
+  if (libtock_pressure_exists()) libtock_sensor_sampler_enable(LIBTOCK_SENSOR_PRESSURE, PERIOD_MS);
+  if (libtock_ambient_light_exists()) libtock_sensor_sampler_enable(LIBTOCK_SENSOR_AMBIENT_LIGHT, PERIOD_MS);
+  if (libtock_ninedof_exists()) libtock_sensor_sampler_enable(LIBTOCK_SENSOR_ACCELEROMETER, PERIOD_MS);
+
+  libtock_sensor_sampler_start(PERIOD_MS, PERIOD_MS / 10, record_cb);
+  printf("[Sensor Service] Publishing every %d ms\n", PERIOD_MS);
+
+  while (1) {
+    yield();
+  }
+}
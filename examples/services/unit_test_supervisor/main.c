@@ -1,8 +1,15 @@
 #include <libtock-sync/services/unit_test.h>
 #include <libtock/tock.h>
 
+// Test runners allowed to run at once. Build with
+// `make CPPFLAGS=-DUNIT_TEST_RUNNERS=1` to run them one after another, for
+// test apps that share hardware.
+#ifndef UNIT_TEST_RUNNERS
+#define UNIT_TEST_RUNNERS 4
+#endif
+
 int main(void) {
-  unit_test_service();
+  unit_test_service_parallel(UNIT_TEST_RUNNERS);
 
   while (1) {
     yield();
@@ -48,6 +48,28 @@ static void test_sampling_buffer(uint8_t channel, int index) {
   }
 }
 
+// Sample every channel four times in one scan.
+static void test_scan(int count) {
+  uint8_t channels[count];
+  uint16_t samples[4 * count];
+  for (int i = 0; i < count; i++) {
+    channels[i] = (uint8_t) i;
+  }
+
+  int err = libtocksync_adc_scan(channels, (uint8_t) count, samples, 4);
+  if (err < 0) {
+    printf("Error scanning ADC: %d\n", err);
+    return;
+  }
+  for (int pass = 0; pass < 4; pass++) {
+    printf("\t[ ");
+    for (int i = 0; i < count; i++) {
+      printf("%u ", (samples[pass * count + i] * reference_voltage) / ((1 << 16) - 1));
+    }
+    printf("]\n");
+  }
+}
+
 int main(void) {
   printf("[Tock] ADC Test\n");
 
@@ -88,6 +110,10 @@ int main(void) {
         libtocksync_alarm_delay_ms(100);
       }
     }
+
+    printf("\nChannel Scan\n");
+    test_scan(count);
+    libtocksync_alarm_delay_ms(100);
   }
 
   return 0;
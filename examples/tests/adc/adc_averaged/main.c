@@ -0,0 +1,46 @@
+#include <stdio.h>
+
+#include <libtock-sync/peripherals/adc.h>
+#include <libtock-sync/services/alarm.h>
+
+#define SAMPLES 256
+
+// Integer square root, for the standard deviation.
+static uint32_t isqrt(uint32_t v) {
+  uint32_t r = 0;
+  for (uint32_t bit = 1UL << 30; bit != 0; bit >>= 2) {
+    if (v >= r + bit) {
+      v -= r + bit;
+      r  = (r >> 1) + bit;
+    } else {
+      r >>= 1;
+    }
+  }
+  return r;
+}
+
+int main(void) {
+  if (!libtock_adc_exists()) {
+    printf("No ADC driver!\n");
+    return -1;
+  }
+
+  int channel_count;
+  libtock_adc_channel_count(&channel_count);
+  printf("ADC driver exists with %d channels\n\n", channel_count);
+
+  while (1) {
+    for (uint8_t channel = 0; channel < channel_count; channel++) {
+      libtock_adc_stats_t stats;
+      returncode_t ret = libtocksync_adc_sample_averaged(channel, SAMPLES, &stats);
+      if (ret != RETURNCODE_SUCCESS) {
+        printf("Channel %u: %s\n", channel, tock_strrcode(ret));
+        continue;
+      }
+      printf("Channel %u: mean %u, range %u..%u, std dev %lu (%lu samples)\n", channel, stats.mean, stats.min,
+             stats.max, (unsigned long) isqrt(stats.variance), (unsigned long) stats.samples);
+    }
+    printf("\n");
+    libtocksync_alarm_delay_ms(1000);
+  }
+}
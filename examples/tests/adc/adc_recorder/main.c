@@ -0,0 +1,60 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/adc_recorder.h>
+#include <libtock-sync/storage/nonvolatile_storage.h>
+#include <libtock/services/time.h>
+#include <libtock/storage/nonvolatile_storage.h>
+
+// Sample the first channel. On Hail, this is external pin A0 (AD0)
+#define ADC_CHANNEL 0
+#define ADC_FREQUENCY 22050
+
+// 256 samples are 512 bytes, one SD card block, filled every 11.6 ms.
+#define BUF_SIZE 256
+#define BUF_COUNT 6
+#define BUF_BYTES (BUF_SIZE * 2)
+
+// Record at most this many buffers.
+#define MAX_BUFFERS 64
+
+static uint16_t buffers[BUF_COUNT * BUF_SIZE];
+static uint16_t readback[BUF_SIZE];
+
+int main(void) {
+  printf("[Tock] ADC Recorder Test\n");
+
+  uint32_t size;
+  returncode_t ret = libtock_nonvolatile_storage_get_number_bytes(&size);
+  if (ret != RETURNCODE_SUCCESS || size < BUF_BYTES) {
+    printf("No nonvolatile storage to record to\n");
+    return -1;
+  }
+  uint32_t limit = size < MAX_BUFFERS * BUF_BYTES ? size : MAX_BUFFERS * BUF_BYTES;
+
+  uint32_t written;
+  uint64_t start = libtock_time_now_us64();
+  ret = libtocksync_adc_recorder_record(LIBTOCK_ADC_RECORDER_NONVOLATILE, 0, limit, ADC_CHANNEL, ADC_FREQUENCY,
+                                        buffers, BUF_COUNT, BUF_SIZE, &written);
+  uint64_t elapsed = libtock_time_now_us64() - start;
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[FAIL] recording stopped after %lu bytes: %s\n", (unsigned long) written, tock_strrcode(ret));
+    return -1;
+  }
+  printf("Recorded %lu bytes in %lu ms, %lu buffers dropped\n", (unsigned long) written,
+         (unsigned long) (elapsed / 1000), (unsigned long) libtock_adc_recorder_overruns());
+
+  // The last buffer read back must look like samples.
+  int len;
+  ret = libtocksync_nonvolatile_storage_read(written - BUF_BYTES, BUF_BYTES, (uint8_t*) readback, BUF_BYTES, &len);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[FAIL] read back: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+  uint32_t sum = 0;
+  for (int i = 0; i < BUF_SIZE; i++) {
+    sum += readback[i];
+  }
+  printf("Last buffer average: %lu\n", (unsigned long) (sum / BUF_SIZE));
+  printf("[SUCCESS] ADC recording stored\n");
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include <stdio.h>
+
+#include <libtock-sync/peripherals/adc.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock/peripherals/adc.h>
+
+// Sample the first channel. On Hail, this is external pin A0 (AD0)
+#define ADC_CHANNEL 0
+#define ADC_FREQUENCY 44100
+
+// 441 samples at 44.1 kHz fill a buffer every 10 ms.
+#define BUF_SIZE 441
+#define BUF_COUNT 8
+
+// Every BURST_EVERY buffers the consumer stalls for BURST_MS while holding
+// the buffer, longer than the two buffers the driver holds could cover.
+#define BURST_EVERY 20
+#define BURST_MS 40
+
+#define REPORT_EVERY 100
+
+static uint16_t buffers[BUF_COUNT * BUF_SIZE];
+static libtock_adc_ring_t ring;
+
+int main(void) {
+  printf("[Tock] ADC Ring Test\n");
+
+  if (!libtock_adc_exists()) {
+    printf("No ADC driver!\n");
+    return -1;
+  }
+
+  returncode_t err = libtock_adc_ring_start(&ring, ADC_CHANNEL, ADC_FREQUENCY, buffers, BUF_COUNT, BUF_SIZE,
+                                            NULL, NULL);
+  if (err != RETURNCODE_SUCCESS) {
+    printf("ring start error: %s\n", tock_strrcode(err));
+    return -1;
+  }
+  printf("Sampling channel %d at %d Hz into %d buffers of %d samples\n",
+         ADC_CHANNEL, ADC_FREQUENCY, BUF_COUNT, BUF_SIZE);
+
+  for (uint32_t n = 1; ; n++) {
+    uint32_t length;
+    uint16_t* samples = libtocksync_adc_ring_acquire(&ring, &length);
+
+    uint32_t sum = 0;
+    uint16_t min = 0xFFFF;
+    uint16_t max = 0;
+    for (uint32_t i = 0; i < length; i++) {
+      uint16_t sample = samples[i];
+      sum += sample;
+      if (sample < min) min = sample;
+      if (sample > max) max = sample;
+    }
+
+    // Processing hiccup. Buffers keep being swapped while the delay yields.
+    if (n % BURST_EVERY == 0) {
+      libtocksync_alarm_delay_ms(BURST_MS);
+    }
+    libtock_adc_ring_release(&ring, samples);
+
+    if (n % REPORT_EVERY == 0) {
+      printf("Buffers: %lu\tAvg: %lu\tMin: %u\tMax: %u\tPending: %lu\tOverruns: %lu\n",
+             n, sum / length, min, max, libtock_adc_ring_pending(&ring), libtock_adc_ring_overruns(&ring));
+    }
+  }
+}
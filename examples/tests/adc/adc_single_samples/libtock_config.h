@@ -0,0 +1,7 @@
+#pragma once
+
+// This app only takes single samples, so the other ADC operations are left
+// out of its libtock.
+#define LIBTOCK_ENABLE_ADC_CONTINUOUS_SAMPLE 0
+#define LIBTOCK_ENABLE_ADC_BUFFERED_SAMPLE 0
+#define LIBTOCK_ENABLE_ADC_CONTINUOUS_BUFFERED_SAMPLE 0
@@ -0,0 +1,52 @@
+#include <stdio.h>
+
+#include <libtock-sync/peripherals/adc.h>
+#include <libtock/peripherals/adc.h>
+
+// Sample the first channel. On Hail, this is external pin A0 (AD0)
+#define ADC_CHANNEL 0
+#define ADC_FREQUENCY 10000
+
+// 100 samples at 10 kHz fill a buffer every 10 ms.
+#define BUF_SIZE 100
+#define BUF_COUNT 8
+
+// Trigger on the input rising through mid-scale, and keep 20 ms before and
+// 30 ms after it.
+#define THRESHOLD 2048
+#define PRE 200
+#define POST 300
+
+static uint16_t buffers[BUF_COUNT * BUF_SIZE];
+static uint16_t window[PRE + POST];
+
+int main(void) {
+  printf("[Tock] ADC Trigger Test\n");
+
+  if (!libtock_adc_exists()) {
+    printf("No ADC driver!\n");
+    return -1;
+  }
+
+  printf("Waiting for channel %d to rise through %d\n", ADC_CHANNEL, THRESHOLD);
+
+  for (int n = 1; ; n++) {
+    uint32_t length, trigger;
+    returncode_t err = libtocksync_adc_trigger_capture(ADC_CHANNEL, ADC_FREQUENCY, buffers, BUF_COUNT, BUF_SIZE,
+                                                       LIBTOCK_ADC_TRIGGER_RISING, THRESHOLD, window, PRE, POST,
+                                                       &length, &trigger);
+    if (err != RETURNCODE_SUCCESS) {
+      printf("capture error: %s\n", tock_strrcode(err));
+      return -1;
+    }
+
+    uint16_t min = 0xFFFF;
+    uint16_t max = 0;
+    for (uint32_t i = 0; i < length; i++) {
+      if (window[i] < min) min = window[i];
+      if (window[i] > max) max = window[i];
+    }
+    printf("Capture %d: %lu samples, trigger at %lu\tBefore: %u\tAt: %u\tMin: %u\tMax: %u\n",
+           n, length, trigger, trigger > 0 ? window[trigger - 1] : 0, window[trigger], min, max);
+  }
+}
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock-sync/crypto/aead.h>
+
+#define PACKET_LEN 128
+#define TAG_LEN    8
+
+static const uint8_t key[LIBTOCK_AEAD_KEY_LEN] = {
+  0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+static const uint8_t nonce[LIBTOCK_AEAD_CCM_NONCE_LEN] = {
+  0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc
+};
+
+static const char header[]  = "hdr:42";
+static const char message[] = "A language empowering everyone to build reliable and efficient software.";
+
+static uint8_t packet[PACKET_LEN];
+static uint8_t streamed[PACKET_LEN];
+
+int main(void) {
+  printf("[TEST] AEAD\n");
+  if (!libtock_aes_exists()) {
+    printf("No AES driver.\n");
+    return -2;
+  }
+
+  uint32_t aad_len = strlen(header);
+  uint32_t msg_len = strlen(message);
+
+  // One shot, in place.
+  memcpy(packet, header, aad_len);
+  memcpy(packet + aad_len, message, msg_len);
+  returncode_t ret = libtocksync_aead_seal(LIBTOCK_AEAD_AES128CCM, key, nonce, sizeof(nonce), packet,
+                                           sizeof(packet), aad_len, msg_len, TAG_LEN);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[FAIL] seal: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+  if (memcmp(packet, header, aad_len) != 0 || memcmp(packet + aad_len, message, msg_len) == 0) {
+    printf("[FAIL] sealed packet is not encrypted as expected\n");
+    return -1;
+  }
+
+  // The same packet assembled piece by piece.
+  libtock_aead_stream_t stream;
+  libtock_aead_stream_init(&stream, streamed, sizeof(streamed));
+  ret = libtock_aead_stream_aad(&stream, (const uint8_t*) header, 4);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aead_stream_aad(&stream, (const uint8_t*) header + 4, aad_len - 4);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aead_stream_update(&stream, (const uint8_t*) message, 10);
+  uint8_t* rest;
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aead_stream_reserve(&stream, msg_len - 10, &rest);
+  if (ret == RETURNCODE_SUCCESS) {
+    memcpy(rest, message + 10, msg_len - 10);
+    ret = libtocksync_aead_stream_seal(&stream, LIBTOCK_AEAD_AES128CCM, key, nonce, sizeof(nonce), TAG_LEN);
+  }
+  if (ret != RETURNCODE_SUCCESS || libtock_aead_stream_length(&stream) != aad_len + msg_len + TAG_LEN ||
+      memcmp(streamed, packet, aad_len + msg_len + TAG_LEN) != 0) {
+    printf("[FAIL] streamed seal differs: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  // Open the streamed copy, then the one-shot packet after tampering.
+  ret = libtocksync_aead_stream_open(&stream, LIBTOCK_AEAD_AES128CCM, key, nonce, sizeof(nonce), TAG_LEN);
+  if (ret != RETURNCODE_SUCCESS || memcmp(streamed + aad_len, message, msg_len) != 0) {
+    printf("[FAIL] open: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+  packet[0] ^= 1;
+  ret = libtocksync_aead_open(LIBTOCK_AEAD_AES128CCM, key, nonce, sizeof(nonce), packet, sizeof(packet),
+                              aad_len, msg_len, TAG_LEN);
+  if (ret != RETURNCODE_FAIL) {
+    printf("[FAIL] tampered packet was accepted: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  printf("[SUCCESS] Sealed, opened and rejected a tampered packet\n");
+  return 0;
+}
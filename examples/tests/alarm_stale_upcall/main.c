@@ -0,0 +1,82 @@
+#include <stdio.h>
+
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+#include <libtock/services/alarm.h>
+
+#define SECOND_MS 100
+
+static libtock_alarm_t first, second;
+static bool first_fired  = false;
+static bool second_fired = false;
+static uint32_t second_fired_at;
+
+static void first_cb(__attribute__ ((unused)) uint32_t now,
+                     __attribute__ ((unused)) uint32_t scheduled,
+                     __attribute__ ((unused)) void*    opaque) {
+  first_fired = true;
+}
+
+static void second_cb(__attribute__ ((unused)) uint32_t now,
+                      __attribute__ ((unused)) uint32_t scheduled,
+                      __attribute__ ((unused)) void*    opaque) {
+  libtock_alarm_command_read(&second_fired_at);
+  second_fired = true;
+}
+
+// Re-arms itself with no delay until told to stop.
+static libtock_alarm_t rearm;
+static int rearms = 0;
+static bool stop_rearming = false;
+
+static void rearm_cb(__attribute__ ((unused)) uint32_t now,
+                     __attribute__ ((unused)) uint32_t scheduled,
+                     __attribute__ ((unused)) void*    opaque) {
+  rearms++;
+  if (!stop_rearming) libtock_alarm_in_ms(0, rearm_cb, NULL, &rearm);
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  printf("alarm_stale_upcall: %s: %s\n", what, ok ? "ok" : "FAIL");
+  if (!ok) failures++;
+}
+
+int main(void) {
+  uint32_t frequency;
+  libtock_alarm_get_frequency(&frequency);
+
+  uint32_t start;
+  libtock_alarm_command_read(&start);
+  libtock_alarm_in_ms(1, first_cb, NULL, &first);
+
+  // Stay busy past the first alarm, so the kernel stamps its upcall while
+  // the app runs, then set the second alarm before the upcall is delivered.
+  uint32_t now = start;
+  while (now - start < frequency / 1000 * 3 + 3) {
+    libtock_alarm_command_read(&now);
+  }
+  uint32_t second_set_at;
+  libtock_alarm_command_read(&second_set_at);
+  libtock_alarm_in_ms(SECOND_MS, second_cb, NULL, &second);
+
+  yield_for(&first_fired);
+  check(!second_fired, "later alarm not run by the stale upcall");
+
+  yield_for(&second_fired);
+  uint32_t elapsed_ms = (uint32_t) ((uint64_t) (second_fired_at - second_set_at) * 1000 / frequency);
+  printf("alarm_stale_upcall: %d ms alarm fired after %lu ms\n", SECOND_MS, elapsed_ms);
+  check(elapsed_ms >= SECOND_MS, "later alarm waits its full time");
+
+  // An alarm a callback sets waits for the next upcall, so one that keeps
+  // re-arming with no delay still lets the app run between upcalls.
+  libtock_alarm_in_ms(0, rearm_cb, NULL, &rearm);
+  yield();
+  yield();
+  stop_rearming = true;
+  libtock_alarm_ms_cancel(&rearm);
+  check(rearms == 2, "zero-length alarm re-armed from its callback runs once per upcall");
+
+  printf("alarm_stale_upcall: %s\n", failures == 0 ? "PASS" : "FAIL");
+  return 0;
+}
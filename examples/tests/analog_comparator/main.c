@@ -4,6 +4,7 @@
 
 #include <libtock-sync/services/alarm.h>
 #include <libtock/peripherals/analog_comparator.h>
+#include <libtock/services/analog_comparator_counter.h>
 #include <libtock/tock.h>
 
 static int callback_channel;
@@ -49,6 +50,21 @@ static void analog_comparator_comparison_interrupt(uint8_t channel) {
   }
 }
 
+static void analog_comparator_window(uint8_t channel, uint32_t count, uint32_t elapsed_us) {
+  uint32_t hz = elapsed_us == 0 ? 0 : (uint32_t) ((uint64_t) count * 1000000 / elapsed_us);
+  printf("Channel %d: %lu crossings in %lu us, about %lu Hz\n", channel, count, elapsed_us, hz);
+}
+
+static void analog_comparator_comparison_counting(uint8_t channel) {
+  // Report once a second, or after 1000 crossings if the signal is busy.
+  static libtock_analog_comparator_counter_t counter;
+  libtock_analog_comparator_counter_start(&counter, channel, 1000, 1000, analog_comparator_window);
+
+  while (1) {
+    yield();
+  }
+}
+
 int main(void) {
   printf("\nAnalog Comparator test application\n");
 
@@ -64,6 +80,7 @@ int main(void) {
   // Set mode according to which implementation you want.
   // mode = 0 --> polling comparison
   // mode = 1 --> interrupt-based comparison
+  // mode = 2 --> count interrupts in windows
   uint8_t mode = 1;
 
   // Choose a comparator channel, starting from index 0 and depending on the chip
@@ -85,6 +102,10 @@ int main(void) {
     // Print for every interrupt received
     case 1: analog_comparator_comparison_interrupt(channel);
       break;
+
+    // Print the number of interrupts in each window
+    case 2: analog_comparator_comparison_counting(channel);
+      break;
   }
   printf("\n");
   return 0;
@@ -10,6 +10,7 @@ int test_off_by_one_name(void);
 int test_off_by_one_service_data(void);
 int test_exactly_full_buffer(void);
 int test_exactly_full_buffer_service_data(void);
+int test_update_in_place(void);
 
 static uint8_t buf[ADV_DATA_MAX_SIZE];
 
@@ -44,6 +45,12 @@ int main(void) {
     return err;
   }
 
+  err = test_update_in_place();
+  if (err != RETURNCODE_SUCCESS) {
+    printf("test_update_in_place failed: %s\r\n", tock_strrcode(err));
+    return err;
+  }
+
   printf("TEST PASSED\r\n");
   return 0;
 }
@@ -93,3 +100,24 @@ int test_exactly_full_buffer(void) {
   AdvData_t adv_data = gap_adv_data_new(buf, sizeof(buf));
   return gap_add_device_name(&adv_data, device_name, sizeof(device_name) - 1);
 }
+
+// Len || GAP_SERVICE_DATA || UUID16 || Service Data (2 bytes)
+//
+// Reserved once, then updated in place without moving the field.
+int test_update_in_place(void) {
+  AdvData_t adv_data = gap_adv_data_new(buf, sizeof(buf));
+  gap_add_flags(&adv_data, LE_GENERAL_DISCOVERABLE);
+
+  int offset = gap_reserve_service_data(&adv_data, 0x1809, 2);
+  if (offset != 7 || adv_data.offset != 9) return RETURNCODE_FAIL;
+  if (buf[3] != 5 || buf[4] != GAP_SERVICE_DATA || buf[5] != 0x09 || buf[6] != 0x18) return RETURNCODE_FAIL;
+
+  uint8_t value[] = {0x00, 0x2a};
+  if (gap_update_field(&adv_data, offset, value, sizeof(value)) != 1) return RETURNCODE_FAIL;
+  if (gap_update_field(&adv_data, offset, value, sizeof(value)) != 0) return RETURNCODE_FAIL;
+  if (buf[8] != 0x2a || adv_data.offset != 9) return RETURNCODE_FAIL;
+
+  // Writing past the laid out advertisement is refused.
+  if (gap_update_field(&adv_data, offset + 1, value, sizeof(value)) != -1) return RETURNCODE_FAIL;
+  return RETURNCODE_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock/display/blit.h>
+#include <libtock/services/time.h>
+
+#define PIXELS 1024
+
+static uint8_t rgb888[PIXELS * 3];
+static uint8_t rgb565[PIXELS * 2];
+static uint8_t mono[PIXELS / 8];
+
+static int fail(const char* what) {
+  printf("[FAIL] %s\n", what);
+  return -1;
+}
+
+int main(void) {
+  printf("[TEST] Blit\n");
+
+  for (int i = 0; i < PIXELS * 3; i++) rgb888[i] = (uint8_t) (i * 37);
+  uint64_t start = libtock_time_now_us64();
+  libtock_blit_rgb888_to_rgb565(rgb565, rgb888, PIXELS);
+  uint64_t convert_us = libtock_time_now_us64() - start;
+  for (int i = 0; i < PIXELS; i++) {
+    uint16_t p = LIBTOCK_BLIT_RGB565(rgb888[3 * i], rgb888[3 * i + 1], rgb888[3 * i + 2]);
+    if (rgb565[2 * i] != p >> 8 || rgb565[2 * i + 1] != (p & 0xFF)) return fail("rgb888 to rgb565");
+  }
+
+  // Expanding a bitmap and packing it again gives it back.
+  for (int i = 0; i < PIXELS / 8; i++) mono[i] = (uint8_t) (i * 91);
+  start = libtock_time_now_us64();
+  libtock_blit_mono_to_rgb565(rgb565, mono, PIXELS, 0xFFFF, 0x0000);
+  uint64_t expand_us = libtock_time_now_us64() - start;
+  uint8_t packed[PIXELS / 8];
+  libtock_blit_rgb565_to_mono(packed, rgb565, PIXELS, 128);
+  if (memcmp(packed, mono, sizeof(packed)) != 0) return fail("mono round trip");
+
+  // Swapping twice is the identity.
+  memcpy(rgb888, rgb565, sizeof(rgb565));
+  libtock_blit_swap16(rgb565, PIXELS);
+  if (rgb565[0] != rgb888[1] || rgb565[1] != rgb888[0]) return fail("swap");
+  libtock_blit_swap16(rgb565, PIXELS);
+  if (memcmp(rgb565, rgb888, sizeof(rgb565)) != 0) return fail("swap twice");
+
+  // A 5x3 rectangle in a 32 pixel wide buffer, from the second pixel of the
+  // second row.
+  memset(rgb565, 0, sizeof(rgb565));
+  libtock_blit_fill_rect_rgb565(rgb565 + (32 + 1) * 2, 64, 5, 3, 0xABCD);
+  for (int y = 0; y < 32; y++) {
+    for (int x = 0; x < 32; x++) {
+      bool inside = x >= 1 && x < 6 && y >= 1 && y < 4;
+      uint8_t* p  = rgb565 + (y * 32 + x) * 2;
+      if ((p[0] == 0xAB && p[1] == 0xCD) != inside) return fail("fill rect");
+    }
+  }
+
+  printf("%d pixels: rgb888 %lu us, mono %lu us\n", PIXELS, (uint32_t) convert_us, (uint32_t) expand_us);
+  printf("[SUCCESS] Blit kernels\n");
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include <stdio.h>
+
+#include <libtock/interface/button.h>
+#include <libtock/interface/led.h>
+#include <libtock/peripherals/adc.h>
+#include <libtock/peripherals/gpio.h>
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+#include <libtock/services/alarm.h>
+#include <libtock/tock.h>
+
+static bool failed;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("capability_cache: FAILED %s\n", what);
+    failed = true;
+  }
+}
+
+static uint32_t ticks(void) {
+  uint32_t now;
+  libtock_alarm_command_read(&now);
+  return now;
+}
+
+// Query a count twice, and check that the second answer matches the first
+// and costs no more than the first.
+static void check_count(const char* name, returncode_t (*query)(int*)) {
+  int first, second;
+  uint32_t t0 = ticks();
+  returncode_t r1 = query(&first);
+  uint32_t t1 = ticks();
+  returncode_t r2 = query(&second);
+  uint32_t t2 = ticks();
+
+  if (r1 != RETURNCODE_SUCCESS) {
+    printf("  %-8s not present\n", name);
+    return;
+  }
+  printf("  %-8s %d, first %lu ticks, cached %lu ticks\n", name, first, t1 - t0, t2 - t1);
+  check(r2 == RETURNCODE_SUCCESS && second == first, name);
+  check(t2 - t1 <= t1 - t0, name);
+}
+
+int main(void) {
+  printf("[TEST] Capability cache\n");
+
+  check_count("leds", libtock_led_count);
+  check_count("buttons", libtock_button_count);
+  check_count("gpio", libtock_gpio_count);
+  check_count("adc", libtock_adc_channel_count);
+
+  uint32_t f1 = 0, f2 = 0;
+  check(libtock_alarm_get_frequency(&f1) == RETURNCODE_SUCCESS && f1 > 0, "alarm frequency");
+  check(libtock_alarm_get_frequency(&f2) == RETURNCODE_SUCCESS && f2 == f1, "alarm frequency cached");
+  printf("  alarm    %lu Hz\n", f1);
+
+  if (!failed) printf("capability_cache: success\n");
+  return 0;
+}
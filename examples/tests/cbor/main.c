@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock/services/cbor.h>
+
+static bool passed = true;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("cbor: FAILED %s\n", what);
+    passed = false;
+  }
+}
+
+static uint8_t buf[64];
+static libtock_cbor_writer_t w;
+
+static void start(void) {
+  libtock_cbor_writer_init(&w, buf, sizeof(buf));
+}
+
+static bool encoded(const uint8_t* expected, size_t len) {
+  size_t got;
+  return libtock_cbor_writer_finish(&w, &got) == RETURNCODE_SUCCESS && got == len &&
+         memcmp(buf, expected, len) == 0;
+}
+
+static void check_encoding(void) {
+  start();
+  libtock_cbor_put_int(&w, 23);
+  check(encoded((const uint8_t[]) {0x17}, 1), "23");
+
+  start();
+  libtock_cbor_put_int(&w, 1000);
+  check(encoded((const uint8_t[]) {0x19, 0x03, 0xe8}, 3), "1000");
+
+  start();
+  libtock_cbor_put_int(&w, -1000);
+  check(encoded((const uint8_t[]) {0x39, 0x03, 0xe7}, 3), "-1000");
+
+  start();
+  libtock_cbor_put_float(&w, 1.5f);
+  check(encoded((const uint8_t[]) {0xf9, 0x3e, 0x00}, 3), "1.5 as half");
+
+  start();
+  libtock_cbor_put_float(&w, 100000.0f);
+  check(encoded((const uint8_t[]) {0xfa, 0x47, 0xc3, 0x50, 0x00}, 5), "100000.0 as single");
+
+  start();
+  libtock_cbor_put_text(&w, "IETF");
+  check(encoded((const uint8_t[]) {0x64, 0x49, 0x45, 0x54, 0x46}, 5), "text");
+
+  start();
+  libtock_cbor_put_array(&w, 2);
+  libtock_cbor_put_bool(&w, false);
+  libtock_cbor_put_null(&w);
+  check(encoded((const uint8_t[]) {0x82, 0xf4, 0xf6}, 3), "array");
+}
+
+static void check_record(void) {
+  start();
+  libtock_cbor_put_map(&w, 3);
+  libtock_cbor_put_text(&w, "t");
+  libtock_cbor_put_int(&w, 2281);
+  libtock_cbor_put_text(&w, "h");
+  libtock_cbor_put_int(&w, 4650);
+  libtock_cbor_put_text(&w, "lx");
+  libtock_cbor_put_int(&w, 312);
+  size_t len;
+  check(libtock_cbor_writer_finish(&w, &len) == RETURNCODE_SUCCESS, "record fits");
+
+  libtock_cbor_reader_t r;
+  libtock_cbor_reader_init(&r, buf, len);
+  size_t count;
+  check(libtock_cbor_get_map(&r, &count) == RETURNCODE_SUCCESS && count == 3, "map");
+
+  const char* key;
+  size_t key_len;
+  int64_t value;
+  check(libtock_cbor_get_int(&r, &value) == RETURNCODE_EINVAL, "type mismatch");
+  check(libtock_cbor_get_text(&r, &key, &key_len) == RETURNCODE_SUCCESS && key_len == 1 && key[0] == 't', "key");
+  check(libtock_cbor_get_int(&r, &value) == RETURNCODE_SUCCESS && value == 2281, "value");
+  check(libtock_cbor_skip(&r) == RETURNCODE_SUCCESS && libtock_cbor_skip(&r) == RETURNCODE_SUCCESS, "skip");
+  check(libtock_cbor_peek(&r) == LIBTOCK_CBOR_TEXT, "peek");
+  check(libtock_cbor_skip(&r) == RETURNCODE_SUCCESS && libtock_cbor_get_int(&r, &value) == RETURNCODE_SUCCESS &&
+        value == 312, "last value");
+  check(libtock_cbor_at_end(&r), "end");
+
+  libtock_cbor_reader_init(&r, buf, len - 1);
+  check(libtock_cbor_skip(&r) == RETURNCODE_ESIZE, "truncated record");
+
+  char text[64];
+  int text_len = snprintf(text, sizeof(text), "%d deg C; %d%% humidity; %d lux;\n", 2281 / 100, 4650 / 100, 312);
+  printf("cbor: record of %u bytes, %d as text\n", (unsigned) len, text_len);
+}
+
+static void check_overflow(void) {
+  uint8_t small[4];
+  libtock_cbor_writer_init(&w, small, sizeof(small));
+  libtock_cbor_put_text(&w, "long");
+  libtock_cbor_put_int(&w, 1);
+  size_t len;
+  check(libtock_cbor_writer_finish(&w, &len) == RETURNCODE_ESIZE, "overflow");
+}
+
+int main(void) {
+  check_encoding();
+  check_record();
+  check_overflow();
+  if (passed) printf("cbor: success\n");
+  return 0;
+}
@@ -0,0 +1,12 @@
+#include <libtock-sync/interface/console_printf.h>
+#include <libtock-sync/services/alarm.h>
+
+int main(void) {
+  libtocksync_console_printf("Lean printf test\n");
+  for (int i = 0; i < 5; i++) {
+    libtocksync_console_printf("[%2d] signed %d, hex 0x%08x, padded [%-6s] [%6s], char %c\n",
+                               i, -i * 1000, 0xC0FFEE00u + i, "left", "right", 'a' + i);
+    libtocksync_alarm_delay_ms(250);
+  }
+  return 0;
+}
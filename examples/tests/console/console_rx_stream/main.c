@@ -0,0 +1,24 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/console_rx.h>
+
+static uint8_t ring[256];
+
+int main(void) {
+  returncode_t ret = libtock_console_rx_start(ring, sizeof(ring), 1, NULL);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[FAIL] Could not start receiving: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  printf("Type lines to echo them back.\n");
+  char line[80];
+  while (true) {
+    int len = libtocksync_console_rx_read_line(line, sizeof(line));
+    if (len < 0) {
+      printf("[FAIL] Reading a line failed: %s\n", tock_strrcode(len));
+      return -1;
+    }
+    printf("%3d: %s (overruns: %lu)\n", len, line, (unsigned long) libtock_console_rx_overruns());
+  }
+}
@@ -0,0 +1,36 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libtock-sync/services/stdout_buffer.h>
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+
+// Deliberately smaller than the output below so writers block on a full
+// buffer.
+static uint8_t stdout_buf[128];
+
+int main(void) {
+  returncode_t ret = libtocksync_stdout_buffer_enable(stdout_buf, sizeof(stdout_buf));
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[FAIL] Could not enable buffered stdout: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  uint32_t start;
+  libtock_alarm_command_read(&start);
+  for (int i = 0; i < 20; i++) {
+    printf("Buffered line %2d: the quick brown fox jumps over the lazy dog\n", i);
+  }
+  uint32_t queued;
+  libtock_alarm_command_read(&queued);
+
+  fflush(stdout);
+  libtocksync_stdout_buffer_flush();
+  uint32_t drained;
+  libtock_alarm_command_read(&drained);
+
+  printf("Queued in %lu ticks, drained after %lu ticks\n",
+         (unsigned long) (queued - start), (unsigned long) (drained - start));
+  printf("Dropped bytes: %lu\n", (unsigned long) libtock_stdout_buffer_dropped());
+  printf("This line is flushed at exit.\n");
+  return 0;
+}
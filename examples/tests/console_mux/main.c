@@ -0,0 +1,34 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock-sync/services/console_mux.h>
+
+#define STATUS 0
+#define DUMP   1
+
+static uint8_t status_buffer[256];
+static uint8_t dump_buffer[2048];
+
+static uint32_t dumped = 0;
+
+// Queue as many dump lines as fit without waiting.
+static void fill_dump(void) {
+  char line[16];
+  while (true) {
+    int len = snprintf(line, sizeof(line), "%08lx\n", (unsigned long) dumped);
+    if (libtock_console_mux_space(DUMP) < (uint32_t) len) return;
+    libtock_console_mux_write(DUMP, line, len);
+    dumped += len;
+  }
+}
+
+int main(void) {
+  libtock_console_mux_open(STATUS, status_buffer, sizeof(status_buffer));
+  libtock_console_mux_open(DUMP, dump_buffer, sizeof(dump_buffer));
+
+  for (int i = 0; ; i++) {
+    libtock_console_mux_printf(STATUS, "status %d: dump at %lu bytes\n", i, (unsigned long) dumped);
+    fill_dump();
+    libtocksync_alarm_delay_ms(100);
+  }
+}
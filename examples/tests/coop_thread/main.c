@@ -0,0 +1,75 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock/services/coop_thread.h>
+
+typedef struct {
+  const char* name;
+  uint32_t period_ms;
+  int iterations;
+} worker_t;
+
+static void worker(void* arg) {
+  worker_t* w = (worker_t*) arg;
+  for (int i = 0; i < w->iterations; i++) {
+    printf("[%s] %d\n", w->name, i);
+    libtocksync_alarm_delay_ms(w->period_ms);
+  }
+}
+
+// Sets the flag it is given after a short delay of its own.
+static void setter(void* arg) {
+  bool* flag = (bool*) arg;
+  libtocksync_alarm_delay_ms(50);
+  *flag = true;
+}
+
+static uint32_t now_ms(void) {
+  struct timeval tv;
+  libtock_alarm_gettimeasticks(&tv, NULL);
+  return tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+int main(void) {
+  static worker_t fast = { .name = "fast", .period_ms = 100, .iterations = 10 };
+  static worker_t slow = { .name = "slow", .period_ms = 250, .iterations = 3 };
+  static libtock_coop_thread_t fast_thread, slow_thread;
+
+  printf("[coop_thread] start\n");
+  uint32_t start = now_ms();
+
+  if (libtock_coop_thread_create(&fast_thread, worker, &fast, 1024) != RETURNCODE_SUCCESS ||
+      libtock_coop_thread_create(&slow_thread, worker, &slow, 1024) != RETURNCODE_SUCCESS) {
+    printf("[coop_thread] failed to create threads\n");
+    return -1;
+  }
+
+  yield_for(&fast_thread.done);
+  yield_for(&slow_thread.done);
+
+  printf("[coop_thread] both threads done after %lu ms (expected ~1000 ms)\n",
+         (unsigned long) (now_ms() - start));
+
+  // Multi-condition and timed waits must park the caller too, or the sibling
+  // that sets the flag never runs.
+  static libtock_coop_thread_t any_thread, timed_thread;
+  static bool any_flag = false;
+  if (libtock_coop_thread_create(&any_thread, setter, &any_flag, 1024) != RETURNCODE_SUCCESS) {
+    printf("[coop_thread] failed to create threads\n");
+    return -1;
+  }
+  bool* conds[2] = { NULL, &any_flag };
+  int index      = yield_for_any(conds, 2);
+  printf("[coop_thread] yield_for_any woken by sibling: %s\n", index == 1 ? "ok" : "FAIL");
+  yield_for(&any_thread.done);
+
+  static bool timed_flag = false;
+  if (libtock_coop_thread_create(&timed_thread, setter, &timed_flag, 1024) != RETURNCODE_SUCCESS) {
+    printf("[coop_thread] failed to create threads\n");
+    return -1;
+  }
+  int rc = libtocksync_alarm_yield_for_with_timeout(&timed_flag, 500);
+  printf("[coop_thread] timed wait woken by sibling: %s\n", rc == RETURNCODE_SUCCESS ? "ok" : "FAIL");
+  yield_for(&timed_thread.done);
+  return 0;
+}
@@ -3,6 +3,7 @@
 #include <string.h>
 
 #include <libtock-sync/peripherals/crc.h>
+#include <libtock/peripherals/crc_soft.h>
 #include <libtock-sync/peripherals/rng.h>
 #include <libtock-sync/services/alarm.h>
 
@@ -25,6 +26,29 @@ static struct test_case test_cases[] = {
 
 int n_test_cases = sizeof(test_cases) / sizeof(struct test_case);
 
+// Bytes per chunk when streaming a test case.
+#define CHUNK 3
+
+// The CRC of `t` in software and streamed in chunks through the driver,
+// which must both match the expected output.
+static bool check_chunked(struct test_case* t) {
+  uint32_t len = strlen(t->input);
+  if (libtock_crc_soft(t->alg, (const uint8_t*) t->input, len) != t->output) return false;
+  if (t->alg == LIBTOCK_CRC_32 && libtock_crc_soft_crc32_small(0, (const uint8_t*) t->input, len) != t->output) {
+    return false;
+  }
+
+  libtock_crc_stream_t stream;
+  libtock_crc_stream_init(&stream, t->alg);
+  for (uint32_t offset = 0; offset < len; offset += CHUNK) {
+    uint32_t n = len - offset < CHUNK ? len - offset : CHUNK;
+    if (libtocksync_crc_stream_update(&stream, (const uint8_t*) t->input + offset, n) != RETURNCODE_SUCCESS) {
+      return false;
+    }
+  }
+  return libtock_crc_stream_result(&stream) == t->output;
+}
+
 uint32_t procid;
 
 int main(void) {
@@ -62,6 +86,7 @@ int main(void) {
         } else {
           printf("(Expected %08lx)", t->output);
         }
+        printf(check_chunked(t) ? " (chunked OK)" : " (chunked differs)");
       } else {
         printf("failed with status %d\n", r);
       }
@@ -2,6 +2,7 @@
 
 #include <libtock-sync/services/alarm.h>
 #include <libtock/peripherals/dac.h>
+#include <libtock/services/dac_stream.h>
 #include <libtock/tock.h>
 
 uint16_t sine_samples[100] = {
@@ -28,15 +29,27 @@ int main(void) {
     return 1;
   }
 
-  while (1) {
-    for (int i = 0; i < 100; i++) {
-      ret = libtock_dac_set_value(sine_samples[i]);
-      if (ret != RETURNCODE_SUCCESS) {
-        printf("ERROR setting DAC value\n");
-        return 1;
-      }
-      libtocksync_alarm_delay_ms(100);
+  // Step through the wave slowly, one value per command.
+  for (int i = 0; i < 100; i++) {
+    ret = libtock_dac_set_value(sine_samples[i]);
+    if (ret != RETURNCODE_SUCCESS) {
+      printf("ERROR setting DAC value\n");
+      return 1;
     }
+    libtocksync_alarm_delay_ms(100);
+  }
+
+  // Then loop the same buffer at 1000 samples per second, a 10 Hz sine, with
+  // no involvement from the app.
+  static libtock_dac_stream_t stream;
+  ret = libtock_dac_stream_start(&stream, 1000, sine_samples, NULL, 100, NULL, NULL);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("ERROR starting DAC stream\n");
+    return 1;
+  }
+  while (1) {
+    libtocksync_alarm_delay_ms(10000);
+    printf("%lu late samples\n", (unsigned long) libtock_dac_stream_late(&stream));
   }
 
   return 0;
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libtock/services/dma_buffer.h>
+
+#define BUFFERS 12
+#define ITERATIONS 500
+
+static bool check(bool ok, const char* what) {
+  if (!ok) printf("dma_buffer: FAILED %s\n", what);
+  return ok;
+}
+
+static bool aligned(const void* ptr) {
+  return ((uintptr_t) ptr & (LIBTOCK_DMA_BUFFER_ALIGN - 1)) == 0;
+}
+
+// Random sizes in and out of use, each buffer filled with its own pattern.
+static bool test_churn(void) {
+  uint8_t* buffers[BUFFERS] = { NULL };
+  size_t lens[BUFFERS];
+  uint32_t seed = 1;
+  for (int i = 0; i < ITERATIONS; i++) {
+    seed = seed * 1103515245 + 12345;
+    int slot = (seed >> 16) % BUFFERS;
+
+    if (buffers[slot] != NULL) {
+      for (size_t j = 0; j < lens[slot]; j++) {
+        if (!check(buffers[slot][j] == (uint8_t) slot, "buffer contents kept")) return false;
+      }
+      libtock_dma_buffer_free(buffers[slot]);
+      buffers[slot] = NULL;
+    } else {
+      lens[slot]    = 1 + (seed >> 8) % 300;
+      buffers[slot] = libtock_dma_buffer_alloc(lens[slot]);
+      if (!check(buffers[slot] != NULL, "alloc")) return false;
+      if (!check(aligned(buffers[slot]), "alignment")) return false;
+      if (!check(libtock_dma_buffer_owns(buffers[slot]), "owns")) return false;
+      for (size_t j = 0; j < lens[slot]; j++) {
+        if (!check(buffers[slot][j] == 0, "zeroed")) return false;
+      }
+      memset(buffers[slot], slot, lens[slot]);
+    }
+  }
+  for (int i = 0; i < BUFFERS; i++) {
+    libtock_dma_buffer_free(buffers[i]);
+  }
+  return true;
+}
+
+// Buffers are rounded to whole alignment units and freed neighbours merge.
+static bool test_reuse(void) {
+  uint8_t* a = libtock_dma_buffer_alloc(1);
+  uint8_t* b = libtock_dma_buffer_alloc(1);
+  if (!check(a != NULL && b != NULL, "small alloc")) return false;
+  if (!check(b - a >= LIBTOCK_DMA_BUFFER_ALIGN, "no shared alignment unit")) return false;
+
+  libtock_dma_buffer_free(a);
+  libtock_dma_buffer_free(b);
+  uint8_t* c = libtock_dma_buffer_alloc((size_t) (b - a) + LIBTOCK_DMA_BUFFER_ALIGN);
+  if (!check(c == a, "freed neighbours merged")) return false;
+  libtock_dma_buffer_free(c);
+
+  libtock_dma_buffer_stats_t stats;
+  libtock_dma_buffer_stats(&stats);
+  return check(stats.buffers == 0 && stats.in_use == 0, "all freed");
+}
+
+// A buffer from `malloc()` is not in the pool.
+static bool test_owns(void) {
+  void* other = malloc(16);
+  bool ok     = check(!libtock_dma_buffer_owns(other), "does not own malloc memory");
+  free(other);
+  return ok;
+}
+
+int main(void) {
+  bool ok = test_churn() && test_reuse() && test_owns();
+
+  libtock_dma_buffer_stats_t stats;
+  libtock_dma_buffer_stats(&stats);
+  printf("dma_buffer: pool %lu B, %lu B in %lu buffers, peak %lu B, %lu failures\n",
+         stats.pool_size, stats.in_use, stats.buffers, stats.peak, stats.failures);
+  if (ok) printf("dma_buffer: success\n");
+  return 0;
+}
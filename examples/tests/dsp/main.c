@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock/dsp/ahrs.h>
+#include <libtock/dsp/dsp.h>
+#include <libtock/dsp/vector.h>
+#include <libtock/services/time.h>
+
+#define LEN 480
+#define BLOCK 64
+#define TAPS 7
+#define AVERAGE 8
+
+// Low-pass FIR, taps add up to about 0.85.
+static const int16_t taps[TAPS] = { 1000, 3000, 6000, 8000, 6000, 3000, 1000 };
+static int16_t fir_state[TAPS - 1 + BLOCK];
+
+// Two identical low-pass stages in Q14, unity gain at DC.
+static const int16_t coeffs[10] = {
+  1106, 2211, 1106, -18727, 6766,
+  1106, 2211, 1106, -18727, 6766,
+};
+static int16_t biquad_state[8];
+
+static int16_t history[AVERAGE];
+static int16_t buf[LEN];
+
+// A square wave of `period` samples, +-`amplitude`.
+static void square(int16_t amplitude, int period) {
+  for (int i = 0; i < LEN; i++) {
+    buf[i] = (i % period) < period / 2 ? amplitude : (int16_t) -amplitude;
+  }
+}
+
+static int fail(const char* what) {
+  printf("[FAIL] %s\n", what);
+  return -1;
+}
+
+int main(void) {
+  printf("[TEST] DSP\n");
+
+  // The RMS of a square wave is its amplitude.
+  square(10000, 12);
+  if (libtock_dsp_rms_q15(buf, LEN) != 10000) return fail("rms");
+
+  // An impulse through the FIR gives back the taps, also across blocks and
+  // calls.
+  libtock_dsp_fir_q15_t fir;
+  libtock_dsp_fir_q15_init(&fir, taps, TAPS, fir_state, BLOCK);
+  memset(buf, 0, sizeof(buf));
+  buf[BLOCK - 2] = INT16_MAX;
+  libtock_dsp_fir_q15(&fir, buf, buf, 50);
+  libtock_dsp_fir_q15(&fir, buf + 50, buf + 50, LEN - 50);
+  for (int k = 0; k < TAPS; k++) {
+    if (buf[BLOCK - 2 + k] != (int16_t) ((INT16_MAX * taps[k]) >> 15)) return fail("fir impulse");
+  }
+
+  // A moving average of a square wave whose period is a multiple of the
+  // window is flat once the window is full.
+  libtock_dsp_moving_average_q15_t ma;
+  if (libtock_dsp_moving_average_q15_init(&ma, history, 6) != RETURNCODE_EINVAL) return fail("average length");
+  libtock_dsp_moving_average_q15_init(&ma, history, AVERAGE);
+  for (int i = 0; i < LEN; i++) {
+    buf[i] = (i % 4) < 2 ? 1000 : 3000;
+  }
+  libtock_dsp_moving_average_q15(&ma, buf, buf, LEN);
+  for (int i = AVERAGE; i < LEN; i++) {
+    if (buf[i] != 2000) return fail("moving average");
+  }
+
+  // Decimating the same wave by its period leaves its mean.
+  for (int i = 0; i < LEN; i++) {
+    buf[i] = (i % 4) < 2 ? 1000 : 3000;
+  }
+  if (libtock_dsp_decimate_q15(buf, buf, LEN, 4) != LEN / 4) return fail("decimate count");
+  for (int i = 0; i < LEN / 4; i++) {
+    if (buf[i] != 2000) return fail("decimate");
+  }
+
+  // The low-pass settles on a DC input and takes most of a square wave at a
+  // quarter of the sample rate away.
+  libtock_dsp_biquad_q15_t bq;
+  libtock_dsp_biquad_q15_init(&bq, 2, coeffs, biquad_state);
+  for (int i = 0; i < LEN; i++) {
+    buf[i] = 8000;
+  }
+  libtock_dsp_biquad_q15(&bq, buf, buf, LEN);
+  if (buf[LEN - 1] < 7900 || buf[LEN - 1] > 8100) return fail("biquad dc");
+
+  libtock_dsp_biquad_q15_init(&bq, 2, coeffs, biquad_state);
+  square(10000, 4);
+  uint64_t start = libtock_time_now_us64();
+  libtock_dsp_biquad_q15(&bq, buf, buf, LEN);
+  uint64_t biquad_us = libtock_time_now_us64() - start;
+  if (libtock_dsp_rms_q15(buf + LEN / 2, LEN / 2) > 5000) return fail("biquad attenuation");
+
+  square(10000, 4);
+  libtock_dsp_fir_q15_init(&fir, taps, TAPS, fir_state, BLOCK);
+  start = libtock_time_now_us64();
+  libtock_dsp_fir_q15(&fir, buf, buf, LEN);
+  uint64_t fir_us = libtock_time_now_us64() - start;
+
+  if (libtock_dsp_atan2_cdeg(1000, -1000) != 13500) return fail("atan2");
+
+  // A board resting at 30 degrees of roll, then turning at 90 degrees per
+  // second about its z axis for one second.
+  libtock_dsp_ahrs_t ahrs;
+  libtock_dsp_ahrs_init(&ahrs, 100, LIBTOCK_DSP_AHRS_GYRO_DPS);
+  libtock_dsp_vec3_t still  = { 0, 0, 0 };
+  libtock_dsp_vec3_t tilted = { 0, 500, 866 };
+  start = libtock_time_now_us64();
+  for (int i = 0; i < 2000; i++) {
+    libtock_dsp_ahrs_update(&ahrs, &still, &tilted, NULL);
+  }
+  uint64_t ahrs_us = (libtock_time_now_us64() - start) / 2000;
+  int32_t roll, pitch, yaw;
+  libtock_dsp_ahrs_euler_cdeg(&ahrs, &roll, &pitch, &yaw);
+  if (roll < 2950 || roll > 3050 || pitch < -50 || pitch > 50) return fail("ahrs tilt");
+
+  libtock_dsp_vec3_t turning = { 0, 0, 90 };
+  libtock_dsp_vec3_t level   = { 0, 0, 1000 };
+  libtock_dsp_ahrs_init(&ahrs, 100, LIBTOCK_DSP_AHRS_GYRO_DPS);
+  for (int i = 0; i < 100; i++) {
+    libtock_dsp_ahrs_update(&ahrs, &turning, &level, NULL);
+  }
+  libtock_dsp_ahrs_euler_cdeg(&ahrs, &roll, &pitch, &yaw);
+  if (yaw < 8950 || yaw > 9050) return fail("ahrs turn");
+
+  printf("%d samples: biquad %lu us, fir %lu us\n", LEN, (unsigned long) biquad_us, (unsigned long) fir_us);
+  printf("ahrs update %lu us\n", (unsigned long) ahrs_us);
+  printf("[SUCCESS] DSP kernels\n");
+  return 0;
+}
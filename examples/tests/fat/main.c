@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock-sync/storage/fat.h>
+#include <libtock/storage/sdcard.h>
+
+#define LINES 100
+
+static libtocksync_fat_t fs;
+
+int main(void) {
+  printf("[TEST] FAT Filesystem\n");
+
+  if (!libtock_sdcard_exists()) {
+    printf("No SD card driver\n");
+    return 0;
+  }
+
+  returncode_t ret = libtocksync_fat_mount(&fs);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Could not mount the filesystem: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+  libtocksync_fat_stdio_attach(&fs);
+
+  FILE* f = fopen("TEST.LOG", "w");
+  if (f == NULL) {
+    printf("Could not create TEST.LOG\n");
+    return -1;
+  }
+  for (int i = 0; i < LINES; i++) {
+    fprintf(f, "line %d\n", i);
+  }
+  fclose(f);
+
+  f = fopen("TEST.LOG", "r");
+  if (f == NULL) {
+    printf("Could not open TEST.LOG\n");
+    return -1;
+  }
+  char line[32];
+  char expected[32];
+  int count = 0;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    snprintf(expected, sizeof(expected), "line %d\n", count);
+    if (strcmp(line, expected) != 0) {
+      printf("Line %d differs: %s", count, line);
+      fclose(f);
+      return -1;
+    }
+    count++;
+  }
+  fclose(f);
+
+  if (count != LINES) {
+    printf("Read %d lines, expected %d\n", count, LINES);
+    return -1;
+  }
+  printf("[SUCCESS] Wrote and read back %d lines\n", LINES);
+  return 0;
+}
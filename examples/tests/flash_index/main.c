@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock/storage/flash_index.h>
+
+#define ENTRIES 64
+
+extern const uint8_t test_index[];
+extern const uint32_t test_index_size;
+
+static libtock_flash_index_t table;
+
+int main(void) {
+  printf("[TEST] Flash Index\n");
+
+  returncode_t ret = libtock_flash_index_open(&table, test_index, test_index_size);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_flash_index_check(&table);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Could not open the index: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+  if (libtock_flash_index_count(&table) != ENTRIES) {
+    printf("Index holds %lu keys, expected %d\n", (unsigned long) libtock_flash_index_count(&table), ENTRIES);
+    return -1;
+  }
+
+  // Same table as table.txt.
+  for (uint32_t i = 0; i < ENTRIES; i++) {
+    uint8_t key[2] = { i, (i * 37) & 0xff };
+    uint32_t expected = i * 2654435761u;
+    uint8_t bytes[4]  = { expected >> 24, expected >> 16, expected >> 8, expected };
+
+    const void* value;
+    uint32_t value_len;
+    ret = libtock_flash_index_find(&table, key, sizeof(key), &value, &value_len);
+    if (ret != RETURNCODE_SUCCESS || value_len != sizeof(bytes) || memcmp(value, bytes, sizeof(bytes)) != 0) {
+      printf("Lookup of key %lu failed\n", (unsigned long) i);
+      return -1;
+    }
+  }
+
+  for (uint32_t i = 0; i < ENTRIES; i++) {
+    uint8_t key[2] = { i, ((i * 37) & 0xff) ^ 1 };
+    const void* value;
+    uint32_t value_len;
+    if (libtock_flash_index_find(&table, key, sizeof(key), &value, &value_len) != RETURNCODE_ENOSUPPORT) {
+      printf("Missing key %lu was found\n", (unsigned long) i);
+      return -1;
+    }
+  }
+
+  printf("[SUCCESS] %d lookups\n", ENTRIES);
+  return 0;
+}
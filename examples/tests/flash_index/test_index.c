@@ -0,0 +1,144 @@
+// Generated by tools/flash_index.py, do not edit.
+
+#include <stdint.h>
+
+__attribute__((aligned(4))) const uint8_t test_index[1628] = {
+  0x46, 0x49, 0x44, 0x58, 0x01, 0x00, 0x00, 0x00, 0x5c, 0x06, 0x00, 0x00,
+  0x40, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x48, 0x00, 0x00, 0x00,
+  0xe5, 0x65, 0xea, 0x1e, 0x13, 0x00, 0x32, 0x00, 0x09, 0x00, 0x02, 0x00,
+  0x00, 0x00, 0x14, 0x00, 0x57, 0x00, 0x01, 0x00, 0x01, 0x00, 0x3b, 0x01,
+  0x02, 0x00, 0xec, 0x00, 0xf1, 0x00, 0x01, 0x00, 0x01, 0x00, 0x26, 0x00,
+  0x0e, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00,
+  0xff, 0xff, 0xff, 0xff, 0x17, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+  0x1a, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff,
+  0x0f, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff,
+  0x39, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00,
+  0x11, 0x00, 0x00, 0x00, 0x26, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00,
+  0x2f, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x2d, 0x00, 0x00, 0x00,
+  0xff, 0xff, 0xff, 0xff, 0x3a, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+  0x29, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x27, 0x00, 0x00, 0x00,
+  0x28, 0x00, 0x00, 0x00, 0x15, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00,
+  0xff, 0xff, 0xff, 0xff, 0x20, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00,
+  0x3d, 0x00, 0x00, 0x00, 0x37, 0x00, 0x00, 0x00, 0x33, 0x00, 0x00, 0x00,
+  0x1c, 0x00, 0x00, 0x00, 0x36, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00,
+  0x3b, 0x00, 0x00, 0x00, 0x2b, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00,
+  0x35, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x19, 0x00, 0x00, 0x00,
+  0x24, 0x00, 0x00, 0x00, 0x1d, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x1b, 0x00, 0x00, 0x00,
+  0x3f, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x0c, 0x00, 0x00, 0x00,
+  0x21, 0x00, 0x00, 0x00, 0x23, 0x00, 0x00, 0x00, 0x12, 0x00, 0x00, 0x00,
+  0x1e, 0x00, 0x00, 0x00, 0x31, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+  0x32, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00,
+  0x22, 0x00, 0x00, 0x00, 0x2e, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+  0x2a, 0x00, 0x00, 0x00, 0x16, 0x00, 0x00, 0x00, 0x34, 0x00, 0x00, 0x00,
+  0x3e, 0x00, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x25, 0x00, 0x00, 0x00,
+  0x60, 0x04, 0x00, 0x00, 0x5c, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x68, 0x04, 0x00, 0x00, 0x64, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x70, 0x04, 0x00, 0x00, 0x6c, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x78, 0x04, 0x00, 0x00, 0x74, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x80, 0x04, 0x00, 0x00, 0x7c, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x88, 0x04, 0x00, 0x00, 0x84, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x90, 0x04, 0x00, 0x00, 0x8c, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x98, 0x04, 0x00, 0x00, 0x94, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xa0, 0x04, 0x00, 0x00, 0x9c, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xa8, 0x04, 0x00, 0x00, 0xa4, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xb0, 0x04, 0x00, 0x00, 0xac, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xb8, 0x04, 0x00, 0x00, 0xb4, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xc0, 0x04, 0x00, 0x00, 0xbc, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xc8, 0x04, 0x00, 0x00, 0xc4, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xd0, 0x04, 0x00, 0x00, 0xcc, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xd8, 0x04, 0x00, 0x00, 0xd4, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xe0, 0x04, 0x00, 0x00, 0xdc, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xe8, 0x04, 0x00, 0x00, 0xe4, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xf0, 0x04, 0x00, 0x00, 0xec, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xf8, 0x04, 0x00, 0x00, 0xf4, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x00, 0x05, 0x00, 0x00, 0xfc, 0x04, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x08, 0x05, 0x00, 0x00, 0x04, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x10, 0x05, 0x00, 0x00, 0x0c, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x18, 0x05, 0x00, 0x00, 0x14, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x20, 0x05, 0x00, 0x00, 0x1c, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x28, 0x05, 0x00, 0x00, 0x24, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x30, 0x05, 0x00, 0x00, 0x2c, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x38, 0x05, 0x00, 0x00, 0x34, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x40, 0x05, 0x00, 0x00, 0x3c, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x48, 0x05, 0x00, 0x00, 0x44, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x50, 0x05, 0x00, 0x00, 0x4c, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x58, 0x05, 0x00, 0x00, 0x54, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x60, 0x05, 0x00, 0x00, 0x5c, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x68, 0x05, 0x00, 0x00, 0x64, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x70, 0x05, 0x00, 0x00, 0x6c, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x78, 0x05, 0x00, 0x00, 0x74, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x80, 0x05, 0x00, 0x00, 0x7c, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x88, 0x05, 0x00, 0x00, 0x84, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x90, 0x05, 0x00, 0x00, 0x8c, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x98, 0x05, 0x00, 0x00, 0x94, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xa0, 0x05, 0x00, 0x00, 0x9c, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xa8, 0x05, 0x00, 0x00, 0xa4, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xb0, 0x05, 0x00, 0x00, 0xac, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xb8, 0x05, 0x00, 0x00, 0xb4, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xc0, 0x05, 0x00, 0x00, 0xbc, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xc8, 0x05, 0x00, 0x00, 0xc4, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xd0, 0x05, 0x00, 0x00, 0xcc, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xd8, 0x05, 0x00, 0x00, 0xd4, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xe0, 0x05, 0x00, 0x00, 0xdc, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xe8, 0x05, 0x00, 0x00, 0xe4, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xf0, 0x05, 0x00, 0x00, 0xec, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0xf8, 0x05, 0x00, 0x00, 0xf4, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x00, 0x06, 0x00, 0x00, 0xfc, 0x05, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x08, 0x06, 0x00, 0x00, 0x04, 0x06, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x10, 0x06, 0x00, 0x00, 0x0c, 0x06, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x18, 0x06, 0x00, 0x00, 0x14, 0x06, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x20, 0x06, 0x00, 0x00, 0x1c, 0x06, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x28, 0x06, 0x00, 0x00, 0x24, 0x06, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x30, 0x06, 0x00, 0x00, 0x2c, 0x06, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x38, 0x06, 0x00, 0x00, 0x34, 0x06, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x40, 0x06, 0x00, 0x00, 0x3c, 0x06, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x48, 0x06, 0x00, 0x00, 0x44, 0x06, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x50, 0x06, 0x00, 0x00, 0x4c, 0x06, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x58, 0x06, 0x00, 0x00, 0x54, 0x06, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9e, 0x37, 0x79, 0xb1,
+  0x01, 0x25, 0x00, 0x00, 0x3c, 0x6e, 0xf3, 0x62, 0x02, 0x4a, 0x00, 0x00,
+  0xda, 0xa6, 0x6d, 0x13, 0x03, 0x6f, 0x00, 0x00, 0x78, 0xdd, 0xe6, 0xc4,
+  0x04, 0x94, 0x00, 0x00, 0x17, 0x15, 0x60, 0x75, 0x05, 0xb9, 0x00, 0x00,
+  0xb5, 0x4c, 0xda, 0x26, 0x06, 0xde, 0x00, 0x00, 0x53, 0x84, 0x53, 0xd7,
+  0x07, 0x03, 0x00, 0x00, 0xf1, 0xbb, 0xcd, 0x88, 0x08, 0x28, 0x00, 0x00,
+  0x8f, 0xf3, 0x47, 0x39, 0x09, 0x4d, 0x00, 0x00, 0x2e, 0x2a, 0xc0, 0xea,
+  0x0a, 0x72, 0x00, 0x00, 0xcc, 0x62, 0x3a, 0x9b, 0x0b, 0x97, 0x00, 0x00,
+  0x6a, 0x99, 0xb4, 0x4c, 0x0c, 0xbc, 0x00, 0x00, 0x08, 0xd1, 0x2d, 0xfd,
+  0x0d, 0xe1, 0x00, 0x00, 0xa7, 0x08, 0xa7, 0xae, 0x0e, 0x06, 0x00, 0x00,
+  0x45, 0x40, 0x21, 0x5f, 0x0f, 0x2b, 0x00, 0x00, 0xe3, 0x77, 0x9b, 0x10,
+  0x10, 0x50, 0x00, 0x00, 0x81, 0xaf, 0x14, 0xc1, 0x11, 0x75, 0x00, 0x00,
+  0x1f, 0xe6, 0x8e, 0x72, 0x12, 0x9a, 0x00, 0x00, 0xbe, 0x1e, 0x08, 0x23,
+  0x13, 0xbf, 0x00, 0x00, 0x5c, 0x55, 0x81, 0xd4, 0x14, 0xe4, 0x00, 0x00,
+  0xfa, 0x8c, 0xfb, 0x85, 0x15, 0x09, 0x00, 0x00, 0x98, 0xc4, 0x75, 0x36,
+  0x16, 0x2e, 0x00, 0x00, 0x36, 0xfb, 0xee, 0xe7, 0x17, 0x53, 0x00, 0x00,
+  0xd5, 0x33, 0x68, 0x98, 0x18, 0x78, 0x00, 0x00, 0x73, 0x6a, 0xe2, 0x49,
+  0x19, 0x9d, 0x00, 0x00, 0x11, 0xa2, 0x5b, 0xfa, 0x1a, 0xc2, 0x00, 0x00,
+  0xaf, 0xd9, 0xd5, 0xab, 0x1b, 0xe7, 0x00, 0x00, 0x4e, 0x11, 0x4f, 0x5c,
+  0x1c, 0x0c, 0x00, 0x00, 0xec, 0x48, 0xc9, 0x0d, 0x1d, 0x31, 0x00, 0x00,
+  0x8a, 0x80, 0x42, 0xbe, 0x1e, 0x56, 0x00, 0x00, 0x28, 0xb7, 0xbc, 0x6f,
+  0x1f, 0x7b, 0x00, 0x00, 0xc6, 0xef, 0x36, 0x20, 0x20, 0xa0, 0x00, 0x00,
+  0x65, 0x26, 0xaf, 0xd1, 0x21, 0xc5, 0x00, 0x00, 0x03, 0x5e, 0x29, 0x82,
+  0x22, 0xea, 0x00, 0x00, 0xa1, 0x95, 0xa3, 0x33, 0x23, 0x0f, 0x00, 0x00,
+  0x3f, 0xcd, 0x1c, 0xe4, 0x24, 0x34, 0x00, 0x00, 0xde, 0x04, 0x96, 0x95,
+  0x25, 0x59, 0x00, 0x00, 0x7c, 0x3c, 0x10, 0x46, 0x26, 0x7e, 0x00, 0x00,
+  0x1a, 0x73, 0x89, 0xf7, 0x27, 0xa3, 0x00, 0x00, 0xb8, 0xab, 0x03, 0xa8,
+  0x28, 0xc8, 0x00, 0x00, 0x56, 0xe2, 0x7d, 0x59, 0x29, 0xed, 0x00, 0x00,
+  0xf5, 0x19, 0xf7, 0x0a, 0x2a, 0x12, 0x00, 0x00, 0x93, 0x51, 0x70, 0xbb,
+  0x2b, 0x37, 0x00, 0x00, 0x31, 0x88, 0xea, 0x6c, 0x2c, 0x5c, 0x00, 0x00,
+  0xcf, 0xc0, 0x64, 0x1d, 0x2d, 0x81, 0x00, 0x00, 0x6d, 0xf7, 0xdd, 0xce,
+  0x2e, 0xa6, 0x00, 0x00, 0x0c, 0x2f, 0x57, 0x7f, 0x2f, 0xcb, 0x00, 0x00,
+  0xaa, 0x66, 0xd1, 0x30, 0x30, 0xf0, 0x00, 0x00, 0x48, 0x9e, 0x4a, 0xe1,
+  0x31, 0x15, 0x00, 0x00, 0xe6, 0xd5, 0xc4, 0x92, 0x32, 0x3a, 0x00, 0x00,
+  0x85, 0x0d, 0x3e, 0x43, 0x33, 0x5f, 0x00, 0x00, 0x23, 0x44, 0xb7, 0xf4,
+  0x34, 0x84, 0x00, 0x00, 0xc1, 0x7c, 0x31, 0xa5, 0x35, 0xa9, 0x00, 0x00,
+  0x5f, 0xb3, 0xab, 0x56, 0x36, 0xce, 0x00, 0x00, 0xfd, 0xeb, 0x25, 0x07,
+  0x37, 0xf3, 0x00, 0x00, 0x9c, 0x22, 0x9e, 0xb8, 0x38, 0x18, 0x00, 0x00,
+  0x3a, 0x5a, 0x18, 0x69, 0x39, 0x3d, 0x00, 0x00, 0xd8, 0x91, 0x92, 0x1a,
+  0x3a, 0x62, 0x00, 0x00, 0x76, 0xc9, 0x0b, 0xcb, 0x3b, 0x87, 0x00, 0x00,
+  0x15, 0x00, 0x85, 0x7c, 0x3c, 0xac, 0x00, 0x00, 0xb3, 0x37, 0xff, 0x2d,
+  0x3d, 0xd1, 0x00, 0x00, 0x51, 0x6f, 0x78, 0xde, 0x3e, 0xf6, 0x00, 0x00,
+  0xef, 0xa6, 0xf2, 0x8f, 0x3f, 0x1b, 0x00, 0x00,
+};
+
+const uint32_t test_index_size = 1628;
@@ -0,0 +1,46 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock/storage/flash_log.h>
+#include <libtock/tock.h>
+
+LIBTOCK_FLASH_LOG_DECLARE(4);
+
+// Print the newest `n` records, which the previous run left.
+static void print_tail(uint32_t n) {
+  uint32_t first, last;
+  if (!libtock_flash_log_range(&first, &last)) {
+    printf("Log is empty.\n");
+    return;
+  }
+  printf("Log holds records %lu to %lu.\n", first, last);
+
+  if (last - first >= n) first = last - n + 1;
+  for (uint32_t seq = first; seq <= last; seq++) {
+    libtock_flash_log_record_t record;
+    if (libtock_flash_log_read(seq, &record) != RETURNCODE_SUCCESS) continue;
+    printf("  %5lu %8lu ms: %.*s\n", record.seq, record.ms, record.len, (const char*) record.data);
+  }
+}
+
+int main(void) {
+  returncode_t ret = libtock_flash_log_init(0);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("flash_log: FAILED init (%s)\n", tock_strrcode(ret));
+    return -1;
+  }
+  print_tail(8);
+
+  libtock_flash_log_printf(0, "boot");
+  for (int i = 0; i < 5; i++) {
+    libtock_flash_log_printf(1, "step %d", i);
+    libtocksync_alarm_delay_ms(100);
+  }
+  libtock_flash_log_printf(2, "about to fault");
+
+  // No flush first: the records are on flash by the time the delay ends.
+  libtocksync_alarm_delay_ms(500);
+  printf("Faulting, the next run prints this run's records.\n");
+  int* x = (int*)(0xffffff00);
+  *x = 1;
+}
@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libtock-sync/display/screen.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock-sync/services/framebuffer.h>
+#include <libtock/services/framebuffer_text.h>
+
+// Moves a small square across a static screen and counts frames in a status
+// line. Each flush only sends the square's old and new positions and the
+// status line.
+
+#define SQUARE 16
+#define STATUS_CELLS 12
+
+static uint8_t glyph_cache[16 * LIBTOCK_FRAMEBUFFER_TEXT_WIDTH * LIBTOCK_FRAMEBUFFER_TEXT_HEIGHT * 4];
+
+int main(void) {
+  uint32_t width, height;
+  libtock_screen_format_t format;
+  if (libtock_screen_get_resolution(&width, &height) != RETURNCODE_SUCCESS ||
+      libtocksync_screen_get_pixel_format(&format) != RETURNCODE_SUCCESS) {
+    printf("No screen\n");
+    return -1;
+  }
+
+  size_t stride   = width * libtock_screen_get_bits_per_pixel(format) / 8;
+  uint8_t* pixels = malloc(stride * height);
+  uint8_t* transfer;
+  if (pixels == NULL || libtock_screen_buffer_init(stride * SQUARE, &transfer) != TOCK_STATUSCODE_SUCCESS) {
+    printf("Out of memory\n");
+    return -1;
+  }
+
+  libtock_framebuffer_t fb;
+  returncode_t ret = libtock_framebuffer_init(&fb, pixels, width, height, format, transfer, stride * SQUARE);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Unsupported screen: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  libtock_framebuffer_text_t text;
+  libtock_framebuffer_text_init(&text, &fb, 1, glyph_cache, sizeof(glyph_cache));
+
+  libtocksync_screen_set_brightness(100);
+  libtock_framebuffer_fill_rect(&fb, 0, 0, width, height, 0);
+  libtocksync_framebuffer_flush(&fb);
+
+  int x = 0, y = LIBTOCK_FRAMEBUFFER_TEXT_HEIGHT, dx = 3, dy = 2;
+  for (uint32_t frame = 0; ; frame++) {
+    char status[STATUS_CELLS + 1];
+    snprintf(status, sizeof(status), "frame %lu", frame);
+    libtock_framebuffer_text_draw_field(&text, 0, 0, STATUS_CELLS, status);
+
+    libtock_framebuffer_fill_rect(&fb, x, y, SQUARE, SQUARE, 0);
+    if (x + dx < 0 || x + dx + SQUARE > (int) width) dx = -dx;
+    if (y + dy < LIBTOCK_FRAMEBUFFER_TEXT_HEIGHT || y + dy + SQUARE > (int) height) dy = -dy;
+    x += dx;
+    y += dy;
+    libtock_framebuffer_fill_rect(&fb, x, y, SQUARE, SQUARE, 0xF800);
+
+    ret = libtocksync_framebuffer_flush(&fb);
+    if (ret != RETURNCODE_SUCCESS) printf("Flush failed: %s\n", tock_strrcode(ret));
+    libtocksync_alarm_delay_ms(20);
+  }
+}
@@ -0,0 +1,68 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libtock-sync/display/screen.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock-sync/services/framebuffer.h>
+#include <libtock/services/time.h>
+
+// Draws an arrow pointing up at the top left of a striped background, in
+// every rotation, and times the flushes.
+
+#define TRANSFER_ROWS 8
+#define ARROW 24
+
+static void draw(libtock_framebuffer_t* fb) {
+  for (int y = 0; y < fb->height; y += 8) {
+    libtock_framebuffer_fill_rect(fb, 0, y, fb->width, 8, (y / 8) % 2 ? 0x001F : 0x0000);
+  }
+  // A triangle over a stem.
+  for (int row = 0; row < ARROW / 2; row++) {
+    libtock_framebuffer_fill_rect(fb, 4 + ARROW / 2 - row, 4 + row, 2 * row + 1, 1, 0xFFFF);
+  }
+  libtock_framebuffer_fill_rect(fb, 4 + ARROW / 2 - 2, 4 + ARROW / 2, 5, ARROW / 2, 0xFFFF);
+}
+
+int main(void) {
+  uint32_t width, height;
+  libtock_screen_format_t format;
+  if (libtock_screen_get_resolution(&width, &height) != RETURNCODE_SUCCESS ||
+      libtocksync_screen_get_pixel_format(&format) != RETURNCODE_SUCCESS) {
+    printf("No screen\n");
+    return -1;
+  }
+
+  size_t stride   = width * libtock_screen_get_bits_per_pixel(format) / 8;
+  uint8_t* pixels = malloc(stride * height);
+  uint8_t* transfer;
+  if (pixels == NULL || libtock_screen_buffer_init(stride * TRANSFER_ROWS, &transfer) != TOCK_STATUSCODE_SUCCESS) {
+    printf("Out of memory\n");
+    return -1;
+  }
+
+  libtock_framebuffer_t fb;
+  returncode_t ret = libtock_framebuffer_init(&fb, pixels, width, height, format, transfer, stride * TRANSFER_ROWS);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Unsupported screen: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  libtocksync_screen_set_brightness(100);
+  while (1) {
+    for (int rotation = ROTATION_NORMAL; rotation <= ROTATION_270; rotation++) {
+      libtock_framebuffer_set_rotation(&fb, rotation);
+      draw(&fb);
+
+      uint64_t start = libtock_time_now_us64();
+      ret = libtocksync_framebuffer_flush(&fb);
+      uint32_t us = (uint32_t) (libtock_time_now_us64() - start);
+      if (ret != RETURNCODE_SUCCESS) {
+        printf("Flush failed: %s\n", tock_strrcode(ret));
+      } else {
+        printf("%3d degrees, %ux%u: %" PRIu32 " us\n", rotation * 90, fb.width, fb.height, us);
+      }
+      libtocksync_alarm_delay_ms(2000);
+    }
+  }
+}
@@ -0,0 +1,55 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock/peripherals/gpio.h>
+#include <libtock/services/gpio_events.h>
+#include <libtock/services/time.h>
+
+#define PIN 0
+#define QUEUE_SIZE 64
+
+static libtock_gpio_event_t events[QUEUE_SIZE];
+static libtock_gpio_events_t queue;
+
+int main(void) {
+  printf("[Test] GPIO Events\n");
+  printf("Feed a square wave into GPIO pin 0.\n");
+
+  returncode_t ret = libtock_gpio_events_start(&queue, events, QUEUE_SIZE, NULL);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_gpio_enable_input(PIN, libtock_pull_down);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_gpio_enable_interrupt(PIN, libtock_change);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("ERROR: Unable to set up pin %d: %s\n", PIN, tock_strrcode(ret));
+    return -1;
+  }
+
+  uint64_t last_rise = 0;
+  while (1) {
+    // Edges queue up while the app sleeps.
+    libtocksync_alarm_delay_ms(250);
+
+    uint32_t edges   = 0;
+    uint32_t periods = 0;
+    uint64_t sum     = 0;
+    libtock_gpio_event_t event;
+    while (libtock_gpio_events_pop(&queue, &event)) {
+      edges++;
+      if (!event.level) continue;
+      if (last_rise != 0) {
+        sum += event.ticks - last_rise;
+        periods++;
+      }
+      last_rise = event.ticks;
+    }
+
+    if (periods == 0) {
+      printf("%lu edges\n", (unsigned long) edges);
+    } else {
+      uint64_t hz = (uint64_t) libtock_time_frequency() * periods / sum;
+      printf("%lu edges, about %lu Hz, %lu dropped, %lu missed\n", (unsigned long) edges, (unsigned long) hz,
+             (unsigned long) libtock_gpio_events_dropped(&queue), (unsigned long) libtock_gpio_events_missed(&queue));
+    }
+  }
+
+  return 0;
+}
@@ -69,6 +69,38 @@ static int loopback(uint32_t out, uint32_t in) {
   return 0;
 }
 
+// The same loopback through a two pin port, bit 0 driving bit 1.
+static int port_loopback(void) {
+  static const uint32_t pins[2] = { 0, 1 };
+  libtock_gpio_port_t port;
+  libtock_gpio_port_init(&port, pins, 2);
+
+  int ret = libtock_gpio_port_enable_output(&port, 0x1);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_gpio_port_enable_input(&port, 0x2, libtock_pull_none);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("ERROR: Unable to configure port: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  for (uint32_t i = 0; i < 10; i++) {
+    uint32_t value = i % 2;
+    ret = libtock_gpio_write_mask(&port, 0x1, value);
+    uint32_t read = 0;
+    if (ret == RETURNCODE_SUCCESS) ret = libtock_gpio_read_mask(&port, 0x2, &read);
+    if (ret != RETURNCODE_SUCCESS) {
+      printf("ERROR: Unable to use port: %s\n", tock_strrcode(ret));
+      return -1;
+    }
+    if (read != value << 1) {
+      printf("ERROR: Expected to read port 0x%lx, got 0x%lx!\n", (unsigned long) (value << 1), (unsigned long) read);
+      return -1;
+    }
+  }
+
+  printf("SUCCESS\n");
+  return 0;
+}
+
 int main(void) {
   int ret;
 
@@ -99,5 +131,10 @@ int main(void) {
   ret = loopback(1, 0);
   if (ret < 0) return -1;
 
+  printf("Checking port loopback pin 0 -> pin 1...");
+  fflush(stdout);
+  ret = port_loopback();
+  if (ret < 0) return -1;
+
   return 0;
 }
@@ -0,0 +1,69 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock-sync/services/gpio_sequence.h>
+#include <libtock/peripherals/gpio.h>
+#include <libtock/services/gpio_sequence.h>
+
+// WS2812 strip on SPI MOSI, clocked at three SPI bits per LED bit.
+#define LEDS 8
+#define SPI_RATE 2400000
+
+// Slow waveform on GPIO pins 0 and 1, played from userspace.
+#define PORT_WIDTH 2
+
+// Two steps per bit plus the latch.
+static libtock_gpio_step_t steps[LEDS * 24 * 2 + 1];
+static libtock_gpio_sequence_t seq;
+static uint8_t spi_buffer[(LEDS * 24 * 3 + 720) / 8 + 1];
+
+static const uint32_t port_pins[PORT_WIDTH] = { 0, 1 };
+static libtock_gpio_port_t port;
+
+// Colour wheel position `pos` as green, red, blue at low brightness.
+static void wheel(uint8_t pos, uint8_t* grb) {
+  uint8_t third = (uint8_t) (pos % 85);
+  uint8_t up    = (uint8_t) (third * 3 / 8);
+  uint8_t down  = (uint8_t) (32 - up);
+  if (pos < 85) {
+    grb[0] = up, grb[1] = down, grb[2] = 0;
+  } else if (pos < 170) {
+    grb[0] = down, grb[1] = 0, grb[2] = up;
+  } else {
+    grb[0] = 0, grb[1] = up, grb[2] = down;
+  }
+}
+
+int main(void) {
+  printf("[Test] GPIO Sequence\n");
+
+  // A clock on pin 0 with a frame pulse on pin 1, 100 us per step.
+  libtock_gpio_sequence_init(&seq, steps, sizeof(steps) / sizeof(steps[0]));
+  libtock_gpio_sequence_add(&seq, 0x3, 0x3, 100000);
+  for (int i = 0; i < 8; i++) {
+    libtock_gpio_sequence_add(&seq, 0x3, 0x0, 100000);
+    libtock_gpio_sequence_add(&seq, 0x1, 0x1, 100000);
+  }
+  returncode_t ret = libtock_gpio_port_init(&port, port_pins, PORT_WIDTH);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_gpio_port_enable_output(&port, 0x3);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_gpio_sequence_play_port(&port, &seq);
+  printf("Port waveform of %lu steps: %s\n", seq.count, tock_strrcode(ret));
+
+  for (uint8_t frame = 0; ; frame += 4) {
+    uint8_t grb[LEDS * 3];
+    for (int i = 0; i < LEDS; i++) {
+      wheel((uint8_t) (frame + i * 32), &grb[i * 3]);
+    }
+
+    libtock_gpio_sequence_init(&seq, steps, sizeof(steps) / sizeof(steps[0]));
+    ret = libtock_gpio_sequence_add_ws2812(&seq, 0x1, grb, LEDS);
+    if (ret == RETURNCODE_SUCCESS) {
+      ret = libtocksync_gpio_sequence_play_spi(&seq, 0x1, SPI_RATE, spi_buffer, sizeof(spi_buffer));
+    }
+    if (ret != RETURNCODE_SUCCESS) {
+      printf("WS2812 write failed: %s\n", tock_strrcode(ret));
+      return -1;
+    }
+    libtocksync_alarm_delay_ms(20);
+  }
+}
@@ -26,8 +26,17 @@ int main(void) {
   printf("Toggling port 0 pin 0\n");
   libtocksync_gpio_async_make_output(0, 0);
 
+  // Pins 2 to 5 count in binary, one pin write per changed bit.
+  printf("Counting on port 0 pins 2-5\n");
+  libtock_gpio_async_port_t counter;
+  libtock_gpio_async_port_init(&counter, 0);
+  libtocksync_gpio_async_port_make_output(&counter, 0x3c);
+
+  uint32_t count = 0;
   while (1) {
     libtocksync_gpio_async_set(0, 0);
+    libtocksync_gpio_async_port_write(&counter, 0x3c, count << 2);
+    count++;
     libtocksync_alarm_delay_ms(500);
     libtocksync_gpio_async_clear(0, 0);
     libtocksync_alarm_delay_ms(500);
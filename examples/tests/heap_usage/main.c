@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libtock/tock.h>
+
+#define BUFFERS 8
+
+static void print_usage(const char* step) {
+  tock_heap_usage_t usage;
+  tock_heap_usage(&usage);
+  printf("%-12s brk %p  used %5lu  peak %5lu  reserved %5lu  free %5lu\n", step, usage.brk, usage.used,
+         usage.peak, usage.reserved, usage.free);
+}
+
+int main(void) {
+  printf("[TEST] Heap usage\n");
+  print_usage("start");
+
+  void* buffers[BUFFERS];
+  for (int i = 0; i < BUFFERS; i++) {
+    buffers[i] = malloc(100 * (i + 1));
+    if (buffers[i] == NULL) {
+      printf("malloc of %d bytes failed\n", 100 * (i + 1));
+      return -1;
+    }
+  }
+  print_usage("allocated");
+
+  for (int i = 0; i < BUFFERS; i++) {
+    free(buffers[i]);
+  }
+  print_usage("freed");
+
+  // Peak must still reflect the allocations above.
+  tock_heap_usage_t usage;
+  tock_heap_usage(&usage);
+  printf("heap_usage: %s\n", usage.peak >= 3600 ? "success" : "FAILED");
+  return 0;
+}
@@ -11,6 +11,10 @@
 uint8_t key_buf[KEY_LEN]   = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xA0, 0xA1};
 uint8_t data_buf[DATA_LEN] = "A language empowering everyone to build reliable and efficient software.";
 uint8_t dest_buf[DEST_LEN];
+uint8_t context_buf[DEST_LEN];
+
+// Size of each piece fed to the HMAC context.
+#define CHUNK 16
 
 
 
@@ -32,5 +36,27 @@ int main(void) {
     return -1;
   }
 
+  // The same HMAC twice through a context that keeps the key, fed piece by
+  // piece.
+  libtock_hmac_context_t context;
+  ret = libtock_hmac_context_init(&context, LIBTOCK_HMAC_SHA256, key_buf, 11);
+  uint32_t len = strlen((const char*) data_buf);
+  for (int round = 0; round < 2 && ret == RETURNCODE_SUCCESS; round++) {
+    for (uint32_t offset = 0; ret == RETURNCODE_SUCCESS && offset < len; offset += CHUNK) {
+      uint32_t n = len - offset < CHUNK ? len - offset : CHUNK;
+      ret = libtocksync_hmac_context_update(&context, data_buf + offset, n);
+    }
+    if (ret == RETURNCODE_SUCCESS) ret = libtocksync_hmac_context_finish(&context, context_buf, DEST_LEN);
+    if (ret == RETURNCODE_SUCCESS && memcmp(dest_buf, context_buf, DEST_LEN) != 0) {
+      printf("HMAC from the context differs.\n");
+      return -1;
+    }
+  }
+  libtock_hmac_context_release(&context);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Unable to compute HMAC with a context: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
   return 0;
 }
@@ -0,0 +1,63 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock/kernel/idle_hint.h>
+#include <libtock/services/alarm.h>
+
+static uint32_t region[LIBTOCK_IDLE_HINT_BUFFER_LEN / 4];
+
+static libtock_alarm_t alarm;
+static bool fired = false;
+
+static void alarm_cb(__attribute__ ((unused)) uint32_t now,
+                     __attribute__ ((unused)) uint32_t scheduled,
+                     __attribute__ ((unused)) void*    opaque) {
+  fired = true;
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  printf("idle_hint: %s: %s\n", what, ok ? "ok" : "FAIL");
+  if (!ok) failures++;
+}
+
+int main(void) {
+  returncode_t ret = libtock_idle_hint_allocate_region((uint8_t*) region, sizeof(region));
+  if (ret != RETURNCODE_SUCCESS) {
+    // The hints are still kept, the kernel just cannot see them.
+    printf("idle_hint: no region: %s\n", tock_strrcode(ret));
+  }
+
+  uint32_t frequency;
+  libtock_alarm_get_frequency(&frequency);
+  libtock_idle_hint_set_latency_ms(20);
+
+  // A wakeup 100 ms from now that may come 50 ms late.
+  libtock_alarm_in_ms_with_slack(100, 50, alarm_cb, NULL, &alarm);
+  libtock_idle_hint_t hint;
+  libtock_idle_hint_get(&hint);
+  uint32_t window = hint.deadline - hint.wakeup;
+  check(hint.has_wakeup, "wakeup published");
+  check(window >= frequency / 20 - 1 && window <= frequency / 20 + 1, "deadline is the slack after the wakeup");
+  check(hint.latency == (uint32_t) ((uint64_t) 20 * frequency / 1000), "latency");
+
+  // The region only changes when the app waits: here, for the alarm.
+  if (ret == RETURNCODE_SUCCESS) check(region[0] == 0, "nothing published before waiting");
+  yield_for(&fired);
+  if (ret == RETURNCODE_SUCCESS) {
+    check(region[0] != 0, "published on wait");
+    check((region[1] & LIBTOCK_IDLE_HINT_WAKEUP) && region[2] == hint.wakeup && region[3] == hint.deadline &&
+          region[4] == hint.latency, "region matches");
+  }
+
+  libtock_idle_hint_get(&hint);
+  check(!hint.has_wakeup, "no wakeup once the alarm fired");
+
+  // A delay has no slack, so the kernel must wake the app right on time.
+  libtocksync_alarm_delay_ms(10);
+  if (ret == RETURNCODE_SUCCESS) check(region[3] == region[2], "no window without slack");
+
+  printf("idle_hint: %s\n", failures == 0 ? "PASS" : "FAIL");
+  return 0;
+}
@@ -15,20 +15,31 @@
 //
 // Optionally uses the packet inspection functions to print out relevant
 // information from the frame. (Set PRINT_PAYLOAD to 1)
+//
+// The ring holds RX_FRAMES - 1 frames, chosen here rather than by the
+// library default, and the app reports when it fills up.
+
+#define RX_FRAMES 6
 
-libtock_ieee802154_rxbuf rx_ring_buf;
+static uint8_t rx_storage[libtock_ieee802154_RING_BUFFER_LEN_FOR(RX_FRAMES)];
+static libtock_ieee802154_ring_t rx_ring;
 
-static void callback(__attribute__ ((unused)) int pans,
-                     __attribute__ ((unused)) int dst_addr,
-                     __attribute__ ((unused)) int src_addr) {
+static void callback(__attribute__ ((unused)) int   pans,
+                     __attribute__ ((unused)) int   dst_addr,
+                     __attribute__ ((unused)) int   src_addr,
+                     __attribute__ ((unused)) void* ud) {
   libtock_led_toggle(0);
 
   // Before accessing an "allowed" buffer, we must request it back.
   // We do this with the reset_ring_buf function. Because this example
   // only uses one ring buffer, we pass null values to unallow the ringbuffer.
-  libtock_reset_ring_buf(NULL, NULL, NULL);
+  libtock_ieee802154_ring_reset(NULL, NULL, NULL);
 
-  uint8_t* packet_rx = libtock_ieee802154_read_next_frame(&rx_ring_buf);
+  uint32_t full      = libtock_ieee802154_ring_full(&rx_ring);
+  uint8_t* packet_rx = libtock_ieee802154_ring_read_next(&rx_ring);
+  if (libtock_ieee802154_ring_full(&rx_ring) != full) {
+    printf("Receive ring was full, frames may have been dropped\n");
+  }
 
   #define PRINT_PAYLOAD 1
   #define PRINT_STRING 0
@@ -91,17 +102,17 @@ static void callback(__attribute__ ((unused)) int pans,
     }
     #endif
 
-    packet_rx = libtock_ieee802154_read_next_frame(&rx_ring_buf);
+    packet_rx = libtock_ieee802154_ring_read_next(&rx_ring);
   }
 
-  libtock_ieee802154_receive(&rx_ring_buf, callback);
+  libtock_ieee802154_ring_reset(&rx_ring, callback, NULL);
 }
 
 int main(void) {
   returncode_t err;
 
   printf("[IEEE802.15.4] Receive\n");
-  memset(rx_ring_buf, 0, libtock_ieee802154_RING_BUFFER_LEN);
+  libtock_ieee802154_ring_init(&rx_ring, rx_storage, sizeof(rx_storage));
 
   err = libtock_ieee802154_set_address_short(0x802);
   if (err != RETURNCODE_SUCCESS) {
@@ -119,7 +130,7 @@ int main(void) {
   if (err != RETURNCODE_SUCCESS) {
     printf("Error: could enable radio (%i)\n", err);
   }
-  err = libtock_ieee802154_receive(&rx_ring_buf, callback);
+  err = libtock_ieee802154_ring_reset(&rx_ring, callback, NULL);
   if (err != RETURNCODE_SUCCESS) {
     printf("Error: could not start receive (%i)\n", err);
   }
@@ -0,0 +1,29 @@
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <libtock-sync/net/ieee802154.h>
+#include <libtock-sync/net/ieee802154_scan.h>
+#include <libtock-sync/services/alarm.h>
+
+#define DWELL_MS 100
+
+int main(void) {
+  libtocksync_ieee802154_up();
+
+  libtock_ieee802154_scan_result_t results[LIBTOCK_IEEE802154_CHANNEL_MAX - LIBTOCK_IEEE802154_CHANNEL_MIN + 1];
+  while (1) {
+    int count;
+    returncode_t ret = libtocksync_ieee802154_energy_scan(LIBTOCK_IEEE802154_CHANNEL_MASK_ALL, DWELL_MS, results,
+                                                          &count);
+    if (ret != RETURNCODE_SUCCESS) {
+      printf("Scan failed: %s\n", tock_strrcode(ret));
+    } else {
+      for (int i = 0; i < count; i++) {
+        printf("channel %2u: %3u frames, %6" PRIu32 " us busy, %4d dBm\n",
+               results[i].channel, results[i].frames, results[i].busy_us, results[i].rssi);
+      }
+      printf("Quietest channel: %u\n\n", libtock_ieee802154_scan_quietest(results, count));
+    }
+    libtocksync_alarm_delay_ms(1000);
+  }
+}
@@ -0,0 +1,72 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock/net/ieee802154_mirror.h>
+#include <libtock/services/time.h>
+
+// Look every neighbor up by short address, the way a MAC layer does per
+// frame, through the kernel and through the mirror.
+
+#define ROUNDS 100
+
+int main(void) {
+  returncode_t ret = libtock_ieee802154_mirror_init();
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Mirror init failed: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  uint32_t max;
+  libtock_ieee802154_max_neighbors(&max);
+  for (uint32_t i = 0; i < max; i++) {
+    uint8_t addr_long[8] = { 0xa0, 0, 0, 0, 0, 0, 0, (uint8_t) i };
+    ret = libtock_ieee802154_mirror_add_neighbor(0x1000 + i, addr_long, NULL);
+    if (ret != RETURNCODE_SUCCESS) {
+      printf("Adding neighbor %" PRIu32 " failed: %s\n", i, tock_strrcode(ret));
+      break;
+    }
+  }
+
+  uint8_t key_id[1] = { 1 };
+  uint8_t key[16]   = { 0 };
+  ret = libtock_ieee802154_mirror_add_key(SEC_LEVEL_ENCMIC32, KEY_ID_INDEX, key_id, key, NULL);
+  if (ret != RETURNCODE_SUCCESS) printf("Adding key failed: %s\n", tock_strrcode(ret));
+
+  uint32_t count = libtock_ieee802154_mirror_num_neighbors();
+  printf("%" PRIu32 " neighbors, %" PRIu32 " keys\n", count, libtock_ieee802154_mirror_num_keys());
+
+  uint32_t errors = 0;
+  uint64_t start  = libtock_time_now_us64();
+  for (int round = 0; round < ROUNDS; round++) {
+    for (uint32_t n = 0; n < count; n++) {
+      // Scan the kernel's list for the address.
+      uint16_t want = 0x1000 + n;
+      for (uint32_t i = 0; i < count; i++) {
+        uint16_t addr_short;
+        uint8_t addr_long[8];
+        if (libtock_ieee802154_get_neighbor(i, &addr_short, addr_long) == RETURNCODE_SUCCESS &&
+            addr_short == want) {
+          break;
+        }
+      }
+    }
+  }
+  uint32_t kernel_us = (uint32_t) (libtock_time_now_us64() - start);
+
+  start = libtock_time_now_us64();
+  for (int round = 0; round < ROUNDS; round++) {
+    for (uint32_t n = 0; n < count; n++) {
+      uint32_t index;
+      const libtock_ieee802154_neighbor_t* found = libtock_ieee802154_mirror_find_short(0x1000 + n, &index);
+      if (found == NULL || index != n) errors++;
+    }
+  }
+  uint32_t mirror_us = (uint32_t) (libtock_time_now_us64() - start);
+
+  if (libtock_ieee802154_mirror_find_key(SEC_LEVEL_ENCMIC32, KEY_ID_INDEX, key_id, NULL) == NULL) errors++;
+
+  printf("%d rounds: kernel %" PRIu32 " us, mirror %" PRIu32 " us, %" PRIu32 " errors\n",
+         ROUNDS, kernel_us, mirror_us, errors);
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <libtock-sync/net/ieee802154.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock/net/ieee802154.h>
+#include <libtock/services/ieee802154_tx_queue.h>
+#include <libtock/services/time.h>
+
+// IEEE 802.15.4 transmit throughput app.
+// Keeps QUEUE_DEPTH frames queued to the specified destination address, so
+// the next frame is handed to the kernel as soon as the previous one is on
+// air, and reports the rate once a second.
+
+#define QUEUE_DEPTH 4
+#define BUF_SIZE 60
+
+static uint8_t packets[QUEUE_DEPTH][BUF_SIZE];
+static libtock_ieee802154_tx_frame_t frames[QUEUE_DEPTH];
+static libtock_ieee802154_tx_frame_t* slots[QUEUE_DEPTH];
+
+static uint32_t sent   = 0;
+static uint32_t acked  = 0;
+static uint32_t failed = 0;
+
+static void frame_done(libtock_ieee802154_tx_frame_t* frame) {
+  if (frame->result == RETURNCODE_SUCCESS || frame->result == RETURNCODE_ENOACK) {
+    sent++;
+    if (frame->acked) acked++;
+  } else {
+    failed++;
+  }
+
+  // Change the sequence byte and send the frame again.
+  packets[frame - frames][0]++;
+  libtock_ieee802154_tx_queue_push(frame);
+}
+
+int main(void) {
+  printf("[IEEE802.15.4] Transmit queue\n");
+
+  libtock_ieee802154_set_address_short(0x1540);
+  libtock_ieee802154_set_pan(0xABCD);
+  libtock_ieee802154_config_commit();
+  libtocksync_ieee802154_up();
+
+  libtock_ieee802154_tx_queue_init(slots, QUEUE_DEPTH, frame_done);
+  for (int i = 0; i < QUEUE_DEPTH; i++) {
+    for (int j = 0; j < BUF_SIZE; j++) {
+      packets[i][j] = j;
+    }
+    frames[i] = (libtock_ieee802154_tx_frame_t) {
+      .payload = packets[i],
+      .len     = BUF_SIZE,
+      .addr    = 0x0802,
+      .level   = SEC_LEVEL_NONE,
+    };
+    returncode_t ret = libtock_ieee802154_tx_queue_push(&frames[i]);
+    if (ret != RETURNCODE_SUCCESS) {
+      printf("Error: could not queue frame (%i)\n", ret);
+    }
+  }
+
+  uint64_t last = libtock_time_now_us64();
+  while (1) {
+    libtocksync_alarm_delay_ms(1000);
+
+    uint64_t now = libtock_time_now_us64();
+    uint32_t us  = (uint32_t) (now - last);
+    printf("%lu frames/s, %lu acked, %lu failed\n",
+           (unsigned long) ((uint64_t) sent * 1000000 / us), (unsigned long) acked, (unsigned long) failed);
+    last   = now;
+    sent   = 0;
+    acked  = 0;
+    failed = 0;
+  }
+}
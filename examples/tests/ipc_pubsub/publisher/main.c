@@ -0,0 +1,21 @@
+#include <libtock-sync/services/alarm.h>
+#include <libtock/kernel/ipc_pubsub.h>
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+
+#include "../sample.h"
+
+static uint8_t slot[64] __attribute__((aligned(64)));
+static ipc_pubsub_publisher_t pub;
+
+int main(void) {
+  ipc_pubsub_publisher_init(&pub, PUBSUB_SERVICE, slot, sizeof(slot));
+
+  sample_t sample = { 0, 0 };
+  while (1) {
+    sample.counter++;
+    libtock_alarm_command_read(&sample.ticks);
+    // One write, however many subscribers there are.
+    ipc_pubsub_publish(&pub, &sample, sizeof(sample), true);
+    libtocksync_alarm_delay_ms(100);
+  }
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <stdint.h>
+
+#define PUBSUB_SERVICE "org.tockos.tests.ipc_pubsub.publisher"
+
+typedef struct {
+  uint32_t counter;
+  uint32_t ticks;
+} sample_t;
@@ -0,0 +1,35 @@
+#include <stdio.h>
+
+#include <libtock/kernel/ipc_pubsub.h>
+
+#include "../sample.h"
+
+static ipc_pubsub_subscriber_t sub;
+static uint32_t last_counter = 0;
+
+static void new_sample(__attribute__ ((unused)) uint32_t seq, __attribute__ ((unused)) void* ud) {
+  sample_t sample;
+  if (ipc_pubsub_read(&sub, &sample, sizeof(sample), NULL) != (int) sizeof(sample)) {
+    return;
+  }
+  if (sample.counter < last_counter) {
+    printf("subscriber: [FAIL] counter went from %lu to %lu\n", (unsigned long) last_counter,
+           (unsigned long) sample.counter);
+  }
+  last_counter = sample.counter;
+  if (sample.counter % 10 == 0) {
+    printf("subscriber: sample %lu at %lu ticks\n", (unsigned long) sample.counter, (unsigned long) sample.ticks);
+  }
+}
+
+int main(void) {
+  int ret = ipc_pubsub_subscribe(&sub, PUBSUB_SERVICE, new_sample, NULL);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("subscriber: no publisher\n");
+    return -1;
+  }
+
+  while (1) {
+    yield();
+  }
+}
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock/kernel/ipc_ring.h>
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+
+#define MESSAGES 1000
+
+static uint8_t region[512] __attribute__((aligned(512)));
+static ipc_ring_t ring;
+
+static int sent     = 0;
+static int received = 0;
+static int errors   = 0;
+
+static void format_message(char* buf, int i) {
+  snprintf(buf, 16, "msg %d", i);
+}
+
+// Queue as many requests as fit. The service notifies when it has made room.
+static void send_more(void) {
+  char msg[16];
+  while (sent < MESSAGES) {
+    format_message(msg, sent);
+    int ret = ipc_ring_send(&ring, msg, strlen(msg));
+    if (ret == RETURNCODE_ENOMEM) return;
+    if (ret != RETURNCODE_SUCCESS) errors++;
+    sent++;
+  }
+}
+
+static void ipc_callback(__attribute__ ((unused)) int   pid,
+                         __attribute__ ((unused)) int   len,
+                         __attribute__ ((unused)) int   arg2,
+                         __attribute__ ((unused)) void* ud) {
+  char reply[16];
+  char expected[16];
+  int n;
+  while ((n = ipc_ring_recv(&ring, reply, sizeof(reply))) >= 0) {
+    format_message(expected, received);
+    // Messages are lowercase, and rot13 twice gives back the original.
+    for (int i = 0; i < n; i++) {
+      if (reply[i] >= 'a' && reply[i] <= 'z') reply[i] = (((reply[i] - 'a') + 13) % 26) + 'a';
+    }
+    if (n != (int) strlen(expected) || memcmp(reply, expected, n) != 0) {
+      errors++;
+    }
+    received++;
+  }
+  send_more();
+}
+
+int main(void) {
+  size_t svc;
+  if (ipc_discover("org.tockos.tests.ipc_ring.service", &svc) != RETURNCODE_SUCCESS) {
+    printf("ipc_ring: no service\n");
+    return -1;
+  }
+
+  ipc_register_client_callback(svc, ipc_callback, NULL);
+  ipc_ring_client_init(&ring, svc, region, sizeof(region));
+
+  struct timeval start, end;
+  libtock_alarm_gettimeasticks(&start, NULL);
+  send_more();
+  while (received < MESSAGES) {
+    yield();
+  }
+  libtock_alarm_gettimeasticks(&end, NULL);
+
+  uint32_t ms = (end.tv_sec - start.tv_sec) * 1000 + (end.tv_usec - start.tv_usec) / 1000;
+  printf("ipc_ring: %d messages echoed in %lu ms, %d errors\n", MESSAGES, (unsigned long) ms, errors);
+  return 0;
+}
@@ -0,0 +1,45 @@
+#include <libtock/kernel/ipc_ring.h>
+#include <libtock/tock.h>
+
+static ipc_ring_t ring;
+
+static void rot13(char* buf, int len) {
+  for (int i = 0; i < len; i++) {
+    if (buf[i] >= 'a' && buf[i] <= 'z') {
+      buf[i] = (((buf[i] - 'a') + 13) % 26) + 'a';
+    } else if (buf[i] >= 'A' && buf[i] <= 'Z') {
+      buf[i] = (((buf[i] - 'A') + 13) % 26) + 'A';
+    }
+  }
+}
+
+// Drain every queued request, writing each reply straight into the reply
+// ring. Requests that do not fit yet are left until the client notifies that
+// it has made room.
+static void drain(void) {
+  const void* msg;
+  int len;
+  while ((len = ipc_ring_peek(&ring, &msg)) >= 0) {
+    char* reply = ipc_ring_reserve(&ring, len);
+    if (reply == NULL) return;
+    memcpy(reply, msg, len);
+    rot13(reply, len);
+    ipc_ring_commit(&ring, len);
+    ipc_ring_consume(&ring);
+  }
+}
+
+static void ipc_callback(int pid, int len, int buf, __attribute__ ((unused)) void* ud) {
+  if (ipc_ring_service_attach(&ring, pid, (void*) buf, len) != RETURNCODE_SUCCESS) {
+    return;
+  }
+  drain();
+}
+
+int main(void) {
+  ipc_register_service_callback("org.tockos.tests.ipc_ring.service", ipc_callback, NULL);
+
+  while (1) {
+    yield();
+  }
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+
+#include <libtock-sync/kernel/ipc_rpc.h>
+
+#include "../protocol.h"
+
+#define BATCHES   100
+#define PER_BATCH 4
+
+IPC_RPC_CLIENT_STUB(adder_add, ADDER_ADD, add_args_t)
+
+static uint8_t region[512] __attribute__((aligned(512)));
+static ipc_rpc_client_t client;
+
+static int errors = 0;
+
+static void add_done(int status, const void* result, size_t len, void* ud) {
+  int32_t expected = (int32_t) (intptr_t) ud;
+  if (status != RETURNCODE_SUCCESS || len != sizeof(add_result_t) ||
+      ((const add_result_t*) result)->sum != expected) {
+    errors++;
+  }
+}
+
+int main(void) {
+  if (ipc_rpc_client_init(&client, ADDER_SERVICE, region, sizeof(region)) != RETURNCODE_SUCCESS) {
+    printf("ipc_rpc: no service\n");
+    return -1;
+  }
+
+  for (int batch = 0; batch < BATCHES; batch++) {
+    // All calls of a batch reach the service with a single notify.
+    ipc_rpc_batch_begin(&client);
+    for (int i = 0; i < PER_BATCH; i++) {
+      add_args_t args = { batch, i };
+      if (adder_add(&client, &args, add_done, (void*) (intptr_t) (batch + i)) != RETURNCODE_SUCCESS) {
+        errors++;
+      }
+    }
+    ipc_rpc_batch_end(&client);
+
+    while (ipc_rpc_pending_count(&client) > 0) {
+      yield();
+    }
+  }
+
+  count_args_t args = { 0 };
+  count_result_t count;
+  size_t len = sizeof(count);
+  int ret    = libtocksync_ipc_rpc_call(&client, ADDER_COUNT, &args, sizeof(args), &count, &len);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("ipc_rpc: count failed: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  printf("ipc_rpc: %d calls in %d batches, %d errors, service counted %lu\n",
+         BATCHES * PER_BATCH, BATCHES, errors, (unsigned long) count.calls);
+  return 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+// Shared between the client and service apps.
+
+#define ADDER_SERVICE "org.tockos.tests.ipc_rpc.service"
+
+#define ADDER_ADD   0
+#define ADDER_COUNT 1
+
+typedef struct {
+  int32_t a;
+  int32_t b;
+} add_args_t;
+
+typedef struct {
+  int32_t sum;
+} add_result_t;
+
+typedef struct {
+  uint32_t unused;
+} count_args_t;
+
+typedef struct {
+  uint32_t calls;
+} count_result_t;
@@ -0,0 +1,36 @@
+#include <libtock/kernel/ipc_rpc.h>
+#include <libtock/tock.h>
+
+#include "../protocol.h"
+
+static uint32_t calls = 0;
+
+static int add_impl(const add_args_t* args, add_result_t* result, __attribute__ ((unused)) void* ud) {
+  result->sum = args->a + args->b;
+  calls++;
+  return RETURNCODE_SUCCESS;
+}
+
+static int count_impl(__attribute__ ((unused)) const count_args_t* args, count_result_t* result,
+                      __attribute__ ((unused)) void* ud) {
+  result->calls = calls;
+  return RETURNCODE_SUCCESS;
+}
+
+IPC_RPC_SERVICE_STUB(add_handler, add_args_t, add_result_t, add_impl)
+IPC_RPC_SERVICE_STUB(count_handler, count_args_t, count_result_t, count_impl)
+
+static const ipc_rpc_method_t methods[] = {
+  [ADDER_ADD]   = { add_handler, sizeof(add_result_t) },
+  [ADDER_COUNT] = { count_handler, sizeof(count_result_t) },
+};
+
+static ipc_rpc_service_t service;
+
+int main(void) {
+  ipc_rpc_service_init(&service, ADDER_SERVICE, methods, sizeof(methods) / sizeof(methods[0]), NULL);
+
+  while (1) {
+    yield();
+  }
+}
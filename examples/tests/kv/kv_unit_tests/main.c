@@ -4,6 +4,8 @@
 
 #include <libtock-sync/services/unit_test.h>
 #include <libtock-sync/storage/kv.h>
+#include <libtock-sync/storage/kv_iter.h>
+#include <libtock-sync/storage/kv_queue.h>
 
 #define KEY_LEN  200
 #define DATA_LEN 3000
@@ -306,6 +308,173 @@ static bool test_set_zero_value(void) {
   return true;
 }
 
+static bool test_set_get_many(void) {
+  int ret;
+  // All keys packed into one buffer.
+  const char keys[] = "kvmany0kvmany1kvmany2";
+  memcpy(key_buf, keys, sizeof(keys) - 1);
+
+  libtock_kv_item_t items[3];
+  for (uint32_t i = 0; i < 3; i++) {
+    value_buf[i * 8] = (uint8_t) (0x10 + i);
+    items[i] = (libtock_kv_item_t) {
+      .key = key_buf + i * 7, .key_len = 7, .value = value_buf + i * 8, .value_len = i + 1,
+    };
+  }
+  ret = libtocksync_kv_set_many(items, 3);
+  CHECK(ret == RETURNCODE_SUCCESS);
+
+  for (uint32_t i = 0; i < 3; i++) {
+    items[i].value     = data_buf + i * 8;
+    items[i].value_len = 8;
+  }
+  ret = libtocksync_kv_get_many(items, 3);
+  CHECK(ret == RETURNCODE_SUCCESS);
+  for (uint32_t i = 0; i < 3; i++) {
+    CHECK(items[i].ret == RETURNCODE_SUCCESS);
+    CHECK(items[i].length == (int) (i + 1));
+    CHECK(data_buf[i * 8] == (uint8_t) (0x10 + i));
+  }
+
+  return true;
+}
+
+static bool test_get_many_not_found(void) {
+  int ret;
+  const char keys[] = "kvmany0kvmanyX";
+  memcpy(key_buf, keys, sizeof(keys) - 1);
+
+  ret = libtocksync_kv_set(key_buf, 7, value_buf, 4);
+  CHECK(ret == RETURNCODE_SUCCESS);
+
+  // A missing key fails its own item but not the rest of the batch.
+  libtock_kv_item_t items[2] = {
+    { .key = key_buf + 7, .key_len = 7, .value = data_buf, .value_len = 8 },
+    { .key = key_buf, .key_len = 7, .value = data_buf + 8, .value_len = 8 },
+  };
+  ret = libtocksync_kv_get_many(items, 2);
+  CHECK(ret == RETURNCODE_ENOSUPPORT);
+  CHECK(items[0].ret == RETURNCODE_ENOSUPPORT);
+  CHECK(items[1].ret == RETURNCODE_SUCCESS);
+  CHECK(items[1].length == 4);
+
+  return true;
+}
+
+static bool test_cache(void) {
+  int ret;
+  char key[] = "kvcache";
+  strcpy((char*) key_buf, key);
+  libtock_kv_cache_entry_t entries[2];
+  libtock_kv_cache_init(entries, 2);
+
+  uint32_t value_len = 4;
+  for (uint32_t i = 0; i < value_len; i++) {
+    value_buf[i] = (uint8_t) (i + 1);
+  }
+  ret = libtocksync_kv_set(key_buf, strlen(key), value_buf, value_len);
+  CHECK(ret == RETURNCODE_SUCCESS);
+
+  // Served from the value written through.
+  ret = libtocksync_kv_get(key_buf, strlen(key), data_buf, DATA_LEN, &value_len);
+  CHECK(ret == RETURNCODE_SUCCESS);
+  CHECK(value_len == 4);
+  CHECK(data_buf[3] == 4);
+  CHECK(libtock_kv_cache_hits() == 1);
+
+  ret = libtocksync_kv_get(key_buf, strlen(key), data_buf, 2, &value_len);
+  CHECK(ret == RETURNCODE_ESIZE);
+  CHECK(value_len == 4);
+
+  ret = libtocksync_kv_delete(key_buf, strlen(key));
+  CHECK(ret == RETURNCODE_SUCCESS);
+  ret = libtocksync_kv_get(key_buf, strlen(key), data_buf, DATA_LEN, &value_len);
+  libtock_kv_cache_init(NULL, 0);
+  CHECK(ret == RETURNCODE_ENOSUPPORT);
+
+  return true;
+}
+
+static bool test_queue(void) {
+  int ret;
+  char key[] = "kvqueue";
+  strcpy((char*) key_buf, key);
+  libtock_kv_queue_entry_t entries[2];
+  ret = libtock_kv_queue_init(entries, 2, 1000);
+  CHECK(ret == RETURNCODE_SUCCESS);
+
+  // Ten sets of one key coalesce into one queued write.
+  for (uint8_t i = 0; i < 10; i++) {
+    ret = libtock_kv_queue_set(key_buf, strlen(key), &i, 1);
+    CHECK(ret == RETURNCODE_SUCCESS);
+  }
+  CHECK(libtock_kv_queue_pending() == 1);
+  CHECK(libtock_kv_queue_coalesced() == 9);
+
+  // Reads see the queued value before it is written.
+  uint32_t value_len;
+  ret = libtocksync_kv_get(key_buf, strlen(key), data_buf, DATA_LEN, &value_len);
+  CHECK(ret == RETURNCODE_SUCCESS);
+  CHECK(value_len == 1);
+  CHECK(data_buf[0] == 9);
+
+  ret = libtocksync_kv_queue_flush();
+  CHECK(ret == RETURNCODE_SUCCESS);
+  CHECK(libtock_kv_queue_idle());
+
+  data_buf[0] = 0;
+  ret         = libtocksync_kv_get(key_buf, strlen(key), data_buf, DATA_LEN, &value_len);
+  CHECK(ret == RETURNCODE_SUCCESS);
+  CHECK(value_len == 1);
+  CHECK(data_buf[0] == 9);
+
+  libtock_kv_queue_init(NULL, 0, 0);
+  ret = libtocksync_kv_delete(key_buf, strlen(key));
+  CHECK(ret == RETURNCODE_SUCCESS);
+  return true;
+}
+
+static bool test_iter_prefix(void) {
+  int ret;
+  static uint8_t dir[256];
+  static uint8_t iter_dir[256];
+  libtock_kv_iter_t iter;
+  size_t count;
+
+  ret = libtocksync_kv_dir_track(dir, sizeof(dir));
+  CHECK(ret == RETURNCODE_SUCCESS);
+
+  value_buf[0] = 1;
+  ret = libtocksync_kv_set((const uint8_t*) "iter.a", 6, value_buf, 1);
+  CHECK(ret == RETURNCODE_SUCCESS);
+  ret = libtocksync_kv_set((const uint8_t*) "iter.b", 6, value_buf, 1);
+  CHECK(ret == RETURNCODE_SUCCESS);
+  ret = libtocksync_kv_set((const uint8_t*) "other", 5, value_buf, 1);
+  CHECK(ret == RETURNCODE_SUCCESS);
+
+  ret = libtocksync_kv_iter_begin(&iter, (const uint8_t*) "iter.", 5, iter_dir, sizeof(iter_dir));
+  CHECK(ret == RETURNCODE_SUCCESS);
+  ret = libtocksync_kv_iter_next(&iter, data_buf, DATA_LEN, &count);
+  CHECK(ret == RETURNCODE_SUCCESS);
+  CHECK(count == 2);
+  CHECK(iter.items[0].ret == RETURNCODE_SUCCESS && iter.items[0].length == 1);
+  ret = libtocksync_kv_iter_next(&iter, data_buf, DATA_LEN, &count);
+  CHECK(ret == RETURNCODE_EALREADY);
+
+  // Deleted keys are no longer listed.
+  ret = libtocksync_kv_delete((const uint8_t*) "iter.a", 6);
+  CHECK(ret == RETURNCODE_SUCCESS);
+  ret = libtocksync_kv_iter_begin(&iter, (const uint8_t*) "iter.", 5, iter_dir, sizeof(iter_dir));
+  CHECK(ret == RETURNCODE_SUCCESS);
+  ret = libtocksync_kv_iter_next(&iter, data_buf, DATA_LEN, &count);
+  CHECK(ret == RETURNCODE_SUCCESS);
+  CHECK(count == 1);
+  CHECK(iter.items[0].key_len == 6 && iter.items[0].key[5] == 'b');
+
+  libtocksync_kv_dir_track(NULL, 0);
+  return true;
+}
+
 static bool subtest_set_get_region(uint32_t start, uint32_t stop) {
   const char* keys[] = {
     "kvtestappak",
@@ -411,6 +580,11 @@ int main(void) {
     TEST(delete_delete),
     TEST(add_update_set),
     TEST(set_zero_value),
+    TEST(set_get_many),
+    TEST(get_many_not_found),
+    TEST(cache),
+    TEST(queue),
+    TEST(iter_prefix),
     TEST(set_get_32regions_1),
     TEST(set_get_32regions_2),
     TEST(set_get_32regions_3),
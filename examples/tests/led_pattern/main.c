@@ -0,0 +1,59 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock/interface/led.h>
+#include <libtock/services/led_pattern.h>
+
+static bool passed = true;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("led_pattern: FAILED %s\n", what);
+    passed = false;
+  }
+}
+
+static const uint16_t once_steps[] = {100, 100, 100};
+static const libtock_led_pattern_t once = {once_steps, 3, false};
+
+int main(void) {
+  int num_leds;
+  if (libtock_led_count(&num_leds) != RETURNCODE_SUCCESS || num_leds == 0) {
+    printf("led_pattern: no LEDs\n");
+    return -1;
+  }
+
+  static const libtock_led_pattern_t empty = {NULL, 0, true};
+  check(libtock_led_pattern_start(LIBTOCK_LED_PATTERN_MAX, &once) == RETURNCODE_EINVAL, "LED out of range");
+  check(libtock_led_pattern_start(0, &empty) == RETURNCODE_EINVAL, "empty pattern");
+  check(libtock_led_pattern_blink_code(0, 0) == RETURNCODE_EINVAL, "blink code 0");
+
+  check(libtock_led_pattern_start(0, &once) == RETURNCODE_SUCCESS, "start");
+  check(libtock_led_pattern_running(0), "running after start");
+  libtocksync_alarm_delay_ms(500);
+  check(!libtock_led_pattern_running(0), "pattern without repeat stops");
+
+  check(libtock_led_pattern_start(0, &libtock_led_pattern_blink_fast) == RETURNCODE_SUCCESS, "restart");
+  check(libtock_led_pattern_stop(0) == RETURNCODE_SUCCESS && !libtock_led_pattern_running(0), "stop");
+
+  if (passed) printf("led_pattern: success\n");
+
+  const libtock_led_pattern_t* patterns[] = {
+    &libtock_led_pattern_heartbeat,
+    NULL,
+    &libtock_led_pattern_blink_slow,
+    &libtock_led_pattern_blink_fast,
+  };
+  for (int i = 0; i < num_leds && i < LIBTOCK_LED_PATTERN_MAX; i++) {
+    const libtock_led_pattern_t* pattern = patterns[i % 4];
+    if (pattern == NULL) {
+      libtock_led_pattern_blink_code(i, 3);
+    } else {
+      libtock_led_pattern_start(i, pattern);
+    }
+  }
+
+  while (1) {
+    yield();
+  }
+}
@@ -0,0 +1,27 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock-sync/services/stdout_buffer.h>
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+#include <libtock/services/log.h>
+
+static uint8_t stdout_buf[512];
+
+int main(void) {
+  libtocksync_stdout_buffer_enable(stdout_buf, sizeof(stdout_buf));
+  printf("Deferred logging test\n");
+
+  for (int i = 0; i < 5; i++) {
+    uint32_t now;
+    libtock_alarm_command_read(&now);
+    LIBTOCK_LOG("iteration %d of %d, ticks=%lu\n", i, 5, now);
+    LIBTOCK_LOG("negative %d, hex 0x%08x, string %s\n", -i, 0xC0FFEE00 + i, "from flash");
+    libtocksync_alarm_delay_ms(100);
+  }
+  LIBTOCK_LOG("no arguments\n");
+
+  fflush(stdout);
+  libtocksync_stdout_buffer_flush();
+  printf("log frames dropped: %lu\n", (unsigned long) libtock_log_dropped());
+  return 0;
+}
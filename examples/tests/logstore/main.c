@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock-sync/storage/logstore.h>
+
+#define PAGE_SIZE 256
+#define PAGE_COUNT 8
+#define KEYS 32
+#define SAMPLES 300
+// Readings in the compressed batch, more than fit in a page uncompressed.
+#define BATCH 128
+#define BATCH_KEY 1000
+
+typedef struct {
+  uint32_t sequence;
+  int32_t value;
+} sample_t;
+
+static uint8_t buffer[PAGE_SIZE];
+static uint8_t scan[PAGE_SIZE];
+static libtock_logstore_entry_t index_entries[KEYS];
+static libtock_logstore_t store;
+
+static int32_t batch[BATCH];
+
+static int32_t value_for(uint32_t sequence) {
+  return (int32_t) (sequence * 7919u) - 1000;
+}
+
+// Slowly changing readings, as from a sensor.
+static int32_t reading_for(uint32_t sequence) {
+  return 2000 + (int32_t) (sequence / 8);
+}
+
+static int mount(void) {
+  returncode_t ret = libtock_logstore_init(&store, 0, PAGE_SIZE, PAGE_COUNT, buffer, scan, index_entries, KEYS);
+  if (ret == RETURNCODE_SUCCESS) ret = libtocksync_logstore_mount(&store);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[FAIL] mount: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+  printf("Mounted with %u records\n", libtock_logstore_count(&store));
+  return 0;
+}
+
+int main(void) {
+  printf("[TEST] Log Store\n");
+  if (mount() != 0) return -1;
+
+  for (uint32_t i = 0; i < SAMPLES; i++) {
+    sample_t sample = { i, value_for(i) };
+    returncode_t ret = libtocksync_logstore_append(&store, i % KEYS, &sample, sizeof(sample));
+    if (ret != RETURNCODE_SUCCESS) {
+      printf("[FAIL] append %lu: %s\n", (unsigned long) i, tock_strrcode(ret));
+      return -1;
+    }
+  }
+  for (uint32_t key = 0; key < KEYS; key += 8) {
+    libtocksync_logstore_remove(&store, key);
+  }
+  returncode_t ret = libtocksync_logstore_flush(&store);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[FAIL] flush: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  if (mount() != 0) return -1;
+  for (uint32_t key = 0; key < KEYS; key++) {
+    sample_t sample;
+    uint16_t len;
+    ret = libtocksync_logstore_read(&store, key, &sample, sizeof(sample), &len);
+    if (key % 8 == 0) {
+      if (ret != RETURNCODE_ENOSUPPORT) {
+        printf("[FAIL] key %lu was not removed\n", (unsigned long) key);
+        return -1;
+      }
+      continue;
+    }
+
+    // The newest sample written for this key.
+    uint32_t expected = SAMPLES - 1 - ((SAMPLES - 1 - key) % KEYS);
+    if (ret != RETURNCODE_SUCCESS || len != sizeof(sample) || sample.sequence != expected ||
+        sample.value != value_for(expected)) {
+      printf("[FAIL] key %lu: %s\n", (unsigned long) key, tock_strrcode(ret));
+      return -1;
+    }
+  }
+
+  for (uint32_t i = 0; i < BATCH; i++) {
+    batch[i] = reading_for(i);
+  }
+  ret = libtocksync_logstore_append_compressed(&store, BATCH_KEY, batch, sizeof(batch));
+  if (ret == RETURNCODE_SUCCESS) ret = libtocksync_logstore_flush(&store);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[FAIL] compressed append: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  if (mount() != 0) return -1;
+  memset(batch, 0, sizeof(batch));
+  uint16_t len;
+  ret = libtocksync_logstore_read(&store, BATCH_KEY, batch, sizeof(batch), &len);
+  if (ret != RETURNCODE_SUCCESS || len != sizeof(batch)) {
+    printf("[FAIL] compressed read: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+  for (uint32_t i = 0; i < BATCH; i++) {
+    if (batch[i] != reading_for(i)) {
+      printf("[FAIL] compressed reading %lu\n", (unsigned long) i);
+      return -1;
+    }
+  }
+
+  printf("[SUCCESS] All samples recovered\n");
+  return 0;
+}
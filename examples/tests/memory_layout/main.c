@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libtock/tock.h>
+
+const bool tock_stack_paint = true;
+
+// Shows up in `.bss` and `.data`.
+static uint8_t bss_buffer[2048];
+static uint8_t data_buffer[256] = {1};
+
+static bool failed;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("memory_layout: FAILED %s\n", what);
+    failed = true;
+  }
+}
+
+int main(void) {
+  printf("[TEST] Memory layout\n");
+  bss_buffer[0] = data_buffer[0];
+
+  void* block = malloc(1024);
+  tock_memory_report();
+
+  tock_memory_layout_t m;
+  tock_memory_layout(&m);
+  check(m.memory_start <= m.stack_bottom && m.stack_bottom < m.stack_top, "stack outside RAM");
+  check(m.stack_top <= m.bss_end, "stack above .bss");
+  check(m.bss_end <= m.heap_start && m.heap_start <= m.brk, "heap below .bss");
+  check(m.brk <= m.grant_start && m.grant_start <= m.memory_end, "heap above grants");
+  check(m.bss_size >= sizeof(bss_buffer) && m.data_size >= sizeof(data_buffer), "section sizes");
+  check((uint8_t*) m.brk - (uint8_t*) m.heap_start >= 1024, "heap holds the allocation");
+  check(m.free <= (uint32_t) ((uint8_t*) m.grant_start - (uint8_t*) m.heap_start), "free exceeds the heap gap");
+
+  free(block);
+  if (!failed) printf("memory_layout: success\n");
+  return 0;
+}
@@ -0,0 +1,43 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock/services/ninedof_stream.h>
+#include <libtock/tock.h>
+
+#define RATE_HZ 100
+#define QUEUE_LEN 128
+
+static libtock_ninedof_sample_t samples[QUEUE_LEN];
+static libtock_ninedof_stream_t stream;
+
+int main(void) {
+  printf("[Test] 9-DoF Stream\n");
+
+  returncode_t ret = libtock_ninedof_stream_start(&stream, RATE_HZ, samples, QUEUE_LEN, NULL, NULL);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Could not start the stream: %s\n", tock_strrcode(ret));
+    return ret;
+  }
+
+  // Drain the queue once a second, as a filter updating in batches would.
+  while (1) {
+    libtocksync_alarm_delay_ms(1000);
+
+    int count = 0;
+    int64_t sum[3] = { 0 };
+    libtock_ninedof_sample_t sample;
+    while (libtock_ninedof_stream_pop(&stream, &sample)) {
+      if ((sample.valid & LIBTOCK_NINEDOF_ACCELEROMETER) == 0) continue;
+      for (int i = 0; i < 3; i++) sum[i] += sample.accelerometer[i];
+      count++;
+    }
+
+    if (count == 0) {
+      printf("no samples\n");
+      continue;
+    }
+    printf("%d samples, mean accel %d %d %d, %lu dropped, %lu skipped\n", count,
+           (int) (sum[0] / count), (int) (sum[1] / count), (int) (sum[2] / count),
+           libtock_ninedof_stream_dropped(&stream), libtock_ninedof_stream_skipped(&stream));
+  }
+}
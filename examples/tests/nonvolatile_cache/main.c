@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock-sync/storage/nonvolatile_cache.h>
+#include <libtock-sync/storage/nonvolatile_storage.h>
+
+#define PAGE_SIZE 256
+#define PAGE_COUNT 2
+#define RECORDS 200
+
+typedef struct {
+  uint32_t sequence;
+  uint32_t value;
+} record_t;
+
+static uint8_t page_data[PAGE_SIZE * PAGE_COUNT];
+static libtock_nonvolatile_cache_page_t pages[PAGE_COUNT];
+static libtock_nonvolatile_cache_t cache;
+
+static uint32_t value_for(uint32_t i) {
+  return i * 2654435761u;
+}
+
+int main(void) {
+  printf("[TEST] Nonvolatile Storage Cache\n");
+
+  returncode_t ret = libtock_nonvolatile_cache_init(&cache, page_data, pages, PAGE_SIZE, PAGE_COUNT);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[FAIL] init: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+  if (cache.storage_size < RECORDS * sizeof(record_t)) {
+    printf("[FAIL] Need %u bytes of storage\n", (unsigned) (RECORDS * sizeof(record_t)));
+    return -1;
+  }
+
+  for (uint32_t i = 0; i < RECORDS; i++) {
+    record_t record = { i, value_for(i) };
+    ret = libtocksync_nonvolatile_cache_write(&cache, i * sizeof(record), (const uint8_t*) &record, sizeof(record));
+    if (ret != RETURNCODE_SUCCESS) {
+      printf("[FAIL] write %lu: %s\n", (unsigned long) i, tock_strrcode(ret));
+      return -1;
+    }
+  }
+  ret = libtocksync_nonvolatile_cache_flush(&cache);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[FAIL] flush: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+  printf("%d records took %lu kernel writes and %lu reads\n", RECORDS,
+         (unsigned long) cache.storage_writes, (unsigned long) cache.storage_reads);
+
+  for (uint32_t i = 0; i < RECORDS; i++) {
+    record_t cached, stored;
+    int length_read;
+    ret = libtocksync_nonvolatile_cache_read(&cache, i * sizeof(cached), (uint8_t*) &cached, sizeof(cached));
+    if (ret == RETURNCODE_SUCCESS) {
+      ret = libtocksync_nonvolatile_storage_read(i * sizeof(stored), sizeof(stored), (uint8_t*) &stored,
+                                                 sizeof(stored), &length_read);
+    }
+    if (ret != RETURNCODE_SUCCESS) {
+      printf("[FAIL] read %lu: %s\n", (unsigned long) i, tock_strrcode(ret));
+      return -1;
+    }
+    if (cached.sequence != i || cached.value != value_for(i) || memcmp(&cached, &stored, sizeof(stored)) != 0) {
+      printf("[FAIL] record %lu does not match\n", (unsigned long) i);
+      return -1;
+    }
+  }
+
+  printf("[SUCCESS] All records read back\n");
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include <stdio.h>
+
+#include <libtock-sync/sensors/humidity.h>
+#include <libtock-sync/sensors/pressure.h>
+#include <libtock-sync/sensors/temperature.h>
+#include <libtock-sync/services/op_group.h>
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+
+static libtocksync_op_group_t group;
+static int temperature;
+static int humidity;
+static int pressure;
+
+static void temperature_done(returncode_t ret, int value) {
+  temperature = value;
+  libtocksync_op_group_complete(&group, ret);
+}
+
+static void humidity_done(returncode_t ret, int value) {
+  humidity = value;
+  libtocksync_op_group_complete(&group, ret);
+}
+
+static void pressure_done(returncode_t ret, int value) {
+  pressure = value;
+  libtocksync_op_group_complete(&group, ret);
+}
+
+static uint32_t now(void) {
+  uint32_t ticks;
+  libtock_alarm_command_read(&ticks);
+  return ticks;
+}
+
+int main(void) {
+  bool have_temperature = libtock_temperature_exists();
+  bool have_humidity    = libtock_humidity_exists();
+  bool have_pressure    = libtock_pressure_exists();
+  if (!have_temperature && !have_humidity && !have_pressure) {
+    printf("[FAIL] No temperature, humidity or pressure sensor.\n");
+    return -1;
+  }
+
+  uint32_t start = now();
+  if (have_temperature) libtocksync_temperature_read(&temperature);
+  if (have_humidity) libtocksync_humidity_read(&humidity);
+  if (have_pressure) libtocksync_pressure_read(&pressure);
+  uint32_t sequential = now() - start;
+  printf("Sequential: %d, %d, %d in %lu ticks\n", temperature, humidity, pressure, (unsigned long) sequential);
+
+  start = now();
+  libtocksync_op_group_init(&group);
+  if (have_temperature) libtocksync_op_group_add(&group, libtock_temperature_read(temperature_done));
+  if (have_humidity) libtocksync_op_group_add(&group, libtock_humidity_read(humidity_done));
+  if (have_pressure) libtocksync_op_group_add(&group, libtock_pressure_read(pressure_done));
+  returncode_t ret = libtocksync_op_group_wait(&group);
+  uint32_t grouped = now() - start;
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[FAIL] Grouped read: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+  printf("Grouped:    %d, %d, %d in %lu ticks\n", temperature, humidity, pressure, (unsigned long) grouped);
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock/services/pool.h>
+
+#define BLOCK_SIZE 127
+#define BLOCKS 16
+#define ITERATIONS 1000
+#define ARENA_SIZE 1024
+
+static libtock_pool_t pool;
+static libtock_arena_t arena;
+
+static bool check(bool ok, const char* what) {
+  if (!ok) printf("pool: FAILED %s\n", what);
+  return ok;
+}
+
+static bool test_pool(void) {
+  if (!check(libtock_pool_init(&pool, BLOCK_SIZE, BLOCKS) == RETURNCODE_SUCCESS, "pool init")) return false;
+
+  uint8_t* blocks[BLOCKS] = { NULL };
+  uint32_t seed = 1;
+  for (int i = 0; i < ITERATIONS; i++) {
+    seed = seed * 1103515245 + 12345;
+    int slot = (seed >> 16) % BLOCKS;
+
+    if (blocks[slot] != NULL) {
+      // Every byte must still hold this slot's pattern.
+      for (int j = 0; j < BLOCK_SIZE; j++) {
+        if (!check(blocks[slot][j] == slot, "block overlap")) return false;
+      }
+      libtock_pool_free(&pool, blocks[slot]);
+      blocks[slot] = NULL;
+      continue;
+    }
+
+    blocks[slot] = libtock_pool_alloc(&pool);
+    if (!check(blocks[slot] != NULL, "pool alloc")) return false;
+    if (!check(((uintptr_t) blocks[slot]) % LIBTOCK_POOL_ALIGN == 0, "block alignment")) return false;
+    if (!check(libtock_pool_owns(&pool, blocks[slot]), "block ownership")) return false;
+    memset(blocks[slot], slot, BLOCK_SIZE);
+  }
+
+  // Taking every remaining block must work, and one more must fail.
+  for (int slot = 0; slot < BLOCKS; slot++) {
+    if (blocks[slot] == NULL) blocks[slot] = libtock_pool_alloc(&pool);
+  }
+  if (!check(libtock_pool_in_use(&pool) == BLOCKS, "pool exhaustion")) return false;
+  if (!check(libtock_pool_alloc(&pool) == NULL, "pool overflow")) return false;
+
+  printf("pool: in use %lu, peak %lu, failures %lu\n", libtock_pool_in_use(&pool), libtock_pool_peak(&pool),
+         libtock_pool_failures(&pool));
+  return true;
+}
+
+static bool test_arena(void) {
+  if (!check(libtock_arena_init(&arena, ARENA_SIZE) == RETURNCODE_SUCCESS, "arena init")) return false;
+
+  for (int i = 0; i < ITERATIONS / 10; i++) {
+    uint8_t* first = NULL;
+    uint32_t len   = 1;
+    while (true) {
+      uint8_t* p = libtock_arena_alloc(&arena, len);
+      if (p == NULL) break;
+      if (!check(((uintptr_t) p) % LIBTOCK_POOL_ALIGN == 0, "arena alignment")) return false;
+      if (first == NULL) first = p;
+      memset(p, 0xa5, len);
+      len = len * 3 % 97 + 1;
+    }
+    if (!check(first == arena.memory, "arena reset")) return false;
+    libtock_arena_reset(&arena);
+  }
+
+  printf("arena: peak %lu of %d bytes, failures %lu\n", libtock_arena_peak(&arena), ARENA_SIZE,
+         libtock_arena_failures(&arena));
+  return true;
+}
+
+int main(void) {
+  if (test_pool() && test_arena()) printf("pool: success\n");
+  return 0;
+}
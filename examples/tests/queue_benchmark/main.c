@@ -0,0 +1,70 @@
+#include <stdio.h>
+
+#include <libtock/services/alarm.h>
+
+// Largest queue size measured. The alarms are statically allocated, so this
+// needs roughly 28 kB of RAM.
+#define MAX_ALARMS 1000
+
+static libtock_alarm_ticks_t alarms[MAX_ALARMS];
+
+// Far enough out that none of the alarms fire during a measurement.
+#define BASE_DT 0x40000000
+
+static void never_cb(__attribute__ ((unused)) uint32_t now,
+                     __attribute__ ((unused)) uint32_t scheduled,
+                     __attribute__ ((unused)) void*    opaque) {}
+
+static uint32_t lcg_state = 1;
+
+static uint32_t lcg_next(void) {
+  lcg_state = lcg_state * 1664525 + 1013904223;
+  return lcg_state;
+}
+
+static uint32_t now_ticks(void) {
+  uint32_t now;
+  libtock_alarm_command_read(&now);
+  return now;
+}
+
+static void report(const char* op, int n, uint32_t ticks, uint32_t frequency) {
+  // Average cost per operation in nanoseconds.
+  uint64_t ns = ((uint64_t) ticks * 1000000000ull) / frequency / n;
+  printf("  %-6s n=%-4d total %6lu ticks, %6lu ns/op\n", op, n, (unsigned long) ticks, (unsigned long) ns);
+}
+
+static void bench(int n, uint32_t frequency) {
+  uint32_t reference = now_ticks();
+
+  // Insert in random expiration order.
+  uint32_t start = now_ticks();
+  for (int i = 0; i < n; i++) {
+    uint32_t dt = BASE_DT + (lcg_next() % 0x10000000);
+    libtock_alarm_at(reference, dt, never_cb, NULL, &alarms[i]);
+  }
+  uint32_t insert_ticks = now_ticks() - start;
+
+  // Cancel in an order unrelated to expiration, leaving the earliest alarms
+  // for last.
+  start = now_ticks();
+  for (int i = 0; i < n; i++) {
+    libtock_alarm_cancel(&alarms[(i * 7919) % n]);
+  }
+  uint32_t cancel_ticks = now_ticks() - start;
+
+  report("insert", n, insert_ticks, frequency);
+  report("cancel", n, cancel_ticks, frequency);
+}
+
+int main(void) {
+  static const int sizes[] = { 10, 100, MAX_ALARMS };
+  uint32_t frequency;
+  libtock_alarm_command_get_frequency(&frequency);
+
+  printf("Alarm queue benchmark (%lu Hz clock)\n", (unsigned long) frequency);
+  for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    bench(sizes[i], frequency);
+  }
+  return 0;
+}
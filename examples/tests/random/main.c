@@ -0,0 +1,59 @@
+#include <stdio.h>
+
+#include <libtock-sync/peripherals/rng.h>
+#include <libtock-sync/services/random.h>
+#include <libtock/services/time.h>
+
+#define DRAWS 1000
+
+int main(void) {
+  printf("[TEST] Random\n");
+
+  if (libtock_random_u32() != 0 || libtock_random_bytes(NULL, 0) != RETURNCODE_EOFF) {
+    printf("[FAIL] Output before seeding\n");
+    return -1;
+  }
+  // A tenth as many 4-byte draws straight from the driver, before the
+  // service takes it over.
+  uint64_t start = libtock_time_now_us64();
+  for (int i = 0; i < DRAWS / 10; i++) {
+    uint32_t value;
+    int count;
+    libtocksync_rng_get_random_bytes((uint8_t*) &value, sizeof(value), sizeof(value), &count);
+  }
+  uint64_t driver_us = (libtock_time_now_us64() - start) * 10;
+
+  returncode_t ret = libtocksync_random_init();
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("[FAIL] Seeding: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  // Each bit should be set in about half of the draws.
+  uint32_t ones[32] = { 0 };
+  start = libtock_time_now_us64();
+  for (int i = 0; i < DRAWS; i++) {
+    uint32_t value = libtock_random_u32();
+    for (int bit = 0; bit < 32; bit++) {
+      ones[bit] += (value >> bit) & 1;
+    }
+  }
+  uint64_t drbg_us = libtock_time_now_us64() - start;
+  for (int bit = 0; bit < 32; bit++) {
+    if (ones[bit] < DRAWS * 4 / 10 || ones[bit] > DRAWS * 6 / 10) {
+      printf("[FAIL] Bit %d set in %lu of %d draws\n", bit, (unsigned long) ones[bit], DRAWS);
+      return -1;
+    }
+  }
+  for (int i = 0; i < DRAWS; i++) {
+    if (libtock_random_below(10) >= 10) {
+      printf("[FAIL] Out of range\n");
+      return -1;
+    }
+  }
+
+  printf("%d values: %lu us from the DRBG, about %lu us from the driver\n", DRAWS, (unsigned long) drbg_us,
+         (unsigned long) driver_us);
+  printf("[SUCCESS] Random numbers look uniform\n");
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include <stdio.h>
+
+#include <libtock-sync/peripherals/rng.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock/services/alarm.h>
+#include <libtock/tock_record.h>
+
+#define ROUNDS 8
+
+static uint8_t recording[4096];
+
+static libtock_alarm_t alarm;
+static bool fired        = false;
+static uint32_t fired_at = 0;
+
+static void alarm_cb(uint32_t                                now,
+                     __attribute__ ((unused)) uint32_t scheduled,
+                     __attribute__ ((unused)) void*    opaque) {
+  fired_at = now;
+  fired    = true;
+}
+
+// FNV-1a over everything the kernel handed the app, so a replay can be
+// checked against the recorded run.
+static uint32_t digest = 2166136261u;
+
+static void fold(const void* data, size_t len) {
+  const uint8_t* bytes = data;
+  for (size_t i = 0; i < len; i++) {
+    digest ^= bytes[i];
+    digest *= 16777619u;
+  }
+}
+
+int main(void) {
+  returncode_t ret = tock_record_start(recording, sizeof(recording));
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("record: cannot start: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  for (int round = 0; round < ROUNDS; round++) {
+    // An upcall delivered by yield().
+    fired = false;
+    libtock_alarm_in_ms(5, alarm_cb, NULL, &alarm);
+    yield_for(&fired);
+    fold(&fired_at, sizeof(fired_at));
+
+    // A read-write buffer filled by the kernel, waited for with
+    // yield_wait_for().
+    uint8_t random[16];
+    int received = 0;
+    libtocksync_rng_get_random_bytes(random, sizeof(random), sizeof(random), &received);
+    fold(random, (size_t) received);
+
+    libtocksync_alarm_delay_ms(1);
+  }
+  tock_record_stop();
+
+  size_t len;
+  tock_record_data(&len);
+  printf("record: digest %08lx, %lu bytes recorded%s\n", digest, (uint32_t) len,
+         tock_record_truncated() ? ", truncated" : "");
+  tock_record_dump();
+  return 0;
+}
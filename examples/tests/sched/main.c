@@ -0,0 +1,51 @@
+#include <stdio.h>
+
+#include <libtock/services/sched.h>
+
+static libtock_sched_task_t control;
+static libtock_sched_task_t report;
+static libtock_sched_task_t idle;
+
+static uint32_t control_state = 0;
+static uint32_t idle_slices   = 0;
+static uint32_t reports       = 0;
+
+static void print_stats(const char* name, const libtock_sched_task_t* task) {
+  printf("sched: %s runs %lu missed %lu overruns %lu worst %lu us\n", name,
+         (unsigned long) task->stats.runs, (unsigned long) task->stats.missed,
+         (unsigned long) task->stats.overruns, (unsigned long) task->stats.worst_us);
+}
+
+static void control_step(__attribute__ ((unused)) libtock_sched_task_t* task) {
+  // Stand-in for reading a sensor and updating an actuator.
+  for (int i = 0; i < 100; i++) control_state = control_state * 1103515245u + 12345u;
+}
+
+static void report_step(__attribute__ ((unused)) libtock_sched_task_t* task) {
+  if (++reports % 10 != 0) return;
+  print_stats("control", &control);
+  print_stats("report", &report);
+  printf("sched: idle slices %lu\n", (unsigned long) idle_slices);
+}
+
+static void idle_step(libtock_sched_task_t* task) {
+  idle_slices++;
+  libtock_sched_background(task);
+}
+
+int main(void) {
+  libtock_sched_task_init(&control, control_step, NULL);
+  libtock_sched_task_init(&report, report_step, NULL);
+  libtock_sched_task_init(&idle, idle_step, NULL);
+
+  // The control loop must finish within 2 ms of each release.
+  returncode_t ret = libtock_sched_periodic(&control, 10000, 2000, 500);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_sched_periodic(&report, 100000, 0, 5000);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("sched: FAILED to start: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+  libtock_sched_background(&idle);
+
+  while (1) yield();
+}
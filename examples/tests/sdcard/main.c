@@ -9,6 +9,7 @@
 
 uint8_t read_buf[512]  = {0};
 uint8_t write_buf[512] = {0};
+uint8_t multi_buf[4 * 512];
 
 int main(void) {
   int err = 0;
@@ -76,6 +77,29 @@ int main(void) {
     libtocksync_alarm_delay_ms(1000);
   }
 
+  // write and read back four consecutive blocks
+  for (int j = 0; j < 4 * 512; j++) {
+    multi_buf[j] = j / 512 + j;
+  }
+  err = libtocksync_sdcard_write_blocks(1, 4, multi_buf, sizeof(multi_buf));
+  if (err < 0) {
+    printf("Multi-block write error: %d\n", err);
+    return -1;
+  }
+  memset(multi_buf, 0, sizeof(multi_buf));
+  err = libtocksync_sdcard_read_blocks(1, 4, multi_buf, sizeof(multi_buf));
+  if (err < 0) {
+    printf("Multi-block read error: %d\n", err);
+    return -1;
+  }
+  for (int j = 0; j < 4 * 512; j++) {
+    if (multi_buf[j] != (uint8_t) (j / 512 + j)) {
+      printf("ERROR: multi-block buffers do not match!\n");
+      return -1;
+    }
+  }
+  printf("Multi-block buffers match!\n\n");
+
   // test complete
   printf("SD card test complete!\n\n");
 
@@ -0,0 +1,44 @@
+#include <stdio.h>
+
+#include <libtock/sensors/ambient_light.h>
+#include <libtock/sensors/humidity.h>
+#include <libtock/sensors/ninedof.h>
+#include <libtock/sensors/temperature.h>
+#include <libtock/services/sensor_sampler.h>
+#include <libtock/tock.h>
+
+static bool has(const libtock_sensor_sample_t* sample, libtock_sensor_t sensor) {
+  return sample->valid & (1u << sensor);
+}
+
+static void sample_cb(const libtock_sensor_sample_t* sample) {
+  printf("%lu ms:", (uint32_t) (sample->us / 1000));
+  if (has(sample, LIBTOCK_SENSOR_TEMPERATURE)) printf(" temp %d", sample->temperature);
+  if (has(sample, LIBTOCK_SENSOR_HUMIDITY)) printf(" humidity %d", sample->humidity);
+  if (has(sample, LIBTOCK_SENSOR_AMBIENT_LIGHT)) printf(" light %d", sample->ambient_light);
+  if (has(sample, LIBTOCK_SENSOR_ACCELEROMETER)) {
+    printf(" accel %d %d %d", sample->accelerometer[0], sample->accelerometer[1], sample->accelerometer[2]);
+  }
+  if (sample->failed) printf(" failed 0x%lx", sample->failed);
+  printf(" (%lu skipped)\n", libtock_sensor_sampler_skipped());
+}
+
+int main(void) {
+  printf("[Test] Sensor Sampler\n");
+
+  // The accelerometer every tick, the rest less often.
+  if (libtock_ninedof_exists()) libtock_sensor_sampler_enable(LIBTOCK_SENSOR_ACCELEROMETER, 250);
+  if (libtock_ambient_light_exists()) libtock_sensor_sampler_enable(LIBTOCK_SENSOR_AMBIENT_LIGHT, 500);
+  if (libtock_temperature_exists()) libtock_sensor_sampler_enable(LIBTOCK_SENSOR_TEMPERATURE, 1000);
+  if (libtock_humidity_exists()) libtock_sensor_sampler_enable(LIBTOCK_SENSOR_HUMIDITY, 2000);
+
+  returncode_t ret = libtock_sensor_sampler_start(250, 20, sample_cb);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Could not start the sampler: %s\n", tock_strrcode(ret));
+    return ret;
+  }
+
+  while (1) {
+    yield();
+  }
+}
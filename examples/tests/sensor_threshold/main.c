@@ -0,0 +1,52 @@
+#include <stdio.h>
+
+#include <libtock-sync/sensors/ambient_light.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock/services/sensor_threshold.h>
+
+static const char* names[] = {"inside", "below", "above"};
+
+static void light_changed(returncode_t ret, libtock_sensor_threshold_state_t state, int lux) {
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("ambient light: read failed (%d)\n", ret);
+    return;
+  }
+  printf("ambient light: %s at %d lux\n", names[state], lux);
+}
+
+static void proximity_changed(returncode_t ret, libtock_sensor_threshold_state_t state, int value) {
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("proximity: watch stopped (%d)\n", ret);
+    return;
+  }
+  printf("proximity: %s at %d\n", names[state], value);
+}
+
+int main(void) {
+  printf("[Sensor Threshold] Test\n");
+
+  int lux;
+  if (libtocksync_ambient_light_read_intensity(&lux) == RETURNCODE_SUCCESS) {
+    libtock_sensor_threshold_t light = {
+      .low           = lux / 2,
+      .high          = lux * 2 + 10,
+      .hysteresis    = lux / 8 + 2,
+      .min_period_ms = 100,
+      .max_period_ms = 5000,
+    };
+    printf("ambient light: watching %d to %d lux\n", light.low, light.high);
+    libtock_sensor_threshold_watch(LIBTOCK_SENSOR_AMBIENT_LIGHT, &light, light_changed);
+  } else {
+    printf("ERROR: No ambient light sensor on this board.\n");
+  }
+
+  libtock_sensor_threshold_t near = {.low = 0, .high = 150, .hysteresis = 30};
+  if (libtock_sensor_threshold_watch_proximity(&near, proximity_changed) != RETURNCODE_SUCCESS) {
+    printf("ERROR: No proximity sensor on this board.\n");
+  }
+
+  while (1) {
+    libtocksync_alarm_delay_ms(10000);
+    printf("ambient light: %lu reads\n", (unsigned long) libtock_sensor_threshold_reads(LIBTOCK_SENSOR_AMBIENT_LIGHT));
+  }
+}
@@ -8,6 +8,10 @@
 
 uint8_t data_buf[DATA_LEN] = "A language empowering everyone to build reliable and efficient software.";
 uint8_t dest_buf[DEST_LEN];
+uint8_t stream_buf[DEST_LEN];
+
+// Size of each piece fed to the incremental hash.
+#define CHUNK 16
 
 int main(void) {
   returncode_t ret;
@@ -26,5 +30,22 @@ int main(void) {
     return -1;
   }
 
+  // The same hash, computed piece by piece.
+  uint32_t len = strlen((char*) data_buf);
+  ret = libtocksync_sha_init(LIBTOCK_SHA256);
+  for (uint32_t offset = 0; ret == RETURNCODE_SUCCESS && offset < len; offset += CHUNK) {
+    uint32_t n = len - offset < CHUNK ? len - offset : CHUNK;
+    ret = libtocksync_sha_update(data_buf + offset, n);
+  }
+  if (ret == RETURNCODE_SUCCESS) ret = libtocksync_sha_finish(stream_buf, DEST_LEN);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Unable to compute incremental SHA: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+  if (memcmp(dest_buf, stream_buf, DEST_LEN) != 0) {
+    printf("Incremental SHA differs.\n");
+    return -1;
+  }
+
   return 0;
 }
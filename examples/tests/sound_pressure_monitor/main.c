@@ -0,0 +1,31 @@
+#include <stdio.h>
+
+#include <libtock/sensors/sound_pressure.h>
+#include <libtock/services/sound_pressure_monitor.h>
+
+#define RATE_HZ 50
+
+static libtock_sound_pressure_monitor_t monitor;
+
+static void window_cb(const libtock_sound_pressure_window_t* window, __attribute__ ((unused)) void* opaque) {
+  printf("min %u max %u avg %u dB, %lu samples, %lu skipped\n", window->min, window->max, window->avg,
+         window->samples, window->skipped);
+}
+
+int main(void) {
+  printf("[Test] Sound Pressure Monitor\n");
+  if (!libtock_sound_pressure_exists()) {
+    printf("No sound pressure sensor\n");
+    return -1;
+  }
+
+  returncode_t ret = libtock_sound_pressure_monitor_start(&monitor, RATE_HZ, RATE_HZ, window_cb, NULL);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Could not start: %s\n", tock_strrcode(ret));
+    return -1;
+  }
+
+  while (1) {
+    yield();
+  }
+}
@@ -0,0 +1,35 @@
+#include <stdio.h>
+
+#include <libtock/tock.h>
+
+const bool tock_stack_paint = true;
+
+// Use roughly `depth` * 64 bytes of stack.
+static int __attribute__ ((noinline)) recurse(int depth) {
+  volatile uint8_t frame[48];
+  frame[0] = (uint8_t) depth;
+  if (depth == 0) return frame[0];
+  return recurse(depth - 1) + frame[0];
+}
+
+int main(void) {
+  uint32_t used, size, last = 0;
+  bool ok = true;
+
+  if (tock_stack_high_water(&used, &size) != RETURNCODE_SUCCESS) {
+    printf("stack_high_water: stack not painted\n");
+    return -1;
+  }
+  printf("[TEST] Stack high-water mark, %lu byte stack\n", size);
+
+  for (int depth = 0; depth <= 8; depth += 4) {
+    recurse(depth);
+    tock_stack_high_water(&used, &size);
+    printf("  depth %d: %lu bytes used\n", depth, used);
+    if (used < last || used >= size) ok = false;
+    last = used;
+  }
+
+  printf("stack_high_water: %s\n", ok ? "success" : "FAILED");
+  return 0;
+}
@@ -0,0 +1,26 @@
+#include <stdio.h>
+
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+#include <libtock/tock.h>
+
+// Give startup something to copy and zero.
+static uint8_t zeroed[4096];
+static uint8_t loaded[1024] = { 1 };
+
+int main(void) {
+  uint32_t at_start, at_main, frequency;
+  tock_startup_ticks(&at_start, &at_main);
+
+  if (libtock_alarm_command_get_frequency(&frequency) != RETURNCODE_SUCCESS || frequency == 0) {
+    printf("startup_time: no alarm\n");
+    return -1;
+  }
+
+  uint32_t ticks = at_main - at_start;
+  uint32_t us    = (uint32_t) ((uint64_t) ticks * 1000000 / frequency);
+  printf("[TEST] Startup time\n");
+  printf("  %lu ticks, %lu us for %u bytes of .bss and %u bytes of .data\n", ticks, us,
+         (unsigned) sizeof(zeroed), (unsigned) sizeof(loaded));
+  printf("startup_time: %s\n", zeroed[sizeof(zeroed) - 1] == 0 && loaded[0] == 1 ? "success" : "FAILED");
+  return 0;
+}
@@ -0,0 +1,45 @@
+#include <stdio.h>
+
+#include <libtock-sync/display/text_screen.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock-sync/services/text_screen_batch.h>
+#include <libtock/services/time.h>
+
+// Shows the uptime on a 16x2 character display, rewriting only the digits
+// that changed each second.
+
+#define COLS 16
+#define ROWS 2
+
+int main(void) {
+  uint8_t ops[64];
+  char shown[COLS * ROWS];
+  libtock_text_screen_batch_t batch;
+  libtock_text_screen_diff_t diff;
+
+  libtock_text_screen_batch_init(&batch, ops, sizeof(ops));
+  libtock_text_screen_diff_init(&diff, shown, COLS, ROWS);
+
+  libtock_text_screen_batch_control(&batch, LIBTOCK_TEXT_SCREEN_OP_DISPLAY_ON);
+  libtock_text_screen_batch_control(&batch, LIBTOCK_TEXT_SCREEN_OP_CLEAR);
+
+  while (1) {
+    uint32_t seconds = (uint32_t) (libtock_time_now_us64() / 1000000);
+    char frame[COLS * ROWS + 1];
+    snprintf(frame, sizeof(frame), "%-16s%-16s", "Uptime", "");
+    snprintf(frame + COLS, COLS + 1, "%02lu:%02lu:%02lu", seconds / 3600, (seconds / 60) % 60, seconds % 60);
+    frame[COLS + 8] = ' ';
+
+    libtock_text_screen_batch_diff(&batch, &diff, frame);
+    size_t bytes = batch.used;
+    returncode_t ret = libtocksync_text_screen_batch_run(&batch);
+    if (ret != RETURNCODE_SUCCESS) {
+      printf("Update failed: %s\n", tock_strrcode(ret));
+      return -1;
+    }
+    printf("%lu s: %u bytes of operations\n", seconds, (unsigned) bytes);
+    libtock_text_screen_batch_reset(&batch);
+
+    libtocksync_alarm_delay_ms(1000);
+  }
+}
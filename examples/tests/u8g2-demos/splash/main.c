@@ -0,0 +1,52 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+
+#include <u8g2-tock.h>
+#include <u8g2.h>
+
+#include "logo_tiles.h"
+
+u8g2_t u8g2;
+
+int main(void) {
+  // One page of 8 pixel rows is all the RAM the screen needs.
+  if (u8g2_tock_init_pages(&u8g2, 1) != 0) {
+    printf("No screen\n");
+    return -1;
+  }
+
+  int width       = u8g2_GetDisplayWidth(&u8g2);
+  int height      = u8g2_GetDisplayHeight(&u8g2);
+  uint8_t tiles_w = width / 8;
+  uint8_t logo_x  = tiles_w > LOGO_TILE_WIDTH ? (tiles_w - LOGO_TILE_WIDTH) / 2 : 0;
+
+  // Clear the screen.
+  u8g2_FirstPage(&u8g2);
+  do {} while (u8g2_NextPage(&u8g2));
+
+  if (u8g2_tock_send_tiles(&u8g2, logo_x, 0, LOGO_TILE_WIDTH, LOGO_TILE_HEIGHT, logo_tiles) != 0) {
+    printf("Logo does not fit the screen\n");
+    return -1;
+  }
+
+  u8g2_SetFont(&u8g2, u8g2_font_profont12_tr);
+  u8g2_SetFontPosBaseline(&u8g2);
+
+  // Redraw only the rows below the logo, so the loop leaves the logo alone.
+  uint8_t text_row = LOGO_TILE_HEIGHT;
+  int count        = 0;
+  while (1) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", count++);
+
+    for (uint8_t row = text_row; row < height / 8; row++) {
+      u8g2_SetBufferCurrTileRow(&u8g2, row);
+      u8g2_ClearBuffer(&u8g2);
+      u8g2_DrawStr(&u8g2, (width - u8g2_GetStrWidth(&u8g2, buf)) / 2, height - 2, buf);
+      u8g2_SendBuffer(&u8g2);
+    }
+
+    libtocksync_alarm_delay_ms(1000);
+  }
+}
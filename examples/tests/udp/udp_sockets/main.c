@@ -0,0 +1,60 @@
+#include <stdio.h>
+
+#include <libtock-sync/net/ieee802154.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock/net/ieee802154.h>
+#include <libtock/net/udp.h>
+#include <libtock/services/udp_sockets.h>
+
+#define LOCAL_PORT 16123
+#define TELEMETRY_PORT 16124
+#define SLOTS 4
+
+static uint8_t telemetry_storage[LIBTOCK_UDP_SOCKET_STORAGE_LEN(SLOTS, LIBTOCK_UDP_SOCKETS_MAX_LEN)];
+static uint8_t other_storage[LIBTOCK_UDP_SOCKET_STORAGE_LEN(SLOTS, LIBTOCK_UDP_SOCKETS_MAX_LEN)];
+static libtock_udp_socket_t telemetry;
+static libtock_udp_socket_t other;
+
+static void drain(const char* name, libtock_udp_socket_t* socket) {
+  size_t len;
+  sock_addr_t src;
+  const uint8_t* data;
+  while ((data = libtock_udp_socket_peek(socket, &len, &src)) != NULL) {
+    printf("[%s] %u bytes from port %u: %.*s\n", name, (unsigned) len, src.port, (int) len, data);
+    libtock_udp_socket_release(socket);
+  }
+}
+
+int main(void) {
+  ipv6_addr_t ifaces[10];
+  libtock_udp_list_ifaces(ifaces, 10);
+
+  if (libtock_ieee802154_driver_exists()) {
+    libtock_ieee802154_set_address_short(49138); // Corresponds to the dst mac addr set in kernel
+    libtock_ieee802154_set_pan(0xABCD);
+    libtock_ieee802154_config_commit();
+    libtocksync_ieee802154_up();
+  }
+
+  sock_addr_t telemetry_src = { .port = TELEMETRY_PORT };
+  libtock_udp_socket_open(&telemetry, &telemetry_src, telemetry_storage, sizeof(telemetry_storage), SLOTS,
+                          NULL, NULL);
+  libtock_udp_socket_open(&other, NULL, other_storage, sizeof(other_storage), SLOTS, NULL, NULL);
+
+  sock_addr_t local = { ifaces[1], LOCAL_PORT };
+  returncode_t ret  = libtock_udp_sockets_start(&local);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("Error binding port %d: %d\n", LOCAL_PORT, ret);
+    return -1;
+  }
+  printf("Listening on port %d\n", LOCAL_PORT);
+
+  while (1) {
+    libtocksync_alarm_delay_ms(1000);
+
+    drain("telemetry", &telemetry);
+    drain("other", &other);
+    printf("dropped %lu/%lu, unmatched %lu\n", (unsigned long) libtock_udp_socket_dropped(&telemetry),
+           (unsigned long) libtock_udp_socket_dropped(&other), (unsigned long) libtock_udp_sockets_unmatched());
+  }
+}
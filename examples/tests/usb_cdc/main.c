@@ -0,0 +1,37 @@
+#include <stdbool.h>
+
+#include <libtock-sync/services/usb_cdc.h>
+#include <libtock/services/alarm.h>
+
+#define CHUNK 64
+#define IDLE_MS 10
+
+static libtock_alarm_t idle_alarm;
+
+// Echoing from the receive callback keeps the link full in both directions.
+// If the host sends faster than it reads, bytes that do not fit are dropped.
+static void received(const uint8_t* data, uint32_t len) {
+  libtock_usb_cdc_write(data, len);
+}
+
+// Deliver bytes short of a full chunk, as a host typing by hand never
+// completes one.
+static void idle(__attribute__ ((unused)) uint32_t now,
+                 __attribute__ ((unused)) uint32_t scheduled,
+                 __attribute__ ((unused)) void*    opaque) {
+  libtock_usb_cdc_rx_flush();
+  libtock_alarm_in_ms(IDLE_MS, idle, NULL, &idle_alarm);
+}
+
+int main(void) {
+  returncode_t ret = libtock_usb_cdc_start(CHUNK, received, NULL);
+  if (ret != RETURNCODE_SUCCESS) return -1;
+
+  const char banner[] = "[TEST] USB CDC echo\r\n";
+  libtocksync_usb_cdc_write((const uint8_t*) banner, sizeof(banner) - 1);
+
+  libtock_alarm_in_ms(IDLE_MS, idle, NULL, &idle_alarm);
+  while (true) {
+    yield();
+  }
+}
@@ -0,0 +1,54 @@
+#include <stdio.h>
+
+#include <libtock-sync/peripherals/rtc.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock-sync/services/wall_clock.h>
+#include <libtock/kernel/read_only_state.h>
+#include <libtock/services/time.h>
+
+#define READS 100
+
+static uint8_t ros[LIBTOCK_READ_ONLY_STATE_BUFFER_LEN];
+
+static void print_date(const char* what, const libtock_rtc_date_t* d) {
+  printf("%s %04d-%02d-%02d %02d:%02d:%02d\n", what, d->year, d->month, d->day, d->hour, d->minute, d->seconds);
+}
+
+int main(void) {
+  // Timestamps cost no system calls with the read-only state clock.
+  if (libtock_read_only_state_allocate_region(ros, sizeof(ros)) == RETURNCODE_SUCCESS) {
+    libtock_time_use_read_only_state(ros);
+  }
+
+  // No resync, as this app also reads the RTC itself to compare.
+  returncode_t ret = libtocksync_wall_clock_start(0);
+  if (ret != RETURNCODE_SUCCESS) {
+    printf("wall_clock: no RTC (%d)\n", ret);
+    return -1;
+  }
+
+  libtock_rtc_date_t date;
+  uint64_t start = libtock_time_now_us64();
+  for (int i = 0; i < READS; i++) {
+    libtocksync_rtc_get_date(&date);
+  }
+  uint64_t rtc_us = libtock_time_now_us64() - start;
+
+  uint64_t us;
+  start = libtock_time_now_us64();
+  for (int i = 0; i < READS; i++) {
+    libtock_wall_clock_now_us(&us);
+  }
+  uint64_t wall_us = libtock_time_now_us64() - start;
+
+  printf("wall_clock: %d RTC reads took %lu us, %d wall-clock reads took %lu us\n", READS, (uint32_t) rtc_us, READS,
+         (uint32_t) wall_us);
+
+  while (1) {
+    libtock_wall_clock_now(&date);
+    print_date("wall clock:", &date);
+    libtocksync_rtc_get_date(&date);
+    print_date("rtc:       ", &date);
+    libtocksync_alarm_delay_ms(5000);
+  }
+}
@@ -0,0 +1,47 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock/tock.h>
+
+#define STATE_VERSION 1
+#define RESTARTS 3
+
+// What a cold start works out, standing in for probing drivers and loading
+// configuration.
+struct derived {
+  uint32_t drivers;
+  uint32_t checksum;
+};
+
+TOCK_NOINIT static tock_warm_state_t warm;
+TOCK_NOINIT static struct derived derived;
+
+static void cold_init(void) {
+  libtocksync_alarm_delay_ms(300);
+  derived.drivers  = 0;
+  derived.checksum = 0;
+  for (uint32_t driver = 0; driver < 0x100; driver++) {
+    if (!driver_exists(driver)) continue;
+    derived.drivers++;
+    derived.checksum = derived.checksum * 31 + driver;
+  }
+}
+
+int main(void) {
+  if (tock_warm_state_check(&warm, &derived, sizeof(derived), STATE_VERSION)) {
+    printf("[Warm restart %lu] %lu drivers, skipped init\n", warm.restarts, derived.drivers);
+  } else {
+    printf("[Cold start] probing drivers\n");
+    cold_init();
+    printf("  %lu drivers\n", derived.drivers);
+  }
+
+  if (warm.restarts >= RESTARTS) {
+    tock_warm_state_clear(&warm);
+    printf("warm_restart: success\n");
+    return 0;
+  }
+
+  tock_warm_state_seal(&warm, &derived, sizeof(derived), STATE_VERSION);
+  tock_restart(0);
+}
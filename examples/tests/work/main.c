@@ -0,0 +1,91 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock/services/work.h>
+
+#define ITEMS 4
+
+static libtock_work_t items[ITEMS];
+static libtock_work_t urgent;
+static libtock_work_t delayed;
+
+// Order the handlers ran in, by item index. `urgent` is recorded as ITEMS.
+static int order[16];
+static int runs = 0;
+static int resubmits = 0;
+static bool delayed_ran = false;
+
+static bool check(bool ok, const char* what) {
+  if (!ok) printf("work: FAILED %s\n", what);
+  return ok;
+}
+
+static void record(libtock_work_t* work) {
+  if (runs < (int) (sizeof(order) / sizeof(order[0]))) order[runs] = (int) (intptr_t) work->ud;
+  runs++;
+}
+
+static void resubmit(libtock_work_t* work) {
+  record(work);
+  if (resubmits-- > 0) libtock_work_submit(work);
+}
+
+static void delayed_handler(__attribute__ ((unused)) libtock_work_t* work) {
+  delayed_ran = true;
+}
+
+// Yield until no work is queued.
+static void drain(void) {
+  while (yield_check_tasks()) {}
+}
+
+static bool test_queue(void) {
+  for (int i = 0; i < ITEMS; i++) {
+    libtock_work_init(&items[i], i == 0 ? resubmit : record, (void*) (intptr_t) i);
+  }
+  libtock_work_init(&urgent, record, (void*) (intptr_t) ITEMS);
+  libtock_work_set_prio(&urgent, TOCK_TASK_PRIO_HIGH);
+
+  for (int i = ITEMS - 1; i >= 0; i--) {
+    if (!check(libtock_work_submit(&items[i]) == RETURNCODE_SUCCESS, "submit")) return false;
+  }
+  libtock_work_submit(&items[2]);
+  libtock_work_submit(&urgent);
+  if (!check(libtock_work_cancel(&items[1]), "cancel queued")) return false;
+  if (!check(!libtock_work_cancel(&items[1]), "cancel twice")) return false;
+
+  resubmits = 1;
+  drain();
+
+  // Urgent first, then 3, 2, 0 in submission order, then 0 again.
+  static const int expected[] = {ITEMS, 3, 2, 0, 0};
+  if (!check(runs == 5, "run count")) return false;
+  for (int i = 0; i < runs; i++) {
+    if (!check(order[i] == expected[i], "run order")) return false;
+  }
+  return true;
+}
+
+static bool test_delayed(void) {
+  libtock_work_init(&delayed, delayed_handler, NULL);
+
+  libtock_work_submit_delayed(&delayed, 10);
+  if (!check(libtock_work_pending(&delayed), "delayed pending")) return false;
+  libtock_work_cancel(&delayed);
+  libtocksync_alarm_delay_ms(30);
+  if (!check(!delayed_ran, "cancel delayed")) return false;
+
+  libtock_work_submit_delayed(&delayed, 10);
+  libtock_work_reschedule(&delayed, 100);
+  libtocksync_alarm_delay_ms(30);
+  if (!check(!delayed_ran && libtock_work_pending(&delayed), "reschedule")) return false;
+  libtocksync_alarm_delay_ms(100);
+  return check(delayed_ran && !libtock_work_pending(&delayed), "delayed run");
+}
+
+int main(void) {
+  if (test_queue() && test_delayed()) {
+    printf("work: success\n");
+  }
+  return 0;
+}
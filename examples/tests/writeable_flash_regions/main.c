@@ -1,5 +1,6 @@
 #include <stdio.h>
 
+#include <libtock/storage/writeable_flash.h>
 #include <libtock/tock.h>
 
 int main(void) {
@@ -11,6 +12,22 @@ int main(void) {
       void* start = tock_app_writeable_flash_region_begins_at(i);
       void* end   = tock_app_writeable_flash_region_ends_at(i);
       printf("Writeable flash region %i starts at %p and ends at %p\n", i, start, end);
+
+      uint32_t size;
+      const void* mapped;
+      if (libtock_writeable_flash_size(i, &size) != RETURNCODE_SUCCESS ||
+          libtock_writeable_flash_map(i, 0, size, &mapped) != RETURNCODE_SUCCESS ||
+          mapped != start) {
+        printf("Mapping region %i failed\n", i);
+        continue;
+      }
+      if (libtock_writeable_flash_map(i, size, 1, &mapped) != RETURNCODE_ESIZE) {
+        printf("Mapping past the end of region %i did not fail\n", i);
+        continue;
+      }
+      if (size >= sizeof(uint32_t)) {
+        printf("  first word: 0x%08lx\n", (unsigned long) *(const uint32_t*) start);
+      }
     }
   }
 }
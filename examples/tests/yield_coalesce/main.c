@@ -0,0 +1,50 @@
+#include <stdio.h>
+
+#include <libtock/tock.h>
+
+// Far more events than the task queue holds.
+#define EVENTS (4 * TOCK_TASK_QUEUE_DEFAULT_SIZE)
+
+static int runs[2];
+static int latest[2];
+
+static void source_cb(int                               value,
+                      __attribute__ ((unused)) int      arg1,
+                      __attribute__ ((unused)) int      arg2,
+                      void*                             ud) {
+  int source = (int) (intptr_t) ud;
+  runs[source]++;
+  latest[source] = value;
+}
+
+static bool check(bool ok, const char* what) {
+  if (!ok) printf("yield_coalesce: FAILED %s\n", what);
+  return ok;
+}
+
+int main(void) {
+  tock_task_queue_stats_reset();
+
+  int dropped = 0;
+  for (int i = 0; i < EVENTS; i++) {
+    for (int source = 0; source < 2; source++) {
+      int ret = tock_enqueue_coalesce(TOCK_TASK_PRIO_NORMAL, source_cb, i, 0, 0, (void*) (intptr_t) source);
+      if (!check(ret >= 0, "enqueue")) return -1;
+      dropped += ret;
+    }
+  }
+
+  while (yield_check_tasks()) {}
+
+  tock_task_queue_stats_t stats;
+  tock_task_queue_stats(&stats);
+
+  bool ok = check(runs[0] == 1 && runs[1] == 1, "one run per source") &&
+            check(latest[0] == EVENTS - 1 && latest[1] == EVENTS - 1, "latest event") &&
+            check(dropped == 2 * (EVENTS - 1) && stats.coalesced == (uint32_t) dropped, "dropped count") &&
+            check(stats.enqueue_failures == 0, "no failures");
+  if (ok) {
+    printf("yield_coalesce: success\n");
+  }
+  return 0;
+}
@@ -0,0 +1,37 @@
+#include <stdio.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock/services/alarm.h>
+#include <libtock/tock.h>
+
+static bool flags[3];
+
+static void set_flag(__attribute__ ((unused)) uint32_t now,
+                     __attribute__ ((unused)) uint32_t scheduled,
+                     void*                            opaque) {
+  *(bool*) opaque = true;
+}
+
+int main(void) {
+  static const uint32_t delays_ms[3] = { 300, 100, 200 };
+  libtock_alarm_t alarms[3];
+  bool* conds[3];
+
+  for (int i = 0; i < 3; i++) {
+    conds[i] = &flags[i];
+    libtock_alarm_in_ms(delays_ms[i], set_flag, &flags[i], &alarms[i]);
+  }
+
+  for (int remaining = 3; remaining > 0; remaining--) {
+    int fired = yield_for_any(conds, 3);
+    printf("[yield_for_any] flag %d fired\n", fired);
+    // Stop waiting on this one.
+    conds[fired] = NULL;
+  }
+
+  bool never = false;
+  bool* never_conds[1] = { &never };
+  int ret = libtocksync_alarm_yield_for_any_with_timeout(never_conds, 1, 250);
+  printf("[yield_for_any] timeout: %s\n", ret == RETURNCODE_FAIL ? "ok" : "unexpected");
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include <stdio.h>
+
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+#include <libtock/tock.h>
+
+#define ROUNDS 32
+// Leave one slot in the normal queue for the urgent task.
+#define BACKGROUND_TASKS (TOCK_TASK_QUEUE_DEFAULT_SIZE - 2)
+#define BACKGROUND_SPIN 2000
+
+static uint32_t enqueued_at;
+static uint32_t latency;
+static bool urgent_fired;
+
+static void background_task(__attribute__ ((unused)) int   arg0,
+                            __attribute__ ((unused)) int   arg1,
+                            __attribute__ ((unused)) int   arg2,
+                            __attribute__ ((unused)) void* ud) {
+  // Stand in for display or logging work.
+  for (volatile int i = 0; i < BACKGROUND_SPIN; i++) {}
+}
+
+static void urgent_task(__attribute__ ((unused)) int   arg0,
+                        __attribute__ ((unused)) int   arg1,
+                        __attribute__ ((unused)) int   arg2,
+                        __attribute__ ((unused)) void* ud) {
+  uint32_t now;
+  libtock_alarm_command_read(&now);
+  latency      = now - enqueued_at;
+  urgent_fired = true;
+}
+
+static void run(tock_task_prio_t prio, uint32_t* min, uint32_t* max) {
+  *min = UINT32_MAX;
+  *max = 0;
+
+  for (int round = 0; round < ROUNDS; round++) {
+    for (int i = 0; i < BACKGROUND_TASKS; i++) {
+      tock_enqueue(background_task, 0, 0, 0, NULL);
+    }
+
+    urgent_fired = false;
+    libtock_alarm_command_read(&enqueued_at);
+    if (tock_enqueue_prio(prio, urgent_task, 0, 0, 0, NULL) < 0) {
+      printf("ERROR: task queue full\n");
+      return;
+    }
+
+    // Drain the queue completely before the next round.
+    while (yield_check_tasks()) {}
+
+    if (!urgent_fired) {
+      printf("ERROR: urgent task did not run\n");
+      return;
+    }
+    if (latency < *min) *min = latency;
+    if (latency > *max) *max = latency;
+  }
+}
+
+int main(void) {
+  uint32_t normal_min, normal_max, high_min, high_max;
+
+  run(TOCK_TASK_PRIO_NORMAL, &normal_min, &normal_max);
+  run(TOCK_TASK_PRIO_HIGH, &high_min, &high_max);
+
+  printf("Deferred task dispatch latency (ticks, %d background tasks)\n", BACKGROUND_TASKS);
+  printf("  normal: min %lu max %lu\n", normal_min, normal_max);
+  printf("  high:   min %lu max %lu\n", high_min, high_max);
+
+  tock_task_queue_stats_t stats;
+  tock_task_queue_stats(&stats);
+  printf("Task queue: high water mark %lu, failures %lu\n",
+         stats.high_water_mark, stats.enqueue_failures);
+
+  return 0;
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+#define TOCK_YIELD_TRACE
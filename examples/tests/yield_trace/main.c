@@ -0,0 +1,58 @@
+#include <stdio.h>
+
+#include <libtock/kernel/read_only_state.h>
+#include <libtock/services/alarm.h>
+#include <libtock/tock.h>
+#include <libtock/tock_trace.h>
+
+#define SLOW_SPIN 20000
+
+static uint8_t ros[LIBTOCK_READ_ONLY_STATE_BUFFER_LEN];
+static libtock_alarm_t fast_alarm;
+static libtock_alarm_t slow_alarm;
+static libtock_alarm_t report_alarm;
+static bool report = false;
+
+static void task(__attribute__ ((unused)) int   arg0,
+                 __attribute__ ((unused)) int   arg1,
+                 __attribute__ ((unused)) int   arg2,
+                 __attribute__ ((unused)) void* ud) {}
+
+static void fast(__attribute__ ((unused)) uint32_t now,
+                 __attribute__ ((unused)) uint32_t scheduled,
+                 __attribute__ ((unused)) void*    opaque) {
+  tock_enqueue(task, 0, 0, 0, NULL);
+}
+
+static void slow(__attribute__ ((unused)) uint32_t now,
+                 __attribute__ ((unused)) uint32_t scheduled,
+                 __attribute__ ((unused)) void*    opaque) {
+  for (volatile int i = 0; i < SLOW_SPIN; i++) {}
+}
+
+static void report_cb(__attribute__ ((unused)) uint32_t now,
+                      __attribute__ ((unused)) uint32_t scheduled,
+                      __attribute__ ((unused)) void*    opaque) {
+  report = true;
+}
+
+int main(void) {
+  if (libtock_read_only_state_allocate_region(ros, sizeof(ros)) != RETURNCODE_SUCCESS) {
+    printf("yield_trace: no read-only state, nothing to time with\n");
+    return -1;
+  }
+  tock_trace_start(ros);
+
+  libtock_alarm_repeating_every_ms(10, fast, NULL, &fast_alarm);
+  libtock_alarm_repeating_every_ms(250, slow, NULL, &slow_alarm);
+  libtock_alarm_repeating_every_ms(1000, report_cb, NULL, &report_alarm);
+
+  while (1) {
+    yield();
+    if (report) {
+      report = false;
+      tock_trace_yield_dump();
+      tock_trace_reset();
+    }
+  }
+}
@@ -0,0 +1,28 @@
+#include <string.h>
+
+#include <libtock-sync/services/benchmark.h>
+#include <libtock-sync/services/unit_test.h>
+#include <libtock/tock.h>
+
+static uint8_t src[256];
+static uint8_t dst[256];
+
+static void bench_empty(void) {}
+
+static void bench_memcpy_256(void) {
+  memcpy(dst, src, sizeof(dst));
+  BENCH_KEEP(dst);
+}
+
+static void bench_yield_no_wait(void) {
+  yield_no_wait();
+}
+
+int main(void) {
+  libtocksync_benchmark_t benches[3] = { BENCH(empty, 100), BENCH(memcpy_256, 16), BENCH(yield_no_wait, 16) };
+  unit_test_bench_runner("unit_tests", benches, 3, 2000, "org.tockos.unit_test");
+
+  while (1) {
+    yield();
+  }
+}
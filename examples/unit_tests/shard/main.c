@@ -0,0 +1,46 @@
+#include <stdbool.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock-sync/services/unit_test.h>
+
+// Each test waits, as a test of a slow peripheral would, so two copies of
+// the app finish in about half the time one takes.
+static bool wait_and_pass(void) {
+  libtocksync_alarm_delay_ms(200);
+  return true;
+}
+
+static bool test_first(void) {
+  return wait_and_pass();
+}
+
+static bool test_second(void) {
+  return wait_and_pass();
+}
+
+static bool test_third(void) {
+  return wait_and_pass();
+}
+
+static bool test_fourth(void) {
+  return wait_and_pass();
+}
+
+static bool test_fifth(void) {
+  return wait_and_pass();
+}
+
+static bool test_sixth(void) {
+  return wait_and_pass();
+}
+
+int main(void) {
+  unit_test_fun tests[6] = {
+    TEST(first), TEST(second), TEST(third), TEST(fourth), TEST(fifth), TEST(sixth)
+  };
+  unit_test_shard_runner(tests, 6, 300, "org.tockos.unit_test", "shard");
+
+  while (1) {
+    yield();
+  }
+}
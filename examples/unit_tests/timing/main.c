@@ -0,0 +1,30 @@
+#include <stdbool.h>
+
+#include <libtock-sync/services/alarm.h>
+#include <libtock-sync/services/unit_test.h>
+
+static bool test_fast(void) {
+  EXPECT_FASTER_THAN(50);
+  libtocksync_alarm_delay_ms(5);
+  return true;
+}
+
+static bool test_slow(void) {
+  EXPECT_FASTER_THAN(50);
+  libtocksync_alarm_delay_ms(100);
+  return true;
+}
+
+static bool test_no_limit(void) {
+  libtocksync_alarm_delay_ms(100);
+  return true;
+}
+
+int main(void) {
+  unit_test_fun tests[3] = { TEST(fast), TEST(slow), TEST(no_limit) };
+  unit_test_runner(tests, 3, 300, "org.tockos.unit_test");
+
+  while (1) {
+    yield();
+  }
+}
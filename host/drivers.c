@@ -0,0 +1,247 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <libtock/interface/syscalls/console_syscalls.h>
+#include <libtock/interface/syscalls/led_syscalls.h>
+#include <libtock/kernel/idle_hint.h>
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+#include <libtock/peripherals/syscalls/rng_syscalls.h>
+
+#include "emulator.h"
+
+// Simulated alarm, console, LED, RNG and idle hint drivers, with the command, allow and
+// upcall numbers of the kernel's capsules.
+
+#define NS_PER_S 1000000000u
+
+#ifndef TOCK_HOST_LEDS
+#define TOCK_HOST_LEDS 4
+#endif
+
+#ifndef TOCK_HOST_CONSOLE_INPUT
+#define TOCK_HOST_CONSOLE_INPUT 1024
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Alarm
+////////////////////////////////////////////////////////////////////////////////
+
+static void alarm_fired(tock_host_timer_t*);
+
+static struct {
+  tock_host_timer_t timer;
+  uint32_t reference;
+  uint32_t dt;
+} alarm = { .timer = { .fired = alarm_fired } };
+
+static uint64_t ticks_now(void) {
+  uint64_t ns = tock_host_now_ns();
+  return ns / NS_PER_S * TOCK_HOST_ALARM_FREQUENCY + ns % NS_PER_S * TOCK_HOST_ALARM_FREQUENCY / NS_PER_S;
+}
+
+// First nanosecond at which the clock reads `ticks`.
+static uint64_t ticks_to_ns(uint64_t ticks) {
+  uint64_t rem = ticks % TOCK_HOST_ALARM_FREQUENCY;
+  return ticks / TOCK_HOST_ALARM_FREQUENCY * NS_PER_S +
+         (rem * NS_PER_S + TOCK_HOST_ALARM_FREQUENCY - 1) / TOCK_HOST_ALARM_FREQUENCY;
+}
+
+static void alarm_fired(__attribute__ ((unused)) tock_host_timer_t* timer) {
+  tock_host_schedule_upcall(DRIVER_NUM_ALARM, 0, (int) (uint32_t) ticks_now(), (int) (alarm.reference + alarm.dt), 0);
+}
+
+// Fire once the counter has passed `reference + dt`, right away if it
+// already has.
+static void alarm_arm(uint32_t reference, uint32_t dt) {
+  alarm.reference = reference;
+  alarm.dt        = dt;
+  uint64_t now     = ticks_now();
+  uint32_t elapsed = (uint32_t) now - reference;
+  uint64_t at      = elapsed >= dt ? now : now + (dt - elapsed);
+  tock_host_timer_set(&alarm.timer, ticks_to_ns(at));
+}
+
+static syscall_return_t alarm_command(__attribute__ ((unused)) tock_host_driver_t* driver, uint32_t command,
+                                      int arg1, int arg2) {
+  switch (command) {
+    case 0:
+      return tock_host_success();
+    case 1:
+      return tock_host_success_u32(TOCK_HOST_ALARM_FREQUENCY);
+    case 2:
+      return tock_host_success_u32((uint32_t) ticks_now());
+    case 3:
+      tock_host_timer_cancel(&alarm.timer);
+      return tock_host_success();
+    case 5:
+      alarm_arm((uint32_t) ticks_now(), (uint32_t) arg1);
+      return tock_host_success_u32(alarm.reference + alarm.dt);
+    case 6:
+      alarm_arm((uint32_t) arg1, (uint32_t) arg2);
+      return tock_host_success_u32(alarm.reference + alarm.dt);
+    default:
+      return tock_host_failure(TOCK_STATUSCODE_NOSUPPORT);
+  }
+}
+
+static tock_host_driver_t alarm_driver = { .number = DRIVER_NUM_ALARM, .command = alarm_command };
+
+////////////////////////////////////////////////////////////////////////////////
+// Console
+////////////////////////////////////////////////////////////////////////////////
+
+// Writes go to stdout and complete at once. Reads take bytes given to
+// `tock_host_console_input()` and complete once the requested number has
+// arrived, or with what there is when aborted.
+static struct {
+  uint8_t input[TOCK_HOST_CONSOLE_INPUT];
+  size_t input_len;
+  // Length of the outstanding read, 0 if none.
+  size_t reading;
+} console;
+
+static size_t console_take(size_t len) {
+  size_t size;
+  uint8_t* buffer = tock_host_allowed_readwrite(DRIVER_NUM_CONSOLE, 1, &size);
+  if (len > size) len = size;
+  if (len > console.input_len) len = console.input_len;
+  memcpy(buffer, console.input, len);
+  memmove(console.input, console.input + len, console.input_len - len);
+  console.input_len -= len;
+  return len;
+}
+
+static void console_try_read(void) {
+  if (console.reading == 0 || console.input_len < console.reading) return;
+  size_t got = console_take(console.reading);
+  console.reading = 0;
+  tock_host_schedule_upcall(DRIVER_NUM_CONSOLE, 2, TOCK_STATUSCODE_SUCCESS, (int) got, 0);
+}
+
+size_t tock_host_console_input(const void* data, size_t len) {
+  size_t space = sizeof(console.input) - console.input_len;
+  if (len > space) len = space;
+  memcpy(console.input + console.input_len, data, len);
+  console.input_len += len;
+  console_try_read();
+  return len;
+}
+
+static syscall_return_t console_command(__attribute__ ((unused)) tock_host_driver_t* driver, uint32_t command,
+                                        int arg1, __attribute__ ((unused)) int arg2) {
+  switch (command) {
+    case 0:
+      return tock_host_success();
+    case 1: {
+      size_t size;
+      const uint8_t* buffer = tock_host_allowed_readonly(DRIVER_NUM_CONSOLE, 1, &size);
+      size_t len = (size_t) arg1 < size ? (size_t) arg1 : size;
+      fwrite(buffer, 1, len, stdout);
+      tock_host_schedule_upcall(DRIVER_NUM_CONSOLE, 1, TOCK_STATUSCODE_SUCCESS, (int) len, 0);
+      return tock_host_success();
+    }
+    case 2: {
+      size_t size;
+      tock_host_allowed_readwrite(DRIVER_NUM_CONSOLE, 1, &size);
+      if (console.reading != 0) return tock_host_failure(TOCK_STATUSCODE_BUSY);
+      if (arg1 <= 0 || (size_t) arg1 > size) return tock_host_failure(TOCK_STATUSCODE_SIZE);
+      console.reading = (size_t) arg1;
+      console_try_read();
+      return tock_host_success();
+    }
+    case 3:
+      if (console.reading != 0) {
+        size_t got = console_take(console.reading);
+        console.reading = 0;
+        tock_host_schedule_upcall(DRIVER_NUM_CONSOLE, 2, TOCK_STATUSCODE_CANCEL, (int) got, 0);
+      }
+      return tock_host_success();
+    default:
+      return tock_host_failure(TOCK_STATUSCODE_NOSUPPORT);
+  }
+}
+
+static tock_host_driver_t console_driver = { .number = DRIVER_NUM_CONSOLE, .command = console_command };
+
+////////////////////////////////////////////////////////////////////////////////
+// LEDs
+////////////////////////////////////////////////////////////////////////////////
+
+static bool leds[TOCK_HOST_LEDS];
+
+bool tock_host_led(uint32_t index) {
+  return index < TOCK_HOST_LEDS && leds[index];
+}
+
+static syscall_return_t led_command(__attribute__ ((unused)) tock_host_driver_t* driver, uint32_t command,
+                                    int arg1, __attribute__ ((unused)) int arg2) {
+  if (command == 0) return tock_host_success_u32(TOCK_HOST_LEDS);
+  if (command > 3) return tock_host_failure(TOCK_STATUSCODE_NOSUPPORT);
+  if (arg1 < 0 || arg1 >= TOCK_HOST_LEDS) return tock_host_failure(TOCK_STATUSCODE_INVAL);
+  leds[arg1] = command == 1 ? true : command == 2 ? false : !leds[arg1];
+  return tock_host_success();
+}
+
+static tock_host_driver_t led_driver = { .number = DRIVER_NUM_LED, .command = led_command };
+
+////////////////////////////////////////////////////////////////////////////////
+// RNG
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15u;
+
+void tock_host_rng_seed(uint64_t seed) {
+  rng_state = seed != 0 ? seed : 1;
+}
+
+// xorshift64*, repeatable rather than secure.
+static uint8_t rng_byte(void) {
+  rng_state ^= rng_state >> 12;
+  rng_state ^= rng_state << 25;
+  rng_state ^= rng_state >> 27;
+  return (uint8_t) ((rng_state * 2685821657736338717u) >> 56);
+}
+
+static syscall_return_t rng_command(__attribute__ ((unused)) tock_host_driver_t* driver, uint32_t command,
+                                    int arg1, __attribute__ ((unused)) int arg2) {
+  if (command == 0) return tock_host_success();
+  if (command != 1) return tock_host_failure(TOCK_STATUSCODE_NOSUPPORT);
+
+  size_t size;
+  uint8_t* buffer = tock_host_allowed_readwrite(DRIVER_NUM_RNG, 0, &size);
+  size_t len      = (size_t) arg1 < size ? (size_t) arg1 : size;
+  for (size_t i = 0; i < len; i++) buffer[i] = rng_byte();
+  tock_host_schedule_upcall(DRIVER_NUM_RNG, 0, 0, (int) len, 0);
+  return tock_host_success();
+}
+
+static tock_host_driver_t rng_driver = { .number = DRIVER_NUM_RNG, .command = rng_command };
+
+////////////////////////////////////////////////////////////////////////////////
+// Idle hints
+////////////////////////////////////////////////////////////////////////////////
+
+const uint32_t* tock_host_idle_hint(void) {
+  size_t size;
+  const uint32_t* region = tock_host_allowed_userspace_read(DRIVER_NUM_IDLE_HINT, 0, &size);
+  return size >= LIBTOCK_IDLE_HINT_BUFFER_LEN ? region : NULL;
+}
+
+static syscall_return_t idle_hint_command(__attribute__ ((unused)) tock_host_driver_t* driver, uint32_t command,
+                                          __attribute__ ((unused)) int arg1, __attribute__ ((unused)) int arg2) {
+  if (command == 0) return tock_host_success();
+  if (command == 1) return tock_host_success_u32(1);
+  return tock_host_failure(TOCK_STATUSCODE_NOSUPPORT);
+}
+
+static tock_host_driver_t idle_hint_driver = { .number = DRIVER_NUM_IDLE_HINT, .command = idle_hint_command };
+
+// Called by the emulator before anything else registers, so an app's own
+// driver with one of these numbers replaces the built-in one.
+void tock_host_register_builtin_drivers(void) {
+  tock_host_register_driver(&alarm_driver);
+  tock_host_register_driver(&console_driver);
+  tock_host_register_driver(&led_driver);
+  tock_host_register_driver(&rng_driver);
+  tock_host_register_driver(&idle_hint_driver);
+}
@@ -0,0 +1,640 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <libtock/tock_record.h>
+
+#include "emulator.h"
+
+#define SUBSCRIPTIONS 64
+#define ALLOWS        64
+
+typedef struct {
+  uint32_t driver;
+  uint32_t subscribe;
+  subscribe_upcall* cb;
+  void* userdata;
+} subscription_t;
+
+typedef enum {
+  ALLOW_READWRITE,
+  ALLOW_READONLY,
+  ALLOW_USERSPACE_READ,
+} allow_kind_t;
+
+typedef struct {
+  allow_kind_t kind;
+  uint32_t driver;
+  uint32_t allow;
+  void* ptr;
+  size_t size;
+} allow_slot_t;
+
+typedef struct {
+  uint32_t driver;
+  uint32_t subscribe;
+  int args[3];
+} upcall_t;
+
+// The process has one kernel, so its state is global.
+static struct {
+  bool initialized;
+  tock_host_driver_t* drivers;
+
+  subscription_t subscriptions[SUBSCRIPTIONS];
+  int num_subscriptions;
+  allow_slot_t allows[ALLOWS];
+  int num_allows;
+
+  // Scheduled upcalls, oldest first.
+  upcall_t upcalls[TOCK_HOST_UPCALL_QUEUE];
+  uint32_t upcall_head;
+  uint32_t upcall_count;
+
+  // Timers by time, earliest first.
+  tock_host_timer_t* timers;
+  struct timespec start;
+  uint64_t skipped_ns;
+  // Sleep through waits instead of skipping them, for apps that talk to
+  // something outside the process.
+  bool realtime;
+
+  // Recording to replay, see `tock_host_replay_start()`, and the offset and
+  // number of the next event in it.
+  uint8_t* replay;
+  size_t replay_len;
+  size_t replay_pos;
+  uint32_t replay_events;
+  bool replaying;
+} host;
+
+// Replay, at the end of this file.
+static subscribe_return_t replay_subscribe(uint32_t driver, uint32_t subscribe, subscribe_upcall cb,
+                                           void* userdata);
+static syscall_return_t replay_command(uint32_t driver, uint32_t command, int arg1, int arg2);
+static statuscode_t replay_allow(allow_kind_t kind, uint32_t driver, uint32_t allow, void* ptr, size_t size,
+                                 void** old_ptr, size_t* old_size);
+static bool replay_yield(bool wait);
+static yield_waitfor_return_t replay_wait_for(uint32_t driver, uint32_t subscribe);
+
+static void init(void) {
+  if (host.initialized) return;
+  host.initialized = true;
+  clock_gettime(CLOCK_MONOTONIC, &host.start);
+  const char* realtime = getenv("TOCK_HOST_REALTIME");
+  host.realtime = realtime != NULL && strcmp(realtime, "0") != 0;
+  tock_host_register_builtin_drivers();
+}
+
+syscall_return_t tock_host_success(void) {
+  syscall_return_t ret = { TOCK_SYSCALL_SUCCESS, { 0, 0, 0 } };
+  return ret;
+}
+
+syscall_return_t tock_host_success_u32(uint32_t value) {
+  syscall_return_t ret = { TOCK_SYSCALL_SUCCESS_U32, { value, 0, 0 } };
+  return ret;
+}
+
+syscall_return_t tock_host_failure(statuscode_t status) {
+  syscall_return_t ret = { TOCK_SYSCALL_FAILURE, { (uint32_t) status, 0, 0 } };
+  return ret;
+}
+
+static tock_host_driver_t* find_driver(uint32_t number) {
+  for (tock_host_driver_t* d = host.drivers; d != NULL; d = d->next) {
+    if (d->number == number) return d;
+  }
+  return NULL;
+}
+
+void tock_host_register_driver(tock_host_driver_t* driver) {
+  init();
+  tock_host_driver_t** link = &host.drivers;
+  while (*link != NULL && (*link)->number != driver->number) link = &(*link)->next;
+  driver->next = *link != NULL ? (*link)->next : NULL;
+  *link        = driver;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Time
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t tock_host_now_ns(void) {
+  init();
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  uint64_t elapsed = (uint64_t) (now.tv_sec - host.start.tv_sec) * 1000000000u + (uint64_t) now.tv_nsec -
+                     (uint64_t) host.start.tv_nsec;
+  return elapsed + host.skipped_ns;
+}
+
+void tock_host_advance_ns(uint64_t ns) {
+  init();
+  host.skipped_ns += ns;
+}
+
+void tock_host_timer_cancel(tock_host_timer_t* timer) {
+  if (!timer->armed) return;
+  tock_host_timer_t** link = &host.timers;
+  while (*link != timer) link = &(*link)->next;
+  *link        = timer->next;
+  timer->armed = false;
+}
+
+void tock_host_timer_set(tock_host_timer_t* timer, uint64_t at_ns) {
+  tock_host_timer_cancel(timer);
+  timer->at_ns = at_ns;
+  tock_host_timer_t** link = &host.timers;
+  while (*link != NULL && (*link)->at_ns <= at_ns) link = &(*link)->next;
+  timer->next  = *link;
+  *link        = timer;
+  timer->armed = true;
+}
+
+static void run_due_timers(void) {
+  uint64_t now = tock_host_now_ns();
+  while (host.timers != NULL && host.timers->at_ns <= now) {
+    tock_host_timer_t* timer = host.timers;
+    host.timers  = timer->next;
+    timer->armed = false;
+    timer->fired(timer);
+  }
+}
+
+// Wait for the next timer, or end the process if nothing can ever happen.
+static void wait_for_timer(void) {
+  if (host.timers == NULL) {
+    fflush(stdout);
+    fprintf(stderr, "tock_host: waiting with no upcall or timer pending, exiting\n");
+    exit(0);
+  }
+  uint64_t now = tock_host_now_ns();
+  if (host.timers->at_ns > now) {
+    uint64_t wait = host.timers->at_ns - now;
+    if (host.realtime) {
+      struct timespec ts = { (time_t) (wait / 1000000000u), (long) (wait % 1000000000u) };
+      nanosleep(&ts, NULL);
+    } else {
+      host.skipped_ns += wait;
+    }
+  }
+  run_due_timers();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Upcalls
+////////////////////////////////////////////////////////////////////////////////
+
+static subscription_t* find_subscription(uint32_t driver, uint32_t subscribe) {
+  for (int i = 0; i < host.num_subscriptions; i++) {
+    subscription_t* s = &host.subscriptions[i];
+    if (s->driver == driver && s->subscribe == subscribe) return s;
+  }
+  return NULL;
+}
+
+bool tock_host_schedule_upcall(uint32_t driver, uint32_t subscribe, int arg0, int arg1, int arg2) {
+  if (host.upcall_count == TOCK_HOST_UPCALL_QUEUE) return false;
+  upcall_t* u = &host.upcalls[(host.upcall_head + host.upcall_count) % TOCK_HOST_UPCALL_QUEUE];
+  *u = (upcall_t) { driver, subscribe, { arg0, arg1, arg2 } };
+  host.upcall_count++;
+  return true;
+}
+
+// Take the `n`th queued upcall out of the queue.
+static upcall_t take_upcall(uint32_t n) {
+  upcall_t taken = host.upcalls[(host.upcall_head + n) % TOCK_HOST_UPCALL_QUEUE];
+  for (uint32_t i = n; i > 0; i--) {
+    host.upcalls[(host.upcall_head + i) % TOCK_HOST_UPCALL_QUEUE] =
+      host.upcalls[(host.upcall_head + i - 1) % TOCK_HOST_UPCALL_QUEUE];
+  }
+  host.upcall_head = (host.upcall_head + 1) % TOCK_HOST_UPCALL_QUEUE;
+  host.upcall_count--;
+  return taken;
+}
+
+// As in the kernel, a new subscription drops the upcalls queued for the old
+// one.
+static void drop_upcalls(uint32_t driver, uint32_t subscribe) {
+  for (uint32_t i = host.upcall_count; i > 0; i--) {
+    upcall_t* u = &host.upcalls[(host.upcall_head + i - 1) % TOCK_HOST_UPCALL_QUEUE];
+    if (u->driver == driver && u->subscribe == subscribe) {
+      take_upcall(i - 1);
+    }
+  }
+}
+
+// Deliver the oldest upcall that goes to a function. Upcalls to a null
+// subscription are dropped.
+static bool deliver(void) {
+  while (host.upcall_count > 0) {
+    upcall_t u        = take_upcall(0);
+    subscription_t* s = find_subscription(u.driver, u.subscribe);
+    if (s != NULL && s->cb != NULL) {
+      s->cb(u.args[0], u.args[1], u.args[2], s->userdata);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool tock_host_yield(bool wait) {
+  init();
+  if (host.replaying) return replay_yield(wait);
+  run_due_timers();
+  while (true) {
+    if (deliver()) return true;
+    if (!wait) return false;
+    wait_for_timer();
+  }
+}
+
+yield_waitfor_return_t tock_host_yield_wait_for(uint32_t driver, uint32_t subscribe) {
+  init();
+  if (host.replaying) return replay_wait_for(driver, subscribe);
+  run_due_timers();
+  while (true) {
+    for (uint32_t i = 0; i < host.upcall_count; i++) {
+      upcall_t* u = &host.upcalls[(host.upcall_head + i) % TOCK_HOST_UPCALL_QUEUE];
+      if (u->driver == driver && u->subscribe == subscribe) {
+        upcall_t taken            = take_upcall(i);
+        yield_waitfor_return_t rv = { taken.args[0], taken.args[1], taken.args[2] };
+        return rv;
+      }
+    }
+    wait_for_timer();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// System calls
+////////////////////////////////////////////////////////////////////////////////
+
+static subscribe_return_t install_subscription(uint32_t driver, uint32_t subscribe, subscribe_upcall cb,
+                                               void* userdata) {
+  subscription_t* s = find_subscription(driver, subscribe);
+  if (s == NULL) {
+    if (host.num_subscriptions == SUBSCRIPTIONS) {
+      subscribe_return_t ret = { false, cb, userdata, TOCK_STATUSCODE_NOMEM };
+      return ret;
+    }
+    s  = &host.subscriptions[host.num_subscriptions++];
+    *s = (subscription_t) { driver, subscribe, NULL, NULL };
+  }
+  subscribe_return_t ret = { true, s->cb, s->userdata, TOCK_STATUSCODE_SUCCESS };
+  s->cb       = cb;
+  s->userdata = userdata;
+  drop_upcalls(driver, subscribe);
+  return ret;
+}
+
+subscribe_return_t tock_host_subscribe(uint32_t driver, uint32_t subscribe, subscribe_upcall cb, void* userdata) {
+  init();
+  if (host.replaying) return replay_subscribe(driver, subscribe, cb, userdata);
+  if (find_driver(driver) == NULL) {
+    subscribe_return_t ret = { false, cb, userdata, TOCK_STATUSCODE_NODEVICE };
+    return ret;
+  }
+  return install_subscription(driver, subscribe, cb, userdata);
+}
+
+syscall_return_t tock_host_command(uint32_t driver, uint32_t command, int arg1, int arg2) {
+  init();
+  if (host.replaying) return replay_command(driver, command, arg1, arg2);
+  // The kernel handles interrupts that arrived while the app ran before it
+  // services a system call, so timers that came due fire here.
+  run_due_timers();
+  tock_host_driver_t* d = find_driver(driver);
+  if (d == NULL) return tock_host_failure(TOCK_STATUSCODE_NODEVICE);
+  return d->command(d, command, arg1, arg2);
+}
+
+static allow_slot_t* find_allow(allow_kind_t kind, uint32_t driver, uint32_t allow, bool create) {
+  for (int i = 0; i < host.num_allows; i++) {
+    allow_slot_t* a = &host.allows[i];
+    if (a->kind == kind && a->driver == driver && a->allow == allow) return a;
+  }
+  if (!create || host.num_allows == ALLOWS) return NULL;
+  allow_slot_t* a = &host.allows[host.num_allows++];
+  *a = (allow_slot_t) { kind, driver, allow, NULL, 0 };
+  return a;
+}
+
+// Swap the buffer in a slot, returning the old one in `*old_ptr` and
+// `*old_size`.
+static statuscode_t swap_allow(allow_kind_t kind, uint32_t driver, uint32_t allow, void* ptr, size_t size,
+                               void** old_ptr, size_t* old_size) {
+  init();
+  *old_ptr  = ptr;
+  *old_size = size;
+  if (host.replaying) return replay_allow(kind, driver, allow, ptr, size, old_ptr, old_size);
+  tock_host_driver_t* d = find_driver(driver);
+  if (d == NULL) return TOCK_STATUSCODE_NODEVICE;
+  allow_slot_t* a = find_allow(kind, driver, allow, true);
+  if (a == NULL) return TOCK_STATUSCODE_NOMEM;
+
+  *old_ptr  = a->ptr;
+  *old_size = a->size;
+  a->ptr    = ptr;
+  a->size   = size;
+  if (d->allowed != NULL && kind != ALLOW_USERSPACE_READ) d->allowed(d, allow, ptr, size);
+  return TOCK_STATUSCODE_SUCCESS;
+}
+
+allow_ro_return_t tock_host_allow_readonly(uint32_t driver, uint32_t allow, const void* ptr, size_t size) {
+  void* old;
+  size_t old_size;
+  statuscode_t status = swap_allow(ALLOW_READONLY, driver, allow, (void*) ptr, size, &old, &old_size);
+  allow_ro_return_t ret = { status == TOCK_STATUSCODE_SUCCESS, old, old_size, status };
+  return ret;
+}
+
+allow_rw_return_t tock_host_allow_readwrite(uint32_t driver, uint32_t allow, void* ptr, size_t size) {
+  void* old;
+  size_t old_size;
+  statuscode_t status = swap_allow(ALLOW_READWRITE, driver, allow, ptr, size, &old, &old_size);
+  allow_rw_return_t ret = { status == TOCK_STATUSCODE_SUCCESS, old, old_size, status };
+  return ret;
+}
+
+allow_userspace_r_return_t tock_host_allow_userspace_read(uint32_t driver, uint32_t allow, void* ptr, size_t size) {
+  void* old;
+  size_t old_size;
+  statuscode_t status = swap_allow(ALLOW_USERSPACE_READ, driver, allow, ptr, size, &old, &old_size);
+  allow_userspace_r_return_t ret = { status == TOCK_STATUSCODE_SUCCESS, old, old_size, status };
+  return ret;
+}
+
+void* tock_host_allowed_readwrite(uint32_t driver, uint32_t allow, size_t* size) {
+  allow_slot_t* a = find_allow(ALLOW_READWRITE, driver, allow, false);
+  *size = a != NULL ? a->size : 0;
+  return a != NULL ? a->ptr : NULL;
+}
+
+const void* tock_host_allowed_readonly(uint32_t driver, uint32_t allow, size_t* size) {
+  allow_slot_t* a = find_allow(ALLOW_READONLY, driver, allow, false);
+  *size = a != NULL ? a->size : 0;
+  return a != NULL ? a->ptr : NULL;
+}
+
+const void* tock_host_allowed_userspace_read(uint32_t driver, uint32_t allow, size_t* size) {
+  allow_slot_t* a = find_allow(ALLOW_USERSPACE_READ, driver, allow, false);
+  *size = a != NULL ? a->size : 0;
+  return a != NULL ? a->ptr : NULL;
+}
+
+// The host C library manages the heap and there is no process memory map,
+// so every memop is unsupported and the `tock_app_*()` queries return NULL.
+memop_return_t tock_host_memop(__attribute__ ((unused)) uint32_t op_type, __attribute__ ((unused)) int arg1) {
+  memop_return_t ret = { TOCK_STATUSCODE_NOSUPPORT, 0 };
+  return ret;
+}
+
+void tock_host_exit(uint32_t completion_code, bool restart) {
+  fflush(stdout);
+  if (restart) fprintf(stderr, "tock_host: restart requested, exiting\n");
+  exit((int) completion_code);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replay
+////////////////////////////////////////////////////////////////////////////////
+
+static const char* event_name(uint8_t kind) {
+  switch (kind) {
+    case TOCK_RECORD_SUBSCRIBE:  return "subscribe";
+    case TOCK_RECORD_COMMAND:    return "command";
+    case TOCK_RECORD_ALLOW_RW:   return "read-write allow";
+    case TOCK_RECORD_ALLOW_RO:   return "read-only allow";
+    case TOCK_RECORD_ALLOW_UR:   return "userspace-readable allow";
+    case TOCK_RECORD_UPCALL:     return "upcall";
+    case TOCK_RECORD_WAIT_FOR:   return "yield-wait-for";
+    case TOCK_RECORD_YIELD_NONE: return "yield with no upcall";
+    default:                     return "unknown event";
+  }
+}
+
+__attribute__ ((noreturn))
+static void replay_finished(uint32_t events) {
+  fflush(stdout);
+  fprintf(stderr, "tock_host: replay finished after %u events\n", events);
+  exit(0);
+}
+
+__attribute__ ((noreturn, format(printf, 1, 2)))
+static void replay_diverged(const char* fmt, ...) {
+  fflush(stdout);
+  fprintf(stderr, "tock_host: replay diverged at event %u: ", host.replay_events);
+  va_list ap;
+  va_start(ap, fmt);
+  vfprintf(stderr, fmt, ap);
+  va_end(ap);
+  fputc('\n', stderr);
+  exit(1);
+}
+
+// The next `len` bytes of the current event. A recording that stopped
+// within the event ends the replay before it.
+static const uint8_t* replay_take(size_t len) {
+  if (host.replay_len - host.replay_pos < len) replay_finished(host.replay_events - 1);
+  const uint8_t* p = host.replay + host.replay_pos;
+  host.replay_pos += len;
+  return p;
+}
+
+static uint32_t replay_u32(void) {
+  const uint8_t* p = replay_take(4);
+  return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+// Start the next event and return its kind, ending the replay at the end of
+// the recording.
+static uint8_t replay_next(void) {
+  if (host.replay_pos == host.replay_len) replay_finished(host.replay_events);
+  host.replay_events++;
+  return *replay_take(1);
+}
+
+// Start the next event, which must be a `kind` for `number` of `driver`.
+static void replay_expect(uint8_t kind, uint32_t driver, uint32_t number) {
+  uint8_t got = replay_next();
+  if (got != kind) {
+    replay_diverged("the app made a %s to driver 0x%x, number %u, the recording has a %s", event_name(kind),
+                    driver, number, event_name(got));
+  }
+  uint32_t rec_driver = replay_u32();
+  uint32_t rec_number = replay_u32();
+  if (rec_driver != driver || rec_number != number) {
+    replay_diverged("the app made a %s to driver 0x%x, number %u, the recording to driver 0x%x, number %u",
+                    event_name(kind), driver, number, rec_driver, rec_number);
+  }
+}
+
+// Copy the buffer contents of an upcall or wait-for event into the app's
+// buffers.
+static void replay_buffers(uint32_t driver) {
+  uint8_t count = *replay_take(1);
+  for (uint8_t i = 0; i < count; i++) {
+    uint32_t allow      = replay_u32();
+    uint32_t len        = replay_u32();
+    const uint8_t* data = replay_take(len);
+    allow_slot_t* a     = find_allow(ALLOW_READWRITE, driver, allow, false);
+    if (a == NULL || a->ptr == NULL) {
+      replay_diverged("the recording fills read-write buffer %u of driver 0x%x, which the app has not allowed",
+                      allow, driver);
+    }
+    memcpy(a->ptr, data, len < a->size ? len : a->size);
+  }
+}
+
+void tock_host_replay_start(void) {
+  init();
+  const char* path = getenv("TOCK_HOST_REPLAY");
+  if (host.replay != NULL || path == NULL || path[0] == '\0') return;
+
+  FILE* f = fopen(path, "rb");
+  if (f == NULL) {
+    fprintf(stderr, "tock_host: cannot open %s\n", path);
+    exit(1);
+  }
+  fseek(f, 0, SEEK_END);
+  long len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  host.replay     = malloc(len > 0 ? (size_t) len : 1);
+  host.replay_len = len > 0 ? fread(host.replay, 1, (size_t) len, f) : 0;
+  fclose(f);
+
+  host.replay_pos = 0;
+  if (host.replay_len < 8 || memcmp(host.replay, TOCK_RECORD_MAGIC, 4) != 0) {
+    fprintf(stderr, "tock_host: %s is not a libtock recording\n", path);
+    exit(1);
+  }
+  host.replay_pos = 4;
+  uint32_t version = replay_u32();
+  if (version != TOCK_RECORD_VERSION) {
+    fprintf(stderr, "tock_host: %s is a version %u recording, expected %u\n", path, version, TOCK_RECORD_VERSION);
+    exit(1);
+  }
+  host.replaying = true;
+}
+
+static subscribe_return_t replay_subscribe(uint32_t driver, uint32_t subscribe, subscribe_upcall cb,
+                                           void* userdata) {
+  replay_expect(TOCK_RECORD_SUBSCRIBE, driver, subscribe);
+  uint32_t status_code = replay_u32();
+  statuscode_t status  = (statuscode_t) status_code;
+  if (status != TOCK_STATUSCODE_SUCCESS) {
+    subscribe_return_t ret = { false, cb, userdata, status };
+    return ret;
+  }
+  return install_subscription(driver, subscribe, cb, userdata);
+}
+
+static syscall_return_t replay_command(uint32_t driver, uint32_t command, int arg1, int arg2) {
+  replay_expect(TOCK_RECORD_COMMAND, driver, command);
+  int rec_arg1 = (int) replay_u32();
+  int rec_arg2 = (int) replay_u32();
+  if (rec_arg1 != arg1 || rec_arg2 != arg2) {
+    replay_diverged("the app passed %d, %d to command %u of driver 0x%x, the recording %d, %d", arg1, arg2,
+                    command, driver, rec_arg1, rec_arg2);
+  }
+  syscall_return_t ret;
+  uint32_t type = replay_u32();
+  ret.type      = (syscall_rtype_t) type;
+  for (int i = 0; i < 3; i++) ret.data[i] = replay_u32();
+  return ret;
+}
+
+static statuscode_t replay_allow(allow_kind_t kind, uint32_t driver, uint32_t allow, void* ptr, size_t size,
+                                 void** old_ptr, size_t* old_size) {
+  static const uint8_t events[] = {
+    [ALLOW_READWRITE]      = TOCK_RECORD_ALLOW_RW,
+    [ALLOW_READONLY]       = TOCK_RECORD_ALLOW_RO,
+    [ALLOW_USERSPACE_READ] = TOCK_RECORD_ALLOW_UR,
+  };
+  replay_expect(events[kind], driver, allow);
+  uint32_t rec_size = replay_u32();
+  if (rec_size != size) {
+    replay_diverged("the app allowed %u bytes to %s %u of driver 0x%x, the recording %u bytes", (uint32_t) size,
+                    event_name(events[kind]), allow, driver, rec_size);
+  }
+  uint32_t status_code = replay_u32();
+  statuscode_t status  = (statuscode_t) status_code;
+  // What the kernel wrote into the buffer handed back.
+  uint32_t returned   = kind == ALLOW_READWRITE ? replay_u32() : 0;
+  const uint8_t* data = replay_take(returned);
+  if (status != TOCK_STATUSCODE_SUCCESS) return status;
+
+  allow_slot_t* a = find_allow(kind, driver, allow, true);
+  if (a == NULL) replay_diverged("more than %d allow slots", ALLOWS);
+  *old_ptr  = a->ptr;
+  *old_size = a->size;
+  a->ptr    = ptr;
+  a->size   = size;
+  if (*old_ptr != NULL) memcpy(*old_ptr, data, returned < *old_size ? returned : *old_size);
+  return TOCK_STATUSCODE_SUCCESS;
+}
+
+static bool replay_yield(bool wait) {
+  uint8_t kind = replay_next();
+  if (kind == TOCK_RECORD_YIELD_NONE) {
+    if (wait) replay_diverged("the app waits, the recording has a yield with no upcall");
+    return false;
+  }
+  if (kind != TOCK_RECORD_UPCALL) replay_diverged("the app yields, the recording has a %s", event_name(kind));
+
+  uint32_t driver    = replay_u32();
+  uint32_t subscribe = replay_u32();
+  int args[3];
+  for (int i = 0; i < 3; i++) args[i] = (int) replay_u32();
+  replay_buffers(driver);
+
+  subscription_t* s = find_subscription(driver, subscribe);
+  if (s == NULL || s->cb == NULL) {
+    replay_diverged("the recording has an upcall to driver 0x%x, number %u, which the app has not subscribed",
+                    driver, subscribe);
+  }
+  s->cb(args[0], args[1], args[2], s->userdata);
+  return true;
+}
+
+static yield_waitfor_return_t replay_wait_for(uint32_t driver, uint32_t subscribe) {
+  replay_expect(TOCK_RECORD_WAIT_FOR, driver, subscribe);
+  yield_waitfor_return_t ret;
+  ret.data0 = (int) replay_u32();
+  ret.data1 = (int) replay_u32();
+  ret.data2 = (int) replay_u32();
+  replay_buffers(driver);
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Stand-ins for `libtock/crt0.c` and `libtock/sys.c`
+////////////////////////////////////////////////////////////////////////////////
+
+// The host C library starts the process and owns the heap and the stack, so
+// there is no layout or usage to report.
+
+const bool tock_stack_paint = false;
+
+void tock_startup_ticks(uint32_t* at_start, uint32_t* at_main) {
+  *at_start = 0;
+  *at_main  = 0;
+}
+
+returncode_t tock_stack_high_water(uint32_t* used, uint32_t* size) {
+  *used = 0;
+  *size = 0;
+  return RETURNCODE_ENOSUPPORT;
+}
+
+void tock_heap_usage(tock_heap_usage_t* usage) {
+  memset(usage, 0, sizeof(*usage));
+}
+
+void tock_memory_layout(tock_memory_layout_t* layout) {
+  memset(layout, 0, sizeof(*layout));
+}
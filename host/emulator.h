@@ -0,0 +1,151 @@
+#pragma once
+
+// Host emulator of the Tock system call interface.
+//
+// Built with `TOCK_HOST`, libtock's `command()`, `subscribe()`, `allow_*()`,
+// `memop()` and the yields are serviced here instead of trapping into a
+// kernel, so libtock, libtock-sync and the code under test run as an
+// ordinary host process under perf, valgrind or a debugger. See
+// `host/README.md` for building.
+//
+// The emulator keeps the kernel's side of the interface: the subscribed
+// upcalls, the allowed buffers, and a queue of scheduled upcalls that the
+// yields deliver. Drivers are plugged in as `tock_host_driver_t`s; the
+// alarm, console, LED and RNG drivers are built in and registered on the
+// first system call.
+//
+// Simulated time is the host's monotonic clock plus all the time skipped
+// while waiting: when the app yields with no upcall queued, the clock jumps
+// to the next timer instead of sleeping, so code runs at host speed and
+// waits take no time at all.
+//
+// With `TOCK_HOST_REPLAY` set in the environment to a recording made with
+// `libtock/tock_record.h`, the drivers are bypassed from the app's
+// `tock_record_start()` on: every system call is answered and every yield
+// served from the recording, which must match what the app does.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Frequency of the simulated alarm driver.
+#ifndef TOCK_HOST_ALARM_FREQUENCY
+#define TOCK_HOST_ALARM_FREQUENCY 1000000
+#endif
+
+// Upcalls that can be queued at once. Scheduling more fails, like a full
+// kernel task queue.
+#ifndef TOCK_HOST_UPCALL_QUEUE
+#define TOCK_HOST_UPCALL_QUEUE 64
+#endif
+
+struct tock_host_driver;
+
+// A simulated driver.
+//
+// `command` handles every command, including the existence check, command
+// 0. `allowed` may be NULL; it is told when the app swaps a buffer, for
+// drivers that act on it straight away. Commands to drivers that are not
+// registered fail with TOCK_STATUSCODE_NODEVICE.
+typedef struct tock_host_driver {
+  uint32_t number;
+  syscall_return_t (*command)(struct tock_host_driver* driver, uint32_t command, int arg1, int arg2);
+  void (*allowed)(struct tock_host_driver* driver, uint32_t allow, void* ptr, size_t size);
+  void* state;
+  struct tock_host_driver* next;
+} tock_host_driver_t;
+
+// A callback at a simulated time.
+typedef struct tock_host_timer {
+  uint64_t at_ns;
+  void (*fired)(struct tock_host_timer* timer);
+  void* state;
+  bool armed;
+  struct tock_host_timer* next;
+} tock_host_timer_t;
+
+// Command results, for driver `command` functions.
+syscall_return_t tock_host_success(void);
+syscall_return_t tock_host_success_u32(uint32_t value);
+syscall_return_t tock_host_failure(statuscode_t status);
+
+// Add a driver, replacing a built-in one with the same number. Call before
+// the app first uses the driver.
+void tock_host_register_driver(tock_host_driver_t* driver);
+
+// Queue an upcall to the function subscribed to `subscribe` of `driver`, to
+// be delivered by the next yield. Returns false if the queue is full.
+//
+// Upcall arguments are `int`s as on a 32-bit target, so they cannot carry
+// host pointers.
+bool tock_host_schedule_upcall(uint32_t driver, uint32_t subscribe, int arg0, int arg1, int arg2);
+
+// The buffer the app allowed to `allow` of `driver`, with its size in
+// `*size`, or NULL if none. Read-write, read-only and userspace-readable
+// allows are kept apart.
+void* tock_host_allowed_readwrite(uint32_t driver, uint32_t allow, size_t* size);
+const void* tock_host_allowed_readonly(uint32_t driver, uint32_t allow, size_t* size);
+const void* tock_host_allowed_userspace_read(uint32_t driver, uint32_t allow, size_t* size);
+
+// Simulated time in nanoseconds since the process started.
+uint64_t tock_host_now_ns(void);
+
+// Run `timer` once the simulated time reaches `at_ns`, replacing an earlier
+// setting of the same timer.
+void tock_host_timer_set(tock_host_timer_t* timer, uint64_t at_ns);
+void tock_host_timer_cancel(tock_host_timer_t* timer);
+
+// Move the simulated clock forward without waiting.
+void tock_host_advance_ns(uint64_t ns);
+
+// Bytes the console driver hands to `libtock_console_read()` and friends,
+// after any earlier input. Returns the number of bytes accepted.
+size_t tock_host_console_input(const void* data, size_t len);
+
+// Seed the RNG driver, for repeatable runs.
+void tock_host_rng_seed(uint64_t seed);
+
+// Whether LED `index` is on.
+bool tock_host_led(uint32_t index);
+
+// The idle hint region the app shares, as 32-bit words laid out as in
+// `libtock/kernel/idle_hint.h`, or NULL if it shares none. The emulator
+// skips idle time either way; this is for checking what an app publishes.
+const uint32_t* tock_host_idle_hint(void);
+
+// Begin replaying the recording named by `TOCK_HOST_REPLAY`, if there is
+// one. Called by `tock_record_start()`.
+//
+// Once replaying, a system call or yield that does not match the next event
+// of the recording prints where they differ and exits with status 1, and
+// the end of the recording exits with status 0.
+void tock_host_replay_start(void);
+
+// Register the alarm, console, LED, RNG and idle hint drivers of
+// `drivers.c`. Called by the emulator on the first system call.
+void tock_host_register_builtin_drivers(void);
+
+// Used by `libtock/tock.c` and `libtock/tock_inline.h` to service system
+// calls on the host.
+subscribe_return_t tock_host_subscribe(uint32_t driver, uint32_t subscribe, subscribe_upcall cb, void* userdata);
+syscall_return_t tock_host_command(uint32_t driver, uint32_t command, int arg1, int arg2);
+allow_ro_return_t tock_host_allow_readonly(uint32_t driver, uint32_t allow, const void* ptr, size_t size);
+allow_rw_return_t tock_host_allow_readwrite(uint32_t driver, uint32_t allow, void* ptr, size_t size);
+allow_userspace_r_return_t tock_host_allow_userspace_read(uint32_t driver, uint32_t allow, void* ptr, size_t size);
+memop_return_t tock_host_memop(uint32_t op_type, int arg1);
+// Deliver one queued upcall, waiting for one first if `wait`. Returns
+// whether one ran.
+bool tock_host_yield(bool wait);
+yield_waitfor_return_t tock_host_yield_wait_for(uint32_t driver, uint32_t subscribe);
+__attribute__ ((noreturn))
+void tock_host_exit(uint32_t completion_code, bool restart);
+
+#ifdef __cplusplus
+}
+#endif
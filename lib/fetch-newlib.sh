@@ -6,6 +6,12 @@ if [ $NEWLIB_VERSION = "4.3.0.20230120" ]; then
   NEWLIB_SHA="2595f02f7cb2fd2e444f4ddc7955deca4c52deb3f91411c4d28326be8b0d9e0d"
 elif [ $NEWLIB_VERSION = "4.2.0.20211231" ]; then
   NEWLIB_SHA="5916d76f1cc3c0f5487275823c85a9a9954edfa15f5706342ecb254d634ed559"
+elif [[ $NEWLIB_VERSION == *-speed ]]; then
+  # Variants are not mirrored, they are built locally.
+  echo "ERROR: libtock-newlib-$NEWLIB_VERSION is not available for download." >&2
+  echo "Build it with \`make -C newlib NEWLIB_VERSION=${NEWLIB_VERSION%-speed} NEWLIB_VARIANT=speed\`" >&2
+  echo "and unpack the resulting zip in this folder." >&2
+  exit 1
 fi
 
 # Name of the pre-created compiled directories.
@@ -0,0 +1,118 @@
+#include <string.h>
+
+#include "ble_gatts.h"
+#include "ble_notify_queue.h"
+#include "nrf_error.h"
+
+static uint8_t _ring[BLE_NOTIFY_QUEUE_SIZE];
+static uint16_t _head = 0;
+static uint16_t _count = 0;
+
+static uint16_t _value_handle = 0;
+static uint16_t _conn_handle = BLE_CONN_HANDLE_INVALID;
+// Transmit buffers the SoftDevice has free for this connection.
+static uint8_t _tx_credits = 0;
+// Cleared when the central has not enabled notifications yet; set again by
+// its next write.
+static bool _can_notify = false;
+static uint32_t _sent = 0;
+
+static void pump (void) {
+    while (_count > 0 && _tx_credits > 0 && _can_notify &&
+           _conn_handle != BLE_CONN_HANDLE_INVALID) {
+        uint8_t chunk[BLE_NOTIFY_QUEUE_PAYLOAD];
+        uint16_t len = _count < BLE_NOTIFY_QUEUE_PAYLOAD ? _count : BLE_NOTIFY_QUEUE_PAYLOAD;
+        for (uint16_t i = 0; i < len; i++) {
+            chunk[i] = _ring[((uint32_t) _head + i) % BLE_NOTIFY_QUEUE_SIZE];
+        }
+
+        ble_gatts_hvx_params_t hvx_params;
+        memset(&hvx_params, 0, sizeof(hvx_params));
+        hvx_params.handle = _value_handle;
+        hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+        hvx_params.p_data = chunk;
+        hvx_params.p_len  = &len;
+
+        uint32_t err_code = sd_ble_gatts_hvx(_conn_handle, &hvx_params);
+        if (err_code == BLE_ERROR_NO_TX_PACKETS) {
+            // Out of step with the SoftDevice; wait for TX_COMPLETE.
+            _tx_credits = 0;
+            return;
+        } else if (err_code != NRF_SUCCESS) {
+            // Notifications not enabled, or the link is going away.
+            _can_notify = false;
+            return;
+        }
+
+        // `len` now holds the number of bytes sent.
+        _head = ((uint32_t) _head + len) % BLE_NOTIFY_QUEUE_SIZE;
+        _count -= len;
+        _tx_credits--;
+        _sent++;
+    }
+}
+
+void ble_notify_queue_init (uint16_t value_handle) {
+    _value_handle = value_handle;
+    _head = 0;
+    _count = 0;
+    _sent = 0;
+}
+
+uint16_t ble_notify_queue_write (const uint8_t* data, uint16_t len) {
+    uint16_t space = ble_notify_queue_space();
+    if (len > space) len = space;
+
+    for (uint16_t i = 0; i < len; i++) {
+        _ring[((uint32_t) _head + _count + i) % BLE_NOTIFY_QUEUE_SIZE] = data[i];
+    }
+    _count += len;
+
+    pump();
+    return len;
+}
+
+void ble_notify_queue_on_ble_evt (ble_evt_t* p_ble_evt) {
+    switch (p_ble_evt->header.evt_id) {
+        case BLE_GAP_EVT_CONNECTED: {
+            _conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            _can_notify = true;
+            if (sd_ble_tx_packet_count_get(_conn_handle, &_tx_credits) != NRF_SUCCESS) {
+                _tx_credits = 1;
+            }
+            break;
+        }
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            _conn_handle = BLE_CONN_HANDLE_INVALID;
+            _tx_credits = 0;
+            _head = 0;
+            _count = 0;
+            break;
+
+        case BLE_EVT_TX_COMPLETE:
+            _tx_credits += p_ble_evt->evt.common_evt.params.tx_complete.count;
+            break;
+
+        case BLE_GATTS_EVT_WRITE:
+            // Possibly the CCCD write that enables notifications.
+            _can_notify = true;
+            break;
+
+        default:
+            return;
+    }
+    pump();
+}
+
+uint16_t ble_notify_queue_pending (void) {
+    return _count;
+}
+
+uint16_t ble_notify_queue_space (void) {
+    return BLE_NOTIFY_QUEUE_SIZE - _count;
+}
+
+uint32_t ble_notify_queue_sent (void) {
+    return _sent;
+}
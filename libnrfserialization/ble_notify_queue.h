@@ -0,0 +1,47 @@
+#pragma once
+
+// Queued GATT notifications for one characteristic.
+//
+// Every notification is one serialized SoftDevice call, and a connection
+// event only carries what the SoftDevice already holds in its transmit
+// buffers. The queue keeps the bytes written to it in a ring and hands them
+// to the SoftDevice as full notifications, as many as it has free transmit
+// buffers for, topping them up from each BLE_EVT_TX_COMPLETE. The free
+// buffers are counted here, so no call is made that would only fail with
+// BLE_ERROR_NO_TX_PACKETS.
+//
+// The S130 SoftDevice keeps the default ATT MTU and has no data length
+// extension, so a notification carries at most
+// `BLE_NOTIFY_QUEUE_PAYLOAD` bytes.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ble.h"
+#include "ble_gatt.h"
+
+#define BLE_NOTIFY_QUEUE_PAYLOAD (GATT_MTU_SIZE_DEFAULT - 3)
+
+// Size of the byte ring, set when building the app.
+#ifndef BLE_NOTIFY_QUEUE_SIZE
+#define BLE_NOTIFY_QUEUE_SIZE 1024
+#endif
+
+// Notify the characteristic value at `value_handle`. Queued bytes go out
+// once a central has connected and enabled notifications.
+void ble_notify_queue_init(uint16_t value_handle);
+
+// Queue as much of `data` as fits and start sending. Returns the number of
+// bytes queued.
+uint16_t ble_notify_queue_write(const uint8_t* data, uint16_t len);
+
+// Feed every BLE event to the queue. It follows the connection, and sends
+// more when transmit buffers free up or notifications are enabled.
+void ble_notify_queue_on_ble_evt(ble_evt_t* p_ble_evt);
+
+// Bytes waiting to be sent, and room left in the ring.
+uint16_t ble_notify_queue_pending(void);
+uint16_t ble_notify_queue_space(void);
+
+// Notifications sent since init.
+uint32_t ble_notify_queue_sent(void);
@@ -18,22 +18,45 @@
 #include "ble_serialization.h"
 #include "ser_sd_transport.h"
 
-// Circular queue for event packets. Event packets are generated asynchronously
+// Receive ring for event packets. Event packets are generated asynchronously
 // from the nRF (e.g. advertisement discovery or read requests).
-#define RX_BUFFER_SIZE 5
-static uint8_t rx_event_buffers[RX_BUFFER_SIZE][SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE];
+//
+// The kernel writes received bytes straight into free space in the ring, and
+// event packets stay where they landed until the serialization library takes
+// them, so they are copied once instead of twice. Packets take only as much
+// of the ring as they need.
+//
+// Both sizes are set when building the library.
+#ifndef NRF_SERIALIZATION_RX_RING_SIZE
+#define NRF_SERIALIZATION_RX_RING_SIZE (5 * SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE)
+#endif
+#ifndef NRF_SERIALIZATION_RX_EVENTS
+#define NRF_SERIALIZATION_RX_EVENTS 32
+#endif
+static uint8_t rx_ring[NRF_SERIALIZATION_RX_RING_SIZE];
+// Queued event packets, oldest first. The oldest one marks the start of the
+// used part of the ring.
+static struct {
+    uint16_t offset;
+    uint16_t len;
+} rx_events[NRF_SERIALIZATION_RX_EVENTS];
 static uint8_t _head_event = 0;
-static uint8_t _tail_event = 0;
+static uint8_t _event_count = 0;
+// End of the bytes the kernel last wrote into the ring.
+static uint16_t _ring_write_end = 0;
+// Event packets dropped because the ring or event queue was full.
+static uint32_t _dropped_events = 0;
 
 // Single entry queue for receiving response packets after sending commands.
 static uint8_t rx_rsp_buffer[SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE];
 static bool _have_rsp_packet = false;
 
-// Buffer to receive packets from the nrf51 in.
-// The upper layer also has a buffer, which we could use, but to make
-// the timing work out better we just keep a buffer around that the kernel
-// can keep a pointer to.
-static uint8_t rx[SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE];
+// Where the kernel is receiving into: free space in the ring, or, while the
+// ring has no room for a full packet, `rx_overflow`. Only responses are kept
+// from the overflow buffer.
+static uint8_t rx_overflow[SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE];
+static uint8_t* rx = rx_overflow;
+static uint16_t _rx_len = 0;
 // This is a pointer to the RX buffer passed in by the upper serialization
 // layer.
 static uint8_t* hal_rx_buf = NULL;
@@ -70,6 +93,8 @@ void timeout_timer_cb (uint32_t a, uint32_t b, void* opaque);
 void ble_serialization_callback (int callback_type, int rx_len, int c, void* other);
 static void serialization_timer_cb (uint32_t a, uint32_t b, void* opaque);
 uint32_t sd_app_evt_wait (void);
+// Number of event packets dropped because the receive ring was full.
+uint32_t nrf_serialization_dropped_events (void);
 
 
 uint32_t ser_app_hal_hw_init (void);
@@ -85,6 +110,61 @@ void ser_app_power_system_off_enter (void);
 void critical_region_enter (void);
 void critical_region_exit (void);
 
+/*******************************************************************************
+ * Receive ring
+ ******************************************************************************/
+
+// Give the kernel the largest free space in the ring that holds a full
+// packet, or the overflow buffer if there is none.
+static void rx_ring_allow (void) {
+    uint16_t start = 0;
+    uint16_t len = NRF_SERIALIZATION_RX_RING_SIZE;
+
+    if (_event_count == 0) {
+        _ring_write_end = 0;
+    } else {
+        uint16_t head = rx_events[_head_event].offset;
+        if (head < _ring_write_end) {
+            // Used part does not wrap: free space after it, then before it.
+            start = _ring_write_end;
+            len = NRF_SERIALIZATION_RX_RING_SIZE - _ring_write_end;
+            if (len < SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE) {
+                start = 0;
+                len = head;
+            }
+        } else {
+            start = _ring_write_end;
+            len = head - _ring_write_end;
+        }
+    }
+
+    uint8_t* target = rx_overflow;
+    if (len >= SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE) {
+        target = rx_ring + start;
+    } else {
+        len = SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE;
+    }
+    if (target == rx && len == _rx_len) return;
+
+    rx = target;
+    _rx_len = len;
+    libtock_nrf51_serialization_set_readwrite_allow_receive_buffer(rx, _rx_len);
+}
+
+static uint8_t* rx_event_head (void) {
+    return rx_ring + rx_events[_head_event].offset;
+}
+
+static void rx_event_pop (void) {
+    _head_event = (_head_event + 1) % NRF_SERIALIZATION_RX_EVENTS;
+    _event_count--;
+    rx_ring_allow();
+}
+
+uint32_t nrf_serialization_dropped_events (void) {
+    return _dropped_events;
+}
+
 /*******************************************************************************
  * Callback from the UART layer in the kernel
  ******************************************************************************/
@@ -123,13 +203,15 @@ void ble_serialization_callback (int callback_type, int rx_len, int c, void* oth
     } else if (callback_type == 4) {
         // RX entire buffer
 
-        // Copy all received packets into our circular buffer
+        // Queue all received packets. Event packets are left in place in
+        // the ring.
+        bool in_ring = rx != rx_overflow;
         int offset = 0;
         while (1 && (rx_len - offset >= SER_PHY_HEADER_SIZE)) {
             int pktlen = (rx[offset] | rx[offset+1] << 8) + SER_PHY_HEADER_SIZE;
             // Make sure that pktlen is reasonable
             if (pktlen > (int) SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE ||
-                pktlen+offset > (int) SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE ||
+                pktlen+offset > (int) _rx_len ||
                 pktlen > rx_len - offset) {
                 // Too big to copy, something went wrong.
                 break;
@@ -148,23 +230,26 @@ void ble_serialization_callback (int callback_type, int rx_len, int c, void* oth
 
                         // Got a response, cancel any pending timer
                         if (_timeout_timer != NULL) {
-                            libtock_alarm_cancel(_timeout_timer);
+                            libtock_alarm_ms_cancel(_timeout_timer);
                             free(_timeout_timer);
                             _timeout_timer = NULL;
                         }
                     }
                     break;
 
-                case SER_PKT_TYPE_EVT:
+                case SER_PKT_TYPE_EVT: {
                     // Check if there is room
-                    if ((_tail_event + 1) % RX_BUFFER_SIZE == _head_event) {
-                        // No empty slots in the queue
+                    if (!in_ring || _event_count == NRF_SERIALIZATION_RX_EVENTS) {
+                        _dropped_events++;
                         break;
                     }
-                    // Copy into open slot and increment the pointer.
-                    memcpy(rx_event_buffers[_tail_event], rx+offset, pktlen);
-                    _tail_event = (_tail_event + 1) % RX_BUFFER_SIZE;
+                    // Record where the packet is.
+                    int tail = (_head_event + _event_count) % NRF_SERIALIZATION_RX_EVENTS;
+                    rx_events[tail].offset = (rx - rx_ring) + offset;
+                    rx_events[tail].len = pktlen;
+                    _event_count++;
                     break;
+                }
             }
 
             // Check for another packet in the buffer.
@@ -174,6 +259,12 @@ void ble_serialization_callback (int callback_type, int rx_len, int c, void* oth
             }
         }
 
+        // Receive the next bytes after these.
+        if (in_ring && rx_len > 0) {
+            _ring_write_end = (rx - rx_ring) + rx_len;
+            rx_ring_allow();
+        }
+
         // Only pass this buffer up if we don't have any others in flight. We
         // can only ask for one buffer from serialization at a time.
         if (!_receiving_packet) {
@@ -183,13 +274,13 @@ void ble_serialization_callback (int callback_type, int rx_len, int c, void* oth
             // library.
             if (_have_rsp_packet) {
                 buf_len = (rx_rsp_buffer[0] | rx_rsp_buffer[1] << 8);
-            } else if (!ser_sd_transport_is_busy() && _head_event != _tail_event) {
+            } else if (!ser_sd_transport_is_busy() && _event_count > 0) {
                 // DO NOT PROCESS EVENTS IF THERE IS A CMD/RSP PAIR STILL
                 // OUTSTANDING. Processing an events can generate a new command
                 // and things break. We use ser_sd_transport_is_busy() to do
                 // this check because it is essentially contingent on there
                 // being an outstanding response for a request.
-                buf_len = (rx_event_buffers[_head_event][0] | rx_event_buffers[_head_event][1] << 8);
+                buf_len = (rx_event_head()[0] | rx_event_head()[1] << 8);
             }
 
             if (buf_len > 0) {
@@ -223,11 +314,12 @@ void ble_serialization_callback (int callback_type, int rx_len, int c, void* oth
                 memcpy(hal_rx_buf, rx_rsp_buffer+SER_PHY_HEADER_SIZE, buf_len);
 
             } else {
-                buf_len = rx_event_buffers[_head_event][0] | (((uint16_t) rx_event_buffers[_head_event][1]) << 8);
-                memcpy(hal_rx_buf, rx_event_buffers[_head_event]+SER_PHY_HEADER_SIZE, buf_len);
+                uint8_t* packet = rx_event_head();
+                buf_len = packet[0] | (((uint16_t) packet[1]) << 8);
+                memcpy(hal_rx_buf, packet+SER_PHY_HEADER_SIZE, buf_len);
 
-                // Remove this packet from our queue.
-                _head_event = (_head_event + 1) % RX_BUFFER_SIZE;
+                // Remove this packet from our queue, freeing its space.
+                rx_event_pop();
             }
 
             _ser_phy_rx_event.evt_type = SER_PHY_EVT_RX_PKT_RECEIVED;
@@ -237,7 +329,7 @@ void ble_serialization_callback (int callback_type, int rx_len, int c, void* oth
             hal_rx_buf = NULL;
 
             // Check if there are more packets in the queue.
-            if (_head_event != _tail_event || _have_rsp_packet) {
+            if (_event_count > 0 || _have_rsp_packet) {
                 _queued_packets = true;
             }
 
@@ -329,7 +421,9 @@ uint32_t ser_phy_open (ser_phy_events_handler_t events_handler) {
     ret = libtock_nrf51_serialization_set_upcall(ble_serialization_callback, NULL);
     if (ret < 0) return NRF_ERROR_INTERNAL;
 
-    ret = libtock_nrf51_serialization_set_readwrite_allow_receive_buffer(rx, SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE);
+    rx = rx_ring;
+    _rx_len = NRF_SERIALIZATION_RX_RING_SIZE;
+    ret = libtock_nrf51_serialization_set_readwrite_allow_receive_buffer(rx, _rx_len);
     if (ret < 0) return NRF_ERROR_INTERNAL;
 
     ret = libtock_nrf51_serialization_read(SER_HAL_TRANSPORT_RX_MAX_PKT_SIZE, &bytes_read);
@@ -63,6 +63,13 @@
 #define SOFTDEVICE_CENTRAL_CONN_COUNT  4
 #define SOFTDEVICE_CENTRAL_SEC_COUNT   1
 
+// Ask the SoftDevice for high bandwidth links, which carry more packets per
+// connection event, if the nRF has the memory for them. Build with
+// -DSOFTDEVICE_CONN_BW_HIGH=0 to keep the SoftDevice defaults.
+#ifndef SOFTDEVICE_CONN_BW_HIGH
+#define SOFTDEVICE_CONN_BW_HIGH        1
+#endif
+
 /* Global nvic state instance, required by nrf_nvic.h */
 // nrf_nvic_state_t nrf_nvic_state;
 
@@ -371,10 +378,32 @@ uint32_t softdevice_enable_get_default_config(uint8_t central_links_count,
         p_ble_enable_params->gap_enable_params.central_sec_count  = SOFTDEVICE_CENTRAL_SEC_COUNT;
     }
 
+#if SOFTDEVICE_CONN_BW_HIGH
+    static ble_conn_bw_counts_t conn_bw_counts;
+    memset(&conn_bw_counts, 0, sizeof(conn_bw_counts));
+    conn_bw_counts.tx_counts.high_count = central_links_count + periph_links_count;
+    conn_bw_counts.rx_counts.high_count = central_links_count + periph_links_count;
+    p_ble_enable_params->common_enable_params.p_conn_bw_counts = &conn_bw_counts;
+#endif
+
     return NRF_SUCCESS;
 }
 
 
+#if SOFTDEVICE_CONN_BW_HIGH
+// Make new links in `role` use the high bandwidth buffers.
+static uint32_t conn_bw_high_set(uint8_t role)
+{
+    ble_opt_t opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.common_opt.conn_bw.role               = role;
+    opt.common_opt.conn_bw.conn_bw.conn_bw_tx = BLE_CONN_BW_HIGH;
+    opt.common_opt.conn_bw.conn_bw.conn_bw_rx = BLE_CONN_BW_HIGH;
+    return sd_ble_opt_set(BLE_COMMON_OPT_CONN_BW, &opt);
+}
+#endif
+
+
 #if defined(NRF_LOG_USES_RTT) && NRF_LOG_USES_RTT == 1
 static inline uint32_t ram_total_size_get(void)
 {
@@ -456,6 +485,28 @@ uint32_t softdevice_enable(ble_enable_params_t * p_ble_enable_params)
     // err_code = sd_ble_enable(p_ble_enable_params, &app_ram_base);
     err_code = sd_ble_enable(p_ble_enable_params, NULL);
 
+#if SOFTDEVICE_CONN_BW_HIGH
+    if (err_code == NRF_ERROR_NO_MEM && p_ble_enable_params->common_enable_params.p_conn_bw_counts != NULL)
+    {
+        // Not enough memory on the nRF for high bandwidth links; fall back
+        // to the defaults.
+        p_ble_enable_params->common_enable_params.p_conn_bw_counts = NULL;
+        err_code = sd_ble_enable(p_ble_enable_params, NULL);
+    }
+    else if (err_code == NRF_SUCCESS && p_ble_enable_params->common_enable_params.p_conn_bw_counts != NULL)
+    {
+        // Links keep the defaults if the option is refused.
+        if (p_ble_enable_params->gap_enable_params.periph_conn_count != 0)
+        {
+            conn_bw_high_set(BLE_GAP_ROLE_PERIPH);
+        }
+        if (p_ble_enable_params->gap_enable_params.central_conn_count != 0)
+        {
+            conn_bw_high_set(BLE_GAP_ROLE_CENTRAL);
+        }
+    }
+#endif
+
 // #if defined(NRF_LOG_USES_RTT) && NRF_LOG_USES_RTT == 1
 //     if (app_ram_base != ram_start)
 //     {
@@ -0,0 +1,23 @@
+#pragma once
+
+// mbedTLS AES on the Tock AES driver, enabled by `MBEDTLS_AES_ALT` in
+// `libtock-mbedtls-config.h`. See `tock_mbedtls_alt.c`.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <libtock/crypto/aes128_soft.h>
+
+// Shortest CBC or CTR input, in bytes, sent to the AES driver. Shorter ones,
+// and all single block operations, run in software, as the system calls cost
+// more than they save.
+#ifndef LIBTOCK_MBEDTLS_AES_THRESHOLD
+#define LIBTOCK_MBEDTLS_AES_THRESHOLD 128
+#endif
+
+typedef struct mbedtls_aes_context {
+  libtock_aes128_soft_t soft;
+  // The key, for the driver.
+  uint8_t key[LIBTOCK_AES128_SOFT_BLOCK];
+  bool has_key;
+} mbedtls_aes_context;
@@ -1,6 +1,6 @@
 #pragma once
 
-// We use the default mbedtls-config.h file with one change.
+// We use the default mbedtls-config.h file with a few changes.
 
 #include "mbedtls-config.h"
 
@@ -11,3 +11,16 @@
 // use the assembly implementation on cortex-m0.
 #undef MBEDTLS_HAVE_ASM
 #endif
+
+// Use the Tock AES and SHA drivers, see `tock_mbedtls_alt.c`. Build with
+// `-DLIBTOCK_MBEDTLS_SOFTWARE_CRYPTO` for mbedTLS's own implementations.
+#ifndef LIBTOCK_MBEDTLS_SOFTWARE_CRYPTO
+#define MBEDTLS_AES_ALT
+#define MBEDTLS_SHA256_ALT
+// The replacement has no XTS, and no use for the AES instructions of other
+// architectures.
+#undef MBEDTLS_CIPHER_MODE_XTS
+#undef MBEDTLS_AESNI_C
+#undef MBEDTLS_AESCE_C
+#undef MBEDTLS_PADLOCK_C
+#endif
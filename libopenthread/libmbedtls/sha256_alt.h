@@ -0,0 +1,22 @@
+#pragma once
+
+// mbedTLS SHA-256 on the Tock SHA driver, enabled by `MBEDTLS_SHA256_ALT` in
+// `libtock-mbedtls-config.h`. See `tock_mbedtls_alt.c`.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <libtock/crypto/sha256_soft.h>
+
+// Shortest first update, in bytes, that moves a SHA-256 hash to the driver.
+#ifndef LIBTOCK_MBEDTLS_SHA256_THRESHOLD
+#define LIBTOCK_MBEDTLS_SHA256_THRESHOLD 512
+#endif
+
+typedef struct mbedtls_sha256_context {
+  libtock_sha256_soft_t soft;
+  // Where the hash runs, see `tock_mbedtls_alt.c`.
+  uint8_t mode;
+  bool is224;
+  bool empty;
+} mbedtls_sha256_context;
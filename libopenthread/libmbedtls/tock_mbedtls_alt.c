@@ -0,0 +1,340 @@
+// mbedTLS AES and SHA-256 on the Tock crypto drivers.
+//
+// OpenThread hashes and encrypts through mbedTLS, which does both in
+// software. With `MBEDTLS_AES_ALT` and `MBEDTLS_SHA256_ALT` these
+// implementations take over, and send work large enough to be worth the system
+// calls to the kernel's drivers:
+//
+// - AES: CBC and CTR runs of at least `LIBTOCK_MBEDTLS_AES_THRESHOLD` bytes
+//   go through `libtocksync_aes_stream()`. Single blocks, which is how CCM and
+//   CMAC use AES, stay in software with `aes128_soft`. The drivers only do
+//   AES-128, so only 128-bit keys are accepted.
+// - SHA-256: a hash whose first update is at least
+//   `LIBTOCK_MBEDTLS_SHA256_THRESHOLD` bytes runs on the driver while no other
+//   hash does, otherwise in software with `sha256_soft`. The driver keeps the
+//   state of its one hash in the kernel, so a hash on the driver cannot be
+//   cloned; its clone fails at `mbedtls_sha256_finish()`. The TLS handshake
+//   checksum is the one cloned hash OpenThread uses, and its first update, the
+//   ClientHello, is well below the default threshold.
+//
+// Both wait for the drivers with `yield()`, so other upcalls can run during
+// a call.
+//
+// Without the drivers both run in software. This follows the mbedTLS 3 API.
+
+#include <string.h>
+
+#include "mbedtls/aes.h"
+#include "mbedtls/error.h"
+#include "mbedtls/platform_util.h"
+#include "mbedtls/sha256.h"
+
+#include <libtock-sync/crypto/aes.h>
+#include <libtock-sync/crypto/sha.h>
+
+#ifndef MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED
+#define MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED -0x0070
+#endif
+
+#define BLOCK LIBTOCK_AES128_SOFT_BLOCK
+
+// ***** AES *****
+
+#if defined(MBEDTLS_AES_ALT)
+
+// Chunk of a driver stream; the stream needs four.
+#define AES_CHUNK 64
+
+typedef struct {
+  const uint8_t* in;
+  uint8_t* out;
+  size_t len;
+  size_t filled;
+} aes_job_t;
+
+static uint8_t aes_work[4 * AES_CHUNK];
+
+static uint32_t aes_fill(uint8_t* buf, uint32_t len, void* opaque) {
+  aes_job_t* job = (aes_job_t*) opaque;
+  size_t n       = job->len - job->filled;
+  if (n > len) n = len;
+  memcpy(buf, job->in + job->filled, n);
+  job->filled += n;
+  return (uint32_t) n;
+}
+
+static void aes_drain(const uint8_t* buf, uint32_t len, void* opaque) {
+  aes_job_t* job = (aes_job_t*) opaque;
+  memcpy(job->out, buf, len);
+  job->out += len;
+}
+
+// Run `len` bytes, whole blocks, through the driver. Returns false if the
+// driver is busy, so the caller can run them in software.
+static bool aes_driver(const mbedtls_aes_context* ctx, libtock_aes_algorithm_t operation, bool encrypting,
+                       const uint8_t* iv, const uint8_t* in, uint8_t* out, size_t len) {
+  aes_job_t job = {.in = in, .out = out, .len = len, .filled = 0};
+  return libtocksync_aes_stream(operation, encrypting, ctx->key, iv, aes_work, AES_CHUNK, aes_fill, aes_drain,
+                                &job) == RETURNCODE_SUCCESS;
+}
+
+void mbedtls_aes_init(mbedtls_aes_context* ctx) {
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_aes_free(mbedtls_aes_context* ctx) {
+  if (ctx == NULL) return;
+  mbedtls_platform_zeroize(ctx, sizeof(*ctx));
+}
+
+int mbedtls_aes_setkey_enc(mbedtls_aes_context* ctx, const unsigned char* key, unsigned int keybits) {
+  if (keybits != 128) return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
+  libtock_aes128_soft_init(&ctx->soft, key);
+  memcpy(ctx->key, key, BLOCK);
+  ctx->has_key = true;
+  return 0;
+}
+
+#if !defined(MBEDTLS_BLOCK_CIPHER_NO_DECRYPT)
+int mbedtls_aes_setkey_dec(mbedtls_aes_context* ctx, const unsigned char* key, unsigned int keybits) {
+  // Both directions use the same schedule.
+  return mbedtls_aes_setkey_enc(ctx, key, keybits);
+}
+
+int mbedtls_internal_aes_decrypt(mbedtls_aes_context* ctx, const unsigned char input[16], unsigned char output[16]) {
+  libtock_aes128_soft_decrypt_block(&ctx->soft, input, output);
+  return 0;
+}
+#endif
+
+int mbedtls_internal_aes_encrypt(mbedtls_aes_context* ctx, const unsigned char input[16], unsigned char output[16]) {
+  libtock_aes128_soft_encrypt_block(&ctx->soft, input, output);
+  return 0;
+}
+
+int mbedtls_aes_crypt_ecb(mbedtls_aes_context* ctx, int mode, const unsigned char input[16],
+                          unsigned char output[16]) {
+  if (!ctx->has_key) return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+  if (mode == MBEDTLS_AES_ENCRYPT) {
+    libtock_aes128_soft_encrypt_block(&ctx->soft, input, output);
+  } else {
+    libtock_aes128_soft_decrypt_block(&ctx->soft, input, output);
+  }
+  return 0;
+}
+
+#if defined(MBEDTLS_CIPHER_MODE_CBC)
+int mbedtls_aes_crypt_cbc(mbedtls_aes_context* ctx, int mode, size_t length, unsigned char iv[16],
+                          const unsigned char* input, unsigned char* output) {
+  if (!ctx->has_key) return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+  if (length % BLOCK != 0) return MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH;
+  if (length == 0) return 0;
+
+  bool encrypting = mode == MBEDTLS_AES_ENCRYPT;
+  if (length >= LIBTOCK_MBEDTLS_AES_THRESHOLD) {
+    // The next IV is the last ciphertext block, which decryption may
+    // overwrite in place.
+    uint8_t next_iv[BLOCK];
+    if (!encrypting) memcpy(next_iv, input + length - BLOCK, BLOCK);
+    if (aes_driver(ctx, LIBTOCK_AES128CBC, encrypting, iv, input, output, length)) {
+      memcpy(iv, encrypting ? output + length - BLOCK : next_iv, BLOCK);
+      return 0;
+    }
+  }
+
+  libtock_aes128_soft_cbc(&ctx->soft, encrypting, iv, input, output, (uint32_t) length);
+  return 0;
+}
+#endif
+
+#if defined(MBEDTLS_CIPHER_MODE_CFB)
+int mbedtls_aes_crypt_cfb128(mbedtls_aes_context* ctx, int mode, size_t length, size_t* iv_off,
+                             unsigned char iv[16], const unsigned char* input, unsigned char* output) {
+  if (!ctx->has_key || *iv_off >= BLOCK) return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+
+  size_t n = *iv_off;
+  for (size_t i = 0; i < length; i++) {
+    if (n == 0) libtock_aes128_soft_encrypt_block(&ctx->soft, iv, iv);
+    uint8_t c = input[i];
+    output[i] = c ^ iv[n];
+    iv[n]     = mode == MBEDTLS_AES_ENCRYPT ? output[i] : c;
+    n         = (n + 1) % BLOCK;
+  }
+  *iv_off = n;
+  return 0;
+}
+
+int mbedtls_aes_crypt_cfb8(mbedtls_aes_context* ctx, int mode, size_t length, unsigned char iv[16],
+                           const unsigned char* input, unsigned char* output) {
+  if (!ctx->has_key) return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+
+  uint8_t block[BLOCK];
+  for (size_t i = 0; i < length; i++) {
+    libtock_aes128_soft_encrypt_block(&ctx->soft, iv, block);
+    uint8_t c = input[i];
+    output[i] = c ^ block[0];
+    memmove(iv, iv + 1, BLOCK - 1);
+    iv[BLOCK - 1] = mode == MBEDTLS_AES_ENCRYPT ? output[i] : c;
+  }
+  return 0;
+}
+#endif
+
+#if defined(MBEDTLS_CIPHER_MODE_OFB)
+int mbedtls_aes_crypt_ofb(mbedtls_aes_context* ctx, size_t length, size_t* iv_off, unsigned char iv[16],
+                          const unsigned char* input, unsigned char* output) {
+  if (!ctx->has_key || *iv_off >= BLOCK) return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+
+  size_t n = *iv_off;
+  for (size_t i = 0; i < length; i++) {
+    if (n == 0) libtock_aes128_soft_encrypt_block(&ctx->soft, iv, iv);
+    output[i] = input[i] ^ iv[n];
+    n         = (n + 1) % BLOCK;
+  }
+  *iv_off = n;
+  return 0;
+}
+#endif
+
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+// Add `blocks` to the big endian counter.
+static void counter_add(uint8_t* counter, size_t blocks) {
+  for (int i = BLOCK - 1; i >= 0 && blocks != 0; i--) {
+    blocks    += counter[i];
+    counter[i] = (uint8_t) blocks;
+    blocks   >>= 8;
+  }
+}
+
+int mbedtls_aes_crypt_ctr(mbedtls_aes_context* ctx, size_t length, size_t* nc_off, unsigned char nonce_counter[16],
+                          unsigned char stream_block[16], const unsigned char* input, unsigned char* output) {
+  if (!ctx->has_key || *nc_off >= BLOCK) return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+
+  size_t n = *nc_off;
+  if (n == 0 && length >= LIBTOCK_MBEDTLS_AES_THRESHOLD) {
+    size_t whole = length - length % BLOCK;
+    if (aes_driver(ctx, LIBTOCK_AES128Ctr, true, nonce_counter, input, output, whole)) {
+      counter_add(nonce_counter, whole / BLOCK);
+      input  += whole;
+      output += whole;
+      length -= whole;
+    }
+  }
+
+  for (size_t i = 0; i < length; i++) {
+    if (n == 0) {
+      libtock_aes128_soft_encrypt_block(&ctx->soft, nonce_counter, stream_block);
+      counter_add(nonce_counter, 1);
+    }
+    output[i] = input[i] ^ stream_block[n];
+    n         = (n + 1) % BLOCK;
+  }
+  *nc_off = n;
+  return 0;
+}
+#endif
+
+#endif // MBEDTLS_AES_ALT
+
+// ***** SHA-256 *****
+
+#if defined(MBEDTLS_SHA256_ALT)
+
+enum {
+  SHA_SOFTWARE,
+  SHA_DRIVER,
+  // A clone of a hash on the driver, which cannot continue.
+  SHA_FAILED,
+};
+
+// The hash that has the driver.
+static mbedtls_sha256_context* sha_owner = NULL;
+
+static const uint32_t sha224_iv[8] = {
+  0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4,
+};
+
+static void sha_release(mbedtls_sha256_context* ctx) {
+  if (sha_owner == ctx) sha_owner = NULL;
+}
+
+void mbedtls_sha256_init(mbedtls_sha256_context* ctx) {
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_sha256_free(mbedtls_sha256_context* ctx) {
+  if (ctx == NULL) return;
+  sha_release(ctx);
+  mbedtls_platform_zeroize(ctx, sizeof(*ctx));
+}
+
+void mbedtls_sha256_clone(mbedtls_sha256_context* dst, const mbedtls_sha256_context* src) {
+  *dst = *src;
+  if (src->mode == SHA_DRIVER) dst->mode = SHA_FAILED;
+}
+
+int mbedtls_sha256_starts(mbedtls_sha256_context* ctx, int is224) {
+  sha_release(ctx);
+  libtock_sha256_soft_init(&ctx->soft);
+  if (is224) memcpy(ctx->soft.state, sha224_iv, sizeof(sha224_iv));
+  ctx->mode  = SHA_SOFTWARE;
+  ctx->is224 = is224 != 0;
+  ctx->empty = true;
+  return 0;
+}
+
+int mbedtls_sha256_update(mbedtls_sha256_context* ctx, const unsigned char* input, size_t ilen) {
+  if (ilen == 0) return 0;
+  if (ctx->mode == SHA_FAILED) return MBEDTLS_ERR_SHA256_BAD_INPUT_DATA;
+
+  if (ctx->empty && !ctx->is224 && sha_owner == NULL && ilen >= LIBTOCK_MBEDTLS_SHA256_THRESHOLD &&
+      libtocksync_sha_init(LIBTOCK_SHA256) == RETURNCODE_SUCCESS) {
+    sha_owner = ctx;
+    ctx->mode = SHA_DRIVER;
+  }
+  ctx->empty = false;
+
+  if (ctx->mode == SHA_SOFTWARE) {
+    libtock_sha256_soft_update(&ctx->soft, input, (uint32_t) ilen);
+    return 0;
+  }
+  if (libtocksync_sha_update(input, (uint32_t) ilen) != RETURNCODE_SUCCESS) {
+    sha_release(ctx);
+    ctx->mode = SHA_FAILED;
+    return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+  }
+  return 0;
+}
+
+int mbedtls_sha256_finish(mbedtls_sha256_context* ctx, unsigned char* output) {
+  uint8_t hash[LIBTOCK_SHA256_SOFT_HASH];
+  int ret = 0;
+
+  switch (ctx->mode) {
+    case SHA_SOFTWARE:
+      libtock_sha256_soft_finish(&ctx->soft, hash);
+      break;
+    case SHA_DRIVER:
+      if (libtocksync_sha_finish(hash, sizeof(hash)) != RETURNCODE_SUCCESS) {
+        ret = MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+      }
+      sha_release(ctx);
+      break;
+    default:
+      return MBEDTLS_ERR_SHA256_BAD_INPUT_DATA;
+  }
+
+  if (ret == 0) memcpy(output, hash, ctx->is224 ? 28 : sizeof(hash));
+  mbedtls_platform_zeroize(hash, sizeof(hash));
+  ctx->mode = SHA_FAILED;
+  return ret;
+}
+
+int mbedtls_internal_sha256_process(mbedtls_sha256_context* ctx, const unsigned char data[64]) {
+  if (ctx->mode != SHA_SOFTWARE) return MBEDTLS_ERR_SHA256_BAD_INPUT_DATA;
+  libtock_sha256_soft_update(&ctx->soft, data, LIBTOCK_SHA256_SOFT_BLOCK);
+  ctx->empty = false;
+  return 0;
+}
+
+#endif // MBEDTLS_SHA256_ALT
@@ -1,12 +1,126 @@
+#include <services/alarm.h>
 #include <storage/nonvolatile_storage.h>
 #include <libtock-sync/storage/nonvolatile_storage.h>
 
 #include <openthread/platform/flash.h>
 
+#include <assert.h>
 #include <stdio.h>
+#include <string.h>
+
+// OpenThread keeps its settings as a log of records in two swap areas
+// on top of this flash API, and updates records such as the child table
+// whenever the network changes. Both swap areas are therefore cached in
+// RAM: reads are served from the cache, and writes only change the cache
+// and mark the chunks they touch dirty. Dirty chunks are written to
+// nonvolatile storage asynchronously, so OpenThread never waits on flash.
+//
+// To spread wear, the flush starts OT_TOCK_FLASH_FLUSH_MS after the first
+// write to a clean cache rather than after every write, so a burst of
+// changes costs one write per chunk, and chunks whose contents did not
+// change are not written at all. Writes of records OpenThread cannot
+// afford to lose (the datasets and the network info holding the frame
+// counters) and erases, which start a swap, start the flush right away.
+// A reset before a delayed flush loses the records in that window, which
+// OpenThread recovers from by relearning them from the network.
+
+#ifndef OT_TOCK_FLASH_FLUSH_MS
+#define OT_TOCK_FLASH_FLUSH_MS 5000
+#endif
+
+#define SWAP_SIZE 1024
+#define SWAP_NUM 2
+#define CHUNK_SIZE 64
+#define CHUNKS (SWAP_SIZE * SWAP_NUM / CHUNK_SIZE)
+
+// Size of the settings record header, which starts with the key.
+#define RECORD_HEADER_SIZE 8
+// The swap marker at the start of each swap area.
+#define SWAP_MARKER_SIZE 4
+
+static uint8_t cache[SWAP_SIZE * SWAP_NUM];
+static bool dirty[CHUNKS];
+
+static struct {
+    // Chunk being written, -1 while storage is idle.
+    int writing;
+    bool scheduled;
+    libtock_alarm_t alarm;
+    // Copy of the chunk being written, so the cache can change meanwhile.
+    uint8_t buffer[CHUNK_SIZE];
+} flush;
+
+// Settings keys written through right away: active and pending datasets,
+// and network info.
+static bool critical_key(uint16_t key) {
+    return key >= 1 && key <= 3;
+}
+
+static void flush_next(void);
+
+static void write_done(returncode_t ret, __attribute__ ((unused)) int length) {
+    // Retry the chunk with the next flush if it failed.
+    if (ret != RETURNCODE_SUCCESS) dirty[flush.writing] = true;
+    flush.writing = -1;
+
+    if (ret == RETURNCODE_SUCCESS) flush_next();
+}
+
+// Start writing the next dirty chunk, if there is one.
+static void flush_next(void) {
+    if (flush.writing >= 0) return;
+
+    for (int i = 0; i < CHUNKS; i++) {
+        if (!dirty[i]) continue;
+
+        dirty[i] = false;
+        memcpy(flush.buffer, &cache[i * CHUNK_SIZE], CHUNK_SIZE);
+        flush.writing = i;
+        if (libtock_nonvolatile_storage_write(i * CHUNK_SIZE, CHUNK_SIZE, flush.buffer, CHUNK_SIZE,
+                                              write_done) != RETURNCODE_SUCCESS) {
+            dirty[i]      = true;
+            flush.writing = -1;
+        }
+        return;
+    }
+}
+
+static void flush_due(__attribute__ ((unused)) uint32_t now,
+                      __attribute__ ((unused)) uint32_t scheduled,
+                      __attribute__ ((unused)) void*    opaque) {
+    flush.scheduled = false;
+    flush_next();
+}
+
+static void flush_now(void) {
+    if (flush.scheduled) {
+        libtock_alarm_ms_cancel(&flush.alarm);
+        flush.scheduled = false;
+    }
+    flush_next();
+}
+
+static void flush_later(void) {
+    if (flush.scheduled || flush.writing >= 0) return;
+    if (libtock_alarm_in_ms(OT_TOCK_FLASH_FLUSH_MS, flush_due, NULL, &flush.alarm) == RETURNCODE_SUCCESS) {
+        flush.scheduled = true;
+    } else {
+        flush_next();
+    }
+}
 
-const uint32_t SWAP_SIZE = 1024;
-const uint8_t SWAP_NUM = 2;
+// Copy `size` bytes into the cache at `offset`, marking the chunks that
+// changed. Returns whether anything changed.
+static bool cache_write(uint32_t offset, const uint8_t *data, uint32_t size) {
+    bool changed = false;
+    for (uint32_t i = 0; i < size; i++) {
+        if (cache[offset + i] == data[i]) continue;
+        cache[offset + i] = data[i];
+        dirty[(offset + i) / CHUNK_SIZE] = true;
+        changed = true;
+    }
+    return changed;
+}
 
 uint32_t otPlatFlashGetSwapSize(otInstance *aInstance){
 	OT_UNUSED_VARIABLE(aInstance);
@@ -15,51 +129,51 @@ uint32_t otPlatFlashGetSwapSize(otInstance *aInstance){
 
 void otPlatFlashInit(otInstance *aInstance) {
     OT_UNUSED_VARIABLE(aInstance);
+
+    flush.writing = -1;
+    int _read;
+    if (libtocksync_nonvolatile_storage_read(0, sizeof(cache), cache, sizeof(cache), &_read) != RETURNCODE_SUCCESS) {
+        memset(cache, 0xff, sizeof(cache));
+    }
 }
 
 void otPlatFlashErase(otInstance *aInstance, uint8_t aSwapIndex) {
     OT_UNUSED_VARIABLE(aInstance);
+    assert(aSwapIndex < SWAP_NUM);
 
-    uint32_t num_bytes;
-    libtock_nonvolatile_storage_get_number_bytes(&num_bytes);
-
-    // Write all zeroes to flash
-    uint8_t zeroes[SWAP_SIZE];
-
-    otPlatFlashWrite(aInstance, aSwapIndex, 0, zeroes, num_bytes);
-
+    // Erased flash reads as all ones.
+    uint8_t erased[CHUNK_SIZE];
+    memset(erased, 0xff, sizeof(erased));
+    for (uint32_t offset = 0; offset < SWAP_SIZE; offset += CHUNK_SIZE) {
+        cache_write(aSwapIndex * SWAP_SIZE + offset, erased, CHUNK_SIZE);
+    }
+    flush_now();
 }
 
 void otPlatFlashWrite(otInstance *aInstance, uint8_t aSwapIndex, uint32_t aOffset,
                       const void *aData, uint32_t aSize) {
     OT_UNUSED_VARIABLE(aInstance);
-    OT_UNUSED_VARIABLE(aSwapIndex);
-    int ret;
-
     assert(aSwapIndex < SWAP_NUM);
-    uint32_t offset = aSwapIndex ? SWAP_SIZE : 0;
-    offset += aOffset;
+    assert(aOffset + aSize <= SWAP_SIZE);
 
-    int _written;
-    ret = libtocksync_nonvolatile_storage_write(offset, aSize, (uint8_t*)aData, aSize, &_written);
-    if (ret != RETURNCODE_SUCCESS) {
+    const uint8_t *data = (const uint8_t *)aData;
+    if (!cache_write(aSwapIndex * SWAP_SIZE + aOffset, data, aSize)) {
         return;
     }
+
+    if (aOffset >= SWAP_MARKER_SIZE && aSize >= RECORD_HEADER_SIZE &&
+        critical_key((uint16_t)(data[0] | (data[1] << 8)))) {
+        flush_now();
+    } else {
+        flush_later();
+    }
 }
 
 void otPlatFlashRead(otInstance *aInstance, uint8_t aSwapIndex, uint32_t aOffset, void *aData,
                      uint32_t aSize) {
     OT_UNUSED_VARIABLE(aInstance);
-    OT_UNUSED_VARIABLE(aSwapIndex);
-    int ret;
-
     assert(aSwapIndex < SWAP_NUM);
-    uint32_t offset = aSwapIndex ? SWAP_SIZE : 0;
-    offset += aOffset;
+    assert(aOffset + aSize <= SWAP_SIZE);
 
-    int _read;
-    ret = libtocksync_nonvolatile_storage_read(offset, aSize, (uint8_t*)aData, aSize, &_read);
-    if (ret != RETURNCODE_SUCCESS) {
-        return;
-    }
+    memcpy(aData, &cache[aSwapIndex * SWAP_SIZE + aOffset], aSize);
 }
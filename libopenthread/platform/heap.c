@@ -0,0 +1,113 @@
+#include <stdbool.h>
+#include <string.h>
+
+#include <openthread/platform/memory.h>
+
+#include "tock_heap.h"
+
+#define ALIGN 8
+
+typedef struct block {
+  // Size of the block including this header.
+  uint32_t size;
+  // Next free block, only valid while the block is free.
+  struct block *next;
+} block_t;
+
+#define HEADER ((sizeof(block_t) + ALIGN - 1) & ~(size_t) (ALIGN - 1))
+#define MIN_BLOCK (HEADER + ALIGN)
+#define ARENA_SIZE (OT_TOCK_HEAP_SIZE & ~(size_t) (ALIGN - 1))
+
+// otPlatCAlloc() carries no context, so the arena is global.
+static struct {
+  uint8_t arena[ARENA_SIZE] __attribute__((aligned(ALIGN)));
+  block_t *free_list;
+  bool initialized;
+  otTockHeapUsage usage;
+} heap;
+
+static void init(void) {
+  heap.free_list        = (block_t *) heap.arena;
+  heap.free_list->size  = ARENA_SIZE;
+  heap.free_list->next  = NULL;
+  heap.usage.mTotal     = ARENA_SIZE;
+  heap.initialized      = true;
+}
+
+void *otPlatCAlloc(size_t aNum, size_t aSize) {
+  if (!heap.initialized) init();
+
+  if (aNum == 0 || aSize == 0 || aSize > ARENA_SIZE / aNum) return NULL;
+  size_t len    = aNum * aSize;
+  uint32_t need = (len + HEADER + ALIGN - 1) & ~(uint32_t) (ALIGN - 1);
+
+  block_t **link = &heap.free_list;
+  while (*link != NULL && (*link)->size < need) link = &(*link)->next;
+
+  block_t *block = *link;
+  if (block == NULL) {
+    heap.usage.mFailures++;
+    return NULL;
+  }
+
+  if (block->size - need >= MIN_BLOCK) {
+    // Keep the tail free, in the block's place in the list.
+    block_t *rest = (block_t *) ((uint8_t *) block + need);
+    rest->size  = block->size - need;
+    rest->next  = block->next;
+    *link       = rest;
+    block->size = need;
+  } else {
+    *link = block->next;
+  }
+
+  heap.usage.mUsed += block->size;
+  heap.usage.mBlocks++;
+  if (heap.usage.mUsed > heap.usage.mPeak) heap.usage.mPeak = heap.usage.mUsed;
+
+  void *payload = (uint8_t *) block + HEADER;
+  memset(payload, 0, len);
+  return payload;
+}
+
+void otPlatFree(void *aPtr) {
+  if (aPtr == NULL) return;
+
+  block_t *block = (block_t *) ((uint8_t *) aPtr - HEADER);
+  heap.usage.mUsed -= block->size;
+  heap.usage.mBlocks--;
+
+  block_t *prev = NULL;
+  block_t *next = heap.free_list;
+  while (next != NULL && next < block) {
+    prev = next;
+    next = next->next;
+  }
+
+  if (next != NULL && (uint8_t *) block + block->size == (uint8_t *) next) {
+    block->size += next->size;
+    block->next  = next->next;
+  } else {
+    block->next = next;
+  }
+
+  if (prev != NULL && (uint8_t *) prev + prev->size == (uint8_t *) block) {
+    prev->size += block->size;
+    prev->next  = block->next;
+  } else if (prev != NULL) {
+    prev->next = block;
+  } else {
+    heap.free_list = block;
+  }
+}
+
+void otTockHeapGetUsage(otTockHeapUsage *aUsage) {
+  if (!heap.initialized) init();
+  *aUsage = heap.usage;
+
+  aUsage->mLargestFree = 0;
+  for (block_t *b = heap.free_list; b != NULL; b = b->next) {
+    uint32_t payload = b->size - HEADER;
+    if (payload > aUsage->mLargestFree) aUsage->mLargestFree = payload;
+  }
+}
@@ -85,7 +85,8 @@
 /**
  * @def OPENTHREAD_CONFIG_NUM_MESSAGE_BUFFERS
  *
- * The number of message buffers in the buffer pool.
+ * The number of message buffers in the buffer pool. With message buffers on the heap, this sizes their share of
+ * `OT_TOCK_HEAP_SIZE`.
  *
  */
 #ifndef OPENTHREAD_CONFIG_NUM_MESSAGE_BUFFERS
@@ -214,10 +215,42 @@
 #define OPENTHREAD_CONFIG_PLATFORM_FLASH_API_ENABLE 1
 #endif
 
+/**
+ * @def OPENTHREAD_CONFIG_HEAP_EXTERNAL_ENABLE
+ *
+ * Define as 1 to allocate through otPlatCAlloc() and otPlatFree(), which take OpenThread's and mbedTLS's memory
+ * from a static arena of `OT_TOCK_HEAP_SIZE` bytes, see `tock_heap.h`.
+ *
+ */
+#ifndef OPENTHREAD_CONFIG_HEAP_EXTERNAL_ENABLE
+#define OPENTHREAD_CONFIG_HEAP_EXTERNAL_ENABLE 1
+#endif
+
+/**
+ * @def OPENTHREAD_CONFIG_MESSAGE_USE_HEAP_ENABLE
+ *
+ * Define as 1 to allocate message buffers from the heap, so they share the arena with mbedTLS.
+ *
+ */
+#ifndef OPENTHREAD_CONFIG_MESSAGE_USE_HEAP_ENABLE
+#define OPENTHREAD_CONFIG_MESSAGE_USE_HEAP_ENABLE 1
+#endif
+
+/**
+ * @def OPENTHREAD_CONFIG_MESSAGE_BUFFER_SIZE
+ *
+ * The size of a message buffer in bytes, OpenThread's default. Defined here so `OT_TOCK_HEAP_SIZE` can use it.
+ *
+ */
+#ifndef OPENTHREAD_CONFIG_MESSAGE_BUFFER_SIZE
+#define OPENTHREAD_CONFIG_MESSAGE_BUFFER_SIZE (sizeof(void *) * 32)
+#endif
+
 /**
  * @def OPENTHREAD_CONFIG_HEAP_INTERNAL_SIZE
  *
- * The size of heap buffer when DTLS is enabled.
+ * The size of heap buffer when DTLS is enabled. With the external heap, this is mbedTLS's share of
+ * `OT_TOCK_HEAP_SIZE`.
  *
  */
 #ifndef OPENTHREAD_CONFIG_HEAP_INTERNAL_SIZE
@@ -270,6 +303,17 @@
 #endif
 #endif
 
+/**
+ * @def OPENTHREAD_CONFIG_PLATFORM_USEC_TIMER_ENABLE
+ *
+ * Define as 1 to use the microsecond alarm of the platform, which is backed by the 64-bit clock of
+ * `services/time`.
+ *
+ */
+#ifndef OPENTHREAD_CONFIG_PLATFORM_USEC_TIMER_ENABLE
+#define OPENTHREAD_CONFIG_PLATFORM_USEC_TIMER_ENABLE 1
+#endif
+
 /**
  * @def RADIO_CONFIG_SRC_MATCH_SHORT_ENTRY_NUM
  *
@@ -327,6 +371,16 @@
 #define OPENTHREAD_CONFIG_MIN_RECEIVE_ON_AFTER 0
 #endif
 
+/**
+ * @def OPENTHREAD_CONFIG_TCP_ENABLE
+ *
+ * Define as 1 to enable the TCP API, which `tock_tcp.h` builds on.
+ *
+ */
+#ifndef OPENTHREAD_CONFIG_TCP_ENABLE
+#define OPENTHREAD_CONFIG_TCP_ENABLE 1
+#endif
+
 /*
  * Suppress the ARMCC warning on unreachable statement,
  * e.g. break after assert(false) or ExitNow() macro.
@@ -95,6 +95,19 @@ extern void otSysEventSignalPending(void);
 
 otError otTockStartReceive(uint8_t aChannel, otInstance *aInstance);
 
+// Share OpenThread's receive ring with the kernel again after something else,
+// such as an energy scan, took the receive upcall. Does nothing before
+// receiving has started.
+void otTockResumeReceive(void);
+
+// Run one iteration of the main loop: process tasklets if OpenThread has
+// signalled any, dispatch driver events if an upcall has signalled any,
+// and yield if neither is left.
+void otTockProcess(otInstance *aInstance);
+
+// Run the main loop forever.
+void otTockRun(otInstance *aInstance);
+
 #ifdef __cplusplus
 } // end of extern "C"
 #endif
@@ -3,26 +3,33 @@
 #include <libtock-sync/net/ieee802154.h>
 #include <libtock/net/eui64.h>
 #include <libtock/net/ieee802154.h>
+#include <libtock/net/ieee802154_scan.h>
 
 #include <openthread/platform/radio.h>
 
 #include "openthread-system.h"
 #include "plat.h"
 
-#define ACK_SIZE 3
-
 static uint8_t tx_mPsdu[OT_RADIO_FRAME_MAX_SIZE];
 static otRadioFrame transmitFrame = {
   .mPsdu   = tx_mPsdu,
   .mLength = OT_RADIO_FRAME_MAX_SIZE
 };
 
-// nrf52840 ACK on transmit is currently unimplemented. We fake this
-// for now by always saying the sent packet was ACKed by the receiver.
-static uint8_t ack_mPSdu[ACK_SIZE] = {0x02, 0x00, 0x00};
+// The driver reports whether a frame was acknowledged, but not the ACK
+// itself, so OpenThread is given an immediate ACK built from the transmitted
+// frame: frame control, sequence number and FCS.
+#define ACK_SIZE 5
+#define FCF_FRAME_TYPE_MASK 0x07
+#define FCF_FRAME_TYPE_ACK 0x02
+#define FCF_FRAME_TYPE_COMMAND 0x03
+#define FCF_FRAME_PENDING 0x10
+#define FCF_ACK_REQUEST 0x20
+
+static uint8_t ack_mPsdu[ACK_SIZE];
 static otRadioFrame ackFrame_radio = {
-  .mPsdu   = ack_mPSdu,
-  .mLength = 3
+  .mPsdu   = ack_mPsdu,
+  .mLength = ACK_SIZE
 };
 
 static struct pending_tx_done_callback {
@@ -32,23 +39,79 @@ static struct pending_tx_done_callback {
 } pending_tx_done_callback = {false, false, TOCK_STATUSCODE_FAIL};
 
 static void tx_done_callback(statuscode_t status, bool acked) {
-	pending_tx_done_callback.flag = true;
+  pending_tx_done_callback.flag = true;
   pending_tx_done_callback.acked = acked;
   pending_tx_done_callback.status = status;
+  otSysEventSignalPending();
 }
 
-bool pending_tx_done_callback_status(otRadioFrame *ackFrame, returncode_t *status, otRadioFrame *txFrame) {
-  if (pending_tx_done_callback.flag) {
-    *ackFrame = ackFrame_radio;
-    *status = tock_status_to_returncode(pending_tx_done_callback.status);
-    *txFrame = transmitFrame;
-  } 
-	
+bool pending_tx_done_callback_status(void) {
   return pending_tx_done_callback.flag;
 }
 
 void reset_pending_tx_done_callback(void) {
-	pending_tx_done_callback.flag = false;
+  pending_tx_done_callback.flag = false;
+}
+
+void handle_tx_done(otInstance *aInstance) {
+  if (!pending_tx_done_callback.flag) return;
+  reset_pending_tx_done_callback();
+
+  bool ack_requested = transmitFrame.mPsdu[0] & FCF_ACK_REQUEST;
+  returncode_t ret = tock_status_to_returncode(pending_tx_done_callback.status);
+
+  if (ret == RETURNCODE_ENOACK || (ret == RETURNCODE_SUCCESS && ack_requested && !pending_tx_done_callback.acked)) {
+    // OpenThread retries at the MAC layer.
+    otPlatRadioTxDone(aInstance, &transmitFrame, NULL, OT_ERROR_NO_ACK);
+  } else if (ret == RETURNCODE_EBUSY) {
+    otPlatRadioTxDone(aInstance, &transmitFrame, NULL, OT_ERROR_CHANNEL_ACCESS_FAILURE);
+  } else if (ret != RETURNCODE_SUCCESS) {
+    otPlatRadioTxDone(aInstance, &transmitFrame, NULL, OT_ERROR_ABORT);
+  } else if (!ack_requested) {
+    otPlatRadioTxDone(aInstance, &transmitFrame, NULL, OT_ERROR_NONE);
+  } else {
+    // Without the real ACK the frame pending bit is unknown. It is set for
+    // MAC commands, which are data requests from a sleepy child, so the
+    // child keeps listening for data its parent may hold; it goes back to
+    // sleep when none arrives.
+    bool command = (transmitFrame.mPsdu[0] & FCF_FRAME_TYPE_MASK) == FCF_FRAME_TYPE_COMMAND;
+    ack_mPsdu[0] = FCF_FRAME_TYPE_ACK | (command ? FCF_FRAME_PENDING : 0);
+    ack_mPsdu[1] = 0;
+    ack_mPsdu[2] = transmitFrame.mPsdu[2];
+    ack_mPsdu[3] = 0;
+    ack_mPsdu[4] = 0;
+    otPlatRadioTxDone(aInstance, &transmitFrame, &ackFrame_radio, OT_ERROR_NONE);
+  }
+}
+
+// OpenThread scans one channel per call. The scan estimates energy from the
+// traffic heard, see libtock/net/ieee802154_scan.h.
+static struct pending_energy_scan_callback {
+  bool flag;
+  returncode_t ret;
+  libtock_ieee802154_scan_result_t result;
+} pending_energy_scan_callback = {false, RETURNCODE_FAIL, {0}};
+
+static void energy_scan_done_callback(returncode_t ret, __attribute__ ((unused)) int count) {
+  pending_energy_scan_callback.flag = true;
+  pending_energy_scan_callback.ret  = ret;
+  otSysEventSignalPending();
+}
+
+bool pending_energy_scan_callback_status(void) {
+  return pending_energy_scan_callback.flag;
+}
+
+void handle_energy_scan_done(otInstance *aInstance) {
+  if (!pending_energy_scan_callback.flag) return;
+  pending_energy_scan_callback.flag = false;
+
+  // The scan used its own receive ring; give the kernel OpenThread's again.
+  otTockResumeReceive();
+
+  int8_t rssi = OT_RADIO_RSSI_INVALID;
+  if (pending_energy_scan_callback.ret == RETURNCODE_SUCCESS) rssi = pending_energy_scan_callback.result.rssi;
+  otPlatRadioEnergyScanDone(aInstance, rssi);
 }
 
 void otPlatRadioGetIeeeEui64(otInstance *aInstance, uint8_t *aIeeeEui64) {
@@ -153,15 +216,16 @@ otError otPlatRadioTransmit(otInstance *aInstance, otRadioFrame *aFrame) {
 
   // The Tock raw 15.4 driver expects frames that do not include the MFR (aka
   // the CRC bytes). OpenThread gives us the full frame, so we just drop the
-  // final two bytes.
-  aFrame->mLength = aFrame->mLength - 2;
+  // final two bytes. The frame itself is left alone, as OpenThread sends it
+  // again on retries.
+  uint8_t length = aFrame->mLength - 2;
 
   int retCode = libtock_ieee802154_set_channel(aFrame->mChannel);
   if (retCode != RETURNCODE_SUCCESS) {
     return OT_ERROR_FAILED;
   }
 
-  returncode_t send_result =  libtock_ieee802154_send_raw((uint8_t*) aFrame->mPsdu, aFrame->mLength, tx_done_callback);
+  returncode_t send_result =  libtock_ieee802154_send_raw((uint8_t*) aFrame->mPsdu, length, tx_done_callback);
   if (send_result != RETURNCODE_SUCCESS) {
     return OT_ERROR_FAILED;
   }
@@ -184,12 +248,12 @@ int8_t otPlatRadioGetRssi(otInstance *aInstance) {
 }
 
 otRadioCaps otPlatRadioGetCaps(otInstance *aInstance) {
-  // TODO: Keeping this here as a placeholder to think
-  // more about what capabilites we want to define for openthread.
-  // Currently, we implement CSMA-CA backoff in the radio driver,
-  // but we may add the security capability.
+  // The radio driver implements CSMA-CA backoff and waits for the ACK
+  // of frames that request one, but retries are left to OpenThread.
+  // Energy scans run in the platform, so OpenThread does not sample RSSI.
   OT_UNUSED_VARIABLE(aInstance);
-  return (otRadioCaps)(OT_RADIO_CAPS_CSMA_BACKOFF | OT_RADIO_CAPS_SLEEP_TO_TX);
+  return (otRadioCaps)(OT_RADIO_CAPS_CSMA_BACKOFF | OT_RADIO_CAPS_ACK_TIMEOUT | OT_RADIO_CAPS_SLEEP_TO_TX |
+                       OT_RADIO_CAPS_ENERGY_SCAN);
 }
 
 bool otPlatRadioGetPromiscuous(otInstance *aInstance) {
@@ -259,11 +323,16 @@ void otPlatRadioClearSrcMatchExtEntries(otInstance *aInstance) {
 }
 
 otError otPlatRadioEnergyScan(otInstance *aInstance, uint8_t aScanChannel, uint16_t aScanDuration) {
-  // TODO
-  OT_UNUSED_VARIABLE(aInstance);
-  OT_UNUSED_VARIABLE(aScanChannel);
-  OT_UNUSED_VARIABLE(aScanDuration);
-  printf("%s:%d in %s\n", __FILE__, __LINE__, __func__);
+  if (!otPlatRadioIsEnabled(aInstance)) return OT_ERROR_INVALID_STATE;
+  if (aScanChannel < LIBTOCK_IEEE802154_CHANNEL_MIN || aScanChannel > LIBTOCK_IEEE802154_CHANNEL_MAX) {
+    return OT_ERROR_INVALID_ARGS;
+  }
+
+  returncode_t ret = libtock_ieee802154_energy_scan(1UL << aScanChannel, aScanDuration ? aScanDuration : 1,
+                                                    &pending_energy_scan_callback.result,
+                                                    energy_scan_done_callback);
+  if (ret == RETURNCODE_EBUSY) return OT_ERROR_BUSY;
+  if (ret != RETURNCODE_SUCCESS) return OT_ERROR_FAILED;
   return OT_ERROR_NONE;
 }
 
@@ -1,8 +1,10 @@
 #include <stdio.h>
 
 #include <openthread/instance.h>
+#include <openthread/platform/alarm-micro.h>
 #include <openthread/platform/alarm-milli.h>
 #include <openthread/platform/radio.h>
+#include <openthread/tasklet.h>
 
 #include <net/ieee802154.h>
 
@@ -21,86 +23,107 @@
 // challenging given the sync/async nature of the kernel upcalls.
 // Apps only receive upcalls when they have yielded. Conversely,
 // this means that an app will receive a pending upcall whenever
-// yield is called. This can lead to strange behavior and receiving
-// packets out of order if an app yields before completing copying
-// the packet from the buffer shared with the kernel to the buffer
-// passed to OpenThread. A ring buffer is used to handle receiving
-// and buffering multiple packets within the kernel (share ring buffer
-// with kernel). We also use a userspace ring buffer to hand the
-// aforementioned async issues. This allows the packet reception
-// for an OpenThread app to work as follows:
-//  1. App shares a kernel ring buffer with the kernel (read/write buffer).
-//  2. Kernel schedules an upcall to notify app.
-//  3. App yields allowing upcall to be handled.
-//  4. App copies data from kernel ring buffer to userspace ring buffer.
-//  5. App copies data from userspace ring buffer to OpenThread instance.
+// yield is called. OpenThread may call libtock functions that
+// yield while it is handling a received frame, so the frame must
+// not be in a buffer the kernel can write to.
 //
-// Although the userspace ring buffer may appear redundant, it is necessary
-// as OpenThread may call libtock functions that yield while OpenThread
-// possess the buffer holding the receiving packet. The use of a ring buffer
-// allows for us to prevent the receive upcall from overwriting the buffer
-// OpenThread is currently copying to the OpenThread instance (leading to packets)
-// being receiving out of order or potentially overwritten.
-
-static libtock_ieee802154_rxbuf rx_buf_a;
-static libtock_ieee802154_rxbuf rx_buf_b;
-
-#define USER_RX_BUF_FRAME_COUNT 3
-static char buf[libtock_ieee802154_FRAME_LEN * USER_RX_BUF_FRAME_COUNT];
-ring_buffer usr_rx_buffer = {
-  .buffer      = buf,
-  .write_index = 0,
-  .read_index  = 0,
-  .new         = false
-};
+// The platform therefore keeps a pool of receive rings, each of which
+// is owned by either the kernel, the filled queue or the free list:
+//  1. The app shares one ring with the kernel (read/write buffer).
+//  2. Kernel writes frames into it and schedules an upcall.
+//  3. On the upcall, the app shares a free ring with the kernel and
+//     moves the one it had to the filled queue.
+//  4. `otSysProcessDrivers` passes each frame of the filled rings to
+//     OpenThread in place and puts the emptied rings back on the free
+//     list.
+//
+// If there is no free ring when an upcall arrives, the kernel keeps
+// its ring, which holds on to the frames already in it, and it is
+// swapped out as soon as a ring is freed. The number of rings and
+// their size can be set per app with OT_TOCK_RX_RINGS and
+// OT_TOCK_RX_RING_FRAMES; each ring holds one frame fewer than its
+// size.
 
-static uint8_t rx_mPsdu[OT_RADIO_FRAME_MAX_SIZE];
-static otRadioFrame receiveFrame = {
-  .mPsdu   = rx_mPsdu,
-  .mLength = OT_RADIO_FRAME_MAX_SIZE
-};
+#ifndef OT_TOCK_RX_RINGS
+#define OT_TOCK_RX_RINGS 3
+#endif
+
+#ifndef OT_TOCK_RX_RING_FRAMES
+#define OT_TOCK_RX_RING_FRAMES 4
+#endif
+
+static uint8_t rx_storage[OT_TOCK_RX_RINGS][libtock_ieee802154_RING_BUFFER_LEN_FOR(OT_TOCK_RX_RING_FRAMES)];
+static libtock_ieee802154_ring_t rx_rings[OT_TOCK_RX_RINGS];
+
+static otRadioFrame receiveFrame;
 
 typedef struct otTock {
-  ring_buffer* usr_rx_buffer;
-  libtock_ieee802154_rxbuf* kernel_rx_buf;
+  // Ring shared with the kernel, NULL until receiving starts.
+  libtock_ieee802154_ring_t* kernel_ring;
+  // Rings the kernel has filled, oldest first.
+  libtock_ieee802154_ring_t* filled[OT_TOCK_RX_RINGS];
+  int filled_head;
+  int filled_count;
+  libtock_ieee802154_ring_t* free[OT_TOCK_RX_RINGS];
+  int free_count;
+  // The kernel ring has frames but there was no ring to swap it for.
+  bool kernel_pending;
   otInstance* instance;
 } otTock;
 
-typedef struct otTock otTock;
 otTock otTockInstance = {
-  .usr_rx_buffer = &usr_rx_buffer,
-  .kernel_rx_buf = &rx_buf_a,
-  .instance      = NULL,
+  .kernel_ring = NULL,
+  .instance    = NULL,
 };
 
-// Helper utility to provide a new ring buffer to the kernel and
-// return the ring buffer previously held by the kernel
-static libtock_ieee802154_rxbuf* swap_shared_kernel_buf(otTock* instance);
+static void ring_reset_cb(__attribute__ ((unused)) int   pans,
+                          __attribute__ ((unused)) int   dst_addr,
+                          __attribute__ ((unused)) int   src_addr,
+                          __attribute__ ((unused)) void* ud);
+
+// Helper utility to provide a free ring to the kernel and queue the
+// ring previously held by the kernel for reading.
+static void swap_shared_kernel_ring(otTock* instance) {
+  if (instance->free_count == 0) {
+    instance->kernel_pending = true;
+    libtock_ieee802154_ring_reset(instance->kernel_ring, ring_reset_cb, NULL);
+    return;
+  }
 
-static void rx_callback(__attribute__ ((unused)) int   pans,
-                        __attribute__ ((unused)) int   dst_addr,
-                        __attribute__ ((unused)) int   src_addr);
+  libtock_ieee802154_ring_t* filled = instance->kernel_ring;
+  instance->kernel_ring    = instance->free[--instance->free_count];
+  instance->kernel_pending = false;
+  libtock_ieee802154_ring_reset(instance->kernel_ring, ring_reset_cb, NULL);
+
+  int tail = (instance->filled_head + instance->filled_count) % OT_TOCK_RX_RINGS;
+  instance->filled[tail] = filled;
+  instance->filled_count++;
+}
 
 static void ring_reset_cb(__attribute__ ((unused)) int   pans,
                           __attribute__ ((unused)) int   dst_addr,
                           __attribute__ ((unused)) int   src_addr,
-			  __attribute__ ((unused)) void* ud) {
-  rx_callback(pans, dst_addr, src_addr);
+                          __attribute__ ((unused)) void* ud) {
+  /* It is important to avoid sync operations that yield (i.e. printf)
+     as this may cause a new upcall to be handled and data to be received
+     out of order and/or lost. */
+  swap_shared_kernel_ring(&otTockInstance);
+  otSysEventSignalPending();
 }
 
-static libtock_ieee802154_rxbuf* swap_shared_kernel_buf(otTock* instance) {
-  libtock_ieee802154_rxbuf* rx_buf;
+// Set when OpenThread posts a tasklet and when a driver upcall leaves
+// work for `otSysProcessDrivers`, so `otTockProcess` only does work
+// that is known to be pending and otherwise yields.
+static bool tasklets_pending = true;
+static bool events_pending   = true;
 
-  if (instance->kernel_rx_buf == &rx_buf_a) {
-    instance->kernel_rx_buf = &rx_buf_b;
-    rx_buf = &rx_buf_a;
-  } else {
-    instance->kernel_rx_buf = &rx_buf_a;
-    rx_buf = &rx_buf_b;
-  }
+void otTaskletsSignalPending(otInstance *aInstance) {
+  OT_UNUSED_VARIABLE(aInstance);
+  tasklets_pending = true;
+}
 
-  libtock_reset_ring_buf(instance->kernel_rx_buf, ring_reset_cb, NULL);
-  return rx_buf;
+void otSysEventSignalPending(void) {
+  events_pending = true;
 }
 
 void otSysInit(int argc, char *argv[]){
@@ -117,48 +140,48 @@ bool otSysPseudoResetWasRequested(void) {
 void readRingBuf(otInstance *aInstance);
 
 bool pending_rx_done_callback_status(void) {
-  return usr_rx_buffer.new;
+  return otTockInstance.filled_count > 0 || otTockInstance.kernel_pending;
 }
 
 bool openthread_platform_pending_work(void){
     return (pending_alarm_done_callback_status() || 
-            pending_tx_done_callback_status(NULL, NULL, NULL) || 
+            pending_alarm_micro_done_callback_status() ||
+            pending_tx_done_callback_status() || 
+            pending_energy_scan_callback_status() ||
             pending_rx_done_callback_status());
 }
 
 void readRingBuf(otInstance *aInstance) {
-    int offset;
-    if(usr_rx_buffer.new){
-    // loop through data until all new data is read
-    do {
-      offset = usr_rx_buffer.read_index * libtock_ieee802154_FRAME_LEN;
-      char* rx_buf       = usr_rx_buffer.buffer;
-      int header_len  = rx_buf[offset];
-      int payload_len = rx_buf[offset + 1];
-      int mic_len     = rx_buf[offset + 2];
+  otTock* instance = &otTockInstance;
+
+  while (instance->filled_count > 0) {
+    // The ring stays at the head of the queue until it is empty, so
+    // upcalls while OpenThread yields only append behind it.
+    libtock_ieee802154_ring_t* ring = instance->filled[instance->filled_head];
+    uint8_t* frame;
+    while ((frame = libtock_ieee802154_ring_read_next(ring)) != NULL) {
+      int header_len  = frame[0];
+      int payload_len = frame[1];
+      int mic_len     = frame[2];
 
       // this does not seem necessary since we implement the csma backoff in the radio driver
       // receiveFrame.mInfo.mRxInfo.mTimestamp = otPlatAlarmMilliGetNow() * 1000;
       receiveFrame.mInfo.mRxInfo.mRssi      = 50;
+      receiveFrame.mPsdu   = &frame[libtock_ieee802154_FRAME_META_LEN];
       receiveFrame.mLength = payload_len + header_len + mic_len + 2;
       receiveFrame.mInfo.mRxInfo.mTimestamp = 0;
       receiveFrame.mInfo.mRxInfo.mLqi       = 0x7f;
 
-      // copy data
-      for (int i = 0; i < (receiveFrame.mLength + libtock_ieee802154_FRAME_META_LEN); i++) {
-        receiveFrame.mPsdu[i] = rx_buf[i + libtock_ieee802154_FRAME_META_LEN + offset];
-      }
-
       // notify openthread instance that a frame has been received
       otPlatRadioReceiveDone(aInstance, &receiveFrame, OT_ERROR_NONE);
-      usr_rx_buffer.read_index++;
-      if (usr_rx_buffer.read_index == USER_RX_BUF_FRAME_COUNT) {
-        usr_rx_buffer.read_index = 0;
-      }
-    } while (usr_rx_buffer.read_index != usr_rx_buffer.write_index);
-    
-    usr_rx_buffer.new = false;  
-    } 
+    }
+
+    instance->filled_head = (instance->filled_head + 1) % OT_TOCK_RX_RINGS;
+    instance->filled_count--;
+    instance->free[instance->free_count++] = ring;
+
+    if (instance->kernel_pending) swap_shared_kernel_ring(instance);
+  }
 }
 
 void otSysProcessDrivers(otInstance *aInstance){
@@ -170,63 +193,14 @@ void otSysProcessDrivers(otInstance *aInstance){
     otPlatAlarmMilliFired(aInstance);
   }
 
-  otRadioFrame ackFrame;
-  otRadioFrame txFrame;
-  returncode_t status;
-
-  if (pending_tx_done_callback_status(&ackFrame, &status, &txFrame)) {
-    reset_pending_tx_done_callback();
-
-    if (status == RETURNCODE_SUCCESS) otPlatRadioTxDone(aInstance, &txFrame, &ackFrame, OT_ERROR_NONE);
-    else otPlatRadioTxDone(aInstance, &txFrame, &ackFrame, OT_ERROR_ABORT);
+  if (pending_alarm_micro_done_callback_status()) {
+    reset_pending_alarm_micro_done_callback();
+    otPlatAlarmMicroFired(aInstance);
   }
 
-}
-
-
-static void rx_callback(__attribute__ ((unused)) int   pans,
-                        __attribute__ ((unused)) int   dst_addr,
-                        __attribute__ ((unused)) int   src_addr) {
-
-  /* It is important to avoid sync operations that yield (i.e. printf)
-     as this may cause a new upcall to be handled and data to be received
-     out of order and/or lost. */
-  uint8_t* rx_buf = swap_shared_kernel_buf(&otTockInstance)[0];
-
-  uint8_t* head_index = &rx_buf[0];
-  uint8_t* tail_index = &rx_buf[1];
-
-  int offset = 2 + *head_index * libtock_ieee802154_FRAME_LEN;
+  handle_tx_done(aInstance);
 
-  // | head active # | tail active # | frame 0 | frame 1 | ... | frame n |
-  while (*head_index != *tail_index) {
-    int header_len = rx_buf[offset];
-    int payload_len = rx_buf[offset + 1];
-    int mic_len        = rx_buf[offset + 2];
-
-    int receive_frame_length = payload_len + header_len + mic_len;
-    int ring_buffer_offset = usr_rx_buffer.write_index * libtock_ieee802154_FRAME_LEN;
-
-    for (int i = 0; i < (libtock_ieee802154_FRAME_META_LEN + receive_frame_length); i++) {
-      usr_rx_buffer.buffer[ring_buffer_offset + i] = rx_buf[i + offset];
-      rx_buf[i + offset] = 0;
-    }
-
-    usr_rx_buffer.new = true;
-    usr_rx_buffer.write_index++;
-    if (usr_rx_buffer.write_index == USER_RX_BUF_FRAME_COUNT) {
-      usr_rx_buffer.write_index = 0;
-    }
-
-    *head_index = (*head_index + 1) % libtock_ieee802154_MAX_RING_BUF_FRAMES;
-    offset     += libtock_ieee802154_FRAME_LEN;
-
-    if (*head_index == 0) {
-      offset = 2;
-    }
-  }
-
-  assert(*head_index == *tail_index);
+  handle_energy_scan_done(aInstance);
 
 }
 
@@ -239,9 +213,46 @@ otError otTockStartReceive(uint8_t aChannel, otInstance *aInstance) {
     return OT_ERROR_NOT_IMPLEMENTED;
   }
 
-  int res = libtock_ieee802154_receive(otTockInstance.kernel_rx_buf, rx_callback);
+  if (otTockInstance.kernel_ring == NULL) {
+    for (int i = 0; i < OT_TOCK_RX_RINGS; i++) {
+      libtock_ieee802154_ring_init(&rx_rings[i], rx_storage[i], sizeof(rx_storage[i]));
+      if (i > 0) otTockInstance.free[otTockInstance.free_count++] = &rx_rings[i];
+    }
+    otTockInstance.kernel_ring = &rx_rings[0];
+  }
+
+  int res = libtock_ieee802154_ring_reset(otTockInstance.kernel_ring, ring_reset_cb, NULL);
 
   if (res != RETURNCODE_SUCCESS) return OT_ERROR_FAILED;
 
   return OT_ERROR_NONE;
 }
+
+void otTockResumeReceive(void) {
+  if (otTockInstance.kernel_ring == NULL) return;
+  libtock_ieee802154_ring_reset(otTockInstance.kernel_ring, ring_reset_cb, NULL);
+}
+
+void otTockProcess(otInstance *aInstance) {
+  // The flags are cleared first, so work signalled while OpenThread
+  // runs (it may yield) is picked up on the next call.
+  if (tasklets_pending) {
+    tasklets_pending = false;
+    otTaskletsProcess(aInstance);
+  }
+
+  if (events_pending) {
+    events_pending = false;
+    otSysProcessDrivers(aInstance);
+  }
+
+  if (!tasklets_pending && !events_pending) {
+    yield();
+  }
+}
+
+void otTockRun(otInstance *aInstance) {
+  for ( ;;) {
+    otTockProcess(aInstance);
+  }
+}
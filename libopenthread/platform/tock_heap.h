@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "openthread-core-tock-config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// OpenThread's heap, in a static arena.
+//
+// The Tock config sets `OPENTHREAD_CONFIG_HEAP_EXTERNAL_ENABLE`, so OpenThread
+// and mbedTLS allocate through `otPlatCAlloc()` and `otPlatFree()`, and with
+// `OPENTHREAD_CONFIG_MESSAGE_USE_HEAP_ENABLE` message buffers come from there
+// too. Both are served from an arena of `OT_TOCK_HEAP_SIZE` bytes in .bss, so
+// Thread's memory is fixed when the app is linked: it never competes with the
+// app's `malloc()`, and the app's allocations cannot fragment it.
+//
+// The arena is a first-fit free list in address order that merges neighbours
+// on free. `otTockHeapGetUsage()` reports how full it has been, for sizing
+// `OT_TOCK_HEAP_SIZE` to a deployment.
+
+// Bytes each allocation spends on its header and alignment, at most.
+#define OT_TOCK_HEAP_BLOCK_OVERHEAD 16
+
+// Room for every message buffer and for mbedTLS's working memory. Apps
+// that run DTLS sessions alongside heavy traffic may need more.
+#ifndef OT_TOCK_HEAP_SIZE
+#define OT_TOCK_HEAP_SIZE \
+  (OPENTHREAD_CONFIG_NUM_MESSAGE_BUFFERS * (OPENTHREAD_CONFIG_MESSAGE_BUFFER_SIZE + OT_TOCK_HEAP_BLOCK_OVERHEAD) \
+   + OPENTHREAD_CONFIG_HEAP_INTERNAL_SIZE)
+#endif
+
+typedef struct {
+  // Bytes in the arena, allocated now including headers, and allocated at
+  // most.
+  uint32_t mTotal;
+  uint32_t mUsed;
+  uint32_t mPeak;
+  // Largest allocation that would succeed now.
+  uint32_t mLargestFree;
+  // Allocations now live, and allocations that found no free block large
+  // enough.
+  uint32_t mBlocks;
+  uint32_t mFailures;
+} otTockHeapUsage;
+
+void otTockHeapGetUsage(otTockHeapUsage *aUsage);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,129 @@
+#include <string.h>
+
+#include "tock_tcp.h"
+
+static otTockTcp *stream_of(otTcpEndpoint *aEndpoint) {
+  return (otTockTcp *) otTcpEndpointGetContext(aEndpoint);
+}
+
+// Deinitialize the endpoint, which cannot be done from its own callbacks.
+static void release(otTockTcp *aStream) {
+  aStream->mOpen  = false;
+  aStream->mCount = 0;
+  if (!aStream->mInitialized) return;
+  aStream->mInitialized = false;
+  otTcpEndpointDeinitialize(&aStream->mEndpoint);
+}
+
+static void established(otTcpEndpoint *aEndpoint) {
+  otTockTcp *stream = stream_of(aEndpoint);
+  if (stream->mCallbacks->connected != NULL) stream->mCallbacks->connected(stream);
+}
+
+static void send_done(otTcpEndpoint *aEndpoint, otLinkedBuffer *aData) {
+  otTockTcp *stream = stream_of(aEndpoint);
+
+  // tcplp hands chunks back in the order they were sent, so `aData` is the
+  // oldest link.
+  const uint8_t *data = aData->mData;
+  size_t length       = aData->mLength;
+  stream->mFirst = (uint8_t) ((stream->mFirst + 1) % OT_TOCK_TCP_MAX_CHUNKS);
+  stream->mCount--;
+
+  if (stream->mCallbacks->sent != NULL) stream->mCallbacks->sent(stream, data, length);
+}
+
+static void receive_available(otTcpEndpoint *aEndpoint, size_t aBytesAvailable, bool aEndOfStream,
+                              size_t aBytesRemaining) {
+  otTockTcp *stream = stream_of(aEndpoint);
+  (void) aBytesRemaining;
+  if (aBytesAvailable == 0 && !aEndOfStream) return;
+
+  // The receive buffer is a ring, so the data is in at most two pieces.
+  const otLinkedBuffer *data = NULL;
+  size_t total = 0;
+  if (otTcpReceiveByReference(aEndpoint, &data) == OT_ERROR_NONE) {
+    for (const otLinkedBuffer *piece = data; piece != NULL; piece = piece->mNext) {
+      bool last = piece->mNext == NULL;
+      if (stream->mCallbacks->received != NULL) {
+        stream->mCallbacks->received(stream, piece->mData, piece->mLength, last && aEndOfStream);
+      }
+      total += piece->mLength;
+    }
+  }
+  if (total == 0 && aEndOfStream && stream->mCallbacks->received != NULL) {
+    stream->mCallbacks->received(stream, NULL, 0, true);
+  }
+  if (total > 0) otTcpCommitReceive(aEndpoint, total, 0);
+}
+
+static void disconnected(otTcpEndpoint *aEndpoint, otTcpDisconnectedReason aReason) {
+  otTockTcp *stream = stream_of(aEndpoint);
+  // The endpoint is released by the next connect or abort.
+  stream->mOpen  = false;
+  stream->mCount = 0;
+  if (stream->mCallbacks->closed != NULL) stream->mCallbacks->closed(stream, aReason);
+}
+
+otError otTockTcpConnect(otTockTcp *aStream, otInstance *aInstance, const otSockAddr *aPeer,
+                         uint8_t *aReceiveBuffer, size_t aReceiveLength, const otTockTcpCallbacks *aCallbacks,
+                         void *aContext) {
+  if (aStream->mOpen) return OT_ERROR_ALREADY;
+  release(aStream);
+
+  otTcpEndpointInitializeArgs args;
+  memset(&args, 0, sizeof(args));
+  args.mContext                  = aStream;
+  args.mEstablishedCallback      = established;
+  args.mSendDoneCallback         = send_done;
+  args.mReceiveAvailableCallback = receive_available;
+  args.mDisconnectedCallback     = disconnected;
+  args.mReceiveBuffer            = aReceiveBuffer;
+  args.mReceiveBufferSize        = aReceiveLength;
+
+  aStream->mCallbacks = aCallbacks;
+  aStream->mContext   = aContext;
+  aStream->mFirst     = 0;
+  aStream->mCount     = 0;
+
+  otError error = otTcpEndpointInitialize(aInstance, &aStream->mEndpoint, &args);
+  if (error != OT_ERROR_NONE) return error;
+  aStream->mInitialized = true;
+  aStream->mOpen        = true;
+
+  error = otTcpConnect(&aStream->mEndpoint, aPeer, OT_TCP_CONNECT_NO_FAST_OPEN);
+  if (error != OT_ERROR_NONE) release(aStream);
+  return error;
+}
+
+otError otTockTcpSend(otTockTcp *aStream, const uint8_t *aData, size_t aLength, bool aMoreToCome) {
+  if (!aStream->mOpen) return OT_ERROR_INVALID_STATE;
+  if (aStream->mCount == OT_TOCK_TCP_MAX_CHUNKS) return OT_ERROR_NO_BUFS;
+
+  otLinkedBuffer *link = &aStream->mLinks[(aStream->mFirst + aStream->mCount) % OT_TOCK_TCP_MAX_CHUNKS];
+  link->mNext   = NULL;
+  link->mData   = aData;
+  link->mLength = aLength;
+
+  otError error = otTcpSendByReference(&aStream->mEndpoint, link, aMoreToCome ? OT_TCP_SEND_MORE_TO_COME : 0);
+  if (error == OT_ERROR_NONE) aStream->mCount++;
+  return error;
+}
+
+size_t otTockTcpFreeChunks(const otTockTcp *aStream) {
+  return aStream->mOpen ? OT_TOCK_TCP_MAX_CHUNKS - aStream->mCount : 0;
+}
+
+otError otTockTcpShutdown(otTockTcp *aStream) {
+  if (!aStream->mOpen) return OT_ERROR_INVALID_STATE;
+  return otTcpSendEndOfStream(&aStream->mEndpoint);
+}
+
+void otTockTcpAbort(otTockTcp *aStream) {
+  if (aStream->mOpen) otTcpAbort(&aStream->mEndpoint);
+  release(aStream);
+}
+
+void *otTockTcpGetContext(const otTockTcp *aStream) {
+  return aStream->mContext;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <openthread/tcp.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// TCP streams for bulk transfers over Thread, such as firmware or log
+// uploads.
+//
+// The stream sends from the app's own buffers: `otTockTcpSend()` links a
+// chunk into tcplp's send buffer by reference, without copying it, and the
+// `sent` callback hands the chunk back once the peer has acknowledged all of
+// it. An app streams a large upload by refilling a few chunks in turn as they
+// come back, so the window stays full while no copy of the data is made.
+//
+// Received data stays in the app's receive buffer, which is also the
+// receive window: it is delivered in place and released when the `received`
+// callback returns. A buffer of at least
+// `OT_TCP_RECEIVE_BUFFER_SIZE_FEW_HOPS` bytes keeps a single hop link busy;
+// `OT_TCP_RECEIVE_BUFFER_SIZE_MANY_HOPS` is needed across several hops.
+//
+// The callbacks run from `otTaskletsProcess()` in the OpenThread main loop.
+
+// Chunks that can be in the send buffer at once.
+#ifndef OT_TOCK_TCP_MAX_CHUNKS
+#define OT_TOCK_TCP_MAX_CHUNKS 4
+#endif
+
+typedef struct otTockTcp otTockTcp;
+
+typedef struct {
+  // The connection is open and sends may start. May be NULL.
+  void (*connected)(otTockTcp *aStream);
+  // The peer acknowledged all of the chunk at `aData`, which the app may
+  // reuse. May be NULL.
+  void (*sent)(otTockTcp *aStream, const uint8_t *aData, size_t aLength);
+  // `aLength` bytes arrived at `aData`, which is only valid during the
+  // callback. `aEnd` is set once the peer has finished sending. May be NULL,
+  // which discards received data.
+  void (*received)(otTockTcp *aStream, const uint8_t *aData, size_t aLength, bool aEnd);
+  // The connection is gone. Chunks not yet acknowledged are not handed
+  // back, and may be reused.
+  void (*closed)(otTockTcp *aStream, otTcpDisconnectedReason aReason);
+} otTockTcpCallbacks;
+
+struct otTockTcp {
+  otTcpEndpoint mEndpoint;
+  const otTockTcpCallbacks *mCallbacks;
+  void *mContext;
+  // Links of the chunks in the send buffer, in order, as a ring.
+  otLinkedBuffer mLinks[OT_TOCK_TCP_MAX_CHUNKS];
+  uint8_t mFirst;
+  uint8_t mCount;
+  // Whether the endpoint is initialized, and whether it can send.
+  bool mInitialized;
+  bool mOpen;
+};
+
+// Connect to `aPeer`, receiving into the `aReceiveLength` bytes at
+// `aReceiveBuffer`, which must stay valid until the stream is closed.
+// `aContext` is returned by `otTockTcpGetContext()`. A new `aStream` must be
+// zeroed; one that closed is reused as it is.
+otError otTockTcpConnect(otTockTcp *aStream, otInstance *aInstance, const otSockAddr *aPeer,
+                         uint8_t *aReceiveBuffer, size_t aReceiveLength, const otTockTcpCallbacks *aCallbacks,
+                         void *aContext);
+
+// Queue the `aLength` bytes at `aData` for sending, without copying them.
+// They must not change until the `sent` callback returns them. Set
+// `aMoreToCome` when another chunk follows right away, so a partial segment
+// waits for it instead of going out alone.
+//
+// Returns OT_ERROR_NO_BUFS if `OT_TOCK_TCP_MAX_CHUNKS` chunks are in the send
+// buffer, and OT_ERROR_INVALID_STATE if the stream is not open.
+otError otTockTcpSend(otTockTcp *aStream, const uint8_t *aData, size_t aLength, bool aMoreToCome);
+
+// Number of chunks `otTockTcpSend()` would accept now.
+size_t otTockTcpFreeChunks(const otTockTcp *aStream);
+
+// Finish sending. The peer is told once every queued chunk has been sent;
+// receiving continues until the peer closes too.
+otError otTockTcpShutdown(otTockTcp *aStream);
+
+// Reset the connection and release the stream at once. No callback follows.
+// Also releases a stream that the peer closed.
+void otTockTcpAbort(otTockTcp *aStream);
+
+void *otTockTcpGetContext(const otTockTcp *aStream);
+
+#ifdef __cplusplus
+}
+#endif
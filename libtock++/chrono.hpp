@@ -0,0 +1,208 @@
+// `std::chrono` clock and timer backed by the alarm driver.
+//
+// `libtock::steady_clock` is a `TrivialClock` over `libtock_time_now_ticks64()`
+// with microsecond durations, so C++ code can use the standard duration types
+// instead of converting ticks by hand:
+//
+//     using namespace std::chrono_literals;
+//
+//     auto start = libtock::steady_clock::now();
+//     do_work();
+//     auto took = libtock::steady_clock::now() - start;
+//     printf("%lld us\n", took.count());
+//
+// `libtock::Timer` runs a callback after a duration or at a time point. It
+// wraps a `libtock_alarm_t` in the alarm service's queue, so any number of
+// timers share the one kernel alarm and none of them allocate:
+//
+//     static void blink(void*) {
+//       libtock_led_toggle(0);
+//       timer.start(500ms, blink, nullptr);
+//     }
+//
+// The tick rate is read from the kernel on first use. Conversions between
+// ticks and microseconds then use precomputed fixed-point ratios, the same way
+// `libtock/services/alarm.c` converts milliseconds, without any division.
+//
+// Apps must build with `-std=c++17` or later.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <libtock/services/alarm.h>
+#include <libtock/services/time.h>
+#include <libtock/tock.h>
+
+namespace libtock {
+
+namespace detail {
+
+// The ratio `num / den` in 32.32 fixed point, for scaling without dividing.
+struct Ratio {
+  uint32_t num      = 0;
+  uint32_t den      = 1;
+  uint32_t integer  = 0;
+  uint32_t fraction = 0;
+
+  constexpr Ratio() = default;
+  constexpr Ratio(uint32_t n, uint32_t d) :
+    num(n), den(d), integer(n / d),
+    fraction(static_cast<uint32_t>((static_cast<uint64_t>(n % d) << 32) / d)) {}
+
+  // floor(value * num / den), exactly.
+  constexpr uint64_t scale(uint32_t value) const {
+    uint64_t result = static_cast<uint64_t>(value) * integer + ((static_cast<uint64_t>(value) * fraction) >> 32);
+    // The truncated fraction can leave the result one short.
+    if ((result + 1) * den <= static_cast<uint64_t>(value) * num) {
+      result++;
+    }
+    return result;
+  }
+
+  // ceil(value * num / den), exactly.
+  constexpr uint64_t scale_up(uint32_t value) const {
+    uint64_t result = scale(value);
+    if (result * den < static_cast<uint64_t>(value) * num) {
+      result++;
+    }
+    return result;
+  }
+};
+
+struct ClockRates {
+  uint32_t frequency = 0;
+  Ratio ticks_to_us;
+  Ratio us_to_ticks;
+  // 2^32 ticks in microseconds, in 64.32 fixed point.
+  uint64_t wrap_us      = 0;
+  uint32_t wrap_us_frac = 0;
+};
+
+inline ClockRates clock_rates;
+
+inline const ClockRates& rates() {
+  if (clock_rates.frequency == 0) {
+    uint32_t f = libtock_time_frequency();
+    constexpr uint64_t us_per_wrap = 1000000ull << 32;
+    clock_rates.ticks_to_us  = Ratio(1000000, f);
+    clock_rates.us_to_ticks  = Ratio(f, 1000000);
+    clock_rates.wrap_us      = us_per_wrap / f;
+    clock_rates.wrap_us_frac = static_cast<uint32_t>(((us_per_wrap % f) << 32) / f);
+    clock_rates.frequency    = f;
+  }
+  return clock_rates;
+}
+
+}  // namespace detail
+
+// Monotonic clock counting microseconds since the alarm counter started.
+struct steady_clock final {
+  using rep        = int64_t;
+  using period     = std::micro;
+  using duration   = std::chrono::duration<rep, period>;
+  using time_point = std::chrono::time_point<steady_clock>;
+
+  static constexpr bool is_steady = true;
+
+  static time_point now() {
+    return time_point(from_ticks(libtock_time_now_ticks64()));
+  }
+
+  // Frequency of the underlying tick counter in Hz.
+  static uint32_t frequency() {
+    return detail::rates().frequency;
+  }
+
+  // Time covered by `ticks` ticks, rounded down. It is exact within the first
+  // 2^32 ticks and at most 1 us short after that, and never decreases as
+  // `ticks` grows.
+  static duration from_ticks(uint64_t ticks) {
+    const detail::ClockRates& r = detail::rates();
+    uint32_t high = static_cast<uint32_t>(ticks >> 32);
+    uint64_t us   = r.ticks_to_us.scale(static_cast<uint32_t>(ticks));
+    if (high != 0) {
+      us += high * r.wrap_us + ((static_cast<uint64_t>(high) * r.wrap_us_frac) >> 32);
+    }
+    return duration(static_cast<rep>(us));
+  }
+
+  // Ticks needed to cover at least `d`, for durations of up to 2^32 - 1 us.
+  // Negative durations are 0 ticks.
+  static uint64_t to_ticks(duration d) {
+    if (d.count() <= 0) return 0;
+    return detail::rates().us_to_ticks.scale_up(static_cast<uint32_t>(d.count()));
+  }
+};
+
+// A one-shot timer in the alarm queue.
+//
+// The timer must stay alive and in place while it is armed, and is cancelled
+// when destroyed. The callback runs from the alarm upcall, like other alarm
+// callbacks, and may restart the timer.
+class Timer final {
+ public:
+  using callback = void (*)(void* context);
+
+  Timer() = default;
+  Timer(const Timer&)            = delete;
+  Timer& operator=(const Timer&) = delete;
+
+  ~Timer() {
+    cancel();
+  }
+
+  // Run `cb` once `d` has passed, replacing any pending expiration. Delays the
+  // tick counter cannot cover in one alarm fall back to millisecond alarms.
+  returncode_t start(steady_clock::duration d, callback cb, void* context) {
+    cancel();
+    cb_      = cb;
+    context_ = context;
+
+    int ret;
+    if (d.count() > static_cast<steady_clock::rep>(UINT32_MAX) || steady_clock::to_ticks(d) > UINT32_MAX) {
+      auto ms = std::chrono::ceil<std::chrono::milliseconds>(d).count();
+      ret = libtock_alarm_in_ms(ms > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(ms), fired, this, &alarm_);
+    } else {
+      uint32_t now;
+      ret = libtock_alarm_command_read(&now);
+      if (ret == RETURNCODE_SUCCESS) {
+        ret = libtock_alarm_at(now, static_cast<uint32_t>(steady_clock::to_ticks(d)), fired, this, &alarm_.alarm);
+      }
+    }
+    armed_ = ret == RETURNCODE_SUCCESS;
+    return static_cast<returncode_t>(ret);
+  }
+
+  // Run `cb` at `when`, or as soon as possible if it has passed.
+  returncode_t start_at(steady_clock::time_point when, callback cb, void* context) {
+    return start(when - steady_clock::now(), cb, context);
+  }
+
+  void cancel() {
+    if (armed_) {
+      libtock_alarm_ms_cancel(&alarm_);
+      armed_ = false;
+    }
+  }
+
+  // True from `start()` until the callback runs or the timer is cancelled.
+  bool armed() const {
+    return armed_;
+  }
+
+ private:
+  static void fired(uint32_t, uint32_t, void* opaque) {
+    Timer* timer  = static_cast<Timer*>(opaque);
+    timer->armed_ = false;
+    timer->cb_(timer->context_);
+  }
+
+  libtock_alarm_t alarm_ = {};
+  callback cb_           = nullptr;
+  void* context_         = nullptr;
+  bool armed_            = false;
+};
+
+}  // namespace libtock
@@ -0,0 +1,208 @@
+// Typed C++20 access to Tock system calls.
+//
+// A thin layer over the system calls in `tock.h` for apps that talk to a
+// driver directly. Driver, command, subscribe and allow numbers are template
+// arguments, so every call compiles down to the same code as the equivalent
+// `libtock_*_command_*()` wrapper, without the wrapper function:
+//
+//     using Console = libtock::Driver<DRIVER_NUM_CONSOLE>;
+//
+//     std::array<uint8_t, 5> msg = {'h', 'e', 'l', 'l', 'o'};
+//     {
+//       libtock::ReadOnlyAllow<Console, 1> allow(std::span{msg});
+//       if (!allow) return allow.status();
+//       returncode_t ret = Console::command<1>(msg.size());
+//       ...
+//     }  // Un-allowed here.
+//
+// Command results carry their value and return code together:
+//
+//     auto count = libtock::Driver<DRIVER_NUM_LED>::command_u32<0>();
+//     if (count) printf("%lu LEDs\n", *count);
+//
+// Allow guards share a buffer for their lifetime and un-allow it when they go
+// out of scope. They go through `allow_readonly()`/`allow_readwrite()`, so a
+// slot made persistent with `Driver::set_persistent_ro()` or
+// `set_persistent_rw()` costs no system call to re-share the buffer that is
+// already shared, or to un-allow it.
+//
+// Apps must build with `-std=c++20`.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include <libtock/tock.h>
+
+namespace libtock {
+
+// Map a kernel status code to a `returncode_t`.
+constexpr returncode_t to_returncode(statuscode_t status) noexcept {
+  // ReturnCode numeric mappings are -1*ErrorCode, and success is 0 in both.
+  return static_cast<returncode_t>(-static_cast<int>(status));
+}
+
+// A `returncode_t` with the value of a successful call.
+//
+// Converts to true on success, and `*` reads the value, which is
+// value-initialized after a failure.
+template <typename T>
+struct Result {
+  returncode_t ret;
+  T value;
+
+  constexpr bool ok() const noexcept {
+    return ret == RETURNCODE_SUCCESS;
+  }
+  constexpr explicit operator bool() const noexcept {
+    return ok();
+  }
+  constexpr const T& operator*() const noexcept {
+    return value;
+  }
+};
+
+namespace detail {
+
+// The failure variant stores its status code in the first data word.
+constexpr returncode_t failure(const syscall_return_t& r) noexcept {
+  return r.type == TOCK_SYSCALL_FAILURE ? to_returncode(static_cast<statuscode_t>(r.data[0])) : RETURNCODE_EBADRVAL;
+}
+
+}  // namespace detail
+
+// Convert a command return without a value, like
+// `tock_command_return_novalue_to_returncode()`.
+constexpr returncode_t to_returncode(const syscall_return_t& r) noexcept {
+  return r.type == TOCK_SYSCALL_SUCCESS ? RETURNCODE_SUCCESS : detail::failure(r);
+}
+
+// Convert a command return carrying one 32-bit value.
+constexpr Result<uint32_t> to_result_u32(const syscall_return_t& r) noexcept {
+  if (r.type == TOCK_SYSCALL_SUCCESS_U32) return {RETURNCODE_SUCCESS, r.data[0]};
+  return {detail::failure(r), 0};
+}
+
+// Convert a command return carrying one 64-bit value.
+constexpr Result<uint64_t> to_result_u64(const syscall_return_t& r) noexcept {
+  if (r.type == TOCK_SYSCALL_SUCCESS_U64) {
+    return {RETURNCODE_SUCCESS, (static_cast<uint64_t>(r.data[1]) << 32) | r.data[0]};
+  }
+  return {detail::failure(r), 0};
+}
+
+// A kernel driver, identified by its number.
+template <uint32_t Num>
+struct Driver final {
+  static constexpr uint32_t number = Num;
+
+  static bool exists() {
+    return driver_exists(Num);
+  }
+
+  // Run command `Cmd`, which returns no value.
+  template <uint32_t Cmd>
+  static returncode_t command(int arg1 = 0, int arg2 = 0) {
+    return to_returncode(::command(Num, Cmd, arg1, arg2));
+  }
+
+  // Run command `Cmd`, which returns a 32-bit value.
+  template <uint32_t Cmd>
+  static Result<uint32_t> command_u32(int arg1 = 0, int arg2 = 0) {
+    return to_result_u32(::command(Num, Cmd, arg1, arg2));
+  }
+
+  // Run command `Cmd`, which returns a 64-bit value.
+  template <uint32_t Cmd>
+  static Result<uint64_t> command_u64(int arg1 = 0, int arg2 = 0) {
+    return to_result_u64(::command(Num, Cmd, arg1, arg2));
+  }
+
+  // Set the upcall for subscribe number `Sub`. Passing nullptr unsubscribes.
+  template <uint32_t Sub>
+  static returncode_t subscribe(subscribe_upcall* cb, void* userdata = nullptr) {
+    subscribe_return_t r = ::subscribe(Num, Sub, cb, userdata);
+    return r.success ? RETURNCODE_SUCCESS : to_returncode(r.status);
+  }
+
+  // Mark read-only or read-write allow `Allow` as persistent, see
+  // `tock_allow_readonly_set_persistent()`.
+  template <uint32_t Allow>
+  static returncode_t set_persistent_ro(bool persistent = true) {
+    return tock_allow_readonly_set_persistent(Num, Allow, persistent);
+  }
+  template <uint32_t Allow>
+  static returncode_t set_persistent_rw(bool persistent = true) {
+    return tock_allow_readwrite_set_persistent(Num, Allow, persistent);
+  }
+};
+
+// Shares a read-only buffer with read-only allow `Allow` of driver `D` while
+// in scope.
+template <typename D, uint32_t Allow>
+class [[nodiscard]] ReadOnlyAllow final {
+ public:
+  template <typename T, std::size_t N>
+  explicit ReadOnlyAllow(std::span<T, N> buffer) {
+    static_assert(std::is_trivially_copyable_v<T>, "the kernel reads the buffer as bytes");
+    allow_ro_return_t r = allow_readonly(D::number, Allow, buffer.data(), buffer.size_bytes());
+    status_ = r.success ? RETURNCODE_SUCCESS : to_returncode(r.status);
+  }
+
+  ReadOnlyAllow(const ReadOnlyAllow&)            = delete;
+  ReadOnlyAllow& operator=(const ReadOnlyAllow&) = delete;
+
+  ~ReadOnlyAllow() {
+    if (status_ == RETURNCODE_SUCCESS) {
+      [[maybe_unused]] allow_ro_return_t r = allow_readonly(D::number, Allow, nullptr, 0);
+    }
+  }
+
+  returncode_t status() const noexcept {
+    return status_;
+  }
+  explicit operator bool() const noexcept {
+    return status_ == RETURNCODE_SUCCESS;
+  }
+
+ private:
+  returncode_t status_;
+};
+
+// Shares a writable buffer with read-write allow `Allow` of driver `D` while
+// in scope.
+template <typename D, uint32_t Allow>
+class [[nodiscard]] ReadWriteAllow final {
+ public:
+  template <typename T, std::size_t N>
+  explicit ReadWriteAllow(std::span<T, N> buffer) {
+    static_assert(std::is_trivially_copyable_v<T>, "the kernel writes the buffer as bytes");
+    static_assert(!std::is_const_v<T>, "the kernel writes to read-write allows");
+    allow_rw_return_t r = allow_readwrite(D::number, Allow, buffer.data(), buffer.size_bytes());
+    status_ = r.success ? RETURNCODE_SUCCESS : to_returncode(r.status);
+  }
+
+  ReadWriteAllow(const ReadWriteAllow&)            = delete;
+  ReadWriteAllow& operator=(const ReadWriteAllow&) = delete;
+
+  ~ReadWriteAllow() {
+    if (status_ == RETURNCODE_SUCCESS) {
+      [[maybe_unused]] allow_rw_return_t r = allow_readwrite(D::number, Allow, nullptr, 0);
+    }
+  }
+
+  returncode_t status() const noexcept {
+    return status_;
+  }
+  explicit operator bool() const noexcept {
+    return status_ == RETURNCODE_SUCCESS;
+  }
+
+ private:
+  returncode_t status_;
+};
+
+}  // namespace libtock
@@ -0,0 +1,434 @@
+// C++20 coroutine adapters for the libtock async APIs.
+//
+// This header lets an app write sequential-looking code over the callback
+// based `libtock_*` drivers:
+//
+//     libtock::Task<> blink() {
+//       while (true) {
+//         libtock_led_toggle(0);
+//         co_await libtock::alarm_ms(500);
+//       }
+//     }
+//
+//     libtock::Task<> echo() {
+//       uint8_t c;
+//       while (true) {
+//         auto r = co_await libtock::console_read(&c, 1);
+//         if (r.ret == RETURNCODE_SUCCESS) co_await libtock::console_write(&c, 1);
+//       }
+//     }
+//
+//     int main() {
+//       auto a = blink();
+//       auto b = echo();
+//       libtock::run(a, b);
+//     }
+//
+// Tasks run on a single-threaded executor driven by `yield()`. A task that
+// awaits an operation is suspended until the operation's callback fires, and
+// other tasks keep running in the meantime.
+//
+// Awaiting a driver operation does not allocate: the awaitable, including any
+// callback state, lives in the awaiting coroutine's frame. Calling a `Task`
+// coroutine allocates its frame once with `operator new`.
+//
+// Drivers whose callbacks carry no user pointer (console, ADC, UDP) support
+// only one outstanding await per operation type, which matches the kernel
+// drivers allowing one operation per process at a time.
+//
+// Apps must build with `-std=c++20` (and `-fcoroutines` on GCC 10).
+
+#pragma once
+
+#include <coroutine>
+#include <cstdlib>
+#include <optional>
+#include <utility>
+
+#include <libtock/interface/console.h>
+#include <libtock/net/udp.h>
+#include <libtock/peripherals/adc.h>
+#include <libtock/services/alarm.h>
+#include <libtock/tock.h>
+
+namespace libtock {
+
+namespace detail {
+
+// A suspended coroutine waiting to be resumed by the executor. Instances are
+// embedded in awaitables so queueing never allocates.
+struct Waiter {
+  std::coroutine_handle<> handle;
+  Waiter* next = nullptr;
+};
+
+// Coroutines made ready by callbacks, resumed in FIFO order by `run()`.
+inline Waiter* ready_head = nullptr;
+inline Waiter* ready_tail = nullptr;
+
+// Called from driver callbacks. The coroutine is resumed later from `run()`,
+// not from inside the upcall.
+inline void make_ready(Waiter* waiter) {
+  waiter->next = nullptr;
+  if (ready_tail == nullptr) {
+    ready_head = waiter;
+  } else {
+    ready_tail->next = waiter;
+  }
+  ready_tail = waiter;
+}
+
+// Resume every ready coroutine, including ones made ready while draining.
+inline void drain_ready() {
+  while (ready_head != nullptr) {
+    Waiter* waiter = ready_head;
+    ready_head = waiter->next;
+    if (ready_head == nullptr) {
+      ready_tail = nullptr;
+    }
+    waiter->handle.resume();
+  }
+}
+
+// Resumes the awaiting coroutine (if any) once a task finishes.
+struct FinalAwaiter {
+  std::coroutine_handle<> continuation;
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<>) const noexcept {
+    return continuation ? continuation : std::noop_coroutine();
+  }
+  void await_resume() const noexcept {}
+};
+
+struct PromiseBase {
+  std::coroutine_handle<> continuation;
+
+  std::suspend_always initial_suspend() const noexcept {
+    return {};
+  }
+  FinalAwaiter final_suspend() const noexcept {
+    return {continuation};
+  }
+  void unhandled_exception() const noexcept {
+    abort();
+  }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+  std::optional<T> value;
+
+  void return_value(T v) {
+    value.emplace(std::move(v));
+  }
+  T result() {
+    return std::move(*value);
+  }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+  void return_void() const noexcept {}
+  void result() const noexcept {}
+};
+
+}  // namespace detail
+
+// A lazily started coroutine producing a `T`.
+//
+// A task starts running when it is first awaited or passed to `run()`. The
+// `Task` object owns the coroutine frame and destroys it when it goes out of
+// scope, so it must outlive the coroutine's execution.
+template <typename T = void>
+class [[nodiscard]] Task final {
+ public:
+  struct promise_type final : detail::Promise<T> {
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+  };
+
+  Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  Task(const Task&)            = delete;
+  Task& operator=(const Task&) = delete;
+  Task& operator=(Task&&)      = delete;
+
+  ~Task() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  // True once the coroutine has returned.
+  bool done() const {
+    return handle_.done();
+  }
+
+  // Start the coroutine if it has not run yet. Used by `run()`.
+  void start() {
+    if (!started_) {
+      started_ = true;
+      handle_.resume();
+    }
+  }
+
+  auto operator co_await() noexcept {
+    struct Awaiter {
+      std::coroutine_handle<promise_type> handle;
+
+      bool await_ready() const noexcept {
+        return handle.done();
+      }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+      T await_resume() {
+        return handle.promise().result();
+      }
+    };
+    started_ = true;
+    return Awaiter{handle_};
+  }
+
+ private:
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+  bool started_ = false;
+};
+
+// Run the given tasks until all of them have finished.
+//
+// Coroutines made ready by callbacks are resumed first. The process only
+// calls `yield()` when nothing is ready.
+template <typename... Ts>
+void run(Task<Ts>&... tasks) {
+  (tasks.start(), ...);
+  while (!(tasks.done() && ...)) {
+    detail::drain_ready();
+    if (!(tasks.done() && ...)) {
+      yield();
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// AWAITABLES
+///
+////////////////////////////////////////////////////////////////////////////////
+
+// Suspend for `ms` milliseconds. Resumes with the return code of
+// `libtock_alarm_in_ms()`.
+class [[nodiscard]] alarm_ms final {
+ public:
+  explicit alarm_ms(uint32_t ms) : ms_(ms) {}
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+  bool await_suspend(std::coroutine_handle<> handle) {
+    waiter_.handle = handle;
+    ret_ = libtock_alarm_in_ms(ms_, callback, this, &alarm_);
+    return ret_ == RETURNCODE_SUCCESS;
+  }
+  returncode_t await_resume() const noexcept {
+    return static_cast<returncode_t>(ret_);
+  }
+
+ private:
+  static void callback(uint32_t, uint32_t, void* opaque) {
+    detail::make_ready(&static_cast<alarm_ms*>(opaque)->waiter_);
+  }
+
+  uint32_t ms_;
+  int ret_ = RETURNCODE_SUCCESS;
+  libtock_alarm_t alarm_ = {};
+  detail::Waiter waiter_;
+};
+
+// Result of a console read or write.
+struct ConsoleResult {
+  returncode_t ret;
+  uint32_t length;
+};
+
+// Read up to `len` bytes from the console into `buffer`.
+class [[nodiscard]] console_read final {
+ public:
+  console_read(uint8_t* buffer, uint32_t len) : buffer_(buffer), len_(len) {}
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+  bool await_suspend(std::coroutine_handle<> handle) {
+    waiter_.handle = handle;
+    pending        = this;
+    result_.ret    = libtock_console_read(buffer_, len_, callback);
+    if (result_.ret != RETURNCODE_SUCCESS) {
+      pending = nullptr;
+      return false;
+    }
+    return true;
+  }
+  ConsoleResult await_resume() const noexcept {
+    return result_;
+  }
+
+ private:
+  static void callback(returncode_t ret, uint32_t length) {
+    console_read* self = std::exchange(pending, nullptr);
+    if (self != nullptr) {
+      self->result_ = {ret, length};
+      detail::make_ready(&self->waiter_);
+    }
+  }
+
+  inline static console_read* pending = nullptr;
+
+  uint8_t* buffer_;
+  uint32_t len_;
+  ConsoleResult result_ = {RETURNCODE_SUCCESS, 0};
+  detail::Waiter waiter_;
+};
+
+// Write `len` bytes from `buffer` to the console.
+class [[nodiscard]] console_write final {
+ public:
+  console_write(const uint8_t* buffer, uint32_t len) : buffer_(buffer), len_(len) {}
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+  bool await_suspend(std::coroutine_handle<> handle) {
+    waiter_.handle = handle;
+    pending        = this;
+    result_.ret    = libtock_console_write(buffer_, len_, callback);
+    if (result_.ret != RETURNCODE_SUCCESS) {
+      pending = nullptr;
+      return false;
+    }
+    return true;
+  }
+  ConsoleResult await_resume() const noexcept {
+    return result_;
+  }
+
+ private:
+  static void callback(returncode_t ret, uint32_t length) {
+    console_write* self = std::exchange(pending, nullptr);
+    if (self != nullptr) {
+      self->result_ = {ret, length};
+      detail::make_ready(&self->waiter_);
+    }
+  }
+
+  inline static console_write* pending = nullptr;
+
+  const uint8_t* buffer_;
+  uint32_t len_;
+  ConsoleResult result_ = {RETURNCODE_SUCCESS, 0};
+  detail::Waiter waiter_;
+};
+
+// Result of a buffered ADC sample.
+struct AdcBufferResult {
+  returncode_t ret;
+  uint8_t channel;
+  uint32_t length;
+  uint16_t* samples;
+};
+
+// Fill the buffer set with `libtock_adc_set_buffer()` with samples from
+// `channel` at `frequency` Hz.
+class [[nodiscard]] adc_buffered_sample final {
+ public:
+  adc_buffered_sample(uint8_t channel, uint32_t frequency) : channel_(channel), frequency_(frequency) {}
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+  bool await_suspend(std::coroutine_handle<> handle) {
+    waiter_.handle = handle;
+    pending        = this;
+    result_.ret    = libtock_adc_buffered_sample(channel_, frequency_, &callbacks);
+    if (result_.ret != RETURNCODE_SUCCESS) {
+      pending = nullptr;
+      return false;
+    }
+    return true;
+  }
+  AdcBufferResult await_resume() const noexcept {
+    return result_;
+  }
+
+ private:
+  static void callback(uint8_t channel, uint32_t length, uint16_t* samples) {
+    adc_buffered_sample* self = std::exchange(pending, nullptr);
+    if (self != nullptr) {
+      self->result_ = {RETURNCODE_SUCCESS, channel, length, samples};
+      detail::make_ready(&self->waiter_);
+    }
+  }
+
+  inline static adc_buffered_sample* pending = nullptr;
+  inline static libtock_adc_callbacks callbacks = {
+    nullptr, nullptr, callback, nullptr,
+  };
+
+  uint8_t channel_;
+  uint32_t frequency_;
+  AdcBufferResult result_ = {RETURNCODE_SUCCESS, 0, 0, nullptr};
+  detail::Waiter waiter_;
+};
+
+// Result of a UDP receive.
+struct UdpRecvResult {
+  returncode_t ret;
+  int length;
+};
+
+// Receive one datagram on the bound socket into `buffer`.
+class [[nodiscard]] udp_recv final {
+ public:
+  udp_recv(void* buffer, size_t len) : buffer_(buffer), len_(len) {}
+
+  bool await_ready() const noexcept {
+    return false;
+  }
+  bool await_suspend(std::coroutine_handle<> handle) {
+    waiter_.handle = handle;
+    pending        = this;
+    result_.ret    = libtock_udp_recv(buffer_, len_, callback);
+    if (result_.ret != RETURNCODE_SUCCESS) {
+      pending = nullptr;
+      return false;
+    }
+    return true;
+  }
+  UdpRecvResult await_resume() const noexcept {
+    return result_;
+  }
+
+ private:
+  static void callback(statuscode_t status, int length) {
+    udp_recv* self = std::exchange(pending, nullptr);
+    if (self != nullptr) {
+      self->result_ = {static_cast<returncode_t>(tock_status_to_returncode(status)), length};
+      detail::make_ready(&self->waiter_);
+    }
+  }
+
+  inline static udp_recv* pending = nullptr;
+
+  void* buffer_;
+  size_t len_;
+  UdpRecvResult result_ = {RETURNCODE_SUCCESS, 0};
+  detail::Waiter waiter_;
+};
+
+}  // namespace libtock
@@ -0,0 +1,53 @@
+#include "aead.h"
+
+struct aead_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static struct aead_data* pending = NULL;
+
+static void aead_cb(returncode_t ret) {
+  struct aead_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
+}
+
+// Wait for the operation whose start returned `ret`.
+static returncode_t wait_done(returncode_t ret) {
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  struct aead_data result = { .fired = false };
+  pending = &result;
+  yield_for(&result.fired);
+  return result.ret;
+}
+
+returncode_t libtocksync_aead_seal(libtock_aead_algorithm_t algorithm, const uint8_t* key, const uint8_t* nonce,
+                                   uint32_t nonce_len, uint8_t* buf, uint32_t buf_len, uint32_t aad_len,
+                                   uint32_t msg_len, uint32_t tag_len) {
+  return wait_done(libtock_aead_seal(algorithm, key, nonce, nonce_len, buf, buf_len, aad_len, msg_len, tag_len,
+                                     aead_cb));
+}
+
+returncode_t libtocksync_aead_open(libtock_aead_algorithm_t algorithm, const uint8_t* key, const uint8_t* nonce,
+                                   uint32_t nonce_len, uint8_t* buf, uint32_t buf_len, uint32_t aad_len,
+                                   uint32_t msg_len, uint32_t tag_len) {
+  return wait_done(libtock_aead_open(algorithm, key, nonce, nonce_len, buf, buf_len, aad_len, msg_len, tag_len,
+                                     aead_cb));
+}
+
+returncode_t libtocksync_aead_stream_seal(libtock_aead_stream_t* stream, libtock_aead_algorithm_t algorithm,
+                                          const uint8_t* key, const uint8_t* nonce, uint32_t nonce_len,
+                                          uint32_t tag_len) {
+  return wait_done(libtock_aead_stream_seal(stream, algorithm, key, nonce, nonce_len, tag_len, aead_cb));
+}
+
+returncode_t libtocksync_aead_stream_open(libtock_aead_stream_t* stream, libtock_aead_algorithm_t algorithm,
+                                          const uint8_t* key, const uint8_t* nonce, uint32_t nonce_len,
+                                          uint32_t tag_len) {
+  return wait_done(libtock_aead_stream_open(stream, algorithm, key, nonce, nonce_len, tag_len, aead_cb));
+}
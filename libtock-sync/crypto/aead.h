@@ -0,0 +1,33 @@
+#pragma once
+
+#include <libtock/crypto/aead.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Seal the packet in `buf` as `libtock_aead_seal()` and wait for it.
+returncode_t libtocksync_aead_seal(libtock_aead_algorithm_t algorithm, const uint8_t* key, const uint8_t* nonce,
+                                   uint32_t nonce_len, uint8_t* buf, uint32_t buf_len, uint32_t aad_len,
+                                   uint32_t msg_len, uint32_t tag_len);
+
+// Open the packet in `buf` as `libtock_aead_open()` and wait for it. Returns
+// RETURNCODE_FAIL if the tag does not match.
+returncode_t libtocksync_aead_open(libtock_aead_algorithm_t algorithm, const uint8_t* key, const uint8_t* nonce,
+                                   uint32_t nonce_len, uint8_t* buf, uint32_t buf_len, uint32_t aad_len,
+                                   uint32_t msg_len, uint32_t tag_len);
+
+// Seal the packet assembled in `stream` and wait for it.
+returncode_t libtocksync_aead_stream_seal(libtock_aead_stream_t* stream, libtock_aead_algorithm_t algorithm,
+                                          const uint8_t* key, const uint8_t* nonce, uint32_t nonce_len,
+                                          uint32_t tag_len);
+
+// Open the packet assembled in `stream` and wait for it.
+returncode_t libtocksync_aead_stream_open(libtock_aead_stream_t* stream, libtock_aead_algorithm_t algorithm,
+                                          const uint8_t* key, const uint8_t* nonce, uint32_t nonce_len,
+                                          uint32_t tag_len);
+
+#ifdef __cplusplus
+}
+#endif
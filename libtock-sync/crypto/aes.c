@@ -0,0 +1,34 @@
+#include "aes.h"
+
+struct aes_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static struct aes_data* pending = NULL;
+
+static void aes_cb_stream(returncode_t ret, __attribute__ ((unused)) void* opaque) {
+  struct aes_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
+}
+
+returncode_t libtocksync_aes_stream(libtock_aes_algorithm_t operation, bool encrypting, const uint8_t* key,
+                                    const uint8_t* iv, uint8_t* work, uint32_t chunk,
+                                    libtock_aes_stream_fill fill, libtock_aes_stream_drain drain, void* opaque) {
+  libtock_aes_stream_t stream;
+  struct aes_data result = { .fired = false };
+
+  returncode_t ret = libtock_aes_stream_start(&stream, operation, encrypting, key, iv, work, chunk, fill, drain,
+                                              aes_cb_stream, opaque);
+  if (ret == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  // Wait for the callback.
+  pending = &result;
+  yield_for(&result.fired);
+  return result.ret;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <libtock/crypto/aes.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Process a whole stream with two buffers in turn, as
+// `libtock_aes_stream_start()`, and wait until it is complete. `fill` and
+// `drain` are called while waiting.
+returncode_t libtocksync_aes_stream(libtock_aes_algorithm_t operation, bool encrypting, const uint8_t* key,
+                                    const uint8_t* iv, uint8_t* work, uint32_t chunk,
+                                    libtock_aes_stream_fill fill, libtock_aes_stream_drain drain, void* opaque);
+
+#ifdef __cplusplus
+}
+#endif
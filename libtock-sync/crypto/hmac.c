@@ -5,11 +5,15 @@ struct hmac_data {
   returncode_t ret;
 };
 
-static struct hmac_data result = {.fired = false};
+static struct hmac_data* pending = NULL;
 
 static void hmac_cb_hmac(returncode_t ret) {
-  result.fired = true;
-  result.ret   = ret;
+  struct hmac_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
 }
 
 returncode_t libtocksync_hmac_simple(libtock_hmac_algorithm_t hmac_type,
@@ -18,13 +22,15 @@ returncode_t libtocksync_hmac_simple(libtock_hmac_algorithm_t hmac_type,
                                      uint8_t* hmac_buffer, uint32_t hmac_length) {
   returncode_t ret;
 
-  result.fired = false;
+  struct hmac_data result = { .fired = false };
 
   ret = libtock_hmac_simple(hmac_type, key_buffer, key_length, input_buffer, input_length, hmac_buffer, hmac_length,
                             hmac_cb_hmac);
+  if (ret == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -39,3 +45,29 @@ returncode_t libtocksync_hmac_simple(libtock_hmac_algorithm_t hmac_type,
 
   return RETURNCODE_SUCCESS;
 }
+
+// Wait for the operation whose start returned `ret`. RETURNCODE_EALREADY
+// means it completed in software.
+static returncode_t wait_done(returncode_t ret) {
+  if (ret == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  struct hmac_data result = { .fired = false };
+  pending = &result;
+  yield_for(&result.fired);
+  return result.ret;
+}
+
+returncode_t libtocksync_hmac_context_update(libtock_hmac_context_t* context, const uint8_t* input_buffer,
+                                             uint32_t input_length) {
+  returncode_t ret = wait_done(libtock_hmac_context_update(context, input_buffer, input_length, hmac_cb_hmac));
+  libtock_hmac_set_readonly_allow_data_buffer(NULL, 0);
+  return ret;
+}
+
+returncode_t libtocksync_hmac_context_finish(libtock_hmac_context_t* context, uint8_t* hmac_buffer,
+                                             uint32_t hmac_length) {
+  returncode_t ret = wait_done(libtock_hmac_context_finish(context, hmac_buffer, hmac_length, hmac_cb_hmac));
+  libtock_hmac_set_readwrite_allow_destination_buffer(NULL, 0);
+  return ret;
+}
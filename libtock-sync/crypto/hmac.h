@@ -13,6 +13,16 @@ returncode_t libtocksync_hmac_simple(libtock_hmac_algorithm_t hmac_type,
                                      uint8_t* input_buffer, uint32_t input_length,
                                      uint8_t* hmac_buffer, uint32_t hmac_length);
 
+// Add `input_length` bytes of `input_buffer` to the current message of
+// `context`.
+returncode_t libtocksync_hmac_context_update(libtock_hmac_context_t* context, const uint8_t* input_buffer,
+                                             uint32_t input_length);
+
+// Complete the current message of `context` and store its HMAC in
+// `hmac_buffer`.
+returncode_t libtocksync_hmac_context_finish(libtock_hmac_context_t* context, uint8_t* hmac_buffer,
+                                             uint32_t hmac_length);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,11 +5,15 @@ struct sha_data {
   returncode_t ret;
 };
 
-static struct sha_data result = {.fired = false};
+static struct sha_data* pending = NULL;
 
 static void sha_cb_hash(returncode_t ret) {
-  result.fired = true;
-  result.ret   = ret;
+  struct sha_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
 }
 
 returncode_t libtocksync_sha_simple_hash(libtock_sha_algorithm_t hash_type,
@@ -17,12 +21,14 @@ returncode_t libtocksync_sha_simple_hash(libtock_sha_algorithm_t hash_type,
                                          uint8_t* hash_buffer, uint32_t hash_length) {
   returncode_t ret;
 
-  result.fired = false;
+  struct sha_data result = { .fired = false };
 
   ret = libtock_sha_simple_hash(hash_type, input_buffer, input_length, hash_buffer, hash_length, sha_cb_hash);
+  if (ret == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -34,3 +40,31 @@ returncode_t libtocksync_sha_simple_hash(libtock_sha_algorithm_t hash_type,
 
   return RETURNCODE_SUCCESS;
 }
+
+// Wait for the operation whose start returned `ret`. RETURNCODE_EALREADY
+// means it completed in software.
+static returncode_t wait_done(returncode_t ret) {
+  if (ret == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  struct sha_data result = { .fired = false };
+  pending = &result;
+  yield_for(&result.fired);
+  return result.ret;
+}
+
+returncode_t libtocksync_sha_init(libtock_sha_algorithm_t hash_type) {
+  return libtock_sha_init(hash_type);
+}
+
+returncode_t libtocksync_sha_update(const uint8_t* input_buffer, uint32_t input_length) {
+  returncode_t ret = wait_done(libtock_sha_update(input_buffer, input_length, sha_cb_hash));
+  libtock_sha_set_readonly_allow_data_buffer(NULL, 0);
+  return ret;
+}
+
+returncode_t libtocksync_sha_finish(uint8_t* hash_buffer, uint32_t hash_length) {
+  returncode_t ret = wait_done(libtock_sha_finish(hash_buffer, hash_length, sha_cb_hash));
+  libtock_sha_set_readwrite_allow_destination_buffer(NULL, 0);
+  return ret;
+}
@@ -12,6 +12,15 @@ returncode_t libtocksync_sha_simple_hash(libtock_sha_algorithm_t hash_type,
                                          uint8_t* input_buffer, uint32_t input_length,
                                          uint8_t* hash_buffer, uint32_t hash_length);
 
+// Start a new incremental hash with `hash_type`.
+returncode_t libtocksync_sha_init(libtock_sha_algorithm_t hash_type);
+
+// Add `input_length` bytes of `input_buffer` to the hash.
+returncode_t libtocksync_sha_update(const uint8_t* input_buffer, uint32_t input_length);
+
+// Complete the hash and store it in `hash_buffer`.
+returncode_t libtocksync_sha_finish(uint8_t* hash_buffer, uint32_t hash_length);
+
 #ifdef __cplusplus
 }
 #endif
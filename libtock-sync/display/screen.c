@@ -15,35 +15,48 @@ struct screen_rotation {
   bool fired;
 };
 
-static struct screen_done result;
-static struct screen_format result_format;
-static struct screen_rotation result_rotation;
+static struct screen_done* pending              = NULL;
+static struct screen_format* pending_format     = NULL;
+static struct screen_rotation* pending_rotation = NULL;
 
 
 static void screen_cb_done(returncode_t ret) {
-  result.ret   = ret;
-  result.fired = true;
+  struct screen_done* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->ret   = ret;
+  op->fired = true;
 }
 static void screen_cb_format(returncode_t ret, libtock_screen_format_t format) {
-  result_format.ret    = ret;
-  result_format.format = format;
-  result_format.fired  = true;
+  struct screen_format* op = pending_format;
+  if (op == NULL) return;
+  pending_format = NULL;
+
+  op->ret    = ret;
+  op->format = format;
+  op->fired  = true;
 }
 static void screen_cb_rotation(returncode_t ret, libtock_screen_rotation_t rotation) {
-  result_rotation.ret      = ret;
-  result_rotation.rotation = rotation;
-  result_rotation.fired    = true;
+  struct screen_rotation* op = pending_rotation;
+  if (op == NULL) return;
+  pending_rotation = NULL;
+
+  op->ret      = ret;
+  op->rotation = rotation;
+  op->fired    = true;
 }
 
 returncode_t libtocksync_screen_set_brightness(uint32_t brightness) {
   returncode_t ret;
 
-  result.fired = false;
+  struct screen_done result = { .fired = false };
 
   ret = libtock_screen_set_brightness(brightness, screen_cb_done);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
@@ -51,12 +64,13 @@ returncode_t libtocksync_screen_set_brightness(uint32_t brightness) {
 returncode_t libtocksync_screen_invert_on(void) {
   returncode_t ret;
 
-  result.fired = false;
+  struct screen_done result = { .fired = false };
 
   ret = libtock_screen_invert_on(screen_cb_done);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
@@ -64,12 +78,13 @@ returncode_t libtocksync_screen_invert_on(void) {
 returncode_t libtocksync_screen_invert_off(void) {
   returncode_t ret;
 
-  result.fired = false;
+  struct screen_done result = { .fired = false };
 
   ret = libtock_screen_invert_on(screen_cb_done);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
@@ -77,12 +92,13 @@ returncode_t libtocksync_screen_invert_off(void) {
 returncode_t libtocksync_screen_get_pixel_format(libtock_screen_format_t* format) {
   returncode_t ret;
 
-  result_format.fired = false;
+  struct screen_format result_format = { .fired = false };
 
   ret = libtock_screen_get_pixel_format(screen_cb_format);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for the callback.
+  pending_format = &result_format;
   yield_for(&result_format.fired);
   if (result_format.ret != RETURNCODE_SUCCESS) return result_format.ret;
 
@@ -90,15 +106,30 @@ returncode_t libtocksync_screen_get_pixel_format(libtock_screen_format_t* format
   return RETURNCODE_SUCCESS;
 }
 
+returncode_t libtocksync_screen_set_pixel_format(libtock_screen_format_t format) {
+  returncode_t ret;
+
+  struct screen_done result = { .fired = false };
+
+  ret = libtock_screen_set_pixel_format(format, screen_cb_done);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  // Wait for the callback.
+  pending = &result;
+  yield_for(&result.fired);
+  return result.ret;
+}
+
 returncode_t libtocksync_screen_get_rotation(libtock_screen_rotation_t* rotation) {
   returncode_t ret;
 
-  result_rotation.fired = false;
+  struct screen_rotation result_rotation = { .fired = false };
 
   ret = libtock_screen_get_rotation(screen_cb_rotation);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for the callback.
+  pending_rotation = &result_rotation;
   yield_for(&result_rotation.fired);
   if (result_rotation.ret != RETURNCODE_SUCCESS) return result_rotation.ret;
 
@@ -109,12 +140,13 @@ returncode_t libtocksync_screen_get_rotation(libtock_screen_rotation_t* rotation
 returncode_t libtocksync_screen_set_rotation(libtock_screen_rotation_t rotation) {
   returncode_t ret;
 
-  result.fired = false;
+  struct screen_done result = { .fired = false };
 
   ret = libtock_screen_set_rotation(rotation, screen_cb_done);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
@@ -122,12 +154,13 @@ returncode_t libtocksync_screen_set_rotation(libtock_screen_rotation_t rotation)
 returncode_t libtocksync_screen_set_frame(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
   returncode_t ret;
 
-  result.fired = false;
+  struct screen_done result = { .fired = false };
 
   ret = libtock_screen_set_frame(x, y, width, height, screen_cb_done);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
@@ -135,12 +168,13 @@ returncode_t libtocksync_screen_set_frame(uint16_t x, uint16_t y, uint16_t width
 returncode_t libtocksync_screen_fill(uint8_t* buffer, int buffer_len, size_t color) {
   returncode_t ret;
 
-  result.fired = false;
+  struct screen_done result = { .fired = false };
 
   ret = libtock_screen_fill(buffer, buffer_len, color, screen_cb_done);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -151,12 +185,13 @@ returncode_t libtocksync_screen_fill(uint8_t* buffer, int buffer_len, size_t col
 returncode_t libtocksync_screen_write(uint8_t* buffer, int buffer_len, size_t length) {
   returncode_t ret;
 
-  result.fired = false;
+  struct screen_done result = { .fired = false };
 
   ret = libtock_screen_write(buffer, buffer_len, length, screen_cb_done);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -19,6 +19,9 @@ returncode_t libtocksync_screen_invert_off(void);
 // Get the current pixel format used by the screen.
 returncode_t libtocksync_screen_get_pixel_format(libtock_screen_format_t* format);
 
+// Set the pixel format used by the screen.
+returncode_t libtocksync_screen_set_pixel_format(libtock_screen_format_t format);
+
 // Get the current screen rotation.
 returncode_t libtocksync_screen_get_rotation(libtock_screen_rotation_t* rotation);
 
@@ -12,29 +12,38 @@ struct text_screen_size_data {
   uint32_t height;
 };
 
-static struct text_screen_data result = {.fired = false};
-static struct text_screen_size_data result_size = {.fired = false};
+static struct text_screen_data* pending           = NULL;
+static struct text_screen_size_data* pending_size = NULL;
 
 static void text_screen_cb(returncode_t ret) {
-  result.fired = true;
-  result.ret   = ret;
+  struct text_screen_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
 }
 
 static void text_screen_size_cb(returncode_t ret, uint32_t width, uint32_t height) {
-  result_size.fired  = true;
-  result_size.ret    = ret;
-  result_size.width  = width;
-  result_size.height = height;
+  struct text_screen_size_data* op = pending_size;
+  if (op == NULL) return;
+  pending_size = NULL;
+
+  op->fired  = true;
+  op->ret    = ret;
+  op->width  = width;
+  op->height = height;
 }
 
 
 static returncode_t text_screen_op(returncode_t (*op)()) {
   returncode_t ret;
-  result.fired = false;
+  struct text_screen_data result = { .fired = false };
 
   ret = op(text_screen_cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
@@ -73,22 +82,24 @@ returncode_t libtocksync_text_screen_home(void) {
 
 returncode_t libtocksync_text_screen_set_cursor(uint8_t col, uint8_t row) {
   returncode_t ret;
-  result.fired = false;
+  struct text_screen_data result = { .fired = false };
 
   ret = libtock_text_screen_set_cursor(col, row, text_screen_cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
 
 returncode_t libtocksync_text_screen_write(uint8_t* buffer, uint32_t buffer_len, uint32_t write_len) {
   returncode_t ret;
-  result.fired = false;
+  struct text_screen_data result = { .fired = false };
 
   ret = libtock_text_screen_write(buffer, buffer_len, write_len, text_screen_cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
+  pending = &result;
   yield_for(&result.fired);
 
   ret = libtock_text_screen_set_readonly_allow(NULL, 0);
@@ -99,11 +110,12 @@ returncode_t libtocksync_text_screen_write(uint8_t* buffer, uint32_t buffer_len,
 
 returncode_t libtocksync_text_screen_get_size(uint32_t* width, uint32_t* height) {
   returncode_t ret;
-  result.fired = false;
+  struct text_screen_size_data result_size = { .fired = false };
 
   ret = libtock_text_screen_get_size(text_screen_size_cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
+  pending_size = &result_size;
   yield_for(&result_size.fired);
   if (result_size.ret != RETURNCODE_SUCCESS) return result_size.ret;
 
@@ -7,26 +7,32 @@ struct data {
   returncode_t result;
 };
 
-static struct data result = { .fired = false };
+static struct data* pending = NULL;
 
 
 static void button_cb(returncode_t ret, int button_num, bool pressed) {
-  result.fired      = true;
-  result.pressed    = pressed;
-  result.button_num = button_num;
-  result.result     = ret;
+  struct data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired      = true;
+  op->pressed    = pressed;
+  op->button_num = button_num;
+  op->result     = ret;
 }
 
 
 returncode_t libtocksync_button_wait_for_press(int button_num) {
   returncode_t err;
-  result.fired = false;
+  struct data result = { .fired = false };
 
   err = libtock_button_notify_on_press(button_num, button_cb);
   if (err != RETURNCODE_SUCCESS) return err;
 
   // Wait for the callback and for the button to be pressed.
   while (true) {
+    result.fired = false;
+    pending      = &result;
     yield_for(&result.fired);
     if (result.result != RETURNCODE_SUCCESS) return result.result;
 
@@ -4,21 +4,26 @@ struct data {
   bool fired;
 };
 
-static struct data result = { .fired = false };
+static struct data* pending = NULL;
 
 
 static void buzzer_cb(void) {
-  result.fired = true;
+  struct data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
 }
 
 returncode_t libtocksync_buzzer_tone(uint32_t frequency_hz, uint32_t duration_ms) {
   int err;
-  result.fired = false;
+  struct data result = { .fired = false };
 
   err = libtock_buzzer_tone(frequency_hz,  duration_ms, buzzer_cb);
   if (err != RETURNCODE_SUCCESS) return err;
 
   // Wait for the callback meaning the tone is finished.
+  pending = &result;
   yield_for(&result.fired);
   return RETURNCODE_SUCCESS;
 }
@@ -1,45 +1,29 @@
 #include "console.h"
 
-struct console_result {
-  bool fired;
-  int length;
-  returncode_t result;
-};
-
-static struct console_result result = { .fired = false };
-
-static void generic_cb(returncode_t ret, uint32_t length) {
-  result.length = length;
-  result.fired  = true;
-  result.result = ret;
-}
+#include "syscalls/console_syscalls.h"
 
 returncode_t libtocksync_console_write(const uint8_t* buffer, uint32_t length, int* written) {
-  int err;
-  result.fired = false;
+  returncode_t err;
 
-  err = libtock_console_write(buffer, length, &generic_cb);
+  err = libtock_console_set_read_allow(buffer, length);
   if (err != RETURNCODE_SUCCESS) return err;
 
-  // Wait for the callback.
-  yield_for(&result.fired);
-  if (result.result != RETURNCODE_SUCCESS) return result.result;
+  err = libtock_console_command_write(length);
+  if (err != RETURNCODE_SUCCESS) return err;
 
-  *written = result.length;
-  return RETURNCODE_SUCCESS;
+  // Wait for the write to finish.
+  return libtocksync_console_yield_wait_for_write(written);
 }
 
 returncode_t libtocksync_console_read(uint8_t* buffer, uint32_t length, int* read) {
-  int err;
-  result.fired = false;
+  returncode_t err;
 
-  err = libtock_console_read(buffer, length, &generic_cb);
+  err = libtock_console_set_readwrite_allow(buffer, length);
   if (err != RETURNCODE_SUCCESS) return err;
 
-  // Wait for the callback.
-  yield_for(&result.fired);
-  if (result.result != RETURNCODE_SUCCESS) return result.result;
+  err = libtock_console_command_read(length);
+  if (err != RETURNCODE_SUCCESS) return err;
 
-  *read = result.length;
-  return RETURNCODE_SUCCESS;
+  // Wait for the read to finish.
+  return libtocksync_console_yield_wait_for_read(read);
 }
@@ -0,0 +1,38 @@
+#include "console_printf.h"
+
+struct printf_data {
+  bool fired;
+  returncode_t ret;
+  uint32_t length;
+};
+
+static struct printf_data* pending = NULL;
+
+static void printf_done(returncode_t ret, uint32_t length) {
+  struct printf_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired  = true;
+  op->ret    = ret;
+  op->length = length;
+}
+
+int libtocksync_console_vprintf(const char* fmt, va_list ap) {
+  struct printf_data result = { .fired = false };
+  returncode_t ret = libtock_console_vprintf(printf_done, fmt, ap);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  pending = &result;
+  yield_for(&result.fired);
+  if (result.ret != RETURNCODE_SUCCESS) return result.ret;
+  return (int) result.length;
+}
+
+int libtocksync_console_printf(const char* fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  int ret = libtocksync_console_vprintf(fmt, ap);
+  va_end(ap);
+  return ret;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <libtock/interface/console_printf.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Format with the lean formatter and write to the console.
+ *
+ * Blocks until the write is done. See `libtock/interface/console_printf.h`
+ * for the supported conversions. Output longer than
+ * `LIBTOCK_CONSOLE_PRINTF_BUF_SIZE - 1` characters is truncated.
+ *
+ * \return The number of bytes written, or a negative returncode_t.
+ */
+__attribute__ ((format(printf, 1, 2)))
+int libtocksync_console_printf(const char* fmt, ...);
+
+int libtocksync_console_vprintf(const char* fmt, va_list ap);
+
+#ifdef __cplusplus
+}
+#endif
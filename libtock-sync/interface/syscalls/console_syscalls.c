@@ -0,0 +1,19 @@
+#include <libtock/interface/syscalls/console_syscalls.h>
+
+#include "console_syscalls.h"
+
+returncode_t libtocksync_console_yield_wait_for_write(int* written) {
+  yield_waitfor_return_t ret = yield_wait_for(DRIVER_NUM_CONSOLE, 1);
+  if (ret.data0 != RETURNCODE_SUCCESS) return ret.data0;
+
+  *written = ret.data1;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtocksync_console_yield_wait_for_read(int* read) {
+  yield_waitfor_return_t ret = yield_wait_for(DRIVER_NUM_CONSOLE, 2);
+  if (ret.data0 != RETURNCODE_SUCCESS) return ret.data0;
+
+  *read = ret.data1;
+  return RETURNCODE_SUCCESS;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wait for a console write to complete.
+//
+// - `written`: Set to the number of bytes written.
+returncode_t libtocksync_console_yield_wait_for_write(int* written);
+
+// Wait for a console read to complete.
+//
+// - `read`: Set to the number of bytes read.
+returncode_t libtocksync_console_yield_wait_for_read(int* read);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,33 @@
+#include "ipc_rpc.h"
+
+struct rpc_data {
+  bool fired;
+  int status;
+  void* result;
+  size_t* result_len;
+};
+
+static void rpc_done(int status, const void* result, size_t len, void* ud) {
+  struct rpc_data* data = ud;
+  if (len > *data->result_len) len = *data->result_len;
+  memcpy(data->result, result, len);
+  *data->result_len = len;
+  data->status      = status;
+  data->fired       = true;
+}
+
+int libtocksync_ipc_rpc_call(ipc_rpc_client_t* client, uint16_t method, const void* args, size_t args_len,
+                             void* result, size_t* result_len) {
+  struct rpc_data data = {
+    .fired      = false,
+    .status     = RETURNCODE_SUCCESS,
+    .result     = result,
+    .result_len = result_len,
+  };
+
+  int ret = ipc_rpc_call(client, method, args, args_len, rpc_done, &data);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  yield_for(&data.fired);
+  return data.status;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <libtock/kernel/ipc_rpc.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Call `method` on the service and block until it responds.
+ *
+ * \param result buffer for the result payload.
+ * \param result_len in: size of `result`, out: bytes of result received.
+ *        Longer results are truncated.
+ * \return The status returned by the service handler, or an error from
+ *         starting the call.
+ */
+int libtocksync_ipc_rpc_call(ipc_rpc_client_t* client, uint16_t method, const void* args, size_t args_len,
+                             void* result, size_t* result_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -11,7 +11,7 @@ struct ieee802154_receive_data {
   int dest_addr;
 };
 
-static struct ieee802154_receive_data receive_result = { .fired = false };
+static struct ieee802154_receive_data* receive_pending = NULL;
 
 
 struct ieee802154_send_data {
@@ -20,26 +20,38 @@ struct ieee802154_send_data {
   statuscode_t status;
 };
 
-static struct ieee802154_send_data send_result     = { .fired = false };
-static struct ieee802154_send_data send_result_raw = { .fired = false };
+static struct ieee802154_send_data* send_pending     = NULL;
+static struct ieee802154_send_data* send_pending_raw = NULL;
 
 static void ieee802154_receive_done_cb(int pan, int src_addr, int dest_addr) {
-  receive_result.fired     = true;
-  receive_result.pan       = pan;
-  receive_result.src_addr  = src_addr;
-  receive_result.dest_addr = dest_addr;
+  struct ieee802154_receive_data* op = receive_pending;
+  if (op == NULL) return;
+  receive_pending = NULL;
+
+  op->fired     = true;
+  op->pan       = pan;
+  op->src_addr  = src_addr;
+  op->dest_addr = dest_addr;
 }
 
 static void ieee802154_send_done_cb(statuscode_t status, bool acked) {
-  send_result.fired  = true;
-  send_result.acked  = acked;
-  send_result.status = status;
+  struct ieee802154_send_data* op = send_pending;
+  if (op == NULL) return;
+  send_pending = NULL;
+
+  op->fired  = true;
+  op->acked  = acked;
+  op->status = status;
 }
 
 static void ieee802154_send_raw_done_cb(statuscode_t status, bool acked) {
-  send_result_raw.fired  = true;
-  send_result_raw.acked  = acked;
-  send_result_raw.status = status;
+  struct ieee802154_send_data* op = send_pending_raw;
+  if (op == NULL) return;
+  send_pending_raw = NULL;
+
+  op->fired  = true;
+  op->acked  = acked;
+  op->status = status;
 }
 
 returncode_t libtocksync_ieee802154_send(uint16_t         addr,
@@ -48,12 +60,13 @@ returncode_t libtocksync_ieee802154_send(uint16_t         addr,
                                          uint8_t*         key_id,
                                          const uint8_t*   payload,
                                          uint8_t          len) {
-  send_result.fired = false;
+  struct ieee802154_send_data send_result = { .fired = false };
 
   returncode_t ret = libtock_ieee802154_send(addr, level, key_id_mode, key_id, payload, len, ieee802154_send_done_cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for the frame to be sent
+  send_pending = &send_result;
   yield_for(&send_result.fired);
 
   return tock_status_to_returncode(send_result.status);
@@ -63,23 +76,25 @@ returncode_t libtocksync_ieee802154_send(uint16_t         addr,
 returncode_t libtocksync_ieee802154_send_raw(
   const uint8_t* payload,
   uint8_t        len) {
-  send_result_raw.fired = false;
+  struct ieee802154_send_data send_result_raw = { .fired = false };
 
   returncode_t ret = libtock_ieee802154_send_raw(payload, len, ieee802154_send_raw_done_cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
+  send_pending_raw = &send_result_raw;
   yield_for(&send_result_raw.fired);
 
   return tock_status_to_returncode(send_result_raw.status);
 }
 
 returncode_t libtocksync_ieee802154_receive(const libtock_ieee802154_rxbuf* frame) {
-  receive_result.fired = false;
+  struct ieee802154_receive_data receive_result = { .fired = false };
 
   returncode_t ret = libtock_ieee802154_receive(frame, ieee802154_receive_done_cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Wait for a frame
+  receive_pending = &receive_result;
   yield_for(&receive_result.fired);
 
   // receive upcall is only scheduled by the kernel if a frame is successfully received
@@ -0,0 +1,27 @@
+#include "ieee802154_scan.h"
+
+struct scan_data {
+  bool fired;
+  returncode_t ret;
+  int count;
+};
+
+static struct scan_data result = { .fired = false };
+
+static void scan_done_cb(returncode_t ret, int count) {
+  result.fired = true;
+  result.ret   = ret;
+  result.count = count;
+}
+
+returncode_t libtocksync_ieee802154_energy_scan(uint32_t channel_mask, uint32_t dwell_ms,
+                                                libtock_ieee802154_scan_result_t* results, int* count) {
+  result.fired = false;
+
+  returncode_t ret = libtock_ieee802154_energy_scan(channel_mask, dwell_ms, results, scan_done_cb);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  yield_for(&result.fired);
+  *count = result.count;
+  return result.ret;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <libtock/net/ieee802154_scan.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Scan the channels in `channel_mask` for `dwell_ms` each and wait for the
+// results. `count` receives the number of results written to `results`.
+// See `libtock_ieee802154_energy_scan()`.
+returncode_t libtocksync_ieee802154_energy_scan(uint32_t channel_mask, uint32_t dwell_ms,
+                                                libtock_ieee802154_scan_result_t* results, int* count);
+
+#ifdef __cplusplus
+}
+#endif
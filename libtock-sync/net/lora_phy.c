@@ -5,21 +5,26 @@ struct lora_phy_spi_data {
   returncode_t ret;
 };
 
-static struct lora_phy_spi_data result = {.fired = false};
+static struct lora_phy_spi_data* pending = NULL;
 
 static void lora_phy_spi_cb(returncode_t ret) {
-  result.fired = true;
-  result.ret   = ret;
+  struct lora_phy_spi_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
 }
 
 returncode_t libtocksync_lora_phy_write(const uint8_t* write,
                                         uint32_t       len) {
-  result.fired = false;
+  struct lora_phy_spi_data result = { .fired = false };
   returncode_t ret;
 
   ret = libtock_lora_phy_write(write, len, lora_phy_spi_cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
@@ -27,12 +32,13 @@ returncode_t libtocksync_lora_phy_write(const uint8_t* write,
 returncode_t libtocksync_lora_phy_read_write(const uint8_t* write,
                                              uint8_t*       read,
                                              uint32_t       len) {
-  result.fired = false;
+  struct lora_phy_spi_data result = { .fired = false };
   returncode_t ret;
 
   ret = libtock_lora_phy_read_write(write, read, len, lora_phy_spi_cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
@@ -1,5 +1,7 @@
 #include <string.h>
 
+#include <libtock-sync/services/alarm.h>
+
 #include "udp.h"
 
 struct recv_data {
@@ -13,41 +15,89 @@ struct send_data {
   statuscode_t status;
 };
 
-static struct send_data send_sync_result = { .fired = false };
-static struct recv_data recv_sync_result = { .fired = false };
+static struct send_data* send_sync_pending = NULL;
+static struct recv_data* recv_sync_pending = NULL;
 
 static void send_callback(statuscode_t ret) {
-  send_sync_result.fired  = true;
-  send_sync_result.status = ret;
+  struct send_data* op = send_sync_pending;
+  if (op == NULL) return;
+  send_sync_pending = NULL;
+
+  op->fired  = true;
+  op->status = ret;
 }
 
 static void recv_callback(statuscode_t ret, int len) {
-  recv_sync_result.val    = len;
-  recv_sync_result.fired  = true;
-  recv_sync_result.status = ret;
+  struct recv_data* op = recv_sync_pending;
+  if (op == NULL) return;
+  recv_sync_pending = NULL;
+
+  op->val    = len;
+  op->fired  = true;
+  op->status = ret;
 }
 
-returncode_t libtocksync_udp_send(void* buf, size_t len,
-                                  sock_addr_t* dst_addr) {
+// Wait on `fired` for at most `timeout_ms` if `timed`. Returns false on
+// timeout.
+static bool udp_wait(bool* fired, bool timed, uint32_t timeout_ms) {
+  if (!timed) {
+    yield_for(fired);
+    return true;
+  }
+  return libtocksync_alarm_yield_for_with_timeout(fired, timeout_ms) == RETURNCODE_SUCCESS;
+}
+
+static returncode_t udp_send(void* buf, size_t len, sock_addr_t* dst_addr, bool timed, uint32_t timeout_ms) {
   returncode_t ret;
-  send_sync_result.fired = false;
+  struct send_data send_sync_result = { .fired = false };
 
   ret = libtock_udp_send(buf, len, dst_addr, send_callback);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
-  yield_for(&send_sync_result.fired);
+  send_sync_pending = &send_sync_result;
+  if (!udp_wait(&send_sync_result.fired, timed, timeout_ms)) {
+    // Abandon the send and revoke the message buffer.
+    send_sync_pending = NULL;
+    libtock_udp_set_upcall_frame_transmitted(NULL, NULL);
+    libtock_udp_set_readonly_allow(NULL, 0);
+    return RETURNCODE_ECANCEL;
+  }
   return tock_status_to_returncode(send_sync_result.status);
 }
 
-returncode_t libtocksync_udp_recv(void* buf, size_t len, size_t* received_len) {
+static returncode_t udp_recv(void* buf, size_t len, size_t* received_len, bool timed, uint32_t timeout_ms) {
   returncode_t ret;
-  recv_sync_result.fired = false;
+  struct recv_data recv_sync_result = { .fired = false };
 
   ret = libtock_udp_recv(buf, len, recv_callback);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
-  yield_for(&recv_sync_result.fired);
+  recv_sync_pending = &recv_sync_result;
+  if (!udp_wait(&recv_sync_result.fired, timed, timeout_ms)) {
+    // Stop receiving into `buf`.
+    recv_sync_pending = NULL;
+    libtock_udp_set_upcall_frame_received(NULL, NULL);
+    libtock_udp_set_readwrite_allow_rx(NULL, 0);
+    return RETURNCODE_ECANCEL;
+  }
 
   *received_len = recv_sync_result.val;
   return tock_status_to_returncode(recv_sync_result.status);
 }
+
+returncode_t libtocksync_udp_send(void* buf, size_t len,
+                                  sock_addr_t* dst_addr) {
+  return udp_send(buf, len, dst_addr, false, 0);
+}
+
+returncode_t libtocksync_udp_recv(void* buf, size_t len, size_t* received_len) {
+  return udp_recv(buf, len, received_len, false, 0);
+}
+
+returncode_t libtocksync_udp_send_timeout(void* buf, size_t len, sock_addr_t* dst_addr, uint32_t timeout_ms) {
+  return udp_send(buf, len, dst_addr, true, timeout_ms);
+}
+
+returncode_t libtocksync_udp_recv_timeout(void* buf, size_t len, size_t* received_len, uint32_t timeout_ms) {
+  return udp_recv(buf, len, received_len, true, timeout_ms);
+}
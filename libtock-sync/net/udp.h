@@ -14,6 +14,13 @@ returncode_t libtocksync_udp_send(void* buf, size_t len,
 
 returncode_t libtocksync_udp_recv(void* buf, size_t len, size_t* received_len);
 
+// Variants of the functions above that give up after `timeout_ms`
+// milliseconds. On timeout the operation is abandoned: its callback is
+// removed, its buffer is revoked, and RETURNCODE_ECANCEL is returned.
+returncode_t libtocksync_udp_send_timeout(void* buf, size_t len, sock_addr_t* dst_addr, uint32_t timeout_ms);
+
+returncode_t libtocksync_udp_recv_timeout(void* buf, size_t len, size_t* received_len, uint32_t timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
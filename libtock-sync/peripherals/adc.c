@@ -19,20 +19,28 @@ struct adc_data {
   int error;
 };
 
-static struct adc_data result;
+static struct adc_data* pending = NULL;
 
 
 static void sample(uint8_t channel, uint16_t sample) {
-  result.fired   = true;
-  result.channel = channel;
-  result.sample  = sample;
+  struct adc_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired   = true;
+  op->channel = channel;
+  op->sample  = sample;
 }
 
 static void buffered_sample(uint8_t channel, uint32_t length, uint16_t* buffer) {
-  result.fired   = true;
-  result.channel = channel;
-  result.length  = length;
-  result.buffer  = buffer;
+  struct adc_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired   = true;
+  op->channel = channel;
+  op->length  = length;
+  op->buffer  = buffer;
 }
 
 
@@ -47,13 +55,14 @@ static libtock_adc_callbacks callbacks = {
 
 returncode_t libtocksync_adc_sample(uint8_t channel, uint16_t* sample) {
   int err;
-  result.fired = false;
+  struct adc_data result = { .fired = false };
   result.error = RETURNCODE_SUCCESS;
 
   err = libtock_adc_single_sample(channel, &callbacks);
   if (err != RETURNCODE_SUCCESS) return err;
 
   // wait for callback
+  pending = &result;
   yield_for(&result.fired);
 
   // copy over result
@@ -64,7 +73,7 @@ returncode_t libtocksync_adc_sample(uint8_t channel, uint16_t* sample) {
 
 returncode_t libtocksync_adc_sample_buffer(uint8_t channel, uint32_t frequency, uint16_t* buffer, uint32_t length) {
   returncode_t err;
-  result.fired = false;
+  struct adc_data result = { .fired = false };
   result.error = RETURNCODE_SUCCESS;
 
   err = libtock_adc_set_buffer(buffer, length);
@@ -74,6 +83,7 @@ returncode_t libtocksync_adc_sample_buffer(uint8_t channel, uint32_t frequency,
   if (err != RETURNCODE_SUCCESS) return err;
 
   // wait for callback
+  pending = &result;
   yield_for(&result.fired);
 
   // copy over result
@@ -83,3 +93,93 @@ returncode_t libtocksync_adc_sample_buffer(uint8_t channel, uint32_t frequency,
 
   return result.error;
 }
+
+struct scan_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static void scan_cb(returncode_t ret, __attribute__ ((unused)) uint32_t passes, void* opaque) {
+  struct scan_data* data = (struct scan_data*) opaque;
+  data->fired = true;
+  data->ret   = ret;
+}
+
+returncode_t libtocksync_adc_scan(const uint8_t* channels, uint8_t channel_count, uint16_t* samples,
+                                  uint32_t passes) {
+  libtock_adc_scan_t scan;
+  struct scan_data result = { .fired = false };
+
+  returncode_t err = libtock_adc_scan(&scan, channels, channel_count, samples, passes, scan_cb, &result);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  yield_for(&result.fired);
+  return result.ret;
+}
+
+struct average_data {
+  bool fired;
+  returncode_t ret;
+  libtock_adc_stats_t stats;
+};
+
+static void average_cb(returncode_t ret, const libtock_adc_stats_t* stats, void* opaque) {
+  struct average_data* data = (struct average_data*) opaque;
+  data->fired = true;
+  data->ret   = ret;
+  data->stats = *stats;
+}
+
+returncode_t libtocksync_adc_sample_averaged(uint8_t channel, uint32_t samples, libtock_adc_stats_t* stats) {
+  static uint16_t buffer[LIBTOCK_ADC_AVERAGE_BUFFER];
+  libtock_adc_average_t avg;
+  struct average_data result = { .fired = false };
+
+  returncode_t err = libtock_adc_sample_averaged(&avg, channel, samples, LIBTOCK_ADC_AVERAGE_FREQUENCY, buffer,
+                                                 LIBTOCK_ADC_AVERAGE_BUFFER, average_cb, &result);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  yield_for(&result.fired);
+  *stats = result.stats;
+  return result.ret;
+}
+
+uint16_t* libtocksync_adc_ring_acquire(libtock_adc_ring_t* ring, uint32_t* length) {
+  uint16_t* buffer;
+  while ((buffer = libtock_adc_ring_acquire(ring, length)) == NULL) {
+    yield();
+  }
+  return buffer;
+}
+
+struct trigger_data {
+  bool fired;
+  returncode_t ret;
+  uint32_t length;
+  uint32_t trigger_index;
+};
+
+static void trigger_cb(returncode_t ret, uint32_t length, uint32_t trigger_index, void* opaque) {
+  struct trigger_data* data = (struct trigger_data*) opaque;
+  data->fired         = true;
+  data->ret           = ret;
+  data->length        = length;
+  data->trigger_index = trigger_index;
+}
+
+returncode_t libtocksync_adc_trigger_capture(uint8_t channel, uint32_t frequency, uint16_t* buffers, uint8_t count,
+                                             uint32_t length, libtock_adc_trigger_mode_t mode, uint16_t threshold,
+                                             uint16_t* window, uint32_t pre, uint32_t post,
+                                             uint32_t* window_len, uint32_t* trigger_index) {
+  libtock_adc_trigger_t trigger;
+  struct trigger_data result = { .fired = false };
+
+  returncode_t err = libtock_adc_trigger_start(&trigger, channel, frequency, buffers, count, length, mode, threshold,
+                                               window, pre, post, trigger_cb, &result);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  yield_for(&result.fired);
+  *window_len    = result.length;
+  *trigger_index = result.trigger_index;
+  return result.ret;
+}
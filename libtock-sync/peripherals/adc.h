@@ -11,6 +11,37 @@ returncode_t libtocksync_adc_sample(uint8_t channel, uint16_t* sample);
 
 returncode_t libtocksync_adc_sample_buffer(uint8_t channel, uint32_t frequency, uint16_t* buffer, uint32_t length);
 
+// Sample `channel_count` channels `passes` times into `samples`, interleaved
+// as described for `libtock_adc_scan()`.
+returncode_t libtocksync_adc_scan(const uint8_t* channels, uint8_t channel_count, uint16_t* samples,
+                                  uint32_t passes);
+
+// Sample `channel` `samples` times and wait for the statistics. Buffered
+// captures run at `LIBTOCK_ADC_AVERAGE_FREQUENCY` into a buffer of
+// `LIBTOCK_ADC_AVERAGE_BUFFER` samples; see `libtock_adc_sample_averaged()`.
+#ifndef LIBTOCK_ADC_AVERAGE_FREQUENCY
+#define LIBTOCK_ADC_AVERAGE_FREQUENCY 10000
+#endif
+
+#ifndef LIBTOCK_ADC_AVERAGE_BUFFER
+#define LIBTOCK_ADC_AVERAGE_BUFFER 32
+#endif
+
+returncode_t libtocksync_adc_sample_averaged(uint8_t channel, uint32_t samples, libtock_adc_stats_t* stats);
+
+// Capture the window around a trigger as for `libtock_adc_trigger_start()`,
+// and wait for it. Stores the number of samples in the window in
+// `*window_len` and the index of the trigger sample in `*trigger_index`.
+// Waits until the trigger fires.
+returncode_t libtocksync_adc_trigger_capture(uint8_t channel, uint32_t frequency, uint16_t* buffers, uint8_t count,
+                                             uint32_t length, libtock_adc_trigger_mode_t mode, uint16_t threshold,
+                                             uint16_t* window, uint32_t pre, uint32_t post,
+                                             uint32_t* window_len, uint32_t* trigger_index);
+
+// Wait for the oldest filled buffer of `ring` and store its number of samples
+// in `*length`. Release the buffer with `libtock_adc_ring_release()`.
+uint16_t* libtocksync_adc_ring_acquire(libtock_adc_ring_t* ring, uint32_t* length);
+
 #ifdef __cplusplus
 }
 #endif
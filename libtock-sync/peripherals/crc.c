@@ -1,33 +1,53 @@
 #include "crc.h"
 
+#include "syscalls/crc_syscalls.h"
+
+#include <libtock/peripherals/crc_soft.h>
+
 struct crc_data {
   bool fired;
-  int status;
-  uint32_t crc;
+  returncode_t ret;
 };
 
-static struct crc_data result = {.fired = false};
+static struct crc_data* pending = NULL;
 
-static void crc_callback(returncode_t ret, uint32_t crc) {
-  result.fired  = true;
-  result.status = ret;
-  result.crc    = crc;
+static void crc_cb_update(returncode_t ret) {
+  struct crc_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
 }
 
 returncode_t libtocksync_crc_compute(const uint8_t* buf, size_t buflen, libtock_crc_alg_t algorithm, uint32_t* crc) {
   returncode_t ret;
-  result.fired = false;
 
-  ret = libtock_crc_compute(buf, buflen, algorithm, crc_callback);
+  if (buflen <= LIBTOCK_CRC_SOFT_THRESHOLD || !libtock_crc_exists()) {
+    *crc = libtock_crc_soft(algorithm, buf, buflen);
+    return RETURNCODE_SUCCESS;
+  }
+
+  ret = libtock_crc_set_readonly_allow(buf, buflen);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
-  yield_for(&result.fired);
-  if (result.status != RETURNCODE_SUCCESS) return result.status;
+  ret = libtock_crc_command_request(algorithm, buflen);
+  if (ret != RETURNCODE_SUCCESS) goto exit;
 
-  ret = libtock_crc_set_readonly_allow(NULL, 0);
-  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtocksync_crc_yield_wait_for(crc);
 
-  *crc = result.crc;
+exit:
+  libtock_crc_set_readonly_allow(NULL, 0);
+  return ret;
+}
 
-  return RETURNCODE_SUCCESS;
+returncode_t libtocksync_crc_stream_update(libtock_crc_stream_t* stream, const uint8_t* buf, uint32_t len) {
+  returncode_t ret = libtock_crc_stream_update(stream, buf, len, crc_cb_update);
+  if (ret == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  struct crc_data result = { .fired = false };
+  pending = &result;
+  yield_for(&result.fired);
+  return result.ret;
 }
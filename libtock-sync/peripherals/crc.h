@@ -12,8 +12,14 @@ extern "C" {
 // Returns `SUCCESS` and sets `result` on success.
 // Returns `EBUSY` if a computation is already in progress.
 // Returns `ESIZE` if the buffer is too big for the unit.
+//
+// Without a CRC driver, or for at most `LIBTOCK_CRC_SOFT_THRESHOLD` bytes,
+// the CRC is computed in software.
 returncode_t libtocksync_crc_compute(const uint8_t* buf, size_t buflen, libtock_crc_alg_t algorithm, uint32_t* result);
 
+// Add `len` bytes of `buf` to `stream` and wait until they are added.
+returncode_t libtocksync_crc_stream_update(libtock_crc_stream_t* stream, const uint8_t* buf, uint32_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,17 +6,21 @@ struct gpio_data {
   bool value;
 };
 
-static struct gpio_data result = { .fired = false };
+static struct gpio_data* pending = NULL;
 
 static void cb(uint32_t pin, bool value) {
-  result.fired = true;
-  result.pin   = pin;
-  result.value = value;
+  struct gpio_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->pin   = pin;
+  op->value = value;
 }
 
 static returncode_t wait_until(uint32_t pin, libtock_gpio_input_mode_t pin_config, libtock_gpio_interrupt_mode_t mode) {
   returncode_t ret;
-  result.fired = false;
+  struct gpio_data result = { .fired = false };
 
   ret = libtock_gpio_set_interrupt_callback(cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
@@ -28,6 +32,7 @@ static returncode_t wait_until(uint32_t pin, libtock_gpio_input_mode_t pin_confi
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   while (1) {
+    pending = &result;
     yield_for(&result.fired);
 
     if (result.pin == pin) {
@@ -6,23 +6,28 @@ struct gpio_async_data {
   returncode_t ret;
 };
 
-static struct gpio_async_data result = { .fired = false };
+static struct gpio_async_data* pending = NULL;
 
 static void gpio_async_callback_command(returncode_t ret, bool value) {
-  result.fired = true;
-  result.value = value;
-  result.ret   = ret;
+  struct gpio_async_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->value = value;
+  op->ret   = ret;
 }
 
 static returncode_t gpio_async_op(uint32_t port, uint8_t pin, returncode_t (*op)(uint32_t, uint8_t,
                                                                                  libtock_gpio_async_callback_command)) {
   returncode_t err;
-  result.fired = false;
+  struct gpio_async_data result = { .fired = false };
 
   err = op(port, pin, gpio_async_callback_command);
   if (err != RETURNCODE_SUCCESS) return err;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
@@ -45,24 +50,26 @@ returncode_t libtocksync_gpio_async_toggle(uint32_t port, uint8_t pin) {
 
 returncode_t libtocksync_gpio_async_make_input(uint32_t port, uint8_t pin, libtock_gpio_input_mode_t pin_config) {
   returncode_t err;
-  result.fired = false;
+  struct gpio_async_data result = { .fired = false };
 
   err = libtock_gpio_async_make_input(port, pin, pin_config, gpio_async_callback_command);
   if (err != RETURNCODE_SUCCESS) return err;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
 
 returncode_t libtocksync_gpio_async_read(uint32_t port, uint8_t pin, bool* value) {
   returncode_t err;
-  result.fired = false;
+  struct gpio_async_data result = { .fired = false };
 
   err = libtock_gpio_async_read(port, pin, gpio_async_callback_command);
   if (err != RETURNCODE_SUCCESS) return err;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -73,12 +80,13 @@ returncode_t libtocksync_gpio_async_read(uint32_t port, uint8_t pin, bool* value
 returncode_t libtocksync_gpio_async_enable_interrupt(uint32_t port, uint8_t pin,
                                                      libtock_gpio_interrupt_mode_t irq_config) {
   returncode_t err;
-  result.fired = false;
+  struct gpio_async_data result = { .fired = false };
 
   err = libtock_gpio_async_enable_interrupt(port, pin, irq_config, gpio_async_callback_command);
   if (err != RETURNCODE_SUCCESS) return err;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
@@ -90,3 +98,54 @@ returncode_t libtocksync_gpio_async_disable_interrupt(uint32_t port, uint8_t pin
 returncode_t libtocksync_gpio_async_disable_sync(uint32_t port, uint8_t pin) {
   return gpio_async_op(port, pin, libtock_gpio_async_disable);
 }
+
+struct gpio_async_port_data {
+  bool fired;
+  uint32_t value;
+  returncode_t ret;
+};
+
+static void gpio_async_port_callback(returncode_t ret, uint32_t value, void* opaque) {
+  struct gpio_async_port_data* result = (struct gpio_async_port_data*) opaque;
+  result->fired = true;
+  result->value = value;
+  result->ret   = ret;
+}
+
+static returncode_t gpio_async_port_wait(returncode_t err, struct gpio_async_port_data* result) {
+  // The whole operation was already done.
+  if (err == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  yield_for(&result->fired);
+  return result->ret;
+}
+
+returncode_t libtocksync_gpio_async_port_make_output(libtock_gpio_async_port_t* port, uint32_t mask) {
+  struct gpio_async_port_data result = { .fired = false };
+  returncode_t err = libtock_gpio_async_port_make_output(port, mask, gpio_async_port_callback, &result);
+  return gpio_async_port_wait(err, &result);
+}
+
+returncode_t libtocksync_gpio_async_port_make_input(libtock_gpio_async_port_t* port, uint32_t mask,
+                                                    libtock_gpio_input_mode_t pin_config) {
+  struct gpio_async_port_data result = { .fired = false };
+  returncode_t err = libtock_gpio_async_port_make_input(port, mask, pin_config, gpio_async_port_callback, &result);
+  return gpio_async_port_wait(err, &result);
+}
+
+returncode_t libtocksync_gpio_async_port_write(libtock_gpio_async_port_t* port, uint32_t mask, uint32_t value) {
+  struct gpio_async_port_data result = { .fired = false };
+  returncode_t err = libtock_gpio_async_port_write(port, mask, value, gpio_async_port_callback, &result);
+  return gpio_async_port_wait(err, &result);
+}
+
+returncode_t libtocksync_gpio_async_port_read(libtock_gpio_async_port_t* port, uint32_t mask, uint32_t* value) {
+  struct gpio_async_port_data result = { .fired = false, .value = 0 };
+  returncode_t err = libtock_gpio_async_port_read(port, mask, gpio_async_port_callback, &result);
+  err = gpio_async_port_wait(err, &result);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  *value = result.value;
+  return RETURNCODE_SUCCESS;
+}
@@ -27,6 +27,19 @@ returncode_t libtocksync_gpio_async_disable_interrupt(uint32_t port, uint8_t pin
 
 returncode_t libtocksync_gpio_async_disable_sync(uint32_t port, uint8_t pin);
 
+// Set the pins of the port in `mask` as outputs.
+returncode_t libtocksync_gpio_async_port_make_output(libtock_gpio_async_port_t* port, uint32_t mask);
+
+// Set the pins of the port in `mask` as inputs.
+returncode_t libtocksync_gpio_async_port_make_input(libtock_gpio_async_port_t* port, uint32_t mask,
+                                                    libtock_gpio_input_mode_t pin_config);
+
+// Drive each output pin in `mask` to its bit of `value`.
+returncode_t libtocksync_gpio_async_port_write(libtock_gpio_async_port_t* port, uint32_t mask, uint32_t value);
+
+// Read the input pins in `mask` into the matching bits of `*value`.
+returncode_t libtocksync_gpio_async_port_read(libtock_gpio_async_port_t* port, uint32_t mask, uint32_t* value);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,113 @@
+#include <libtock-sync/services/alarm.h>
+
+#include "i2c_master.h"
+
+static void i2c_callback(__attribute__ ((unused)) int a1,
+                         __attribute__ ((unused)) int a2,
+                         __attribute__ ((unused)) int unused,
+                         void*                        ud) {
+  *(bool*) ud = true;
+}
+
+// Start a transfer with `start` and wait for it for at most `timeout_ms`.
+static returncode_t i2c_transfer(uint8_t* buffer, uint16_t buffer_len, uint32_t timeout_ms,
+                                 int (*start)(uint8_t, uint16_t, uint16_t), uint8_t address,
+                                 uint16_t write_len, uint16_t read_len) {
+  // The flag lives on this stack frame, and the callback is removed before
+  // returning on timeout, so a late completion cannot write to it.
+  bool ready = false;
+  int rval   = i2c_master_set_buffer(buffer, buffer_len);
+  if (rval < 0) return rval;
+
+  rval = i2c_master_set_callback(i2c_callback, &ready);
+  if (rval < 0) return rval;
+
+  rval = start(address, write_len, read_len);
+  if (rval < 0) return rval;
+
+  if (libtocksync_alarm_yield_for_with_timeout(&ready, timeout_ms) != RETURNCODE_SUCCESS) {
+    i2c_master_set_callback(NULL, NULL);
+    i2c_master_set_buffer(NULL, 0);
+    return RETURNCODE_ECANCEL;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+static int start_write(uint8_t address, uint16_t write_len, __attribute__ ((unused)) uint16_t read_len) {
+  return i2c_master_write(address, write_len);
+}
+
+static int start_read(uint8_t address, __attribute__ ((unused)) uint16_t write_len, uint16_t read_len) {
+  return i2c_master_read(address, read_len);
+}
+
+returncode_t libtocksync_i2c_master_write_timeout(uint16_t address, uint8_t* buffer, uint16_t len,
+                                                  uint32_t timeout_ms) {
+  return i2c_transfer(buffer, len, timeout_ms, start_write, address, len, 0);
+}
+
+returncode_t libtocksync_i2c_master_read_timeout(uint16_t address, uint8_t* buffer, uint16_t len,
+                                                 uint32_t timeout_ms) {
+  return i2c_transfer(buffer, len, timeout_ms, start_read, address, 0, len);
+}
+
+returncode_t libtocksync_i2c_master_write_read_timeout(uint16_t address, uint8_t* buffer, uint16_t write_len,
+                                                       uint16_t read_len, uint32_t timeout_ms) {
+  uint16_t len = write_len;
+  if (read_len > write_len) {
+    len = read_len;
+  }
+  return i2c_transfer(buffer, len, timeout_ms, i2c_master_write_read, address, write_len, read_len);
+}
+
+struct reg_batch_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static void reg_batch_callback(returncode_t ret, __attribute__ ((unused)) size_t completed, void* opaque) {
+  struct reg_batch_data* result = (struct reg_batch_data*) opaque;
+  result->fired = true;
+  result->ret   = ret;
+}
+
+returncode_t libtocksync_i2c_master_reg_batch(uint8_t address, const i2c_master_reg_op_t* ops, size_t count) {
+  i2c_master_reg_batch_t batch;
+  struct reg_batch_data result = { .fired = false };
+
+  returncode_t err = i2c_master_reg_batch(&batch, address, ops, count, reg_batch_callback, &result);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  yield_for(&result.fired);
+  return result.ret;
+}
+
+returncode_t libtocksync_i2c_master_reg_read_burst(uint8_t address, uint8_t reg, uint8_t* data, uint16_t len) {
+  i2c_master_reg_op_t op = { .reg = reg, .read = true, .data = data, .len = len };
+  return libtocksync_i2c_master_reg_batch(address, &op, 1);
+}
+
+returncode_t libtocksync_i2c_master_reg_write(uint8_t address, uint8_t reg, const uint8_t* data, uint16_t len) {
+  i2c_master_reg_op_t op = { .reg = reg, .read = false, .data = (uint8_t*) data, .len = len };
+  return libtocksync_i2c_master_reg_batch(address, &op, 1);
+}
+
+returncode_t libtocksync_i2c_master_reg_write_list(uint8_t address, const uint8_t* pairs, size_t count) {
+  // Written in chunks so the operations fit on the stack.
+  i2c_master_reg_op_t ops[8];
+  while (count > 0) {
+    size_t chunk = count < 8 ? count : 8;
+    for (size_t i = 0; i < chunk; i++) {
+      ops[i].reg  = pairs[2 * i];
+      ops[i].read = false;
+      ops[i].data = (uint8_t*) &pairs[2 * i + 1];
+      ops[i].len  = 1;
+    }
+
+    returncode_t err = libtocksync_i2c_master_reg_batch(address, ops, chunk);
+    if (err != RETURNCODE_SUCCESS) return err;
+    pairs += 2 * chunk;
+    count -= chunk;
+  }
+  return RETURNCODE_SUCCESS;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <libtock/peripherals/i2c_master.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Versions of `i2c_master_write_sync()`, `i2c_master_read_sync()` and
+// `i2c_master_write_read_sync()` that give up after `timeout_ms`
+// milliseconds. On timeout the transfer is abandoned: its callback is
+// removed, `buffer` is revoked, and RETURNCODE_ECANCEL is returned. The bus
+// may stay busy until the stalled transfer ends.
+
+returncode_t libtocksync_i2c_master_write_timeout(uint16_t address, uint8_t* buffer, uint16_t len,
+                                                  uint32_t timeout_ms);
+
+returncode_t libtocksync_i2c_master_read_timeout(uint16_t address, uint8_t* buffer, uint16_t len,
+                                                 uint32_t timeout_ms);
+
+returncode_t libtocksync_i2c_master_write_read_timeout(uint16_t address, uint8_t* buffer, uint16_t write_len,
+                                                       uint16_t read_len, uint32_t timeout_ms);
+
+// Read `len` bytes starting at register `reg` of the device at `address`.
+returncode_t libtocksync_i2c_master_reg_read_burst(uint8_t address, uint8_t reg, uint8_t* data, uint16_t len);
+
+// Write `len` bytes starting at register `reg` of the device at `address`.
+returncode_t libtocksync_i2c_master_reg_write(uint8_t address, uint8_t reg, const uint8_t* data, uint16_t len);
+
+// Write `count` single byte registers, given as `count` pairs of register and
+// value in `pairs`, such as a sensor init table.
+returncode_t libtocksync_i2c_master_reg_write_list(uint8_t address, const uint8_t* pairs, size_t count);
+
+// Run a batch of register operations, see `i2c_master_reg_batch()`.
+returncode_t libtocksync_i2c_master_reg_batch(uint8_t address, const i2c_master_reg_op_t* ops, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
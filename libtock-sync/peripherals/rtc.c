@@ -10,29 +10,38 @@ struct rtc_done_data {
   returncode_t ret;
 };
 
-static struct rtc_date_data result      = { .fired = false };
-static struct rtc_done_data result_done = { .fired = false };
+static struct rtc_date_data* pending      = NULL;
+static struct rtc_done_data* pending_done = NULL;
 
 
 static void rtc_date_cb(returncode_t ret, libtock_rtc_date_t date) {
-  result.fired = true;
-  result.ret   = ret;
-  result.date  = date;
+  struct rtc_date_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
+  op->date  = date;
 }
 
 static void rtc_done_cb(returncode_t ret) {
-  result_done.fired = true;
-  result_done.ret   = ret;
+  struct rtc_done_data* op = pending_done;
+  if (op == NULL) return;
+  pending_done = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
 }
 
 returncode_t libtocksync_rtc_get_date(libtock_rtc_date_t* date) {
   returncode_t ret;
 
-  result.fired = false;
+  struct rtc_date_data result = { .fired = false };
 
   ret = libtock_rtc_get_date(rtc_date_cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -43,11 +52,12 @@ returncode_t libtocksync_rtc_get_date(libtock_rtc_date_t* date) {
 returncode_t libtocksync_rtc_set_date(libtock_rtc_date_t* set_date) {
   returncode_t ret;
 
-  result_done.fired = false;
+  struct rtc_done_data result_done = { .fired = false };
 
   ret = libtock_rtc_set_date(set_date, rtc_done_cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
+  pending_done = &result_done;
   yield_for(&result_done.fired);
 
   return result_done.ret;
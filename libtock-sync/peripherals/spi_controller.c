@@ -1,3 +1,5 @@
+#include <libtock-sync/services/alarm.h>
+
 #include "spi_controller.h"
 
 struct spi_data {
@@ -5,40 +7,61 @@ struct spi_data {
   returncode_t ret;
 };
 
-static struct spi_data result = { .fired = false };
+static struct spi_data* pending = NULL;
 
 
 static void cb(returncode_t ret) {
-  result.fired = true;
-  result.ret   = ret;
+  struct spi_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
 }
 
-returncode_t libtocksync_spi_controller_write(const uint8_t* write,
-                                              size_t         len) {
+// Wait for the transfer just started, for at most `timeout_ms` if `timed`.
+// On timeout the transfer is abandoned and its buffers revoked.
+static returncode_t spi_wait(struct spi_data* result, bool timed, uint32_t timeout_ms) {
+  pending = result;
+  if (!timed) {
+    yield_for(&result->fired);
+    return result->ret;
+  }
+
+  if (libtocksync_alarm_yield_for_with_timeout(&result->fired, timeout_ms) != RETURNCODE_SUCCESS) {
+    pending = NULL;
+    libtock_spi_controller_set_upcall(NULL, NULL);
+    libtock_spi_controller_allow_readonly_write(NULL, 0);
+    libtock_spi_controller_allow_readwrite_read(NULL, 0);
+    return RETURNCODE_ECANCEL;
+  }
+  return result->ret;
+}
+
+static returncode_t spi_write(const uint8_t* write, size_t len, bool timed, uint32_t timeout_ms) {
   returncode_t err;
-  result.fired = false;
+  struct spi_data result = { .fired = false };
 
   err = libtock_spi_controller_write(write, len, cb);
   if (err != RETURNCODE_SUCCESS) return err;
 
-  yield_for(&result.fired);
-  if (result.ret != RETURNCODE_SUCCESS) return result.ret;
+  err = spi_wait(&result, timed, timeout_ms);
+  if (err != RETURNCODE_SUCCESS) return err;
 
   err = libtock_spi_controller_allow_readonly_write(NULL, 0);
   return err;
 }
 
-returncode_t libtocksync_spi_controller_read_write(const uint8_t* write,
-                                                   uint8_t*       read,
-                                                   size_t         len) {
+static returncode_t spi_read_write(const uint8_t* write, uint8_t* read, size_t len, bool timed,
+                                   uint32_t timeout_ms) {
   returncode_t err;
-  result.fired = false;
+  struct spi_data result = { .fired = false };
 
   err = libtock_spi_controller_read_write(write, read, len, cb);
   if (err != RETURNCODE_SUCCESS) return err;
 
-  yield_for(&result.fired);
-  if (result.ret != RETURNCODE_SUCCESS) return result.ret;
+  err = spi_wait(&result, timed, timeout_ms);
+  if (err != RETURNCODE_SUCCESS) return err;
 
   err = libtock_spi_controller_allow_readonly_write(NULL, 0);
   if (err != RETURNCODE_SUCCESS) return err;
@@ -47,3 +70,46 @@ returncode_t libtocksync_spi_controller_read_write(const uint8_t* write,
 
   return err;
 }
+
+returncode_t libtocksync_spi_controller_write(const uint8_t* write,
+                                              size_t         len) {
+  return spi_write(write, len, false, 0);
+}
+
+returncode_t libtocksync_spi_controller_read_write(const uint8_t* write,
+                                                   uint8_t*       read,
+                                                   size_t         len) {
+  return spi_read_write(write, read, len, false, 0);
+}
+
+returncode_t libtocksync_spi_controller_write_timeout(const uint8_t* write,
+                                                      size_t         len,
+                                                      uint32_t       timeout_ms) {
+  return spi_write(write, len, true, timeout_ms);
+}
+
+returncode_t libtocksync_spi_controller_read_write_timeout(const uint8_t* write,
+                                                           uint8_t*       read,
+                                                           size_t         len,
+                                                           uint32_t       timeout_ms) {
+  return spi_read_write(write, read, len, true, timeout_ms);
+}
+
+static void transaction_cb(returncode_t ret, __attribute__ ((unused)) size_t completed, void* opaque) {
+  struct spi_data* result = (struct spi_data*) opaque;
+  result->fired = true;
+  result->ret   = ret;
+}
+
+returncode_t libtocksync_spi_controller_transaction(const libtock_spi_controller_segment_t* segments,
+                                                    size_t                                  count) {
+  returncode_t err;
+  struct spi_data result = { .fired = false };
+  libtock_spi_controller_transaction_t transaction;
+
+  err = libtock_spi_controller_transaction(&transaction, segments, count, transaction_cb, &result);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  yield_for(&result.fired);
+  return result.ret;
+}
@@ -16,6 +16,24 @@ returncode_t libtocksync_spi_controller_read_write(const uint8_t* write,
                                                    uint8_t*       read,
                                                    size_t         len);
 
+// Variants of the functions above that give up after `timeout_ms`
+// milliseconds. On timeout the transfer is abandoned: its callback is
+// removed, its buffers are revoked, and RETURNCODE_ECANCEL is returned. The
+// controller may stay busy until the stalled transfer ends.
+returncode_t libtocksync_spi_controller_write_timeout(const uint8_t* write,
+                                                      size_t         len,
+                                                      uint32_t       timeout_ms);
+
+returncode_t libtocksync_spi_controller_read_write_timeout(const uint8_t* write,
+                                                           uint8_t*       read,
+                                                           size_t         len,
+                                                           uint32_t       timeout_ms);
+
+// Run `count` segments back to back, see
+// `libtock_spi_controller_transaction()`.
+returncode_t libtocksync_spi_controller_transaction(const libtock_spi_controller_segment_t* segments,
+                                                    size_t                                  count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,22 +5,27 @@ struct spi_peripheral_data {
   returncode_t ret;
 };
 
-static struct spi_peripheral_data result = { .fired = false };
+static struct spi_peripheral_data* pending = NULL;
 
 
 static void cb(returncode_t ret) {
-  result.fired = true;
-  result.ret   = ret;
+  struct spi_peripheral_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
 }
 
 returncode_t libtocksync_spi_peripheral_write(const uint8_t* write,
                                               size_t         len) {
   returncode_t err;
-  result.fired = false;
+  struct spi_peripheral_data result = { .fired = false };
 
   err = libtock_spi_peripheral_write(write, len, cb);
   if (err != RETURNCODE_SUCCESS) return err;
 
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -32,11 +37,12 @@ returncode_t libtocksync_spi_peripheral_read_write(const uint8_t* write,
                                                    uint8_t*       read,
                                                    size_t         len) {
   returncode_t err;
-  result.fired = false;
+  struct spi_peripheral_data result = { .fired = false };
 
   err = libtock_spi_peripheral_read_write(write, read, len, cb);
   if (err != RETURNCODE_SUCCESS) return err;
 
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
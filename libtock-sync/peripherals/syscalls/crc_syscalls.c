@@ -0,0 +1,11 @@
+#include <libtock/peripherals/syscalls/crc_syscalls.h>
+
+#include "crc_syscalls.h"
+
+returncode_t libtocksync_crc_yield_wait_for(uint32_t* crc) {
+  yield_waitfor_return_t ret = yield_wait_for(DRIVER_NUM_CRC, 0);
+  if (ret.data0 != RETURNCODE_SUCCESS) return ret.data0;
+
+  *crc = (uint32_t) ret.data1;
+  return RETURNCODE_SUCCESS;
+}
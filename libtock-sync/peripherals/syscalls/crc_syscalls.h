@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wait for a CRC computation to complete.
+//
+// - `crc`: Set to the computed CRC.
+returncode_t libtocksync_crc_yield_wait_for(uint32_t* crc);
+
+#ifdef __cplusplus
+}
+#endif
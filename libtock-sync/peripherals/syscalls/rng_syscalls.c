@@ -0,0 +1,9 @@
+#include <libtock/peripherals/syscalls/rng_syscalls.h>
+
+#include "rng_syscalls.h"
+
+returncode_t libtocksync_rng_yield_wait_for(int* received) {
+  yield_waitfor_return_t ret = yield_wait_for(DRIVER_NUM_RNG, 0);
+  *received = ret.data1;
+  return RETURNCODE_SUCCESS;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wait for a random bytes request to complete.
+//
+// - `received`: Set to the number of random bytes written to the buffer.
+returncode_t libtocksync_rng_yield_wait_for(int* received);
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,21 +5,26 @@ struct usb_data {
   returncode_t ret;
 };
 
-static struct usb_data result = { .fired = false };
+static struct usb_data* pending = NULL;
 
 static void usb_callback(returncode_t ret) {
-  result.fired = true;
-  result.ret   = ret;
+  struct usb_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
 }
 
 returncode_t libtocksync_usb_enable_and_attach(void) {
   int err;
 
-  result.fired = false;
+  struct usb_data result = { .fired = false };
 
   err = libtock_usb_enable_and_attach(usb_callback);
   if (err != RETURNCODE_SUCCESS) return err;
 
+  pending = &result;
   yield_for(&result.fired);
   return result.ret;
 }
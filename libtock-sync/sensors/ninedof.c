@@ -11,16 +11,20 @@ struct ninedof_data {
   returncode_t ret;
 };
 
-static struct ninedof_data result = { .fired = false };
+static struct ninedof_data* pending = NULL;
 
 
 
 static void ninedof_cb(returncode_t ret, int x, int y, int z) {
-  result.x     = x;
-  result.y     = y;
-  result.z     = z;
-  result.fired = true;
-  result.ret   = ret;
+  struct ninedof_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->x     = x;
+  op->y     = y;
+  op->z     = z;
+  op->fired = true;
+  op->ret   = ret;
 }
 
 
@@ -28,12 +32,13 @@ static void ninedof_cb(returncode_t ret, int x, int y, int z) {
 returncode_t libtocksync_ninedof_read_accelerometer(int* x, int* y, int* z) {
   returncode_t err;
 
-  result.fired = false;
+  struct ninedof_data result = { .fired = false };
 
   err = libtock_ninedof_read_accelerometer(ninedof_cb);
   if (err != RETURNCODE_SUCCESS) return err;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -51,7 +56,7 @@ returncode_t libtocksync_ninedof_read_accelerometer_magnitude(double* magnitude)
   err = libtocksync_ninedof_read_accelerometer(&x, &y, &z);
   if (err != RETURNCODE_SUCCESS) return err;
 
-  *magnitude = sqrt(result.x * result.x + result.y * result.y + result.z * result.z);
+  *magnitude = sqrt(x * x + y * y + z * z);
 
   return RETURNCODE_SUCCESS;
 }
@@ -59,12 +64,13 @@ returncode_t libtocksync_ninedof_read_accelerometer_magnitude(double* magnitude)
 returncode_t libtocksync_ninedof_read_magnetometer(int* x, int* y, int* z) {
   returncode_t err;
 
-  result.fired = false;
+  struct ninedof_data result = { .fired = false };
 
   err = libtock_ninedof_read_magnetometer(ninedof_cb);
   if (err != RETURNCODE_SUCCESS) return err;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -78,12 +84,13 @@ returncode_t libtocksync_ninedof_read_magnetometer(int* x, int* y, int* z) {
 returncode_t libtocksync_ninedof_read_gyroscope(int* x, int* y, int* z) {
   returncode_t err;
 
-  result.fired = false;
+  struct ninedof_data result = { .fired = false };
 
   err = libtock_ninedof_read_gyroscope(ninedof_cb);
   if (err != RETURNCODE_SUCCESS) return err;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -93,3 +100,27 @@ returncode_t libtocksync_ninedof_read_gyroscope(int* x, int* y, int* z) {
 
   return RETURNCODE_SUCCESS;
 }
+
+struct ninedof_all_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static void ninedof_all_cb(returncode_t ret, __attribute__ ((unused)) libtock_ninedof_sample_t* sample, void* opaque) {
+  struct ninedof_all_data* result = (struct ninedof_all_data*) opaque;
+  result->fired = true;
+  result->ret   = ret;
+}
+
+returncode_t libtocksync_ninedof_read_all(libtock_ninedof_sample_t* sample) {
+  returncode_t err;
+  libtock_ninedof_reader_t reader;
+  struct ninedof_all_data result = { .fired = false };
+
+  err = libtock_ninedof_read_all(&reader, sample, ninedof_all_cb, &result);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  // Wait for the callback.
+  yield_for(&result.fired);
+  return result.ret;
+}
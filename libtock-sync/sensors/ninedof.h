@@ -57,6 +57,17 @@ returncode_t libtocksync_ninedof_read_magnetometer(int* x, int* y, int* z);
 // A returncode indicating whether the read was completed successfully.
 returncode_t libtocksync_ninedof_read_gyroscope(int* x, int* y, int* z);
 
+// Read all three sensors synchronously.
+//
+// ## Arguments
+//
+// - `sample`: Filled with the readings of the sensors the board has.
+//
+// ## Return Value
+//
+// A returncode indicating whether the read was completed successfully.
+returncode_t libtocksync_ninedof_read_all(libtock_ninedof_sample_t* sample);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,9 @@
+#include <libtock/sensors/syscalls/ambient_light_syscalls.h>
+
+#include "ambient_light_syscalls.h"
+
+returncode_t libtocksync_ambient_light_yield_wait_for(int* intensity) {
+  yield_waitfor_return_t ret = yield_wait_for(DRIVER_NUM_AMBIENT_LIGHT, 0);
+  *intensity = ret.data0;
+  return RETURNCODE_SUCCESS;
+}
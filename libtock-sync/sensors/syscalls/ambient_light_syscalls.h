@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wait for an ambient light intensity reading to complete.
+//
+// - `intensity`: Set to the light intensity in lux.
+returncode_t libtocksync_ambient_light_yield_wait_for(int* intensity);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,9 @@
+#include <libtock/sensors/syscalls/humidity_syscalls.h>
+
+#include "humidity_syscalls.h"
+
+returncode_t libtocksync_humidity_yield_wait_for(int* humidity) {
+  yield_waitfor_return_t ret = yield_wait_for(DRIVER_NUM_HUMIDITY, 0);
+  *humidity = ret.data0;
+  return RETURNCODE_SUCCESS;
+}
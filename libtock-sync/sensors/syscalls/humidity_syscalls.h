@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wait for a humidity reading to complete.
+//
+// - `humidity`: Set to the relative humidity in hundredths of a percent.
+returncode_t libtocksync_humidity_yield_wait_for(int* humidity);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,9 @@
+#include <libtock/sensors/syscalls/pressure_syscalls.h>
+
+#include "pressure_syscalls.h"
+
+returncode_t libtocksync_pressure_yield_wait_for(int* pressure) {
+  yield_waitfor_return_t ret = yield_wait_for(DRIVER_NUM_PRESSURE, 0);
+  *pressure = ret.data0;
+  return RETURNCODE_SUCCESS;
+}
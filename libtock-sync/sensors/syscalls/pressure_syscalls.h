@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wait for a pressure reading to complete.
+//
+// - `pressure`: Set to the pressure reading.
+returncode_t libtocksync_pressure_yield_wait_for(int* pressure);
+
+#ifdef __cplusplus
+}
+#endif
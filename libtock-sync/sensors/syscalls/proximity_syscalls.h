@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wait for a proximity reading to complete.
+//
+// - `proximity`: Set to the proximity reading.
+returncode_t libtocksync_proximity_yield_wait_for(uint8_t* proximity);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wait for a sound pressure reading to complete.
+//
+// - `sound_pressure`: Set to the sound pressure reading.
+returncode_t libtocksync_sound_pressure_yield_wait_for(uint8_t* sound_pressure);
+
+#ifdef __cplusplus
+}
+#endif
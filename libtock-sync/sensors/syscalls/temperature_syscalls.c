@@ -0,0 +1,9 @@
+#include <libtock/sensors/syscalls/temperature_syscalls.h>
+
+#include "temperature_syscalls.h"
+
+returncode_t libtocksync_temperature_yield_wait_for(int* temperature) {
+  yield_waitfor_return_t ret = yield_wait_for(DRIVER_NUM_TEMPERATURE, 0);
+  *temperature = ret.data0;
+  return RETURNCODE_SUCCESS;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wait for a temperature reading to complete.
+//
+// - `temperature`: Set to the temperature in hundredths of degrees
+//   centigrade.
+returncode_t libtocksync_temperature_yield_wait_for(int* temperature);
+
+#ifdef __cplusplus
+}
+#endif
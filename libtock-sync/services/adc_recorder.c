@@ -0,0 +1,31 @@
+#include "adc_recorder.h"
+
+struct recorder_data {
+  bool fired;
+  returncode_t ret;
+  uint32_t written;
+};
+
+static struct recorder_data result = { .fired = false };
+
+static void recorder_cb(returncode_t ret, uint32_t written) {
+  result.fired   = true;
+  result.ret     = ret;
+  result.written = written;
+}
+
+returncode_t libtocksync_adc_recorder_record(libtock_adc_recorder_target_t target, uint32_t start, uint32_t limit,
+                                             uint8_t channel, uint32_t frequency,
+                                             uint16_t* buffers, uint8_t count, uint32_t length,
+                                             uint32_t* written) {
+  if (limit == 0) return RETURNCODE_EINVAL;
+  result.fired = false;
+
+  returncode_t ret = libtock_adc_recorder_start(target, start, limit, channel, frequency, buffers, count, length,
+                                                recorder_cb);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  yield_for(&result.fired);
+  *written = result.written;
+  return result.ret;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <libtock/services/adc_recorder.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Record `limit` bytes of samples to storage and wait until they are stored.
+// The arguments are as for `libtock_adc_recorder_start()`, and the number of
+// bytes stored is put in `*written`, also when a write fails.
+//
+// Returns RETURNCODE_EINVAL if `limit` is 0, as the recording would never
+// end.
+returncode_t libtocksync_adc_recorder_record(libtock_adc_recorder_target_t target, uint32_t start, uint32_t limit,
+                                             uint8_t channel, uint32_t frequency,
+                                             uint16_t* buffers, uint8_t count, uint32_t length,
+                                             uint32_t* written);
+
+#ifdef __cplusplus
+}
+#endif
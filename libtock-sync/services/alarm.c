@@ -4,20 +4,21 @@ struct alarm_cb_data {
   bool fired;
 };
 
-static struct alarm_cb_data delay_data = { .fired = false };
-
 static void delay_cb(__attribute__ ((unused)) uint32_t now,
                      __attribute__ ((unused)) uint32_t scheduled,
-                     __attribute__ ((unused)) void*    opaque) {
-  delay_data.fired = true;
+                     void*                            opaque) {
+  struct alarm_cb_data* data = (struct alarm_cb_data*) opaque;
+  data->fired = true;
 }
 
 int libtocksync_alarm_delay_ms(uint32_t ms) {
-  delay_data.fired = false;
+  // Kept on the stack so concurrent delays (e.g. from cooperative threads) do
+  // not share a flag.
+  struct alarm_cb_data delay_data = { .fired = false };
   libtock_alarm_t alarm;
   int rc;
 
-  if ((rc = libtock_alarm_in_ms(ms, delay_cb, NULL, &alarm)) != RETURNCODE_SUCCESS) {
+  if ((rc = libtock_alarm_in_ms(ms, delay_cb, &delay_data, &alarm)) != RETURNCODE_SUCCESS) {
     return rc;
   }
 
@@ -25,27 +26,65 @@ int libtocksync_alarm_delay_ms(uint32_t ms) {
   return rc;
 }
 
-static struct alarm_cb_data yf_timeout_data = { .fired = false };
+int libtocksync_alarm_delay_us(uint32_t us) {
+  struct alarm_cb_data delay_data = { .fired = false };
+  libtock_alarm_t alarm;
+  int rc;
+
+  if ((rc = libtock_alarm_in_us(us, delay_cb, &delay_data, &alarm)) != RETURNCODE_SUCCESS) {
+    return rc;
+  }
 
-static void yf_timeout_cb(__attribute__ ((unused)) uint32_t now,
-                          __attribute__ ((unused)) uint32_t scheduled,
-                          __attribute__ ((unused)) void*    opaque) {
-  yf_timeout_data.fired = true;
+  yield_for(&delay_data.fired);
+  return rc;
 }
 
 int libtocksync_alarm_yield_for_with_timeout(bool* cond, uint32_t ms) {
-  yf_timeout_data.fired = false;
-  libtock_alarm_t alarm;
-  libtock_alarm_in_ms(ms, yf_timeout_cb, NULL, &alarm);
+  bool* conds[1] = { cond };
+  int ret        = libtocksync_alarm_yield_for_any_with_timeout(conds, 1, ms);
+  return ret < 0 ? ret : RETURNCODE_SUCCESS;
+}
+
+// What a timed `yield_for_any()` waits on: the caller's conditions or the
+// timeout.
+struct timed_wait {
+  bool** conds;
+  size_t n;
+  bool* timed_out;
+};
 
-  while (!*cond) {
-    if (yf_timeout_data.fired) {
-      return RETURNCODE_FAIL;
+static int first_true(bool* conds[], size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (conds[i] != NULL && *conds[i]) {
+      return (int) i;
     }
+  }
+  return -1;
+}
 
-    yield();
+static bool timed_wait_ready(void* ctx) {
+  struct timed_wait* wait = (struct timed_wait*) ctx;
+  return *wait->timed_out || first_true(wait->conds, wait->n) >= 0;
+}
+
+int libtocksync_alarm_yield_for_any_with_timeout(bool* conds[], size_t n, uint32_t ms) {
+  struct alarm_cb_data timeout_data = { .fired = false };
+  libtock_alarm_t alarm;
+  int rc;
+
+  if ((rc = libtock_alarm_in_ms(ms, delay_cb, &timeout_data, &alarm)) != RETURNCODE_SUCCESS) {
+    return rc;
   }
 
+  // Wait through `yield_until()` so a cooperative thread is parked, rather
+  // than holding the process in `yield()` while its siblings could run.
+  struct timed_wait wait = { .conds = conds, .n = n, .timed_out = &timeout_data.fired };
+  yield_until(timed_wait_ready, &wait);
+
+  int i = first_true(conds, n);
+  if (i < 0) {
+    return RETURNCODE_FAIL;
+  }
   libtock_alarm_ms_cancel(&alarm);
-  return RETURNCODE_SUCCESS;
+  return i;
 }
@@ -17,6 +17,16 @@ extern "C" {
  */
 int libtocksync_alarm_delay_ms(uint32_t ms);
 
+/** \brief Blocks for the given amount of time in microseconds.
+ *
+ * This is a blocking version of `libtock_alarm_in_us`. The delay is rounded
+ * down to whole clock ticks.
+ *
+ * \param us the number of microseconds to delay for.
+ * \return An error code. Either RETURNCODE_SUCCESS or RETURNCODE_FAIL.
+ */
+int libtocksync_alarm_delay_us(uint32_t us);
+
 /** \brief Functions as yield_for with a timeout in milliseconds.
  *
  * This yields on a condition variable, but will return early
@@ -28,6 +38,20 @@ int libtocksync_alarm_delay_ms(uint32_t ms);
  */
 int libtocksync_alarm_yield_for_with_timeout(bool* cond, uint32_t ms);
 
+/** \brief Functions as yield_for_any with a timeout in milliseconds.
+ *
+ * This yields until any of the `n` conditions in `conds` is true, but will
+ * return early if none is met before the timeout in milliseconds. NULL entries
+ * in `conds` are skipped.
+ *
+ * \param conds the conditions to yield_for.
+ * \param n the number of entries in `conds`.
+ * \param ms the amount of time before returning without any condition.
+ * \return The index of the first true condition, or a negative error code:
+ * RETURNCODE_FAIL for timeout, or the error from setting the alarm.
+ */
+int libtocksync_alarm_yield_for_any_with_timeout(bool* conds[], size_t n, uint32_t ms);
+
 #ifdef __cplusplus
 }
 #endif
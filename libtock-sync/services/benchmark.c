@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libtock/peripherals/syscalls/alarm_syscalls.h>
+#include <libtock/services/time.h>
+
+#include "benchmark.h"
+
+static uint64_t samples[LIBTOCK_BENCH_SAMPLES];
+
+// Ticks taken by a clock reading, measured on first use.
+static bool calibrated;
+static uint64_t overhead;
+
+// The alarm counter, read live. `libtock_time_now_ticks64()` only changes on
+// context switches once it reads the read-only state, so it would time code
+// that makes no system calls as taking no time.
+static uint32_t now_ticks(void) {
+  uint32_t now = 0;
+  libtock_alarm_command_read(&now);
+  return now;
+}
+
+static int cmp_u64(const void* a, const void* b) {
+  uint64_t x = *(const uint64_t*) a;
+  uint64_t y = *(const uint64_t*) b;
+  return (x > y) - (x < y);
+}
+
+// The least time two back-to-back readings can differ by.
+static uint64_t clock_overhead(void) {
+  if (calibrated) return overhead;
+
+  overhead = UINT64_MAX;
+  for (int i = 0; i < LIBTOCK_BENCH_SAMPLES; i++) {
+    uint32_t start = now_ticks();
+    uint32_t end   = now_ticks();
+    if (end - start < overhead) overhead = end - start;
+  }
+  calibrated = true;
+  return overhead;
+}
+
+static uint64_t ticks_to_ns(uint64_t ticks, uint32_t iterations) {
+  uint32_t hz = libtock_time_frequency();
+  // Split to stay within 64 bits for any sample the runner can take.
+  uint64_t ns = (ticks / hz) * 1000000000 + (ticks % hz) * 1000000000 / hz;
+  return ns / iterations;
+}
+
+void libtocksync_benchmark_measure(const libtocksync_benchmark_t* bench, libtocksync_benchmark_result_t* result) {
+  uint32_t iterations = bench->iterations > 0 ? bench->iterations : 1;
+  uint64_t clock_cost = clock_overhead();
+
+  for (int i = 0; i < LIBTOCK_BENCH_WARMUP; i++) {
+    for (uint32_t j = 0; j < iterations; j++) {
+      bench->fun();
+    }
+  }
+
+  for (int i = 0; i < LIBTOCK_BENCH_SAMPLES; i++) {
+    uint32_t start = now_ticks();
+    for (uint32_t j = 0; j < iterations; j++) {
+      bench->fun();
+    }
+    uint32_t ticks = now_ticks() - start;
+    samples[i] = ticks > clock_cost ? ticks - clock_cost : 0;
+  }
+
+  qsort(samples, LIBTOCK_BENCH_SAMPLES, sizeof(samples[0]), cmp_u64);
+  // Nearest-rank percentiles.
+  result->samples   = LIBTOCK_BENCH_SAMPLES;
+  result->min_ns    = ticks_to_ns(samples[0], iterations);
+  result->median_ns = ticks_to_ns(samples[(LIBTOCK_BENCH_SAMPLES - 1) / 2], iterations);
+  result->p99_ns    = ticks_to_ns(samples[(LIBTOCK_BENCH_SAMPLES * 99 + 99) / 100 - 1], iterations);
+  result->max_ns    = ticks_to_ns(samples[LIBTOCK_BENCH_SAMPLES - 1], iterations);
+}
+
+void libtocksync_benchmark_run(const libtocksync_benchmark_t* benches, uint32_t count) {
+  printf("# benchmark,clock_hz=%lu,overhead_ticks=%lu\n", (unsigned long) libtock_time_frequency(),
+         (unsigned long) clock_overhead());
+  printf("name,iterations,samples,min_ns,median_ns,p99_ns,max_ns\n");
+
+  for (uint32_t i = 0; i < count; i++) {
+    libtocksync_benchmark_result_t result;
+    libtocksync_benchmark_measure(&benches[i], &result);
+    printf("%s,%lu,%lu,%lu,%lu,%lu,%lu\n", benches[i].name, (unsigned long) benches[i].iterations,
+           (unsigned long) result.samples, (unsigned long) result.min_ns, (unsigned long) result.median_ns,
+           (unsigned long) result.p99_ns, (unsigned long) result.max_ns);
+  }
+}
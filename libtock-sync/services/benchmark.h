@@ -0,0 +1,81 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Micro-benchmark harness.
+//
+// Benchmarks are registered like unit tests: each is a function that runs
+// the code under test once, listed with the `BENCH()` macro and handed to
+// the runner:
+//
+//     static void bench_memcpy_1k(void) {
+//       memcpy(dst, src, 1024);
+//       BENCH_KEEP(dst);
+//     }
+//
+//     int main(void) {
+//       libtocksync_benchmark_t benches[] = { BENCH(memcpy_1k, 64) };
+//       libtocksync_benchmark_run(benches, 1);
+//     }
+//
+// The runner times `iterations` back-to-back calls as one sample, which
+// keeps fast functions above the clock's resolution, and divides by the
+// count. It takes `LIBTOCK_BENCH_SAMPLES` samples per benchmark after
+// `LIBTOCK_BENCH_WARMUP` untimed ones, subtracts the cost of reading the
+// clock, and prints one CSV row per benchmark:
+//
+//     # benchmark,clock_hz=<hz>,overhead_ticks=<ticks>
+//     name,iterations,samples,min_ns,median_ns,p99_ns,max_ns
+//     memcpy_1k,64,31,<ns>,<ns>,<ns>,<ns>
+//
+// Lines starting with '#' are comments. Times are per call.
+//
+// The clock is the alarm counter, read with a system call per reading, so
+// a sample must be shorter than one wrap of the counter.
+
+#ifndef LIBTOCK_BENCH_SAMPLES
+#define LIBTOCK_BENCH_SAMPLES 31
+#endif
+
+#ifndef LIBTOCK_BENCH_WARMUP
+#define LIBTOCK_BENCH_WARMUP 2
+#endif
+
+typedef struct {
+  void (*fun)(void);
+  const char* name;
+  uint32_t iterations;
+} libtocksync_benchmark_t;
+
+#define BENCH(NAME, ITERATIONS) { \
+    bench_##NAME,                 \
+    #NAME,                        \
+    (ITERATIONS)                  \
+}
+
+// Make the compiler assume `x` is used, so the work producing it is not
+// optimized away.
+#define BENCH_KEEP(x) __asm__ volatile ("" : : "r" (x) : "memory")
+
+// Statistics of one benchmark, in nanoseconds per call.
+typedef struct {
+  uint32_t samples;
+  uint64_t min_ns;
+  uint64_t median_ns;
+  uint64_t p99_ns;
+  uint64_t max_ns;
+} libtocksync_benchmark_result_t;
+
+// Time a single benchmark without printing anything.
+void libtocksync_benchmark_measure(const libtocksync_benchmark_t* bench, libtocksync_benchmark_result_t* result);
+
+// Time every benchmark in `benches` and print the CSV report.
+void libtocksync_benchmark_run(const libtocksync_benchmark_t* benches, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,24 @@
+#include "console_mux.h"
+
+int libtocksync_console_mux_write(uint8_t channel, const void* data, uint32_t len) {
+  if (channel >= LIBTOCK_CONSOLE_MUX_CHANNELS) return 0;
+
+  const uint8_t* bytes = data;
+  uint32_t written     = libtock_console_mux_write(channel, bytes, len);
+  while (written < len) {
+    if (libtock_console_mux_space(channel) == 0 && libtock_console_mux_empty()) {
+      // Nothing drains into a closed channel.
+      return (int) written;
+    }
+    // The ring is full, wait for a frame to be written.
+    yield();
+    written += libtock_console_mux_write(channel, bytes + written, len - written);
+  }
+  return (int) len;
+}
+
+void libtocksync_console_mux_flush(void) {
+  while (!libtock_console_mux_empty()) {
+    yield();
+  }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <libtock/services/console_mux.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Queue all `len` bytes of `data` on `channel`, waiting for its ring to
+// drain while it is full. Returns the number of bytes queued, which is `len`
+// unless the channel is not open.
+int libtocksync_console_mux_write(uint8_t channel, const void* data, uint32_t len);
+
+// Wait until every channel's bytes have been written to the console.
+void libtocksync_console_mux_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+#include "console_rx.h"
+
+// Set when the last line ended with '\r', so a following '\n' is skipped.
+static bool after_cr = false;
+
+int libtocksync_console_rx_getc(void) {
+  while (true) {
+    int c = libtock_console_rx_getc();
+    if (c >= 0) return c;
+    if (!libtock_console_rx_running()) return -1;
+    // Bytes only arrive in upcalls, so nothing can change until then.
+    yield();
+  }
+}
+
+int libtocksync_console_rx_read_line(char* line, uint32_t len) {
+  if (len < 2) return RETURNCODE_EINVAL;
+
+  uint32_t n = 0;
+  while (n < len - 1) {
+    int c = libtocksync_console_rx_getc();
+    if (c < 0) return RETURNCODE_EOFF;
+
+    if (c == '\n' && after_cr && n == 0) {
+      after_cr = false;
+      continue;
+    }
+    after_cr = c == '\r';
+    if (c == '\r' || c == '\n') break;
+    line[n++] = (char) c;
+  }
+  line[n] = '\0';
+  return (int) n;
+}
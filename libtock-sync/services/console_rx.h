@@ -0,0 +1,34 @@
+#pragma once
+
+#include <libtock/services/console_rx.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Blocks until a byte has been received and returns it.
+ *
+ * Receiving must have been started with `libtock_console_rx_start()`. With a
+ * `chunk` above one, this waits for a whole chunk to arrive.
+ *
+ * \return The byte, or -1 if receiving is not running.
+ */
+int libtocksync_console_rx_getc(void);
+
+/** \brief Blocks until a full line has been received.
+ *
+ * A line ends at '\r' or '\n', a '\n' directly after a '\r' is skipped so
+ * both terminal conventions give one line per Enter. The terminator is not
+ * stored and `line` is always NUL terminated. Longer lines are returned in
+ * pieces of `len - 1` bytes.
+ *
+ * \param line buffer for the line.
+ * \param len size of `line`, at least 2.
+ * \return The line length, or a negative returncode_t.
+ */
+int libtocksync_console_rx_read_line(char* line, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
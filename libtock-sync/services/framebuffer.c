@@ -0,0 +1,24 @@
+#include "framebuffer.h"
+
+struct flush_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static struct flush_data result;
+
+static void flush_done(returncode_t ret) {
+  result.fired = true;
+  result.ret   = ret;
+}
+
+returncode_t libtocksync_framebuffer_flush(libtock_framebuffer_t* fb) {
+  result.fired = false;
+  returncode_t err = libtock_framebuffer_flush(fb, flush_done);
+  if (err == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  // Wait for the callback.
+  yield_for(&result.fired);
+  return result.ret;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/services/framebuffer.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Write the dirty rectangles of `fb` to the screen and wait until they are
+// written. Returns RETURNCODE_SUCCESS right away if nothing is dirty.
+returncode_t libtocksync_framebuffer_flush(libtock_framebuffer_t* fb);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,14 @@
+#include <libtock-sync/peripherals/spi_controller.h>
+
+#include "gpio_sequence.h"
+
+returncode_t libtocksync_gpio_sequence_play_spi(const libtock_gpio_sequence_t* seq, uint16_t pin_mask,
+                                                uint32_t rate, uint8_t* buffer, uint32_t len) {
+  uint32_t used;
+  returncode_t ret = libtock_gpio_sequence_render_spi(seq, pin_mask, rate, buffer, len, &used);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = libtock_spi_controller_set_rate(rate);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  return libtocksync_spi_controller_write(buffer, used);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <libtock/services/gpio_sequence.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Render the pin with bit `pin_mask` of `seq` into `buffer`, as for
+// `libtock_gpio_sequence_render_spi()`, and write it out with the SPI
+// controller clocked at `rate` Hz. Wire the device to MOSI.
+returncode_t libtocksync_gpio_sequence_play_spi(const libtock_gpio_sequence_t* seq, uint16_t pin_mask,
+                                                uint32_t rate, uint8_t* buffer, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,52 @@
+#include "lora_sx126x.h"
+
+struct sx126x_data {
+  bool fired;
+  returncode_t ret;
+  int read;
+};
+
+static struct sx126x_data result;
+
+static void op_done(returncode_t ret) {
+  result.fired = true;
+  result.ret   = ret;
+}
+
+static void read_done(returncode_t ret, int read) {
+  result.fired = true;
+  result.ret   = ret;
+  result.read  = read;
+}
+
+static returncode_t wait(returncode_t err) {
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  // Wait for the callback.
+  yield_for(&result.fired);
+  return result.ret;
+}
+
+returncode_t libtocksync_lora_sx126x_commit_registers(void) {
+  result.fired = false;
+  returncode_t err = libtock_lora_sx126x_commit_registers(op_done);
+  if (err == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+  return wait(err);
+}
+
+returncode_t libtocksync_lora_sx126x_command(const uint8_t* cmd, uint32_t len, uint8_t* response) {
+  result.fired = false;
+  return wait(libtock_lora_sx126x_command(cmd, len, response, op_done));
+}
+
+returncode_t libtocksync_lora_sx126x_write_fifo(uint8_t offset, const uint8_t* data, uint8_t len) {
+  result.fired = false;
+  return wait(libtock_lora_sx126x_write_fifo(offset, data, len, op_done));
+}
+
+returncode_t libtocksync_lora_sx126x_read_packet(uint8_t* buf, uint8_t len, int* read) {
+  result.fired = false;
+  returncode_t ret = wait(libtock_lora_sx126x_read_packet(buf, len, read_done));
+  if (read) *read = ret == RETURNCODE_SUCCESS ? result.read : 0;
+  return ret;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <libtock/services/lora_sx126x.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Write the staged registers and wait until they are written. Returns
+// RETURNCODE_SUCCESS if nothing was staged.
+returncode_t libtocksync_lora_sx126x_commit_registers(void);
+
+// Send one command and wait for it. `response` may be NULL.
+returncode_t libtocksync_lora_sx126x_command(const uint8_t* cmd, uint32_t len, uint8_t* response);
+
+// Write `len` bytes to the FIFO at `offset` and wait for it.
+returncode_t libtocksync_lora_sx126x_write_fifo(uint8_t offset, const uint8_t* data, uint8_t len);
+
+// Read the last received packet into `buf` and wait for it. `read` is set
+// to the bytes copied.
+returncode_t libtocksync_lora_sx126x_read_packet(uint8_t* buf, uint8_t len, int* read);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,39 @@
+#include "op_group.h"
+
+static void record(libtocksync_op_group_t* group, returncode_t ret) {
+  if (ret != RETURNCODE_SUCCESS && group->status == RETURNCODE_SUCCESS) {
+    group->status = ret;
+  }
+}
+
+void libtocksync_op_group_init(libtocksync_op_group_t* group) {
+  group->pending = 0;
+  group->done    = true;
+  group->status  = RETURNCODE_SUCCESS;
+}
+
+returncode_t libtocksync_op_group_add(libtocksync_op_group_t* group, returncode_t started) {
+  if (started == RETURNCODE_SUCCESS) {
+    group->pending++;
+    group->done = false;
+  } else {
+    record(group, started);
+  }
+  return started;
+}
+
+void libtocksync_op_group_complete(libtocksync_op_group_t* group, returncode_t ret) {
+  // Ignore completions the group is not waiting for.
+  if (group->pending == 0) return;
+
+  record(group, ret);
+  group->pending--;
+  if (group->pending == 0) {
+    group->done = true;
+  }
+}
+
+returncode_t libtocksync_op_group_wait(libtocksync_op_group_t* group) {
+  yield_for(&group->done);
+  return group->status;
+}
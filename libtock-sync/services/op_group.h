@@ -0,0 +1,69 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Start several asynchronous operations and wait for all of them at once.
+//
+// The synchronous wrappers block on one operation at a time, so reading
+// three independent sensors takes the sum of their latencies. A group lets
+// the app start all three with the `libtock_*` calls and yield until the
+// last one completes, which takes only as long as the slowest:
+//
+//     static libtocksync_op_group_t group;
+//     static int temperature;
+//
+//     static void temperature_done(returncode_t ret, int value) {
+//       temperature = value;
+//       libtocksync_op_group_complete(&group, ret);
+//     }
+//
+//     libtocksync_op_group_init(&group);
+//     libtocksync_op_group_add(&group, libtock_temperature_read(temperature_done));
+//     libtocksync_op_group_add(&group, libtock_humidity_read(humidity_done));
+//     ret = libtocksync_op_group_wait(&group);
+//
+// Every callback of an added operation must call
+// `libtocksync_op_group_complete()` exactly once.
+
+typedef struct {
+  // Operations started but not completed.
+  int pending;
+  // Set once `pending` drops to zero.
+  bool done;
+  // First error from a start or a completion.
+  returncode_t status;
+} libtocksync_op_group_t;
+
+/** \brief Prepare an empty group.
+ */
+void libtocksync_op_group_init(libtocksync_op_group_t* group);
+
+/** \brief Record an operation given the return code of the call starting it.
+ *
+ * If the operation started, the group waits for its completion. Otherwise
+ * the error becomes the group's status unless an earlier one is recorded.
+ *
+ * \return `started`, so the call can still be checked in place.
+ */
+returncode_t libtocksync_op_group_add(libtocksync_op_group_t* group, returncode_t started);
+
+/** \brief Mark one operation complete. Call from the operation's callback.
+ *
+ * \param ret the operation's result, recorded if it is the first error.
+ */
+void libtocksync_op_group_complete(libtocksync_op_group_t* group, returncode_t ret);
+
+/** \brief Block until every operation added to the group has completed.
+ *
+ * \return RETURNCODE_SUCCESS, or the first error recorded by
+ *         `libtocksync_op_group_add()` or `libtocksync_op_group_complete()`.
+ */
+returncode_t libtocksync_op_group_wait(libtocksync_op_group_t* group);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,24 @@
+#include "random.h"
+
+struct random_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static struct random_data result = { .fired = false };
+
+static void random_cb(returncode_t ret) {
+  result.fired = true;
+  result.ret   = ret;
+}
+
+returncode_t libtocksync_random_init(void) {
+  result.fired = false;
+
+  returncode_t ret = libtock_random_init(random_cb);
+  if (ret == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  yield_for(&result.fired);
+  return result.ret;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/services/random.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Seed the generator of `libtock/services/random.h` and wait until it is
+// ready. Returns immediately if it already is.
+returncode_t libtocksync_random_init(void);
+
+#ifdef __cplusplus
+}
+#endif
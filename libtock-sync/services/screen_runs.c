@@ -0,0 +1,24 @@
+#include "screen_runs.h"
+
+struct runs_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static struct runs_data result;
+
+static void runs_done(returncode_t ret) {
+  result.fired = true;
+  result.ret   = ret;
+}
+
+returncode_t libtocksync_screen_runs_write(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                                           const uint8_t* pixels) {
+  result.fired = false;
+  returncode_t err = libtock_screen_runs_write(x, y, width, height, pixels, runs_done);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  // Wait for the callback.
+  yield_for(&result.fired);
+  return result.ret;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <libtock/services/screen_runs.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Write an RGB565 image to the screen as fills and raw runs, and wait until
+// it is written.
+returncode_t libtocksync_screen_runs_write(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                                           const uint8_t* pixels);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,63 @@
+#include "sensor_cache.h"
+
+// The callback has no context, so each sensor has its own reader.
+struct cache_read_data {
+  bool fired;
+  returncode_t ret;
+  int value;
+};
+
+static struct cache_read_data* pending[LIBTOCK_SENSOR_AMBIENT_LIGHT + 1];
+
+static void read_done(libtock_sensor_t sensor, returncode_t ret, int value) {
+  struct cache_read_data* op = pending[sensor];
+  if (op == NULL) return;
+  pending[sensor] = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
+  op->value = value;
+}
+
+static void temperature_cb(returncode_t ret, int value) {
+  read_done(LIBTOCK_SENSOR_TEMPERATURE, ret, value);
+}
+
+static void humidity_cb(returncode_t ret, int value) {
+  read_done(LIBTOCK_SENSOR_HUMIDITY, ret, value);
+}
+
+static void pressure_cb(returncode_t ret, int value) {
+  read_done(LIBTOCK_SENSOR_PRESSURE, ret, value);
+}
+
+static void ambient_light_cb(returncode_t ret, int value) {
+  read_done(LIBTOCK_SENSOR_AMBIENT_LIGHT, ret, value);
+}
+
+static const libtock_sensor_cache_callback callbacks[] = {
+  [LIBTOCK_SENSOR_TEMPERATURE]   = temperature_cb,
+  [LIBTOCK_SENSOR_HUMIDITY]      = humidity_cb,
+  [LIBTOCK_SENSOR_PRESSURE]      = pressure_cb,
+  [LIBTOCK_SENSOR_AMBIENT_LIGHT] = ambient_light_cb,
+};
+
+returncode_t libtocksync_sensor_cache_read(libtock_sensor_t sensor, int* value) {
+  if (sensor > LIBTOCK_SENSOR_AMBIENT_LIGHT) return RETURNCODE_EINVAL;
+  // A synchronous read of this sensor is already waiting further up the
+  // stack.
+  if (pending[sensor] != NULL) return RETURNCODE_EBUSY;
+
+  struct cache_read_data result = { .fired = false };
+  returncode_t err = libtock_sensor_cache_read(sensor, value, callbacks[sensor]);
+  if (err == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  // Wait for the callback.
+  pending[sensor] = &result;
+  yield_for(&result.fired);
+  if (result.ret != RETURNCODE_SUCCESS) return result.ret;
+
+  *value = result.value;
+  return RETURNCODE_SUCCESS;
+}
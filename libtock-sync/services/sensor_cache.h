@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/services/sensor_cache.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Read `sensor` into `*value`, from the cache if the cached reading is fresh
+// enough, otherwise waiting for a conversion.
+returncode_t libtocksync_sensor_cache_read(libtock_sensor_t sensor, int* value);
+
+#ifdef __cplusplus
+}
+#endif
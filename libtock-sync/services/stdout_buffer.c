@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "stdout_buffer.h"
+
+// newlib flushes its `FILE` buffers only after running the `atexit()`
+// handlers, so flush them here before draining.
+static void flush_at_exit(void) {
+  fflush(NULL);
+  libtocksync_stdout_buffer_flush();
+}
+
+returncode_t libtocksync_stdout_buffer_enable(uint8_t* buffer, uint32_t len) {
+  static bool registered = false;
+
+  returncode_t ret = libtock_stdout_buffer_enable(buffer, len);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  if (!registered) {
+    registered = atexit(flush_at_exit) == 0;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+int libtocksync_stdout_buffer_write(const uint8_t* data, uint32_t len) {
+  if (!libtock_stdout_buffer_enabled()) return 0;
+
+  uint32_t written = 0;
+  while (true) {
+    written += libtock_stdout_buffer_write(data + written, len - written);
+    if (written == len) break;
+    // The buffer is full, wait for a console write to complete.
+    yield();
+  }
+  return (int) len;
+}
+
+void libtocksync_stdout_buffer_flush(void) {
+  while (!libtock_stdout_buffer_empty()) {
+    yield();
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <libtock/services/stdout_buffer.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Buffer stdout in `buffer` instead of blocking on every write.
+ *
+ * After this call `_write()` copies output into `buffer` and returns, and
+ * only blocks while the buffer is full. Buffered output is flushed when the
+ * process exits through `exit()` or by returning from `main()`.
+ *
+ * \param buffer storage for the ring buffer, which must stay valid for the
+ *        rest of the process.
+ * \param len size of `buffer` in bytes, a power of two.
+ * \return RETURNCODE_SUCCESS, RETURNCODE_EINVAL if `len` is not a power of
+ *         two, or
+ *         RETURNCODE_EBUSY if buffering is already enabled.
+ */
+returncode_t libtocksync_stdout_buffer_enable(uint8_t* buffer, uint32_t len);
+
+/** \brief Copy `len` bytes into the stdout buffer.
+ *
+ * Blocks only until enough of the buffer has drained to hold `data`.
+ *
+ * \return The number of bytes written, which is `len` unless buffering is
+ *         not enabled.
+ */
+int libtocksync_stdout_buffer_write(const uint8_t* data, uint32_t len);
+
+/** \brief Block until all buffered stdout has been written to the console.
+ *
+ * This does not flush the newlib `FILE` buffer, call `fflush(stdout)` first to
+ * include output that has not reached `_write()` yet.
+ */
+void libtocksync_stdout_buffer_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
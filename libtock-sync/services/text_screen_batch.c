@@ -0,0 +1,24 @@
+#include "text_screen_batch.h"
+
+struct batch_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static struct batch_data result;
+
+static void batch_done(returncode_t ret) {
+  result.fired = true;
+  result.ret   = ret;
+}
+
+returncode_t libtocksync_text_screen_batch_run(libtock_text_screen_batch_t* batch) {
+  result.fired = false;
+  returncode_t err = libtock_text_screen_batch_run(batch, batch_done);
+  if (err == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  // Wait for the callback.
+  yield_for(&result.fired);
+  return result.ret;
+}
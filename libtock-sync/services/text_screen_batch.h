@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/services/text_screen_batch.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Run the operations recorded in `batch` and wait until they are done.
+// Returns RETURNCODE_SUCCESS right away if the batch is empty.
+returncode_t libtocksync_text_screen_batch_run(libtock_text_screen_batch_t* batch);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,26 @@
+#include "udp_batch.h"
+
+struct batch_data {
+  bool fired;
+  returncode_t ret;
+  int sent;
+};
+
+static struct batch_data result;
+
+static void batch_done(returncode_t ret, int sent) {
+  result.fired = true;
+  result.ret   = ret;
+  result.sent  = sent;
+}
+
+returncode_t libtocksync_udp_send_batch(libtock_udp_datagram_t* datagrams, int count, int* sent) {
+  result.fired = false;
+  returncode_t err = libtock_udp_send_batch(datagrams, count, batch_done);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  // Wait for the callback.
+  yield_for(&result.fired);
+  if (sent) *sent = result.sent;
+  return result.ret;
+}
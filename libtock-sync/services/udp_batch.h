@@ -0,0 +1,17 @@
+#pragma once
+
+#include <libtock/services/udp_batch.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Send `count` datagrams in order and wait until all are done. `sent` may be
+// NULL. Returns the first error, if any; each datagram's `result` says
+// which failed.
+returncode_t libtocksync_udp_send_batch(libtock_udp_datagram_t* datagrams, int count, int* sent);
+
+#ifdef __cplusplus
+}
+#endif
@@ -12,8 +12,11 @@
 #include <string.h>
 
 #include "alarm.h"
+#include "benchmark.h"
 #include <libtock/kernel/ipc.h>
 
+#include <libtock/services/time.h>
+
 #include "unit_test.h"
 
 /*******************************************************************************
@@ -49,9 +52,25 @@ typedef enum {
   Failed,
 
   // Test did not complete within the timeout window.
-  Timeout
+  Timeout,
+
+  // Benchmark completed, its timings are in `metric`.
+  Measured,
 } unit_test_result_t;
 
+/**
+ * Timings of a benchmark, in nanoseconds per call.
+ */
+typedef struct {
+  char suite[24];
+  uint32_t iterations;
+  uint32_t samples;
+  uint32_t min_ns;
+  uint32_t median_ns;
+  uint32_t p99_ns;
+  uint32_t max_ns;
+} unit_test_metric_t;
+
 /**
  * Encapsulates all the state needed to coordinate a test runner with the test
  * supervisor. There is one unit_test_t structure per test runner (one test runner
@@ -65,9 +84,18 @@ struct unit_test_t {
   // Total number of individual tests this test runner will be running.
   uint32_t count;
 
-  // Current test number being run by this test runner.
+  // Current test number being run by this test runner, handed out by the
+  // supervisor. `count` once there are no tests left for it.
   uint32_t current;
 
+  // Name of the group of test runners sharing these tests, empty if the
+  // runner runs all of them itself.
+  char group[24];
+
+  // Whether the test runner must run with no other runner alongside it, as
+  // benchmarks do.
+  bool exclusive;
+
   // Current test name
   char name[24];
 
@@ -83,20 +111,50 @@ struct unit_test_t {
   // Process ID of this test runner.
   int pid;
 
+  // Supervisor state: whether the runner has been let start, the tests
+  // handed out to it if it is in no group, and its group.
+  bool running;
+  uint32_t assigned;
+  struct unit_test_group* shared;
+
   // alarm structure used for triggering test timeout conditions.
   libtock_alarm_t alarm;
 
   // Result of the most recently completed test.
   unit_test_result_t result;
 
-  // The reason a test has failed;
-  char reason[72];
+  // Time the most recently completed test function took.
+  uint32_t elapsed_us;
+
+  union {
+    // The reason a test has failed;
+    char reason[72];
+
+    // What a benchmark measured, when the result is Measured.
+    unit_test_metric_t metric;
+  };
 
   // Interior linked list element, points to the next test runner in the
   // queue.
   unit_test_t* next;
 };
 
+/**
+ * Test runners sharing one set of tests. The supervisor hands the next test
+ * not yet started to whichever member asks first, and reports one summary
+ * for the group once every member has finished.
+ */
+typedef struct unit_test_group {
+  // Empty for an unused slot.
+  char name[24];
+  uint32_t count;
+  uint32_t next;
+  uint32_t pass_count;
+  uint32_t fail_count;
+  // Members that have not finished or timed out.
+  uint32_t members;
+} unit_test_group_t;
+
 /**
  * Linked list header for basic interior linked list operations on the
  * unit_test_t struct. Only needed for optimizing the append operation.
@@ -150,10 +208,12 @@ static bool list_contains(linked_list_t* list, unit_test_t* test) {
 /**
  * Test runner's shared buffer which holds the per-test-runner unit_test_t state.
  * This must be aligned because the test runners share their buffers with the
- * test supervisor via the `ipc_share` mechanism.
+ * test supervisor via the `ipc_share` mechanism. The pointers in unit_test_t
+ * double in size in 64-bit host builds.
  */
-#define TEST_BUF_SZ 256
+#define TEST_BUF_SZ (sizeof(void*) == 4 ? 256 : 512)
 static char test_buf[TEST_BUF_SZ] __attribute__((aligned(TEST_BUF_SZ)));
+_Static_assert(sizeof(unit_test_t) <= TEST_BUF_SZ, "unit_test_t does not fit the shared buffer");
 
 /**
  * Test runner's condition variable which allows the test runner to
@@ -162,10 +222,30 @@ static char test_buf[TEST_BUF_SZ] __attribute__((aligned(TEST_BUF_SZ)));
 static bool done = false;
 
 /**
- * Test supervisor's linked list of pending test runners.
+ * Test supervisor's linked list of test runners waiting to start.
  */
 static linked_list_t pending_pids;
 
+/**
+ * Test supervisor's limit on test runners running at once, how many are
+ * running, and whether one of them must run alone.
+ */
+static uint32_t max_running   = 1;
+static uint32_t running_count = 0;
+static bool exclusive_running = false;
+
+/**
+ * Test supervisor's groups of test runners sharing tests.
+ */
+#define UNIT_TEST_MAX_GROUPS 8
+static unit_test_group_t groups[UNIT_TEST_MAX_GROUPS];
+
+/**
+ * Whether the test supervisor has printed the benchmark header yet. It is
+ * printed once, so the rows of every test runner form a single report.
+ */
+static bool bench_header_printed = false;
+
 
 /*******************************************************************************
  * TEST RUNNER FUNCTIONS
@@ -206,35 +286,37 @@ void set_failure_reason(const char* reason) {
   strncpy(failure_reason, reason, sizeof(failure_reason));
 }
 
-/** \brief Run a sequence of unit tests and report the results.
- *
- * This function is called by the IPC clients, i.e. the 'test runners'. This
- * function coordinates with the test supervisor's IPC service to run each test
- * in sequence and report the status of each one.
+// Limit set by `EXPECT_FASTER_THAN` for the current test, 0 for none.
+static uint32_t time_limit_ms;
+void set_time_limit_ms(uint32_t ms) {
+  time_limit_ms = ms;
+}
+
+static uint32_t saturate_u32(uint64_t value) {
+  return value > UINT32_MAX ? UINT32_MAX : (uint32_t) value;
+}
+
+/** \brief Connect to the test supervisor and wait for approval to start.
  *
- * \param tests An array of boolean functions which return true for PASS and
- *              false for FAIL.
- * \param test_count The total number of tests in the tests array.
- * \param timeout_ms The maximum amount of time each test is allowed to run
- *                   before being timed out.
- * \param svc_name The IPC service name of the test supervisor (e.g.
- *                 "org.tockos.unit_test")
+ * Returns the supervisor's service ID, or a negative value if it was not
+ * found.
  */
-void unit_test_runner(unit_test_fun* tests, uint32_t test_count,
-                      uint32_t timeout_ms, const char* svc_name) {
-
+static int runner_init(uint32_t test_count, uint32_t timeout_ms, const char* svc_name, const char* group,
+                       bool exclusive) {
   // Initialize the test state.
   memset(&test_buf[0], 0, TEST_BUF_SZ);
   unit_test_t* test = (unit_test_t*)(&test_buf[0]);
   test->count      = test_count;
   test->timeout_ms = timeout_ms;
+  test->exclusive  = exclusive;
+  if (group != NULL) strncpy(test->group, group, sizeof(test->group));
 
   // Establish communication with the test supervisor service. First delay 10 ms
   // to ensure the supervisor service has time to register.
   libtocksync_alarm_delay_ms(10);
   size_t test_svc;
   int err = ipc_discover(svc_name, &test_svc);
-  if (err < 0) return;
+  if (err < 0) return err;
 
   // Register the callback for cooperative scheduling.
   ipc_register_client_callback(test_svc, continue_callback, NULL);
@@ -245,21 +327,47 @@ void unit_test_runner(unit_test_fun* tests, uint32_t test_count,
   // Wait for the supervisor's approval to start running tests.
   test->cmd = TestInit;
   sync_with_supervisor(test_svc);
+  return (int) test_svc;
+}
 
-  uint32_t i = 0;
-  for (i = 0; i < test_count; i++) {
-    memcpy(test->name, tests[i].name, sizeof(test->name));
+/** \brief Run the unit tests the supervisor hands out and report the results.
+ *
+ * Shared by `unit_test_runner` and `unit_test_shard_runner`: asks the
+ * supervisor for a test, runs it and reports its result, until the
+ * supervisor has none left for this runner.
+ */
+static void run_tests(unit_test_fun* tests, uint32_t test_count, uint32_t timeout_ms, const char* svc_name,
+                      const char* group) {
+  int test_svc = runner_init(test_count, timeout_ms, svc_name, group, false);
+  if (test_svc < 0) return;
+  unit_test_t* test = (unit_test_t*)(&test_buf[0]);
 
-    // Await approval to start the current test.
+  while (true) {
+    // Await approval to start the next test, and learn which one it is.
     test->cmd = TestStart;
     sync_with_supervisor(test_svc);
+    if (test->current >= test_count) break;
+    unit_test_fun* t = &tests[test->current];
+    memcpy(test->name, t->name, sizeof(test->name));
 
     // Run the test.
     test_setup();
     failure_reason[0] = '\0';
-    bool passed = tests[i].fun();
+    time_limit_ms     = 0;
+    uint64_t start   = libtock_time_now_us64();
+    bool passed      = t->fun();
+    uint64_t elapsed = libtock_time_now_us64() - start;
     test_teardown();
 
+    // The limit is only checked for tests that otherwise passed, so a
+    // failure keeps its own reason.
+    test->elapsed_us = saturate_u32(elapsed);
+    if (passed && time_limit_ms != 0 && elapsed >= (uint64_t) time_limit_ms * 1000) {
+      snprintf(failure_reason, sizeof(failure_reason), "slower than %lu ms",
+               (unsigned long) time_limit_ms);
+      passed = false;
+    }
+
     // Record the result. If the test timed out, the supervisor will have
     // marked the result already.
     if (test->result != Timeout) {
@@ -270,9 +378,6 @@ void unit_test_runner(unit_test_fun* tests, uint32_t test_count,
     // Indicate test completion.
     test->cmd = TestEnd;
     sync_with_supervisor(test_svc);
-
-    // Move to the next test in the series.
-    test->current++;
   }
 
   // Indicate that the tests are all complete, and the app is cleaning up.
@@ -280,6 +385,88 @@ void unit_test_runner(unit_test_fun* tests, uint32_t test_count,
   sync_with_supervisor(test_svc);
 }
 
+/** \brief Run a sequence of unit tests and report the results.
+ *
+ * This function is called by the IPC clients, i.e. the 'test runners'. This
+ * function coordinates with the test supervisor's IPC service to run each test
+ * in sequence and report the status of each one.
+ *
+ * \param tests An array of boolean functions which return true for PASS and
+ *              false for FAIL.
+ * \param test_count The total number of tests in the tests array.
+ * \param timeout_ms The maximum amount of time each test is allowed to run
+ *                   before being timed out.
+ * \param svc_name The IPC service name of the test supervisor (e.g.
+ *                 "org.tockos.unit_test")
+ */
+void unit_test_runner(unit_test_fun* tests, uint32_t test_count,
+                      uint32_t timeout_ms, const char* svc_name) {
+  run_tests(tests, test_count, timeout_ms, svc_name, NULL);
+}
+
+/** \brief Run a share of a group's unit tests and report the results.
+ *
+ * Like `unit_test_runner`, but every runner passing the same `group` takes
+ * tests from one list, so copies of a test app split its tests between them.
+ */
+void unit_test_shard_runner(unit_test_fun* tests, uint32_t test_count, uint32_t timeout_ms,
+                            const char* svc_name, const char* group) {
+  run_tests(tests, test_count, timeout_ms, svc_name, group);
+}
+
+/** \brief Run a sequence of benchmarks and report their timings.
+ *
+ * The benchmark counterpart of `unit_test_runner`. Each benchmark is measured
+ * with `libtocksync_benchmark_measure` as one test, and its timings are sent to
+ * the test supervisor instead of a pass/fail result.
+ *
+ * \param suite Name the supervisor reports the timings under. Process IDs
+ *              change between runs, so this is what keeps rows comparable.
+ * \param benches An array of benchmarks, see `BENCH`.
+ * \param bench_count The total number of benchmarks in the benches array.
+ * \param timeout_ms The maximum amount of time each benchmark is allowed to
+ *                   run, including warm-up, before being timed out.
+ * \param svc_name The IPC service name of the test supervisor (e.g.
+ *                 "org.tockos.unit_test")
+ */
+void unit_test_bench_runner(const char* suite, const libtocksync_benchmark_t* benches,
+                            uint32_t bench_count, uint32_t timeout_ms, const char* svc_name) {
+  // Other runners alongside would skew the timings.
+  int test_svc = runner_init(bench_count, timeout_ms, svc_name, NULL, true);
+  if (test_svc < 0) return;
+  unit_test_t* test = (unit_test_t*)(&test_buf[0]);
+
+  while (true) {
+    // Await approval to start the next benchmark.
+    test->cmd = TestStart;
+    sync_with_supervisor(test_svc);
+    if (test->current >= bench_count) break;
+    uint32_t i = test->current;
+    strncpy(test->name, benches[i].name, sizeof(test->name));
+
+    libtocksync_benchmark_result_t result;
+    libtocksync_benchmark_measure(&benches[i], &result);
+
+    // A timed out benchmark has no timings worth sending.
+    if (test->result != Timeout) {
+      test->result = Measured;
+      strncpy(test->metric.suite, suite, sizeof(test->metric.suite));
+      test->metric.iterations = benches[i].iterations;
+      test->metric.samples    = result.samples;
+      test->metric.min_ns     = saturate_u32(result.min_ns);
+      test->metric.median_ns  = saturate_u32(result.median_ns);
+      test->metric.p99_ns     = saturate_u32(result.p99_ns);
+      test->metric.max_ns     = saturate_u32(result.max_ns);
+    }
+
+    test->cmd = TestEnd;
+    sync_with_supervisor(test_svc);
+  }
+
+  test->cmd = TestCleanup;
+  sync_with_supervisor(test_svc);
+}
+
 /*******************************************************************************
  * TEST SUPERVISOR FUNCTIONS
  ******************************************************************************/
@@ -294,19 +481,42 @@ static void print_test_result(unit_test_t* test) {
   printf("%d.%03lu: %-24s ", test->pid, test->current, name_buf);
   switch (test->result) {
     case Passed:
-      puts("[✓]");
+      printf("[✓] %lu.%03lu ms\n", test->elapsed_us / 1000, test->elapsed_us % 1000);
       break;
     case Failed:
-      printf("[FAILED] %s\n", reason_buf);
+      printf("[FAILED] %lu.%03lu ms %s\n", test->elapsed_us / 1000, test->elapsed_us % 1000, reason_buf);
       break;
     case Timeout:
       puts("[ERROR: Timeout]");
       break;
+    case Measured:
+      printf("[%lu ns]\n", test->metric.median_ns);
+      break;
     default:
       break;
   }
 }
 
+/** \brief Print the timings of a benchmark as a row of the benchmark report.
+ *
+ * Rows from every test runner start with "bench," and share one header, so
+ * they can be filtered out of the console output as a single CSV file.
+ */
+static void print_bench_row(unit_test_t* test) {
+  char name_buf[sizeof(test->name) + 1]          = {0};
+  char suite_buf[sizeof(test->metric.suite) + 1] = {0};
+  memcpy(name_buf, test->name, sizeof(test->name));
+  memcpy(suite_buf, test->metric.suite, sizeof(test->metric.suite));
+
+  if (!bench_header_printed) {
+    puts("bench,suite,name,iterations,samples,min_ns,median_ns,p99_ns,max_ns");
+    bench_header_printed = true;
+  }
+  printf("bench,%s,%s,%lu,%lu,%lu,%lu,%lu,%lu\n", suite_buf, name_buf,
+         test->metric.iterations, test->metric.samples, test->metric.min_ns,
+         test->metric.median_ns, test->metric.p99_ns, test->metric.max_ns);
+}
+
 /** \brief Print an aggregate summary of the unit test results to the console.
  */
 static void print_test_summary(unit_test_t* test) {
@@ -321,23 +531,107 @@ static void print_test_summary(unit_test_t* test) {
          incomplete, total);
 }
 
-struct alarm_cb_data {
-  unit_test_t* test;
-};
+/** \brief Print the aggregate summary of a group of test runners.
+ */
+static void print_group_summary(unit_test_group_t* group) {
+  char name_buf[sizeof(group->name) + 1] = {0};
+  memcpy(name_buf, group->name, sizeof(group->name));
+  uint32_t incomplete = group->count - (group->pass_count + group->fail_count);
+
+  printf("Summary %s: [%lu/%lu] Passed, [%lu/%lu] Failed, [%lu/%lu] Incomplete\n",
+         name_buf, group->pass_count, group->count,
+         group->fail_count, group->count,
+         incomplete, group->count);
+}
+
+/** \brief Add a test runner to the group it names, creating the group if
+ * needed.
+ *
+ * Returns NULL for a runner in no group, and for one that cannot join, which
+ * then runs all of its tests itself.
+ */
+static unit_test_group_t* join_group(unit_test_t* test) {
+  if (test->group[0] == '\0') return NULL;
+
+  unit_test_group_t* group = NULL;
+  for (int i = 0; i < UNIT_TEST_MAX_GROUPS; i++) {
+    if (strncmp(groups[i].name, test->group, sizeof(groups[i].name)) == 0) {
+      group = &groups[i];
+      break;
+    }
+    if (groups[i].name[0] == '\0' && group == NULL) {
+      group = &groups[i];
+    }
+  }
+  if (group == NULL || (group->name[0] != '\0' && group->count != test->count)) {
+    printf("%d: cannot join test group, running all tests\n", test->pid);
+    return NULL;
+  }
 
-static struct alarm_cb_data data = { .test = NULL };
+  if (group->name[0] == '\0') {
+    memset(group, 0, sizeof(*group));
+    memcpy(group->name, test->group, sizeof(group->name));
+    group->count = test->count;
+  }
+  group->members++;
+  return group;
+}
+
+/** \brief Take a finished or timed out test runner out of its group, and
+ * report the group once its last member is done.
+ */
+static void leave_group(unit_test_group_t* group) {
+  if (--group->members != 0) return;
+  print_group_summary(group);
+  group->name[0] = '\0';
+}
+
+/** \brief Let waiting test runners start, up to the limit on runners running
+ * at once.
+ *
+ * Runners start in the order they registered. One that must run alone waits
+ * for the others to finish, and holds back the ones after it.
+ */
+static void start_pending(linked_list_t* pending) {
+  while (pending->head != NULL && !exclusive_running && running_count < max_running) {
+    unit_test_t* test = pending->head;
+    if (test->exclusive && running_count > 0) return;
+
+    list_pop(pending);
+    test->running = true;
+    running_count++;
+    exclusive_running = test->exclusive;
+    ipc_notify_client(test->pid);
+  }
+}
+
+/** \brief Free a test runner's place for the next waiting one.
+ */
+static void finish_runner(unit_test_t* test) {
+  test->running = false;
+  running_count--;
+  if (test->exclusive) exclusive_running = false;
+  start_pending(&pending_pids);
+}
 
 /** \brief Timer callback for handling a test timeout.
  *
  * When a test times out, there's no guarantee about the test runner's state, so
- * we just stop the tests here and print the results.
+ * we just stop its tests here and print the results. Other test runners
+ * carry on, and the rest of a group's tests go to its other members.
  */
 static void timeout_callback(__attribute__ ((unused)) uint32_t now,
                              __attribute__ ((unused)) uint32_t scheduled,
-                             __attribute__ ((unused)) void*    opqaue) {
-  data.test->result = Timeout;
-  print_test_result(data.test);
-  print_test_summary(data.test);
+                             void*                             opaque) {
+  unit_test_t* test = (unit_test_t*) opaque;
+  test->result = Timeout;
+  print_test_result(test);
+  if (test->shared != NULL) {
+    leave_group(test->shared);
+  } else {
+    print_test_summary(test);
+  }
+  finish_runner(test);
 }
 
 /** \brief IPC service callback for coordinating test runners.
@@ -362,26 +656,31 @@ static void unit_test_service_callback(int                            pid,
 
   switch (test->cmd) {
     case TestInit:
-      // Initialize the relevant fields in the test descriptor.
-      test->pid = pid;
-
-      // Queue the test
-      if (!list_contains(pending, test)) {
+      // Queue the test runner, and start it if there is room.
+      if (!test->running && !list_contains(pending, test)) {
+        test->pid    = pid;
+        test->shared = join_group(test);
         list_append(pending, test);
+        start_pending(pending);
       }
+      break;
 
-      // If there is no other test in progress, start this test.
-      if (pending->head->pid == pid) {
-        ipc_notify_client(pid);
+    case TestStart: {
+      // Hand out the next test, from the group's list if the runner is in
+      // one.
+      uint32_t* next = test->shared != NULL ? &test->shared->next : &test->assigned;
+      if (*next >= test->count) {
+        test->current = test->count;
+        ipc_notify_client(test->pid);
+        break;
       }
-      break;
+      test->current = (*next)++;
 
-    case TestStart:
       // Start the alarm and start the test.
-      data.test = test;
-      libtock_alarm_in_ms(test->timeout_ms, timeout_callback, NULL, &test->alarm);
+      libtock_alarm_in_ms(test->timeout_ms, timeout_callback, test, &test->alarm);
       ipc_notify_client(test->pid);
       break;
+    }
 
     case TestEnd:
       // Cancel the timeout alarm since the test is now complete.
@@ -392,32 +691,46 @@ static void unit_test_service_callback(int                            pid,
       // printed. In this case, we no longer want the tests to continue,
       // as there is no guarantee about the test runner's state.
       if (test->result != Timeout) {
-        if (test->result == Passed) {
+        bool passed = test->result == Passed || test->result == Measured;
+        if (passed) {
           test->pass_count++;
         } else {
           test->fail_count++;
         }
+        if (test->shared != NULL) {
+          if (passed) {
+            test->shared->pass_count++;
+          } else {
+            test->shared->fail_count++;
+          }
+        }
         print_test_result(test);
+        if (test->result == Measured) {
+          print_bench_row(test);
+        }
         ipc_notify_client(test->pid);
       }
       break;
 
-    case TestCleanup:
-      // If the test timed out, we want to stop the further execution of tests.
-      if (test->result != Timeout) {
-        print_test_summary(test);
+    case TestCleanup: {
+      // If the test timed out, the runner has been given up on already.
+      bool finished = test->result != Timeout && test->running;
+      if (finished) {
+        if (test->shared != NULL) {
+          leave_group(test->shared);
+        } else {
+          print_test_summary(test);
+        }
       }
 
-      // Remove the completed test runner from the queue and allow it to
-      // exit.
-      list_pop(pending);
+      // Allow the completed test runner to exit, and continue with the next
+      // waiting one, if there is one.
       ipc_notify_client(test->pid);
-
-      // Continue with the next enqueued test runner, if there is one.
-      if (pending->head) {
-        ipc_notify_client(pending->head->pid);
+      if (finished) {
+        finish_runner(test);
       }
       break;
+    }
     default:
       break;
   }
@@ -428,8 +741,17 @@ static void unit_test_service_callback(int                            pid,
  * Sets up the IPC service and returns.
  */
 void unit_test_service(void) {
+  unit_test_service_parallel(1);
+}
+
+/** \brief Test supervisor entry point that runs test runners side by side.
+ *
+ * Sets up the IPC service and returns.
+ */
+void unit_test_service_parallel(uint32_t max_runners) {
   pending_pids.head = NULL;
   pending_pids.tail = NULL;
+  max_running       = max_runners > 0 ? max_runners : 1;
   ipc_register_service_callback("org.tockos.unit_test",
                                 unit_test_service_callback, &pending_pids);
 }
@@ -63,10 +63,13 @@
  * In this case, if you load both applications on the board, the serial output
  * will be:
  *
- *    2.000: pass             [✓]
- *    2.001: fail             [FAILED]
+ *    2.000: pass             [✓] 0.012 ms
+ *    2.001: fail             [FAILED] 0.011 ms
  *    2.002: timeout          [ERROR: Timeout]
  *
+ * Each completed test is followed by how long the test function took. A test
+ * that calls `EXPECT_FASTER_THAN(ms)` fails if it takes longer than that.
+ *
  * Author: Shane Leonard <shanel@stanford.edu>
  * Modified: 8/13/2017
  */
@@ -80,6 +83,8 @@ extern "C" {
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "benchmark.h"
+
 /** \brief Unit test function signature.
  *
  * All unit tests should return a boolean representing true for PASS and false
@@ -101,6 +106,16 @@ void set_failure_reason(const char* reason);
 
 #define CHECK(x) if (!(x)) { set_failure_reason(#x); return false; }
 
+/** \brief Fail the current test if it takes `ms` milliseconds or longer.
+ *
+ * The limit applies to the test function as a whole and is checked once it
+ * returns, so this may be used anywhere in the test. It does not apply to
+ * `test_setup` or `test_teardown`.
+ */
+void set_time_limit_ms(uint32_t ms);
+
+#define EXPECT_FASTER_THAN(ms) set_time_limit_ms(ms)
+
 /** \brief A test setup function */
 bool test_setup(void);
 
@@ -150,6 +165,62 @@ void test_teardown(void);
 void unit_test_runner(unit_test_fun* tests, uint32_t test_count,
                       uint32_t timeout_ms, const char* svc_name);
 
+/** \brief Unit test runner sharing its tests with other test runners.
+ *
+ * \param tests An array of boolean functions which return true for PASS and
+ *              false for FAIL.
+ * \param test_count The total number of tests in the tests array.
+ * \param timeout_ms The maximum amount of time each test is allowed to run
+ *                   before being timed out.
+ * \param svc_name The IPC service name of the test supervisor (e.g.
+ *                 "org.tockos.unit_test")
+ * \param group Name of the group of runners sharing the tests, at most 24
+ *              characters.
+ *
+ * Like `unit_test_runner`, except that every runner passing the same `group`
+ * and `test_count` takes tests from one list: the supervisor hands each test
+ * to whichever runner asks for one first. Load several copies of a test app
+ * (under different names) with a supervisor started with
+ * `unit_test_service_parallel` to spread its tests over them. The
+ * supervisor prints one summary for the whole group once every runner has
+ * finished:
+ *
+ *    3.000: pass                     [✓] 0.012 ms
+ *    4.001: fail                     [FAILED] 0.011 ms
+ *    3.002: pass_too                 [✓] 0.010 ms
+ *    Summary mysuite: [2/3] Passed, [1/3] Failed, [0/3] Incomplete
+ *
+ * A runner whose test times out is stopped as usual, and the group's
+ * remaining tests go to the other runners.
+ */
+void unit_test_shard_runner(unit_test_fun* tests, uint32_t test_count, uint32_t timeout_ms,
+                            const char* svc_name, const char* group);
+
+/** \brief Benchmark runner.
+ *
+ * \param suite Name the supervisor reports the timings under, at most 24
+ *              characters. Use the same one across runs to compare them.
+ * \param benches An array of benchmarks, registered with `BENCH` (see
+ *                benchmark.h).
+ * \param bench_count The total number of benchmarks in the benches array.
+ * \param timeout_ms The maximum amount of time each benchmark is allowed to
+ *                   run, warm-up included, before being timed out.
+ * \param svc_name The IPC service name of the test supervisor (e.g.
+ *                 "org.tockos.unit_test")
+ *
+ * Each benchmark is run like a test, and the supervisor prints its timings as
+ * a row of one report shared by every app that uses it:
+ *
+ *    bench,suite,name,iterations,samples,min_ns,median_ns,p99_ns,max_ns
+ *    bench,mylib,memcpy_1k,16,31,<ns>,<ns>,<ns>,<ns>
+ *
+ * Benchmarks that complete count as passed in the summary. A benchmark
+ * runner runs with no other test runner alongside it, even under
+ * `unit_test_service_parallel`, so the timings are not skewed.
+ */
+void unit_test_bench_runner(const char* suite, const libtocksync_benchmark_t* benches,
+                            uint32_t bench_count, uint32_t timeout_ms, const char* svc_name);
+
 /** \brief Test supervisor entry point.
  *
  * The test supervisor should call this function in main and then return.
@@ -164,6 +235,21 @@ void unit_test_runner(unit_test_fun* tests, uint32_t test_count,
  */
 void unit_test_service(void);
 
+/** \brief Test supervisor entry point that runs test runners side by side.
+ *
+ * \param max_runners How many test runners may run tests at once.
+ *
+ * Like `unit_test_service`, which runs one test runner at a time, but lets up
+ * to `max_runners` runners run their tests concurrently, each test with its
+ * own timeout. Runners start in the order they registered, and results are
+ * printed as tests complete, prefixed with the runner's process ID. A timed
+ * out runner no longer holds up the ones after it.
+ *
+ * Only load test apps together that do not share hardware or state, or
+ * they will fail each other's tests.
+ */
+void unit_test_service_parallel(uint32_t max_runners);
+
 #ifdef __cplusplus
 }
 #endif
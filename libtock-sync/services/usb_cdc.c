@@ -0,0 +1,21 @@
+#include "usb_cdc.h"
+
+returncode_t libtocksync_usb_cdc_write(const uint8_t* data, uint32_t len) {
+  uint32_t queued = 0;
+  while (true) {
+    queued += libtock_usb_cdc_write(data + queued, len - queued);
+    if (queued == len) return RETURNCODE_SUCCESS;
+    // With nothing in flight no space will free up, the send failed.
+    if (!libtock_usb_cdc_tx_busy()) return RETURNCODE_EOFF;
+    // Buffers only drain in upcalls, so nothing can change until then.
+    yield();
+  }
+}
+
+returncode_t libtocksync_usb_cdc_flush(void) {
+  while (libtock_usb_cdc_tx_busy()) {
+    yield();
+  }
+  // Only a stopped channel has no space.
+  return libtock_usb_cdc_tx_space() == 0 ? RETURNCODE_EOFF : RETURNCODE_SUCCESS;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <libtock/services/usb_cdc.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Queue all of `data` on the USB CDC channel.
+ *
+ * Blocks only while both transmit buffers are full. The channel must have
+ * been started with `libtock_usb_cdc_start()`.
+ *
+ * \return RETURNCODE_SUCCESS once every byte is queued, or RETURNCODE_EOFF
+ *         if the channel is not running or stops sending.
+ */
+returncode_t libtocksync_usb_cdc_write(const uint8_t* data, uint32_t len);
+
+/** \brief Blocks until every queued byte has been sent.
+ *
+ * \return RETURNCODE_SUCCESS, or RETURNCODE_EOFF if the channel is not
+ *         running.
+ */
+returncode_t libtocksync_usb_cdc_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
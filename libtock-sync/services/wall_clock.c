@@ -0,0 +1,23 @@
+#include "wall_clock.h"
+
+struct wall_clock_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static struct wall_clock_data result = { .fired = false };
+
+static void wall_clock_cb(returncode_t ret) {
+  result.fired = true;
+  result.ret   = ret;
+}
+
+returncode_t libtocksync_wall_clock_start(uint32_t resync_ms) {
+  result.fired = false;
+
+  returncode_t ret = libtock_wall_clock_start(resync_ms, wall_clock_cb);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  yield_for(&result.fired);
+  return result.ret;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/services/wall_clock.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Start the wall clock of `libtock/services/wall_clock.h`, resyncing every
+// `resync_ms`, and wait for the first RTC read.
+returncode_t libtocksync_wall_clock_start(uint32_t resync_ms);
+
+#ifdef __cplusplus
+}
+#endif
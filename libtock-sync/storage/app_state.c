@@ -5,22 +5,28 @@ struct app_state_data {
   returncode_t ret;
 };
 
-static struct app_state_data result = {.fired = false};
+static struct app_state_data* pending = NULL;
 
 static void app_state_cb(returncode_t ret) {
-  result.fired = true;
-  result.ret   = ret;
+  struct app_state_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
 }
 
 returncode_t libtocksync_app_state_save(void) {
   returncode_t err;
 
-  result.fired = false;
+  struct app_state_data result = { .fired = false };
 
   err = libtock_app_state_save(app_state_cb);
+  if (err == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
   if (err != RETURNCODE_SUCCESS) return err;
 
   // Wait for the callback.
+  pending = &result;
   yield_for(&result.fired);
 
   return result.ret;
@@ -0,0 +1,834 @@
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <libtock-sync/sys.h>
+
+#include "fat.h"
+#include "sdcard.h"
+
+#define SECTOR          LIBTOCKSYNC_FAT_SECTOR_SIZE
+#define NO_SECTOR       UINT32_MAX
+#define ENTRY_SIZE      32
+#define ENTRIES_PER_SEC (SECTOR / ENTRY_SIZE)
+
+#define ATTR_READ_ONLY 0x01
+#define ATTR_VOLUME_ID 0x08
+#define ATTR_DIRECTORY 0x10
+#define ATTR_ARCHIVE   0x20
+#define ATTR_LONG_NAME 0x0f
+
+#define ENTRY_FREE    0xe5
+#define ENTRY_END     0x00
+
+static uint16_t get16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+static uint32_t get32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static void put16(uint8_t* p, uint16_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+static returncode_t disk_read(uint32_t sector, uint32_t count, uint8_t* buf) {
+  if (count == 1) return libtocksync_sdcard_read_block(sector, buf, SECTOR);
+  return libtocksync_sdcard_read_blocks(sector, count, buf, count * SECTOR);
+}
+
+static returncode_t disk_write(uint32_t sector, uint32_t count, const uint8_t* buf) {
+  if (count == 1) return libtocksync_sdcard_write_block(sector, (uint8_t*) buf, SECTOR);
+  return libtocksync_sdcard_write_blocks(sector, count, (uint8_t*) buf, count * SECTOR);
+}
+
+// ------------------------------
+// Filesystem sector window
+// ------------------------------
+
+static returncode_t win_flush(libtocksync_fat_t* fs) {
+  if (!fs->win_dirty) return RETURNCODE_SUCCESS;
+
+  returncode_t ret = disk_write(fs->win_sector, 1, fs->win);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  // Keep the other FAT copies in step.
+  if (fs->win_sector >= fs->fat_start && fs->win_sector < fs->fat_start + fs->fat_sectors) {
+    for (uint32_t i = 1; i < fs->fat_count; i++) {
+      ret = disk_write(fs->win_sector + i * fs->fat_sectors, 1, fs->win);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+    }
+  }
+  fs->win_dirty = false;
+  return RETURNCODE_SUCCESS;
+}
+
+static returncode_t win_move(libtocksync_fat_t* fs, uint32_t sector) {
+  if (fs->win_sector == sector) return RETURNCODE_SUCCESS;
+
+  returncode_t ret = win_flush(fs);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  fs->win_sector = NO_SECTOR;
+  ret = disk_read(sector, 1, fs->win);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  fs->win_sector = sector;
+  return RETURNCODE_SUCCESS;
+}
+
+// Move the window to `sector` without reading it, zeroed.
+static returncode_t win_zero(libtocksync_fat_t* fs, uint32_t sector) {
+  returncode_t ret = win_flush(fs);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  memset(fs->win, 0, SECTOR);
+  fs->win_sector = sector;
+  fs->win_dirty  = true;
+  return RETURNCODE_SUCCESS;
+}
+
+// ------------------------------
+// Cluster chains
+// ------------------------------
+
+static uint32_t cluster_sector(const libtocksync_fat_t* fs, uint32_t cluster) {
+  return fs->data_start + (cluster - 2) * fs->sectors_per_cluster;
+}
+
+static uint32_t cluster_bytes(const libtocksync_fat_t* fs) {
+  return fs->sectors_per_cluster * SECTOR;
+}
+
+static bool is_end_of_chain(const libtocksync_fat_t* fs, uint32_t value) {
+  return value < 2 || value >= fs->cluster_count + 2;
+}
+
+static returncode_t fat_get(libtocksync_fat_t* fs, uint32_t cluster, uint32_t* value) {
+  uint32_t offset = cluster * (fs->fat32 ? 4 : 2);
+  returncode_t ret = win_move(fs, fs->fat_start + offset / SECTOR);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  const uint8_t* p = fs->win + offset % SECTOR;
+  *value = fs->fat32 ? get32(p) & 0x0fffffff : get16(p);
+  return RETURNCODE_SUCCESS;
+}
+
+static returncode_t fat_set(libtocksync_fat_t* fs, uint32_t cluster, uint32_t value) {
+  uint32_t offset = cluster * (fs->fat32 ? 4 : 2);
+  returncode_t ret = win_move(fs, fs->fat_start + offset / SECTOR);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  uint8_t* p = fs->win + offset % SECTOR;
+  if (fs->fat32) {
+    // The top four bits are reserved and must be kept.
+    put32(p, (get32(p) & 0xf0000000) | (value & 0x0fffffff));
+  } else {
+    put16(p, value);
+  }
+  fs->win_dirty = true;
+  return RETURNCODE_SUCCESS;
+}
+
+static uint32_t end_of_chain(const libtocksync_fat_t* fs) {
+  return fs->fat32 ? 0x0fffffff : 0xffff;
+}
+
+// Allocate a free cluster and link it after `prev`, if not zero. The cluster
+// right after `prev` is preferred, so files stay contiguous.
+static returncode_t cluster_alloc(libtocksync_fat_t* fs, uint32_t prev, uint32_t* cluster) {
+  uint32_t start = prev != 0 ? prev + 1 : fs->free_hint;
+  for (uint32_t i = 0; i < fs->cluster_count; i++) {
+    uint32_t candidate = 2 + (start - 2 + i) % fs->cluster_count;
+    uint32_t value;
+    returncode_t ret = fat_get(fs, candidate, &value);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    if (value != 0) continue;
+
+    ret = fat_set(fs, candidate, end_of_chain(fs));
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    if (prev != 0) {
+      ret = fat_set(fs, prev, candidate);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+    }
+    fs->free_hint = candidate + 1 < fs->cluster_count + 2 ? candidate + 1 : 2;
+    *cluster      = candidate;
+    return RETURNCODE_SUCCESS;
+  }
+  return RETURNCODE_ENOMEM;
+}
+
+static returncode_t chain_free(libtocksync_fat_t* fs, uint32_t cluster) {
+  while (!is_end_of_chain(fs, cluster)) {
+    uint32_t next;
+    returncode_t ret = fat_get(fs, cluster, &next);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    ret = fat_set(fs, cluster, 0);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    if (cluster < fs->free_hint) fs->free_hint = cluster;
+    cluster = next;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+// ------------------------------
+// Directories
+// ------------------------------
+
+// Sector holding entry `index` of the directory starting at `dir_cluster`,
+// zero for the FAT16 root. With `extend`, a cluster directory grows by a
+// zeroed cluster when `index` is past its end. Returns RETURNCODE_ENOSUPPORT
+// past the end otherwise.
+static returncode_t dir_sector(libtocksync_fat_t* fs, uint32_t dir_cluster, uint32_t index, bool extend,
+                               uint32_t* sector) {
+  uint32_t sector_index = index / ENTRIES_PER_SEC;
+  if (dir_cluster == 0) {
+    if (sector_index >= fs->root_sectors) return extend ? RETURNCODE_ENOMEM : RETURNCODE_ENOSUPPORT;
+    *sector = fs->root_start + sector_index;
+    return RETURNCODE_SUCCESS;
+  }
+
+  uint32_t cluster = dir_cluster;
+  for (uint32_t n = sector_index / fs->sectors_per_cluster; n > 0; n--) {
+    uint32_t next;
+    returncode_t ret = fat_get(fs, cluster, &next);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    if (is_end_of_chain(fs, next)) {
+      if (!extend) return RETURNCODE_ENOSUPPORT;
+      ret = cluster_alloc(fs, cluster, &next);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+      for (uint32_t i = 0; i < fs->sectors_per_cluster; i++) {
+        ret = win_zero(fs, cluster_sector(fs, next) + i);
+        if (ret != RETURNCODE_SUCCESS) return ret;
+      }
+    }
+    cluster = next;
+  }
+  *sector = cluster_sector(fs, cluster) + sector_index % fs->sectors_per_cluster;
+  return RETURNCODE_SUCCESS;
+}
+
+// Convert one path component to a padded 8.3 name.
+static returncode_t make_name(const char* name, size_t len, uint8_t out[11]) {
+  memset(out, ' ', 11);
+  size_t i   = 0;
+  size_t pos = 0;
+  for (; i < len && name[i] != '.'; i++) {
+    if (pos == 8) return RETURNCODE_EINVAL;
+    out[pos++] = toupper((unsigned char) name[i]);
+  }
+  if (pos == 0) return RETURNCODE_EINVAL;
+  if (i < len) {
+    i++;
+    for (pos = 8; i < len; i++) {
+      if (pos == 11 || name[i] == '.') return RETURNCODE_EINVAL;
+      out[pos++] = toupper((unsigned char) name[i]);
+    }
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+// Find `name` in a directory. On success the window holds the entry, at
+// `*sector` and `*offset`. Otherwise `*sector` and `*offset` are a free slot,
+// or NO_SECTOR if the directory has none.
+static returncode_t dir_find(libtocksync_fat_t* fs, uint32_t dir_cluster, const uint8_t name[11], uint32_t* sector,
+                             uint16_t* offset) {
+  *sector = NO_SECTOR;
+  for (uint32_t index = 0;; index++) {
+    uint32_t s;
+    returncode_t ret = dir_sector(fs, dir_cluster, index, false, &s);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    ret = win_move(fs, s);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+
+    uint16_t off     = (index % ENTRIES_PER_SEC) * ENTRY_SIZE;
+    const uint8_t* e = fs->win + off;
+    if (e[0] == ENTRY_END || e[0] == ENTRY_FREE) {
+      if (*sector == NO_SECTOR) {
+        *sector = s;
+        *offset = off;
+      }
+      if (e[0] == ENTRY_END) return RETURNCODE_ENOSUPPORT;
+      continue;
+    }
+    if ((e[11] & ATTR_LONG_NAME) == ATTR_LONG_NAME || (e[11] & ATTR_VOLUME_ID)) continue;
+    if (memcmp(e, name, 11) == 0) {
+      *sector = s;
+      *offset = off;
+      return RETURNCODE_SUCCESS;
+    }
+  }
+}
+
+static uint32_t entry_cluster(const libtocksync_fat_t* fs, const uint8_t* e) {
+  uint32_t cluster = get16(e + 26);
+  if (fs->fat32) cluster |= (uint32_t) get16(e + 20) << 16;
+  return cluster;
+}
+
+// Look up `path`. Sets `*dir_cluster` to the directory holding the last
+// component and `name` to that component, then returns as `dir_find()`.
+static returncode_t path_find(libtocksync_fat_t* fs, const char* path, uint32_t* dir_cluster, uint8_t name[11],
+                              uint32_t* sector, uint16_t* offset) {
+  *dir_cluster = fs->root_cluster;
+  while (*path == '/') path++;
+
+  while (true) {
+    const char* end = strchr(path, '/');
+    size_t len      = end != NULL ? (size_t) (end - path) : strlen(path);
+    returncode_t ret = make_name(path, len, name);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+
+    ret = dir_find(fs, *dir_cluster, name, sector, offset);
+    if (end == NULL) return ret;
+    if (ret != RETURNCODE_SUCCESS) return ret;
+
+    const uint8_t* e = fs->win + *offset;
+    if (!(e[11] & ATTR_DIRECTORY)) return RETURNCODE_ENOSUPPORT;
+    // A ".." entry pointing at the root holds cluster zero.
+    *dir_cluster = entry_cluster(fs, e);
+    if (*dir_cluster == 0) *dir_cluster = fs->root_cluster;
+
+    path = end + 1;
+    while (*path == '/') path++;
+  }
+}
+
+// ------------------------------
+// Files
+// ------------------------------
+
+static returncode_t buf_flush(libtocksync_fat_file_t* file) {
+  if (!file->buf_dirty) return RETURNCODE_SUCCESS;
+  returncode_t ret = disk_write(file->buf_sector, 1, file->buf);
+  if (ret == RETURNCODE_SUCCESS) file->buf_dirty = false;
+  return ret;
+}
+
+// Load `sector` into the file buffer. Without `fill` the sector holds no file
+// data yet and is zeroed instead of read.
+static returncode_t buf_move(libtocksync_fat_file_t* file, uint32_t sector, bool fill) {
+  if (file->buf_sector == sector) return RETURNCODE_SUCCESS;
+
+  returncode_t ret = buf_flush(file);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  file->buf_sector = NO_SECTOR;
+  if (fill) {
+    ret = disk_read(sector, 1, file->buf);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+  } else {
+    memset(file->buf, 0, SECTOR);
+  }
+  file->buf_sector = sector;
+  return RETURNCODE_SUCCESS;
+}
+
+// Find cluster `index` of the file's chain, allocating clusters up to it if
+// `allocate`. Returns RETURNCODE_ENOSUPPORT past the end of the chain.
+static returncode_t file_cluster(libtocksync_fat_file_t* file, uint32_t index, bool allocate, uint32_t* cluster) {
+  libtocksync_fat_t* fs = file->fs;
+  returncode_t ret;
+
+  if (file->start_cluster == 0) {
+    if (!allocate) return RETURNCODE_ENOSUPPORT;
+    ret = cluster_alloc(fs, 0, &file->start_cluster);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    file->entry_dirty = true;
+    file->cluster     = 0;
+  }
+  if (file->cluster == 0 || file->cluster_index > index) {
+    file->cluster       = file->start_cluster;
+    file->cluster_index = 0;
+  }
+
+  while (file->cluster_index < index) {
+    uint32_t next;
+    ret = fat_get(fs, file->cluster, &next);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    if (is_end_of_chain(fs, next)) {
+      if (!allocate) return RETURNCODE_ENOSUPPORT;
+      ret = cluster_alloc(fs, file->cluster, &next);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+    }
+    file->cluster = next;
+    file->cluster_index++;
+  }
+  *cluster = file->cluster;
+  return RETURNCODE_SUCCESS;
+}
+
+// Card sector holding the byte at the file position.
+static returncode_t pos_sector(libtocksync_fat_file_t* file, bool allocate, uint32_t* sector) {
+  libtocksync_fat_t* fs = file->fs;
+  uint32_t cluster;
+  returncode_t ret = file_cluster(file, file->pos / cluster_bytes(fs), allocate, &cluster);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  *sector = cluster_sector(fs, cluster) + (file->pos % cluster_bytes(fs)) / SECTOR;
+  return RETURNCODE_SUCCESS;
+}
+
+// Sector at the file position and the number of whole sectors, up to `max`,
+// that can be transferred from there in one go: the rest of the current
+// cluster and any clusters directly after it on the card. Leaves the cached
+// cluster at or before the one the position reaches afterwards.
+static returncode_t run_start(libtocksync_fat_file_t* file, uint32_t max, bool allocate, uint32_t* sector,
+                              uint32_t* sectors) {
+  libtocksync_fat_t* fs = file->fs;
+  returncode_t ret      = pos_sector(file, allocate, sector);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  uint32_t index   = file->cluster_index;
+  uint32_t cluster = file->cluster;
+  uint32_t n       = fs->sectors_per_cluster - (file->pos % cluster_bytes(fs)) / SECTOR;
+  while (n < max) {
+    uint32_t next;
+    ret = file_cluster(file, ++index, allocate, &next);
+    if (ret == RETURNCODE_ENOSUPPORT) break;
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    if (next != cluster + 1) break;
+    cluster = next;
+    n      += fs->sectors_per_cluster;
+  }
+  *sectors = n < max ? n : max;
+  return RETURNCODE_SUCCESS;
+}
+
+static returncode_t entry_update(libtocksync_fat_file_t* file) {
+  libtocksync_fat_t* fs = file->fs;
+  if (!file->entry_dirty) return RETURNCODE_SUCCESS;
+
+  returncode_t ret = win_move(fs, file->entry_sector);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  uint8_t* e = fs->win + file->entry_offset;
+  e[11] |= ATTR_ARCHIVE;
+  put16(e + 20, file->start_cluster >> 16);
+  put16(e + 26, file->start_cluster);
+  put32(e + 28, file->size);
+  fs->win_dirty     = true;
+  file->entry_dirty = false;
+  return RETURNCODE_SUCCESS;
+}
+
+// Release the clusters after the ones holding the file's data.
+static returncode_t release_unused(libtocksync_fat_file_t* file) {
+  libtocksync_fat_t* fs = file->fs;
+  if (file->start_cluster == 0) return RETURNCODE_SUCCESS;
+
+  returncode_t ret;
+  if (file->size == 0) {
+    ret = chain_free(fs, file->start_cluster);
+    file->start_cluster = 0;
+    file->cluster       = 0;
+    file->entry_dirty   = true;
+    return ret;
+  }
+
+  uint32_t last;
+  ret = file_cluster(file, (file->size - 1) / cluster_bytes(fs), false, &last);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  uint32_t next;
+  ret = fat_get(fs, last, &next);
+  if (ret != RETURNCODE_SUCCESS || is_end_of_chain(fs, next)) return ret;
+  ret = fat_set(fs, last, end_of_chain(fs));
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  return chain_free(fs, next);
+}
+
+returncode_t libtocksync_fat_mount(libtocksync_fat_t* fs) {
+  uint32_t block_size;
+  returncode_t ret = libtocksync_sdcard_initialize(&block_size, NULL);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (block_size != SECTOR) return RETURNCODE_ENOSUPPORT;
+
+  fs->win_sector = NO_SECTOR;
+  fs->win_dirty  = false;
+  ret = win_move(fs, 0);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (fs->win[510] != 0x55 || fs->win[511] != 0xaa) return RETURNCODE_ENOSUPPORT;
+
+  // A boot sector starts with a jump; otherwise look for a FAT partition in
+  // the MBR.
+  uint32_t volume = 0;
+  if (fs->win[0] != 0xeb && fs->win[0] != 0xe9) {
+    for (int i = 0; i < 4 && volume == 0; i++) {
+      const uint8_t* part = fs->win + 446 + i * 16;
+      uint8_t type        = part[4];
+      if (type == 0x04 || type == 0x06 || type == 0x0e || type == 0x0b || type == 0x0c) volume = get32(part + 8);
+    }
+    if (volume == 0) return RETURNCODE_ENOSUPPORT;
+    ret = win_move(fs, volume);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+  }
+
+  const uint8_t* bpb = fs->win;
+  if (get16(bpb + 11) != SECTOR || bpb[13] == 0 || bpb[16] == 0) return RETURNCODE_ENOSUPPORT;
+
+  uint32_t fat_sectors   = get16(bpb + 22) != 0 ? get16(bpb + 22) : get32(bpb + 36);
+  uint32_t total_sectors = get16(bpb + 19) != 0 ? get16(bpb + 19) : get32(bpb + 32);
+  uint32_t root_entries  = get16(bpb + 17);
+
+  fs->sectors_per_cluster = bpb[13];
+  fs->fat_count           = bpb[16];
+  fs->fat_start           = volume + get16(bpb + 14);
+  fs->fat_sectors         = fat_sectors;
+  fs->root_start          = fs->fat_start + fs->fat_count * fat_sectors;
+  fs->root_sectors        = (root_entries * ENTRY_SIZE + SECTOR - 1) / SECTOR;
+  fs->data_start          = fs->root_start + fs->root_sectors;
+  if (total_sectors <= fs->data_start - volume) return RETURNCODE_ENOSUPPORT;
+  fs->cluster_count = (total_sectors - (fs->data_start - volume)) / fs->sectors_per_cluster;
+
+  // The FAT type follows from the cluster count alone. FAT12 is not supported.
+  if (fs->cluster_count < 4085) return RETURNCODE_ENOSUPPORT;
+  fs->fat32        = fs->cluster_count >= 65525;
+  fs->root_cluster = fs->fat32 ? get32(bpb + 44) : 0;
+  fs->free_hint    = 2;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtocksync_fat_open(libtocksync_fat_t* fs, libtocksync_fat_file_t* file, const char* path,
+                                  uint8_t flags) {
+  uint32_t dir_cluster, sector;
+  uint16_t offset;
+  uint8_t name[11];
+
+  returncode_t ret = path_find(fs, path, &dir_cluster, name, &sector, &offset);
+  if (ret == RETURNCODE_ENOSUPPORT && (flags & LIBTOCKSYNC_FAT_CREATE) && sector == NO_SECTOR) {
+    // The directory is full, grow it.
+    uint32_t index = 0;
+    while (dir_sector(fs, dir_cluster, index, false, &sector) == RETURNCODE_SUCCESS) index += ENTRIES_PER_SEC;
+    ret = dir_sector(fs, dir_cluster, index, true, &sector);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    offset = 0;
+    ret    = RETURNCODE_ENOSUPPORT;
+  }
+
+  if (ret == RETURNCODE_ENOSUPPORT && (flags & LIBTOCKSYNC_FAT_CREATE)) {
+    ret = win_move(fs, sector);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    uint8_t* e = fs->win + offset;
+    memset(e, 0, ENTRY_SIZE);
+    memcpy(e, name, 11);
+    e[11]         = ATTR_ARCHIVE;
+    fs->win_dirty = true;
+  } else if (ret != RETURNCODE_SUCCESS) {
+    return ret;
+  }
+
+  const uint8_t* e = fs->win + offset;
+  if (e[11] & ATTR_DIRECTORY) return RETURNCODE_EINVAL;
+  if ((e[11] & ATTR_READ_ONLY) && (flags & (LIBTOCKSYNC_FAT_WRITE | LIBTOCKSYNC_FAT_TRUNCATE))) {
+    return RETURNCODE_EINVAL;
+  }
+
+  file->fs            = fs;
+  file->flags         = flags;
+  file->entry_sector  = sector;
+  file->entry_offset  = offset;
+  file->entry_dirty   = false;
+  file->start_cluster = entry_cluster(fs, e);
+  file->size          = get32(e + 28);
+  file->pos           = 0;
+  file->cluster       = 0;
+  file->cluster_index = 0;
+  file->buf_sector    = NO_SECTOR;
+  file->buf_dirty     = false;
+  file->open          = true;
+
+  if ((flags & LIBTOCKSYNC_FAT_TRUNCATE) && file->start_cluster != 0) {
+    ret = chain_free(fs, file->start_cluster);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    file->start_cluster = 0;
+    file->size          = 0;
+    file->entry_dirty   = true;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtocksync_fat_read(libtocksync_fat_file_t* file, void* buf, uint32_t len, uint32_t* count) {
+  uint8_t* out = buf;
+  *count = 0;
+  if (!file->open || !(file->flags & LIBTOCKSYNC_FAT_READ)) return RETURNCODE_EINVAL;
+  if (len > file->size - file->pos) len = file->size - file->pos;
+
+  while (len > 0) {
+    uint32_t in_sector = file->pos % SECTOR;
+    uint32_t sector;
+    returncode_t ret;
+
+    if (in_sector == 0 && len >= SECTOR) {
+      // Whole sectors go straight to the caller.
+      uint32_t sectors;
+      ret = run_start(file, len / SECTOR, false, &sector, &sectors);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+      if (file->buf_dirty && file->buf_sector >= sector && file->buf_sector < sector + sectors) {
+        ret = buf_flush(file);
+        if (ret != RETURNCODE_SUCCESS) return ret;
+      }
+      ret = disk_read(sector, sectors, out);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+
+      uint32_t n = sectors * SECTOR;
+      out       += n;
+      file->pos += n;
+      *count    += n;
+      len       -= n;
+      continue;
+    }
+
+    ret = pos_sector(file, false, &sector);
+    if (ret == RETURNCODE_SUCCESS) ret = buf_move(file, sector, true);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+
+    uint32_t n = SECTOR - in_sector;
+    if (n > len) n = len;
+    memcpy(out, file->buf + in_sector, n);
+    out       += n;
+    file->pos += n;
+    *count    += n;
+    len       -= n;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtocksync_fat_write(libtocksync_fat_file_t* file, const void* buf, uint32_t len) {
+  const uint8_t* in = buf;
+  if (!file->open || !(file->flags & LIBTOCKSYNC_FAT_WRITE)) return RETURNCODE_EINVAL;
+  if (file->flags & LIBTOCKSYNC_FAT_APPEND) file->pos = file->size;
+  if (len > UINT32_MAX - file->pos) return RETURNCODE_ESIZE;
+
+  while (len > 0) {
+    uint32_t in_sector = file->pos % SECTOR;
+    uint32_t sector;
+    uint32_t n;
+    returncode_t ret;
+
+    if (in_sector == 0 && len >= SECTOR) {
+      uint32_t sectors;
+      ret = run_start(file, len / SECTOR, true, &sector, &sectors);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+      // The buffered sector is overwritten.
+      if (file->buf_sector >= sector && file->buf_sector < sector + sectors) {
+        file->buf_sector = NO_SECTOR;
+        file->buf_dirty  = false;
+      }
+      ret = disk_write(sector, sectors, in);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+      n = sectors * SECTOR;
+    } else {
+      ret = pos_sector(file, true, &sector);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+      // Only read back a sector that already holds data.
+      ret = buf_move(file, sector, file->pos - in_sector < file->size);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+
+      n = SECTOR - in_sector;
+      if (n > len) n = len;
+      memcpy(file->buf + in_sector, in, n);
+      file->buf_dirty = true;
+    }
+
+    in        += n;
+    file->pos += n;
+    len       -= n;
+    if (file->pos > file->size) {
+      file->size        = file->pos;
+      file->entry_dirty = true;
+    }
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtocksync_fat_seek(libtocksync_fat_file_t* file, uint32_t offset) {
+  if (!file->open || offset > file->size) return RETURNCODE_EINVAL;
+  file->pos = offset;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtocksync_fat_preallocate(libtocksync_fat_file_t* file, uint32_t len) {
+  if (!file->open || !(file->flags & LIBTOCKSYNC_FAT_WRITE)) return RETURNCODE_EINVAL;
+  if (len == 0) return RETURNCODE_SUCCESS;
+  if (len > UINT32_MAX - file->size) return RETURNCODE_ESIZE;
+
+  uint32_t cluster;
+  return file_cluster(file, (file->size + len - 1) / cluster_bytes(file->fs), true, &cluster);
+}
+
+returncode_t libtocksync_fat_sync(libtocksync_fat_file_t* file) {
+  if (!file->open) return RETURNCODE_EINVAL;
+
+  returncode_t ret = buf_flush(file);
+  if (ret == RETURNCODE_SUCCESS) ret = entry_update(file);
+  if (ret == RETURNCODE_SUCCESS) ret = win_flush(file->fs);
+  return ret;
+}
+
+returncode_t libtocksync_fat_close(libtocksync_fat_file_t* file) {
+  if (!file->open) return RETURNCODE_EINVAL;
+
+  returncode_t ret = RETURNCODE_SUCCESS;
+  if (file->flags & LIBTOCKSYNC_FAT_WRITE) ret = release_unused(file);
+  if (ret == RETURNCODE_SUCCESS) ret = libtocksync_fat_sync(file);
+  file->open = false;
+  return ret;
+}
+
+returncode_t libtocksync_fat_unlink(libtocksync_fat_t* fs, const char* path) {
+  uint32_t dir_cluster, sector;
+  uint16_t offset;
+  uint8_t name[11];
+
+  returncode_t ret = path_find(fs, path, &dir_cluster, name, &sector, &offset);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  uint8_t* e = fs->win + offset;
+  if (e[11] & ATTR_DIRECTORY) return RETURNCODE_EINVAL;
+  uint32_t cluster = entry_cluster(fs, e);
+  e[0]          = ENTRY_FREE;
+  fs->win_dirty = true;
+
+  ret = chain_free(fs, cluster);
+  if (ret == RETURNCODE_SUCCESS) ret = win_flush(fs);
+  return ret;
+}
+
+// ------------------------------
+// Newlib file calls
+// ------------------------------
+
+#define FIRST_FD 3
+
+static libtocksync_fat_t* stdio_fs;
+static libtocksync_fat_file_t stdio_files[LIBTOCKSYNC_FAT_STDIO_FILES];
+
+static int set_errno(returncode_t ret) {
+  switch (ret) {
+    case RETURNCODE_ENOSUPPORT: errno = ENOENT; break;
+    case RETURNCODE_ENOMEM:     errno = ENOSPC; break;
+    case RETURNCODE_EINVAL:     errno = EINVAL; break;
+    case RETURNCODE_ESIZE:      errno = EFBIG; break;
+    default:                    errno = EIO; break;
+  }
+  return -1;
+}
+
+static libtocksync_fat_file_t* stdio_file(int fd) {
+  int i = fd - FIRST_FD;
+  if (i < 0 || i >= LIBTOCKSYNC_FAT_STDIO_FILES || !stdio_files[i].open) return NULL;
+  return &stdio_files[i];
+}
+
+static int stdio_open(const char* path, int flags) {
+  int i = 0;
+  while (i < LIBTOCKSYNC_FAT_STDIO_FILES && stdio_files[i].open) i++;
+  if (i == LIBTOCKSYNC_FAT_STDIO_FILES) {
+    errno = EMFILE;
+    return -1;
+  }
+
+  uint8_t fat_flags = 0;
+  switch (flags & O_ACCMODE) {
+    case O_RDONLY: fat_flags = LIBTOCKSYNC_FAT_READ; break;
+    case O_WRONLY: fat_flags = LIBTOCKSYNC_FAT_WRITE; break;
+    default:       fat_flags = LIBTOCKSYNC_FAT_READ | LIBTOCKSYNC_FAT_WRITE; break;
+  }
+  if (flags & O_CREAT) fat_flags |= LIBTOCKSYNC_FAT_CREATE;
+  if (flags & O_TRUNC) fat_flags |= LIBTOCKSYNC_FAT_TRUNCATE;
+  if (flags & O_APPEND) fat_flags |= LIBTOCKSYNC_FAT_APPEND;
+
+  returncode_t ret = libtocksync_fat_open(stdio_fs, &stdio_files[i], path, fat_flags);
+  if (ret != RETURNCODE_SUCCESS) return set_errno(ret);
+  return FIRST_FD + i;
+}
+
+static int stdio_close(int fd) {
+  libtocksync_fat_file_t* file = stdio_file(fd);
+  if (file == NULL) {
+    errno = EBADF;
+    return -1;
+  }
+  returncode_t ret = libtocksync_fat_close(file);
+  return ret == RETURNCODE_SUCCESS ? 0 : set_errno(ret);
+}
+
+static int stdio_read(int fd, void* buf, uint32_t count) {
+  libtocksync_fat_file_t* file = stdio_file(fd);
+  if (file == NULL) {
+    errno = EBADF;
+    return -1;
+  }
+  uint32_t done;
+  returncode_t ret = libtocksync_fat_read(file, buf, count, &done);
+  return ret == RETURNCODE_SUCCESS ? (int) done : set_errno(ret);
+}
+
+static int stdio_write(int fd, const void* buf, uint32_t count) {
+  libtocksync_fat_file_t* file = stdio_file(fd);
+  if (file == NULL) {
+    errno = EBADF;
+    return -1;
+  }
+  returncode_t ret = libtocksync_fat_write(file, buf, count);
+  return ret == RETURNCODE_SUCCESS ? (int) count : set_errno(ret);
+}
+
+static int stdio_lseek(int fd, int offset, int whence) {
+  libtocksync_fat_file_t* file = stdio_file(fd);
+  if (file == NULL) {
+    errno = EBADF;
+    return -1;
+  }
+  int64_t base = whence == SEEK_CUR ? file->pos : whence == SEEK_END ? file->size : 0;
+  int64_t pos  = base + offset;
+  if (pos < 0 || pos > file->size) {
+    errno = EINVAL;
+    return -1;
+  }
+  file->pos = pos;
+  return pos;
+}
+
+static int stdio_fstat(int fd, struct stat* st) {
+  libtocksync_fat_file_t* file = stdio_file(fd);
+  if (file == NULL) {
+    errno = EBADF;
+    return -1;
+  }
+  memset(st, 0, sizeof(*st));
+  st->st_mode    = S_IFREG;
+  st->st_size    = file->size;
+  st->st_blksize = SECTOR;
+  return 0;
+}
+
+static int stdio_unlink(const char* path) {
+  returncode_t ret = libtocksync_fat_unlink(stdio_fs, path);
+  return ret == RETURNCODE_SUCCESS ? 0 : set_errno(ret);
+}
+
+static const libtocksync_sys_file_ops_t stdio_ops = {
+  .open   = stdio_open,
+  .close  = stdio_close,
+  .read   = stdio_read,
+  .write  = stdio_write,
+  .lseek  = stdio_lseek,
+  .fstat  = stdio_fstat,
+  .unlink = stdio_unlink,
+};
+
+void libtocksync_fat_stdio_attach(libtocksync_fat_t* fs) {
+  stdio_fs = fs;
+  libtocksync_sys_set_file_ops(&stdio_ops);
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// FAT16 and FAT32 filesystem on the SD card.
+//
+// Files are opened by path, with `/` separating directories, and use 8.3
+// names; long file names are ignored. Directories can be read through but not
+// created.
+//
+// Filesystem sectors (the FAT and directories) go through a one-sector
+// write-back window, so appending to a file touches the FAT once per
+// cluster. File data moves through a one-sector buffer per file, while
+// sector-aligned reads and writes of whole sectors go straight between the
+// card and the caller's buffer, as one multi-block transfer for each run of
+// consecutive sectors. New clusters are taken right after the previous one
+// whenever that is free, and `libtocksync_fat_preallocate()` reserves them
+// ahead of time, so a log streamed to the card is written sequentially.
+//
+// `libtocksync_fat_stdio_attach()` makes the filesystem available through
+// the newlib file calls, so `fopen()`, `fprintf()` and friends work.
+//
+// Nothing reaches the card until a file is synced or closed, or its sector
+// buffer moves on. Timestamps are not maintained.
+
+#define LIBTOCKSYNC_FAT_SECTOR_SIZE 512
+
+// Open flags.
+#define LIBTOCKSYNC_FAT_READ     0x01
+#define LIBTOCKSYNC_FAT_WRITE    0x02
+// Create the file if it does not exist.
+#define LIBTOCKSYNC_FAT_CREATE   0x04
+// Discard the contents of an existing file.
+#define LIBTOCKSYNC_FAT_TRUNCATE 0x08
+// Write at the end of the file.
+#define LIBTOCKSYNC_FAT_APPEND   0x10
+
+// Number of files the newlib calls can have open at once.
+#ifndef LIBTOCKSYNC_FAT_STDIO_FILES
+#define LIBTOCKSYNC_FAT_STDIO_FILES 2
+#endif
+
+typedef struct {
+  bool fat32;
+  uint8_t sectors_per_cluster;
+  uint8_t fat_count;
+  uint32_t fat_start;
+  uint32_t fat_sectors;
+  // FAT16 fixed root directory, unused on FAT32.
+  uint32_t root_start;
+  uint32_t root_sectors;
+  // First cluster of the root directory on FAT32, zero on FAT16.
+  uint32_t root_cluster;
+  uint32_t data_start;
+  uint32_t cluster_count;
+  // Where to look for a free cluster next.
+  uint32_t free_hint;
+  // Filesystem sector window.
+  uint32_t win_sector;
+  bool win_dirty;
+  uint8_t win[LIBTOCKSYNC_FAT_SECTOR_SIZE];
+} libtocksync_fat_t;
+
+typedef struct {
+  libtocksync_fat_t* fs;
+  uint8_t flags;
+  bool open;
+  // Location of the directory entry.
+  uint32_t entry_sector;
+  uint16_t entry_offset;
+  bool entry_dirty;
+  uint32_t start_cluster;
+  uint32_t size;
+  uint32_t pos;
+  // A cluster of the chain and its index in it, to avoid walking the chain
+  // from the start. Zero if unknown.
+  uint32_t cluster;
+  uint32_t cluster_index;
+  // File data sector buffer.
+  uint32_t buf_sector;
+  bool buf_dirty;
+  uint8_t buf[LIBTOCKSYNC_FAT_SECTOR_SIZE];
+} libtocksync_fat_file_t;
+
+// Initialize the SD card and mount the FAT filesystem on it, either on the
+// whole card or on the first FAT partition.
+//
+// Returns RETURNCODE_ENOSUPPORT if there is no FAT16 or FAT32 filesystem
+// with 512-byte sectors.
+returncode_t libtocksync_fat_mount(libtocksync_fat_t* fs);
+
+// Open the file at `path`.
+//
+// Returns RETURNCODE_ENOSUPPORT if the file or a directory on the way does
+// not exist, RETURNCODE_EINVAL if `path` is not made of 8.3 names or names a
+// directory, and RETURNCODE_ENOMEM if a fixed root directory is full.
+returncode_t libtocksync_fat_open(libtocksync_fat_t* fs, libtocksync_fat_file_t* file, const char* path,
+                                  uint8_t flags);
+
+// Read up to `len` bytes at the file position and set `*count` to the number
+// read, which is only below `len` at the end of the file.
+returncode_t libtocksync_fat_read(libtocksync_fat_file_t* file, void* buf, uint32_t len, uint32_t* count);
+
+// Write `len` bytes at the file position, growing the file as needed.
+//
+// Returns RETURNCODE_ENOMEM if the card is full, in which case part of the
+// data may have been written.
+returncode_t libtocksync_fat_write(libtocksync_fat_file_t* file, const void* buf, uint32_t len);
+
+// Move the file position to `offset`. Returns RETURNCODE_EINVAL past the end
+// of the file.
+returncode_t libtocksync_fat_seek(libtocksync_fat_file_t* file, uint32_t offset);
+
+// Reserve clusters for `len` more bytes after the end of the file, so later
+// writes need no allocation. Reserved clusters not written to are released
+// when the file is closed.
+returncode_t libtocksync_fat_preallocate(libtocksync_fat_file_t* file, uint32_t len);
+
+// Write buffered data and the file size to the card.
+returncode_t libtocksync_fat_sync(libtocksync_fat_file_t* file);
+
+// Sync and close the file.
+returncode_t libtocksync_fat_close(libtocksync_fat_file_t* file);
+
+// Delete the file at `path`.
+returncode_t libtocksync_fat_unlink(libtocksync_fat_t* fs, const char* path);
+
+// Route the newlib file calls (`_open()`, `_read()`, `_write()`, ...) for
+// paths and file descriptors other than the console to `fs`.
+void libtocksync_fat_stdio_attach(libtocksync_fat_t* fs);
+
+#ifdef __cplusplus
+}
+#endif
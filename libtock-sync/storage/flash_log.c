@@ -0,0 +1,10 @@
+#include "flash_log.h"
+
+returncode_t libtocksync_flash_log_flush(void) {
+  while (1) {
+    returncode_t ret = libtock_flash_log_flush();
+    if (ret == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    yield();
+  }
+}
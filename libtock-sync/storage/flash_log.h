@@ -0,0 +1,16 @@
+#pragma once
+
+#include <libtock/storage/flash_log.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wait until every appended record is on flash, such as before a planned
+// restart.
+returncode_t libtocksync_flash_log_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,3 +1,5 @@
+#include <libtock-sync/services/alarm.h>
+
 #include "kv.h"
 
 struct kv_data {
@@ -6,75 +8,254 @@ struct kv_data {
   returncode_t ret;
 };
 
-static struct kv_data result = {.fired = false};
+static struct kv_data* pending = NULL;
 
 static void kv_cb_get(returncode_t ret, int length) {
-  result.fired  = true;
-  result.length = length;
-  result.ret    = ret;
+  struct kv_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired  = true;
+  op->length = length;
+  op->ret    = ret;
 }
 
 static void kv_cb_done(returncode_t ret) {
-  result.fired = true;
-  result.ret   = ret;
+  struct kv_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
 }
 
-returncode_t libtocksync_kv_get(const uint8_t* key_buffer, uint32_t key_len, uint8_t* ret_buffer, uint32_t ret_len,
-                                uint32_t* value_len) {
+static void kv_cb_many(returncode_t ret, size_t succeeded) {
+  struct kv_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired  = true;
+  op->length = succeeded;
+  op->ret    = ret;
+}
+
+// Wait for the callback of the operation just started, for at most
+// `timeout_ms` if `timed`. On timeout the operation is abandoned: its upcall
+// is removed and its buffers are revoked, so the kernel can no longer write
+// into them.
+static returncode_t kv_wait(struct kv_data* result, bool timed, uint32_t timeout_ms) {
+  pending = result;
+  if (!timed) {
+    yield_for(&result->fired);
+    return result->ret;
+  }
+
+  if (libtocksync_alarm_yield_for_with_timeout(&result->fired, timeout_ms) != RETURNCODE_SUCCESS) {
+    pending = NULL;
+    libtock_kv_set_upcall(NULL, NULL);
+    libtock_kv_set_readonly_allow_key_buffer(NULL, 0);
+    libtock_kv_set_readonly_allow_input_buffer(NULL, 0);
+    libtock_kv_set_readwrite_allow_output_buffer(NULL, 0);
+    return RETURNCODE_ECANCEL;
+  }
+  return result->ret;
+}
+
+static returncode_t kv_get(const uint8_t* key_buffer, uint32_t key_len, uint8_t* ret_buffer, uint32_t ret_len,
+                           uint32_t* value_len, bool timed, uint32_t timeout_ms) {
   returncode_t err;
-  result.fired = false;
+  struct kv_data result = { .fired = false };
+
+  // A queued set is newer than anything in the store.
+  err = libtock_kv_queue_lookup(key_buffer, key_len, ret_buffer, ret_len, value_len);
+  if (err != RETURNCODE_EOFF) return err;
+
+  err = libtock_kv_cache_lookup(key_buffer, key_len, ret_buffer, ret_len, value_len);
+  if (err != RETURNCODE_EOFF) return err;
 
   err = libtock_kv_get(key_buffer, key_len, ret_buffer, ret_len, kv_cb_get);
   if (err != RETURNCODE_SUCCESS) return err;
 
   // Wait for the callback.
-  yield_for(&result.fired);
-  if (result.ret != RETURNCODE_SUCCESS) return result.ret;
+  err = kv_wait(&result, timed, timeout_ms);
+  if (err != RETURNCODE_SUCCESS) return err;
 
   // Return the length of the retrieved value.
   *value_len = result.length;
+  libtock_kv_cache_store(key_buffer, key_len, ret_buffer, result.length);
 
   return RETURNCODE_SUCCESS;
 }
 
+// Directory kept up to date by the calls below, see
+// `libtocksync_kv_dir_track()`.
+static struct {
+  uint8_t* dir;
+  uint32_t len;
+  uint32_t capacity;
+} tracked;
+
+static returncode_t dir_write(bool timed, uint32_t timeout_ms) {
+  returncode_t err;
+  struct kv_data result = { .fired = false };
+
+  err = libtock_kv_set((const uint8_t*) LIBTOCK_KV_DIR_KEY, LIBTOCK_KV_DIR_KEY_LEN, tracked.dir, tracked.len,
+                       kv_cb_done);
+  if (err != RETURNCODE_SUCCESS) return err;
+  return kv_wait(&result, timed, timeout_ms);
+}
+
 static returncode_t kv_insert(const uint8_t* key_buffer, uint32_t key_len, const uint8_t* val_buffer,
                               uint32_t val_len, returncode_t (*op_fn)(const uint8_t*, uint32_t, const uint8_t*,
-                                                                      uint32_t, libtock_kv_callback_done)) {
+                                                                      uint32_t, libtock_kv_callback_done),
+                              bool timed, uint32_t timeout_ms) {
   returncode_t err;
-  result.fired = false;
+  struct kv_data result = { .fired = false };
+
+  // List a new key before writing its value.
+  bool listed = false;
+  if (tracked.dir != NULL && op_fn != libtock_kv_update &&
+      libtock_kv_dir_find(tracked.dir, tracked.len, key_buffer, key_len) < 0) {
+    err = libtock_kv_dir_append(tracked.dir, &tracked.len, tracked.capacity, key_buffer, key_len);
+    if (err != RETURNCODE_SUCCESS) return err;
+    listed = true;
+    err    = dir_write(timed, timeout_ms);
+    if (err != RETURNCODE_SUCCESS) {
+      libtock_kv_dir_remove(tracked.dir, &tracked.len, key_buffer, key_len);
+      return err;
+    }
+  }
 
   // Do the requested set/add/update operation.
   err = op_fn(key_buffer, key_len, val_buffer, val_len, kv_cb_done);
+  if (err == RETURNCODE_SUCCESS) {
+    // Wait for the callback.
+    err = kv_wait(&result, timed, timeout_ms);
+  }
+
+  if (err == RETURNCODE_SUCCESS) {
+    libtock_kv_cache_store(key_buffer, key_len, val_buffer, val_len);
+  } else if (listed) {
+    // The stored directory keeps the key until the next change, which is
+    // harmless.
+    libtock_kv_dir_remove(tracked.dir, &tracked.len, key_buffer, key_len);
+  }
+  return err;
+}
+
+static returncode_t kv_delete(const uint8_t* key_buffer, uint32_t key_len, bool timed, uint32_t timeout_ms) {
+  returncode_t err;
+  struct kv_data result = { .fired = false };
+
+  err = libtock_kv_delete(key_buffer, key_len, kv_cb_done);
   if (err != RETURNCODE_SUCCESS) return err;
 
   // Wait for the callback.
-  yield_for(&result.fired);
-  return result.ret;
+  err = kv_wait(&result, timed, timeout_ms);
+
+  // Unlist the key once its value is gone, or if it never had one.
+  if ((err == RETURNCODE_SUCCESS || err == RETURNCODE_ENOSUPPORT) && tracked.dir != NULL &&
+      libtock_kv_dir_find(tracked.dir, tracked.len, key_buffer, key_len) >= 0) {
+    libtock_kv_dir_remove(tracked.dir, &tracked.len, key_buffer, key_len);
+    returncode_t dir_err = dir_write(timed, timeout_ms);
+    if (err == RETURNCODE_SUCCESS) err = dir_err;
+  }
+  return err;
+}
+
+returncode_t libtocksync_kv_dir_track(uint8_t* dir, uint32_t capacity) {
+  returncode_t err;
+  struct kv_data result = { .fired = false };
+
+  tracked.dir = NULL;
+  if (dir == NULL) return RETURNCODE_SUCCESS;
+
+  err = libtock_kv_get((const uint8_t*) LIBTOCK_KV_DIR_KEY, LIBTOCK_KV_DIR_KEY_LEN, dir, capacity, kv_cb_get);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  err = kv_wait(&result, false, 0);
+  if (err == RETURNCODE_ENOSUPPORT) {
+    result.length = 0;
+  } else if (err != RETURNCODE_SUCCESS) {
+    return err;
+  }
+
+  tracked.dir      = dir;
+  tracked.len      = result.length;
+  tracked.capacity = capacity;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtocksync_kv_get(const uint8_t* key_buffer, uint32_t key_len, uint8_t* ret_buffer, uint32_t ret_len,
+                                uint32_t* value_len) {
+  return kv_get(key_buffer, key_len, ret_buffer, ret_len, value_len, false, 0);
 }
 
 returncode_t libtocksync_kv_set(const uint8_t* key_buffer, uint32_t key_len, const uint8_t* val_buffer,
                                 uint32_t val_len) {
-  return kv_insert(key_buffer, key_len, val_buffer, val_len, libtock_kv_set);
+  return kv_insert(key_buffer, key_len, val_buffer, val_len, libtock_kv_set, false, 0);
 }
 
 returncode_t libtocksync_kv_add(const uint8_t* key_buffer, uint32_t key_len, const uint8_t* val_buffer,
                                 uint32_t val_len) {
-  return kv_insert(key_buffer, key_len, val_buffer, val_len, libtock_kv_add);
+  return kv_insert(key_buffer, key_len, val_buffer, val_len, libtock_kv_add, false, 0);
 }
 
 returncode_t libtocksync_kv_update(const uint8_t* key_buffer, uint32_t key_len, const uint8_t* val_buffer,
                                    uint32_t val_len) {
-  return kv_insert(key_buffer, key_len, val_buffer, val_len, libtock_kv_update);
+  return kv_insert(key_buffer, key_len, val_buffer, val_len, libtock_kv_update, false, 0);
 }
 
 returncode_t libtocksync_kv_delete(const uint8_t* key_buffer, uint32_t key_len) {
+  return kv_delete(key_buffer, key_len, false, 0);
+}
+
+returncode_t libtocksync_kv_get_timeout(const uint8_t* key_buffer, uint32_t key_len, uint8_t* ret_buffer,
+                                        uint32_t ret_len, uint32_t* value_len, uint32_t timeout_ms) {
+  return kv_get(key_buffer, key_len, ret_buffer, ret_len, value_len, true, timeout_ms);
+}
+
+returncode_t libtocksync_kv_set_timeout(const uint8_t* key_buffer, uint32_t key_len, const uint8_t* val_buffer,
+                                        uint32_t val_len, uint32_t timeout_ms) {
+  return kv_insert(key_buffer, key_len, val_buffer, val_len, libtock_kv_set, true, timeout_ms);
+}
+
+returncode_t libtocksync_kv_add_timeout(const uint8_t* key_buffer, uint32_t key_len, const uint8_t* val_buffer,
+                                        uint32_t val_len, uint32_t timeout_ms) {
+  return kv_insert(key_buffer, key_len, val_buffer, val_len, libtock_kv_add, true, timeout_ms);
+}
+
+returncode_t libtocksync_kv_update_timeout(const uint8_t* key_buffer, uint32_t key_len, const uint8_t* val_buffer,
+                                           uint32_t val_len, uint32_t timeout_ms) {
+  return kv_insert(key_buffer, key_len, val_buffer, val_len, libtock_kv_update, true, timeout_ms);
+}
+
+returncode_t libtocksync_kv_delete_timeout(const uint8_t* key_buffer, uint32_t key_len, uint32_t timeout_ms) {
+  return kv_delete(key_buffer, key_len, true, timeout_ms);
+}
+
+static returncode_t kv_many(libtock_kv_item_t* items, size_t count,
+                            returncode_t (*op_fn)(libtock_kv_item_t*, size_t, libtock_kv_callback_many)) {
   returncode_t err;
-  result.fired = false;
+  struct kv_data result = { .fired = false };
 
-  err = libtock_kv_delete(key_buffer, key_len, kv_cb_done);
-  if (err != RETURNCODE_SUCCESS) return err;
+  // A batch whose items all fail to start completes before returning, so the
+  // result has to be in place first.
+  pending = &result;
+  err     = op_fn(items, count, kv_cb_many);
+  if (err != RETURNCODE_SUCCESS) {
+    pending = NULL;
+    return err;
+  }
 
-  // Wait for the callback.
   yield_for(&result.fired);
   return result.ret;
 }
+
+returncode_t libtocksync_kv_get_many(libtock_kv_item_t* items, size_t count) {
+  return kv_many(items, count, libtock_kv_get_many);
+}
+
+returncode_t libtocksync_kv_set_many(libtock_kv_item_t* items, size_t count) {
+  return kv_many(items, count, libtock_kv_set_many);
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <libtock/storage/kv.h>
+#include <libtock/storage/kv_cache.h>
+#include <libtock/storage/kv_iter.h>
+#include <libtock/storage/kv_queue.h>
 #include <libtock/tock.h>
 
 #ifdef __cplusplus
@@ -21,6 +24,44 @@ returncode_t libtocksync_kv_update(const uint8_t* key_buffer, uint32_t key_len,
 
 returncode_t libtocksync_kv_delete(const uint8_t* key_buffer, uint32_t key_len);
 
+// Variants of the functions above that give up after `timeout_ms`
+// milliseconds. On timeout the operation is abandoned: its callback is
+// removed, its buffers are revoked, and RETURNCODE_ECANCEL is returned. The
+// kernel may still finish the abandoned operation, so the next call can get
+// RETURNCODE_EBUSY until it has.
+
+returncode_t libtocksync_kv_get_timeout(const uint8_t* key_buffer, uint32_t key_len, uint8_t* ret_buffer,
+                                        uint32_t ret_len, uint32_t* value_len, uint32_t timeout_ms);
+
+returncode_t libtocksync_kv_set_timeout(const uint8_t* key_buffer, uint32_t key_len, const uint8_t* val_buffer,
+                                        uint32_t val_len, uint32_t timeout_ms);
+
+returncode_t libtocksync_kv_add_timeout(const uint8_t* key_buffer, uint32_t key_len, const uint8_t* val_buffer,
+                                        uint32_t val_len, uint32_t timeout_ms);
+
+returncode_t libtocksync_kv_update_timeout(const uint8_t* key_buffer, uint32_t key_len, const uint8_t* val_buffer,
+                                           uint32_t val_len, uint32_t timeout_ms);
+
+returncode_t libtocksync_kv_delete_timeout(const uint8_t* key_buffer, uint32_t key_len, uint32_t timeout_ms);
+
+// Get or set every item in `items`, waiting once for the whole batch. Each
+// item's result is in its `ret` field. Returns the first item error, or
+// RETURNCODE_SUCCESS if every item succeeded.
+returncode_t libtocksync_kv_get_many(libtock_kv_item_t* items, size_t count);
+
+returncode_t libtocksync_kv_set_many(libtock_kv_item_t* items, size_t count);
+
+// Keep the key directory used by `libtock_kv_iter_begin()` up to date. Reads
+// the directory into `dir`, which holds `capacity` bytes and must stay valid.
+// Afterwards the blocking set and add list new keys and the blocking delete
+// unlists them, costing one more write only when the set of keys changes.
+// Keys written by the asynchronous calls are not listed. Passing NULL stops
+// tracking.
+//
+// Sets and adds of new keys return RETURNCODE_ENOMEM without writing
+// anything once `dir` is full.
+returncode_t libtocksync_kv_dir_track(uint8_t* dir, uint32_t capacity);
+
 #ifdef __cplusplus
 }
 #endif
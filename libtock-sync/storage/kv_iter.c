@@ -0,0 +1,54 @@
+#include "kv_iter.h"
+
+struct iter_data {
+  bool fired;
+  size_t count;
+  returncode_t ret;
+};
+
+static struct iter_data* pending = NULL;
+
+static void iter_cb_begin(returncode_t ret) {
+  struct iter_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
+}
+
+static void iter_cb_next(returncode_t ret, size_t count) {
+  struct iter_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->count = count;
+  op->ret   = ret;
+}
+
+returncode_t libtocksync_kv_iter_begin(libtock_kv_iter_t* iter, const uint8_t* prefix, uint32_t prefix_len,
+                                       uint8_t* dir, uint32_t dir_capacity) {
+  returncode_t err;
+  struct iter_data result = { .fired = false };
+
+  err = libtock_kv_iter_begin(iter, prefix, prefix_len, dir, dir_capacity, iter_cb_begin);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  pending = &result;
+  yield_for(&result.fired);
+  return result.ret;
+}
+
+returncode_t libtocksync_kv_iter_next(libtock_kv_iter_t* iter, uint8_t* buf, uint32_t buf_len, size_t* count) {
+  returncode_t err;
+  struct iter_data result = { .fired = false };
+
+  err = libtock_kv_iter_next(iter, buf, buf_len, iter_cb_next);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  pending = &result;
+  yield_for(&result.fired);
+  *count = result.count;
+  return result.ret;
+}
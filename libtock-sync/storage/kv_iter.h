@@ -0,0 +1,21 @@
+#pragma once
+
+#include <libtock/storage/kv_iter.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Start iterating over the keys starting with `prefix`. See
+// `libtock_kv_iter_begin()`.
+returncode_t libtocksync_kv_iter_begin(libtock_kv_iter_t* iter, const uint8_t* prefix, uint32_t prefix_len,
+                                       uint8_t* dir, uint32_t dir_capacity);
+
+// Fetch the next batch of values into `buf` and set `*count` to the number
+// of entries in `iter->items`. Returns RETURNCODE_EALREADY once done.
+returncode_t libtocksync_kv_iter_next(libtock_kv_iter_t* iter, uint8_t* buf, uint32_t buf_len, size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,41 @@
+#include "kv_queue.h"
+
+struct flush_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static struct flush_data* pending = NULL;
+
+static void flush_cb(returncode_t ret) {
+  struct flush_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
+}
+
+returncode_t libtocksync_kv_queue_flush(void) {
+  struct flush_data result = { .fired = false };
+
+  pending = &result;
+  returncode_t err = libtock_kv_queue_flush(flush_cb);
+  if (err != RETURNCODE_SUCCESS) {
+    pending = NULL;
+    return err;
+  }
+
+  // Sets queued while waiting are not part of this flush, so wait for them
+  // too before the store is handed back.
+  yield_for(&result.fired);
+  returncode_t ret = result.ret;
+  while (!libtock_kv_queue_idle()) {
+    result.fired = false;
+    pending      = &result;
+    libtock_kv_queue_flush(flush_cb);
+    yield_for(&result.fired);
+    if (ret == RETURNCODE_SUCCESS) ret = result.ret;
+  }
+  return ret;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <libtock/storage/kv_queue.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Write every queued set and wait until they are stored, as for
+// `libtock_kv_queue_flush()`. Returns the first write error since the
+// previous flush. Afterwards the other KV calls can be used again.
+returncode_t libtocksync_kv_queue_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,101 @@
+#include "logstore.h"
+
+struct logstore_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static struct logstore_data* pending = NULL;
+
+static void logstore_cb(returncode_t ret) {
+  struct logstore_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
+}
+
+// Wait for the operation whose start returned `ret`. RETURNCODE_EALREADY
+// means it completed without a callback.
+static returncode_t wait_done(returncode_t ret) {
+  if (ret == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  struct logstore_data result = { .fired = false };
+  pending = &result;
+  yield_for(&result.fired);
+  return result.ret;
+}
+
+// Whether appending `key` needs an index entry that is not available.
+// Flushing cannot help then.
+static bool index_full(const libtock_logstore_t* store, uint32_t key) {
+  if (store->index_count < store->index_capacity) return false;
+  for (uint16_t i = 0; i < store->index_count; i++) {
+    if (store->index[i].key == key) return false;
+  }
+  return true;
+}
+
+enum add_kind {
+  ADD_APPEND,
+  ADD_COMPRESSED,
+  ADD_REMOVE,
+};
+
+static returncode_t try_add(libtock_logstore_t* store, uint32_t key, const void* data, uint16_t len,
+                            enum add_kind kind) {
+  switch (kind) {
+    case ADD_APPEND:
+      return libtock_logstore_append(store, key, data, len);
+    case ADD_COMPRESSED:
+      return libtock_logstore_append_compressed(store, key, data, len);
+    default:
+      return libtock_logstore_remove(store, key);
+  }
+}
+
+// Add the record until it fits, flushing full pages in between. Each flush also
+// reclaims a page, so a full buffer may take several flushes to get room.
+static returncode_t add_record(libtock_logstore_t* store, uint32_t key, const void* data, uint16_t len,
+                               enum add_kind kind) {
+  for (uint16_t i = 0; i <= store->page_count; i++) {
+    returncode_t ret = try_add(store, key, data, len, kind);
+    if (ret != RETURNCODE_ENOMEM) return ret;
+    if (kind != ADD_REMOVE && index_full(store, key)) return ret;
+
+    ret = libtock_logstore_flush(store, logstore_cb);
+    // An empty buffer that cannot take the record means the store is full.
+    if (ret == RETURNCODE_EALREADY) return RETURNCODE_ENOMEM;
+    ret = wait_done(ret);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+  }
+  return RETURNCODE_ENOMEM;
+}
+
+returncode_t libtocksync_logstore_mount(libtock_logstore_t* store) {
+  return wait_done(libtock_logstore_mount(store, logstore_cb));
+}
+
+returncode_t libtocksync_logstore_append(libtock_logstore_t* store, uint32_t key, const void* data, uint16_t len) {
+  return add_record(store, key, data, len, ADD_APPEND);
+}
+
+returncode_t libtocksync_logstore_append_compressed(libtock_logstore_t* store, uint32_t key, const void* data,
+                                                    uint16_t len) {
+  return add_record(store, key, data, len, ADD_COMPRESSED);
+}
+
+returncode_t libtocksync_logstore_remove(libtock_logstore_t* store, uint32_t key) {
+  return add_record(store, key, NULL, 0, ADD_REMOVE);
+}
+
+returncode_t libtocksync_logstore_flush(libtock_logstore_t* store) {
+  return wait_done(libtock_logstore_flush(store, logstore_cb));
+}
+
+returncode_t libtocksync_logstore_read(libtock_logstore_t* store, uint32_t key, void* buf, uint16_t len,
+                                       uint16_t* record_len) {
+  return wait_done(libtock_logstore_read(store, key, buf, len, record_len, logstore_cb));
+}
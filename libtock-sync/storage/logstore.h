@@ -0,0 +1,37 @@
+#pragma once
+
+#include <libtock/storage/logstore.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Blocking versions of the `libtock_logstore_*` operations.
+
+// Recover the store from storage.
+returncode_t libtocksync_logstore_mount(libtock_logstore_t* store);
+
+// Add a record for `key`, writing out full pages as needed.
+//
+// Returns RETURNCODE_ENOMEM if the store or its index is full.
+returncode_t libtocksync_logstore_append(libtock_logstore_t* store, uint32_t key, const void* data, uint16_t len);
+
+// Add a record for `key`, compressed if that makes it smaller.
+returncode_t libtocksync_logstore_append_compressed(libtock_logstore_t* store, uint32_t key, const void* data,
+                                                    uint16_t len);
+
+// Delete the record for `key`.
+returncode_t libtocksync_logstore_remove(libtock_logstore_t* store, uint32_t key);
+
+// Write the page buffer to storage.
+returncode_t libtocksync_logstore_flush(libtock_logstore_t* store);
+
+// Read up to `len` bytes of the record for `key` into `buf`, and set
+// `*record_len` to the full record length.
+returncode_t libtocksync_logstore_read(libtock_logstore_t* store, uint32_t key, void* buf, uint16_t len,
+                                       uint16_t* record_len);
+
+#ifdef __cplusplus
+}
+#endif
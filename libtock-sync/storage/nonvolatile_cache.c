@@ -0,0 +1,76 @@
+#include "nonvolatile_cache.h"
+
+struct cache_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static struct cache_data* pending = NULL;
+
+static void cache_cb(returncode_t ret) {
+  struct cache_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
+}
+
+// Wait for the fill or flush whose start returned `ret`.
+static returncode_t wait_done(returncode_t ret) {
+  if (ret == RETURNCODE_EALREADY) return RETURNCODE_SUCCESS;
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  struct cache_data result = { .fired = false };
+  pending = &result;
+  yield_for(&result.fired);
+  return result.ret;
+}
+
+// Run `op` on the part of the range in one page, loading the page first if it
+// is not resident.
+static returncode_t page_op(libtock_nonvolatile_cache_t* cache, uint32_t offset, uint8_t* buf, uint32_t len,
+                            bool write) {
+  while (true) {
+    returncode_t ret = write ? libtock_nonvolatile_cache_write(cache, offset, buf, len) :
+                       libtock_nonvolatile_cache_read(cache, offset, buf, len);
+    if (ret != RETURNCODE_EOFF) return ret;
+
+    ret = wait_done(libtock_nonvolatile_cache_fill(cache, offset, cache_cb));
+    if (ret != RETURNCODE_SUCCESS) return ret;
+  }
+}
+
+static returncode_t range_op(libtock_nonvolatile_cache_t* cache, uint32_t offset, uint8_t* buf, uint32_t len,
+                             bool write) {
+  if (offset > cache->storage_size || len > cache->storage_size - offset) return RETURNCODE_ESIZE;
+
+  // One page at a time, so a cache of a single page can serve any range.
+  while (len > 0) {
+    uint32_t chunk = cache->page_size - offset % cache->page_size;
+    if (chunk > len) chunk = len;
+
+    returncode_t ret = page_op(cache, offset, buf, chunk, write);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+
+    buf    += chunk;
+    offset += chunk;
+    len    -= chunk;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtocksync_nonvolatile_cache_read(libtock_nonvolatile_cache_t* cache, uint32_t offset, uint8_t* buf,
+                                                uint32_t len) {
+  return range_op(cache, offset, buf, len, false);
+}
+
+returncode_t libtocksync_nonvolatile_cache_write(libtock_nonvolatile_cache_t* cache, uint32_t offset,
+                                                 const uint8_t* data, uint32_t len) {
+  // `range_op()` only reads from `data` when writing.
+  return range_op(cache, offset, (uint8_t*) data, len, true);
+}
+
+returncode_t libtocksync_nonvolatile_cache_flush(libtock_nonvolatile_cache_t* cache) {
+  return wait_done(libtock_nonvolatile_cache_flush(cache, cache_cb));
+}
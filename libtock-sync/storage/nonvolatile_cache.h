@@ -0,0 +1,27 @@
+#pragma once
+
+#include <libtock/storage/nonvolatile_cache.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Blocking access through a `libtock_nonvolatile_cache_t`. Pages that are not
+// resident are loaded as needed, evicting the least recently used page.
+
+// Read `len` bytes at storage offset `offset` into `buf`.
+returncode_t libtocksync_nonvolatile_cache_read(libtock_nonvolatile_cache_t* cache, uint32_t offset, uint8_t* buf,
+                                                uint32_t len);
+
+// Write `len` bytes from `data` at storage offset `offset`. The data reaches
+// the storage when its pages are evicted or flushed.
+returncode_t libtocksync_nonvolatile_cache_write(libtock_nonvolatile_cache_t* cache, uint32_t offset,
+                                                 const uint8_t* data, uint32_t len);
+
+// Write every dirty page to the storage.
+returncode_t libtocksync_nonvolatile_cache_flush(libtock_nonvolatile_cache_t* cache);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,57 +1,37 @@
 #include "nonvolatile_storage.h"
 
-struct nv_data {
-  bool fired;
-  returncode_t ret;
-  int length;
-};
-
-static struct nv_data result = {.fired = false};
-
-static void write_cb(returncode_t ret, int length) {
-  result.fired  = true;
-  result.ret    = ret;
-  result.length = length;
-}
-
-static void read_cb(returncode_t ret, int length) {
-  result.fired  = true;
-  result.ret    = ret;
-  result.length = length;
-}
+#include "syscalls/nonvolatile_storage_syscalls.h"
 
 returncode_t libtocksync_nonvolatile_storage_write(uint32_t offset, uint32_t length, uint8_t* buffer,
                                                    uint32_t buffer_length, int* length_written) {
   returncode_t ret;
-  result.fired = false;
 
-  ret = libtock_nonvolatile_storage_write(offset, length, buffer, buffer_length, write_cb);
+  ret = libtock_nonvolatile_storage_set_allow_readonly_write_buffer(buffer, buffer_length);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
-  yield_for(&result.fired);
-  if (result.ret != RETURNCODE_SUCCESS) return result.ret;
+  ret = libtock_nonvolatile_storage_command_write(offset, length);
+  if (ret != RETURNCODE_SUCCESS) goto exit;
 
-  ret = libtock_nonvolatile_storage_set_allow_readonly_write_buffer(NULL, 0);
-  if (result.ret != RETURNCODE_SUCCESS) return result.ret;
+  ret = libtocksync_nonvolatile_storage_yield_wait_for_write(length_written);
 
-  *length_written = result.length;
-  return RETURNCODE_SUCCESS;
+exit:
+  libtock_nonvolatile_storage_set_allow_readonly_write_buffer(NULL, 0);
+  return ret;
 }
 
 returncode_t libtocksync_nonvolatile_storage_read(uint32_t offset, uint32_t length, uint8_t* buffer,
                                                   uint32_t buffer_length, int* length_read) {
   returncode_t ret;
-  result.fired = false;
 
-  ret = libtock_nonvolatile_storage_read(offset, length, buffer, buffer_length, read_cb);
+  ret = libtock_nonvolatile_storage_set_allow_readwrite_read_buffer(buffer, buffer_length);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
-  yield_for(&result.fired);
-  if (result.ret != RETURNCODE_SUCCESS) return result.ret;
+  ret = libtock_nonvolatile_storage_command_read(offset, length);
+  if (ret != RETURNCODE_SUCCESS) goto exit;
 
-  ret = libtock_nonvolatile_storage_set_allow_readwrite_read_buffer(NULL, 0);
-  if (result.ret != RETURNCODE_SUCCESS) return result.ret;
+  ret = libtocksync_nonvolatile_storage_yield_wait_for_read(length_read);
 
-  *length_read = result.length;
-  return RETURNCODE_SUCCESS;
+exit:
+  libtock_nonvolatile_storage_set_allow_readwrite_read_buffer(NULL, 0);
+  return ret;
 }
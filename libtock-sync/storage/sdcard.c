@@ -13,29 +13,38 @@ struct sdcard_data {
   returncode_t ret;
 };
 
-static struct sdcard_data result = {.fired = false};
+static struct sdcard_data* pending = NULL;
 
 static void sdcard_cb_init(returncode_t ret, uint32_t block_size, uint32_t size_in_kB) {
-  result.fired      = true;
-  result.block_size = block_size;
-  result.size_in_kB = size_in_kB;
-  result.ret        = ret;
+  struct sdcard_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired      = true;
+  op->block_size = block_size;
+  op->size_in_kB = size_in_kB;
+  op->ret        = ret;
 }
 
 static void sdcard_cb_general(returncode_t ret) {
-  result.fired = true;
-  result.ret   = ret;
+  struct sdcard_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
 }
 
 
 returncode_t libtocksync_sdcard_initialize(uint32_t* block_size, uint32_t* size_in_kB) {
   returncode_t ret;
-  result.fired = false;
+  struct sdcard_data result = { .fired = false };
 
   ret = libtock_sdcard_initialize(sdcard_cb_init);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // wait for callback
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -52,12 +61,13 @@ returncode_t libtocksync_sdcard_initialize(uint32_t* block_size, uint32_t* size_
 
 returncode_t libtocksync_sdcard_read_block(uint32_t sector, uint8_t* buffer, uint32_t len) {
   returncode_t ret;
-  result.fired = false;
+  struct sdcard_data result = { .fired = false };
 
   ret = libtock_sdcard_read_block(sector, buffer, len, sdcard_cb_general);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // wait for callback
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -69,12 +79,13 @@ returncode_t libtocksync_sdcard_read_block(uint32_t sector, uint8_t* buffer, uin
 
 returncode_t libtocksync_sdcard_write_block(uint32_t sector, uint8_t* buffer, uint32_t len) {
   returncode_t ret;
-  result.fired = false;
+  struct sdcard_data result = { .fired = false };
 
   ret = libtock_sdcard_write_block(sector, buffer, len, sdcard_cb_general);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   // wait for callback
+  pending = &result;
   yield_for(&result.fired);
   if (result.ret != RETURNCODE_SUCCESS) return result.ret;
 
@@ -83,3 +94,29 @@ returncode_t libtocksync_sdcard_write_block(uint32_t sector, uint8_t* buffer, ui
 
   return RETURNCODE_SUCCESS;
 }
+
+returncode_t libtocksync_sdcard_read_blocks(uint32_t sector, uint32_t count, uint8_t* buffer, uint32_t len) {
+  returncode_t ret;
+  struct sdcard_data result = { .fired = false };
+
+  ret = libtock_sdcard_read_blocks(sector, count, buffer, len, sdcard_cb_general);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  // wait for callback
+  pending = &result;
+  yield_for(&result.fired);
+  return result.ret;
+}
+
+returncode_t libtocksync_sdcard_write_blocks(uint32_t sector, uint32_t count, uint8_t* buffer, uint32_t len) {
+  returncode_t ret;
+  struct sdcard_data result = { .fired = false };
+
+  ret = libtock_sdcard_write_blocks(sector, count, buffer, len, sdcard_cb_general);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  // wait for callback
+  pending = &result;
+  yield_for(&result.fired);
+  return result.ret;
+}
@@ -16,6 +16,12 @@ returncode_t libtocksync_sdcard_read_block(uint32_t sector, uint8_t* buffer, uin
 // Write a block to the SD card.
 returncode_t libtocksync_sdcard_write_block(uint32_t sector, uint8_t* buffer, uint32_t len);
 
+// Read `count` consecutive blocks from the SD card into `buffer`.
+returncode_t libtocksync_sdcard_read_blocks(uint32_t sector, uint32_t count, uint8_t* buffer, uint32_t len);
+
+// Write `count` consecutive blocks from `buffer` to the SD card.
+returncode_t libtocksync_sdcard_write_blocks(uint32_t sector, uint32_t count, uint8_t* buffer, uint32_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,59 @@
+#include <libtock-sync/storage/sdcard.h>
+
+#include "sdcard_cache.h"
+
+struct cache_data {
+  bool fired;
+  returncode_t ret;
+};
+
+static struct cache_data* pending = NULL;
+
+static void cache_cb(returncode_t ret) {
+  struct cache_data* op = pending;
+  if (op == NULL) return;
+  pending = NULL;
+
+  op->fired = true;
+  op->ret   = ret;
+}
+
+// Let a read in flight, usually read-ahead, finish.
+static void wait_idle(libtock_sdcard_cache_t* cache) {
+  while (libtock_sdcard_cache_busy(cache)) {
+    yield();
+  }
+}
+
+returncode_t libtocksync_sdcard_cache_read(libtock_sdcard_cache_t* cache, uint32_t sector, uint8_t* buf) {
+  while (true) {
+    returncode_t ret = libtock_sdcard_cache_read(cache, sector, buf);
+    if (ret != RETURNCODE_EOFF) return ret;
+
+    // The block may be the one being read ahead.
+    wait_idle(cache);
+    ret = libtock_sdcard_cache_read(cache, sector, buf);
+    if (ret != RETURNCODE_EOFF) return ret;
+
+    struct cache_data result = { .fired = false };
+    ret = libtock_sdcard_cache_fill(cache, sector, cache_cb);
+    if (ret == RETURNCODE_EALREADY) continue;
+    if (ret != RETURNCODE_SUCCESS) return ret;
+
+    pending = &result;
+    yield_for(&result.fired);
+    if (result.ret != RETURNCODE_SUCCESS) return result.ret;
+  }
+}
+
+returncode_t libtocksync_sdcard_cache_write(libtock_sdcard_cache_t* cache, uint32_t sector, uint8_t* buf) {
+  // The card takes one command at a time, and a read of this block in flight
+  // would bring back the old data.
+  wait_idle(cache);
+
+  returncode_t ret = libtocksync_sdcard_write_block(sector, buf, cache->block_size);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  libtock_sdcard_cache_update(cache, sector, buf);
+  return RETURNCODE_SUCCESS;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <libtock/storage/sdcard_cache.h>
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Read block `sector` into `buf` through the cache, waiting for the card if
+// the block is not resident. Sequential reads are served by read-ahead.
+returncode_t libtocksync_sdcard_cache_read(libtock_sdcard_cache_t* cache, uint32_t sector, uint8_t* buf);
+
+// Write `buf` to block `sector` of the card and update the cached copy.
+returncode_t libtocksync_sdcard_cache_write(libtock_sdcard_cache_t* cache, uint32_t sector, uint8_t* buf);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wait for a nonvolatile storage read to complete.
+//
+// - `length`: Set to the number of bytes read.
+returncode_t libtocksync_nonvolatile_storage_yield_wait_for_read(int* length);
+
+// Wait for a nonvolatile storage write to complete.
+//
+// - `length`: Set to the number of bytes written.
+returncode_t libtocksync_nonvolatile_storage_yield_wait_for_write(int* length);
+
+#ifdef __cplusplus
+}
+#endif
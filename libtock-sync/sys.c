@@ -1,4 +1,11 @@
+#include <errno.h>
+#include <sys/stat.h>
+
+#include <libtock/tock_record.h>
+
 #include "interface/console.h"
+#include "services/stdout_buffer.h"
+#include "sys.h"
 
 // XXX Suppress missing prototype warnings for this file as the headers should
 // be in newlib internals, but first stab at including things didn't quite work
@@ -7,12 +14,76 @@
 #pragma GCC diagnostic ignored "-Wmissing-prototypes"
 #pragma GCC diagnostic ignored "-Wstrict-prototypes"
 
+// Installed by a filesystem. Kept behind a pointer so apps that never use
+// files do not link one in.
+static const libtocksync_sys_file_ops_t* file_ops = NULL;
+
+void libtocksync_sys_set_file_ops(const libtocksync_sys_file_ops_t* ops) {
+  file_ops = ops;
+}
+
+static bool is_file(int fd) {
+  return fd > 2 && file_ops != NULL;
+}
+
 // ------------------------------
 // SYNCHRONOUS LIBC SUPPORT STUBS
 // ------------------------------
 
-int _write(__attribute__ ((unused)) int fd, const void* buf, uint32_t count) {
+int _write(int fd, const void* buf, uint32_t count) {
+  if (is_file(fd)) return file_ops->write(fd, buf, count);
+
+  if (libtock_stdout_buffer_enabled()) {
+    return libtocksync_stdout_buffer_write((const uint8_t*) buf, count);
+  }
+
   int written;
+#ifdef TOCK_SYSCALL_RECORD
+  // `printf()` makes no system calls on the host, so a replay there would
+  // not make these.
+  bool recording = tock_record_active();
+  tock_record_stop();
   libtocksync_console_write((const uint8_t*) buf, count, &written);
+  if (recording) tock_record_resume();
+#else
+  libtocksync_console_write((const uint8_t*) buf, count, &written);
+#endif
   return written;
 }
+
+int _open(const char* path, int flags, ...) {
+  if (file_ops == NULL) {
+    errno = ENOENT;
+    return -1;
+  }
+  return file_ops->open(path, flags);
+}
+
+int _close(int fd) {
+  if (is_file(fd)) return file_ops->close(fd);
+  return -1;
+}
+
+int _read(int fd, void* buf, uint32_t count) {
+  if (is_file(fd)) return file_ops->read(fd, buf, count);
+  return 0;
+}
+
+int _lseek(int fd, uint32_t offset, int whence) {
+  if (is_file(fd)) return file_ops->lseek(fd, (int) offset, whence);
+  return 0;
+}
+
+int _fstat(int fd, struct stat* st) {
+  if (is_file(fd)) return file_ops->fstat(fd, st);
+  st->st_mode = S_IFCHR;
+  return 0;
+}
+
+int _unlink(const char* path) {
+  if (file_ops == NULL) {
+    errno = ENOENT;
+    return -1;
+  }
+  return file_ops->unlink(path);
+}
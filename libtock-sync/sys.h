@@ -0,0 +1,30 @@
+#pragma once
+
+#include <sys/stat.h>
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// File calls behind the newlib file syscalls, for file descriptors above 2.
+// Each returns -1 and sets `errno` on failure.
+typedef struct {
+  int (*open)(const char* path, int flags);
+  int (*close)(int fd);
+  int (*read)(int fd, void* buf, uint32_t count);
+  int (*write)(int fd, const void* buf, uint32_t count);
+  // `whence` is SEEK_SET, SEEK_CUR or SEEK_END. Returns the new position.
+  int (*lseek)(int fd, int offset, int whence);
+  int (*fstat)(int fd, struct stat* st);
+  int (*unlink)(const char* path);
+} libtocksync_sys_file_ops_t;
+
+// Install the file calls, replacing any earlier ones. Only the console is
+// available before this is called.
+void libtocksync_sys_set_file_ops(const libtocksync_sys_file_ops_t* ops);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+
+// Build-time configuration of libtock.
+//
+// libtock is normally built once with every feature and shared by all apps.
+// An app that sets `LIBTOCK_CONFIG` in its Makefile to the path of a header
+// instead gets its own copy of libtock and libtock-sync, built with that
+// header included here, in the `build/` directory next to the header:
+//
+//     LIBTOCK_CONFIG := libtock_config.h
+//
+// The header may define any of the options below. Unlisted options keep
+// their defaults, so an empty header builds the same library as usual.
+//
+// Options that select optional code:
+//
+// - `TOCK_SYSCALL_TRACE`: record system calls, see `tock_trace.h`.
+// - `TOCK_YIELD_TRACE`: time upcalls, deferred tasks, and yields, see
+//   `tock_trace.h`.
+// - `TOCK_SYSCALL_RECORD`: record system calls and upcalls for replay on
+//   the host, see `tock_record.h`.
+// - `LIBTOCK_PRINTF_LONG_LONG`, `LIBTOCK_PRINTF_FLOAT`: see
+//   `interface/console_printf.h`.
+//
+// Options that remove code, each defaulting to 1. Functions of a disabled
+// feature remain, so everything still links, but return
+// RETURNCODE_ENOSUPPORT without calling the kernel:
+//
+// - `LIBTOCK_ENABLE_ADC_SINGLE_SAMPLE`: `libtock_adc_single_sample()`.
+// - `LIBTOCK_ENABLE_ADC_CONTINUOUS_SAMPLE`: `libtock_adc_continuous_sample()`.
+// - `LIBTOCK_ENABLE_ADC_BUFFERED_SAMPLE`: `libtock_adc_buffered_sample()`.
+// - `LIBTOCK_ENABLE_ADC_CONTINUOUS_BUFFERED_SAMPLE`:
+//   `libtock_adc_continuous_buffered_sample()`.
+//
+// Disabling the ADC operations an app does not use also drops their cases
+// from the shared ADC upcall, so the upcall only checks for the ones left.
+
+#ifdef LIBTOCK_CONFIG_FILE
+#include LIBTOCK_CONFIG_FILE
+#endif
+
+#ifndef LIBTOCK_ENABLE_ADC_SINGLE_SAMPLE
+#define LIBTOCK_ENABLE_ADC_SINGLE_SAMPLE 1
+#endif
+
+#ifndef LIBTOCK_ENABLE_ADC_CONTINUOUS_SAMPLE
+#define LIBTOCK_ENABLE_ADC_CONTINUOUS_SAMPLE 1
+#endif
+
+#ifndef LIBTOCK_ENABLE_ADC_BUFFERED_SAMPLE
+#define LIBTOCK_ENABLE_ADC_BUFFERED_SAMPLE 1
+#endif
+
+#ifndef LIBTOCK_ENABLE_ADC_CONTINUOUS_BUFFERED_SAMPLE
+#define LIBTOCK_ENABLE_ADC_CONTINUOUS_BUFFERED_SAMPLE 1
+#endif
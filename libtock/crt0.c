@@ -1,6 +1,7 @@
+#include "peripherals/syscalls/alarm_syscalls.h"
 #include "tock.h"
+#include "tock_inline.h"
 #include <stdlib.h>
-#include <string.h>
 
 #if defined(STACK_SIZE)
 #warning Attempt to compile libtock with a fixed STACK_SIZE.
@@ -19,6 +20,116 @@ extern int main(int argc, char* argv[]);
 #pragma GCC diagnostic ignored "-Wmissing-declarations"
 #pragma GCC diagnostic ignored "-Wmissing-prototypes"
 
+// Set to 0 to skip reading the alarm counter during startup.
+#ifndef TOCK_STARTUP_TIMING
+#define TOCK_STARTUP_TIMING 1
+#endif
+
+// Alarm ticks when `_c_start_*` was entered and right before `main()`. The
+// values are kept in locals until `.data` is loaded, then stored here.
+static uint32_t startup_ticks_start;
+static uint32_t startup_ticks_main;
+
+static inline uint32_t startup_ticks(void) {
+#if TOCK_STARTUP_TIMING
+  // Inline so this works before the GOT is set up. The command fails, and
+  // leaves `data[0]` at 0, if there is no alarm driver.
+  syscall_return_t ret = tock_inline_command(DRIVER_NUM_ALARM, 2, 0, 0);
+  return ret.type == TOCK_SYSCALL_SUCCESS_U32 ? ret.data[0] : 0;
+#else
+  return 0;
+#endif
+}
+
+void tock_startup_ticks(uint32_t* at_start, uint32_t* at_main) {
+  *at_start = startup_ticks_start;
+  *at_main  = startup_ticks_main;
+}
+
+// Written over the free stack when stack painting is enabled. The bytes
+// differ so no byte-wise fill can produce it by accident.
+#define STACK_PAINT 0x5354414bu
+
+// Apps enable stack painting by defining this as true, which overrides this
+// weak default:
+//
+//     const bool tock_stack_paint = true;
+__attribute__ ((weak)) const bool tock_stack_paint = false;
+
+static uint32_t* stack_bottom;
+static uint32_t* stack_top;
+static bool stack_painted;
+
+// Record the stack bounds and, if enabled, paint everything below the
+// current stack pointer. Nothing uses the stack below `sp`, and the loop makes
+// no calls, so only the startup frames above it are left unpainted.
+static inline void stack_setup(uint32_t mem_start, uint32_t stack_size) {
+  stack_bottom = (uint32_t*)mem_start;
+  stack_top    = (uint32_t*)((mem_start + stack_size + 7) & ~(uint32_t)7);
+  if (!tock_stack_paint) return;
+
+  uint32_t* sp;
+#if defined(__thumb__)
+  __asm__ volatile ("mov %0, sp" : "=r" (sp));
+#elif defined(__riscv)
+  __asm__ volatile ("mv %0, sp" : "=r" (sp));
+#endif
+  for (uint32_t* p = stack_bottom; p < sp; p++) {
+    *p = STACK_PAINT;
+  }
+  stack_painted = true;
+}
+
+returncode_t tock_stack_high_water(uint32_t* used, uint32_t* size) {
+  *size = (stack_top - stack_bottom) * sizeof(uint32_t);
+  if (!stack_painted) return RETURNCODE_ENOSUPPORT;
+
+  // The stack grows down, so the lowest overwritten word is the deepest use.
+  uint32_t* p = stack_bottom;
+  while (p < stack_top && *p == STACK_PAINT) {
+    p++;
+  }
+  *used = (stack_top - p) * sizeof(uint32_t);
+  return RETURNCODE_SUCCESS;
+}
+
+// The linker script word-aligns the start and end of the GOT, `.data` and
+// `.bss`, so startup copies and zeroes whole words, four per iteration. The
+// empty asm hides the loop from the compiler, which would otherwise turn it
+// back into a call to newlib's byte-oriented `memcpy()` or `memset()` in
+// size-optimized builds.
+static inline void copy_words(uint32_t* dst, const uint32_t* src, uint32_t bytes) {
+  uint32_t* end = dst + bytes / sizeof(uint32_t);
+  while (end - dst >= 4) {
+    uint32_t a = src[0], b = src[1], c = src[2], d = src[3];
+    dst[0] = a;
+    dst[1] = b;
+    dst[2] = c;
+    dst[3] = d;
+    dst   += 4;
+    src   += 4;
+    __asm__ ("" : "+r" (dst), "+r" (src));
+  }
+  while (dst < end) {
+    *dst++ = *src++;
+  }
+}
+
+static inline void zero_words(uint32_t* dst, uint32_t bytes) {
+  uint32_t* end = dst + bytes / sizeof(uint32_t);
+  while (end - dst >= 4) {
+    dst[0] = 0;
+    dst[1] = 0;
+    dst[2] = 0;
+    dst[3] = 0;
+    dst   += 4;
+    __asm__ ("" : "+r" (dst));
+  }
+  while (dst < end) {
+    *dst++ = 0;
+  }
+}
+
 // The structure populated by the linker script at the very beginning of the
 // text segment. It represents sizes and offsets from the text segment of
 // sections that need some sort of loading and/or relocation.
@@ -63,6 +174,34 @@ struct reldata {
   uint32_t data[];
 };
 
+// The header and memory region the app started with, for
+// `tock_memory_layout()`. Set after `.bss` is zeroed.
+static const struct hdr* app_hdr;
+static uint32_t app_mem_start;
+
+void tock_memory_layout(tock_memory_layout_t* layout) {
+  tock_heap_usage_t heap;
+  tock_heap_usage(&heap);
+
+  layout->memory_start = (void*)app_mem_start;
+  layout->memory_end   = tock_app_memory_ends_at();
+  layout->grant_start  = tock_app_grant_begins_at();
+  layout->flash_start  = tock_app_flash_begins_at();
+  layout->flash_end    = tock_app_flash_ends_at();
+
+  layout->stack_bottom = stack_bottom;
+  layout->stack_top    = stack_top;
+  layout->got_size     = app_hdr->got_size;
+  layout->data_size    = app_hdr->data_size;
+  layout->bss_size     = app_hdr->bss_size;
+  layout->bss_end      = (void*)(app_mem_start + app_hdr->bss_start + app_hdr->bss_size);
+
+  layout->heap_start = heap.start;
+  layout->brk        = heap.brk;
+  // Granted but unused heap bytes count as free, they are the app's already.
+  layout->free = heap.free + (heap.reserved - heap.used);
+}
+
 __attribute__ ((section(".start"), used))
 __attribute__ ((weak))
 __attribute__ ((naked))
@@ -258,7 +397,8 @@ void _start(void* app_start __attribute__((unused)),
 //   app.
 __attribute__((noreturn))
 void _c_start_pic(uint32_t app_start, uint32_t mem_start) {
-  struct hdr* myhdr = (struct hdr*)app_start;
+  uint32_t ticks_start = startup_ticks();
+  struct hdr* myhdr    = (struct hdr*)app_start;
 
   // Fix up the Global Offset Table (GOT).
 
@@ -267,7 +407,8 @@ void _c_start_pic(uint32_t app_start, uint32_t mem_start) {
   // Get the address in flash of where the table currently is.
   uint32_t* got_sym_start = (uint32_t*)(myhdr->got_sym_start + app_start);
   // Iterate all entries in the table and correct the addresses.
-  for (uint32_t i = 0; i < (myhdr->got_size / (uint32_t)sizeof(uint32_t)); i++) {
+  uint32_t got_entries = myhdr->got_size / (uint32_t)sizeof(uint32_t);
+  for (uint32_t i = 0; i < got_entries; i++) {
     // Use the sentinel here. If the most significant bit is 0, then we know
     // this offset is pointing to an address in memory. If the MSB is 1, then
     // the offset refers to a value in flash.
@@ -292,14 +433,14 @@ void _c_start_pic(uint32_t app_start, uint32_t mem_start) {
 
   // Load the data section from flash into RAM. We use the offsets from our
   // crt0 header so we know where this starts and where it should go.
-  void* data_start     = (void*)(myhdr->data_start + mem_start);
-  void* data_sym_start = (void*)(myhdr->data_sym_start + app_start);
-  memcpy(data_start, data_sym_start, myhdr->data_size);
+  uint32_t* data_start     = (uint32_t*)(myhdr->data_start + mem_start);
+  uint32_t* data_sym_start = (uint32_t*)(myhdr->data_sym_start + app_start);
+  copy_words(data_start, data_sym_start, myhdr->data_size);
 
   // Zero BSS segment. Again, we know where this should be in the process RAM
   // based on the crt0 header.
-  char* bss_start = (char*)(myhdr->bss_start + mem_start);
-  memset(bss_start, 0, myhdr->bss_size);
+  uint32_t* bss_start = (uint32_t*)(myhdr->bss_start + mem_start);
+  zero_words(bss_start, myhdr->bss_size);
 
   // Do relative data address fixups. We know these entries are stored at the end
   // of flash and can be located using the crt0 header.
@@ -308,7 +449,8 @@ void _c_start_pic(uint32_t app_start, uint32_t mem_start) {
   // length field is followed by that many entries. We iterate each entry and
   // correct addresses.
   struct reldata* rd = (struct reldata*)(myhdr->reldata_start + (uint32_t)app_start);
-  for (uint32_t i = 0; i < (rd->len / (int)sizeof(uint32_t)); i += 2) {
+  uint32_t rd_words   = rd->len / (uint32_t)sizeof(uint32_t);
+  for (uint32_t i = 0; i < rd_words; i += 2) {
     // The entries are offsets from the beginning of the app's memory region.
     // First, we get a pointer to the location of the address we need to fix.
     uint32_t* target = (uint32_t*)(rd->data[i] + mem_start);
@@ -327,6 +469,12 @@ void _c_start_pic(uint32_t app_start, uint32_t mem_start) {
     }
   }
 
+  stack_setup(mem_start, myhdr->stack_size);
+  app_hdr       = myhdr;
+  app_mem_start = mem_start;
+
+  startup_ticks_start = ticks_start;
+  startup_ticks_main  = startup_ticks();
   exit(main(0, NULL));
 }
 
@@ -339,27 +487,34 @@ void _c_start_pic(uint32_t app_start, uint32_t mem_start) {
 //   app.
 __attribute__((noreturn))
 void _c_start_nopic(uint32_t app_start, uint32_t mem_start) {
-  struct hdr* myhdr = (struct hdr*)app_start;
+  uint32_t ticks_start = startup_ticks();
+  struct hdr* myhdr    = (struct hdr*)app_start;
 
   // Copy over the Global Offset Table (GOT). The GOT seems to still get created
   // and used in some cases, even though nothing is being relocated and the
   // addresses are static. So, all we need to do is copy the GOT entries from
   // flash to RAM, without doing any address changes. Of course, if the GOT
   // length is 0 this is a no-op.
-  void* got_start     = (void*)(myhdr->got_start + mem_start);
-  void* got_sym_start = (void*)(myhdr->got_sym_start + app_start);
-  memcpy(got_start, got_sym_start, myhdr->got_size);
+  uint32_t* got_start     = (uint32_t*)(myhdr->got_start + mem_start);
+  uint32_t* got_sym_start = (uint32_t*)(myhdr->got_sym_start + app_start);
+  copy_words(got_start, got_sym_start, myhdr->got_size);
 
   // Load the data section from flash into RAM. We use the offsets from our
   // crt0 header so we know where this starts and where it should go.
-  void* data_start     = (void*)(myhdr->data_start + mem_start);
-  void* data_sym_start = (void*)(myhdr->data_sym_start + app_start);
-  memcpy(data_start, data_sym_start, myhdr->data_size);
+  uint32_t* data_start     = (uint32_t*)(myhdr->data_start + mem_start);
+  uint32_t* data_sym_start = (uint32_t*)(myhdr->data_sym_start + app_start);
+  copy_words(data_start, data_sym_start, myhdr->data_size);
 
   // Zero BSS segment. Again, we know where this should be in the process RAM
   // based on the crt0 header.
-  char* bss_start = (char*)(myhdr->bss_start + mem_start);
-  memset(bss_start, 0, myhdr->bss_size);
+  uint32_t* bss_start = (uint32_t*)(myhdr->bss_start + mem_start);
+  zero_words(bss_start, myhdr->bss_size);
+
+  stack_setup(mem_start, myhdr->stack_size);
+  app_hdr       = myhdr;
+  app_mem_start = mem_start;
 
+  startup_ticks_start = ticks_start;
+  startup_ticks_main  = startup_ticks();
   exit(main(0, NULL));
 }
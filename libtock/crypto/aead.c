@@ -0,0 +1,130 @@
+#include <string.h>
+
+#include "aead.h"
+
+// Callback of the running operation, and whether it is opening a packet.
+static libtock_aead_callback active_cb = NULL;
+static bool active_open;
+
+static void aead_unallow(void) {
+  libtock_aes_set_readonly_allow_source_buffer(NULL, 0);
+  libtock_aes_set_readwrite_allow_dest_buffer(NULL, 0);
+  libtock_aes_set_readonly_allow_key_buffer(NULL, 0);
+  libtock_aes_set_readonly_allow_nonce_buffer(NULL, 0);
+}
+
+static void aead_upcall(int result,
+                        __attribute__ ((unused)) int length,
+                        int verified,
+                        __attribute__ ((unused)) void* opaque) {
+  libtock_aead_callback cb = active_cb;
+  if (cb == NULL) return;
+
+  libtock_aes_finish();
+  aead_unallow();
+  active_cb = NULL;
+
+  returncode_t ret = (returncode_t) result;
+  if (ret == RETURNCODE_SUCCESS && active_open && !verified) ret = RETURNCODE_FAIL;
+  cb(ret);
+}
+
+// The driver takes the whole packet in both directions: the associated data
+// from `a_off`, the message from `m_off` up to the tag, and the tag in the
+// last `mic_len` bytes. Source and destination are the same buffer, as the
+// driver copies the source in before writing the result out.
+static returncode_t aead_start(libtock_aead_algorithm_t algorithm, bool encrypting, const uint8_t* key,
+                               const uint8_t* nonce, uint32_t nonce_len, uint8_t* buf, uint32_t buf_len,
+                               uint32_t aad_len, uint32_t msg_len, uint32_t tag_len, libtock_aead_callback cb) {
+  if (algorithm != LIBTOCK_AEAD_AES128CCM) return RETURNCODE_EINVAL;
+  if (tag_len < 4 || tag_len > 16 || tag_len % 2 != 0) return RETURNCODE_EINVAL;
+  if (nonce_len != LIBTOCK_AEAD_CCM_NONCE_LEN) return RETURNCODE_EINVAL;
+  if (aad_len > buf_len || msg_len > buf_len - aad_len || tag_len > buf_len - aad_len - msg_len) {
+    return RETURNCODE_ESIZE;
+  }
+  if (active_cb != NULL) return RETURNCODE_EBUSY;
+
+  uint32_t len     = aad_len + msg_len + tag_len;
+  returncode_t ret = libtock_aes_set_algorithm(LIBTOCK_AES128CCM, encrypting);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_ccm_set_a_off(0);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_ccm_set_m_off(aad_len);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_ccm_set_mic_len(tag_len);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_ccm_set_confidential(true);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_set_readonly_allow_key_buffer(key, LIBTOCK_AEAD_KEY_LEN);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_set_readonly_allow_nonce_buffer(nonce, nonce_len);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_set_readonly_allow_source_buffer(buf, len);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_set_readwrite_allow_dest_buffer(buf, len);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_set_upcall(aead_upcall, NULL);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_setup();
+  if (ret != RETURNCODE_SUCCESS) {
+    aead_unallow();
+    return ret;
+  }
+
+  active_cb   = cb;
+  active_open = !encrypting;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_aead_seal(libtock_aead_algorithm_t algorithm, const uint8_t* key, const uint8_t* nonce,
+                               uint32_t nonce_len, uint8_t* buf, uint32_t buf_len, uint32_t aad_len,
+                               uint32_t msg_len, uint32_t tag_len, libtock_aead_callback cb) {
+  return aead_start(algorithm, true, key, nonce, nonce_len, buf, buf_len, aad_len, msg_len, tag_len, cb);
+}
+
+returncode_t libtock_aead_open(libtock_aead_algorithm_t algorithm, const uint8_t* key, const uint8_t* nonce,
+                               uint32_t nonce_len, uint8_t* buf, uint32_t buf_len, uint32_t aad_len,
+                               uint32_t msg_len, uint32_t tag_len, libtock_aead_callback cb) {
+  return aead_start(algorithm, false, key, nonce, nonce_len, buf, buf_len, aad_len, msg_len, tag_len, cb);
+}
+
+void libtock_aead_stream_init(libtock_aead_stream_t* stream, uint8_t* buf, uint32_t size) {
+  stream->buf     = buf;
+  stream->size    = size;
+  stream->aad_len = 0;
+  stream->msg_len = 0;
+}
+
+returncode_t libtock_aead_stream_aad(libtock_aead_stream_t* stream, const uint8_t* data, uint32_t len) {
+  if (stream->msg_len != 0) return RETURNCODE_EINVAL;
+  if (len > stream->size - stream->aad_len) return RETURNCODE_ESIZE;
+  memcpy(stream->buf + stream->aad_len, data, len);
+  stream->aad_len += len;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_aead_stream_reserve(libtock_aead_stream_t* stream, uint32_t len, uint8_t** ptr) {
+  if (len > stream->size - libtock_aead_stream_length(stream)) return RETURNCODE_ESIZE;
+  *ptr = stream->buf + libtock_aead_stream_length(stream);
+  stream->msg_len += len;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_aead_stream_update(libtock_aead_stream_t* stream, const uint8_t* data, uint32_t len) {
+  uint8_t* ptr;
+  returncode_t ret = libtock_aead_stream_reserve(stream, len, &ptr);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  memcpy(ptr, data, len);
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_aead_stream_seal(libtock_aead_stream_t* stream, libtock_aead_algorithm_t algorithm,
+                                      const uint8_t* key, const uint8_t* nonce, uint32_t nonce_len,
+                                      uint32_t tag_len, libtock_aead_callback cb) {
+  returncode_t ret = libtock_aead_seal(algorithm, key, nonce, nonce_len, stream->buf, stream->size,
+                                       stream->aad_len, stream->msg_len, tag_len, cb);
+  if (ret == RETURNCODE_SUCCESS) stream->msg_len += tag_len;
+  return ret;
+}
+
+returncode_t libtock_aead_stream_open(libtock_aead_stream_t* stream, libtock_aead_algorithm_t algorithm,
+                                      const uint8_t* key, const uint8_t* nonce, uint32_t nonce_len,
+                                      uint32_t tag_len, libtock_aead_callback cb) {
+  if (stream->msg_len < tag_len) return RETURNCODE_ESIZE;
+  return libtock_aead_open(algorithm, key, nonce, nonce_len, stream->buf, stream->size,
+                           stream->aad_len, stream->msg_len - tag_len, tag_len, cb);
+}
+
+uint32_t libtock_aead_stream_length(const libtock_aead_stream_t* stream) {
+  return stream->aad_len + stream->msg_len;
+}
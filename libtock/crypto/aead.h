@@ -0,0 +1,119 @@
+#pragma once
+
+#include "../tock.h"
+#include "aes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Authenticated encryption with associated data.
+//
+// A packet lives in one buffer laid out as the AES driver processes it:
+//
+//   | associated data | message | tag |
+//     aad_len           msg_len   tag_len
+//
+// The associated data is authenticated but sent in the clear, the message is
+// encrypted and authenticated. Sealing encrypts the message in place and
+// writes the tag after it; opening decrypts the message in place and checks
+// the tag. Nothing is copied, so a packet can be built straight into its
+// transmit buffer with headroom left for the tag.
+//
+// Only AES-128 CCM is supported, as that is what the kernel driver
+// implements. The key and nonce are shared with the kernel for the duration
+// of one operation, and only one operation can run at a time.
+
+typedef enum {
+  LIBTOCK_AEAD_AES128CCM = 0,
+} libtock_aead_algorithm_t;
+
+#define LIBTOCK_AEAD_KEY_LEN       16
+#define LIBTOCK_AEAD_CCM_NONCE_LEN 13
+
+// Function signature for AEAD callbacks.
+//
+// - `arg1` (`returncode_t`): Status of the operation. Opening a packet whose
+//   tag does not match returns RETURNCODE_FAIL.
+typedef void (*libtock_aead_callback)(returncode_t);
+
+// Seal the packet in `buf`, whose `buf_len` bytes must have room for the
+// `aad_len` bytes of associated data, the `msg_len` bytes of message that
+// follow it and a `tag_len` bytes tag after that. CCM takes an even
+// `tag_len` from 4 to 16 and a nonce of `LIBTOCK_AEAD_CCM_NONCE_LEN` bytes,
+// which must never be reused with the same key.
+//
+// Returns RETURNCODE_EINVAL for a bad tag or nonce length, RETURNCODE_ESIZE
+// if the packet does not fit in `buf`, and RETURNCODE_EBUSY while another
+// operation runs.
+returncode_t libtock_aead_seal(libtock_aead_algorithm_t algorithm, const uint8_t* key, const uint8_t* nonce,
+                               uint32_t nonce_len, uint8_t* buf, uint32_t buf_len, uint32_t aad_len,
+                               uint32_t msg_len, uint32_t tag_len, libtock_aead_callback cb);
+
+// Open the sealed packet in `buf`, laid out as for `libtock_aead_seal()`.
+// The message is decrypted in place whether or not the tag matches, and
+// must not be used unless the callback reports success.
+returncode_t libtock_aead_open(libtock_aead_algorithm_t algorithm, const uint8_t* key, const uint8_t* nonce,
+                               uint32_t nonce_len, uint8_t* buf, uint32_t buf_len, uint32_t aad_len,
+                               uint32_t msg_len, uint32_t tag_len, libtock_aead_callback cb);
+
+// A packet assembled piece by piece into one buffer.
+//
+// The associated data is added first, then the message, each in as many
+// pieces as needed. Pieces can be copied in with `libtock_aead_stream_aad()`
+// and `libtock_aead_stream_update()`, or written in place after reserving
+// room with `libtock_aead_stream_reserve()`. The whole packet is then sealed
+// or opened in one operation.
+//
+// Sealing appends the tag to the message, so a sealed stream can be opened
+// again as it is. A packet to open is added with its tag at the end of the
+// message.
+typedef struct {
+  uint8_t* buf;
+  uint32_t size;
+  uint32_t aad_len;
+  uint32_t msg_len;
+} libtock_aead_stream_t;
+
+// Start assembling a packet in the `size` bytes of `buf`.
+void libtock_aead_stream_init(libtock_aead_stream_t* stream, uint8_t* buf, uint32_t size);
+
+// Add `len` bytes of associated data.
+//
+// Returns RETURNCODE_EINVAL once the message has started and RETURNCODE_ESIZE
+// if the data does not fit.
+returncode_t libtock_aead_stream_aad(libtock_aead_stream_t* stream, const uint8_t* data, uint32_t len);
+
+// Add `len` bytes of message.
+//
+// Returns RETURNCODE_ESIZE if the data does not fit.
+returncode_t libtock_aead_stream_update(libtock_aead_stream_t* stream, const uint8_t* data, uint32_t len);
+
+// Add `len` bytes of message to be written at `*ptr` by the caller.
+//
+// Returns RETURNCODE_ESIZE if they do not fit.
+returncode_t libtock_aead_stream_reserve(libtock_aead_stream_t* stream, uint32_t len, uint8_t** ptr);
+
+// Seal the assembled packet with a `tag_len` bytes tag, as
+// `libtock_aead_seal()`.
+//
+// Returns RETURNCODE_ESIZE if there is no room left for the tag.
+returncode_t libtock_aead_stream_seal(libtock_aead_stream_t* stream, libtock_aead_algorithm_t algorithm,
+                                      const uint8_t* key, const uint8_t* nonce, uint32_t nonce_len,
+                                      uint32_t tag_len, libtock_aead_callback cb);
+
+// Open the assembled packet, whose message ends with its `tag_len` bytes
+// tag, as `libtock_aead_open()`.
+//
+// Returns RETURNCODE_ESIZE if the message is shorter than the tag.
+returncode_t libtock_aead_stream_open(libtock_aead_stream_t* stream, libtock_aead_algorithm_t algorithm,
+                                      const uint8_t* key, const uint8_t* nonce, uint32_t nonce_len,
+                                      uint32_t tag_len, libtock_aead_callback cb);
+
+// Bytes of the packet in the buffer, from the start of the associated data
+// to the end of the message.
+uint32_t libtock_aead_stream_length(const libtock_aead_stream_t* stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "aes.h"
 
 returncode_t libtock_aes_set_algorithm(libtock_aes_algorithm_t operation, bool encrypting) {
@@ -31,3 +33,143 @@ returncode_t libtock_aes_ccm_set_mic_len(uint32_t value) {
 returncode_t libtock_aes_ccm_set_confidential(bool value) {
   return libtock_aes_command_ccm_set_confidential(value);
 }
+
+#define AES_BLOCK 16
+
+// The running stream. The AES driver processes one buffer at a time.
+static libtock_aes_stream_t* active_stream = NULL;
+
+// Whether the kernel has an AES driver: unknown (-1), no (0) or yes (1).
+static int driver = -1;
+
+static bool have_driver(void) {
+  if (driver < 0) driver = libtock_aes_exists();
+  return driver;
+}
+
+static void stream_unallow(void) {
+  libtock_aes_set_readonly_allow_source_buffer(NULL, 0);
+  libtock_aes_set_readwrite_allow_dest_buffer(NULL, 0);
+  libtock_aes_set_readonly_allow_key_buffer(NULL, 0);
+  libtock_aes_set_readonly_allow_iv_buffer(NULL, 0);
+}
+
+static void stream_complete(libtock_aes_stream_t* stream, returncode_t ret) {
+  libtock_aes_finish();
+  stream_unallow();
+  active_stream = NULL;
+  stream->done(ret, stream->opaque);
+}
+
+// Share buffer pair `slot` with the kernel.
+static returncode_t stream_allow(libtock_aes_stream_t* stream, int slot) {
+  returncode_t ret = libtock_aes_set_readonly_allow_source_buffer(stream->in[slot], stream->len[slot]);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtock_aes_set_readwrite_allow_dest_buffer(stream->out[slot], stream->len[slot]);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  stream->running = slot;
+  return RETURNCODE_SUCCESS;
+}
+
+static uint32_t stream_fill(libtock_aes_stream_t* stream, int slot) {
+  uint32_t len = stream->fill(stream->in[slot], stream->chunk, stream->opaque);
+  return len < stream->chunk ? len : stream->chunk;
+}
+
+static void stream_upcall(int result,
+                          __attribute__ ((unused)) int length,
+                          __attribute__ ((unused)) int verified,
+                          void* opaque) {
+  libtock_aes_stream_t* stream = opaque;
+  if (stream != active_stream) return;
+  if (result != RETURNCODE_SUCCESS) {
+    stream_complete(stream, (returncode_t) result);
+    return;
+  }
+
+  // Start the next chunk before touching the finished one.
+  int done_slot = stream->running;
+  int next_slot = 1 - done_slot;
+  bool more     = stream->len[next_slot] > 0;
+  if (more) {
+    returncode_t ret = stream_allow(stream, next_slot);
+    if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_crypt();
+    if (ret != RETURNCODE_SUCCESS) {
+      stream_complete(stream, ret);
+      return;
+    }
+  }
+
+  stream->drain(stream->out[done_slot], stream->len[done_slot], stream->opaque);
+  if (!more) {
+    stream_complete(stream, RETURNCODE_SUCCESS);
+    return;
+  }
+  // Filled while the kernel works on the other chunk. After a short chunk
+  // the stream has ended.
+  stream->len[done_slot] = stream->len[next_slot] < stream->chunk ? 0 : stream_fill(stream, done_slot);
+}
+
+// Run the rest of a stream whose first chunk is filled in slot 0.
+static returncode_t stream_soft(libtock_aes_stream_t* stream, libtock_aes_algorithm_t operation, bool encrypting,
+                                const uint8_t* key, const uint8_t* iv) {
+  libtock_aes128_soft_t ctx;
+  uint8_t chain[AES_BLOCK];
+  libtock_aes128_soft_init(&ctx, key);
+  memcpy(chain, iv, AES_BLOCK);
+
+  uint32_t len = stream->len[0];
+  while (len > 0) {
+    if (operation == LIBTOCK_AES128Ctr) {
+      libtock_aes128_soft_ctr(&ctx, chain, stream->in[0], stream->out[0], len);
+    } else if (len % AES_BLOCK != 0) {
+      return RETURNCODE_EINVAL;
+    } else if (operation == LIBTOCK_AES128CBC) {
+      libtock_aes128_soft_cbc(&ctx, encrypting, chain, stream->in[0], stream->out[0], len);
+    } else {
+      libtock_aes128_soft_ecb(&ctx, encrypting, stream->in[0], stream->out[0], len);
+    }
+    stream->drain(stream->out[0], len, stream->opaque);
+    len = len < stream->chunk ? 0 : stream_fill(stream, 0);
+  }
+  return RETURNCODE_EALREADY;
+}
+
+returncode_t libtock_aes_stream_start(libtock_aes_stream_t* stream, libtock_aes_algorithm_t operation,
+                                      bool encrypting, const uint8_t* key, const uint8_t* iv, uint8_t* work,
+                                      uint32_t chunk, libtock_aes_stream_fill fill, libtock_aes_stream_drain drain,
+                                      libtock_aes_stream_done done, void* opaque) {
+  if (operation == LIBTOCK_AES128CCM || chunk == 0 || chunk % AES_BLOCK != 0) return RETURNCODE_EINVAL;
+  if (active_stream != NULL) return RETURNCODE_EBUSY;
+
+  stream->in[0]  = work;
+  stream->in[1]  = work + chunk;
+  stream->out[0] = work + 2 * chunk;
+  stream->out[1] = work + 3 * chunk;
+  stream->chunk  = chunk;
+  stream->fill   = fill;
+  stream->drain  = drain;
+  stream->done   = done;
+  stream->opaque = opaque;
+
+  stream->len[0] = stream_fill(stream, 0);
+  if (stream->len[0] == 0) return RETURNCODE_EALREADY;
+  if (!have_driver() || (stream->len[0] < chunk && stream->len[0] <= LIBTOCK_AES_SOFT_THRESHOLD)) {
+    return stream_soft(stream, operation, encrypting, key, iv);
+  }
+
+  returncode_t ret = libtock_aes_set_algorithm(operation, encrypting);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_set_readonly_allow_key_buffer(key, AES_BLOCK);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_set_readonly_allow_iv_buffer(iv, AES_BLOCK);
+  if (ret == RETURNCODE_SUCCESS) ret = stream_allow(stream, 0);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_set_upcall(stream_upcall, stream);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_aes_setup();
+  if (ret != RETURNCODE_SUCCESS) {
+    stream_unallow();
+    return ret;
+  }
+
+  active_stream  = stream;
+  stream->len[1] = stream->len[0] < chunk ? 0 : stream_fill(stream, 1);
+  return RETURNCODE_SUCCESS;
+}
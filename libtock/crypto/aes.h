@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../tock.h"
+#include "aes128_soft.h"
 #include "syscalls/aes_syscalls.h"
 
 #ifdef __cplusplus
@@ -63,6 +64,71 @@ returncode_t libtock_aes_ccm_set_mic_len(uint32_t value);
 // This sets the confidential bool for AES CCM.
 returncode_t libtock_aes_ccm_set_confidential(bool value);
 
+// Bulk encryption or decryption of a stream with two buffers in turn.
+//
+// The stream is cut into chunks. While the kernel processes one chunk, the
+// app fills the next one into the other input buffer and consumes the output
+// of the previous one, so the accelerator never waits for the app to refill:
+//
+//   kernel:  chunk 0 | chunk 1 | chunk 2 | ...
+//   app:     fill 1  | drain 0 | drain 1 |
+//                    | fill 2  | fill 3  |
+//
+// The stream owns the AES driver until it completes. CCM is not supported.
+//
+// Without an AES driver the stream runs in software before
+// `libtock_aes_stream_start()` returns, one buffer pair at a time. A stream
+// shorter than one chunk and no longer than `LIBTOCK_AES_SOFT_THRESHOLD`
+// bytes also runs in software when there is a driver, as below some size the
+// system calls cost more than the encryption; see `LIBTOCK_SHA_SOFT_THRESHOLD`
+// in `sha.h` for how to choose it.
+#ifndef LIBTOCK_AES_SOFT_THRESHOLD
+#define LIBTOCK_AES_SOFT_THRESHOLD 0
+#endif
+
+// Called for the input of the next chunk. Write up to `len` bytes to `buf`
+// and return how many were written, or 0 at the end of the stream. Except for
+// the last chunk, which may be shorter, chunks should be full; the kernel
+// requires whole 16-byte blocks for CBC and ECB.
+typedef uint32_t (*libtock_aes_stream_fill)(uint8_t* buf, uint32_t len, void* opaque);
+
+// Called with the output of each chunk, in order. `buf` is reused once this
+// returns.
+typedef void (*libtock_aes_stream_drain)(const uint8_t* buf, uint32_t len, void* opaque);
+
+// Called once the stream is complete, or failed.
+typedef void (*libtock_aes_stream_done)(returncode_t ret, void* opaque);
+
+typedef struct {
+  uint8_t* in[2];
+  uint8_t* out[2];
+  uint32_t len[2];
+  uint32_t chunk;
+  // Buffer pair being processed by the kernel.
+  int running;
+  libtock_aes_stream_fill fill;
+  libtock_aes_stream_drain drain;
+  libtock_aes_stream_done done;
+  void* opaque;
+} libtock_aes_stream_t;
+
+// Start processing a stream with `operation` (CTR, CBC or ECB), `key` and
+// `iv`, which stay shared with the kernel until the stream completes.
+// `work` holds four chunks of `chunk` bytes, a multiple of 16, for the two
+// input and two output buffers.
+//
+// The first two chunks are filled before this returns.
+//
+// Returns RETURNCODE_EINVAL for CCM, a bad chunk size, or a CBC or ECB
+// stream in software that does not end on a whole block, RETURNCODE_EBUSY
+// while another stream runs, and RETURNCODE_EALREADY if the stream was empty
+// or has run in software. `done` is not called unless this returns
+// RETURNCODE_SUCCESS.
+returncode_t libtock_aes_stream_start(libtock_aes_stream_t* stream, libtock_aes_algorithm_t operation,
+                                      bool encrypting, const uint8_t* key, const uint8_t* iv, uint8_t* work,
+                                      uint32_t chunk, libtock_aes_stream_fill fill, libtock_aes_stream_drain drain,
+                                      libtock_aes_stream_done done, void* opaque);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,220 @@
+#include <string.h>
+
+#include "aes128_soft.h"
+
+static const uint8_t sbox[256] = {
+  0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+  0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+  0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+  0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+  0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+  0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+  0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+  0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+  0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+  0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+  0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+  0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+  0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+  0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+  0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+  0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+static const uint8_t inv_sbox[256] = {
+  0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
+  0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
+  0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
+  0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25,
+  0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92,
+  0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
+  0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06,
+  0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02, 0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b,
+  0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
+  0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e,
+  0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89, 0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b,
+  0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
+  0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f,
+  0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d, 0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef,
+  0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
+  0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d,
+};
+
+// Columns are little endian words: row `r` of a column is byte `r`.
+
+static inline uint32_t ror(uint32_t x, int n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+static inline uint32_t load_le(const uint8_t* p) {
+  return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+static inline void store_le(uint8_t* p, uint32_t x) {
+  p[0] = x;
+  p[1] = x >> 8;
+  p[2] = x >> 16;
+  p[3] = x >> 24;
+}
+
+// Multiply each of the four bytes of `x` by 2 in GF(2^8).
+static inline uint32_t xtime4(uint32_t x) {
+  return ((x & 0x7f7f7f7f) << 1) ^ (((x >> 7) & 0x01010101) * 0x1b);
+}
+
+static inline uint32_t sub_word(uint32_t x, const uint8_t* box) {
+  return (uint32_t) box[x & 0xff] | (uint32_t) box[(x >> 8) & 0xff] << 8 |
+         (uint32_t) box[(x >> 16) & 0xff] << 16 | (uint32_t) box[x >> 24] << 24;
+}
+
+static inline uint32_t mix_column(uint32_t x) {
+  uint32_t x8 = ror(x, 8);
+  return xtime4(x ^ x8) ^ x8 ^ ror(x, 16) ^ ror(x, 24);
+}
+
+// InvMixColumns is MixColumns after adding 4 * (a[r] + a[r + 2]) to each row.
+static inline uint32_t inv_mix_column(uint32_t x) {
+  uint32_t v = xtime4(xtime4(x ^ ror(x, 16)));
+  return mix_column(x ^ v);
+}
+
+// SubBytes and ShiftRows together: row `r` of column `c` comes from column
+// `c + r`.
+static void sub_shift(uint32_t* s) {
+  uint32_t t[4];
+  for (int c = 0; c < 4; c++) {
+    t[c] = (uint32_t) sbox[s[c] & 0xff] |
+           (uint32_t) sbox[(s[(c + 1) & 3] >> 8) & 0xff] << 8 |
+           (uint32_t) sbox[(s[(c + 2) & 3] >> 16) & 0xff] << 16 |
+           (uint32_t) sbox[s[(c + 3) & 3] >> 24] << 24;
+  }
+  memcpy(s, t, sizeof(t));
+}
+
+// The inverse: row `r` of column `c` comes from column `c - r`.
+static void inv_sub_shift(uint32_t* s) {
+  uint32_t t[4];
+  for (int c = 0; c < 4; c++) {
+    t[c] = (uint32_t) inv_sbox[s[c] & 0xff] |
+           (uint32_t) inv_sbox[(s[(c + 3) & 3] >> 8) & 0xff] << 8 |
+           (uint32_t) inv_sbox[(s[(c + 2) & 3] >> 16) & 0xff] << 16 |
+           (uint32_t) inv_sbox[s[(c + 1) & 3] >> 24] << 24;
+  }
+  memcpy(s, t, sizeof(t));
+}
+
+static inline void add_round_key(uint32_t* s, const uint32_t* rk) {
+  s[0] ^= rk[0];
+  s[1] ^= rk[1];
+  s[2] ^= rk[2];
+  s[3] ^= rk[3];
+}
+
+void libtock_aes128_soft_init(libtock_aes128_soft_t* ctx, const uint8_t* key) {
+  uint32_t* w = ctx->round_keys;
+  uint8_t rcon = 1;
+  for (int i = 0; i < 4; i++) {
+    w[i] = load_le(key + 4 * i);
+  }
+  for (int i = 4; i < 44; i++) {
+    uint32_t t = w[i - 1];
+    if (i % 4 == 0) {
+      t    = sub_word(ror(t, 8), sbox) ^ rcon;
+      rcon = (rcon << 1) ^ ((rcon >> 7) * 0x1b);
+    }
+    w[i] = w[i - 4] ^ t;
+  }
+}
+
+void libtock_aes128_soft_encrypt_block(const libtock_aes128_soft_t* ctx, const uint8_t* in, uint8_t* out) {
+  uint32_t s[4];
+  for (int c = 0; c < 4; c++) {
+    s[c] = load_le(in + 4 * c);
+  }
+  add_round_key(s, ctx->round_keys);
+  for (int round = 1; round < 10; round++) {
+    sub_shift(s);
+    for (int c = 0; c < 4; c++) {
+      s[c] = mix_column(s[c]);
+    }
+    add_round_key(s, ctx->round_keys + 4 * round);
+  }
+  sub_shift(s);
+  add_round_key(s, ctx->round_keys + 40);
+  for (int c = 0; c < 4; c++) {
+    store_le(out + 4 * c, s[c]);
+  }
+}
+
+void libtock_aes128_soft_decrypt_block(const libtock_aes128_soft_t* ctx, const uint8_t* in, uint8_t* out) {
+  uint32_t s[4];
+  for (int c = 0; c < 4; c++) {
+    s[c] = load_le(in + 4 * c);
+  }
+  add_round_key(s, ctx->round_keys + 40);
+  for (int round = 9; round > 0; round--) {
+    inv_sub_shift(s);
+    add_round_key(s, ctx->round_keys + 4 * round);
+    for (int c = 0; c < 4; c++) {
+      s[c] = inv_mix_column(s[c]);
+    }
+  }
+  inv_sub_shift(s);
+  add_round_key(s, ctx->round_keys);
+  for (int c = 0; c < 4; c++) {
+    store_le(out + 4 * c, s[c]);
+  }
+}
+
+void libtock_aes128_soft_ctr(const libtock_aes128_soft_t* ctx, uint8_t* counter, const uint8_t* in, uint8_t* out,
+                             uint32_t len) {
+  uint8_t pad[LIBTOCK_AES128_SOFT_BLOCK];
+  while (len > 0) {
+    libtock_aes128_soft_encrypt_block(ctx, counter, pad);
+    for (int i = LIBTOCK_AES128_SOFT_BLOCK - 1; i >= 0 && ++counter[i] == 0; i--) {
+    }
+
+    uint32_t n = len < LIBTOCK_AES128_SOFT_BLOCK ? len : LIBTOCK_AES128_SOFT_BLOCK;
+    for (uint32_t i = 0; i < n; i++) {
+      out[i] = in[i] ^ pad[i];
+    }
+    in  += n;
+    out += n;
+    len -= n;
+  }
+}
+
+void libtock_aes128_soft_cbc(const libtock_aes128_soft_t* ctx, bool encrypting, uint8_t* iv, const uint8_t* in,
+                             uint8_t* out, uint32_t len) {
+  uint8_t block[LIBTOCK_AES128_SOFT_BLOCK];
+  for ( ; len >= LIBTOCK_AES128_SOFT_BLOCK;
+        in += LIBTOCK_AES128_SOFT_BLOCK, out += LIBTOCK_AES128_SOFT_BLOCK, len -= LIBTOCK_AES128_SOFT_BLOCK) {
+    if (encrypting) {
+      for (int i = 0; i < LIBTOCK_AES128_SOFT_BLOCK; i++) {
+        block[i] = in[i] ^ iv[i];
+      }
+      libtock_aes128_soft_encrypt_block(ctx, block, out);
+      memcpy(iv, out, LIBTOCK_AES128_SOFT_BLOCK);
+    } else {
+      // `in` may be `out`, so keep the ciphertext for the next block.
+      memcpy(block, in, LIBTOCK_AES128_SOFT_BLOCK);
+      libtock_aes128_soft_decrypt_block(ctx, block, out);
+      for (int i = 0; i < LIBTOCK_AES128_SOFT_BLOCK; i++) {
+        out[i] ^= iv[i];
+      }
+      memcpy(iv, block, LIBTOCK_AES128_SOFT_BLOCK);
+    }
+  }
+}
+
+void libtock_aes128_soft_ecb(const libtock_aes128_soft_t* ctx, bool encrypting, const uint8_t* in, uint8_t* out,
+                             uint32_t len) {
+  for ( ; len >= LIBTOCK_AES128_SOFT_BLOCK;
+        in += LIBTOCK_AES128_SOFT_BLOCK, out += LIBTOCK_AES128_SOFT_BLOCK, len -= LIBTOCK_AES128_SOFT_BLOCK) {
+    if (encrypting) {
+      libtock_aes128_soft_encrypt_block(ctx, in, out);
+    } else {
+      libtock_aes128_soft_decrypt_block(ctx, in, out);
+    }
+  }
+}
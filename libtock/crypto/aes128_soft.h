@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// AES-128 in software, used by `aes.h` when the kernel has no AES driver.
+//
+// The state is kept as four column words so MixColumns works on a whole
+// column at a time with shifts and masks, which suits 32-bit cores without
+// needing the 4 kB lookup tables of table-driven implementations. Only the
+// two 256-byte S-boxes are stored.
+
+#define LIBTOCK_AES128_SOFT_BLOCK 16
+
+typedef struct {
+  uint32_t round_keys[44];
+} libtock_aes128_soft_t;
+
+void libtock_aes128_soft_init(libtock_aes128_soft_t* ctx, const uint8_t* key);
+
+void libtock_aes128_soft_encrypt_block(const libtock_aes128_soft_t* ctx, const uint8_t* in, uint8_t* out);
+
+void libtock_aes128_soft_decrypt_block(const libtock_aes128_soft_t* ctx, const uint8_t* in, uint8_t* out);
+
+// Process `len` bytes from `in` to `out`, which may be the same buffer, in
+// CTR mode. `counter` is the 16-byte counter block, incremented as a big
+// endian number after every block so that a following call continues the
+// stream. A partial block can only come last.
+void libtock_aes128_soft_ctr(const libtock_aes128_soft_t* ctx, uint8_t* counter, const uint8_t* in, uint8_t* out,
+                             uint32_t len);
+
+// Process whole blocks in CBC mode, updating `iv` to chain into a following
+// call.
+void libtock_aes128_soft_cbc(const libtock_aes128_soft_t* ctx, bool encrypting, uint8_t* iv, const uint8_t* in,
+                             uint8_t* out, uint32_t len);
+
+// Process whole blocks in ECB mode.
+void libtock_aes128_soft_ecb(const libtock_aes128_soft_t* ctx, bool encrypting, const uint8_t* in, uint8_t* out,
+                             uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
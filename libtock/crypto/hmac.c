@@ -1,5 +1,53 @@
+#include <string.h>
+
 #include "hmac.h"
 
+// The context whose key and algorithm the kernel has, if any.
+static libtock_hmac_context_t* keyed = NULL;
+
+// Whether the kernel has an HMAC driver: unknown (-1), no (0) or yes (1).
+static int driver = -1;
+
+// The context whose message is in progress in software, and the inner hash
+// of that message.
+static libtock_hmac_context_t* soft_context = NULL;
+static libtock_sha256_soft_t soft_inner;
+
+static bool have_driver(void) {
+  if (driver < 0) driver = libtock_hmac_exists();
+  return driver;
+}
+
+static bool context_soft(const libtock_hmac_context_t* context) {
+  return context->algorithm == LIBTOCK_HMAC_SHA256 && !have_driver();
+}
+
+// Hash `key`, padded to a block and XORed with `pad`, into `sha`.
+static void soft_start(libtock_sha256_soft_t* sha, const uint8_t* key, uint32_t key_length, uint8_t pad) {
+  uint8_t block[LIBTOCK_SHA256_SOFT_BLOCK] = { 0 };
+  if (key_length > LIBTOCK_SHA256_SOFT_BLOCK) {
+    libtock_sha256_soft(key, key_length, block);
+  } else {
+    memcpy(block, key, key_length);
+  }
+  for (int i = 0; i < LIBTOCK_SHA256_SOFT_BLOCK; i++) {
+    block[i] ^= pad;
+  }
+  libtock_sha256_soft_init(sha);
+  libtock_sha256_soft_update(sha, block, sizeof(block));
+}
+
+// Complete the HMAC whose inner hash is `inner`.
+static void soft_finish(libtock_sha256_soft_t* inner, const uint8_t* key, uint32_t key_length, uint8_t* hash) {
+  uint8_t digest[LIBTOCK_SHA256_SOFT_HASH];
+  libtock_sha256_soft_finish(inner, digest);
+
+  libtock_sha256_soft_t outer;
+  soft_start(&outer, key, key_length, 0x5c);
+  libtock_sha256_soft_update(&outer, digest, sizeof(digest));
+  libtock_sha256_soft_finish(&outer, hash);
+}
+
 static void hmac_upcall(int ret,
                         __attribute__ ((unused)) int unused1,
                         __attribute__ ((unused)) int unused2, void* opaque) {
@@ -16,6 +64,18 @@ returncode_t libtock_hmac_simple(libtock_hmac_algorithm_t hmac_type,
 
   returncode_t ret;
 
+  if (hmac_type == LIBTOCK_HMAC_SHA256 && (!have_driver() || input_length <= LIBTOCK_HMAC_SOFT_THRESHOLD)) {
+    if (hash_length < LIBTOCK_SHA256_SOFT_HASH) return RETURNCODE_ESIZE;
+    libtock_sha256_soft_t inner;
+    soft_start(&inner, key_buffer, key_length, 0x36);
+    libtock_sha256_soft_update(&inner, input_buffer, input_length);
+    soft_finish(&inner, key_buffer, key_length, hash_buffer);
+    return RETURNCODE_EALREADY;
+  }
+
+  // This replaces the key of any context.
+  keyed = NULL;
+
   ret = libtock_hmac_command_set_algorithm((uint32_t) hmac_type);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
@@ -35,3 +95,85 @@ returncode_t libtock_hmac_simple(libtock_hmac_algorithm_t hmac_type,
   return ret;
 
 }
+
+// Give the kernel the key and algorithm of `context` unless it has them.
+static returncode_t use_context(libtock_hmac_context_t* context) {
+  if (keyed == context) return RETURNCODE_SUCCESS;
+
+  returncode_t ret = libtock_hmac_command_set_algorithm((uint32_t) context->algorithm);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = libtock_hmac_set_readonly_allow_key_buffer(context->key, context->key_length);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  keyed = context;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_hmac_context_init(libtock_hmac_context_t* context, libtock_hmac_algorithm_t hmac_type,
+                                       const uint8_t* key_buffer, uint32_t key_length) {
+  context->algorithm  = hmac_type;
+  context->key        = key_buffer;
+  context->key_length = key_length;
+  if (keyed == context) keyed = NULL;
+  if (soft_context == context) soft_context = NULL;
+  if (context_soft(context)) return RETURNCODE_SUCCESS;
+  return use_context(context);
+}
+
+returncode_t libtock_hmac_context_update(libtock_hmac_context_t* context, const uint8_t* input_buffer,
+                                         uint32_t input_length, libtock_hmac_callback_hmac cb) {
+  returncode_t ret;
+
+  if (context_soft(context)) {
+    if (soft_context != context) {
+      soft_start(&soft_inner, context->key, context->key_length, 0x36);
+      soft_context = context;
+    }
+    libtock_sha256_soft_update(&soft_inner, input_buffer, input_length);
+    return RETURNCODE_EALREADY;
+  }
+
+  ret = use_context(context);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = libtock_hmac_set_readonly_allow_data_buffer(input_buffer, input_length);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = libtock_hmac_set_upcall(hmac_upcall, cb);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  return libtock_hmac_command_update();
+}
+
+returncode_t libtock_hmac_context_finish(libtock_hmac_context_t* context, uint8_t* hash_buffer, uint32_t hash_length,
+                                         libtock_hmac_callback_hmac cb) {
+  returncode_t ret;
+
+  if (context_soft(context)) {
+    if (hash_length < LIBTOCK_SHA256_SOFT_HASH) return RETURNCODE_ESIZE;
+    // A message with no updates.
+    if (soft_context != context) soft_start(&soft_inner, context->key, context->key_length, 0x36);
+    soft_finish(&soft_inner, context->key, context->key_length, hash_buffer);
+    soft_context = NULL;
+    return RETURNCODE_EALREADY;
+  }
+
+  ret = use_context(context);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = libtock_hmac_set_readwrite_allow_destination_buffer(hash_buffer, hash_length);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = libtock_hmac_set_upcall(hmac_upcall, cb);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  return libtock_hmac_command_finish();
+}
+
+void libtock_hmac_context_release(libtock_hmac_context_t* context) {
+  if (soft_context == context) soft_context = NULL;
+  if (keyed != context) return;
+  libtock_hmac_set_readonly_allow_key_buffer(NULL, 0);
+  keyed = NULL;
+}
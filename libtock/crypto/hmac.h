@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../tock.h"
+#include "sha256_soft.h"
 #include "syscalls/hmac_syscalls.h"
 
 #ifdef __cplusplus
@@ -18,18 +19,66 @@ typedef enum {
   LIBTOCK_HMAC_SHA512 = 2,
 } libtock_hmac_algorithm_t;
 
-
+// HMAC-SHA256 falls back to software when the kernel has no HMAC driver.
+// `libtock_hmac_simple()` also computes messages of at most
+// `LIBTOCK_HMAC_SOFT_THRESHOLD` bytes in software when there is a driver;
+// see `LIBTOCK_SHA_SOFT_THRESHOLD` in `sha.h` for how to choose it.
+//
+// Work done in software is complete when the call returns, which then
+// returns RETURNCODE_EALREADY and does not call the callback.
+#ifndef LIBTOCK_HMAC_SOFT_THRESHOLD
+#define LIBTOCK_HMAC_SOFT_THRESHOLD 0
+#endif
 
 // Compute an HMAC using `keyb_buffer` over `input_buffer` and store the result
 // in `hash_buffer`.
 //
-// The callback will be called when the HMAC is available.
+// The callback will be called when the HMAC is available, unless this
+// returns RETURNCODE_EALREADY.
 returncode_t libtock_hmac_simple(libtock_hmac_algorithm_t hmac_type,
                                  uint8_t* key_buffer, uint32_t key_length,
                                  uint8_t* input_buffer, uint32_t input_length,
                                  uint8_t* hash_buffer, uint32_t hash_length,
                                  libtock_hmac_callback_hmac cb);
 
+// A key kept shared with the kernel across many messages.
+//
+// `libtock_hmac_context_init()` shares the key once. Each message is then
+// fed with `libtock_hmac_context_update()` as many times as needed and
+// completed with `libtock_hmac_context_finish()`, after which the next
+// message can start straight away with the same key. The key is only shared
+// again if another context or `libtock_hmac_simple()` was used in between.
+// The key buffer must stay valid until `libtock_hmac_context_release()`.
+//
+// Only one update or finish can run at a time. Without an HMAC driver, an
+// HMAC-SHA256 context runs in software and every update and finish returns
+// RETURNCODE_EALREADY.
+typedef struct {
+  libtock_hmac_algorithm_t algorithm;
+  const uint8_t* key;
+  uint32_t key_length;
+} libtock_hmac_context_t;
+
+// Set up `context` with `key_buffer` and share the key with the kernel.
+returncode_t libtock_hmac_context_init(libtock_hmac_context_t* context, libtock_hmac_algorithm_t hmac_type,
+                                       const uint8_t* key_buffer, uint32_t key_length);
+
+// Add `input_length` bytes of `input_buffer` to the current message.
+//
+// The callback will be called once the data has been consumed and
+// `input_buffer` may be reused.
+returncode_t libtock_hmac_context_update(libtock_hmac_context_t* context, const uint8_t* input_buffer,
+                                         uint32_t input_length, libtock_hmac_callback_hmac cb);
+
+// Complete the current message and store its HMAC in `hash_buffer`.
+//
+// The callback will be called when the HMAC is available.
+returncode_t libtock_hmac_context_finish(libtock_hmac_context_t* context, uint8_t* hash_buffer, uint32_t hash_length,
+                                         libtock_hmac_callback_hmac cb);
+
+// Stop sharing the key of `context` with the kernel.
+void libtock_hmac_context_release(libtock_hmac_context_t* context);
+
 #ifdef __cplusplus
 }
 #endif
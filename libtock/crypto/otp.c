@@ -0,0 +1,73 @@
+#include <string.h>
+
+#include "../services/time.h"
+#include "otp.h"
+
+static const uint32_t powers_of_ten[10] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+
+static void pad_state(libtock_sha256_soft_t* sha, const uint8_t* block, uint8_t pad) {
+  uint8_t padded[LIBTOCK_SHA256_SOFT_BLOCK];
+  for (int i = 0; i < LIBTOCK_SHA256_SOFT_BLOCK; i++) {
+    padded[i] = block[i] ^ pad;
+  }
+  libtock_sha256_soft_init(sha);
+  libtock_sha256_soft_update(sha, padded, sizeof(padded));
+}
+
+void libtock_otp_key_init(libtock_otp_key_t* key, const uint8_t* secret, uint32_t secret_len) {
+  uint8_t block[LIBTOCK_SHA256_SOFT_BLOCK] = { 0 };
+  if (secret_len > LIBTOCK_SHA256_SOFT_BLOCK) {
+    libtock_sha256_soft(secret, secret_len, block);
+  } else {
+    memcpy(block, secret, secret_len);
+  }
+  pad_state(&key->inner, block, 0x36);
+  pad_state(&key->outer, block, 0x5c);
+}
+
+uint32_t libtock_otp_code(const libtock_otp_key_t* key, uint64_t moving_factor, int digits) {
+  uint8_t factor[8];
+  for (int i = 0; i < 8; i++) {
+    factor[i] = moving_factor >> (56 - 8 * i);
+  }
+
+  uint8_t mac[LIBTOCK_SHA256_SOFT_HASH];
+  libtock_sha256_soft_t sha = key->inner;
+  libtock_sha256_soft_update(&sha, factor, sizeof(factor));
+  libtock_sha256_soft_finish(&sha, mac);
+  sha = key->outer;
+  libtock_sha256_soft_update(&sha, mac, sizeof(mac));
+  libtock_sha256_soft_finish(&sha, mac);
+
+  // Dynamic truncation.
+  int offset      = mac[sizeof(mac) - 1] & 0x0f;
+  uint32_t binary = (uint32_t) (mac[offset] & 0x7f) << 24 | (uint32_t) mac[offset + 1] << 16 |
+                    (uint32_t) mac[offset + 2] << 8 | mac[offset + 3];
+
+  if (digits < 1) digits = 1;
+  if (digits > 9) digits = 9;
+  return binary % powers_of_ten[digits];
+}
+
+uint32_t libtock_otp_totp(const libtock_otp_key_t* key, uint64_t unix_time, uint32_t step, int digits) {
+  return libtock_otp_code(key, unix_time / step, digits);
+}
+
+uint32_t libtock_otp_totp_now(const libtock_otp_key_t* key, uint64_t boot_time, uint32_t step, int digits) {
+  return libtock_otp_totp(key, boot_time + libtock_time_now_us64() / 1000000, step, digits);
+}
+
+void libtock_otp_counter_init(libtock_otp_counter_t* counter, uint64_t stored, uint32_t batch) {
+  counter->next     = stored;
+  counter->reserved = stored;
+  counter->batch    = batch == 0 ? 1 : batch;
+}
+
+bool libtock_otp_counter_next(libtock_otp_counter_t* counter, uint64_t* value) {
+  bool reserve = counter->next >= counter->reserved;
+  if (reserve) counter->reserved = counter->next + counter->batch;
+  *value = counter->next++;
+  return reserve;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../tock.h"
+#include "sha256_soft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// One-time passwords: HOTP (RFC 4226) and TOTP (RFC 6238) with HMAC-SHA256.
+//
+// `libtock_otp_key_init()` hashes the padded key blocks once and keeps the
+// two hash states. Each code then only hashes the 8-byte moving factor and
+// the inner digest, two SHA-256 compressions in software, instead of a full
+// HMAC with its key setup or a trip to the kernel.
+//
+// The key states can recreate codes for the key, so keep them no longer
+// than the key itself would be kept.
+
+typedef struct {
+  // Hash states after the key XORed with the inner and outer pads.
+  libtock_sha256_soft_t inner;
+  libtock_sha256_soft_t outer;
+} libtock_otp_key_t;
+
+// Prepare `key` from the `secret_len` bytes of `secret`.
+void libtock_otp_key_init(libtock_otp_key_t* key, const uint8_t* secret, uint32_t secret_len);
+
+// The code for `moving_factor`, `digits` from 1 to 9 long. For HOTP the
+// moving factor is the counter.
+uint32_t libtock_otp_code(const libtock_otp_key_t* key, uint64_t moving_factor, int digits);
+
+// The TOTP code at `unix_time` seconds, with time steps of `step` seconds
+// counted from the Unix epoch.
+uint32_t libtock_otp_totp(const libtock_otp_key_t* key, uint64_t unix_time, uint32_t step, int digits);
+
+// The TOTP code now, where `boot_time` is the Unix time in seconds at which
+// the monotonic clock of `libtock/services/time.h` started.
+uint32_t libtock_otp_totp_now(const libtock_otp_key_t* key, uint64_t boot_time, uint32_t step, int digits);
+
+// A HOTP counter persisted in batches.
+//
+// Rather than storing the counter after every code, the counter reserves
+// `batch` values at a time and only the end of the reservation is stored.
+// After a reset the counter resumes from the stored value, skipping at most
+// `batch` unused values, which the verifier's look-ahead window absorbs.
+// No value is ever used twice.
+typedef struct {
+  // Next value to use.
+  uint64_t next;
+  // Values below this are reserved and already stored.
+  uint64_t reserved;
+  uint32_t batch;
+} libtock_otp_counter_t;
+
+// Resume from `stored`, the last reservation stored, or 0 for a new key.
+void libtock_otp_counter_init(libtock_otp_counter_t* counter, uint64_t stored, uint32_t batch);
+
+// Take the next value. Returns true if a new reservation was made, in which
+// case `counter->reserved` must be stored before the code for `*value` is
+// given out.
+bool libtock_otp_counter_next(libtock_otp_counter_t* counter, uint64_t* value);
+
+#ifdef __cplusplus
+}
+#endif
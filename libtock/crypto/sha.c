@@ -1,5 +1,17 @@
 #include "sha.h"
 
+// Whether the kernel has a SHA driver: unknown (-1), no (0) or yes (1).
+static int driver = -1;
+
+// Whether the incremental hash in progress runs in software, and its state.
+static bool soft = false;
+static libtock_sha256_soft_t soft_ctx;
+
+static bool have_driver(void) {
+  if (driver < 0) driver = libtock_sha_exists();
+  return driver;
+}
+
 static void sha_upcall(int ret,
                        __attribute__ ((unused)) int unused1,
                        __attribute__ ((unused)) int unused2, void* opaque) {
@@ -14,6 +26,12 @@ returncode_t libtock_sha_simple_hash(libtock_sha_algorithm_t hash_type,
 
   returncode_t ret;
 
+  if (hash_type == LIBTOCK_SHA256 && (!have_driver() || input_length <= LIBTOCK_SHA_SOFT_THRESHOLD)) {
+    if (hash_length < LIBTOCK_SHA256_SOFT_HASH) return RETURNCODE_ESIZE;
+    libtock_sha256_soft(input_buffer, input_length, hash_buffer);
+    return RETURNCODE_EALREADY;
+  }
+
   ret = libtock_sha_command_set_algorithm((uint8_t) hash_type);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
@@ -29,3 +47,50 @@ returncode_t libtock_sha_simple_hash(libtock_sha_algorithm_t hash_type,
   ret = libtock_sha_command_run();
   return ret;
 }
+
+returncode_t libtock_sha_init(libtock_sha_algorithm_t hash_type) {
+  soft = hash_type == LIBTOCK_SHA256 && !have_driver();
+  if (soft) {
+    libtock_sha256_soft_init(&soft_ctx);
+    return RETURNCODE_SUCCESS;
+  }
+  return libtock_sha_command_set_algorithm((uint8_t) hash_type);
+}
+
+returncode_t libtock_sha_update(const uint8_t* input_buffer, uint32_t input_length,
+                                libtock_sha_callback_update cb) {
+  returncode_t ret;
+
+  if (soft) {
+    libtock_sha256_soft_update(&soft_ctx, input_buffer, input_length);
+    return RETURNCODE_EALREADY;
+  }
+
+  // The kernel only reads from the buffer.
+  ret = libtock_sha_set_readonly_allow_data_buffer((uint8_t*) input_buffer, input_length);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = libtock_sha_set_upcall(sha_upcall, cb);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  return libtock_sha_command_update();
+}
+
+returncode_t libtock_sha_finish(uint8_t* hash_buffer, uint32_t hash_length, libtock_sha_callback_hash cb) {
+  returncode_t ret;
+
+  if (soft) {
+    if (hash_length < LIBTOCK_SHA256_SOFT_HASH) return RETURNCODE_ESIZE;
+    libtock_sha256_soft_finish(&soft_ctx, hash_buffer);
+    soft = false;
+    return RETURNCODE_EALREADY;
+  }
+
+  ret = libtock_sha_set_readwrite_allow_destination_buffer(hash_buffer, hash_length);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = libtock_sha_set_upcall(sha_upcall, cb);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  return libtock_sha_command_finish();
+}
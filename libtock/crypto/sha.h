@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../tock.h"
+#include "sha256_soft.h"
 #include "syscalls/sha_syscalls.h"
 
 #ifdef __cplusplus
@@ -12,22 +13,62 @@ extern "C" {
 // - `arg1` (`returncode_t`): Status from computing the hash.
 typedef void (*libtock_sha_callback_hash)(returncode_t);
 
+// Function signature for SHA update callback.
+//
+// - `arg1` (`returncode_t`): Status from adding the data to the hash.
+typedef void (*libtock_sha_callback_update)(returncode_t);
+
 typedef enum {
   LIBTOCK_SHA256 = 0,
   LIBTOCK_SHA384 = 1,
   LIBTOCK_SHA512 = 2,
 } libtock_sha_algorithm_t;
 
-
+// SHA-256 falls back to software when the kernel has no SHA driver, so apps
+// need not be built differently for boards without one. Messages of at most
+// `LIBTOCK_SHA_SOFT_THRESHOLD` bytes are also hashed in software when there
+// is a driver, as below some size the system calls cost more than the hash.
+// The crossover depends on the board; `examples/benchmarks/crypto` measures
+// it, and `make CFLAGS=-DLIBTOCK_SHA_SOFT_THRESHOLD=<bytes>` sets it.
+//
+// Work done in software is complete when the call returns, which then
+// returns RETURNCODE_EALREADY and does not call the callback.
+#ifndef LIBTOCK_SHA_SOFT_THRESHOLD
+#define LIBTOCK_SHA_SOFT_THRESHOLD 0
+#endif
 
 // Compute a SHA hash over `input_buffer` and store the hash in `hash_buffer`.
 //
-// The callback will be called when the hash is available.
+// The callback will be called when the hash is available, unless this
+// returns RETURNCODE_EALREADY.
 returncode_t libtock_sha_simple_hash(libtock_sha_algorithm_t hash_type,
                                      uint8_t* input_buffer, uint32_t input_length,
                                      uint8_t* hash_buffer, uint32_t hash_length,
                                      libtock_sha_callback_hash cb);
 
+// Incremental hashing, for input that arrives in pieces or is too large to
+// hold in memory at once: `libtock_sha_init()`, then
+// `libtock_sha_update()` for each piece in order, then `libtock_sha_finish()`.
+// Only one update or finish can run at a time, and each keeps its buffer
+// shared with the kernel until its callback. Without a SHA driver, a SHA-256
+// hash runs in software and every update and finish returns
+// RETURNCODE_EALREADY.
+
+// Start a new hash with `hash_type`, discarding any hash in progress.
+returncode_t libtock_sha_init(libtock_sha_algorithm_t hash_type);
+
+// Add `input_length` bytes of `input_buffer` to the hash.
+//
+// The callback will be called once the data has been consumed and
+// `input_buffer` may be reused.
+returncode_t libtock_sha_update(const uint8_t* input_buffer, uint32_t input_length,
+                                libtock_sha_callback_update cb);
+
+// Complete the hash and store it in `hash_buffer`.
+//
+// The callback will be called when the hash is available.
+returncode_t libtock_sha_finish(uint8_t* hash_buffer, uint32_t hash_length, libtock_sha_callback_hash cb);
+
 #ifdef __cplusplus
 }
 #endif
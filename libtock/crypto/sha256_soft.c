@@ -0,0 +1,124 @@
+#include <string.h>
+
+#include "sha256_soft.h"
+
+static const uint32_t k[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t ror(uint32_t x, int n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+static inline uint32_t load_be(const uint8_t* p) {
+  return (uint32_t) p[0] << 24 | (uint32_t) p[1] << 16 | (uint32_t) p[2] << 8 | p[3];
+}
+
+static inline void store_be(uint8_t* p, uint32_t x) {
+  p[0] = x >> 24;
+  p[1] = x >> 16;
+  p[2] = x >> 8;
+  p[3] = x;
+}
+
+static void compress(uint32_t* state, const uint8_t* block) {
+  uint32_t w[16];
+  uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+  uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+  for (int i = 0; i < 64; i++) {
+    uint32_t wi;
+    if (i < 16) {
+      wi = load_be(block + 4 * i);
+    } else {
+      uint32_t w15 = w[(i - 15) & 15];
+      uint32_t w2  = w[(i - 2) & 15];
+      uint32_t s0  = ror(w15, 7) ^ ror(w15, 18) ^ (w15 >> 3);
+      uint32_t s1  = ror(w2, 17) ^ ror(w2, 19) ^ (w2 >> 10);
+      wi = w[i & 15] + s0 + w[(i - 7) & 15] + s1;
+    }
+    w[i & 15] = wi;
+
+    uint32_t t1 = h + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + wi;
+    uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+void libtock_sha256_soft_init(libtock_sha256_soft_t* ctx) {
+  static const uint32_t initial[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+  };
+  memcpy(ctx->state, initial, sizeof(initial));
+  ctx->length = 0;
+  ctx->used   = 0;
+}
+
+void libtock_sha256_soft_update(libtock_sha256_soft_t* ctx, const uint8_t* data, uint32_t len) {
+  ctx->length += len;
+  if (ctx->used > 0) {
+    uint32_t n = LIBTOCK_SHA256_SOFT_BLOCK - ctx->used;
+    if (n > len) n = len;
+    memcpy(ctx->block + ctx->used, data, n);
+    ctx->used += n;
+    data      += n;
+    len       -= n;
+    if (ctx->used < LIBTOCK_SHA256_SOFT_BLOCK) return;
+    compress(ctx->state, ctx->block);
+    ctx->used = 0;
+  }
+  // Whole blocks straight from the input.
+  for ( ; len >= LIBTOCK_SHA256_SOFT_BLOCK; data += LIBTOCK_SHA256_SOFT_BLOCK, len -= LIBTOCK_SHA256_SOFT_BLOCK) {
+    compress(ctx->state, data);
+  }
+  memcpy(ctx->block, data, len);
+  ctx->used = len;
+}
+
+void libtock_sha256_soft_finish(libtock_sha256_soft_t* ctx, uint8_t* hash) {
+  uint64_t bits = ctx->length * 8;
+  ctx->block[ctx->used++] = 0x80;
+  if (ctx->used > LIBTOCK_SHA256_SOFT_BLOCK - 8) {
+    memset(ctx->block + ctx->used, 0, LIBTOCK_SHA256_SOFT_BLOCK - ctx->used);
+    compress(ctx->state, ctx->block);
+    ctx->used = 0;
+  }
+  memset(ctx->block + ctx->used, 0, LIBTOCK_SHA256_SOFT_BLOCK - 8 - ctx->used);
+  store_be(ctx->block + 56, bits >> 32);
+  store_be(ctx->block + 60, bits);
+  compress(ctx->state, ctx->block);
+
+  for (int i = 0; i < 8; i++) {
+    store_be(hash + 4 * i, ctx->state[i]);
+  }
+}
+
+void libtock_sha256_soft(const uint8_t* data, uint32_t len, uint8_t* hash) {
+  libtock_sha256_soft_t ctx;
+  libtock_sha256_soft_init(&ctx);
+  libtock_sha256_soft_update(&ctx, data, len);
+  libtock_sha256_soft_finish(&ctx, hash);
+}
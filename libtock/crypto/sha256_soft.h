@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// SHA-256 in software, used by `sha.h` and `hmac.h` when the kernel has no
+// driver or the input is too small to be worth a trip to the kernel.
+//
+// Written for 32-bit cores: the state and message schedule are words, the
+// schedule is kept to a 16-word window to save stack, and rotations and byte
+// swaps are plain C that compiles to single instructions on Cortex-M3 and
+// later and on RV32 with Zbb.
+
+#define LIBTOCK_SHA256_SOFT_BLOCK 64
+#define LIBTOCK_SHA256_SOFT_HASH  32
+
+typedef struct {
+  uint32_t state[8];
+  uint64_t length;
+  uint8_t block[LIBTOCK_SHA256_SOFT_BLOCK];
+  uint32_t used;
+} libtock_sha256_soft_t;
+
+void libtock_sha256_soft_init(libtock_sha256_soft_t* ctx);
+
+void libtock_sha256_soft_update(libtock_sha256_soft_t* ctx, const uint8_t* data, uint32_t len);
+
+// Complete the hash and write its `LIBTOCK_SHA256_SOFT_HASH` bytes to `hash`.
+void libtock_sha256_soft_finish(libtock_sha256_soft_t* ctx, uint8_t* hash);
+
+// Hash `len` bytes of `data` in one go.
+void libtock_sha256_soft(const uint8_t* data, uint32_t len, uint8_t* hash);
+
+#ifdef __cplusplus
+}
+#endif
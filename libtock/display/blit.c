@@ -0,0 +1,234 @@
+#include <string.h>
+
+#include "blit.h"
+
+// Unaligned word access. The compiler turns these into single loads and
+// stores where the core allows it.
+static inline uint32_t load32(const uint8_t* p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline void store32(uint8_t* p, uint32_t v) {
+  memcpy(p, &v, sizeof(v));
+}
+
+// A pixel in screen byte order, as it appears in memory read as a native
+// halfword.
+static inline uint16_t screen_order(uint16_t color) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  return (uint16_t) ((color >> 8) | (color << 8));
+#else
+  return color;
+#endif
+}
+
+// Two pixels in screen byte order as a native word, `first` at the lower
+// address.
+static inline uint32_t screen_pair(uint16_t first, uint16_t second) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  return (uint32_t) screen_order(first) | ((uint32_t) screen_order(second) << 16);
+#else
+  return ((uint32_t) first << 16) | second;
+#endif
+}
+
+void libtock_blit_rgb888_to_rgb565(uint8_t* dst, const uint8_t* src, size_t pixels) {
+  // Four pixels at a time: three words in, two words out.
+  for (; pixels >= 4; pixels -= 4, src += 12, dst += 8) {
+    uint32_t w0 = load32(src);
+    uint32_t w1 = load32(src + 4);
+    uint32_t w2 = load32(src + 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint16_t p0 = LIBTOCK_BLIT_RGB565(w0 & 0xFF, (w0 >> 8) & 0xFF, (w0 >> 16) & 0xFF);
+    uint16_t p1 = LIBTOCK_BLIT_RGB565(w0 >> 24, w1 & 0xFF, (w1 >> 8) & 0xFF);
+    uint16_t p2 = LIBTOCK_BLIT_RGB565((w1 >> 16) & 0xFF, w1 >> 24, w2 & 0xFF);
+    uint16_t p3 = LIBTOCK_BLIT_RGB565((w2 >> 8) & 0xFF, (w2 >> 16) & 0xFF, w2 >> 24);
+#else
+    uint16_t p0 = LIBTOCK_BLIT_RGB565(w0 >> 24, (w0 >> 16) & 0xFF, (w0 >> 8) & 0xFF);
+    uint16_t p1 = LIBTOCK_BLIT_RGB565(w0 & 0xFF, w1 >> 24, (w1 >> 16) & 0xFF);
+    uint16_t p2 = LIBTOCK_BLIT_RGB565((w1 >> 8) & 0xFF, w1 & 0xFF, w2 >> 24);
+    uint16_t p3 = LIBTOCK_BLIT_RGB565((w2 >> 16) & 0xFF, (w2 >> 8) & 0xFF, w2 & 0xFF);
+#endif
+    store32(dst, screen_pair(p0, p1));
+    store32(dst + 4, screen_pair(p2, p3));
+  }
+  for (; pixels > 0; pixels--, src += 3, dst += 2) {
+    uint16_t p = LIBTOCK_BLIT_RGB565(src[0], src[1], src[2]);
+    dst[0] = p >> 8;
+    dst[1] = p & 0xFF;
+  }
+}
+
+void libtock_blit_swap16(uint8_t* buf, size_t pixels) {
+  for (; pixels >= 2; pixels -= 2, buf += 4) {
+    uint32_t w = load32(buf);
+    store32(buf, ((w & 0x00FF00FF) << 8) | ((w >> 8) & 0x00FF00FF));
+  }
+  if (pixels > 0) {
+    uint8_t t = buf[0];
+    buf[0] = buf[1];
+    buf[1] = t;
+  }
+}
+
+void libtock_blit_mono_to_rgb565(uint8_t* dst, const uint8_t* src, size_t pixels, uint16_t fg, uint16_t bg) {
+  // Every pair of bits becomes one output word.
+  uint32_t pairs[4] = {
+    screen_pair(bg, bg), screen_pair(bg, fg), screen_pair(fg, bg), screen_pair(fg, fg),
+  };
+
+  for (; pixels >= 8; pixels -= 8, src++, dst += 16) {
+    uint8_t bits = *src;
+    store32(dst, pairs[bits >> 6]);
+    store32(dst + 4, pairs[(bits >> 4) & 3]);
+    store32(dst + 8, pairs[(bits >> 2) & 3]);
+    store32(dst + 12, pairs[bits & 3]);
+  }
+  for (size_t i = 0; i < pixels; i++, dst += 2) {
+    uint16_t p = (*src & (0x80 >> i)) ? fg : bg;
+    dst[0] = p >> 8;
+    dst[1] = p & 0xFF;
+  }
+}
+
+// Luminance of an RGB565 pixel, from 0 to 255, as (2R + 5G + B) / 8.
+static inline uint8_t luminance(uint16_t p) {
+  uint32_t r = (p >> 11) << 3;
+  uint32_t g = ((p >> 5) & 0x3F) << 2;
+  uint32_t b = (p & 0x1F) << 3;
+  return (uint8_t) ((2 * r + 5 * g + b) >> 3);
+}
+
+void libtock_blit_rgb565_to_mono(uint8_t* dst, const uint8_t* src, size_t pixels, uint8_t threshold) {
+  uint8_t bits = 0;
+  size_t i;
+  for (i = 0; i < pixels; i++, src += 2) {
+    bits <<= 1;
+    if (luminance((uint16_t) ((src[0] << 8) | src[1])) >= threshold) bits |= 1;
+    if ((i & 7) == 7) {
+      *dst++ = bits;
+      bits   = 0;
+    }
+  }
+  if (i & 7) *dst = bits << (8 - (i & 7));
+}
+
+void libtock_blit_fill_rgb565(uint8_t* dst, size_t pixels, uint16_t color) {
+  if (pixels == 0) return;
+
+  // Two pixels per word, four words per iteration.
+  uint32_t pair = screen_pair(color, color);
+  for (; pixels >= 8; pixels -= 8, dst += 16) {
+    store32(dst, pair);
+    store32(dst + 4, pair);
+    store32(dst + 8, pair);
+    store32(dst + 12, pair);
+  }
+  for (; pixels >= 2; pixels -= 2, dst += 4) {
+    store32(dst, pair);
+  }
+  if (pixels > 0) {
+    dst[0] = color >> 8;
+    dst[1] = color & 0xFF;
+  }
+}
+
+void libtock_blit_fill_rect_rgb565(uint8_t* dst, size_t stride, uint16_t width, uint16_t height, uint16_t color) {
+  if (width == 0 || height == 0) return;
+
+  // Fill the first row, then copy it to the others.
+  libtock_blit_fill_rgb565(dst, width, color);
+  libtock_blit_copy_rect(dst + stride, stride, dst, 0, width * 2, height - 1);
+}
+
+void libtock_blit_copy_rect(uint8_t* dst, size_t dst_stride, const uint8_t* src, size_t src_stride,
+                            size_t row_bytes, uint16_t height) {
+  // Rows that are contiguous in both buffers are one copy.
+  if (dst_stride == row_bytes && src_stride == row_bytes) {
+    memcpy(dst, src, row_bytes * height);
+    return;
+  }
+  for (uint16_t y = 0; y < height; y++, dst += dst_stride, src += src_stride) {
+    memcpy(dst, src, row_bytes);
+  }
+}
+
+#define TILE 8
+
+static inline __attribute__((always_inline)) void copy_pixel(uint8_t* dst, const uint8_t* src, uint8_t bpp) {
+  switch (bpp) {
+    case 1: *dst = *src; break;
+    case 2: memcpy(dst, src, 2); break;
+    case 4: memcpy(dst, src, 4); break;
+    default: memcpy(dst, src, bpp); break;
+  }
+}
+
+// Quarter turn of the tile of `src` at `x0`,`y0`. Source pixel `x`,`y` goes
+// to `height - 1 - y`,`x` when `clockwise`, and to `y`,`width - 1 - x`
+// otherwise.
+static inline __attribute__((always_inline)) void turn_tile(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                                             size_t src_stride, uint16_t width, uint16_t height,
+                                                             uint16_t x0, uint16_t y0, uint8_t bpp, bool clockwise) {
+  uint16_t x1 = x0 + TILE < width ? x0 + TILE : width;
+  uint16_t y1 = y0 + TILE < height ? y0 + TILE : height;
+  for (uint16_t x = x0; x < x1; x++) {
+    uint16_t row      = clockwise ? x : width - 1 - x;
+    uint8_t* out      = dst + row * dst_stride;
+    const uint8_t* in = src + y0 * src_stride + x * bpp;
+    if (clockwise) {
+      out += (size_t) (height - 1 - y0) * bpp;
+      for (uint16_t y = y0; y < y1; y++, in += src_stride, out -= bpp) copy_pixel(out, in, bpp);
+    } else {
+      out += (size_t) y0 * bpp;
+      for (uint16_t y = y0; y < y1; y++, in += src_stride, out += bpp) copy_pixel(out, in, bpp);
+    }
+  }
+}
+
+static inline __attribute__((always_inline)) void turn(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                                        size_t src_stride, uint16_t width, uint16_t height,
+                                                        uint8_t bpp, bool clockwise) {
+  for (uint16_t y0 = 0; y0 < height; y0 += TILE) {
+    for (uint16_t x0 = 0; x0 < width; x0 += TILE) {
+      turn_tile(dst, dst_stride, src, src_stride, width, height, x0, y0, bpp, clockwise);
+    }
+  }
+}
+
+// Half turn: each row of `src` goes reversed to the mirrored row of `dst`.
+static void half_turn(uint8_t* dst, size_t dst_stride, const uint8_t* src, size_t src_stride,
+                      uint16_t width, uint16_t height, uint8_t bpp) {
+  for (uint16_t y = 0; y < height; y++) {
+    const uint8_t* in = src + y * src_stride;
+    uint8_t* out      = dst + (height - 1 - y) * dst_stride + (size_t) (width - 1) * bpp;
+    for (uint16_t x = 0; x < width; x++, in += bpp, out -= bpp) copy_pixel(out, in, bpp);
+  }
+}
+
+void libtock_blit_rotate_rect(uint8_t* dst, size_t dst_stride, const uint8_t* src, size_t src_stride,
+                              uint16_t width, uint16_t height, uint8_t bytes_per_pixel,
+                              libtock_screen_rotation_t rotation) {
+  if (width == 0 || height == 0) return;
+
+  if (rotation == ROTATION_180) {
+    half_turn(dst, dst_stride, src, src_stride, width, height, bytes_per_pixel);
+    return;
+  }
+  if (rotation != ROTATION_90 && rotation != ROTATION_270) {
+    libtock_blit_copy_rect(dst, dst_stride, src, src_stride, (size_t) width * bytes_per_pixel, height);
+    return;
+  }
+
+  // Separate loops for the common pixel sizes let the compiler turn each
+  // pixel copy into one load and store.
+  bool clockwise = rotation == ROTATION_90;
+  switch (bytes_per_pixel) {
+    case 1: turn(dst, dst_stride, src, src_stride, width, height, 1, clockwise); break;
+    case 2: turn(dst, dst_stride, src, src_stride, width, height, 2, clockwise); break;
+    case 4: turn(dst, dst_stride, src, src_stride, width, height, 4, clockwise); break;
+    default: turn(dst, dst_stride, src, src_stride, width, height, bytes_per_pixel, clockwise); break;
+  }
+}
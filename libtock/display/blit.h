@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../tock.h"
+#include "screen.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Pixel conversion and rectangle kernels for preparing screen buffers.
+//
+// RGB565 pixels are stored most significant byte first, the order the
+// screen driver expects (see `libtock_screen_fill()`). RGB888 pixels are
+// stored as red, green, blue bytes. Mono bitmaps hold one bit per pixel,
+// most significant bit first, 1 for a set pixel.
+//
+// The kernels work on 32-bit words where they can, which on Cortex-M is
+// several times faster than converting pixel by pixel. Buffers need no
+// particular alignment.
+
+// Pack an RGB565 color from 8-bit components.
+#define LIBTOCK_BLIT_RGB565(r, g, b) \
+        ((uint16_t) ((((r) & 0xF8) << 8) | (((g) & 0xFC) << 3) | ((b) >> 3)))
+
+// Convert `pixels` RGB888 pixels from `src` to RGB565 in `dst`.
+void libtock_blit_rgb888_to_rgb565(uint8_t* dst, const uint8_t* src, size_t pixels);
+
+// Swap the bytes of `pixels` 16-bit pixels in place, to convert between the
+// screen's byte order and the CPU's.
+void libtock_blit_swap16(uint8_t* buf, size_t pixels);
+
+// Expand `pixels` pixels of the mono bitmap `src` to RGB565, with `fg` for
+// set pixels and `bg` for clear ones.
+void libtock_blit_mono_to_rgb565(uint8_t* dst, const uint8_t* src, size_t pixels, uint16_t fg, uint16_t bg);
+
+// Pack `pixels` RGB565 pixels into a mono bitmap. A pixel is set if its
+// luminance, from 0 to 255, is at least `threshold`. Unused bits of the last
+// byte are cleared.
+void libtock_blit_rgb565_to_mono(uint8_t* dst, const uint8_t* src, size_t pixels, uint8_t threshold);
+
+// Fill `pixels` RGB565 pixels with `color`.
+void libtock_blit_fill_rgb565(uint8_t* dst, size_t pixels, uint16_t color);
+
+// Fill a `width` by `height` rectangle of RGB565 pixels with `color`.
+// `stride` is the distance between rows of `dst` in bytes.
+void libtock_blit_fill_rect_rgb565(uint8_t* dst, size_t stride, uint16_t width, uint16_t height, uint16_t color);
+
+// Copy a rectangle of `row_bytes` by `height` between buffers with row
+// strides `dst_stride` and `src_stride` in bytes.
+void libtock_blit_copy_rect(uint8_t* dst, size_t dst_stride, const uint8_t* src, size_t src_stride,
+                            size_t row_bytes, uint16_t height);
+
+// Copy a `width` by `height` rectangle of `bytes_per_pixel` pixels from
+// `src` to `dst`, turned clockwise by `rotation`. For `ROTATION_90` and
+// `ROTATION_270`, `dst` receives `height` by `width` pixels. Strides are in
+// bytes.
+//
+// Quarter turns walk the rectangle in 8 by 8 pixel tiles, so the rows of
+// `src` a tile reads stay in cache while it writes whole runs of `dst`, and
+// a rotated copy costs close to a straight one.
+void libtock_blit_rotate_rect(uint8_t* dst, size_t dst_stride, const uint8_t* src, size_t src_stride,
+                              uint16_t width, uint16_t height, uint8_t bytes_per_pixel,
+                              libtock_screen_rotation_t rotation);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,4 +1,4 @@
-#include <stdlib.h>
+#include "../services/dma_buffer.h"
 
 #include "screen.h"
 
@@ -10,6 +10,29 @@ static void screen_callback_done(int                          status,
   cb(tock_status_to_returncode(status));
 }
 
+// What the screen supports, read from the kernel on first use. Only the
+// current resolution can change, when the resolution or rotation is set.
+static struct {
+  int32_t resolutions;
+  uint32_t widths[LIBTOCK_SCREEN_CACHED_MODES];
+  uint32_t heights[LIBTOCK_SCREEN_CACHED_MODES];
+  int32_t formats;
+  libtock_screen_format_t format_list[LIBTOCK_SCREEN_CACHED_MODES];
+  bool resolution_valid;
+  uint32_t width;
+  uint32_t height;
+} caps = { .resolutions = -1, .formats = -1 };
+
+// Like `screen_callback_done()`, for operations that change the resolution.
+static void screen_callback_resized(int                          status,
+                                    __attribute__ ((unused)) int data1,
+                                    __attribute__ ((unused)) int data2,
+                                    void*                        opaque) {
+  caps.resolution_valid = false;
+  libtock_screen_callback_done cb = (libtock_screen_callback_done) opaque;
+  cb(tock_status_to_returncode(status));
+}
+
 static void screen_callback_format(int                          status,
                                    __attribute__ ((unused)) int data1,
                                    __attribute__ ((unused)) int data2,
@@ -30,7 +53,7 @@ static void screen_callback_rotation(int                          status,
 statuscode_t libtock_screen_buffer_init(size_t len, uint8_t** buffer) {
   if (*buffer != NULL) return TOCK_STATUSCODE_ALREADY;
 
-  *buffer = (uint8_t*) calloc(1, len);
+  *buffer = (uint8_t*) libtock_dma_buffer_alloc(len);
   if (*buffer == NULL) return TOCK_STATUSCODE_FAIL;
 
   return TOCK_STATUSCODE_SUCCESS;
@@ -61,23 +84,68 @@ int libtock_screen_get_bits_per_pixel(libtock_screen_format_t format) {
 
 
 returncode_t libtock_screen_get_supported_resolutions(uint32_t* resolutions) {
-  return libtock_screen_command_get_supported_resolutions(resolutions);
+  if (caps.resolutions < 0) {
+    returncode_t ret = libtock_screen_command_get_supported_resolutions(resolutions);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    caps.resolutions = (int32_t) *resolutions;
+
+    // Read the modes now, so the loop apps run over them costs no calls.
+    for (int32_t i = 0; i < caps.resolutions && i < LIBTOCK_SCREEN_CACHED_MODES; i++) {
+      ret = libtock_screen_command_get_supported_resolution(i, &caps.widths[i], &caps.heights[i]);
+      if (ret != RETURNCODE_SUCCESS) {
+        caps.resolutions = -1;
+        return ret;
+      }
+    }
+  }
+  *resolutions = (uint32_t) caps.resolutions;
+  return RETURNCODE_SUCCESS;
 }
 
 returncode_t libtock_screen_get_supported_resolution(size_t index, uint32_t* width, uint32_t* height) {
-  return libtock_screen_command_get_supported_resolution(index, width, height);
+  uint32_t count;
+  returncode_t ret = libtock_screen_get_supported_resolutions(&count);
+  if (ret != RETURNCODE_SUCCESS || index >= LIBTOCK_SCREEN_CACHED_MODES) {
+    return libtock_screen_command_get_supported_resolution(index, width, height);
+  }
+  if (index >= count) return RETURNCODE_EINVAL;
+  *width  = caps.widths[index];
+  *height = caps.heights[index];
+  return RETURNCODE_SUCCESS;
 }
 
 returncode_t libtock_screen_get_supported_pixel_formats(uint32_t* formats) {
-  return libtock_screen_command_get_supported_pixel_formats(formats);
+  if (caps.formats < 0) {
+    returncode_t ret = libtock_screen_command_get_supported_pixel_formats(formats);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    caps.formats = (int32_t) *formats;
+
+    for (int32_t i = 0; i < caps.formats && i < LIBTOCK_SCREEN_CACHED_MODES; i++) {
+      uint32_t f;
+      ret = libtock_screen_command_get_supported_pixel_format(i, &f);
+      if (ret != RETURNCODE_SUCCESS) {
+        caps.formats = -1;
+        return ret;
+      }
+      caps.format_list[i] = f;
+    }
+  }
+  *formats = (uint32_t) caps.formats;
+  return RETURNCODE_SUCCESS;
 }
 
 returncode_t libtock_screen_get_supported_pixel_format(size_t index, libtock_screen_format_t* format) {
-  returncode_t ret;
-  uint32_t f;
-  ret     = libtock_screen_command_get_supported_pixel_format(index, &f);
-  *format = f;
-  return ret;
+  uint32_t count;
+  returncode_t ret = libtock_screen_get_supported_pixel_formats(&count);
+  if (ret != RETURNCODE_SUCCESS || index >= LIBTOCK_SCREEN_CACHED_MODES) {
+    uint32_t f;
+    ret     = libtock_screen_command_get_supported_pixel_format(index, &f);
+    *format = f;
+    return ret;
+  }
+  if (index >= count) return RETURNCODE_EINVAL;
+  *format = caps.format_list[index];
+  return RETURNCODE_SUCCESS;
 }
 
 bool libtock_screen_setup_enabled(void) {
@@ -121,13 +189,21 @@ returncode_t libtock_screen_invert_off(libtock_screen_callback_done cb) {
 
 
 returncode_t libtock_screen_get_resolution(uint32_t* width, uint32_t* height) {
-  return libtock_screen_command_get_resolution(width, height);
+  if (!caps.resolution_valid) {
+    returncode_t ret = libtock_screen_command_get_resolution(&caps.width, &caps.height);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    caps.resolution_valid = true;
+  }
+  *width  = caps.width;
+  *height = caps.height;
+  return RETURNCODE_SUCCESS;
 }
 
 returncode_t libtock_screen_set_resolution(uint32_t width, uint32_t height, libtock_screen_callback_done cb) {
   returncode_t ret;
 
-  ret = libtock_screen_set_upcall(screen_callback_done, cb);
+  caps.resolution_valid = false;
+  ret = libtock_screen_set_upcall(screen_callback_resized, cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   ret = libtock_screen_command_set_resolution(width, height);
@@ -170,7 +246,9 @@ returncode_t libtock_screen_get_rotation(libtock_screen_callback_rotation cb) {
 returncode_t libtock_screen_set_rotation(libtock_screen_rotation_t rotation, libtock_screen_callback_done cb) {
   returncode_t ret;
 
-  ret = libtock_screen_set_upcall(screen_callback_done, cb);
+  // Rotating swaps the width and height.
+  caps.resolution_valid = false;
+  ret = libtock_screen_set_upcall(screen_callback_resized, cb);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   ret = libtock_screen_command_set_rotation((uint32_t) rotation);
@@ -48,7 +48,9 @@ typedef void (*libtock_screen_callback_rotation)(returncode_t, libtock_screen_ro
 // Allocate and setup `buffer` with size `len`.
 //
 // This will allocate len bytes and assign buffer to the array. This buffer can
-// be used for drawing the screen.
+// be used for drawing the screen. It comes zeroed from
+// `libtock/services/dma_buffer.h`, so free it with
+// `libtock_dma_buffer_free()`.
 statuscode_t libtock_screen_buffer_init(size_t len, uint8_t** buffer);
 
 // QUERY
@@ -57,6 +59,14 @@ statuscode_t libtock_screen_buffer_init(size_t len, uint8_t** buffer);
 // `false` otherwise.
 bool libtock_screen_setup_enabled(void);
 
+// Supported resolutions and pixel formats are read from the kernel on first
+// use and cached, as is the current resolution until it is set or the
+// screen is rotated. Modes past this many are read from the kernel each
+// time.
+#ifndef LIBTOCK_SCREEN_CACHED_MODES
+#define LIBTOCK_SCREEN_CACHED_MODES 8
+#endif
+
 // Get the number of supported resolutions for the screen.
 returncode_t libtock_screen_get_supported_resolutions(uint32_t* resolutions);
 
@@ -0,0 +1,153 @@
+#include "ahrs.h"
+#include "dsp.h"
+
+#define ONE_Q30 ((int32_t) 1 << 30)
+
+static inline int32_t mul_q30(int32_t a, int32_t b) {
+  return (int32_t) (((int64_t) a * b) >> 30);
+}
+
+returncode_t libtock_dsp_ahrs_init(libtock_dsp_ahrs_t* ahrs, uint32_t sample_rate_hz, int32_t gyro_scale) {
+  if (sample_rate_hz == 0) return RETURNCODE_EINVAL;
+
+  ahrs->q[0]        = ONE_Q30;
+  ahrs->q[1]        = 0;
+  ahrs->q[2]        = 0;
+  ahrs->q[3]        = 0;
+  ahrs->integral[0] = 0;
+  ahrs->integral[1] = 0;
+  ahrs->integral[2] = 0;
+  ahrs->two_kp      = LIBTOCK_DSP_AHRS_TWO_KP;
+  ahrs->two_ki      = LIBTOCK_DSP_AHRS_TWO_KI;
+  ahrs->dt          = (int32_t) (ONE_Q30 / sample_rate_hz);
+  ahrs->gyro_scale  = gyro_scale;
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_dsp_ahrs_set_gains(libtock_dsp_ahrs_t* ahrs, int32_t two_kp, int32_t two_ki) {
+  ahrs->two_kp = two_kp;
+  ahrs->two_ki = two_ki;
+}
+
+// Add the error between the measured direction `m`, normalized, and the
+// direction `v` the current orientation predicts for it.
+static void add_error(int64_t* e, const libtock_dsp_vec3_t* m, const libtock_dsp_vec3_t* v) {
+  libtock_dsp_vec3_t c;
+  libtock_dsp_vec3_cross_q30(m, v, &c);
+  e[0] += c.x;
+  e[1] += c.y;
+  e[2] += c.z;
+}
+
+void libtock_dsp_ahrs_update(libtock_dsp_ahrs_t* ahrs, const libtock_dsp_vec3_t* gyro,
+                             const libtock_dsp_vec3_t* accel, const libtock_dsp_vec3_t* mag) {
+  int32_t q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+
+  // Rotation rate in Q24 radians per second.
+  int64_t g[3] = {
+    (int64_t) gyro->x * ahrs->gyro_scale,
+    (int64_t) gyro->y * ahrs->gyro_scale,
+    (int64_t) gyro->z * ahrs->gyro_scale,
+  };
+
+  libtock_dsp_vec3_t a;
+  if (libtock_dsp_vec3_normalize_q30(accel, &a) == RETURNCODE_SUCCESS) {
+    int64_t e[3] = { 0, 0, 0 };
+
+    // Gravity as the current orientation sees it.
+    libtock_dsp_vec3_t v = {
+      2 * (mul_q30(q1, q3) - mul_q30(q0, q2)),
+      2 * (mul_q30(q0, q1) + mul_q30(q2, q3)),
+      mul_q30(q0, q0) - mul_q30(q1, q1) - mul_q30(q2, q2) + mul_q30(q3, q3),
+    };
+    add_error(e, &a, &v);
+
+    libtock_dsp_vec3_t m;
+    if (mag != NULL && libtock_dsp_vec3_normalize_q30(mag, &m) == RETURNCODE_SUCCESS) {
+      int32_t half = ONE_Q30 / 2;
+      // The field in the earth frame, with its horizontal part along x.
+      int32_t hx = 2 * (mul_q30(m.x, half - mul_q30(q2, q2) - mul_q30(q3, q3)) +
+                        mul_q30(m.y, mul_q30(q1, q2) - mul_q30(q0, q3)) +
+                        mul_q30(m.z, mul_q30(q1, q3) + mul_q30(q0, q2)));
+      int32_t hy = 2 * (mul_q30(m.x, mul_q30(q1, q2) + mul_q30(q0, q3)) +
+                        mul_q30(m.y, half - mul_q30(q1, q1) - mul_q30(q3, q3)) +
+                        mul_q30(m.z, mul_q30(q2, q3) - mul_q30(q0, q1)));
+      int32_t bz = 2 * (mul_q30(m.x, mul_q30(q1, q3) - mul_q30(q0, q2)) +
+                        mul_q30(m.y, mul_q30(q2, q3) + mul_q30(q0, q1)) +
+                        mul_q30(m.z, half - mul_q30(q1, q1) - mul_q30(q2, q2)));
+      int32_t bx = (int32_t) libtock_dsp_sqrt_u64((uint64_t) ((int64_t) hx * hx + (int64_t) hy * hy));
+
+      // That field as the current orientation sees it.
+      libtock_dsp_vec3_t w = {
+        2 * (mul_q30(bx, half - mul_q30(q2, q2) - mul_q30(q3, q3)) + mul_q30(bz, mul_q30(q1, q3) - mul_q30(q0, q2))),
+        2 * (mul_q30(bx, mul_q30(q1, q2) - mul_q30(q0, q3)) + mul_q30(bz, mul_q30(q0, q1) + mul_q30(q2, q3))),
+        2 * (mul_q30(bx, mul_q30(q0, q2) + mul_q30(q1, q3)) + mul_q30(bz, half - mul_q30(q1, q1) - mul_q30(q2, q2))),
+      };
+      add_error(e, &m, &w);
+    }
+
+    for (int i = 0; i < 3; i++) {
+      // Half the error, in Q24, as the gains are doubled.
+      int64_t e24 = e[i] >> 7;
+      if (ahrs->two_ki != 0) {
+        ahrs->integral[i] += (int32_t) ((((ahrs->two_ki * e24) >> 16) * ahrs->dt) >> 30);
+      }
+      g[i] += ((ahrs->two_kp * e24) >> 16) + ahrs->integral[i];
+    }
+  }
+
+  // Half the rotation over one period, Q30 radians.
+  int32_t hx = (int32_t) ((g[0] * ahrs->dt) >> 25);
+  int32_t hy = (int32_t) ((g[1] * ahrs->dt) >> 25);
+  int32_t hz = (int32_t) ((g[2] * ahrs->dt) >> 25);
+
+  q0 += -mul_q30(ahrs->q[1], hx) - mul_q30(ahrs->q[2], hy) - mul_q30(ahrs->q[3], hz);
+  q1 += mul_q30(ahrs->q[0], hx) + mul_q30(ahrs->q[2], hz) - mul_q30(ahrs->q[3], hy);
+  q2 += mul_q30(ahrs->q[0], hy) - mul_q30(ahrs->q[1], hz) + mul_q30(ahrs->q[3], hx);
+  q3 += mul_q30(ahrs->q[0], hz) + mul_q30(ahrs->q[1], hy) - mul_q30(ahrs->q[2], hx);
+
+  uint64_t sum = 0;
+  int32_t q[4] = { q0, q1, q2, q3 };
+  for (int i = 0; i < 4; i++) {
+    sum += (uint64_t) ((int64_t) q[i] * q[i]);
+  }
+  uint32_t norm = libtock_dsp_sqrt_u64(sum);
+  for (int i = 0; i < 4; i++) {
+    ahrs->q[i] = (int32_t) (((int64_t) q[i] << 30) / norm);
+  }
+}
+
+void libtock_dsp_ahrs_update_ninedof(libtock_dsp_ahrs_t* ahrs, const libtock_ninedof_sample_t* sample) {
+  libtock_dsp_vec3_t zero  = { 0, 0, 0 };
+  libtock_dsp_vec3_t gyro  = zero;
+  libtock_dsp_vec3_t accel = zero;
+  libtock_dsp_vec3_t mag   = zero;
+
+  if (sample->valid & LIBTOCK_NINEDOF_GYROSCOPE) {
+    gyro = (libtock_dsp_vec3_t) { sample->gyroscope[0], sample->gyroscope[1], sample->gyroscope[2] };
+  }
+  if (sample->valid & LIBTOCK_NINEDOF_ACCELEROMETER) {
+    accel = (libtock_dsp_vec3_t) { sample->accelerometer[0], sample->accelerometer[1], sample->accelerometer[2] };
+  }
+  if (sample->valid & LIBTOCK_NINEDOF_MAGNETOMETER) {
+    mag = (libtock_dsp_vec3_t) { sample->magnetometer[0], sample->magnetometer[1], sample->magnetometer[2] };
+  }
+  libtock_dsp_ahrs_update(ahrs, &gyro, &accel, &mag);
+}
+
+void libtock_dsp_ahrs_euler_cdeg(const libtock_dsp_ahrs_t* ahrs, int32_t* roll, int32_t* pitch, int32_t* yaw) {
+  int32_t q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+
+  *roll = libtock_dsp_atan2_cdeg(2 * (mul_q30(q0, q1) + mul_q30(q2, q3)),
+                                 ONE_Q30 - 2 * (mul_q30(q1, q1) + mul_q30(q2, q2)));
+
+  // asin(s) as atan2(s, sqrt(1 - s^2)).
+  int32_t s = 2 * (mul_q30(q0, q2) - mul_q30(q3, q1));
+  if (s > ONE_Q30) s = ONE_Q30;
+  if (s < -ONE_Q30) s = -ONE_Q30;
+  int32_t c = (int32_t) libtock_dsp_sqrt_u64((uint64_t) (((int64_t) ONE_Q30 << 30) - (int64_t) s * s));
+  *pitch = libtock_dsp_atan2_cdeg(s, c);
+
+  *yaw = libtock_dsp_atan2_cdeg(2 * (mul_q30(q0, q3) + mul_q30(q1, q2)),
+                                ONE_Q30 - 2 * (mul_q30(q2, q2) + mul_q30(q3, q3)));
+}
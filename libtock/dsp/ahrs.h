@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../sensors/ninedof.h"
+#include "../tock.h"
+#include "vector.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fixed-point Mahony orientation filter.
+//
+// The filter integrates the gyroscope into an orientation quaternion and
+// corrects its drift with the direction of gravity from the accelerometer
+// and, when given, of north from the magnetometer. Everything is integer
+// math on Q30 values with 64-bit intermediates, so it runs at the same speed
+// with or without an FPU, and fast enough at 100 Hz on a Cortex-M0.
+//
+// Rates are Q24 radians per second internally. Gyroscope readings are
+// converted with a scale in the same format, and the accelerometer and
+// magnetometer readings are normalized, so their units do not matter.
+
+// Gyroscope scale for readings in degrees per second, pi / 180 in Q24.
+#define LIBTOCK_DSP_AHRS_GYRO_DPS 292818
+
+// Default proportional gain, 2 * Kp with Kp = 0.5, in Q16.
+#ifndef LIBTOCK_DSP_AHRS_TWO_KP
+#define LIBTOCK_DSP_AHRS_TWO_KP 65536
+#endif
+
+// Default integral gain, 2 * Ki, in Q16. Integral feedback removes a constant
+// gyroscope bias, and is off by default.
+#ifndef LIBTOCK_DSP_AHRS_TWO_KI
+#define LIBTOCK_DSP_AHRS_TWO_KI 0
+#endif
+
+typedef struct {
+  // Orientation quaternion w, x, y, z in Q30.
+  int32_t q[4];
+  // Integral feedback, Q24 radians per second.
+  int32_t integral[3];
+  // Gains in Q16.
+  int32_t two_kp;
+  int32_t two_ki;
+  // Sample period in Q30 seconds.
+  int32_t dt;
+  // Q24 radians per second per gyroscope unit.
+  int32_t gyro_scale;
+} libtock_dsp_ahrs_t;
+
+// Start from the identity orientation with updates at `sample_rate_hz`,
+// gyroscope readings scaled by `gyro_scale`, such as
+// `LIBTOCK_DSP_AHRS_GYRO_DPS`, and the default gains.
+//
+// Returns RETURNCODE_EINVAL if `sample_rate_hz` is 0.
+returncode_t libtock_dsp_ahrs_init(libtock_dsp_ahrs_t* ahrs, uint32_t sample_rate_hz, int32_t gyro_scale);
+
+// Set both gains, in Q16.
+void libtock_dsp_ahrs_set_gains(libtock_dsp_ahrs_t* ahrs, int32_t two_kp, int32_t two_ki);
+
+// Advance one sample period. `mag` may be NULL to track roll and pitch only.
+// An all zero `accel` skips the correction, as in free fall.
+void libtock_dsp_ahrs_update(libtock_dsp_ahrs_t* ahrs, const libtock_dsp_vec3_t* gyro,
+                             const libtock_dsp_vec3_t* accel, const libtock_dsp_vec3_t* mag);
+
+// Advance one sample period with a combined read from
+// `libtock_ninedof_read_all()`. Sensors missing from the sample are left out.
+void libtock_dsp_ahrs_update_ninedof(libtock_dsp_ahrs_t* ahrs, const libtock_ninedof_sample_t* sample);
+
+// The orientation as roll, pitch and yaw in hundredths of a degree.
+void libtock_dsp_ahrs_euler_cdeg(const libtock_dsp_ahrs_t* ahrs, int32_t* roll, int32_t* pitch, int32_t* yaw);
+
+#ifdef __cplusplus
+}
+#endif
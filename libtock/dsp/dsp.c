@@ -0,0 +1,403 @@
+#include <string.h>
+
+#include "dsp.h"
+
+#if defined(__ARM_FEATURE_DSP)
+// Two Q15 values in one word, `lo` in the low half.
+static inline uint32_t pack16(int16_t lo, int16_t hi) {
+  return (uint16_t) lo | ((uint32_t) (uint16_t) hi << 16);
+}
+
+// Two Q15 values starting at `p`, `p[0]` in the low half. Cortex-M4 and M7
+// allow unaligned word loads.
+static inline uint32_t load16x2(const int16_t* p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+// acc + a.lo * b.lo + a.hi * b.hi
+static inline int32_t smlad(uint32_t a, uint32_t b, int32_t acc) {
+  int32_t r;
+  __asm__ ("smlad %0, %1, %2, %3" : "=r" (r) : "r" (a), "r" (b), "r" (acc));
+  return r;
+}
+
+// acc + a.lo * b.hi + a.hi * b.lo
+static inline int32_t smladx(uint32_t a, uint32_t b, int32_t acc) {
+  int32_t r;
+  __asm__ ("smladx %0, %1, %2, %3" : "=r" (r) : "r" (a), "r" (b), "r" (acc));
+  return r;
+}
+
+// acc + a.lo * b.lo + a.hi * b.hi, with a 64-bit accumulator
+static inline int64_t smlald(uint32_t a, uint32_t b, int64_t acc) {
+  __asm__ ("smlald %Q0, %R0, %1, %2" : "+r" (acc) : "r" (a), "r" (b));
+  return acc;
+}
+#endif
+
+static inline int16_t sat16(int32_t x) {
+  if (x > INT16_MAX) return INT16_MAX;
+  if (x < INT16_MIN) return INT16_MIN;
+  return (int16_t) x;
+}
+
+static inline int32_t sat32(int64_t x) {
+  if (x > INT32_MAX) return INT32_MAX;
+  if (x < INT32_MIN) return INT32_MIN;
+  return (int32_t) x;
+}
+
+uint32_t libtock_dsp_sqrt_u64(uint64_t v) {
+  uint64_t root = 0;
+  uint64_t bit  = (uint64_t) 1 << 62;
+  while (bit > v) bit >>= 2;
+  while (bit != 0) {
+    if (v >= root + bit) {
+      v   -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t) root;
+}
+
+static bool log2_exact(uint32_t length, uint8_t* shift) {
+  if (length == 0 || (length & (length - 1)) != 0) return false;
+  *shift = 0;
+  while ((1u << *shift) < length) (*shift)++;
+  return true;
+}
+
+void libtock_dsp_q15_from_adc(const uint16_t* in, int16_t* out, uint32_t len) {
+  for (uint32_t i = 0; i < len; i++) {
+    out[i] = (int16_t) (in[i] ^ 0x8000);
+  }
+}
+
+
+
+// ***** Decimation *****
+
+uint32_t libtock_dsp_decimate_q15(const int16_t* in, int16_t* out, uint32_t len, uint32_t factor) {
+  if (factor == 0) return 0;
+  uint32_t count = len / factor;
+
+  for (uint32_t o = 0; o < count; o++) {
+    const int16_t* group = in + o * factor;
+    int32_t sum = 0;
+    uint32_t i  = 0;
+#if defined(__ARM_FEATURE_DSP)
+    for ( ; i + 1 < factor; i += 2) {
+      sum = smlad(load16x2(group + i), 0x00010001, sum);
+    }
+#endif
+    for ( ; i < factor; i++) {
+      sum += group[i];
+    }
+    // Only samples of earlier groups are overwritten.
+    out[o] = (int16_t) (sum / (int32_t) factor);
+  }
+  return count;
+}
+
+uint32_t libtock_dsp_decimate_q31(const int32_t* in, int32_t* out, uint32_t len, uint32_t factor) {
+  if (factor == 0) return 0;
+  uint32_t count = len / factor;
+
+  for (uint32_t o = 0; o < count; o++) {
+    const int32_t* group = in + o * factor;
+    int64_t sum = 0;
+    for (uint32_t i = 0; i < factor; i++) {
+      sum += group[i];
+    }
+    out[o] = (int32_t) (sum / (int64_t) factor);
+  }
+  return count;
+}
+
+
+
+// ***** Moving Average *****
+
+returncode_t libtock_dsp_moving_average_q15_init(libtock_dsp_moving_average_q15_t* ma, int16_t* history,
+                                                 uint16_t length) {
+  if (!log2_exact(length, &ma->shift)) return RETURNCODE_EINVAL;
+
+  ma->history = history;
+  ma->length  = length;
+  ma->pos     = 0;
+  ma->sum     = 0;
+  memset(history, 0, length * sizeof(*history));
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_dsp_moving_average_q31_init(libtock_dsp_moving_average_q31_t* ma, int32_t* history,
+                                                 uint16_t length) {
+  if (!log2_exact(length, &ma->shift)) return RETURNCODE_EINVAL;
+
+  ma->history = history;
+  ma->length  = length;
+  ma->pos     = 0;
+  ma->sum     = 0;
+  memset(history, 0, length * sizeof(*history));
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_dsp_moving_average_q15(libtock_dsp_moving_average_q15_t* ma, const int16_t* in, int16_t* out,
+                                    uint32_t len) {
+  uint16_t mask = ma->length - 1;
+  for (uint32_t i = 0; i < len; i++) {
+    int16_t x = in[i];
+    ma->sum += x - ma->history[ma->pos];
+
+    ma->history[ma->pos] = x;
+    ma->pos              = (ma->pos + 1) & mask;
+    out[i]               = (int16_t) (ma->sum >> ma->shift);
+  }
+}
+
+void libtock_dsp_moving_average_q31(libtock_dsp_moving_average_q31_t* ma, const int32_t* in, int32_t* out,
+                                    uint32_t len) {
+  uint16_t mask = ma->length - 1;
+  for (uint32_t i = 0; i < len; i++) {
+    int32_t x = in[i];
+    ma->sum += (int64_t) x - ma->history[ma->pos];
+
+    ma->history[ma->pos] = x;
+    ma->pos              = (ma->pos + 1) & mask;
+    out[i]               = (int32_t) (ma->sum >> ma->shift);
+  }
+}
+
+
+
+// ***** Biquad *****
+
+void libtock_dsp_biquad_q15_init(libtock_dsp_biquad_q15_t* bq, uint8_t stages, const int16_t* coeffs,
+                                 int16_t* state) {
+  bq->coeffs = coeffs;
+  bq->state  = state;
+  bq->stages = stages;
+  memset(state, 0, stages * 4 * sizeof(*state));
+}
+
+void libtock_dsp_biquad_q31_init(libtock_dsp_biquad_q31_t* bq, uint8_t stages, const int32_t* coeffs,
+                                 int32_t* state) {
+  bq->coeffs = coeffs;
+  bq->state  = state;
+  bq->stages = stages;
+  memset(state, 0, stages * 4 * sizeof(*state));
+}
+
+void libtock_dsp_biquad_q15(libtock_dsp_biquad_q15_t* bq, const int16_t* in, int16_t* out, uint32_t len) {
+  if (bq->stages == 0 && in != out) memmove(out, in, len * sizeof(*out));
+
+  // The first stage reads `in`, the rest refine `out` in place.
+  const int16_t* src = in;
+  for (uint8_t s = 0; s < bq->stages; s++) {
+    const int16_t* c = bq->coeffs + 5 * s;
+    int16_t* state   = bq->state + 4 * s;
+
+#if defined(__ARM_FEATURE_DSP)
+    // The history stays packed as (x[n-1], x[n-2]) and (y[n-1], y[n-2]), so
+    // each pair of taps is one SMLAD.
+    uint32_t b12 = pack16(c[1], c[2]);
+    uint32_t a12 = pack16((int16_t) -c[3], (int16_t) -c[4]);
+    uint32_t xs  = pack16(state[0], state[1]);
+    uint32_t ys  = pack16(state[2], state[3]);
+    for (uint32_t i = 0; i < len; i++) {
+      int16_t x   = src[i];
+      int32_t acc = c[0] * x;
+      acc = smlad(b12, xs, acc);
+      acc = smlad(a12, ys, acc);
+      int16_t y = sat16(acc >> 14);
+      xs     = (xs << 16) | (uint16_t) x;
+      ys     = (ys << 16) | (uint16_t) y;
+      out[i] = y;
+    }
+    state[0] = (int16_t) xs;
+    state[1] = (int16_t) (xs >> 16);
+    state[2] = (int16_t) ys;
+    state[3] = (int16_t) (ys >> 16);
+#else
+    int16_t x1 = state[0];
+    int16_t x2 = state[1];
+    int16_t y1 = state[2];
+    int16_t y2 = state[3];
+    for (uint32_t i = 0; i < len; i++) {
+      int16_t x   = src[i];
+      int32_t acc = c[0] * x + c[1] * x1 + c[2] * x2 - c[3] * y1 - c[4] * y2;
+      int16_t y   = sat16(acc >> 14);
+      x2     = x1;
+      x1     = x;
+      y2     = y1;
+      y1     = y;
+      out[i] = y;
+    }
+    state[0] = x1;
+    state[1] = x2;
+    state[2] = y1;
+    state[3] = y2;
+#endif
+    src = out;
+  }
+}
+
+void libtock_dsp_biquad_q31(libtock_dsp_biquad_q31_t* bq, const int32_t* in, int32_t* out, uint32_t len) {
+  if (bq->stages == 0 && in != out) memmove(out, in, len * sizeof(*out));
+
+  const int32_t* src = in;
+  for (uint8_t s = 0; s < bq->stages; s++) {
+    const int32_t* c = bq->coeffs + 5 * s;
+    int32_t* state   = bq->state + 4 * s;
+    int32_t x1       = state[0];
+    int32_t x2       = state[1];
+    int32_t y1       = state[2];
+    int32_t y2       = state[3];
+    for (uint32_t i = 0; i < len; i++) {
+      int32_t x   = src[i];
+      int64_t acc = (int64_t) c[0] * x + (int64_t) c[1] * x1 + (int64_t) c[2] * x2
+                    - (int64_t) c[3] * y1 - (int64_t) c[4] * y2;
+      int32_t y = sat32(acc >> 30);
+      x2     = x1;
+      x1     = x;
+      y2     = y1;
+      y1     = y;
+      out[i] = y;
+    }
+    state[0] = x1;
+    state[1] = x2;
+    state[2] = y1;
+    state[3] = y2;
+    src      = out;
+  }
+}
+
+
+
+// ***** FIR *****
+
+returncode_t libtock_dsp_fir_q15_init(libtock_dsp_fir_q15_t* fir, const int16_t* taps, uint16_t tap_count,
+                                      int16_t* state, uint16_t block) {
+  if (tap_count == 0 || block == 0) return RETURNCODE_EINVAL;
+
+  fir->taps      = taps;
+  fir->state     = state;
+  fir->tap_count = tap_count;
+  fir->block     = block;
+  memset(state, 0, (tap_count - 1) * sizeof(*state));
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_dsp_fir_q31_init(libtock_dsp_fir_q31_t* fir, const int32_t* taps, uint16_t tap_count,
+                                      int32_t* state, uint16_t block) {
+  if (tap_count == 0 || block == 0) return RETURNCODE_EINVAL;
+
+  fir->taps      = taps;
+  fir->state     = state;
+  fir->tap_count = tap_count;
+  fir->block     = block;
+  memset(state, 0, (tap_count - 1) * sizeof(*state));
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_dsp_fir_q15(libtock_dsp_fir_q15_t* fir, const int16_t* in, int16_t* out, uint32_t len) {
+  const int16_t* taps = fir->taps;
+  uint32_t count      = fir->tap_count;
+  uint32_t history    = count - 1;
+
+  while (len > 0) {
+    uint32_t n = len < fir->block ? len : fir->block;
+    // Copying the input first is what makes in place filtering work.
+    memcpy(fir->state + history, in, n * sizeof(*in));
+
+    for (uint32_t i = 0; i < n; i++) {
+      // x[count - 1] is the newest sample.
+      const int16_t* x = fir->state + i;
+      int32_t acc      = 0;
+      uint32_t k       = 0;
+#if defined(__ARM_FEATURE_DSP)
+      // (taps[k], taps[k + 1]) against (x[count - 2 - k], x[count - 1 - k]),
+      // crossed.
+      for ( ; k + 1 < count; k += 2) {
+        acc = smladx(load16x2(taps + k), load16x2(x + count - 2 - k), acc);
+      }
+#endif
+      for ( ; k < count; k++) {
+        acc += taps[k] * x[count - 1 - k];
+      }
+      out[i] = sat16(acc >> 15);
+    }
+
+    memmove(fir->state, fir->state + n, history * sizeof(*fir->state));
+    in  += n;
+    out += n;
+    len -= n;
+  }
+}
+
+void libtock_dsp_fir_q31(libtock_dsp_fir_q31_t* fir, const int32_t* in, int32_t* out, uint32_t len) {
+  const int32_t* taps = fir->taps;
+  uint32_t count      = fir->tap_count;
+  uint32_t history    = count - 1;
+
+  while (len > 0) {
+    uint32_t n = len < fir->block ? len : fir->block;
+    memcpy(fir->state + history, in, n * sizeof(*in));
+
+    for (uint32_t i = 0; i < n; i++) {
+      const int32_t* x = fir->state + i;
+      int64_t acc      = 0;
+      for (uint32_t k = 0; k < count; k++) {
+        acc += (int64_t) taps[k] * x[count - 1 - k];
+      }
+      out[i] = sat32(acc >> 31);
+    }
+
+    memmove(fir->state, fir->state + n, history * sizeof(*fir->state));
+    in  += n;
+    out += n;
+    len -= n;
+  }
+}
+
+
+
+// ***** RMS *****
+
+int16_t libtock_dsp_rms_q15(const int16_t* buf, uint32_t len) {
+  if (len == 0) return 0;
+
+  uint64_t sum = 0;
+  uint32_t i   = 0;
+#if defined(__ARM_FEATURE_DSP)
+  for ( ; i + 1 < len; i += 2) {
+    uint32_t pair = load16x2(buf + i);
+    sum = (uint64_t) smlald(pair, pair, (int64_t) sum);
+  }
+#endif
+  for ( ; i < len; i++) {
+    sum += (uint32_t) (buf[i] * buf[i]);
+  }
+
+  // The mean square is Q30, so its root is Q15.
+  uint32_t root = libtock_dsp_sqrt_u64(sum / len);
+  return root > INT16_MAX ? INT16_MAX : (int16_t) root;
+}
+
+int32_t libtock_dsp_rms_q31(const int32_t* buf, uint32_t len) {
+  if (len == 0) return 0;
+
+  // Squares are kept as Q31 so that the sum cannot overflow.
+  uint64_t sum = 0;
+  for (uint32_t i = 0; i < len; i++) {
+    sum += (uint64_t) (((int64_t) buf[i] * buf[i]) >> 31);
+  }
+
+  uint32_t root = libtock_dsp_sqrt_u64((sum / len) << 31);
+  return root > INT32_MAX ? INT32_MAX : (int32_t) root;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fixed-point signal processing kernels for sample buffers.
+//
+// Q15 values are `int16_t` fractions in [-1, 1), Q31 values are `int32_t`.
+// Every kernel takes an input and an output buffer, which may be the same
+// buffer to process in place. Filters keep their history in a state struct,
+// so a stream can be processed one buffer at a time, for example from
+// `libtock_adc_ring_acquire()`.
+//
+// On Cortex-M4 and M7 the Q15 kernels use the DSP extension (SMLAD and
+// friends), handling two samples per instruction. Other targets use plain C
+// with the same results.
+
+// Convert `len` ADC samples to Q15. ADC results are unsigned and left
+// aligned, so mid scale becomes zero.
+void libtock_dsp_q15_from_adc(const uint16_t* in, int16_t* out, uint32_t len);
+
+// Integer square root, rounded down.
+uint32_t libtock_dsp_sqrt_u64(uint64_t v);
+
+
+
+// ***** Decimation *****
+
+// Average each group of `factor` samples into one output sample, reducing
+// the rate by `factor`. Trailing samples that do not make a whole group are
+// dropped, so `len` should be a multiple of `factor`. Apply a low-pass filter
+// first if the averaging is not enough to prevent aliasing.
+//
+// Returns the number of output samples, `len / factor`.
+uint32_t libtock_dsp_decimate_q15(const int16_t* in, int16_t* out, uint32_t len, uint32_t factor);
+uint32_t libtock_dsp_decimate_q31(const int32_t* in, int32_t* out, uint32_t len, uint32_t factor);
+
+
+
+// ***** Moving Average *****
+
+// Boxcar average over the last `length` samples, which must be a power of two
+// so the division is a shift. `history` holds `length` samples.
+
+typedef struct {
+  int16_t* history;
+  uint16_t length;
+  uint16_t pos;
+  uint8_t shift;
+  int32_t sum;
+} libtock_dsp_moving_average_q15_t;
+
+typedef struct {
+  int32_t* history;
+  uint16_t length;
+  uint16_t pos;
+  uint8_t shift;
+  int64_t sum;
+} libtock_dsp_moving_average_q31_t;
+
+// Returns RETURNCODE_EINVAL if `length` is not a power of two.
+returncode_t libtock_dsp_moving_average_q15_init(libtock_dsp_moving_average_q15_t* ma, int16_t* history,
+                                                 uint16_t length);
+returncode_t libtock_dsp_moving_average_q31_init(libtock_dsp_moving_average_q31_t* ma, int32_t* history,
+                                                 uint16_t length);
+
+void libtock_dsp_moving_average_q15(libtock_dsp_moving_average_q15_t* ma, const int16_t* in, int16_t* out,
+                                    uint32_t len);
+void libtock_dsp_moving_average_q31(libtock_dsp_moving_average_q31_t* ma, const int32_t* in, int32_t* out,
+                                    uint32_t len);
+
+
+
+// ***** Biquad *****
+
+// Cascade of second order sections. Each stage computes
+//
+//   y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+//
+// with the coefficients stored as five values per stage, `b0, b1, b2, a1,
+// a2`, in Q14 for the Q15 filter and Q30 for the Q31 filter, so magnitudes up
+// to 2 fit. The accumulators, 32 bits for Q15 and 64 bits for Q31, cannot
+// overflow as long as the absolute values of a stage's coefficients add up to
+// less than 4. `state` holds four values per stage.
+
+typedef struct {
+  const int16_t* coeffs;
+  int16_t* state;
+  uint8_t stages;
+} libtock_dsp_biquad_q15_t;
+
+typedef struct {
+  const int32_t* coeffs;
+  int32_t* state;
+  uint8_t stages;
+} libtock_dsp_biquad_q31_t;
+
+void libtock_dsp_biquad_q15_init(libtock_dsp_biquad_q15_t* bq, uint8_t stages, const int16_t* coeffs,
+                                 int16_t* state);
+void libtock_dsp_biquad_q31_init(libtock_dsp_biquad_q31_t* bq, uint8_t stages, const int32_t* coeffs,
+                                 int32_t* state);
+
+void libtock_dsp_biquad_q15(libtock_dsp_biquad_q15_t* bq, const int16_t* in, int16_t* out, uint32_t len);
+void libtock_dsp_biquad_q31(libtock_dsp_biquad_q31_t* bq, const int32_t* in, int32_t* out, uint32_t len);
+
+
+
+// ***** FIR *****
+
+// Finite impulse response filter, y[n] = sum of taps[k] x[n-k].
+//
+// `state` holds `tap_count - 1 + block` samples: the filter copies up to
+// `block` input samples next to the history and runs the taps over one
+// contiguous array, so longer buffers are processed `block` samples at a time.
+// The accumulators, 32 bits for Q15 and 64 bits for Q31, cannot overflow as
+// long as the absolute values of the taps add up to less than 2.
+
+typedef struct {
+  const int16_t* taps;
+  int16_t* state;
+  uint16_t tap_count;
+  uint16_t block;
+} libtock_dsp_fir_q15_t;
+
+typedef struct {
+  const int32_t* taps;
+  int32_t* state;
+  uint16_t tap_count;
+  uint16_t block;
+} libtock_dsp_fir_q31_t;
+
+// Returns RETURNCODE_EINVAL if `tap_count` or `block` is zero.
+returncode_t libtock_dsp_fir_q15_init(libtock_dsp_fir_q15_t* fir, const int16_t* taps, uint16_t tap_count,
+                                      int16_t* state, uint16_t block);
+returncode_t libtock_dsp_fir_q31_init(libtock_dsp_fir_q31_t* fir, const int32_t* taps, uint16_t tap_count,
+                                      int32_t* state, uint16_t block);
+
+void libtock_dsp_fir_q15(libtock_dsp_fir_q15_t* fir, const int16_t* in, int16_t* out, uint32_t len);
+void libtock_dsp_fir_q31(libtock_dsp_fir_q31_t* fir, const int32_t* in, int32_t* out, uint32_t len);
+
+
+
+// ***** RMS *****
+
+// Root mean square of `len` samples, 0 for an empty buffer.
+int16_t libtock_dsp_rms_q15(const int16_t* buf, uint32_t len);
+int32_t libtock_dsp_rms_q31(const int32_t* buf, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+#include "dsp.h"
+#include "vector.h"
+
+static inline int32_t mul_q30(int32_t a, int32_t b) {
+  return (int32_t) (((int64_t) a * b) >> 30);
+}
+
+static inline int64_t abs64(int64_t v) {
+  return v < 0 ? -v : v;
+}
+
+uint32_t libtock_dsp_vec3_magnitude(const libtock_dsp_vec3_t* v) {
+  uint64_t sum = (uint64_t) ((int64_t) v->x * v->x) + (uint64_t) ((int64_t) v->y * v->y) +
+                 (uint64_t) ((int64_t) v->z * v->z);
+  return libtock_dsp_sqrt_u64(sum);
+}
+
+returncode_t libtock_dsp_vec3_normalize_q30(const libtock_dsp_vec3_t* v, libtock_dsp_vec3_t* out) {
+  uint32_t norm = libtock_dsp_vec3_magnitude(v);
+  if (norm == 0) return RETURNCODE_EINVAL;
+
+  out->x = (int32_t) (((int64_t) v->x << 30) / norm);
+  out->y = (int32_t) (((int64_t) v->y << 30) / norm);
+  out->z = (int32_t) (((int64_t) v->z << 30) / norm);
+  return RETURNCODE_SUCCESS;
+}
+
+int32_t libtock_dsp_vec3_dot_q30(const libtock_dsp_vec3_t* a, const libtock_dsp_vec3_t* b) {
+  return (int32_t) (((int64_t) a->x * b->x + (int64_t) a->y * b->y + (int64_t) a->z * b->z) >> 30);
+}
+
+void libtock_dsp_vec3_cross_q30(const libtock_dsp_vec3_t* a, const libtock_dsp_vec3_t* b, libtock_dsp_vec3_t* out) {
+  int32_t x = mul_q30(a->y, b->z) - mul_q30(a->z, b->y);
+  int32_t y = mul_q30(a->z, b->x) - mul_q30(a->x, b->z);
+  int32_t z = mul_q30(a->x, b->y) - mul_q30(a->y, b->x);
+  out->x = x;
+  out->y = y;
+  out->z = z;
+}
+
+// atan(2^-i) in degrees, Q16.
+static const int32_t cordic_angles[] = {
+  2949120, 1740967, 919879, 466945, 234379, 117304, 58666, 29335, 14668, 7334,
+  3667,    1833,    917,    458,    229,    115,    57,    29,    14,    7,
+};
+
+int32_t libtock_dsp_atan2_cdeg(int32_t y, int32_t x) {
+  if (x == 0 && y == 0) return 0;
+
+  int64_t vx = x;
+  int64_t vy = y;
+  int32_t angle = 0;
+  // Rotate the left half plane by 180 degrees, as CORDIC only covers +-90.
+  if (vx < 0) {
+    vx    = -vx;
+    vy    = -vy;
+    angle = y >= 0 ? 180 << 16 : -(180 << 16);
+  }
+
+  // Bring the vector to about 2^40 so the shifts keep enough precision.
+  while (abs64(vx) < ((int64_t) 1 << 39) && abs64(vy) < ((int64_t) 1 << 39)) {
+    vx <<= 1;
+    vy <<= 1;
+  }
+
+  for (uint32_t i = 0; i < sizeof(cordic_angles) / sizeof(cordic_angles[0]); i++) {
+    int64_t dx = vy >> i;
+    int64_t dy = vx >> i;
+    if (vy > 0) {
+      vx    += dx;
+      vy    -= dy;
+      angle += cordic_angles[i];
+    } else {
+      vx    -= dx;
+      vy    += dy;
+      angle -= cordic_angles[i];
+    }
+  }
+
+  // To hundredths of a degree, rounding to nearest.
+  return (int32_t) (((int64_t) angle * 100 + (1 << 15)) >> 16);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Integer 3-vector math for sensor readings.
+//
+// Unit vectors are Q30, so each component is an `int32_t` fraction in
+// [-2, 2). Raw sensor readings can be used directly for magnitudes and
+// angles, as only their ratios matter. Angles are in hundredths of a degree,
+// like the temperature driver's hundredths of a degree.
+
+typedef struct {
+  int32_t x;
+  int32_t y;
+  int32_t z;
+} libtock_dsp_vec3_t;
+
+// Euclidean length of `v`.
+uint32_t libtock_dsp_vec3_magnitude(const libtock_dsp_vec3_t* v);
+
+// Scale `v` to unit length in Q30.
+//
+// Returns RETURNCODE_EINVAL if `v` is zero.
+returncode_t libtock_dsp_vec3_normalize_q30(const libtock_dsp_vec3_t* v, libtock_dsp_vec3_t* out);
+
+// Dot product of two Q30 vectors, in Q30.
+int32_t libtock_dsp_vec3_dot_q30(const libtock_dsp_vec3_t* a, const libtock_dsp_vec3_t* b);
+
+// Cross product of two Q30 vectors, in Q30. `out` may be `a` or `b`.
+void libtock_dsp_vec3_cross_q30(const libtock_dsp_vec3_t* a, const libtock_dsp_vec3_t* b, libtock_dsp_vec3_t* out);
+
+// Angle of the point (`x`, `y`) from the positive x axis, in hundredths of a
+// degree from -18000 to 18000, accurate to about 0.01 degrees. Computed with
+// CORDIC, so only shifts and adds are used. Returns 0 for the origin.
+int32_t libtock_dsp_atan2_cdeg(int32_t y, int32_t x);
+
+#ifdef __cplusplus
+}
+#endif
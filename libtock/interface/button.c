@@ -1,7 +1,15 @@
 #include "button.h"
 
 returncode_t libtock_button_count(int* count) {
-  return libtock_button_command_count(count);
+  // The number of buttons cannot change while the process runs.
+  static int cached = -1;
+  if (cached < 0) {
+    returncode_t ret = libtock_button_command_count(count);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    cached = *count;
+  }
+  *count = cached;
+  return RETURNCODE_SUCCESS;
 }
 
 returncode_t libtock_button_read(int button_num, int* button_value) {
@@ -22,7 +22,8 @@ typedef void (*libtock_button_callback)(returncode_t, int, bool);
 // - `button_value`: Will be set to 1 if button is pressed, 0 otherwise.
 returncode_t libtock_button_read(int button_num, int* button_value);
 
-// Set `count` to the number of buttons.
+// Set `count` to the number of buttons. The count is read from the kernel
+// once and then cached.
 returncode_t libtock_button_count(int* count);
 
 // Setup a callback when a button is pressed.
@@ -0,0 +1,314 @@
+#include <stdint.h>
+
+#include "console_printf.h"
+
+#ifdef LIBTOCK_PRINTF_LONG_LONG
+typedef unsigned long long printf_uint_t;
+#else
+typedef uint32_t printf_uint_t;
+#endif
+
+typedef struct {
+  char* buf;
+  size_t size;
+  // Characters produced so far, including ones that did not fit.
+  size_t len;
+} printf_out_t;
+
+typedef struct {
+  bool left;
+  bool zero;
+  bool alt;
+  char sign;
+  int width;
+  int precision;
+} printf_spec_t;
+
+static void put(printf_out_t* out, char c) {
+  if (out->len + 1 < out->size) {
+    out->buf[out->len] = c;
+  }
+  out->len++;
+}
+
+static void pad(printf_out_t* out, char c, int n) {
+  while (n-- > 0) {
+    put(out, c);
+  }
+}
+
+static void put_string(printf_out_t* out, const printf_spec_t* spec, const char* s) {
+  int len = 0;
+  while (s[len] != '\0' && (spec->precision < 0 || len < spec->precision)) {
+    len++;
+  }
+  if (!spec->left) pad(out, ' ', spec->width - len);
+  for (int i = 0; i < len; i++) {
+    put(out, s[i]);
+  }
+  if (spec->left) pad(out, ' ', spec->width - len);
+}
+
+static void put_number(printf_out_t* out, const printf_spec_t* spec, printf_uint_t value, unsigned base,
+                       bool upper, bool negative, const char* prefix) {
+  const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+  // Enough for a 64-bit value in octal.
+  char tmp[22];
+  int n = 0;
+  while (value != 0) {
+    tmp[n++] = digits[value % base];
+    value   /= base;
+  }
+
+  // Like printf, precision 0 prints nothing for a zero value.
+  int precision = spec->precision < 0 ? 1 : spec->precision;
+  int zeros     = precision > n ? precision - n : 0;
+  char sign     = negative ? '-' : spec->sign;
+  int prefix_len = 0;
+  while (prefix[prefix_len] != '\0') {
+    prefix_len++;
+  }
+
+  int len     = (sign != 0) + prefix_len + zeros + n;
+  int padding = spec->width > len ? spec->width - len : 0;
+  if (spec->zero && !spec->left && spec->precision < 0) {
+    zeros  += padding;
+    padding = 0;
+  }
+
+  if (!spec->left) pad(out, ' ', padding);
+  if (sign != 0) put(out, sign);
+  for (int i = 0; i < prefix_len; i++) {
+    put(out, prefix[i]);
+  }
+  pad(out, '0', zeros);
+  while (n > 0) {
+    put(out, tmp[--n]);
+  }
+  if (spec->left) pad(out, ' ', padding);
+}
+
+#ifdef LIBTOCK_PRINTF_FLOAT
+// Only values whose integer part fits in 32 bits are printed correctly.
+static void put_float(printf_out_t* out, const printf_spec_t* spec, double value) {
+  int precision = spec->precision < 0 ? 6 : spec->precision;
+  if (precision > 9) precision = 9;
+
+  bool negative = value < 0;
+  if (negative) value = -value;
+
+  uint32_t scale = 1;
+  for (int i = 0; i < precision; i++) {
+    scale *= 10;
+  }
+  // Round once on the scaled value so carries reach the integer part.
+  double scaled     = value * scale + 0.5;
+  uint32_t integer  = (uint32_t) (scaled / scale);
+  uint32_t fraction = (uint32_t) (scaled - (double) integer * scale);
+
+  // Format the number without padding, then pad it as a whole.
+  char tmp[24];
+  printf_out_t num    = { tmp, sizeof(tmp), 0 };
+  printf_spec_t plain = { false, false, false, spec->sign, 0, -1 };
+  put_number(&num, &plain, integer, 10, false, negative, "");
+  if (precision > 0) {
+    printf_spec_t digits = { false, false, false, 0, 0, precision };
+    put(&num, '.');
+    put_number(&num, &digits, fraction, 10, false, false, "");
+  }
+  tmp[num.len < sizeof(tmp) ? num.len : sizeof(tmp) - 1] = '\0';
+
+  printf_spec_t field = { spec->left, false, false, 0, spec->width, -1 };
+  put_string(out, &field, tmp);
+}
+#endif
+
+int libtock_console_vsnprintf(char* buf, size_t size, const char* fmt, va_list ap) {
+  printf_out_t out = { buf, size, 0 };
+
+  while (*fmt != '\0') {
+    if (*fmt != '%') {
+      put(&out, *fmt++);
+      continue;
+    }
+    const char* start = fmt++;
+
+    printf_spec_t spec = { false, false, false, 0, 0, -1 };
+    while (true) {
+      if (*fmt == '-') spec.left = true;
+      else if (*fmt == '0') spec.zero = true;
+      else if (*fmt == '#') spec.alt = true;
+      else if (*fmt == '+') spec.sign = '+';
+      else if (*fmt == ' ') {
+        if (spec.sign == 0) spec.sign = ' ';
+      } else break;
+      fmt++;
+    }
+
+    if (*fmt == '*') {
+      spec.width = va_arg(ap, int);
+      if (spec.width < 0) {
+        spec.left  = true;
+        spec.width = -spec.width;
+      }
+      fmt++;
+    } else {
+      while (*fmt >= '0' && *fmt <= '9') {
+        spec.width = spec.width * 10 + (*fmt++ - '0');
+      }
+    }
+
+    if (*fmt == '.') {
+      fmt++;
+      spec.precision = 0;
+      if (*fmt == '*') {
+        spec.precision = va_arg(ap, int);
+        fmt++;
+      } else {
+        while (*fmt >= '0' && *fmt <= '9') {
+          spec.precision = spec.precision * 10 + (*fmt++ - '0');
+        }
+      }
+    }
+
+    // Number of bits in the argument, 0 for `int`.
+    int bits = 0;
+    if (fmt[0] == 'h' && fmt[1] == 'h') {
+      bits = 8;
+      fmt += 2;
+    } else if (fmt[0] == 'h') {
+      bits = 16;
+      fmt++;
+    } else if (fmt[0] == 'l' && fmt[1] == 'l') {
+      bits = 64;
+      fmt += 2;
+    } else if (fmt[0] == 'j') {
+      bits = 64;
+      fmt++;
+    } else if (fmt[0] == 'l' || fmt[0] == 'z' || fmt[0] == 't') {
+      // `long`, `size_t` and `ptrdiff_t` are 32 bits on every Tock target.
+      fmt++;
+    }
+
+    char conv = *fmt;
+    if (conv == '\0') break;
+    fmt++;
+
+    switch (conv) {
+      case 'd':
+      case 'i': {
+        long long value = bits == 64 ? va_arg(ap, long long) : va_arg(ap, int);
+        if (bits == 8) value = (signed char) value;
+        else if (bits == 16) value = (short) value;
+#ifndef LIBTOCK_PRINTF_LONG_LONG
+        value = (int32_t) value;
+#endif
+        bool negative = value < 0;
+        unsigned long long magnitude = negative ? 0ULL - (unsigned long long) value : (unsigned long long) value;
+        put_number(&out, &spec, (printf_uint_t) magnitude, 10, false, negative, "");
+        break;
+      }
+      case 'u':
+      case 'x':
+      case 'X':
+      case 'o': {
+        unsigned long long value = bits == 64 ? va_arg(ap, unsigned long long) : va_arg(ap, unsigned int);
+        if (bits == 8) value = (unsigned char) value;
+        else if (bits == 16) value = (unsigned short) value;
+        unsigned base = conv == 'u' ? 10 : conv == 'o' ? 8 : 16;
+        const char* prefix = "";
+        if (spec.alt && value != 0) {
+          prefix = conv == 'o' ? "0" : conv == 'x' ? "0x" : conv == 'X' ? "0X" : "";
+        }
+        spec.sign = 0;
+        put_number(&out, &spec, (printf_uint_t) value, base, conv == 'X', false, prefix);
+        break;
+      }
+      case 'p': {
+        spec.sign      = 0;
+        spec.precision = 8;
+        put_number(&out, &spec, (uintptr_t) va_arg(ap, void*), 16, false, false, "0x");
+        break;
+      }
+      case 'c': {
+        char c = (char) va_arg(ap, int);
+        if (!spec.left) pad(&out, ' ', spec.width - 1);
+        put(&out, c);
+        if (spec.left) pad(&out, ' ', spec.width - 1);
+        break;
+      }
+      case 's': {
+        const char* s = va_arg(ap, const char*);
+        put_string(&out, &spec, s != NULL ? s : "(null)");
+        break;
+      }
+      case 'f':
+      case 'F': {
+#ifdef LIBTOCK_PRINTF_FLOAT
+        put_float(&out, &spec, va_arg(ap, double));
+#else
+        (void) va_arg(ap, double);
+        put(&out, '?');
+#endif
+        break;
+      }
+      case '%':
+        put(&out, '%');
+        break;
+      default:
+        // Unsupported conversion, print it unchanged.
+        while (start < fmt) {
+          put(&out, *start++);
+        }
+        break;
+    }
+  }
+
+  if (size > 0) {
+    buf[out.len < size ? out.len : size - 1] = '\0';
+  }
+  return (int) out.len;
+}
+
+int libtock_console_snprintf(char* buf, size_t size, const char* fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  int len = libtock_console_vsnprintf(buf, size, fmt, ap);
+  va_end(ap);
+  return len;
+}
+
+static char tx_buffer[LIBTOCK_CONSOLE_PRINTF_BUF_SIZE];
+static bool tx_busy = false;
+static libtock_console_callback_write tx_callback = NULL;
+
+static void tx_done(returncode_t ret, uint32_t length) {
+  tx_busy = false;
+  if (tx_callback != NULL) {
+    tx_callback(ret, length);
+  }
+}
+
+returncode_t libtock_console_vprintf(libtock_console_callback_write cb, const char* fmt, va_list ap) {
+  if (tx_busy) return RETURNCODE_EBUSY;
+
+  int len = libtock_console_vsnprintf(tx_buffer, sizeof(tx_buffer), fmt, ap);
+  if (len > (int) sizeof(tx_buffer) - 1) {
+    len = sizeof(tx_buffer) - 1;
+  }
+
+  tx_callback = cb;
+  returncode_t ret = libtock_console_write((const uint8_t*) tx_buffer, len, tx_done);
+  if (ret == RETURNCODE_SUCCESS) {
+    tx_busy = true;
+  }
+  return ret;
+}
+
+returncode_t libtock_console_printf(libtock_console_callback_write cb, const char* fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  returncode_t ret = libtock_console_vprintf(cb, fmt, ap);
+  va_end(ap);
+  return ret;
+}
@@ -0,0 +1,60 @@
+/*
+ * Lean formatted console output.
+ *
+ * A small `printf` replacement that does not use newlib's stdio. It formats
+ * straight into a console transmit buffer, so apps that only use these
+ * functions avoid linking the full `vfprintf` and its `FILE` buffering.
+ *
+ * Supported: `%d %i %u %x %X %o %c %s %p %%`, the flags `- 0 + space #`, field
+ * width and precision (both also as `*`), and the length modifiers `hh h l ll
+ * z t j`. Wide characters are not supported.
+ *
+ * Optional features, enabled by building libtock with the macro defined (e.g.
+ * `make CFLAGS=-DLIBTOCK_PRINTF_LONG_LONG` after cleaning libtock):
+ *
+ * - `LIBTOCK_PRINTF_LONG_LONG`: print `ll` and `j` arguments with 64-bit
+ *   arithmetic. Without it they are truncated to 32 bits, which avoids
+ *   linking 64-bit division.
+ * - `LIBTOCK_PRINTF_FLOAT`: support `%f`. Without it `%f` consumes its
+ *   argument and prints `?`, which avoids linking soft-float code.
+ *
+ * `LIBTOCK_CONSOLE_PRINTF_BUF_SIZE` sets the transmit buffer size (default
+ * 128). Longer messages are truncated.
+ */
+
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+
+#include "../tock.h"
+#include "console.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef LIBTOCK_CONSOLE_PRINTF_BUF_SIZE
+#define LIBTOCK_CONSOLE_PRINTF_BUF_SIZE 128
+#endif
+
+// Format into `buf` like `vsnprintf()`. Returns the length the full output
+// would have had, `buf` holds at most `size - 1` characters and a NUL.
+int libtock_console_vsnprintf(char* buf, size_t size, const char* fmt, va_list ap);
+
+__attribute__ ((format(printf, 3, 4)))
+int libtock_console_snprintf(char* buf, size_t size, const char* fmt, ...);
+
+// Format into the console transmit buffer and start writing it. `cb` is
+// called once the write is done and may be NULL.
+//
+// Returns RETURNCODE_EBUSY if the previous formatted write has not finished,
+// or the error from `libtock_console_write()`.
+__attribute__ ((format(printf, 2, 3)))
+returncode_t libtock_console_printf(libtock_console_callback_write cb, const char* fmt, ...);
+
+returncode_t libtock_console_vprintf(libtock_console_callback_write cb, const char* fmt, va_list ap);
+
+#ifdef __cplusplus
+}
+#endif
@@ -7,7 +7,8 @@
 extern "C" {
 #endif
 
-// Returns the number of LEDs on the host platform.
+// Returns the number of LEDs on the host platform. The count is read from the
+// kernel once and then cached.
 returncode_t libtock_led_count(int* count);
 
 // Turn on the specified LED.
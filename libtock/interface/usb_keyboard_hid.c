@@ -1,3 +1,5 @@
+#include <ctype.h>
+
 #include "usb_keyboard_hid.h"
 
 static void usb_keyboard_hid_upcall(__attribute__ ((unused)) int callback_type,
@@ -20,3 +22,123 @@ returncode_t libtock_usb_keyboard_hid_send(uint8_t* buffer, uint32_t len, libtoc
   err = libtock_usb_keyboard_hid_command_send(); // Sometimes returns ERESERVE (but everything keeps working??)
   return err;
 }
+
+bool libtock_usb_keyboard_hid_keycode(char c, uint8_t* modifier, uint8_t* key) {
+  uint8_t shift = 2;  // KB_MODIFIER_LEFT_SHIFT = 2
+
+  // Clear modifier.
+  *modifier = 0;
+
+  if ((c >= 'A') && (c <= 'Z')) {
+    c         = tolower((int) c);
+    *modifier = shift;
+  }
+  if ((c >= 'a') && (c <= 'z')) {
+    *key = ((c -= 'a') + 4);
+    return true;
+  }
+  if ((c >= '1') && (c <= '9')) {
+    *key = ((c -= '0') + 0x1D);
+    return true;
+  }
+  switch (c) {
+    case '!':   *modifier = shift;
+      *key = 0x1E;
+      return true;
+    case '@':   *modifier = shift;
+      *key = 0x1F;
+      return true;
+    case '#':   *modifier = shift;
+      *key = 0x20;
+      return true;
+    case '$':   *modifier = shift;
+      *key = 0x21;
+      return true;
+    case '%':   *modifier = shift;
+      *key = 0x22;
+      return true;
+    case '^':   *modifier = shift;
+      *key = 0x23;
+      return true;
+    case '&':   *modifier = shift;
+      *key = 0x24;
+      return true;
+    case '*':   *modifier = shift;
+      *key = 0x25;
+      return true;
+    case '(':   *modifier = shift;
+      *key = 0x26;
+      return true;
+    case ')':   *modifier = shift;
+      *key = 0x27;
+      return true;
+    case '0':   *key = 0x27;
+      return true;
+    case '\n':  *key = 0x28;
+      return true;                          // enter
+    case '\r':  *key = 0x28;
+      return true;                          // enter
+    case '\b':  *key = 0x2A;
+      return true;                          // backspace
+    case '\t':  *key = 0x2B;
+      return true;                          // tab
+    case ' ':   *key = 0x2C;
+      return true;                          // space
+    case '_':   *modifier = shift;
+      *key = 0x2D;
+      return true;
+    case '-':   *key = 0x2D;
+      return true;
+    case '+':   *modifier = shift;
+      *key = 0x2E;
+      return true;
+    case '=':   *key = 0x2E;
+      return true;
+    case '{':   *modifier = shift;
+      *key = 0x2F;
+      return true;
+    case '[':   *key = 0x2F;
+      return true;
+    case '}':   *modifier = shift;
+      *key = 0x30;
+      return true;
+    case ']':   *key = 0x30;
+      return true;
+    case '|':   *modifier = shift;
+      *key = 0x31;
+      return true;
+    case '\\':   *key = 0x31;
+      return true;
+    case ':':   *modifier = shift;
+      *key = 0x33;
+      return true;
+    case ';':   *key = 0x33;
+      return true;
+    case '"':   *modifier = shift;
+      *key = 0x34;
+      return true;
+    case '\'':   *key = 0x34;
+      return true;
+    case '~':   *modifier = shift;
+      *key = 0x35;
+      return true;
+    case '`':   *key = 0x35;
+      return true;
+    case '<':   *modifier = shift;
+      *key = 0x36;
+      return true;
+    case ',':   *key = 0x36;
+      return true;
+    case '>':   *modifier = shift;
+      *key = 0x37;
+      return true;
+    case '.':   *key = 0x37;
+      return true;
+    case '?':   *modifier = shift;
+      *key = 0x38;
+      return true;
+    case '/':   *key = 0x38;
+      return true;
+  }
+  return false;
+}
@@ -16,6 +16,10 @@ typedef void (*libtock_usb_keyboard_hid_callback)(returncode_t);
 // be triggered when the send has completed.
 returncode_t libtock_usb_keyboard_hid_send(uint8_t* buffer, uint32_t len, libtock_usb_keyboard_hid_callback cb);
 
+// Look up the HID key code and modifier that type `c` on a US keyboard.
+// Returns false if `c` cannot be typed.
+bool libtock_usb_keyboard_hid_keycode(char c, uint8_t* modifier, uint8_t* key);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,66 @@
+#include "../services/alarm.h"
+
+#include "idle_hint.h"
+
+// The hints are process-wide, like the alarm queue they mostly come from.
+static struct {
+  libtock_idle_hint_t hint;
+  // Whether `hint` changed since it was last copied to `region`.
+  bool dirty;
+  volatile uint32_t* region;
+} idle;
+
+returncode_t libtock_idle_hint_allocate_region(uint8_t* base, int len) {
+  if (len < LIBTOCK_IDLE_HINT_BUFFER_LEN) {
+    // The buffer is not long enough
+    return RETURNCODE_ESIZE;
+  }
+
+  returncode_t ret = libtock_idle_hint_set_userspace_read_allow_region(base, len);
+  if (ret == RETURNCODE_SUCCESS) {
+    idle.region    = (volatile uint32_t*) base;
+    idle.region[0] = 0;
+    idle.dirty     = true;
+  }
+  return ret;
+}
+
+void libtock_idle_hint_set_latency_ms(uint32_t ms) {
+  uint32_t frequency;
+  if (libtock_alarm_get_frequency(&frequency) != RETURNCODE_SUCCESS) return;
+
+  uint64_t ticks = (uint64_t) ms * frequency / 1000;
+  idle.hint.latency = ticks > UINT32_MAX ? UINT32_MAX : (uint32_t) ticks;
+  idle.dirty        = true;
+}
+
+void libtock_idle_hint_get(libtock_idle_hint_t* hint) {
+  *hint = idle.hint;
+}
+
+void libtock_idle_hint_set_wakeup(uint32_t wakeup, uint32_t deadline) {
+  if (idle.hint.has_wakeup && idle.hint.wakeup == wakeup && idle.hint.deadline == deadline) return;
+  idle.hint.has_wakeup = true;
+  idle.hint.wakeup     = wakeup;
+  idle.hint.deadline   = deadline;
+  idle.dirty           = true;
+}
+
+void libtock_idle_hint_clear_wakeup(void) {
+  if (!idle.hint.has_wakeup) return;
+  idle.hint.has_wakeup = false;
+  idle.dirty           = true;
+}
+
+void libtock_idle_hint_publish(void) {
+  if (idle.region == NULL || !idle.dirty) return;
+
+  idle.region[1] = idle.hint.has_wakeup ? LIBTOCK_IDLE_HINT_WAKEUP : 0;
+  idle.region[2] = idle.hint.wakeup;
+  idle.region[3] = idle.hint.deadline;
+  idle.region[4] = idle.hint.latency;
+  // The count moves last, so a kernel that sees it change sees the words
+  // it covers.
+  idle.region[0]++;
+  idle.dirty = false;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "../tock.h"
+#include "syscalls/idle_hint_syscalls.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Idle hints for the kernel's choice of sleep state.
+//
+// When every process waits, the kernel decides how deeply the chip sleeps.
+// Deeper states save more power but take longer to wake from, so the kernel
+// can only pick one if it knows nothing needs the process before then. With
+// a region shared through `libtock_idle_hint_allocate_region()`, libtock
+// keeps it informed:
+//
+// - the alarm service publishes its next wakeup: when the earliest
+//   outstanding alarm expires, and the deadline by which the first alarm's
+//   slack (see `libtock_alarm_in_ms_with_slack()`) runs out. The kernel may
+//   wake the process anywhere in between, e.g. together with other
+//   processes or early enough to leave a deep state in time;
+// - the app says how late other upcalls, such as I/O completions or button
+//   presses, may be delivered, with `libtock_idle_hint_set_latency_ms()`.
+//
+// Changes are collected and copied into the region when `yield()` is about
+// to wait, which is when the kernel reads it, so rearming alarms while the
+// app runs costs no copies, and nothing without a region.
+//
+// Version 1, 32-bit words:
+//   |-------------------------|
+//   |       Count (u32)       |  incremented after every update
+//   |-------------------------|
+//   |       Flags (u32)       |  LIBTOCK_IDLE_HINT_WAKEUP
+//   |-------------------------|
+//   |      Wakeup (u32)       |  alarm counter ticks
+//   |-------------------------|
+//   |     Deadline (u32)      |  alarm counter ticks
+//   |-------------------------|
+//   |      Latency (u32)      |  ticks
+//   |-------------------------|
+#define LIBTOCK_IDLE_HINT_BUFFER_LEN (5 * 4)
+
+// Wakeup and deadline are valid: an alarm is outstanding.
+#define LIBTOCK_IDLE_HINT_WAKEUP 0x1
+
+typedef struct {
+  // Whether an alarm is outstanding. Without one, only other upcalls wake
+  // the process.
+  bool has_wakeup;
+  // When the first alarm expires, on the alarm counter.
+  uint32_t wakeup;
+  // Latest time the kernel may wake the process without an alarm firing
+  // later than its slack allows.
+  uint32_t deadline;
+  // Ticks other upcalls may be delivered late.
+  uint32_t latency;
+} libtock_idle_hint_t;
+
+// Share a word-aligned buffer with the kernel to publish idle hints in.
+//
+// - `base` the buffer to use.
+// - `len` should be `LIBTOCK_IDLE_HINT_BUFFER_LEN`.
+returncode_t libtock_idle_hint_allocate_region(uint8_t* base, int len);
+
+// How late upcalls other than alarms may be delivered, 0 by default.
+void libtock_idle_hint_set_latency_ms(uint32_t ms);
+
+// The hints as the next wait publishes them.
+void libtock_idle_hint_get(libtock_idle_hint_t* hint);
+
+// Called by the alarm service when its next wakeup changes.
+void libtock_idle_hint_set_wakeup(uint32_t wakeup, uint32_t deadline);
+void libtock_idle_hint_clear_wakeup(void);
+
+// Called by `yield()` before it waits to copy changed hints into the
+// region.
+void libtock_idle_hint_publish(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,7 +1,79 @@
 #include "ipc.h"
 #include "tock.h"
 
+// Cache of successful discoveries. A process gets a new id when it restarts,
+// so an entry is dropped as soon as using its id fails.
+typedef struct {
+  uint32_t hash;
+  char* name;
+  size_t svc_id;
+} discover_entry_t;
+
+static discover_entry_t discover_cache[IPC_DISCOVER_CACHE_SIZE];
+static int discover_next = 0;
+
+// FNV-1a, used to skip most string compares on lookup.
+static uint32_t name_hash(const char* name) {
+  uint32_t hash = 2166136261u;
+  while (*name != '\0') {
+    hash ^= (uint8_t) *name++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static void discover_drop(discover_entry_t* entry) {
+  free(entry->name);
+  entry->name = NULL;
+}
+
+static void discover_drop_id(size_t svc_id) {
+  for (int i = 0; i < IPC_DISCOVER_CACHE_SIZE; i++) {
+    if (discover_cache[i].name != NULL && discover_cache[i].svc_id == svc_id) {
+      discover_drop(&discover_cache[i]);
+    }
+  }
+}
+
+static void discover_insert(uint32_t hash, const char* pkg_name, size_t svc_id) {
+  char* name = strdup(pkg_name);
+  if (name == NULL) return;
+
+  discover_entry_t* entry = &discover_cache[discover_next];
+  discover_next = (discover_next + 1) % IPC_DISCOVER_CACHE_SIZE;
+  discover_drop(entry);
+  entry->hash   = hash;
+  entry->name   = name;
+  entry->svc_id = svc_id;
+}
+
+void ipc_discover_invalidate(const char* pkg_name) {
+  for (int i = 0; i < IPC_DISCOVER_CACHE_SIZE; i++) {
+    discover_entry_t* entry = &discover_cache[i];
+    if (entry->name != NULL && (pkg_name == NULL || strcmp(entry->name, pkg_name) == 0)) {
+      discover_drop(entry);
+    }
+  }
+}
+
 int ipc_discover(const char* pkg_name, size_t* svc_id) {
+  uint32_t hash = name_hash(pkg_name);
+  for (int i = 0; i < IPC_DISCOVER_CACHE_SIZE; i++) {
+    discover_entry_t* entry = &discover_cache[i];
+    if (entry->name != NULL && entry->hash == hash && strcmp(entry->name, pkg_name) == 0) {
+      *svc_id = entry->svc_id;
+      return RETURNCODE_SUCCESS;
+    }
+  }
+
+  int ret = ipc_discover_uncached(pkg_name, svc_id);
+  if (ret == RETURNCODE_SUCCESS) {
+    discover_insert(hash, pkg_name, *svc_id);
+  }
+  return ret;
+}
+
+int ipc_discover_uncached(const char* pkg_name, size_t* svc_id) {
   int len = strlen(pkg_name);
 
   allow_ro_return_t prev = allow_readonly(IPC_DRIVER_NUM, 0, pkg_name, len);
@@ -31,12 +103,16 @@ int ipc_register_service_callback(const char* pkg_name,
 
 int ipc_register_client_callback(size_t svc_id, subscribe_upcall callback, void* ud) {
   subscribe_return_t sval = subscribe(IPC_DRIVER_NUM, svc_id, callback, ud);
-  return tock_subscribe_return_to_returncode(sval);
+  int ret = tock_subscribe_return_to_returncode(sval);
+  if (ret != RETURNCODE_SUCCESS) discover_drop_id(svc_id);
+  return ret;
 }
 
 int ipc_notify_service(size_t pid) {
   syscall_return_t res = command(IPC_DRIVER_NUM, 2, (int) pid, 0);
-  return tock_command_return_novalue_to_returncode(res);
+  int ret = tock_command_return_novalue_to_returncode(res);
+  if (ret != RETURNCODE_SUCCESS) discover_drop_id(pid);
+  return ret;
 }
 
 int ipc_notify_client(size_t pid) {
@@ -46,5 +122,7 @@ int ipc_notify_client(size_t pid) {
 
 int ipc_share(size_t pid, void* base, int len) {
   allow_rw_return_t aval = allow_readwrite(IPC_DRIVER_NUM, (int) pid, base, len);
-  return tock_allow_rw_return_to_returncode(aval);
+  int ret = tock_allow_rw_return_to_returncode(aval);
+  if (ret != RETURNCODE_SUCCESS) discover_drop_id(pid);
+  return ret;
 }
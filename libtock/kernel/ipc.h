@@ -11,12 +11,28 @@ extern "C" {
 
 #define IPC_DRIVER_NUM 0x10000
 
+// Number of discovered services remembered by `ipc_discover()`.
+#define IPC_DISCOVER_CACHE_SIZE 4
+
 // Performs service discovery
 //
 // Retrieves the process identifier of the process with the given package name,
 // or a negative value on error.
+//
+// Successful lookups are cached, so repeated calls for the same name do not
+// make a syscall. A restarted service gets a new process identifier: the
+// cached entry is dropped when `ipc_register_client_callback()`,
+// `ipc_notify_service()` or `ipc_share()` fails for its old identifier, and
+// the next `ipc_discover()` looks the service up again.
 int ipc_discover(const char* pkg_name, size_t* svc_id);
 
+// Performs service discovery without consulting or updating the cache.
+int ipc_discover_uncached(const char* pkg_name, size_t* svc_id);
+
+// Drop the cached identifier for `pkg_name`, or every cached identifier if
+// `pkg_name` is NULL.
+void ipc_discover_invalidate(const char* pkg_name);
+
 // Registers a service callback for this process.
 //
 // Service callbacks are called in response to `notify`s from clients and take
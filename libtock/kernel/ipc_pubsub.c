@@ -0,0 +1,135 @@
+#include "ipc_pubsub.h"
+
+#define SLOT_MAGIC 0x50554253
+
+// Attempts `ipc_pubsub_read()` makes before giving up on a busy publisher.
+#define READ_RETRIES 8
+
+static uint32_t load(const uint32_t* p) {
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static void store(uint32_t* p, uint32_t value) {
+  __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+// A client notifying the publisher asks to subscribe. Share the slot with it
+// and notify back, which hands the client the slot's address.
+static void publisher_upcall(int pid, __attribute__ ((unused)) int len, __attribute__ ((unused)) int buf,
+                             void* ud) {
+  ipc_pubsub_publisher_t* pub = ud;
+
+  bool known = false;
+  for (int i = 0; i < pub->subscriber_count; i++) {
+    if (pub->subscribers[i] == (size_t) pid) known = true;
+  }
+  if (!known) {
+    if (pub->subscriber_count == IPC_PUBSUB_MAX_SUBSCRIBERS) return;
+    if (ipc_share(pid, pub->slot, pub->slot_len) != RETURNCODE_SUCCESS) return;
+    pub->subscribers[pub->subscriber_count++] = pid;
+  }
+  ipc_notify_client(pid);
+}
+
+int ipc_pubsub_publisher_init(ipc_pubsub_publisher_t* pub, const char* pkg_name, void* slot, size_t len) {
+  if (len <= sizeof(ipc_pubsub_slot_t)) return RETURNCODE_ESIZE;
+
+  pub->slot             = slot;
+  pub->slot_len         = len;
+  pub->subscriber_count = 0;
+
+  pub->slot->magic    = SLOT_MAGIC;
+  pub->slot->seq      = 0;
+  pub->slot->capacity = len - sizeof(ipc_pubsub_slot_t);
+  pub->slot->len      = 0;
+
+  return ipc_register_service_callback(pkg_name, publisher_upcall, pub);
+}
+
+size_t ipc_pubsub_capacity(const ipc_pubsub_publisher_t* pub) {
+  return pub->slot_len - sizeof(ipc_pubsub_slot_t);
+}
+
+int ipc_pubsub_publish(ipc_pubsub_publisher_t* pub, const void* sample, size_t len, bool notify) {
+  if (len > ipc_pubsub_capacity(pub)) return RETURNCODE_ESIZE;
+
+  ipc_pubsub_slot_t* slot = pub->slot;
+  uint32_t seq = slot->seq;
+  store(&slot->seq, seq + 1);
+  // Keep the data writes after the odd sequence number.
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  memcpy(slot + 1, sample, len);
+  slot->len = len;
+  store(&slot->seq, seq + 2);
+
+  if (notify) {
+    for (int i = 0; i < pub->subscriber_count; ) {
+      if (ipc_notify_client(pub->subscribers[i]) != RETURNCODE_SUCCESS) {
+        // The subscriber exited or restarted, forget it.
+        pub->subscribers[i] = pub->subscribers[--pub->subscriber_count];
+        continue;
+      }
+      i++;
+    }
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+static void subscriber_upcall(__attribute__ ((unused)) int pid, int len, int buf, void* ud) {
+  ipc_pubsub_subscriber_t* sub = ud;
+
+  if (sub->slot == NULL) {
+    const ipc_pubsub_slot_t* slot = (const ipc_pubsub_slot_t*) buf;
+    if (slot == NULL || len <= (int) sizeof(ipc_pubsub_slot_t) || load(&slot->magic) != SLOT_MAGIC) {
+      return;
+    }
+    sub->slot     = slot;
+    sub->slot_len = len;
+  }
+
+  if (sub->callback != NULL) {
+    sub->callback(load(&sub->slot->seq), sub->ud);
+  }
+}
+
+int ipc_pubsub_subscribe(ipc_pubsub_subscriber_t* sub, const char* pkg_name, ipc_pubsub_callback callback,
+                         void* ud) {
+  sub->slot     = NULL;
+  sub->slot_len = 0;
+  sub->callback = callback;
+  sub->ud       = ud;
+
+  int ret = ipc_discover(pkg_name, &sub->publisher);
+  if (ret < 0) return ret;
+
+  ret = ipc_register_client_callback(sub->publisher, subscriber_upcall, sub);
+  if (ret < 0) return ret;
+
+  return ipc_notify_service(sub->publisher);
+}
+
+int ipc_pubsub_read(const ipc_pubsub_subscriber_t* sub, void* buf, size_t len, uint32_t* seq) {
+  const ipc_pubsub_slot_t* slot = sub->slot;
+  if (slot == NULL) return RETURNCODE_EOFF;
+
+  // The publisher may be preempted mid-write, so take a consistent snapshot
+  // or retry.
+  size_t capacity = sub->slot_len - sizeof(ipc_pubsub_slot_t);
+  for (int attempt = 0; attempt < READ_RETRIES; attempt++) {
+    uint32_t before = load(&slot->seq);
+    if (before & 1) continue;
+    if (before == 0) return RETURNCODE_EOFF;
+
+    uint32_t sample_len = load(&slot->len);
+    if (sample_len > capacity) continue;
+    if (sample_len > len) return RETURNCODE_ESIZE;
+    memcpy(buf, slot + 1, sample_len);
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (load(&slot->seq) == before) {
+      if (seq != NULL) *seq = before;
+      return (int) sample_len;
+    }
+  }
+  return RETURNCODE_EBUSY;
+}
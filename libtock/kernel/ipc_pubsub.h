@@ -0,0 +1,98 @@
+#pragma once
+
+#include "ipc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Publish/subscribe over IPC.
+//
+// A publisher (an IPC service) owns one slot holding the latest sample and
+// shares the same slot with every subscriber. Publishing writes the sample
+// once, no matter how many subscribers there are, and subscribers read it
+// straight from the slot without any syscall.
+//
+// The slot is protected by a sequence counter: the publisher makes it odd
+// while writing and even once done, and a reader retries if the counter was
+// odd or changed during its copy. Readers therefore never block the
+// publisher and never see a torn sample.
+//
+// Publisher:
+//
+//     static uint8_t slot[64] __attribute__((aligned(64)));
+//     ipc_pubsub_publisher_init(&pub, "org.example.sensor", slot, sizeof(slot));
+//     ipc_pubsub_publish(&pub, &sample, sizeof(sample), true);
+//
+// Subscriber:
+//
+//     ipc_pubsub_subscribe(&sub, "org.example.sensor", new_sample, NULL);
+//     ...
+//     ipc_pubsub_read(&sub, &sample, sizeof(sample), &seq);
+
+// Maximum number of subscribers per publisher.
+#define IPC_PUBSUB_MAX_SUBSCRIBERS 8
+
+// Layout of the start of the shared slot.
+typedef struct {
+  uint32_t magic;
+  // Odd while a sample is being written. Incremented by two per sample.
+  uint32_t seq;
+  // Bytes of sample data after the header.
+  uint32_t capacity;
+  uint32_t len;
+} ipc_pubsub_slot_t;
+
+typedef struct {
+  ipc_pubsub_slot_t* slot;
+  size_t slot_len;
+  size_t subscribers[IPC_PUBSUB_MAX_SUBSCRIBERS];
+  int subscriber_count;
+} ipc_pubsub_publisher_t;
+
+// Function signature for subscriber notifications.
+//
+// - `arg1` (`uint32_t`): Sequence number of the new sample.
+// - `arg2` (`void*`): The `ud` passed to `ipc_pubsub_subscribe()`.
+typedef void (*ipc_pubsub_callback)(uint32_t, void*);
+
+typedef struct {
+  const ipc_pubsub_slot_t* slot;
+  size_t slot_len;
+  size_t publisher;
+  ipc_pubsub_callback callback;
+  void* ud;
+} ipc_pubsub_subscriber_t;
+
+// Register as the publisher for this app's package name `pkg_name`, with
+// `slot` holding the samples. `slot` and `len` must meet the requirements of
+// `ipc_share()`.
+int ipc_pubsub_publisher_init(ipc_pubsub_publisher_t* pub, const char* pkg_name, void* slot, size_t len);
+
+// Largest sample the slot holds.
+size_t ipc_pubsub_capacity(const ipc_pubsub_publisher_t* pub);
+
+// Store a new sample. If `notify` is true, every subscriber is notified,
+// otherwise subscribers only see it when they next read.
+//
+// Returns RETURNCODE_ESIZE if `len` is above `ipc_pubsub_capacity()`.
+int ipc_pubsub_publish(ipc_pubsub_publisher_t* pub, const void* sample, size_t len, bool notify);
+
+// Subscribe to the publisher with package name `pkg_name`. `callback` runs
+// for every notified sample, starting with the one current when the
+// subscription is accepted, and may be NULL.
+int ipc_pubsub_subscribe(ipc_pubsub_subscriber_t* sub, const char* pkg_name, ipc_pubsub_callback callback,
+                         void* ud);
+
+// Copy the latest sample into `buf`. `seq`, if not NULL, is set to its
+// sequence number, which changes with every publish.
+//
+// Returns the sample length, RETURNCODE_EOFF if the subscription has not
+// been accepted yet or nothing has been published, RETURNCODE_ESIZE if the
+// sample does not fit, and RETURNCODE_EBUSY if the publisher kept writing
+// during every retry.
+int ipc_pubsub_read(const ipc_pubsub_subscriber_t* sub, void* buf, size_t len, uint32_t* seq);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,238 @@
+#include "ipc_ring.h"
+
+#define RING_MAGIC  0x52494E47
+#define WRAP_MARKER 0xFFFFFFFF
+
+// Smallest ring that still holds a useful message.
+#define MIN_RING_SIZE 16
+
+static uint32_t load(const uint32_t* p) {
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static void store(uint32_t* p, uint32_t value) {
+  __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+static uint32_t record_size(size_t len) {
+  return 4 + (((uint32_t) len + 3) & ~3u);
+}
+
+static int notify(const ipc_ring_t* ring) {
+  return ring->service ? ipc_notify_client(ring->peer) : ipc_notify_service(ring->peer);
+}
+
+// Indices written by the peer are only used once checked.
+static bool valid_index(const ipc_ring_half_t* half, uint32_t index) {
+  return index < half->size && (index & 3) == 0;
+}
+
+static void half_init(ipc_ring_half_t* half, ipc_ring_header_t* header, uint8_t* region, uint32_t offset,
+                      uint32_t size) {
+  header->magic            = RING_MAGIC;
+  header->offset           = offset;
+  header->size             = size;
+  header->head             = 0;
+  header->tail             = 0;
+  header->producer_waiting = 0;
+
+  half->header  = header;
+  half->data    = region + offset;
+  half->size    = size;
+  half->index   = 0;
+  half->pending = 0;
+}
+
+int ipc_ring_client_init(ipc_ring_t* ring, size_t svc_id, void* region, size_t len) {
+  uint32_t headers = 2 * sizeof(ipc_ring_header_t);
+  if (len < headers + 2 * MIN_RING_SIZE) return RETURNCODE_EINVAL;
+
+  uint32_t size = ((len - headers) / 2) & ~3u;
+  uint8_t* base = region;
+  ipc_ring_header_t* header = region;
+
+  half_init(&ring->tx, &header[0], base, headers, size);
+  half_init(&ring->rx, &header[1], base, headers + size, size);
+  ring->region      = base;
+  ring->peer        = svc_id;
+  ring->service     = false;
+  ring->attached    = true;
+  ring->hold        = false;
+  ring->notify_held = false;
+
+  return ipc_share(svc_id, region, len);
+}
+
+// Check a header the client wrote and attach `half` to it, taking the initial
+// index from `index`.
+static bool half_attach(ipc_ring_half_t* half, ipc_ring_header_t* header, uint8_t* region, uint32_t len,
+                        const uint32_t* index) {
+  uint32_t offset = load(&header->offset);
+  uint32_t size   = load(&header->size);
+  if (load(&header->magic) != RING_MAGIC) return false;
+  if ((offset & 3) != 0 || (size & 3) != 0 || size < MIN_RING_SIZE) return false;
+  if (offset < 2 * sizeof(ipc_ring_header_t) || offset > len || size > len - offset) return false;
+
+  half->header  = header;
+  half->data    = region + offset;
+  half->size    = size;
+  half->pending = 0;
+  half->index   = load(index);
+  return valid_index(half, half->index);
+}
+
+int ipc_ring_service_attach(ipc_ring_t* ring, int pid, void* region, int len) {
+  if (ring->attached) {
+    if (ring->peer == (size_t) pid && ring->region == region) return RETURNCODE_SUCCESS;
+    return RETURNCODE_EBUSY;
+  }
+  if (region == NULL || len < (int) (2 * sizeof(ipc_ring_header_t))) return RETURNCODE_EINVAL;
+
+  ipc_ring_header_t* header = region;
+  // The client's transmit ring is the service's receive ring.
+  if (!half_attach(&ring->rx, &header[0], region, len, &header[0].tail) ||
+      !half_attach(&ring->tx, &header[1], region, len, &header[1].head)) {
+    return RETURNCODE_EINVAL;
+  }
+
+  ring->region      = region;
+  ring->peer        = pid;
+  ring->service     = true;
+  ring->attached    = true;
+  ring->hold        = false;
+  ring->notify_held = false;
+  return RETURNCODE_SUCCESS;
+}
+
+size_t ipc_ring_max_message(const ipc_ring_t* ring) {
+  // A message may have to skip the end of the ring, so a record of up to half
+  // the ring always fits once the ring has drained.
+  return ((ring->tx.size / 2) & ~3u) - 4;
+}
+
+void* ipc_ring_reserve(ipc_ring_t* ring, size_t len) {
+  ipc_ring_half_t* tx = &ring->tx;
+  if (!ring->attached || len > ipc_ring_max_message(ring)) return NULL;
+
+  uint32_t need = record_size(len);
+  uint32_t head = tx->index;
+  uint32_t skip = head + need > tx->size ? tx->size - head : 0;
+
+  for (int attempt = 0; attempt < 2; attempt++) {
+    uint32_t tail = load(&tx->header->tail);
+    if (!valid_index(tx, tail)) return NULL;
+
+    // One word always stays free, so a full ring is not mistaken for empty.
+    uint32_t used = (head - tail + tx->size) % tx->size;
+    if (skip + need <= tx->size - used - 4) {
+      uint32_t start = head;
+      if (skip != 0) {
+        *(uint32_t*) (tx->data + head) = WRAP_MARKER;
+        start = 0;
+      }
+      tx->pending = skip + need;
+      return tx->data + start + 4;
+    }
+
+    // Ask the consumer to notify once it frees space, then check again in
+    // case it did so before seeing the flag.
+    store(&tx->header->producer_waiting, 1);
+  }
+  return NULL;
+}
+
+int ipc_ring_commit(ipc_ring_t* ring, size_t len) {
+  ipc_ring_half_t* tx = &ring->tx;
+  if (tx->pending == 0) return RETURNCODE_EINVAL;
+
+  uint32_t old_head = tx->index;
+  uint32_t skip     = old_head + tx->pending > tx->size ? tx->size - old_head : 0;
+  uint32_t start    = skip != 0 ? 0 : old_head;
+  uint32_t need     = record_size(len);
+  if (need > tx->pending - skip) return RETURNCODE_ESIZE;
+
+  *(uint32_t*) (tx->data + start) = (uint32_t) len;
+  tx->index   = (start + need) % tx->size;
+  tx->pending = 0;
+  store(&tx->header->head, tx->index);
+
+  // Only a consumer that had drained everything is waiting for a notify.
+  if (load(&tx->header->tail) == old_head) {
+    if (ring->hold) {
+      ring->notify_held = true;
+      return RETURNCODE_SUCCESS;
+    }
+    return notify(ring);
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+int ipc_ring_send(ipc_ring_t* ring, const void* msg, size_t len) {
+  if (len > ipc_ring_max_message(ring)) return RETURNCODE_ESIZE;
+
+  void* slot = ipc_ring_reserve(ring, len);
+  if (slot == NULL) return RETURNCODE_ENOMEM;
+  memcpy(slot, msg, len);
+  return ipc_ring_commit(ring, len);
+}
+
+void ipc_ring_hold_notify(ipc_ring_t* ring) {
+  ring->hold = true;
+}
+
+int ipc_ring_release_notify(ipc_ring_t* ring) {
+  ring->hold = false;
+  if (!ring->notify_held) return RETURNCODE_SUCCESS;
+  ring->notify_held = false;
+  return notify(ring);
+}
+
+int ipc_ring_peek(ipc_ring_t* ring, const void** msg) {
+  ipc_ring_half_t* rx = &ring->rx;
+  if (!ring->attached) return RETURNCODE_EOFF;
+
+  uint32_t head = load(&rx->header->head);
+  if (!valid_index(rx, head)) return RETURNCODE_FAIL;
+
+  if (rx->index != head && load((uint32_t*) (rx->data + rx->index)) == WRAP_MARKER) {
+    rx->index = 0;
+    store(&rx->header->tail, 0);
+  }
+  if (rx->index == head) return RETURNCODE_EOFF;
+
+  uint32_t len  = load((uint32_t*) (rx->data + rx->index));
+  uint32_t used = (head - rx->index + rx->size) % rx->size;
+  if (len > rx->size || record_size(len) > used || rx->index + record_size(len) > rx->size) {
+    return RETURNCODE_FAIL;
+  }
+
+  rx->pending = record_size(len);
+  *msg        = rx->data + rx->index + 4;
+  return (int) len;
+}
+
+int ipc_ring_consume(ipc_ring_t* ring) {
+  ipc_ring_half_t* rx = &ring->rx;
+  if (rx->pending == 0) return RETURNCODE_EINVAL;
+
+  rx->index   = (rx->index + rx->pending) % rx->size;
+  rx->pending = 0;
+  store(&rx->header->tail, rx->index);
+
+  if (load(&rx->header->producer_waiting) != 0) {
+    store(&rx->header->producer_waiting, 0);
+    return notify(ring);
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+int ipc_ring_recv(ipc_ring_t* ring, void* buf, size_t len) {
+  const void* msg;
+  int n = ipc_ring_peek(ring, &msg);
+  if (n < 0) return n;
+  if ((size_t) n > len) return RETURNCODE_ESIZE;
+
+  memcpy(buf, msg, n);
+  ipc_ring_consume(ring);
+  return n;
+}
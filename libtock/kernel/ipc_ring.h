@@ -0,0 +1,145 @@
+#pragma once
+
+#include "ipc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Message rings over an IPC shared buffer.
+//
+// A client shares one buffer with a service, and this module lays out two
+// single-producer/single-consumer rings in it: one carrying messages from the
+// client to the service, and one carrying messages back. Messages are written
+// in place, so neither side copies a whole buffer per message, and a notify
+// is only sent when a ring goes from empty to non-empty. A producer can queue
+// many messages per notify.
+//
+// Client:
+//
+//     static uint8_t region[512] __attribute__((aligned(512)));
+//     ipc_ring_t ring;
+//     ipc_register_client_callback(svc, client_callback, NULL);
+//     ipc_ring_client_init(&ring, svc, region, sizeof(region));
+//     ipc_ring_send(&ring, "hello", 5);
+//
+// Service, from its IPC callback:
+//
+//     static void service_callback(int pid, int len, int buf, void* ud) {
+//       ipc_ring_service_attach(&ring, pid, (void*) buf, len);
+//       const void* msg;
+//       int n;
+//       while ((n = ipc_ring_peek(&ring, &msg)) >= 0) {
+//         handle(msg, n);
+//         ipc_ring_consume(&ring);
+//       }
+//     }
+//
+// Both sides must drain incoming messages until `ipc_ring_peek()` reports
+// the ring empty whenever they are notified, otherwise later messages do not
+// generate a notify. A notify is also sent to a producer that found its ring
+// full, once the consumer has made room.
+//
+// The service does not trust the client: every index read from the shared
+// buffer is checked before use.
+
+// Per-direction ring state kept at the start of the shared buffer. Indices
+// are byte offsets into the ring data.
+typedef struct {
+  uint32_t magic;
+  // Offset of the ring data from the start of the shared buffer.
+  uint32_t offset;
+  uint32_t size;
+  // Written only by the producer.
+  uint32_t head;
+  // Written only by the consumer.
+  uint32_t tail;
+  // Set by a producer that is waiting for space.
+  uint32_t producer_waiting;
+} ipc_ring_header_t;
+
+// One direction of a channel.
+typedef struct {
+  ipc_ring_header_t* header;
+  uint8_t* data;
+  // Copied at setup, so the peer cannot change it afterwards.
+  uint32_t size;
+  // This side's index (head when producing, tail when consuming), kept
+  // locally so the peer cannot change it.
+  uint32_t index;
+  // Producer: bytes reserved by `ipc_ring_reserve()`. Consumer: bytes of the
+  // message returned by `ipc_ring_peek()`.
+  uint32_t pending;
+} ipc_ring_half_t;
+
+// One end of a channel.
+typedef struct {
+  ipc_ring_half_t tx;
+  ipc_ring_half_t rx;
+  uint8_t* region;
+  size_t peer;
+  bool service;
+  bool attached;
+  // Set by `ipc_ring_hold_notify()`.
+  bool hold;
+  bool notify_held;
+} ipc_ring_t;
+
+// Lay out both rings in `region` and share it with the service `svc_id`.
+//
+// `region` and `len` must meet the requirements of `ipc_share()`.
+int ipc_ring_client_init(ipc_ring_t* ring, size_t svc_id, void* region, size_t len);
+
+// Attach to the rings a client set up, using the arguments of the service
+// IPC callback. Calling it again for an attached ring only checks that it
+// is the same client and buffer.
+//
+// Returns RETURNCODE_EINVAL if the buffer does not hold valid rings and
+// RETURNCODE_EBUSY if `ring` is attached to a different client.
+int ipc_ring_service_attach(ipc_ring_t* ring, int pid, void* region, int len);
+
+// Largest message `ipc_ring_send()` accepts.
+size_t ipc_ring_max_message(const ipc_ring_t* ring);
+
+// Reserve space for a `len` byte message and return where to write it, or
+// NULL if the ring is full. Publish it with `ipc_ring_commit()`.
+void* ipc_ring_reserve(ipc_ring_t* ring, size_t len);
+
+// Publish the message reserved with `ipc_ring_reserve()`. `len` must not be
+// larger than the reserved length.
+int ipc_ring_commit(ipc_ring_t* ring, size_t len);
+
+// Copy a message into the ring and publish it.
+//
+// Returns RETURNCODE_ESIZE if `len` is above `ipc_ring_max_message()` and
+// RETURNCODE_ENOMEM if the ring is full. The consumer notifies this side
+// once there is space again.
+int ipc_ring_send(ipc_ring_t* ring, const void* msg, size_t len);
+
+// Delay the notify for messages sent from now on until
+// `ipc_ring_release_notify()`, so a batch costs at most one notify even if
+// the consumer runs in between.
+void ipc_ring_hold_notify(ipc_ring_t* ring);
+
+// Send the notify held back since `ipc_ring_hold_notify()`, if any.
+int ipc_ring_release_notify(ipc_ring_t* ring);
+
+// Point `msg` at the oldest incoming message without removing it.
+//
+// Returns the message length, RETURNCODE_EOFF if there is none, or
+// RETURNCODE_FAIL if the peer corrupted the ring.
+int ipc_ring_peek(ipc_ring_t* ring, const void** msg);
+
+// Remove the message returned by `ipc_ring_peek()`.
+int ipc_ring_consume(ipc_ring_t* ring);
+
+// Copy the oldest incoming message into `buf` and remove it.
+//
+// Returns the message length, RETURNCODE_EOFF if there is none, or
+// RETURNCODE_ESIZE if it does not fit in `len` bytes, in which case it stays
+// in the ring.
+int ipc_ring_recv(ipc_ring_t* ring, void* buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
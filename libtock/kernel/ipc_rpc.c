@@ -0,0 +1,197 @@
+#include "ipc_rpc.h"
+
+static ipc_rpc_pending_t* find_pending(ipc_rpc_client_t* client, uint16_t id) {
+  for (int i = 0; i < IPC_RPC_MAX_PENDING; i++) {
+    if (client->pending[i].in_use && client->pending[i].id == id) {
+      return &client->pending[i];
+    }
+  }
+  return NULL;
+}
+
+static void client_upcall(__attribute__ ((unused)) int   pid,
+                          __attribute__ ((unused)) int   len,
+                          __attribute__ ((unused)) int   arg2,
+                          void*                          ud) {
+  ipc_rpc_client_t* client = ud;
+  const void* msg;
+  int n;
+  while ((n = ipc_ring_peek(&client->ring, &msg)) >= 0) {
+    if ((size_t) n < sizeof(ipc_rpc_header_t)) {
+      ipc_ring_consume(&client->ring);
+      continue;
+    }
+    const ipc_rpc_header_t* header = msg;
+    ipc_rpc_pending_t* pending     = find_pending(client, header->id);
+    if (pending != NULL) {
+      // Free the slot first so the callback can make a new call.
+      ipc_rpc_callback callback = pending->callback;
+      void* callback_ud         = pending->ud;
+      pending->in_use = false;
+      callback(header->status, header + 1, n - sizeof(ipc_rpc_header_t), callback_ud);
+    }
+    ipc_ring_consume(&client->ring);
+  }
+}
+
+int ipc_rpc_client_init(ipc_rpc_client_t* client, const char* pkg_name, void* region, size_t len) {
+  size_t svc_id;
+  int ret = ipc_discover(pkg_name, &svc_id);
+  if (ret < 0) return ret;
+
+  client->next_id = 0;
+  for (int i = 0; i < IPC_RPC_MAX_PENDING; i++) {
+    client->pending[i].in_use = false;
+  }
+
+  ret = ipc_register_client_callback(svc_id, client_upcall, client);
+  if (ret < 0) return ret;
+  return ipc_ring_client_init(&client->ring, svc_id, region, len);
+}
+
+int ipc_rpc_call(ipc_rpc_client_t* client, uint16_t method, const void* args, size_t args_len,
+                 ipc_rpc_callback callback, void* ud) {
+  ipc_rpc_pending_t* pending = NULL;
+  for (int i = 0; i < IPC_RPC_MAX_PENDING; i++) {
+    if (!client->pending[i].in_use) {
+      pending = &client->pending[i];
+      break;
+    }
+  }
+  if (pending == NULL) return RETURNCODE_EBUSY;
+
+  size_t len = sizeof(ipc_rpc_header_t) + args_len;
+  if (len > ipc_ring_max_message(&client->ring)) return RETURNCODE_ESIZE;
+
+  ipc_rpc_header_t* header = ipc_ring_reserve(&client->ring, len);
+  if (header == NULL) return RETURNCODE_ENOMEM;
+
+  // IDs of outstanding calls must differ, skip any still in use after the
+  // counter wraps.
+  do {
+    client->next_id++;
+  } while (find_pending(client, client->next_id) != NULL);
+
+  header->method = method;
+  header->id     = client->next_id;
+  header->status = 0;
+  memcpy(header + 1, args, args_len);
+
+  pending->id       = header->id;
+  pending->in_use   = true;
+  pending->callback = callback;
+  pending->ud       = ud;
+
+  int ret = ipc_ring_commit(&client->ring, len);
+  if (ret != RETURNCODE_SUCCESS) {
+    // The service could not be notified. Any late response is ignored.
+    pending->in_use = false;
+  }
+  return ret;
+}
+
+void ipc_rpc_batch_begin(ipc_rpc_client_t* client) {
+  ipc_ring_hold_notify(&client->ring);
+}
+
+int ipc_rpc_batch_end(ipc_rpc_client_t* client) {
+  return ipc_ring_release_notify(&client->ring);
+}
+
+int ipc_rpc_pending_count(const ipc_rpc_client_t* client) {
+  int count = 0;
+  for (int i = 0; i < IPC_RPC_MAX_PENDING; i++) {
+    if (client->pending[i].in_use) count++;
+  }
+  return count;
+}
+
+// Answer every queued request from one client. Stops early if the reply ring
+// is full; the client notifies once it has read some replies.
+static void serve(ipc_rpc_service_t* service, ipc_ring_t* ring) {
+  if (ipc_ring_max_message(ring) < sizeof(ipc_rpc_header_t)) return;
+  size_t ring_max = ipc_ring_max_message(ring) - sizeof(ipc_rpc_header_t);
+
+  // All replies to this batch reach the client with one notify.
+  ipc_ring_hold_notify(ring);
+
+  const void* msg;
+  int n;
+  while ((n = ipc_ring_peek(ring, &msg)) >= 0) {
+    if ((size_t) n < sizeof(ipc_rpc_header_t)) {
+      ipc_ring_consume(ring);
+      continue;
+    }
+
+    // Copy the header out, the client may change the shared buffer at any
+    // time.
+    ipc_rpc_header_t request;
+    memcpy(&request, msg, sizeof(request));
+
+    const ipc_rpc_method_t* method = NULL;
+    if (request.method < service->method_count && service->methods[request.method].handler != NULL) {
+      method = &service->methods[request.method];
+    }
+    size_t max_result = ring_max;
+    if (method != NULL && method->max_result != 0 && method->max_result < ring_max) {
+      max_result = method->max_result;
+    }
+
+    ipc_rpc_header_t* reply = ipc_ring_reserve(ring, sizeof(ipc_rpc_header_t) + max_result);
+    if (reply == NULL) break;
+
+    size_t result_len = max_result;
+    if (method != NULL) {
+      reply->status = method->handler((const ipc_rpc_header_t*) msg + 1, n - sizeof(ipc_rpc_header_t),
+                                      reply + 1, &result_len, service->ud);
+    } else {
+      reply->status = RETURNCODE_ENOSUPPORT;
+      result_len    = 0;
+    }
+    if (result_len > max_result) result_len = max_result;
+    reply->method = request.method;
+    reply->id     = request.id;
+
+    ipc_ring_commit(ring, sizeof(ipc_rpc_header_t) + result_len);
+    ipc_ring_consume(ring);
+  }
+
+  ipc_ring_release_notify(ring);
+}
+
+static void service_upcall(int pid, int len, int buf, void* ud) {
+  ipc_rpc_service_t* service = ud;
+
+  // Use the ring already attached to this client, or a free one.
+  ipc_ring_t* ring = NULL;
+  for (int i = 0; i < IPC_RPC_MAX_CLIENTS; i++) {
+    ipc_ring_t* candidate = &service->rings[i];
+    if (candidate->attached && candidate->peer == (size_t) pid) {
+      ring = candidate;
+      break;
+    }
+    if (!candidate->attached && ring == NULL) {
+      ring = candidate;
+    }
+  }
+  if (ring == NULL) return;
+
+  if (ring->attached && ring->region != (uint8_t*) buf) {
+    // The client restarted with a new buffer.
+    ring->attached = false;
+  }
+  if (ipc_ring_service_attach(ring, pid, (void*) buf, len) != RETURNCODE_SUCCESS) return;
+
+  serve(service, ring);
+}
+
+int ipc_rpc_service_init(ipc_rpc_service_t* service, const char* pkg_name, const ipc_rpc_method_t* methods,
+                         size_t method_count, void* ud) {
+  for (int i = 0; i < IPC_RPC_MAX_CLIENTS; i++) {
+    service->rings[i].attached = false;
+  }
+  service->methods      = methods;
+  service->method_count = method_count;
+  service->ud           = ud;
+  return ipc_register_service_callback(pkg_name, service_upcall, service);
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "ipc_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Remote procedure calls between apps.
+//
+// Requests and responses travel over an `ipc_ring_t` and start with a small
+// header carrying the method number, a request ID, and for responses a
+// status. A client may have up to `IPC_RPC_MAX_PENDING` calls outstanding,
+// and calls made back to back share one notify. Wrap several calls in
+// `ipc_rpc_batch_begin()`/`ipc_rpc_batch_end()` to guarantee that.
+//
+// Methods are numbered by their index in the service's method table. The
+// `IPC_RPC_CLIENT_STUB` and `IPC_RPC_SERVICE_STUB` macros generate typed
+// wrappers for methods that take and return fixed-size structs:
+//
+//     typedef struct { uint32_t channel; } read_args_t;
+//     typedef struct { int32_t value; } read_result_t;
+//     #define SENSOR_READ 0
+//
+//     // Client
+//     IPC_RPC_CLIENT_STUB(sensor_read, SENSOR_READ, read_args_t)
+//
+//     // Service
+//     static int read_impl(const read_args_t* args, read_result_t* result, void* ud);
+//     IPC_RPC_SERVICE_STUB(read_handler, read_args_t, read_result_t, read_impl)
+//     static const ipc_rpc_method_t methods[] = {
+//       [SENSOR_READ] = { read_handler, sizeof(read_result_t) },
+//     };
+//
+// Argument and result structs are copied as raw bytes, so both apps must be
+// built with the same definitions. Payloads are 4-byte aligned.
+
+// Maximum number of outstanding calls per client.
+#define IPC_RPC_MAX_PENDING 8
+
+// Maximum number of clients per service.
+#define IPC_RPC_MAX_CLIENTS 4
+
+// Header in front of every request and response.
+typedef struct {
+  uint16_t method;
+  uint16_t id;
+  // Response status, a returncode_t. Zero in requests.
+  int32_t status;
+} ipc_rpc_header_t;
+
+// Function signature for call completions.
+//
+// - `arg1` (`int`): Returncode from the service handler, or an IPC error.
+// - `arg2` (`const void*`): Result payload, valid only during the callback.
+// - `arg3` (`size_t`): Result payload length.
+// - `arg4` (`void*`): The `ud` passed to `ipc_rpc_call()`.
+typedef void (*ipc_rpc_callback)(int, const void*, size_t, void*);
+
+// Function signature for service method handlers.
+//
+// Write up to `*result_len` bytes of result into `result` and set
+// `*result_len` to the number written. `result` points into the reply ring,
+// so results are not copied again. Returns the status sent to the client.
+typedef int (*ipc_rpc_handler)(const void* args, size_t args_len, void* result, size_t* result_len, void* ud);
+
+// Entry in a service's method table.
+typedef struct {
+  ipc_rpc_handler handler;
+  // Largest result the handler writes. Space for it is reserved in the reply
+  // ring before the handler runs, so keep it tight to fit more replies per
+  // batch. Zero allows the largest message the ring takes.
+  size_t max_result;
+} ipc_rpc_method_t;
+
+typedef struct {
+  uint16_t id;
+  bool in_use;
+  ipc_rpc_callback callback;
+  void* ud;
+} ipc_rpc_pending_t;
+
+typedef struct {
+  ipc_ring_t ring;
+  uint16_t next_id;
+  ipc_rpc_pending_t pending[IPC_RPC_MAX_PENDING];
+} ipc_rpc_client_t;
+
+typedef struct {
+  ipc_ring_t rings[IPC_RPC_MAX_CLIENTS];
+  const ipc_rpc_method_t* methods;
+  size_t method_count;
+  void* ud;
+} ipc_rpc_service_t;
+
+// Connect to the service with package name `pkg_name`, using `region` as the
+// shared buffer. `region` and `len` must meet the requirements of
+// `ipc_share()`.
+int ipc_rpc_client_init(ipc_rpc_client_t* client, const char* pkg_name, void* region, size_t len);
+
+// Start a call. `callback` runs once the response arrives.
+//
+// Returns RETURNCODE_EBUSY if `IPC_RPC_MAX_PENDING` calls are outstanding,
+// RETURNCODE_ESIZE if the arguments do not fit in a message, and
+// RETURNCODE_ENOMEM if the request ring is full.
+int ipc_rpc_call(ipc_rpc_client_t* client, uint16_t method, const void* args, size_t args_len,
+                 ipc_rpc_callback callback, void* ud);
+
+// Delay the notify for calls made until `ipc_rpc_batch_end()`, so the whole
+// batch reaches the service with one notify.
+void ipc_rpc_batch_begin(ipc_rpc_client_t* client);
+
+int ipc_rpc_batch_end(ipc_rpc_client_t* client);
+
+// Number of calls waiting for a response.
+int ipc_rpc_pending_count(const ipc_rpc_client_t* client);
+
+// Register as the service for this app's package name `pkg_name`, handling
+// method `i` with `methods[i]`. `ud` is passed to every handler.
+int ipc_rpc_service_init(ipc_rpc_service_t* service, const char* pkg_name, const ipc_rpc_method_t* methods,
+                         size_t method_count, void* ud);
+
+// Generate `int name(ipc_rpc_client_t*, const args_t*, ipc_rpc_callback, void*)`
+// calling `method`.
+#define IPC_RPC_CLIENT_STUB(name, method, args_t)                                                   \
+  static inline int name(ipc_rpc_client_t* client, const args_t* args, ipc_rpc_callback callback,   \
+                         void* ud) {                                                                \
+    return ipc_rpc_call(client, method, args, sizeof(args_t), callback, ud);                        \
+  }
+
+// Generate an `ipc_rpc_handler` named `name` that checks the payload sizes
+// and calls `int impl(const args_t*, result_t*, void* ud)`.
+#define IPC_RPC_SERVICE_STUB(name, args_t, result_t, impl)                                          \
+  static int name(const void* args, size_t args_len, void* result, size_t* result_len, void* ud) {  \
+    if (args_len != sizeof(args_t) || *result_len < sizeof(result_t)) {                             \
+      *result_len = 0;                                                                              \
+      return RETURNCODE_ESIZE;                                                                      \
+    }                                                                                               \
+    *result_len = sizeof(result_t);                                                                 \
+    return impl((const args_t*) args, (result_t*) result, ud);                                      \
+  }
+
+#ifdef __cplusplus
+}
+#endif
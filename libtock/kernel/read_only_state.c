@@ -7,7 +7,12 @@ returncode_t libtock_read_only_state_allocate_region(uint8_t* base, int len) {
     return RETURNCODE_ESIZE;
   }
 
-  return libtock_read_only_state_set_userspace_read_allow_allocate_region(base, len);
+  returncode_t ret = libtock_read_only_state_set_userspace_read_allow_allocate_region(base, len);
+  if (ret == RETURNCODE_SUCCESS) {
+    // Let `yield_no_wait()` check for queued upcalls without a trap.
+    tock_yield_use_read_only_state(base);
+  }
+  return ret;
 }
 
 uint32_t libtock_read_only_state_get_pending_tasks(void* base) {
@@ -23,6 +23,9 @@ extern "C" {
 //
 // - `base` the buffer to use.
 // - `len` should be `LIBTOCK_READ_ONLY_STATE_BUFFER_LEN`.
+//
+// From then on `yield_no_wait()` reads the pending task count from the region
+// and skips its system call while nothing is pending.
 returncode_t libtock_read_only_state_allocate_region(uint8_t* base, int len);
 
 // Use the read only state buffer provided by `base`
@@ -30,7 +33,8 @@ returncode_t libtock_read_only_state_allocate_region(uint8_t* base, int len);
 uint32_t libtock_read_only_state_get_pending_tasks(void* base);
 
 // Use the read only state buffer provided by `base`
-// to get the current time returned from the kernel.
+// to get the time the kernel last switched to this app. The kernel only
+// writes it on a context switch, so it does not advance while the app runs.
 uint64_t libtock_read_only_state_get_ticks(void* base);
 
 #ifdef __cplusplus
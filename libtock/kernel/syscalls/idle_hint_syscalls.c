@@ -0,0 +1,15 @@
+#include "idle_hint_syscalls.h"
+
+bool libtock_idle_hint_exists(void) {
+  return driver_exists(DRIVER_NUM_IDLE_HINT);
+}
+
+returncode_t libtock_idle_hint_set_userspace_read_allow_region(uint8_t* buffer, uint32_t length) {
+  allow_userspace_r_return_t aval = allow_userspace_read(DRIVER_NUM_IDLE_HINT, 0, (void*) buffer, length);
+  return tock_allow_userspace_r_return_to_returncode(aval);
+}
+
+returncode_t libtock_idle_hint_command_get_version(uint32_t* version) {
+  syscall_return_t cval = command(DRIVER_NUM_IDLE_HINT, 1, 0, 0);
+  return tock_command_return_u32_to_returncode(cval, version);
+}
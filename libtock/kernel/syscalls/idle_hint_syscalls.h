@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Not assigned upstream yet; boards whose kernel serves the hints under
+// another number override it through `LIBTOCK_CONFIG`.
+#ifndef DRIVER_NUM_IDLE_HINT
+#define DRIVER_NUM_IDLE_HINT 0x0000A
+#endif
+
+// Check if this driver is available on the kernel.
+bool libtock_idle_hint_exists(void);
+
+// Share the region the app publishes its idle hints in.
+//
+// - `buffer` the buffer to use.
+// - `len` should be `LIBTOCK_IDLE_HINT_BUFFER_LEN`.
+returncode_t libtock_idle_hint_set_userspace_read_allow_region(uint8_t* buffer, uint32_t length);
+
+// Get the latest version of the idle hint region supported by the kernel.
+returncode_t libtock_idle_hint_command_get_version(uint32_t* version);
+
+#ifdef __cplusplus
+}
+#endif
@@ -72,6 +72,10 @@ typedef enum {
 // advd               - The advertising data
 // len                - Length of the advertising data (will be truncated to 31 bytes)
 // interval           - The advertising interval in milliseconds
+//
+// The kernel reads `advd` for every advertising event, so bytes changed in it
+// while advertising go out with the next event. Only changing the length
+// requires stopping and restarting.
 int ble_start_advertising(int pdu_type, uint8_t* advd, int len, uint16_t interval);
 
 // stop advertising but don't change anything in the packet configuration
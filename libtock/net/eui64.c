@@ -1,5 +1,14 @@
 #include "eui64.h"
 
 returncode_t libtock_eui64_get(uint64_t* eui64) {
-  return libtock_eui64_command_get(eui64);
+  // The EUI-64 is fixed in hardware.
+  static bool cached = false;
+  static uint64_t value;
+  if (!cached) {
+    returncode_t ret = libtock_eui64_command_get(&value);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    cached = true;
+  }
+  *eui64 = value;
+  return RETURNCODE_SUCCESS;
 }
@@ -7,6 +7,7 @@
 extern "C" {
 #endif
 
+// Get the board's EUI-64. It is read from the kernel once and then cached.
 returncode_t libtock_eui64_get(uint64_t* eui64);
 
 #ifdef __cplusplus
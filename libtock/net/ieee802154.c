@@ -412,22 +412,63 @@ returncode_t libtock_reset_ring_buf(const libtock_ieee802154_rxbuf* frame, subsc
   return libtock_ieee802154_set_upcall_frame_received(callback, ud);
 }
 
-uint8_t* libtock_ieee802154_read_next_frame(const libtock_ieee802154_rxbuf* frame) {
-  if (!frame) return NULL;
-
-  uint8_t* rx_buf = (uint8_t*) frame;
+static uint8_t* read_next(uint8_t* rx_buf, uint8_t frames) {
   int read_index  = rx_buf[0];
   int write_index = rx_buf[1];
   if (read_index == write_index) {
     return NULL;
   }
   rx_buf[0]++;
-  if (rx_buf[0] >= libtock_ieee802154_MAX_RING_BUF_FRAMES) {
+  if (rx_buf[0] >= frames) {
     rx_buf[0] = 0;
   }
   return &rx_buf[libtock_ieee802154_RING_BUF_META_LEN + (read_index * libtock_ieee802154_FRAME_LEN)];
 }
 
+uint8_t* libtock_ieee802154_read_next_frame(const libtock_ieee802154_rxbuf* frame) {
+  if (!frame) return NULL;
+  return read_next((uint8_t*) frame, libtock_ieee802154_MAX_RING_BUF_FRAMES);
+}
+
+returncode_t libtock_ieee802154_ring_init(libtock_ieee802154_ring_t* ring, uint8_t* storage, size_t len) {
+  if (len < libtock_ieee802154_RING_BUFFER_LEN_FOR(2)) return RETURNCODE_EINVAL;
+  size_t frames = (len - libtock_ieee802154_RING_BUF_META_LEN) / libtock_ieee802154_FRAME_LEN;
+  if (frames > 255) return RETURNCODE_EINVAL;
+
+  ring->buffer     = storage;
+  ring->frames     = frames;
+  ring->first_read = false;
+  ring->full       = 0;
+  memset(storage, 0, libtock_ieee802154_RING_BUFFER_LEN_FOR(frames));
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_ieee802154_ring_reset(libtock_ieee802154_ring_t* ring, subscribe_upcall callback, void* ud) {
+  uint8_t* buffer = ring ? ring->buffer : NULL;
+  uint32_t len    = ring ? libtock_ieee802154_RING_BUFFER_LEN_FOR(ring->frames) : 0;
+  returncode_t ret = libtock_ieee802154_set_readwrite_allow_rx(buffer, len);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (ring) ring->first_read = true;
+
+  return libtock_ieee802154_set_upcall_frame_received(callback, ud);
+}
+
+uint8_t* libtock_ieee802154_ring_read_next(libtock_ieee802154_ring_t* ring) {
+  if (!ring) return NULL;
+
+  uint8_t* rx_buf = ring->buffer;
+  if (ring->first_read) {
+    ring->first_read = false;
+    int pending = (rx_buf[1] + ring->frames - rx_buf[0]) % ring->frames;
+    if (pending == ring->frames - 1) ring->full++;
+  }
+  return read_next(rx_buf, ring->frames);
+}
+
+uint32_t libtock_ieee802154_ring_full(const libtock_ieee802154_ring_t* ring) {
+  return ring->full;
+}
+
 int libtock_ieee802154_frame_get_length(const uint8_t* frame) {
   if (!frame) return 0;
   // data_offset + data_len - 2 header bytes
@@ -444,12 +485,10 @@ int libtock_ieee802154_frame_get_payload_length(const uint8_t* frame) {
   return frame[1];
 }
 
-// Utility function to determine if the source and destination PAN and
-// addresses are present depending on the frame control field. This is used
-// only internally as a header parsing subroutine. Supports only 2003, 2006 or
-// 2015 frame versions. Returns false if the addressing mode combination is
-// invalid or the frame version is not supported. All out-parameters must be
-// provided.
+// Determine which PANs and addresses are present from the frame control
+// field. Supports only 2003, 2006 or 2015 frame versions. Returns false if
+// the addressing mode combination is invalid or the frame version is not
+// supported.
 //
 // If the source pan is dropped, that means that it is the same as the
 // destination pan, which must be present.
@@ -459,11 +498,6 @@ static bool libtock_ieee802154_get_addressing(uint16_t     frame_control,
                                               bool*        src_pan_present,
                                               bool*        src_pan_dropped,
                                               addr_mode_t* src_mode) {
-  if (!dst_pan_present || !dst_mode || !src_pan_present || !src_pan_dropped ||
-      !src_mode) {
-    return false;
-  }
-
   typedef enum {
     VERSION_2003 = 0x0,
     VERSION_2006 = 0x1,
@@ -475,8 +509,11 @@ static bool libtock_ieee802154_get_addressing(uint16_t     frame_control,
   *dst_mode = (addr_mode_t) ((frame_control >> 10) & 0x3);
   *src_mode = (addr_mode_t) ((frame_control >> 14) & 0x3);
   bool pan_id_compression = (frame_control >> 6) & 0x1;
-  bool dst_present        = dst_mode != ADDR_NONE;
-  bool src_present        = src_mode != ADDR_NONE;
+  bool dst_present        = *dst_mode != ADDR_NONE;
+  bool src_present        = *src_mode != ADDR_NONE;
+
+  // Mode 1 is reserved.
+  if (*dst_mode == 1 || *src_mode == 1) return false;
 
   // The flags that we are trying to determine
   *src_pan_dropped = false;
@@ -505,176 +542,126 @@ static bool libtock_ieee802154_get_addressing(uint16_t     frame_control,
   } else if (version == VERSION_2003 || version == VERSION_2006) {
     *src_pan_dropped = pan_id_compression;
     *dst_pan_present = dst_present;
-    *src_pan_present = src_present && !src_pan_dropped;
+    *src_pan_present = src_present && !*src_pan_dropped;
   } else {
     return false;
   }
 
   // Check validity of addressing modes
-  if (*src_pan_dropped && !*dst_pan_present) {
-    return 0xff;
-  }
-
-  return true;
+  return !(*src_pan_dropped && !*dst_pan_present);
 }
 
-// Utility function to obtain the frame control field from a frame
-static void libtock_ieee802154_get_frame_control(const uint8_t* frame, uint16_t* frame_control) {
-  if (!frame || !frame_control) return;
-  *frame_control = ((uint16_t) frame[libtock_ieee802154_FRAME_META_LEN]) |
-                   (((uint16_t) frame[libtock_ieee802154_FRAME_META_LEN + 1]) << 8);
+static uint16_t read_le16(const uint8_t* p) {
+  return ((uint16_t) p[0]) | (((uint16_t) p[1]) << 8);
 }
 
-// Utility function to obtain the address offset from a frame
-static void libtock_ieee802154_get_addr_offset(const uint8_t* frame, uint16_t* addr_offset, uint16_t* frame_control,
-                                               const uint16_t* SEQ_SUPPRESSED) {
-  if (!frame || !addr_offset || !frame_control || !SEQ_SUPPRESSED) return;
-  *addr_offset = ((*frame_control & *SEQ_SUPPRESSED) ? 2 : 3) + libtock_ieee802154_FRAME_META_LEN;
-}
-
-addr_mode_t libtock_ieee802154_frame_get_dst_addr(__attribute__ ((unused)) const uint8_t* frame,
-                                                  __attribute__ ((unused)) uint16_t*      short_addr,
-                                                  __attribute__ ((unused)) uint8_t*       long_addr) {
-  if (!frame) return ADDR_NONE;
-
-  uint16_t frame_control;
-  libtock_ieee802154_get_frame_control(frame, &frame_control);
-
-  bool dst_pan_present, src_pan_present, src_pan_dropped;
-  addr_mode_t dst_mode, src_mode;
-  if (!libtock_ieee802154_get_addressing(frame_control, &dst_pan_present, &dst_mode,
-                                         &src_pan_present, &src_pan_dropped, &src_mode)) {
-    return ADDR_NONE;
-  }
-
-  // The addressing fields are after the sequence number, which can be ommitted
-  const uint16_t SEQ_SUPPRESSED = 0x0100;
-  uint16_t addr_offset;
-  libtock_ieee802154_get_addr_offset(frame, &addr_offset, &frame_control, &SEQ_SUPPRESSED);
-
-  if (dst_pan_present) addr_offset += 2;
-
-  if (dst_mode == ADDR_SHORT && short_addr) {
-    *short_addr = ((uint16_t) frame[addr_offset]) |
-                  (((uint16_t) frame[addr_offset + 1]) << 8);
+// Reads an address of `mode` at `p` and returns its length in bytes. Long
+// addresses are stored most significant byte first, as returned by the
+// getters.
+static int read_addr(const uint8_t* p, addr_mode_t mode, uint16_t* short_addr, uint8_t* long_addr) {
+  if (mode == ADDR_SHORT) {
+    *short_addr = read_le16(p);
+    return 2;
   }
-  if (dst_mode == ADDR_LONG && long_addr) {
-    int i;
-    for (i = 0; i < 8; i++) {
-      long_addr[i] = frame[addr_offset + 7 - i];
+  if (mode == ADDR_LONG) {
+    for (int i = 0; i < 8; i++) {
+      long_addr[i] = p[7 - i];
     }
+    return 8;
   }
-
-  return dst_mode;
+  return 0;
 }
 
-addr_mode_t libtock_ieee802154_frame_get_src_addr(__attribute__ ((unused)) const uint8_t* frame,
-                                                  __attribute__ ((unused)) uint16_t*      short_addr,
-                                                  __attribute__ ((unused)) uint8_t*       long_addr) {
-  if (!frame) return ADDR_NONE;
+bool libtock_ieee802154_frame_parse(const uint8_t* frame, libtock_ieee802154_header_t* hdr) {
+  if (!frame || !hdr) return false;
+
+  int payload_offset = frame[0];
+  int payload_length = frame[1];
+  if (payload_offset + payload_length > libtock_ieee802154_FRAME_LEN) return false;
 
-  uint16_t frame_control;
-  libtock_ieee802154_get_frame_control(frame, &frame_control);
+  const uint8_t* p = &frame[libtock_ieee802154_FRAME_META_LEN];
+  hdr->frame_control = read_le16(p);
+  p += 2;
 
-  bool dst_pan_present, src_pan_present, src_pan_dropped;
-  addr_mode_t dst_mode, src_mode;
-  if (!libtock_ieee802154_get_addressing(frame_control, &dst_pan_present, &dst_mode,
-                                         &src_pan_present, &src_pan_dropped, &src_mode)) {
-    return ADDR_NONE;
+  bool src_pan_dropped;
+  if (!libtock_ieee802154_get_addressing(hdr->frame_control, &hdr->dst_pan_present, &hdr->dst_mode,
+                                         &hdr->src_pan_present, &src_pan_dropped, &hdr->src_mode)) {
+    return false;
   }
 
-  // The addressing fields are after the sequence number, which can be ommitted
+  // The sequence number can be omitted in 2015 frames.
   const uint16_t SEQ_SUPPRESSED = 0x0100;
-  uint16_t addr_offset;
-  libtock_ieee802154_get_addr_offset(frame, &addr_offset, &frame_control, &SEQ_SUPPRESSED);
-
-  if (dst_pan_present) addr_offset += 2;
-  if (dst_mode == ADDR_SHORT) {
-    addr_offset += 2;
-  } else if (dst_mode == ADDR_LONG) {
-    addr_offset += 8;
-  }
-  if (src_pan_present) addr_offset += 2;
+  hdr->seq_present = !(hdr->frame_control & SEQ_SUPPRESSED);
+  hdr->seq         = hdr->seq_present ? *p++ : 0;
 
-  if (src_mode == ADDR_SHORT && short_addr) {
-    *short_addr = ((uint16_t) frame[addr_offset]) |
-                  (((uint16_t) frame[addr_offset + 1]) << 8);
+  hdr->dst_pan = 0;
+  if (hdr->dst_pan_present) {
+    hdr->dst_pan = read_le16(p);
+    p += 2;
   }
-  if (src_mode == ADDR_LONG && long_addr) {
-    int i;
-    for (i = 0; i < 8; i++) {
-      long_addr[i] = frame[addr_offset + 7 - i];
-    }
+  p += read_addr(p, hdr->dst_mode, &hdr->dst_short, hdr->dst_long);
+
+  hdr->src_pan = hdr->dst_pan;
+  if (hdr->src_pan_present) {
+    hdr->src_pan = read_le16(p);
+    p += 2;
   }
+  hdr->src_pan_present = hdr->src_pan_present || src_pan_dropped;
+  p += read_addr(p, hdr->src_mode, &hdr->src_short, hdr->src_long);
 
-  return src_mode;
-}
+  // The addressing must end before the payload, leaving room for any
+  // auxiliary security header.
+  if (p - frame > payload_offset) return false;
 
-bool libtock_ieee802154_frame_get_dst_pan(__attribute__ ((unused)) const uint8_t* frame,
-                                          __attribute__ ((unused)) uint16_t*      pan) {
-  if (!frame) return false;
+  hdr->payload        = &frame[payload_offset];
+  hdr->payload_length = payload_length;
+  return true;
+}
 
-  uint16_t frame_control;
-  libtock_ieee802154_get_frame_control(frame, &frame_control);
+addr_mode_t libtock_ieee802154_frame_get_dst_addr(const uint8_t* frame,
+                                                  uint16_t*      short_addr,
+                                                  uint8_t*       long_addr) {
+  libtock_ieee802154_header_t hdr;
+  if (!libtock_ieee802154_frame_parse(frame, &hdr)) return ADDR_NONE;
 
-  bool dst_pan_present, src_pan_present, src_pan_dropped;
-  addr_mode_t dst_mode, src_mode;
-  if (!libtock_ieee802154_get_addressing(frame_control, &dst_pan_present, &dst_mode,
-                                         &src_pan_present, &src_pan_dropped, &src_mode)) {
-    return false;
-  }
-
-  // The addressing fields are after the sequence number, which can be ommitted
-  const uint16_t SEQ_SUPPRESSED = 0x0100;
-  uint16_t addr_offset;
-  libtock_ieee802154_get_addr_offset(frame, &addr_offset, &frame_control, &SEQ_SUPPRESSED);
+  if (hdr.dst_mode == ADDR_SHORT && short_addr) *short_addr = hdr.dst_short;
+  if (hdr.dst_mode == ADDR_LONG && long_addr) memcpy(long_addr, hdr.dst_long, 8);
+  return hdr.dst_mode;
+}
 
-  if (dst_pan_present && pan) {
-    *pan = ((uint16_t) frame[addr_offset]) |
-           (((uint16_t) frame[addr_offset + 1]) << 8);
-  }
+addr_mode_t libtock_ieee802154_frame_get_src_addr(const uint8_t* frame,
+                                                  uint16_t*      short_addr,
+                                                  uint8_t*       long_addr) {
+  libtock_ieee802154_header_t hdr;
+  if (!libtock_ieee802154_frame_parse(frame, &hdr)) return ADDR_NONE;
 
-  return dst_pan_present;
+  if (hdr.src_mode == ADDR_SHORT && short_addr) *short_addr = hdr.src_short;
+  if (hdr.src_mode == ADDR_LONG && long_addr) memcpy(long_addr, hdr.src_long, 8);
+  return hdr.src_mode;
 }
 
-bool libtock_ieee802154_frame_get_src_pan(__attribute__ ((unused)) const uint8_t* frame,
-                                          __attribute__ ((unused)) uint16_t*      pan) {
-  if (!frame) return false;
+bool libtock_ieee802154_frame_get_dst_pan(const uint8_t* frame,
+                                          uint16_t*      pan) {
+  libtock_ieee802154_header_t hdr;
+  if (!libtock_ieee802154_frame_parse(frame, &hdr)) return false;
 
-  uint16_t frame_control;
-  libtock_ieee802154_get_frame_control(frame, &frame_control);
+  if (hdr.dst_pan_present && pan) *pan = hdr.dst_pan;
+  return hdr.dst_pan_present;
+}
 
-  bool dst_pan_present, src_pan_present, src_pan_dropped;
-  addr_mode_t dst_mode, src_mode;
-  if (!libtock_ieee802154_get_addressing(frame_control, &dst_pan_present, &dst_mode,
-                                         &src_pan_present, &src_pan_dropped, &src_mode)) {
-    return false;
-  }
+bool libtock_ieee802154_frame_get_src_pan(const uint8_t* frame,
+                                          uint16_t*      pan) {
+  libtock_ieee802154_header_t hdr;
+  if (!libtock_ieee802154_frame_parse(frame, &hdr)) return false;
 
-  // The addressing fields are after the sequence number, which can be ommitted
-  const uint16_t SEQ_SUPPRESSED = 0x0100;
-  uint16_t addr_offset;
-  libtock_ieee802154_get_addr_offset(frame, &addr_offset, &frame_control, &SEQ_SUPPRESSED);
-
-  if (src_pan_dropped) {
-    // We can assume that the destination pan is present.
-    if (pan) {
-      *pan = ((uint16_t) frame[addr_offset]) |
-             (((uint16_t) frame[addr_offset + 1]) << 8);
-    }
-  } else {
-    if (dst_pan_present) addr_offset += 2;
-    if (dst_mode == ADDR_SHORT) {
-      addr_offset += 2;
-    } else if (dst_mode == ADDR_LONG) {
-      addr_offset += 8;
-    }
+  if (hdr.src_pan_present && pan) *pan = hdr.src_pan;
+  return hdr.src_pan_present;
+}
 
-    if (src_pan_present && pan) {
-      *pan = ((uint16_t) frame[addr_offset]) |
-             (((uint16_t) frame[addr_offset + 1]) << 8);
-    }
+const uint8_t* libtock_ieee802154_ring_next_parsed(libtock_ieee802154_ring_t* ring, libtock_ieee802154_header_t* hdr) {
+  const uint8_t* frame;
+  while ((frame = libtock_ieee802154_ring_read_next(ring)) != NULL) {
+    if (libtock_ieee802154_frame_parse(frame, hdr)) return frame;
   }
-
-  return src_pan_present || src_pan_dropped;
+  return NULL;
 }
@@ -275,12 +275,18 @@ returncode_t libtock_ieee802154_send_raw(const uint8_t*                        p
 
 // Size of the ring buffer expected by the kernel. The ring buffer is of the following
 // form: | read index | write index | frame 1 | frame 2 | ... | frame n |.
-// Dependent on the application, the number of frames contained in the ring buffer
-// can be increased or decreased by changing the value of libtock_ieee802154_MAX_RING_BUF_FRAMES.
+// The kernel derives the number of frames from the length of the allowed
+// buffer. `libtock_ieee802154_rxbuf` holds libtock_ieee802154_MAX_RING_BUF_FRAMES
+// frames; apps that need a different count at runtime use
+// `libtock_ieee802154_ring_t` instead.
 #define libtock_ieee802154_RING_BUF_META_LEN 2
+#ifndef libtock_ieee802154_MAX_RING_BUF_FRAMES
 #define libtock_ieee802154_MAX_RING_BUF_FRAMES 3
-#define libtock_ieee802154_RING_BUFFER_LEN (libtock_ieee802154_RING_BUF_META_LEN + \
-                                            libtock_ieee802154_MAX_RING_BUF_FRAMES * libtock_ieee802154_FRAME_LEN)
+#endif
+#define libtock_ieee802154_RING_BUFFER_LEN_FOR(frames) (libtock_ieee802154_RING_BUF_META_LEN + \
+                                                        (frames) * libtock_ieee802154_FRAME_LEN)
+#define libtock_ieee802154_RING_BUFFER_LEN libtock_ieee802154_RING_BUFFER_LEN_FOR( \
+    libtock_ieee802154_MAX_RING_BUF_FRAMES)
 
 // Type for the 15.4 ring buffer.
 typedef uint8_t libtock_ieee802154_rxbuf[libtock_ieee802154_RING_BUFFER_LEN];
@@ -361,6 +367,36 @@ bool libtock_ieee802154_frame_get_dst_pan(const uint8_t* frame,
 bool libtock_ieee802154_frame_get_src_pan(const uint8_t* frame,
                                           uint16_t*      pan);
 
+// The header of a received frame, decoded in one pass by
+// `libtock_ieee802154_frame_parse()`. Fields of absent addresses are not
+// written. `payload` points into the frame, which is not copied.
+typedef struct {
+  uint16_t frame_control;
+  bool seq_present;
+  uint8_t seq;
+  bool dst_pan_present;
+  uint16_t dst_pan;
+  addr_mode_t dst_mode;
+  uint16_t dst_short;
+  uint8_t dst_long[8];
+  // Also true if the source PAN is compressed, in which case `src_pan` is the
+  // destination PAN.
+  bool src_pan_present;
+  uint16_t src_pan;
+  addr_mode_t src_mode;
+  uint16_t src_short;
+  uint8_t src_long[8];
+  const uint8_t* payload;
+  int payload_length;
+} libtock_ieee802154_header_t;
+
+// Decodes the header of a received frame into `hdr`, which the getters above
+// do one field at a time. Long addresses are in the same byte order as the
+// getters return them. Returns `false` if the frame is invalid or its version
+// is not supported.
+// `frame` (in): The frame data provided by libtock_ieee802154_receive_*.
+bool libtock_ieee802154_frame_parse(const uint8_t* frame, libtock_ieee802154_header_t* hdr);
+
 // Reads the next frame from the ring buffer. If the ring buffer is empty,
 // returns NULL. The pointer returned points to the first index of the
 // received frame.
@@ -373,6 +409,44 @@ uint8_t* libtock_ieee802154_read_next_frame(const libtock_ieee802154_rxbuf* fram
 // all pending RX upcalls.
 returncode_t libtock_reset_ring_buf(const libtock_ieee802154_rxbuf* frame, subscribe_upcall callback, void* ud);
 
+// A receive ring buffer whose frame count is chosen at runtime.
+//
+// The kernel keeps one slot free to tell a full ring from an empty one, so a
+// ring of `frames` slots holds `frames - 1` received frames. Frames that
+// arrive while the ring is full are dropped by the kernel. The kernel does not
+// report drops, so the ring counts the reads that found it full, each of
+// which means frames may have been lost; a growing count says the ring is too
+// small for the traffic.
+typedef struct {
+  uint8_t* buffer;
+  uint8_t frames;
+  // Whether the next read is the first since the ring was handed back.
+  bool first_read;
+  uint32_t full;
+} libtock_ieee802154_ring_t;
+
+// Set up `ring` over `len` bytes of `storage`, which holds as many frames as
+// fit. `libtock_ieee802154_RING_BUFFER_LEN_FOR(frames)` gives the length for
+// a given frame count.
+//
+// Returns RETURNCODE_EINVAL if fewer than 2 or more than 255 frames fit.
+returncode_t libtock_ieee802154_ring_init(libtock_ieee802154_ring_t* ring, uint8_t* storage, size_t len);
+
+// Like `libtock_reset_ring_buf()` for a runtime-sized ring. Passing a NULL
+// `ring` and `callback` disables receiving.
+returncode_t libtock_ieee802154_ring_reset(libtock_ieee802154_ring_t* ring, subscribe_upcall callback, void* ud);
+
+// Like `libtock_ieee802154_read_next_frame()` for a runtime-sized ring.
+uint8_t* libtock_ieee802154_ring_read_next(libtock_ieee802154_ring_t* ring);
+
+// Number of reads that found the ring full since `libtock_ieee802154_ring_init()`.
+uint32_t libtock_ieee802154_ring_full(const libtock_ieee802154_ring_t* ring);
+
+// Reads the next frame from `ring` and parses it into `hdr`, skipping frames
+// that fail to parse. Returns the frame, which stays in the ring, or NULL if
+// the ring is empty.
+const uint8_t* libtock_ieee802154_ring_next_parsed(libtock_ieee802154_ring_t* ring, libtock_ieee802154_header_t* hdr);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,217 @@
+#include <string.h>
+
+#include "ieee802154_mirror.h"
+
+// Open addressing tables at most half full, holding list index + 1 and 0 for
+// an empty slot. They are rebuilt whenever a list changes, which is rare
+// next to lookups.
+#define NEIGHBOR_SLOTS (2 * LIBTOCK_IEEE802154_MIRROR_NEIGHBORS)
+#define KEY_SLOTS (2 * LIBTOCK_IEEE802154_MIRROR_KEYS)
+
+_Static_assert(LIBTOCK_IEEE802154_MIRROR_NEIGHBORS < 255 && LIBTOCK_IEEE802154_MIRROR_KEYS < 255,
+               "list indices must fit the hash slots");
+
+// The kernel keeps one neighbor and one key list per process, so the mirror
+// is global.
+static struct {
+  libtock_ieee802154_neighbor_t neighbors[LIBTOCK_IEEE802154_MIRROR_NEIGHBORS];
+  uint32_t num_neighbors;
+  uint8_t by_short[NEIGHBOR_SLOTS];
+  uint8_t by_long[NEIGHBOR_SLOTS];
+
+  libtock_ieee802154_key_t keys[LIBTOCK_IEEE802154_MIRROR_KEYS];
+  uint32_t num_keys;
+  uint8_t by_key_id[KEY_SLOTS];
+} mirror;
+
+// FNV-1a, continuing from `hash`.
+static uint32_t hash_bytes(uint32_t hash, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static uint32_t hash_short(uint16_t addr_short) {
+  return ((uint32_t) addr_short * 2654435761u) >> 16;
+}
+
+static uint32_t hash_long(const uint8_t* addr_long) {
+  return hash_bytes(2166136261u, addr_long, 8);
+}
+
+static uint32_t hash_key_id(security_level_t level, key_id_mode_t key_id_mode, const uint8_t* key_id) {
+  uint8_t head[2] = { (uint8_t) level, (uint8_t) key_id_mode };
+  uint32_t hash   = hash_bytes(2166136261u, head, sizeof(head));
+  return hash_bytes(hash, key_id, libtock_ieee802154_key_id_bytes(key_id_mode));
+}
+
+static void insert(uint8_t* slots, uint32_t count, uint32_t hash, uint32_t index) {
+  uint32_t s = hash % count;
+  while (slots[s] != 0) s = (s + 1) % count;
+  slots[s] = (uint8_t) (index + 1);
+}
+
+static void rebuild_neighbors(void) {
+  memset(mirror.by_short, 0, sizeof(mirror.by_short));
+  memset(mirror.by_long, 0, sizeof(mirror.by_long));
+  for (uint32_t i = 0; i < mirror.num_neighbors; i++) {
+    insert(mirror.by_short, NEIGHBOR_SLOTS, hash_short(mirror.neighbors[i].addr_short), i);
+    insert(mirror.by_long, NEIGHBOR_SLOTS, hash_long(mirror.neighbors[i].addr_long), i);
+  }
+}
+
+static void rebuild_keys(void) {
+  memset(mirror.by_key_id, 0, sizeof(mirror.by_key_id));
+  for (uint32_t i = 0; i < mirror.num_keys; i++) {
+    const libtock_ieee802154_key_t* k = &mirror.keys[i];
+    insert(mirror.by_key_id, KEY_SLOTS, hash_key_id(k->level, k->key_id_mode, k->key_id), i);
+  }
+}
+
+// Read the kernel's neighbors from `from` on, keeping the ones before it.
+static returncode_t load_neighbors(uint32_t from) {
+  uint32_t count;
+  returncode_t ret = libtock_ieee802154_num_neighbors(&count);
+  if (ret == RETURNCODE_SUCCESS && count > LIBTOCK_IEEE802154_MIRROR_NEIGHBORS) ret = RETURNCODE_ENOMEM;
+  for (uint32_t i = from; ret == RETURNCODE_SUCCESS && i < count; i++) {
+    libtock_ieee802154_neighbor_t* n = &mirror.neighbors[i];
+    ret = libtock_ieee802154_get_neighbor(i, &n->addr_short, n->addr_long);
+  }
+  // On failure, keep only what is known to match the kernel.
+  mirror.num_neighbors = ret == RETURNCODE_SUCCESS ? count : 0;
+  rebuild_neighbors();
+  return ret;
+}
+
+static returncode_t load_keys(uint32_t from) {
+  uint32_t count;
+  returncode_t ret = libtock_ieee802154_num_keys(&count);
+  if (ret == RETURNCODE_SUCCESS && count > LIBTOCK_IEEE802154_MIRROR_KEYS) ret = RETURNCODE_ENOMEM;
+  for (uint32_t i = from; ret == RETURNCODE_SUCCESS && i < count; i++) {
+    libtock_ieee802154_key_t* k = &mirror.keys[i];
+    memset(k->key_id, 0, sizeof(k->key_id));
+    ret = libtock_ieee802154_get_key_desc(i, &k->level, &k->key_id_mode, k->key_id, k->key);
+  }
+  mirror.num_keys = ret == RETURNCODE_SUCCESS ? count : 0;
+  rebuild_keys();
+  return ret;
+}
+
+returncode_t libtock_ieee802154_mirror_init(void) {
+  uint32_t max;
+  returncode_t ret = libtock_ieee802154_max_neighbors(&max);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (max > LIBTOCK_IEEE802154_MIRROR_NEIGHBORS) return RETURNCODE_ENOMEM;
+  ret = libtock_ieee802154_max_keys(&max);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (max > LIBTOCK_IEEE802154_MIRROR_KEYS) return RETURNCODE_ENOMEM;
+
+  ret = load_neighbors(0);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  return load_keys(0);
+}
+
+returncode_t libtock_ieee802154_mirror_add_neighbor(uint16_t addr_short, const uint8_t* addr_long, uint32_t* index) {
+  uint32_t added;
+  returncode_t ret = libtock_ieee802154_add_neighbor(addr_short, (uint8_t*) addr_long, &added);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (index != NULL) *index = added;
+
+  // The kernel returns the existing entry for known addresses, and appends
+  // new ones.
+  if (added > mirror.num_neighbors || added >= LIBTOCK_IEEE802154_MIRROR_NEIGHBORS) return load_neighbors(0);
+  mirror.neighbors[added].addr_short = addr_short;
+  memcpy(mirror.neighbors[added].addr_long, addr_long, 8);
+  if (added == mirror.num_neighbors) mirror.num_neighbors++;
+  rebuild_neighbors();
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_ieee802154_mirror_remove_neighbor(uint32_t index) {
+  returncode_t ret = libtock_ieee802154_remove_neighbor(index);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  // The entries after `index` moved, so read them again.
+  return load_neighbors(index < mirror.num_neighbors ? index : 0);
+}
+
+returncode_t libtock_ieee802154_mirror_add_key(security_level_t level, key_id_mode_t key_id_mode,
+                                               const uint8_t* key_id, const uint8_t* key, uint32_t* index) {
+  uint32_t added;
+  returncode_t ret = libtock_ieee802154_add_key(level, key_id_mode, (uint8_t*) key_id, (uint8_t*) key, &added);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (index != NULL) *index = added;
+
+  if (added > mirror.num_keys || added >= LIBTOCK_IEEE802154_MIRROR_KEYS) return load_keys(0);
+  libtock_ieee802154_key_t* k = &mirror.keys[added];
+  k->level       = level;
+  k->key_id_mode = key_id_mode;
+  memset(k->key_id, 0, sizeof(k->key_id));
+  if (key_id != NULL) memcpy(k->key_id, key_id, libtock_ieee802154_key_id_bytes(key_id_mode));
+  memcpy(k->key, key, sizeof(k->key));
+  if (added == mirror.num_keys) mirror.num_keys++;
+  rebuild_keys();
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_ieee802154_mirror_remove_key(uint32_t index) {
+  returncode_t ret = libtock_ieee802154_remove_key(index);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  return load_keys(index < mirror.num_keys ? index : 0);
+}
+
+uint32_t libtock_ieee802154_mirror_num_neighbors(void) {
+  return mirror.num_neighbors;
+}
+
+uint32_t libtock_ieee802154_mirror_num_keys(void) {
+  return mirror.num_keys;
+}
+
+const libtock_ieee802154_neighbor_t* libtock_ieee802154_mirror_neighbor(uint32_t index) {
+  return index < mirror.num_neighbors ? &mirror.neighbors[index] : NULL;
+}
+
+const libtock_ieee802154_key_t* libtock_ieee802154_mirror_key(uint32_t index) {
+  return index < mirror.num_keys ? &mirror.keys[index] : NULL;
+}
+
+const libtock_ieee802154_neighbor_t* libtock_ieee802154_mirror_find_short(uint16_t addr_short, uint32_t* index) {
+  for (uint32_t s = hash_short(addr_short) % NEIGHBOR_SLOTS; mirror.by_short[s] != 0; s = (s + 1) % NEIGHBOR_SLOTS) {
+    uint32_t i = mirror.by_short[s] - 1;
+    if (mirror.neighbors[i].addr_short == addr_short) {
+      if (index != NULL) *index = i;
+      return &mirror.neighbors[i];
+    }
+  }
+  return NULL;
+}
+
+const libtock_ieee802154_neighbor_t* libtock_ieee802154_mirror_find_long(const uint8_t* addr_long, uint32_t* index) {
+  for (uint32_t s = hash_long(addr_long) % NEIGHBOR_SLOTS; mirror.by_long[s] != 0; s = (s + 1) % NEIGHBOR_SLOTS) {
+    uint32_t i = mirror.by_long[s] - 1;
+    if (memcmp(mirror.neighbors[i].addr_long, addr_long, 8) == 0) {
+      if (index != NULL) *index = i;
+      return &mirror.neighbors[i];
+    }
+  }
+  return NULL;
+}
+
+const libtock_ieee802154_key_t* libtock_ieee802154_mirror_find_key(security_level_t level, key_id_mode_t key_id_mode,
+                                                                   const uint8_t* key_id, uint32_t* index) {
+  uint8_t id[9] = { 0 };
+  if (key_id != NULL) memcpy(id, key_id, libtock_ieee802154_key_id_bytes(key_id_mode));
+
+  for (uint32_t s = hash_key_id(level, key_id_mode, id) % KEY_SLOTS; mirror.by_key_id[s] != 0;
+       s = (s + 1) % KEY_SLOTS) {
+    uint32_t i = mirror.by_key_id[s] - 1;
+    const libtock_ieee802154_key_t* k = &mirror.keys[i];
+    if (k->level == level && k->key_id_mode == key_id_mode && memcmp(k->key_id, id, sizeof(id)) == 0) {
+      if (index != NULL) *index = i;
+      return k;
+    }
+  }
+  return NULL;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "ieee802154.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Userspace copy of the kernel's 802.15.4 neighbor and key lists.
+//
+// Every `libtock_ieee802154_get_neighbor*()` and `get_key*()` call is one or
+// more syscalls, which is too slow to run per frame. The mirror reads both
+// lists once in `libtock_ieee802154_mirror_init()`, and the add and remove
+// functions here change the kernel's list and the copy together. Lookups
+// then run from memory: by index, or by address or key ID through small
+// hash tables.
+//
+// Lists the app changes with the plain `libtock_ieee802154_add_*()` and
+// `remove_*()` calls are not seen until `libtock_ieee802154_mirror_init()`
+// runs again.
+
+// Largest lists the mirror holds. `libtock_ieee802154_mirror_init()` fails if
+// the kernel supports more.
+#ifndef LIBTOCK_IEEE802154_MIRROR_NEIGHBORS
+#define LIBTOCK_IEEE802154_MIRROR_NEIGHBORS 16
+#endif
+
+#ifndef LIBTOCK_IEEE802154_MIRROR_KEYS
+#define LIBTOCK_IEEE802154_MIRROR_KEYS 8
+#endif
+
+typedef struct {
+  uint16_t addr_short;
+  uint8_t addr_long[8];
+} libtock_ieee802154_neighbor_t;
+
+typedef struct {
+  security_level_t level;
+  key_id_mode_t key_id_mode;
+  // Key ID bytes as for `libtock_ieee802154_get_key_id()`, zero past
+  // `libtock_ieee802154_key_id_bytes(key_id_mode)`.
+  uint8_t key_id[9];
+  uint8_t key[16];
+} libtock_ieee802154_key_t;
+
+// Read the kernel's neighbor and key lists.
+//
+// Returns RETURNCODE_ENOMEM if the kernel supports more neighbors or keys
+// than `LIBTOCK_IEEE802154_MIRROR_NEIGHBORS` or `LIBTOCK_IEEE802154_MIRROR_KEYS`.
+returncode_t libtock_ieee802154_mirror_init(void);
+
+// Add or remove a neighbor in the kernel's list and in the mirror. Same
+// arguments as `libtock_ieee802154_add_neighbor()` and
+// `libtock_ieee802154_remove_neighbor()`.
+returncode_t libtock_ieee802154_mirror_add_neighbor(uint16_t addr_short, const uint8_t* addr_long, uint32_t* index);
+returncode_t libtock_ieee802154_mirror_remove_neighbor(uint32_t index);
+
+// Add or remove a key in the kernel's list and in the mirror. Same arguments
+// as `libtock_ieee802154_add_key()` and `libtock_ieee802154_remove_key()`.
+returncode_t libtock_ieee802154_mirror_add_key(security_level_t level, key_id_mode_t key_id_mode,
+                                               const uint8_t* key_id, const uint8_t* key, uint32_t* index);
+returncode_t libtock_ieee802154_mirror_remove_key(uint32_t index);
+
+uint32_t libtock_ieee802154_mirror_num_neighbors(void);
+uint32_t libtock_ieee802154_mirror_num_keys(void);
+
+// The neighbor or key at `index` in the kernel's list, or NULL past the end.
+// Pointers stay valid until the list next changes.
+const libtock_ieee802154_neighbor_t* libtock_ieee802154_mirror_neighbor(uint32_t index);
+const libtock_ieee802154_key_t* libtock_ieee802154_mirror_key(uint32_t index);
+
+// Find a neighbor by its short or long address, or a key by its security
+// level and key ID. Returns NULL if there is none, and otherwise writes its
+// list index to `index` unless that is NULL.
+const libtock_ieee802154_neighbor_t* libtock_ieee802154_mirror_find_short(uint16_t addr_short, uint32_t* index);
+const libtock_ieee802154_neighbor_t* libtock_ieee802154_mirror_find_long(const uint8_t* addr_long, uint32_t* index);
+const libtock_ieee802154_key_t* libtock_ieee802154_mirror_find_key(security_level_t level, key_id_mode_t key_id_mode,
+                                                                   const uint8_t* key_id, uint32_t* index);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,148 @@
+#include "../services/alarm.h"
+#include "ieee802154_scan.h"
+
+// Frames arrive no faster than the upcalls are handled, so a small ring
+// loses few of them, and only the count and length matter here.
+#define SCAN_RING_FRAMES 4
+
+// 32 us per byte at 250 kbit/s, and 6 bytes of preamble, SFD and length
+// before the PSDU.
+#define US_PER_BYTE 32
+#define PHY_HEADER 6
+
+// The driver has one receive upcall per process, so only one scan runs at a
+// time and its state is global.
+static struct {
+  bool running;
+  uint8_t storage[libtock_ieee802154_RING_BUFFER_LEN_FOR(SCAN_RING_FRAMES)];
+  libtock_ieee802154_ring_t ring;
+  libtock_alarm_t alarm;
+  uint32_t remaining;
+  uint32_t dwell_ms;
+  uint8_t restore_channel;
+  libtock_ieee802154_scan_result_t* results;
+  int count;
+  libtock_ieee802154_callback_scan_done cb;
+} scan;
+
+static void drain(void) {
+  libtock_ieee802154_scan_result_t* r = &scan.results[scan.count];
+  uint8_t* frame;
+  while ((frame = libtock_ieee802154_ring_read_next(&scan.ring)) != NULL) {
+    // Header, payload and MIC lengths, and the FCS the driver strips.
+    uint32_t psdu = frame[0] + frame[1] + frame[2] + 2;
+    if (r->frames < UINT16_MAX) r->frames++;
+    r->busy_us += (PHY_HEADER + psdu) * US_PER_BYTE;
+  }
+}
+
+static void scan_rx_upcall(__attribute__ ((unused)) int   pans,
+                           __attribute__ ((unused)) int   dst_addr,
+                           __attribute__ ((unused)) int   src_addr,
+                           __attribute__ ((unused)) void* ud) {
+  if (!scan.running) return;
+  drain();
+  libtock_ieee802154_ring_reset(&scan.ring, scan_rx_upcall, NULL);
+}
+
+static int8_t estimate_rssi(const libtock_ieee802154_scan_result_t* r) {
+  if (r->frames == 0) return LIBTOCK_IEEE802154_SCAN_FLOOR_DBM;
+
+  uint32_t dwell_us = scan.dwell_ms * 1000;
+  uint32_t busy     = r->busy_us < dwell_us ? r->busy_us : dwell_us;
+  int32_t span      = LIBTOCK_IEEE802154_SCAN_BUSY_DBM - LIBTOCK_IEEE802154_SCAN_FLOOR_DBM;
+  int32_t rssi      = LIBTOCK_IEEE802154_SCAN_FLOOR_DBM + (int32_t) ((uint64_t) busy * span / dwell_us);
+  // Any traffic ranks above a silent channel.
+  return (int8_t) (rssi > LIBTOCK_IEEE802154_SCAN_FLOOR_DBM ? rssi : LIBTOCK_IEEE802154_SCAN_FLOOR_DBM + 1);
+}
+
+static void finish(returncode_t ret) {
+  libtock_ieee802154_ring_reset(NULL, NULL, NULL);
+  libtock_ieee802154_set_channel(scan.restore_channel);
+  libtock_ieee802154_config_commit();
+  scan.running = false;
+  scan.cb(ret, scan.count);
+}
+
+static void dwell_done(uint32_t, uint32_t, void*);
+
+// Tune to the lowest channel left in the mask and listen on it.
+static returncode_t next_channel(void) {
+  uint8_t channel = (uint8_t) __builtin_ctz(scan.remaining);
+  scan.remaining &= scan.remaining - 1;
+
+  libtock_ieee802154_scan_result_t* r = &scan.results[scan.count];
+  r->channel = channel;
+  r->frames  = 0;
+  r->busy_us = 0;
+  r->rssi    = LIBTOCK_IEEE802154_SCAN_FLOOR_DBM;
+
+  returncode_t ret = libtock_ieee802154_set_channel(channel);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_ieee802154_config_commit();
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_ieee802154_ring_reset(&scan.ring, scan_rx_upcall, NULL);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_alarm_in_ms(scan.dwell_ms, dwell_done, NULL, &scan.alarm);
+  return ret;
+}
+
+static void dwell_done(__attribute__ ((unused)) uint32_t now,
+                       __attribute__ ((unused)) uint32_t scheduled,
+                       __attribute__ ((unused)) void*    opaque) {
+  // Count what came in since the last upcall, then stop listening so the
+  // next channel starts with an empty ring.
+  drain();
+  libtock_ieee802154_ring_reset(NULL, NULL, NULL);
+  libtock_ieee802154_ring_init(&scan.ring, scan.storage, sizeof(scan.storage));
+
+  scan.results[scan.count].rssi = estimate_rssi(&scan.results[scan.count]);
+  scan.count++;
+
+  if (scan.remaining == 0) {
+    finish(RETURNCODE_SUCCESS);
+    return;
+  }
+  returncode_t ret = next_channel();
+  if (ret != RETURNCODE_SUCCESS) finish(ret);
+}
+
+returncode_t libtock_ieee802154_energy_scan(uint32_t channel_mask, uint32_t dwell_ms,
+                                            libtock_ieee802154_scan_result_t* results,
+                                            libtock_ieee802154_callback_scan_done cb) {
+  if (scan.running) return RETURNCODE_EBUSY;
+  channel_mask &= LIBTOCK_IEEE802154_CHANNEL_MASK_ALL;
+  if (channel_mask == 0 || dwell_ms == 0) return RETURNCODE_EINVAL;
+
+  bool up;
+  if (libtock_ieee802154_is_up(&up) != RETURNCODE_SUCCESS || !up) return RETURNCODE_EOFF;
+  returncode_t ret = libtock_ieee802154_get_channel(&scan.restore_channel);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtock_ieee802154_ring_init(&scan.ring, scan.storage, sizeof(scan.storage));
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  scan.remaining = channel_mask;
+  scan.dwell_ms  = dwell_ms;
+  scan.results   = results;
+  scan.count     = 0;
+  scan.cb        = cb;
+  scan.running   = true;
+
+  ret = next_channel();
+  if (ret != RETURNCODE_SUCCESS) {
+    libtock_ieee802154_ring_reset(NULL, NULL, NULL);
+    libtock_ieee802154_set_channel(scan.restore_channel);
+    libtock_ieee802154_config_commit();
+    scan.running = false;
+  }
+  return ret;
+}
+
+uint8_t libtock_ieee802154_scan_quietest(const libtock_ieee802154_scan_result_t* results, int count) {
+  if (count == 0) return 0;
+
+  const libtock_ieee802154_scan_result_t* best = &results[0];
+  for (int i = 1; i < count; i++) {
+    if (results[i].rssi < best->rssi || (results[i].rssi == best->rssi && results[i].busy_us < best->busy_us)) {
+      best = &results[i];
+    }
+  }
+  return best->channel;
+}
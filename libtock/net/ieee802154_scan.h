@@ -0,0 +1,71 @@
+#pragma once
+
+#include "ieee802154.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Channel energy scan over a mask of 802.15.4 channels, as one operation.
+//
+// The scan listens on each channel of the mask in turn for `dwell_ms`,
+// switching channels itself from alarm callbacks, and restores the channel
+// the radio was on when it is done. The app is called back once, with a
+// result for every scanned channel.
+//
+// The kernel driver has no energy detect command and reports no RSSI with
+// received frames, so a channel's energy is estimated from the frames heard
+// on it: their airtime at 250 kbit/s over the dwell time, mapped from
+// `LIBTOCK_IEEE802154_SCAN_FLOOR_DBM` for a silent channel up to
+// `LIBTOCK_IEEE802154_SCAN_BUSY_DBM` for one busy the whole time. That
+// ranks channels by traffic, which is what channel selection needs.
+//
+// The scan takes the driver's receive upcall with a ring of its own, so the
+// app's receive is stopped while it runs and must be armed again after it.
+
+#define LIBTOCK_IEEE802154_CHANNEL_MIN 11
+#define LIBTOCK_IEEE802154_CHANNEL_MAX 26
+
+// Bit `n` of a channel mask selects channel `n`, as in OpenThread.
+#define LIBTOCK_IEEE802154_CHANNEL_MASK_ALL 0x07FFF800
+
+#ifndef LIBTOCK_IEEE802154_SCAN_FLOOR_DBM
+#define LIBTOCK_IEEE802154_SCAN_FLOOR_DBM (-100)
+#endif
+
+#ifndef LIBTOCK_IEEE802154_SCAN_BUSY_DBM
+#define LIBTOCK_IEEE802154_SCAN_BUSY_DBM (-50)
+#endif
+
+typedef struct {
+  uint8_t channel;
+  // Frames heard, and their airtime.
+  uint16_t frames;
+  uint32_t busy_us;
+  // Estimated energy on the channel in dBm.
+  int8_t rssi;
+} libtock_ieee802154_scan_result_t;
+
+// Function signature for the scan callback.
+//
+// - `arg1` (`returncode_t`): Whether every channel was scanned.
+// - `arg2` (`int`): Number of results written.
+typedef void (*libtock_ieee802154_callback_scan_done)(returncode_t, int);
+
+// Scan the channels in `channel_mask` for `dwell_ms` each. `results` must
+// hold one entry per channel in the mask, and is filled in channel order.
+//
+// Returns RETURNCODE_EINVAL if the mask holds no valid channel,
+// RETURNCODE_EOFF if the radio is off, and RETURNCODE_EBUSY if a scan is
+// already running.
+returncode_t libtock_ieee802154_energy_scan(uint32_t channel_mask, uint32_t dwell_ms,
+                                            libtock_ieee802154_scan_result_t* results,
+                                            libtock_ieee802154_callback_scan_done cb);
+
+// The channel in `results` with the lowest energy, preferring the first of
+// equals. Returns 0 if `count` is 0.
+uint8_t libtock_ieee802154_scan_quietest(const libtock_ieee802154_scan_result_t* results, int count);
+
+#ifdef __cplusplus
+}
+#endif
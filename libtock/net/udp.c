@@ -2,6 +2,10 @@
 
 #include "udp.h"
 
+// Source and destination address of sent datagrams, shared with the kernel
+// while the app is bound.
+static unsigned char udp_tx_cfg[2 * sizeof(sock_addr_t)];
+
 returncode_t libtock_udp_bind(sock_handle_t* handle, sock_addr_t* addr, unsigned char* buf_bind_cfg) {
   // Pass interface to listen on and space for kernel to write src addr
   // of received packets
@@ -23,10 +27,8 @@ returncode_t libtock_udp_bind(sock_handle_t* handle, sock_addr_t* addr, unsigned
   // Notably, the pair chosen must match the address/port to which the
   // app is bound, unless the kernel changes in the future to allow for
   // sending from a port to which the app is not bound.
-  // HACK!! This is not static.
-  unsigned char BUF_TX_CFG[2 * sizeof(sock_addr_t)];
-  memcpy(BUF_TX_CFG, &(handle->addr), bytes);
-  ret = libtock_udp_set_readwrite_allow_cfg((void*) BUF_TX_CFG, 2 * bytes);
+  memcpy(udp_tx_cfg, &(handle->addr), bytes);
+  ret = libtock_udp_set_readwrite_allow_cfg((void*) udp_tx_cfg, 2 * bytes);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
   return libtock_udp_command_bind();
@@ -65,19 +67,34 @@ static void udp_send_done_upcall(int                          status,
 returncode_t libtock_udp_send(void* buf, size_t len,
                               sock_addr_t* dst_addr, libtock_udp_callback_send_done cb) {
   returncode_t ret;
-  unsigned char BUF_TX_CFG[2 * sizeof(sock_addr_t)];
 
   // Set dest addr
   // NOTE: bind() must be called previously for this to work
   // If bind() has not been called, command(COMMAND_SEND) will return RESERVE
   int bytes = sizeof(sock_addr_t);
-  memcpy(BUF_TX_CFG + bytes, dst_addr, bytes);
+  memcpy(udp_tx_cfg + bytes, dst_addr, bytes);
+  ret = libtock_udp_set_readwrite_allow_cfg((void*) udp_tx_cfg, 2 * bytes);
+  if (ret != RETURNCODE_SUCCESS) return ret;
 
   // Set message buffer
   ret = libtock_udp_set_readonly_allow(buf, len);
   if (ret != RETURNCODE_SUCCESS) return ret;
 
-  return libtock_udp_set_upcall_frame_transmitted(udp_send_done_upcall, cb);
+  ret = libtock_udp_set_upcall_frame_transmitted(udp_send_done_upcall, cb);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  return libtock_udp_command_send();
+}
+
+returncode_t libtock_udp_sendv(const libtock_udp_iovec_t* iov, int iovcnt, uint8_t* scratch, size_t scratch_len,
+                               sock_addr_t* dst_addr, libtock_udp_callback_send_done cb) {
+  size_t len = 0;
+  for (int i = 0; i < iovcnt; i++) {
+    if (iov[i].len > scratch_len - len) return RETURNCODE_ESIZE;
+    memcpy(scratch + len, iov[i].buf, iov[i].len);
+    len += iov[i].len;
+  }
+  return libtock_udp_send(scratch, len, dst_addr, cb);
 }
 
 static void udp_recv_done_upcall(int                          length,
@@ -59,6 +59,19 @@ returncode_t libtock_udp_recv(void* buf, size_t len, libtock_udp_callback_recv_d
 returncode_t libtock_udp_send(void* buf, size_t len,
                               sock_addr_t* dst_addr, libtock_udp_callback_send_done cb);
 
+// One piece of a datagram sent with `libtock_udp_sendv()`.
+typedef struct {
+  const void* buf;
+  size_t len;
+} libtock_udp_iovec_t;
+
+// Sends the concatenation of `iovcnt` pieces as one datagram, like
+// `libtock_udp_send()`. The kernel only takes a single buffer, so the pieces
+// are gathered into `scratch`, which must stay valid until the callback.
+// Returns RETURNCODE_ESIZE if they do not fit in `scratch_len` bytes.
+returncode_t libtock_udp_sendv(const libtock_udp_iovec_t* iov, int iovcnt, uint8_t* scratch, size_t scratch_len,
+                               sock_addr_t* dst_addr, libtock_udp_callback_send_done cb);
+
 // Lists `len` interfaces at the array pointed to by `ifaces`.
 // Returns the _total_ number of interfaces, negative on failure.
 returncode_t libtock_udp_list_ifaces(ipv6_addr_t* ifaces, size_t len);
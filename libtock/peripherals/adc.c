@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "adc.h"
 
 
@@ -26,6 +28,7 @@ static void adc_routing_upcall(int   callback_type,
   libtock_adc_callbacks* callbacks = (libtock_adc_callbacks*) opaque;
 
   switch (callback_type) {
+#if LIBTOCK_ENABLE_ADC_SINGLE_SAMPLE
     case libtock_adc_SingleSample:
       if (callbacks->single_sample_callback) {
         uint8_t channel = (uint8_t)arg1;
@@ -33,7 +36,9 @@ static void adc_routing_upcall(int   callback_type,
         callbacks->single_sample_callback(channel, sample);
       }
       break;
+#endif
 
+#if LIBTOCK_ENABLE_ADC_CONTINUOUS_SAMPLE
     case libtock_adc_ContinuousSample:
       if (callbacks->continuous_sample_callback) {
         uint8_t channel = (uint8_t)arg1;
@@ -41,7 +46,9 @@ static void adc_routing_upcall(int   callback_type,
         callbacks->continuous_sample_callback(channel, sample);
       }
       break;
+#endif
 
+#if LIBTOCK_ENABLE_ADC_BUFFERED_SAMPLE
     case libtock_adc_SingleBuffer:
       if (callbacks->buffered_sample_callback) {
         uint8_t channel  = (uint8_t)(arg1 & 0xFF);
@@ -50,7 +57,9 @@ static void adc_routing_upcall(int   callback_type,
         callbacks->buffered_sample_callback(channel, length, buffer);
       }
       break;
+#endif
 
+#if LIBTOCK_ENABLE_ADC_CONTINUOUS_BUFFERED_SAMPLE
     case libtock_adc_ContinuousBuffer:
       if (callbacks->continuous_buffered_sample_callback) {
         uint8_t channel  = (uint8_t)(arg1 & 0xFF);
@@ -59,6 +68,7 @@ static void adc_routing_upcall(int   callback_type,
         callbacks->continuous_buffered_sample_callback(channel, length, buffer);
       }
       break;
+#endif
   }
 }
 
@@ -73,22 +83,33 @@ returncode_t libtock_adc_set_double_buffer(uint16_t* buffer, uint32_t length) {
 }
 
 returncode_t libtock_adc_channel_count(int* count) {
-  return libtock_adc_command_channel_count(count);
+  // The number of channels cannot change while the process runs.
+  static int cached = -1;
+  if (cached < 0) {
+    returncode_t ret = libtock_adc_command_channel_count(count);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    cached = *count;
+  }
+  *count = cached;
+  return RETURNCODE_SUCCESS;
 }
 
 returncode_t libtock_adc_single_sample(uint8_t channel, libtock_adc_callbacks* callbacks) {
+  if (!LIBTOCK_ENABLE_ADC_SINGLE_SAMPLE) return RETURNCODE_ENOSUPPORT;
   returncode_t ret = libtock_adc_set_upcall(adc_routing_upcall, callbacks);
   if (ret != RETURNCODE_SUCCESS) return ret;
   return libtock_adc_command_single_sample(channel);
 }
 
 returncode_t libtock_adc_continuous_sample(uint8_t channel, uint32_t frequency, libtock_adc_callbacks* callbacks) {
+  if (!LIBTOCK_ENABLE_ADC_CONTINUOUS_SAMPLE) return RETURNCODE_ENOSUPPORT;
   returncode_t ret = libtock_adc_set_upcall(adc_routing_upcall, callbacks);
   if (ret != RETURNCODE_SUCCESS) return ret;
   return libtock_adc_command_continuous_sample(channel, frequency);
 }
 
 returncode_t libtock_adc_buffered_sample(uint8_t channel, uint32_t frequency, libtock_adc_callbacks* callbacks) {
+  if (!LIBTOCK_ENABLE_ADC_BUFFERED_SAMPLE) return RETURNCODE_ENOSUPPORT;
   returncode_t ret = libtock_adc_set_upcall(adc_routing_upcall, callbacks);
   if (ret != RETURNCODE_SUCCESS) return ret;
   return libtock_adc_command_buffered_sample(channel, frequency);
@@ -96,6 +117,7 @@ returncode_t libtock_adc_buffered_sample(uint8_t channel, uint32_t frequency, li
 
 returncode_t libtock_adc_continuous_buffered_sample(uint8_t channel, uint32_t frequency,
                                                     libtock_adc_callbacks* callbacks) {
+  if (!LIBTOCK_ENABLE_ADC_CONTINUOUS_BUFFERED_SAMPLE) return RETURNCODE_ENOSUPPORT;
   returncode_t ret = libtock_adc_set_upcall(adc_routing_upcall, callbacks);
   if (ret != RETURNCODE_SUCCESS) return ret;
   return libtock_adc_command_continuous_buffered_sample(channel, frequency);
@@ -104,3 +126,439 @@ returncode_t libtock_adc_continuous_buffered_sample(uint8_t channel, uint32_t fr
 returncode_t libtock_adc_stop_sampling(void) {
   return libtock_adc_command_stop_sampling();
 }
+
+// ***** Buffer Ring *****
+
+enum ring_state {
+  RING_FREE,
+  RING_DRIVER,
+  RING_READY,
+  RING_APP,
+};
+
+static uint16_t* ring_buffer(libtock_adc_ring_t* ring, uint8_t i) {
+  return ring->buffers + (uint32_t) i * ring->length;
+}
+
+// Number of the buffer at `buffer`, or `ring->count` if it is not one.
+static uint8_t ring_index(libtock_adc_ring_t* ring, const uint16_t* buffer) {
+  if (buffer < ring->buffers) return ring->count;
+  uint32_t offset = (uint32_t) (buffer - ring->buffers);
+  if (offset % ring->length != 0 || offset / ring->length >= ring->count) return ring->count;
+  return (uint8_t) (offset / ring->length);
+}
+
+static returncode_t ring_allow(libtock_adc_ring_t* ring, uint8_t slot, uint8_t i) {
+  ring->state[i]   = RING_DRIVER;
+  ring->slot[slot] = i;
+  if (slot == 0) {
+    return libtock_adc_set_buffer(ring_buffer(ring, i), ring->length);
+  }
+  return libtock_adc_set_double_buffer(ring_buffer(ring, i), ring->length);
+}
+
+static uint8_t ring_pop(libtock_adc_ring_t* ring) {
+  uint8_t i = ring->ready[ring->ready_head];
+  ring->ready_head = (uint8_t) ((ring->ready_head + 1) % ring->count);
+  ring->ready_count--;
+  return i;
+}
+
+static void adc_ring_upcall(int   callback_type,
+                            int   arg1,
+                            int   arg2,
+                            void* opaque) {
+  libtock_adc_ring_t* ring = (libtock_adc_ring_t*) opaque;
+  if (callback_type != libtock_adc_ContinuousBuffer) return;
+
+  uint8_t i = ring_index(ring, (uint16_t*) arg2);
+  if (i >= ring->count || ring->state[i] != RING_DRIVER) return;
+  uint8_t slot = ring->slot[0] == i ? 0 : 1;
+
+  ring->state[i]  = RING_READY;
+  ring->filled[i] = ((uint32_t) arg1 >> 8) & 0xFFFFFF;
+  ring->ready[(ring->ready_head + ring->ready_count) % ring->count] = i;
+  ring->ready_count++;
+
+  // Refill the slot the driver just gave back, preferring a free buffer over
+  // dropping the oldest unread one.
+  uint8_t next = ring->count;
+  for (uint8_t j = 0; j < ring->count; j++) {
+    if (ring->state[j] == RING_FREE) {
+      next = j;
+      break;
+    }
+  }
+  if (next == ring->count) {
+    next = ring_pop(ring);
+    ring->overruns++;
+  }
+  ring_allow(ring, slot, next);
+
+  if (ring->cb && ring->ready_count > 0) {
+    ring->cb(ring->opaque);
+  }
+}
+
+returncode_t libtock_adc_ring_start(libtock_adc_ring_t* ring, uint8_t channel, uint32_t frequency,
+                                    uint16_t* buffers, uint8_t count, uint32_t length,
+                                    libtock_adc_ring_callback cb, void* opaque) {
+  if (count < 3 || count > LIBTOCK_ADC_RING_MAX || buffers == NULL || length == 0) return RETURNCODE_EINVAL;
+
+  ring->buffers     = buffers;
+  ring->length      = length;
+  ring->count       = count;
+  ring->channel     = channel;
+  ring->ready_head  = 0;
+  ring->ready_count = 0;
+  ring->overruns    = 0;
+  ring->cb          = cb;
+  ring->opaque      = opaque;
+  for (uint8_t i = 0; i < count; i++) {
+    ring->state[i] = RING_FREE;
+  }
+
+  returncode_t ret = ring_allow(ring, 0, 0);
+  if (ret == RETURNCODE_SUCCESS) ret = ring_allow(ring, 1, 1);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_adc_set_upcall(adc_ring_upcall, ring);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_adc_command_continuous_buffered_sample(channel, frequency);
+  if (ret != RETURNCODE_SUCCESS) {
+    libtock_adc_set_buffer(NULL, 0);
+    libtock_adc_set_double_buffer(NULL, 0);
+  }
+  return ret;
+}
+
+uint16_t* libtock_adc_ring_acquire(libtock_adc_ring_t* ring, uint32_t* length) {
+  if (ring->ready_count == 0) return NULL;
+
+  uint8_t i = ring_pop(ring);
+  ring->state[i] = RING_APP;
+  *length        = ring->filled[i];
+  return ring_buffer(ring, i);
+}
+
+returncode_t libtock_adc_ring_release(libtock_adc_ring_t* ring, uint16_t* buffer) {
+  uint8_t i = ring_index(ring, buffer);
+  if (i >= ring->count || ring->state[i] != RING_APP) return RETURNCODE_EINVAL;
+
+  ring->state[i] = RING_FREE;
+  return RETURNCODE_SUCCESS;
+}
+
+uint32_t libtock_adc_ring_pending(const libtock_adc_ring_t* ring) {
+  return ring->ready_count;
+}
+
+uint32_t libtock_adc_ring_overruns(const libtock_adc_ring_t* ring) {
+  return ring->overruns;
+}
+
+returncode_t libtock_adc_ring_stop(libtock_adc_ring_t* ring) {
+  returncode_t ret = libtock_adc_command_stop_sampling();
+  libtock_adc_set_buffer(NULL, 0);
+  libtock_adc_set_double_buffer(NULL, 0);
+  for (uint8_t i = 0; i < ring->count; i++) {
+    if (ring->state[i] == RING_DRIVER) ring->state[i] = RING_FREE;
+  }
+  return ret;
+}
+
+// ***** Channel Scan *****
+
+static void adc_scan_upcall(int                          callback_type,
+                            __attribute__ ((unused)) int arg1,
+                            int                          arg2,
+                            void*                        opaque) {
+  libtock_adc_scan_t* scan = (libtock_adc_scan_t*) opaque;
+  if (callback_type != libtock_adc_SingleSample || scan->index >= scan->total) return;
+
+  scan->samples[scan->index++] = (uint16_t) arg2;
+
+  returncode_t ret = RETURNCODE_SUCCESS;
+  if (scan->index < scan->total) {
+    ret = libtock_adc_command_single_sample(scan->channels[scan->index % scan->channel_count]);
+    if (ret == RETURNCODE_SUCCESS) return;
+  }
+  scan->cb(ret, scan->index / scan->channel_count, scan->opaque);
+}
+
+returncode_t libtock_adc_scan(libtock_adc_scan_t* scan, const uint8_t* channels, uint8_t channel_count,
+                              uint16_t* samples, uint32_t passes,
+                              libtock_adc_scan_callback cb, void* opaque) {
+  if (channel_count == 0 || passes == 0) return RETURNCODE_EINVAL;
+
+  scan->channels      = channels;
+  scan->channel_count = channel_count;
+  scan->samples       = samples;
+  scan->total         = passes * channel_count;
+  scan->index         = 0;
+  scan->cb            = cb;
+  scan->opaque        = opaque;
+
+  returncode_t ret = libtock_adc_set_upcall(adc_scan_upcall, scan);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  return libtock_adc_command_single_sample(channels[0]);
+}
+
+// ***** Averaged Sample *****
+
+static void average_add(libtock_adc_average_t* avg, uint16_t sample) {
+  libtock_adc_stats_t* stats = &avg->stats;
+  if (stats->samples == 0 || sample < stats->min) stats->min = sample;
+  if (stats->samples == 0 || sample > stats->max) stats->max = sample;
+  stats->samples++;
+  stats->sum       += sample;
+  avg->sum_squares += (uint32_t) sample * sample;
+}
+
+static void average_finish(libtock_adc_average_t* avg, returncode_t ret) {
+  libtock_adc_stats_t* stats = &avg->stats;
+  if (stats->samples > 0) {
+    uint64_t n = stats->samples;
+    stats->mean = (uint16_t) ((stats->sum + n / 2) / n);
+    // n * sum of squares - sum^2 cannot overflow for n up to
+    // LIBTOCK_ADC_AVERAGE_MAX 16-bit samples.
+    stats->variance = (uint32_t) ((n * avg->sum_squares - (uint64_t) stats->sum * stats->sum) / (n * n));
+  }
+  avg->cb(ret, stats, avg->opaque);
+}
+
+// Start the next capture, or the next single sample.
+static returncode_t average_next(libtock_adc_average_t* avg) {
+  if (avg->single) return libtock_adc_command_single_sample(avg->channel);
+
+  uint32_t len     = avg->remaining < avg->buffer_len ? avg->remaining : avg->buffer_len;
+  returncode_t ret = libtock_adc_set_buffer(avg->buffer, len);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  return libtock_adc_command_buffered_sample(avg->channel, avg->frequency);
+}
+
+static void adc_average_upcall(int   callback_type,
+                               int   arg1,
+                               int   arg2,
+                               void* opaque) {
+  libtock_adc_average_t* avg = (libtock_adc_average_t*) opaque;
+  if (avg->remaining == 0) return;
+
+  if (callback_type == libtock_adc_SingleSample && avg->single) {
+    average_add(avg, (uint16_t) arg2);
+    avg->remaining--;
+  } else if (callback_type == libtock_adc_SingleBuffer && !avg->single) {
+    uint32_t length = ((uint32_t) arg1 >> 8) & 0xFFFFFF;
+    if (length > avg->remaining) length = avg->remaining;
+    for (uint32_t i = 0; i < length; i++) {
+      average_add(avg, avg->buffer[i]);
+    }
+    avg->remaining -= length;
+  } else {
+    return;
+  }
+
+  returncode_t ret = RETURNCODE_SUCCESS;
+  if (avg->remaining > 0) {
+    ret = average_next(avg);
+    if (ret == RETURNCODE_SUCCESS) return;
+  }
+  if (!avg->single) libtock_adc_set_buffer(NULL, 0);
+  avg->remaining = 0;
+  average_finish(avg, ret);
+}
+
+returncode_t libtock_adc_sample_averaged(libtock_adc_average_t* avg, uint8_t channel, uint32_t samples,
+                                         uint32_t frequency, uint16_t* buffer, uint32_t buffer_len,
+                                         libtock_adc_average_callback cb, void* opaque) {
+  if (samples == 0 || samples > LIBTOCK_ADC_AVERAGE_MAX) return RETURNCODE_EINVAL;
+
+  memset(&avg->stats, 0, sizeof(avg->stats));
+  avg->channel     = channel;
+  avg->frequency   = frequency;
+  avg->buffer      = buffer;
+  avg->buffer_len  = buffer_len;
+  avg->remaining   = samples;
+  avg->single      = buffer == NULL || buffer_len == 0 || !LIBTOCK_ENABLE_ADC_BUFFERED_SAMPLE;
+  avg->sum_squares = 0;
+  avg->cb          = cb;
+  avg->opaque      = opaque;
+
+  returncode_t ret = libtock_adc_set_upcall(adc_average_upcall, avg);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = average_next(avg);
+  if (ret != RETURNCODE_SUCCESS && !avg->single) {
+    // The driver cannot capture buffers, or not at this rate.
+    libtock_adc_set_buffer(NULL, 0);
+    avg->single = true;
+    ret         = average_next(avg);
+  }
+  if (ret != RETURNCODE_SUCCESS) avg->remaining = 0;
+  return ret;
+}
+
+
+
+// ***** Triggered Capture *****
+
+static bool trigger_hit(libtock_adc_trigger_t* trigger, uint16_t sample) {
+  bool above = sample >= trigger->threshold;
+  bool below = sample <= trigger->threshold;
+  switch (trigger->mode) {
+    case LIBTOCK_ADC_TRIGGER_ABOVE:
+      return above;
+    case LIBTOCK_ADC_TRIGGER_BELOW:
+      return below;
+    case LIBTOCK_ADC_TRIGGER_RISING:
+      return above && trigger->have_last && trigger->last < trigger->threshold;
+    case LIBTOCK_ADC_TRIGGER_FALLING:
+      return below && trigger->have_last && trigger->last > trigger->threshold;
+  }
+  return false;
+}
+
+static void trigger_release_held(libtock_adc_trigger_t* trigger) {
+  for (uint8_t h = 0; h < trigger->held_count; h++) {
+    libtock_adc_ring_release(&trigger->ring, trigger->held[h]);
+  }
+  trigger->held_count   = 0;
+  trigger->held_samples = 0;
+}
+
+static void trigger_finish(libtock_adc_trigger_t* trigger, returncode_t ret) {
+  libtock_adc_ring_stop(&trigger->ring);
+  trigger_release_held(trigger);
+  trigger->running = false;
+  trigger->cb(ret, trigger->stored, trigger->trigger_index, trigger->opaque);
+}
+
+// Keep `buffer` as history, and give back the oldest held buffers that are
+// no longer needed to cover `pre` samples.
+static void trigger_hold(libtock_adc_trigger_t* trigger, uint16_t* buffer, uint32_t length) {
+  trigger->held[trigger->held_count]     = buffer;
+  trigger->held_len[trigger->held_count] = length;
+  trigger->held_count++;
+  trigger->held_samples += length;
+
+  uint8_t drop = 0;
+  while (trigger->held_count - drop > 1 && trigger->held_samples - trigger->held_len[drop] >= trigger->pre) {
+    libtock_adc_ring_release(&trigger->ring, trigger->held[drop]);
+    trigger->held_samples -= trigger->held_len[drop];
+    drop++;
+  }
+  if (drop > 0) {
+    trigger->held_count -= drop;
+    memmove(trigger->held, trigger->held + drop, trigger->held_count * sizeof(trigger->held[0]));
+    memmove(trigger->held_len, trigger->held_len + drop, trigger->held_count * sizeof(trigger->held_len[0]));
+  }
+}
+
+// Copy the samples before `buffer[index]` into the front of the window,
+// newest last.
+static void trigger_store_history(libtock_adc_trigger_t* trigger, const uint16_t* buffer, uint32_t index) {
+  uint32_t total = trigger->held_samples + index;
+  uint32_t n     = total < trigger->pre ? total : trigger->pre;
+  trigger->trigger_index = n;
+
+  uint32_t take = index < n ? index : n;
+  memcpy(trigger->window + n - take, buffer + index - take, take * sizeof(uint16_t));
+  n -= take;
+  for (uint8_t h = trigger->held_count; h > 0 && n > 0; h--) {
+    uint32_t len = trigger->held_len[h - 1];
+    take = len < n ? len : n;
+    memcpy(trigger->window + n - take, trigger->held[h - 1] + len - take, take * sizeof(uint16_t));
+    n -= take;
+  }
+  trigger_release_held(trigger);
+  trigger->stored = trigger->trigger_index;
+}
+
+// Returns true once the window is full.
+static bool trigger_store(libtock_adc_trigger_t* trigger, const uint16_t* samples, uint32_t length) {
+  uint32_t end  = trigger->trigger_index + trigger->post;
+  uint32_t take = end - trigger->stored < length ? end - trigger->stored : length;
+  memcpy(trigger->window + trigger->stored, samples, take * sizeof(uint16_t));
+  trigger->stored += take;
+  return trigger->stored == end;
+}
+
+static void trigger_buffer(libtock_adc_trigger_t* trigger, uint16_t* buffer, uint32_t length) {
+  uint32_t start = 0;
+  if (!trigger->triggered) {
+    uint32_t i = 0;
+    for ( ; i < length; i++) {
+      if (trigger_hit(trigger, buffer[i])) break;
+      trigger->last      = buffer[i];
+      trigger->have_last = true;
+    }
+    if (i == length) {
+      trigger_hold(trigger, buffer, length);
+      return;
+    }
+    trigger_store_history(trigger, buffer, i);
+    trigger->triggered = true;
+    start = i;
+  }
+
+  bool full = trigger_store(trigger, buffer + start, length - start);
+  libtock_adc_ring_release(&trigger->ring, buffer);
+  if (full) trigger_finish(trigger, RETURNCODE_SUCCESS);
+}
+
+static void adc_trigger_ring_cb(void* opaque) {
+  libtock_adc_trigger_t* trigger = (libtock_adc_trigger_t*) opaque;
+
+  uint16_t* buffer;
+  uint32_t length;
+  while (trigger->running && (buffer = libtock_adc_ring_acquire(&trigger->ring, &length)) != NULL) {
+    uint32_t overruns = libtock_adc_ring_overruns(&trigger->ring);
+    if (overruns != trigger->overruns) {
+      trigger->overruns = overruns;
+      if (trigger->triggered) {
+        libtock_adc_ring_release(&trigger->ring, buffer);
+        trigger_finish(trigger, RETURNCODE_FAIL);
+        return;
+      }
+      // Samples are missing before this buffer, so the history starts over.
+      trigger_release_held(trigger);
+      trigger->have_last = false;
+    }
+    trigger_buffer(trigger, buffer, length);
+  }
+}
+
+returncode_t libtock_adc_trigger_start(libtock_adc_trigger_t* trigger, uint8_t channel, uint32_t frequency,
+                                       uint16_t* buffers, uint8_t count, uint32_t length,
+                                       libtock_adc_trigger_mode_t mode, uint16_t threshold,
+                                       uint16_t* window, uint32_t pre, uint32_t post,
+                                       libtock_adc_trigger_callback cb, void* opaque) {
+  if (post == 0 || window == NULL || length == 0 || count < pre / length + 4) return RETURNCODE_EINVAL;
+
+  trigger->mode          = mode;
+  trigger->threshold     = threshold;
+  trigger->window        = window;
+  trigger->pre           = pre;
+  trigger->post          = post;
+  trigger->held_count    = 0;
+  trigger->held_samples  = 0;
+  trigger->have_last     = false;
+  trigger->overruns      = 0;
+  trigger->triggered     = false;
+  trigger->stored        = 0;
+  trigger->trigger_index = 0;
+  trigger->cb            = cb;
+  trigger->opaque        = opaque;
+  trigger->running       = true;
+
+  returncode_t ret = libtock_adc_ring_start(&trigger->ring, channel, frequency, buffers, count, length,
+                                            adc_trigger_ring_cb, trigger);
+  if (ret != RETURNCODE_SUCCESS) trigger->running = false;
+  return ret;
+}
+
+returncode_t libtock_adc_trigger_stop(libtock_adc_trigger_t* trigger) {
+  if (!trigger->running) return RETURNCODE_EALREADY;
+
+  returncode_t ret = libtock_adc_ring_stop(&trigger->ring);
+  trigger_release_held(trigger);
+  trigger->running = false;
+  return ret;
+}
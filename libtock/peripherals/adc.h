@@ -80,7 +80,8 @@ returncode_t libtock_adc_set_double_buffer(uint16_t* buffer, uint32_t length);
 
 
 
-// query how many channels are available in the ADC driver
+// query how many channels are available in the ADC driver, read from the
+// kernel once and then cached
 returncode_t libtock_adc_channel_count(int* count);
 
 // request a single analog sample
@@ -116,6 +117,279 @@ returncode_t libtock_adc_stop_sampling(void);
 
 
 
+// ***** Buffer Ring *****
+
+// Continuous sampling into a ring of N buffers.
+//
+// The driver only holds two buffers at a time, so a consumer that falls more
+// than one buffer period behind loses samples with
+// `libtock_adc_continuous_buffered_sample()`. The ring keeps the driver busy
+// with free buffers and queues filled ones until the app acquires them. The
+// app reads the samples in place and releases the buffer when done. If the
+// app falls so far behind that no buffer is free, the oldest filled buffer is
+// handed back to the driver and counted as an overrun.
+//
+// Buffers are swapped when the driver reports a full one, so the app must
+// yield at least once per buffer period while the ring runs.
+
+#ifndef LIBTOCK_ADC_RING_MAX
+#define LIBTOCK_ADC_RING_MAX 16
+#endif
+
+// Function signature for the ring callback, called during a yield whenever a
+// buffer has been filled.
+//
+// - `arg1` (`void*`): The opaque pointer passed to `libtock_adc_ring_start()`.
+typedef void (*libtock_adc_ring_callback)(void*);
+
+typedef struct {
+  uint16_t* buffers;
+  uint32_t length;
+  uint8_t count;
+  uint8_t channel;
+  // Owner of each buffer.
+  uint8_t state[LIBTOCK_ADC_RING_MAX];
+  // Samples in each filled buffer.
+  uint32_t filled[LIBTOCK_ADC_RING_MAX];
+  // Filled buffers, oldest first.
+  uint8_t ready[LIBTOCK_ADC_RING_MAX];
+  uint8_t ready_head;
+  uint8_t ready_count;
+  // Buffer held in each of the two driver slots.
+  uint8_t slot[2];
+  uint32_t overruns;
+  libtock_adc_ring_callback cb;
+  void* opaque;
+} libtock_adc_ring_t;
+
+// Start sampling `channel` at `frequency` into `count` buffers of `length`
+// samples each, stored back to back in `buffers`. `cb` may be NULL if the app
+// polls with `libtock_adc_ring_acquire()`.
+//
+// Returns RETURNCODE_EINVAL if `count` is below 3 or above
+// `LIBTOCK_ADC_RING_MAX`, as two buffers are no better than the plain double
+// buffer.
+returncode_t libtock_adc_ring_start(libtock_adc_ring_t* ring, uint8_t channel, uint32_t frequency,
+                                    uint16_t* buffers, uint8_t count, uint32_t length,
+                                    libtock_adc_ring_callback cb, void* opaque);
+
+// Take the oldest filled buffer and store its number of samples in `*length`.
+// The buffer belongs to the app until `libtock_adc_ring_release()`.
+//
+// Returns NULL if no buffer is filled.
+uint16_t* libtock_adc_ring_acquire(libtock_adc_ring_t* ring, uint32_t* length);
+
+// Give a buffer from `libtock_adc_ring_acquire()` back to the ring.
+//
+// Returns RETURNCODE_EINVAL if the app does not hold `buffer`.
+returncode_t libtock_adc_ring_release(libtock_adc_ring_t* ring, uint16_t* buffer);
+
+// Number of filled buffers waiting to be acquired.
+uint32_t libtock_adc_ring_pending(const libtock_adc_ring_t* ring);
+
+// Number of filled buffers dropped because the app did not release buffers in
+// time.
+uint32_t libtock_adc_ring_overruns(const libtock_adc_ring_t* ring);
+
+// Stop sampling and take the buffers back from the driver. Filled buffers can
+// still be acquired afterwards.
+returncode_t libtock_adc_ring_stop(libtock_adc_ring_t* ring);
+
+
+
+// ***** Channel Scan *****
+
+// Sample a list of channels into one interleaved buffer.
+//
+// The driver samples one channel per operation, so the scan issues the next
+// sample straight from the upcall of the previous one. The samples of a scan
+// are taken back to back without a round trip through the app, and the app
+// is called once when the whole sequence is done. For periodic scans, start a
+// scan of one pass from an alarm callback.
+
+// Function signature for the scan callback.
+//
+// - `arg1` (`returncode_t`): Status of the scan.
+// - `arg2` (`uint32_t`): Number of complete passes stored.
+// - `arg3` (`void*`): The opaque pointer passed to `libtock_adc_scan()`.
+typedef void (*libtock_adc_scan_callback)(returncode_t, uint32_t, void*);
+
+typedef struct {
+  const uint8_t* channels;
+  uint8_t channel_count;
+  uint16_t* samples;
+  uint32_t total;
+  // Next sample to store.
+  uint32_t index;
+  libtock_adc_scan_callback cb;
+  void* opaque;
+} libtock_adc_scan_t;
+
+// Sample the `channel_count` channels in `channels`, in order, `passes` times.
+// Sample `i` of pass `p` is stored at `samples[p * channel_count + i]`, so
+// `samples` must hold `passes * channel_count` values. `channels` and
+// `samples` must stay valid until `cb` is called.
+//
+// Returns RETURNCODE_EINVAL if there is nothing to sample.
+returncode_t libtock_adc_scan(libtock_adc_scan_t* scan, const uint8_t* channels, uint8_t channel_count,
+                              uint16_t* samples, uint32_t passes,
+                              libtock_adc_scan_callback cb, void* opaque);
+
+
+
+
+
+// ***** Averaged Sample *****
+
+// Take many samples of one channel and report their statistics once.
+//
+// The driver has no oversampling mode, so the samples come from buffered
+// captures of up to `buffer_len` samples each, issued back to back from the
+// upcalls. Without a buffer, or if the driver cannot capture buffers, each
+// sample is a single sample started from the upcall of the previous one, as
+// in the channel scan. Either way the app is called once, with the mean and
+// variance computed as the samples arrive.
+
+// Most samples one average can take, which keeps the sums in range.
+#define LIBTOCK_ADC_AVERAGE_MAX 65535
+
+typedef struct {
+  uint32_t samples;
+  // Sum of the samples; `sum / samples` with more resolution than `mean`.
+  uint32_t sum;
+  // Mean rounded to the nearest step.
+  uint16_t mean;
+  uint16_t min;
+  uint16_t max;
+  // Population variance in steps squared.
+  uint32_t variance;
+} libtock_adc_stats_t;
+
+// Function signature for the averaged sample callback.
+//
+// - `arg1` (`returncode_t`): Status of the sampling.
+// - `arg2` (`const libtock_adc_stats_t*`): Statistics of the samples taken.
+// - `arg3` (`void*`): The opaque pointer passed to
+//   `libtock_adc_sample_averaged()`.
+typedef void (*libtock_adc_average_callback)(returncode_t, const libtock_adc_stats_t*, void*);
+
+typedef struct {
+  uint8_t channel;
+  uint32_t frequency;
+  uint16_t* buffer;
+  uint32_t buffer_len;
+  // Samples still to take, and whether they are taken one at a time.
+  uint32_t remaining;
+  bool single;
+  uint64_t sum_squares;
+  libtock_adc_stats_t stats;
+  libtock_adc_average_callback cb;
+  void* opaque;
+} libtock_adc_average_t;
+
+// Sample `channel` `samples` times and call `cb` with the statistics.
+// Buffered captures run at `frequency` into `buffer`, which holds
+// `buffer_len` samples and may be NULL to take single samples. `avg` and
+// `buffer` must stay valid until `cb` is called.
+//
+// Returns RETURNCODE_EINVAL if `samples` is 0 or above
+// `LIBTOCK_ADC_AVERAGE_MAX`.
+returncode_t libtock_adc_sample_averaged(libtock_adc_average_t* avg, uint8_t channel, uint32_t samples,
+                                         uint32_t frequency, uint16_t* buffer, uint32_t buffer_len,
+                                         libtock_adc_average_callback cb, void* opaque);
+
+
+
+// ***** Triggered Capture *****
+
+// Capture a window of samples around a trigger on one channel.
+//
+// The driver has no trigger logic, so the capture runs a buffer ring
+// (above) and checks each filled buffer for the trigger as it arrives.
+// Until the trigger, filled buffers are only held back, enough of them to
+// cover the pre-trigger history, and handed back to the driver unread once
+// they are older than that. Nothing is copied until the trigger fires; then
+// the history before it and the samples after it are copied once into the
+// app's window and the app is called with the window, and sampling stops.
+// Start the capture again to re-arm it.
+
+typedef enum {
+  // The first sample at or above the threshold.
+  LIBTOCK_ADC_TRIGGER_ABOVE,
+  // The first sample at or below the threshold.
+  LIBTOCK_ADC_TRIGGER_BELOW,
+  // A sample at or above the threshold after one below it.
+  LIBTOCK_ADC_TRIGGER_RISING,
+  // A sample at or below the threshold after one above it.
+  LIBTOCK_ADC_TRIGGER_FALLING,
+} libtock_adc_trigger_mode_t;
+
+// Function signature for the trigger callback.
+//
+// - `arg1` (`returncode_t`): Status of the capture.
+// - `arg2` (`uint32_t`): Number of samples in the window.
+// - `arg3` (`uint32_t`): Index of the trigger sample in the window, which is
+//   also the number of samples before it. Below `pre` if the trigger came
+//   before that much history was sampled.
+// - `arg4` (`void*`): The opaque pointer passed to
+//   `libtock_adc_trigger_start()`.
+typedef void (*libtock_adc_trigger_callback)(returncode_t, uint32_t, uint32_t, void*);
+
+typedef struct {
+  libtock_adc_ring_t ring;
+  libtock_adc_trigger_mode_t mode;
+  uint16_t threshold;
+  uint16_t* window;
+  uint32_t pre;
+  uint32_t post;
+  // Buffers held back as history, oldest first, and the samples in them.
+  uint16_t* held[LIBTOCK_ADC_RING_MAX];
+  uint32_t held_len[LIBTOCK_ADC_RING_MAX];
+  uint8_t held_count;
+  uint32_t held_samples;
+  // Previous sample, for the edge modes.
+  uint16_t last;
+  bool have_last;
+  // Ring overruns seen so far; one breaks the history.
+  uint32_t overruns;
+  bool running;
+  // Samples stored in the window once triggered.
+  bool triggered;
+  uint32_t stored;
+  uint32_t trigger_index;
+  libtock_adc_trigger_callback cb;
+  void* opaque;
+} libtock_adc_trigger_t;
+
+// Sample `channel` at `frequency` through `count` buffers of `length`
+// samples each, stored back to back in `buffers` as for
+// `libtock_adc_ring_start()`, until the trigger fires. Then store up to
+// `pre` samples before the trigger sample, the trigger sample and the
+// `post - 1` samples after it in `window`, which must hold `pre + post`
+// samples, and call `cb`.
+//
+// The history is held in the ring, so it must have room for
+// `pre / length + 1` held buffers beside the two the driver fills and one
+// more filled one: `count` must be at least `pre / length + 4`.
+//
+// Buffers the ring drops because the app did not yield in time are left out
+// of the history. If one is dropped after the trigger, the callback gets
+// RETURNCODE_FAIL with the samples stored so far.
+//
+// Returns RETURNCODE_EINVAL if `post` is 0 or the ring is too small for
+// `pre`.
+returncode_t libtock_adc_trigger_start(libtock_adc_trigger_t* trigger, uint8_t channel, uint32_t frequency,
+                                       uint16_t* buffers, uint8_t count, uint32_t length,
+                                       libtock_adc_trigger_mode_t mode, uint16_t threshold,
+                                       uint16_t* window, uint32_t pre, uint32_t post,
+                                       libtock_adc_trigger_callback cb, void* opaque);
+
+// Stop a capture that has not triggered yet, without calling its callback.
+//
+// Returns RETURNCODE_EALREADY if the capture is not running.
+returncode_t libtock_adc_trigger_stop(libtock_adc_trigger_t* trigger);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,7 +1,15 @@
 #include "analog_comparator.h"
 
 returncode_t libtock_analog_comparator_count(int* count) {
-  return libtock_analog_comparator_command_count((uint32_t*) count);
+  // The number of comparators cannot change while the process runs.
+  static int cached = -1;
+  if (cached < 0) {
+    returncode_t ret = libtock_analog_comparator_command_count((uint32_t*) count);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    cached = *count;
+  }
+  *count = cached;
+  return RETURNCODE_SUCCESS;
 }
 
 returncode_t libtock_analog_comparator_comparison(uint8_t channel, bool* comparison) {
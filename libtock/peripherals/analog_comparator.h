@@ -7,7 +7,8 @@
 extern "C" {
 #endif
 
-// Request the number of available ACs.
+// Request the number of available ACs. The count is read from the kernel
+// once and then cached.
 returncode_t libtock_analog_comparator_count(int* count);
 
 // Compare the voltages of two pins (if one is higher than the other) on the
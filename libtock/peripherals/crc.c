@@ -1,4 +1,5 @@
 #include "crc.h"
+#include "crc_soft.h"
 
 static void crc_upcall(int status, int v1, __attribute__((unused)) int v2, void* opaque) {
   libtock_crc_callback_computed cb = (libtock_crc_callback_computed) opaque;
@@ -18,3 +19,65 @@ returncode_t libtock_crc_compute(const uint8_t* buf, uint32_t buflen, libtock_cr
   ret = libtock_crc_command_request(algorithm, buflen);
   return ret;
 }
+
+// The stream the driver is working for.
+static libtock_crc_stream_t* active_stream = NULL;
+
+// Whether the kernel has a CRC driver: unknown (-1), no (0) or yes (1).
+static int driver = -1;
+
+static bool have_driver(void) {
+  if (driver < 0) driver = libtock_crc_exists();
+  return driver;
+}
+
+static void stream_computed(returncode_t ret, uint32_t crc) {
+  libtock_crc_stream_t* stream = active_stream;
+  if (stream == NULL) return;
+  active_stream = NULL;
+  libtock_crc_set_readonly_allow(NULL, 0);
+
+  if (ret == RETURNCODE_SUCCESS) {
+    stream->crc = libtock_crc_soft_combine(stream->algorithm, stream->crc, crc, stream->chunk_len);
+  } else if (ret == RETURNCODE_ESIZE) {
+    // Too large for the unit after all.
+    stream->crc = libtock_crc_soft_update(stream->algorithm, stream->crc, stream->chunk, stream->chunk_len);
+    ret         = RETURNCODE_SUCCESS;
+  }
+  stream->cb(ret);
+}
+
+void libtock_crc_stream_init(libtock_crc_stream_t* stream, libtock_crc_alg_t algorithm) {
+  stream->algorithm = algorithm;
+  stream->crc       = libtock_crc_soft_initial(algorithm);
+  stream->chunk_len = 0;
+}
+
+returncode_t libtock_crc_stream_update(libtock_crc_stream_t* stream, const uint8_t* buf, uint32_t len,
+                                       libtock_crc_callback_update cb) {
+  if (active_stream != NULL) return RETURNCODE_EBUSY;
+
+  if (!have_driver() || len <= LIBTOCK_CRC_SOFT_THRESHOLD) {
+    stream->crc = libtock_crc_soft_update(stream->algorithm, stream->crc, buf, len);
+    return RETURNCODE_EALREADY;
+  }
+
+  stream->chunk     = buf;
+  stream->chunk_len = len;
+  stream->cb        = cb;
+  active_stream     = stream;
+
+  returncode_t ret = libtock_crc_compute(buf, len, stream->algorithm, stream_computed);
+  if (ret != RETURNCODE_SUCCESS) {
+    active_stream = NULL;
+    libtock_crc_set_readonly_allow(NULL, 0);
+    if (ret != RETURNCODE_ESIZE) return ret;
+    stream->crc = libtock_crc_soft_update(stream->algorithm, stream->crc, buf, len);
+    return RETURNCODE_EALREADY;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+uint32_t libtock_crc_stream_result(const libtock_crc_stream_t* stream) {
+  return stream->crc;
+}
@@ -33,6 +33,50 @@ typedef enum {
 returncode_t libtock_crc_compute(const uint8_t* buf, uint32_t buflen, libtock_crc_alg_t algorithm,
                                  libtock_crc_callback_computed cb);
 
+// Chunks of at most `LIBTOCK_CRC_SOFT_THRESHOLD` bytes are computed in
+// software even when there is a CRC driver, as below some size the system
+// calls cost more than the CRC. Set it per board with
+// `make CFLAGS=-DLIBTOCK_CRC_SOFT_THRESHOLD=<bytes>`.
+#ifndef LIBTOCK_CRC_SOFT_THRESHOLD
+#define LIBTOCK_CRC_SOFT_THRESHOLD 0
+#endif
+
+// Function signature for CRC stream callbacks.
+//
+// - `arg1` (`returncode_t`): Status of adding the chunk.
+typedef void (*libtock_crc_callback_update)(returncode_t);
+
+// A CRC computed over data that arrives in chunks, such as a flash image
+// read piece by piece.
+//
+// The driver computes each chunk from scratch, and its result is combined
+// with the CRC so far in software. Without a driver, for chunks within
+// `LIBTOCK_CRC_SOFT_THRESHOLD`, or for chunks too large for the driver, the
+// chunk is computed in software instead.
+typedef struct {
+  libtock_crc_alg_t algorithm;
+  // CRC of the data so far.
+  uint32_t crc;
+  // The chunk the driver is working on.
+  uint32_t chunk_len;
+  const uint8_t* chunk;
+  libtock_crc_callback_update cb;
+} libtock_crc_stream_t;
+
+// Start a CRC of `algorithm` over no data.
+void libtock_crc_stream_init(libtock_crc_stream_t* stream, libtock_crc_alg_t algorithm);
+
+// Add `len` bytes of `buf`, which must stay unchanged until the callback.
+//
+// Returns RETURNCODE_EALREADY if the chunk was added in software, in which
+// case the callback is not called, and RETURNCODE_EBUSY while the driver is
+// working on a chunk.
+returncode_t libtock_crc_stream_update(libtock_crc_stream_t* stream, const uint8_t* buf, uint32_t len,
+                                       libtock_crc_callback_update cb);
+
+// The CRC of the data added so far.
+uint32_t libtock_crc_stream_result(const libtock_crc_stream_t* stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../tock.h"
+#include "crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Software versions of the CRCs of `crc.h`, giving the same results as the
+// CRC driver.
+//
+// CRC-32 and CRC-32C use slicing-by-8, eight bytes per step through 8 kB of
+// tables each. With `make CFLAGS=-DLIBTOCK_CRC_SLICE_BY_8=0` they go a byte
+// at a time through 1 kB tables instead, for boards short of flash. Tables
+// of unused algorithms are dropped by the linker.
+//
+// CRCs here are always in the form the algorithm outputs, so a value from
+// the driver can be continued in software and the other way round.
+
+#ifndef LIBTOCK_CRC_SLICE_BY_8
+#define LIBTOCK_CRC_SLICE_BY_8 1
+#endif
+
+#if LIBTOCK_CRC_SLICE_BY_8
+#define LIBTOCK_CRC_SLICES 8
+#else
+#define LIBTOCK_CRC_SLICES 1
+#endif
+
+// The CRC of no data.
+uint32_t libtock_crc_soft_initial(libtock_crc_alg_t algorithm);
+
+// Continue `crc` over `len` more bytes of `buf`.
+uint32_t libtock_crc_soft_update(libtock_crc_alg_t algorithm, uint32_t crc, const uint8_t* buf, uint32_t len);
+
+// The CRC of `len` bytes of `buf`.
+uint32_t libtock_crc_soft(libtock_crc_alg_t algorithm, const uint8_t* buf, uint32_t len);
+
+// Continue a CRC-32 over `len` more bytes of `buf`, four bits at a time
+// through a 64-byte table. Gives the same result as
+// `libtock_crc_soft_update(LIBTOCK_CRC_32, ...)` without linking its tables,
+// for checksums of headers and small records.
+uint32_t libtock_crc_soft_crc32_small(uint32_t crc, const uint8_t* buf, uint32_t len);
+
+// The CRC of data A followed by data B, from the CRC of each and the length
+// of B. Costs a few hundred operations, whatever the length.
+uint32_t libtock_crc_soft_combine(libtock_crc_alg_t algorithm, uint32_t crc_a, uint32_t crc_b, uint32_t len_b);
+
+#ifdef __cplusplus
+}
+#endif
@@ -9,7 +9,15 @@ static void gpio_upcall(int                          pin_number,
 }
 
 returncode_t libtock_gpio_count(int* count) {
-  return libtock_gpio_command_count((uint32_t*) count);
+  // The number of pins cannot change while the process runs.
+  static int cached = -1;
+  if (cached < 0) {
+    returncode_t ret = libtock_gpio_command_count((uint32_t*) count);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    cached = *count;
+  }
+  *count = cached;
+  return RETURNCODE_SUCCESS;
 }
 
 returncode_t libtock_gpio_set_interrupt_callback(libtock_gpio_callback_interrupt cb) {
@@ -51,3 +59,81 @@ returncode_t libtock_gpio_disable_interrupt(uint32_t pin) {
 returncode_t libtock_gpio_disable(uint32_t pin) {
   return libtock_gpio_command_disable(pin);
 }
+
+// Bits of `mask` that name pins of `port`.
+static uint32_t port_bits(const libtock_gpio_port_t* port, uint32_t mask) {
+  return port->width == 32 ? mask : mask & ((1u << port->width) - 1);
+}
+
+returncode_t libtock_gpio_port_init(libtock_gpio_port_t* port, const uint32_t* pins, uint8_t width) {
+  if (width == 0 || width > 32) return RETURNCODE_EINVAL;
+
+  port->pins   = pins;
+  port->width  = width;
+  port->output = 0;
+  port->known  = 0;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_gpio_port_enable_output(libtock_gpio_port_t* port, uint32_t mask) {
+  mask = port_bits(port, mask);
+  for (uint8_t i = 0; i < port->width; i++) {
+    if ((mask & (1u << i)) == 0) continue;
+    // The level the pin comes up with is up to the chip.
+    port->known &= ~(1u << i);
+    returncode_t ret = libtock_gpio_command_enable_output(port->pins[i]);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_gpio_port_enable_input(libtock_gpio_port_t* port, uint32_t mask,
+                                            libtock_gpio_input_mode_t pin_config) {
+  mask         = port_bits(port, mask);
+  port->known &= ~mask;
+  for (uint8_t i = 0; i < port->width; i++) {
+    if ((mask & (1u << i)) == 0) continue;
+    returncode_t ret = libtock_gpio_command_enable_input(port->pins[i], (uint32_t) pin_config);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_gpio_write_mask(libtock_gpio_port_t* port, uint32_t mask, uint32_t value) {
+  mask = port_bits(port, mask);
+  uint32_t changed = mask & (~port->known | (port->output ^ value));
+
+  for (uint8_t i = 0; changed != 0; i++) {
+    uint32_t bit = 1u << i;
+    if ((changed & bit) == 0) continue;
+    changed &= ~bit;
+
+    returncode_t ret;
+    if (value & bit) {
+      ret = libtock_gpio_command_set(port->pins[i]);
+    } else {
+      ret = libtock_gpio_command_clear(port->pins[i]);
+    }
+    if (ret != RETURNCODE_SUCCESS) {
+      port->known &= ~bit;
+      return ret;
+    }
+    port->output = (port->output & ~bit) | (value & bit);
+    port->known  |= bit;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_gpio_read_mask(libtock_gpio_port_t* port, uint32_t mask, uint32_t* value) {
+  mask = port_bits(port, mask);
+  uint32_t levels = 0;
+  for (uint8_t i = 0; i < port->width; i++) {
+    if ((mask & (1u << i)) == 0) continue;
+    uint32_t level;
+    returncode_t ret = libtock_gpio_command_read(port->pins[i], &level);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    if (level) levels |= 1u << i;
+  }
+  *value = levels;
+  return RETURNCODE_SUCCESS;
+}
@@ -25,7 +25,8 @@ typedef enum {
   libtock_falling_edge,
 } libtock_gpio_interrupt_mode_t;
 
-// Returns the number of GPIO pins configured on the board.
+// Returns the number of GPIO pins configured on the board. The count is read
+// from the kernel once and then cached.
 returncode_t libtock_gpio_count(int* count);
 
 // Set the callback function that is called when a GPIO interrupt fires.
@@ -63,6 +64,47 @@ returncode_t libtock_gpio_disable_interrupt(uint32_t pin);
 // Completely disable the pin allowing it to go into its lowest power mode.
 returncode_t libtock_gpio_disable(uint32_t pin);
 
+
+// ***** Ports *****
+
+// A group of up to 32 pins driven as the bits of one value, such as a
+// parallel bus. Bit `i` of a value is pin `pins[i]`.
+//
+// The driver takes one pin per command, so the port remembers the levels it
+// last wrote and only issues commands for the pins whose level changes.
+// Writing a byte that differs in two bits costs two syscalls instead of
+// eight. The pins still change one after the other, so devices that sample
+// the bus need a separate strobe pin written afterwards.
+
+typedef struct {
+  const uint32_t* pins;
+  uint8_t width;
+  // Levels last written to the output pins.
+  uint32_t output;
+  // Bits of `output` that match the pins.
+  uint32_t known;
+} libtock_gpio_port_t;
+
+// Set up a port of `width` pins, numbered in `pins`, which must stay valid.
+//
+// Returns RETURNCODE_EINVAL if `width` is 0 or more than 32.
+returncode_t libtock_gpio_port_init(libtock_gpio_port_t* port, const uint32_t* pins, uint8_t width);
+
+// Set the pins of the port in `mask` as outputs.
+returncode_t libtock_gpio_port_enable_output(libtock_gpio_port_t* port, uint32_t mask);
+
+// Set the pins of the port in `mask` as inputs.
+returncode_t libtock_gpio_port_enable_input(libtock_gpio_port_t* port, uint32_t mask,
+                                            libtock_gpio_input_mode_t pin_config);
+
+// Drive each output pin in `mask` to its bit of `value`. Pins already at that
+// level are not touched.
+returncode_t libtock_gpio_write_mask(libtock_gpio_port_t* port, uint32_t mask, uint32_t value);
+
+// Read the input pins in `mask` into the matching bits of `*value`. Other bits
+// are zero.
+returncode_t libtock_gpio_read_mask(libtock_gpio_port_t* port, uint32_t mask, uint32_t* value);
+
 #ifdef __cplusplus
 }
 #endif
@@ -81,3 +81,109 @@ returncode_t libtock_gpio_async_disable_interrupt(uint32_t port, uint8_t pin, li
 returncode_t libtock_gpio_async_disable(uint32_t port, uint8_t pin, libtock_gpio_async_callback_command cb) {
   return gpio_async_operation(port, pin, cb, libtock_gpio_async_command_disable);
 }
+
+
+// ***** Ports *****
+
+enum port_op {
+  PORT_MAKE_OUTPUT,
+  PORT_MAKE_INPUT,
+  PORT_WRITE,
+  PORT_READ,
+};
+
+static void port_finish(libtock_gpio_async_port_t* port, returncode_t ret) {
+  uint32_t value = port->op == PORT_READ ? port->value : 0;
+  port->cb(ret, value, port->opaque);
+}
+
+// Issue the command for the lowest pin left in the operation.
+static returncode_t port_next(libtock_gpio_async_port_t* port) {
+  uint8_t pin = 0;
+  while ((port->remaining & (1u << pin)) == 0) pin++;
+  port->pin = pin;
+
+  switch (port->op) {
+    case PORT_MAKE_OUTPUT:
+      return libtock_gpio_async_command_make_output(port->port, pin);
+    case PORT_MAKE_INPUT:
+      return libtock_gpio_async_command_make_input(port->port, pin, (libtock_gpio_input_mode_t) port->config);
+    case PORT_WRITE:
+      if (port->value & (1u << pin)) {
+        return libtock_gpio_async_command_set(port->port, pin);
+      }
+      return libtock_gpio_async_command_clear(port->port, pin);
+    default:
+      return libtock_gpio_async_command_read(port->port, pin);
+  }
+}
+
+static void gpio_async_upcall_port(__attribute__ ((unused)) int unused1,
+                                   int                          value,
+                                   __attribute__ ((unused)) int unused2,
+                                   void*                        opaque) {
+  libtock_gpio_async_port_t* port = (libtock_gpio_async_port_t*) opaque;
+  uint32_t bit = 1u << port->pin;
+
+  port->remaining &= ~bit;
+  if (port->op == PORT_WRITE) {
+    port->output = (port->output & ~bit) | (port->value & bit);
+    port->known  |= bit;
+  } else if (port->op == PORT_READ && value) {
+    port->value |= bit;
+  }
+
+  if (port->remaining == 0) {
+    port_finish(port, RETURNCODE_SUCCESS);
+    return;
+  }
+  returncode_t ret = port_next(port);
+  if (ret != RETURNCODE_SUCCESS) port_finish(port, ret);
+}
+
+static returncode_t port_start(libtock_gpio_async_port_t* port, uint8_t op, uint32_t mask, uint32_t value,
+                               uint32_t config, libtock_gpio_async_port_callback cb, void* opaque) {
+  if (mask == 0) return RETURNCODE_EALREADY;
+
+  returncode_t ret = libtock_gpio_async_set_upcall_command(gpio_async_upcall_port, port);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  port->op        = op;
+  port->remaining = mask;
+  port->value     = value;
+  port->config    = config;
+  port->cb        = cb;
+  port->opaque    = opaque;
+  return port_next(port);
+}
+
+void libtock_gpio_async_port_init(libtock_gpio_async_port_t* port, uint32_t port_number) {
+  port->port   = port_number;
+  port->output = 0;
+  port->known  = 0;
+}
+
+returncode_t libtock_gpio_async_port_make_output(libtock_gpio_async_port_t* port, uint32_t mask,
+                                                 libtock_gpio_async_port_callback cb, void* opaque) {
+  // The level of a pin is not known until it is written.
+  port->known &= ~mask;
+  return port_start(port, PORT_MAKE_OUTPUT, mask, 0, 0, cb, opaque);
+}
+
+returncode_t libtock_gpio_async_port_make_input(libtock_gpio_async_port_t* port, uint32_t mask,
+                                                libtock_gpio_input_mode_t pin_config,
+                                                libtock_gpio_async_port_callback cb, void* opaque) {
+  port->known &= ~mask;
+  return port_start(port, PORT_MAKE_INPUT, mask, 0, (uint32_t) pin_config, cb, opaque);
+}
+
+returncode_t libtock_gpio_async_port_write(libtock_gpio_async_port_t* port, uint32_t mask, uint32_t value,
+                                           libtock_gpio_async_port_callback cb, void* opaque) {
+  uint32_t changed = mask & (~port->known | (port->output ^ value));
+  return port_start(port, PORT_WRITE, changed, value, 0, cb, opaque);
+}
+
+returncode_t libtock_gpio_async_port_read(libtock_gpio_async_port_t* port, uint32_t mask,
+                                          libtock_gpio_async_port_callback cb, void* opaque) {
+  return port_start(port, PORT_READ, mask, 0, 0, cb, opaque);
+}
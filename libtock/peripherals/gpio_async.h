@@ -43,6 +43,73 @@ returncode_t libtock_gpio_async_disable_interrupt(uint32_t port, uint8_t pin, li
 
 returncode_t libtock_gpio_async_disable(uint32_t port, uint8_t pin, libtock_gpio_async_callback_command cb);
 
+// ***** Ports *****
+
+// Operations on several pins of one expander port, with bit `i` of a mask
+// being pin `i`. Each one finishes with a single callback.
+//
+// The driver takes one pin per command and each command is a bus transaction
+// to the expander, so the pins are still handled one at a time, with the next
+// command issued from the upcall of the previous one. The port remembers the
+// levels it last wrote and skips the pins that already have the requested
+// level, which makes writing a value that differs in one bit a single
+// transaction.
+//
+// The driver has one command upcall, so only one operation can run at a time
+// across all ports and the single pin calls above.
+
+// Function signature for port operation callbacks.
+//
+// - `arg1` (`returncode_t`): Status of the operation.
+// - `arg2` (`uint32_t`): For a read, the level of each pin in the mask.
+// - `arg3` (`void*`): The opaque pointer passed to the operation.
+typedef void (*libtock_gpio_async_port_callback)(returncode_t, uint32_t, void*);
+
+typedef struct {
+  uint32_t port;
+  // Levels last written to the output pins.
+  uint32_t output;
+  // Bits of `output` that match the pins.
+  uint32_t known;
+  // The operation in progress.
+  uint8_t op;
+  uint32_t remaining;
+  uint32_t value;
+  uint32_t config;
+  uint8_t pin;
+  libtock_gpio_async_port_callback cb;
+  void* opaque;
+} libtock_gpio_async_port_t;
+
+void libtock_gpio_async_port_init(libtock_gpio_async_port_t* port, uint32_t port_number);
+
+// Set the pins of the port in `mask` as outputs.
+//
+// Returns RETURNCODE_EALREADY, with no callback, if `mask` is 0.
+returncode_t libtock_gpio_async_port_make_output(libtock_gpio_async_port_t* port, uint32_t mask,
+                                                 libtock_gpio_async_port_callback cb, void* opaque);
+
+// Set the pins of the port in `mask` as inputs.
+//
+// Returns RETURNCODE_EALREADY, with no callback, if `mask` is 0.
+returncode_t libtock_gpio_async_port_make_input(libtock_gpio_async_port_t* port, uint32_t mask,
+                                                libtock_gpio_input_mode_t pin_config,
+                                                libtock_gpio_async_port_callback cb, void* opaque);
+
+// Drive each output pin in `mask` to its bit of `value`.
+//
+// Returns RETURNCODE_EALREADY, with no callback, if every pin already has its
+// level.
+returncode_t libtock_gpio_async_port_write(libtock_gpio_async_port_t* port, uint32_t mask, uint32_t value,
+                                           libtock_gpio_async_port_callback cb, void* opaque);
+
+// Read the input pins in `mask`. The callback gets their levels in the
+// matching bits, other bits are zero.
+//
+// Returns RETURNCODE_EALREADY, with no callback, if `mask` is 0.
+returncode_t libtock_gpio_async_port_read(libtock_gpio_async_port_t* port, uint32_t mask,
+                                          libtock_gpio_async_port_callback cb, void* opaque);
+
 #ifdef __cplusplus
 }
 #endif
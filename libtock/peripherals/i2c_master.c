@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "i2c_master.h"
 
 #define DRIVER_NUM_I2CMASTER 0x20003
@@ -89,3 +91,61 @@ int i2c_master_write_read_sync(uint16_t address, uint8_t* buffer, uint16_t write
   yield_for(&ready);
   return RETURNCODE_SUCCESS;
 }
+
+static int reg_batch_next(i2c_master_reg_batch_t* batch);
+
+static void reg_batch_callback(__attribute__ ((unused)) int a1,
+                               __attribute__ ((unused)) int a2,
+                               __attribute__ ((unused)) int unused,
+                               void*                        ud) {
+  i2c_master_reg_batch_t* batch = (i2c_master_reg_batch_t*) ud;
+
+  batch->index++;
+  int rval = RETURNCODE_SUCCESS;
+  if (batch->index < batch->count) {
+    rval = reg_batch_next(batch);
+    if (rval == RETURNCODE_SUCCESS) return;
+  }
+  i2c_master_set_buffer(NULL, 0);
+  batch->cb(rval, batch->index, batch->opaque);
+}
+
+static int reg_batch_next(i2c_master_reg_batch_t* batch) {
+  const i2c_master_reg_op_t* op = &batch->ops[batch->index];
+  int rval;
+
+  if (op->read) {
+    // The address byte goes out of the same buffer the data comes back in.
+    op->data[0] = op->reg;
+    rval        = i2c_master_set_buffer(op->data, op->len);
+    if (rval < 0) return rval;
+    return i2c_master_write_read(batch->address, 1, op->len);
+  }
+
+  batch->scratch[0] = op->reg;
+  memcpy(&batch->scratch[1], op->data, op->len);
+  rval = i2c_master_set_buffer(batch->scratch, 1 + op->len);
+  if (rval < 0) return rval;
+  return i2c_master_write(batch->address, 1 + op->len);
+}
+
+returncode_t i2c_master_reg_batch(i2c_master_reg_batch_t* batch, uint8_t address,
+                                  const i2c_master_reg_op_t* ops, size_t count,
+                                  i2c_master_reg_callback cb, void* opaque) {
+  if (count == 0) return RETURNCODE_EINVAL;
+  for (size_t i = 0; i < count; i++) {
+    if (ops[i].len == 0) return RETURNCODE_EINVAL;
+    if (!ops[i].read && ops[i].len > I2C_MASTER_REG_WRITE_MAX) return RETURNCODE_EINVAL;
+  }
+
+  batch->address = address;
+  batch->ops     = ops;
+  batch->count   = count;
+  batch->index   = 0;
+  batch->cb      = cb;
+  batch->opaque  = opaque;
+
+  int rval = i2c_master_set_callback(reg_batch_callback, batch);
+  if (rval < 0) return rval;
+  return reg_batch_next(batch);
+}
@@ -16,6 +16,59 @@ int i2c_master_write_sync(uint16_t address, uint8_t* buffer, uint16_t len);
 int i2c_master_read_sync(uint16_t address, uint8_t* buffer, uint16_t len);
 int i2c_master_write_read_sync(uint16_t address, uint8_t* buffer, uint16_t write_len, uint16_t read_len);
 
+
+// ***** Registers *****
+
+// Register access on devices that take a register address byte followed by
+// the data, which covers most sensors.
+//
+// The driver runs one transfer per command, so a batch is still one bus
+// transaction per operation. The operations are chained from the transfer
+// upcall, so a whole init sequence costs the app a single callback instead of
+// a round trip per register.
+
+// Longest write, in data bytes, that a batch can do. Writes are copied behind
+// the register address into the batch.
+#ifndef I2C_MASTER_REG_WRITE_MAX
+#define I2C_MASTER_REG_WRITE_MAX 32
+#endif
+
+typedef struct {
+  uint8_t reg;
+  // Read `len` bytes starting at `reg` into `data` if set, otherwise write
+  // them.
+  bool read;
+  uint8_t* data;
+  uint16_t len;
+} i2c_master_reg_op_t;
+
+// Function signature for batch callbacks.
+//
+// - `arg1` (`returncode_t`): Status of the batch.
+// - `arg2` (`size_t`): Number of operations that completed.
+// - `arg3` (`void*`): The opaque pointer passed to `i2c_master_reg_batch()`.
+typedef void (*i2c_master_reg_callback)(returncode_t, size_t, void*);
+
+typedef struct {
+  uint8_t address;
+  const i2c_master_reg_op_t* ops;
+  size_t count;
+  size_t index;
+  i2c_master_reg_callback cb;
+  void* opaque;
+  uint8_t scratch[1 + I2C_MASTER_REG_WRITE_MAX];
+} i2c_master_reg_batch_t;
+
+// Run `count` register operations on the device at `address`, with one
+// callback at the end. `ops` and the data they point to must stay valid
+// until then. A read uses its own `data` as the transfer buffer.
+//
+// Returns RETURNCODE_EINVAL if `count` is 0, or an operation is empty or is a
+// write longer than `I2C_MASTER_REG_WRITE_MAX`.
+returncode_t i2c_master_reg_batch(i2c_master_reg_batch_t* batch, uint8_t address,
+                                  const i2c_master_reg_op_t* ops, size_t count,
+                                  i2c_master_reg_callback cb, void* opaque);
+
 #ifdef __cplusplus
 }
 #endif
@@ -130,3 +130,89 @@ int i2c_master_slave_read_sync(uint16_t address, uint16_t len, int* length_read)
 
   return RETURNCODE_SUCCESS;
 }
+
+static void ring_put(i2c_master_slave_ring_t* ring, uint8_t byte) {
+  size_t pos = ring->head + ring->used;
+  if (pos >= ring->size) pos -= ring->size;
+  ring->storage[pos] = byte;
+  ring->used++;
+}
+
+static uint8_t ring_take(i2c_master_slave_ring_t* ring) {
+  uint8_t byte = ring->storage[ring->head];
+  ring->head++;
+  if (ring->head == ring->size) ring->head = 0;
+  ring->used--;
+  return byte;
+}
+
+static void ring_upcall(int                          callback_type,
+                        int                          length,
+                        __attribute__ ((unused)) int unused,
+                        void*                        ud) {
+  i2c_master_slave_ring_t* ring = (i2c_master_slave_ring_t*) ud;
+  if (callback_type != TOCK_I2C_CB_SLAVE_WRITE) return;
+
+  size_t len = (size_t) length;
+  if (len > I2C_MASTER_SLAVE_RING_MESSAGE_MAX) len = I2C_MASTER_SLAVE_RING_MESSAGE_MAX;
+  if (ring->size - ring->used < len + 1) {
+    ring->dropped++;
+  } else {
+    ring_put(ring, (uint8_t) len);
+    for (size_t i = 0; i < len; i++) {
+      ring_put(ring, ring->listen[i]);
+    }
+    ring->count++;
+  }
+
+  // The listen buffer has been copied, so the next message can land in it.
+  i2c_master_slave_listen();
+  if (ring->cb) ring->cb(ring->opaque);
+}
+
+int i2c_master_slave_ring_start(i2c_master_slave_ring_t* ring, uint8_t address, uint8_t* storage, size_t size,
+                                i2c_master_slave_ring_callback cb, void* opaque) {
+  int err;
+
+  ring->storage = storage;
+  ring->size    = size;
+  ring->head    = 0;
+  ring->used    = 0;
+  ring->count   = 0;
+  ring->dropped = 0;
+  ring->cb      = cb;
+  ring->opaque  = opaque;
+
+  err = i2c_master_slave_set_slave_write_buffer(ring->listen, I2C_MASTER_SLAVE_RING_MESSAGE_MAX);
+  if (err < 0) return err;
+
+  err = i2c_master_slave_set_callback(ring_upcall, ring);
+  if (err < 0) return err;
+
+  err = i2c_master_slave_set_slave_address(address);
+  if (err < 0) return err;
+
+  return i2c_master_slave_listen();
+}
+
+bool i2c_master_slave_ring_pop(i2c_master_slave_ring_t* ring, uint8_t* message, size_t max, size_t* len) {
+  if (ring->count == 0) return false;
+
+  size_t length = ring_take(ring);
+  for (size_t i = 0; i < length; i++) {
+    uint8_t byte = ring_take(ring);
+    if (i < max) message[i] = byte;
+  }
+  ring->count--;
+
+  *len = length < max ? length : max;
+  return true;
+}
+
+uint32_t i2c_master_slave_ring_count(const i2c_master_slave_ring_t* ring) {
+  return ring->count;
+}
+
+uint32_t i2c_master_slave_ring_dropped(const i2c_master_slave_ring_t* ring) {
+  return ring->dropped;
+}
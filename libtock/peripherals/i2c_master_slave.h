@@ -30,6 +30,57 @@ int i2c_master_slave_write_sync(uint8_t address, uint8_t length, int* length_wri
 int i2c_master_slave_write_read_sync(uint8_t address, uint8_t wlen, uint8_t rlen, int* length_written);
 int i2c_master_slave_read_sync(uint16_t address, uint16_t len, int* length_read);
 
+// ***** Receive ring *****
+
+// Queue of messages written to this device as an I2C target.
+//
+// The kernel copies each message into one listen buffer, so a message that
+// arrives before the app has handled the previous one overwrites it. The ring
+// copies every message out of the listen buffer in the upcall, with a length
+// byte in front, and listens again at once. The app takes messages in order
+// whenever it gets to them.
+//
+// The ring takes over the driver callback, so master operations on this
+// driver stop the ring until it is started again.
+
+// Longest message the ring receives, at most 255. Longer messages are
+// truncated by the kernel.
+#ifndef I2C_MASTER_SLAVE_RING_MESSAGE_MAX
+#define I2C_MASTER_SLAVE_RING_MESSAGE_MAX 32
+#endif
+
+// Function signature for the ring callback, called after a message was
+// queued.
+typedef void (*i2c_master_slave_ring_callback)(void*);
+
+typedef struct {
+  uint8_t* storage;
+  size_t size;
+  size_t head;
+  size_t used;
+  uint32_t count;
+  uint32_t dropped;
+  i2c_master_slave_ring_callback cb;
+  void* opaque;
+  uint8_t listen[I2C_MASTER_SLAVE_RING_MESSAGE_MAX];
+} i2c_master_slave_ring_t;
+
+// Listen at `address` and queue messages in `storage`, which holds `size`
+// bytes. Each message takes its length plus one byte. `cb` may be NULL.
+int i2c_master_slave_ring_start(i2c_master_slave_ring_t* ring, uint8_t address, uint8_t* storage, size_t size,
+                                i2c_master_slave_ring_callback cb, void* opaque);
+
+// Take the oldest message into `message`, which holds `max` bytes, and set
+// `*len` to its length. A message longer than `max` is truncated. Returns
+// false if the ring is empty.
+bool i2c_master_slave_ring_pop(i2c_master_slave_ring_t* ring, uint8_t* message, size_t max, size_t* len);
+
+// Number of messages waiting.
+uint32_t i2c_master_slave_ring_count(const i2c_master_slave_ring_t* ring);
+
+// Number of messages dropped because the ring was full.
+uint32_t i2c_master_slave_ring_dropped(const i2c_master_slave_ring_t* ring);
+
 #ifdef __cplusplus
 }
 #endif
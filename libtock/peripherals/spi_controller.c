@@ -78,3 +78,81 @@ returncode_t libtock_spi_controller_read_write(const uint8_t*                  w
 
   return libtock_spi_controller_write(write, len, cb);
 }
+
+static returncode_t transaction_next(libtock_spi_controller_transaction_t* transaction);
+
+static void transaction_finish(libtock_spi_controller_transaction_t* transaction, returncode_t ret) {
+  // Never leave the chip select asserted after the transaction.
+  if (transaction->holding) {
+    libtock_spi_controller_command_release_low();
+    transaction->holding = false;
+  }
+  libtock_spi_controller_allow_readonly_write(NULL, 0);
+  libtock_spi_controller_allow_readwrite_read(NULL, 0);
+  transaction->cb(ret, transaction->index, transaction->opaque);
+}
+
+static void transaction_upcall(__attribute__ ((unused)) int unused0,
+                               __attribute__ ((unused)) int unused1,
+                               __attribute__ ((unused)) int unused2,
+                               void*                        opaque) {
+  libtock_spi_controller_transaction_t* transaction = (libtock_spi_controller_transaction_t*) opaque;
+
+  transaction->index++;
+  if (transaction->index == transaction->count) {
+    transaction_finish(transaction, RETURNCODE_SUCCESS);
+    return;
+  }
+  returncode_t ret = transaction_next(transaction);
+  if (ret != RETURNCODE_SUCCESS) transaction_finish(transaction, ret);
+}
+
+static returncode_t transaction_next(libtock_spi_controller_transaction_t* transaction) {
+  const libtock_spi_controller_segment_t* segment = &transaction->segments[transaction->index];
+  returncode_t ret;
+
+  // Releasing before the transfer lets the chip select go up when it ends.
+  if (segment->hold != transaction->holding) {
+    if (segment->hold) {
+      ret = libtock_spi_controller_command_hold_low();
+    } else {
+      ret = libtock_spi_controller_command_release_low();
+    }
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    transaction->holding = segment->hold;
+  }
+
+  ret = libtock_spi_controller_allow_readwrite_read(segment->read, segment->read ? segment->len : 0);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = libtock_spi_controller_allow_readonly_write((uint8_t*) segment->write, segment->len);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  return libtock_spi_controller_command_read_write_bytes(segment->len);
+}
+
+returncode_t libtock_spi_controller_transaction(libtock_spi_controller_transaction_t* transaction,
+                                                const libtock_spi_controller_segment_t* segments, size_t count,
+                                                libtock_spi_controller_transaction_callback cb, void* opaque) {
+  if (count == 0) return RETURNCODE_EINVAL;
+  for (size_t i = 0; i < count; i++) {
+    if (segments[i].write == NULL || segments[i].len == 0) return RETURNCODE_EINVAL;
+  }
+
+  returncode_t ret = libtock_spi_controller_set_upcall(transaction_upcall, transaction);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  transaction->segments = segments;
+  transaction->count    = count;
+  transaction->index    = 0;
+  transaction->holding  = false;
+  transaction->cb       = cb;
+  transaction->opaque   = opaque;
+
+  ret = transaction_next(transaction);
+  if (ret != RETURNCODE_SUCCESS && transaction->holding) {
+    libtock_spi_controller_command_release_low();
+    transaction->holding = false;
+  }
+  return ret;
+}
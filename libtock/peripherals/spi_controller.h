@@ -59,6 +59,50 @@ returncode_t libtock_spi_controller_read_write(const uint8_t*                  w
                                                size_t                          len,
                                                libtock_spi_controller_callback cb);
 
+
+// ***** Transactions *****
+
+// One segment of a transaction. `read` may be NULL to discard the bytes
+// clocked in. If `hold` is set the chip select stays asserted after the
+// segment, so the next segment continues the same device transaction, such
+// as a register address followed by its data.
+typedef struct {
+  const uint8_t* write;
+  uint8_t* read;
+  size_t len;
+  bool hold;
+} libtock_spi_controller_segment_t;
+
+// Function signature for transaction callbacks.
+//
+// - `arg1` (`returncode_t`): Status of the transaction.
+// - `arg2` (`size_t`): Number of segments that completed.
+// - `arg3` (`void*`): The opaque pointer passed to
+//   `libtock_spi_controller_transaction()`.
+typedef void (*libtock_spi_controller_transaction_callback)(returncode_t, size_t, void*);
+
+typedef struct {
+  const libtock_spi_controller_segment_t* segments;
+  size_t count;
+  size_t index;
+  bool holding;
+  libtock_spi_controller_transaction_callback cb;
+  void* opaque;
+} libtock_spi_controller_transaction_t;
+
+// Run `count` segments back to back with a single callback at the end.
+//
+// The driver transfers one buffer per command, so the next segment is started
+// from the upcall of the previous one rather than from the app. Holding the
+// chip select uses `libtock_spi_controller_hold_low()`, and is only as well
+// supported as that call. The segments must stay valid until the callback.
+//
+// Returns RETURNCODE_EINVAL if `count` is 0 or a segment is empty or has no
+// write buffer.
+returncode_t libtock_spi_controller_transaction(libtock_spi_controller_transaction_t* transaction,
+                                                const libtock_spi_controller_segment_t* segments, size_t count,
+                                                libtock_spi_controller_transaction_callback cb, void* opaque);
+
 #ifdef __cplusplus
 }
 #endif
@@ -59,3 +59,85 @@ returncode_t libtock_spi_peripheral_read_write(const uint8_t*                  w
 
   return libtock_spi_peripheral_write(write, len, cb);
 }
+
+static returncode_t receive_arm(libtock_spi_peripheral_receive_t* receive) {
+  returncode_t ret;
+
+  ret = libtock_spi_peripheral_allow_readwrite_read(receive->buffers[receive->armed], receive->len);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  return libtock_spi_peripheral_command_write(receive->len);
+}
+
+static void receive_upcall(__attribute__ ((unused)) int unused0,
+                           __attribute__ ((unused)) int unused1,
+                           __attribute__ ((unused)) int unused2,
+                           void*                        opaque) {
+  libtock_spi_peripheral_receive_t* receive = (libtock_spi_peripheral_receive_t*) opaque;
+  if (!receive->running) return;
+
+  uint8_t filled = receive->armed;
+  uint8_t other  = filled ^ 1;
+  if (receive->held[other]) {
+    // Nowhere to receive into but the buffer just filled.
+    receive->overruns++;
+    receive_arm(receive);
+    return;
+  }
+
+  receive->held[filled] = true;
+  receive->armed        = other;
+  receive_arm(receive);
+  receive->cb(receive->buffers[filled], receive->opaque);
+}
+
+returncode_t libtock_spi_peripheral_receive_start(libtock_spi_peripheral_receive_t* receive, uint8_t* first,
+                                                  uint8_t* second, const uint8_t* reply, size_t len,
+                                                  libtock_spi_peripheral_receive_callback cb, void* opaque) {
+  returncode_t ret;
+
+  receive->buffers[0] = first;
+  receive->buffers[1] = second;
+  receive->reply      = reply;
+  receive->len        = len;
+  receive->armed      = 0;
+  receive->held[0]    = false;
+  receive->held[1]    = false;
+  receive->overruns   = 0;
+  receive->cb         = cb;
+  receive->opaque     = opaque;
+
+  // The reply stays allowed for every transfer.
+  ret = libtock_spi_peripheral_allow_readonly_write((uint8_t*) reply, len);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = libtock_spi_peripheral_set_upcall(receive_upcall, receive);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  receive->running = true;
+
+  ret = receive_arm(receive);
+  if (ret != RETURNCODE_SUCCESS) receive->running = false;
+  return ret;
+}
+
+returncode_t libtock_spi_peripheral_receive_release(libtock_spi_peripheral_receive_t* receive, uint8_t* buffer) {
+  for (int i = 0; i < 2; i++) {
+    if (receive->buffers[i] == buffer && receive->held[i]) {
+      receive->held[i] = false;
+      return RETURNCODE_SUCCESS;
+    }
+  }
+  return RETURNCODE_EINVAL;
+}
+
+uint32_t libtock_spi_peripheral_receive_overruns(const libtock_spi_peripheral_receive_t* receive) {
+  return receive->overruns;
+}
+
+void libtock_spi_peripheral_receive_stop(libtock_spi_peripheral_receive_t* receive) {
+  receive->running = false;
+  libtock_spi_peripheral_set_upcall(NULL, NULL);
+  libtock_spi_peripheral_allow_readwrite_read(NULL, 0);
+  libtock_spi_peripheral_allow_readonly_write(NULL, 0);
+}
@@ -41,6 +41,55 @@ returncode_t libtock_spi_peripheral_read_write(const uint8_t*                  w
                                                size_t                          len,
                                                libtock_spi_peripheral_callback cb);
 
+
+// ***** Double-buffered receive *****
+
+// Continuous receive into two buffers. When a transfer completes the next
+// one is armed with the other buffer before the app is called, so the kernel
+// fills one buffer while the app processes the first. The app hands each
+// buffer back with `libtock_spi_peripheral_receive_release()`.
+//
+// If the app still holds the other buffer when a transfer completes, the
+// buffer just filled is armed again and its data is lost. These transfers
+// are counted by `libtock_spi_peripheral_receive_overruns()`.
+
+// Function signature for receive callbacks.
+//
+// - `arg1` (`uint8_t*`): The filled buffer, held by the app until released.
+// - `arg2` (`void*`): The opaque pointer passed to
+//   `libtock_spi_peripheral_receive_start()`.
+typedef void (*libtock_spi_peripheral_receive_callback)(uint8_t*, void*);
+
+typedef struct {
+  uint8_t* buffers[2];
+  const uint8_t* reply;
+  size_t len;
+  // Buffer the kernel is filling.
+  uint8_t armed;
+  bool held[2];
+  uint32_t overruns;
+  bool running;
+  libtock_spi_peripheral_receive_callback cb;
+  void* opaque;
+} libtock_spi_peripheral_receive_t;
+
+// Start receiving `len` byte transfers into `first` and `second`. `reply` is
+// the `len` bytes sent back to the controller during every transfer.
+returncode_t libtock_spi_peripheral_receive_start(libtock_spi_peripheral_receive_t* receive, uint8_t* first,
+                                                  uint8_t* second, const uint8_t* reply, size_t len,
+                                                  libtock_spi_peripheral_receive_callback cb, void* opaque);
+
+// Give a buffer passed to the callback back for receiving.
+//
+// Returns RETURNCODE_EINVAL if the app does not hold `buffer`.
+returncode_t libtock_spi_peripheral_receive_release(libtock_spi_peripheral_receive_t* receive, uint8_t* buffer);
+
+// Number of transfers lost because both buffers were in use.
+uint32_t libtock_spi_peripheral_receive_overruns(const libtock_spi_peripheral_receive_t* receive);
+
+// Stop receiving. The transfer in progress is not reported.
+void libtock_spi_peripheral_receive_stop(libtock_spi_peripheral_receive_t* receive);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,3 +1,4 @@
+#include "../peripherals/syscalls/alarm_syscalls.h"
 #include "ninedof.h"
 
 // internal callback for faking synchronous reads
@@ -36,3 +37,60 @@ returncode_t libtock_ninedof_read_gyroscope(libtock_ninedof_callback cb) {
   err = libtock_ninedof_command_start_gyroscope_reading();
   return err;
 }
+
+static returncode_t start_stage(uint8_t stage) {
+  switch (stage) {
+    case 0:
+      return libtock_ninedof_command_start_accelerometer_reading();
+    case 1:
+      return libtock_ninedof_command_start_magnetometer_reading();
+    default:
+      return libtock_ninedof_command_start_gyroscope_reading();
+  }
+}
+
+// Start the read of `reader->stage`, or of the first sensor after it the
+// board has. Returns the error of the last sensor tried if none could start.
+static returncode_t read_all_start(libtock_ninedof_reader_t* reader) {
+  returncode_t ret = RETURNCODE_FAIL;
+  for ( ; reader->stage < 3; reader->stage++) {
+    ret = start_stage(reader->stage);
+    if (ret == RETURNCODE_SUCCESS) break;
+  }
+  return ret;
+}
+
+static void read_all_upcall(int x, int y, int z, void* opaque) {
+  libtock_ninedof_reader_t* reader = (libtock_ninedof_reader_t*) opaque;
+  libtock_ninedof_sample_t* sample = reader->sample;
+
+  int* dest = reader->stage == 0 ? sample->accelerometer :
+              reader->stage == 1 ? sample->magnetometer : sample->gyroscope;
+  dest[0]        = x;
+  dest[1]        = y;
+  dest[2]        = z;
+  sample->valid |= 1 << reader->stage;
+
+  reader->stage++;
+  if (read_all_start(reader) != RETURNCODE_SUCCESS) {
+    reader->cb(RETURNCODE_SUCCESS, sample, reader->opaque);
+  }
+}
+
+returncode_t libtock_ninedof_read_all(libtock_ninedof_reader_t* reader, libtock_ninedof_sample_t* sample,
+                                      libtock_ninedof_sample_callback cb, void* opaque) {
+  returncode_t err;
+
+  err = libtock_ninedof_set_upcall(read_all_upcall, reader);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  reader->sample = sample;
+  reader->stage  = 0;
+  reader->cb     = cb;
+  reader->opaque = opaque;
+  sample->valid  = 0;
+  libtock_alarm_command_read(&sample->ticks);
+
+  // If no sensor can be read the error is returned here with no callback.
+  return read_all_start(reader);
+}
@@ -32,6 +32,48 @@ returncode_t libtock_ninedof_read_magnetometer(libtock_ninedof_callback cb);
 // The X, Y, Z and measurements will be returned via the callback.
 returncode_t libtock_ninedof_read_gyroscope(libtock_ninedof_callback cb);
 
+// ***** Combined read *****
+
+// Bits of `libtock_ninedof_sample_t.valid`.
+#define LIBTOCK_NINEDOF_ACCELEROMETER 0x1
+#define LIBTOCK_NINEDOF_MAGNETOMETER  0x2
+#define LIBTOCK_NINEDOF_GYROSCOPE     0x4
+
+typedef struct {
+  // Alarm counter when the read started.
+  uint32_t ticks;
+  // Which of the readings below were taken.
+  uint8_t valid;
+  int accelerometer[3];
+  int magnetometer[3];
+  int gyroscope[3];
+} libtock_ninedof_sample_t;
+
+// Function signature for combined read callbacks.
+//
+// - `arg1` (`returncode_t`): Status of the read.
+// - `arg2` (`libtock_ninedof_sample_t*`): The sample being filled.
+// - `arg3` (`void*`): The opaque pointer passed to
+//   `libtock_ninedof_read_all()`.
+typedef void (*libtock_ninedof_sample_callback)(returncode_t, libtock_ninedof_sample_t*, void*);
+
+typedef struct {
+  libtock_ninedof_sample_t* sample;
+  uint8_t stage;
+  libtock_ninedof_sample_callback cb;
+  void* opaque;
+} libtock_ninedof_reader_t;
+
+// Read the accelerometer, magnetometer and gyroscope into `sample` with one
+// callback at the end. The driver reads one sensor per command, so the next
+// read is started from the upcall of the previous one. Sensors the board
+// does not have are skipped and left out of `sample->valid`.
+//
+// Returns the error of the last sensor, with no callback, if none of them
+// could be read.
+returncode_t libtock_ninedof_read_all(libtock_ninedof_reader_t* reader, libtock_ninedof_sample_t* sample,
+                                      libtock_ninedof_sample_callback cb, void* opaque);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,4 +1,4 @@
-#include <stdlib.h>
+#include "../services/dma_buffer.h"
 
 #include "touch.h"
 
@@ -83,7 +83,7 @@ returncode_t libtock_touch_disable_multi_touch(void) {
 
 returncode_t libtock_touch_allocate_multi_touch_buffer(int max_touches, libtock_touch_event_t** buffer) {
   libtock_touch_event_t* multi_touch_buffer;
-  multi_touch_buffer = (libtock_touch_event_t*) malloc(max_touches * sizeof(libtock_touch_event_t));
+  multi_touch_buffer = (libtock_touch_event_t*) libtock_dma_buffer_alloc(max_touches * sizeof(libtock_touch_event_t));
 
   if (multi_touch_buffer == NULL) {
     return RETURNCODE_ENOMEM;
@@ -73,6 +73,8 @@ returncode_t libtock_touch_enable_multi_touch(libtock_touch_event_t* buffer, int
 
 returncode_t libtock_touch_disable_multi_touch(void);
 
+// Allocate a buffer for `max_touches` events from
+// `libtock/services/dma_buffer.h`. Free it with `libtock_dma_buffer_free()`.
 returncode_t libtock_touch_allocate_multi_touch_buffer(int max_touches, libtock_touch_event_t** buffer);
 
 returncode_t libtock_touch_get_gestures(libtock_touch_gesture_callback cb);
@@ -0,0 +1,136 @@
+#include "../storage/nonvolatile_storage.h"
+#include "../storage/sdcard.h"
+#include "adc_recorder.h"
+
+// The storage callbacks carry no context, so the recording is global.
+static struct {
+  bool running;
+  bool sampling;
+  libtock_adc_recorder_target_t target;
+  uint32_t start;
+  uint32_t limit;
+  uint32_t written;
+  uint32_t buffer_bytes;
+  // Buffer being written, NULL while storage is idle.
+  uint16_t* writing;
+  libtock_adc_ring_t ring;
+  libtock_adc_recorder_callback cb;
+} recorder;
+
+static void stop_sampling(void) {
+  if (recorder.sampling) {
+    libtock_adc_ring_stop(&recorder.ring);
+    recorder.sampling = false;
+  }
+}
+
+static void finish(returncode_t ret) {
+  stop_sampling();
+  recorder.running = false;
+  recorder.cb(ret, recorder.written);
+}
+
+static void write_done(returncode_t ret);
+
+static void nonvolatile_done(returncode_t ret, __attribute__ ((unused)) int length) {
+  write_done(ret);
+}
+
+static void sdcard_done(returncode_t ret) {
+  write_done(ret);
+}
+
+// Start writing the oldest filled buffer, if there is one.
+static void write_next(void) {
+  uint32_t length;
+  uint16_t* buffer = libtock_adc_ring_acquire(&recorder.ring, &length);
+  if (buffer == NULL) {
+    if (!recorder.sampling) finish(RETURNCODE_SUCCESS);
+    return;
+  }
+
+  returncode_t ret;
+  uint32_t bytes = recorder.buffer_bytes;
+  if (recorder.target == LIBTOCK_ADC_RECORDER_NONVOLATILE) {
+    ret = libtock_nonvolatile_storage_write(recorder.start + recorder.written, bytes, (uint8_t*) buffer, bytes,
+                                            nonvolatile_done);
+  } else {
+    ret = libtock_sdcard_write_blocks(recorder.start + recorder.written / LIBTOCK_ADC_RECORDER_SD_BLOCK,
+                                      bytes / LIBTOCK_ADC_RECORDER_SD_BLOCK, (uint8_t*) buffer, bytes, sdcard_done);
+  }
+
+  recorder.writing = buffer;
+  if (ret != RETURNCODE_SUCCESS) write_done(ret);
+}
+
+static void write_done(returncode_t ret) {
+  libtock_adc_ring_release(&recorder.ring, recorder.writing);
+  recorder.writing = NULL;
+  if (ret != RETURNCODE_SUCCESS) {
+    finish(ret);
+    return;
+  }
+
+  recorder.written += recorder.buffer_bytes;
+  if (recorder.limit != 0 && recorder.written >= recorder.limit) {
+    finish(RETURNCODE_SUCCESS);
+    return;
+  }
+  write_next();
+}
+
+static void ring_filled(__attribute__ ((unused)) void* opaque) {
+  if (recorder.running && recorder.writing == NULL) write_next();
+}
+
+returncode_t libtock_adc_recorder_start(libtock_adc_recorder_target_t target, uint32_t start, uint32_t limit,
+                                        uint8_t channel, uint32_t frequency,
+                                        uint16_t* buffers, uint8_t count, uint32_t length,
+                                        libtock_adc_recorder_callback cb) {
+  if (recorder.running) return RETURNCODE_EBUSY;
+
+  uint32_t buffer_bytes = length * sizeof(uint16_t);
+  if (buffer_bytes == 0) return RETURNCODE_EINVAL;
+  if (target == LIBTOCK_ADC_RECORDER_SDCARD && buffer_bytes % LIBTOCK_ADC_RECORDER_SD_BLOCK != 0) {
+    return RETURNCODE_EINVAL;
+  }
+  // A limit below one buffer would record nothing.
+  if (limit != 0 && limit < buffer_bytes) return RETURNCODE_EINVAL;
+
+  recorder.target       = target;
+  recorder.start        = start;
+  recorder.limit        = limit - limit % buffer_bytes;
+  recorder.written      = 0;
+  recorder.buffer_bytes = buffer_bytes;
+  recorder.writing      = NULL;
+  recorder.cb           = cb;
+
+  returncode_t ret = libtock_adc_ring_start(&recorder.ring, channel, frequency, buffers, count, length,
+                                            ring_filled, NULL);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  recorder.running  = true;
+  recorder.sampling = true;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_adc_recorder_stop(void) {
+  if (!recorder.running) return RETURNCODE_EALREADY;
+
+  stop_sampling();
+  // Filled buffers are written as soon as they arrive, so with storage idle
+  // there is nothing left.
+  if (recorder.writing == NULL) {
+    recorder.running = false;
+    return RETURNCODE_EALREADY;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+uint32_t libtock_adc_recorder_written(void) {
+  return recorder.written;
+}
+
+uint32_t libtock_adc_recorder_overruns(void) {
+  return libtock_adc_ring_overruns(&recorder.ring);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../peripherals/adc.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Record continuous ADC samples straight to storage.
+//
+// The recorder samples into an ADC buffer ring (see `libtock_adc_ring_start()`)
+// and writes each filled buffer from the ring to nonvolatile storage or an SD
+// card as soon as the previous write is done, so sampling never waits for
+// storage. Buffers are written in place and go back to the ring when their
+// write completes. If storage falls behind by more buffers than the ring
+// holds, the oldest unwritten buffer is dropped and counted in
+// `libtock_adc_recorder_overruns()`.
+//
+// Samples are stored as raw little-endian `uint16_t` values, one buffer after
+// the other. Only one recording can run at a time.
+
+// Size of an SD card block. Recording to an SD card writes whole buffers as
+// blocks, so buffers must be a multiple of this many bytes.
+#ifndef LIBTOCK_ADC_RECORDER_SD_BLOCK
+#define LIBTOCK_ADC_RECORDER_SD_BLOCK 512
+#endif
+
+typedef enum {
+  LIBTOCK_ADC_RECORDER_NONVOLATILE,
+  LIBTOCK_ADC_RECORDER_SDCARD,
+} libtock_adc_recorder_target_t;
+
+// Function signature for the recorder callback, called once when the
+// recording ends.
+//
+// - `arg1` (`returncode_t`): RETURNCODE_SUCCESS if the limit was reached or
+//   the recording was stopped, otherwise the error of the failed write.
+// - `arg2` (`uint32_t`): Number of bytes stored.
+typedef void (*libtock_adc_recorder_callback)(returncode_t, uint32_t);
+
+// Start recording `channel` at `frequency` into `count` buffers of `length`
+// samples each, stored back to back in `buffers`.
+//
+// For nonvolatile storage `start` is the byte offset of the recording, for an
+// SD card it is the first sector. Recording ends after `limit` bytes, rounded
+// down to whole buffers, or when it is stopped if `limit` is 0.
+//
+// Returns RETURNCODE_EBUSY if a recording is running and RETURNCODE_EINVAL if
+// the ring cannot be built from the buffers or SD card buffers are not whole
+// blocks.
+returncode_t libtock_adc_recorder_start(libtock_adc_recorder_target_t target, uint32_t start, uint32_t limit,
+                                        uint8_t channel, uint32_t frequency,
+                                        uint16_t* buffers, uint8_t count, uint32_t length,
+                                        libtock_adc_recorder_callback cb);
+
+// Stop sampling. Buffers filled so far are still written, and the callback
+// is called after the last of them.
+//
+// Returns RETURNCODE_EALREADY if there was nothing left to write, in which
+// case the recording is over and the callback is not called.
+returncode_t libtock_adc_recorder_stop(void);
+
+// Number of bytes stored so far.
+uint32_t libtock_adc_recorder_written(void);
+
+// Number of filled buffers dropped because storage did not keep up.
+uint32_t libtock_adc_recorder_overruns(void);
+
+#ifdef __cplusplus
+}
+#endif
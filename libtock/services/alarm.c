@@ -1,13 +1,82 @@
 #include "alarm.h"
+#include "../kernel/idle_hint.h"
 #include <assert.h>
 #include <limits.h>
 #include <stdlib.h>
 
 #define MAX_TICKS UINT32_MAX
 
-// Returns 0 if a <= b < c, 1 otherwise
-static int within_range(uint32_t a, uint32_t b, uint32_t c) {
-  return (b - a) < (b - c);
+// A precomputed ratio `num / den` used to scale values without dividing.
+//
+// `integer` and `fraction` hold the ratio in 32.32 fixed point. When `den` is
+// a power of two, `shift` is its log2 and scaling is a multiply and a shift.
+typedef struct {
+  uint32_t num;
+  uint32_t den;
+  uint32_t integer;
+  uint32_t fraction;
+  int8_t shift;
+} ratio_t;
+
+static void ratio_init(ratio_t* ratio, uint32_t num, uint32_t den) {
+  ratio->num      = num;
+  ratio->den      = den;
+  ratio->integer  = num / den;
+  ratio->fraction = (uint32_t) (((uint64_t) (num % den) << 32) / den);
+  ratio->shift    = -1;
+  if ((den & (den - 1)) == 0) {
+    ratio->shift = (int8_t) __builtin_ctz(den);
+  }
+}
+
+// Returns floor(value * num / den) exactly.
+static uint64_t ratio_scale(const ratio_t* ratio, uint32_t value) {
+  uint64_t product = (uint64_t) value * ratio->num;
+  if (ratio->shift >= 0) {
+    return product >> ratio->shift;
+  }
+
+  uint64_t result = (uint64_t) value * ratio->integer;
+  if (ratio->fraction != 0) {
+    result += ((uint64_t) value * ratio->fraction) >> 32;
+    // The truncated fraction can leave the result one short.
+    if ((result + 1) * ratio->den <= product) {
+      result++;
+    }
+  }
+  return result;
+}
+
+// The alarm frequency and conversion ratios, set up on first use. The
+// frequency cannot change while the process runs.
+static struct {
+  uint32_t frequency;
+  ratio_t ms_to_ticks;
+  ratio_t ticks_to_ms;
+  ratio_t us_to_ticks;
+} clock_info = { .frequency = 0 };
+
+static void clock_init(void) {
+  if (clock_info.frequency != 0) {
+    return;
+  }
+  uint32_t frequency = 0;
+  libtock_alarm_command_get_frequency(&frequency);
+  assert(frequency > 0);
+
+  ratio_init(&clock_info.ms_to_ticks, frequency, 1000);
+  ratio_init(&clock_info.ticks_to_ms, 1000, frequency);
+  ratio_init(&clock_info.us_to_ticks, frequency, 1000000);
+  clock_info.frequency = frequency;
+}
+
+returncode_t libtock_alarm_get_frequency(uint32_t* frequency) {
+  if (clock_info.frequency == 0) {
+    if (!libtock_alarm_exists()) return RETURNCODE_ENODEVICE;
+    clock_init();
+  }
+  *frequency = clock_info.frequency;
+  return RETURNCODE_SUCCESS;
 }
 
 /** \brief Convert milliseconds to clock ticks
@@ -15,129 +84,251 @@ static int within_range(uint32_t a, uint32_t b, uint32_t c) {
  * WARNING: This function will assert if the output
  * number of ticks overflows `UINT32_MAX`.
  *
- * This conversion is accurate to within 1 millisecond of a true
- * fractional conversion.
+ * The result is the exact conversion rounded down. It is computed with
+ * precomputed fixed-point ratios, so no division is done after the first call.
  *
  * \param ms the milliseconds to convert to ticks
  * \return ticks a number of clock ticks that
  * correspond to the given number of milliseconds
  */
 static uint32_t ms_to_ticks(uint32_t ms) {
-  // This conversion has a max error of 1ms.
-  // View the justification here https://github.com/tock/libtock-c/pull/434
-  uint32_t frequency;
-  libtock_alarm_command_get_frequency(&frequency);
-
-  uint32_t seconds                 = ms / 1000;
-  uint32_t leftover_millis         = ms % 1000;
-  uint32_t milliseconds_per_second = 1000;
-
-  // ticks needs to be 64 bits because the kernel may scale frequency several magnitudes
-  uint64_t ticks = (uint64_t) seconds * frequency;
-  ticks += ((uint64_t) leftover_millis * frequency) / milliseconds_per_second;
+  clock_init();
+  uint64_t ticks = ratio_scale(&clock_info.ms_to_ticks, ms);
 
   assert(ticks <= UINT32_MAX); // check for overflow before 64 -> 32 bit conversion
   return ticks;
 }
 
+// Convert clock ticks to milliseconds, rounded down.
 static uint32_t ticks_to_ms(uint32_t ticks) {
-  // `ticks_to_ms`'s conversion will be accurate to within the range
-  // 0 to 1 milliseconds less than the exact conversion
-  // (true millisecond conversion - [0,1) milliseconds).
-
-  uint32_t frequency;
-  libtock_alarm_command_get_frequency(&frequency);
+  clock_init();
+  return (uint32_t) ratio_scale(&clock_info.ticks_to_ms, ticks);
+}
 
-  uint32_t seconds = (ticks / frequency);
-  uint32_t milliseconds_per_second = 1000;
+// Outstanding alarms are kept in a pairing heap ordered by expiration, so
+// inserting is O(1) and removing the next or any other alarm is O(log n)
+// amortized. Each alarm links to its first child (`child`), its next sibling
+// (`next`), and its previous sibling or, for a first child, its parent
+// (`prev`). The root has no `prev`.
+static libtock_alarm_ticks_t* root = NULL;
 
-  // Calculate the conversion of full seconds to ticks.
-  uint32_t milliseconds = seconds * milliseconds_per_second;
+// Expirations are compared as offsets from `heap_base`, a time no later than
+// any outstanding expiration. This keeps the order correct when the clock
+// wraps. `heap_base` only moves forward, by at most the offset of the root.
+static uint32_t heap_base = 0;
+
+// Ticks from `heap_base` until `alarm` expires, or 0 if it expired before
+// `heap_base`.
+static uint32_t alarm_key(const libtock_alarm_ticks_t* alarm) {
+  uint32_t since_reference = heap_base - alarm->reference;
+  if ((int32_t) since_reference > 0) {
+    // The reference is before `heap_base`.
+    return alarm->dt > since_reference ? alarm->dt - since_reference : 0;
+  }
+  return alarm->reference + alarm->dt - heap_base;
+}
 
-  // To get conversion accuracy within 1 millisecond, the conversion
-  // must also convert partial seconds.
-  uint32_t leftover_ticks = ticks % frequency;
+// Meld two detached heaps, returning the new root.
+static libtock_alarm_ticks_t* heap_meld(libtock_alarm_ticks_t* a, libtock_alarm_ticks_t* b) {
+  if (a == NULL) {
+    return b;
+  }
+  if (b == NULL) {
+    return a;
+  }
+  if (alarm_key(b) < alarm_key(a)) {
+    libtock_alarm_ticks_t* tmp = a;
+    a = b;
+    b = tmp;
+  }
+  // `b` becomes the first child of `a`.
+  b->prev = a;
+  b->next = a->child;
+  if (a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+  return a;
+}
 
-  // This calculation is mathematically equivalent to doing:
-  //
-  //   `leftover_ticks` / (`frequency` / `milliseconds_per_second`)
-  //
-  // This is taking the remaining unconverted ticks (leftover_ticks)
-  // and dividing by the number of ticks per millisecond
-  // (`frequency` (ticks per second) / `1000` milliseconds per second)
-  // The division is done this way because of the same argument in
-  // `ms_to_ticks`.
-  milliseconds += (leftover_ticks * milliseconds_per_second) / frequency;
+// Meld a list of sibling heaps into one using the standard two-pass pairing.
+static libtock_alarm_ticks_t* heap_merge_pairs(libtock_alarm_ticks_t* first) {
+  // Left to right, meld siblings in pairs and stack the results through
+  // `prev`.
+  libtock_alarm_ticks_t* stack = NULL;
+  while (first != NULL) {
+    libtock_alarm_ticks_t* a = first;
+    libtock_alarm_ticks_t* b = a->next;
+    first   = b != NULL ? b->next : NULL;
+    a->next = NULL;
+    a->prev = NULL;
+    if (b != NULL) {
+      b->next = NULL;
+      b->prev = NULL;
+    }
+    libtock_alarm_ticks_t* pair = heap_meld(a, b);
+    pair->prev = stack;
+    stack      = pair;
+  }
 
-  return milliseconds;
+  // Right to left, meld the pairs together.
+  libtock_alarm_ticks_t* result = NULL;
+  while (stack != NULL) {
+    libtock_alarm_ticks_t* next = stack->prev;
+    stack->prev = NULL;
+    result      = heap_meld(stack, result);
+    stack       = next;
+  }
+  return result;
 }
 
-static libtock_alarm_ticks_t* root = NULL;
+static void heap_insert(libtock_alarm_ticks_t* alarm) {
+  alarm->next  = NULL;
+  alarm->prev  = NULL;
+  alarm->child = NULL;
 
-static void root_insert(libtock_alarm_ticks_t* alarm) {
-  if (root == NULL) {
-    root       = alarm;
-    root->next = NULL;
-    root->prev = NULL;
-    return;
+  // Move the base up to the new reference when that keeps it at or before
+  // every expiration, so references stay close to the base.
+  if (root == NULL || alarm->reference - heap_base <= alarm_key(root)) {
+    heap_base = alarm->reference;
   }
+  root = heap_meld(root, alarm);
+}
+
+// Parent of a non-root alarm.
+static libtock_alarm_ticks_t* heap_parent(libtock_alarm_ticks_t* alarm) {
+  while (alarm->prev->child != alarm) {
+    alarm = alarm->prev;
+  }
+  return alarm->prev;
+}
 
-  libtock_alarm_ticks_t** cur = &root;
-  libtock_alarm_ticks_t* prev = NULL;
-  while (*cur != NULL) {
-    uint32_t cur_expiration = (*cur)->reference + (*cur)->dt;
-    uint32_t new_expiration = alarm->reference + alarm->dt;
-    if (!within_range(alarm->reference, cur_expiration, new_expiration)) {
-      // insert before
-      libtock_alarm_ticks_t* tmp = *cur;
-      *cur        = alarm;
-      alarm->next = tmp;
-      alarm->prev = prev;
-      tmp->prev   = alarm;
-      return;
+// The latest time, relative to `heap_base`, that the kernel alarm may fire:
+// the earliest expiration plus slack of any outstanding alarm.
+//
+// Descendants expire no earlier than their ancestors, so only the subtrees of
+// alarms expiring before the best deadline found so far are visited.
+static uint32_t heap_earliest_deadline(void) {
+  uint32_t best = UINT32_MAX;
+  libtock_alarm_ticks_t* alarm = root;
+  while (alarm != NULL) {
+    uint32_t key = alarm_key(alarm);
+    if (key < best) {
+      uint32_t deadline = key + alarm->slack;
+      if (deadline < key) {
+        deadline = UINT32_MAX;
+      }
+      if (deadline < best) {
+        best = deadline;
+      }
+      if (alarm->child != NULL) {
+        alarm = alarm->child;
+        continue;
+      }
     }
-    prev = *cur;
-    cur  = &prev->next;
+    // Move on to the next sibling, climbing up past finished subtrees.
+    while (alarm != root && alarm->next == NULL) {
+      alarm = heap_parent(alarm);
+    }
+    alarm = alarm == root ? NULL : alarm->next;
   }
-  // didn't return, so prev points to the last in the list
-  prev->next  = alarm;
-  alarm->prev = prev;
-  alarm->next = NULL;
+  return best;
+}
 
+static bool heap_contains(const libtock_alarm_ticks_t* alarm) {
+  return alarm == root || alarm->prev != NULL;
 }
 
-static libtock_alarm_ticks_t* root_pop(void) {
-  if (root == NULL) {
-    return NULL;
+static void heap_remove(libtock_alarm_ticks_t* alarm) {
+  if (alarm == root) {
+    root = heap_merge_pairs(alarm->child);
   } else {
-    libtock_alarm_ticks_t* res = root;
-    root = root->next;
-    if (root != NULL) {
-      root->prev = NULL;
+    if (alarm->prev->child == alarm) {
+      alarm->prev->child = alarm->next;
+    } else {
+      alarm->prev->next = alarm->next;
+    }
+    if (alarm->next != NULL) {
+      alarm->next->prev = alarm->prev;
     }
-    res->next = NULL;
-    return res;
+    root = heap_meld(root, heap_merge_pairs(alarm->child));
   }
+  alarm->next  = NULL;
+  alarm->prev  = NULL;
+  alarm->child = NULL;
 }
 
-static libtock_alarm_ticks_t* root_peek(void) {
-  return root;
+// Whether the kernel alarm is set, and the absolute time it fires at.
+static bool armed = false;
+static uint32_t armed_at;
+
+// Number of the alarm upcall running now, 0 outside of one.
+static uint32_t upcall_running = 0;
+static uint32_t upcalls        = 0;
+
+static void alarm_upcall(int, int, int, void*);
+
+// Set the kernel alarm for the earliest deadline of the outstanding alarms.
+static int heap_arm(void) {
+  uint32_t deadline = heap_earliest_deadline();
+  armed    = true;
+  armed_at = heap_base + deadline;
+  libtock_idle_hint_set_wakeup(heap_base + alarm_key(root), armed_at);
+  libtock_alarm_set_upcall((subscribe_upcall*)alarm_upcall, NULL);
+  return libtock_alarm_command_set_absolute(heap_base, deadline);
 }
 
-static void alarm_upcall(__attribute__ ((unused)) int   kernel_now,
+// Whether `alarm` had expired at `now`.
+static bool alarm_expired(const libtock_alarm_ticks_t* alarm, uint32_t now) {
+  uint32_t elapsed = now - alarm->reference;
+  if ((int32_t) elapsed < 0) {
+    // Set after `now`, or more than 2^31 ticks ago. The reference is never
+    // after the current time, so that tells the two apart.
+    uint32_t current = now;
+    libtock_alarm_command_read(&current);
+    elapsed = current - alarm->reference;
+  }
+  return alarm->dt <= elapsed;
+}
+
+// Runs every alarm that had expired when the kernel scheduled this upcall.
+//
+// All expirations are checked against the `kernel_now` timestamp passed to the
+// upcall rather than a fresh clock read, so draining any number of expired
+// alarms costs only the final re-arm syscall. An alarm that expires while the
+// callbacks run is left in the queue. The kernel alarm for it is already in
+// the past, so it fires right away in the next upcall.
+//
+// So does any alarm a callback sets. Its reference comes from a later clock
+// read than `kernel_now`, so `now - reference` would wrap and make it look
+// expired, and a callback setting a zero-length alarm would never leave
+// the loop.
+//
+// An alarm set after the kernel stamped the upcall but before it ran, from
+// main code or an earlier upcall, has the same wrapped reference, so
+// `alarm_expired()` checks references that look later than `now` against a
+// fresh clock read.
+static void alarm_upcall(int                            kernel_now,
                          __attribute__ ((unused)) int   scheduled,
                          __attribute__ ((unused)) int   unused2,
                          __attribute__ ((unused)) void* opaque) {
-  for (libtock_alarm_ticks_t* alarm = root_peek(); alarm != NULL; alarm = root_peek()) {
-    uint32_t now;
-    libtock_alarm_command_read(&now);
-    // has the alarm not expired yet? (distance from `now` has to be larger or
-    // equal to distance from current clock value.
-    if (alarm->dt > now - alarm->reference) {
-      libtock_alarm_command_set_absolute(alarm->reference, alarm->dt);
+  uint32_t now = (uint32_t) kernel_now;
+
+  if (++upcalls == 0) upcalls = 1;
+  upcall_running = upcalls;
+  armed          = false;
+  for (libtock_alarm_ticks_t* alarm = root; alarm != NULL; alarm = root) {
+    if (alarm->upcall == upcall_running || !alarm_expired(alarm, now)) {
+      // A callback may already have armed the kernel alarm for this
+      // deadline.
+      if (!armed || armed_at != heap_base + heap_earliest_deadline()) {
+        heap_arm();
+      }
       break;
     } else {
-      root_pop();
+      // Every remaining alarm expires at or after this one.
+      heap_base += alarm_key(alarm);
+      heap_remove(alarm);
 
       if (alarm->callback) {
         uint32_t expiration = alarm->reference + alarm->dt;
@@ -145,53 +336,54 @@ static void alarm_upcall(__attribute__ ((unused)) int   kernel_now,
       }
     }
   }
+  if (root == NULL) libtock_idle_hint_clear_wakeup();
+  upcall_running = 0;
 }
 
-static int libtock_alarm_at_internal(uint32_t reference, uint32_t dt, libtock_alarm_callback cb, void* ud,
-                                     libtock_alarm_ticks_t* alarm) {
+static int libtock_alarm_at_internal(uint32_t reference, uint32_t dt, uint32_t slack, libtock_alarm_callback cb,
+                                     void* ud, libtock_alarm_ticks_t* alarm) {
   alarm->reference = reference;
   alarm->dt        = dt;
+  alarm->slack     = slack;
   alarm->callback  = cb;
   alarm->ud        = ud;
-  alarm->prev      = NULL;
-  alarm->next      = NULL;
+  alarm->upcall    = upcall_running;
 
-  root_insert(alarm);
-  int i = 0;
-  for (libtock_alarm_ticks_t* cur = root_peek(); cur != NULL; cur = cur->next) {
-    i++;
-  }
-
-  if (root_peek() == alarm) {
-    libtock_alarm_set_upcall((subscribe_upcall*)alarm_upcall, NULL);
+  heap_insert(alarm);
 
-    return libtock_alarm_command_set_absolute(alarm->reference, alarm->dt);
+  // The kernel alarm only needs to move if this alarm's window closes before
+  // the currently armed time.
+  uint32_t deadline = alarm_key(alarm) + slack;
+  if (deadline < alarm_key(alarm)) {
+    deadline = UINT32_MAX;
+  }
+  if (!armed || deadline < armed_at - heap_base) {
+    return heap_arm();
   }
   return RETURNCODE_SUCCESS;
 }
 
 int libtock_alarm_at(uint32_t reference, uint32_t dt, libtock_alarm_callback cb, void* opaque,
                      libtock_alarm_ticks_t* alarm) {
-  return libtock_alarm_at_internal(reference, dt, cb, opaque, alarm);
+  return libtock_alarm_at_internal(reference, dt, 0, cb, opaque, alarm);
 }
 
 void libtock_alarm_cancel(libtock_alarm_ticks_t* alarm) {
-  if (alarm->prev != NULL) {
-    alarm->prev->next = alarm->next;
-  }
-  if (alarm->next != NULL) {
-    alarm->next->prev = alarm->prev;
+  if (!heap_contains(alarm)) {
+    return;
   }
 
-  if (root == alarm) {
-    root = alarm->next;
-    if (root != NULL) {
-      libtock_alarm_command_set_absolute(root->reference, root->dt);
-    }
-  }
+  bool was_root = alarm == root;
+  heap_remove(alarm);
 
-  alarm->prev = NULL;
-  alarm->next = NULL;
+  if (root == NULL) {
+    // Any pending kernel alarm now fires into an empty queue, which is
+    // harmless, but the next alarm must set its own time.
+    armed = false;
+    libtock_idle_hint_clear_wakeup();
+  } else if (was_root) {
+    heap_arm();
+  }
 }
 
 // The intermediate callback that handles overflows of alarm. This is used by
@@ -205,11 +397,12 @@ static void overflow_callback(__attribute__ ((unused)) uint32_t now,
 
   if (tock_timer->overflows_left == 0) {
     // no overflows left, schedule last alarm with original callback
-    libtock_alarm_at(last_timer_fire_time,
-                     tock_timer->remaining_ticks,
-                     tock_timer->callback,
-                     tock_timer->user_data,
-                     &(tock_timer->alarm));
+    libtock_alarm_at_internal(last_timer_fire_time,
+                              tock_timer->remaining_ticks,
+                              tock_timer->slack_ticks,
+                              tock_timer->callback,
+                              tock_timer->user_data,
+                              &(tock_timer->alarm));
   } else {
     // schedule next intermediate alarm that will overflow
     tock_timer->overflows_left--;
@@ -222,7 +415,10 @@ static void overflow_callback(__attribute__ ((unused)) uint32_t now,
   }
 }
 
-int libtock_alarm_in_ms(uint32_t ms, libtock_alarm_callback cb, void* opaque, libtock_alarm_t* alarm) {
+static int alarm_in_ms_internal(uint32_t ms, uint32_t slack_ticks, libtock_alarm_callback cb, void* opaque,
+                                libtock_alarm_t* alarm) {
+  alarm->slack_ticks = slack_ticks;
+
   uint32_t now;
   int ret = libtock_alarm_command_read(&now);
   if (ret != RETURNCODE_SUCCESS) return ret;
@@ -246,10 +442,36 @@ int libtock_alarm_in_ms(uint32_t ms, libtock_alarm_callback cb, void* opaque, li
                             &(alarm->alarm));
   } else {
     // No overflows needed
-    return libtock_alarm_at(now, ms_to_ticks(ms), cb, opaque, &(alarm->alarm));
+    return libtock_alarm_at_internal(now, ms_to_ticks(ms), slack_ticks, cb, opaque, &(alarm->alarm));
   }
 }
 
+int libtock_alarm_in_ms(uint32_t ms, libtock_alarm_callback cb, void* opaque, libtock_alarm_t* alarm) {
+  return alarm_in_ms_internal(ms, 0, cb, opaque, alarm);
+}
+
+int libtock_alarm_in_ms_with_slack(uint32_t ms, uint32_t slack_ms, libtock_alarm_callback cb, void* opaque,
+                                   libtock_alarm_t* alarm) {
+  return alarm_in_ms_internal(ms, ms_to_ticks(slack_ms), cb, opaque, alarm);
+}
+
+int libtock_alarm_in_us(uint32_t us, libtock_alarm_callback cb, void* opaque, libtock_alarm_t* alarm) {
+  clock_init();
+  uint64_t ticks = ratio_scale(&clock_info.us_to_ticks, us);
+  if (ticks > MAX_TICKS) {
+    // Too long for a single alarm, sub-millisecond precision does not matter
+    // at this length.
+    return libtock_alarm_in_ms(us / 1000, cb, opaque, alarm);
+  }
+
+  uint32_t now;
+  int ret = libtock_alarm_command_read(&now);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  alarm->slack_ticks = 0;
+  return libtock_alarm_at_internal(now, (uint32_t) ticks, 0, cb, opaque, &(alarm->alarm));
+}
+
 static void alarm_repeating_cb(uint32_t now, __attribute__ ((unused)) uint32_t scheduled, void* opaque) {
   libtock_alarm_t* repeating = (libtock_alarm_t*) opaque;
   uint32_t interval_ms       = repeating->interval_ms;
@@ -257,18 +479,26 @@ static void alarm_repeating_cb(uint32_t now, __attribute__ ((unused)) uint32_t s
   // than 2^32 ticks, but the wraparound gives use the expiration time we want.
   uint32_t cur_exp = repeating->alarm.reference + ms_to_ticks(interval_ms);
 
-  libtock_alarm_in_ms(interval_ms, (libtock_alarm_callback)alarm_repeating_cb, (void*)repeating, repeating);
+  alarm_in_ms_internal(interval_ms, repeating->slack_ticks, (libtock_alarm_callback)alarm_repeating_cb,
+                       (void*)repeating, repeating);
   repeating->callback(now, cur_exp, repeating->user_data);
 }
 
 
 void libtock_alarm_repeating_every_ms(uint32_t ms, libtock_alarm_callback cb, void* opaque,
                                       libtock_alarm_t* repeating) {
+  libtock_alarm_repeating_every_ms_with_slack(ms, 0, cb, opaque, repeating);
+}
+
+void libtock_alarm_repeating_every_ms_with_slack(uint32_t ms, uint32_t slack_ms, libtock_alarm_callback cb,
+                                                 void* opaque, libtock_alarm_t* repeating) {
   repeating->interval_ms = ms;
+  repeating->slack_ticks = ms_to_ticks(slack_ms);
   repeating->callback    = cb;
   repeating->user_data   = opaque;
 
-  libtock_alarm_in_ms(ms, (libtock_alarm_callback)alarm_repeating_cb, (void*)repeating, repeating);
+  alarm_in_ms_internal(ms, repeating->slack_ticks, (libtock_alarm_callback)alarm_repeating_cb, (void*)repeating,
+                       repeating);
 }
 
 void libtock_alarm_ms_cancel(libtock_alarm_t* alarm) {
@@ -279,11 +509,10 @@ int libtock_alarm_gettimeasticks(struct timeval* tv, __attribute__ ((unused)) vo
   uint32_t frequency, now, seconds, remainder;
   const uint32_t microsecond_scaler = 1000000;
 
-  libtock_alarm_command_get_frequency(&frequency);
+  clock_init();
+  frequency = clock_info.frequency;
   libtock_alarm_command_read(&now);
 
-  assert(frequency > 0);
-
   // Obtain seconds and remainder due to integer divison
   seconds   = now / frequency;
   remainder = now % frequency;
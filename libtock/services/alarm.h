@@ -39,10 +39,17 @@ typedef void (*libtock_alarm_callback)(uint32_t, uint32_t, void*);
 typedef struct alarm {
   uint32_t reference;
   uint32_t dt;
+  // Ticks the alarm may fire late by, so it can share an upcall with other
+  // alarms.
+  uint32_t slack;
   libtock_alarm_callback callback;
   void* ud;
+  // The alarm upcall that was running when the alarm was set, 0 if none.
+  uint32_t upcall;
+  // Links in the queue of outstanding alarms.
   struct alarm* next;
   struct alarm* prev;
+  struct alarm* child;
 } libtock_alarm_ticks_t;
 
 /** \brief Opaque handle to a repeating alarm.
@@ -59,6 +66,8 @@ typedef struct alarm_data {
   // Number of ticks remaining after the last time the
   // counter overflows.
   uint32_t remaining_ticks;
+  // Slack in ticks for the final alarm of the interval.
+  uint32_t slack_ticks;
   libtock_alarm_callback callback;
   void* user_data;
   libtock_alarm_ticks_t alarm;
@@ -92,6 +101,10 @@ int libtock_alarm_at(uint32_t reference, uint32_t dt, libtock_alarm_callback cal
  */
 void libtock_alarm_cancel(libtock_alarm_ticks_t* alarm);
 
+// Get the alarm frequency in Hz. It is read from the kernel once and then
+// cached, so every module can ask for it without a system call.
+returncode_t libtock_alarm_get_frequency(uint32_t* frequency);
+
 // Use this to implement _gettimeofday yourself as libtock-c doesn't provide
 // an implementation.
 //
@@ -121,6 +134,40 @@ int libtock_alarm_gettimeasticks(struct timeval* tv, void* tzvp);
  */
 int libtock_alarm_in_ms(uint32_t ms, libtock_alarm_callback cb, void* opaque, libtock_alarm_t* alarm);
 
+/** \brief Create a new alarm to fire in `us` microseconds.
+ *
+ * The `alarm` parameter is allocated by the caller and must live as long as
+ * the alarm is outstanding.
+ *
+ * The delay is rounded down to whole clock ticks, so the resolution depends on
+ * the alarm frequency (about 30 us at 32 kHz). Delays longer than 2^32 ticks
+ * fall back to `libtock_alarm_in_ms` with millisecond resolution.
+ *
+ * \param us the number of microseconds to fire the alarm after.
+ * \param cb a callback to be invoked when the alarm expires.
+ * \param opaque pointer passed to the callback.
+ * \param alarm handle to the alarm that was created.
+ * \return An error code. Either RETURNCODE_SUCCESS or RETURNCODE_FAIL.
+ */
+int libtock_alarm_in_us(uint32_t us, libtock_alarm_callback cb, void* opaque, libtock_alarm_t* alarm);
+
+/** \brief Create a new alarm to fire in `ms` milliseconds, up to `slack_ms` late.
+ *
+ * Like `libtock_alarm_in_ms`, but the alarm service may delay this alarm by up
+ * to `slack_ms` so that it fires in the same upcall as other alarms. When the
+ * kernel alarm fires, every alarm whose expiration has passed is run, so
+ * alarms with overlapping windows cost a single wakeup.
+ *
+ * \param ms the number of milliseconds to fire the alarm after.
+ * \param slack_ms how many milliseconds late the alarm may fire.
+ * \param cb a callback to be invoked when the alarm expires.
+ * \param opaque pointer passed to the callback.
+ * \param alarm handle to the alarm that was created.
+ * \return An error code. Either RETURNCODE_SUCCESS or RETURNCODE_FAIL.
+ */
+int libtock_alarm_in_ms_with_slack(uint32_t ms, uint32_t slack_ms, libtock_alarm_callback cb, void* opaque,
+                                   libtock_alarm_t* alarm);
+
 /** \brief Create a new repeating alarm to fire every `ms` milliseconds.
  *
  * The `alarm` parameter is allocated by the caller and must live as long as
@@ -135,6 +182,22 @@ int libtock_alarm_in_ms(uint32_t ms, libtock_alarm_callback cb, void* opaque, li
 void libtock_alarm_repeating_every_ms(uint32_t ms, libtock_alarm_callback cb, void* opaque,
                                       libtock_alarm_t* alarm);
 
+/** \brief Create a new repeating alarm that may fire up to `slack_ms` late.
+ *
+ * See `libtock_alarm_in_ms_with_slack`. As with
+ * `libtock_alarm_repeating_every_ms`, each period starts when the previous
+ * expiration fires.
+ *
+ * \param ms the interval to fire the alarm at in milliseconds.
+ * \param slack_ms how many milliseconds late each expiration may fire.
+ * \param cb a callback to be invoked when the alarm expires.
+ * \param opaque pointer passed to the callback.
+ * \param alarm pointer to a new libtock_alarm_t to be used by the implementation to
+ *        keep track of the alarm.
+ */
+void libtock_alarm_repeating_every_ms_with_slack(uint32_t ms, uint32_t slack_ms, libtock_alarm_callback cb,
+                                                 void* opaque, libtock_alarm_t* alarm);
+
 /** \brief Cancels an existing alarm set in milliseconds.
  *
  * \param alarm to cancel.
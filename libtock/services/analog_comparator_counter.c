@@ -0,0 +1,80 @@
+#include "analog_comparator_counter.h"
+#include "time.h"
+
+// The comparator upcall is shared by all channels and carries no context, so
+// the running counters are global.
+static libtock_analog_comparator_counter_t* counters[LIBTOCK_ANALOG_COMPARATOR_COUNTER_MAX_CHANNELS];
+
+static void window_expired(uint32_t now, uint32_t scheduled, void* opaque);
+
+static void start_window(libtock_analog_comparator_counter_t* counter) {
+  counter->count           = 0;
+  counter->window_start_us = libtock_time_now_us64();
+  if (counter->window_ms != 0) {
+    libtock_alarm_in_ms(counter->window_ms, window_expired, counter, &counter->alarm);
+  }
+}
+
+static void report(libtock_analog_comparator_counter_t* counter) {
+  uint64_t elapsed = libtock_time_now_us64() - counter->window_start_us;
+  uint32_t count   = counter->count;
+
+  libtock_alarm_ms_cancel(&counter->alarm);
+  start_window(counter);
+  counter->cb(counter->channel, count, elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t) elapsed);
+}
+
+static void window_expired(__attribute__ ((unused)) uint32_t now, __attribute__ ((unused)) uint32_t scheduled,
+                           void* opaque) {
+  report((libtock_analog_comparator_counter_t*) opaque);
+}
+
+static void crossing(int channel, __attribute__ ((unused)) int arg1, __attribute__ ((unused)) int arg2,
+                     __attribute__ ((unused)) void* opaque) {
+  for (int i = 0; i < LIBTOCK_ANALOG_COMPARATOR_COUNTER_MAX_CHANNELS; i++) {
+    libtock_analog_comparator_counter_t* counter = counters[i];
+    if (counter == NULL || counter->channel != channel) continue;
+
+    counter->count++;
+    counter->total++;
+    if (counter->crossings != 0 && counter->count >= counter->crossings) report(counter);
+    return;
+  }
+}
+
+returncode_t libtock_analog_comparator_counter_start(libtock_analog_comparator_counter_t* counter, uint8_t channel,
+                                                     uint32_t crossings, uint32_t window_ms,
+                                                     libtock_analog_comparator_counter_callback cb) {
+  if (crossings == 0 && window_ms == 0) return RETURNCODE_EINVAL;
+
+  int slot = -1;
+  for (int i = 0; i < LIBTOCK_ANALOG_COMPARATOR_COUNTER_MAX_CHANNELS; i++) {
+    if (counters[i] != NULL && counters[i]->channel == channel) return RETURNCODE_EBUSY;
+    if (counters[i] == NULL && slot < 0) slot = i;
+  }
+  if (slot < 0) return RETURNCODE_ENOMEM;
+
+  *counter = (libtock_analog_comparator_counter_t) {
+    .channel   = channel,
+    .crossings = crossings,
+    .window_ms = window_ms,
+    .cb        = cb,
+  };
+
+  returncode_t ret = libtock_analog_comparator_set_upcall(crossing, NULL);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtock_analog_comparator_start_comparing(channel);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  counters[slot] = counter;
+  start_window(counter);
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_analog_comparator_counter_stop(libtock_analog_comparator_counter_t* counter) {
+  for (int i = 0; i < LIBTOCK_ANALOG_COMPARATOR_COUNTER_MAX_CHANNELS; i++) {
+    if (counters[i] == counter) counters[i] = NULL;
+  }
+  libtock_alarm_ms_cancel(&counter->alarm);
+  return libtock_analog_comparator_stop_comparing(counter->channel);
+}
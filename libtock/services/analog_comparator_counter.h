@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../peripherals/analog_comparator.h"
+#include "../tock.h"
+#include "alarm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Counting analog comparator crossings in windows.
+//
+// With interrupt-based comparisons the comparator upcalls on every crossing,
+// and an app that handles each one is swamped by a noisy signal. A counter
+// takes over the comparator upcall and only counts crossings there. It calls
+// the app once per window: after `crossings` crossings, or after `window_ms`
+// milliseconds, whichever comes first, with the count and the window's
+// length. That is all a frequency or threshold-rate measurement needs.
+//
+// The kernel keeps one pending upcall per driver, so crossings that happen
+// faster than upcalls are delivered are not counted. The counts are then a
+// lower bound.
+//
+// Counters on different channels can run at the same time.
+
+#ifndef LIBTOCK_ANALOG_COMPARATOR_COUNTER_MAX_CHANNELS
+#define LIBTOCK_ANALOG_COMPARATOR_COUNTER_MAX_CHANNELS 4
+#endif
+
+// Function signature for window callbacks.
+//
+// - `arg1` (`uint8_t`): Channel.
+// - `arg2` (`uint32_t`): Crossings counted in the window.
+// - `arg3` (`uint32_t`): Length of the window in microseconds.
+typedef void (*libtock_analog_comparator_counter_callback)(uint8_t, uint32_t, uint32_t);
+
+typedef struct {
+  uint8_t channel;
+  uint32_t crossings;
+  uint32_t window_ms;
+  libtock_analog_comparator_counter_callback cb;
+  // Crossings in the current window, and when it started.
+  uint32_t count;
+  uint64_t window_start_us;
+  // Crossings since the counter started.
+  uint32_t total;
+  libtock_alarm_t alarm;
+} libtock_analog_comparator_counter_t;
+
+// Count crossings on `channel` and call `cb` after `crossings` crossings or
+// `window_ms` milliseconds. Either may be 0 to only use the other. Starts
+// interrupt-based comparisons on the channel.
+//
+// Returns RETURNCODE_EINVAL if both are 0, RETURNCODE_EBUSY if the channel
+// already has a counter, and RETURNCODE_ENOMEM if
+// `LIBTOCK_ANALOG_COMPARATOR_COUNTER_MAX_CHANNELS` counters are running.
+returncode_t libtock_analog_comparator_counter_start(libtock_analog_comparator_counter_t* counter, uint8_t channel,
+                                                     uint32_t crossings, uint32_t window_ms,
+                                                     libtock_analog_comparator_counter_callback cb);
+
+// Stop counting and stop comparisons on the counter's channel. The
+// crossings of the unfinished window are not reported.
+returncode_t libtock_analog_comparator_counter_stop(libtock_analog_comparator_counter_t* counter);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,172 @@
+#include <string.h>
+
+#include "ble_scan.h"
+#include "time.h"
+
+#define HEADER_SIZE  2
+#define ADDRESS_SIZE 6
+
+typedef struct {
+  uint32_t hash;
+  uint32_t seen_ms;
+  bool used;
+} dedup_entry_t;
+
+// The scan callback carries no context, so the scan is global.
+static struct {
+  uint8_t buffer[LIBTOCK_BLE_ADV_MAX_LEN];
+  libtock_ble_scan_report_t* reports;
+  int capacity;
+  int head;
+  int count;
+  libtock_ble_scan_filter_t filter;
+  libtock_ble_scan_callback cb;
+  uint32_t dropped;
+  uint32_t filtered;
+  dedup_entry_t dedup[LIBTOCK_BLE_SCAN_DEDUP_SLOTS];
+} scan;
+
+// FNV-1a over the address and data.
+static uint32_t hash_of(const uint8_t* p, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= p[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static const uint8_t* find_ad(const uint8_t* data, uint8_t data_len, uint8_t type, uint8_t* len) {
+  uint8_t i = 0;
+  while (i + 1 < data_len) {
+    uint8_t field_len = data[i];
+    if (field_len == 0 || i + 1 + field_len > data_len) return NULL;
+    if (data[i + 1] == type) {
+      *len = field_len - 1;
+      return &data[i + 2];
+    }
+    i += 1 + field_len;
+  }
+  return NULL;
+}
+
+static bool allowed(const uint8_t* address) {
+  if (scan.filter.allow == NULL) return true;
+  for (int i = 0; i < scan.filter.allow_count; i++) {
+    if (memcmp(scan.filter.allow[i], address, ADDRESS_SIZE) == 0) return true;
+  }
+  return false;
+}
+
+// Whether the advertisement was seen within the window, recording it either
+// way. A new advertisement replaces the one seen longest ago.
+static bool duplicate(const uint8_t* adv, size_t len, uint32_t now_ms) {
+  uint32_t hash         = hash_of(adv, len);
+  dedup_entry_t* oldest = &scan.dedup[0];
+  for (int i = 0; i < LIBTOCK_BLE_SCAN_DEDUP_SLOTS; i++) {
+    dedup_entry_t* entry = &scan.dedup[i];
+    if (entry->used && entry->hash == hash) {
+      bool recent = now_ms - entry->seen_ms < scan.filter.dedup_ms;
+      // Only reports restart the window, so a steady advertiser is reported
+      // once per window.
+      if (!recent) entry->seen_ms = now_ms;
+      return recent;
+    }
+    if (!entry->used || (oldest->used && now_ms - entry->seen_ms > now_ms - oldest->seen_ms)) oldest = entry;
+  }
+
+  oldest->used    = true;
+  oldest->hash    = hash;
+  oldest->seen_ms = now_ms;
+  return false;
+}
+
+static void scan_upcall(int result, int len, __attribute__ ((unused)) int unused, __attribute__ ((unused)) void* ud) {
+  if (result != RETURNCODE_SUCCESS || len < HEADER_SIZE + ADDRESS_SIZE) return;
+  if (len > LIBTOCK_BLE_ADV_MAX_LEN) len = LIBTOCK_BLE_ADV_MAX_LEN;
+
+  const uint8_t* address = &scan.buffer[HEADER_SIZE];
+  const uint8_t* data    = address + ADDRESS_SIZE;
+  uint8_t data_len       = len - HEADER_SIZE - ADDRESS_SIZE;
+  uint64_t now_us        = libtock_time_now_us64();
+
+  uint8_t ad_len;
+  if (!allowed(address) ||
+      (scan.filter.ad_type != LIBTOCK_BLE_SCAN_ANY_AD_TYPE &&
+       find_ad(data, data_len, scan.filter.ad_type, &ad_len) == NULL)) {
+    scan.filtered++;
+    return;
+  }
+
+  // Checked before the duplicate filter so a dropped advertisement does not
+  // start a window and is reported once there is room.
+  if (scan.count == scan.capacity) {
+    scan.dropped++;
+    return;
+  }
+
+  if (scan.filter.dedup_ms != 0 && duplicate(address, ADDRESS_SIZE + data_len, (uint32_t) (now_us / 1000))) {
+    scan.filtered++;
+    return;
+  }
+
+  libtock_ble_scan_report_t* report = &scan.reports[(scan.head + scan.count) % scan.capacity];
+  report->pdu_type       = scan.buffer[0] & 0x0f;
+  report->random_address = (scan.buffer[0] & 0x40) != 0;
+  report->data_len       = data_len;
+  report->time_us        = now_us;
+  memcpy(report->address, address, ADDRESS_SIZE);
+  memcpy(report->data, data, data_len);
+  scan.count++;
+
+  if (scan.cb) scan.cb();
+}
+
+returncode_t libtock_ble_scan_start(libtock_ble_scan_report_t* reports, int capacity,
+                                    const libtock_ble_scan_filter_t* filter, libtock_ble_scan_callback cb) {
+  if (reports == NULL || capacity <= 0) return RETURNCODE_EINVAL;
+
+  scan.reports  = reports;
+  scan.capacity = capacity;
+  scan.head     = 0;
+  scan.count    = 0;
+  scan.cb       = cb;
+  scan.dropped  = 0;
+  scan.filtered = 0;
+  memset(&scan.filter, 0, sizeof(scan.filter));
+  if (filter != NULL) scan.filter = *filter;
+  memset(scan.dedup, 0, sizeof(scan.dedup));
+
+  return ble_start_passive_scan(scan.buffer, sizeof(scan.buffer), scan_upcall);
+}
+
+returncode_t libtock_ble_scan_stop(void) {
+  return ble_stop_passive_scan();
+}
+
+const libtock_ble_scan_report_t* libtock_ble_scan_peek(void) {
+  if (scan.count == 0) return NULL;
+  return &scan.reports[scan.head];
+}
+
+void libtock_ble_scan_release(void) {
+  if (scan.count == 0) return;
+  scan.head = (scan.head + 1) % scan.capacity;
+  scan.count--;
+}
+
+int libtock_ble_scan_count(void) {
+  return scan.count;
+}
+
+uint32_t libtock_ble_scan_dropped(void) {
+  return scan.dropped;
+}
+
+uint32_t libtock_ble_scan_filtered(void) {
+  return scan.filtered;
+}
+
+const uint8_t* libtock_ble_scan_find_ad(const libtock_ble_scan_report_t* report, uint8_t type, uint8_t* len) {
+  return find_ad(report->data, report->data_len, type, len);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../net/ble.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Queued and filtered BLE passive scanning.
+//
+// The BLE driver delivers one advertisement per upcall into a single buffer,
+// which it overwrites with the next one. The service keeps that buffer with
+// the kernel and, in the upcall, filters each advertisement and copies the
+// ones that pass into a ring of reports, so the app can take them when it
+// gets to them.
+//
+// An advertisement passes the filter if:
+//
+// - its advertiser address is in the allowlist, if there is one,
+// - it carries an AD structure of the filter's AD type, if it has one, and
+// - the same advertiser has not sent the same data within the filter's
+//   duplicate window, if it is not 0.
+//
+// Duplicates are detected by a hash of the address and data, kept for the
+// last `LIBTOCK_BLE_SCAN_DEDUP_SLOTS` distinct advertisements.
+//
+// Advertisements that arrive while the ring is full are dropped and counted
+// by `libtock_ble_scan_dropped()`. Ones that fail the filter are counted by
+// `libtock_ble_scan_filtered()`.
+
+#ifndef LIBTOCK_BLE_SCAN_DEDUP_SLOTS
+#define LIBTOCK_BLE_SCAN_DEDUP_SLOTS 32
+#endif
+
+#define LIBTOCK_BLE_ADV_MAX_LEN 39
+#define LIBTOCK_BLE_ADV_DATA_MAX_LEN 31
+
+// AD type that matches any advertisement.
+#define LIBTOCK_BLE_SCAN_ANY_AD_TYPE 0
+
+typedef struct {
+  // PDU type, one of ADV_IND, ADV_DIRECT_IND, ADV_NONCONN_IND or
+  // ADV_SCAN_IND.
+  uint8_t pdu_type;
+  // Whether `address` is a random address.
+  bool random_address;
+  // Advertiser address, least significant byte first as on air.
+  uint8_t address[6];
+  uint8_t data_len;
+  uint8_t data[LIBTOCK_BLE_ADV_DATA_MAX_LEN];
+  // Time the advertisement arrived, from `libtock_time_now_us64()`.
+  uint64_t time_us;
+} libtock_ble_scan_report_t;
+
+typedef struct {
+  // Advertiser addresses to accept, or NULL to accept any.
+  const uint8_t (*allow)[6];
+  int allow_count;
+  // AD type that must be present, or `LIBTOCK_BLE_SCAN_ANY_AD_TYPE`.
+  uint8_t ad_type;
+  // Suppress repeats of the same address and data within this many
+  // milliseconds, or 0 to report every advertisement.
+  uint32_t dedup_ms;
+} libtock_ble_scan_filter_t;
+
+// Function signature for the scan callback, called after a report was
+// queued.
+typedef void (*libtock_ble_scan_callback)(void);
+
+// Start scanning into a ring of `capacity` reports. `filter` is copied and
+// may be NULL to report every advertisement, and `cb` may be NULL.
+//
+// Returns RETURNCODE_EINVAL if `capacity` is 0.
+returncode_t libtock_ble_scan_start(libtock_ble_scan_report_t* reports, int capacity,
+                                    const libtock_ble_scan_filter_t* filter, libtock_ble_scan_callback cb);
+
+// Stop scanning. Queued reports can still be read.
+returncode_t libtock_ble_scan_stop(void);
+
+// The oldest queued report, or NULL if there is none. It stays queued until
+// `libtock_ble_scan_release()`.
+const libtock_ble_scan_report_t* libtock_ble_scan_peek(void);
+
+// Remove the oldest queued report.
+void libtock_ble_scan_release(void);
+
+// Number of queued reports.
+int libtock_ble_scan_count(void);
+
+// Number of advertisements dropped because the ring was full.
+uint32_t libtock_ble_scan_dropped(void);
+
+// Number of advertisements that failed the filter, including duplicates.
+uint32_t libtock_ble_scan_filtered(void);
+
+// Find the first AD structure of `type` in `report`. Returns its data and
+// sets `len`, or returns NULL if there is none.
+const uint8_t* libtock_ble_scan_find_ad(const libtock_ble_scan_report_t* report, uint8_t type, uint8_t* len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,140 @@
+#include "../interface/button.h"
+#include "alarm.h"
+#include "button_debounce.h"
+#include "time.h"
+
+enum hold_state {
+  HOLD_NONE,
+  HOLD_WAIT_LONG,
+  HOLD_REPEAT,
+};
+
+// The button callback has no context, so the buttons are global.
+static struct {
+  int count;
+  libtock_button_debounce_callback cb;
+  libtock_alarm_t alarm;
+  bool armed;
+  uint32_t armed_at;
+  // Debounced level of each button.
+  bool pressed[LIBTOCK_BUTTON_DEBOUNCE_MAX];
+  // Edges are ignored until `settle_at` while settling.
+  bool settling[LIBTOCK_BUTTON_DEBOUNCE_MAX];
+  uint32_t settle_at[LIBTOCK_BUTTON_DEBOUNCE_MAX];
+  // Next long press or repeat event of a held button.
+  uint8_t hold[LIBTOCK_BUTTON_DEBOUNCE_MAX];
+  uint32_t hold_at[LIBTOCK_BUTTON_DEBOUNCE_MAX];
+} debounce;
+
+static uint32_t now_ms(void) {
+  return (uint32_t) (libtock_time_now_us64() / 1000);
+}
+
+// Whether `deadline` has passed at `now`, across wraps.
+static bool reached(uint32_t now, uint32_t deadline) {
+  return (int32_t) (now - deadline) >= 0;
+}
+
+static void report(int button, bool pressed, uint32_t now) {
+  debounce.pressed[button]   = pressed;
+  debounce.settling[button]  = true;
+  debounce.settle_at[button] = now + LIBTOCK_BUTTON_DEBOUNCE_MS;
+  debounce.hold[button]      = pressed ? HOLD_WAIT_LONG : HOLD_NONE;
+  debounce.hold_at[button]   = now + LIBTOCK_BUTTON_LONG_PRESS_MS;
+  debounce.cb(button, pressed ? LIBTOCK_BUTTON_PRESS : LIBTOCK_BUTTON_RELEASE);
+}
+
+static void timer_fired(uint32_t now, uint32_t scheduled, void* opaque);
+
+// Arm the shared alarm for the earliest deadline of any button, or stop it
+// if no button needs one.
+static void schedule(void) {
+  uint32_t now      = now_ms();
+  bool found        = false;
+  uint32_t earliest = 0;
+  for (int i = 0; i < debounce.count; i++) {
+    if (debounce.settling[i] && (!found || reached(earliest, debounce.settle_at[i]))) {
+      earliest = debounce.settle_at[i];
+      found    = true;
+    }
+    if (debounce.hold[i] != HOLD_NONE && (!found || reached(earliest, debounce.hold_at[i]))) {
+      earliest = debounce.hold_at[i];
+      found    = true;
+    }
+  }
+
+  if (debounce.armed && (!found || debounce.armed_at != earliest)) {
+    libtock_alarm_ms_cancel(&debounce.alarm);
+    debounce.armed = false;
+  }
+  if (!found || debounce.armed) return;
+
+  uint32_t delay = reached(now, earliest) ? 0 : earliest - now;
+  if (libtock_alarm_in_ms(delay, timer_fired, NULL, &debounce.alarm) == RETURNCODE_SUCCESS) {
+    debounce.armed    = true;
+    debounce.armed_at = earliest;
+  }
+}
+
+static void timer_fired(__attribute__ ((unused)) uint32_t now,
+                        __attribute__ ((unused)) uint32_t scheduled,
+                        __attribute__ ((unused)) void*    opaque) {
+  debounce.armed = false;
+  uint32_t ms = now_ms();
+
+  for (int i = 0; i < debounce.count; i++) {
+    if (debounce.settling[i] && reached(ms, debounce.settle_at[i])) {
+      debounce.settling[i] = false;
+      // Edges during the chatter were ignored, so check where it ended up.
+      int level;
+      if (libtock_button_read(i, &level) == RETURNCODE_SUCCESS && (level == 1) != debounce.pressed[i]) {
+        report(i, level == 1, ms);
+        continue;
+      }
+    }
+
+    if (debounce.hold[i] == HOLD_NONE || !reached(ms, debounce.hold_at[i])) continue;
+    if (debounce.hold[i] == HOLD_WAIT_LONG) {
+      debounce.hold[i] = LIBTOCK_BUTTON_REPEAT_MS > 0 ? HOLD_REPEAT : HOLD_NONE;
+      debounce.cb(i, LIBTOCK_BUTTON_LONG_PRESS);
+    } else {
+      debounce.cb(i, LIBTOCK_BUTTON_REPEAT);
+    }
+    debounce.hold_at[i] += LIBTOCK_BUTTON_REPEAT_MS;
+    // After a stall, repeat from now instead of in a burst.
+    if (reached(ms, debounce.hold_at[i])) debounce.hold_at[i] = ms + LIBTOCK_BUTTON_REPEAT_MS;
+  }
+
+  schedule();
+}
+
+static void button_edge(__attribute__ ((unused)) returncode_t ret, int button, bool pressed) {
+  if (button < 0 || button >= debounce.count) return;
+  if (debounce.settling[button] || pressed == debounce.pressed[button]) return;
+
+  report(button, pressed, now_ms());
+  schedule();
+}
+
+returncode_t libtock_button_debounce_start(libtock_button_debounce_callback cb) {
+  int count;
+  returncode_t ret = libtock_button_count(&count);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (count > LIBTOCK_BUTTON_DEBOUNCE_MAX) count = LIBTOCK_BUTTON_DEBOUNCE_MAX;
+
+  if (debounce.armed) libtock_alarm_ms_cancel(&debounce.alarm);
+  debounce.armed = false;
+  debounce.count = count;
+  debounce.cb    = cb;
+  for (int i = 0; i < count; i++) {
+    int level = 0;
+    libtock_button_read(i, &level);
+    debounce.pressed[i]  = level == 1;
+    debounce.settling[i] = false;
+    debounce.hold[i]     = HOLD_NONE;
+
+    ret = libtock_button_notify_on_press(i, button_edge);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+  }
+  return RETURNCODE_SUCCESS;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Debounced button events.
+//
+// The first edge of a press or release is reported as soon as its upcall
+// arrives. Further edges of that button are then ignored for
+// `LIBTOCK_BUTTON_DEBOUNCE_MS`, after which the button is read once and a
+// change that happened during the chatter is reported. Holding a button
+// reports a long press after `LIBTOCK_BUTTON_LONG_PRESS_MS` and then repeats
+// every `LIBTOCK_BUTTON_REPEAT_MS`, if that is not 0.
+//
+// All buttons share a single alarm, which only runs while some button is
+// settling or held.
+
+#ifndef LIBTOCK_BUTTON_DEBOUNCE_MAX
+#define LIBTOCK_BUTTON_DEBOUNCE_MAX 8
+#endif
+
+#ifndef LIBTOCK_BUTTON_DEBOUNCE_MS
+#define LIBTOCK_BUTTON_DEBOUNCE_MS 20
+#endif
+
+#ifndef LIBTOCK_BUTTON_LONG_PRESS_MS
+#define LIBTOCK_BUTTON_LONG_PRESS_MS 600
+#endif
+
+#ifndef LIBTOCK_BUTTON_REPEAT_MS
+#define LIBTOCK_BUTTON_REPEAT_MS 150
+#endif
+
+typedef enum {
+  LIBTOCK_BUTTON_PRESS,
+  LIBTOCK_BUTTON_RELEASE,
+  // The button has been held for `LIBTOCK_BUTTON_LONG_PRESS_MS`.
+  LIBTOCK_BUTTON_LONG_PRESS,
+  // The button is still held, every `LIBTOCK_BUTTON_REPEAT_MS` after the long
+  // press.
+  LIBTOCK_BUTTON_REPEAT,
+} libtock_button_event_t;
+
+// Function signature for debounced button callbacks.
+//
+// - `arg1` (`int`): Button index.
+// - `arg2` (`libtock_button_event_t`): What happened.
+typedef void (*libtock_button_debounce_callback)(int, libtock_button_event_t);
+
+// Enable interrupts on every button, up to `LIBTOCK_BUTTON_DEBOUNCE_MAX`, and
+// call `cb` with their debounced events. This replaces any callback set with
+// `libtock_button_notify_on_press()`.
+returncode_t libtock_button_debounce_start(libtock_button_debounce_callback cb);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,400 @@
+#include <string.h>
+
+#include "cbor.h"
+
+// Major types, in the top three bits of a value's first byte.
+#define MAJOR_UINT   0
+#define MAJOR_NEGINT 1
+#define MAJOR_BYTES  2
+#define MAJOR_TEXT   3
+#define MAJOR_ARRAY  4
+#define MAJOR_MAP    5
+#define MAJOR_TAG    6
+#define MAJOR_SIMPLE 7
+
+// Additional information in the low five bits: the argument itself below 24,
+// otherwise the size of the argument that follows.
+#define INFO_1_BYTE  24
+#define INFO_2_BYTES 25
+#define INFO_4_BYTES 26
+#define INFO_8_BYTES 27
+
+#define SIMPLE_FALSE 20
+#define SIMPLE_TRUE  21
+#define SIMPLE_NULL  22
+
+void libtock_cbor_writer_init(libtock_cbor_writer_t* w, uint8_t* buf, size_t size) {
+  w->buf      = buf;
+  w->size     = size;
+  w->len      = 0;
+  w->overflow = false;
+}
+
+// Reserve `n` bytes, or mark the writer as overflowed.
+static uint8_t* reserve(libtock_cbor_writer_t* w, size_t n) {
+  if (w->overflow || w->size - w->len < n) {
+    w->overflow = true;
+    return NULL;
+  }
+  uint8_t* p = w->buf + w->len;
+  w->len += n;
+  return p;
+}
+
+// Write the first byte and big-endian argument of `n` bytes.
+static void put_raw(libtock_cbor_writer_t* w, uint8_t first, uint64_t arg, size_t n) {
+  uint8_t* p = reserve(w, 1 + n);
+  if (p == NULL) return;
+  p[0] = first;
+  for (size_t i = n; i > 0; i--) {
+    p[i] = (uint8_t) arg;
+    arg >>= 8;
+  }
+}
+
+// Write a head in its shortest form.
+static void put_head(libtock_cbor_writer_t* w, uint8_t major, uint64_t arg) {
+  uint8_t type = (uint8_t) (major << 5);
+  if (arg < INFO_1_BYTE) {
+    put_raw(w, type | (uint8_t) arg, 0, 0);
+  } else if (arg <= UINT8_MAX) {
+    put_raw(w, type | INFO_1_BYTE, arg, 1);
+  } else if (arg <= UINT16_MAX) {
+    put_raw(w, type | INFO_2_BYTES, arg, 2);
+  } else if (arg <= UINT32_MAX) {
+    put_raw(w, type | INFO_4_BYTES, arg, 4);
+  } else {
+    put_raw(w, type | INFO_8_BYTES, arg, 8);
+  }
+}
+
+void libtock_cbor_put_uint(libtock_cbor_writer_t* w, uint64_t value) {
+  put_head(w, MAJOR_UINT, value);
+}
+
+void libtock_cbor_put_int(libtock_cbor_writer_t* w, int64_t value) {
+  if (value >= 0) {
+    put_head(w, MAJOR_UINT, (uint64_t) value);
+  } else {
+    // -1 - value, without overflowing at INT64_MIN.
+    put_head(w, MAJOR_NEGINT, ~(uint64_t) value);
+  }
+}
+
+void libtock_cbor_put_bool(libtock_cbor_writer_t* w, bool value) {
+  put_head(w, MAJOR_SIMPLE, value ? SIMPLE_TRUE : SIMPLE_FALSE);
+}
+
+void libtock_cbor_put_null(libtock_cbor_writer_t* w) {
+  put_head(w, MAJOR_SIMPLE, SIMPLE_NULL);
+}
+
+void libtock_cbor_put_float(libtock_cbor_writer_t* w, float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  uint32_t sign = (bits >> 16) & 0x8000;
+  int32_t exp   = (int32_t) ((bits >> 23) & 0xff);
+  uint32_t mant = bits & 0x7fffff;
+
+  // Zeros, infinities, NaN and normal numbers with a short enough mantissa
+  // fit half precision.
+  if (exp == 0 && mant == 0) {
+    put_raw(w, (MAJOR_SIMPLE << 5) | INFO_2_BYTES, sign, 2);
+  } else if (exp == 0xff) {
+    put_raw(w, (MAJOR_SIMPLE << 5) | INFO_2_BYTES, sign | 0x7c00 | (mant != 0 ? 0x200 : 0), 2);
+  } else if (exp >= 127 - 14 && exp <= 127 + 15 && (mant & 0x1fff) == 0) {
+    put_raw(w, (MAJOR_SIMPLE << 5) | INFO_2_BYTES, sign | ((uint32_t) (exp - 112) << 10) | (mant >> 13), 2);
+  } else {
+    put_raw(w, (MAJOR_SIMPLE << 5) | INFO_4_BYTES, bits, 4);
+  }
+}
+
+void libtock_cbor_put_bytes(libtock_cbor_writer_t* w, const void* data, size_t len) {
+  put_head(w, MAJOR_BYTES, len);
+  uint8_t* p = reserve(w, len);
+  if (p != NULL) memcpy(p, data, len);
+}
+
+void libtock_cbor_put_text(libtock_cbor_writer_t* w, const char* str) {
+  libtock_cbor_put_text_len(w, str, strlen(str));
+}
+
+void libtock_cbor_put_text_len(libtock_cbor_writer_t* w, const char* str, size_t len) {
+  put_head(w, MAJOR_TEXT, len);
+  uint8_t* p = reserve(w, len);
+  if (p != NULL) memcpy(p, str, len);
+}
+
+void libtock_cbor_put_array(libtock_cbor_writer_t* w, size_t count) {
+  put_head(w, MAJOR_ARRAY, count);
+}
+
+void libtock_cbor_put_map(libtock_cbor_writer_t* w, size_t count) {
+  put_head(w, MAJOR_MAP, count);
+}
+
+void libtock_cbor_put_tag(libtock_cbor_writer_t* w, uint64_t tag) {
+  put_head(w, MAJOR_TAG, tag);
+}
+
+returncode_t libtock_cbor_writer_finish(const libtock_cbor_writer_t* w, size_t* len) {
+  if (w->overflow) return RETURNCODE_ESIZE;
+  *len = w->len;
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_cbor_reader_init(libtock_cbor_reader_t* r, const void* buf, size_t len) {
+  r->buf = (const uint8_t*) buf;
+  r->len = len;
+  r->pos = 0;
+}
+
+typedef struct {
+  uint8_t major;
+  uint8_t info;
+  uint64_t arg;
+  // Position after the head.
+  size_t end;
+} head_t;
+
+static returncode_t read_head(const libtock_cbor_reader_t* r, size_t pos, head_t* head) {
+  if (pos >= r->len) return RETURNCODE_ESIZE;
+  uint8_t first = r->buf[pos++];
+  head->major = first >> 5;
+  head->info  = first & 0x1f;
+
+  size_t n;
+  if (head->info < INFO_1_BYTE) {
+    n = 0;
+  } else if (head->info <= INFO_8_BYTES) {
+    n = (size_t) 1 << (head->info - INFO_1_BYTE);
+  } else {
+    // Reserved, or an indefinite length.
+    return RETURNCODE_EINVAL;
+  }
+  if (r->len - pos < n) return RETURNCODE_ESIZE;
+
+  head->arg = n == 0 ? head->info : 0;
+  for (size_t i = 0; i < n; i++) {
+    head->arg = (head->arg << 8) | r->buf[pos++];
+  }
+  head->end = pos;
+  return RETURNCODE_SUCCESS;
+}
+
+// Read the head of the next value, which must have major type `major`.
+static returncode_t expect(const libtock_cbor_reader_t* r, uint8_t major, head_t* head) {
+  returncode_t ret = read_head(r, r->pos, head);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  return head->major == major ? RETURNCODE_SUCCESS : RETURNCODE_EINVAL;
+}
+
+libtock_cbor_type_t libtock_cbor_peek(const libtock_cbor_reader_t* r) {
+  head_t head;
+  if (read_head(r, r->pos, &head) != RETURNCODE_SUCCESS) return LIBTOCK_CBOR_INVALID;
+
+  switch (head.major) {
+    case MAJOR_UINT:   return LIBTOCK_CBOR_UINT;
+    case MAJOR_NEGINT: return LIBTOCK_CBOR_NEGINT;
+    case MAJOR_BYTES:  return LIBTOCK_CBOR_BYTES;
+    case MAJOR_TEXT:   return LIBTOCK_CBOR_TEXT;
+    case MAJOR_ARRAY:  return LIBTOCK_CBOR_ARRAY;
+    case MAJOR_MAP:    return LIBTOCK_CBOR_MAP;
+    case MAJOR_TAG:    return LIBTOCK_CBOR_TAG;
+    default:
+      break;
+  }
+  if (head.info == SIMPLE_FALSE || head.info == SIMPLE_TRUE) return LIBTOCK_CBOR_BOOL;
+  if (head.info == SIMPLE_NULL) return LIBTOCK_CBOR_NULL;
+  if (head.info >= INFO_2_BYTES && head.info <= INFO_8_BYTES) return LIBTOCK_CBOR_FLOAT;
+  return LIBTOCK_CBOR_INVALID;
+}
+
+bool libtock_cbor_at_end(const libtock_cbor_reader_t* r) {
+  return r->pos >= r->len;
+}
+
+returncode_t libtock_cbor_get_uint(libtock_cbor_reader_t* r, uint64_t* value) {
+  head_t head;
+  returncode_t ret = expect(r, MAJOR_UINT, &head);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  *value = head.arg;
+  r->pos = head.end;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_cbor_get_int(libtock_cbor_reader_t* r, int64_t* value) {
+  head_t head;
+  returncode_t ret = read_head(r, r->pos, &head);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if ((head.major != MAJOR_UINT && head.major != MAJOR_NEGINT) || head.arg > INT64_MAX) return RETURNCODE_EINVAL;
+
+  *value = head.major == MAJOR_UINT ? (int64_t) head.arg : -1 - (int64_t) head.arg;
+  r->pos = head.end;
+  return RETURNCODE_SUCCESS;
+}
+
+// Read the next simple value with additional information `info`.
+static returncode_t get_simple(libtock_cbor_reader_t* r, uint8_t info) {
+  head_t head;
+  returncode_t ret = expect(r, MAJOR_SIMPLE, &head);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (head.info != info) return RETURNCODE_EINVAL;
+
+  r->pos = head.end;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_cbor_get_bool(libtock_cbor_reader_t* r, bool* value) {
+  if (get_simple(r, SIMPLE_TRUE) == RETURNCODE_SUCCESS) {
+    *value = true;
+    return RETURNCODE_SUCCESS;
+  }
+  returncode_t ret = get_simple(r, SIMPLE_FALSE);
+  if (ret == RETURNCODE_SUCCESS) *value = false;
+  return ret;
+}
+
+returncode_t libtock_cbor_get_null(libtock_cbor_reader_t* r) {
+  return get_simple(r, SIMPLE_NULL);
+}
+
+static float half_to_float(uint32_t half) {
+  uint32_t sign = (half & 0x8000) << 16;
+  uint32_t exp  = (half >> 10) & 0x1f;
+  uint32_t mant = half & 0x3ff;
+
+  if (exp == 0) {
+    // Zero and subnormals, mant * 2^-24.
+    float f = (float) mant / 16777216.0f;
+    return sign != 0 ? -f : f;
+  }
+
+  uint32_t bits;
+  if (exp == 0x1f) {
+    bits = sign | 0x7f800000 | (mant << 13);
+  } else {
+    bits = sign | ((exp + 112) << 23) | (mant << 13);
+  }
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+returncode_t libtock_cbor_get_float(libtock_cbor_reader_t* r, float* value) {
+  head_t head;
+  returncode_t ret = expect(r, MAJOR_SIMPLE, &head);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  if (head.info == INFO_2_BYTES) {
+    *value = half_to_float((uint32_t) head.arg);
+  } else if (head.info == INFO_4_BYTES) {
+    uint32_t bits = (uint32_t) head.arg;
+    memcpy(value, &bits, sizeof(*value));
+  } else if (head.info == INFO_8_BYTES) {
+    double d;
+    memcpy(&d, &head.arg, sizeof(d));
+    *value = (float) d;
+  } else {
+    return RETURNCODE_EINVAL;
+  }
+  r->pos = head.end;
+  return RETURNCODE_SUCCESS;
+}
+
+// Read a string of major type `major`, pointing into the buffer.
+static returncode_t get_string(libtock_cbor_reader_t* r, uint8_t major, const uint8_t** data, size_t* len) {
+  head_t head;
+  returncode_t ret = expect(r, major, &head);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (head.arg > r->len - head.end) return RETURNCODE_ESIZE;
+
+  *data  = r->buf + head.end;
+  *len   = (size_t) head.arg;
+  r->pos = head.end + (size_t) head.arg;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_cbor_get_bytes(libtock_cbor_reader_t* r, const uint8_t** data, size_t* len) {
+  return get_string(r, MAJOR_BYTES, data, len);
+}
+
+returncode_t libtock_cbor_get_text(libtock_cbor_reader_t* r, const char** str, size_t* len) {
+  return get_string(r, MAJOR_TEXT, (const uint8_t**) str, len);
+}
+
+// Read the head of an array, map or tag.
+static returncode_t get_count(libtock_cbor_reader_t* r, uint8_t major, uint64_t* count) {
+  head_t head;
+  returncode_t ret = expect(r, major, &head);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  *count = head.arg;
+  r->pos = head.end;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_cbor_get_array(libtock_cbor_reader_t* r, size_t* count) {
+  uint64_t n;
+  returncode_t ret = get_count(r, MAJOR_ARRAY, &n);
+  if (ret == RETURNCODE_SUCCESS) *count = (size_t) n;
+  return ret;
+}
+
+returncode_t libtock_cbor_get_map(libtock_cbor_reader_t* r, size_t* count) {
+  uint64_t n;
+  returncode_t ret = get_count(r, MAJOR_MAP, &n);
+  if (ret == RETURNCODE_SUCCESS) *count = (size_t) n;
+  return ret;
+}
+
+returncode_t libtock_cbor_get_tag(libtock_cbor_reader_t* r, uint64_t* tag) {
+  return get_count(r, MAJOR_TAG, tag);
+}
+
+// Find the end of the value at `*pos`, `depth` levels of nesting deep.
+static returncode_t skip_at(const libtock_cbor_reader_t* r, size_t* pos, int depth) {
+  head_t head;
+  returncode_t ret = read_head(r, *pos, &head);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  *pos = head.end;
+
+  uint64_t items;
+  switch (head.major) {
+    case MAJOR_BYTES:
+    case MAJOR_TEXT:
+      if (head.arg > r->len - *pos) return RETURNCODE_ESIZE;
+      *pos += (size_t) head.arg;
+      return RETURNCODE_SUCCESS;
+    case MAJOR_ARRAY:
+      items = head.arg;
+      break;
+    case MAJOR_MAP:
+      // A count this large cannot fit the buffer anyway.
+      if (head.arg > UINT64_MAX / 2) return RETURNCODE_ESIZE;
+      items = head.arg * 2;
+      break;
+    case MAJOR_TAG:
+      items = 1;
+      break;
+    default:
+      return RETURNCODE_SUCCESS;
+  }
+
+  if (depth == LIBTOCK_CBOR_MAX_DEPTH) return RETURNCODE_EINVAL;
+  // Every item takes at least a byte, so a truncated buffer ends the loop.
+  for (uint64_t i = 0; i < items; i++) {
+    ret = skip_at(r, pos, depth + 1);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_cbor_skip(libtock_cbor_reader_t* r) {
+  size_t pos       = r->pos;
+  returncode_t ret = skip_at(r, &pos, 0);
+  if (ret == RETURNCODE_SUCCESS) r->pos = pos;
+  return ret;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Streaming CBOR (RFC 8949) encoding and decoding.
+//
+// Telemetry formatted as text with `snprintf()` is slow to produce and makes
+// large packets. A CBOR record of a few sensor readings is typically a third
+// of the size of its text, and encoding it is a handful of byte stores per
+// value. The writer encodes straight into a caller's buffer, such as the
+// buffer passed to `libtock_udp_send()` or an advertisement's manufacturer
+// data, and never allocates:
+//
+//     uint8_t packet[32];
+//     libtock_cbor_writer_t w;
+//     libtock_cbor_writer_init(&w, packet, sizeof(packet));
+//     libtock_cbor_put_map(&w, 2);
+//     libtock_cbor_put_text(&w, "t");
+//     libtock_cbor_put_int(&w, temperature);
+//     libtock_cbor_put_text(&w, "lx");
+//     libtock_cbor_put_int(&w, lux);
+//     size_t len;
+//     if (libtock_cbor_writer_finish(&w, &len) == RETURNCODE_SUCCESS) ...
+//
+// A write that does not fit marks the writer as overflowed and every later
+// write is dropped, so a record is built without checking every call and
+// checked once with `libtock_cbor_writer_finish()`. Integers and lengths use their shortest
+// form, and floats are written as half precision when that loses nothing.
+//
+// The reader decodes in place: strings point into the buffer rather than being
+// copied. Arrays and maps only give their length; their items follow as the
+// next values. Indefinite lengths are not supported by either side.
+
+// Nesting of arrays, maps and tags `libtock_cbor_skip()` follows.
+#ifndef LIBTOCK_CBOR_MAX_DEPTH
+#define LIBTOCK_CBOR_MAX_DEPTH 8
+#endif
+
+typedef struct {
+  uint8_t* buf;
+  size_t size;
+  size_t len;
+  bool overflow;
+} libtock_cbor_writer_t;
+
+typedef enum {
+  LIBTOCK_CBOR_UINT,
+  LIBTOCK_CBOR_NEGINT,
+  LIBTOCK_CBOR_BYTES,
+  LIBTOCK_CBOR_TEXT,
+  LIBTOCK_CBOR_ARRAY,
+  LIBTOCK_CBOR_MAP,
+  LIBTOCK_CBOR_TAG,
+  LIBTOCK_CBOR_BOOL,
+  LIBTOCK_CBOR_NULL,
+  LIBTOCK_CBOR_FLOAT,
+  // Other simple values, and the end of the buffer.
+  LIBTOCK_CBOR_INVALID,
+} libtock_cbor_type_t;
+
+typedef struct {
+  const uint8_t* buf;
+  size_t len;
+  size_t pos;
+} libtock_cbor_reader_t;
+
+void libtock_cbor_writer_init(libtock_cbor_writer_t* w, uint8_t* buf, size_t size);
+
+void libtock_cbor_put_uint(libtock_cbor_writer_t* w, uint64_t value);
+void libtock_cbor_put_int(libtock_cbor_writer_t* w, int64_t value);
+void libtock_cbor_put_bool(libtock_cbor_writer_t* w, bool value);
+void libtock_cbor_put_null(libtock_cbor_writer_t* w);
+void libtock_cbor_put_float(libtock_cbor_writer_t* w, float value);
+void libtock_cbor_put_bytes(libtock_cbor_writer_t* w, const void* data, size_t len);
+// Write the NUL-terminated UTF-8 string `str`.
+void libtock_cbor_put_text(libtock_cbor_writer_t* w, const char* str);
+void libtock_cbor_put_text_len(libtock_cbor_writer_t* w, const char* str, size_t len);
+// Start an array of `count` items, or a map of `count` key and value pairs,
+// which are written next.
+void libtock_cbor_put_array(libtock_cbor_writer_t* w, size_t count);
+void libtock_cbor_put_map(libtock_cbor_writer_t* w, size_t count);
+void libtock_cbor_put_tag(libtock_cbor_writer_t* w, uint64_t tag);
+
+// Put the encoded length in `*len`.
+//
+// Returns RETURNCODE_ESIZE if a write did not fit in the buffer.
+returncode_t libtock_cbor_writer_finish(const libtock_cbor_writer_t* w, size_t* len);
+
+void libtock_cbor_reader_init(libtock_cbor_reader_t* r, const void* buf, size_t len);
+
+// Type of the next value, LIBTOCK_CBOR_INVALID at the end of the buffer.
+libtock_cbor_type_t libtock_cbor_peek(const libtock_cbor_reader_t* r);
+
+// Whether every value of the buffer has been read.
+bool libtock_cbor_at_end(const libtock_cbor_reader_t* r);
+
+// Each of these reads the next value. They return RETURNCODE_EINVAL and leave
+// the reader where it was if the value has another type or does not fit the
+// result, and RETURNCODE_ESIZE if the buffer ends within it.
+returncode_t libtock_cbor_get_uint(libtock_cbor_reader_t* r, uint64_t* value);
+returncode_t libtock_cbor_get_int(libtock_cbor_reader_t* r, int64_t* value);
+returncode_t libtock_cbor_get_bool(libtock_cbor_reader_t* r, bool* value);
+returncode_t libtock_cbor_get_null(libtock_cbor_reader_t* r);
+// Reads half, single and double precision floats.
+returncode_t libtock_cbor_get_float(libtock_cbor_reader_t* r, float* value);
+// `*data` points into the reader's buffer.
+returncode_t libtock_cbor_get_bytes(libtock_cbor_reader_t* r, const uint8_t** data, size_t* len);
+returncode_t libtock_cbor_get_text(libtock_cbor_reader_t* r, const char** str, size_t* len);
+returncode_t libtock_cbor_get_array(libtock_cbor_reader_t* r, size_t* count);
+returncode_t libtock_cbor_get_map(libtock_cbor_reader_t* r, size_t* count);
+returncode_t libtock_cbor_get_tag(libtock_cbor_reader_t* r, uint64_t* tag);
+
+// Skip the next value, with the items of arrays and maps and the value of
+// tags, up to `LIBTOCK_CBOR_MAX_DEPTH` levels deep.
+returncode_t libtock_cbor_skip(libtock_cbor_reader_t* r);
+
+#ifdef __cplusplus
+}
+#endif
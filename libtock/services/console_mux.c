@@ -0,0 +1,137 @@
+#include <stdarg.h>
+#include <string.h>
+
+#include "../interface/console.h"
+#include "../interface/console_printf.h"
+#include "console_mux.h"
+
+#define FRAME_START 0x00
+#define FRAME_MUX   0xFE
+
+typedef struct {
+  uint8_t* buffer;
+  uint32_t size;
+  // Total bytes ever queued and taken for frames, as in stdout_buffer.c.
+  uint32_t head;
+  uint32_t tail;
+  uint32_t dropped;
+} mux_channel_t;
+
+// The console write callback carries no context, so the channels are global.
+static struct {
+  mux_channel_t channels[LIBTOCK_CONSOLE_MUX_CHANNELS];
+  uint8_t frame[LIBTOCK_CONSOLE_MUX_HEADER + LIBTOCK_CONSOLE_MUX_FRAME_DATA];
+  // Channel of the frame being written, or -1.
+  int writing;
+} mux = { .writing = -1 };
+
+static void start_write(void);
+
+static void write_done(returncode_t ret, uint32_t length) {
+  uint32_t sent = LIBTOCK_CONSOLE_MUX_HEADER + mux.frame[3];
+  if (ret != RETURNCODE_SUCCESS || length < sent) {
+    mux.channels[mux.writing].dropped += mux.frame[3];
+  }
+  mux.writing = -1;
+  start_write();
+}
+
+// Frame the next bytes of the highest priority channel that has any and
+// hand them to the console.
+static void start_write(void) {
+  while (mux.writing < 0) {
+    int c = 0;
+    while (c < LIBTOCK_CONSOLE_MUX_CHANNELS && mux.channels[c].head == mux.channels[c].tail) c++;
+    if (c == LIBTOCK_CONSOLE_MUX_CHANNELS) return;
+
+    // The bytes are copied out of the ring, so their space is free again
+    // while the frame is written.
+    mux_channel_t* ch = &mux.channels[c];
+    uint32_t len      = ch->head - ch->tail;
+    if (len > LIBTOCK_CONSOLE_MUX_FRAME_DATA) len = LIBTOCK_CONSOLE_MUX_FRAME_DATA;
+    uint32_t start = ch->tail % ch->size;
+    uint32_t first = start + len > ch->size ? ch->size - start : len;
+    memcpy(mux.frame + LIBTOCK_CONSOLE_MUX_HEADER, ch->buffer + start, first);
+    memcpy(mux.frame + LIBTOCK_CONSOLE_MUX_HEADER + first, ch->buffer, len - first);
+    ch->tail += len;
+
+    mux.frame[0] = FRAME_START;
+    mux.frame[1] = FRAME_MUX;
+    mux.frame[2] = (uint8_t) c;
+    mux.frame[3] = (uint8_t) len;
+    mux.writing  = c;
+    if (libtock_console_write(mux.frame, LIBTOCK_CONSOLE_MUX_HEADER + len, write_done) != RETURNCODE_SUCCESS) {
+      // Drop the frame and try the next one.
+      ch->dropped += len;
+      mux.writing  = -1;
+    }
+  }
+}
+
+returncode_t libtock_console_mux_open(uint8_t channel, uint8_t* buffer, uint32_t len) {
+  if (channel >= LIBTOCK_CONSOLE_MUX_CHANNELS || len == 0) return RETURNCODE_EINVAL;
+  mux_channel_t* ch = &mux.channels[channel];
+  if (ch->buffer != NULL) return RETURNCODE_EBUSY;
+
+  ch->buffer  = buffer;
+  ch->size    = len;
+  ch->head    = 0;
+  ch->tail    = 0;
+  ch->dropped = 0;
+  return RETURNCODE_SUCCESS;
+}
+
+uint32_t libtock_console_mux_space(uint8_t channel) {
+  if (channel >= LIBTOCK_CONSOLE_MUX_CHANNELS) return 0;
+  mux_channel_t* ch = &mux.channels[channel];
+  if (ch->buffer == NULL) return 0;
+  return ch->size - (ch->head - ch->tail);
+}
+
+uint32_t libtock_console_mux_write(uint8_t channel, const void* data, uint32_t len) {
+  uint32_t space = libtock_console_mux_space(channel);
+  if (len > space) len = space;
+  if (len == 0) return 0;
+
+  mux_channel_t* ch = &mux.channels[channel];
+  uint32_t start    = ch->head % ch->size;
+  uint32_t first    = start + len > ch->size ? ch->size - start : len;
+  memcpy(ch->buffer + start, data, first);
+  memcpy(ch->buffer, (const uint8_t*) data + first, len - first);
+  ch->head += len;
+
+  start_write();
+  return len;
+}
+
+returncode_t libtock_console_mux_printf(uint8_t channel, const char* fmt, ...) {
+  if (channel >= LIBTOCK_CONSOLE_MUX_CHANNELS || mux.channels[channel].buffer == NULL) return RETURNCODE_EOFF;
+
+  char message[LIBTOCK_CONSOLE_MUX_FRAME_DATA + 1];
+  va_list ap;
+  va_start(ap, fmt);
+  int len = libtock_console_vsnprintf(message, sizeof(message), fmt, ap);
+  va_end(ap);
+  if (len < 0) return RETURNCODE_EINVAL;
+  if (len > LIBTOCK_CONSOLE_MUX_FRAME_DATA) len = LIBTOCK_CONSOLE_MUX_FRAME_DATA;
+
+  if (libtock_console_mux_space(channel) < (uint32_t) len) {
+    mux.channels[channel].dropped += len;
+    return RETURNCODE_ENOMEM;
+  }
+  libtock_console_mux_write(channel, message, len);
+  return RETURNCODE_SUCCESS;
+}
+
+bool libtock_console_mux_empty(void) {
+  if (mux.writing >= 0) return false;
+  for (int c = 0; c < LIBTOCK_CONSOLE_MUX_CHANNELS; c++) {
+    if (mux.channels[c].head != mux.channels[c].tail) return false;
+  }
+  return true;
+}
+
+uint32_t libtock_console_mux_dropped(uint8_t channel) {
+  if (channel >= LIBTOCK_CONSOLE_MUX_CHANNELS) return 0;
+  return mux.channels[channel].dropped;
+}
@@ -0,0 +1,78 @@
+/*
+ * Multiplexed console channels.
+ *
+ * Several streams share the console without one holding up another. Each
+ * channel has its own ring buffer, and the console is fed with small frames
+ * taken from the rings by priority: channel 0 first, then 1, and so on. A
+ * log line queued on a high priority channel goes out after at most one
+ * frame of a bulk dump on a lower one, instead of after the whole dump.
+ *
+ * Frame format:
+ *
+ *     0x00, 0xFE, channel, n (1..LIBTOCK_CONSOLE_MUX_FRAME_DATA), n bytes
+ *
+ * The leading zero byte and the 0xFE tag keep frames apart from plain text
+ * and from `libtock/services/log.h` frames. `tools/console_demux.py` splits
+ * the console stream back into channels on the host.
+ *
+ * The channels drain through chained `libtock_console_write()` calls, so
+ * they cannot be used together with buffered stdout
+ * (`libtock/services/stdout_buffer.h`), and `printf()` while frames drain
+ * fails with RETURNCODE_EBUSY. Nothing here blocks; libtock-sync has
+ * blocking writes and a flush.
+ */
+
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef LIBTOCK_CONSOLE_MUX_CHANNELS
+#define LIBTOCK_CONSOLE_MUX_CHANNELS 4
+#endif
+
+// Largest payload of one frame. Smaller frames let a high priority channel
+// in sooner; larger ones spend less on headers and console writes.
+#ifndef LIBTOCK_CONSOLE_MUX_FRAME_DATA
+#define LIBTOCK_CONSOLE_MUX_FRAME_DATA 64
+#endif
+
+#define LIBTOCK_CONSOLE_MUX_HEADER 4
+
+// Give `channel` a ring buffer of `len` bytes. Lower channels drain first.
+//
+// Returns RETURNCODE_EINVAL if `channel` is not below
+// `LIBTOCK_CONSOLE_MUX_CHANNELS` or `len` is zero, and RETURNCODE_EBUSY if
+// the channel already has a buffer.
+returncode_t libtock_console_mux_open(uint8_t channel, uint8_t* buffer, uint32_t len);
+
+// Copy as much of `data` into the channel's ring as fits and start
+// draining. Returns the number of bytes copied, 0 for a channel that is not
+// open.
+uint32_t libtock_console_mux_write(uint8_t channel, const void* data, uint32_t len);
+
+// Format a message with `libtock_console_vsnprintf()` and queue it whole,
+// or drop it if it does not fit. Messages are cut to
+// `LIBTOCK_CONSOLE_MUX_FRAME_DATA` bytes.
+//
+// Returns RETURNCODE_ENOMEM if the message was dropped, and RETURNCODE_EOFF
+// for a channel that is not open.
+__attribute__ ((format(printf, 2, 3)))
+returncode_t libtock_console_mux_printf(uint8_t channel, const char* fmt, ...);
+
+// Bytes `channel` can take without its ring filling up.
+uint32_t libtock_console_mux_space(uint8_t channel);
+
+// True once every channel's bytes have been written to the console.
+bool libtock_console_mux_empty(void);
+
+// Bytes of `channel` dropped because a message did not fit or a console
+// write failed.
+uint32_t libtock_console_mux_dropped(uint8_t channel);
+
+#ifdef __cplusplus
+}
+#endif
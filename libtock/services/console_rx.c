@@ -0,0 +1,125 @@
+#include "console_rx.h"
+#include "ringbuf.h"
+#include "../interface/syscalls/console_syscalls.h"
+
+typedef struct {
+  libtock_ringbuf_t ring;
+  uint32_t chunk;
+  // Length of the outstanding read, zero if none.
+  uint32_t armed;
+  bool running;
+  uint32_t overruns;
+  libtock_console_rx_callback callback;
+} console_rx_t;
+
+static console_rx_t rx;
+
+// Start a read into the ring's free span, unless one is outstanding. The
+// driver writes straight into the ring and the upcall commits what arrived.
+static returncode_t arm(void) {
+  if (!rx.running || rx.armed != 0) return RETURNCODE_SUCCESS;
+
+  uint32_t len;
+  uint8_t* span = libtock_ringbuf_write_span(&rx.ring, &len);
+  if (span == NULL) {
+    rx.overruns++;
+    return RETURNCODE_SUCCESS;
+  }
+  if (len > rx.chunk) len = rx.chunk;
+
+  returncode_t ret = libtock_console_set_readwrite_allow(span, len);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = libtock_console_command_read(len);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  rx.armed = len;
+  return RETURNCODE_SUCCESS;
+}
+
+static void read_upcall(int status, int length, __attribute__ ((unused)) int unused2,
+                        __attribute__ ((unused)) void* opaque) {
+  if (!rx.running) return;
+
+  uint32_t received = (uint32_t) length;
+  if (received > rx.armed) received = rx.armed;
+  rx.armed = 0;
+  libtock_ringbuf_commit(&rx.ring, received);
+
+  // Re-arm before running any app code so as few bytes as possible are
+  // missed. A failed read is not retried, as it would likely fail again.
+  int ret = tock_status_to_returncode((statuscode_t) status);
+  if (ret == RETURNCODE_SUCCESS || ret == RETURNCODE_ECANCEL) {
+    arm();
+  }
+
+  if (received > 0 && rx.callback != NULL) {
+    rx.callback(received, libtock_ringbuf_used(&rx.ring));
+  }
+}
+
+returncode_t libtock_console_rx_start(uint8_t* ring, uint32_t size, uint32_t chunk,
+                                      libtock_console_rx_callback callback) {
+  if (chunk == 0) return RETURNCODE_EINVAL;
+  if (rx.running) return RETURNCODE_EBUSY;
+
+  returncode_t ret = libtock_ringbuf_init(&rx.ring, ring, size);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtock_console_read_done_set_upcall(read_upcall, NULL);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  rx.chunk    = chunk;
+  rx.armed    = 0;
+  rx.running  = true;
+  rx.overruns = 0;
+  rx.callback = callback;
+
+  ret = arm();
+  if (ret != RETURNCODE_SUCCESS) {
+    rx.running = false;
+  }
+  return ret;
+}
+
+returncode_t libtock_console_rx_stop(void) {
+  if (!rx.running) return RETURNCODE_EALREADY;
+
+  rx.running = false;
+  if (rx.armed != 0) {
+    rx.armed = 0;
+    libtock_console_command_abort_read();
+  }
+  return libtock_console_set_readwrite_allow(NULL, 0);
+}
+
+bool libtock_console_rx_running(void) {
+  return rx.running;
+}
+
+returncode_t libtock_console_rx_flush(void) {
+  if (!rx.running) return RETURNCODE_EOFF;
+  if (rx.armed == 0) return RETURNCODE_SUCCESS;
+  return libtock_console_command_abort_read();
+}
+
+uint32_t libtock_console_rx_available(void) {
+  return libtock_ringbuf_used(&rx.ring);
+}
+
+uint32_t libtock_console_rx_read(uint8_t* buffer, uint32_t len) {
+  len = libtock_ringbuf_read(&rx.ring, buffer, len);
+
+  // Receiving pauses when the ring is full, resume it now there is space.
+  if (len > 0) arm();
+  return len;
+}
+
+int libtock_console_rx_getc(void) {
+  uint8_t c;
+  if (libtock_console_rx_read(&c, 1) == 0) return -1;
+  return c;
+}
+
+uint32_t libtock_console_rx_overruns(void) {
+  return rx.overruns;
+}
@@ -0,0 +1,69 @@
+/*
+ * Continuous console receive.
+ *
+ * `libtock_console_read()` reads a fixed number of bytes, and bytes that
+ * arrive before the next read is started are lost. This service keeps a read
+ * outstanding at all times instead: it allows the free part of a ring buffer
+ * to the console driver, and re-arms the read from the upcall as soon as one
+ * completes, before any app code runs. The app consumes bytes from the ring
+ * whenever it likes.
+ *
+ * The console driver completes a read only once the requested number of bytes
+ * has arrived. `chunk` sets that number: 1 delivers every byte immediately,
+ * larger values save a syscall round trip per byte but bytes only become
+ * visible when a chunk fills or `libtock_console_rx_flush()` is called.
+ *
+ * While running, this service owns the console read upcall and read-write
+ * allow, so `libtock_console_read()` must not be used.
+ */
+
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Function signature for data available callbacks.
+//
+// - `arg1` (`uint32_t`): Number of bytes that just arrived.
+// - `arg2` (`uint32_t`): Number of bytes now available to read.
+typedef void (*libtock_console_rx_callback)(uint32_t, uint32_t);
+
+// Start receiving into `ring`, which must stay valid until
+// `libtock_console_rx_stop()`. `callback` may be NULL.
+//
+// Returns RETURNCODE_EINVAL if `size` is not a power of two or `chunk` is
+// zero, RETURNCODE_EBUSY if
+// receiving is already running, or the error from starting the first read.
+returncode_t libtock_console_rx_start(uint8_t* ring, uint32_t size, uint32_t chunk,
+                                      libtock_console_rx_callback callback);
+
+// Stop receiving. Bytes still in the ring can be read afterwards, bytes of a
+// partially received chunk are discarded.
+returncode_t libtock_console_rx_stop(void);
+
+// True between `libtock_console_rx_start()` and `libtock_console_rx_stop()`.
+bool libtock_console_rx_running(void);
+
+// Complete the outstanding read early so the bytes received so far become
+// available. Receiving continues afterwards.
+returncode_t libtock_console_rx_flush(void);
+
+// Number of bytes ready to be read.
+uint32_t libtock_console_rx_available(void);
+
+// Copy up to `len` received bytes into `buffer`. Returns the number copied.
+uint32_t libtock_console_rx_read(uint8_t* buffer, uint32_t len);
+
+// Returns the next received byte, or -1 if none is available.
+int libtock_console_rx_getc(void);
+
+// Number of times the ring was full, which pauses receiving until bytes are
+// read. Bytes sent to a paused console are lost.
+uint32_t libtock_console_rx_overruns(void);
+
+#ifdef __cplusplus
+}
+#endif
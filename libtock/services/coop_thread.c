@@ -0,0 +1,314 @@
+#include "coop_thread.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Stacks are aligned to 16 bytes, which satisfies both the ARM AAPCS (8) and
+// RISC-V (16) ABIs.
+#define STACK_ALIGN 16
+
+// The context that first created a thread (normally `main()`). Its stack is
+// the process stack, so it is never freed.
+static libtock_coop_thread_t main_thread = {
+  .sp         = NULL,
+  .waiting_on = NULL,
+  .until      = NULL,
+  .until_ctx  = NULL,
+  .fn         = NULL,
+  .arg        = NULL,
+  .stack      = NULL,
+  .done       = false,
+  .next       = &main_thread,
+};
+
+// The running thread. Threads form a circular list through `next`.
+static libtock_coop_thread_t* current = &main_thread;
+
+// A thread that has returned but whose stack has not been freed yet. A thread
+// cannot free the stack it is running on, so the next thread to run does it.
+static libtock_coop_thread_t* zombie = NULL;
+
+static int live_threads = 1;
+
+static void thread_entry(void);
+
+#if defined(__thumb__)
+
+#define COOP_THREAD_SUPPORTED 1
+
+// Save the callee-saved registers of the running thread on its stack, store
+// its stack pointer in `*save_sp`, and restore the thread whose stack pointer
+// is `new_sp`. Written for ARMv6-M, where push and pop only take r0-r7 and lr.
+//
+// Frame layout, from the lowest address: r8, r9, r10, r11, r4, r5, r6, r7, lr.
+__attribute__ ((naked, noinline))
+static void coop_thread_switch(__attribute__ ((unused)) void** save_sp,
+                               __attribute__ ((unused)) void*  new_sp) {
+  __asm__ volatile (
+    "push {r4-r7, lr}  \n"
+    "mov  r4, r8       \n"
+    "mov  r5, r9       \n"
+    "mov  r6, r10      \n"
+    "mov  r7, r11      \n"
+    "push {r4-r7}      \n"
+    "mov  r2, sp       \n"
+    "str  r2, [r0]     \n"
+    "mov  sp, r1       \n"
+    "pop  {r4-r7}      \n"
+    "mov  r8, r4       \n"
+    "mov  r9, r5       \n"
+    "mov  r10, r6      \n"
+    "mov  r11, r7      \n"
+    "pop  {r4-r7, pc}  \n"
+    );
+}
+
+#define FRAME_WORDS 9
+
+static void* coop_thread_init_frame(uint32_t* top) {
+  uint32_t* frame = top - FRAME_WORDS;
+  for (int i = 0; i < FRAME_WORDS; i++) {
+    frame[i] = 0;
+  }
+  // r9 holds the PIC base, which all threads share.
+  uint32_t r9;
+  __asm__ volatile ("mov %0, r9" : "=r" (r9));
+  frame[1] = r9;
+  // Function pointers already have the Thumb bit set.
+  frame[8] = (uint32_t) thread_entry;
+  return frame;
+}
+
+#elif defined(__riscv)
+
+#define COOP_THREAD_SUPPORTED 1
+
+// Save the callee-saved registers of the running thread on its stack, store
+// its stack pointer in `*save_sp`, and restore the thread whose stack pointer
+// is `new_sp`.
+//
+// Frame layout, from the lowest address: ra, s0-s11, padded to 16 bytes.
+__attribute__ ((naked, noinline))
+static void coop_thread_switch(__attribute__ ((unused)) void** save_sp,
+                               __attribute__ ((unused)) void*  new_sp) {
+  __asm__ volatile (
+    "addi sp, sp, -64  \n"
+    "sw   ra,  0(sp)   \n"
+    "sw   s0,  4(sp)   \n"
+    "sw   s1,  8(sp)   \n"
+    "sw   s2,  12(sp)  \n"
+    "sw   s3,  16(sp)  \n"
+    "sw   s4,  20(sp)  \n"
+    "sw   s5,  24(sp)  \n"
+    "sw   s6,  28(sp)  \n"
+    "sw   s7,  32(sp)  \n"
+    "sw   s8,  36(sp)  \n"
+    "sw   s9,  40(sp)  \n"
+    "sw   s10, 44(sp)  \n"
+    "sw   s11, 48(sp)  \n"
+    "sw   sp,  0(a0)   \n"
+    "mv   sp,  a1      \n"
+    "lw   ra,  0(sp)   \n"
+    "lw   s0,  4(sp)   \n"
+    "lw   s1,  8(sp)   \n"
+    "lw   s2,  12(sp)  \n"
+    "lw   s3,  16(sp)  \n"
+    "lw   s4,  20(sp)  \n"
+    "lw   s5,  24(sp)  \n"
+    "lw   s6,  28(sp)  \n"
+    "lw   s7,  32(sp)  \n"
+    "lw   s8,  36(sp)  \n"
+    "lw   s9,  40(sp)  \n"
+    "lw   s10, 44(sp)  \n"
+    "lw   s11, 48(sp)  \n"
+    "addi sp, sp, 64   \n"
+    "ret               \n"
+    );
+}
+
+#define FRAME_WORDS 16
+
+static void* coop_thread_init_frame(uint32_t* top) {
+  uint32_t* frame = top - FRAME_WORDS;
+  for (int i = 0; i < FRAME_WORDS; i++) {
+    frame[i] = 0;
+  }
+  frame[0] = (uint32_t) thread_entry;
+  return frame;
+}
+
+#else
+
+// No context switch is available, `libtock_coop_thread_create()` fails before
+// one is needed.
+#define COOP_THREAD_SUPPORTED 0
+
+static void coop_thread_switch(__attribute__ ((unused)) void** save_sp,
+                               __attribute__ ((unused)) void*  new_sp) {
+  abort();
+}
+
+static void* coop_thread_init_frame(uint32_t* top) {
+  (void) thread_entry;
+  return top;
+}
+
+#endif
+
+static bool runnable(libtock_coop_thread_t* thread) {
+  if (thread->done) {
+    return false;
+  }
+  if (thread->waiting_on != NULL) {
+    return *thread->waiting_on;
+  }
+  if (thread->until != NULL) {
+    return thread->until(thread->until_ctx);
+  }
+  return true;
+}
+
+// Unlink and free a finished thread, unless it is the one running.
+static void reap(void) {
+  if (zombie == NULL || zombie == current) {
+    return;
+  }
+  libtock_coop_thread_t* prev = zombie;
+  while (prev->next != zombie) {
+    prev = prev->next;
+  }
+  prev->next = zombie->next;
+  free(zombie->stack);
+  zombie->stack = NULL;
+  zombie        = NULL;
+}
+
+static void switch_to(libtock_coop_thread_t* thread) {
+  if (thread == current) {
+    return;
+  }
+  libtock_coop_thread_t* prev = current;
+  current = thread;
+  coop_thread_switch(&prev->sp, thread->sp);
+  reap();
+}
+
+// Resume the next runnable thread after the current one, possibly the current
+// one itself. Only call into the kernel once no thread can make progress.
+static void schedule(void) {
+  while (true) {
+    libtock_coop_thread_t* thread = current->next;
+    while (true) {
+      if (runnable(thread)) {
+        switch_to(thread);
+        return;
+      }
+      if (thread == current) {
+        break;
+      }
+      thread = thread->next;
+    }
+    yield();
+  }
+}
+
+static void thread_entry(void) {
+  reap();
+  current->fn(current->arg);
+
+  current->done = true;
+  zombie        = current;
+  live_threads--;
+  // A finished thread is never runnable, so this does not return.
+  schedule();
+  abort();
+}
+
+static void coop_yield_for(bool* cond) {
+  libtock_coop_thread_t* self = current;
+  self->waiting_on = cond;
+  while (!*cond) {
+    schedule();
+  }
+  self->waiting_on = NULL;
+}
+
+static void coop_yield_until(bool (*ready)(void* ctx), void* ctx) {
+  libtock_coop_thread_t* self = current;
+  self->until     = ready;
+  self->until_ctx = ctx;
+  while (!ready(ctx)) {
+    schedule();
+  }
+  self->until     = NULL;
+  self->until_ctx = NULL;
+}
+
+// Yield-WaitFor blocks the whole process and does not deliver the upcall to a
+// function, so it cannot be parked like `yield_for()`. Let the other runnable
+// threads start their own operations first, then block in the kernel.
+static bool coop_yield_wait_for(__attribute__ ((unused)) uint32_t driver,
+                                __attribute__ ((unused)) uint32_t subscribe,
+                                __attribute__ ((unused)) yield_waitfor_return_t* ret) {
+  libtock_coop_thread_yield();
+  return false;
+}
+
+static const tock_yield_hooks_t coop_yield_hooks = {
+  .yield_for      = coop_yield_for,
+  .yield_until    = coop_yield_until,
+  .yield_wait_for = coop_yield_wait_for,
+};
+
+returncode_t libtock_coop_thread_create(libtock_coop_thread_t* thread, libtock_coop_thread_fn fn, void* arg,
+                                        size_t stack_size) {
+  if (!COOP_THREAD_SUPPORTED) {
+    return RETURNCODE_ENOSUPPORT;
+  }
+  if (stack_size < LIBTOCK_COOP_THREAD_MIN_STACK) {
+    return RETURNCODE_EINVAL;
+  }
+
+  uint8_t* stack = malloc(stack_size);
+  if (stack == NULL) {
+    return RETURNCODE_ENOMEM;
+  }
+
+  uintptr_t top = ((uintptr_t) stack + stack_size) & ~((uintptr_t) STACK_ALIGN - 1);
+
+  thread->sp         = coop_thread_init_frame((uint32_t*) top);
+  thread->waiting_on = NULL;
+  thread->until      = NULL;
+  thread->until_ctx  = NULL;
+  thread->fn         = fn;
+  thread->arg        = arg;
+  thread->stack      = stack;
+  thread->done       = false;
+
+  // Insert after the running thread so it runs next.
+  thread->next  = current->next;
+  current->next = thread;
+  live_threads++;
+
+  tock_set_yield_hooks(&coop_yield_hooks);
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_coop_thread_yield(void) {
+  libtock_coop_thread_t* thread = current->next;
+  while (thread != current) {
+    if (runnable(thread)) {
+      switch_to(thread);
+      return;
+    }
+    thread = thread->next;
+  }
+}
+
+libtock_coop_thread_t* libtock_coop_thread_self(void) {
+  return current;
+}
+
+int libtock_coop_thread_count(void) {
+  return live_threads;
+}
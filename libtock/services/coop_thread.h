@@ -0,0 +1,95 @@
+/*
+ * Cooperative threads.
+ *
+ * This module runs several sequential workflows inside one process. Each
+ * thread has its own stack allocated from the app heap. Threads are never
+ * preempted: they switch only when the running thread waits.
+ *
+ * Once a thread has been created, `yield_for()`, `yield_for_any()` and
+ * `yield_until()` no longer block the whole process. Instead, the calling
+ * thread is parked and another runnable thread is resumed. The kernel is only
+ * asked to `yield()` when every thread is waiting. This lets one app overlap
+ * several blocking `libtocksync_*` operations, including ones with a timeout,
+ * for example a sensor read in one thread and a radio session in another.
+ *
+ * Wrappers built on `yield_wait_for()` cannot be parked the same way, because
+ * the kernel hands the upcall back only to the caller of Yield-WaitFor. Those
+ * first let the other runnable threads run, so they can start their own
+ * operations, and then block the process until their own upcall arrives.
+ *
+ * The context that calls `libtock_coop_thread_create()` first (normally
+ * `main()`) becomes a thread itself and takes part in scheduling.
+ *
+ * Only one thread may wait on a given upcall (driver and subscribe number) at
+ * a time. Upcalls and deferred tasks run on the stack of whichever thread
+ * called into the kernel, so stacks must leave room for them.
+ */
+
+#pragma once
+
+#include "../tock.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Smallest accepted stack size, in bytes.
+#define LIBTOCK_COOP_THREAD_MIN_STACK 256
+
+// Function signature for a thread entry point.
+//
+// - `arg1` (`arg`): The pointer passed to `libtock_coop_thread_create()`.
+typedef void (*libtock_coop_thread_fn)(void*);
+
+/** \brief Handle to a cooperative thread.
+ *
+ * The storage is owned by the caller and must remain valid until `done` is
+ * true. The stack is owned by the library and freed when the thread returns.
+ */
+typedef struct libtock_coop_thread {
+  // Saved stack pointer while the thread is switched out.
+  void* sp;
+  // Condition the thread is waiting on in `yield_for()`, or NULL.
+  bool* waiting_on;
+  // Predicate and its context the thread is waiting on in `yield_until()` (and
+  // so `yield_for_any()` and the libtock-sync timed waits), or NULL. A thread
+  // waiting on neither is runnable.
+  bool (*until)(void* ctx);
+  void* until_ctx;
+  libtock_coop_thread_fn fn;
+  void* arg;
+  void* stack;
+  // Set once `fn` has returned. Other threads can `yield_for(&thread->done)`
+  // to join.
+  bool done;
+  struct libtock_coop_thread* next;
+} libtock_coop_thread_t;
+
+// Create a thread that runs `fn(arg)` on a new `stack_size` byte stack.
+//
+// The thread becomes runnable immediately but does not start until the caller
+// waits or calls `libtock_coop_thread_yield()`.
+//
+// Returns RETURNCODE_EINVAL if `stack_size` is below
+// `LIBTOCK_COOP_THREAD_MIN_STACK`, RETURNCODE_ENOMEM if the stack cannot be
+// allocated, and RETURNCODE_ENOSUPPORT on architectures without a context
+// switch implementation.
+returncode_t libtock_coop_thread_create(libtock_coop_thread_t* thread, libtock_coop_thread_fn fn, void* arg,
+                                        size_t stack_size);
+
+// Let other runnable threads execute before continuing. This does not call
+// into the kernel, so pending upcalls are not delivered.
+void libtock_coop_thread_yield(void);
+
+// Returns the running thread.
+libtock_coop_thread_t* libtock_coop_thread_self(void);
+
+// Returns the number of threads that have not finished, including the initial
+// context.
+int libtock_coop_thread_count(void);
+
+#ifdef __cplusplus
+}
+#endif
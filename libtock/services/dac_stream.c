@@ -0,0 +1,81 @@
+#include "../peripherals/dac.h"
+#include "dac_stream.h"
+
+static void schedule_next(libtock_dac_stream_t* stream);
+
+static void sample_due(uint32_t now, uint32_t scheduled, void* opaque) {
+  libtock_dac_stream_t* stream = (libtock_dac_stream_t*) opaque;
+  if (!stream->running) return;
+
+  uint16_t* buffer = stream->buffers[stream->playing];
+  libtock_dac_command_set_value(buffer[stream->pos]);
+  if (now - scheduled > stream->step) {
+    // Restart the schedule from here rather than catching up in a burst.
+    stream->late++;
+    stream->deadline = now;
+  }
+
+  stream->pos++;
+  bool finished = stream->pos == stream->length;
+  if (finished) {
+    stream->pos = 0;
+    if (stream->buffers[1] != NULL) stream->playing ^= 1;
+  }
+
+  // The next sample is scheduled first so the refill does not delay it.
+  schedule_next(stream);
+  if (finished && stream->cb) stream->cb(buffer, stream->opaque);
+}
+
+static void schedule_next(libtock_dac_stream_t* stream) {
+  uint32_t step = stream->step;
+  stream->frac += stream->step_frac;
+  if (stream->frac >= stream->frequency) {
+    stream->frac -= stream->frequency;
+    step++;
+  }
+
+  uint32_t reference = stream->deadline;
+  stream->deadline += step;
+  libtock_alarm_at(reference, step, sample_due, stream, &stream->alarm);
+}
+
+returncode_t libtock_dac_stream_start(libtock_dac_stream_t* stream, uint32_t frequency, uint16_t* first,
+                                      uint16_t* second, uint32_t length,
+                                      libtock_dac_stream_callback cb, void* opaque) {
+  uint32_t ticks;
+  returncode_t ret = libtock_alarm_get_frequency(&ticks);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (frequency == 0 || frequency > ticks || first == NULL || length == 0) return RETURNCODE_EINVAL;
+
+  uint32_t now;
+  ret = libtock_alarm_command_read(&now);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  stream->buffers[0] = first;
+  stream->buffers[1] = second;
+  stream->length     = length;
+  stream->playing    = 0;
+  stream->pos        = 0;
+  stream->frequency  = frequency;
+  stream->step       = ticks / frequency;
+  stream->step_frac  = ticks % frequency;
+  stream->frac       = 0;
+  stream->deadline   = now;
+  stream->late       = 0;
+  stream->running    = true;
+  stream->cb         = cb;
+  stream->opaque     = opaque;
+
+  schedule_next(stream);
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_dac_stream_stop(libtock_dac_stream_t* stream) {
+  stream->running = false;
+  libtock_alarm_cancel(&stream->alarm);
+}
+
+uint32_t libtock_dac_stream_late(const libtock_dac_stream_t* stream) {
+  return stream->late;
+}
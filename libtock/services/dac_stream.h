@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../tock.h"
+#include "alarm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Buffered waveform output on the DAC.
+//
+// The DAC driver sets one value per command, so the stream plays sample
+// buffers from the alarm. Each sample is scheduled at an absolute deadline
+// derived from the sample rate, so the rate does not drift with upcall
+// latency. The app is only involved once per buffer.
+//
+// With two buffers the stream alternates between them and calls back with
+// each buffer it finishes, which the app refills before the other one is
+// done playing. With one buffer the stream loops it, which plays a periodic
+// waveform such as a tone without any app involvement.
+//
+// Every sample still costs an alarm upcall, so the usable rate depends on the
+// board. A sample that goes out more than one period late restarts the
+// schedule instead of being followed by a burst, and is counted by
+// `libtock_dac_stream_late()`.
+
+// Function signature for the refill callback.
+//
+// - `arg1` (`uint16_t*`): The buffer that was just played. It is played
+//   again after the other buffer.
+// - `arg2` (`void*`): The opaque pointer passed to
+//   `libtock_dac_stream_start()`.
+typedef void (*libtock_dac_stream_callback)(uint16_t*, void*);
+
+typedef struct {
+  uint16_t* buffers[2];
+  uint32_t length;
+  uint8_t playing;
+  uint32_t pos;
+  // Ticks per sample, `step` plus `step_frac / frequency`.
+  uint32_t frequency;
+  uint32_t step;
+  uint32_t step_frac;
+  uint32_t frac;
+  uint32_t deadline;
+  uint32_t late;
+  bool running;
+  libtock_dac_stream_callback cb;
+  void* opaque;
+  libtock_alarm_ticks_t alarm;
+} libtock_dac_stream_t;
+
+// Start playing `length` samples per buffer at `frequency` samples per
+// second. `second` may be NULL to loop `first`, and `cb` may be NULL if the
+// buffers never change. The DAC must have been initialized.
+//
+// Returns RETURNCODE_EINVAL if `frequency` is 0 or above the alarm frequency,
+// or `length` is 0.
+returncode_t libtock_dac_stream_start(libtock_dac_stream_t* stream, uint32_t frequency, uint16_t* first,
+                                      uint16_t* second, uint32_t length,
+                                      libtock_dac_stream_callback cb, void* opaque);
+
+// Stop after the current sample. No callback follows.
+void libtock_dac_stream_stop(libtock_dac_stream_t* stream);
+
+// Number of samples that went out more than one sample period late.
+uint32_t libtock_dac_stream_late(const libtock_dac_stream_t* stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,171 @@
+#include <string.h>
+#include <unistd.h>
+
+#include "dma_buffer.h"
+
+#define ALIGN LIBTOCK_DMA_BUFFER_ALIGN
+
+// Rounded up to whole alignment units.
+#define UNITS(n) (((n) + ALIGN - 1) & ~(uint32_t) (ALIGN - 1))
+
+// The pool is a list of segments taken from the heap break, each a run of
+// blocks: a header and the buffer after it. Headers take whole alignment
+// units, so every buffer starts aligned and none shares a cache line with
+// bookkeeping.
+typedef struct segment {
+  struct segment* next;
+  // Bytes of blocks after the segment header.
+  uint32_t size;
+} segment_t;
+
+typedef struct {
+  // Bytes of the buffer after the block header.
+  uint32_t size;
+  bool free;
+} block_t;
+
+#define SEGMENT_HEADER UNITS(sizeof(segment_t))
+#define BLOCK_HEADER   UNITS(sizeof(block_t))
+
+// Allows carry no owner of their buffers, so the pool is global.
+static struct {
+  segment_t* first;
+  segment_t* last;
+  libtock_dma_buffer_stats_t stats;
+} pool;
+
+static block_t* first_block(segment_t* segment) {
+  return (block_t*) ((uint8_t*) segment + SEGMENT_HEADER);
+}
+
+static uint8_t* segment_end(segment_t* segment) {
+  return (uint8_t*) first_block(segment) + segment->size;
+}
+
+static block_t* next_block(block_t* block) {
+  return (block_t*) ((uint8_t*) block + BLOCK_HEADER + block->size);
+}
+
+static void* block_buffer(block_t* block) {
+  return (uint8_t*) block + BLOCK_HEADER;
+}
+
+// Add `len` bytes of blocks, a multiple of the alignment, as one free block.
+// Memory the heap break hands out right after the last segment extends it;
+// anything else starts a new segment.
+static returncode_t grow(uint32_t len) {
+  segment_t* last = pool.last;
+  block_t* block;
+  if (last != NULL && sbrk(0) == segment_end(last)) {
+    if (sbrk((int) len) == (void*) -1) return RETURNCODE_ENOMEM;
+    block        = (block_t*) segment_end(last);
+    last->size  += len;
+    pool.stats.pool_size += len;
+  } else {
+    uint32_t total = SEGMENT_HEADER + len + ALIGN - 1;
+    void* start    = sbrk((int) total);
+    if (start == (void*) -1) return RETURNCODE_ENOMEM;
+
+    segment_t* segment = (segment_t*) (((uintptr_t) start + ALIGN - 1) & ~(uintptr_t) (ALIGN - 1));
+    segment->next = NULL;
+    segment->size = len;
+    if (last != NULL) {
+      last->next = segment;
+    } else {
+      pool.first = segment;
+    }
+    pool.last             = segment;
+    pool.stats.pool_size += total;
+    block = first_block(segment);
+  }
+  block->size = len - BLOCK_HEADER;
+  block->free = true;
+  return RETURNCODE_SUCCESS;
+}
+
+// First free block of at least `size` bytes, merging free neighbours on the
+// way.
+static block_t* find_free(uint32_t size) {
+  for (segment_t* segment = pool.first; segment != NULL; segment = segment->next) {
+    uint8_t* end = segment_end(segment);
+    for (block_t* block = first_block(segment); (uint8_t*) block < end; block = next_block(block)) {
+      if (!block->free) continue;
+      for (block_t* next = next_block(block); (uint8_t*) next < end && next->free; next = next_block(block)) {
+        block->size += BLOCK_HEADER + next->size;
+      }
+      if (block->size >= size) return block;
+    }
+  }
+  return NULL;
+}
+
+// Make sure a free block of `size` bytes exists.
+static block_t* find_or_grow(uint32_t size) {
+  block_t* block = find_free(size);
+  if (block != NULL) return block;
+
+  uint32_t len = BLOCK_HEADER + size;
+  if (len < UNITS(LIBTOCK_DMA_BUFFER_CHUNK)) len = UNITS(LIBTOCK_DMA_BUFFER_CHUNK);
+  if (grow(len) != RETURNCODE_SUCCESS) return NULL;
+  return find_free(size);
+}
+
+void* libtock_dma_buffer_alloc(size_t len) {
+  if (len == 0) return NULL;
+  if (len > UINT32_MAX / 2) {
+    pool.stats.failures++;
+    return NULL;
+  }
+
+  uint32_t size  = UNITS((uint32_t) len);
+  block_t* block = find_or_grow(size);
+  if (block == NULL) {
+    pool.stats.failures++;
+    return NULL;
+  }
+
+  // Split off the rest if it can hold a buffer of its own.
+  if (block->size - size >= BLOCK_HEADER + ALIGN) {
+    block_t* rest = (block_t*) ((uint8_t*) block + BLOCK_HEADER + size);
+    rest->size  = block->size - size - BLOCK_HEADER;
+    rest->free  = true;
+    block->size = size;
+  }
+  block->free = false;
+
+  pool.stats.buffers++;
+  pool.stats.in_use += block->size;
+  if (pool.stats.in_use > pool.stats.peak) pool.stats.peak = pool.stats.in_use;
+
+  void* buffer = block_buffer(block);
+  memset(buffer, 0, block->size);
+  return buffer;
+}
+
+void libtock_dma_buffer_free(void* buffer) {
+  if (buffer == NULL) return;
+
+  block_t* block = (block_t*) ((uint8_t*) buffer - BLOCK_HEADER);
+  if (block->free) return;
+  block->free = true;
+  pool.stats.buffers--;
+  pool.stats.in_use -= block->size;
+}
+
+returncode_t libtock_dma_buffer_reserve(size_t len) {
+  if (len > UINT32_MAX / 2) return RETURNCODE_ENOMEM;
+  if (len == 0) return RETURNCODE_SUCCESS;
+  return find_or_grow(UNITS((uint32_t) len)) != NULL ? RETURNCODE_SUCCESS : RETURNCODE_ENOMEM;
+}
+
+bool libtock_dma_buffer_owns(const void* ptr) {
+  const uint8_t* p = (const uint8_t*) ptr;
+  for (segment_t* segment = pool.first; segment != NULL; segment = segment->next) {
+    if (p >= (const uint8_t*) first_block(segment) && p < segment_end(segment)) return true;
+  }
+  return false;
+}
+
+void libtock_dma_buffer_stats(libtock_dma_buffer_stats_t* stats) {
+  *stats = pool.stats;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Aligned buffers for driver allows.
+//
+// Buffers shared with drivers through allows are read and written by the
+// kernel and, on many chips, by DMA. One that starts in the middle of a
+// word, or shares a cache line with unrelated data, can make the driver copy
+// it through a bounce buffer or fall back to slow unaligned accesses. Buffers
+// from this allocator start on a `LIBTOCK_DMA_BUFFER_ALIGN` boundary and are
+// rounded up to a multiple of it, so no two buffers, and no allocator
+// bookkeeping, share a cache line.
+//
+// The buffers come from a pool kept apart from `malloc()`'s heap. It takes
+// memory from the heap break in chunks of at least `LIBTOCK_DMA_BUFFER_CHUNK`
+// bytes as allocations need it, and never gives it back. Freed buffers are
+// reused first fit, with neighbouring free buffers merged.
+//
+// libtock's own buffer helpers, e.g. `libtock_screen_buffer_init()` and
+// `libtock_touch_allocate_multi_touch_buffer()`, allocate from here. Static
+// buffers can be aligned the same way with `LIBTOCK_DMA_ALIGNED`:
+//
+//     static uint16_t samples[256] LIBTOCK_DMA_ALIGNED;
+//     libtock_adc_set_buffer(samples, 256);
+
+// Alignment of every buffer and the unit buffer sizes are rounded to. 32
+// bytes is the cache line of the cached Cortex-M cores; 4 keeps them word
+// aligned with the least padding. Must be a power of two.
+#ifndef LIBTOCK_DMA_BUFFER_ALIGN
+#define LIBTOCK_DMA_BUFFER_ALIGN 32
+#endif
+
+// Least the pool grows by when no free buffer fits.
+#ifndef LIBTOCK_DMA_BUFFER_CHUNK
+#define LIBTOCK_DMA_BUFFER_CHUNK 1024
+#endif
+
+// Align a static or stack buffer like the allocated ones.
+#define LIBTOCK_DMA_ALIGNED __attribute__ ((aligned(LIBTOCK_DMA_BUFFER_ALIGN)))
+
+typedef struct {
+  // Bytes taken from the heap break, including bookkeeping.
+  uint32_t pool_size;
+  // Bytes in buffers now allocated, after rounding, and the most ever.
+  uint32_t in_use;
+  uint32_t peak;
+  // Buffers now allocated.
+  uint32_t buffers;
+  // Allocations that failed because the kernel could not grow the app's
+  // memory.
+  uint32_t failures;
+} libtock_dma_buffer_stats_t;
+
+// Returns a zeroed buffer of at least `len` bytes, or NULL if `len` is 0 or
+// the memory cannot be had.
+void* libtock_dma_buffer_alloc(size_t len);
+
+// Return `buffer` to the pool. `buffer` may be NULL.
+void libtock_dma_buffer_free(void* buffer);
+
+// Grow the pool so that `len` bytes can be allocated later without taking
+// more memory, e.g. before `malloc()` moves the heap break past it.
+//
+// Returns RETURNCODE_ENOMEM if the kernel cannot grow the app's memory.
+returncode_t libtock_dma_buffer_reserve(size_t len);
+
+// Whether `ptr` points into the pool.
+bool libtock_dma_buffer_owns(const void* ptr);
+
+void libtock_dma_buffer_stats(libtock_dma_buffer_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,294 @@
+#include <string.h>
+
+#include "../display/blit.h"
+#include "framebuffer.h"
+
+static uint32_t area(const libtock_framebuffer_rect_t* r) {
+  return (uint32_t) r->width * r->height;
+}
+
+static libtock_framebuffer_rect_t rect_union(const libtock_framebuffer_rect_t* a, const libtock_framebuffer_rect_t* b) {
+  uint16_t x0 = a->x < b->x ? a->x : b->x;
+  uint16_t y0 = a->y < b->y ? a->y : b->y;
+  uint16_t x1 = a->x + a->width > b->x + b->width ? a->x + a->width : b->x + b->width;
+  uint16_t y1 = a->y + a->height > b->y + b->height ? a->y + a->height : b->y + b->height;
+  libtock_framebuffer_rect_t u = { x0, y0, x1 - x0, y1 - y0 };
+  return u;
+}
+
+// Pixels added by merging `a` and `b`, or 0 if the union covers no more than
+// the two rectangles did.
+static uint32_t merge_cost(const libtock_framebuffer_rect_t* a, const libtock_framebuffer_rect_t* b) {
+  libtock_framebuffer_rect_t u = rect_union(a, b);
+  uint32_t separate = area(a) + area(b);
+  return area(&u) > separate ? area(&u) - separate : 0;
+}
+
+static void merge(libtock_framebuffer_rect_t* rects, int* count, int i, int j) {
+  rects[i] = rect_union(&rects[i], &rects[j]);
+  rects[j] = rects[*count - 1];
+  (*count)--;
+}
+
+void libtock_framebuffer_mark(libtock_framebuffer_t* fb, int x, int y, int width, int height) {
+  if (x < 0) {
+    width += x;
+    x      = 0;
+  }
+  if (y < 0) {
+    height += y;
+    y       = 0;
+  }
+  if (x + width > fb->width) width = fb->width - x;
+  if (y + height > fb->height) height = fb->height - y;
+  if (width <= 0 || height <= 0) return;
+
+  libtock_framebuffer_rect_t rects[LIBTOCK_FRAMEBUFFER_RECTS + 1];
+  int count = fb->dirty_count;
+  memcpy(rects, fb->dirty, count * sizeof(rects[0]));
+  rects[count++] = (libtock_framebuffer_rect_t) { x, y, width, height };
+
+  // Merge whatever merges for free, until nothing does.
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (int i = 0; i < count && !merged; i++) {
+      for (int j = i + 1; j < count && !merged; j++) {
+        if (merge_cost(&rects[i], &rects[j]) == 0) {
+          merge(rects, &count, i, j);
+          merged = true;
+        }
+      }
+    }
+  }
+
+  if (count > LIBTOCK_FRAMEBUFFER_RECTS) {
+    int best_i = 0, best_j = 1;
+    uint32_t best = UINT32_MAX;
+    for (int i = 0; i < count; i++) {
+      for (int j = i + 1; j < count; j++) {
+        uint32_t cost = merge_cost(&rects[i], &rects[j]);
+        if (cost < best) {
+          best   = cost;
+          best_i = i;
+          best_j = j;
+        }
+      }
+    }
+    merge(rects, &count, best_i, best_j);
+  }
+
+  memcpy(fb->dirty, rects, count * sizeof(rects[0]));
+  fb->dirty_count = count;
+}
+
+returncode_t libtock_framebuffer_init(libtock_framebuffer_t* fb, uint8_t* pixels, uint16_t width, uint16_t height,
+                                      libtock_screen_format_t format, uint8_t* transfer, size_t transfer_len) {
+  int bits = libtock_screen_get_bits_per_pixel(format);
+  if (bits < 8 || bits % 8 != 0) return RETURNCODE_ENOSUPPORT;
+  if (transfer_len < (size_t) width * (bits / 8)) return RETURNCODE_ESIZE;
+
+  fb->pixels          = pixels;
+  fb->width           = width;
+  fb->height          = height;
+  fb->bytes_per_pixel = bits / 8;
+  fb->rotation        = ROTATION_NORMAL;
+  fb->transfer        = transfer;
+  fb->transfer_len    = transfer_len;
+  fb->dirty_count     = 0;
+  libtock_framebuffer_mark(fb, 0, 0, width, height);
+  return RETURNCODE_SUCCESS;
+}
+
+static bool quarter_turn(libtock_screen_rotation_t rotation) {
+  return rotation == ROTATION_90 || rotation == ROTATION_270;
+}
+
+void libtock_framebuffer_set_rotation(libtock_framebuffer_t* fb, libtock_screen_rotation_t rotation) {
+  if (quarter_turn(rotation) != quarter_turn(fb->rotation)) {
+    uint16_t width = fb->width;
+    fb->width  = fb->height;
+    fb->height = width;
+  }
+  fb->rotation    = rotation;
+  fb->dirty_count = 0;
+  libtock_framebuffer_mark(fb, 0, 0, fb->width, fb->height);
+}
+
+// Where `r` lands on the panel.
+static libtock_framebuffer_rect_t panel_rect(const libtock_framebuffer_t* fb, const libtock_framebuffer_rect_t* r) {
+  switch (fb->rotation) {
+    case ROTATION_90:
+      return (libtock_framebuffer_rect_t) { fb->height - r->y - r->height, r->x, r->height, r->width };
+    case ROTATION_180:
+      return (libtock_framebuffer_rect_t) { fb->width - r->x - r->width, fb->height - r->y - r->height, r->width,
+                                            r->height };
+    case ROTATION_270:
+      return (libtock_framebuffer_rect_t) { r->y, fb->width - r->x - r->width, r->height, r->width };
+    default:
+      return *r;
+  }
+}
+
+// The part of `r` that lands on `rows` panel rows starting `row` rows into
+// its panel rectangle.
+static libtock_framebuffer_rect_t band_rect(const libtock_framebuffer_t* fb, const libtock_framebuffer_rect_t* r,
+                                            uint16_t row, uint16_t rows) {
+  switch (fb->rotation) {
+    case ROTATION_90:
+      return (libtock_framebuffer_rect_t) { r->x + row, r->y, rows, r->height };
+    case ROTATION_180:
+      return (libtock_framebuffer_rect_t) { r->x, r->y + r->height - row - rows, r->width, rows };
+    case ROTATION_270:
+      return (libtock_framebuffer_rect_t) { r->x + r->width - row - rows, r->y, rows, r->height };
+    default:
+      return (libtock_framebuffer_rect_t) { r->x, r->y + row, r->width, rows };
+  }
+}
+
+static void put_color(uint8_t* p, uint8_t bytes, uint32_t color) {
+  for (int i = bytes - 1; i >= 0; i--) {
+    p[i]    = color & 0xFF;
+    color >>= 8;
+  }
+}
+
+void libtock_framebuffer_set_pixel(libtock_framebuffer_t* fb, int x, int y, uint32_t color) {
+  libtock_framebuffer_fill_rect(fb, x, y, 1, 1, color);
+}
+
+void libtock_framebuffer_fill_rect(libtock_framebuffer_t* fb, int x, int y, int width, int height, uint32_t color) {
+  int x0 = x < 0 ? 0 : x;
+  int y0 = y < 0 ? 0 : y;
+  int x1 = x + width > fb->width ? fb->width : x + width;
+  int y1 = y + height > fb->height ? fb->height : y + height;
+  if (x0 >= x1 || y0 >= y1) return;
+
+  uint8_t bpp   = fb->bytes_per_pixel;
+  size_t stride = (size_t) fb->width * bpp;
+  uint8_t* row  = fb->pixels + y0 * stride + x0 * bpp;
+  if (bpp == 2) {
+    libtock_blit_fill_rect_rgb565(row, stride, x1 - x0, y1 - y0, (uint16_t) color);
+  } else {
+    // Fill the first row, then copy it to the others.
+    for (int i = 0; i < x1 - x0; i++) {
+      put_color(row + i * bpp, bpp, color);
+    }
+    libtock_blit_copy_rect(row + stride, stride, row, 0, (x1 - x0) * bpp, y1 - y0 - 1);
+  }
+  libtock_framebuffer_mark(fb, x0, y0, x1 - x0, y1 - y0);
+}
+
+void libtock_framebuffer_blit(libtock_framebuffer_t* fb, int x, int y, int width, int height, const uint8_t* src) {
+  int x0 = x < 0 ? 0 : x;
+  int y0 = y < 0 ? 0 : y;
+  int x1 = x + width > fb->width ? fb->width : x + width;
+  int y1 = y + height > fb->height ? fb->height : y + height;
+  if (x0 >= x1 || y0 >= y1) return;
+
+  uint8_t bpp   = fb->bytes_per_pixel;
+  size_t stride = (size_t) fb->width * bpp;
+  for (int j = y0; j < y1; j++) {
+    const uint8_t* from = src + ((size_t) (j - y) * width + (x0 - x)) * bpp;
+    memcpy(fb->pixels + j * stride + x0 * bpp, from, (x1 - x0) * bpp);
+  }
+  libtock_framebuffer_mark(fb, x0, y0, x1 - x0, y1 - y0);
+}
+
+// The screen callbacks carry no context, so the flush is global.
+static struct {
+  bool running;
+  libtock_framebuffer_t* fb;
+  libtock_framebuffer_rect_t rects[LIBTOCK_FRAMEBUFFER_RECTS];
+  int count;
+  int index;
+  // Rows of the current rectangle already written, and in the current band.
+  uint16_t row;
+  uint16_t rows;
+  uint8_t* data;
+  size_t len;
+  libtock_framebuffer_callback cb;
+} flush;
+
+static returncode_t next_band(void);
+
+static void finish(returncode_t ret) {
+  flush.running = false;
+  flush.cb(ret);
+}
+
+static void write_done(returncode_t ret) {
+  if (ret != RETURNCODE_SUCCESS) {
+    finish(ret);
+    return;
+  }
+
+  flush.row += flush.rows;
+  if (flush.row == panel_rect(flush.fb, &flush.rects[flush.index]).height) {
+    flush.index++;
+    flush.row = 0;
+  }
+  ret = next_band();
+  if (ret != RETURNCODE_SUCCESS) finish(ret);
+}
+
+static void frame_done(returncode_t ret) {
+  if (ret == RETURNCODE_SUCCESS) {
+    ret = libtock_screen_write(flush.data, flush.len, flush.len, write_done);
+  }
+  if (ret != RETURNCODE_SUCCESS) finish(ret);
+}
+
+// Start writing the next band of rows. Finishes the flush after the last one.
+static returncode_t next_band(void) {
+  if (flush.index == flush.count) {
+    finish(RETURNCODE_SUCCESS);
+    return RETURNCODE_SUCCESS;
+  }
+
+  libtock_framebuffer_t* fb     = flush.fb;
+  libtock_framebuffer_rect_t* r = &flush.rects[flush.index];
+  libtock_framebuffer_rect_t p  = panel_rect(fb, r);
+  uint8_t bpp                   = fb->bytes_per_pixel;
+  size_t stride                 = (size_t) fb->width * bpp;
+  size_t row_bytes              = (size_t) p.width * bpp;
+  uint16_t left                 = p.height - flush.row;
+
+  if (fb->rotation == ROTATION_NORMAL && r->width == fb->width) {
+    // Full rows are contiguous in the framebuffer.
+    flush.rows = left;
+    flush.data = fb->pixels + (r->y + flush.row) * stride;
+  } else {
+    size_t fit = fb->transfer_len / row_bytes;
+    flush.rows = fit < left ? fit : left;
+    libtock_framebuffer_rect_t b = band_rect(fb, r, flush.row, flush.rows);
+    libtock_blit_rotate_rect(fb->transfer, row_bytes, fb->pixels + b.y * stride + b.x * bpp, stride,
+                             b.width, b.height, bpp, fb->rotation);
+    flush.data = fb->transfer;
+  }
+  flush.len = flush.rows * row_bytes;
+
+  return libtock_screen_set_frame(p.x, p.y + flush.row, p.width, flush.rows, frame_done);
+}
+
+returncode_t libtock_framebuffer_flush(libtock_framebuffer_t* fb, libtock_framebuffer_callback cb) {
+  if (flush.running) return RETURNCODE_EBUSY;
+  if (fb->dirty_count == 0) return RETURNCODE_EALREADY;
+
+  memcpy(flush.rects, fb->dirty, fb->dirty_count * sizeof(fb->dirty[0]));
+  flush.count   = fb->dirty_count;
+  flush.fb      = fb;
+  flush.index   = 0;
+  flush.row     = 0;
+  flush.cb      = cb;
+  flush.running = true;
+
+  returncode_t ret = next_band();
+  if (ret != RETURNCODE_SUCCESS) {
+    // The rectangles stay dirty for the next attempt.
+    flush.running = false;
+    return ret;
+  }
+  fb->dirty_count = 0;
+  return RETURNCODE_SUCCESS;
+}
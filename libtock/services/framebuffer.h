@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../display/screen.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Framebuffer with dirty rectangle tracking.
+//
+// The app draws into a full copy of the screen in its own memory. Every
+// drawing call marks the rectangle it touched, and overlapping or adjacent
+// rectangles are merged when that does not add pixels. A flush then sends
+// only the marked rectangles, with one `set_frame` and one write per
+// rectangle where possible, instead of the whole screen.
+//
+// Rectangles that span the full width are written straight from the
+// framebuffer. Narrower ones are copied row by row into the transfer buffer,
+// and a rectangle larger than the transfer buffer is sent in bands of rows.
+//
+// Pixels are stored in the screen's format, most significant byte first, as
+// `libtock_screen_fill()` does. Formats with less than one byte per pixel are
+// not supported.
+//
+// For panels whose controller cannot rotate, `libtock_framebuffer_set_rotation()`
+// turns the framebuffer instead: the app draws upright in the rotated
+// coordinates, and the flush turns each rectangle into the panel's
+// orientation as it copies it to the transfer buffer. The copy goes through
+// `libtock_blit_rotate_rect()`, so a rotated flush costs about as much as an
+// unrotated one of a rectangle narrower than the screen.
+
+// Number of dirty rectangles tracked. When a new rectangle does not fit, the
+// two rectangles whose union adds the fewest pixels are merged.
+#ifndef LIBTOCK_FRAMEBUFFER_RECTS
+#define LIBTOCK_FRAMEBUFFER_RECTS 8
+#endif
+
+typedef struct {
+  uint16_t x;
+  uint16_t y;
+  uint16_t width;
+  uint16_t height;
+} libtock_framebuffer_rect_t;
+
+typedef struct {
+  uint8_t* pixels;
+  uint16_t width;
+  uint16_t height;
+  uint8_t bytes_per_pixel;
+  libtock_screen_rotation_t rotation;
+  uint8_t* transfer;
+  size_t transfer_len;
+  libtock_framebuffer_rect_t dirty[LIBTOCK_FRAMEBUFFER_RECTS];
+  int dirty_count;
+} libtock_framebuffer_t;
+
+// Function signature for the flush callback.
+//
+// - `arg1` (`returncode_t`): Whether every rectangle was written.
+typedef void (*libtock_framebuffer_callback)(returncode_t);
+
+// Set up `fb` for a `width` by `height` screen in `format`. `pixels` holds
+// `width * height` pixels. `transfer` must hold at least one row of the
+// screen, and would usually come from `libtock_screen_buffer_init()`. The
+// whole screen starts out dirty.
+//
+// Returns RETURNCODE_ENOSUPPORT for formats with less than one byte per
+// pixel, and RETURNCODE_ESIZE if `transfer` is shorter than a row.
+returncode_t libtock_framebuffer_init(libtock_framebuffer_t* fb, uint8_t* pixels, uint16_t width, uint16_t height,
+                                      libtock_screen_format_t format, uint8_t* transfer, size_t transfer_len);
+
+// Draw in coordinates turned clockwise by `rotation` from the panel's. For
+// `ROTATION_90` and `ROTATION_270` the framebuffer's width and height are
+// the panel's height and width. The pixels keep their bytes, so the app
+// redraws after a change; the whole screen is marked dirty.
+//
+// This is independent of `libtock_screen_set_rotation()`, and meant for
+// panels that do not support it.
+void libtock_framebuffer_set_rotation(libtock_framebuffer_t* fb, libtock_screen_rotation_t rotation);
+
+// Mark a rectangle as changed, for example after drawing into `pixels`
+// directly. The rectangle is clipped to the screen.
+void libtock_framebuffer_mark(libtock_framebuffer_t* fb, int x, int y, int width, int height);
+
+// Set one pixel.
+void libtock_framebuffer_set_pixel(libtock_framebuffer_t* fb, int x, int y, uint32_t color);
+
+// Fill a rectangle with `color`.
+void libtock_framebuffer_fill_rect(libtock_framebuffer_t* fb, int x, int y, int width, int height, uint32_t color);
+
+// Copy a `width` by `height` block of pixels, in the screen's format, to
+// `x`,`y`. Parts outside the screen are skipped.
+void libtock_framebuffer_blit(libtock_framebuffer_t* fb, int x, int y, int width, int height, const uint8_t* src);
+
+// Write the dirty rectangles to the screen and mark the framebuffer clean.
+// Drawing may continue during the flush, and what it marks is left for the
+// next flush.
+//
+// Returns RETURNCODE_EALREADY if nothing is dirty, in which case there is no
+// callback, and RETURNCODE_EBUSY if a flush is already running.
+returncode_t libtock_framebuffer_flush(libtock_framebuffer_t* fb, libtock_framebuffer_callback cb);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,145 @@
+#include <string.h>
+
+#include "framebuffer_text.h"
+
+// 5x7 font for ' ' to '~'. Each glyph is five columns, least significant bit
+// at the top.
+static const uint8_t font[95][5] = {
+  {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+  {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+  {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00},
+  {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x08, 0x2A, 0x1C, 0x2A, 0x08}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+  {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00},
+  {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+  {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31}, {0x18, 0x14, 0x12, 0x7F, 0x10},
+  {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+  {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00},
+  {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14},
+  {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3E},
+  {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+  {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x01, 0x01},
+  {0x3E, 0x41, 0x41, 0x51, 0x32}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+  {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40},
+  {0x7F, 0x02, 0x04, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+  {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46},
+  {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+  {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x7F, 0x20, 0x18, 0x20, 0x7F}, {0x63, 0x14, 0x08, 0x14, 0x63},
+  {0x03, 0x04, 0x78, 0x04, 0x03}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00},
+  {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04},
+  {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78},
+  {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7F},
+  {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x08, 0x14, 0x54, 0x54, 0x3C},
+  {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00},
+  {0x00, 0x7F, 0x10, 0x28, 0x44}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78},
+  {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7C, 0x14, 0x14, 0x14, 0x08},
+  {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+  {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C},
+  {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C},
+  {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7F, 0x00, 0x00},
+  {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x04, 0x08, 0x10, 0x08},
+};
+
+static void put_color(uint8_t* p, uint8_t bytes, uint32_t color) {
+  for (int i = bytes - 1; i >= 0; i--) {
+    p[i]    = color & 0xFF;
+    color >>= 8;
+  }
+}
+
+returncode_t libtock_framebuffer_text_init(libtock_framebuffer_text_t* text, libtock_framebuffer_t* fb,
+                                           uint8_t scale, uint8_t* cache, size_t cache_len) {
+  if (scale == 0) return RETURNCODE_EINVAL;
+
+  size_t glyph_bytes = (size_t) LIBTOCK_FRAMEBUFFER_TEXT_WIDTH * LIBTOCK_FRAMEBUFFER_TEXT_HEIGHT * scale * scale *
+                       fb->bytes_per_pixel;
+  size_t slots = cache_len / glyph_bytes;
+  if (slots == 0) return RETURNCODE_ESIZE;
+  if (slots > LIBTOCK_FRAMEBUFFER_TEXT_SLOTS) slots = LIBTOCK_FRAMEBUFFER_TEXT_SLOTS;
+
+  text->fb          = fb;
+  text->scale       = scale;
+  text->cache       = cache;
+  text->glyph_bytes = glyph_bytes;
+  text->slots       = slots;
+  text->clock       = 0;
+  text->fg          = 0xFFFFFFFF;
+  text->bg          = 0;
+  memset(text->glyph, 0, sizeof(text->glyph));
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_framebuffer_text_set_colors(libtock_framebuffer_text_t* text, uint32_t fg, uint32_t bg) {
+  if (fg == text->fg && bg == text->bg) return;
+
+  text->fg = fg;
+  text->bg = bg;
+  memset(text->glyph, 0, sizeof(text->glyph));
+}
+
+// Render `c` in the current colors into `dst`.
+static void render(libtock_framebuffer_text_t* text, char c, uint8_t* dst) {
+  uint8_t bpp            = text->fb->bytes_per_pixel;
+  uint8_t scale          = text->scale;
+  size_t stride          = (size_t) LIBTOCK_FRAMEBUFFER_TEXT_WIDTH * scale * bpp;
+  const uint8_t* columns = font[c - ' '];
+
+  for (int row = 0; row < LIBTOCK_FRAMEBUFFER_TEXT_HEIGHT; row++) {
+    // Render one scaled row, then repeat it for the scale.
+    uint8_t* line = dst + row * scale * stride;
+    uint8_t* p    = line;
+    for (int col = 0; col < LIBTOCK_FRAMEBUFFER_TEXT_WIDTH; col++) {
+      bool set = col < 5 && (columns[col] & (1 << row));
+      for (int s = 0; s < scale; s++, p += bpp) {
+        put_color(p, bpp, set ? text->fg : text->bg);
+      }
+    }
+    for (int s = 1; s < scale; s++) {
+      memcpy(line + s * stride, line, stride);
+    }
+  }
+}
+
+// The cached rendering of `c`, rendering it first if needed.
+static const uint8_t* lookup(libtock_framebuffer_text_t* text, char c) {
+  text->clock++;
+
+  int victim = 0;
+  for (int i = 0; i < text->slots; i++) {
+    if (text->glyph[i] == c) {
+      text->used[i] = text->clock;
+      return text->cache + i * text->glyph_bytes;
+    }
+    // Prefer an empty slot, otherwise the least recently used.
+    if (text->glyph[victim] != 0 && (text->glyph[i] == 0 || text->used[i] < text->used[victim])) victim = i;
+  }
+
+  uint8_t* slot = text->cache + victim * text->glyph_bytes;
+  render(text, c, slot);
+  text->glyph[victim] = c;
+  text->used[victim]  = text->clock;
+  return slot;
+}
+
+static int draw(libtock_framebuffer_text_t* text, int x, int y, const char* str, int cells) {
+  int width  = LIBTOCK_FRAMEBUFFER_TEXT_WIDTH * text->scale;
+  int height = LIBTOCK_FRAMEBUFFER_TEXT_HEIGHT * text->scale;
+  for (int i = 0; str[i] != '\0' && (cells < 0 || i < cells); i++, x += width) {
+    char c = str[i] >= ' ' && str[i] <= '~' ? str[i] : '?';
+    libtock_framebuffer_blit(text->fb, x, y, width, height, lookup(text, c));
+  }
+  return x;
+}
+
+int libtock_framebuffer_text_draw(libtock_framebuffer_text_t* text, int x, int y, const char* str) {
+  return draw(text, x, y, str, -1);
+}
+
+void libtock_framebuffer_text_draw_field(libtock_framebuffer_text_t* text, int x, int y, int cells,
+                                         const char* str) {
+  int end   = x + cells * LIBTOCK_FRAMEBUFFER_TEXT_WIDTH * text->scale;
+  int after = draw(text, x, y, str, cells);
+  if (after < end) {
+    libtock_framebuffer_fill_rect(text->fb, after, y, end - after, LIBTOCK_FRAMEBUFFER_TEXT_HEIGHT * text->scale,
+                                  text->bg);
+  }
+}
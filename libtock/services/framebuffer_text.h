@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../tock.h"
+#include "framebuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Text drawing into a framebuffer with a glyph cache.
+//
+// Text is drawn in a built-in 5x7 font for printable ASCII, in cells of
+// `LIBTOCK_FRAMEBUFFER_TEXT_WIDTH` by `LIBTOCK_FRAMEBUFFER_TEXT_HEIGHT` pixels
+// times the scale. Each glyph is rendered once into a cache in the
+// framebuffer's pixel format and then copied into the framebuffer one row at
+// a time, so redrawing a status line costs a few row copies per character
+// rather than a bit test per pixel.
+//
+// The cache lives in a buffer supplied by the app. It holds as many glyphs as
+// fit, up to `LIBTOCK_FRAMEBUFFER_TEXT_SLOTS`, and replaces the least
+// recently used one when full. Changing the colors empties it.
+
+#define LIBTOCK_FRAMEBUFFER_TEXT_WIDTH 6
+#define LIBTOCK_FRAMEBUFFER_TEXT_HEIGHT 8
+
+#ifndef LIBTOCK_FRAMEBUFFER_TEXT_SLOTS
+#define LIBTOCK_FRAMEBUFFER_TEXT_SLOTS 64
+#endif
+
+typedef struct {
+  libtock_framebuffer_t* fb;
+  uint8_t scale;
+  uint32_t fg;
+  uint32_t bg;
+  uint8_t* cache;
+  size_t glyph_bytes;
+  int slots;
+  // Character in each slot, 0 if empty, and when it was last used.
+  char glyph[LIBTOCK_FRAMEBUFFER_TEXT_SLOTS];
+  uint32_t used[LIBTOCK_FRAMEBUFFER_TEXT_SLOTS];
+  uint32_t clock;
+} libtock_framebuffer_text_t;
+
+// Set up `text` to draw into `fb` at `scale` times the font size, white on
+// black, with glyphs cached in `cache`. One glyph takes
+// `6 * 8 * scale * scale` pixels of cache.
+//
+// Returns RETURNCODE_ESIZE if `cache` cannot hold a single glyph.
+returncode_t libtock_framebuffer_text_init(libtock_framebuffer_text_t* text, libtock_framebuffer_t* fb,
+                                           uint8_t scale, uint8_t* cache, size_t cache_len);
+
+// Set the text and background colors, in the framebuffer's format.
+void libtock_framebuffer_text_set_colors(libtock_framebuffer_text_t* text, uint32_t fg, uint32_t bg);
+
+// Draw `str` with its top left corner at `x`,`y`. Characters outside
+// printable ASCII are drawn as `?`. Returns the x coordinate after the text.
+int libtock_framebuffer_text_draw(libtock_framebuffer_text_t* text, int x, int y, const char* str);
+
+// Draw `str` in a field of `cells` characters, clearing the rest of the field
+// to the background color and cutting off text that does not fit. This
+// overwrites whatever the field showed before, as for a status line.
+void libtock_framebuffer_text_draw_field(libtock_framebuffer_text_t* text, int x, int y, int cells,
+                                         const char* str);
+
+#ifdef __cplusplus
+}
+#endif
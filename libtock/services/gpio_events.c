@@ -0,0 +1,70 @@
+#include "gpio_events.h"
+#include "time.h"
+
+// The GPIO interrupt callback has no context.
+static libtock_gpio_events_t* active = NULL;
+
+static void gpio_event(uint32_t pin, bool level) {
+  libtock_gpio_events_t* queue = active;
+  if (queue == NULL) return;
+
+  uint64_t ticks = libtock_time_now_ticks64();
+  if (pin < 32) {
+    uint32_t bit = 1u << pin;
+    if ((queue->seen & bit) && ((queue->levels & bit) != 0) == level) queue->missed++;
+    queue->seen  |= bit;
+    queue->levels = level ? queue->levels | bit : queue->levels & ~bit;
+  }
+
+  // Fill the record in place rather than building and copying it.
+  uint32_t space;
+  libtock_gpio_event_t* event = libtock_ringbuf_write_span(&queue->ring, &space);
+  if (event == NULL) {
+    queue->dropped++;
+    return;
+  }
+  event->ticks = ticks;
+  event->pin   = pin;
+  event->level = level;
+  libtock_ringbuf_commit(&queue->ring, 1);
+
+  if (queue->cb) queue->cb();
+}
+
+returncode_t libtock_gpio_events_start(libtock_gpio_events_t* queue, libtock_gpio_event_t* events,
+                                       uint32_t capacity, libtock_gpio_events_callback cb) {
+  returncode_t ret = libtock_ringbuf_init_records(&queue->ring, events, sizeof(libtock_gpio_event_t), capacity);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  queue->dropped = 0;
+  queue->missed  = 0;
+  queue->levels  = 0;
+  queue->seen    = 0;
+  queue->cb      = cb;
+
+  active = queue;
+  ret    = libtock_gpio_set_interrupt_callback(gpio_event);
+  if (ret != RETURNCODE_SUCCESS) active = NULL;
+  return ret;
+}
+
+returncode_t libtock_gpio_events_stop(libtock_gpio_events_t* queue) {
+  if (active == queue) active = NULL;
+  return RETURNCODE_SUCCESS;
+}
+
+bool libtock_gpio_events_pop(libtock_gpio_events_t* queue, libtock_gpio_event_t* event) {
+  return libtock_ringbuf_pop(&queue->ring, event);
+}
+
+uint32_t libtock_gpio_events_count(const libtock_gpio_events_t* queue) {
+  return libtock_ringbuf_used(&queue->ring);
+}
+
+uint32_t libtock_gpio_events_dropped(const libtock_gpio_events_t* queue) {
+  return queue->dropped;
+}
+
+uint32_t libtock_gpio_events_missed(const libtock_gpio_events_t* queue) {
+  return queue->missed;
+}
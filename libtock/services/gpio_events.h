@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../peripherals/gpio.h"
+#include "../tock.h"
+#include "ringbuf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Queue of timestamped GPIO interrupt events.
+//
+// A GPIO interrupt callback that processes each edge as it comes loses
+// edges whenever the app is busy, because the kernel keeps only one pending
+// upcall per driver. The queue takes over the GPIO interrupt callback and
+// records every upcall with the pin, the level and the time from
+// `libtock_time_now_ticks64()`. The app drains the queue at leisure to
+// decode pulse trains or measure periods.
+//
+// Timestamps are taken when the upcall reaches the app, so they include its
+// delivery latency. With `libtock_change` interrupts two events in a row with
+// the same level mean edges were lost before the upcall was delivered; these
+// are counted by `libtock_gpio_events_missed()`. The count is meaningless for
+// rising or falling edge interrupts.
+//
+// Only one queue can be active, as the interrupt callback is shared by all
+// pins. Interrupts are enabled on each pin with
+// `libtock_gpio_enable_interrupt()` as usual.
+
+typedef struct {
+  uint64_t ticks;
+  uint32_t pin;
+  bool level;
+} libtock_gpio_event_t;
+
+// Function signature for the event callback, called during a yield after an
+// event was queued.
+typedef void (*libtock_gpio_events_callback)(void);
+
+typedef struct {
+  libtock_ringbuf_t ring;
+  uint32_t dropped;
+  uint32_t missed;
+  // Last level of pins 0 to 31, for the bits in `seen`.
+  uint32_t levels;
+  uint32_t seen;
+  libtock_gpio_events_callback cb;
+} libtock_gpio_events_t;
+
+// Start queueing interrupts into `events`, which holds `capacity` events.
+// `cb` may be NULL.
+//
+// Returns RETURNCODE_EINVAL if `capacity` is not a power of two.
+returncode_t libtock_gpio_events_start(libtock_gpio_events_t* queue, libtock_gpio_event_t* events,
+                                       uint32_t capacity, libtock_gpio_events_callback cb);
+
+// Stop queueing. Queued events can still be taken.
+returncode_t libtock_gpio_events_stop(libtock_gpio_events_t* queue);
+
+// Take the oldest event. Returns false if the queue is empty.
+bool libtock_gpio_events_pop(libtock_gpio_events_t* queue, libtock_gpio_event_t* event);
+
+// Number of events waiting.
+uint32_t libtock_gpio_events_count(const libtock_gpio_events_t* queue);
+
+// Number of events dropped because the queue was full.
+uint32_t libtock_gpio_events_dropped(const libtock_gpio_events_t* queue);
+
+// Number of events showing that edges were lost before they reached the app.
+uint32_t libtock_gpio_events_missed(const libtock_gpio_events_t* queue);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,168 @@
+#include "../peripherals/syscalls/alarm_syscalls.h"
+#include "alarm.h"
+#include "gpio_sequence.h"
+
+#define NS_PER_S 1000000000ull
+
+// Low level long enough for every WS2812 revision to latch its colour.
+#define WS2812_LATCH_NS 300000
+
+#define ONEWIRE_RESET_NS 480000
+#define ONEWIRE_PRESENCE_NS 480000
+
+const libtock_gpio_bit_timing_t libtock_gpio_timing_ws2812 = {
+  .zero_ns    = { 400, 850 },
+  .one_ns     = { 800, 450 },
+  .start_high = true,
+  .lsb_first  = false,
+};
+
+const libtock_gpio_bit_timing_t libtock_gpio_timing_onewire = {
+  .zero_ns    = { 60000, 10000 },
+  .one_ns     = { 6000, 64000 },
+  .start_high = false,
+  .lsb_first  = true,
+};
+
+void libtock_gpio_sequence_init(libtock_gpio_sequence_t* seq, libtock_gpio_step_t* steps, uint32_t capacity) {
+  seq->steps    = steps;
+  seq->capacity = capacity;
+  seq->count    = 0;
+}
+
+returncode_t libtock_gpio_sequence_add(libtock_gpio_sequence_t* seq, uint16_t mask, uint16_t level,
+                                       uint32_t delay_ns) {
+  level &= mask;
+  if (seq->count > 0) {
+    libtock_gpio_step_t* last = &seq->steps[seq->count - 1];
+    if (last->mask == mask && last->level == level && last->delay_ns <= UINT32_MAX - delay_ns) {
+      last->delay_ns += delay_ns;
+      return RETURNCODE_SUCCESS;
+    }
+  }
+  if (seq->count == seq->capacity) return RETURNCODE_ENOMEM;
+
+  seq->steps[seq->count].mask     = mask;
+  seq->steps[seq->count].level    = level;
+  seq->steps[seq->count].delay_ns = delay_ns;
+  seq->count++;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_gpio_sequence_add_bits(libtock_gpio_sequence_t* seq, uint16_t mask,
+                                            const libtock_gpio_bit_timing_t* timing,
+                                            const uint8_t* data, uint32_t bits) {
+  uint32_t start = seq->count;
+  uint16_t first = timing->start_high ? mask : 0;
+
+  for (uint32_t i = 0; i < bits; i++) {
+    uint8_t shift     = timing->lsb_first ? i % 8 : 7 - i % 8;
+    bool one          = (data[i / 8] >> shift) & 1;
+    const uint32_t* t = one ? timing->one_ns : timing->zero_ns;
+
+    returncode_t ret = libtock_gpio_sequence_add(seq, mask, first, t[0]);
+    if (ret == RETURNCODE_SUCCESS) ret = libtock_gpio_sequence_add(seq, mask, (uint16_t) ~first, t[1]);
+    if (ret != RETURNCODE_SUCCESS) {
+      seq->count = start;
+      return ret;
+    }
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_gpio_sequence_add_ws2812(libtock_gpio_sequence_t* seq, uint16_t mask, const uint8_t* grb,
+                                              uint32_t leds) {
+  uint32_t start   = seq->count;
+  returncode_t ret = libtock_gpio_sequence_add_bits(seq, mask, &libtock_gpio_timing_ws2812, grb, leds * 24);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_gpio_sequence_add(seq, mask, 0, WS2812_LATCH_NS);
+  if (ret != RETURNCODE_SUCCESS) seq->count = start;
+  return ret;
+}
+
+returncode_t libtock_gpio_sequence_add_onewire_reset(libtock_gpio_sequence_t* seq, uint16_t mask) {
+  uint32_t start   = seq->count;
+  returncode_t ret = libtock_gpio_sequence_add(seq, mask, 0, ONEWIRE_RESET_NS);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_gpio_sequence_add(seq, mask, mask, ONEWIRE_PRESENCE_NS);
+  if (ret != RETURNCODE_SUCCESS) seq->count = start;
+  return ret;
+}
+
+returncode_t libtock_gpio_sequence_add_onewire_write(libtock_gpio_sequence_t* seq, uint16_t mask,
+                                                     const uint8_t* data, uint32_t len) {
+  return libtock_gpio_sequence_add_bits(seq, mask, &libtock_gpio_timing_onewire, data, len * 8);
+}
+
+uint64_t libtock_gpio_sequence_duration_ns(const libtock_gpio_sequence_t* seq) {
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < seq->count; i++) {
+    total += seq->steps[i].delay_ns;
+  }
+  return total;
+}
+
+// Bit of the SPI stream nearest to `ns` into the sequence.
+static uint64_t spi_bit(uint64_t ns, uint32_t rate) {
+  return (ns * rate + NS_PER_S / 2) / NS_PER_S;
+}
+
+// Set bits `from` up to `to` of the stream to `high`.
+static void spi_fill(uint8_t* out, uint64_t from, uint64_t to, bool high) {
+  for (uint64_t bit = from; bit < to; bit++) {
+    uint8_t b = (uint8_t) (0x80 >> (bit % 8));
+    if (high) {
+      out[bit / 8] |= b;
+    } else {
+      out[bit / 8] &= (uint8_t) ~b;
+    }
+  }
+}
+
+returncode_t libtock_gpio_sequence_render_spi(const libtock_gpio_sequence_t* seq, uint16_t pin_mask, uint32_t rate,
+                                              uint8_t* out, uint32_t out_len, uint32_t* used) {
+  if (pin_mask == 0 || (pin_mask & (pin_mask - 1)) != 0 || rate == 0) return RETURNCODE_EINVAL;
+
+  uint64_t bits = spi_bit(libtock_gpio_sequence_duration_ns(seq), rate);
+  *used = (uint32_t) ((bits + 7) / 8);
+  if (*used > out_len) return RETURNCODE_ENOMEM;
+
+  bool high    = false;
+  uint64_t at  = 0;
+  uint64_t bit = 0;
+  for (uint32_t i = 0; i < seq->count; i++) {
+    const libtock_gpio_step_t* step = &seq->steps[i];
+    if (step->mask & pin_mask) high = (step->level & pin_mask) != 0;
+    at += step->delay_ns;
+
+    uint64_t end = spi_bit(at, rate);
+    spi_fill(out, bit, end, high);
+    bit = end;
+  }
+  spi_fill(out, bit, (uint64_t) *used * 8, high);
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_gpio_sequence_play_port(libtock_gpio_port_t* port, const libtock_gpio_sequence_t* seq) {
+  uint32_t frequency;
+  returncode_t ret = libtock_alarm_get_frequency(&frequency);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  uint32_t start;
+  ret = libtock_alarm_command_read(&start);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  uint64_t at = 0;
+  for (uint32_t i = 0; i < seq->count; i++) {
+    const libtock_gpio_step_t* step = &seq->steps[i];
+    ret = libtock_gpio_write_mask(port, step->mask, step->level);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+
+    at += step->delay_ns;
+    uint32_t deadline = start + (uint32_t) (at * frequency / NS_PER_S);
+    uint32_t now;
+    do {
+      ret = libtock_alarm_command_read(&now);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+    } while ((int32_t) (now - deadline) < 0);
+  }
+  return RETURNCODE_SUCCESS;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../peripherals/gpio.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Timed GPIO waveforms for bit-banged protocols.
+//
+// A sequence is a list of steps, each driving some pins of a GPIO port to a
+// level and holding it for a time. The encoders below build the steps for
+// common protocols: NRZ bit streams in general, WS2812 LEDs and 1-Wire
+// writes.
+//
+// The kernel has no driver that plays a list of steps, so there are two ways
+// to play a sequence:
+//
+// - `libtock_gpio_sequence_render_spi()` turns the steps of one pin into a
+//   bit stream for the SPI controller, which clocks it out on MOSI at a fixed
+//   bit rate. Every edge is then placed by the hardware to within one bit
+//   period, with a single transfer for the whole sequence. This is the way to
+//   drive devices with sub-microsecond timing such as WS2812 LEDs: wire their
+//   data input to MOSI.
+// - `libtock_gpio_sequence_play_port()` drives the pins of a
+//   `libtock_gpio_port_t` with one GPIO command per changed pin and times
+//   the steps by spinning on the alarm counter. Steps last at least a few
+//   syscalls and are rounded to alarm ticks, and the kernel may run something
+//   else in between, so this suits slow protocols and several pins at once.
+//
+// Each step costs `sizeof(libtock_gpio_step_t)` bytes and encoders add two
+// per bit, so long streams are best encoded and rendered in pieces.
+
+typedef struct {
+  // Pins of the port the step drives, and their levels.
+  uint16_t mask;
+  uint16_t level;
+  // Time until the next step.
+  uint32_t delay_ns;
+} libtock_gpio_step_t;
+
+typedef struct {
+  libtock_gpio_step_t* steps;
+  uint32_t capacity;
+  uint32_t count;
+} libtock_gpio_sequence_t;
+
+// Timing of one bit of an NRZ stream: the pin is held at the start level and
+// then at the other level, for times that depend on the bit.
+typedef struct {
+  uint32_t zero_ns[2];
+  uint32_t one_ns[2];
+  bool start_high;
+  bool lsb_first;
+} libtock_gpio_bit_timing_t;
+
+// WS2812 (NeoPixel) bits, most significant bit first.
+extern const libtock_gpio_bit_timing_t libtock_gpio_timing_ws2812;
+// 1-Wire write slots at standard speed, least significant bit first.
+extern const libtock_gpio_bit_timing_t libtock_gpio_timing_onewire;
+
+// Start an empty sequence in `steps`, which holds `capacity` steps.
+void libtock_gpio_sequence_init(libtock_gpio_sequence_t* seq, libtock_gpio_step_t* steps, uint32_t capacity);
+
+// Drive the pins in `mask` to their bits of `level` and hold for `delay_ns`.
+// A step that drives the same pins to the same levels as the last one only
+// makes the last one longer.
+//
+// Returns RETURNCODE_ENOMEM if the sequence is full.
+returncode_t libtock_gpio_sequence_add(libtock_gpio_sequence_t* seq, uint16_t mask, uint16_t level,
+                                       uint32_t delay_ns);
+
+// Encode the first `bits` bits of `data` on the pins in `mask` with
+// `timing`.
+//
+// Returns RETURNCODE_ENOMEM, and adds nothing, if the steps do not fit.
+returncode_t libtock_gpio_sequence_add_bits(libtock_gpio_sequence_t* seq, uint16_t mask,
+                                            const libtock_gpio_bit_timing_t* timing,
+                                            const uint8_t* data, uint32_t bits);
+
+// Send `leds` colours of three bytes each, in the green, red, blue order the
+// LEDs take, followed by the low time that latches them.
+returncode_t libtock_gpio_sequence_add_ws2812(libtock_gpio_sequence_t* seq, uint16_t mask, const uint8_t* grb,
+                                              uint32_t leds);
+
+// A 1-Wire reset pulse and the time devices answer in. Sequences only drive
+// pins, so the presence pulse is not read.
+returncode_t libtock_gpio_sequence_add_onewire_reset(libtock_gpio_sequence_t* seq, uint16_t mask);
+
+// Write `len` bytes on a 1-Wire bus. Releasing the bus drives it high, so
+// the pin must not fight a device that holds it low.
+returncode_t libtock_gpio_sequence_add_onewire_write(libtock_gpio_sequence_t* seq, uint16_t mask,
+                                                     const uint8_t* data, uint32_t len);
+
+// Total time of the sequence.
+uint64_t libtock_gpio_sequence_duration_ns(const libtock_gpio_sequence_t* seq);
+
+// Render the levels of the pin with bit `pin_mask` in the step masks into
+// SPI bytes, most significant bit first, for a clock of `rate` Hz. Each step
+// ends on the bit nearest its end time, so rounding does not add up over the
+// sequence. The pin is low until the first step that drives it, and the
+// last byte is padded with the final level. `*used` is set to the number of
+// bytes the sequence needs.
+//
+// Returns RETURNCODE_EINVAL if `pin_mask` is not a single bit or `rate` is
+// 0, and RETURNCODE_ENOMEM if `out_len` is below `*used`.
+returncode_t libtock_gpio_sequence_render_spi(const libtock_gpio_sequence_t* seq, uint16_t pin_mask, uint32_t rate,
+                                              uint8_t* out, uint32_t out_len, uint32_t* used);
+
+// Play the sequence on the pins of `port`, which must already be outputs.
+// Steps are timed from the start of the sequence, so the time a step runs
+// late is made up in the ones after it.
+returncode_t libtock_gpio_sequence_play_port(libtock_gpio_port_t* port, const libtock_gpio_sequence_t* seq);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,93 @@
+#include "i2c_poller.h"
+
+// The bus is shared, so the queue of due devices is global.
+static struct {
+  libtock_i2c_poll_device_t* head;
+  libtock_i2c_poll_device_t* tail;
+  // Device whose operations are on the bus, NULL while it is idle.
+  libtock_i2c_poll_device_t* current;
+  i2c_master_reg_batch_t batch;
+} poller;
+
+static void batch_done(returncode_t ret, size_t completed, void* opaque);
+
+// Start the next due device, if the bus is idle.
+static void poll_next(void) {
+  while (poller.current == NULL && poller.head != NULL) {
+    libtock_i2c_poll_device_t* device = poller.head;
+    poller.head = device->next;
+    if (poller.head == NULL) poller.tail = NULL;
+    device->due = false;
+
+    poller.current = device;
+    returncode_t ret = i2c_master_reg_batch(&poller.batch, device->address, device->ops, device->count,
+                                            batch_done, device);
+    if (ret != RETURNCODE_SUCCESS) {
+      poller.current = NULL;
+      device->cb(ret, device->opaque);
+    }
+  }
+}
+
+static void batch_done(returncode_t ret, __attribute__ ((unused)) size_t completed, void* opaque) {
+  libtock_i2c_poll_device_t* device = (libtock_i2c_poll_device_t*) opaque;
+  poller.current = NULL;
+  if (device->active) device->cb(ret, device->opaque);
+  poll_next();
+}
+
+static void device_due(__attribute__ ((unused)) uint32_t now,
+                       __attribute__ ((unused)) uint32_t scheduled,
+                       void*                             opaque) {
+  libtock_i2c_poll_device_t* device = (libtock_i2c_poll_device_t*) opaque;
+  if (device->due) return;
+
+  device->due  = true;
+  device->next = NULL;
+  if (poller.tail != NULL) {
+    poller.tail->next = device;
+  } else {
+    poller.head = device;
+  }
+  poller.tail = device;
+
+  // Other devices due in this wakeup are queued by their own timers before
+  // the first transfer completes.
+  poll_next();
+}
+
+returncode_t libtock_i2c_poller_add(libtock_i2c_poll_device_t* device, uint8_t address,
+                                    const i2c_master_reg_op_t* ops, size_t count,
+                                    uint32_t period_ms, uint32_t slack_ms,
+                                    libtock_i2c_poller_callback cb, void* opaque) {
+  if (count == 0 || period_ms == 0) return RETURNCODE_EINVAL;
+
+  device->address = address;
+  device->ops     = ops;
+  device->count   = count;
+  device->cb      = cb;
+  device->opaque  = opaque;
+  device->due     = false;
+  device->active  = true;
+
+  libtock_alarm_repeating_every_ms_with_slack(period_ms, slack_ms, device_due, device, &device->alarm);
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_i2c_poller_remove(libtock_i2c_poll_device_t* device) {
+  if (!device->active) return;
+  device->active = false;
+  libtock_alarm_ms_cancel(&device->alarm);
+
+  if (!device->due) return;
+  device->due = false;
+
+  libtock_i2c_poll_device_t** link = &poller.head;
+  libtock_i2c_poll_device_t* prev  = NULL;
+  while (*link != device) {
+    prev = *link;
+    link = &(*link)->next;
+  }
+  *link = device->next;
+  if (poller.tail == device) poller.tail = prev;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "../peripherals/i2c_master.h"
+#include "../tock.h"
+#include "alarm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Periodic polling of several I2C devices that share the bus.
+//
+// Each device has a period and a list of register operations, usually the
+// reads of its measurement registers. Device timers are set with slack, so
+// devices with nearby deadlines wake the app once, and the devices that are
+// due are then polled one after another from the transfer upcalls. The app
+// gets one callback per device once its reads have completed, and devices
+// never contend for the bus.
+//
+// A device whose previous poll is still waiting for the bus when its timer
+// fires again is polled once, not twice.
+
+// Function signature for poll callbacks.
+//
+// - `arg1` (`returncode_t`): Status of the register operations.
+// - `arg2` (`void*`): The opaque pointer passed to
+//   `libtock_i2c_poller_add()`.
+typedef void (*libtock_i2c_poller_callback)(returncode_t, void*);
+
+typedef struct libtock_i2c_poll_device {
+  uint8_t address;
+  const i2c_master_reg_op_t* ops;
+  size_t count;
+  libtock_i2c_poller_callback cb;
+  void* opaque;
+  bool active;
+  bool due;
+  libtock_alarm_t alarm;
+  struct libtock_i2c_poll_device* next;
+} libtock_i2c_poll_device_t;
+
+// Poll the device at `address` every `period_ms`, up to `slack_ms` late, by
+// running `ops` and then calling `cb`. `device` and `ops` must stay valid
+// until the device is removed.
+//
+// Returns RETURNCODE_EINVAL if `count` or `period_ms` is 0.
+returncode_t libtock_i2c_poller_add(libtock_i2c_poll_device_t* device, uint8_t address,
+                                    const i2c_master_reg_op_t* ops, size_t count,
+                                    uint32_t period_ms, uint32_t slack_ms,
+                                    libtock_i2c_poller_callback cb, void* opaque);
+
+// Stop polling `device`. If it is being polled right now, the transfer
+// finishes but no callback follows.
+void libtock_i2c_poller_remove(libtock_i2c_poll_device_t* device);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,74 @@
+#include "ieee802154_tx_queue.h"
+
+// The transmit callbacks carry no context, so the queue is global.
+static struct {
+  libtock_ieee802154_tx_frame_t** slots;
+  int capacity;
+  int head;
+  int count;
+  libtock_ieee802154_tx_queue_callback cb;
+} queue;
+
+static void send_done(statuscode_t status, bool acked);
+
+static returncode_t send(libtock_ieee802154_tx_frame_t* frame) {
+  if (frame->raw) return libtock_ieee802154_send_raw(frame->payload, frame->len, send_done);
+  return libtock_ieee802154_send(frame->addr, frame->level, frame->key_id_mode, frame->key_id,
+                                 frame->payload, frame->len, send_done);
+}
+
+static libtock_ieee802154_tx_frame_t* pop(void) {
+  libtock_ieee802154_tx_frame_t* frame = queue.slots[queue.head];
+  queue.head = (queue.head + 1) % queue.capacity;
+  queue.count--;
+  return frame;
+}
+
+static void send_done(statuscode_t status, bool acked) {
+  if (queue.count == 0) return;
+
+  libtock_ieee802154_tx_frame_t* done = pop();
+  done->result = tock_status_to_returncode(status);
+  done->acked  = acked;
+
+  // Start the next frame before the app sees this one. Frames that cannot
+  // be sent finish right away with their error, in order.
+  while (queue.count > 0) {
+    returncode_t ret = send(queue.slots[queue.head]);
+    if (ret == RETURNCODE_SUCCESS) break;
+
+    if (queue.cb) queue.cb(done);
+    done         = pop();
+    done->result = ret;
+    done->acked  = false;
+  }
+  if (queue.cb) queue.cb(done);
+}
+
+returncode_t libtock_ieee802154_tx_queue_init(libtock_ieee802154_tx_frame_t** slots, int capacity,
+                                              libtock_ieee802154_tx_queue_callback cb) {
+  if (queue.count > 0) return RETURNCODE_EBUSY;
+  if (slots == NULL || capacity <= 0) return RETURNCODE_EINVAL;
+
+  queue.slots    = slots;
+  queue.capacity = capacity;
+  queue.head     = 0;
+  queue.cb       = cb;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_ieee802154_tx_queue_push(libtock_ieee802154_tx_frame_t* frame) {
+  if (queue.count == queue.capacity) return RETURNCODE_ENOMEM;
+
+  if (queue.count == 0) {
+    returncode_t ret = send(frame);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+  }
+  queue.slots[(queue.head + queue.count) % queue.capacity] = frame;
+  queue.count++;
+  return RETURNCODE_SUCCESS;
+}
+
+int libtock_ieee802154_tx_queue_pending(void) {
+  return queue.count;
+}
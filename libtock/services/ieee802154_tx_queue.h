@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../net/ieee802154.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Queued 802.15.4 transmission.
+//
+// The driver sends one frame at a time, and an app that builds each frame
+// after the previous one is done leaves the radio idle in between. The queue
+// takes several frames up front. When a frame is done the next one is handed
+// to the kernel first, which copies it, and only then is the app called back
+// with the result of the frame that finished, so the radio is busy again
+// while the app handles it and builds more frames.
+//
+// The queue replaces the transmit callback of the driver while it has frames,
+// so the app should not call `libtock_ieee802154_send()` itself meanwhile.
+
+typedef struct {
+  // Frame to send. With `raw` set, the payload is a complete frame passed to
+  // `libtock_ieee802154_send_raw()`, and the addressing and security fields
+  // are unused.
+  const uint8_t* payload;
+  uint8_t len;
+  bool raw;
+  uint16_t addr;
+  security_level_t level;
+  key_id_mode_t key_id_mode;
+  uint8_t* key_id;
+  // Result, set before the frame is passed to the callback.
+  returncode_t result;
+  bool acked;
+} libtock_ieee802154_tx_frame_t;
+
+// Function signature for the per-frame callback.
+//
+// - `arg1` (`libtock_ieee802154_tx_frame_t*`): The frame that finished, with
+//   `result` and `acked` set. It is no longer used by the queue.
+typedef void (*libtock_ieee802154_tx_queue_callback)(libtock_ieee802154_tx_frame_t*);
+
+// Set up the queue to hold up to `capacity` frames in `slots`, and call `cb`
+// with each frame that finishes. Fails with RETURNCODE_EBUSY while frames are
+// queued.
+returncode_t libtock_ieee802154_tx_queue_init(libtock_ieee802154_tx_frame_t** slots, int capacity,
+                                              libtock_ieee802154_tx_queue_callback cb);
+
+// Queue `frame`, which must stay valid until it is passed to the callback.
+// Sending starts right away if the queue was idle.
+//
+// Returns RETURNCODE_ENOMEM if the queue is full. If the queue was idle and
+// the frame could not be sent, returns that error and does not queue it.
+returncode_t libtock_ieee802154_tx_queue_push(libtock_ieee802154_tx_frame_t* frame);
+
+// Number of frames queued, including the one being sent.
+int libtock_ieee802154_tx_queue_pending(void);
+
+#ifdef __cplusplus
+}
+#endif
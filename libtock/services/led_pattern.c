@@ -0,0 +1,162 @@
+#include "../interface/led.h"
+#include "alarm.h"
+#include "led_pattern.h"
+#include "time.h"
+
+// Flash and pause lengths of blink codes.
+#define CODE_FLASH_MS 200
+#define CODE_PAUSE_MS 1200
+
+static const uint16_t blink_slow_steps[] = {500, 500};
+static const uint16_t blink_fast_steps[] = {100, 100};
+static const uint16_t heartbeat_steps[]  = {80, 120, 80, 720};
+static const uint16_t beacon_steps[]     = {50, 1950};
+
+const libtock_led_pattern_t libtock_led_pattern_blink_slow = {blink_slow_steps, 2, true};
+const libtock_led_pattern_t libtock_led_pattern_blink_fast = {blink_fast_steps, 2, true};
+const libtock_led_pattern_t libtock_led_pattern_heartbeat  = {heartbeat_steps, 4, true};
+const libtock_led_pattern_t libtock_led_pattern_beacon     = {beacon_steps, 2, true};
+
+typedef struct {
+  const libtock_led_pattern_t* pattern;
+  // Blink code being shown, instead of `pattern`, if not 0.
+  uint8_t code;
+  uint16_t step;
+  uint32_t next_at;
+} led_state_t;
+
+// The alarm callback has no context, so the LEDs are global.
+static struct {
+  led_state_t leds[LIBTOCK_LED_PATTERN_MAX];
+  libtock_alarm_t alarm;
+  bool armed;
+  uint32_t armed_at;
+} patterns;
+
+static uint32_t now_ms(void) {
+  return (uint32_t) (libtock_time_now_us64() / 1000);
+}
+
+// Whether `deadline` has passed at `now`, across wraps.
+static bool reached(uint32_t now, uint32_t deadline) {
+  return (int32_t) (now - deadline) >= 0;
+}
+
+static bool running(const led_state_t* led) {
+  return led->pattern != NULL || led->code != 0;
+}
+
+static uint32_t step_count(const led_state_t* led) {
+  return led->code != 0 ? 2u * led->code : led->pattern->count;
+}
+
+static uint32_t step_ms(const led_state_t* led) {
+  if (led->code == 0) return led->pattern->steps[led->step];
+  return led->step == 2u * led->code - 1 ? CODE_PAUSE_MS : CODE_FLASH_MS;
+}
+
+// Apply step `led->step` of LED `i` and schedule its end, from `at`.
+static void enter_step(int i, uint32_t at) {
+  led_state_t* led = &patterns.leds[i];
+  // Even steps are on.
+  if (led->step % 2 == 0) {
+    libtock_led_on(i);
+  } else {
+    libtock_led_off(i);
+  }
+  led->next_at = at + step_ms(led);
+}
+
+static void timer_fired(uint32_t now, uint32_t scheduled, void* opaque);
+
+// Arm the shared alarm for the earliest change of any LED, or stop it if no
+// pattern runs.
+static void schedule(void) {
+  bool found        = false;
+  uint32_t earliest = 0;
+  for (int i = 0; i < LIBTOCK_LED_PATTERN_MAX; i++) {
+    led_state_t* led = &patterns.leds[i];
+    if (running(led) && (!found || reached(earliest, led->next_at))) {
+      earliest = led->next_at;
+      found    = true;
+    }
+  }
+
+  if (patterns.armed && (!found || patterns.armed_at != earliest)) {
+    libtock_alarm_ms_cancel(&patterns.alarm);
+    patterns.armed = false;
+  }
+  if (!found || patterns.armed) return;
+
+  uint32_t now   = now_ms();
+  uint32_t delay = reached(now, earliest) ? 0 : earliest - now;
+  if (libtock_alarm_in_ms(delay, timer_fired, NULL, &patterns.alarm) == RETURNCODE_SUCCESS) {
+    patterns.armed    = true;
+    patterns.armed_at = earliest;
+  }
+}
+
+static void timer_fired(__attribute__ ((unused)) uint32_t now,
+                        __attribute__ ((unused)) uint32_t scheduled,
+                        __attribute__ ((unused)) void*    opaque) {
+  patterns.armed = false;
+  // Changes due shortly are made now, to share this wakeup.
+  uint32_t ms = now_ms() + LIBTOCK_LED_PATTERN_SLACK_MS;
+
+  for (int i = 0; i < LIBTOCK_LED_PATTERN_MAX; i++) {
+    led_state_t* led = &patterns.leds[i];
+    if (!running(led) || !reached(ms, led->next_at)) continue;
+
+    // Steps advance on the pattern's own timeline, so they do not drift.
+    uint32_t at = led->next_at;
+    if (++led->step == step_count(led)) {
+      if (led->code == 0 && !led->pattern->repeat) {
+        led->pattern = NULL;
+        libtock_led_off(i);
+        continue;
+      }
+      led->step = 0;
+    }
+    // After a stall, continue from now instead of in a burst.
+    if (reached(ms, at + step_ms(led))) at = ms - LIBTOCK_LED_PATTERN_SLACK_MS;
+    enter_step(i, at);
+  }
+
+  schedule();
+}
+
+static returncode_t start(int led, const libtock_led_pattern_t* pattern, uint8_t code) {
+  if (led < 0 || led >= LIBTOCK_LED_PATTERN_MAX) return RETURNCODE_EINVAL;
+
+  led_state_t* state = &patterns.leds[led];
+  state->pattern = pattern;
+  state->code    = code;
+  state->step    = 0;
+  enter_step(led, now_ms());
+  schedule();
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_led_pattern_start(int led, const libtock_led_pattern_t* pattern) {
+  if (pattern == NULL || pattern->count == 0) return RETURNCODE_EINVAL;
+  return start(led, pattern, 0);
+}
+
+returncode_t libtock_led_pattern_blink_code(int led, uint8_t code) {
+  if (code == 0) return RETURNCODE_EINVAL;
+  return start(led, NULL, code);
+}
+
+returncode_t libtock_led_pattern_stop(int led) {
+  if (led < 0 || led >= LIBTOCK_LED_PATTERN_MAX) return RETURNCODE_EINVAL;
+
+  patterns.leds[led].pattern = NULL;
+  patterns.leds[led].code    = 0;
+  schedule();
+  return libtock_led_off(led);
+}
+
+bool libtock_led_pattern_running(int led) {
+  if (led < 0 || led >= LIBTOCK_LED_PATTERN_MAX) return false;
+  return running(&patterns.leds[led]);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Status LED patterns on one shared timeline.
+//
+// Each LED can run a pattern of on and off times. All LEDs share a single
+// alarm, set for the next change of any of them, and changes due within
+// `LIBTOCK_LED_PATTERN_SLACK_MS` of each other are made in the same wakeup,
+// so a handful of blinking indicators costs one wakeup per change and one LED
+// command per change of an LED. The alarm only runs while a pattern is.
+//
+// Tock's LEDs are either on or off, so patterns are made of on and off
+// times; there is no brightness for fading.
+
+#ifndef LIBTOCK_LED_PATTERN_MAX
+#define LIBTOCK_LED_PATTERN_MAX 8
+#endif
+
+#ifndef LIBTOCK_LED_PATTERN_SLACK_MS
+#define LIBTOCK_LED_PATTERN_SLACK_MS 10
+#endif
+
+// On time, off time, on time and so on, in milliseconds. A pattern that does
+// not repeat leaves the LED off at its end.
+typedef struct {
+  const uint16_t* steps;
+  uint8_t count;
+  bool repeat;
+} libtock_led_pattern_t;
+
+// Patterns for common indicators.
+extern const libtock_led_pattern_t libtock_led_pattern_blink_slow;
+extern const libtock_led_pattern_t libtock_led_pattern_blink_fast;
+extern const libtock_led_pattern_t libtock_led_pattern_heartbeat;
+// One short flash every two seconds.
+extern const libtock_led_pattern_t libtock_led_pattern_beacon;
+
+// Run `pattern` on `led`, from its first step, replacing the LED's pattern.
+// `pattern` must stay valid while it runs.
+//
+// Returns RETURNCODE_EINVAL if `led` is not below `LIBTOCK_LED_PATTERN_MAX`
+// or the pattern has no steps.
+returncode_t libtock_led_pattern_start(int led, const libtock_led_pattern_t* pattern);
+
+// Flash `led` `code` times, pause, and repeat, to show a number such as an
+// error code.
+returncode_t libtock_led_pattern_blink_code(int led, uint8_t code);
+
+// Stop the pattern on `led` and turn it off.
+returncode_t libtock_led_pattern_stop(int led);
+
+// Whether a pattern runs on `led`.
+bool libtock_led_pattern_running(int led);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,75 @@
+#include <stdarg.h>
+
+#include "log.h"
+#include "stdout_buffer.h"
+
+#define FRAME_START  0x00
+#define FRAME_ANCHOR 0xFF
+
+// Format IDs are offsets from this string. The decoder finds it by name in
+// the ELF symbol table.
+const char libtock_log_anchor[] = "libtock-log";
+
+// Set once the anchor frame has been queued.
+static bool anchored = false;
+
+static uint32_t dropped = 0;
+
+static uint8_t* put_u32(uint8_t* p, uint32_t value) {
+  p[0] = value & 0xFF;
+  p[1] = (value >> 8) & 0xFF;
+  p[2] = (value >> 16) & 0xFF;
+  p[3] = (value >> 24) & 0xFF;
+  return p + 4;
+}
+
+// Queue `len` bytes only if all of them fit, a partial frame would corrupt
+// the stream.
+static returncode_t queue_frame(const uint8_t* frame, uint32_t len) {
+  if (!libtock_stdout_buffer_enabled()) return RETURNCODE_EOFF;
+  if (libtock_stdout_buffer_space() < len) return RETURNCODE_ENOMEM;
+  libtock_stdout_buffer_write(frame, len);
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_log_emit(const char* fmt, int nargs, ...) {
+  if (nargs < 0 || nargs > LIBTOCK_LOG_MAX_ARGS) return RETURNCODE_EINVAL;
+
+  uint8_t frame[2 + 4 + 4 * LIBTOCK_LOG_MAX_ARGS];
+  returncode_t ret;
+
+  // The decoder needs the runtime address of the anchor to resolve `%s`
+  // pointers, which depends on where the app was loaded.
+  if (!anchored) {
+    frame[0] = FRAME_START;
+    frame[1] = FRAME_ANCHOR;
+    put_u32(frame + 2, (uint32_t) libtock_log_anchor);
+    ret = queue_frame(frame, 6);
+    if (ret != RETURNCODE_SUCCESS) {
+      dropped++;
+      return ret;
+    }
+    anchored = true;
+  }
+
+  frame[0] = FRAME_START;
+  frame[1] = (uint8_t) nargs;
+  uint8_t* p = put_u32(frame + 2, (uint32_t) (fmt - libtock_log_anchor));
+
+  va_list ap;
+  va_start(ap, nargs);
+  for (int i = 0; i < nargs; i++) {
+    p = put_u32(p, va_arg(ap, uint32_t));
+  }
+  va_end(ap);
+
+  ret = queue_frame(frame, p - frame);
+  if (ret != RETURNCODE_SUCCESS) {
+    dropped++;
+  }
+  return ret;
+}
+
+uint32_t libtock_log_dropped(void) {
+  return dropped;
+}
@@ -0,0 +1,66 @@
+/*
+ * Deferred-format binary logging.
+ *
+ * `LIBTOCK_LOG()` does not format its message on the device. It sends a short
+ * binary frame with an ID for the format string and the raw argument values,
+ * and `tools/log_decode.py` turns the frames back into text using the app's
+ * ELF file:
+ *
+ *     LIBTOCK_LOG("rx len=%u rssi=%d\n", len, rssi);
+ *
+ *     $ tools/log_decode.py build/cortex-m4/cortex-m4.elf < /dev/ttyACM0
+ *     rx len=42 rssi=-71
+ *
+ * Frames are queued in the buffered stdout ring (see
+ * `libtock/services/stdout_buffer.h`), so they stay in order with `printf()`
+ * output and are drained in the background. Logging never blocks: if buffered
+ * stdout is not enabled or the frame does not fit, the message is dropped and
+ * counted by `libtock_log_dropped()`.
+ *
+ * Rules for arguments:
+ *
+ * - The format must be a string literal. Its ID is its offset from a marker
+ *   in flash, so the literal itself never has to be sent.
+ * - At most `LIBTOCK_LOG_MAX_ARGS` arguments, each an integer of up to 32
+ *   bits or a pointer. `%s` only decodes strings in flash, such as
+ *   literals.
+ *
+ * Frame format, all integers little-endian:
+ *
+ *     0x00, n (args, 0..8), u32 format ID, n * u32 args
+ *     0x00, 0xFF, u32 runtime address of the marker, sent once first
+ *
+ * The leading zero byte separates frames from text, so plain stdout output
+ * must not contain NUL bytes.
+ */
+
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LIBTOCK_LOG_MAX_ARGS 8
+
+// Log `fmt` with up to `LIBTOCK_LOG_MAX_ARGS` integer or pointer arguments.
+#define LIBTOCK_LOG(fmt, ...) \
+  libtock_log_emit("" fmt "", LIBTOCK_LOG_NARGS_(_, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0), ##__VA_ARGS__)
+
+#define LIBTOCK_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+
+// Queue one log frame. Use `LIBTOCK_LOG()` instead of calling this directly;
+// every variadic argument is read as a `uint32_t`.
+//
+// Returns RETURNCODE_EOFF if buffered stdout is not enabled,
+// RETURNCODE_ENOMEM if the buffer is full, and RETURNCODE_EINVAL if `nargs`
+// is out of range.
+returncode_t libtock_log_emit(const char* fmt, int nargs, ...);
+
+// Number of log frames dropped because they could not be queued.
+uint32_t libtock_log_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
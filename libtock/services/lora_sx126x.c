@@ -0,0 +1,252 @@
+#include <string.h>
+
+#include "lora_sx126x.h"
+
+#define OPCODE_WRITE_REGISTER       0x0D
+#define OPCODE_WRITE_BUFFER         0x0E
+#define OPCODE_READ_BUFFER          0x1E
+#define OPCODE_GET_RX_BUFFER_STATUS 0x13
+
+typedef enum {
+  OP_NONE,
+  OP_COMMAND,
+  OP_REGISTERS,
+  OP_READ_STATUS,
+  OP_READ_BUFFER,
+} op_t;
+
+// The PHY callbacks are shared by the whole driver, so the radio is global.
+static struct {
+  uint32_t busy_pin;
+  uint32_t dio_pin;
+  libtock_lora_sx126x_callback_irq irq_cb;
+
+  // Staged register writes, sorted by address.
+  uint16_t reg_addr[LIBTOCK_LORA_SX126X_MAX_STAGED];
+  uint8_t reg_value[LIBTOCK_LORA_SX126X_MAX_STAGED];
+  int reg_count;
+  // First staged write not yet committed.
+  int reg_next;
+
+  op_t op;
+  bool waiting_busy;
+  uint32_t len;
+  uint8_t tx[LIBTOCK_LORA_SX126X_MAX_TRANSFER];
+  uint8_t rx[LIBTOCK_LORA_SX126X_MAX_TRANSFER];
+  uint8_t* response;
+  uint8_t* read_buf;
+  uint8_t read_len;
+  libtock_lora_sx126x_callback cb;
+  libtock_lora_sx126x_callback_read read_cb;
+} radio;
+
+static void transfer_done(returncode_t ret);
+
+static void start_transfer(void) {
+  returncode_t ret = libtock_lora_phy_read_write(radio.tx, radio.rx, radio.len, transfer_done);
+  if (ret != RETURNCODE_SUCCESS) transfer_done(ret);
+}
+
+// Start the prepared transfer once BUSY is low. BUSY is read first, so the
+// interrupt is only used while the radio is actually busy.
+static void when_ready(void) {
+  int busy;
+  returncode_t ret = libtock_lora_phy_gpio_read(radio.busy_pin, &busy);
+  if (ret != RETURNCODE_SUCCESS) {
+    transfer_done(ret);
+    return;
+  }
+  if (!busy) {
+    start_transfer();
+    return;
+  }
+
+  radio.waiting_busy = true;
+  libtock_lora_phy_gpio_enable_interrupt(radio.busy_pin, libtock_falling_edge);
+  // BUSY may have fallen before the interrupt was enabled.
+  if (libtock_lora_phy_gpio_read(radio.busy_pin, &busy) == RETURNCODE_SUCCESS && !busy) {
+    radio.waiting_busy = false;
+    libtock_lora_phy_gpio_disable_interrupt(radio.busy_pin);
+    start_transfer();
+  }
+}
+
+static void gpio_event(uint32_t pin, bool high) {
+  if (pin == radio.busy_pin && !high && radio.waiting_busy) {
+    radio.waiting_busy = false;
+    libtock_lora_phy_gpio_disable_interrupt(radio.busy_pin);
+    start_transfer();
+  } else if (pin == radio.dio_pin && high && radio.irq_cb) {
+    radio.irq_cb();
+  }
+}
+
+// Prepare a WriteRegister of the run of consecutive addresses starting at
+// `reg_next`.
+static void prepare_register_run(void) {
+  int first    = radio.reg_next;
+  int last     = first;
+  int max_data = LIBTOCK_LORA_SX126X_MAX_TRANSFER - 3;
+  while (last + 1 < radio.reg_count && radio.reg_addr[last + 1] == radio.reg_addr[last] + 1 &&
+         last + 1 - first < max_data) {
+    last++;
+  }
+
+  uint16_t addr = radio.reg_addr[first];
+  radio.tx[0]   = OPCODE_WRITE_REGISTER;
+  radio.tx[1]   = addr >> 8;
+  radio.tx[2]   = addr & 0xff;
+  memcpy(&radio.tx[3], &radio.reg_value[first], last - first + 1);
+  radio.len      = 3 + last - first + 1;
+  radio.reg_next = last + 1;
+}
+
+static void finish(returncode_t ret) {
+  op_t op = radio.op;
+  radio.op = OP_NONE;
+  if (op == OP_READ_STATUS || op == OP_READ_BUFFER) {
+    radio.read_cb(ret, 0);
+  } else {
+    radio.cb(ret);
+  }
+}
+
+static void transfer_done(returncode_t ret) {
+  if (ret != RETURNCODE_SUCCESS) {
+    if (radio.op == OP_REGISTERS) radio.reg_count = 0;
+    finish(ret);
+    return;
+  }
+
+  switch (radio.op) {
+    case OP_COMMAND:
+      if (radio.response) memcpy(radio.response, radio.rx, radio.len);
+      finish(RETURNCODE_SUCCESS);
+      break;
+
+    case OP_REGISTERS:
+      if (radio.reg_next < radio.reg_count) {
+        prepare_register_run();
+        when_ready();
+        return;
+      }
+      radio.reg_count = 0;
+      finish(RETURNCODE_SUCCESS);
+      break;
+
+    case OP_READ_STATUS: {
+      // Status, payload length, start offset.
+      uint8_t length = radio.rx[2];
+      uint8_t start  = radio.rx[3];
+      if (length > radio.read_len) length = radio.read_len;
+
+      memset(radio.tx, 0, 3 + length);
+      radio.tx[0] = OPCODE_READ_BUFFER;
+      radio.tx[1] = start;
+      radio.len   = 3 + length;
+      radio.op    = OP_READ_BUFFER;
+      when_ready();
+      break;
+    }
+
+    case OP_READ_BUFFER: {
+      // Data follows the opcode, offset and status bytes.
+      int length = radio.len - 3;
+      memcpy(radio.read_buf, &radio.rx[3], length);
+      radio.op = OP_NONE;
+      radio.read_cb(RETURNCODE_SUCCESS, length);
+      break;
+    }
+
+    case OP_NONE:
+      break;
+  }
+}
+
+returncode_t libtock_lora_sx126x_init(uint32_t busy_pin, uint32_t dio_pin, libtock_lora_sx126x_callback_irq irq_cb) {
+  radio.busy_pin = busy_pin;
+  radio.dio_pin  = dio_pin;
+  radio.irq_cb   = irq_cb;
+
+  returncode_t ret = libtock_lora_phy_gpio_enable_input(busy_pin, libtock_pull_none);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtock_lora_phy_gpio_enable_input(dio_pin, libtock_pull_none);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtock_lora_phy_gpio_set_callback(gpio_event);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  return libtock_lora_phy_gpio_enable_interrupt(dio_pin, libtock_rising_edge);
+}
+
+returncode_t libtock_lora_sx126x_stage_register(uint16_t addr, uint8_t value) {
+  if (radio.op == OP_REGISTERS) return RETURNCODE_EBUSY;
+
+  int i = 0;
+  while (i < radio.reg_count && radio.reg_addr[i] < addr) i++;
+  if (i < radio.reg_count && radio.reg_addr[i] == addr) {
+    radio.reg_value[i] = value;
+    return RETURNCODE_SUCCESS;
+  }
+  if (radio.reg_count == LIBTOCK_LORA_SX126X_MAX_STAGED) return RETURNCODE_ENOMEM;
+
+  memmove(&radio.reg_addr[i + 1], &radio.reg_addr[i], (radio.reg_count - i) * sizeof(radio.reg_addr[0]));
+  memmove(&radio.reg_value[i + 1], &radio.reg_value[i], radio.reg_count - i);
+  radio.reg_addr[i]  = addr;
+  radio.reg_value[i] = value;
+  radio.reg_count++;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_lora_sx126x_commit_registers(libtock_lora_sx126x_callback cb) {
+  if (radio.op != OP_NONE) return RETURNCODE_EBUSY;
+  if (radio.reg_count == 0) return RETURNCODE_EALREADY;
+
+  radio.op       = OP_REGISTERS;
+  radio.cb       = cb;
+  radio.reg_next = 0;
+  prepare_register_run();
+  when_ready();
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_lora_sx126x_command(const uint8_t* cmd, uint32_t len, uint8_t* response,
+                                        libtock_lora_sx126x_callback cb) {
+  if (radio.op != OP_NONE) return RETURNCODE_EBUSY;
+  if (len == 0 || len > LIBTOCK_LORA_SX126X_MAX_TRANSFER) return RETURNCODE_ESIZE;
+
+  memcpy(radio.tx, cmd, len);
+  radio.len      = len;
+  radio.response = response;
+  radio.op       = OP_COMMAND;
+  radio.cb       = cb;
+  when_ready();
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_lora_sx126x_write_fifo(uint8_t offset, const uint8_t* data, uint8_t len,
+                                           libtock_lora_sx126x_callback cb) {
+  if (radio.op != OP_NONE) return RETURNCODE_EBUSY;
+
+  radio.tx[0] = OPCODE_WRITE_BUFFER;
+  radio.tx[1] = offset;
+  memcpy(&radio.tx[2], data, len);
+  radio.len      = 2 + len;
+  radio.response = NULL;
+  radio.op       = OP_COMMAND;
+  radio.cb       = cb;
+  when_ready();
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_lora_sx126x_read_packet(uint8_t* buf, uint8_t len, libtock_lora_sx126x_callback_read cb) {
+  if (radio.op != OP_NONE) return RETURNCODE_EBUSY;
+
+  memset(radio.tx, 0, 4);
+  radio.tx[0]    = OPCODE_GET_RX_BUFFER_STATUS;
+  radio.len      = 4;
+  radio.read_buf = buf;
+  radio.read_len = len;
+  radio.op       = OP_READ_STATUS;
+  radio.read_cb  = cb;
+  when_ready();
+  return RETURNCODE_SUCCESS;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../net/lora_phy.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Packet-level access to an SX126x LoRa radio over the LoRa PHY driver.
+//
+// Every SX126x command is one SPI transaction and must wait for the radio's
+// BUSY line to go low. `libtock_lora_phy_read_write()` and the PHY GPIO calls
+// leave that to the app, which then spends a syscall per byte-sized register
+// access and polls BUSY and DIO with `libtock_lora_phy_gpio_read()`.
+//
+// This helper instead:
+//
+// - waits for BUSY with a falling-edge interrupt, and only if it is high,
+// - stages register writes and commits each run of consecutive addresses as
+//   one burst WriteRegister transaction,
+// - writes a whole packet to the FIFO in one transaction,
+// - reads a received packet with one GetRxBufferStatus and one ReadBuffer
+//   transaction, and
+// - reports DIO interrupts through a callback instead of polling.
+//
+// One operation runs at a time. Starting another while one is in progress
+// returns RETURNCODE_EBUSY, as does staging a register during a commit.
+
+// Register writes that can be staged before a commit.
+#ifndef LIBTOCK_LORA_SX126X_MAX_STAGED
+#define LIBTOCK_LORA_SX126X_MAX_STAGED 32
+#endif
+
+// Largest SPI transaction: a ReadBuffer of a full 255 byte packet.
+#define LIBTOCK_LORA_SX126X_MAX_TRANSFER (3 + 255)
+
+// Function signature for operation callbacks.
+//
+// - `arg1` (`returncode_t`): Status of the SPI transactions.
+typedef void (*libtock_lora_sx126x_callback)(returncode_t);
+
+// Function signature for packet read callbacks.
+//
+// - `arg1` (`returncode_t`): Status of the SPI transactions.
+// - `arg2` (`int`): Bytes copied into the buffer. Longer packets are cut
+//   short.
+typedef void (*libtock_lora_sx126x_callback_read)(returncode_t, int);
+
+// Function signature for the DIO interrupt callback, called on a rising edge
+// of the DIO pin. The app reads and clears the radio's IRQ status with a
+// GetIrqStatus and a ClearIrqStatus command.
+typedef void (*libtock_lora_sx126x_callback_irq)(void);
+
+// Configure the BUSY and DIO pins of the PHY driver and start reporting DIO
+// interrupts to `irq_cb`. This replaces any callback set with
+// `libtock_lora_phy_gpio_set_callback()`.
+returncode_t libtock_lora_sx126x_init(uint32_t busy_pin, uint32_t dio_pin, libtock_lora_sx126x_callback_irq irq_cb);
+
+// Stage a register write. A later write to the same register replaces the
+// earlier one.
+//
+// Returns RETURNCODE_ENOMEM if `LIBTOCK_LORA_SX126X_MAX_STAGED` writes are
+// already staged.
+returncode_t libtock_lora_sx126x_stage_register(uint16_t addr, uint8_t value);
+
+// Write the staged registers, one burst per run of consecutive addresses.
+//
+// Returns RETURNCODE_EALREADY if nothing is staged, in which case no callback
+// follows.
+returncode_t libtock_lora_sx126x_commit_registers(libtock_lora_sx126x_callback cb);
+
+// Send one command of `len` bytes, starting with its opcode. If `response` is
+// not NULL, it receives the `len` bytes clocked back, so status and data
+// bytes are at the same offsets as in the datasheet.
+returncode_t libtock_lora_sx126x_command(const uint8_t* cmd, uint32_t len, uint8_t* response,
+                                        libtock_lora_sx126x_callback cb);
+
+// Write `len` bytes to the FIFO at `offset` in one transaction.
+returncode_t libtock_lora_sx126x_write_fifo(uint8_t offset, const uint8_t* data, uint8_t len,
+                                           libtock_lora_sx126x_callback cb);
+
+// Read the last received packet into `buf`.
+returncode_t libtock_lora_sx126x_read_packet(uint8_t* buf, uint8_t len, libtock_lora_sx126x_callback_read cb);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,110 @@
+#include "ninedof_stream.h"
+
+static void schedule_next(libtock_ninedof_stream_t* stream);
+
+static void sample_read(returncode_t ret, libtock_ninedof_sample_t* sample, void* opaque) {
+  libtock_ninedof_stream_t* stream = (libtock_ninedof_stream_t*) opaque;
+  stream->reading = false;
+  if (!stream->running || ret != RETURNCODE_SUCCESS) return;
+
+  if (stream->count == stream->capacity) {
+    stream->dropped++;
+    return;
+  }
+  uint32_t tail = stream->head + stream->count;
+  if (tail >= stream->capacity) tail -= stream->capacity;
+  stream->samples[tail] = *sample;
+  stream->count++;
+
+  if (stream->cb) stream->cb(stream->opaque);
+}
+
+static void sample_due(uint32_t now, uint32_t scheduled, void* opaque) {
+  libtock_ninedof_stream_t* stream = (libtock_ninedof_stream_t*) opaque;
+  if (!stream->running) return;
+
+  if (now - scheduled > stream->step) {
+    // Restart the schedule from here rather than catching up in a burst.
+    stream->deadline = now;
+  }
+  schedule_next(stream);
+
+  if (stream->reading) {
+    stream->skipped++;
+    return;
+  }
+  if (libtock_ninedof_read_all(&stream->reader, &stream->current, sample_read, stream) == RETURNCODE_SUCCESS) {
+    stream->reading = true;
+  }
+}
+
+static void schedule_next(libtock_ninedof_stream_t* stream) {
+  uint32_t step = stream->step;
+  stream->frac += stream->step_frac;
+  if (stream->frac >= stream->frequency) {
+    stream->frac -= stream->frequency;
+    step++;
+  }
+
+  uint32_t reference = stream->deadline;
+  stream->deadline += step;
+  libtock_alarm_at(reference, step, sample_due, stream, &stream->alarm);
+}
+
+returncode_t libtock_ninedof_stream_start(libtock_ninedof_stream_t* stream, uint32_t frequency,
+                                          libtock_ninedof_sample_t* samples, uint32_t capacity,
+                                          libtock_ninedof_stream_callback cb, void* opaque) {
+  uint32_t ticks;
+  returncode_t ret = libtock_alarm_get_frequency(&ticks);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (frequency == 0 || frequency > ticks || capacity == 0) return RETURNCODE_EINVAL;
+
+  uint32_t now;
+  ret = libtock_alarm_command_read(&now);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  stream->samples   = samples;
+  stream->capacity  = capacity;
+  stream->head      = 0;
+  stream->count     = 0;
+  stream->dropped   = 0;
+  stream->skipped   = 0;
+  stream->frequency = frequency;
+  stream->step      = ticks / frequency;
+  stream->step_frac = ticks % frequency;
+  stream->frac      = 0;
+  stream->deadline  = now;
+  stream->running   = true;
+  stream->reading   = false;
+  stream->cb        = cb;
+  stream->opaque    = opaque;
+
+  schedule_next(stream);
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_ninedof_stream_stop(libtock_ninedof_stream_t* stream) {
+  stream->running = false;
+  libtock_alarm_cancel(&stream->alarm);
+}
+
+bool libtock_ninedof_stream_pop(libtock_ninedof_stream_t* stream, libtock_ninedof_sample_t* sample) {
+  if (stream->count == 0) return false;
+
+  *sample      = stream->samples[stream->head];
+  stream->head = stream->head + 1 == stream->capacity ? 0 : stream->head + 1;
+  stream->count--;
+  return true;
+}
+
+uint32_t libtock_ninedof_stream_count(const libtock_ninedof_stream_t* stream) {
+  return stream->count;
+}
+
+uint32_t libtock_ninedof_stream_dropped(const libtock_ninedof_stream_t* stream) {
+  return stream->dropped;
+}
+
+uint32_t libtock_ninedof_stream_skipped(const libtock_ninedof_stream_t* stream) {
+  return stream->skipped;
+}
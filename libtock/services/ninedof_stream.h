@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../sensors/ninedof.h"
+#include "../tock.h"
+#include "alarm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Continuous 9-DoF sampling at a fixed rate into a queue.
+//
+// Each sample is a combined read from `libtock_ninedof_read_all()`, started
+// at an absolute deadline derived from the rate so the rate does not drift
+// with read latency. Samples are queued and the app takes them at its own
+// pace, for example once per orientation filter update.
+//
+// A deadline that comes while the previous read is still running is skipped
+// and counted by `libtock_ninedof_stream_skipped()`, which means the rate is
+// above what the sensors can deliver.
+
+// Function signature for the sample callback, called after each sample was
+// queued.
+typedef void (*libtock_ninedof_stream_callback)(void*);
+
+typedef struct {
+  libtock_ninedof_sample_t* samples;
+  uint32_t capacity;
+  uint32_t head;
+  uint32_t count;
+  uint32_t dropped;
+  uint32_t skipped;
+  // Ticks per sample, `step` plus `step_frac / frequency`.
+  uint32_t frequency;
+  uint32_t step;
+  uint32_t step_frac;
+  uint32_t frac;
+  uint32_t deadline;
+  bool running;
+  bool reading;
+  libtock_ninedof_reader_t reader;
+  libtock_ninedof_sample_t current;
+  libtock_ninedof_stream_callback cb;
+  void* opaque;
+  libtock_alarm_ticks_t alarm;
+} libtock_ninedof_stream_t;
+
+// Sample at `frequency` Hz into `samples`, which holds `capacity` samples.
+// `cb` may be NULL.
+//
+// Returns RETURNCODE_EINVAL if `frequency` is 0 or above the alarm frequency,
+// or `capacity` is 0.
+returncode_t libtock_ninedof_stream_start(libtock_ninedof_stream_t* stream, uint32_t frequency,
+                                          libtock_ninedof_sample_t* samples, uint32_t capacity,
+                                          libtock_ninedof_stream_callback cb, void* opaque);
+
+// Stop sampling. Queued samples can still be taken.
+void libtock_ninedof_stream_stop(libtock_ninedof_stream_t* stream);
+
+// Take the oldest sample. Returns false if the queue is empty.
+bool libtock_ninedof_stream_pop(libtock_ninedof_stream_t* stream, libtock_ninedof_sample_t* sample);
+
+// Number of samples waiting.
+uint32_t libtock_ninedof_stream_count(const libtock_ninedof_stream_t* stream);
+
+// Number of samples dropped because the queue was full.
+uint32_t libtock_ninedof_stream_dropped(const libtock_ninedof_stream_t* stream);
+
+// Number of deadlines skipped because the previous read had not finished.
+uint32_t libtock_ninedof_stream_skipped(const libtock_ninedof_stream_t* stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,128 @@
+#include <unistd.h>
+
+#include "pool.h"
+
+static uint32_t align_up(uint32_t n) {
+  return (n + LIBTOCK_POOL_ALIGN - 1) & ~(uint32_t) (LIBTOCK_POOL_ALIGN - 1);
+}
+
+// Take an aligned region of `len` bytes from the heap break. Going through
+// `sbrk()` keeps it in the heap usage counters, and newlib's malloc copes with
+// the break moving under it.
+static uint8_t* grow(uint32_t len) {
+  void* start = sbrk((int) (len + LIBTOCK_POOL_ALIGN - 1));
+  if (start == (void*) -1) return NULL;
+  return (uint8_t*) (((uintptr_t) start + LIBTOCK_POOL_ALIGN - 1) & ~(uintptr_t) (LIBTOCK_POOL_ALIGN - 1));
+}
+
+returncode_t libtock_pool_init(libtock_pool_t* pool, uint32_t block_size, uint32_t count) {
+  if (block_size == 0 || count == 0) return RETURNCODE_EINVAL;
+
+  // Free blocks hold the free list link.
+  if (block_size < sizeof(void*)) block_size = sizeof(void*);
+  block_size = align_up(block_size);
+  if (count > UINT32_MAX / block_size) return RETURNCODE_ENOMEM;
+
+  uint8_t* memory = grow(block_size * count);
+  if (memory == NULL) return RETURNCODE_ENOMEM;
+
+  pool->memory     = memory;
+  pool->block_size = block_size;
+  pool->count      = count;
+  pool->in_use     = 0;
+  pool->peak       = 0;
+  pool->failures   = 0;
+
+  // Link the blocks in address order so the first allocations are adjacent.
+  pool->free_list = NULL;
+  for (uint32_t i = count; i > 0; i--) {
+    void** block = (void**) (memory + (i - 1) * block_size);
+    *block          = pool->free_list;
+    pool->free_list = block;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+void* libtock_pool_alloc(libtock_pool_t* pool) {
+  void** block = (void**) pool->free_list;
+  if (block == NULL) {
+    pool->failures++;
+    return NULL;
+  }
+
+  pool->free_list = *block;
+  pool->in_use++;
+  if (pool->in_use > pool->peak) pool->peak = pool->in_use;
+  return block;
+}
+
+void libtock_pool_free(libtock_pool_t* pool, void* block) {
+  if (block == NULL) return;
+
+  *(void**) block = pool->free_list;
+  pool->free_list = block;
+  pool->in_use--;
+}
+
+bool libtock_pool_owns(const libtock_pool_t* pool, const void* ptr) {
+  const uint8_t* p = (const uint8_t*) ptr;
+  return p >= pool->memory && p < pool->memory + pool->block_size * pool->count;
+}
+
+uint32_t libtock_pool_in_use(const libtock_pool_t* pool) {
+  return pool->in_use;
+}
+
+uint32_t libtock_pool_peak(const libtock_pool_t* pool) {
+  return pool->peak;
+}
+
+uint32_t libtock_pool_failures(const libtock_pool_t* pool) {
+  return pool->failures;
+}
+
+returncode_t libtock_arena_init(libtock_arena_t* arena, uint32_t size) {
+  if (size == 0) return RETURNCODE_EINVAL;
+
+  // Rounding up lets the last allocation use the padding.
+  size = align_up(size);
+  uint8_t* memory = grow(size);
+  if (memory == NULL) return RETURNCODE_ENOMEM;
+
+  arena->memory   = memory;
+  arena->size     = size;
+  arena->used     = 0;
+  arena->peak     = 0;
+  arena->failures = 0;
+  return RETURNCODE_SUCCESS;
+}
+
+void* libtock_arena_alloc(libtock_arena_t* arena, uint32_t len) {
+  // `used` is always aligned, as `memory` is.
+  uint32_t padded = align_up(len);
+  if (padded < len || padded > arena->size - arena->used) {
+    arena->failures++;
+    return NULL;
+  }
+
+  void* ptr = arena->memory + arena->used;
+  arena->used += padded;
+  if (arena->used > arena->peak) arena->peak = arena->used;
+  return ptr;
+}
+
+void libtock_arena_reset(libtock_arena_t* arena) {
+  arena->used = 0;
+}
+
+uint32_t libtock_arena_used(const libtock_arena_t* arena) {
+  return arena->used;
+}
+
+uint32_t libtock_arena_peak(const libtock_arena_t* arena) {
+  return arena->peak;
+}
+
+uint32_t libtock_arena_failures(const libtock_arena_t* arena) {
+  return arena->failures;
+}
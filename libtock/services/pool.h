@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fixed-size block pools and bump arenas.
+//
+// newlib's `malloc()` grows the heap with `_sbrk()` and never gives memory
+// back, so an app that allocates and frees buffers of varying sizes for a
+// long time can fragment it until a request fails despite plenty of free
+// memory. These allocators avoid that for hot paths: each takes one region
+// from the heap break when it is created and only carves from it, in constant
+// time.
+//
+// - A pool hands out blocks of one size from a free list, for objects such as
+//   packet buffers that are freed in any order.
+// - An arena hands out memory of any size by bumping a pointer and frees it
+//   all at once with `libtock_arena_reset()`, for data that lives until the
+//   end of some unit of work.
+//
+// Their memory is never returned to the kernel, and `malloc()` remains usable
+// alongside them. Both keep counters to size them from real workloads.
+
+// Alignment of every block and arena allocation.
+#define LIBTOCK_POOL_ALIGN 8
+
+typedef struct {
+  uint8_t* memory;
+  uint32_t block_size;
+  uint32_t count;
+  void* free_list;
+  uint32_t in_use;
+  uint32_t peak;
+  uint32_t failures;
+} libtock_pool_t;
+
+typedef struct {
+  uint8_t* memory;
+  uint32_t size;
+  uint32_t used;
+  uint32_t peak;
+  uint32_t failures;
+} libtock_arena_t;
+
+// Create a pool of `count` blocks of at least `block_size` bytes, rounded up
+// to `LIBTOCK_POOL_ALIGN`.
+//
+// Returns RETURNCODE_EINVAL if `block_size` or `count` is 0, or
+// RETURNCODE_ENOMEM if the kernel cannot grow the app's memory.
+returncode_t libtock_pool_init(libtock_pool_t* pool, uint32_t block_size, uint32_t count);
+
+// Returns a free block, or NULL if all are in use.
+void* libtock_pool_alloc(libtock_pool_t* pool);
+
+// Return `block` to the pool. `block` may be NULL.
+void libtock_pool_free(libtock_pool_t* pool, void* block);
+
+// Whether `ptr` points into one of the pool's blocks.
+bool libtock_pool_owns(const libtock_pool_t* pool, const void* ptr);
+
+// Number of blocks now allocated, the most ever allocated at once, and the
+// number of allocations that failed.
+uint32_t libtock_pool_in_use(const libtock_pool_t* pool);
+uint32_t libtock_pool_peak(const libtock_pool_t* pool);
+uint32_t libtock_pool_failures(const libtock_pool_t* pool);
+
+// Create an arena of `size` bytes.
+//
+// Returns RETURNCODE_EINVAL if `size` is 0, or RETURNCODE_ENOMEM if the
+// kernel cannot grow the app's memory.
+returncode_t libtock_arena_init(libtock_arena_t* arena, uint32_t size);
+
+// Returns `len` bytes aligned to `LIBTOCK_POOL_ALIGN`, or NULL if the arena
+// does not have that much left.
+void* libtock_arena_alloc(libtock_arena_t* arena, uint32_t len);
+
+// Free everything allocated from the arena.
+void libtock_arena_reset(libtock_arena_t* arena);
+
+// Bytes now allocated, including alignment padding, the most ever allocated
+// between resets, and the number of allocations that failed.
+uint32_t libtock_arena_used(const libtock_arena_t* arena);
+uint32_t libtock_arena_peak(const libtock_arena_t* arena);
+uint32_t libtock_arena_failures(const libtock_arena_t* arena);
+
+#ifdef __cplusplus
+}
+#endif
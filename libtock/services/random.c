@@ -0,0 +1,155 @@
+#include <string.h>
+
+#include "../crypto/aes128_soft.h"
+#include "../peripherals/rng.h"
+#include "dma_buffer.h"
+#include "random.h"
+
+// Key and counter block of the DRBG, together the seed length.
+#define KEY_LEN  16
+#define SEED_LEN 32
+// Output generated at a time.
+#define OUTPUT_LEN 64
+
+static bool seeded = false;
+static uint8_t v[LIBTOCK_AES128_SOFT_BLOCK];
+static libtock_aes128_soft_t key;
+
+static uint8_t output[OUTPUT_LEN];
+static uint32_t output_pos = OUTPUT_LEN;
+// Bytes of output since the last reseed.
+static uint32_t since_reseed;
+
+// Entropy from the driver, and whether a request for it is running.
+static uint8_t pool[SEED_LEN] LIBTOCK_DMA_ALIGNED;
+static uint32_t pool_len;
+static bool requesting = false;
+static libtock_random_callback_ready ready_cb = NULL;
+
+static void increment_v(void) {
+  for (int i = LIBTOCK_AES128_SOFT_BLOCK - 1; i >= 0 && ++v[i] == 0; i--) {
+  }
+}
+
+// CTR_DRBG_Update: the next two blocks, XORed with `provided` if given, are
+// the new key and counter.
+static void drbg_update(const uint8_t* provided) {
+  uint8_t temp[SEED_LEN];
+  for (int i = 0; i < SEED_LEN; i += LIBTOCK_AES128_SOFT_BLOCK) {
+    increment_v();
+    libtock_aes128_soft_encrypt_block(&key, v, temp + i);
+  }
+  if (provided != NULL) {
+    for (int i = 0; i < SEED_LEN; i++) {
+      temp[i] ^= provided[i];
+    }
+  }
+  libtock_aes128_soft_init(&key, temp);
+  memcpy(v, temp + KEY_LEN, LIBTOCK_AES128_SOFT_BLOCK);
+  memset(temp, 0, sizeof(temp));
+}
+
+// Mix the pool into the state, instantiating it on first use.
+static void drbg_reseed(void) {
+  if (!seeded) {
+    static const uint8_t zero_key[KEY_LEN] = { 0 };
+    libtock_aes128_soft_init(&key, zero_key);
+    memset(v, 0, sizeof(v));
+  }
+  drbg_update(pool);
+  memset(pool, 0, sizeof(pool));
+  pool_len     = 0;
+  since_reseed = 0;
+  // Drop output generated from the old state.
+  output_pos = OUTPUT_LEN;
+  seeded     = true;
+}
+
+static void drbg_generate(void) {
+  for (int i = 0; i < OUTPUT_LEN; i += LIBTOCK_AES128_SOFT_BLOCK) {
+    increment_v();
+    libtock_aes128_soft_encrypt_block(&key, v, output + i);
+  }
+  drbg_update(NULL);
+  output_pos = 0;
+}
+
+static returncode_t request_entropy(void);
+
+static void rng_cb(returncode_t ret, int received) {
+  requesting = false;
+  libtock_rng_set_allow_readwrite(NULL, 0);
+
+  if (ret == RETURNCODE_SUCCESS) {
+    pool_len += received;
+    if (pool_len < SEED_LEN) {
+      ret = request_entropy();
+      if (ret == RETURNCODE_SUCCESS) return;
+    } else {
+      drbg_reseed();
+    }
+  }
+
+  libtock_random_callback_ready cb = ready_cb;
+  ready_cb = NULL;
+  if (cb != NULL) cb(ret);
+}
+
+static returncode_t request_entropy(void) {
+  returncode_t ret = libtock_rng_get_random_bytes(pool + pool_len, SEED_LEN - pool_len, SEED_LEN - pool_len,
+                                                  rng_cb);
+  requesting = ret == RETURNCODE_SUCCESS;
+  return ret;
+}
+
+returncode_t libtock_random_init(libtock_random_callback_ready cb) {
+  if (seeded) return RETURNCODE_EALREADY;
+  if (requesting) return RETURNCODE_EBUSY;
+  ready_cb = cb;
+  return request_entropy();
+}
+
+bool libtock_random_ready(void) {
+  return seeded;
+}
+
+returncode_t libtock_random_bytes(uint8_t* buf, uint32_t len) {
+  if (!seeded) return RETURNCODE_EOFF;
+
+  while (len > 0) {
+    if (output_pos == OUTPUT_LEN) drbg_generate();
+    uint32_t n = OUTPUT_LEN - output_pos;
+    if (n > len) n = len;
+    memcpy(buf, output + output_pos, n);
+    // Served bytes are not kept.
+    memset(output + output_pos, 0, n);
+    output_pos   += n;
+    buf          += n;
+    len          -= n;
+    since_reseed += n;
+  }
+
+  if (since_reseed >= LIBTOCK_RANDOM_RESEED_BYTES && !requesting) request_entropy();
+  return RETURNCODE_SUCCESS;
+}
+
+uint32_t libtock_random_u32(void) {
+  uint32_t value = 0;
+  libtock_random_bytes((uint8_t*) &value, sizeof(value));
+  return value;
+}
+
+uint32_t libtock_random_below(uint32_t bound) {
+  // Lemire's multiply and reject: only values in the short last interval
+  // are drawn again.
+  uint64_t m   = (uint64_t) libtock_random_u32() * bound;
+  uint32_t low = (uint32_t) m;
+  if (low < bound) {
+    uint32_t threshold = -bound % bound;
+    while (low < threshold) {
+      m   = (uint64_t) libtock_random_u32() * bound;
+      low = (uint32_t) m;
+    }
+  }
+  return m >> 32;
+}
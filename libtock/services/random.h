@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fast random numbers from a userspace DRBG seeded by the RNG driver.
+//
+// Each request to the RNG driver is an allow, a subscribe, a command and an
+// upcall, which dominates the cost of the few bytes protocol code usually
+// needs. This service seeds a CTR_DRBG (NIST SP 800-90A, AES-128 without a
+// derivation function) from the driver once and serves random numbers from
+// it without system calls. After every `LIBTOCK_RANDOM_RESEED_BYTES` bytes
+// of output it asks the driver for fresh entropy in the background and mixes
+// it in when the upcall arrives.
+//
+// Output is generated a block buffer at a time, so a call usually only
+// copies from the buffer.
+//
+// The service owns the RNG driver's upcall and buffer: do not call
+// `libtock_rng_get_random_bytes()` while it is in use.
+
+#ifndef LIBTOCK_RANDOM_RESEED_BYTES
+#define LIBTOCK_RANDOM_RESEED_BYTES 4096
+#endif
+
+// Function signature for the callback once the generator is seeded.
+//
+// - `arg1` (`returncode_t`): Status of the first request to the RNG driver.
+typedef void (*libtock_random_callback_ready)(returncode_t);
+
+// Seed the generator from the RNG driver.
+//
+// Returns RETURNCODE_EALREADY if the generator is already seeded, in which
+// case the callback is not called.
+returncode_t libtock_random_init(libtock_random_callback_ready cb);
+
+// Whether the generator has been seeded.
+bool libtock_random_ready(void);
+
+// Fill `buf` with `len` random bytes.
+//
+// Returns RETURNCODE_EOFF if the generator is not seeded yet.
+returncode_t libtock_random_bytes(uint8_t* buf, uint32_t len);
+
+// A random 32-bit number. The generator must be seeded; before that this
+// returns 0.
+uint32_t libtock_random_u32(void);
+
+// A uniformly distributed random number below `bound`, which must not be 0.
+uint32_t libtock_random_below(uint32_t bound);
+
+#ifdef __cplusplus
+}
+#endif
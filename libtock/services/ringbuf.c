@@ -0,0 +1,112 @@
+#include <string.h>
+
+#include "ringbuf.h"
+
+static bool power_of_two(uint32_t n) {
+  return n != 0 && (n & (n - 1)) == 0;
+}
+
+returncode_t libtock_ringbuf_init(libtock_ringbuf_t* ring, uint8_t* buffer, uint32_t size) {
+  return libtock_ringbuf_init_records(ring, buffer, 1, size);
+}
+
+returncode_t libtock_ringbuf_init_records(libtock_ringbuf_t* ring, void* buffer, uint32_t record_size,
+                                          uint32_t count) {
+  if (record_size == 0 || !power_of_two(count)) return RETURNCODE_EINVAL;
+
+  ring->buffer      = buffer;
+  ring->record_size = record_size;
+  ring->mask        = count - 1;
+  ring->head        = 0;
+  ring->tail        = 0;
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_ringbuf_clear(libtock_ringbuf_t* ring) {
+  ring->tail = ring->head;
+}
+
+uint32_t libtock_ringbuf_capacity(const libtock_ringbuf_t* ring) {
+  return ring->mask + 1;
+}
+
+uint32_t libtock_ringbuf_used(const libtock_ringbuf_t* ring) {
+  return ring->head - ring->tail;
+}
+
+uint32_t libtock_ringbuf_space(const libtock_ringbuf_t* ring) {
+  return ring->mask + 1 - (ring->head - ring->tail);
+}
+
+bool libtock_ringbuf_empty(const libtock_ringbuf_t* ring) {
+  return ring->head == ring->tail;
+}
+
+static uint8_t* unit(const libtock_ringbuf_t* ring, uint32_t position) {
+  return ring->buffer + (position & ring->mask) * ring->record_size;
+}
+
+// Units from `position` to the end of the buffer.
+static uint32_t to_end(const libtock_ringbuf_t* ring, uint32_t position) {
+  return ring->mask + 1 - (position & ring->mask);
+}
+
+uint32_t libtock_ringbuf_write(libtock_ringbuf_t* ring, const void* data, uint32_t count) {
+  uint32_t space = libtock_ringbuf_space(ring);
+  if (count > space) count = space;
+
+  uint32_t first = to_end(ring, ring->head);
+  if (first > count) first = count;
+  memcpy(unit(ring, ring->head), data, first * ring->record_size);
+  memcpy(ring->buffer, (const uint8_t*) data + first * ring->record_size, (count - first) * ring->record_size);
+  ring->head += count;
+  return count;
+}
+
+uint32_t libtock_ringbuf_read(libtock_ringbuf_t* ring, void* data, uint32_t count) {
+  uint32_t used = libtock_ringbuf_used(ring);
+  if (count > used) count = used;
+
+  uint32_t first = to_end(ring, ring->tail);
+  if (first > count) first = count;
+  memcpy(data, unit(ring, ring->tail), first * ring->record_size);
+  memcpy((uint8_t*) data + first * ring->record_size, ring->buffer, (count - first) * ring->record_size);
+  ring->tail += count;
+  return count;
+}
+
+bool libtock_ringbuf_push(libtock_ringbuf_t* ring, const void* record) {
+  if (libtock_ringbuf_space(ring) == 0) return false;
+  memcpy(unit(ring, ring->head), record, ring->record_size);
+  ring->head++;
+  return true;
+}
+
+bool libtock_ringbuf_pop(libtock_ringbuf_t* ring, void* record) {
+  if (libtock_ringbuf_empty(ring)) return false;
+  memcpy(record, unit(ring, ring->tail), ring->record_size);
+  ring->tail++;
+  return true;
+}
+
+void* libtock_ringbuf_write_span(libtock_ringbuf_t* ring, uint32_t* count) {
+  uint32_t space = libtock_ringbuf_space(ring);
+  uint32_t len   = to_end(ring, ring->head);
+  *count = len < space ? len : space;
+  return *count > 0 ? unit(ring, ring->head) : NULL;
+}
+
+void libtock_ringbuf_commit(libtock_ringbuf_t* ring, uint32_t count) {
+  ring->head += count;
+}
+
+void* libtock_ringbuf_read_span(libtock_ringbuf_t* ring, uint32_t* count) {
+  uint32_t used = libtock_ringbuf_used(ring);
+  uint32_t len  = to_end(ring, ring->tail);
+  *count = len < used ? len : used;
+  return *count > 0 ? unit(ring, ring->tail) : NULL;
+}
+
+void libtock_ringbuf_release(libtock_ringbuf_t* ring, uint32_t count) {
+  ring->tail += count;
+}
@@ -0,0 +1,86 @@
+/*
+ * Single-producer, single-consumer ring buffers.
+ *
+ * A ring holds a power-of-two number of fixed-size units: bytes for a byte
+ * ring, or records of `record_size` bytes. The producer and consumer each
+ * advance their own free-running counter, the fill level is their
+ * difference, and the position in the buffer is the counter masked by the
+ * capacity, so there is no division on any path and the counters may wrap.
+ *
+ * Besides copying in and out, each side can work on the ring in place:
+ * `libtock_ringbuf_write_span()` returns the contiguous free space for a
+ * producer to fill directly, for instance by allowing it to the kernel, and
+ * `libtock_ringbuf_commit()` publishes what was written into it. On the
+ * other side, `libtock_ringbuf_read_span()` and `libtock_ringbuf_release()`
+ * let a consumer hand queued data to a syscall without copying it first.
+ * Spans stop at the end of the buffer; after committing or releasing one,
+ * the next span starts at the buffer's beginning.
+ *
+ * Upcalls only run inside `yield()`, so a producer in an upcall and a
+ * consumer in the main loop never run at the same time and need no locking.
+ */
+
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  uint8_t* buffer;
+  uint32_t record_size;
+  // Capacity in units, minus one.
+  uint32_t mask;
+  // Units ever written and read.
+  uint32_t head;
+  uint32_t tail;
+} libtock_ringbuf_t;
+
+// Use the `size` bytes at `buffer` as a byte ring.
+//
+// Returns RETURNCODE_EINVAL unless `size` is a power of two.
+returncode_t libtock_ringbuf_init(libtock_ringbuf_t* ring, uint8_t* buffer, uint32_t size);
+
+// Use `buffer` as a ring of `count` records of `record_size` bytes.
+//
+// Returns RETURNCODE_EINVAL if `record_size` is 0 or `count` is not a power
+// of two.
+returncode_t libtock_ringbuf_init_records(libtock_ringbuf_t* ring, void* buffer, uint32_t record_size,
+                                          uint32_t count);
+
+// Drop everything queued.
+void libtock_ringbuf_clear(libtock_ringbuf_t* ring);
+
+// Capacity, units queued and units free.
+uint32_t libtock_ringbuf_capacity(const libtock_ringbuf_t* ring);
+uint32_t libtock_ringbuf_used(const libtock_ringbuf_t* ring);
+uint32_t libtock_ringbuf_space(const libtock_ringbuf_t* ring);
+bool libtock_ringbuf_empty(const libtock_ringbuf_t* ring);
+
+// Copy up to `count` units in or out. Return the number of units copied.
+uint32_t libtock_ringbuf_write(libtock_ringbuf_t* ring, const void* data, uint32_t count);
+uint32_t libtock_ringbuf_read(libtock_ringbuf_t* ring, void* data, uint32_t count);
+
+// Copy one record in or out. Return false if the ring is full or empty.
+bool libtock_ringbuf_push(libtock_ringbuf_t* ring, const void* record);
+bool libtock_ringbuf_pop(libtock_ringbuf_t* ring, void* record);
+
+// Contiguous free space at the producer's end, with its length in units in
+// `*count`. Returns NULL if the ring is full.
+void* libtock_ringbuf_write_span(libtock_ringbuf_t* ring, uint32_t* count);
+
+// Publish `count` units written into the write span.
+void libtock_ringbuf_commit(libtock_ringbuf_t* ring, uint32_t count);
+
+// Contiguous queued units at the consumer's end, with their number in
+// `*count`. Returns NULL if the ring is empty.
+void* libtock_ringbuf_read_span(libtock_ringbuf_t* ring, uint32_t* count);
+
+// Free the first `count` units of the read span.
+void libtock_ringbuf_release(libtock_ringbuf_t* ring, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
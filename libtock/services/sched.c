@@ -0,0 +1,263 @@
+#include "sched.h"
+#include "time.h"
+
+// The dispatch task and the alarms carry no context beyond the scheduler,
+// so its state is global.
+static struct {
+  // Ready deadline jobs, earliest deadline first.
+  libtock_sched_task_t* ready;
+  // Queued background slices, oldest first.
+  libtock_sched_task_t* idle_head;
+  libtock_sched_task_t* idle_tail;
+  // Every periodic task.
+  libtock_sched_task_t* periodic;
+  uint32_t utilization;
+
+  libtock_sched_task_t* running;
+  uint64_t run_start_us;
+  uint32_t run_budget_us;
+
+  // Whether a dispatch is in the task queue, and whether the alarms for
+  // background work and for the next release are set.
+  bool dispatch_queued;
+  bool idle_armed;
+  bool release_armed;
+  libtock_alarm_t idle_alarm;
+  libtock_alarm_t release_alarm;
+} sched;
+
+static void kick(void);
+
+// Share of the CPU `task` reserves, rounded up.
+static uint32_t density(const libtock_sched_task_t* task) {
+  uint32_t window = task->deadline_us < task->period_us ? task->deadline_us : task->period_us;
+  return (uint32_t) (((uint64_t) task->budget_us * 1000 + window - 1) / window);
+}
+
+// Jobs with equal deadlines run in the order they became ready.
+static void insert_ready(libtock_sched_task_t* task) {
+  libtock_sched_task_t** link = &sched.ready;
+  while (*link != NULL && (*link)->due_us <= task->due_us) link = &(*link)->next;
+  task->next  = *link;
+  *link       = task;
+  task->ready = true;
+}
+
+static void remove_from(libtock_sched_task_t** link, libtock_sched_task_t* task, libtock_sched_task_t** tail) {
+  libtock_sched_task_t* prev = NULL;
+  while (*link != task) {
+    prev = *link;
+    link = &(*link)->next;
+  }
+  *link = task->next;
+  if (tail != NULL && *tail == task) *tail = prev;
+  task->next = NULL;
+}
+
+static void unready(libtock_sched_task_t* task) {
+  if (task->background) {
+    remove_from(&sched.idle_head, task, &sched.idle_tail);
+  } else {
+    remove_from(&sched.ready, task, NULL);
+  }
+  task->ready = false;
+}
+
+static void run(libtock_sched_task_t* task) {
+  uint64_t due = task->due_us;
+  bool background = task->background;
+  unready(task);
+
+  sched.running       = task;
+  sched.run_budget_us = task->budget_us;
+  sched.run_start_us  = libtock_time_now_us64();
+  task->handler(task);
+  uint64_t end = libtock_time_now_us64();
+  sched.running = NULL;
+
+  uint64_t elapsed = end - sched.run_start_us;
+  uint32_t took    = elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t) elapsed;
+  task->stats.runs++;
+  if (took > task->stats.worst_us) task->stats.worst_us = took;
+  if (sched.run_budget_us != 0 && took > sched.run_budget_us) task->stats.overruns++;
+  if (!background && end > due) task->stats.missed++;
+}
+
+static void dispatch(__attribute__ ((unused)) int arg0, __attribute__ ((unused)) int arg1,
+                     __attribute__ ((unused)) int arg2, __attribute__ ((unused)) void* ud) {
+  sched.dispatch_queued = false;
+  // Background work waits for the idle alarm, so it never runs twice
+  // without a trip through the kernel.
+  if (sched.ready != NULL) run(sched.ready);
+  kick();
+}
+
+static void idle_fired(__attribute__ ((unused)) uint32_t now, __attribute__ ((unused)) uint32_t scheduled,
+                       __attribute__ ((unused)) void* opaque) {
+  sched.idle_armed = false;
+  if (sched.ready != NULL) {
+    run(sched.ready);
+  } else if (sched.idle_head != NULL) {
+    run(sched.idle_head);
+  }
+  kick();
+}
+
+// Make sure the next job gets to run.
+static void kick(void) {
+  if (sched.ready != NULL && !sched.dispatch_queued) {
+    if (tock_enqueue(dispatch, 0, 0, 0, NULL) >= 0) {
+      sched.dispatch_queued = true;
+      return;
+    }
+    // The task queue is full; run the job from the alarm instead.
+  } else if (sched.ready != NULL || sched.idle_head == NULL) {
+    return;
+  }
+  if (!sched.idle_armed && libtock_alarm_in_us(0, idle_fired, NULL, &sched.idle_alarm) == RETURNCODE_SUCCESS) {
+    sched.idle_armed = true;
+  }
+}
+
+// Make `task`'s next job ready as of `now`.
+static void release(libtock_sched_task_t* task, uint64_t now) {
+  if (task->ready) {
+    // The last job never ran; this one replaces it.
+    task->stats.missed++;
+    unready(task);
+  }
+  task->due_us = task->release_us + task->deadline_us;
+  insert_ready(task);
+
+  task->release_us += task->period_us;
+  if (task->release_us <= now) {
+    // Whole periods went by without a release, count their jobs as missed.
+    uint64_t skipped = (now - task->release_us) / task->period_us + 1;
+    task->stats.missed += (uint32_t) skipped;
+    task->release_us   += skipped * task->period_us;
+  }
+}
+
+static void release_fired(uint32_t, uint32_t, void*);
+
+static void arm_release(void) {
+  if (sched.release_armed) {
+    libtock_alarm_ms_cancel(&sched.release_alarm);
+    sched.release_armed = false;
+  }
+  if (sched.periodic == NULL) return;
+
+  uint64_t next = UINT64_MAX;
+  for (libtock_sched_task_t* t = sched.periodic; t != NULL; t = t->next_periodic) {
+    if (t->release_us < next) next = t->release_us;
+  }
+  uint64_t now = libtock_time_now_us64();
+  uint64_t in  = next > now ? next - now : 0;
+  if (libtock_alarm_in_us(in > UINT32_MAX ? UINT32_MAX : (uint32_t) in, release_fired, NULL,
+                          &sched.release_alarm) == RETURNCODE_SUCCESS) {
+    sched.release_armed = true;
+  }
+}
+
+static void release_fired(__attribute__ ((unused)) uint32_t now_ticks, __attribute__ ((unused)) uint32_t scheduled,
+                          __attribute__ ((unused)) void* opaque) {
+  sched.release_armed = false;
+  uint64_t now = libtock_time_now_us64();
+  for (libtock_sched_task_t* t = sched.periodic; t != NULL; t = t->next_periodic) {
+    if (t->release_us <= now) release(t, now);
+  }
+  arm_release();
+  kick();
+}
+
+void libtock_sched_task_init(libtock_sched_task_t* task, libtock_sched_handler handler, void* ud) {
+  *task = (libtock_sched_task_t) {
+    .handler = handler,
+    .ud      = ud,
+  };
+}
+
+returncode_t libtock_sched_periodic(libtock_sched_task_t* task, uint32_t period_us, uint32_t deadline_us,
+                                   uint32_t budget_us) {
+  if (period_us == 0 || deadline_us > period_us) return RETURNCODE_EINVAL;
+  if (task->periodic || task->ready) return RETURNCODE_EBUSY;
+
+  task->period_us   = period_us;
+  task->deadline_us = deadline_us == 0 ? period_us : deadline_us;
+  task->budget_us   = budget_us;
+  task->background  = false;
+  uint32_t share = density(task);
+  if (sched.utilization + share > LIBTOCK_SCHED_MAX_UTILIZATION) return RETURNCODE_ENOMEM;
+  sched.utilization += share;
+
+  task->periodic      = true;
+  task->next_periodic = sched.periodic;
+  sched.periodic      = task;
+
+  uint64_t now = libtock_time_now_us64();
+  task->release_us = now;
+  release(task, now);
+  arm_release();
+  kick();
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_sched_submit(libtock_sched_task_t* task, uint32_t deadline_us, uint32_t budget_us) {
+  if (task->periodic || (task->ready && task->background)) return RETURNCODE_EBUSY;
+
+  uint64_t due = libtock_time_now_us64() + deadline_us;
+  task->budget_us = budget_us;
+  if (task->ready) {
+    if (due >= task->due_us) return RETURNCODE_SUCCESS;
+    unready(task);
+  }
+  task->background = false;
+  task->due_us     = due;
+  insert_ready(task);
+  kick();
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_sched_background(libtock_sched_task_t* task) {
+  if (task->periodic || (task->ready && !task->background)) return RETURNCODE_EBUSY;
+  if (task->ready) return RETURNCODE_SUCCESS;
+
+  task->background = true;
+  task->budget_us  = 0;
+  task->ready      = true;
+  task->next       = NULL;
+  if (sched.idle_tail == NULL) {
+    sched.idle_head = task;
+  } else {
+    sched.idle_tail->next = task;
+  }
+  sched.idle_tail = task;
+  kick();
+  return RETURNCODE_SUCCESS;
+}
+
+bool libtock_sched_cancel(libtock_sched_task_t* task) {
+  bool was_scheduled = task->periodic || task->ready;
+
+  if (task->periodic) {
+    libtock_sched_task_t** link = &sched.periodic;
+    while (*link != task) link = &(*link)->next_periodic;
+    *link = task->next_periodic;
+    task->next_periodic = NULL;
+    task->periodic      = false;
+    sched.utilization  -= density(task);
+    arm_release();
+  }
+  if (task->ready) unready(task);
+  return was_scheduled;
+}
+
+uint32_t libtock_sched_budget_left_us(void) {
+  if (sched.running == NULL || sched.run_budget_us == 0) return UINT32_MAX;
+  uint64_t elapsed = libtock_time_now_us64() - sched.run_start_us;
+  return elapsed >= sched.run_budget_us ? 0 : sched.run_budget_us - (uint32_t) elapsed;
+}
+
+uint32_t libtock_sched_utilization(void) {
+  return sched.utilization;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "../tock.h"
+#include "alarm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Earliest-deadline-first scheduling of cooperative tasks.
+//
+// Deferred tasks and work items run in FIFO order, so a control loop that
+// must finish within its period waits behind whatever was queued first. This
+// scheduler orders jobs by deadline instead:
+//
+// - Periodic tasks are released by the alarm queue every `period_us`, and
+//   each release is due `deadline_us` later.
+// - One-shot jobs are submitted with a deadline relative to now.
+// - Background tasks have no deadline and run only when no job with one is
+//   ready, one slice per trip through the kernel, so they soak up idle time
+//   without holding off upcalls.
+//
+// Jobs run from `yield()` like other deferred tasks, one job per task so
+// upcalls and other tasks get in between. The ready job with the earliest
+// deadline always runs next.
+//
+// Handlers are not preempted, so a budget is a promise rather than a limit:
+// a handler with long work checks `libtock_sched_budget_left_us()` and
+// splits it up, and jobs that run over are counted. Periodic tasks are only
+// admitted while the sum of `budget_us` over the shorter of deadline and
+// period stays within `LIBTOCK_SCHED_MAX_UTILIZATION`, which keeps the
+// declared load schedulable.
+//
+//     static libtock_sched_task_t control;
+//
+//     static void control_step(libtock_sched_task_t* task) { ... }
+//
+//     libtock_sched_task_init(&control, control_step, NULL);
+//     libtock_sched_periodic(&control, 10000, 0, 2000);
+//     while (1) yield();
+
+// Largest admitted utilization of periodic tasks, in parts per thousand.
+#ifndef LIBTOCK_SCHED_MAX_UTILIZATION
+#define LIBTOCK_SCHED_MAX_UTILIZATION 900
+#endif
+
+struct libtock_sched_task;
+
+// Function signature for task handlers.
+//
+// - `arg1` (`libtock_sched_task_t*`): The task that runs. Its `ud` field
+//   holds the pointer passed to `libtock_sched_task_init()`.
+typedef void (*libtock_sched_handler)(struct libtock_sched_task*);
+
+typedef struct {
+  // Jobs run.
+  uint32_t runs;
+  // Jobs that finished after their deadline, or were released again before
+  // they ran.
+  uint32_t missed;
+  // Jobs that ran longer than their budget.
+  uint32_t overruns;
+  // Longest run.
+  uint32_t worst_us;
+} libtock_sched_stats_t;
+
+typedef struct libtock_sched_task {
+  libtock_sched_handler handler;
+  void* ud;
+  uint32_t period_us;
+  uint32_t deadline_us;
+  uint32_t budget_us;
+  // Absolute times of the ready job's deadline and the next release.
+  uint64_t due_us;
+  uint64_t release_us;
+  bool ready;
+  bool periodic;
+  bool background;
+  struct libtock_sched_task* next;
+  struct libtock_sched_task* next_periodic;
+  libtock_sched_stats_t stats;
+} libtock_sched_task_t;
+
+// Set up `task` to call `handler`. `task` must live as long as it is
+// scheduled.
+void libtock_sched_task_init(libtock_sched_task_t* task, libtock_sched_handler handler, void* ud);
+
+// Release `task` now and every `period_us` from now on, each job due
+// `deadline_us` after its release, or at the next release if `deadline_us`
+// is 0. `budget_us` is the longest one job should run, 0 for no budget.
+//
+// Returns RETURNCODE_EINVAL if `period_us` is 0 or `deadline_us` longer
+// than it, RETURNCODE_EBUSY if the task is already scheduled, and
+// RETURNCODE_ENOMEM if admitting it would exceed
+// `LIBTOCK_SCHED_MAX_UTILIZATION`.
+returncode_t libtock_sched_periodic(libtock_sched_task_t* task, uint32_t period_us, uint32_t deadline_us,
+                                   uint32_t budget_us);
+
+// Queue one job of `task` due `deadline_us` from now. Submitting a task
+// that is already ready keeps the earlier of the two deadlines.
+//
+// Returns RETURNCODE_EBUSY for a periodic or background task.
+returncode_t libtock_sched_submit(libtock_sched_task_t* task, uint32_t deadline_us, uint32_t budget_us);
+
+// Queue one slice of background work. A handler resubmits itself to
+// continue. Does nothing if the task is already queued.
+//
+// Returns RETURNCODE_EBUSY for a periodic task or one with a deadline job
+// ready.
+returncode_t libtock_sched_background(libtock_sched_task_t* task);
+
+// Stop releasing `task` and drop its ready job. Returns true if it was
+// scheduled. A handler that is running is not stopped.
+bool libtock_sched_cancel(libtock_sched_task_t* task);
+
+// Budget left to the running job, or UINT32_MAX if it has none or no job
+// is running. 0 once the budget is used up.
+uint32_t libtock_sched_budget_left_us(void);
+
+// Admitted utilization of periodic tasks, in parts per thousand.
+uint32_t libtock_sched_utilization(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,145 @@
+#include "screen_runs.h"
+
+// The screen callbacks carry no context, so the write is global.
+static struct {
+  bool running;
+  uint16_t x;
+  uint16_t y;
+  uint16_t width;
+  uint16_t height;
+  const uint8_t* pixels;
+  // Next pixel to send.
+  uint16_t row;
+  uint16_t col;
+  // Operation whose frame is being set.
+  bool fill;
+  uint16_t color;
+  const uint8_t* data;
+  size_t len;
+  libtock_screen_runs_callback cb;
+} runs;
+
+// `libtock_screen_fill()` takes the color from the start of an allowed buffer.
+static uint8_t fill_buffer[4];
+
+static uint16_t pixel(uint16_t row, uint16_t col) {
+  const uint8_t* p = runs.pixels + ((size_t) row * runs.width + col) * 2;
+  return (uint16_t) ((p[0] << 8) | p[1]);
+}
+
+// Length of the run of one color starting at `col` in `row`.
+static uint16_t run_length(uint16_t row, uint16_t col) {
+  uint16_t color = pixel(row, col);
+  uint16_t end   = col + 1;
+  while (end < runs.width && pixel(row, end) == color) end++;
+  return end - col;
+}
+
+// Whether `row` has no run long enough for a fill.
+static bool row_is_raw(uint16_t row) {
+  for (uint16_t col = 0; col < runs.width; ) {
+    uint16_t len = run_length(row, col);
+    if (len >= LIBTOCK_SCREEN_RUNS_MIN) return false;
+    col += len;
+  }
+  return true;
+}
+
+static void finish(returncode_t ret) {
+  runs.running = false;
+  runs.cb(ret);
+}
+
+static returncode_t next_op(void);
+
+static void op_done(returncode_t ret) {
+  if (ret == RETURNCODE_SUCCESS) ret = next_op();
+  if (ret != RETURNCODE_SUCCESS) finish(ret);
+}
+
+static void frame_done(returncode_t ret) {
+  if (ret == RETURNCODE_SUCCESS) {
+    if (runs.fill) {
+      ret = libtock_screen_fill(fill_buffer, sizeof(fill_buffer), runs.color, op_done);
+    } else {
+      ret = libtock_screen_write((uint8_t*) runs.data, runs.len, runs.len, op_done);
+    }
+  }
+  if (ret != RETURNCODE_SUCCESS) finish(ret);
+}
+
+// Work out the next run and set its frame. Finishes after the last one.
+static returncode_t next_op(void) {
+  if (runs.row == runs.height) {
+    finish(RETURNCODE_SUCCESS);
+    return RETURNCODE_SUCCESS;
+  }
+
+  uint16_t row = runs.row, col = runs.col;
+  uint16_t len = run_length(row, col);
+  uint16_t frame_width, frame_rows = 1;
+
+  if (col == 0 && len == runs.width) {
+    // Whole rows of one color are a single fill.
+    uint16_t color = pixel(row, 0);
+    while (row + frame_rows < runs.height && pixel(row + frame_rows, 0) == color &&
+           run_length(row + frame_rows, 0) == runs.width) {
+      frame_rows++;
+    }
+    runs.fill   = true;
+    runs.color  = color;
+    frame_width = runs.width;
+  } else if (len >= LIBTOCK_SCREEN_RUNS_MIN) {
+    runs.fill   = true;
+    runs.color  = pixel(row, col);
+    frame_width = len;
+  } else {
+    // Raw pixels up to the next long run or the end of the row.
+    uint16_t end = col + len;
+    while (end < runs.width) {
+      uint16_t next = run_length(row, end);
+      if (next >= LIBTOCK_SCREEN_RUNS_MIN) break;
+      end += next;
+    }
+    frame_width = end - col;
+    // Following rows without long runs are contiguous with a full raw row.
+    if (col == 0 && end == runs.width) {
+      while (row + frame_rows < runs.height && row_is_raw(row + frame_rows)) frame_rows++;
+    }
+    runs.fill = false;
+    runs.data = runs.pixels + ((size_t) row * runs.width + col) * 2;
+    runs.len  = (size_t) frame_width * frame_rows * 2;
+  }
+
+  if (frame_width == runs.width) {
+    runs.row += frame_rows;
+    runs.col  = 0;
+  } else {
+    runs.col += frame_width;
+    if (runs.col == runs.width) {
+      runs.row++;
+      runs.col = 0;
+    }
+  }
+  return libtock_screen_set_frame(runs.x + col, runs.y + row, frame_width, frame_rows, frame_done);
+}
+
+returncode_t libtock_screen_runs_write(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                                       const uint8_t* pixels, libtock_screen_runs_callback cb) {
+  if (runs.running) return RETURNCODE_EBUSY;
+  if (width == 0 || height == 0) return RETURNCODE_EINVAL;
+
+  runs.x       = x;
+  runs.y       = y;
+  runs.width   = width;
+  runs.height  = height;
+  runs.pixels  = pixels;
+  runs.row     = 0;
+  runs.col     = 0;
+  runs.cb      = cb;
+  runs.running = true;
+
+  returncode_t ret = next_op();
+  if (ret != RETURNCODE_SUCCESS) runs.running = false;
+  return ret;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../display/screen.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Run-length screen writes for RGB565 images with large flat areas.
+//
+// The screen driver has no compressed write command, only `write` for raw
+// pixels and `fill` for a frame of one color. This splits an image into
+// runs: rows that are entirely one color become a single fill over all of
+// them, runs of at least `LIBTOCK_SCREEN_RUNS_MIN` pixels of one color in a
+// row become a fill of that span, and everything else is written raw
+// straight from the image. Flat regions then cost one command instead of
+// passing every pixel through the allow buffer.
+//
+// Each run needs its own `set_frame`, so short runs are cheaper to write raw.
+// An image without long runs is written as one raw frame, the same as
+// `libtock_screen_write()`.
+
+// Shortest run in pixels that is sent as a fill.
+#ifndef LIBTOCK_SCREEN_RUNS_MIN
+#define LIBTOCK_SCREEN_RUNS_MIN 32
+#endif
+
+// Function signature for the completion callback.
+//
+// - `arg1` (`returncode_t`): Whether the whole image was written.
+typedef void (*libtock_screen_runs_callback)(returncode_t);
+
+// Write the `width` by `height` RGB565 image `pixels`, stored most
+// significant byte first, to the screen with its top left corner at `x`,`y`.
+// `pixels` must stay unchanged until the callback.
+//
+// Returns RETURNCODE_EBUSY if a write is already running.
+returncode_t libtock_screen_runs_write(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                                       const uint8_t* pixels, libtock_screen_runs_callback cb);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,103 @@
+#include "../sensors/ambient_light.h"
+#include "../sensors/humidity.h"
+#include "../sensors/pressure.h"
+#include "../sensors/temperature.h"
+#include "sensor_cache.h"
+#include "time.h"
+
+// The cached sensors are the first ones of `libtock_sensor_t`.
+#define CACHED_SENSORS (LIBTOCK_SENSOR_AMBIENT_LIGHT + 1)
+
+struct cache_entry {
+  uint32_t max_age_ms;
+  bool valid;
+  uint64_t taken_us;
+  int value;
+  bool converting;
+  uint8_t waiting;
+  libtock_sensor_cache_callback waiters[LIBTOCK_SENSOR_CACHE_WAITERS];
+};
+
+// The sensor callbacks carry no context, so the cache is global.
+static struct cache_entry cache[CACHED_SENSORS];
+
+static void conversion_done(libtock_sensor_t sensor, returncode_t ret, int value) {
+  struct cache_entry* entry = &cache[sensor];
+  entry->converting = false;
+  if (ret == RETURNCODE_SUCCESS) {
+    entry->valid    = true;
+    entry->taken_us = libtock_time_now_us64();
+    entry->value    = value;
+  }
+
+  // Callbacks may read again, so take the waiters out first.
+  uint8_t waiting = entry->waiting;
+  libtock_sensor_cache_callback waiters[LIBTOCK_SENSOR_CACHE_WAITERS];
+  for (uint8_t i = 0; i < waiting; i++) {
+    waiters[i] = entry->waiters[i];
+  }
+  entry->waiting = 0;
+
+  for (uint8_t i = 0; i < waiting; i++) {
+    waiters[i](ret, value);
+  }
+}
+
+static void temperature_done(returncode_t ret, int value) {
+  conversion_done(LIBTOCK_SENSOR_TEMPERATURE, ret, value);
+}
+
+static void humidity_done(returncode_t ret, int value) {
+  conversion_done(LIBTOCK_SENSOR_HUMIDITY, ret, value);
+}
+
+static void pressure_done(returncode_t ret, int value) {
+  conversion_done(LIBTOCK_SENSOR_PRESSURE, ret, value);
+}
+
+static void ambient_light_done(returncode_t ret, int value) {
+  conversion_done(LIBTOCK_SENSOR_AMBIENT_LIGHT, ret, value);
+}
+
+static returncode_t start_conversion(libtock_sensor_t sensor) {
+  switch (sensor) {
+    case LIBTOCK_SENSOR_TEMPERATURE:
+      return libtock_temperature_read(temperature_done);
+    case LIBTOCK_SENSOR_HUMIDITY:
+      return libtock_humidity_read(humidity_done);
+    case LIBTOCK_SENSOR_PRESSURE:
+      return libtock_pressure_read(pressure_done);
+    default:
+      return libtock_ambient_light_read_intensity(ambient_light_done);
+  }
+}
+
+returncode_t libtock_sensor_cache_set_max_age(libtock_sensor_t sensor, uint32_t max_age_ms) {
+  if (sensor >= CACHED_SENSORS) return RETURNCODE_EINVAL;
+  cache[sensor].max_age_ms = max_age_ms;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_sensor_cache_read(libtock_sensor_t sensor, int* value, libtock_sensor_cache_callback cb) {
+  if (sensor >= CACHED_SENSORS) return RETURNCODE_EINVAL;
+  struct cache_entry* entry = &cache[sensor];
+
+  if (entry->valid && !entry->converting &&
+      libtock_time_now_us64() - entry->taken_us <= (uint64_t) entry->max_age_ms * 1000) {
+    *value = entry->value;
+    return RETURNCODE_EALREADY;
+  }
+
+  if (entry->waiting == LIBTOCK_SENSOR_CACHE_WAITERS) return RETURNCODE_EBUSY;
+  if (!entry->converting) {
+    returncode_t ret = start_conversion(sensor);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    entry->converting = true;
+  }
+  entry->waiters[entry->waiting++] = cb;
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_sensor_cache_invalidate(libtock_sensor_t sensor) {
+  if (sensor < CACHED_SENSORS) cache[sensor].valid = false;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../tock.h"
+#include "sensor_sampler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cached reads of the temperature, humidity, pressure and ambient light
+// sensors.
+//
+// A reading is reused for reads that come within the max age of the sensor,
+// and reads that come while a conversion is running wait for it instead of
+// starting another one. Several modules of an app can then read the same
+// sensor without each paying for a conversion.
+//
+// The max age of every sensor starts at 0, which still shares in-flight
+// conversions but never reuses a finished one.
+
+// Number of callbacks that can wait for one sensor's conversion.
+#ifndef LIBTOCK_SENSOR_CACHE_WAITERS
+#define LIBTOCK_SENSOR_CACHE_WAITERS 4
+#endif
+
+// Function signature for cached read callbacks.
+//
+// - `arg1` (`returncode_t`): Status of the conversion.
+// - `arg2` (`int`): The reading, in the units of the sensor driver.
+typedef void (*libtock_sensor_cache_callback)(returncode_t, int);
+
+// Reuse readings of `sensor` for `max_age_ms` after they were taken.
+//
+// Returns RETURNCODE_EINVAL for sensors the cache does not cover.
+returncode_t libtock_sensor_cache_set_max_age(libtock_sensor_t sensor, uint32_t max_age_ms);
+
+// Read `sensor`. If a fresh enough reading is cached, it is put in `*value`
+// and RETURNCODE_EALREADY is returned with no callback. Otherwise `cb` gets
+// the result of the running or a new conversion.
+//
+// Returns RETURNCODE_EBUSY if `LIBTOCK_SENSOR_CACHE_WAITERS` callbacks are
+// already waiting, and RETURNCODE_EINVAL for sensors the cache does not
+// cover.
+returncode_t libtock_sensor_cache_read(libtock_sensor_t sensor, int* value, libtock_sensor_cache_callback cb);
+
+// Forget the cached reading of `sensor`, so the next read converts.
+void libtock_sensor_cache_invalidate(libtock_sensor_t sensor);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,198 @@
+#include "../sensors/ambient_light.h"
+#include "../sensors/humidity.h"
+#include "../sensors/ninedof.h"
+#include "../sensors/pressure.h"
+#include "../sensors/temperature.h"
+#include "sensor_sampler.h"
+#include "time.h"
+
+#define NINEDOF_SENSORS ((1u << LIBTOCK_SENSOR_ACCELEROMETER) | (1u << LIBTOCK_SENSOR_MAGNETOMETER) | \
+                         (1u << LIBTOCK_SENSOR_GYROSCOPE))
+
+// The sensor callbacks carry no context, so the sampler is global.
+static struct {
+  bool running;
+  uint32_t tick_ms;
+  // Period of each sensor, 0 if disabled.
+  uint32_t period_ms[LIBTOCK_SENSOR_COUNT];
+  uint32_t tick;
+  // Sensors still to report for the record being collected.
+  uint32_t pending;
+  // Ninedof sensors not yet started.
+  uint32_t ninedof_queue;
+  uint32_t skipped;
+  libtock_sensor_sample_t sample;
+  libtock_sensor_sampler_callback cb;
+  libtock_alarm_t alarm;
+} sampler;
+
+static void sensor_done(libtock_sensor_t sensor, returncode_t ret);
+
+static void temperature_done(returncode_t ret, int value) {
+  sampler.sample.temperature = value;
+  sensor_done(LIBTOCK_SENSOR_TEMPERATURE, ret);
+}
+
+static void humidity_done(returncode_t ret, int value) {
+  sampler.sample.humidity = value;
+  sensor_done(LIBTOCK_SENSOR_HUMIDITY, ret);
+}
+
+static void pressure_done(returncode_t ret, int value) {
+  sampler.sample.pressure = value;
+  sensor_done(LIBTOCK_SENSOR_PRESSURE, ret);
+}
+
+static void ambient_light_done(returncode_t ret, int value) {
+  sampler.sample.ambient_light = value;
+  sensor_done(LIBTOCK_SENSOR_AMBIENT_LIGHT, ret);
+}
+
+static void store3(int* dest, int x, int y, int z) {
+  dest[0] = x;
+  dest[1] = y;
+  dest[2] = z;
+}
+
+static void accelerometer_done(returncode_t ret, int x, int y, int z) {
+  store3(sampler.sample.accelerometer, x, y, z);
+  sensor_done(LIBTOCK_SENSOR_ACCELEROMETER, ret);
+}
+
+static void magnetometer_done(returncode_t ret, int x, int y, int z) {
+  store3(sampler.sample.magnetometer, x, y, z);
+  sensor_done(LIBTOCK_SENSOR_MAGNETOMETER, ret);
+}
+
+static void gyroscope_done(returncode_t ret, int x, int y, int z) {
+  store3(sampler.sample.gyroscope, x, y, z);
+  sensor_done(LIBTOCK_SENSOR_GYROSCOPE, ret);
+}
+
+static returncode_t start_read(libtock_sensor_t sensor) {
+  switch (sensor) {
+    case LIBTOCK_SENSOR_TEMPERATURE:
+      return libtock_temperature_read(temperature_done);
+    case LIBTOCK_SENSOR_HUMIDITY:
+      return libtock_humidity_read(humidity_done);
+    case LIBTOCK_SENSOR_PRESSURE:
+      return libtock_pressure_read(pressure_done);
+    case LIBTOCK_SENSOR_AMBIENT_LIGHT:
+      return libtock_ambient_light_read_intensity(ambient_light_done);
+    case LIBTOCK_SENSOR_ACCELEROMETER:
+      return libtock_ninedof_read_accelerometer(accelerometer_done);
+    case LIBTOCK_SENSOR_MAGNETOMETER:
+      return libtock_ninedof_read_magnetometer(magnetometer_done);
+    case LIBTOCK_SENSOR_GYROSCOPE:
+      return libtock_ninedof_read_gyroscope(gyroscope_done);
+    default:
+      return RETURNCODE_EINVAL;
+  }
+}
+
+// Start `sensor`, or record it as failed if it cannot be started.
+static void start_sensor(libtock_sensor_t sensor) {
+  if (start_read(sensor) != RETURNCODE_SUCCESS) {
+    sampler.pending       &= ~(1u << sensor);
+    sampler.sample.failed |= 1u << sensor;
+  }
+}
+
+// Start the next queued ninedof sensor, one at a time.
+static void start_ninedof(void) {
+  while (sampler.ninedof_queue != 0) {
+    libtock_sensor_t sensor = LIBTOCK_SENSOR_ACCELEROMETER;
+    while ((sampler.ninedof_queue & (1u << sensor)) == 0) sensor++;
+    sampler.ninedof_queue &= ~(1u << sensor);
+
+    start_sensor(sensor);
+    if (sampler.pending & (1u << sensor)) return;
+  }
+}
+
+static void deliver_if_complete(void) {
+  if (sampler.pending != 0 || !sampler.running) return;
+  sampler.cb(&sampler.sample);
+}
+
+static void sensor_done(libtock_sensor_t sensor, returncode_t ret) {
+  uint32_t bit = 1u << sensor;
+  // A late reading from a stopped sampler.
+  if ((sampler.pending & bit) == 0) return;
+
+  sampler.pending &= ~bit;
+  if (ret == RETURNCODE_SUCCESS) {
+    sampler.sample.valid |= bit;
+  } else {
+    sampler.sample.failed |= bit;
+  }
+
+  if (bit & NINEDOF_SENSORS) start_ninedof();
+  deliver_if_complete();
+}
+
+static void tick_fired(__attribute__ ((unused)) uint32_t now,
+                       __attribute__ ((unused)) uint32_t scheduled,
+                       __attribute__ ((unused)) void*    opaque) {
+  if (sampler.pending != 0) {
+    sampler.skipped++;
+    return;
+  }
+
+  uint32_t due = 0;
+  for (int i = 0; i < LIBTOCK_SENSOR_COUNT; i++) {
+    if (sampler.period_ms[i] == 0) continue;
+    uint32_t period = sampler.period_ms[i] / sampler.tick_ms;
+    if (period == 0 || sampler.tick % period == 0) due |= 1u << i;
+  }
+  sampler.tick++;
+  if (due == 0) return;
+
+  sampler.sample.us     = libtock_time_now_us64();
+  sampler.sample.valid  = 0;
+  sampler.sample.failed = 0;
+  sampler.pending       = due;
+  sampler.ninedof_queue = due & NINEDOF_SENSORS;
+
+  for (int i = 0; i < LIBTOCK_SENSOR_COUNT; i++) {
+    uint32_t bit = 1u << i;
+    if ((due & bit) && !(bit & NINEDOF_SENSORS)) start_sensor((libtock_sensor_t) i);
+  }
+  start_ninedof();
+  deliver_if_complete();
+}
+
+returncode_t libtock_sensor_sampler_enable(libtock_sensor_t sensor, uint32_t period_ms) {
+  if (sensor >= LIBTOCK_SENSOR_COUNT) return RETURNCODE_EINVAL;
+  sampler.period_ms[sensor] = period_ms;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_sensor_sampler_start(uint32_t tick_ms, uint32_t slack_ms, libtock_sensor_sampler_callback cb) {
+  if (tick_ms == 0) return RETURNCODE_EINVAL;
+  if (sampler.running) libtock_alarm_ms_cancel(&sampler.alarm);
+
+  sampler.running       = true;
+  sampler.tick_ms       = tick_ms;
+  sampler.tick          = 0;
+  sampler.pending       = 0;
+  sampler.ninedof_queue = 0;
+  sampler.skipped       = 0;
+  sampler.cb            = cb;
+
+  libtock_alarm_repeating_every_ms_with_slack(tick_ms, slack_ms, tick_fired, NULL, &sampler.alarm);
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_sensor_sampler_stop(void) {
+  if (!sampler.running) return;
+  sampler.running = false;
+  libtock_alarm_ms_cancel(&sampler.alarm);
+  // Readings still in flight are ignored by `sensor_done()`.
+  sampler.pending       = 0;
+  sampler.ninedof_queue = 0;
+}
+
+uint32_t libtock_sensor_sampler_skipped(void) {
+  return sampler.skipped;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../tock.h"
+#include "alarm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Periodic sampling of the common sensor drivers on a shared tick.
+//
+// Each enabled sensor has a period that is a whole number of ticks. On every
+// tick the sensors that are due are all started at once, as they are
+// independent drivers, and the results are collected into one record that is
+// delivered when the last reading is in. The accelerometer, magnetometer and
+// gyroscope share the ninedof driver, so those are read one after another.
+//
+// The tick alarm is set with slack, so it can share wakeups with other
+// alarms. A tick that comes while the previous record is still being
+// collected is skipped and counted by `libtock_sensor_sampler_skipped()`.
+
+typedef enum {
+  LIBTOCK_SENSOR_TEMPERATURE,
+  LIBTOCK_SENSOR_HUMIDITY,
+  LIBTOCK_SENSOR_PRESSURE,
+  LIBTOCK_SENSOR_AMBIENT_LIGHT,
+  LIBTOCK_SENSOR_ACCELEROMETER,
+  LIBTOCK_SENSOR_MAGNETOMETER,
+  LIBTOCK_SENSOR_GYROSCOPE,
+  LIBTOCK_SENSOR_COUNT,
+} libtock_sensor_t;
+
+typedef struct {
+  // Time of the tick from `libtock_time_now_us64()`.
+  uint64_t us;
+  // Bit `1 << sensor` is set for each sensor read in this record.
+  uint32_t valid;
+  // Bit `1 << sensor` is set for each due sensor whose read failed.
+  uint32_t failed;
+  // Units are those of the sensor drivers.
+  int temperature;
+  int humidity;
+  int pressure;
+  int ambient_light;
+  int accelerometer[3];
+  int magnetometer[3];
+  int gyroscope[3];
+} libtock_sensor_sample_t;
+
+// Function signature for sample callbacks. The record is only valid during
+// the callback.
+typedef void (*libtock_sensor_sampler_callback)(const libtock_sensor_sample_t*);
+
+// Read `sensor` every `period_ms`, rounded down to whole ticks and at least
+// one tick. A period of 0 disables the sensor. Takes effect on the next tick.
+returncode_t libtock_sensor_sampler_enable(libtock_sensor_t sensor, uint32_t period_ms);
+
+// Start ticking every `tick_ms`, up to `slack_ms` late, and call `cb` with
+// each record.
+//
+// Returns RETURNCODE_EINVAL if `tick_ms` is 0.
+returncode_t libtock_sensor_sampler_start(uint32_t tick_ms, uint32_t slack_ms, libtock_sensor_sampler_callback cb);
+
+// Stop ticking. A record being collected is not delivered.
+void libtock_sensor_sampler_stop(void);
+
+// Number of ticks skipped because the previous record was not complete.
+uint32_t libtock_sensor_sampler_skipped(void);
+
+#ifdef __cplusplus
+}
+#endif
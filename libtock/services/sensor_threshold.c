@@ -0,0 +1,262 @@
+#include <stdlib.h>
+
+#include "../sensors/proximity.h"
+#include "alarm.h"
+#include "sensor_cache.h"
+#include "sensor_threshold.h"
+#include "time.h"
+
+// The polled sensors are the cached ones, the first of `libtock_sensor_t`.
+#define POLLED_SENSORS (LIBTOCK_SENSOR_AMBIENT_LIGHT + 1)
+
+// Largest proximity reading.
+#define PROXIMITY_MAX 255
+
+typedef struct {
+  libtock_sensor_threshold_t threshold;
+  libtock_sensor_threshold_callback cb;
+  libtock_sensor_threshold_state_t state;
+  bool active;
+  bool reading;
+  // Previous reading, to estimate how fast the reading moves.
+  bool have_last;
+  int last;
+  uint32_t last_ms;
+  uint32_t period_ms;
+  uint32_t reads;
+  libtock_alarm_t alarm;
+} watch_t;
+
+// The sensor callbacks carry no context, so the watches are global.
+static watch_t watches[POLLED_SENSORS];
+static watch_t proximity;
+
+static uint32_t now_ms(void) {
+  return (uint32_t) (libtock_time_now_us64() / 1000);
+}
+
+static bool valid(const libtock_sensor_threshold_t* t, bool polled) {
+  if (t == NULL || t->low > t->high || t->hysteresis < 0) return false;
+  return !polled || (t->min_period_ms > 0 && t->min_period_ms <= t->max_period_ms);
+}
+
+// Where `value` is, given where the reading was.
+static libtock_sensor_threshold_state_t classify(const watch_t* w, int value) {
+  const libtock_sensor_threshold_t* t = &w->threshold;
+  if (w->state == LIBTOCK_SENSOR_THRESHOLD_ABOVE && value > t->high - t->hysteresis) {
+    return LIBTOCK_SENSOR_THRESHOLD_ABOVE;
+  }
+  if (w->state == LIBTOCK_SENSOR_THRESHOLD_BELOW && value < t->low + t->hysteresis) {
+    return LIBTOCK_SENSOR_THRESHOLD_BELOW;
+  }
+  if (value > t->high) return LIBTOCK_SENSOR_THRESHOLD_ABOVE;
+  if (value < t->low) return LIBTOCK_SENSOR_THRESHOLD_BELOW;
+  return LIBTOCK_SENSOR_THRESHOLD_INSIDE;
+}
+
+// How far the reading must move from `value` to change state.
+static int64_t distance(const watch_t* w, int value) {
+  const libtock_sensor_threshold_t* t = &w->threshold;
+  switch (w->state) {
+    case LIBTOCK_SENSOR_THRESHOLD_ABOVE:
+      return (int64_t) value - (t->high - t->hysteresis);
+    case LIBTOCK_SENSOR_THRESHOLD_BELOW:
+      return (int64_t) t->low + t->hysteresis - value;
+    default: {
+      int64_t up   = (int64_t) t->high - value + 1;
+      int64_t down = (int64_t) value - t->low + 1;
+      return up < down ? up : down;
+    }
+  }
+}
+
+// Poll at half the time the reading would take to change state if it kept
+// moving as it did since the previous read.
+static uint32_t next_period(const watch_t* w, int value, uint32_t now) {
+  const libtock_sensor_threshold_t* t = &w->threshold;
+  uint64_t period;
+  if (!w->have_last) {
+    period = t->min_period_ms;
+  } else if (value == w->last) {
+    period = (uint64_t) w->period_ms * 2;
+  } else {
+    uint64_t change = (uint64_t) llabs((int64_t) value - w->last);
+    period = (uint64_t) distance(w, value) * (now - w->last_ms) / change / 2;
+  }
+
+  if (period < t->min_period_ms) return t->min_period_ms;
+  if (period > t->max_period_ms) return t->max_period_ms;
+  return (uint32_t) period;
+}
+
+static void poll_fired(uint32_t now, uint32_t scheduled, void* opaque);
+
+static void schedule_poll(watch_t* w, uint32_t period_ms) {
+  w->period_ms = period_ms;
+  libtock_alarm_in_ms(period_ms, poll_fired, w, &w->alarm);
+}
+
+static void read_done(libtock_sensor_t sensor, returncode_t ret, int value) {
+  watch_t* w = &watches[sensor];
+  w->reading = false;
+  if (!w->active) return;
+
+  if (ret != RETURNCODE_SUCCESS) {
+    w->cb(ret, w->state, w->last);
+    schedule_poll(w, w->threshold.max_period_ms);
+    return;
+  }
+
+  w->reads++;
+  uint32_t now = now_ms();
+  libtock_sensor_threshold_state_t state = classify(w, value);
+  bool changed = state != w->state;
+  w->state = state;
+
+  uint32_t period = next_period(w, value, now);
+  w->have_last = true;
+  w->last      = value;
+  w->last_ms   = now;
+  schedule_poll(w, period);
+
+  // Last, as the callback may change the watch.
+  if (changed) w->cb(RETURNCODE_SUCCESS, state, value);
+}
+
+static void temperature_done(returncode_t ret, int value) {
+  read_done(LIBTOCK_SENSOR_TEMPERATURE, ret, value);
+}
+
+static void humidity_done(returncode_t ret, int value) {
+  read_done(LIBTOCK_SENSOR_HUMIDITY, ret, value);
+}
+
+static void pressure_done(returncode_t ret, int value) {
+  read_done(LIBTOCK_SENSOR_PRESSURE, ret, value);
+}
+
+static void ambient_light_done(returncode_t ret, int value) {
+  read_done(LIBTOCK_SENSOR_AMBIENT_LIGHT, ret, value);
+}
+
+static const libtock_sensor_cache_callback read_callbacks[] = {
+  [LIBTOCK_SENSOR_TEMPERATURE]   = temperature_done,
+  [LIBTOCK_SENSOR_HUMIDITY]      = humidity_done,
+  [LIBTOCK_SENSOR_PRESSURE]      = pressure_done,
+  [LIBTOCK_SENSOR_AMBIENT_LIGHT] = ambient_light_done,
+};
+
+static void start_read(libtock_sensor_t sensor) {
+  watch_t* w = &watches[sensor];
+  if (w->reading) return;
+
+  int value;
+  returncode_t ret = libtock_sensor_cache_read(sensor, &value, read_callbacks[sensor]);
+  if (ret == RETURNCODE_EALREADY) {
+    read_done(sensor, RETURNCODE_SUCCESS, value);
+  } else if (ret == RETURNCODE_SUCCESS) {
+    w->reading = true;
+  } else {
+    read_done(sensor, ret, 0);
+  }
+}
+
+static void poll_fired(__attribute__ ((unused)) uint32_t now,
+                       __attribute__ ((unused)) uint32_t scheduled,
+                       void*                             opaque) {
+  watch_t* w = (watch_t*) opaque;
+  start_read((libtock_sensor_t) (w - watches));
+}
+
+returncode_t libtock_sensor_threshold_watch(libtock_sensor_t sensor, const libtock_sensor_threshold_t* threshold,
+                                            libtock_sensor_threshold_callback cb) {
+  if (sensor >= POLLED_SENSORS || cb == NULL || !valid(threshold, true)) return RETURNCODE_EINVAL;
+
+  watch_t* w = &watches[sensor];
+  libtock_alarm_ms_cancel(&w->alarm);
+  w->threshold = *threshold;
+  w->cb        = cb;
+  w->state     = LIBTOCK_SENSOR_THRESHOLD_INSIDE;
+  w->have_last = false;
+  w->period_ms = threshold->min_period_ms;
+  w->reads     = 0;
+  w->active    = true;
+
+  // A read already in progress counts as the first one.
+  start_read(sensor);
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_sensor_threshold_unwatch(libtock_sensor_t sensor) {
+  if (sensor >= POLLED_SENSORS) return;
+  watches[sensor].active = false;
+  libtock_alarm_ms_cancel(&watches[sensor].alarm);
+}
+
+uint32_t libtock_sensor_threshold_reads(libtock_sensor_t sensor) {
+  if (sensor >= POLLED_SENSORS) return 0;
+  return watches[sensor].reads;
+}
+
+static uint32_t clamp_proximity(int64_t value) {
+  if (value < 0) return 0;
+  if (value > PROXIMITY_MAX) return PROXIMITY_MAX;
+  return (uint32_t) value;
+}
+
+static void proximity_done(returncode_t ret, uint8_t value);
+
+// Ask the driver to interrupt when the reading leaves the window its state
+// allows.
+static returncode_t arm_proximity(void) {
+  const libtock_sensor_threshold_t* t = &proximity.threshold;
+  int64_t lower, upper;
+  switch (proximity.state) {
+    case LIBTOCK_SENSOR_THRESHOLD_ABOVE:
+      lower = (int64_t) t->high - t->hysteresis + 1;
+      upper = PROXIMITY_MAX;
+      break;
+    case LIBTOCK_SENSOR_THRESHOLD_BELOW:
+      lower = 0;
+      upper = (int64_t) t->low + t->hysteresis - 1;
+      break;
+    default:
+      lower = t->low;
+      upper = t->high;
+      break;
+  }
+  return libtock_proximity_read_on_interrupt(clamp_proximity(lower), clamp_proximity(upper), proximity_done);
+}
+
+static void proximity_done(returncode_t ret, uint8_t value) {
+  if (!proximity.active) return;
+
+  libtock_sensor_threshold_state_t state = classify(&proximity, value);
+  bool changed = state != proximity.state;
+  proximity.state = state;
+
+  returncode_t err = arm_proximity();
+  if (err != RETURNCODE_SUCCESS) {
+    proximity.active = false;
+    ret = err;
+  }
+  if (changed || ret != RETURNCODE_SUCCESS) proximity.cb(ret, state, value);
+}
+
+returncode_t libtock_sensor_threshold_watch_proximity(const libtock_sensor_threshold_t* threshold,
+                                                      libtock_sensor_threshold_callback cb) {
+  if (cb == NULL || !valid(threshold, false)) return RETURNCODE_EINVAL;
+
+  proximity.threshold = *threshold;
+  proximity.cb        = cb;
+  proximity.state     = LIBTOCK_SENSOR_THRESHOLD_INSIDE;
+  proximity.active    = true;
+
+  returncode_t ret = arm_proximity();
+  if (ret != RETURNCODE_SUCCESS) proximity.active = false;
+  return ret;
+}
+
+void libtock_sensor_threshold_unwatch_proximity(void) {
+  proximity.active = false;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../tock.h"
+#include "sensor_sampler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Notifications when a sensor reading leaves or re-enters a window.
+//
+// A watch reports when the reading of a sensor goes above `high` or below
+// `low`, and when it comes back. To keep a noisy reading near a threshold
+// from reporting on every read, it only comes back once it is `hysteresis`
+// inside the window.
+//
+// The proximity driver checks thresholds itself and interrupts, so its watch
+// makes no reads while nothing changes. The temperature, humidity, pressure
+// and ambient light drivers have no thresholds, so their watches poll, through
+// `sensor_cache` so other readers of the sensor share the conversions. Polls
+// adapt to the reading: from the change since the previous read the watch
+// estimates when the reading could reach the next threshold and polls at half
+// that, between `min_period_ms` and `max_period_ms`. A steady reading far from
+// the thresholds is read every `max_period_ms`.
+
+typedef enum {
+  LIBTOCK_SENSOR_THRESHOLD_INSIDE,
+  LIBTOCK_SENSOR_THRESHOLD_BELOW,
+  LIBTOCK_SENSOR_THRESHOLD_ABOVE,
+} libtock_sensor_threshold_state_t;
+
+// Function signature for threshold callbacks.
+//
+// - `arg1` (`returncode_t`): Status of the read. On errors the state is
+//   unchanged and polling continues.
+// - `arg2` (`libtock_sensor_threshold_state_t`): Where the reading is now.
+// - `arg3` (`int`): The reading, in the units of the sensor driver.
+typedef void (*libtock_sensor_threshold_callback)(returncode_t, libtock_sensor_threshold_state_t, int);
+
+typedef struct {
+  int low;
+  int high;
+  int hysteresis;
+  uint32_t min_period_ms;
+  uint32_t max_period_ms;
+} libtock_sensor_threshold_t;
+
+// Watch `sensor`, one of temperature, humidity, pressure and ambient light,
+// replacing any watch of it. The reading starts out inside, so `cb` is called
+// after the first read if it is not.
+//
+// Returns RETURNCODE_EINVAL for other sensors, if `low` is above `high`, the
+// hysteresis is negative, or the periods are 0 or out of order.
+returncode_t libtock_sensor_threshold_watch(libtock_sensor_t sensor, const libtock_sensor_threshold_t* threshold,
+                                            libtock_sensor_threshold_callback cb);
+
+// Stop watching `sensor`. A read in progress is not reported.
+void libtock_sensor_threshold_unwatch(libtock_sensor_t sensor);
+
+// Watch the proximity sensor, with its interrupt. The periods are unused.
+returncode_t libtock_sensor_threshold_watch_proximity(const libtock_sensor_threshold_t* threshold,
+                                                      libtock_sensor_threshold_callback cb);
+
+// Stop watching the proximity sensor. The driver's last interrupt request
+// stays armed, but its upcall is ignored.
+void libtock_sensor_threshold_unwatch_proximity(void);
+
+// Number of reads the polled watch of `sensor` has made.
+uint32_t libtock_sensor_threshold_reads(libtock_sensor_t sensor);
+
+#ifdef __cplusplus
+}
+#endif
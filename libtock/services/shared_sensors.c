@@ -0,0 +1,26 @@
+#include "shared_sensors.h"
+
+// An app talks to the one sensor service, so the subscription is global.
+static struct {
+  ipc_pubsub_subscriber_t sub;
+  libtock_shared_sensors_callback cb;
+  void* opaque;
+} shared;
+
+static void new_record(__attribute__ ((unused)) uint32_t seq, __attribute__ ((unused)) void* ud) {
+  if (shared.cb) shared.cb(shared.opaque);
+}
+
+returncode_t libtock_shared_sensors_subscribe(libtock_shared_sensors_callback cb, void* opaque) {
+  shared.cb     = cb;
+  shared.opaque = opaque;
+  return ipc_pubsub_subscribe(&shared.sub, LIBTOCK_SHARED_SENSORS_SERVICE, new_record, NULL);
+}
+
+returncode_t libtock_shared_sensors_read(libtock_sensor_sample_t* sample) {
+  int ret = ipc_pubsub_read(&shared.sub, sample, sizeof(*sample), NULL);
+  if (ret < 0) return ret;
+  // A record of another size comes from a service built with another layout.
+  if (ret != (int) sizeof(*sample)) return RETURNCODE_ESIZE;
+  return RETURNCODE_SUCCESS;
+}
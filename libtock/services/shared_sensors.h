@@ -0,0 +1,40 @@
+#pragma once
+
+#include "../kernel/ipc_pubsub.h"
+#include "../tock.h"
+#include "sensor_sampler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Client of the shared sensor service.
+//
+// When several apps read the same sensors, the kernel serializes their
+// conversions and every app waits for the others. The service in
+// `examples/services/sensor_service` instead owns the sensors, samples them
+// once per period and publishes each record with `ipc_pubsub`. Clients read
+// the latest record straight from shared memory, with no syscall, and can ask
+// to be notified of each new one.
+
+// Package name of the sensor service.
+#define LIBTOCK_SHARED_SENSORS_SERVICE "org.tockos.services.sensors"
+
+// Function signature for new record notifications.
+//
+// - `arg1` (`void*`): The opaque pointer passed to
+//   `libtock_shared_sensors_subscribe()`.
+typedef void (*libtock_shared_sensors_callback)(void*);
+
+// Connect to the sensor service. `cb`, if not NULL, is called whenever a new
+// record is published.
+returncode_t libtock_shared_sensors_subscribe(libtock_shared_sensors_callback cb, void* opaque);
+
+// Copy the latest record into `sample`.
+//
+// Returns RETURNCODE_EOFF if the service has not published a record yet.
+returncode_t libtock_shared_sensors_read(libtock_sensor_sample_t* sample);
+
+#ifdef __cplusplus
+}
+#endif
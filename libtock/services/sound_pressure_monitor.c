@@ -0,0 +1,119 @@
+#include "../sensors/syscalls/sound_pressure_syscalls.h"
+#include "sound_pressure_monitor.h"
+
+static void schedule_next(libtock_sound_pressure_monitor_t* monitor);
+
+static void reset_window(libtock_sound_pressure_monitor_t* monitor) {
+  monitor->deadlines       = 0;
+  monitor->sum             = 0;
+  monitor->current.min     = UINT8_MAX;
+  monitor->current.max     = 0;
+  monitor->current.avg     = 0;
+  monitor->current.samples = 0;
+  monitor->current.skipped = 0;
+}
+
+// Count a deadline and report the window once it is full.
+static void deadline_passed(libtock_sound_pressure_monitor_t* monitor) {
+  monitor->deadlines++;
+  if (monitor->deadlines < monitor->window) return;
+
+  libtock_sound_pressure_window_t window = monitor->current;
+  if (window.samples == 0) {
+    window.min = 0;
+  } else {
+    window.avg = (uint8_t) (monitor->sum / window.samples);
+  }
+  reset_window(monitor);
+  monitor->cb(&window, monitor->opaque);
+}
+
+static void sound_pressure_upcall(int                          sound_pressure,
+                                  __attribute__ ((unused)) int unused,
+                                  __attribute__ ((unused)) int unused1,
+                                  void*                        opaque) {
+  libtock_sound_pressure_monitor_t* monitor = (libtock_sound_pressure_monitor_t*) opaque;
+  monitor->reading = false;
+  if (!monitor->running) return;
+
+  uint8_t db = (uint8_t) sound_pressure;
+  if (db < monitor->current.min) monitor->current.min = db;
+  if (db > monitor->current.max) monitor->current.max = db;
+  monitor->sum += db;
+  monitor->current.samples++;
+  deadline_passed(monitor);
+}
+
+static void sample_due(uint32_t now, uint32_t scheduled, void* opaque) {
+  libtock_sound_pressure_monitor_t* monitor = (libtock_sound_pressure_monitor_t*) opaque;
+  if (!monitor->running) return;
+
+  if (now - scheduled > monitor->step) {
+    // Restart the schedule from here rather than catching up in a burst.
+    monitor->deadline = now;
+  }
+  schedule_next(monitor);
+
+  if (monitor->reading) {
+    monitor->current.skipped++;
+    deadline_passed(monitor);
+    return;
+  }
+  if (libtock_sound_pressure_command_read() == RETURNCODE_SUCCESS) {
+    monitor->reading = true;
+  } else {
+    deadline_passed(monitor);
+  }
+}
+
+static void schedule_next(libtock_sound_pressure_monitor_t* monitor) {
+  uint32_t step = monitor->step;
+  monitor->frac += monitor->step_frac;
+  if (monitor->frac >= monitor->frequency) {
+    monitor->frac -= monitor->frequency;
+    step++;
+  }
+
+  uint32_t reference = monitor->deadline;
+  monitor->deadline += step;
+  libtock_alarm_at(reference, step, sample_due, monitor, &monitor->alarm);
+}
+
+returncode_t libtock_sound_pressure_monitor_start(libtock_sound_pressure_monitor_t* monitor, uint32_t frequency,
+                                                  uint32_t window, libtock_sound_pressure_monitor_callback cb,
+                                                  void* opaque) {
+  uint32_t ticks;
+  returncode_t ret = libtock_alarm_get_frequency(&ticks);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (frequency == 0 || frequency > ticks || window == 0) return RETURNCODE_EINVAL;
+
+  ret = libtock_sound_pressure_set_upcall(sound_pressure_upcall, monitor);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtock_sound_pressure_command_enable();
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  uint32_t now;
+  ret = libtock_alarm_command_read(&now);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  monitor->window    = window;
+  monitor->frequency = frequency;
+  monitor->step      = ticks / frequency;
+  monitor->step_frac = ticks % frequency;
+  monitor->frac      = 0;
+  monitor->deadline  = now;
+  monitor->running   = true;
+  monitor->reading   = false;
+  monitor->cb        = cb;
+  monitor->opaque    = opaque;
+  reset_window(monitor);
+
+  schedule_next(monitor);
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_sound_pressure_monitor_stop(libtock_sound_pressure_monitor_t* monitor) {
+  monitor->running = false;
+  libtock_alarm_cancel(&monitor->alarm);
+  libtock_sound_pressure_command_disable();
+}
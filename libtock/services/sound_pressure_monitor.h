@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../tock.h"
+#include "alarm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Windowed sound pressure monitoring.
+//
+// The sound pressure driver returns one reading per command, so the monitor
+// reads it from the alarm at a fixed rate and keeps the minimum, maximum and
+// average of each window of readings. The app is only called once per window,
+// with the summary, instead of once per reading.
+//
+// Readings are started at absolute deadlines derived from the rate, as in
+// `ninedof_stream.h`. A deadline that comes while the previous reading is
+// still running is skipped and counted in the window summary.
+
+// Summary of one window.
+typedef struct {
+  // Quietest and loudest reading in dB.
+  uint8_t min;
+  uint8_t max;
+  // Arithmetic mean of the readings in dB, rounded down.
+  uint8_t avg;
+  // Readings in the window. Failed readings are not counted.
+  uint32_t samples;
+  // Deadlines skipped during the window because a reading was still running.
+  uint32_t skipped;
+} libtock_sound_pressure_window_t;
+
+// Function signature for the window callback.
+//
+// - `arg1` (`const libtock_sound_pressure_window_t*`): The window that just
+//   ended.
+// - `arg2` (`void*`): The opaque pointer passed to
+//   `libtock_sound_pressure_monitor_start()`.
+typedef void (*libtock_sound_pressure_monitor_callback)(const libtock_sound_pressure_window_t*, void*);
+
+typedef struct {
+  uint32_t window;
+  uint32_t deadlines;
+  uint32_t sum;
+  libtock_sound_pressure_window_t current;
+  // Ticks per reading, `step` plus `step_frac / frequency`.
+  uint32_t frequency;
+  uint32_t step;
+  uint32_t step_frac;
+  uint32_t frac;
+  uint32_t deadline;
+  bool running;
+  bool reading;
+  libtock_sound_pressure_monitor_callback cb;
+  void* opaque;
+  libtock_alarm_ticks_t alarm;
+} libtock_sound_pressure_monitor_t;
+
+// Enable the sensor and read it `frequency` times per second, calling `cb`
+// after every `window` deadlines. There is only one sound pressure sensor, so
+// only one monitor can run at a time, and `libtock_sound_pressure_read()`
+// must not be used while it does.
+//
+// Returns RETURNCODE_EINVAL if `frequency` is 0 or above the alarm frequency,
+// or `window` is 0.
+returncode_t libtock_sound_pressure_monitor_start(libtock_sound_pressure_monitor_t* monitor, uint32_t frequency,
+                                                  uint32_t window, libtock_sound_pressure_monitor_callback cb,
+                                                  void* opaque);
+
+// Stop reading and disable the sensor. The current window is discarded.
+void libtock_sound_pressure_monitor_stop(libtock_sound_pressure_monitor_t* monitor);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,80 @@
+#include "stdout_buffer.h"
+#include "ringbuf.h"
+#include "../interface/console.h"
+
+typedef struct {
+  bool enabled;
+  libtock_ringbuf_t ring;
+  // Bytes handed to the console and not yet completed.
+  uint32_t in_flight;
+  uint32_t dropped;
+} stdout_buffer_t;
+
+static stdout_buffer_t out;
+
+static void start_write(void);
+
+static void write_done(returncode_t ret, uint32_t length) {
+  if (ret != RETURNCODE_SUCCESS || length > out.in_flight) {
+    // Do not retry, just drop the chunk.
+    out.dropped += out.in_flight;
+    length       = out.in_flight;
+  }
+  libtock_ringbuf_release(&out.ring, length);
+  out.in_flight = 0;
+  start_write();
+}
+
+// Hand the next contiguous run of buffered bytes to the console, straight
+// from the ring.
+static void start_write(void) {
+  if (out.in_flight != 0) return;
+
+  uint32_t len;
+  uint8_t* span = libtock_ringbuf_read_span(&out.ring, &len);
+  if (span == NULL) return;
+
+  out.in_flight = len;
+  if (libtock_console_write(span, len, write_done) != RETURNCODE_SUCCESS) {
+    out.in_flight = 0;
+    out.dropped  += len;
+    libtock_ringbuf_release(&out.ring, len);
+  }
+}
+
+returncode_t libtock_stdout_buffer_enable(uint8_t* buffer, uint32_t len) {
+  if (out.enabled) return RETURNCODE_EBUSY;
+
+  returncode_t ret = libtock_ringbuf_init(&out.ring, buffer, len);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  out.enabled   = true;
+  out.in_flight = 0;
+  out.dropped   = 0;
+  return RETURNCODE_SUCCESS;
+}
+
+bool libtock_stdout_buffer_enabled(void) {
+  return out.enabled;
+}
+
+uint32_t libtock_stdout_buffer_space(void) {
+  if (!out.enabled) return 0;
+  return libtock_ringbuf_space(&out.ring);
+}
+
+uint32_t libtock_stdout_buffer_write(const uint8_t* data, uint32_t len) {
+  if (!out.enabled) return 0;
+
+  len = libtock_ringbuf_write(&out.ring, data, len);
+  if (len > 0) start_write();
+  return len;
+}
+
+bool libtock_stdout_buffer_empty(void) {
+  return libtock_ringbuf_empty(&out.ring);
+}
+
+uint32_t libtock_stdout_buffer_dropped(void) {
+  return out.dropped;
+}
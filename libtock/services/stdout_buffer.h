@@ -0,0 +1,57 @@
+/*
+ * Buffered, asynchronous stdout.
+ *
+ * Once enabled, `printf()` and everything else that ends up in `_write()`
+ * copies its output into a ring buffer and returns immediately. The buffer is
+ * drained to the console in the background by chained `libtock_console_write`
+ * calls, so a debug print no longer blocks until the UART has sent it.
+ *
+ * Use `libtocksync_stdout_buffer_enable()` from
+ * `libtock-sync/services/stdout_buffer.h` to turn buffering on and
+ * `libtocksync_stdout_buffer_flush()` as a barrier that waits until all
+ * buffered output has been written. Pending output is also flushed when the
+ * process exits.
+ *
+ * While the buffer is draining, the console write operation is in use, so
+ * calling `libtock_console_write` or `libtocksync_console_write` directly
+ * returns RETURNCODE_EBUSY.
+ *
+ * This module never blocks. When the buffer is full, `_write()` waits for
+ * space in libtock-sync.
+ */
+
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Start buffering stdout in `buffer`, which must remain valid while buffering
+// is enabled. `len` sets the buffer size and must be a power of two.
+//
+// Returns RETURNCODE_EINVAL if `len` is not a power of two and
+// RETURNCODE_EBUSY if buffering is already enabled.
+returncode_t libtock_stdout_buffer_enable(uint8_t* buffer, uint32_t len);
+
+// True if buffering is enabled.
+bool libtock_stdout_buffer_enabled(void);
+
+// Copy as much of `data` into the buffer as fits and start draining it.
+// Returns the number of bytes copied, which is less than `len` if the buffer
+// is full.
+uint32_t libtock_stdout_buffer_write(const uint8_t* data, uint32_t len);
+
+// Number of bytes that can be written without the buffer filling up.
+uint32_t libtock_stdout_buffer_space(void);
+
+// True once every buffered byte has been written to the console.
+bool libtock_stdout_buffer_empty(void);
+
+// Number of bytes dropped because writing to the console failed.
+uint32_t libtock_stdout_buffer_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,204 @@
+#include "cbor.h"
+#include "pool.h"
+#include "telemetry.h"
+#include "udp_batch.h"
+
+// Datagrams start with an array head with a one byte count, which is filled
+// in when the datagram is closed.
+#define HEADER_LEN 2
+#define ARRAY_1_BYTE_COUNT 0x98
+
+typedef struct {
+  uint8_t* buf;
+  size_t len;
+  uint8_t records;
+} datagram_t;
+
+// The sampler and UDP callbacks carry no context, so the pipeline is global.
+static struct {
+  bool running;
+  libtock_telemetry_config_t config;
+  libtock_pool_t pool;
+  size_t buffer_size;
+  // Datagram being filled, with no buffer if `open.buf` is NULL.
+  datagram_t open;
+  // Closed datagrams waiting to be sent, oldest first.
+  datagram_t queue[LIBTOCK_TELEMETRY_MAX_BUFFERS];
+  int queued;
+  // Datagrams of the batch being sent, the first `sending` of `queue`.
+  libtock_udp_datagram_t batch[LIBTOCK_TELEMETRY_MAX_BUFFERS];
+  int sending;
+  bool flushing;
+  libtock_telemetry_stats_t stats;
+} pipeline;
+
+static void batch_done(returncode_t ret, int sent);
+
+static void try_send(void) {
+  if (pipeline.sending > 0 || pipeline.queued == 0) return;
+  if (!pipeline.flushing && pipeline.queued < pipeline.config.datagrams_per_batch) return;
+
+  int count = pipeline.queued;
+  for (int i = 0; i < count; i++) {
+    pipeline.batch[i].buf = pipeline.queue[i].buf;
+    pipeline.batch[i].len = pipeline.queue[i].len;
+    pipeline.batch[i].dst = pipeline.config.dst;
+  }
+  if (libtock_udp_send_batch(pipeline.batch, count, batch_done) == RETURNCODE_SUCCESS) {
+    pipeline.sending  = count;
+    pipeline.flushing = false;
+  }
+}
+
+static void batch_done(__attribute__ ((unused)) returncode_t ret, int sent) {
+  int count = pipeline.sending;
+  pipeline.stats.datagrams_sent += sent;
+  pipeline.stats.send_errors    += count - sent;
+
+  for (int i = 0; i < count; i++) {
+    libtock_pool_free(&pipeline.pool, pipeline.queue[i].buf);
+  }
+  for (int i = count; i < pipeline.queued; i++) {
+    pipeline.queue[i - count] = pipeline.queue[i];
+  }
+  pipeline.queued -= count;
+  pipeline.sending = 0;
+
+  if (pipeline.running) try_send();
+}
+
+static void close_open(void) {
+  if (pipeline.open.buf == NULL) return;
+  if (pipeline.open.records == 0) {
+    libtock_pool_free(&pipeline.pool, pipeline.open.buf);
+  } else {
+    pipeline.open.buf[0] = ARRAY_1_BYTE_COUNT;
+    pipeline.open.buf[1] = pipeline.open.records;
+    pipeline.queue[pipeline.queued++] = pipeline.open;
+  }
+  pipeline.open.buf = NULL;
+}
+
+static bool open_new(void) {
+  pipeline.open.buf = libtock_pool_alloc(&pipeline.pool);
+  if (pipeline.open.buf == NULL) return false;
+  pipeline.open.len     = HEADER_LEN;
+  pipeline.open.records = 0;
+  return true;
+}
+
+static void put3(libtock_cbor_writer_t* w, const int* v) {
+  libtock_cbor_put_array(w, 3);
+  for (int i = 0; i < 3; i++) {
+    libtock_cbor_put_int(w, v[i]);
+  }
+}
+
+// Append `sample` to the open datagram. Returns false if it does not fit.
+static bool encode(const libtock_sensor_sample_t* sample) {
+  datagram_t* d = &pipeline.open;
+  libtock_cbor_writer_t w;
+  libtock_cbor_writer_init(&w, d->buf + d->len, pipeline.buffer_size - d->len);
+
+  libtock_cbor_put_array(&w, 2);
+  libtock_cbor_put_uint(&w, (uint32_t) (sample->us / 1000));
+  libtock_cbor_put_map(&w, (size_t) __builtin_popcount(sample->valid));
+  for (int s = 0; s < LIBTOCK_SENSOR_COUNT; s++) {
+    if ((sample->valid & (1u << s)) == 0) continue;
+    libtock_cbor_put_uint(&w, (uint64_t) s);
+    switch ((libtock_sensor_t) s) {
+      case LIBTOCK_SENSOR_TEMPERATURE:   libtock_cbor_put_int(&w, sample->temperature); break;
+      case LIBTOCK_SENSOR_HUMIDITY:      libtock_cbor_put_int(&w, sample->humidity); break;
+      case LIBTOCK_SENSOR_PRESSURE:      libtock_cbor_put_int(&w, sample->pressure); break;
+      case LIBTOCK_SENSOR_AMBIENT_LIGHT: libtock_cbor_put_int(&w, sample->ambient_light); break;
+      case LIBTOCK_SENSOR_ACCELEROMETER: put3(&w, sample->accelerometer); break;
+      case LIBTOCK_SENSOR_MAGNETOMETER:  put3(&w, sample->magnetometer); break;
+      default:                           put3(&w, sample->gyroscope); break;
+    }
+  }
+
+  size_t len;
+  if (libtock_cbor_writer_finish(&w, &len) != RETURNCODE_SUCCESS) return false;
+  d->len += len;
+  d->records++;
+  return true;
+}
+
+static void record_ready(const libtock_sensor_sample_t* sample) {
+  if (sample->valid == 0) return;
+  pipeline.stats.records++;
+
+  if (pipeline.open.buf == NULL && !open_new()) {
+    pipeline.stats.records_dropped++;
+    return;
+  }
+  if (!encode(sample)) {
+    // Start the next datagram with it; a record too large for an empty one
+    // is lost.
+    bool empty = pipeline.open.records == 0;
+    close_open();
+    if (empty || !open_new() || !encode(sample)) {
+      pipeline.stats.records_dropped++;
+      try_send();
+      return;
+    }
+  }
+
+  if (pipeline.open.records == pipeline.config.records_per_datagram) close_open();
+  try_send();
+}
+
+returncode_t libtock_telemetry_start(const libtock_telemetry_config_t* config) {
+  if (pipeline.running) return RETURNCODE_EBUSY;
+  if (config->dst == NULL || config->records_per_datagram == 0 ||
+      config->datagrams_per_batch == 0 || config->buffers < config->datagrams_per_batch ||
+      config->buffers > LIBTOCK_TELEMETRY_MAX_BUFFERS) {
+    return RETURNCODE_EINVAL;
+  }
+
+  if (pipeline.pool.count == 0) {
+    int max_tx_len;
+    returncode_t ret = libtock_udp_get_max_tx_len(&max_tx_len);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    if (max_tx_len <= HEADER_LEN) return RETURNCODE_ESIZE;
+
+    ret = libtock_pool_init(&pipeline.pool, (uint32_t) max_tx_len, config->buffers);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    pipeline.buffer_size = (size_t) max_tx_len;
+  } else if (config->buffers > pipeline.pool.count) {
+    return RETURNCODE_EINVAL;
+  }
+
+  pipeline.flushing = false;
+  pipeline.config   = *config;
+
+  returncode_t ret = libtock_sensor_sampler_start(config->tick_ms, config->slack_ms, record_ready);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  pipeline.running = true;
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_telemetry_flush(void) {
+  if (!pipeline.running) return;
+  close_open();
+  pipeline.flushing = true;
+  try_send();
+}
+
+void libtock_telemetry_stop(void) {
+  if (!pipeline.running) return;
+  pipeline.running = false;
+  libtock_sensor_sampler_stop();
+
+  if (pipeline.open.buf != NULL) libtock_pool_free(&pipeline.pool, pipeline.open.buf);
+  pipeline.open.buf = NULL;
+  // Keep the datagrams being sent until the batch finishes.
+  for (int i = pipeline.sending; i < pipeline.queued; i++) {
+    libtock_pool_free(&pipeline.pool, pipeline.queue[i].buf);
+  }
+  pipeline.queued = pipeline.sending;
+}
+
+void libtock_telemetry_stats(libtock_telemetry_stats_t* stats) {
+  *stats = pipeline.stats;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../net/udp.h"
+#include "../tock.h"
+#include "sensor_sampler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sensor telemetry over UDP.
+//
+// The pipeline connects `sensor_sampler`, which reads due sensors in
+// parallel, to `udp_batch`. Each record is encoded as CBOR straight into a
+// transmit buffer from a pool, several records per datagram, and full
+// datagrams are sent back to back in batches, so the radio is woken once per
+// batch rather than once per reading and no stage waits for another.
+//
+// A datagram is a CBOR array of records. Each record is an array of the
+// sample time in milliseconds and a map from `libtock_sensor_t` to the
+// reading, in the units of the sensor driver, or an array of three for the
+// ninedof sensors:
+//
+//     [[1200, {0: 2281, 3: 312}], [2200, {0: 2283, 3: 305}]]
+//
+// Enable the sensors with `libtock_sensor_sampler_enable()` and bind the app
+// with `libtock_udp_bind()` before starting the pipeline. The pipeline owns
+// the sampler and the UDP batch while it runs.
+
+// Most transmit buffers of a pipeline.
+#define LIBTOCK_TELEMETRY_MAX_BUFFERS 8
+
+typedef struct {
+  // Where to send the datagrams. Must stay valid while the pipeline runs.
+  sock_addr_t* dst;
+  // Sampler tick and slack, see `libtock_sensor_sampler_start()`.
+  uint32_t tick_ms;
+  uint32_t slack_ms;
+  // Records packed into each datagram, fewer if they do not fit the driver's
+  // largest datagram.
+  uint8_t records_per_datagram;
+  // Full datagrams sent together.
+  uint8_t datagrams_per_batch;
+  // Transmit buffers, at least `datagrams_per_batch`, up to
+  // `LIBTOCK_TELEMETRY_MAX_BUFFERS`. Extra ones fill while a batch is sent.
+  uint8_t buffers;
+} libtock_telemetry_config_t;
+
+typedef struct {
+  uint32_t records;
+  uint32_t datagrams_sent;
+  // Records lost because every buffer was full or waiting to be sent.
+  uint32_t records_dropped;
+  // Datagrams the driver failed to send.
+  uint32_t send_errors;
+} libtock_telemetry_stats_t;
+
+// Start sampling and sending.
+//
+// The buffers are taken from the heap the first time and reused by later
+// starts, which may not ask for more of them.
+//
+// Returns RETURNCODE_EINVAL for an invalid config, RETURNCODE_ENOMEM if the
+// buffers cannot be allocated, and RETURNCODE_EBUSY if it already runs.
+returncode_t libtock_telemetry_start(const libtock_telemetry_config_t* config);
+
+// Send the records collected so far without waiting for the datagram or the
+// batch to fill.
+void libtock_telemetry_flush(void);
+
+// Stop sampling. Datagrams not yet sent are dropped; a batch being sent
+// finishes.
+void libtock_telemetry_stop(void);
+
+void libtock_telemetry_stats(libtock_telemetry_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,166 @@
+#include <string.h>
+
+#include "text_screen_batch.h"
+
+// A gap of this many unchanged characters or fewer costs less to write again
+// than to move the cursor over.
+#define DIFF_GAP 3
+
+void libtock_text_screen_batch_init(libtock_text_screen_batch_t* batch, uint8_t* buffer, size_t size) {
+  batch->buffer = buffer;
+  batch->size   = size;
+  batch->used   = 0;
+}
+
+void libtock_text_screen_batch_reset(libtock_text_screen_batch_t* batch) {
+  batch->used = 0;
+}
+
+returncode_t libtock_text_screen_batch_control(libtock_text_screen_batch_t* batch, libtock_text_screen_op_t op) {
+  if (op >= LIBTOCK_TEXT_SCREEN_OP_SET_CURSOR) return RETURNCODE_EINVAL;
+  if (batch->size - batch->used < 1) return RETURNCODE_ESIZE;
+
+  batch->buffer[batch->used++] = op;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_text_screen_batch_set_cursor(libtock_text_screen_batch_t* batch, uint8_t col, uint8_t row) {
+  if (batch->size - batch->used < 3) return RETURNCODE_ESIZE;
+
+  batch->buffer[batch->used++] = LIBTOCK_TEXT_SCREEN_OP_SET_CURSOR;
+  batch->buffer[batch->used++] = col;
+  batch->buffer[batch->used++] = row;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_text_screen_batch_write(libtock_text_screen_batch_t* batch, const char* str, size_t len) {
+  while (len > 0) {
+    size_t chunk = len > UINT8_MAX ? UINT8_MAX : len;
+    if (batch->size - batch->used < 2 + chunk) return RETURNCODE_ESIZE;
+
+    batch->buffer[batch->used++] = LIBTOCK_TEXT_SCREEN_OP_WRITE;
+    batch->buffer[batch->used++] = chunk;
+    memcpy(batch->buffer + batch->used, str, chunk);
+    batch->used += chunk;
+    str         += chunk;
+    len         -= chunk;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+// The text screen callbacks carry no context, so the run is global.
+static struct {
+  bool running;
+  libtock_text_screen_batch_t* batch;
+  size_t pos;
+  libtock_text_screen_batch_callback cb;
+} run;
+
+static returncode_t next_op(void);
+
+static void op_done(returncode_t ret) {
+  if (ret == RETURNCODE_SUCCESS) ret = next_op();
+  if (ret != RETURNCODE_SUCCESS) {
+    run.running = false;
+    run.cb(ret);
+  }
+}
+
+// Start the next operation. Finishes after the last one.
+static returncode_t next_op(void) {
+  libtock_text_screen_batch_t* batch = run.batch;
+  if (run.pos == batch->used) {
+    run.running = false;
+    run.cb(RETURNCODE_SUCCESS);
+    return RETURNCODE_SUCCESS;
+  }
+
+  uint8_t* op = batch->buffer + run.pos;
+  switch (op[0]) {
+    case LIBTOCK_TEXT_SCREEN_OP_DISPLAY_ON:
+      run.pos += 1;
+      return libtock_text_screen_display_on(op_done);
+    case LIBTOCK_TEXT_SCREEN_OP_DISPLAY_OFF:
+      run.pos += 1;
+      return libtock_text_screen_display_off(op_done);
+    case LIBTOCK_TEXT_SCREEN_OP_BLINK_ON:
+      run.pos += 1;
+      return libtock_text_screen_blink_on(op_done);
+    case LIBTOCK_TEXT_SCREEN_OP_BLINK_OFF:
+      run.pos += 1;
+      return libtock_text_screen_blink_off(op_done);
+    case LIBTOCK_TEXT_SCREEN_OP_SHOW_CURSOR:
+      run.pos += 1;
+      return libtock_text_screen_show_cursor(op_done);
+    case LIBTOCK_TEXT_SCREEN_OP_HIDE_CURSOR:
+      run.pos += 1;
+      return libtock_text_screen_hide_cursor(op_done);
+    case LIBTOCK_TEXT_SCREEN_OP_CLEAR:
+      run.pos += 1;
+      return libtock_text_screen_clear(op_done);
+    case LIBTOCK_TEXT_SCREEN_OP_HOME:
+      run.pos += 1;
+      return libtock_text_screen_home(op_done);
+    case LIBTOCK_TEXT_SCREEN_OP_SET_CURSOR:
+      run.pos += 3;
+      return libtock_text_screen_set_cursor(op[1], op[2], op_done);
+    case LIBTOCK_TEXT_SCREEN_OP_WRITE:
+      // The characters are written straight from the batch buffer.
+      run.pos += 2 + op[1];
+      return libtock_text_screen_write(op + 2, op[1], op[1], op_done);
+    default:
+      return RETURNCODE_EINVAL;
+  }
+}
+
+returncode_t libtock_text_screen_batch_run(libtock_text_screen_batch_t* batch, libtock_text_screen_batch_callback cb) {
+  if (run.running) return RETURNCODE_EBUSY;
+  if (batch->used == 0) return RETURNCODE_EALREADY;
+
+  run.batch   = batch;
+  run.pos     = 0;
+  run.cb      = cb;
+  run.running = true;
+
+  returncode_t ret = next_op();
+  if (ret != RETURNCODE_SUCCESS) run.running = false;
+  return ret;
+}
+
+void libtock_text_screen_diff_init(libtock_text_screen_diff_t* diff, char* shown, uint8_t cols, uint8_t rows) {
+  diff->shown = shown;
+  diff->cols  = cols;
+  diff->rows  = rows;
+  // No frame contains NUL, so every character differs at first.
+  memset(shown, 0, (size_t) cols * rows);
+}
+
+returncode_t libtock_text_screen_batch_diff(libtock_text_screen_batch_t* batch, libtock_text_screen_diff_t* diff,
+                                            const char* frame) {
+  for (uint8_t row = 0; row < diff->rows; row++) {
+    char* shown      = diff->shown + row * diff->cols;
+    const char* want = frame + row * diff->cols;
+
+    uint8_t col = 0;
+    while (col < diff->cols) {
+      if (shown[col] == want[col]) {
+        col++;
+        continue;
+      }
+
+      // Extend the span over changes separated by short gaps.
+      uint8_t start = col, end = col + 1;
+      for (uint8_t i = end; i < diff->cols && i - end <= DIFF_GAP; i++) {
+        if (shown[i] != want[i]) end = i + 1;
+      }
+
+      returncode_t ret = libtock_text_screen_batch_set_cursor(batch, start, row);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+      ret = libtock_text_screen_batch_write(batch, want + start, end - start);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+      memcpy(shown + start, want + start, end - start);
+      col = end;
+    }
+  }
+  return RETURNCODE_SUCCESS;
+}
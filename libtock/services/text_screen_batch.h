@@ -0,0 +1,97 @@
+#pragma once
+
+#include "../display/text_screen.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Batched text screen updates.
+//
+// The text screen driver runs one operation per command, and each one needs
+// its own upcall. A batch records cursor moves, writes and control operations
+// into a buffer, and `libtock_text_screen_batch_run()` issues them back to
+// back from the upcalls, with a single callback at the end. The kernel has no
+// command stream, so this saves the app's round trips rather than the
+// kernel's, but the app is only woken once per update.
+//
+// A `libtock_text_screen_diff_t` keeps a copy of what the screen shows, and
+// adds only the changed characters of each new frame to a batch.
+
+typedef enum {
+  LIBTOCK_TEXT_SCREEN_OP_DISPLAY_ON,
+  LIBTOCK_TEXT_SCREEN_OP_DISPLAY_OFF,
+  LIBTOCK_TEXT_SCREEN_OP_BLINK_ON,
+  LIBTOCK_TEXT_SCREEN_OP_BLINK_OFF,
+  LIBTOCK_TEXT_SCREEN_OP_SHOW_CURSOR,
+  LIBTOCK_TEXT_SCREEN_OP_HIDE_CURSOR,
+  LIBTOCK_TEXT_SCREEN_OP_CLEAR,
+  LIBTOCK_TEXT_SCREEN_OP_HOME,
+  // Followed by column and row.
+  LIBTOCK_TEXT_SCREEN_OP_SET_CURSOR,
+  // Followed by a length byte and that many characters.
+  LIBTOCK_TEXT_SCREEN_OP_WRITE,
+} libtock_text_screen_op_t;
+
+typedef struct {
+  uint8_t* buffer;
+  size_t size;
+  size_t used;
+} libtock_text_screen_batch_t;
+
+// Function signature for the batch callback.
+//
+// - `arg1` (`returncode_t`): Whether every operation succeeded. The batch
+//   stops at the first failure.
+typedef void (*libtock_text_screen_batch_callback)(returncode_t);
+
+// Record operations into `buffer` of `size` bytes.
+void libtock_text_screen_batch_init(libtock_text_screen_batch_t* batch, uint8_t* buffer, size_t size);
+
+// Forget the recorded operations.
+void libtock_text_screen_batch_reset(libtock_text_screen_batch_t* batch);
+
+// Record an operation without arguments.
+//
+// Returns RETURNCODE_ESIZE if the buffer is full, and RETURNCODE_EINVAL for
+// operations that take arguments.
+returncode_t libtock_text_screen_batch_control(libtock_text_screen_batch_t* batch, libtock_text_screen_op_t op);
+
+// Record a cursor move.
+returncode_t libtock_text_screen_batch_set_cursor(libtock_text_screen_batch_t* batch, uint8_t col, uint8_t row);
+
+// Record a write of `len` characters. Long writes are split.
+returncode_t libtock_text_screen_batch_write(libtock_text_screen_batch_t* batch, const char* str, size_t len);
+
+// Run the recorded operations in order, then call `cb`. The batch must stay
+// unchanged until then, and may be reset or run again afterwards.
+//
+// Returns RETURNCODE_EALREADY if the batch is empty, in which case there is
+// no callback, and RETURNCODE_EBUSY if a batch is already running.
+returncode_t libtock_text_screen_batch_run(libtock_text_screen_batch_t* batch, libtock_text_screen_batch_callback cb);
+
+typedef struct {
+  char* shown;
+  uint8_t cols;
+  uint8_t rows;
+} libtock_text_screen_diff_t;
+
+// Track a `cols` by `rows` screen in `shown`, which holds `cols * rows`
+// characters. Nothing is assumed to be shown yet, so the first frame is
+// written in full.
+void libtock_text_screen_diff_init(libtock_text_screen_diff_t* diff, char* shown, uint8_t cols, uint8_t rows);
+
+// Add the changes from what is shown to `frame`, `cols * rows` characters in
+// row order, to `batch`. Changes a few characters apart are written together
+// rather than with another cursor move. `shown` is updated as if the batch
+// will run.
+//
+// Returns RETURNCODE_ESIZE if the batch filled up. `shown` then only
+// includes the changes that fit.
+returncode_t libtock_text_screen_batch_diff(libtock_text_screen_batch_t* batch, libtock_text_screen_diff_t* diff,
+                                            const char* frame);
+
+#ifdef __cplusplus
+}
+#endif
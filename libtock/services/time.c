@@ -0,0 +1,92 @@
+#include "time.h"
+#include "../kernel/read_only_state.h"
+#include "alarm.h"
+
+#include <assert.h>
+
+static uint32_t frequency = 0;
+
+// Read-only state region to read ticks from, if any.
+static void* ros = NULL;
+
+// State for extending the 32-bit alarm counter.
+static bool extending     = false;
+static uint32_t last_low  = 0;
+static uint32_t high      = 0;
+static libtock_alarm_ticks_t wrap_alarm;
+
+#define HALF_WRAP (1u << 31)
+
+// Extend a 32-bit counter value to 64 bits. Values up to half a wrap older
+// than the latest one (e.g. the timestamp of a delayed upcall) are extended
+// into the epoch they belong to instead of being mistaken for a wrap.
+static uint64_t extend(uint32_t now) {
+  if (now - last_low < HALF_WRAP) {
+    if (now < last_low) {
+      high++;
+    }
+    last_low = now;
+    return ((uint64_t) high << 32) | now;
+  }
+  uint32_t epoch = now > last_low ? high - 1 : high;
+  return ((uint64_t) epoch << 32) | now;
+}
+
+// Keeps `extend()` seeing the counter at least twice per wrap.
+static void wrap_cb(uint32_t now, uint32_t scheduled, __attribute__ ((unused)) void* opaque) {
+  extend(now);
+  libtock_alarm_at(scheduled, HALF_WRAP, wrap_cb, NULL, &wrap_alarm);
+}
+
+static void init(void) {
+  if (frequency == 0) {
+    libtock_alarm_get_frequency(&frequency);
+    assert(frequency > 0);
+  }
+  if (ros == NULL && !extending) {
+    uint32_t now;
+    libtock_alarm_command_read(&now);
+    last_low  = now;
+    extending = true;
+    libtock_alarm_at(now, HALF_WRAP, wrap_cb, NULL, &wrap_alarm);
+  }
+}
+
+returncode_t libtock_time_use_read_only_state(void* read_only_state) {
+  ros = read_only_state;
+  if (ros != NULL && extending) {
+    libtock_alarm_cancel(&wrap_alarm);
+    extending = false;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+uint32_t libtock_time_frequency(void) {
+  init();
+  return frequency;
+}
+
+uint64_t libtock_time_now_ticks64(void) {
+  init();
+  if (ros != NULL) {
+    return libtock_read_only_state_get_ticks(ros);
+  }
+  uint32_t now;
+  libtock_alarm_command_read(&now);
+  return extend(now);
+}
+
+uint64_t libtock_time_ticks_to_us64(uint64_t ticks) {
+  const uint32_t us_per_second = 1000000;
+  uint32_t freq = libtock_time_frequency();
+
+  // Split into whole seconds and a remainder so the multiplication cannot
+  // overflow.
+  uint64_t seconds   = ticks / freq;
+  uint64_t remainder = ticks % freq;
+  return seconds * us_per_second + (remainder * us_per_second) / freq;
+}
+
+uint64_t libtock_time_now_us64(void) {
+  return libtock_time_ticks_to_us64(libtock_time_now_ticks64());
+}
@@ -0,0 +1,52 @@
+/*
+ * This module provides a 64-bit monotonic clock.
+ *
+ * The alarm driver exposes a 32-bit counter, which wraps every 2^32 ticks
+ * (about 36 hours at 32 kHz, about 72 minutes at 1 MHz). This service extends
+ * it to 64 bits by counting wraps. It keeps an internal alarm that fires once
+ * every 2^31 ticks, so a wrap is never missed even if the app reads the time
+ * rarely.
+ *
+ * If the kernel shares a read-only state region (see
+ * `libtock/kernel/read_only_state.h`), the service can read the kernel's
+ * 64-bit tick count straight from memory instead. Reading the time then costs
+ * no system calls and needs no internal alarm, but the kernel only updates
+ * that count when it switches to the app: it is the time of the last context
+ * switch, and stands still while the app runs. Code that measures intervals
+ * without making system calls should use the alarm counter instead.
+ */
+
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Read the time from a read-only state region, or go back to the alarm
+// counter if `read_only_state` is NULL.
+//
+// The region must already be shared with
+// `libtock_read_only_state_allocate_region()`. Its tick count must run at the
+// alarm driver's frequency. From then on the time is that of the last
+// context switch into the app, not a live reading.
+returncode_t libtock_time_use_read_only_state(void* read_only_state);
+
+// Frequency of the clock in Hz.
+uint32_t libtock_time_frequency(void);
+
+// Ticks since the clock started. With a read-only state region, as of the
+// last context switch into the app.
+uint64_t libtock_time_now_ticks64(void);
+
+// Microseconds since the clock started.
+uint64_t libtock_time_now_us64(void);
+
+// Convert a tick count to microseconds without overflowing for any count
+// `libtock_time_now_ticks64()` can return.
+uint64_t libtock_time_ticks_to_us64(uint64_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,108 @@
+#include "../peripherals/syscalls/alarm_syscalls.h"
+#include "alarm.h"
+#include "tone_player.h"
+
+// The buzzer callback carries no context, so the player is global.
+static struct {
+  const libtock_tone_t* tones;
+  uint32_t count;
+  uint32_t next;
+  libtock_tone_player_callback cb;
+  bool playing;
+  // Whether a tone is sounding, and whether the next one is due.
+  bool sounding;
+  bool due;
+  uint32_t frequency;
+  // Tick the sequence started at, the time into it the last alarm was set
+  // for, and that alarm.
+  uint32_t start_ticks;
+  uint64_t at_ms;
+  libtock_alarm_ticks_t alarm;
+} player;
+
+static void play_next(void);
+
+static uint32_t ms_to_ticks(uint64_t ms) {
+  return (uint32_t) (ms * player.frequency / 1000);
+}
+
+static void finish(returncode_t ret) {
+  player.playing = false;
+  if (player.cb != NULL) player.cb(ret);
+}
+
+static void tone_done(void) {
+  player.sounding = false;
+  if (player.playing && player.due) play_next();
+}
+
+static void tone_due(__attribute__ ((unused)) uint32_t now, __attribute__ ((unused)) uint32_t scheduled,
+                     __attribute__ ((unused)) void* opaque) {
+  player.due = true;
+  // A tone still sounding starts the next one when it is done.
+  if (!player.sounding) play_next();
+}
+
+static void play_next(void) {
+  player.due = false;
+  if (player.next == player.count) {
+    finish(RETURNCODE_SUCCESS);
+    return;
+  }
+
+  const libtock_tone_t* tone = &player.tones[player.next++];
+  if (tone->frequency_hz != 0 && tone->duration_ms != 0) {
+    returncode_t ret = libtock_buzzer_tone(tone->frequency_hz, tone->duration_ms, tone_done);
+    if (ret != RETURNCODE_SUCCESS) {
+      finish(ret);
+      return;
+    }
+    player.sounding = true;
+  }
+
+  // Set each alarm from the sequence's own timeline, so rounding does not
+  // accumulate. Successive alarms are apart by one tone, well within range.
+  uint64_t from_ms = player.at_ms;
+  player.at_ms += tone->duration_ms + tone->gap_ms;
+  uint32_t reference = player.start_ticks + ms_to_ticks(from_ms);
+  uint32_t dt        = ms_to_ticks(player.at_ms) - ms_to_ticks(from_ms);
+  libtock_alarm_at(reference, dt, tone_due, NULL, &player.alarm);
+}
+
+returncode_t libtock_tone_player_play(const libtock_tone_t* tones, uint32_t count, libtock_tone_player_callback cb) {
+  if (player.playing) return RETURNCODE_EBUSY;
+
+  uint32_t frequency;
+  returncode_t ret = libtock_alarm_get_frequency(&frequency);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  uint32_t now;
+  ret = libtock_alarm_command_read(&now);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  player.tones       = tones;
+  player.count       = count;
+  player.next        = 0;
+  player.cb          = cb;
+  player.playing     = true;
+  player.due         = false;
+  player.frequency   = frequency;
+  player.start_ticks = now;
+  player.at_ms       = 0;
+
+  // A tone from a stopped sequence may still be sounding.
+  if (!player.sounding) {
+    play_next();
+  } else {
+    player.due = true;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_tone_player_stop(void) {
+  libtock_alarm_cancel(&player.alarm);
+  player.playing = false;
+}
+
+bool libtock_tone_player_playing(void) {
+  return player.playing;
+}
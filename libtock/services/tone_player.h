@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../interface/buzzer.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Playing a sequence of tones on the buzzer in the background.
+//
+// `libtock_buzzer_tone()` plays one tone. The player walks an array of tones,
+// starting each on an alarm set from the start of the sequence, so rounding
+// and upcall latency do not add up over a song, and the app runs or sleeps in
+// between. If a tone has not finished when the next is due, as can happen
+// without a gap, the next starts from the buzzer's completion upcall.
+//
+// Songs are usually `const` and stay in flash:
+//
+//     static const libtock_tone_t song[] = {
+//       {NOTE_E6, 450, 50}, {NOTE_E6, 450, 50}, {0, 500, 0}, ...
+//     };
+//
+//     libtock_tone_player_play(song, sizeof(song) / sizeof(song[0]), done);
+
+typedef struct {
+  // Frequency of the tone, or 0 for a rest.
+  uint16_t frequency_hz;
+  // How long the tone sounds, and the silence after it.
+  uint16_t duration_ms;
+  uint16_t gap_ms;
+} libtock_tone_t;
+
+// Function signature for the end of a sequence.
+//
+// - `arg1` (`returncode_t`): RETURNCODE_SUCCESS after the last tone and its
+//   gap, or the error that stopped the sequence.
+typedef void (*libtock_tone_player_callback)(returncode_t);
+
+// Play `count` tones from `tones`, which must stay valid until `cb` is
+// called. `cb` may be NULL.
+//
+// Returns RETURNCODE_EBUSY if a sequence is playing.
+returncode_t libtock_tone_player_play(const libtock_tone_t* tones, uint32_t count, libtock_tone_player_callback cb);
+
+// Stop after the tone that is playing. `cb` is not called.
+void libtock_tone_player_stop(void);
+
+// Whether a sequence is playing.
+bool libtock_tone_player_playing(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,147 @@
+#include "touch_queue.h"
+
+// There is one touch device, so the queue is global.
+static struct {
+  libtock_touch_event_t* events;
+  int capacity;
+  int head;
+  int count;
+  uint32_t dropped;
+  bool multi;
+  libtock_touch_queue_callback cb;
+  libtock_touch_event_t batch[LIBTOCK_TOUCH_QUEUE_MAX_TOUCHES];
+} queue;
+
+static libtock_touch_event_t* entry(int index) {
+  index += queue.head;
+  if (index >= queue.capacity) index -= queue.capacity;
+  return &queue.events[index];
+}
+
+// Remove the entry at `index`, moving the later ones up.
+static void remove_entry(int index) {
+  for (int i = index; i < queue.count - 1; i++) {
+    *entry(i) = *entry(i + 1);
+  }
+  queue.count--;
+}
+
+static void push(const libtock_touch_event_t* event) {
+  if (event->status == LIBTOCK_TOUCH_STATUS_MOVED) {
+    // Only the latest entry of the touch matters: if it is a move, update it.
+    for (int i = queue.count - 1; i >= 0; i--) {
+      libtock_touch_event_t* queued = entry(i);
+      if (queued->id != event->id) continue;
+      if (queued->status == LIBTOCK_TOUCH_STATUS_MOVED) {
+        *queued = *event;
+        return;
+      }
+      break;
+    }
+  }
+
+  if (queue.count == queue.capacity && event->status != LIBTOCK_TOUCH_STATUS_MOVED) {
+    for (int i = 0; i < queue.count; i++) {
+      if (entry(i)->status == LIBTOCK_TOUCH_STATUS_MOVED) {
+        remove_entry(i);
+        queue.dropped++;
+        break;
+      }
+    }
+  }
+  if (queue.count == queue.capacity) {
+    queue.dropped++;
+    return;
+  }
+
+  *entry(queue.count) = *event;
+  queue.count++;
+}
+
+static void notify(bool was_empty) {
+  if (was_empty && queue.count > 0 && queue.cb) queue.cb();
+}
+
+static void single_touch_upcall(int                            status,
+                                int                            xy,
+                                __attribute__ ((unused)) int   unused1,
+                                __attribute__ ((unused)) void* opaque) {
+  libtock_touch_event_t event = {
+    .id       = 0,
+    .status   = (unsigned char) status,
+    .x        = (unsigned short) (((uint32_t) xy) >> 16),
+    .y        = (unsigned short) (((uint32_t) xy) & 0xFFFF),
+    .size     = 0,
+    .pressure = 0,
+  };
+
+  bool was_empty = queue.count == 0;
+  push(&event);
+  notify(was_empty);
+}
+
+static void multi_touch_upcall(int                            num_events,
+                               __attribute__ ((unused)) int   dropped_events,
+                               __attribute__ ((unused)) int   lost_touches,
+                               __attribute__ ((unused)) void* opaque) {
+  if (num_events > LIBTOCK_TOUCH_QUEUE_MAX_TOUCHES) num_events = LIBTOCK_TOUCH_QUEUE_MAX_TOUCHES;
+
+  bool was_empty = queue.count == 0;
+  for (int i = 0; i < num_events; i++) {
+    push(&queue.batch[i]);
+  }
+  // The driver holds the next batch until this one is acknowledged.
+  libtock_touch_multi_touch_next();
+  notify(was_empty);
+}
+
+returncode_t libtock_touch_queue_start(libtock_touch_event_t* storage, int capacity, libtock_touch_queue_callback cb) {
+  if (capacity <= 0) return RETURNCODE_EINVAL;
+
+  int touches;
+  returncode_t ret = libtock_touch_get_number_of_touches(&touches);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (touches < 1) return RETURNCODE_ENODEVICE;
+
+  queue.events   = storage;
+  queue.capacity = capacity;
+  queue.head     = 0;
+  queue.count    = 0;
+  queue.dropped  = 0;
+  queue.cb       = cb;
+  queue.multi    = touches > 1;
+
+  if (!queue.multi) {
+    ret = libtock_touch_set_upcall_single_touch(single_touch_upcall, NULL);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    return libtock_touch_command_enable_single_touch();
+  }
+
+  ret = libtock_touch_set_allow_readwrite_multi_touch(queue.batch, sizeof(queue.batch));
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtock_touch_set_upcall_multi_touch(multi_touch_upcall, NULL);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  return libtock_touch_command_enable_multi_touch();
+}
+
+returncode_t libtock_touch_queue_stop(void) {
+  if (queue.multi) return libtock_touch_disable_multi_touch();
+  return libtock_touch_disable_single_touch();
+}
+
+bool libtock_touch_queue_pop(libtock_touch_event_t* event) {
+  if (queue.count == 0) return false;
+
+  *event     = queue.events[queue.head];
+  queue.head = queue.head + 1 == queue.capacity ? 0 : queue.head + 1;
+  queue.count--;
+  return true;
+}
+
+int libtock_touch_queue_count(void) {
+  return queue.count;
+}
+
+uint32_t libtock_touch_queue_dropped(void) {
+  return queue.dropped;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../sensors/touch.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Queued touch events.
+//
+// The touch driver reports every event with an upcall, and an app that only
+// keeps the latest position loses the presses and releases in between. The
+// queue keeps every press and release, in order, for each touch. Consecutive
+// moves of a touch are coalesced into its latest position, so a drag adds at
+// most one entry per touch until the app takes it.
+//
+// The queue uses multi touch when the device supports more than one touch,
+// and then queues the whole batch of each upcall before acknowledging it.
+// Single touch events are queued with id 0.
+//
+// If the queue is full, the oldest queued move makes room for a press or
+// release. Events that still do not fit are counted by
+// `libtock_touch_queue_dropped()`.
+
+// Largest multi touch batch read from the driver.
+#ifndef LIBTOCK_TOUCH_QUEUE_MAX_TOUCHES
+#define LIBTOCK_TOUCH_QUEUE_MAX_TOUCHES 5
+#endif
+
+// Function signature for the notification callback, called when events were
+// queued into an empty queue. It is not called again until the app has taken
+// every event.
+typedef void (*libtock_touch_queue_callback)(void);
+
+// Start queueing events into `storage`, which holds `capacity` events. `cb`
+// may be NULL. This replaces any touch callback.
+//
+// Returns RETURNCODE_ENODEVICE if there is no touch device.
+returncode_t libtock_touch_queue_start(libtock_touch_event_t* storage, int capacity, libtock_touch_queue_callback cb);
+
+// Stop queueing. Queued events can still be taken.
+returncode_t libtock_touch_queue_stop(void);
+
+// Take the oldest event. Returns false if the queue is empty.
+bool libtock_touch_queue_pop(libtock_touch_event_t* event);
+
+// Number of events waiting.
+int libtock_touch_queue_count(void);
+
+// Number of events dropped because the queue was full.
+uint32_t libtock_touch_queue_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
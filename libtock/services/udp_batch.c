@@ -0,0 +1,61 @@
+#include "udp_batch.h"
+
+// The UDP send callback carries no context, so the batch is global.
+static struct {
+  bool running;
+  libtock_udp_datagram_t* datagrams;
+  int count;
+  int next;
+  int sent;
+  returncode_t first_error;
+  libtock_udp_batch_callback cb;
+} batch;
+
+static void send_done(statuscode_t status);
+
+static returncode_t send_current(void) {
+  libtock_udp_datagram_t* d = &batch.datagrams[batch.next];
+  return libtock_udp_send((void*) d->buf, d->len, d->dst, send_done);
+}
+
+static void record(returncode_t ret) {
+  batch.datagrams[batch.next].result = ret;
+  if (ret == RETURNCODE_SUCCESS) {
+    batch.sent++;
+  } else if (batch.first_error == RETURNCODE_SUCCESS) {
+    batch.first_error = ret;
+  }
+  batch.next++;
+}
+
+static void send_done(statuscode_t status) {
+  if (!batch.running) return;
+  record(tock_status_to_returncode(status));
+
+  // Datagrams that cannot be started fail right away.
+  while (batch.next < batch.count) {
+    returncode_t ret = send_current();
+    if (ret == RETURNCODE_SUCCESS) return;
+    record(ret);
+  }
+
+  batch.running = false;
+  batch.cb(batch.first_error, batch.sent);
+}
+
+returncode_t libtock_udp_send_batch(libtock_udp_datagram_t* datagrams, int count, libtock_udp_batch_callback cb) {
+  if (batch.running) return RETURNCODE_EBUSY;
+  if (count <= 0) return RETURNCODE_EINVAL;
+
+  batch.datagrams   = datagrams;
+  batch.count       = count;
+  batch.next        = 0;
+  batch.sent        = 0;
+  batch.first_error = RETURNCODE_SUCCESS;
+  batch.cb          = cb;
+
+  returncode_t ret = send_current();
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  batch.running = true;
+  return RETURNCODE_SUCCESS;
+}
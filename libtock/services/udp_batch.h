@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../net/udp.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Batched UDP sends.
+//
+// The driver sends one datagram at a time. A batch sends a list of
+// datagrams back to back, starting each one from the completion upcall of
+// the previous one, and calls the app once when the whole batch is done.
+// The app must be bound, and must not send anything else meanwhile.
+
+typedef struct {
+  const void* buf;
+  size_t len;
+  sock_addr_t* dst;
+  // Result of sending this datagram, set before the batch callback.
+  returncode_t result;
+} libtock_udp_datagram_t;
+
+// Function signature for the batch callback.
+//
+// - `arg1` (`returncode_t`): RETURNCODE_SUCCESS if every datagram was sent,
+//   otherwise the first error. Each datagram's `result` says which.
+// - `arg2` (`int`): Number of datagrams sent successfully.
+typedef void (*libtock_udp_batch_callback)(returncode_t, int);
+
+// Send `count` datagrams in order. Failed datagrams do not stop the batch.
+// `datagrams` and their buffers must stay valid until the callback.
+//
+// Returns RETURNCODE_EBUSY while a batch is running. If the first datagram
+// cannot be sent, returns the error and no callback follows; the remaining
+// datagrams are not sent.
+returncode_t libtock_udp_send_batch(libtock_udp_datagram_t* datagrams, int count, libtock_udp_batch_callback cb);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,134 @@
+#include <string.h>
+
+#include "udp_sockets.h"
+
+// The UDP driver binds one port per app and its callbacks carry no context,
+// so the receive side is global.
+static struct {
+  sock_handle_t handle;
+  // The kernel writes the source of each datagram to the first address.
+  unsigned char bind_cfg[2 * sizeof(sock_addr_t)];
+  uint8_t buffer[LIBTOCK_UDP_SOCKETS_MAX_LEN];
+  libtock_udp_socket_t* sockets;
+  uint32_t unmatched;
+} udp;
+
+static bool is_zero(const uint8_t* p, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (p[i] != 0) return false;
+  }
+  return true;
+}
+
+static bool matches(const libtock_udp_socket_t* socket, const sock_addr_t* src) {
+  const sock_addr_t* remote = &socket->remote;
+  if (remote->port != 0 && remote->port != src->port) return false;
+  return is_zero(remote->addr.addr, sizeof(remote->addr.addr)) ||
+         memcmp(remote->addr.addr, src->addr.addr, sizeof(src->addr.addr)) == 0;
+}
+
+static void received(statuscode_t status, int length) {
+  if (status != TOCK_STATUSCODE_SUCCESS || length < 0) return;
+
+  sock_addr_t src;
+  memcpy(&src, udp.bind_cfg, sizeof(src));
+
+  libtock_udp_socket_t* socket = udp.sockets;
+  while (socket != NULL && !matches(socket, &src)) socket = socket->next;
+  if (socket == NULL) {
+    udp.unmatched++;
+    return;
+  }
+
+  size_t len = length > LIBTOCK_UDP_SOCKETS_MAX_LEN ? LIBTOCK_UDP_SOCKETS_MAX_LEN : (size_t) length;
+  if (socket->count == socket->slots ||
+      sizeof(libtock_udp_datagram_header_t) + len > socket->slot_size) {
+    socket->dropped++;
+    return;
+  }
+
+  int slot      = (socket->head + socket->count) % socket->slots;
+  uint8_t* dest = socket->storage + slot * socket->slot_size;
+  libtock_udp_datagram_header_t header = { .src = src, .len = len };
+  memcpy(dest, &header, sizeof(header));
+  memcpy(dest + sizeof(header), udp.buffer, len);
+  socket->count++;
+
+  if (socket->cb) socket->cb(socket, socket->opaque);
+}
+
+returncode_t libtock_udp_sockets_start(const sock_addr_t* local) {
+  sock_addr_t addr = *local;
+  returncode_t ret = libtock_udp_bind(&udp.handle, &addr, udp.bind_cfg);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  return libtock_udp_recv(udp.buffer, sizeof(udp.buffer), received);
+}
+
+returncode_t libtock_udp_sockets_stop(void) {
+  return libtock_udp_close(&udp.handle);
+}
+
+uint32_t libtock_udp_sockets_unmatched(void) {
+  return udp.unmatched;
+}
+
+returncode_t libtock_udp_socket_open(libtock_udp_socket_t* socket, const sock_addr_t* remote, uint8_t* storage,
+                                     size_t len, int slots, libtock_udp_socket_callback cb, void* opaque) {
+  if (slots <= 0 || len / slots <= sizeof(libtock_udp_datagram_header_t)) return RETURNCODE_EINVAL;
+
+  if (remote != NULL) {
+    socket->remote = *remote;
+  } else {
+    memset(&socket->remote, 0, sizeof(socket->remote));
+  }
+  socket->storage   = storage;
+  socket->slot_size = len / slots;
+  socket->slots     = slots;
+  socket->head      = 0;
+  socket->count     = 0;
+  socket->dropped   = 0;
+  socket->cb        = cb;
+  socket->opaque    = opaque;
+  socket->next      = NULL;
+
+  libtock_udp_socket_t** tail = &udp.sockets;
+  while (*tail != NULL) tail = &(*tail)->next;
+  *tail = socket;
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_udp_socket_close(libtock_udp_socket_t* socket) {
+  for (libtock_udp_socket_t** p = &udp.sockets; *p != NULL; p = &(*p)->next) {
+    if (*p == socket) {
+      *p = socket->next;
+      break;
+    }
+  }
+  socket->count = 0;
+}
+
+const uint8_t* libtock_udp_socket_peek(libtock_udp_socket_t* socket, size_t* len, sock_addr_t* src) {
+  if (socket->count == 0) return NULL;
+
+  const uint8_t* slot = socket->storage + socket->head * socket->slot_size;
+  libtock_udp_datagram_header_t header;
+  memcpy(&header, slot, sizeof(header));
+  *len = header.len;
+  if (src != NULL) *src = header.src;
+  return slot + sizeof(header);
+}
+
+void libtock_udp_socket_release(libtock_udp_socket_t* socket) {
+  if (socket->count == 0) return;
+  socket->head = (socket->head + 1) % socket->slots;
+  socket->count--;
+}
+
+int libtock_udp_socket_count(const libtock_udp_socket_t* socket) {
+  return socket->count;
+}
+
+uint32_t libtock_udp_socket_dropped(const libtock_udp_socket_t* socket) {
+  return socket->dropped;
+}
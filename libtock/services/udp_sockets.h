@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../net/udp.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Queued UDP reception for several services.
+//
+// The UDP driver binds a single port per app and has one receive buffer,
+// which it overwrites with the next datagram. The service keeps that buffer
+// with the kernel and, in the upcall, copies each datagram with its source
+// address into the queue of the first socket whose remote filter matches it,
+// so the app can take datagrams when it gets to them.
+//
+// Sockets share the bound local port and are told apart by their remote
+// address and port, either of which can be left as a wildcard. Sockets are
+// matched in the order they were opened, so a catch-all socket should be
+// opened last.
+//
+// A datagram that does not fit in its socket's queue, or is larger than a
+// slot, is dropped and counted by `libtock_udp_socket_dropped()`. Datagrams
+// that match no socket are counted by `libtock_udp_sockets_unmatched()`.
+
+// Largest datagram the service receives.
+#ifndef LIBTOCK_UDP_SOCKETS_MAX_LEN
+#define LIBTOCK_UDP_SOCKETS_MAX_LEN 200
+#endif
+
+// Header of each queued datagram.
+typedef struct {
+  sock_addr_t src;
+  uint16_t len;
+} libtock_udp_datagram_header_t;
+
+// Bytes of storage for `slots` datagrams of up to `max_len` bytes each.
+#define LIBTOCK_UDP_SOCKET_SLOT_SIZE(max_len) (sizeof(libtock_udp_datagram_header_t) + (max_len))
+#define LIBTOCK_UDP_SOCKET_STORAGE_LEN(slots, max_len) ((slots) * LIBTOCK_UDP_SOCKET_SLOT_SIZE(max_len))
+
+struct libtock_udp_socket;
+
+// Function signature for the receive callback, called after a datagram was
+// queued on the socket.
+//
+// - `arg1` (`struct libtock_udp_socket*`): The socket.
+// - `arg2` (`void*`): The opaque pointer passed to `libtock_udp_socket_open()`.
+typedef void (*libtock_udp_socket_callback)(struct libtock_udp_socket*, void*);
+
+typedef struct libtock_udp_socket {
+  // Remote filter. An all-zero address or port 0 matches any.
+  sock_addr_t remote;
+  uint8_t* storage;
+  size_t slot_size;
+  int slots;
+  int head;
+  int count;
+  uint32_t dropped;
+  libtock_udp_socket_callback cb;
+  void* opaque;
+  struct libtock_udp_socket* next;
+} libtock_udp_socket_t;
+
+// Bind `local` and start receiving. Datagrams that arrive before any socket
+// is open are counted as unmatched.
+returncode_t libtock_udp_sockets_start(const sock_addr_t* local);
+
+// Stop receiving and close the bound port. Open sockets keep their queued
+// datagrams.
+returncode_t libtock_udp_sockets_stop(void);
+
+// Number of datagrams that matched no socket.
+uint32_t libtock_udp_sockets_unmatched(void);
+
+// Open `socket` for datagrams from `remote`, or from anywhere if `remote` is
+// NULL, queued in `len` bytes of `storage`. The storage is split into
+// `slots` equal slots, each of which holds one datagram and its header;
+// `LIBTOCK_UDP_SOCKET_STORAGE_LEN()` sizes it. `cb` may be NULL.
+//
+// Returns RETURNCODE_EINVAL if a slot cannot hold a header.
+returncode_t libtock_udp_socket_open(libtock_udp_socket_t* socket, const sock_addr_t* remote, uint8_t* storage,
+                                     size_t len, int slots, libtock_udp_socket_callback cb, void* opaque);
+
+// Stop queueing datagrams on `socket`. Its queue is discarded.
+void libtock_udp_socket_close(libtock_udp_socket_t* socket);
+
+// The oldest queued datagram, or NULL if there is none. Its length and, if
+// `src` is not NULL, its source are written out. The datagram stays queued,
+// in place, until `libtock_udp_socket_release()`.
+const uint8_t* libtock_udp_socket_peek(libtock_udp_socket_t* socket, size_t* len, sock_addr_t* src);
+
+// Drop the oldest queued datagram.
+void libtock_udp_socket_release(libtock_udp_socket_t* socket);
+
+// Number of datagrams queued on `socket`.
+int libtock_udp_socket_count(const libtock_udp_socket_t* socket);
+
+// Number of datagrams dropped because the queue was full or a slot too small.
+uint32_t libtock_udp_socket_dropped(const libtock_udp_socket_t* socket);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,165 @@
+#include "usb_cdc.h"
+#include "../interface/syscalls/console_syscalls.h"
+
+#include <string.h>
+
+// The console upcalls carry no context, so the channel is global.
+static struct {
+  bool running;
+  libtock_usb_cdc_rx_callback rx_cb;
+  libtock_usb_cdc_tx_callback tx_cb;
+
+  uint8_t tx_buf[2][LIBTOCK_USB_CDC_BUFFER_LEN];
+  uint32_t tx_len[2];
+  // Buffer taking new bytes. While idle it is always empty.
+  uint8_t filling;
+  bool sending;
+
+  uint8_t rx_buf[2][LIBTOCK_USB_CDC_BUFFER_LEN];
+  // Buffer the outstanding read goes into.
+  uint8_t receiving;
+  uint32_t rx_chunk;
+  bool rx_armed;
+} cdc;
+
+// Send the filling buffer and switch to the other one.
+static returncode_t send_filling(void) {
+  uint8_t buf = cdc.filling;
+
+  returncode_t ret = libtock_console_set_read_allow(cdc.tx_buf[buf], cdc.tx_len[buf]);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_console_command_write((int) cdc.tx_len[buf]);
+  if (ret != RETURNCODE_SUCCESS) {
+    cdc.tx_len[buf] = 0;
+    return ret;
+  }
+
+  cdc.sending         = true;
+  cdc.filling         = buf ^ 1;
+  cdc.tx_len[buf ^ 1] = 0;
+  return RETURNCODE_SUCCESS;
+}
+
+static void write_upcall(int status, __attribute__ ((unused)) int length,
+                         __attribute__ ((unused)) int unused,
+                         __attribute__ ((unused)) void* opaque) {
+  // A transfer started before `libtock_usb_cdc_stop()` has nothing to report.
+  if (!cdc.running || !cdc.sending) return;
+  cdc.sending = false;
+
+  returncode_t ret = tock_status_to_returncode((statuscode_t) status);
+  if (ret == RETURNCODE_SUCCESS && cdc.tx_len[cdc.filling] > 0) {
+    // The next buffer goes out before the app hears about anything.
+    ret = send_filling();
+    if (ret == RETURNCODE_SUCCESS) return;
+  }
+
+  cdc.tx_len[cdc.filling] = 0;
+  if (cdc.tx_cb != NULL) cdc.tx_cb(ret);
+}
+
+static returncode_t arm_read(void) {
+  returncode_t ret = libtock_console_set_readwrite_allow(cdc.rx_buf[cdc.receiving], cdc.rx_chunk);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  ret = libtock_console_command_read((int) cdc.rx_chunk);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  cdc.rx_armed = true;
+  return RETURNCODE_SUCCESS;
+}
+
+static void read_upcall(int status, int length, __attribute__ ((unused)) int unused,
+                        __attribute__ ((unused)) void* opaque) {
+  if (!cdc.running || !cdc.rx_armed) return;
+  cdc.rx_armed = false;
+
+  uint8_t filled    = cdc.receiving;
+  uint32_t received = (uint32_t) length;
+  if (received > cdc.rx_chunk) received = cdc.rx_chunk;
+  cdc.receiving ^= 1;
+
+  // Keep receiving into the other buffer while the app looks at this one. A
+  // failed read is not retried, as it would likely fail again.
+  returncode_t ret = tock_status_to_returncode((statuscode_t) status);
+  if (ret == RETURNCODE_SUCCESS || ret == RETURNCODE_ECANCEL) arm_read();
+
+  if (received > 0) cdc.rx_cb(cdc.rx_buf[filled], received);
+}
+
+returncode_t libtock_usb_cdc_start(uint32_t rx_chunk, libtock_usb_cdc_rx_callback rx_cb,
+                                   libtock_usb_cdc_tx_callback tx_cb) {
+  if (rx_cb != NULL && (rx_chunk == 0 || rx_chunk > LIBTOCK_USB_CDC_BUFFER_LEN)) return RETURNCODE_EINVAL;
+  if (cdc.running) return RETURNCODE_EBUSY;
+
+  returncode_t ret = libtock_console_write_done_set_upcall(write_upcall, NULL);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtock_console_read_done_set_upcall(read_upcall, NULL);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  cdc.rx_cb     = rx_cb;
+  cdc.tx_cb     = tx_cb;
+  cdc.tx_len[0] = 0;
+  cdc.tx_len[1] = 0;
+  cdc.filling   = 0;
+  cdc.sending   = false;
+  cdc.receiving = 0;
+  cdc.rx_chunk  = rx_chunk;
+  cdc.rx_armed  = false;
+  cdc.running   = true;
+
+  if (rx_cb == NULL) return RETURNCODE_SUCCESS;
+  ret = arm_read();
+  if (ret != RETURNCODE_SUCCESS) cdc.running = false;
+  return ret;
+}
+
+returncode_t libtock_usb_cdc_stop(void) {
+  if (!cdc.running) return RETURNCODE_EALREADY;
+
+  cdc.running = false;
+  if (cdc.rx_armed) {
+    cdc.rx_armed = false;
+    libtock_console_command_abort_read();
+  }
+  return libtock_console_set_readwrite_allow(NULL, 0);
+}
+
+uint32_t libtock_usb_cdc_write(const uint8_t* data, uint32_t len) {
+  if (!cdc.running) return 0;
+
+  uint32_t queued = 0;
+  while (queued < len) {
+    uint8_t buf   = cdc.filling;
+    uint32_t room = LIBTOCK_USB_CDC_BUFFER_LEN - cdc.tx_len[buf];
+    if (room == 0) break;
+
+    uint32_t n = len - queued;
+    if (n > room) n = room;
+    memcpy(cdc.tx_buf[buf] + cdc.tx_len[buf], data + queued, n);
+    cdc.tx_len[buf] += n;
+
+    if (!cdc.sending) {
+      // The filling buffer only held these bytes, so a failed send queues
+      // nothing.
+      if (send_filling() != RETURNCODE_SUCCESS) break;
+    }
+    queued += n;
+  }
+  return queued;
+}
+
+uint32_t libtock_usb_cdc_tx_space(void) {
+  if (!cdc.running) return 0;
+  if (!cdc.sending) return 2 * LIBTOCK_USB_CDC_BUFFER_LEN;
+  return LIBTOCK_USB_CDC_BUFFER_LEN - cdc.tx_len[cdc.filling];
+}
+
+bool libtock_usb_cdc_tx_busy(void) {
+  return cdc.running && cdc.sending;
+}
+
+returncode_t libtock_usb_cdc_rx_flush(void) {
+  if (!cdc.running) return RETURNCODE_EOFF;
+  if (!cdc.rx_armed) return RETURNCODE_SUCCESS;
+  return libtock_console_command_abort_read();
+}
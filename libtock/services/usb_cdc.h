@@ -0,0 +1,79 @@
+/*
+ * Double-buffered USB CDC data channel.
+ *
+ * Tock does not give apps their own USB endpoints. On boards with USB, the
+ * kernel's CDC-ACM device carries the console driver, so that driver is the
+ * bulk data link to the host. This service runs the console driver as a raw
+ * byte channel with two buffers in each direction, which keeps the link busy
+ * without ever waiting on the app:
+ *
+ * - TX: `libtock_usb_cdc_write()` copies into the buffer that is not being
+ *   sent and returns at once. When a transfer completes, the filled buffer
+ *   goes out from the upcall, before any app code runs.
+ * - RX: when a read completes, the read into the other buffer is started
+ *   before the callback gets the filled one, so the host can keep sending
+ *   while the app handles the data.
+ *
+ * While running, this service owns both console upcalls and allows, so
+ * `printf()` and the other console functions must not be used. On boards
+ * whose console is a UART the channel runs over that UART instead.
+ */
+
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Size of each of the four buffers.
+#ifndef LIBTOCK_USB_CDC_BUFFER_LEN
+#define LIBTOCK_USB_CDC_BUFFER_LEN 256
+#endif
+
+// Function signature for receive callbacks.
+//
+// - `arg1` (`const uint8_t*`): Received bytes. They are only valid until the
+//   callback returns.
+// - `arg2` (`uint32_t`): Number of bytes.
+typedef void (*libtock_usb_cdc_rx_callback)(const uint8_t*, uint32_t);
+
+// Function signature for transmit callbacks.
+//
+// - `arg1` (`returncode_t`): SUCCESS once every queued byte has been sent, or
+//   the error that stopped sending. Bytes still queued are discarded on error.
+typedef void (*libtock_usb_cdc_tx_callback)(returncode_t);
+
+// Start the channel. Reads complete once `rx_chunk` bytes have arrived, at
+// most `LIBTOCK_USB_CDC_BUFFER_LEN`. Either callback may be NULL, a NULL
+// `rx_cb` leaves receiving off.
+//
+// Returns RETURNCODE_EINVAL if `rx_chunk` is 0 or too large with a receive
+// callback, RETURNCODE_EBUSY if the channel is already running, or the error
+// from starting the first read.
+returncode_t libtock_usb_cdc_start(uint32_t rx_chunk, libtock_usb_cdc_rx_callback rx_cb,
+                                   libtock_usb_cdc_tx_callback tx_cb);
+
+// Stop the channel. The outstanding read is aborted and its bytes are
+// discarded. A transfer in flight still completes, but nothing queued after
+// it is sent and no callback follows.
+returncode_t libtock_usb_cdc_stop(void);
+
+// Queue up to `len` bytes for sending. Returns the number queued, which is
+// less than `len` once both buffers are full, and 0 when not running.
+uint32_t libtock_usb_cdc_write(const uint8_t* data, uint32_t len);
+
+// Number of bytes `libtock_usb_cdc_write()` would accept now.
+uint32_t libtock_usb_cdc_tx_space(void);
+
+// True while queued bytes have not all been sent.
+bool libtock_usb_cdc_tx_busy(void);
+
+// Complete the outstanding read early, so bytes received short of `rx_chunk`
+// are delivered. Receiving continues afterwards.
+returncode_t libtock_usb_cdc_rx_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
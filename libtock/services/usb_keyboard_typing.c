@@ -0,0 +1,103 @@
+#include <string.h>
+
+#include "usb_keyboard_typing.h"
+
+// The kernel takes the report from the start of a 64 byte buffer.
+#define REPORT_BUFFER_LEN 64
+
+// The keyboard callbacks carry no context, so the string being typed is
+// global.
+static struct {
+  bool busy;
+  const char* str;
+  int len;
+  int pos;
+  // Key in the last report sent, or 0 if it released all keys.
+  uint8_t pressed;
+  uint8_t report[REPORT_BUFFER_LEN];
+  libtock_usb_keyboard_typing_callback cb;
+} typing;
+
+// Skip to the next character that can be typed and look it up.
+static bool next_key(uint8_t* modifier, uint8_t* key) {
+  while (typing.pos < typing.len) {
+    if (libtock_usb_keyboard_hid_keycode(typing.str[typing.pos], modifier, key)) return true;
+    typing.pos++;
+  }
+  return false;
+}
+
+static void finish(returncode_t ret) {
+  typing.busy = false;
+  libtock_usb_keyboard_hid_set_readwrite_allow_send_buffer(NULL, 0);
+  typing.cb(ret);
+}
+
+// Fill in the next report. Returns false once the string is done and all
+// keys are released.
+static bool fill_report(void) {
+  uint8_t modifier = 0;
+  uint8_t key      = 0;
+  bool more        = next_key(&modifier, &key);
+
+  if (typing.pressed != 0 && (!more || key == typing.pressed)) {
+    // Release so the host sees the same key twice, or at the end.
+    memset(typing.report, 0, 8);
+    typing.pressed = 0;
+    return true;
+  }
+  if (!more) return false;
+
+  memset(typing.report, 0, 8);
+  typing.report[0] = modifier;
+  typing.report[2] = key;
+  typing.pressed   = key;
+  typing.pos++;
+  return true;
+}
+
+static void send_next(void) {
+  if (!fill_report()) {
+    finish(RETURNCODE_SUCCESS);
+    return;
+  }
+
+  returncode_t ret = libtock_usb_keyboard_hid_command_send();
+  // The driver sometimes reports ERESERVE although the report goes out.
+  if (ret != RETURNCODE_SUCCESS && ret != RETURNCODE_ERESERVE) finish(ret);
+}
+
+static void report_sent(__attribute__ ((unused)) int callback_type,
+                        __attribute__ ((unused)) int unused1,
+                        __attribute__ ((unused)) int unused2,
+                        __attribute__ ((unused)) void* opaque) {
+  send_next();
+}
+
+returncode_t libtock_usb_keyboard_hid_type(const char* str, int len, libtock_usb_keyboard_typing_callback cb) {
+  if (typing.busy) return RETURNCODE_EBUSY;
+
+  typing.str     = str;
+  typing.len     = len;
+  typing.pos     = 0;
+  typing.pressed = 0;
+  typing.cb      = cb;
+
+  uint8_t modifier, key;
+  if (!next_key(&modifier, &key)) return RETURNCODE_EALREADY;
+
+  returncode_t err = libtock_usb_keyboard_hid_set_upcall(report_sent, NULL);
+  if (err != RETURNCODE_SUCCESS) return err;
+  err = libtock_usb_keyboard_hid_set_readwrite_allow_send_buffer(typing.report, sizeof(typing.report));
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  typing.busy = true;
+  fill_report();
+  err = libtock_usb_keyboard_hid_command_send();
+  if (err != RETURNCODE_SUCCESS && err != RETURNCODE_ERESERVE) {
+    typing.busy = false;
+    libtock_usb_keyboard_hid_set_readwrite_allow_send_buffer(NULL, 0);
+    return err;
+  }
+  return RETURNCODE_SUCCESS;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../interface/usb_keyboard_hid.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Typing strings on the USB HID keyboard.
+//
+// The send buffer is shared with the kernel and the upcall subscribed once
+// per string. Each report then costs a single command, issued from the
+// previous report's upcall, so the string streams at the host's poll rate
+// with one callback at the end.
+//
+// A key is released only before it is pressed again and at the end of the
+// string. Pressing a different key replaces the previous one in the report,
+// so most characters take a single report instead of a press and a release.
+//
+// Characters without a US keyboard key code are skipped.
+
+// Function signature for the typing done callback.
+//
+// - `arg1` (`returncode_t`): Status of the first report that failed, or
+//   RETURNCODE_SUCCESS.
+typedef void (*libtock_usb_keyboard_typing_callback)(returncode_t);
+
+// Type the `len` characters of `str`. `str` must stay valid until `cb`.
+//
+// Returns RETURNCODE_EALREADY if there is nothing to type, in which case no
+// callback follows, and RETURNCODE_EBUSY if a string is being typed.
+returncode_t libtock_usb_keyboard_hid_type(const char* str, int len, libtock_usb_keyboard_typing_callback cb);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,143 @@
+#include "alarm.h"
+#include "time.h"
+#include "wall_clock.h"
+
+#define US_PER_S 1000000ULL
+
+// The RTC callback carries no context, so the clock is global.
+static struct {
+  bool valid;
+  bool reading;
+  // Wall-clock time at monotonic time `sync_mono_us`.
+  uint64_t sync_wall_us;
+  uint64_t sync_mono_us;
+  uint32_t resync_ms;
+  libtock_wall_clock_callback cb;
+  libtock_alarm_t alarm;
+} wall;
+
+static uint64_t now_us(void) {
+  return wall.sync_wall_us + (libtock_time_now_us64() - wall.sync_mono_us);
+}
+
+static void resync(uint32_t now, uint32_t scheduled, void* opaque);
+
+static void date_read(returncode_t ret, libtock_rtc_date_t date) {
+  // The RTC second began at most one second before now.
+  uint64_t mono_us = libtock_time_now_us64();
+  wall.reading = false;
+
+  if (ret == RETURNCODE_SUCCESS) {
+    uint64_t second_us = libtock_wall_clock_date_to_seconds(&date) * US_PER_S;
+    uint64_t wall_us   = second_us;
+    if (wall.valid) {
+      // Keep our sub-second phase unless it has left the RTC's second.
+      wall_us = wall.sync_wall_us + (mono_us - wall.sync_mono_us);
+      if (wall_us < second_us) {
+        wall_us = second_us;
+      } else if (wall_us >= second_us + US_PER_S) {
+        wall_us = second_us + US_PER_S - 1;
+      }
+    }
+    wall.sync_wall_us = wall_us;
+    wall.sync_mono_us = mono_us;
+  }
+
+  bool first = !wall.valid;
+  if (ret == RETURNCODE_SUCCESS) wall.valid = true;
+
+  if (wall.resync_ms != 0) {
+    libtock_alarm_in_ms(wall.resync_ms, resync, NULL, &wall.alarm);
+  }
+  if (first && wall.cb != NULL) {
+    libtock_wall_clock_callback cb = wall.cb;
+    wall.cb = NULL;
+    cb(ret);
+  }
+}
+
+static returncode_t read_rtc(void) {
+  if (wall.reading) return RETURNCODE_EBUSY;
+  returncode_t ret = libtock_rtc_get_date(date_read);
+  if (ret == RETURNCODE_SUCCESS) wall.reading = true;
+  return ret;
+}
+
+static void resync(__attribute__ ((unused)) uint32_t now, __attribute__ ((unused)) uint32_t scheduled,
+                   __attribute__ ((unused)) void* opaque) {
+  // A read still outstanding after a whole interval was lost, e.g. to an
+  // app's own RTC read replacing the upcall.
+  wall.reading = false;
+  if (read_rtc() != RETURNCODE_SUCCESS && wall.resync_ms != 0) {
+    // Try again after the next interval.
+    libtock_alarm_in_ms(wall.resync_ms, resync, NULL, &wall.alarm);
+  }
+}
+
+returncode_t libtock_wall_clock_start(uint32_t resync_ms, libtock_wall_clock_callback cb) {
+  libtock_alarm_ms_cancel(&wall.alarm);
+  wall.resync_ms = resync_ms;
+  wall.cb        = cb;
+  return read_rtc();
+}
+
+void libtock_wall_clock_stop(void) {
+  wall.resync_ms = 0;
+  libtock_alarm_ms_cancel(&wall.alarm);
+}
+
+bool libtock_wall_clock_valid(void) {
+  return wall.valid;
+}
+
+returncode_t libtock_wall_clock_now_us(uint64_t* us) {
+  if (!wall.valid) return RETURNCODE_EOFF;
+  *us = now_us();
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_wall_clock_now(libtock_rtc_date_t* date) {
+  if (!wall.valid) return RETURNCODE_EOFF;
+  libtock_wall_clock_seconds_to_date(now_us() / US_PER_S, date);
+  return RETURNCODE_SUCCESS;
+}
+
+// Days since 1970-01-01 of a date in the proleptic Gregorian calendar, with
+// years starting in March so the leap day is last.
+static int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  int64_t era    = (y >= 0 ? y : y - 399) / 400;
+  unsigned yoe   = (unsigned) (y - era * 400);
+  unsigned doy   = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  unsigned doe   = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + (int64_t) doe - 719468;
+}
+
+uint64_t libtock_wall_clock_date_to_seconds(const libtock_rtc_date_t* date) {
+  int64_t days = days_from_civil(date->year, (unsigned) date->month, (unsigned) date->day);
+  if (days < 0) return 0;
+  return (uint64_t) days * 86400 + date->hour * 3600 + date->minute * 60 + date->seconds;
+}
+
+void libtock_wall_clock_seconds_to_date(uint64_t seconds, libtock_rtc_date_t* date) {
+  uint64_t days = seconds / 86400;
+  uint32_t secs = (uint32_t) (seconds % 86400);
+
+  // Inverse of `days_from_civil()`.
+  uint64_t z   = days + 719468;
+  uint64_t era = z / 146097;
+  unsigned doe = (unsigned) (z - era * 146097);
+  unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  unsigned mp  = (5 * doy + 2) / 153;
+  unsigned m   = mp < 10 ? mp + 3 : mp - 9;
+
+  date->year        = (int) (yoe + era * 400 + (m <= 2));
+  date->month       = (int) m;
+  date->day         = (int) (doy - (153 * mp + 2) / 5 + 1);
+  // 1970-01-01 was a Thursday.
+  date->day_of_week = (int) ((days + THURSDAY) % 7);
+  date->hour        = (int) (secs / 3600);
+  date->minute      = (int) (secs / 60 % 60);
+  date->seconds     = (int) (secs % 60);
+}
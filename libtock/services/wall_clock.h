@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../peripherals/rtc.h"
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wall-clock time without reading the RTC for every timestamp.
+//
+// Reading the RTC is a system call and, for RTCs on I2C, a bus transaction,
+// too slow to timestamp every log record. The wall clock reads the RTC once
+// and from then on adds the time elapsed on the monotonic clock of
+// `libtock/services/time.h`, which is a local computation once that clock
+// uses the read-only state region.
+//
+// The tick clock drifts against the RTC, so the wall clock reads the RTC
+// again every `resync_ms`. The RTC counts whole seconds, so the chosen time
+// is only moved when it falls outside the second the RTC reports, and then to
+// the nearest edge of that second. Sub-second resolution is kept and the clock
+// never jumps by more than the drift. While a resync reads the RTC, the app
+// must not use `libtock_rtc_get_date()` itself.
+//
+// Times are microseconds since 1970-01-01 00:00:00, in whatever time zone the
+// RTC is set to.
+
+// Function signature for the first synchronization.
+//
+// - `arg1` (`returncode_t`): Status of the first RTC read.
+typedef void (*libtock_wall_clock_callback)(returncode_t);
+
+// Read the RTC, call `cb` once the wall clock is valid, and resync every
+// `resync_ms` milliseconds, or never if 0. `cb` may be NULL.
+returncode_t libtock_wall_clock_start(uint32_t resync_ms, libtock_wall_clock_callback cb);
+
+// Stop resynchronizing. The clock stays valid and keeps running from the
+// last RTC read.
+void libtock_wall_clock_stop(void);
+
+// Whether the RTC has been read at least once.
+bool libtock_wall_clock_valid(void);
+
+// Current time in microseconds since the epoch. Returns RETURNCODE_EOFF if
+// the RTC has not been read yet.
+returncode_t libtock_wall_clock_now_us(uint64_t* us);
+
+// Current date and time. Returns RETURNCODE_EOFF if the RTC has not been
+// read yet.
+returncode_t libtock_wall_clock_now(libtock_rtc_date_t* date);
+
+// Convert between dates and seconds since the epoch. Years from 1970 on are
+// supported.
+uint64_t libtock_wall_clock_date_to_seconds(const libtock_rtc_date_t* date);
+void libtock_wall_clock_seconds_to_date(uint64_t seconds, libtock_rtc_date_t* date);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,143 @@
+#include "work.h"
+
+// Queued items of one priority, oldest first. The work upcalls carry no
+// context beyond the queue, so the queues are global.
+typedef struct {
+  libtock_work_t* head;
+  libtock_work_t* tail;
+  // Whether a task to run the queue is in the task queue.
+  bool scheduled;
+} work_queue_t;
+
+static work_queue_t queues[TOCK_TASK_PRIO_COUNT];
+
+static void run_queue(int prio, int arg1, int arg2, void* ud);
+
+static bool schedule(tock_task_prio_t prio) {
+  if (queues[prio].scheduled) return true;
+  if (tock_enqueue_prio(prio, run_queue, prio, 0, 0, NULL) < 0) return false;
+  queues[prio].scheduled = true;
+  return true;
+}
+
+static void append(libtock_work_t* work) {
+  work_queue_t* q = &queues[work->prio];
+  work->next   = NULL;
+  work->queued = true;
+  if (q->tail == NULL) {
+    q->head = work;
+  } else {
+    q->tail->next = work;
+  }
+  q->tail = work;
+}
+
+static libtock_work_t* pop(work_queue_t* q) {
+  libtock_work_t* work = q->head;
+  q->head = work->next;
+  if (q->head == NULL) q->tail = NULL;
+  work->next   = NULL;
+  work->queued = false;
+  return work;
+}
+
+static void run_queue(int prio, __attribute__ ((unused)) int arg1, __attribute__ ((unused)) int arg2,
+                      __attribute__ ((unused)) void* ud) {
+  work_queue_t* q = &queues[prio];
+  q->scheduled = false;
+
+  // Run the items queued so far. Items submitted meanwhile, including
+  // resubmitted ones, wait for the next task so other tasks get their turn,
+  // unless the task queue is full, in which case they run now.
+  libtock_work_t* last = q->tail;
+  while (q->head != NULL) {
+    bool final = q->head == last;
+    libtock_work_t* work = pop(q);
+    work->handler(work);
+    // `last` may also have been cancelled by a handler.
+    if ((final || !last->queued) && (q->head == NULL || schedule((tock_task_prio_t) prio))) return;
+  }
+}
+
+static void delay_expired(__attribute__ ((unused)) uint32_t now, __attribute__ ((unused)) uint32_t scheduled,
+                          void* opaque) {
+  libtock_work_t* work = (libtock_work_t*) opaque;
+  work->delayed = false;
+  // The task queue can only be full here if nothing drains it, and then the
+  // item could not run anyway; try again shortly.
+  if (libtock_work_submit(work) != RETURNCODE_SUCCESS) {
+    libtock_work_submit_delayed(work, 1);
+  }
+}
+
+void libtock_work_init(libtock_work_t* work, libtock_work_handler handler, void* ud) {
+  *work = (libtock_work_t) {
+    .handler = handler,
+    .ud      = ud,
+    .prio    = TOCK_TASK_PRIO_NORMAL,
+  };
+}
+
+returncode_t libtock_work_set_prio(libtock_work_t* work, tock_task_prio_t prio) {
+  if (prio >= TOCK_TASK_PRIO_COUNT) return RETURNCODE_EINVAL;
+  if (libtock_work_pending(work)) return RETURNCODE_EBUSY;
+  work->prio = prio;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_work_submit(libtock_work_t* work) {
+  if (work->delayed) {
+    libtock_alarm_ms_cancel(&work->alarm);
+    work->delayed = false;
+  }
+  if (work->queued) return RETURNCODE_SUCCESS;
+
+  if (!schedule(work->prio)) return RETURNCODE_ENOMEM;
+  append(work);
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_work_submit_delayed(libtock_work_t* work, uint32_t ms) {
+  if (libtock_work_pending(work)) return RETURNCODE_SUCCESS;
+  if (ms == 0) return libtock_work_submit(work);
+
+  int ret = libtock_alarm_in_ms(ms, delay_expired, work, &work->alarm);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  work->delayed = true;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_work_reschedule(libtock_work_t* work, uint32_t ms) {
+  libtock_work_cancel(work);
+  return libtock_work_submit_delayed(work, ms);
+}
+
+bool libtock_work_cancel(libtock_work_t* work) {
+  bool was_pending = libtock_work_pending(work);
+
+  if (work->delayed) {
+    libtock_alarm_ms_cancel(&work->alarm);
+    work->delayed = false;
+  }
+
+  if (work->queued) {
+    work_queue_t* q       = &queues[work->prio];
+    libtock_work_t** link = &q->head;
+    libtock_work_t* prev  = NULL;
+    while (*link != work) {
+      prev = *link;
+      link = &(*link)->next;
+    }
+    *link = work->next;
+    if (q->tail == work) q->tail = prev;
+    work->next   = NULL;
+    work->queued = false;
+    // A task left scheduled for an empty queue finds nothing to run.
+  }
+
+  return was_pending;
+}
+
+bool libtock_work_pending(const libtock_work_t* work) {
+  return work->queued || work->delayed;
+}
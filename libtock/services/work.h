@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "../tock.h"
+#include "alarm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Deferred work items.
+//
+// A work item is a function to run later from the main loop, outside the
+// upcall or callback that asked for it. Items are structs the caller embeds
+// in its own state, so queueing never allocates and never fails for lack of
+// slots:
+//
+//     static libtock_work_t rx_work;
+//
+//     static void rx_handler(libtock_work_t* work) { ... }
+//
+//     libtock_work_init(&rx_work, rx_handler, NULL);
+//     ...
+//     // In an upcall:
+//     libtock_work_submit(&rx_work);
+//
+// Submitting an item that is already queued does nothing, so an upcall that
+// fires again before its work ran costs one run of the handler, which
+// replaces the usual "pending flag" checked from the main loop. Items run in
+// the order they were submitted, from `yield()` like tasks queued with
+// `tock_enqueue()`. A pending item can be cancelled, and delayed work uses
+// the item's own alarm.
+//
+// All queued items of a priority share one slot of the task queue, so the
+// work queue cannot crowd out other deferred tasks.
+
+struct libtock_work;
+
+// Function signature for work handlers.
+//
+// - `arg1` (`libtock_work_t*`): The item that ran. Its `ud` field holds the
+//   pointer passed to `libtock_work_init()`. The handler may submit the item
+//   again.
+typedef void (*libtock_work_handler)(struct libtock_work*);
+
+typedef struct libtock_work {
+  libtock_work_handler handler;
+  void* ud;
+  tock_task_prio_t prio;
+  // Whether the item is queued to run, or waiting for its delay.
+  bool queued;
+  bool delayed;
+  struct libtock_work* next;
+  libtock_alarm_t alarm;
+} libtock_work_t;
+
+// Set up `work` to call `handler` with normal priority. `work` must live as
+// long as it is queued or delayed.
+void libtock_work_init(libtock_work_t* work, libtock_work_handler handler, void* ud);
+
+// Run `work` with priority `prio` from now on. Items of `TOCK_TASK_PRIO_HIGH`
+// run before normal priority tasks. Must not be called while `work` is
+// pending.
+returncode_t libtock_work_set_prio(libtock_work_t* work, tock_task_prio_t prio);
+
+// Queue `work` to run the next time the app yields. Does nothing if it is
+// already queued. A pending delay is cancelled, as the item runs now.
+//
+// Returns RETURNCODE_ENOMEM only if nothing of this priority was queued and
+// the task queue is full.
+returncode_t libtock_work_submit(libtock_work_t* work);
+
+// Queue `work` to run in `ms` milliseconds. Does nothing if it is already
+// delayed or queued; use `libtock_work_reschedule()` to move the deadline.
+returncode_t libtock_work_submit_delayed(libtock_work_t* work, uint32_t ms);
+
+// Queue `work` to run in `ms` milliseconds, replacing any earlier submission.
+returncode_t libtock_work_reschedule(libtock_work_t* work, uint32_t ms);
+
+// Stop `work` from running, whether it is queued or delayed. Returns true if
+// it was pending. A handler that is already running is not stopped.
+bool libtock_work_cancel(libtock_work_t* work);
+
+// Whether `work` is queued or delayed.
+bool libtock_work_pending(const libtock_work_t* work);
+
+#ifdef __cplusplus
+}
+#endif
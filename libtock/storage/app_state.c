@@ -1,30 +1,130 @@
 #include <string.h>
 
+#include "../peripherals/crc_soft.h"
 #include "app_state.h"
+#include "writeable_flash.h"
 
+#define PAGE LIBTOCK_APP_STATE_PAGE_SIZE
+
+// Copy holding the current state, or -1 if neither copy is valid.
+static int current = -1;
+static uint32_t current_seq = 0;
+
+// Progress of the running save.
+static struct {
+  bool busy;
+  int target;
+  // Next data page to compare, or `page_count` once the header is being
+  // written.
+  uint32_t page;
+  libtock_app_state_header_t header;
+  libtock_app_state_callback cb;
+} save;
+
+static uint8_t* copy_base(int copy) {
+  return (uint8_t*) _app_state_flash_pointer + copy * LIBTOCK_APP_STATE_COPY_SIZE(_app_state_size);
+}
+
+static uint8_t* copy_data(int copy) {
+  return copy_base(copy) + PAGE;
+}
+
+static uint32_t page_count(void) {
+  return (_app_state_size + PAGE - 1) / PAGE;
+}
+
+static uint32_t page_length(uint32_t page) {
+  uint32_t remaining = _app_state_size - page * PAGE;
+  return remaining < PAGE ? remaining : PAGE;
+}
+
+static bool copy_valid(int copy, uint32_t* seq) {
+  libtock_app_state_header_t header;
+  memcpy(&header, copy_base(copy), sizeof(header));
+  if (header.magic != LIBTOCK_APP_STATE_MAGIC || header.size != _app_state_size) return false;
+  if (header.crc != libtock_crc_soft_crc32_small(0, copy_data(copy), _app_state_size)) return false;
+  *seq = header.seq;
+  return true;
+}
+
+static returncode_t write_flash(const void* data, uint32_t len, uint8_t* dest) {
+  returncode_t ret = libtock_app_state_set_readonly_allow(data, len);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  return libtock_app_state_command_save((uint32_t) dest);
+}
+
+// Write the next data page that differs from the target copy, or the header
+// once none is left.
+static returncode_t save_next(void) {
+  const uint8_t* ram = _app_state_ram_pointer;
+  uint8_t* data      = copy_data(save.target);
+
+  for (; save.page < page_count(); save.page++) {
+    uint32_t offset = save.page * PAGE;
+    uint32_t len    = page_length(save.page);
+    if (memcmp(ram + offset, data + offset, len) != 0) return write_flash(ram + offset, len, data + offset);
+  }
+
+  // The CRC covers what reached flash, in case the state changed during the
+  // save.
+  save.header.magic = LIBTOCK_APP_STATE_MAGIC;
+  save.header.seq   = current_seq + 1;
+  save.header.crc   = libtock_crc_soft_crc32_small(0, data, _app_state_size);
+  save.header.size  = _app_state_size;
+  return write_flash(&save.header, sizeof(save.header), copy_base(save.target));
+}
+
+static void save_finish(returncode_t ret) {
+  libtock_app_state_set_readonly_allow(NULL, 0);
+  save.busy = false;
+  save.cb(ret);
+}
 
-// Internal callback for synchronous interfaces
 static void app_state_upcall(__attribute__ ((unused)) int callback_type,
                              __attribute__ ((unused)) int value,
                              __attribute__ ((unused)) int unused,
-                             void*                        opaque) {
-  libtock_app_state_callback cb = (libtock_app_state_callback) opaque;
-  cb(RETURNCODE_SUCCESS);
-}
+                             __attribute__ ((unused)) void* opaque) {
+  if (!save.busy) return;
 
+  // Later comparisons and the CRC read the copy being written.
+  libtock_writeable_flash_invalidate(copy_base(save.target), LIBTOCK_APP_STATE_COPY_SIZE(_app_state_size));
 
-static returncode_t app_state_init(void) {
-  returncode_t ret;
+  if (save.page < page_count()) {
+    save.page++;
+    returncode_t ret = save_next();
+    if (ret != RETURNCODE_SUCCESS) save_finish(ret);
+    return;
+  }
 
-  ret = libtock_app_state_set_readonly_allow(_app_state_ram_pointer, _app_state_size);
-  if (ret != RETURNCODE_SUCCESS) return ret;
+  current     = save.target;
+  current_seq = save.header.seq;
+  save_finish(RETURNCODE_SUCCESS);
+}
 
+
+static returncode_t app_state_init(void) {
   // Check that we have a region to use for this.
   int number_regions = tock_app_number_writeable_flash_regions();
   if (number_regions == 0) return RETURNCODE_ENOMEM;
 
   // Get the pointer to flash which we need to ask the kernel where it is.
   _app_state_flash_pointer = tock_app_writeable_flash_region_begins_at(0);
+  uint8_t* end = tock_app_writeable_flash_region_ends_at(0);
+  if ((size_t) (end - (uint8_t*) _app_state_flash_pointer) < 2 * LIBTOCK_APP_STATE_COPY_SIZE(_app_state_size)) {
+    return RETURNCODE_ENOMEM;
+  }
+
+  // Use the newest valid copy.
+  uint32_t seq[2];
+  bool valid[2] = { copy_valid(0, &seq[0]), copy_valid(1, &seq[1]) };
+  if (valid[0] && valid[1]) {
+    current = (int32_t) (seq[1] - seq[0]) > 0 ? 1 : 0;
+  } else if (valid[0] || valid[1]) {
+    current = valid[0] ? 0 : 1;
+  } else {
+    current = -1;
+  }
+  current_seq = current >= 0 ? seq[current] : 0;
 
   _app_state_inited = true;
   return RETURNCODE_SUCCESS;
@@ -37,7 +137,9 @@ returncode_t libtock_app_state_load(void) {
     if (err != RETURNCODE_SUCCESS) return err;
   }
 
-  memcpy(_app_state_ram_pointer, _app_state_flash_pointer, _app_state_size);
+  // With no valid copy, hand the app whatever flash holds, as it checks its
+  // own markers.
+  memcpy(_app_state_ram_pointer, copy_data(current >= 0 ? current : 0), _app_state_size);
   return RETURNCODE_SUCCESS;
 }
 
@@ -48,10 +150,24 @@ returncode_t libtock_app_state_save(libtock_app_state_callback cb) {
     err = app_state_init();
     if (err != RETURNCODE_SUCCESS) return err;
   }
+  if (save.busy) return RETURNCODE_EBUSY;
 
-  err = libtock_app_state_set_upcall(app_state_upcall, (void*) cb);
+  if (current >= 0 && memcmp(_app_state_ram_pointer, copy_data(current), _app_state_size) == 0) {
+    return RETURNCODE_EALREADY;
+  }
+
+  err = libtock_app_state_set_upcall(app_state_upcall, NULL);
   if (err != RETURNCODE_SUCCESS) return err;
 
-  err = libtock_app_state_command_save((uint32_t) _app_state_flash_pointer);
+  save.busy   = true;
+  save.target = current == 0 ? 1 : 0;
+  save.page   = 0;
+  save.cb     = cb;
+
+  err = save_next();
+  if (err != RETURNCODE_SUCCESS) {
+    libtock_app_state_set_readonly_allow(NULL, 0);
+    save.busy = false;
+  }
   return err;
 }
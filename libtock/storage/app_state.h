@@ -33,6 +33,14 @@
 //     ret = app_state_save_sync();
 //     if (ret != 0) prinrf("ERROR(%i): Could not write back to flash.\n", ret);
 //   }
+//
+// The flash region holds two copies of the state, each a header page followed
+// by the data pages. A save writes the copy not holding the current state,
+// and only the data pages that differ from what that copy already holds,
+// then commits the copy by writing its header with the next sequence number
+// and a CRC-32 of the data. A reset during a save leaves a copy that fails its
+// CRC, so loading falls back to the previous state, and saves alternate
+// between the copies to spread wear.
 
 #include "../tock.h"
 #include "syscalls/app_state_syscalls.h"
@@ -41,6 +49,27 @@
 extern "C" {
 #endif
 
+// Flash page size, the unit in which changes are written. Set it to the page
+// size of the board with `make CFLAGS=-DLIBTOCK_APP_STATE_PAGE_SIZE=4096`.
+#ifndef LIBTOCK_APP_STATE_PAGE_SIZE
+#define LIBTOCK_APP_STATE_PAGE_SIZE 512
+#endif
+
+#define LIBTOCK_APP_STATE_MAGIC 0x41505354
+
+// Bytes of flash used by one copy of a `size`-byte state.
+#define LIBTOCK_APP_STATE_COPY_SIZE(size) \
+  (LIBTOCK_APP_STATE_PAGE_SIZE * (1 + ((size) + LIBTOCK_APP_STATE_PAGE_SIZE - 1) / LIBTOCK_APP_STATE_PAGE_SIZE))
+
+// Header at the start of each copy.
+typedef struct {
+  uint32_t magic;
+  uint32_t seq;
+  // CRC-32 of the data.
+  uint32_t crc;
+  uint32_t size;
+} libtock_app_state_header_t;
+
 // Declare an application state structure
 //
 // This macro does a little extra bookkeeping, however it should look
@@ -55,13 +84,13 @@ extern "C" {
 // The variable `memory_copy` is available as regular C structure, however
 // users must explicitly `load` and `save` application state as appropriate.
 // Note that each process may only use APP_STATE_DECLARE once.
-#define LIBTOCK_APP_STATE_DECLARE(_type, _identifier)                 \
-  __attribute__((section(".app_state")))                              \
-  _type _app_state_flash;                                             \
-  _type _identifier;                                                  \
-  void* _app_state_flash_pointer = NULL;                              \
-  void* _app_state_ram_pointer   = &_identifier;                        \
-  size_t _app_state_size         = sizeof(_type);                             \
+#define LIBTOCK_APP_STATE_DECLARE(_type, _identifier)                            \
+  __attribute__((section(".app_state"), aligned(LIBTOCK_APP_STATE_PAGE_SIZE)))   \
+  uint8_t _app_state_flash[2][LIBTOCK_APP_STATE_COPY_SIZE(sizeof(_type))];       \
+  _type _identifier;                                                             \
+  void* _app_state_flash_pointer = NULL;                                         \
+  void* _app_state_ram_pointer   = &_identifier;                                 \
+  size_t _app_state_size         = sizeof(_type);                                \
   bool _app_state_inited         = false;
 
 
@@ -83,6 +112,10 @@ extern bool _app_state_inited;
 returncode_t libtock_app_state_load(void);
 
 // Save the application state to persistent storage.
+//
+// Returns RETURNCODE_EALREADY if the state has not changed since it was last
+// loaded or saved, in which case `cb` is not called, and RETURNCODE_EBUSY
+// while a save is running.
 returncode_t libtock_app_state_save(libtock_app_state_callback cb);
 
 
@@ -0,0 +1,150 @@
+#include <string.h>
+
+#include "compress.h"
+
+// Shortest match worth a copy.
+#define MIN_MATCH 4
+// The format ends every block with literals: the last match starts at
+// least 12 bytes and ends at least 5 bytes before the end.
+#define LAST_MATCH_START 12
+#define LAST_LITERALS    5
+
+static uint32_t read32(const uint8_t* p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static uint32_t hash(uint32_t v) {
+  return (v * 2654435761u) >> (32 - LIBTOCK_COMPRESS_HASH_BITS);
+}
+
+// Output position while compressing. `ok` turns false once `out` is full.
+typedef struct {
+  uint8_t* out;
+  uint32_t len;
+  uint32_t pos;
+  bool ok;
+} writer_t;
+
+static void put(writer_t* w, uint8_t b) {
+  if (w->pos < w->len) {
+    w->out[w->pos++] = b;
+  } else {
+    w->ok = false;
+  }
+}
+
+// Extra length bytes after a 4-bit length field of 15.
+static void put_length(writer_t* w, uint32_t len) {
+  for (; len >= 255; len -= 255) {
+    put(w, 255);
+  }
+  put(w, len);
+}
+
+// One sequence: `lit_len` literals, then a match of `match_len` bytes
+// `offset` back, or nothing if `match_len` is zero.
+static void put_sequence(writer_t* w, const uint8_t* lit, uint32_t lit_len, uint16_t offset, uint32_t match_len) {
+  uint32_t m = match_len == 0 ? 0 : match_len - MIN_MATCH;
+  put(w, (lit_len < 15 ? lit_len : 15) << 4 | (m < 15 ? m : 15));
+  if (lit_len >= 15) put_length(w, lit_len - 15);
+
+  if (w->ok && lit_len <= w->len - w->pos) {
+    memcpy(w->out + w->pos, lit, lit_len);
+    w->pos += lit_len;
+  } else {
+    w->ok = false;
+  }
+  if (match_len == 0) return;
+
+  put(w, offset & 0xff);
+  put(w, offset >> 8);
+  if (m >= 15) put_length(w, m - 15);
+}
+
+returncode_t libtock_compress(const uint8_t* in, uint32_t len, uint8_t* out, uint32_t out_len,
+                              uint32_t* compressed_len) {
+  if (len > LIBTOCK_COMPRESS_MAX_INPUT) return RETURNCODE_EINVAL;
+
+  uint16_t table[1 << LIBTOCK_COMPRESS_HASH_BITS];
+  memset(table, 0, sizeof(table));
+  writer_t w = { .out = out, .len = out_len, .pos = 0, .ok = true };
+
+  uint32_t anchor = 0;
+  if (len > LAST_MATCH_START) {
+    uint32_t limit       = len - LAST_MATCH_START;
+    uint32_t match_limit = len - LAST_LITERALS;
+    uint32_t pos         = 0;
+    while (pos < limit) {
+      uint32_t v   = read32(in + pos);
+      uint32_t h   = hash(v);
+      uint32_t ref = table[h];
+      table[h] = pos;
+      if (ref >= pos || read32(in + ref) != v) {
+        pos++;
+        continue;
+      }
+
+      uint32_t match_len = MIN_MATCH;
+      while (pos + match_len < match_limit && in[ref + match_len] == in[pos + match_len]) {
+        match_len++;
+      }
+      put_sequence(&w, in + anchor, pos - anchor, pos - ref, match_len);
+      if (!w.ok) return RETURNCODE_ESIZE;
+      pos   += match_len;
+      anchor = pos;
+    }
+  }
+
+  put_sequence(&w, in + anchor, len - anchor, 0, 0);
+  if (!w.ok) return RETURNCODE_ESIZE;
+  *compressed_len = w.pos;
+  return RETURNCODE_SUCCESS;
+}
+
+// Read the extra length bytes after a 4-bit length field of 15.
+static bool get_length(const uint8_t* in, uint32_t len, uint32_t* pos, uint32_t* value) {
+  uint8_t b;
+  do {
+    if (*pos >= len) return false;
+    b       = in[(*pos)++];
+    *value += b;
+  } while (b == 255);
+  return true;
+}
+
+returncode_t libtock_decompress(const uint8_t* in, uint32_t len, uint8_t* out, uint32_t out_len,
+                                uint32_t* decompressed_len) {
+  uint32_t pos = 0;
+  uint32_t written = 0;
+  while (pos < len && written < out_len) {
+    uint8_t token    = in[pos++];
+    uint32_t lit_len = token >> 4;
+    if (lit_len == 15 && !get_length(in, len, &pos, &lit_len)) return RETURNCODE_FAIL;
+    if (lit_len > len - pos) return RETURNCODE_FAIL;
+
+    uint32_t n = lit_len < out_len - written ? lit_len : out_len - written;
+    memcpy(out + written, in + pos, n);
+    written += n;
+    pos     += lit_len;
+    // The last sequence has no match.
+    if (pos == len || written == out_len) break;
+
+    if (len - pos < 2) return RETURNCODE_FAIL;
+    uint32_t offset = in[pos] | in[pos + 1] << 8;
+    pos += 2;
+    if (offset == 0 || offset > written) return RETURNCODE_FAIL;
+
+    uint32_t match_len = token & 0xf;
+    if (match_len == 15 && !get_length(in, len, &pos, &match_len)) return RETURNCODE_FAIL;
+    match_len += MIN_MATCH;
+
+    // Byte by byte, as the copy may overlap its own output.
+    for (; match_len > 0 && written < out_len; match_len--, written++) {
+      out[written] = out[written - offset];
+    }
+  }
+  *decompressed_len = written;
+  return RETURNCODE_SUCCESS;
+}
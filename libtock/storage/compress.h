@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// LZ77 compression for data headed to storage.
+//
+// The output is an LZ4 block: runs of literal bytes alternating with copies
+// of up to 64 kB back, so any LZ4 block decoder can read it. Compression
+// needs no memory beyond a hash table of `1 << LIBTOCK_COMPRESS_HASH_BITS`
+// 16-bit positions on the stack, and decompression needs none at all.
+//
+// Blocks are compressed on their own, so each record or page can be read
+// back without the ones before it. Sensor logs and other repetitive data
+// typically shrink to a third or less; random data does not shrink and is
+// best stored as is.
+
+// Hash table size, two bytes of stack per entry while compressing. Larger
+// finds more matches.
+#ifndef LIBTOCK_COMPRESS_HASH_BITS
+#define LIBTOCK_COMPRESS_HASH_BITS 8
+#endif
+
+// Largest input of one block.
+#define LIBTOCK_COMPRESS_MAX_INPUT 65535
+
+// Compress `len` bytes of `in` into `out`, which holds `out_len` bytes, and
+// set `*compressed_len` to the size of the block.
+//
+// Returns RETURNCODE_ESIZE if the block does not fit in `out`, and
+// RETURNCODE_EINVAL if `len` is above LIBTOCK_COMPRESS_MAX_INPUT.
+returncode_t libtock_compress(const uint8_t* in, uint32_t len, uint8_t* out, uint32_t out_len,
+                              uint32_t* compressed_len);
+
+// Decompress the block of `len` bytes at `in` into `out`, stopping once
+// `out_len` bytes are written, and set `*decompressed_len` to the bytes
+// written.
+//
+// Returns RETURNCODE_FAIL if the block is corrupt.
+returncode_t libtock_decompress(const uint8_t* in, uint32_t len, uint8_t* out, uint32_t out_len,
+                                uint32_t* decompressed_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,108 @@
+#include <string.h>
+
+#include "../peripherals/crc_soft.h"
+#include "flash_index.h"
+
+static uint32_t fmix32(uint32_t h) {
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
+
+// Seeded FNV-1a with a final mix. Must match `key_hash()` in
+// tools/flash_index.py.
+static uint32_t key_hash(uint32_t seed, const uint8_t* key, uint32_t len) {
+  uint32_t h = 0x811c9dc5 ^ (seed * 0x9e3779b9);
+  for (uint32_t i = 0; i < len; i++) {
+    h = (h ^ key[i]) * 0x01000193;
+  }
+  return fmix32(h);
+}
+
+static bool range_valid(const libtock_flash_index_t* index, uint32_t offset, uint32_t len) {
+  return offset <= index->size && len <= index->size - offset;
+}
+
+returncode_t libtock_flash_index_open(libtock_flash_index_t* index, const void* image, uint32_t size) {
+  const libtock_flash_index_header_t* header = image;
+  if (((uintptr_t) image & 3) != 0) return RETURNCODE_EINVAL;
+  if (size < sizeof(*header)) return RETURNCODE_ESIZE;
+  if (header->magic != LIBTOCK_FLASH_INDEX_MAGIC || header->version != LIBTOCK_FLASH_INDEX_VERSION) {
+    return RETURNCODE_EINVAL;
+  }
+  if (header->size > size) return RETURNCODE_ESIZE;
+  if (header->count > 0 && (header->bucket_count == 0 || header->slot_count < header->count)) {
+    return RETURNCODE_EINVAL;
+  }
+
+  // Bound every table by the image size first, so the offsets cannot wrap.
+  uint32_t limit = header->size;
+  if (header->bucket_count > limit / 2 || header->slot_count > limit / 4 ||
+      header->count > limit / sizeof(libtock_flash_index_record_t)) {
+    return RETURNCODE_ESIZE;
+  }
+  uint32_t seeds_offset   = sizeof(*header);
+  uint32_t slots_offset   = (seeds_offset + 2 * header->bucket_count + 3) & ~3u;
+  uint32_t records_offset = slots_offset + 4 * header->slot_count;
+  uint32_t end = records_offset + header->count * sizeof(libtock_flash_index_record_t);
+  if (slots_offset > limit || records_offset > limit || end > limit) return RETURNCODE_ESIZE;
+
+  index->base         = image;
+  index->size         = header->size;
+  index->count        = header->count;
+  index->bucket_count = header->bucket_count;
+  index->slot_count   = header->slot_count;
+  index->seeds        = (const uint16_t*) (index->base + seeds_offset);
+  index->slots        = (const uint32_t*) (index->base + slots_offset);
+  index->records      = (const libtock_flash_index_record_t*) (index->base + records_offset);
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_flash_index_check(const libtock_flash_index_t* index) {
+  const libtock_flash_index_header_t* header = (const libtock_flash_index_header_t*) index->base;
+  uint32_t crc = libtock_crc_soft_crc32_small(0, index->base + sizeof(*header), index->size - sizeof(*header));
+  return crc == header->crc ? RETURNCODE_SUCCESS : RETURNCODE_FAIL;
+}
+
+static bool record_valid(const libtock_flash_index_t* index, const libtock_flash_index_record_t* record) {
+  return range_valid(index, record->key_offset, record->key_len) &&
+         range_valid(index, record->value_offset, record->value_len);
+}
+
+returncode_t libtock_flash_index_find(const libtock_flash_index_t* index, const void* key, uint32_t key_len,
+                                      const void** value, uint32_t* value_len) {
+  if (index->count == 0) return RETURNCODE_ENOSUPPORT;
+
+  uint32_t bucket = key_hash(0, key, key_len) % index->bucket_count;
+  uint32_t slot   = key_hash(index->seeds[bucket], key, key_len) % index->slot_count;
+  uint32_t number = index->slots[slot];
+  if (number >= index->count) return RETURNCODE_ENOSUPPORT;
+
+  const libtock_flash_index_record_t* record = &index->records[number];
+  if (record->key_len != key_len || !record_valid(index, record)) return RETURNCODE_ENOSUPPORT;
+  if (key_len > 0 && memcmp(index->base + record->key_offset, key, key_len) != 0) return RETURNCODE_ENOSUPPORT;
+
+  *value     = index->base + record->value_offset;
+  *value_len = record->value_len;
+  return RETURNCODE_SUCCESS;
+}
+
+uint32_t libtock_flash_index_count(const libtock_flash_index_t* index) {
+  return index->count;
+}
+
+returncode_t libtock_flash_index_entry(const libtock_flash_index_t* index, uint32_t i, const void** key,
+                                       uint32_t* key_len, const void** value, uint32_t* value_len) {
+  if (i >= index->count) return RETURNCODE_EINVAL;
+
+  const libtock_flash_index_record_t* record = &index->records[i];
+  if (!record_valid(index, record)) return RETURNCODE_EINVAL;
+  *key       = index->base + record->key_offset;
+  *key_len   = record->key_len;
+  *value     = index->base + record->value_offset;
+  *value_len = record->value_len;
+  return RETURNCODE_SUCCESS;
+}
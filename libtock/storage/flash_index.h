@@ -0,0 +1,97 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Read-only key/value index searched in place in flash.
+//
+// Large read-mostly tables are built into an image by
+// `tools/flash_index.py`, and either compiled into the app as a `const`
+// array or stored in a writeable flash region (see `writeable_flash.h`).
+// Lookups read the image where it is mapped, so the table costs no RAM.
+//
+// The image holds a perfect hash over the keys: a key picks a bucket, the
+// bucket's seed picks the key's slot, and one comparison with the key of the
+// record in that slot decides whether it is there. Every lookup costs two
+// hashes of the key, whatever the size of the table.
+//
+// Image layout, all little endian and four-byte aligned:
+//
+//   header      libtock_flash_index_header_t
+//   seeds       uint16_t[bucket_count]
+//   slots       uint32_t[slot_count], record numbers or
+//               LIBTOCK_FLASH_INDEX_EMPTY
+//   records     libtock_flash_index_record_t[count]
+//   data        values and keys, each padded to four bytes
+//
+// Offsets in records are from the start of the image.
+
+#define LIBTOCK_FLASH_INDEX_MAGIC   0x58444946
+#define LIBTOCK_FLASH_INDEX_VERSION 1
+#define LIBTOCK_FLASH_INDEX_EMPTY   0xffffffff
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t flags;
+  // Bytes in the whole image.
+  uint32_t size;
+  uint32_t count;
+  uint32_t bucket_count;
+  uint32_t slot_count;
+  // CRC-32 of everything after the header.
+  uint32_t crc;
+} libtock_flash_index_header_t;
+
+typedef struct {
+  uint32_t key_offset;
+  uint32_t value_offset;
+  uint16_t key_len;
+  uint16_t value_len;
+} libtock_flash_index_record_t;
+
+typedef struct {
+  const uint8_t* base;
+  uint32_t size;
+  uint32_t count;
+  uint32_t bucket_count;
+  uint32_t slot_count;
+  const uint16_t* seeds;
+  const uint32_t* slots;
+  const libtock_flash_index_record_t* records;
+} libtock_flash_index_t;
+
+// Open the image of `size` bytes at `image`, which must be four-byte aligned
+// and stay mapped while the index is used. Only the header and table bounds
+// are checked, use `libtock_flash_index_check()` to verify the contents.
+//
+// Returns RETURNCODE_EINVAL if `image` does not hold a flash index and
+// RETURNCODE_ESIZE if the image is truncated.
+returncode_t libtock_flash_index_open(libtock_flash_index_t* index, const void* image, uint32_t size);
+
+// Verify the CRC of the image. Returns RETURNCODE_FAIL if it does not match.
+returncode_t libtock_flash_index_check(const libtock_flash_index_t* index);
+
+// Look up `key` and point `*value` at its value in flash, `*value_len` bytes
+// long.
+//
+// Returns RETURNCODE_ENOSUPPORT if the key is not in the index.
+returncode_t libtock_flash_index_find(const libtock_flash_index_t* index, const void* key, uint32_t key_len,
+                                      const void** value, uint32_t* value_len);
+
+// Number of keys in the index.
+uint32_t libtock_flash_index_count(const libtock_flash_index_t* index);
+
+// Get entry `i`, for `i` below `libtock_flash_index_count()`. Entries are in
+// the order of the tool's input.
+//
+// Returns RETURNCODE_EINVAL if `i` is out of range.
+returncode_t libtock_flash_index_entry(const libtock_flash_index_t* index, uint32_t i, const void** key,
+                                       uint32_t* key_len, const void** value, uint32_t* value_len);
+
+#ifdef __cplusplus
+}
+#endif
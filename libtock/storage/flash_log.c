@@ -0,0 +1,264 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../peripherals/crc_soft.h"
+#include "../services/time.h"
+#include "flash_log.h"
+#include "syscalls/app_state_syscalls.h"
+#include "writeable_flash.h"
+
+#define PAGE LIBTOCK_FLASH_LOG_PAGE_SIZE
+#define RECORDS_PER_PAGE (PAGE / LIBTOCK_FLASH_LOG_RECORD_SIZE)
+
+_Static_assert(sizeof(libtock_flash_log_record_t) == LIBTOCK_FLASH_LOG_RECORD_SIZE,
+               "LIBTOCK_FLASH_LOG_RECORD_SIZE must be a multiple of 4");
+_Static_assert(PAGE % LIBTOCK_FLASH_LOG_RECORD_SIZE == 0,
+               "LIBTOCK_FLASH_LOG_RECORD_SIZE must divide LIBTOCK_FLASH_LOG_PAGE_SIZE");
+
+// The app state driver's upcall carries no context, so the log is global.
+static struct {
+  const uint8_t* flash;
+  uint32_t pages;
+  // Slot of the next record in the ring of `pages * RECORDS_PER_PAGE`, its
+  // sequence number, and how many records before it the log holds.
+  uint32_t next_slot;
+  uint32_t next_seq;
+  uint32_t count;
+  // RAM copies of the page being filled, `buffers[cur]`, and of the one
+  // before it until that is written. `page` is -1 for an unused buffer.
+  uint8_t buffers[2][PAGE] __attribute__((aligned(4)));
+  int32_t page[2];
+  bool dirty[2];
+  int cur;
+  // Buffer being written, or -1.
+  int writing;
+  libtock_flash_log_stats_t stats;
+} log_state = { .page = { -1, -1 }, .writing = -1 };
+
+static uint32_t record_crc(const libtock_flash_log_record_t* record) {
+  libtock_flash_log_record_t copy = *record;
+  copy.crc = 0;
+  return libtock_crc_soft_crc32_small(0, (const uint8_t*) &copy, sizeof(copy));
+}
+
+static bool record_valid(const libtock_flash_log_record_t* record) {
+  return record->len <= LIBTOCK_FLASH_LOG_DATA_SIZE && record->crc == record_crc(record);
+}
+
+static uint32_t total_slots(void) {
+  return log_state.pages * RECORDS_PER_PAGE;
+}
+
+// Record `index` of `page`, from its RAM copy if it has one.
+static const libtock_flash_log_record_t* record_at(uint32_t page, uint32_t index) {
+  const uint8_t* base = log_state.flash + page * PAGE;
+  for (int b = 0; b < 2; b++) {
+    if (log_state.page[b] == (int32_t) page) base = log_state.buffers[b];
+  }
+  return (const libtock_flash_log_record_t*) (base + index * LIBTOCK_FLASH_LOG_RECORD_SIZE);
+}
+
+// Write the older dirty buffer, or the current one, if no write is running.
+static void kick(void) {
+  if (log_state.writing >= 0) return;
+
+  int b = 1 - log_state.cur;
+  if (!log_state.dirty[b]) b = log_state.cur;
+  if (!log_state.dirty[b]) return;
+
+  log_state.dirty[b] = false;
+  log_state.stats.writes++;
+  const uint8_t* dest = log_state.flash + log_state.page[b] * PAGE;
+  returncode_t ret    = libtock_app_state_set_readonly_allow(log_state.buffers[b], PAGE);
+  if (ret == RETURNCODE_SUCCESS) ret = libtock_app_state_command_save((uint32_t) dest);
+  if (ret != RETURNCODE_SUCCESS) {
+    // Try again on the next append.
+    log_state.dirty[b] = true;
+    log_state.stats.write_errors++;
+    libtock_app_state_set_readonly_allow(NULL, 0);
+    return;
+  }
+  log_state.writing = b;
+}
+
+static void flash_log_upcall(__attribute__ ((unused)) int callback_type,
+                             __attribute__ ((unused)) int value,
+                             __attribute__ ((unused)) int unused,
+                             __attribute__ ((unused)) void* opaque) {
+  if (log_state.writing < 0) return;
+
+  libtock_writeable_flash_invalidate(log_state.flash + log_state.page[log_state.writing] * PAGE, PAGE);
+  libtock_app_state_set_readonly_allow(NULL, 0);
+  log_state.writing = -1;
+  kick();
+}
+
+// Records held in pages before `page`, counting back while each page is a
+// full run continuing into the next. `first_seq` is the first record's
+// sequence number in `page`.
+static uint32_t count_before(uint32_t page, uint32_t first_seq) {
+  uint32_t count = 0;
+  for (uint32_t k = 1; k < log_state.pages; k++) {
+    uint32_t p        = (page + log_state.pages - k) % log_state.pages;
+    uint32_t expected = first_seq - k * RECORDS_PER_PAGE;
+    const libtock_flash_log_record_t* head = record_at(p, 0);
+    const libtock_flash_log_record_t* tail = record_at(p, RECORDS_PER_PAGE - 1);
+    if (!record_valid(head) || head->seq != expected) break;
+    if (!record_valid(tail) || tail->seq != expected + RECORDS_PER_PAGE - 1) break;
+    count += RECORDS_PER_PAGE;
+  }
+  return count;
+}
+
+returncode_t libtock_flash_log_init(int region) {
+  if (!libtock_app_state_exists()) return RETURNCODE_ENODEVICE;
+
+  uint32_t size;
+  const void* flash;
+  returncode_t ret = libtock_writeable_flash_size(region, &size);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtock_writeable_flash_map(region, 0, size, &flash);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (size / PAGE < 2) return RETURNCODE_ENOMEM;
+
+  ret = libtock_app_state_set_upcall(flash_log_upcall, NULL);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  memset(&log_state.stats, 0, sizeof(log_state.stats));
+  log_state.flash    = flash;
+  log_state.pages    = size / PAGE;
+  log_state.page[0]  = -1;
+  log_state.page[1]  = -1;
+  log_state.dirty[0] = false;
+  log_state.dirty[1] = false;
+  log_state.cur      = 0;
+  log_state.writing  = -1;
+
+  // The newest page is the one whose first record is newest.
+  int32_t newest = -1;
+  uint32_t newest_seq = 0;
+  for (uint32_t p = 0; p < log_state.pages; p++) {
+    const libtock_flash_log_record_t* head = record_at(p, 0);
+    if (!record_valid(head)) continue;
+    if (newest < 0 || (int32_t) (head->seq - newest_seq) > 0) {
+      newest     = (int32_t) p;
+      newest_seq = head->seq;
+    }
+  }
+
+  if (newest < 0) {
+    log_state.next_slot = 0;
+    log_state.next_seq  = 1;
+    log_state.count     = 0;
+    return RETURNCODE_SUCCESS;
+  }
+
+  // Then the tail is the last record continuing the page's run.
+  uint32_t held = 0;
+  while (held < RECORDS_PER_PAGE) {
+    const libtock_flash_log_record_t* record = record_at((uint32_t) newest, held);
+    if (!record_valid(record) || record->seq != newest_seq + held) break;
+    held++;
+  }
+
+  log_state.next_slot = ((uint32_t) newest * RECORDS_PER_PAGE + held) % total_slots();
+  log_state.next_seq  = newest_seq + held;
+  log_state.count     = held + count_before((uint32_t) newest, newest_seq);
+
+  if (held < RECORDS_PER_PAGE) {
+    // Keep filling the page. Its first write repeats the records it holds.
+    memcpy(log_state.buffers[0], log_state.flash + (uint32_t) newest * PAGE, PAGE);
+    memset(log_state.buffers[0] + held * LIBTOCK_FLASH_LOG_RECORD_SIZE, 0xff,
+           PAGE - held * LIBTOCK_FLASH_LOG_RECORD_SIZE);
+    log_state.page[0] = newest;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_flash_log_append(uint8_t tag, const void* data, size_t len) {
+  if (log_state.flash == NULL) return RETURNCODE_EOFF;
+  if (len > LIBTOCK_FLASH_LOG_DATA_SIZE) return RETURNCODE_ESIZE;
+
+  uint32_t page  = log_state.next_slot / RECORDS_PER_PAGE;
+  uint32_t index = log_state.next_slot % RECORDS_PER_PAGE;
+
+  if (log_state.page[log_state.cur] != (int32_t) page) {
+    // Entering a page: erase it in the other buffer, which must not still be
+    // waiting for flash.
+    int other = 1 - log_state.cur;
+    if (log_state.writing == other || log_state.dirty[other]) {
+      log_state.stats.dropped++;
+      return RETURNCODE_EBUSY;
+    }
+    memset(log_state.buffers[other], 0xff, PAGE);
+    log_state.page[other] = (int32_t) page;
+    log_state.cur         = other;
+
+    uint32_t others = (log_state.pages - 1) * RECORDS_PER_PAGE;
+    if (log_state.count > others) log_state.count = others;
+  }
+
+  libtock_flash_log_record_t* record =
+    (libtock_flash_log_record_t*) (log_state.buffers[log_state.cur] + index * LIBTOCK_FLASH_LOG_RECORD_SIZE);
+  memset(record, 0, sizeof(*record));
+  record->seq = log_state.next_seq;
+  record->ms  = (uint32_t) (libtock_time_now_us64() / 1000);
+  record->len = (uint8_t) len;
+  record->tag = tag;
+  memcpy(record->data, data, len);
+  record->crc = record_crc(record);
+
+  log_state.dirty[log_state.cur] = true;
+  log_state.next_slot = (log_state.next_slot + 1) % total_slots();
+  log_state.next_seq++;
+  log_state.count++;
+  log_state.stats.appended++;
+
+  kick();
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_flash_log_printf(uint8_t tag, const char* format, ...) {
+  char line[LIBTOCK_FLASH_LOG_DATA_SIZE + 1];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  if (len < 0) return RETURNCODE_EINVAL;
+  if (len > LIBTOCK_FLASH_LOG_DATA_SIZE) len = LIBTOCK_FLASH_LOG_DATA_SIZE;
+  return libtock_flash_log_append(tag, line, (size_t) len);
+}
+
+bool libtock_flash_log_range(uint32_t* first, uint32_t* last) {
+  if (log_state.count == 0) return false;
+  *last  = log_state.next_seq - 1;
+  *first = log_state.next_seq - log_state.count;
+  return true;
+}
+
+returncode_t libtock_flash_log_read(uint32_t seq, libtock_flash_log_record_t* record) {
+  uint32_t back = log_state.next_seq - seq;
+  if (back == 0 || back > log_state.count) return RETURNCODE_EINVAL;
+
+  uint32_t slot = (log_state.next_slot + total_slots() - back) % total_slots();
+  const libtock_flash_log_record_t* found = record_at(slot / RECORDS_PER_PAGE, slot % RECORDS_PER_PAGE);
+  if (!record_valid(found) || found->seq != seq) return RETURNCODE_EINVAL;
+
+  *record = *found;
+  return RETURNCODE_SUCCESS;
+}
+
+bool libtock_flash_log_flushed(void) {
+  return log_state.writing < 0 && !log_state.dirty[0] && !log_state.dirty[1];
+}
+
+returncode_t libtock_flash_log_flush(void) {
+  if (libtock_flash_log_flushed()) return RETURNCODE_EALREADY;
+  kick();
+  return log_state.writing >= 0 ? RETURNCODE_SUCCESS : RETURNCODE_FAIL;
+}
+
+void libtock_flash_log_stats(libtock_flash_log_stats_t* stats) {
+  *stats = log_state.stats;
+}
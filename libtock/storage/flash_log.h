@@ -0,0 +1,118 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Always-on log of fixed-size records in a writeable flash region, which
+// survives faults and restarts.
+//
+// Appending a record stores it in a RAM copy of the flash page it belongs
+// to and starts a write of that page if none is running, so the record
+// reaches flash within one page write. Records appended while a write runs
+// go out together in the next one, so logging costs a copy and a CRC per
+// record and at most one page write in flight, however fast records come.
+//
+// The records go around the region in a ring of pages. Each page is erased
+// when the log enters it: its first write fills the rest of the page with
+// 0xff, so the page never mixes records of two laps. Every record carries a
+// sequence number and a CRC-32, and `libtock_flash_log_init()` recovers the
+// tail on boot from the first record of each page and a scan of the newest
+// page. A record torn by a reset fails its CRC and ends the log there.
+//
+// The region is reserved with `LIBTOCK_FLASH_LOG_DECLARE()`:
+//
+//     LIBTOCK_FLASH_LOG_DECLARE(8);
+//
+//     int main(void) {
+//       libtock_flash_log_init(0);
+//       libtock_flash_log_printf(0, "boot");
+//       ...
+//     }
+//
+// The log writes through the app state driver and owns its upcall, so an
+// app cannot also use `app_state.h`. libtock-sync has a blocking flush.
+
+// Flash page size, the unit the kernel erases and writes. Set it to the
+// page size of the board with `make CFLAGS=-DLIBTOCK_FLASH_LOG_PAGE_SIZE=4096`.
+#ifndef LIBTOCK_FLASH_LOG_PAGE_SIZE
+#define LIBTOCK_FLASH_LOG_PAGE_SIZE 512
+#endif
+
+// Bytes per record, including the 14-byte header. Must divide the page size.
+#ifndef LIBTOCK_FLASH_LOG_RECORD_SIZE
+#define LIBTOCK_FLASH_LOG_RECORD_SIZE 64
+#endif
+
+#define LIBTOCK_FLASH_LOG_DATA_SIZE (LIBTOCK_FLASH_LOG_RECORD_SIZE - 14)
+
+// Reserve `_pages` pages of flash for the log as writeable flash region 0.
+#define LIBTOCK_FLASH_LOG_DECLARE(_pages)                                              \
+  __attribute__((section(".app_state"), aligned(LIBTOCK_FLASH_LOG_PAGE_SIZE), used))   \
+  uint8_t _flash_log_flash[_pages][LIBTOCK_FLASH_LOG_PAGE_SIZE]
+
+typedef struct {
+  uint32_t seq;
+  // Milliseconds since boot when the record was appended.
+  uint32_t ms;
+  // CRC-32 of the record, with this field zero.
+  uint32_t crc;
+  // Bytes used in `data`.
+  uint8_t len;
+  // Free for the app, such as a log level or subsystem.
+  uint8_t tag;
+  uint8_t data[LIBTOCK_FLASH_LOG_DATA_SIZE];
+} libtock_flash_log_record_t;
+
+typedef struct {
+  // Records appended since boot, and dropped because both page buffers
+  // were waiting for flash.
+  uint32_t appended;
+  uint32_t dropped;
+  // Page writes issued and failed.
+  uint32_t writes;
+  uint32_t write_errors;
+} libtock_flash_log_stats_t;
+
+// Use writeable flash region `region` for the log, and find the newest
+// record in it. Records continue after it with the next sequence number.
+//
+// Returns RETURNCODE_ENOMEM if the region has fewer than two pages, and
+// RETURNCODE_ENODEVICE without the app state driver.
+returncode_t libtock_flash_log_init(int region);
+
+// Append a record of `len` bytes at `data`.
+//
+// Returns RETURNCODE_ESIZE if `len` is above `LIBTOCK_FLASH_LOG_DATA_SIZE`
+// and RETURNCODE_EBUSY if the record was dropped because flash cannot keep
+// up.
+returncode_t libtock_flash_log_append(uint8_t tag, const void* data, size_t len);
+
+// Append a line of text, cut to `LIBTOCK_FLASH_LOG_DATA_SIZE` bytes.
+__attribute__((format(printf, 2, 3)))
+returncode_t libtock_flash_log_printf(uint8_t tag, const char* format, ...);
+
+// Sequence numbers of the oldest and newest records held, including ones not
+// yet on flash. Returns false if the log is empty.
+bool libtock_flash_log_range(uint32_t* first, uint32_t* last);
+
+// Copy record `seq` to `record`. Returns RETURNCODE_EINVAL if the log does
+// not hold it.
+returncode_t libtock_flash_log_read(uint32_t seq, libtock_flash_log_record_t* record);
+
+// Whether every appended record is on flash.
+bool libtock_flash_log_flushed(void);
+
+// Start writing records that are not on flash, such as after a failed
+// write. Returns RETURNCODE_EALREADY if every record is on flash,
+// RETURNCODE_SUCCESS while a write runs, and RETURNCODE_FAIL if no write
+// could be started.
+returncode_t libtock_flash_log_flush(void);
+
+void libtock_flash_log_stats(libtock_flash_log_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
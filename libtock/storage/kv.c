@@ -1,4 +1,5 @@
 #include "kv.h"
+#include "kv_cache.h"
 
 static void kv_upcall_get(int                          err,
                           int                          length,
@@ -40,6 +41,9 @@ static returncode_t kv_insert(const uint8_t* key_buffer, uint32_t key_len, const
                               uint32_t val_len, returncode_t (*op_fn)(void), libtock_kv_callback_done cb) {
   returncode_t err;
 
+  // The stored value is unknown until the operation completes.
+  libtock_kv_cache_invalidate(key_buffer, key_len);
+
   err = libtock_kv_set_upcall(kv_upcall_done, cb);
   if (err != RETURNCODE_SUCCESS) return err;
 
@@ -72,6 +76,8 @@ returncode_t libtock_kv_update(const uint8_t* key_buffer, uint32_t key_len, cons
 returncode_t libtock_kv_delete(const uint8_t* key_buffer, uint32_t key_len, libtock_kv_callback_done cb) {
   returncode_t err;
 
+  libtock_kv_cache_invalidate(key_buffer, key_len);
+
   err = libtock_kv_set_upcall(kv_upcall_done, cb);
   if (err != RETURNCODE_SUCCESS) return err;
 
@@ -81,3 +87,100 @@ returncode_t libtock_kv_delete(const uint8_t* key_buffer, uint32_t key_len, libt
   err = libtock_kv_command_delete();
   return err;
 }
+
+// The running batch. Only one can run, since the driver has a single upcall.
+static struct {
+  libtock_kv_item_t* items;
+  size_t count;
+  size_t next;
+  bool set;
+  bool busy;
+  libtock_kv_callback_many cb;
+} batch;
+
+// Start the next item of the batch. Items that fail to start are recorded
+// and skipped. Returns false once all items are done.
+static bool batch_start_next(void) {
+  while (batch.next < batch.count) {
+    libtock_kv_item_t* item = &batch.items[batch.next];
+    returncode_t err = libtock_kv_set_readonly_allow_key_buffer(item->key, item->key_len);
+    if (err == RETURNCODE_SUCCESS) {
+      if (batch.set) {
+        libtock_kv_cache_invalidate(item->key, item->key_len);
+        err = libtock_kv_set_readonly_allow_input_buffer(item->value, item->value_len);
+        if (err == RETURNCODE_SUCCESS) err = libtock_kv_command_set();
+      } else {
+        err = libtock_kv_set_readwrite_allow_output_buffer(item->value, item->value_len);
+        if (err == RETURNCODE_SUCCESS) err = libtock_kv_command_get();
+      }
+    }
+    if (err == RETURNCODE_SUCCESS) return true;
+
+    item->ret    = err;
+    item->length = 0;
+    batch.next++;
+  }
+  return false;
+}
+
+static void batch_finish(void) {
+  libtock_kv_set_readonly_allow_key_buffer(NULL, 0);
+  libtock_kv_set_readonly_allow_input_buffer(NULL, 0);
+  libtock_kv_set_readwrite_allow_output_buffer(NULL, 0);
+
+  returncode_t ret = RETURNCODE_SUCCESS;
+  size_t succeeded = 0;
+  for (size_t i = 0; i < batch.count; i++) {
+    if (batch.items[i].ret == RETURNCODE_SUCCESS) {
+      succeeded++;
+    } else if (ret == RETURNCODE_SUCCESS) {
+      ret = batch.items[i].ret;
+    }
+  }
+  batch.busy = false;
+  batch.cb(ret, succeeded);
+}
+
+static void kv_upcall_many(int                          err,
+                           int                          length,
+                           __attribute__ ((unused)) int unused2,
+                           __attribute__ ((unused)) void* opaque) {
+  if (!batch.busy || batch.next >= batch.count) return;
+
+  libtock_kv_item_t* item = &batch.items[batch.next];
+  item->ret    = tock_status_to_returncode(err);
+  item->length = batch.set ? 0 : length;
+  if (item->ret == RETURNCODE_SUCCESS) {
+    libtock_kv_cache_store(item->key, item->key_len, item->value, batch.set ? item->value_len : (uint32_t) length);
+  }
+  batch.next++;
+
+  if (!batch_start_next()) batch_finish();
+}
+
+static returncode_t kv_many(libtock_kv_item_t* items, size_t count, bool set, libtock_kv_callback_many cb) {
+  if (batch.busy) return RETURNCODE_EBUSY;
+  if (count == 0) return RETURNCODE_EINVAL;
+
+  returncode_t err = libtock_kv_set_upcall(kv_upcall_many, NULL);
+  if (err != RETURNCODE_SUCCESS) return err;
+
+  batch.items = items;
+  batch.count = count;
+  batch.next  = 0;
+  batch.set   = set;
+  batch.cb    = cb;
+  batch.busy  = true;
+
+  // If no item starts, report the failures right away.
+  if (!batch_start_next()) batch_finish();
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_kv_get_many(libtock_kv_item_t* items, size_t count, libtock_kv_callback_many cb) {
+  return kv_many(items, count, false, cb);
+}
+
+returncode_t libtock_kv_set_many(libtock_kv_item_t* items, size_t count, libtock_kv_callback_many cb) {
+  return kv_many(items, count, true, cb);
+}
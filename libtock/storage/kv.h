@@ -18,6 +18,26 @@ typedef void (*libtock_kv_callback_get)(returncode_t, int);
 // - `arg1` (`returncode_t`): Status of kv operation.
 typedef void (*libtock_kv_callback_done)(returncode_t);
 
+// Function signature for KV batch callbacks.
+//
+// - `arg1` (`returncode_t`): Status of the first item that failed, or
+//   RETURNCODE_SUCCESS.
+// - `arg2` (`size_t`): Number of items that succeeded.
+typedef void (*libtock_kv_callback_many)(returncode_t, size_t);
+
+// One key of a batch operation.
+typedef struct {
+  const uint8_t* key;
+  uint32_t key_len;
+  // Gets: buffer for the value. Sets: the value to store.
+  uint8_t* value;
+  uint32_t value_len;
+  // Set once the item completes. Gets: length of the stored value, which may
+  // be larger than `value_len`.
+  int length;
+  returncode_t ret;
+} libtock_kv_item_t;
+
 
 returncode_t libtock_kv_get(const uint8_t* key_buffer, uint32_t key_len, uint8_t* ret_buffer, uint32_t ret_len,
                             libtock_kv_callback_get cb);
@@ -33,6 +53,21 @@ returncode_t libtock_kv_update(const uint8_t* key_buffer, uint32_t key_len, cons
 
 returncode_t libtock_kv_delete(const uint8_t* key_buffer, uint32_t key_len, libtock_kv_callback_done cb);
 
+// Get or set every item in `items`, then call `cb` once.
+//
+// The kernel handles one key per command, so the items still run one after
+// another, but each one is started from the previous one's upcall and the
+// upcall is only subscribed once. The app sees a single completion instead of
+// one per key. Each item's result is in its `ret` field, and a failed item
+// does not stop the batch.
+//
+// `items` and the buffers it points to must stay valid until `cb` runs. Only
+// one batch can run at a time; returns RETURNCODE_EBUSY otherwise. No other
+// KV call may be made until `cb` runs, as it would take over the upcall.
+returncode_t libtock_kv_get_many(libtock_kv_item_t* items, size_t count, libtock_kv_callback_many cb);
+
+returncode_t libtock_kv_set_many(libtock_kv_item_t* items, size_t count, libtock_kv_callback_many cb);
+
 
 #ifdef __cplusplus
 }
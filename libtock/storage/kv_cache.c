@@ -0,0 +1,94 @@
+#include <string.h>
+
+#include "kv_cache.h"
+
+static libtock_kv_cache_entry_t* entries = NULL;
+static uint32_t entry_count = 0;
+static uint32_t use_clock   = 0;
+static uint32_t hits        = 0;
+static uint32_t misses      = 0;
+
+static libtock_kv_cache_entry_t* find(const uint8_t* key, uint32_t key_len) {
+  for (uint32_t i = 0; i < entry_count; i++) {
+    libtock_kv_cache_entry_t* entry = &entries[i];
+    if (entry->valid && entry->key_len == key_len && memcmp(entry->key, key, key_len) == 0) return entry;
+  }
+  return NULL;
+}
+
+void libtock_kv_cache_init(libtock_kv_cache_entry_t* cache_entries, uint32_t count) {
+  entries     = cache_entries;
+  entry_count = count;
+  use_clock   = 0;
+  hits        = 0;
+  misses      = 0;
+  libtock_kv_cache_clear();
+}
+
+returncode_t libtock_kv_cache_lookup(const uint8_t* key, uint32_t key_len, uint8_t* buf, uint32_t buf_len,
+                                     uint32_t* value_len) {
+  libtock_kv_cache_entry_t* entry = find(key, key_len);
+  if (entry == NULL) {
+    if (entry_count > 0) misses++;
+    return RETURNCODE_EOFF;
+  }
+
+  hits++;
+  entry->last_use = ++use_clock;
+  *value_len      = entry->value_len;
+  if (entry->value_len > buf_len) {
+    memcpy(buf, entry->value, buf_len);
+    return RETURNCODE_ESIZE;
+  }
+  memcpy(buf, entry->value, entry->value_len);
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_kv_cache_store(const uint8_t* key, uint32_t key_len, const uint8_t* value, uint32_t value_len) {
+  if (entry_count == 0) return;
+
+  libtock_kv_cache_entry_t* entry = find(key, key_len);
+  if (key_len > LIBTOCK_KV_CACHE_KEY_MAX || value_len > LIBTOCK_KV_CACHE_VALUE_MAX) {
+    // Too large to cache, but an older value must not stay behind.
+    if (entry != NULL) entry->valid = false;
+    return;
+  }
+
+  if (entry == NULL) {
+    // Take a free entry, or else the least recently used one.
+    entry = &entries[0];
+    for (uint32_t i = 0; i < entry_count; i++) {
+      if (!entries[i].valid) {
+        entry = &entries[i];
+        break;
+      }
+      if (entries[i].last_use < entry->last_use) entry = &entries[i];
+    }
+    memcpy(entry->key, key, key_len);
+    entry->key_len = key_len;
+  }
+
+  if (value_len > 0) memcpy(entry->value, value, value_len);
+  entry->value_len = value_len;
+  entry->valid     = true;
+  entry->last_use  = ++use_clock;
+}
+
+void libtock_kv_cache_invalidate(const uint8_t* key, uint32_t key_len) {
+  libtock_kv_cache_entry_t* entry = find(key, key_len);
+  if (entry != NULL) entry->valid = false;
+}
+
+void libtock_kv_cache_clear(void) {
+  for (uint32_t i = 0; i < entry_count; i++) {
+    entries[i].valid = false;
+  }
+}
+
+uint32_t libtock_kv_cache_hits(void) {
+  return hits;
+}
+
+uint32_t libtock_kv_cache_misses(void) {
+  return misses;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Read cache for KV lookups.
+//
+// Once `libtock_kv_cache_init()` has been called, `libtocksync_kv_get()`
+// serves keys it has seen before from RAM, without a kernel round trip. The
+// least recently used entry is replaced when the cache is full.
+//
+// The cache is write-through: setting, adding, updating or deleting a key
+// from this app drops its entry as the operation starts, and a successful
+// blocking set, add or update stores the new value. Writes made by other apps
+// are not seen, so only cache keys this app owns.
+//
+// Keys and values larger than the limits below are never cached. Both can be
+// raised with `make CFLAGS=-DLIBTOCK_KV_CACHE_KEY_MAX=...`.
+
+#ifndef LIBTOCK_KV_CACHE_KEY_MAX
+#define LIBTOCK_KV_CACHE_KEY_MAX 32
+#endif
+
+#ifndef LIBTOCK_KV_CACHE_VALUE_MAX
+#define LIBTOCK_KV_CACHE_VALUE_MAX 32
+#endif
+
+typedef struct {
+  uint8_t key[LIBTOCK_KV_CACHE_KEY_MAX];
+  uint8_t value[LIBTOCK_KV_CACHE_VALUE_MAX];
+  uint16_t key_len;
+  uint16_t value_len;
+  bool valid;
+  uint32_t last_use;
+} libtock_kv_cache_entry_t;
+
+// Cache up to `count` keys in `entries`. Replaces any earlier cache, and a
+// `count` of zero turns caching off.
+void libtock_kv_cache_init(libtock_kv_cache_entry_t* entries, uint32_t count);
+
+// Copy the cached value of `key` into `buf` and set `*value_len` to its full
+// length.
+//
+// Returns RETURNCODE_EOFF if the key is not cached, and RETURNCODE_ESIZE if
+// the value is longer than `buf_len`, in which case `buf` holds its start.
+returncode_t libtock_kv_cache_lookup(const uint8_t* key, uint32_t key_len, uint8_t* buf, uint32_t buf_len,
+                                     uint32_t* value_len);
+
+// Record `value` as the current value of `key`.
+void libtock_kv_cache_store(const uint8_t* key, uint32_t key_len, const uint8_t* value, uint32_t value_len);
+
+// Drop the entry for `key`, if any.
+void libtock_kv_cache_invalidate(const uint8_t* key, uint32_t key_len);
+
+// Drop every entry.
+void libtock_kv_cache_clear(void);
+
+// Number of lookups served from the cache and missed since init.
+uint32_t libtock_kv_cache_hits(void);
+
+uint32_t libtock_kv_cache_misses(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,140 @@
+#include <string.h>
+
+#include "kv_iter.h"
+
+// The iterator running an operation. The KV get callbacks carry no userdata.
+static libtock_kv_iter_t* active = NULL;
+
+static returncode_t iter_start_get(libtock_kv_iter_t* iter, uint32_t pos);
+
+int libtock_kv_dir_find(const uint8_t* dir, uint32_t dir_len, const uint8_t* key, uint32_t key_len) {
+  uint32_t pos = 0;
+  while (pos < dir_len) {
+    uint32_t len = dir[pos];
+    if (len == key_len && pos + 1 + len <= dir_len && memcmp(dir + pos + 1, key, len) == 0) return pos;
+    pos += 1 + len;
+  }
+  return -1;
+}
+
+returncode_t libtock_kv_dir_append(uint8_t* dir, uint32_t* dir_len, uint32_t capacity, const uint8_t* key,
+                                   uint32_t key_len) {
+  if (key_len > LIBTOCK_KV_DIR_KEY_MAX) return RETURNCODE_ESIZE;
+  if (libtock_kv_dir_find(dir, *dir_len, key, key_len) >= 0) return RETURNCODE_SUCCESS;
+  if (capacity - *dir_len < 1 + key_len) return RETURNCODE_ENOMEM;
+
+  dir[*dir_len] = key_len;
+  memcpy(dir + *dir_len + 1, key, key_len);
+  *dir_len += 1 + key_len;
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_kv_dir_remove(uint8_t* dir, uint32_t* dir_len, const uint8_t* key, uint32_t key_len) {
+  int pos = libtock_kv_dir_find(dir, *dir_len, key, key_len);
+  if (pos < 0) return;
+
+  uint32_t entry = 1 + key_len;
+  memmove(dir + pos, dir + pos + entry, *dir_len - pos - entry);
+  *dir_len -= entry;
+}
+
+// Offset of the next key at or after `pos` that matches the prefix, or
+// `dir_len` if there is none.
+static uint32_t next_match(const libtock_kv_iter_t* iter, uint32_t pos) {
+  while (pos < iter->dir_len) {
+    uint32_t len = iter->dir[pos];
+    if (pos + 1 + len > iter->dir_len) break;
+    if (iter->prefix_len == 0) return pos;
+    if (len >= iter->prefix_len && memcmp(iter->dir + pos + 1, iter->prefix, iter->prefix_len) == 0) return pos;
+    pos += 1 + len;
+  }
+  return iter->dir_len;
+}
+
+static void iter_finish(libtock_kv_iter_t* iter) {
+  active = NULL;
+  iter->next_cb(RETURNCODE_SUCCESS, iter->count);
+}
+
+static void iter_dir_done(returncode_t ret, int length) {
+  libtock_kv_iter_t* iter = active;
+  if (iter == NULL) return;
+  active = NULL;
+
+  if (ret == RETURNCODE_SUCCESS) {
+    iter->dir_len = length;
+  } else if (ret == RETURNCODE_ENOSUPPORT) {
+    // Nothing has been listed yet.
+    ret = RETURNCODE_SUCCESS;
+  }
+  iter->begin_cb(ret);
+}
+
+static void iter_get_done(returncode_t ret, int length) {
+  libtock_kv_iter_t* iter = active;
+  if (iter == NULL) return;
+
+  if (ret == RETURNCODE_ESIZE && iter->count > 0) {
+    // Does not fit behind the values fetched so far, start the next batch
+    // with it.
+    iter_finish(iter);
+    return;
+  }
+
+  libtock_kv_item_t* item = &iter->items[iter->count++];
+  item->key       = iter->dir + iter->pos + 1;
+  item->key_len   = iter->dir[iter->pos];
+  item->value     = iter->buf + iter->buf_used;
+  item->value_len = iter->buf_len - iter->buf_used;
+  item->length    = length;
+  item->ret       = ret;
+  if (ret == RETURNCODE_SUCCESS) iter->buf_used += length;
+  iter->pos = next_match(iter, iter->pos + 1 + item->key_len);
+
+  if (iter->count == LIBTOCK_KV_ITER_BATCH || iter->pos >= iter->dir_len || iter->buf_used == iter->buf_len ||
+      iter_start_get(iter, iter->pos) != RETURNCODE_SUCCESS) {
+    iter_finish(iter);
+  }
+}
+
+static returncode_t iter_start_get(libtock_kv_iter_t* iter, uint32_t pos) {
+  return libtock_kv_get(iter->dir + pos + 1, iter->dir[pos], iter->buf + iter->buf_used,
+                        iter->buf_len - iter->buf_used, iter_get_done);
+}
+
+returncode_t libtock_kv_iter_begin(libtock_kv_iter_t* iter, const uint8_t* prefix, uint32_t prefix_len,
+                                   uint8_t* dir, uint32_t dir_capacity, libtock_kv_callback_done cb) {
+  if (active != NULL) return RETURNCODE_EBUSY;
+
+  iter->dir          = dir;
+  iter->dir_capacity = dir_capacity;
+  iter->dir_len      = 0;
+  iter->pos          = 0;
+  iter->prefix       = prefix;
+  iter->prefix_len   = prefix_len;
+  iter->count        = 0;
+  iter->begin_cb     = cb;
+
+  returncode_t ret = libtock_kv_get((const uint8_t*) LIBTOCK_KV_DIR_KEY, LIBTOCK_KV_DIR_KEY_LEN, dir, dir_capacity,
+                                    iter_dir_done);
+  if (ret == RETURNCODE_SUCCESS) active = iter;
+  return ret;
+}
+
+returncode_t libtock_kv_iter_next(libtock_kv_iter_t* iter, uint8_t* buf, uint32_t buf_len,
+                                  libtock_kv_callback_many cb) {
+  if (active != NULL) return RETURNCODE_EBUSY;
+
+  iter->count = 0;
+  iter->pos   = next_match(iter, iter->pos);
+  if (iter->pos >= iter->dir_len) return RETURNCODE_EALREADY;
+
+  iter->buf      = buf;
+  iter->buf_len  = buf_len;
+  iter->buf_used = 0;
+  iter->next_cb  = cb;
+
+  returncode_t ret = iter_start_get(iter, iter->pos);
+  if (ret == RETURNCODE_SUCCESS) active = iter;
+  return ret;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "../tock.h"
+#include "kv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Key enumeration for the KV store.
+//
+// The KV driver looks keys up by hash and cannot list them, so the keys are
+// recorded in a directory: a KV entry under `LIBTOCK_KV_DIR_KEY` holding
+// every key, each as a length byte followed by the key bytes. The blocking
+// KV calls keep the directory up to date once
+// `libtocksync_kv_dir_track()` has been called.
+//
+// An iterator reads the directory once, then fetches the values of the keys
+// matching its prefix several at a time. Each batch is a chain of gets
+// started from the driver upcall, packing the values one after another into
+// the caller's buffer, with a single callback at the end.
+//
+// A key is added to the directory before its value is written and removed
+// after its value is deleted, so a reset in between can leave a key listed
+// that has no value, but never a value that is not listed. Such keys show up
+// as items failing with RETURNCODE_ENOSUPPORT.
+
+#define LIBTOCK_KV_DIR_KEY     "\0kv-dir"
+#define LIBTOCK_KV_DIR_KEY_LEN 7
+
+// Longest key the directory holds.
+#define LIBTOCK_KV_DIR_KEY_MAX 255
+
+// Most values fetched by one `libtock_kv_iter_next()`.
+#ifndef LIBTOCK_KV_ITER_BATCH
+#define LIBTOCK_KV_ITER_BATCH 8
+#endif
+
+typedef struct {
+  // Directory contents, read by `libtock_kv_iter_begin()`.
+  uint8_t* dir;
+  uint32_t dir_capacity;
+  uint32_t dir_len;
+  // Offset in `dir` of the next key to visit.
+  uint32_t pos;
+  const uint8_t* prefix;
+  uint32_t prefix_len;
+  // Entries of the last batch. `key` points into `dir` and `value` into the
+  // buffer passed to `libtock_kv_iter_next()`.
+  libtock_kv_item_t items[LIBTOCK_KV_ITER_BATCH];
+  size_t count;
+  uint8_t* buf;
+  uint32_t buf_len;
+  uint32_t buf_used;
+  libtock_kv_callback_done begin_cb;
+  libtock_kv_callback_many next_cb;
+} libtock_kv_iter_t;
+
+// Offset of `key` in the directory `dir`, or -1 if it is not listed.
+int libtock_kv_dir_find(const uint8_t* dir, uint32_t dir_len, const uint8_t* key, uint32_t key_len);
+
+// Add `key` to the directory, updating `*dir_len`. Returns RETURNCODE_ENOMEM
+// if it does not fit in `capacity` bytes, and RETURNCODE_ESIZE if the key is
+// longer than `LIBTOCK_KV_DIR_KEY_MAX`.
+returncode_t libtock_kv_dir_append(uint8_t* dir, uint32_t* dir_len, uint32_t capacity, const uint8_t* key,
+                                   uint32_t key_len);
+
+// Remove `key` from the directory, if listed.
+void libtock_kv_dir_remove(uint8_t* dir, uint32_t* dir_len, const uint8_t* key, uint32_t key_len);
+
+// Start iterating over the keys starting with `prefix`, which may be empty.
+// Reads the directory into `dir`, which holds `dir_capacity` bytes, and
+// calls `cb` once done. `prefix` must stay valid while iterating.
+//
+// A store without a directory iterates over nothing. Completes with
+// RETURNCODE_ESIZE if the directory does not fit in `dir`.
+returncode_t libtock_kv_iter_begin(libtock_kv_iter_t* iter, const uint8_t* prefix, uint32_t prefix_len,
+                                   uint8_t* dir, uint32_t dir_capacity, libtock_kv_callback_done cb);
+
+// Fetch the next values into `buf`, stopping after `LIBTOCK_KV_ITER_BATCH`
+// values or once the next value does not fit. `cb` gets RETURNCODE_SUCCESS
+// and the number of entries placed in `iter->items`, each with its own
+// `ret`. A value that does not fit in the whole of `buf` is returned alone
+// with RETURNCODE_ESIZE and its full length.
+//
+// Returns RETURNCODE_EALREADY once every matching key has been visited, and
+// RETURNCODE_EBUSY while another iterator operation runs. Like the other KV
+// calls, no other KV call may be made until `cb` runs.
+returncode_t libtock_kv_iter_next(libtock_kv_iter_t* iter, uint8_t* buf, uint32_t buf_len,
+                                  libtock_kv_callback_many cb);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,207 @@
+#include <string.h>
+
+#include "../services/alarm.h"
+#include "kv_cache.h"
+#include "kv_queue.h"
+
+// The KV driver has one upcall per process, so the queue is global.
+static struct {
+  libtock_kv_queue_entry_t* entries;
+  uint32_t count;
+  uint32_t flush_ms;
+  uint32_t next_order;
+  // Entries set before `limit` are written now; later ones wait for the
+  // timer or a flush.
+  uint32_t limit;
+  libtock_alarm_t alarm;
+  bool timer_armed;
+  // Copy of the entry being written, so it can be set again meanwhile.
+  bool writing;
+  uint8_t key[LIBTOCK_KV_QUEUE_KEY_MAX];
+  uint8_t value[LIBTOCK_KV_QUEUE_VALUE_MAX];
+  uint16_t key_len;
+  uint16_t value_len;
+  libtock_kv_callback_done flush_cb;
+  returncode_t error;
+  uint32_t coalesced;
+  uint32_t failed;
+} queue;
+
+static libtock_kv_queue_entry_t* find(const uint8_t* key, uint32_t key_len) {
+  for (uint32_t i = 0; i < queue.count; i++) {
+    libtock_kv_queue_entry_t* entry = &queue.entries[i];
+    if (entry->queued && entry->key_len == key_len && memcmp(entry->key, key, key_len) == 0) return entry;
+  }
+  return NULL;
+}
+
+// The queued entry set longest ago, if it is due.
+static libtock_kv_queue_entry_t* next_due(void) {
+  libtock_kv_queue_entry_t* next = NULL;
+  for (uint32_t i = 0; i < queue.count; i++) {
+    libtock_kv_queue_entry_t* entry = &queue.entries[i];
+    if (entry->queued && (next == NULL || entry->order < next->order)) next = entry;
+  }
+  return next != NULL && next->order < queue.limit ? next : NULL;
+}
+
+static void timer_fired(uint32_t, uint32_t, void*);
+
+static void arm_timer(void) {
+  if (queue.timer_armed) return;
+  queue.timer_armed = true;
+  libtock_alarm_in_ms(queue.flush_ms, timer_fired, NULL, &queue.alarm);
+}
+
+static void write_done(returncode_t ret);
+
+// Write due entries one after another until none is left, then report a
+// waiting flush and leave the rest for the timer.
+static void write_next(void) {
+  libtock_kv_queue_entry_t* entry;
+  while ((entry = next_due()) != NULL) {
+    memcpy(queue.key, entry->key, entry->key_len);
+    memcpy(queue.value, entry->value, entry->value_len);
+    queue.key_len   = entry->key_len;
+    queue.value_len = entry->value_len;
+    entry->queued   = false;
+
+    returncode_t ret = libtock_kv_set(queue.key, queue.key_len, queue.value, queue.value_len, write_done);
+    if (ret == RETURNCODE_SUCCESS) {
+      queue.writing = true;
+      return;
+    }
+    queue.failed++;
+    if (queue.error == RETURNCODE_SUCCESS) queue.error = ret;
+  }
+
+  if (libtock_kv_queue_pending() > 0) {
+    arm_timer();
+  } else if (queue.timer_armed) {
+    libtock_alarm_ms_cancel(&queue.alarm);
+    queue.timer_armed = false;
+  }
+  if (queue.flush_cb != NULL) {
+    libtock_kv_callback_done cb = queue.flush_cb;
+    returncode_t ret = queue.error;
+    queue.flush_cb = NULL;
+    queue.error    = RETURNCODE_SUCCESS;
+    cb(ret);
+  }
+}
+
+static void write_done(returncode_t ret) {
+  queue.writing = false;
+  if (ret == RETURNCODE_SUCCESS) {
+    libtock_kv_cache_store(queue.key, queue.key_len, queue.value, queue.value_len);
+  } else {
+    queue.failed++;
+    if (queue.error == RETURNCODE_SUCCESS) queue.error = ret;
+  }
+  write_next();
+}
+
+static void timer_fired(__attribute__ ((unused)) uint32_t now,
+                        __attribute__ ((unused)) uint32_t scheduled,
+                        __attribute__ ((unused)) void*    opaque) {
+  queue.timer_armed = false;
+  queue.limit       = queue.next_order;
+  if (!queue.writing) write_next();
+}
+
+returncode_t libtock_kv_queue_init(libtock_kv_queue_entry_t* entries, uint32_t count, uint32_t flush_ms) {
+  if (queue.writing) return RETURNCODE_EBUSY;
+  if (queue.timer_armed) libtock_alarm_ms_cancel(&queue.alarm);
+
+  memset(&queue, 0, sizeof(queue));
+  queue.entries  = entries;
+  queue.count    = count;
+  queue.flush_ms = flush_ms;
+  queue.error    = RETURNCODE_SUCCESS;
+  for (uint32_t i = 0; i < count; i++) {
+    entries[i].queued = false;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_kv_queue_set(const uint8_t* key, uint32_t key_len, const uint8_t* value, uint32_t value_len) {
+  if (key_len > LIBTOCK_KV_QUEUE_KEY_MAX || value_len > LIBTOCK_KV_QUEUE_VALUE_MAX) return RETURNCODE_ESIZE;
+
+  libtock_kv_queue_entry_t* entry = find(key, key_len);
+  if (entry != NULL) {
+    queue.coalesced++;
+  } else {
+    for (uint32_t i = 0; i < queue.count && entry == NULL; i++) {
+      if (!queue.entries[i].queued) entry = &queue.entries[i];
+    }
+    if (entry == NULL) return RETURNCODE_ENOMEM;
+    memcpy(entry->key, key, key_len);
+    entry->key_len = (uint16_t) key_len;
+    entry->queued  = true;
+  }
+  memcpy(entry->value, value, value_len);
+  entry->value_len = (uint16_t) value_len;
+  entry->order     = queue.next_order++;
+
+  if (queue.flush_ms == 0) {
+    queue.limit = queue.next_order;
+    if (!queue.writing) write_next();
+  } else if (!queue.writing) {
+    arm_timer();
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_kv_queue_lookup(const uint8_t* key, uint32_t key_len, uint8_t* buf, uint32_t buf_len,
+                                     uint32_t* value_len) {
+  const uint8_t* value;
+  uint32_t len;
+
+  libtock_kv_queue_entry_t* entry = find(key, key_len);
+  if (entry != NULL) {
+    value = entry->value;
+    len   = entry->value_len;
+  } else if (queue.writing && queue.key_len == key_len && memcmp(queue.key, key, key_len) == 0) {
+    value = queue.value;
+    len   = queue.value_len;
+  } else {
+    return RETURNCODE_EOFF;
+  }
+
+  *value_len = len;
+  if (len > buf_len) {
+    memcpy(buf, value, buf_len);
+    return RETURNCODE_ESIZE;
+  }
+  memcpy(buf, value, len);
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_kv_queue_flush(libtock_kv_callback_done cb) {
+  if (queue.flush_cb != NULL) return RETURNCODE_EBUSY;
+
+  queue.flush_cb = cb;
+  queue.limit    = queue.next_order;
+  if (!queue.writing) write_next();
+  return RETURNCODE_SUCCESS;
+}
+
+bool libtock_kv_queue_idle(void) {
+  return !queue.writing && libtock_kv_queue_pending() == 0;
+}
+
+uint32_t libtock_kv_queue_pending(void) {
+  uint32_t pending = 0;
+  for (uint32_t i = 0; i < queue.count; i++) {
+    if (queue.entries[i].queued) pending++;
+  }
+  return pending;
+}
+
+uint32_t libtock_kv_queue_coalesced(void) {
+  return queue.coalesced;
+}
+
+uint32_t libtock_kv_queue_failed(void) {
+  return queue.failed;
+}
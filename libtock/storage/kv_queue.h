@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../tock.h"
+#include "kv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Write-behind queue for KV sets.
+//
+// `libtock_kv_queue_set()` copies the key and value into the queue and
+// returns at once; the queue writes them to the store later, from a timer
+// `flush_ms` after the first queued set or when the app asks with
+// `libtock_kv_queue_flush()`. A set to a key that is still queued replaces
+// the queued value, so a counter updated a hundred times between flushes
+// costs one flash write.
+//
+// Writes go out in the order of each key's last set: a key set again moves
+// behind the keys set since it was first queued. A value replaced before it
+// was written is never written.
+//
+// The queue drives the KV driver from its own callbacks while it writes, so
+// no other KV call may be made until `libtock_kv_queue_idle()` is true, for
+// instance after a flush. `libtocksync_kv_get()` returns queued values before
+// they are written, but keys written through the queue should not also be
+// written with the other KV calls.
+//
+// Keys and values larger than the limits below cannot be queued. Both can be
+// raised with `make CFLAGS=-DLIBTOCK_KV_QUEUE_KEY_MAX=...`.
+
+#ifndef LIBTOCK_KV_QUEUE_KEY_MAX
+#define LIBTOCK_KV_QUEUE_KEY_MAX 32
+#endif
+
+#ifndef LIBTOCK_KV_QUEUE_VALUE_MAX
+#define LIBTOCK_KV_QUEUE_VALUE_MAX 64
+#endif
+
+typedef struct {
+  uint8_t key[LIBTOCK_KV_QUEUE_KEY_MAX];
+  uint8_t value[LIBTOCK_KV_QUEUE_VALUE_MAX];
+  uint16_t key_len;
+  uint16_t value_len;
+  bool queued;
+  // Position of the last set; the lowest is written first.
+  uint32_t order;
+} libtock_kv_queue_entry_t;
+
+// Queue up to `count` keys in `entries`, writing them `flush_ms` after the
+// first set of a batch, or as soon as the store is free if `flush_ms` is 0.
+//
+// Returns RETURNCODE_EBUSY while an earlier queue is still writing.
+returncode_t libtock_kv_queue_init(libtock_kv_queue_entry_t* entries, uint32_t count, uint32_t flush_ms);
+
+// Queue `value` as the new value of `key`.
+//
+// Returns RETURNCODE_ESIZE if the key or value is over the limits, and
+// RETURNCODE_ENOMEM if the key is not queued yet and every entry is taken;
+// flush and try again.
+returncode_t libtock_kv_queue_set(const uint8_t* key, uint32_t key_len, const uint8_t* value, uint32_t value_len);
+
+// Copy the queued value of `key` into `buf` and set `*value_len` to its full
+// length, as for `libtock_kv_cache_lookup()`.
+//
+// Returns RETURNCODE_EOFF if the key is not queued.
+returncode_t libtock_kv_queue_lookup(const uint8_t* key, uint32_t key_len, uint8_t* buf, uint32_t buf_len,
+                                     uint32_t* value_len);
+
+// Start writing now, and call `cb` once every set made before this call has
+// been written or replaced by a later set. `cb` gets the first write error
+// since the previous flush, or RETURNCODE_SUCCESS. With nothing to write,
+// `cb` runs before this returns.
+//
+// Returns RETURNCODE_EBUSY if a flush is already waiting.
+returncode_t libtock_kv_queue_flush(libtock_kv_callback_done cb);
+
+// True when nothing is queued or being written.
+bool libtock_kv_queue_idle(void);
+
+// Keys waiting to be written.
+uint32_t libtock_kv_queue_pending(void);
+
+// Sets that replaced a queued value instead of adding a write, and writes
+// the store failed.
+uint32_t libtock_kv_queue_coalesced(void);
+
+uint32_t libtock_kv_queue_failed(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,570 @@
+#include <string.h>
+
+#include "../peripherals/crc_soft.h"
+#include "logstore.h"
+
+#define PAGE_HEADER sizeof(libtock_logstore_page_header_t)
+#define RECORD_HEADER sizeof(libtock_logstore_record_header_t)
+
+#define FLAG_REMOVED    0x0001
+#define FLAG_COMPRESSED 0x0002
+
+// Length before compression at the start of a compressed record's data.
+#define RAW_LEN_SIZE sizeof(uint16_t)
+
+enum {
+  STATE_IDLE,
+  // Reading every page header to find the newest page.
+  STATE_MOUNT_HEADERS,
+  // Reading headers backwards from the newest page to find the oldest one.
+  STATE_MOUNT_WALK,
+  // Reading the pages of the log to rebuild the index.
+  STATE_MOUNT_PAGES,
+  STATE_WRITE_PAGE,
+  STATE_COMPACT_READ,
+  STATE_READ_RECORD,
+  // Reading a compressed record into `scan`.
+  STATE_READ_COMPRESSED,
+};
+
+// The store running an operation. The nonvolatile storage callbacks carry no
+// userdata, and the driver has one upcall per direction.
+static libtock_logstore_t* active = NULL;
+
+static void storage_read_done(returncode_t ret, int length);
+static void storage_write_done(returncode_t ret, int length);
+
+static uint32_t page_crc(const uint8_t* page) {
+  libtock_logstore_page_header_t header;
+  memcpy(&header, page, PAGE_HEADER);
+  header.crc = 0;
+  uint32_t crc = libtock_crc_soft_crc32_small(0, (const uint8_t*) &header, PAGE_HEADER);
+  return libtock_crc_soft_crc32_small(crc, page + PAGE_HEADER, header.used);
+}
+
+static uint32_t record_size(uint16_t len) {
+  return RECORD_HEADER + ((len + 3u) & ~3u);
+}
+
+static libtock_logstore_page_header_t* buffer_header(libtock_logstore_t* store) {
+  return (libtock_logstore_page_header_t*) store->buffer;
+}
+
+static uint16_t next_slot(const libtock_logstore_t* store, uint16_t slot) {
+  return (slot + 1) % store->page_count;
+}
+
+static uint16_t prev_slot(const libtock_logstore_t* store, uint16_t slot) {
+  return (slot + store->page_count - 1) % store->page_count;
+}
+
+// Slot the page buffer is written to.
+static uint16_t buffer_slot(const libtock_logstore_t* store) {
+  return next_slot(store, store->head);
+}
+
+static uint32_t slot_address(const libtock_logstore_t* store, uint16_t slot) {
+  return store->base + slot * store->page_size;
+}
+
+static libtock_logstore_entry_t* find_entry(libtock_logstore_t* store, uint32_t key) {
+  for (uint16_t i = 0; i < store->index_count; i++) {
+    if (store->index[i].key == key) return &store->index[i];
+  }
+  return NULL;
+}
+
+static returncode_t set_entry(libtock_logstore_t* store, uint32_t key, uint16_t page, uint16_t offset, uint16_t len,
+                              uint16_t raw_len) {
+  libtock_logstore_entry_t* entry = find_entry(store, key);
+  if (entry == NULL) {
+    if (store->index_count == store->index_capacity) return RETURNCODE_ENOMEM;
+    entry      = &store->index[store->index_count++];
+    entry->key = key;
+  }
+  entry->page   = page;
+  entry->offset  = offset;
+  entry->len     = len;
+  entry->raw_len = raw_len;
+  return RETURNCODE_SUCCESS;
+}
+
+static void remove_entry(libtock_logstore_t* store, libtock_logstore_entry_t* entry) {
+  *entry = store->index[--store->index_count];
+}
+
+static bool page_has_entries(const libtock_logstore_t* store, uint16_t page) {
+  for (uint16_t i = 0; i < store->index_count; i++) {
+    if (store->index[i].page == page) return true;
+  }
+  return false;
+}
+
+// Whether the page in `scan` was written by this store and is intact.
+static bool scan_valid(const libtock_logstore_t* store) {
+  const libtock_logstore_page_header_t* header = (const libtock_logstore_page_header_t*) store->scan;
+  return header->magic == LIBTOCK_LOGSTORE_MAGIC && header->used <= store->page_size - PAGE_HEADER &&
+         header->crc == page_crc(store->scan);
+}
+
+static void finish(libtock_logstore_t* store, returncode_t ret) {
+  libtock_logstore_callback cb = store->callback;
+  active          = NULL;
+  store->state    = STATE_IDLE;
+  store->callback = NULL;
+  if (cb != NULL) cb(ret);
+}
+
+// Start an operation, or undo the setup if its first step did not start.
+static returncode_t begin(libtock_logstore_t* store, int state, libtock_logstore_callback cb) {
+  if (active != NULL) return RETURNCODE_EBUSY;
+  active          = store;
+  store->state    = state;
+  store->callback = cb;
+  return RETURNCODE_SUCCESS;
+}
+
+static returncode_t started(libtock_logstore_t* store, returncode_t ret) {
+  if (ret != RETURNCODE_SUCCESS) {
+    active          = NULL;
+    store->state    = STATE_IDLE;
+    store->callback = NULL;
+  }
+  return ret;
+}
+
+static returncode_t read_scan(libtock_logstore_t* store, uint16_t slot, uint32_t len) {
+  return libtock_nonvolatile_storage_read(slot_address(store, slot), len, store->scan, store->page_size,
+                                          storage_read_done);
+}
+
+// Add the records of the valid page in `scan`, stored at `slot`, to the
+// index.
+static returncode_t index_scan(libtock_logstore_t* store, uint16_t slot) {
+  const libtock_logstore_page_header_t* header = (const libtock_logstore_page_header_t*) store->scan;
+  uint32_t end    = PAGE_HEADER + header->used;
+  uint32_t offset = PAGE_HEADER;
+  while (offset + RECORD_HEADER <= end) {
+    libtock_logstore_record_header_t record;
+    memcpy(&record, store->scan + offset, RECORD_HEADER);
+    uint32_t size = record_size(record.len);
+    if (offset + size > end) break;
+
+    if (record.flags & FLAG_REMOVED) {
+      libtock_logstore_entry_t* entry = find_entry(store, record.key);
+      if (entry != NULL) remove_entry(store, entry);
+    } else {
+      uint16_t raw_len = record.len;
+      if ((record.flags & FLAG_COMPRESSED) && record.len >= RAW_LEN_SIZE) {
+        memcpy(&raw_len, store->scan + offset + RECORD_HEADER, RAW_LEN_SIZE);
+      }
+      returncode_t ret = set_entry(store, record.key, slot, offset, record.len, raw_len);
+      if (ret != RETURNCODE_SUCCESS) return ret;
+    }
+    offset += size;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+// Empty the page buffer and reclaim the page after the one it is written to
+// by copying that page's live records into the buffer. Completes the running
+// operation once done.
+static void start_buffer(libtock_logstore_t* store) {
+  libtock_logstore_page_header_t* header = buffer_header(store);
+  header->used  = 0;
+  header->count = 0;
+  store->ready  = false;
+
+  uint16_t target = buffer_slot(store);
+  if (page_has_entries(store, target)) {
+    // The next write would overwrite live records.
+    store->mounted = false;
+    finish(store, RETURNCODE_FAIL);
+    return;
+  }
+
+  uint16_t victim = next_slot(store, target);
+  if (!page_has_entries(store, victim)) {
+    store->ready = true;
+    finish(store, RETURNCODE_SUCCESS);
+    return;
+  }
+
+  store->state  = STATE_COMPACT_READ;
+  store->cursor = victim;
+  returncode_t ret = read_scan(store, victim, store->page_size);
+  if (ret != RETURNCODE_SUCCESS) {
+    store->mounted = false;
+    finish(store, ret);
+  }
+}
+
+static void compact_done(libtock_logstore_t* store, returncode_t ret) {
+  if (ret != RETURNCODE_SUCCESS) {
+    store->mounted = false;
+    finish(store, ret);
+    return;
+  }
+
+  uint16_t victim = store->cursor;
+  uint16_t target = buffer_slot(store);
+  libtock_logstore_page_header_t* header = buffer_header(store);
+  if (scan_valid(store)) {
+    const libtock_logstore_page_header_t* scanned = (const libtock_logstore_page_header_t*) store->scan;
+    uint32_t end    = PAGE_HEADER + scanned->used;
+    uint32_t offset = PAGE_HEADER;
+    while (offset + RECORD_HEADER <= end) {
+      libtock_logstore_record_header_t record;
+      memcpy(&record, store->scan + offset, RECORD_HEADER);
+      uint32_t size = record_size(record.len);
+      if (offset + size > end) break;
+
+      libtock_logstore_entry_t* entry = find_entry(store, record.key);
+      if (entry != NULL && entry->page == victim && entry->offset == offset) {
+        // Live records of one page always fit in an empty buffer.
+        uint16_t new_offset = PAGE_HEADER + header->used;
+        memcpy(store->buffer + new_offset, store->scan + offset, size);
+        entry->page    = target;
+        entry->offset  = new_offset;
+        header->used  += size;
+        header->count += 1;
+      }
+      offset += size;
+    }
+  }
+
+  // Anything still pointing at the page was unreadable.
+  for (uint16_t i = 0; i < store->index_count; ) {
+    if (store->index[i].page == victim) {
+      remove_entry(store, &store->index[i]);
+    } else {
+      i++;
+    }
+  }
+
+  store->ready = true;
+  finish(store, RETURNCODE_SUCCESS);
+}
+
+static void mount_headers_done(libtock_logstore_t* store, returncode_t ret) {
+  const libtock_logstore_page_header_t* header = (const libtock_logstore_page_header_t*) store->scan;
+  if (ret == RETURNCODE_SUCCESS && header->magic == LIBTOCK_LOGSTORE_MAGIC && header->seq > store->head_seq) {
+    store->head     = store->cursor;
+    store->head_seq = header->seq;
+  }
+
+  store->cursor++;
+  if (store->cursor < store->page_count) {
+    ret = read_scan(store, store->cursor, PAGE_HEADER);
+  } else if (store->head_seq == 0) {
+    store->mounted = true;
+    start_buffer(store);
+    return;
+  } else {
+    store->state     = STATE_MOUNT_WALK;
+    store->remaining = 1;
+    store->cursor    = prev_slot(store, store->head);
+    ret = read_scan(store, store->cursor, PAGE_HEADER);
+  }
+  if (ret != RETURNCODE_SUCCESS) finish(store, ret);
+}
+
+static void mount_pages_start(libtock_logstore_t* store) {
+  store->state  = STATE_MOUNT_PAGES;
+  store->cursor = (store->head + store->page_count - (store->remaining - 1)) % store->page_count;
+  returncode_t ret = read_scan(store, store->cursor, store->page_size);
+  if (ret != RETURNCODE_SUCCESS) finish(store, ret);
+}
+
+static void mount_walk_done(libtock_logstore_t* store, returncode_t ret) {
+  const libtock_logstore_page_header_t* header = (const libtock_logstore_page_header_t*) store->scan;
+  uint32_t expected = store->head_seq - store->remaining;
+  if (ret == RETURNCODE_SUCCESS && header->magic == LIBTOCK_LOGSTORE_MAGIC && expected != 0 &&
+      header->seq == expected) {
+    store->remaining++;
+    if (store->remaining < store->page_count) {
+      store->cursor = prev_slot(store, store->cursor);
+      ret = read_scan(store, store->cursor, PAGE_HEADER);
+      if (ret != RETURNCODE_SUCCESS) finish(store, ret);
+      return;
+    }
+  }
+  mount_pages_start(store);
+}
+
+static void mount_pages_done(libtock_logstore_t* store, returncode_t ret) {
+  if (ret != RETURNCODE_SUCCESS) {
+    finish(store, ret);
+    return;
+  }
+
+  if (scan_valid(store)) {
+    ret = index_scan(store, store->cursor);
+    if (ret != RETURNCODE_SUCCESS) {
+      finish(store, ret);
+      return;
+    }
+  } else if (store->remaining == 1) {
+    // The newest page was torn by a reset during its write. Its slot is
+    // written next.
+    store->head = prev_slot(store, store->head);
+    store->head_seq--;
+  }
+
+  store->remaining--;
+  if (store->remaining > 0) {
+    store->cursor = next_slot(store, store->cursor);
+    ret = read_scan(store, store->cursor, store->page_size);
+    if (ret != RETURNCODE_SUCCESS) finish(store, ret);
+    return;
+  }
+
+  store->mounted = true;
+  start_buffer(store);
+}
+
+// Decompress `len` bytes of compressed record data into `buf`, stopping
+// after `buf_len` bytes.
+static returncode_t decompress_record(const uint8_t* data, uint16_t len, uint8_t* buf, uint16_t buf_len) {
+  if (len < RAW_LEN_SIZE) return RETURNCODE_FAIL;
+  uint32_t written;
+  return libtock_decompress(data + RAW_LEN_SIZE, len - RAW_LEN_SIZE, buf, buf_len, &written);
+}
+
+static void read_compressed_done(libtock_logstore_t* store, returncode_t ret) {
+  if (ret == RETURNCODE_SUCCESS) {
+    ret = decompress_record(store->scan, store->remaining, store->read_buf, store->read_len);
+  }
+  finish(store, ret);
+}
+
+static void storage_read_done(returncode_t ret, __attribute__ ((unused)) int length) {
+  libtock_logstore_t* store = active;
+  if (store == NULL) return;
+
+  switch (store->state) {
+    case STATE_MOUNT_HEADERS:
+      mount_headers_done(store, ret);
+      break;
+    case STATE_MOUNT_WALK:
+      mount_walk_done(store, ret);
+      break;
+    case STATE_MOUNT_PAGES:
+      mount_pages_done(store, ret);
+      break;
+    case STATE_COMPACT_READ:
+      compact_done(store, ret);
+      break;
+    case STATE_READ_RECORD:
+      finish(store, ret);
+      break;
+    case STATE_READ_COMPRESSED:
+      read_compressed_done(store, ret);
+      break;
+    default:
+      break;
+  }
+}
+
+static void storage_write_done(returncode_t ret, __attribute__ ((unused)) int length) {
+  libtock_logstore_t* store = active;
+  if (store == NULL || store->state != STATE_WRITE_PAGE) return;
+
+  if (ret != RETURNCODE_SUCCESS) {
+    // The buffer is unchanged, the flush can be retried.
+    store->ready = true;
+    finish(store, ret);
+    return;
+  }
+  store->head = buffer_slot(store);
+  store->head_seq++;
+  start_buffer(store);
+}
+
+returncode_t libtock_logstore_init(libtock_logstore_t* store, uint32_t base, uint32_t page_size,
+                                   uint16_t page_count, uint8_t* buffer, uint8_t* scan,
+                                   libtock_logstore_entry_t* index, uint16_t index_capacity) {
+  if (page_count < 2 || page_size < 32 || page_size > 65532 || page_size % 4 != 0) return RETURNCODE_EINVAL;
+
+  store->base           = base;
+  store->page_size      = page_size;
+  store->page_count     = page_count;
+  store->buffer         = buffer;
+  store->scan           = scan;
+  store->index          = index;
+  store->index_capacity = index_capacity;
+  store->index_count    = 0;
+  store->head           = page_count - 1;
+  store->head_seq       = 0;
+  store->mounted        = false;
+  store->ready          = false;
+  store->state          = STATE_IDLE;
+  store->callback       = NULL;
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_logstore_mount(libtock_logstore_t* store, libtock_logstore_callback cb) {
+  returncode_t ret = begin(store, STATE_MOUNT_HEADERS, cb);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  store->index_count = 0;
+  store->head        = store->page_count - 1;
+  store->head_seq    = 0;
+  store->mounted     = false;
+  store->ready       = false;
+  store->cursor      = 0;
+  return started(store, read_scan(store, 0, PAGE_HEADER));
+}
+
+uint32_t libtock_logstore_max_record(const libtock_logstore_t* store) {
+  return store->page_size - PAGE_HEADER - RECORD_HEADER;
+}
+
+// Add a record whose data, `len` bytes, is already at its place in the page
+// buffer.
+static returncode_t commit_record(libtock_logstore_t* store, uint32_t key, uint16_t len, uint16_t raw_len,
+                                  uint16_t flags) {
+  libtock_logstore_page_header_t* header = buffer_header(store);
+  uint32_t size   = record_size(len);
+  uint16_t offset = PAGE_HEADER + header->used;
+  if (!(flags & FLAG_REMOVED)) {
+    returncode_t ret = set_entry(store, key, buffer_slot(store), offset, len, raw_len);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+  }
+
+  libtock_logstore_record_header_t record = { .key = key, .len = len, .flags = flags };
+  memcpy(store->buffer + offset, &record, RECORD_HEADER);
+  memset(store->buffer + offset + RECORD_HEADER + len, 0, size - RECORD_HEADER - len);
+  header->used  += size;
+  header->count += 1;
+  return RETURNCODE_SUCCESS;
+}
+
+static returncode_t check_append(libtock_logstore_t* store) {
+  if (!store->mounted) return RETURNCODE_EOFF;
+  if (store->state != STATE_IDLE || !store->ready) return RETURNCODE_EBUSY;
+  return RETURNCODE_SUCCESS;
+}
+
+static returncode_t append_record(libtock_logstore_t* store, uint32_t key, const void* data, uint16_t len,
+                                  uint16_t flags) {
+  returncode_t ret = check_append(store);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (len > libtock_logstore_max_record(store)) return RETURNCODE_ESIZE;
+
+  libtock_logstore_page_header_t* header = buffer_header(store);
+  if (PAGE_HEADER + header->used + record_size(len) > store->page_size) return RETURNCODE_ENOMEM;
+
+  // An index error leaves the copied data outside the used part of the
+  // buffer.
+  uint8_t* dest = store->buffer + PAGE_HEADER + header->used + RECORD_HEADER;
+  if (len > 0) memcpy(dest, data, len);
+  return commit_record(store, key, len, len, flags);
+}
+
+returncode_t libtock_logstore_append(libtock_logstore_t* store, uint32_t key, const void* data, uint16_t len) {
+  return append_record(store, key, data, len, 0);
+}
+
+returncode_t libtock_logstore_append_compressed(libtock_logstore_t* store, uint32_t key, const void* data,
+                                                uint16_t len) {
+  returncode_t ret = check_append(store);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  // Compress straight into the buffer, keeping the result only if it is
+  // smaller than the data and the record fits.
+  libtock_logstore_page_header_t* header = buffer_header(store);
+  uint32_t free_space = store->page_size - PAGE_HEADER - header->used;
+  uint32_t limit      = free_space >= RECORD_HEADER ? (free_space - RECORD_HEADER) & ~3u : 0;
+  bool space_bound    = limit < (uint32_t) len - 1;
+  if (!space_bound) limit = len - 1;
+  if (len > 0 && limit > RAW_LEN_SIZE) {
+    uint8_t* dest = store->buffer + PAGE_HEADER + header->used + RECORD_HEADER;
+    uint32_t compressed_len;
+    if (libtock_compress(data, len, dest + RAW_LEN_SIZE, limit - RAW_LEN_SIZE, &compressed_len) ==
+        RETURNCODE_SUCCESS) {
+      memcpy(dest, &len, RAW_LEN_SIZE);
+      return commit_record(store, key, RAW_LEN_SIZE + compressed_len, len, FLAG_COMPRESSED);
+    }
+  }
+
+  ret = append_record(store, key, data, len, 0);
+  // Too large as is, but it may compress into an emptier buffer.
+  if (ret == RETURNCODE_ESIZE && space_bound && header->used > 0) ret = RETURNCODE_ENOMEM;
+  return ret;
+}
+
+returncode_t libtock_logstore_remove(libtock_logstore_t* store, uint32_t key) {
+  if (!store->mounted) return RETURNCODE_EOFF;
+  libtock_logstore_entry_t* entry = find_entry(store, key);
+  if (entry == NULL) return RETURNCODE_ENOSUPPORT;
+
+  // Older records for the key may still be on storage, so the removal has
+  // to be stored too.
+  returncode_t ret = append_record(store, key, NULL, 0, FLAG_REMOVED);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  remove_entry(store, entry);
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_logstore_flush(libtock_logstore_t* store, libtock_logstore_callback cb) {
+  if (!store->mounted) return RETURNCODE_EOFF;
+  libtock_logstore_page_header_t* header = buffer_header(store);
+  if (store->state == STATE_IDLE && header->count == 0) return RETURNCODE_EALREADY;
+
+  returncode_t ret = begin(store, STATE_WRITE_PAGE, cb);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  header->magic = LIBTOCK_LOGSTORE_MAGIC;
+  header->seq   = store->head_seq + 1;
+  header->crc   = page_crc(store->buffer);
+  store->ready  = false;
+  ret = libtock_nonvolatile_storage_write(slot_address(store, buffer_slot(store)), PAGE_HEADER + header->used,
+                                          store->buffer, store->page_size, storage_write_done);
+  if (ret != RETURNCODE_SUCCESS) store->ready = true;
+  return started(store, ret);
+}
+
+returncode_t libtock_logstore_read(libtock_logstore_t* store, uint32_t key, void* buf, uint16_t len,
+                                   uint16_t* record_len, libtock_logstore_callback cb) {
+  if (!store->mounted) return RETURNCODE_EOFF;
+  libtock_logstore_entry_t* entry = find_entry(store, key);
+  if (entry == NULL) return RETURNCODE_ENOSUPPORT;
+
+  *record_len = entry->raw_len;
+  bool compressed = entry->raw_len != entry->len;
+  uint16_t n      = len < entry->raw_len ? len : entry->raw_len;
+  uint32_t data   = slot_address(store, entry->page) + entry->offset + RECORD_HEADER;
+  if (entry->page == buffer_slot(store)) {
+    if (!compressed) {
+      memcpy(buf, store->buffer + entry->offset + RECORD_HEADER, n);
+      return RETURNCODE_EALREADY;
+    }
+    returncode_t ret = decompress_record(store->buffer + entry->offset + RECORD_HEADER, entry->len, buf, n);
+    return ret == RETURNCODE_SUCCESS ? RETURNCODE_EALREADY : ret;
+  }
+  if (n == 0) return RETURNCODE_EALREADY;
+
+  if (compressed) {
+    returncode_t ret = begin(store, STATE_READ_COMPRESSED, cb);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    store->read_buf  = buf;
+    store->read_len  = n;
+    store->remaining = entry->len;
+    return started(store,
+                   libtock_nonvolatile_storage_read(data, entry->len, store->scan, store->page_size,
+                                                    storage_read_done));
+  }
+
+  returncode_t ret = begin(store, STATE_READ_RECORD, cb);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  return started(store, libtock_nonvolatile_storage_read(data, n, buf, n, storage_read_done));
+}
+
+uint16_t libtock_logstore_count(const libtock_logstore_t* store) {
+  return store->index_count;
+}
+
+bool libtock_logstore_busy(const libtock_logstore_t* store) {
+  return store->state != STATE_IDLE;
+}
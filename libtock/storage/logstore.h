@@ -0,0 +1,181 @@
+#pragma once
+
+#include "../tock.h"
+#include "compress.h"
+#include "nonvolatile_storage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Log-structured record store on nonvolatile storage.
+//
+// Records are appended to a page buffer in RAM and written out as whole
+// pages, in order, around a ring of `page_count` pages. Nothing is rewritten
+// in place, so many small records cost one sequential page write, and writes
+// are spread evenly over the storage.
+//
+// Every record has a 32-bit key. An index in RAM maps each key to its newest
+// record, so a read costs one kernel read. Writing a key again supersedes
+// the old record, and `libtock_logstore_remove()` deletes it.
+//
+// Records added with `libtock_logstore_append_compressed()` are stored as an
+// LZ4 block (see `compress.h`) whenever that is smaller, and decompressed
+// when read, so compressible data such as sensor samples packs several times
+// more records into each page.
+//
+// Each page carries a sequence number and a CRC-32. Mounting reads the page
+// headers to find the newest run of consecutive pages, then reads those
+// pages to rebuild the index. A page torn by a reset during its write fails
+// its CRC and is ignored, along with the records it held.
+//
+// Space is reclaimed in the background. After each page write the store
+// reads the page after the next one to be written and copies its live
+// records into the fresh buffer. A page is only overwritten after its live
+// records are on storage elsewhere, so a reset never loses them. This
+// costs at most one page of live data per page written. The store is full
+// once every page is full of live records.
+//
+// The store owns the nonvolatile storage upcalls while an operation runs,
+// and only one operation of one store can run at a time. libtock-sync has
+// blocking versions of these functions.
+
+#define LIBTOCK_LOGSTORE_MAGIC 0x4c4f4753
+
+// Start of every page on storage.
+typedef struct {
+  uint32_t magic;
+  uint32_t seq;
+  // CRC-32 of the header, with this field zero, and the records.
+  uint32_t crc;
+  // Bytes of records after the header.
+  uint16_t used;
+  uint16_t count;
+} libtock_logstore_page_header_t;
+
+// Start of every record. The data follows, padded to four bytes. The data of
+// a compressed record is its length before compression as a `uint16_t`,
+// then the compressed block.
+typedef struct {
+  uint32_t key;
+  uint16_t len;
+  uint16_t flags;
+} libtock_logstore_record_header_t;
+
+// Index entry for the newest record of a key.
+typedef struct {
+  uint32_t key;
+  uint16_t page;
+  // Offset of the record header in the page.
+  uint16_t offset;
+  // Bytes of data in the record, and before compression. Only compressed
+  // records have a `raw_len` other than `len`.
+  uint16_t len;
+  uint16_t raw_len;
+} libtock_logstore_entry_t;
+
+// Function signature for operation completions.
+//
+// - `arg1` (`returncode_t`): Status of the operation.
+typedef void (*libtock_logstore_callback)(returncode_t);
+
+typedef struct {
+  uint32_t base;
+  uint32_t page_size;
+  uint16_t page_count;
+  // Page being filled, written to slot `(head + 1) % page_count`.
+  uint8_t* buffer;
+  // Page read during mount and compaction.
+  uint8_t* scan;
+  libtock_logstore_entry_t* index;
+  uint16_t index_capacity;
+  uint16_t index_count;
+  // Newest page on storage and its sequence number, zero if there is none.
+  uint16_t head;
+  uint32_t head_seq;
+  bool mounted;
+  // False while the buffer is being written or refilled by compaction.
+  bool ready;
+  // State of the running operation.
+  int state;
+  libtock_logstore_callback callback;
+  uint16_t cursor;
+  uint16_t remaining;
+  // Destination of a compressed record being read.
+  uint8_t* read_buf;
+  uint16_t read_len;
+} libtock_logstore_t;
+
+// Set up a store over `page_count` pages of `page_size` bytes of storage
+// starting at `base`. `buffer` and `scan` each hold `page_size` bytes, and
+// `index` holds `index_capacity` entries, one per distinct live key.
+//
+// Returns RETURNCODE_EINVAL if there are fewer than two pages, or
+// `page_size` is not a multiple of four between 32 and 65532 bytes.
+returncode_t libtock_logstore_init(libtock_logstore_t* store, uint32_t base, uint32_t page_size,
+                                   uint16_t page_count, uint8_t* buffer, uint8_t* scan,
+                                   libtock_logstore_entry_t* index, uint16_t index_capacity);
+
+// Recover the store from storage and rebuild the index. Storage that holds no
+// valid pages gives an empty store. `cb` is called once the store is ready.
+//
+// Completes with RETURNCODE_ENOMEM if the index is too small for the stored
+// keys.
+returncode_t libtock_logstore_mount(libtock_logstore_t* store, libtock_logstore_callback cb);
+
+// Largest record data length.
+uint32_t libtock_logstore_max_record(const libtock_logstore_t* store);
+
+// Add a record for `key` to the page buffer, superseding any earlier one. The
+// record is stored on the next `libtock_logstore_flush()` or once the buffer
+// is full, and can be read straight away.
+//
+// Returns RETURNCODE_EOFF if the store is not mounted, RETURNCODE_EBUSY while
+// an operation is running, RETURNCODE_ESIZE if `len` is above
+// `libtock_logstore_max_record()`, and RETURNCODE_ENOMEM if the buffer or
+// index is full, in which case flushing makes room unless the store is full.
+//
+// If reclaiming a page fails the store is unmounted, and must be mounted
+// again before further use.
+returncode_t libtock_logstore_append(libtock_logstore_t* store, uint32_t key, const void* data, uint16_t len);
+
+// Add a record for `key` like `libtock_logstore_append()`, compressing the
+// data if that makes it smaller. Compressed, `len` may be above
+// `libtock_logstore_max_record()` as long as the stored record is not.
+//
+// Compression uses `LIBTOCK_COMPRESS_HASH_BITS` 16-bit entries of stack.
+returncode_t libtock_logstore_append_compressed(libtock_logstore_t* store, uint32_t key, const void* data,
+                                                uint16_t len);
+
+// Delete the record for `key`. Returns as `libtock_logstore_append()`, or
+// RETURNCODE_ENOSUPPORT if there is no such record.
+returncode_t libtock_logstore_remove(libtock_logstore_t* store, uint32_t key);
+
+// Write the page buffer to storage and reclaim the next page. `cb` is called
+// once the store is ready for appends again.
+//
+// Returns RETURNCODE_EALREADY if the buffer is empty and RETURNCODE_EBUSY
+// while an operation is running.
+returncode_t libtock_logstore_flush(libtock_logstore_t* store, libtock_logstore_callback cb);
+
+// Read up to `len` bytes of the record for `key` into `buf`, and set
+// `*record_len` to the full record length. Compressed records are read
+// through the `scan` page and decompressed into `buf`, and complete with
+// RETURNCODE_FAIL if their data is corrupt.
+//
+// Returns RETURNCODE_EALREADY if the record was still in the page buffer and
+// has been copied already, in which case `cb` is not called.
+// Returns RETURNCODE_ENOSUPPORT if there is no record for `key` and
+// RETURNCODE_EBUSY while an operation is running.
+returncode_t libtock_logstore_read(libtock_logstore_t* store, uint32_t key, void* buf, uint16_t len,
+                                   uint16_t* record_len, libtock_logstore_callback cb);
+
+// Number of live records.
+uint16_t libtock_logstore_count(const libtock_logstore_t* store);
+
+// Whether an operation is running.
+bool libtock_logstore_busy(const libtock_logstore_t* store);
+
+#ifdef __cplusplus
+}
+#endif
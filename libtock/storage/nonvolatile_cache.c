@@ -0,0 +1,285 @@
+#include <string.h>
+
+#include "nonvolatile_cache.h"
+
+// The cache running a fill or flush. The nonvolatile storage callbacks carry
+// no userdata, and the driver has one upcall per direction, so only one
+// operation can be in flight.
+static libtock_nonvolatile_cache_t* active = NULL;
+
+static void storage_write_done(returncode_t ret, int length);
+static void storage_read_done(returncode_t ret, int length);
+
+static uint8_t* slot_data(libtock_nonvolatile_cache_t* cache, uint32_t slot) {
+  return cache->data + slot * cache->page_size;
+}
+
+// Bytes of the page at `page_offset` that exist in the storage.
+static uint32_t page_length(const libtock_nonvolatile_cache_t* cache, uint32_t page_offset) {
+  uint32_t remaining = cache->storage_size - page_offset;
+  return remaining < cache->page_size ? remaining : cache->page_size;
+}
+
+static int find_slot(const libtock_nonvolatile_cache_t* cache, uint32_t page_offset) {
+  for (uint32_t i = 0; i < cache->page_count; i++) {
+    if (cache->pages[i].offset == page_offset) return i;
+  }
+  return -1;
+}
+
+// Least recently used slot, or -1. Only clean slots qualify if `clean_only`.
+// The slot used by a running operation is never chosen.
+static int find_victim(const libtock_nonvolatile_cache_t* cache, bool clean_only) {
+  int victim = -1;
+  for (uint32_t i = 0; i < cache->page_count; i++) {
+    const libtock_nonvolatile_cache_page_t* page = &cache->pages[i];
+    if (cache->busy && i == cache->slot) continue;
+    if (clean_only && page->dirty) continue;
+    if (victim < 0 || page->last_use < cache->pages[victim].last_use) victim = i;
+  }
+  return victim;
+}
+
+static bool range_valid(const libtock_nonvolatile_cache_t* cache, uint32_t offset, uint32_t len) {
+  return offset <= cache->storage_size && len <= cache->storage_size - offset;
+}
+
+static void finish(libtock_nonvolatile_cache_t* cache, returncode_t ret) {
+  libtock_nonvolatile_cache_callback cb = cache->callback;
+  active             = NULL;
+  cache->busy        = false;
+  cache->callback    = NULL;
+  cache->fill_offset = LIBTOCK_NONVOLATILE_CACHE_EMPTY;
+  if (cb != NULL) cb(ret);
+}
+
+static returncode_t start_write(libtock_nonvolatile_cache_t* cache, uint32_t slot, uint32_t page_offset) {
+  cache->slot = slot;
+  cache->storage_writes++;
+  return libtock_nonvolatile_storage_write(page_offset, page_length(cache, page_offset), slot_data(cache, slot),
+                                           cache->page_size, storage_write_done);
+}
+
+static returncode_t start_read(libtock_nonvolatile_cache_t* cache) {
+  cache->storage_reads++;
+  return libtock_nonvolatile_storage_read(cache->fill_offset, page_length(cache, cache->fill_offset),
+                                          slot_data(cache, cache->slot), cache->page_size, storage_read_done);
+}
+
+// Start writing the next dirty page of a flush. Returns RETURNCODE_EALREADY
+// if none is left.
+static returncode_t flush_next(libtock_nonvolatile_cache_t* cache) {
+  for (uint32_t i = 0; i < cache->page_count; i++) {
+    libtock_nonvolatile_cache_page_t* page = &cache->pages[i];
+    if (!page->dirty) continue;
+
+    // Cleared before the write, so a write to the page while it is being
+    // flushed marks it dirty again.
+    page->dirty = false;
+    returncode_t ret = start_write(cache, i, page->offset);
+    if (ret != RETURNCODE_SUCCESS) page->dirty = true;
+    return ret;
+  }
+  return RETURNCODE_EALREADY;
+}
+
+static void storage_write_done(returncode_t ret, __attribute__ ((unused)) int length) {
+  libtock_nonvolatile_cache_t* cache = active;
+  if (cache == NULL) return;
+
+  if (cache->fill_offset != LIBTOCK_NONVOLATILE_CACHE_EMPTY) {
+    // Evicted page written back, load the requested one in its place. If
+    // either step fails the slot still holds the evicted page.
+    bool written = ret == RETURNCODE_SUCCESS;
+    if (written) ret = start_read(cache);
+    if (ret != RETURNCODE_SUCCESS) {
+      cache->pages[cache->slot].offset = cache->evict_offset;
+      cache->pages[cache->slot].dirty  = !written;
+      finish(cache, ret);
+    }
+    return;
+  }
+
+  if (ret != RETURNCODE_SUCCESS) {
+    cache->pages[cache->slot].dirty = true;
+    finish(cache, ret);
+    return;
+  }
+  ret = flush_next(cache);
+  if (ret != RETURNCODE_SUCCESS) {
+    finish(cache, ret == RETURNCODE_EALREADY ? RETURNCODE_SUCCESS : ret);
+  }
+}
+
+static void storage_read_done(returncode_t ret, __attribute__ ((unused)) int length) {
+  libtock_nonvolatile_cache_t* cache = active;
+  if (cache == NULL) return;
+
+  if (ret == RETURNCODE_SUCCESS) {
+    libtock_nonvolatile_cache_page_t* page = &cache->pages[cache->slot];
+    page->offset   = cache->fill_offset;
+    page->last_use = ++cache->clock;
+  }
+  finish(cache, ret);
+}
+
+returncode_t libtock_nonvolatile_cache_init(libtock_nonvolatile_cache_t* cache, uint8_t* data,
+                                            libtock_nonvolatile_cache_page_t* pages, uint32_t page_size,
+                                            uint32_t page_count) {
+  if (page_size == 0 || page_count == 0) return RETURNCODE_EINVAL;
+
+  returncode_t ret = libtock_nonvolatile_storage_get_number_bytes(&cache->storage_size);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  cache->data           = data;
+  cache->pages          = pages;
+  cache->page_size      = page_size;
+  cache->page_count     = page_count;
+  cache->clock          = 0;
+  cache->callback       = NULL;
+  cache->busy           = false;
+  cache->fill_offset    = LIBTOCK_NONVOLATILE_CACHE_EMPTY;
+  cache->slot           = 0;
+  cache->evict_offset   = LIBTOCK_NONVOLATILE_CACHE_EMPTY;
+  cache->storage_writes = 0;
+  cache->storage_reads  = 0;
+  for (uint32_t i = 0; i < page_count; i++) {
+    pages[i].offset   = LIBTOCK_NONVOLATILE_CACHE_EMPTY;
+    pages[i].last_use = 0;
+    pages[i].dirty    = false;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_nonvolatile_cache_read(libtock_nonvolatile_cache_t* cache, uint32_t offset, uint8_t* buf,
+                                            uint32_t len) {
+  if (!range_valid(cache, offset, len)) return RETURNCODE_ESIZE;
+  if (len == 0) return RETURNCODE_SUCCESS;
+
+  uint32_t first = offset - offset % cache->page_size;
+  for (uint32_t page = first; page < offset + len; page += cache->page_size) {
+    if (find_slot(cache, page) < 0) return RETURNCODE_EOFF;
+  }
+
+  while (len > 0) {
+    uint32_t page_offset = offset - offset % cache->page_size;
+    uint32_t in_page     = offset - page_offset;
+    uint32_t chunk       = cache->page_size - in_page;
+    if (chunk > len) chunk = len;
+
+    uint32_t slot = find_slot(cache, page_offset);
+    memcpy(buf, slot_data(cache, slot) + in_page, chunk);
+    cache->pages[slot].last_use = ++cache->clock;
+
+    buf    += chunk;
+    offset += chunk;
+    len    -= chunk;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_nonvolatile_cache_write(libtock_nonvolatile_cache_t* cache, uint32_t offset,
+                                             const uint8_t* data, uint32_t len) {
+  if (!range_valid(cache, offset, len)) return RETURNCODE_ESIZE;
+  if (len == 0) return RETURNCODE_SUCCESS;
+
+  uint32_t first = offset - offset % cache->page_size;
+  if (offset == first && len == page_length(cache, first) && find_slot(cache, first) < 0) {
+    // The whole page is replaced, take over a clean slot without reading it.
+    int victim = find_victim(cache, true);
+    if (victim < 0) return RETURNCODE_EOFF;
+    cache->pages[victim].offset = first;
+  }
+
+  for (uint32_t page = first; page < offset + len; page += cache->page_size) {
+    if (find_slot(cache, page) < 0) return RETURNCODE_EOFF;
+  }
+
+  while (len > 0) {
+    uint32_t page_offset = offset - offset % cache->page_size;
+    uint32_t in_page     = offset - page_offset;
+    uint32_t chunk       = cache->page_size - in_page;
+    if (chunk > len) chunk = len;
+
+    uint32_t slot = find_slot(cache, page_offset);
+    memcpy(slot_data(cache, slot) + in_page, data, chunk);
+    cache->pages[slot].dirty    = true;
+    cache->pages[slot].last_use = ++cache->clock;
+
+    data   += chunk;
+    offset += chunk;
+    len    -= chunk;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_nonvolatile_cache_fill(libtock_nonvolatile_cache_t* cache, uint32_t offset,
+                                            libtock_nonvolatile_cache_callback cb) {
+  if (offset >= cache->storage_size) return RETURNCODE_ESIZE;
+  if (active != NULL) return RETURNCODE_EBUSY;
+
+  uint32_t page_offset = offset - offset % cache->page_size;
+  if (find_slot(cache, page_offset) >= 0) return RETURNCODE_EALREADY;
+
+  uint32_t slot = find_victim(cache, false);
+  libtock_nonvolatile_cache_page_t* page = &cache->pages[slot];
+
+  active             = cache;
+  cache->busy        = true;
+  cache->callback    = cb;
+  cache->fill_offset = page_offset;
+  cache->slot        = slot;
+
+  returncode_t ret;
+  if (page->dirty) {
+    // Nothing may use the slot while it is written back.
+    cache->evict_offset = page->offset;
+    page->offset        = LIBTOCK_NONVOLATILE_CACHE_EMPTY;
+    page->dirty         = false;
+    ret = start_write(cache, slot, cache->evict_offset);
+    if (ret != RETURNCODE_SUCCESS) {
+      page->offset = cache->evict_offset;
+      page->dirty  = true;
+    }
+  } else {
+    page->offset = LIBTOCK_NONVOLATILE_CACHE_EMPTY;
+    ret = start_read(cache);
+  }
+
+  if (ret != RETURNCODE_SUCCESS) {
+    active             = NULL;
+    cache->busy        = false;
+    cache->callback    = NULL;
+    cache->fill_offset = LIBTOCK_NONVOLATILE_CACHE_EMPTY;
+  }
+  return ret;
+}
+
+returncode_t libtock_nonvolatile_cache_flush(libtock_nonvolatile_cache_t* cache, libtock_nonvolatile_cache_callback cb) {
+  if (active != NULL) return RETURNCODE_EBUSY;
+
+  active             = cache;
+  cache->busy        = true;
+  cache->callback    = cb;
+  cache->fill_offset = LIBTOCK_NONVOLATILE_CACHE_EMPTY;
+
+  returncode_t ret = flush_next(cache);
+  if (ret != RETURNCODE_SUCCESS) {
+    active          = NULL;
+    cache->busy     = false;
+    cache->callback = NULL;
+  }
+  return ret;
+}
+
+bool libtock_nonvolatile_cache_busy(const libtock_nonvolatile_cache_t* cache) {
+  return cache->busy;
+}
+
+uint32_t libtock_nonvolatile_cache_dirty_count(const libtock_nonvolatile_cache_t* cache) {
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < cache->page_count; i++) {
+    if (cache->pages[i].dirty) count++;
+  }
+  return count;
+}
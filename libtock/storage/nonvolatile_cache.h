@@ -0,0 +1,119 @@
+#pragma once
+
+#include "../tock.h"
+#include "nonvolatile_storage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Write-back page cache over nonvolatile storage.
+//
+// The cache keeps `page_count` pages of `page_size` bytes of the storage in
+// RAM. Reads and writes of resident pages are plain memory copies. Written
+// pages are marked dirty and only reach the storage when they are evicted or
+// flushed, so many small writes to a page cost one page-sized kernel write.
+//
+// The functions here never block. `libtock_nonvolatile_cache_read()` and
+// `libtock_nonvolatile_cache_write()` return RETURNCODE_EOFF if a page they
+// need is not resident; load it with `libtock_nonvolatile_cache_fill()` and
+// retry. libtock-sync provides versions that do this automatically.
+//
+// The cache owns the nonvolatile storage upcalls while a fill or flush is in
+// progress, and only one fill or flush can run at a time across all caches.
+// Do not access the storage region it caches through
+// `libtock_nonvolatile_storage_*` directly.
+
+// Page slot offset while the slot holds no page.
+#define LIBTOCK_NONVOLATILE_CACHE_EMPTY UINT32_MAX
+
+// Function signature for fill and flush completions.
+//
+// - `arg1` (`returncode_t`): Status of the operation.
+typedef void (*libtock_nonvolatile_cache_callback)(returncode_t);
+
+typedef struct {
+  // Storage offset of the page held in the slot, or
+  // `LIBTOCK_NONVOLATILE_CACHE_EMPTY`.
+  uint32_t offset;
+  uint32_t last_use;
+  bool dirty;
+} libtock_nonvolatile_cache_page_t;
+
+typedef struct {
+  uint8_t* data;
+  libtock_nonvolatile_cache_page_t* pages;
+  uint32_t page_size;
+  uint32_t page_count;
+  uint32_t storage_size;
+  uint32_t clock;
+  // Completion of the running fill or flush, NULL when idle.
+  libtock_nonvolatile_cache_callback callback;
+  bool busy;
+  // Page being loaded by a fill, or `LIBTOCK_NONVOLATILE_CACHE_EMPTY` during
+  // a flush.
+  uint32_t fill_offset;
+  // Slot being written back or read into.
+  uint32_t slot;
+  // Offset and state of a dirty page being evicted by a fill, restored if the
+  // write back fails.
+  uint32_t evict_offset;
+  // Number of kernel writes and reads issued, for tuning.
+  uint32_t storage_writes;
+  uint32_t storage_reads;
+} libtock_nonvolatile_cache_t;
+
+// Set up a cache using `data`, which holds `page_count * page_size` bytes, as
+// the page buffers and `pages` as the per-page state.
+//
+// Returns RETURNCODE_EINVAL if `page_size` or `page_count` is zero.
+returncode_t libtock_nonvolatile_cache_init(libtock_nonvolatile_cache_t* cache, uint8_t* data,
+                                            libtock_nonvolatile_cache_page_t* pages, uint32_t page_size,
+                                            uint32_t page_count);
+
+// Copy `len` bytes at storage offset `offset` into `buf`.
+//
+// Returns RETURNCODE_ESIZE if the range is outside the storage, or
+// RETURNCODE_EOFF, without copying anything, if a page in the range is not
+// resident.
+returncode_t libtock_nonvolatile_cache_read(libtock_nonvolatile_cache_t* cache, uint32_t offset, uint8_t* buf,
+                                            uint32_t len);
+
+// Copy `len` bytes from `data` into the cache at storage offset `offset` and
+// mark the pages dirty.
+//
+// A write that covers one whole page does not need that page to be resident
+// if a clean slot is free, because none of the old contents are kept.
+//
+// Returns RETURNCODE_ESIZE if the range is outside the storage, or
+// RETURNCODE_EOFF, without writing anything, if a page in the range is not
+// resident.
+returncode_t libtock_nonvolatile_cache_write(libtock_nonvolatile_cache_t* cache, uint32_t offset,
+                                             const uint8_t* data, uint32_t len);
+
+// Load the page containing `offset`, writing back the least recently used
+// page first if it is dirty. `cb` is called once the page is resident.
+//
+// Returns RETURNCODE_EALREADY if the page is resident, RETURNCODE_ESIZE if
+// `offset` is outside the storage, and RETURNCODE_EBUSY if a fill or flush is
+// running.
+returncode_t libtock_nonvolatile_cache_fill(libtock_nonvolatile_cache_t* cache, uint32_t offset,
+                                            libtock_nonvolatile_cache_callback cb);
+
+// Write every dirty page to the storage. `cb` is called once all of them are
+// written or one fails. Pages stay resident and usable during the flush;
+// pages written to again are flushed by the next call.
+//
+// Returns RETURNCODE_EALREADY if no page is dirty and RETURNCODE_EBUSY if a
+// fill or flush is running.
+returncode_t libtock_nonvolatile_cache_flush(libtock_nonvolatile_cache_t* cache, libtock_nonvolatile_cache_callback cb);
+
+// Whether a fill or flush is running.
+bool libtock_nonvolatile_cache_busy(const libtock_nonvolatile_cache_t* cache);
+
+// Number of dirty pages.
+uint32_t libtock_nonvolatile_cache_dirty_count(const libtock_nonvolatile_cache_t* cache);
+
+#ifdef __cplusplus
+}
+#endif
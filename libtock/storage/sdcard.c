@@ -96,3 +96,107 @@ returncode_t libtock_sdcard_write_block(uint32_t sector, uint8_t* buffer, uint32
   ret = libtock_sdcard_command_write_block(sector);
   return ret;
 }
+
+// The running multi-block transfer. The driver moves one block per command,
+// so the blocks are issued back to back from the upcall, each through an
+// allow of its part of the buffer.
+static struct {
+  bool busy;
+  bool write;
+  uint32_t sector;
+  uint32_t remaining;
+  uint8_t* buffer;
+  uint32_t block_size;
+  libtock_sdcard_callback_operations cb;
+} multi;
+
+static returncode_t multi_start_block(void) {
+  returncode_t ret;
+
+  if (multi.write) {
+    ret = libtock_sdcard_set_readonly_allow_write_buffer(multi.buffer, multi.block_size);
+    if (ret != RETURNCODE_SUCCESS) return ret;
+    return libtock_sdcard_command_write_block(multi.sector);
+  }
+
+  ret = libtock_sdcard_set_readwrite_allow_read_buffer(multi.buffer, multi.block_size);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  return libtock_sdcard_command_read_block(multi.sector);
+}
+
+static void multi_finish(returncode_t ret) {
+  if (multi.write) {
+    libtock_sdcard_set_readonly_allow_write_buffer(NULL, 0);
+  } else {
+    libtock_sdcard_set_readwrite_allow_read_buffer(NULL, 0);
+  }
+  multi.busy = false;
+  multi.cb(ret);
+}
+
+// Callback types as in `sdcard_upcall()`.
+static void sdcard_multi_upcall(int                          callback_type,
+                                int                          arg1,
+                                __attribute__ ((unused)) int arg2,
+                                __attribute__ ((unused)) void* opaque) {
+  if (!multi.busy) return;
+
+  switch (callback_type) {
+    case 2:
+    case 3: {
+      // read_done, write_done
+      multi.sector++;
+      multi.remaining--;
+      multi.buffer += multi.block_size;
+      if (multi.remaining == 0) {
+        multi_finish(RETURNCODE_SUCCESS);
+        return;
+      }
+      returncode_t ret = multi_start_block();
+      if (ret != RETURNCODE_SUCCESS) multi_finish(ret);
+      break;
+    }
+
+    case 0:
+      // card_detection_changed
+      multi_finish(RETURNCODE_EUNINSTALLED);
+      break;
+
+    case 4:
+      // error
+      multi_finish(arg1);
+      break;
+  }
+}
+
+static returncode_t sdcard_blocks(uint32_t sector, uint32_t count, uint8_t* buffer, uint32_t len, bool write,
+                                  libtock_sdcard_callback_operations cb) {
+  returncode_t ret;
+
+  if (multi.busy) return RETURNCODE_EBUSY;
+  if (count == 0 || len % count != 0) return RETURNCODE_EINVAL;
+
+  ret = libtock_sdcard_set_upcall(sdcard_multi_upcall, NULL);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  multi.write      = write;
+  multi.sector     = sector;
+  multi.remaining  = count;
+  multi.buffer     = buffer;
+  multi.block_size = len / count;
+  multi.cb         = cb;
+
+  ret = multi_start_block();
+  if (ret == RETURNCODE_SUCCESS) multi.busy = true;
+  return ret;
+}
+
+returncode_t libtock_sdcard_read_blocks(uint32_t sector, uint32_t count, uint8_t* buffer, uint32_t len,
+                                        libtock_sdcard_callback_operations cb) {
+  return sdcard_blocks(sector, count, buffer, len, false, cb);
+}
+
+returncode_t libtock_sdcard_write_blocks(uint32_t sector, uint32_t count, uint8_t* buffer, uint32_t len,
+                                         libtock_sdcard_callback_operations cb) {
+  return sdcard_blocks(sector, count, buffer, len, true, cb);
+}
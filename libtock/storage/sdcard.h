@@ -56,6 +56,39 @@ returncode_t libtock_sdcard_read_block(uint32_t sector, uint8_t* buffer, uint32_
 returncode_t libtock_sdcard_write_block(uint32_t sector, uint8_t* buffer, uint32_t len,
                                         libtock_sdcard_callback_operations cb);
 
+// Read `count` consecutive blocks from an SD card asynchronously.
+//
+// The blocks are read back to back into `buffer`, which holds `count` blocks
+// in `len` bytes, and `cb` is called once after the last block or on the first
+// error. The driver transfers one block per command, so the blocks are issued
+// one after another from the driver upcall without involving the app.
+//
+// Returns RETURNCODE_EINVAL if `len` is not a multiple of `count` and
+// RETURNCODE_EBUSY while another multi-block transfer runs.
+//
+// ## Arguments
+//
+// - `sector`: sector address of the first block.
+// - `count`: number of blocks.
+// - `buffer`: buffer to read into.
+// - `len`: len of buffer.
+// - `cb`: callback.
+returncode_t libtock_sdcard_read_blocks(uint32_t sector, uint32_t count, uint8_t* buffer, uint32_t len,
+                                        libtock_sdcard_callback_operations cb);
+
+// Write `count` consecutive blocks to an SD card asynchronously. See
+// `libtock_sdcard_read_blocks()`.
+//
+// ## Arguments
+//
+// - `sector`: sector address of the first block.
+// - `count`: number of blocks.
+// - `buffer`: buffer to write from.
+// - `len`: len of buffer.
+// - `cb`: callback.
+returncode_t libtock_sdcard_write_blocks(uint32_t sector, uint32_t count, uint8_t* buffer, uint32_t len,
+                                         libtock_sdcard_callback_operations cb);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,147 @@
+#include <string.h>
+
+#include "sdcard_cache.h"
+
+// The cache with a read in flight. The SD card callbacks carry no userdata.
+static libtock_sdcard_cache_t* active = NULL;
+
+static uint8_t* slot_data(libtock_sdcard_cache_t* cache, uint32_t slot) {
+  return cache->data + slot * cache->block_size;
+}
+
+static int find_slot(const libtock_sdcard_cache_t* cache, uint32_t sector) {
+  for (uint32_t i = 0; i < cache->block_count; i++) {
+    if (cache->blocks[i].sector == sector) return i;
+  }
+  return -1;
+}
+
+static uint32_t find_victim(const libtock_sdcard_cache_t* cache) {
+  uint32_t victim = 0;
+  for (uint32_t i = 1; i < cache->block_count; i++) {
+    if (cache->blocks[i].last_use < cache->blocks[victim].last_use) victim = i;
+  }
+  return victim;
+}
+
+static void card_read_done(returncode_t ret);
+
+static returncode_t start_fill(libtock_sdcard_cache_t* cache, uint32_t sector, libtock_sdcard_callback_operations cb) {
+  uint32_t slot = find_victim(cache);
+  cache->blocks[slot].sector = LIBTOCK_SDCARD_CACHE_EMPTY;
+
+  returncode_t ret = libtock_sdcard_read_block(sector, slot_data(cache, slot), cache->block_size, card_read_done);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  active             = cache;
+  cache->busy        = true;
+  cache->fill_sector = sector;
+  cache->slot        = slot;
+  cache->callback    = cb;
+  cache->card_reads++;
+  return RETURNCODE_SUCCESS;
+}
+
+// Start reading the next block of the read-ahead window that is not resident,
+// if any.
+static void read_ahead(libtock_sdcard_cache_t* cache) {
+  if (cache->busy) return;
+  for (uint32_t sector = cache->last_sector + 1; sector <= cache->ahead_end; sector++) {
+    if (find_slot(cache, sector) >= 0) continue;
+    // A failed read-ahead is not an error, the app reads the block itself.
+    if (start_fill(cache, sector, NULL) != RETURNCODE_SUCCESS) cache->ahead_end = cache->last_sector;
+    return;
+  }
+}
+
+static void card_read_done(returncode_t ret) {
+  libtock_sdcard_cache_t* cache = active;
+  if (cache == NULL) return;
+  active = NULL;
+
+  libtock_sdcard_callback_operations cb = cache->callback;
+  cache->busy     = false;
+  cache->callback = NULL;
+  libtock_sdcard_set_readwrite_allow_read_buffer(NULL, 0);
+
+  if (ret == RETURNCODE_SUCCESS) {
+    // Read-ahead blocks count as used now, so the window is not evicted
+    // before the app reaches it.
+    cache->blocks[cache->slot].sector   = cache->fill_sector;
+    cache->blocks[cache->slot].last_use = ++cache->clock;
+    cache->blocks[cache->slot].ahead    = cb == NULL;
+  } else if (cb == NULL) {
+    // Most likely past the end of the card.
+    cache->ahead_end = cache->last_sector;
+  }
+
+  if (cb != NULL) cb(ret);
+  read_ahead(cache);
+}
+
+returncode_t libtock_sdcard_cache_init(libtock_sdcard_cache_t* cache, uint8_t* data,
+                                       libtock_sdcard_cache_block_t* blocks, uint32_t block_size,
+                                       uint32_t block_count, uint32_t readahead) {
+  if (block_size == 0 || block_count < 2) return RETURNCODE_EINVAL;
+  if (readahead >= block_count) readahead = block_count - 1;
+
+  cache->data           = data;
+  cache->blocks         = blocks;
+  cache->block_size     = block_size;
+  cache->block_count    = block_count;
+  cache->readahead      = readahead;
+  cache->clock          = 0;
+  cache->last_sector    = LIBTOCK_SDCARD_CACHE_EMPTY;
+  cache->ahead_end      = LIBTOCK_SDCARD_CACHE_EMPTY;
+  cache->busy           = false;
+  cache->fill_sector    = LIBTOCK_SDCARD_CACHE_EMPTY;
+  cache->slot           = 0;
+  cache->callback       = NULL;
+  cache->card_reads     = 0;
+  cache->readahead_hits = 0;
+  for (uint32_t i = 0; i < block_count; i++) {
+    blocks[i].sector   = LIBTOCK_SDCARD_CACHE_EMPTY;
+    blocks[i].last_use = 0;
+    blocks[i].ahead    = false;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_sdcard_cache_read(libtock_sdcard_cache_t* cache, uint32_t sector, uint8_t* buf) {
+  // Retries of the same sector do not move the window.
+  if (sector != cache->last_sector) {
+    bool sequential = cache->last_sector != LIBTOCK_SDCARD_CACHE_EMPTY && sector == cache->last_sector + 1;
+    cache->ahead_end   = sequential ? sector + cache->readahead : sector;
+    cache->last_sector = sector;
+  }
+
+  int slot = find_slot(cache, sector);
+  if (slot < 0) return RETURNCODE_EOFF;
+
+  if (cache->blocks[slot].ahead) {
+    cache->blocks[slot].ahead = false;
+    cache->readahead_hits++;
+  }
+  memcpy(buf, slot_data(cache, slot), cache->block_size);
+  cache->blocks[slot].last_use = ++cache->clock;
+
+  read_ahead(cache);
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_sdcard_cache_fill(libtock_sdcard_cache_t* cache, uint32_t sector,
+                                       libtock_sdcard_callback_operations cb) {
+  if (cache->busy) return RETURNCODE_EBUSY;
+  if (active != NULL) return RETURNCODE_EBUSY;
+  if (find_slot(cache, sector) >= 0) return RETURNCODE_EALREADY;
+  return start_fill(cache, sector, cb);
+}
+
+void libtock_sdcard_cache_update(libtock_sdcard_cache_t* cache, uint32_t sector, const uint8_t* data) {
+  int slot = find_slot(cache, sector);
+  if (slot >= 0) memcpy(slot_data(cache, slot), data, cache->block_size);
+}
+
+bool libtock_sdcard_cache_busy(const libtock_sdcard_cache_t* cache) {
+  return cache->busy;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../tock.h"
+#include "sdcard.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Read cache with read-ahead over SD card blocks.
+//
+// The cache keeps `block_count` blocks of the card in RAM. When the app reads
+// consecutive blocks, the cache starts reading the blocks after the current
+// one in the background, up to `readahead` blocks ahead, so by the time the
+// app asks for the next block it is usually resident. The card then streams
+// while the app processes data, instead of the app waiting for every block.
+//
+// The functions here never block. `libtock_sdcard_cache_read()` returns
+// RETURNCODE_EOFF if the block is not resident; load it with
+// `libtock_sdcard_cache_fill()` and retry, or use the libtock-sync version,
+// which does this automatically.
+//
+// The cache owns the SD card upcall while a read is in flight, and only one
+// cache can be used at a time. Write blocks through
+// `libtocksync_sdcard_cache_write()` so the cache stays coherent.
+
+// Block slot sector while the slot holds no block.
+#define LIBTOCK_SDCARD_CACHE_EMPTY UINT32_MAX
+
+typedef struct {
+  // Sector held in the slot, or `LIBTOCK_SDCARD_CACHE_EMPTY`.
+  uint32_t sector;
+  uint32_t last_use;
+  // Loaded by read-ahead and not read by the app yet.
+  bool ahead;
+} libtock_sdcard_cache_block_t;
+
+typedef struct {
+  uint8_t* data;
+  libtock_sdcard_cache_block_t* blocks;
+  uint32_t block_size;
+  uint32_t block_count;
+  uint32_t readahead;
+  uint32_t clock;
+  // Last sector the app read, and the last sector to read ahead to.
+  uint32_t last_sector;
+  uint32_t ahead_end;
+  bool busy;
+  // Sector being read and its slot while busy.
+  uint32_t fill_sector;
+  uint32_t slot;
+  // Completion of the running fill, NULL for read-ahead.
+  libtock_sdcard_callback_operations callback;
+  // Number of card reads issued, and how many of them were read-ahead that
+  // the app went on to use, for tuning.
+  uint32_t card_reads;
+  uint32_t readahead_hits;
+} libtock_sdcard_cache_t;
+
+// Set up a cache using `data`, which holds `block_count * block_size` bytes,
+// as the block buffers and `blocks` as the per-block state. At most
+// `readahead` blocks are read ahead, and fewer than `block_count`.
+//
+// Returns RETURNCODE_EINVAL if `block_size` is zero or `block_count` is below
+// two.
+returncode_t libtock_sdcard_cache_init(libtock_sdcard_cache_t* cache, uint8_t* data,
+                                       libtock_sdcard_cache_block_t* blocks, uint32_t block_size,
+                                       uint32_t block_count, uint32_t readahead);
+
+// Copy block `sector` into `buf`, which holds `block_size` bytes, and read
+// ahead if the app is reading sequentially.
+//
+// Returns RETURNCODE_EOFF if the block is not resident.
+returncode_t libtock_sdcard_cache_read(libtock_sdcard_cache_t* cache, uint32_t sector, uint8_t* buf);
+
+// Load block `sector` into the least recently used slot. `cb` is called once
+// it is resident, after which read-ahead continues.
+//
+// Returns RETURNCODE_EALREADY if the block is resident already, and
+// RETURNCODE_EBUSY while a read is in flight.
+returncode_t libtock_sdcard_cache_fill(libtock_sdcard_cache_t* cache, uint32_t sector,
+                                       libtock_sdcard_callback_operations cb);
+
+// Replace the cached copy of `sector`, if any, with `data`. Call after the
+// block has been written to the card.
+void libtock_sdcard_cache_update(libtock_sdcard_cache_t* cache, uint32_t sector, const uint8_t* data);
+
+// Whether a read, requested or ahead, is in flight.
+bool libtock_sdcard_cache_busy(const libtock_sdcard_cache_t* cache);
+
+#ifdef __cplusplus
+}
+#endif
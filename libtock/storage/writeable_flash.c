@@ -0,0 +1,62 @@
+#include "writeable_flash.h"
+
+// Region bounds, looked up with memop on first use.
+static struct {
+  bool known;
+  const uint8_t* start;
+  uint32_t size;
+} regions[LIBTOCK_WRITEABLE_FLASH_REGIONS_MAX];
+
+static returncode_t region_bounds(int region, const uint8_t** start, uint32_t* size) {
+  if (region < 0) return RETURNCODE_EINVAL;
+
+  if (region < LIBTOCK_WRITEABLE_FLASH_REGIONS_MAX && regions[region].known) {
+    *start = regions[region].start;
+    *size  = regions[region].size;
+    return RETURNCODE_SUCCESS;
+  }
+
+  if (region >= tock_app_number_writeable_flash_regions()) return RETURNCODE_EINVAL;
+  const uint8_t* begin = tock_app_writeable_flash_region_begins_at(region);
+  const uint8_t* end   = tock_app_writeable_flash_region_ends_at(region);
+  if (begin == NULL || end == NULL || end < begin) return RETURNCODE_EINVAL;
+
+  *start = begin;
+  *size  = end - begin;
+  if (region < LIBTOCK_WRITEABLE_FLASH_REGIONS_MAX) {
+    regions[region].start = begin;
+    regions[region].size  = end - begin;
+    regions[region].known = true;
+  }
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t libtock_writeable_flash_size(int region, uint32_t* size) {
+  const uint8_t* start;
+  return region_bounds(region, &start, size);
+}
+
+returncode_t libtock_writeable_flash_map(int region, uint32_t offset, uint32_t len, const void** ptr) {
+  const uint8_t* start;
+  uint32_t size;
+  returncode_t ret = region_bounds(region, &start, &size);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  if (offset > size || len > size - offset) return RETURNCODE_ESIZE;
+
+  *ptr = start + offset;
+  return RETURNCODE_SUCCESS;
+}
+
+void libtock_writeable_flash_invalidate(__attribute__ ((unused)) const void* ptr,
+                                        __attribute__ ((unused)) uint32_t len) {
+  // The supported cores do not cache flash reads in the CPU, so a barrier
+  // with a memory clobber is enough: it drains outstanding accesses, flushes
+  // prefetched instructions and forces the compiler to read flash again.
+#if defined(__thumb__)
+  __asm__ volatile ("dsb\n isb" : : : "memory");
+#elif defined(__riscv)
+  __asm__ volatile ("fence rw, rw" : : : "memory");
+#else
+  __sync_synchronize();
+#endif
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Direct reads from the writeable flash regions in the app's header.
+//
+// These regions are mapped into the app's address space, so data such as
+// lookup tables can be read in place through a pointer instead of being
+// copied out with a read command. The kernel writes them (see
+// `app_state.h`), and after every write to a region the app must call
+// `libtock_writeable_flash_invalidate()` before reading it again through a
+// pointer.
+
+// Number of regions whose bounds are remembered after the first lookup.
+#ifndef LIBTOCK_WRITEABLE_FLASH_REGIONS_MAX
+#define LIBTOCK_WRITEABLE_FLASH_REGIONS_MAX 4
+#endif
+
+// Get the size in bytes of writeable flash region `region`.
+//
+// Returns RETURNCODE_EINVAL if the region does not exist.
+returncode_t libtock_writeable_flash_size(int region, uint32_t* size);
+
+// Set `*ptr` to the mapped flash at `offset` in region `region`, which is
+// valid for `len` bytes.
+//
+// Returns RETURNCODE_EINVAL if the region does not exist and
+// RETURNCODE_ESIZE if the range does not fit in it.
+returncode_t libtock_writeable_flash_map(int region, uint32_t offset, uint32_t len, const void** ptr);
+
+// Make flash written since the last call visible to reads through mapped
+// pointers. Values read from `ptr` to `ptr + len` before the write are not
+// reused by the compiler, and the flash read path is synchronized.
+void libtock_writeable_flash_invalidate(const void* ptr, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
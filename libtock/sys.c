@@ -25,32 +25,12 @@
 
 void* __dso_handle = 0;
 
-int _unlink(const char* pathname) {
-  return -1;
-}
-
 int _isatty(int fd) {
   if (fd == 0) {
     return 1;
   }
   return 0;
 }
-int _open(const char* path, int flags, ...) {
-  return -1;
-}
-int _close(int fd) {
-  return -1;
-}
-int _fstat(int fd, struct stat* st) {
-  st->st_mode = S_IFCHR;
-  return 0;
-}
-int _lseek(int fd, uint32_t offset, int whence) {
-  return 0;
-}
-int _read(int fd, void* buf, uint32_t count) {
-  return 0;   // k_read(fd, (uint8_t*) buf, count);
-}
 void _exit(int __status) {
   tock_exit((uint32_t) __status);
 }
@@ -61,12 +41,70 @@ int _kill(pid_t pid, int sig) {
   return -1;
 }
 
+// The break is grown from the kernel in chunks of this many bytes, so a
+// sequence of small allocations costs one memop instead of one each.
+#ifndef TOCK_SBRK_CHUNK
+#define TOCK_SBRK_CHUNK 512
+#endif
+
+// `brk` is the break malloc sees, `end` the kernel's break. The bytes in
+// between have been granted but not yet handed out.
+static struct {
+  uint8_t* start;
+  uint8_t* brk;
+  uint8_t* end;
+  uint8_t* peak;
+} heap;
+
+static void heap_init(void) {
+  if (heap.end != NULL) return;
+  memop_return_t ret = memop(1, 0);
+  heap.start = heap.brk = heap.end = heap.peak = (uint8_t*) ret.data;
+}
+
 caddr_t _sbrk(int incr) {
-  memop_return_t ret;
-  ret = memop(1, incr);
-  if (ret.status != TOCK_STATUSCODE_SUCCESS) {
-    errno = ENOMEM;
-    return (caddr_t) -1;
+  heap_init();
+
+  while (incr > heap.end - heap.brk) {
+    uint32_t need    = incr - (heap.end - heap.brk);
+    uint32_t chunked = (need + TOCK_SBRK_CHUNK - 1) / TOCK_SBRK_CHUNK * TOCK_SBRK_CHUNK;
+
+    memop_return_t ret = memop(1, chunked);
+    if (ret.status != TOCK_STATUSCODE_SUCCESS) {
+      // Close to the grant region a whole chunk may not fit.
+      chunked = need;
+      ret     = memop(1, chunked);
+    }
+    if (ret.status != TOCK_STATUSCODE_SUCCESS) {
+      errno = ENOMEM;
+      return (caddr_t) -1;
+    }
+
+    // Something else moved the kernel's break, so the spare bytes are not
+    // contiguous with the new memory. Continue from the new memory instead.
+    if ((uint8_t*) ret.data != heap.end) heap.brk = (uint8_t*) ret.data;
+    heap.end = (uint8_t*) ret.data + chunked;
   }
-  return (caddr_t) ret.data;
+
+  // Shrinking only moves the break malloc sees, the memory stays with the
+  // process for the next growth.
+  if (incr < heap.start - heap.brk) incr = heap.start - heap.brk;
+
+  uint8_t* old = heap.brk;
+  heap.brk += incr;
+  if (heap.brk > heap.peak) heap.peak = heap.brk;
+  return (caddr_t) old;
+}
+
+void tock_heap_usage(tock_heap_usage_t* usage) {
+  heap_init();
+
+  usage->start    = heap.start;
+  usage->brk      = heap.brk;
+  usage->used     = heap.brk - heap.start;
+  usage->peak     = heap.peak - heap.start;
+  usage->reserved = heap.end - heap.start;
+
+  uint8_t* grant = tock_app_grant_begins_at();
+  usage->free = grant > heap.end ? (uint32_t) (grant - heap.end) : 0;
 }
@@ -4,155 +4,280 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include "kernel/idle_hint.h"
+#include "kernel/read_only_state.h"
+#include "peripherals/crc_soft.h"
 #include "tock.h"
+#include "tock_inline.h"
+#include "tock_record.h"
+#include "tock_trace.h"
 
+// Storage for the deferred task queue. The default queue holds
+// `TOCK_TASK_QUEUE_DEFAULT_SIZE` entries. Both symbols are weak so that an app
+// can provide its own, differently sized queue with
+// `TOCK_TASK_QUEUE_SIZE(n)`.
+__attribute__ ((weak))
+tock_task_t tock_task_queue[TOCK_TASK_QUEUE_DEFAULT_SIZE];
+__attribute__ ((weak))
+const int tock_task_queue_size = TOCK_TASK_QUEUE_DEFAULT_SIZE;
+
+// Storage for high priority tasks. These are expected to be rare and short, so
+// this queue is small and fixed.
+static tock_task_t task_queue_high[TOCK_TASK_QUEUE_HIGH_PRIO_SIZE];
+
+// Ring buffer state for one priority level. One slot is always left empty to
+// distinguish a full queue from an empty one.
 typedef struct {
-  subscribe_upcall* cb;
-  int arg0;
-  int arg1;
-  int arg2;
-  void* ud;
-} tock_task_t;
+  tock_task_t* tasks;
+  int cur;
+  int last;
+} task_ring_t;
+
+// Indexed by `tock_task_prio_t`, so rings are checked in priority order.
+static task_ring_t task_rings[TOCK_TASK_PRIO_COUNT] = {
+  [TOCK_TASK_PRIO_HIGH]   = { task_queue_high, 0, 0 },
+  [TOCK_TASK_PRIO_NORMAL] = { tock_task_queue, 0, 0 },
+};
+
+static int task_ring_size(tock_task_prio_t prio) {
+  if (prio == TOCK_TASK_PRIO_HIGH) {
+    return TOCK_TASK_QUEUE_HIGH_PRIO_SIZE;
+  } else {
+    return tock_task_queue_size;
+  }
+}
+
+// Task queue instrumentation.
+static int task_depth            = 0;
+static int task_high_water_mark  = 0;
+static uint32_t task_enqueued    = 0;
+static uint32_t task_failures    = 0;
+static uint32_t task_coalesced   = 0;
+static uint64_t task_depth_total = 0;
+
+// Bracket a trap into the kernel, for `TOCK_YIELD_TRACE` and
+// `TOCK_SYSCALL_RECORD`.
+static inline void trace_yield_enter(__attribute__ ((unused)) tock_trace_yield_mark_t* mark) {
+#ifdef TOCK_YIELD_TRACE
+  tock_trace_yield_enter(mark);
+#endif
+#ifdef TOCK_SYSCALL_RECORD
+  tock_record_yield_enter();
+#endif
+}
 
-#define TASK_QUEUE_SIZE  16
-static tock_task_t task_queue[TASK_QUEUE_SIZE];
-static int task_cur  = 0;
-static int task_last = 0;
+static inline void trace_yield_exit(__attribute__ ((unused)) const tock_trace_yield_mark_t* mark) {
+#ifdef TOCK_SYSCALL_RECORD
+  tock_record_yield_exit();
+#endif
+#ifdef TOCK_YIELD_TRACE
+  tock_trace_yield_exit(mark);
+#endif
+}
 
 int tock_enqueue(subscribe_upcall cb, int arg0, int arg1, int arg2, void* ud) {
-  int next_task_last = (task_last + 1) % TASK_QUEUE_SIZE;
-  if (next_task_last == task_cur) {
+  return tock_enqueue_prio(TOCK_TASK_PRIO_NORMAL, cb, arg0, arg1, arg2, ud);
+}
+
+int tock_enqueue_prio(tock_task_prio_t prio, subscribe_upcall cb, int arg0, int arg1, int arg2, void* ud) {
+  if (prio >= TOCK_TASK_PRIO_COUNT) {
+    return -1;
+  }
+
+  task_ring_t* ring  = &task_rings[prio];
+  int next_task_last = (ring->last + 1) % task_ring_size(prio);
+  if (next_task_last == ring->cur) {
+    task_failures++;
+    return -1;
+  }
+
+  ring->tasks[ring->last].cb   = cb;
+  ring->tasks[ring->last].arg0 = arg0;
+  ring->tasks[ring->last].arg1 = arg1;
+  ring->tasks[ring->last].arg2 = arg2;
+  ring->tasks[ring->last].ud   = ud;
+#ifdef TOCK_YIELD_TRACE
+  ring->tasks[ring->last].enqueued = tock_trace_now();
+#endif
+  ring->last = next_task_last;
+
+  task_depth++;
+  if (task_depth > task_high_water_mark) {
+    task_high_water_mark = task_depth;
+  }
+  task_enqueued++;
+  task_depth_total += task_depth;
+
+  return ring->last;
+}
+
+int tock_enqueue_coalesce(tock_task_prio_t prio, subscribe_upcall cb, int arg0, int arg1, int arg2, void* ud) {
+  if (prio >= TOCK_TASK_PRIO_COUNT) {
     return -1;
   }
 
-  task_queue[task_last].cb   = cb;
-  task_queue[task_last].arg0 = arg0;
-  task_queue[task_last].arg1 = arg1;
-  task_queue[task_last].arg2 = arg2;
-  task_queue[task_last].ud   = ud;
-  task_last = next_task_last;
+  // Replace the arguments of a pending task from the same source. It keeps
+  // its place, so the source's latest event runs no later than its first.
+  task_ring_t* ring = &task_rings[prio];
+  int size          = task_ring_size(prio);
+  for (int i = ring->cur; i != ring->last; i = (i + 1) % size) {
+    tock_task_t* task = &ring->tasks[i];
+    if (task->cb == cb && task->ud == ud) {
+      task->arg0 = arg0;
+      task->arg1 = arg1;
+      task->arg2 = arg2;
+      task_coalesced++;
+      return 1;
+    }
+  }
+
+  return tock_enqueue_prio(prio, cb, arg0, arg1, arg2, ud) < 0 ? -1 : 0;
+}
+
+void tock_task_queue_stats(tock_task_queue_stats_t* stats) {
+  // One slot of each ring is always left empty.
+  stats->capacity         = (tock_task_queue_size - 1) + (TOCK_TASK_QUEUE_HIGH_PRIO_SIZE - 1);
+  stats->depth            = task_depth;
+  stats->high_water_mark  = task_high_water_mark;
+  stats->enqueued         = task_enqueued;
+  stats->enqueue_failures = task_failures;
+  stats->coalesced        = task_coalesced;
+  stats->average_depth    = task_enqueued == 0 ? 0 : (uint32_t) (task_depth_total / task_enqueued);
+}
 
-  return task_last;
+void tock_task_queue_stats_reset(void) {
+  task_high_water_mark = task_depth;
+  task_enqueued        = 0;
+  task_failures        = 0;
+  task_coalesced       = 0;
+  task_depth_total     = 0;
 }
 
 int tock_status_to_returncode(statuscode_t status) {
-  // Conversion is easy. Since ReturnCode numeric mappings are -1*ErrorCode,
-  // and success is 0 in both cases, we can just multiply by -1.
-  return -1 * status;
+  return tock_inline_status_to_returncode(status);
 }
 
 int tock_command_return_novalue_to_returncode(syscall_return_t command_return) {
-  if (command_return.type == TOCK_SYSCALL_SUCCESS) {
-    return RETURNCODE_SUCCESS;
-  } else if (command_return.type == TOCK_SYSCALL_FAILURE) {
-    return tock_status_to_returncode(command_return.data[0]);
-  } else {
-    // The remaining SyscallReturn variants must never happen if using this
-    // function. We return `EBADRVAL` to signal an unexpected return variant.
-    return RETURNCODE_EBADRVAL;
-  }
+  return tock_inline_command_return_novalue_to_returncode(command_return);
 }
 
 int tock_command_return_u32_to_returncode(syscall_return_t command_return, uint32_t* val) {
-  if (command_return.type == TOCK_SYSCALL_SUCCESS_U32) {
-    *val = command_return.data[0];
-    return RETURNCODE_SUCCESS;
-  } else if (command_return.type == TOCK_SYSCALL_FAILURE) {
-    return tock_status_to_returncode(command_return.data[0]);
-  } else {
-    // The remaining SyscallReturn variants must never happen if using this
-    // function. We return `EBADRVAL` to signal an unexpected return variant.
-    return RETURNCODE_EBADRVAL;
-  }
+  return tock_inline_command_return_u32_to_returncode(command_return, val);
 }
 
 int tock_command_return_u64_to_returncode(syscall_return_t command_return, uint64_t* val) {
-  uint32_t lsb;
-  uint32_t msb;
-  if (command_return.type == TOCK_SYSCALL_SUCCESS_U64) {
-    lsb  = command_return.data[0];
-    msb  = command_return.data[1];
-    *val = ((uint64_t)msb << 32) | lsb;
-    return RETURNCODE_SUCCESS;
-  } else if (command_return.type == TOCK_SYSCALL_FAILURE) {
-    return tock_status_to_returncode(command_return.data[0]);
-  } else {
-    // The remaining SyscallReturn variants must never happen if using this
-    // function. We return `EBADRVAL` to signal an unexpected return variant.
-    return RETURNCODE_EBADRVAL;
-  }
+  return tock_inline_command_return_u64_to_returncode(command_return, val);
 }
 
 int tock_command_return_u32_u32_to_returncode(syscall_return_t command_return, uint32_t* val1, uint32_t* val2) {
-  if (command_return.type == TOCK_SYSCALL_SUCCESS_U32_U32) {
-    *val1 = command_return.data[0];
-    *val2 = command_return.data[1];
-    return RETURNCODE_SUCCESS;
-  } else if (command_return.type == TOCK_SYSCALL_FAILURE) {
-    return tock_status_to_returncode(command_return.data[0]);
-  } else {
-    // The remaining SyscallReturn variants must never happen if using this
-    // function. We return `EBADRVAL` to signal an unexpected return variant.
-    return RETURNCODE_EBADRVAL;
-  }
+  return tock_inline_command_return_u32_u32_to_returncode(command_return, val1, val2);
 }
 
 int tock_subscribe_return_to_returncode(subscribe_return_t subscribe_return) {
-  // If the subscribe was successful, easily return SUCCESS.
-  if (subscribe_return.success) {
-    return RETURNCODE_SUCCESS;
-  } else {
-    // Not success, so return the proper returncode.
-    return tock_status_to_returncode(subscribe_return.status);
-  }
+  return tock_inline_subscribe_return_to_returncode(subscribe_return);
 }
 
 int tock_allow_rw_return_to_returncode(allow_rw_return_t allow_return) {
-  // If the allow was successful, easily return SUCCESS.
-  if (allow_return.success) {
-    return RETURNCODE_SUCCESS;
-  } else {
-    // Not success, so return the proper returncode.
-    return tock_status_to_returncode(allow_return.status);
-  }
+  return tock_inline_allow_rw_return_to_returncode(allow_return);
 }
 
 int tock_allow_ro_return_to_returncode(allow_ro_return_t allow_return) {
-  // If the allow was successful, easily return SUCCESS.
-  if (allow_return.success) {
-    return RETURNCODE_SUCCESS;
-  } else {
-    // Not success, so return the proper returncode.
-    return tock_status_to_returncode(allow_return.status);
-  }
+  return tock_inline_allow_ro_return_to_returncode(allow_return);
 }
 
 int tock_allow_userspace_r_return_to_returncode(allow_userspace_r_return_t allow_return) {
-  // If the allow was successful, easily return SUCCESS.
-  if (allow_return.success) {
-    return RETURNCODE_SUCCESS;
-  } else {
-    // Not success, so return the proper returncode.
-    return tock_status_to_returncode(allow_return.status);
+  return tock_inline_allow_userspace_r_return_to_returncode(allow_return);
+}
+
+// Read-only state region shared with the kernel, if any. Its count of queued
+// upcalls lets `yield_no_wait()` skip a trap that would find nothing to run.
+static void* yield_ros = NULL;
+
+void tock_yield_use_read_only_state(void* read_only_state) {
+  yield_ros = read_only_state;
+}
+
+int tock_pending_upcalls(void) {
+  if (yield_ros == NULL) {
+    return -1;
   }
+  return (int) libtock_read_only_state_get_pending_tasks(yield_ros);
+}
+
+// Scheduler hooks installed with `tock_set_yield_hooks()`, if any.
+static const tock_yield_hooks_t* yield_hooks = NULL;
+
+void tock_set_yield_hooks(const tock_yield_hooks_t* hooks) {
+  yield_hooks = hooks;
 }
 
 void yield_for(bool* cond) {
+  if (yield_hooks != NULL && yield_hooks->yield_for != NULL) {
+    yield_hooks->yield_for(cond);
+    return;
+  }
   while (!*cond) {
     yield();
   }
 }
 
+void yield_until(bool (*ready)(void* ctx), void* ctx) {
+  if (yield_hooks != NULL && yield_hooks->yield_until != NULL) {
+    yield_hooks->yield_until(ready, ctx);
+    return;
+  }
+  while (!ready(ctx)) {
+    yield();
+  }
+}
+
+struct any_of {
+  bool** conds;
+  size_t n;
+};
+
+// Index of the first true condition, or -1 if none is.
+static int first_true(bool* conds[], size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (conds[i] != NULL && *conds[i]) {
+      return (int) i;
+    }
+  }
+  return -1;
+}
+
+static bool any_true(void* ctx) {
+  struct any_of* any = (struct any_of*) ctx;
+  return first_true(any->conds, any->n) >= 0;
+}
+
+int yield_for_any(bool* conds[], size_t n) {
+  struct any_of any = { .conds = conds, .n = n };
+  yield_until(any_true, &any);
+  return first_true(conds, n);
+}
+
 // Returns 1 if a task is processed, 0 otherwise
+//
+// Pending high priority tasks always run before normal priority tasks.
 int yield_check_tasks(void) {
-  if (task_cur != task_last) {
-    tock_task_t task = task_queue[task_cur];
-    task_cur = (task_cur + 1) % TASK_QUEUE_SIZE;
-    task.cb(task.arg0, task.arg1, task.arg2, task.ud);
-    return 1;
-  } else {
-    return 0;
+  for (int prio = 0; prio < TOCK_TASK_PRIO_COUNT; prio++) {
+    task_ring_t* ring = &task_rings[prio];
+    if (ring->cur != ring->last) {
+      tock_task_t task = ring->tasks[ring->cur];
+      ring->cur = (ring->cur + 1) % task_ring_size(prio);
+      task_depth--;
+#ifdef TOCK_YIELD_TRACE
+      uint32_t start = tock_trace_now();
+      task.cb(task.arg0, task.arg1, task.arg2, task.ud);
+      tock_trace_task(task.cb, task.enqueued, start, tock_trace_now());
+#else
+      task.cb(task.arg0, task.arg1, task.arg2, task.ud);
+#endif
+      return 1;
+    }
   }
+  return 0;
 }
 
 #if defined(__thumb__)
@@ -183,21 +308,29 @@ void yield(void) {
     // According to the AAPCS: A subroutine must preserve the contents of the
     // registers r4-r8, r10, r11 and SP (and r9 in PCS variants that designate
     // r9 as v6) As our compilation flags mark r9 as the PIC base register, it
-    // does not need to be saved. Thus we must clobber r0-3, r12, and LR
+    // does not need to be saved. Thus we must clobber r0-3, r12, and LR. r0
+    // and r1 carry the arguments, so they are outputs rather than clobbers.
+    libtock_idle_hint_publish();
+    tock_trace_yield_mark_t mark;
+    trace_yield_enter(&mark);
     register uint32_t wait __asm__ ("r0")       = 1; // yield-wait
     register uint32_t wait_field __asm__ ("r1") = 0; // yield result ptr
     __asm__ volatile (
       "svc 0       \n"
+      : "+r" (wait), "+r" (wait_field)
       :
-      : "r" (wait), "r" (wait_field)
       : "memory", "r2", "r3", "r12", "lr"
       );
+    trace_yield_exit(&mark);
   }
 }
 
 int yield_no_wait(void) {
   if (yield_check_tasks()) {
     return 1;
+  } else if (yield_ros != NULL && libtock_read_only_state_get_pending_tasks(yield_ros) == 0) {
+    // The kernel has no upcall queued for us, so the trap would return 0.
+    return 0;
   } else {
     // Note: A process stops yielding when there is a callback ready to run,
     // which the kernel executes by modifying the stack frame pushed by the
@@ -220,20 +353,43 @@ int yield_no_wait(void) {
     // According to the AAPCS: A subroutine must preserve the contents of the
     // registers r4-r8, r10, r11 and SP (and r9 in PCS variants that designate
     // r9 as v6) As our compilation flags mark r9 as the PIC base register, it
-    // does not need to be saved. Thus we must clobber r0-3, r12, and LR
+    // does not need to be saved. Thus we must clobber r0-3, r12, and LR. r0
+    // and r1 carry the arguments, so they are outputs rather than clobbers.
     uint8_t result = 0;
+    tock_trace_yield_mark_t mark;
+    trace_yield_enter(&mark);
     register uint32_t wait __asm__ ("r0")       = 0; // yield-no-wait
     register uint8_t* wait_field __asm__ ("r1") = &result; // yield result ptr
     __asm__ volatile (
       "svc 0       \n"
+      : "+r" (wait), "+r" (wait_field)
       :
-      : "r" (wait), "r" (wait_field)
       : "memory", "r2", "r3", "r12", "lr"
       );
+    trace_yield_exit(&mark);
     return (int)result;
   }
 }
 
+static yield_waitfor_return_t yield_wait_for_kernel(uint32_t driver, uint32_t subscribe) {
+  // Yield-WaitFor does not invoke any upcall function, the kernel returns the
+  // upcall arguments in r0-r2 instead. Deferred tasks are not run either.
+  register uint32_t waitfor __asm__ ("r0") = 2; // yield-waitfor
+  register uint32_t r1 __asm__ ("r1")      = driver;
+  register uint32_t r2 __asm__ ("r2")      = subscribe;
+  register int rv0 __asm__ ("r0");
+  register int rv1 __asm__ ("r1");
+  register int rv2 __asm__ ("r2");
+  __asm__ volatile (
+    "svc 0       \n"
+    : "=r" (rv0), "=r" (rv1), "=r" (rv2)
+    : "r" (waitfor), "r" (r1), "r" (r2)
+    : "memory"
+    );
+  yield_waitfor_return_t rv = {rv0, rv1, rv2};
+  return rv;
+}
+
 void tock_exit(uint32_t completion_code) {
   register uint32_t r0 __asm__ ("r0") = 0; // Terminate
   register uint32_t r1 __asm__ ("r1") = completion_code;
@@ -257,163 +413,6 @@ void tock_restart(uint32_t completion_code) {
   __builtin_unreachable();
 }
 
-subscribe_return_t subscribe(uint32_t driver, uint32_t subscribe,
-                             subscribe_upcall cb, void* userdata) {
-  register uint32_t r0 __asm__ ("r0") = driver;
-  register uint32_t r1 __asm__ ("r1") = subscribe;
-  register void*    r2 __asm__ ("r2") = cb;
-  register void*    r3 __asm__ ("r3") = userdata;
-  register int rtype __asm__ ("r0");
-  register int rv1 __asm__ ("r1");
-  register int rv2 __asm__ ("r2");
-  register int rv3 __asm__ ("r3");
-  __asm__ volatile (
-    "svc 1"
-    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
-    : "r" (r0), "r" (r1), "r" (r2), "r" (r3)
-    : "memory");
-
-  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
-    subscribe_return_t rval = {true, (subscribe_upcall*)rv1, (void*)rv2, 0};
-    return rval;
-  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
-    subscribe_return_t rval = {false, (subscribe_upcall*)rv2, (void*)rv3, (statuscode_t)rv1};
-    return rval;
-  } else {
-    exit(1);
-  }
-}
-
-syscall_return_t command(uint32_t driver, uint32_t command,
-                         int arg1, int arg2) {
-  register uint32_t r0 __asm__ ("r0") = driver;
-  register uint32_t r1 __asm__ ("r1") = command;
-  register uint32_t r2 __asm__ ("r2") = arg1;
-  register uint32_t r3 __asm__ ("r3") = arg2;
-  register uint32_t rtype __asm__ ("r0");
-  register uint32_t rv1 __asm__ ("r1");
-  register uint32_t rv2 __asm__ ("r2");
-  register uint32_t rv3 __asm__ ("r3");
-  __asm__ volatile (
-    "svc 2"
-    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
-    : "r" (r0), "r" (r1), "r" (r2), "r" (r3)
-    : "memory"
-    );
-  syscall_return_t rval = {rtype, {rv1, rv2, rv3}};
-  return rval;
-}
-
-allow_ro_return_t allow_readonly(uint32_t driver, uint32_t allow, const void* ptr, size_t size) {
-  register uint32_t r0 __asm__ ("r0")       = driver;
-  register uint32_t r1 __asm__ ("r1")       = allow;
-  register const void*    r2 __asm__ ("r2") = ptr;
-  register size_t r3 __asm__ ("r3")         = size;
-  register int rtype __asm__ ("r0");
-  register int rv1 __asm__ ("r1");
-  register int rv2 __asm__ ("r2");
-  register int rv3 __asm__ ("r3");
-  __asm__ volatile (
-    "svc 4"
-    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
-    : "r" (r0), "r" (r1), "r" (r2), "r" (r3)
-    : "memory"
-    );
-  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
-    allow_ro_return_t rv = {true, (const void*)rv1, (size_t)rv2, 0};
-    return rv;
-  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
-    allow_ro_return_t rv = {false, (const void*)rv2, (size_t)rv3, (statuscode_t)rv1};
-    return rv;
-  } else {
-    // Invalid return type
-    exit(1);
-  }
-}
-
-allow_rw_return_t allow_readwrite(uint32_t driver, uint32_t allow, void* ptr, size_t size) {
-  register uint32_t r0 __asm__ ("r0")       = driver;
-  register uint32_t r1 __asm__ ("r1")       = allow;
-  register const void*    r2 __asm__ ("r2") = ptr;
-  register size_t r3 __asm__ ("r3")         = size;
-  register int rtype __asm__ ("r0");
-  register int rv1 __asm__ ("r1");
-  register int rv2 __asm__ ("r2");
-  register int rv3 __asm__ ("r3");
-  __asm__ volatile (
-    "svc 3"
-    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
-    : "r" (r0), "r" (r1), "r" (r2), "r" (r3)
-    : "memory"
-    );
-  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
-    allow_rw_return_t rv = {true, (void*)rv1, (size_t)rv2, 0};
-    return rv;
-  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
-    allow_rw_return_t rv = {false, (void*)rv2, (size_t)rv3, (statuscode_t)rv1};
-    return rv;
-  } else {
-    // Invalid return type
-    exit(1);
-  }
-}
-
-
-allow_userspace_r_return_t allow_userspace_read(uint32_t driver,
-                                                uint32_t allow, void* ptr,
-                                                size_t size) {
-  register uint32_t r0 __asm__ ("r0")       = driver;
-  register uint32_t r1 __asm__ ("r1")       = allow;
-  register const void*    r2 __asm__ ("r2") = ptr;
-  register size_t r3 __asm__ ("r3")         = size;
-  register int rtype __asm__ ("r0");
-  register int rv1 __asm__ ("r1");
-  register int rv2 __asm__ ("r2");
-  register int rv3 __asm__ ("r3");
-  __asm__ volatile (
-    "svc 7"
-    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
-    : "r" (r0), "r" (r1), "r" (r2), "r" (r3)
-    : "memory"
-    );
-  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
-    allow_userspace_r_return_t rv = {true, (void*)rv1, (size_t)rv2, 0};
-    return rv;
-  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
-    allow_userspace_r_return_t rv = {false, (void*)rv2, (size_t)rv3, (statuscode_t)rv1};
-    return rv;
-  } else {
-    // Invalid return type
-    exit(-1);
-  }
-}
-
-memop_return_t memop(uint32_t op_type, int arg1) {
-  register uint32_t r0 __asm__ ("r0") = op_type;
-  register int r1 __asm__ ("r1")      = arg1;
-  register uint32_t val __asm__ ("r1");
-  register uint32_t code __asm__ ("r0");
-  __asm__ volatile (
-    "svc 5"
-    : "=r" (code), "=r" (val)
-    : "r" (r0), "r" (r1)
-    : "memory"
-    );
-  if (code == TOCK_SYSCALL_SUCCESS) {
-    memop_return_t rv = {TOCK_STATUSCODE_SUCCESS, 0};
-    return rv;
-  } else if (code == TOCK_SYSCALL_SUCCESS_U32) {
-    memop_return_t rv = {TOCK_STATUSCODE_SUCCESS, val};
-    return rv;
-  } else if (code == TOCK_SYSCALL_FAILURE) {
-    memop_return_t rv = {(statuscode_t) val, 0};
-    return rv;
-  } else {
-    // Invalid return type
-    exit(1);
-  }
-}
-
 #elif defined(__riscv)
 
 // Implementation of the syscalls for generic RISC-V platforms.
@@ -421,45 +420,79 @@ memop_return_t memop(uint32_t op_type, int arg1) {
 // For RISC-V, the arguments are passed through registers a0-a4. Generally,
 // the syscall number is put in a4, and the required arguments are specified in
 // a0-a3. Nothing specifically syscall related is pushed to the process stack.
+//
+// As on Thumb, yield clobbers exactly the registers an upcall may: the
+// caller-saved registers of the calling convention. RV32 has more of them
+// (ra, t0-t6 and a0-a7) than Thumb (r0-r3, r12 and lr), so the list is longer
+// but not more conservative. a0 and a1 carry the arguments, so they are
+// outputs rather than clobbers. The other system calls never run upcalls and
+// only clobber what the kernel returns in.
 
 void yield(void) {
   if (yield_check_tasks()) {
     return;
   } else {
+    libtock_idle_hint_publish();
+    tock_trace_yield_mark_t mark;
+    trace_yield_enter(&mark);
     register uint32_t a0  __asm__ ("a0")        = 1; // yield-wait
     register uint32_t wait_field __asm__ ("a1") = 0; // yield result ptr
     __asm__ volatile (
       "li       a4, 0\n"
       "ecall\n"
+      : "+r" (a0), "+r" (wait_field)
       :
-      : "r" (a0), "r" (wait_field)
       : "memory", "a2", "a3", "a4", "a5", "a6", "a7",
       "t0", "t1", "t2", "t3", "t4", "t5", "t6", "ra"
       );
-
+    trace_yield_exit(&mark);
   }
 }
 
 int yield_no_wait(void) {
   if (yield_check_tasks()) {
     return 1;
+  } else if (yield_ros != NULL && libtock_read_only_state_get_pending_tasks(yield_ros) == 0) {
+    // The kernel has no upcall queued for us, so the trap would return 0.
+    return 0;
   } else {
     uint8_t result = 0;
+    tock_trace_yield_mark_t mark;
+    trace_yield_enter(&mark);
     register uint32_t a0  __asm__ ("a0") = 0; // yield-no-wait
     register uint8_t* a1  __asm__ ("a1") = &result;
     __asm__ volatile (
       "li       a4, 0\n"
       "ecall\n"
+      : "+r" (a0), "+r" (a1)
       :
-      : "r" (a0), "r" (a1)
       : "memory", "a2", "a3", "a4", "a5", "a6", "a7",
       "t0", "t1", "t2", "t3", "t4", "t5", "t6", "ra"
       );
+    trace_yield_exit(&mark);
     return (int)result;
   }
 }
 
 
+static yield_waitfor_return_t yield_wait_for_kernel(uint32_t driver, uint32_t subscribe) {
+  register uint32_t a0  __asm__ ("a0") = 2; // yield-waitfor
+  register uint32_t a1  __asm__ ("a1") = driver;
+  register uint32_t a2  __asm__ ("a2") = subscribe;
+  register int rv0 __asm__ ("a0");
+  register int rv1 __asm__ ("a1");
+  register int rv2 __asm__ ("a2");
+  __asm__ volatile (
+    "li       a4, 0\n"
+    "ecall\n"
+    : "=r" (rv0), "=r" (rv1), "=r" (rv2)
+    : "r" (a0), "r" (a1), "r" (a2)
+    : "memory", "a4"
+    );
+  yield_waitfor_return_t rv = {rv0, rv1, rv2};
+  return rv;
+}
+
 void tock_restart(uint32_t completion_code) {
   register uint32_t a0  __asm__ ("a0") = 1; // exit-restart
   register uint32_t a1  __asm__ ("a1") = completion_code;
@@ -484,165 +517,371 @@ void tock_exit(uint32_t completion_code) {
   __builtin_unreachable();
 }
 
-subscribe_return_t subscribe(uint32_t driver, uint32_t subscribe,
-                             subscribe_upcall uc, void* userdata) {
-  register uint32_t a0  __asm__ ("a0") = driver;
-  register uint32_t a1  __asm__ ("a1") = subscribe;
-  register void*    a2  __asm__ ("a2") = uc;
-  register void*    a3  __asm__ ("a3") = userdata;
-  register uint32_t a4  __asm__ ("a4") = 1;
-  register int rtype __asm__ ("a0");
-  register int rv1 __asm__ ("a1");
-  register int rv2 __asm__ ("a2");
-  register int rv3 __asm__ ("a3");
-  __asm__ volatile (
-    "ecall\n"
-    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
-    : "r" (a0), "r" (a1), "r" (a2), "r" (a3), "r" (a4)
-    : "memory");
-  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
-    subscribe_return_t rval = {true, (subscribe_upcall*)rv1, (void*)rv2, 0};
-    return rval;
-  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
-    subscribe_return_t rval = {false, (subscribe_upcall*)rv2, (void*)rv3, (statuscode_t)rv1};
-    return rval;
+#elif defined(TOCK_HOST)
+
+// Host builds, see `host/emulator.h`. The emulator delivers upcalls by
+// calling them from inside the yield, as the kernel does by switching into
+// them.
+
+void yield(void) {
+  if (yield_check_tasks()) {
+    return;
   } else {
-    exit(1);
+    libtock_idle_hint_publish();
+    tock_trace_yield_mark_t mark;
+    trace_yield_enter(&mark);
+    tock_host_yield(true);
+    trace_yield_exit(&mark);
+  }
+}
+
+int yield_no_wait(void) {
+  if (yield_check_tasks()) {
+    return 1;
+  } else {
+    tock_trace_yield_mark_t mark;
+    trace_yield_enter(&mark);
+    int result = tock_host_yield(false);
+    trace_yield_exit(&mark);
+    return result;
+  }
+}
+
+static yield_waitfor_return_t yield_wait_for_kernel(uint32_t driver, uint32_t subscribe) {
+  return tock_host_yield_wait_for(driver, subscribe);
+}
+
+void tock_restart(uint32_t completion_code) {
+  tock_host_exit(completion_code, true);
+}
+
+void tock_exit(uint32_t completion_code) {
+  tock_host_exit(completion_code, false);
+}
+
+#endif
+
+// Per-driver caches for `driver_exists()` and `subscribe()`.
+//
+// Drivers cannot appear or disappear while a process runs, so the result of
+// the existence check never goes stale. The subscribe cache remembers the
+// upcall and userdata last installed through `subscribe()` so that
+// re-installing the same pair (as the sync wrappers do before every
+// operation) skips the system call. Both caches replace entries round-robin.
+#define DRIVER_CACHE_SIZE    8
+#define SUBSCRIBE_CACHE_SIZE 16
+
+typedef struct {
+  bool valid;
+  bool exists;
+  uint32_t driver;
+} driver_cache_entry_t;
+
+static driver_cache_entry_t driver_cache[DRIVER_CACHE_SIZE];
+static int driver_cache_next = 0;
+
+typedef struct {
+  bool valid;
+  uint32_t driver;
+  uint32_t subscribe;
+  subscribe_upcall* cb;
+  void* userdata;
+} subscribe_cache_entry_t;
+
+static subscribe_cache_entry_t subscribe_cache[SUBSCRIBE_CACHE_SIZE];
+static int subscribe_cache_next = 0;
+
+static subscribe_cache_entry_t* subscribe_cache_find(uint32_t driver, uint32_t subscribe) {
+  for (int i = 0; i < SUBSCRIBE_CACHE_SIZE; i++) {
+    subscribe_cache_entry_t* entry = &subscribe_cache[i];
+    if (entry->valid && entry->driver == driver && entry->subscribe == subscribe) {
+      return entry;
+    }
   }
+  return NULL;
+}
+
+void tock_subscribe_cache_invalidate(void) {
+  for (int i = 0; i < SUBSCRIBE_CACHE_SIZE; i++) {
+    subscribe_cache[i].valid = false;
+  }
+}
+
+// Allow slots marked persistent with `tock_allow_*_set_persistent()`.
+//
+// A persistent slot keeps its buffer shared with the kernel: un-allowing it is
+// skipped, and so is re-allowing the buffer that is already shared.
+#define PERSISTENT_ALLOW_SLOTS 8
+
+typedef struct {
+  bool used;
+  bool readonly;
+  uint32_t driver;
+  uint32_t allow;
+  // Buffer currently shared with the kernel, NULL if none.
+  const void* ptr;
+  size_t size;
+} persistent_allow_t;
+
+static persistent_allow_t persistent_allows[PERSISTENT_ALLOW_SLOTS];
+
+static persistent_allow_t* persistent_allow_find(bool readonly, uint32_t driver, uint32_t allow) {
+  for (int i = 0; i < PERSISTENT_ALLOW_SLOTS; i++) {
+    persistent_allow_t* slot = &persistent_allows[i];
+    if (slot->used && slot->readonly == readonly && slot->driver == driver && slot->allow == allow) {
+      return slot;
+    }
+  }
+  return NULL;
+}
+
+// Returns true if allowing `ptr` and `size` on `slot` can be skipped.
+static bool persistent_allow_skip(const persistent_allow_t* slot, const void* ptr, size_t size) {
+  if (slot == NULL) {
+    return false;
+  }
+  // An un-allow keeps the buffer shared.
+  if (ptr == NULL && size == 0) {
+    return true;
+  }
+  return slot->ptr == ptr && slot->size == size;
+}
+
+#if defined(__thumb__) || defined(__riscv) || defined(TOCK_HOST)
+
+yield_waitfor_return_t yield_wait_for(uint32_t driver, uint32_t subscribe) {
+  yield_waitfor_return_t ret;
+  if (yield_hooks != NULL && yield_hooks->yield_wait_for != NULL &&
+      yield_hooks->yield_wait_for(driver, subscribe, &ret)) {
+    return ret;
+  }
+
+  libtock_idle_hint_publish();
+  tock_trace_yield_mark_t mark;
+  trace_yield_enter(&mark);
+  ret = yield_wait_for_kernel(driver, subscribe);
+#ifdef TOCK_SYSCALL_RECORD
+  tock_record_wait_for(driver, subscribe, &ret);
+#endif
+  trace_yield_exit(&mark);
+  return ret;
+}
+
+// The system call implementations are shared with `tock_inline.h`.
+//
+// When built with `TOCK_SYSCALL_TRACE`, each call is also recorded with
+// `tock_trace_record()`, and when built with `TOCK_SYSCALL_RECORD`, it is
+// appended to the recording of `tock_record.h`.
+
+#ifdef TOCK_SYSCALL_TRACE
+// Map the `success` flag of subscribe and allow returns back to the
+// SyscallReturn variant the kernel used.
+static syscall_rtype_t trace_rtype(bool success) {
+  return success ? TOCK_SYSCALL_SUCCESS_U32_U32 : TOCK_SYSCALL_FAILURE_U32_U32;
+}
+#endif
+
+subscribe_return_t subscribe(uint32_t driver, uint32_t subscribe,
+                             subscribe_upcall cb, void* userdata) {
+  subscribe_cache_entry_t* entry = subscribe_cache_find(driver, subscribe);
+  if (entry != NULL && entry->cb == cb && entry->userdata == userdata) {
+    // Already installed, the kernel would hand back the same pair.
+    subscribe_return_t ret = { true, cb, userdata, TOCK_STATUSCODE_SUCCESS };
+    return ret;
+  }
+
+  // The kernel gets a timing trampoline instead of `cb` when tracing yields,
+  // and a recording one around that when recording.
+  subscribe_upcall* kernel_cb = cb;
+  void* kernel_userdata       = userdata;
+#ifdef TOCK_YIELD_TRACE
+  void* trace_token = tock_trace_upcall_wrap(driver, subscribe, &kernel_cb, &kernel_userdata);
+#endif
+#ifdef TOCK_SYSCALL_RECORD
+  void* record_token = tock_record_upcall_wrap(driver, subscribe, &kernel_cb, &kernel_userdata);
+#endif
+
+#ifdef TOCK_SYSCALL_TRACE
+  uint32_t start         = tock_trace_now();
+  subscribe_return_t ret = tock_inline_subscribe(driver, subscribe, kernel_cb, kernel_userdata);
+  tock_trace_record(TOCK_TRACE_SUBSCRIBE, driver, subscribe, start, tock_trace_now(), trace_rtype(ret.success));
+#else
+  subscribe_return_t ret = tock_inline_subscribe(driver, subscribe, kernel_cb, kernel_userdata);
+#endif
+#ifdef TOCK_SYSCALL_RECORD
+  tock_record_subscribe(driver, subscribe, &ret);
+  tock_record_upcall_done(record_token, &ret);
+#endif
+#ifdef TOCK_YIELD_TRACE
+  tock_trace_upcall_done(trace_token, &ret);
+#endif
+
+  if (ret.success) {
+    if (entry == NULL) {
+      entry = &subscribe_cache[subscribe_cache_next];
+      subscribe_cache_next = (subscribe_cache_next + 1) % SUBSCRIBE_CACHE_SIZE;
+    }
+    entry->valid     = true;
+    entry->driver    = driver;
+    entry->subscribe = subscribe;
+    entry->cb        = cb;
+    entry->userdata  = userdata;
+  } else if (entry != NULL) {
+    entry->valid = false;
+  }
+  return ret;
 }
 
 syscall_return_t command(uint32_t driver, uint32_t command,
                          int arg1, int arg2) {
-  register uint32_t a0  __asm__ ("a0") = driver;
-  register uint32_t a1  __asm__ ("a1") = command;
-  register uint32_t a2  __asm__ ("a2") = arg1;
-  register uint32_t a3  __asm__ ("a3") = arg2;
-  register uint32_t a4  __asm__ ("a4") = 2;
-  register int rtype __asm__ ("a0");
-  register int rv1 __asm__ ("a1");
-  register int rv2 __asm__ ("a2");
-  register int rv3 __asm__ ("a3");
-  __asm__ volatile (
-    "ecall\n"
-    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
-    : "r" (a0), "r" (a1), "r" (a2), "r" (a3), "r" (a4)
-    : "memory");
-  syscall_return_t rval = {rtype, {rv1, rv2, rv3}};
-  return rval;
-}
-
-allow_rw_return_t allow_readwrite(uint32_t driver, uint32_t allow,
-                                  void* ptr, size_t size) {
-  register uint32_t a0  __asm__ ("a0") = driver;
-  register uint32_t a1  __asm__ ("a1") = allow;
-  register void*    a2  __asm__ ("a2") = ptr;
-  register size_t a3  __asm__ ("a3")   = size;
-  register uint32_t a4  __asm__ ("a4") = 3;
-  register int rtype __asm__ ("a0");
-  register int rv1  __asm__ ("a1");
-  register int rv2  __asm__ ("a2");
-  register int rv3  __asm__ ("a3");
-  __asm__ volatile (
-    "ecall\n"
-    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
-    : "r" (a0), "r" (a1), "r" (a2), "r" (a3), "r" (a4)
-    : "memory");
-  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
-    allow_rw_return_t rv = {true, (void*)rv1, (size_t)rv2, 0};
-    return rv;
-  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
-    allow_rw_return_t rv = {false, (void*)rv2, (size_t)rv3, (statuscode_t)rv1};
-    return rv;
-  } else {
-    // Invalid return type
-    exit(1);
+#ifdef TOCK_SYSCALL_TRACE
+  uint32_t start       = tock_trace_now();
+  syscall_return_t ret = tock_inline_command(driver, command, arg1, arg2);
+  tock_trace_record(TOCK_TRACE_COMMAND, driver, command, start, tock_trace_now(), ret.type);
+#else
+  syscall_return_t ret = tock_inline_command(driver, command, arg1, arg2);
+#endif
+#ifdef TOCK_SYSCALL_RECORD
+  tock_record_command(driver, command, arg1, arg2, &ret);
+#endif
+  return ret;
+}
+
+allow_ro_return_t allow_readonly(uint32_t driver, uint32_t allow, const void* ptr, size_t size) {
+  persistent_allow_t* slot = persistent_allow_find(true, driver, allow);
+  if (persistent_allow_skip(slot, ptr, size)) {
+    // The kernel would return the buffer that is already shared.
+    allow_ro_return_t ret = { true, slot->ptr, slot->size, TOCK_STATUSCODE_SUCCESS };
+    return ret;
+  }
+
+#ifdef TOCK_SYSCALL_TRACE
+  uint32_t start        = tock_trace_now();
+  allow_ro_return_t ret = tock_inline_allow_readonly(driver, allow, ptr, size);
+  tock_trace_record(TOCK_TRACE_ALLOW_READONLY, driver, allow, start, tock_trace_now(), trace_rtype(ret.success));
+#else
+  allow_ro_return_t ret = tock_inline_allow_readonly(driver, allow, ptr, size);
+#endif
+#ifdef TOCK_SYSCALL_RECORD
+  tock_record_allow_readonly(driver, allow, size, &ret);
+#endif
+
+  if (slot != NULL && ret.success) {
+    slot->ptr  = ptr;
+    slot->size = size;
   }
+  return ret;
 }
 
-allow_userspace_r_return_t allow_userspace_read(uint32_t driver,
-                                                uint32_t allow, void* ptr,
-                                                size_t size) {
-  register uint32_t a0  __asm__ ("a0") = driver;
-  register uint32_t a1  __asm__ ("a1") = allow;
-  register void*    a2  __asm__ ("a2") = ptr;
-  register size_t a3  __asm__ ("a3")   = size;
-  register int rtype __asm__ ("a0");
-  register int rv1  __asm__ ("a1");
-  register int rv2  __asm__ ("a2");
-  register int rv3  __asm__ ("a3");
-  __asm__ volatile (
-    "li    a4, 7\n"
-    "ecall\n"
-    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
-    : "r" (a0), "r" (a1), "r" (a2), "r" (a3)
-    : "memory");
-  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
-    allow_userspace_r_return_t rv = {true, (void*)rv1, (size_t)rv2, 0};
-    return rv;
-  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
-    allow_userspace_r_return_t rv = {false, (void*)rv2, (size_t)rv3, (statuscode_t)rv1};
-    return rv;
-  } else {
-    // Invalid return type
-    exit(-1);
+allow_rw_return_t allow_readwrite(uint32_t driver, uint32_t allow, void* ptr, size_t size) {
+  persistent_allow_t* slot = persistent_allow_find(false, driver, allow);
+  if (persistent_allow_skip(slot, ptr, size)) {
+    // The kernel would return the buffer that is already shared.
+    allow_rw_return_t ret = { true, (void*) slot->ptr, slot->size, TOCK_STATUSCODE_SUCCESS };
+    return ret;
   }
+
+#ifdef TOCK_SYSCALL_TRACE
+  uint32_t start        = tock_trace_now();
+  allow_rw_return_t ret = tock_inline_allow_readwrite(driver, allow, ptr, size);
+  tock_trace_record(TOCK_TRACE_ALLOW_READWRITE, driver, allow, start, tock_trace_now(), trace_rtype(ret.success));
+#else
+  allow_rw_return_t ret = tock_inline_allow_readwrite(driver, allow, ptr, size);
+#endif
+#ifdef TOCK_SYSCALL_RECORD
+  tock_record_allow_readwrite(driver, allow, ptr, size, &ret);
+#endif
+
+  if (slot != NULL && ret.success) {
+    slot->ptr  = ptr;
+    slot->size = size;
+  }
+  return ret;
 }
 
-allow_ro_return_t allow_readonly(uint32_t driver, uint32_t allow,
-                                 const void* ptr, size_t size) {
-  register uint32_t a0  __asm__ ("a0")    = driver;
-  register uint32_t a1  __asm__ ("a1")    = allow;
-  register const void* a2  __asm__ ("a2") = ptr;
-  register size_t a3  __asm__ ("a3")      = size;
-  register uint32_t a4  __asm__ ("a4")    = 4;
-  register int rtype __asm__ ("a0");
-  register int rv1 __asm__ ("a1");
-  register int rv2 __asm__ ("a2");
-  register int rv3 __asm__ ("a3");
-  __asm__ volatile (
-    "ecall\n"
-    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
-    : "r" (a0), "r" (a1), "r" (a2), "r" (a3), "r" (a4)
-    : "memory");
-  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
-    allow_ro_return_t rv = {true, (const void*)rv1, (size_t)rv2, 0};
-    return rv;
-  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
-    allow_ro_return_t rv = {false, (const void*)rv2, (size_t)rv3, (statuscode_t)rv1};
-    return rv;
+static returncode_t persistent_allow_set(bool readonly, uint32_t driver, uint32_t allow, bool persistent) {
+  persistent_allow_t* slot = persistent_allow_find(readonly, driver, allow);
+
+  if (persistent) {
+    if (slot != NULL) {
+      return RETURNCODE_SUCCESS;
+    }
+    for (int i = 0; i < PERSISTENT_ALLOW_SLOTS; i++) {
+      if (!persistent_allows[i].used) {
+        slot           = &persistent_allows[i];
+        slot->used     = true;
+        slot->readonly = readonly;
+        slot->driver   = driver;
+        slot->allow    = allow;
+        // Whatever is shared right now is unknown, so the next allow always
+        // reaches the kernel.
+        slot->ptr  = NULL;
+        slot->size = 0;
+        return RETURNCODE_SUCCESS;
+      }
+    }
+    return RETURNCODE_ENOMEM;
+  }
+
+  if (slot == NULL) {
+    return RETURNCODE_SUCCESS;
+  }
+  slot->used = false;
+  if (slot->ptr == NULL) {
+    return RETURNCODE_SUCCESS;
+  }
+  // Perform the un-allow that was skipped while the slot was persistent.
+  if (readonly) {
+    allow_ro_return_t ret = tock_inline_allow_readonly(driver, allow, NULL, 0);
+#ifdef TOCK_SYSCALL_RECORD
+    tock_record_allow_readonly(driver, allow, 0, &ret);
+#endif
+    return tock_allow_ro_return_to_returncode(ret);
   } else {
-    // Invalid return type
-    exit(1);
+    allow_rw_return_t ret = tock_inline_allow_readwrite(driver, allow, NULL, 0);
+#ifdef TOCK_SYSCALL_RECORD
+    tock_record_allow_readwrite(driver, allow, NULL, 0, &ret);
+#endif
+    return tock_allow_rw_return_to_returncode(ret);
   }
 }
 
-memop_return_t memop(uint32_t op_type, int arg1) {
-  register uint32_t a0    __asm__ ("a0") = op_type;
-  register int a1         __asm__ ("a1") = arg1;
-  register uint32_t a4    __asm__ ("a4") = 5;
-  register uint32_t val   __asm__ ("a1");
-  register uint32_t code  __asm__ ("a0");
-  __asm__ volatile (
-    "ecall\n"
-    : "=r" (code), "=r" (val)
-    : "r" (a0), "r" (a1), "r" (a4)
-    : "memory"
-    );
-  if (code == TOCK_SYSCALL_SUCCESS) {
-    memop_return_t rv = {TOCK_STATUSCODE_SUCCESS, 0};
-    return rv;
-  } else if (code == TOCK_SYSCALL_SUCCESS_U32) {
-    memop_return_t rv = {TOCK_STATUSCODE_SUCCESS, val};
-    return rv;
-  } else if (code == TOCK_SYSCALL_FAILURE) {
-    memop_return_t rv = {(statuscode_t) val, 0};
-    return rv;
-  } else {
-    // Invalid return type
-    exit(1);
+returncode_t tock_allow_readwrite_set_persistent(uint32_t driver, uint32_t allow, bool persistent) {
+  return persistent_allow_set(false, driver, allow, persistent);
+}
+
+returncode_t tock_allow_readonly_set_persistent(uint32_t driver, uint32_t allow, bool persistent) {
+  return persistent_allow_set(true, driver, allow, persistent);
+}
+
+void tock_allow_persistent_invalidate(void) {
+  for (int i = 0; i < PERSISTENT_ALLOW_SLOTS; i++) {
+    persistent_allows[i].ptr  = NULL;
+    persistent_allows[i].size = 0;
   }
 }
 
+allow_userspace_r_return_t allow_userspace_read(uint32_t driver,
+                                                uint32_t allow, void* ptr,
+                                                size_t size) {
+#ifdef TOCK_SYSCALL_TRACE
+  uint32_t start                 = tock_trace_now();
+  allow_userspace_r_return_t ret = tock_inline_allow_userspace_read(driver, allow, ptr, size);
+  tock_trace_record(TOCK_TRACE_ALLOW_USERSPACE_READ, driver, allow, start, tock_trace_now(),
+                    trace_rtype(ret.success));
+#else
+  allow_userspace_r_return_t ret = tock_inline_allow_userspace_read(driver, allow, ptr, size);
+#endif
+#ifdef TOCK_SYSCALL_RECORD
+  tock_record_allow_userspace_read(driver, allow, size, &ret);
+#endif
+  return ret;
+}
+
+memop_return_t memop(uint32_t op_type, int arg1) {
+  return tock_inline_memop(op_type, arg1);
+}
+
 #endif
 
 // Returns the address where the process's RAM region starts.
@@ -732,13 +971,22 @@ void* tock_app_writeable_flash_region_ends_at(int region_index) {
 }
 
 bool driver_exists(uint32_t driver) {
+  for (int i = 0; i < DRIVER_CACHE_SIZE; i++) {
+    if (driver_cache[i].valid && driver_cache[i].driver == driver) {
+      return driver_cache[i].exists;
+    }
+  }
+
   syscall_return_t sval = command(driver, 0, 0, 0);
   // Any success type says the driver exists.
-  if (sval.type >= TOCK_SYSCALL_SUCCESS) {
-    return true;
-  } else {
-    return false;
-  }
+  bool exists = sval.type >= TOCK_SYSCALL_SUCCESS;
+
+  driver_cache_entry_t* entry = &driver_cache[driver_cache_next];
+  driver_cache_next = (driver_cache_next + 1) % DRIVER_CACHE_SIZE;
+  entry->valid  = true;
+  entry->exists = exists;
+  entry->driver = driver;
+  return exists;
 }
 
 const char* tock_strerr(statuscode_t status) {
@@ -782,6 +1030,75 @@ const char* tock_strrcode(returncode_t returncode) {
   return "Invalid error number";
 }
 
+#define WARM_STATE_MAGIC 0x5741524d
+
+// The restart count is left out, so counting a restart does not need a new
+// CRC.
+static uint32_t warm_state_crc(const tock_warm_state_t* warm, const void* state, size_t size) {
+  tock_warm_state_t header = *warm;
+  header.crc      = 0;
+  header.restarts = 0;
+  uint32_t crc = libtock_crc_soft_crc32_small(0, (const uint8_t*) &header, sizeof(header));
+  return libtock_crc_soft_crc32_small(crc, state, size);
+}
+
+// Where the app's flash begins, which tells this build from another.
+static uint32_t app_flash(void) {
+  void* begins = tock_app_flash_begins_at();
+  return (uint32_t) (uintptr_t) begins;
+}
+
+bool tock_warm_state_check(tock_warm_state_t* warm, const void* state, size_t size, uint32_t version) {
+  if (warm->magic != WARM_STATE_MAGIC || warm->version != version || warm->size != size) return false;
+  if (warm->flash != app_flash()) return false;
+  if (warm->crc != warm_state_crc(warm, state, size)) return false;
+  warm->restarts++;
+  return true;
+}
+
+void tock_warm_state_seal(tock_warm_state_t* warm, const void* state, size_t size, uint32_t version) {
+  // Resealing valid state keeps its restart count.
+  bool valid = warm->magic == WARM_STATE_MAGIC && warm->version == version && warm->size == size &&
+               warm->flash == app_flash();
+  warm->magic   = WARM_STATE_MAGIC;
+  warm->version = version;
+  warm->size    = size;
+  warm->flash   = app_flash();
+  if (!valid) warm->restarts = 0;
+  warm->crc = warm_state_crc(warm, state, size);
+}
+
+void tock_warm_state_clear(tock_warm_state_t* warm) {
+  warm->magic = 0;
+}
+
+void tock_memory_report(void) {
+  tock_memory_layout_t m;
+  tock_memory_layout(&m);
+  tock_heap_usage_t heap;
+  tock_heap_usage(&heap);
+
+  uint32_t ram   = (uint8_t*) m.memory_end - (uint8_t*) m.memory_start;
+  uint32_t stack = (uint8_t*) m.stack_top - (uint8_t*) m.stack_bottom;
+  uint32_t grant = (uint8_t*) m.memory_end - (uint8_t*) m.grant_start;
+  uint32_t flash = (uint8_t*) m.flash_end - (uint8_t*) m.flash_start;
+
+  printf("Memory: %" PRIu32 " bytes RAM at %p, %" PRIu32 " bytes flash at %p\n", ram, m.memory_start, flash,
+         m.flash_start);
+  printf("  stack %6" PRIu32 "  %p-%p", stack, m.stack_bottom, m.stack_top);
+  uint32_t stack_used, stack_size;
+  if (tock_stack_high_water(&stack_used, &stack_size) == RETURNCODE_SUCCESS) {
+    printf(", %" PRIu32 " used at most", stack_used);
+  }
+  printf("\n");
+  printf("  got   %6" PRIu32 "\n", m.got_size);
+  printf("  data  %6" PRIu32 "\n", m.data_size);
+  printf("  bss   %6" PRIu32 "  ends at %p\n", m.bss_size, m.bss_end);
+  printf("  heap  %6" PRIu32 "  %p-%p, %" PRIu32 " at most\n", heap.used, m.heap_start, m.brk, heap.peak);
+  printf("  free  %6" PRIu32 "\n", m.free);
+  printf("  grant %6" PRIu32 "  from %p\n", grant, m.grant_start);
+}
+
 void tock_expect(int expected, int actual, const char* file, unsigned line) {
   if (expected != actual) {
     printf("Expectation failure in \"%s\" at line %u\n", file, line);
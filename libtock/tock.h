@@ -4,6 +4,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "config.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -75,6 +77,14 @@ typedef enum {
   TOCK_STATUSCODE_NOACK       = 13,
 } statuscode_t;
 
+// Return structure from a yield-waitfor syscall. These are the arguments the
+// upcall would have been called with.
+typedef struct {
+  int data0;
+  int data1;
+  int data2;
+} yield_waitfor_return_t;
+
 // Generic return structure from a system call.
 typedef struct {
   syscall_rtype_t type;
@@ -174,16 +184,245 @@ int tock_allow_ro_return_to_returncode(allow_ro_return_t);
 // Convert a `allow_userspace_r_return_t` to a `returncode_t`.
 int tock_allow_userspace_r_return_to_returncode(allow_userspace_r_return_t);
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// DEFERRED TASKS
+///
+////////////////////////////////////////////////////////////////////////////////
+
+// A deferred upcall. Tasks are queued with `tock_enqueue()` and run by
+// `yield()`, `yield_no_wait()`, or `yield_check_tasks()` before the process
+// yields to the kernel.
+typedef struct {
+  subscribe_upcall* cb;
+  int arg0;
+  int arg1;
+  int arg2;
+  void* ud;
+#ifdef TOCK_YIELD_TRACE
+  // Tick the task was queued at.
+  uint32_t enqueued;
+#endif
+} tock_task_t;
+
+// Number of slots in the task queue if the app does not choose a size.
+#define TOCK_TASK_QUEUE_DEFAULT_SIZE 16
+
+// Task queue storage. These are weak symbols in libtock; use
+// `TOCK_TASK_QUEUE_SIZE()` rather than referencing them directly.
+extern tock_task_t tock_task_queue[];
+extern const int tock_task_queue_size;
+
+// Override the size of the normal priority task queue.
+//
+// Use this once, at file scope, in one source file of the app:
+//
+// ```c
+// TOCK_TASK_QUEUE_SIZE(64);
+// ```
+//
+// The queue holds at most `_n - 1` pending tasks.
+#define TOCK_TASK_QUEUE_SIZE(_n)      \
+  tock_task_t tock_task_queue[(_n)]; \
+  const int tock_task_queue_size = (_n)
+
+// Number of slots in the high priority task queue.
+#define TOCK_TASK_QUEUE_HIGH_PRIO_SIZE 8
+
+// Priority classes for deferred tasks. Lower values run first.
+typedef enum {
+  // Latency-critical work, e.g. radio acknowledgements.
+  TOCK_TASK_PRIO_HIGH   = 0,
+  // Everything else. This is the priority used by `tock_enqueue()`.
+  TOCK_TASK_PRIO_NORMAL = 1,
+  TOCK_TASK_PRIO_COUNT,
+} tock_task_prio_t;
+
+// Counters describing how the task queues have been used.
+typedef struct {
+  // Maximum number of tasks the queue can hold.
+  uint32_t capacity;
+  // Number of tasks currently waiting to run.
+  uint32_t depth;
+  // Largest queue depth observed.
+  uint32_t high_water_mark;
+  // Number of tasks successfully enqueued.
+  uint32_t enqueued;
+  // Number of `tock_enqueue()` calls that failed because the queue was full.
+  uint32_t enqueue_failures;
+  // Number of `tock_enqueue_coalesce()` calls that replaced a pending task.
+  uint32_t coalesced;
+  // Mean queue depth, sampled after each successful enqueue.
+  uint32_t average_depth;
+} tock_task_queue_stats_t;
+
+// Queue a callback to be run the next time the app yields.
+//
+// Returns a non-negative value on success, or -1 if the queue is full.
 int tock_enqueue(subscribe_upcall cb, int arg0, int arg1, int arg2, void* ud);
 
+// Queue a callback with the given priority.
+//
+// All pending `TOCK_TASK_PRIO_HIGH` tasks run before any `TOCK_TASK_PRIO_NORMAL`
+// task. Tasks of the same priority run in FIFO order.
+//
+// Returns a non-negative value on success, or -1 if the queue for `prio` is
+// full or `prio` is invalid.
+int tock_enqueue_prio(tock_task_prio_t prio, subscribe_upcall cb, int arg0, int arg1, int arg2, void* ud);
+
+// Queue a callback, or update a pending one from the same source.
+//
+// The source is the pair of `cb` and `ud`. If a task with both is still
+// waiting to run, its arguments are replaced by `arg0` to `arg2` and it keeps
+// its place in the queue, so a storm of events from one source (continuous
+// samples, touch moves, pin toggles) takes one slot and runs once with the
+// latest values, instead of overrunning the queue. Use this only for events
+// where the latest supersedes the earlier ones.
+//
+// Returns 0 if the task was queued, 1 if it replaced a pending one, in which
+// case the earlier event was dropped, or -1 if the queue is full or `prio` is
+// invalid.
+int tock_enqueue_coalesce(tock_task_prio_t prio, subscribe_upcall cb, int arg0, int arg1, int arg2, void* ud);
+
+// Read the task queue counters. Counters cover all priority levels.
+void tock_task_queue_stats(tock_task_queue_stats_t* stats);
+
+// Reset the task queue counters. The high water mark restarts at the current
+// queue depth.
+void tock_task_queue_stats_reset(void);
+
 int yield_check_tasks(void);
+// Before waiting, `yield()` and `yield_wait_for()` publish the app's idle
+// hints, see `libtock/kernel/idle_hint.h`.
 void yield(void);
 void yield_for(bool*);
+
+// Block until any of the `n` conditions in `conds` is true, and return the
+// index of the first true condition. NULL entries are skipped.
+//
+// Conditions are only re-checked when `yield()` returns, i.e. once per
+// delivered upcall. For a timeout, see
+// `libtocksync_alarm_yield_for_any_with_timeout()`.
+int yield_for_any(bool* conds[], size_t n);
+
+// Block until `ready(ctx)` returns true. This is `yield_for()` for conditions
+// that are not a single flag, and is what `yield_for_any()` and the timed
+// waits in libtock-sync are built on. `ready` is checked once per delivered
+// upcall and, under a userspace scheduler, from other threads, so it must
+// only read state.
+void yield_until(bool (*ready)(void* ctx), void* ctx);
+
+// Return 1 if a deferred task or an upcall ran, 0 if there was none.
+//
+// Once a read-only state region is shared with the kernel, see
+// `libtock/kernel/read_only_state.h`, this reads the kernel's count of queued
+// upcalls first and only traps into the kernel if it is not 0, so polling
+// loops such as `while (yield_no_wait() == 0) {}` cost no system calls while
+// there is nothing to do.
 int yield_no_wait(void);
 
+// Number of upcalls the kernel has queued for the process, read from the
+// read-only state region without a system call, or -1 if no region is
+// shared. Busy loops can check this before doing work that only matters
+// once an upcall is pending.
+int tock_pending_upcalls(void);
+
+// Use `read_only_state` for `yield_no_wait()` and `tock_pending_upcalls()`, or
+// NULL to stop. `libtock_read_only_state_allocate_region()` calls this.
+void tock_yield_use_read_only_state(void* read_only_state);
+
+// Block until the kernel schedules an upcall for `subscribe` on `driver`, and
+// return that upcall's arguments.
+//
+// The upcall function registered for `subscribe` (if any) is not invoked, and
+// no other upcalls or deferred tasks run while waiting. This avoids the cost of
+// subscribing and switching into an upcall for synchronous operations.
+yield_waitfor_return_t yield_wait_for(uint32_t driver, uint32_t subscribe);
+
+// Hooks that let a userspace scheduler (e.g. `libtock/services/coop_thread.h`)
+// run other work while the caller waits.
+//
+// - `yield_for`: Replaces the body of `yield_for()`. Must return only once
+//   `*cond` is true.
+// - `yield_until`: Replaces the body of `yield_until()`, and so of
+//   `yield_for_any()`. Must return only once `ready(ctx)` is true.
+// - `yield_wait_for`: Called by `yield_wait_for()` before trapping into the
+//   kernel. Returns true and fills in `ret` if it handled the wait, or false
+//   to let `yield_wait_for()` block in the kernel as usual.
+typedef struct {
+  void (*yield_for)(bool* cond);
+  void (*yield_until)(bool (*ready)(void* ctx), void* ctx);
+  bool (*yield_wait_for)(uint32_t driver, uint32_t subscribe, yield_waitfor_return_t* ret);
+} tock_yield_hooks_t;
+
+// Install scheduler hooks, or pass NULL to restore the default behavior. The
+// hooks structure must remain valid while installed.
+void tock_set_yield_hooks(const tock_yield_hooks_t* hooks);
+
 void tock_exit(uint32_t completion_code) __attribute__ ((noreturn));
 void tock_restart(uint32_t completion_code) __attribute__ ((noreturn));
 
+// Alarm ticks read when the C startup code was entered and right before
+// `main()` was called, to measure how long the process took to start, for
+// example after `tock_restart()`. Both are 0 if the board has no alarm or
+// libtock was built with `TOCK_STARTUP_TIMING` set to 0.
+void tock_startup_ticks(uint32_t* at_start, uint32_t* at_main);
+
+// Deepest stack use so far, to size `STACK_SIZE`. This needs the stack to be
+// painted at startup, which an app enables by defining
+//
+//     const bool tock_stack_paint = true;
+//
+// `size` is always set to the stack size. Returns RETURNCODE_ENOSUPPORT if the
+// stack was not painted. If `used` equals `size` the stack probably
+// overflowed.
+returncode_t tock_stack_high_water(uint32_t* used, uint32_t* size);
+extern const bool tock_stack_paint;
+
+// State that survives `tock_restart()`, so an app can skip re-initialization
+// on a warm restart.
+//
+// Variables marked `TOCK_NOINIT` go in the `.noinit` section, which startup
+// neither loads nor zeroes. The kernel leaves the app's RAM alone when it
+// restarts the app, so they keep their value, but after a cold boot or a
+// reflash they hold garbage. A `tock_warm_state_t` next to them records a
+// CRC-32 and a version to tell the two apart:
+//
+//     TOCK_NOINIT static tock_warm_state_t warm;
+//     TOCK_NOINIT static struct config config;
+//
+//     if (!tock_warm_state_check(&warm, &config, sizeof(config), CONFIG_VERSION)) {
+//       load_config(&config);
+//       tock_warm_state_seal(&warm, &config, sizeof(config), CONFIG_VERSION);
+//     }
+//
+// Seal the state again after changing it, and before restarting, or the
+// next check fails and the app starts cold.
+#define TOCK_NOINIT __attribute__((section(".noinit")))
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size;
+  // CRC-32 of this header, with this field zero, and the state.
+  uint32_t crc;
+  // Where the app was in flash when sealed, so a new image starts cold.
+  uint32_t flash;
+  // Successful checks since the state was last sealed from a cold start.
+  uint32_t restarts;
+} tock_warm_state_t;
+
+// Whether `warm` vouches for the `size` bytes at `state` with version
+// `version`. Counts a restart in `warm->restarts` if so.
+bool tock_warm_state_check(tock_warm_state_t* warm, const void* state, size_t size, uint32_t version);
+
+// Record the `size` bytes at `state` as valid warm state of version
+// `version`.
+void tock_warm_state_seal(tock_warm_state_t* warm, const void* state, size_t size, uint32_t version);
+
+// Make the next check fail, so the next start is cold.
+void tock_warm_state_clear(tock_warm_state_t* warm);
+
 __attribute__ ((warn_unused_result))
 syscall_return_t command(uint32_t driver, uint32_t command, int arg1, int arg2);
 
@@ -191,9 +430,21 @@ syscall_return_t command(uint32_t driver, uint32_t command, int arg1, int arg2);
 // be the Null Upcall.
 #define TOCK_NULL_UPCALL 0
 
+// Install an upcall.
+//
+// The most recently installed (upcall, userdata) pair is cached per driver and
+// subscribe number. Subscribing the same pair again returns success without a
+// system call. Note that this also skips the kernel dropping any upcalls still
+// queued for that subscription.
 __attribute__ ((warn_unused_result))
 subscribe_return_t subscribe(uint32_t driver, uint32_t subscribe, subscribe_upcall uc, void* userdata);
 
+// Forget every cached subscription so the next `subscribe()` calls reach the
+// kernel. Must be called after installing upcalls without `subscribe()`, for
+// example with `tock_inline_subscribe()`: until then a `subscribe()` of the
+// pair libtock last installed is skipped, leaving the other upcall in place.
+void tock_subscribe_cache_invalidate(void);
+
 __attribute__ ((warn_unused_result))
 allow_rw_return_t allow_readwrite(uint32_t driver, uint32_t allow, void* ptr, size_t size);
 
@@ -205,6 +456,26 @@ allow_userspace_r_return_t allow_userspace_read(uint32_t driver,
 __attribute__ ((warn_unused_result))
 allow_ro_return_t allow_readonly(uint32_t driver, uint32_t allow, const void* ptr, size_t size);
 
+// Mark a read-write or read-only allow slot as persistent, or clear the mark.
+//
+// While a slot is persistent, `allow_readwrite()`/`allow_readonly()` skip the
+// system call when asked to un-allow (NULL, 0) or to re-share the buffer that
+// is already shared. Driver wrappers that allow and un-allow around every
+// operation then cost no allow syscalls when the app keeps reusing the same
+// buffer. The kernel keeps access to that buffer between operations, so the
+// app must not rely on un-allowing to reclaim it.
+//
+// Clearing the mark un-allows the buffer if one is still shared. Returns
+// RETURNCODE_ENOMEM if all persistent slots are in use.
+returncode_t tock_allow_readwrite_set_persistent(uint32_t driver, uint32_t allow, bool persistent);
+returncode_t tock_allow_readonly_set_persistent(uint32_t driver, uint32_t allow, bool persistent);
+
+// Forget which buffer each persistent slot has shared, keeping the slots
+// persistent, so their next allows reach the kernel. Must be called after
+// sharing buffers on a persistent slot without `allow_readwrite()` or
+// `allow_readonly()`, for example with `tock_inline_allow_readwrite()`.
+void tock_allow_persistent_invalidate(void);
+
 // Call the memop syscall.
 memop_return_t memop(uint32_t op_type, int arg1);
 
@@ -218,8 +489,63 @@ int tock_app_number_writeable_flash_regions(void);
 void* tock_app_writeable_flash_region_begins_at(int region_index);
 void* tock_app_writeable_flash_region_ends_at(int region_index);
 
+// Heap usage, to right-size an app's memory.
+typedef struct {
+  // Start of the heap and the current break returned by `sbrk(0)`.
+  void* start;
+  void* brk;
+  // Bytes between `start` and the break, now and at its highest.
+  uint32_t used;
+  uint32_t peak;
+  // Bytes granted by the kernel. `_sbrk()` grows the heap in chunks of
+  // `TOCK_SBRK_CHUNK` bytes, so this can be above `used`.
+  uint32_t reserved;
+  // Bytes the heap can still grow by before reaching the grant region.
+  uint32_t free;
+} tock_heap_usage_t;
+
+// Fill `usage` with the heap's current state.
+void tock_heap_usage(tock_heap_usage_t* usage);
+
+// Where the app's memory went, from the crt0 header and the kernel's memops.
+//
+// The app's RAM holds, from the bottom, the stack, the GOT, `.data` and
+// `.bss`, then the heap up to the break; the kernel's grant region starts
+// above. Addresses are NULL if the kernel does not report them.
+typedef struct {
+  void* memory_start;
+  void* memory_end;
+  void* grant_start;
+  void* flash_start;
+  void* flash_end;
+  // The stack grows down from `stack_top` to `stack_bottom`.
+  void* stack_bottom;
+  void* stack_top;
+  // Section sizes in bytes, and the end of `.bss`, where the heap starts.
+  uint32_t got_size;
+  uint32_t data_size;
+  uint32_t bss_size;
+  void* bss_end;
+  // Start of the heap and the break, as in `tock_heap_usage_t`.
+  void* heap_start;
+  void* brk;
+  // Bytes `malloc()` can still grow into: those below the grant region,
+  // including ones already granted but not handed out.
+  uint32_t free;
+} tock_memory_layout_t;
+
+// Fill `layout` with the app's memory layout now.
+void tock_memory_layout(tock_memory_layout_t* layout);
+
+// Print the memory layout and stack and heap use to the console, to spot
+// where RAM goes and tune `STACK_SIZE`, `APP_HEAP_SIZE` and buffer sizes.
+void tock_memory_report(void);
+
 
 // Checks to see if the given driver number exists on this platform.
+//
+// The answer is cached, so only the first call for a driver issues a system
+// call.
 bool driver_exists(uint32_t driver);
 
 
@@ -0,0 +1,498 @@
+#pragma once
+
+// Inlinable system call implementations.
+//
+// The system call functions in `tock.h` (`command()`, `subscribe()`, etc.) are
+// out-of-line functions that return their results through memory. Code on a
+// hot path can include this header instead to get `static inline` versions of
+// the same system calls and return code conversions. When the call is inlined,
+// the compiler can keep the returned structure in registers and skip the
+// function call entirely.
+//
+// The inline versions make the system call directly and bypass libtock's
+// caches of installed upcalls and persistent allows. Mixing them with the
+// out-of-line calls is fine for `command()` and `memop()`. After an inline
+// subscribe or allow, call `tock_subscribe_cache_invalidate()` or
+// `tock_allow_persistent_invalidate()`, or a later `subscribe()` or allow of
+// the buffer libtock remembers may be skipped without reaching the kernel.
+//
+// For example, a polling loop reading a GPIO pin:
+//
+// ```c
+// #include <libtock/peripherals/syscalls/gpio_syscalls.h>
+// #include <libtock/tock_inline.h>
+//
+// uint32_t value;
+// syscall_return_t cval = tock_inline_command(DRIVER_NUM_GPIO, 6, pin, 0);
+// int err = tock_inline_command_return_u32_to_returncode(cval, &value);
+// ```
+
+#include <stdlib.h>
+
+#include "tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline int tock_inline_status_to_returncode(statuscode_t status) {
+  // Conversion is easy. Since ReturnCode numeric mappings are -1*ErrorCode,
+  // and success is 0 in both cases, we can just multiply by -1.
+  return -1 * status;
+}
+
+static inline int tock_inline_command_return_novalue_to_returncode(syscall_return_t command_return) {
+  if (command_return.type == TOCK_SYSCALL_SUCCESS) {
+    return RETURNCODE_SUCCESS;
+  } else if (command_return.type == TOCK_SYSCALL_FAILURE) {
+    return tock_inline_status_to_returncode(command_return.data[0]);
+  } else {
+    // The remaining SyscallReturn variants must never happen if using this
+    // function. We return `EBADRVAL` to signal an unexpected return variant.
+    return RETURNCODE_EBADRVAL;
+  }
+}
+
+static inline int tock_inline_command_return_u32_to_returncode(syscall_return_t command_return, uint32_t* val) {
+  if (command_return.type == TOCK_SYSCALL_SUCCESS_U32) {
+    *val = command_return.data[0];
+    return RETURNCODE_SUCCESS;
+  } else if (command_return.type == TOCK_SYSCALL_FAILURE) {
+    return tock_inline_status_to_returncode(command_return.data[0]);
+  } else {
+    // The remaining SyscallReturn variants must never happen if using this
+    // function. We return `EBADRVAL` to signal an unexpected return variant.
+    return RETURNCODE_EBADRVAL;
+  }
+}
+
+static inline int tock_inline_command_return_u64_to_returncode(syscall_return_t command_return, uint64_t* val) {
+  uint32_t lsb;
+  uint32_t msb;
+  if (command_return.type == TOCK_SYSCALL_SUCCESS_U64) {
+    lsb  = command_return.data[0];
+    msb  = command_return.data[1];
+    *val = ((uint64_t)msb << 32) | lsb;
+    return RETURNCODE_SUCCESS;
+  } else if (command_return.type == TOCK_SYSCALL_FAILURE) {
+    return tock_inline_status_to_returncode(command_return.data[0]);
+  } else {
+    // The remaining SyscallReturn variants must never happen if using this
+    // function. We return `EBADRVAL` to signal an unexpected return variant.
+    return RETURNCODE_EBADRVAL;
+  }
+}
+
+static inline int tock_inline_command_return_u32_u32_to_returncode(syscall_return_t command_return, uint32_t* val1, uint32_t* val2) {
+  if (command_return.type == TOCK_SYSCALL_SUCCESS_U32_U32) {
+    *val1 = command_return.data[0];
+    *val2 = command_return.data[1];
+    return RETURNCODE_SUCCESS;
+  } else if (command_return.type == TOCK_SYSCALL_FAILURE) {
+    return tock_inline_status_to_returncode(command_return.data[0]);
+  } else {
+    // The remaining SyscallReturn variants must never happen if using this
+    // function. We return `EBADRVAL` to signal an unexpected return variant.
+    return RETURNCODE_EBADRVAL;
+  }
+}
+
+static inline int tock_inline_subscribe_return_to_returncode(subscribe_return_t subscribe_return) {
+  // If the subscribe was successful, easily return SUCCESS.
+  if (subscribe_return.success) {
+    return RETURNCODE_SUCCESS;
+  } else {
+    // Not success, so return the proper returncode.
+    return tock_inline_status_to_returncode(subscribe_return.status);
+  }
+}
+
+static inline int tock_inline_allow_rw_return_to_returncode(allow_rw_return_t allow_return) {
+  // If the allow was successful, easily return SUCCESS.
+  if (allow_return.success) {
+    return RETURNCODE_SUCCESS;
+  } else {
+    // Not success, so return the proper returncode.
+    return tock_inline_status_to_returncode(allow_return.status);
+  }
+}
+
+static inline int tock_inline_allow_ro_return_to_returncode(allow_ro_return_t allow_return) {
+  // If the allow was successful, easily return SUCCESS.
+  if (allow_return.success) {
+    return RETURNCODE_SUCCESS;
+  } else {
+    // Not success, so return the proper returncode.
+    return tock_inline_status_to_returncode(allow_return.status);
+  }
+}
+
+static inline int tock_inline_allow_userspace_r_return_to_returncode(allow_userspace_r_return_t allow_return) {
+  // If the allow was successful, easily return SUCCESS.
+  if (allow_return.success) {
+    return RETURNCODE_SUCCESS;
+  } else {
+    // Not success, so return the proper returncode.
+    return tock_inline_status_to_returncode(allow_return.status);
+  }
+}
+
+#if defined(__thumb__)
+
+static inline subscribe_return_t tock_inline_subscribe(uint32_t driver, uint32_t subscribe,
+                                                       subscribe_upcall cb, void* userdata) {
+  register uint32_t r0 __asm__ ("r0") = driver;
+  register uint32_t r1 __asm__ ("r1") = subscribe;
+  register void*    r2 __asm__ ("r2") = cb;
+  register void*    r3 __asm__ ("r3") = userdata;
+  register int rtype __asm__ ("r0");
+  register int rv1 __asm__ ("r1");
+  register int rv2 __asm__ ("r2");
+  register int rv3 __asm__ ("r3");
+  __asm__ volatile (
+    "svc 1"
+    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
+    : "r" (r0), "r" (r1), "r" (r2), "r" (r3)
+    : "memory");
+
+  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
+    subscribe_return_t rval = {true, (subscribe_upcall*)rv1, (void*)rv2, 0};
+    return rval;
+  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
+    subscribe_return_t rval = {false, (subscribe_upcall*)rv2, (void*)rv3, (statuscode_t)rv1};
+    return rval;
+  } else {
+    exit(1);
+  }
+}
+
+static inline syscall_return_t tock_inline_command(uint32_t driver, uint32_t command,
+                                                   int arg1, int arg2) {
+  register uint32_t r0 __asm__ ("r0") = driver;
+  register uint32_t r1 __asm__ ("r1") = command;
+  register uint32_t r2 __asm__ ("r2") = arg1;
+  register uint32_t r3 __asm__ ("r3") = arg2;
+  register uint32_t rtype __asm__ ("r0");
+  register uint32_t rv1 __asm__ ("r1");
+  register uint32_t rv2 __asm__ ("r2");
+  register uint32_t rv3 __asm__ ("r3");
+  __asm__ volatile (
+    "svc 2"
+    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
+    : "r" (r0), "r" (r1), "r" (r2), "r" (r3)
+    : "memory"
+    );
+  syscall_return_t rval = {rtype, {rv1, rv2, rv3}};
+  return rval;
+}
+
+static inline allow_ro_return_t tock_inline_allow_readonly(uint32_t driver, uint32_t allow, const void* ptr, size_t size) {
+  register uint32_t r0 __asm__ ("r0")       = driver;
+  register uint32_t r1 __asm__ ("r1")       = allow;
+  register const void*    r2 __asm__ ("r2") = ptr;
+  register size_t r3 __asm__ ("r3")         = size;
+  register int rtype __asm__ ("r0");
+  register int rv1 __asm__ ("r1");
+  register int rv2 __asm__ ("r2");
+  register int rv3 __asm__ ("r3");
+  __asm__ volatile (
+    "svc 4"
+    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
+    : "r" (r0), "r" (r1), "r" (r2), "r" (r3)
+    : "memory"
+    );
+  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
+    allow_ro_return_t rv = {true, (const void*)rv1, (size_t)rv2, 0};
+    return rv;
+  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
+    allow_ro_return_t rv = {false, (const void*)rv2, (size_t)rv3, (statuscode_t)rv1};
+    return rv;
+  } else {
+    // Invalid return type
+    exit(1);
+  }
+}
+
+static inline allow_rw_return_t tock_inline_allow_readwrite(uint32_t driver, uint32_t allow, void* ptr, size_t size) {
+  register uint32_t r0 __asm__ ("r0")       = driver;
+  register uint32_t r1 __asm__ ("r1")       = allow;
+  register const void*    r2 __asm__ ("r2") = ptr;
+  register size_t r3 __asm__ ("r3")         = size;
+  register int rtype __asm__ ("r0");
+  register int rv1 __asm__ ("r1");
+  register int rv2 __asm__ ("r2");
+  register int rv3 __asm__ ("r3");
+  __asm__ volatile (
+    "svc 3"
+    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
+    : "r" (r0), "r" (r1), "r" (r2), "r" (r3)
+    : "memory"
+    );
+  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
+    allow_rw_return_t rv = {true, (void*)rv1, (size_t)rv2, 0};
+    return rv;
+  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
+    allow_rw_return_t rv = {false, (void*)rv2, (size_t)rv3, (statuscode_t)rv1};
+    return rv;
+  } else {
+    // Invalid return type
+    exit(1);
+  }
+}
+
+static inline allow_userspace_r_return_t tock_inline_allow_userspace_read(uint32_t driver,
+                                                                          uint32_t allow, void* ptr,
+                                                                          size_t size) {
+  register uint32_t r0 __asm__ ("r0")       = driver;
+  register uint32_t r1 __asm__ ("r1")       = allow;
+  register const void*    r2 __asm__ ("r2") = ptr;
+  register size_t r3 __asm__ ("r3")         = size;
+  register int rtype __asm__ ("r0");
+  register int rv1 __asm__ ("r1");
+  register int rv2 __asm__ ("r2");
+  register int rv3 __asm__ ("r3");
+  __asm__ volatile (
+    "svc 7"
+    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
+    : "r" (r0), "r" (r1), "r" (r2), "r" (r3)
+    : "memory"
+    );
+  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
+    allow_userspace_r_return_t rv = {true, (void*)rv1, (size_t)rv2, 0};
+    return rv;
+  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
+    allow_userspace_r_return_t rv = {false, (void*)rv2, (size_t)rv3, (statuscode_t)rv1};
+    return rv;
+  } else {
+    // Invalid return type
+    exit(-1);
+  }
+}
+
+static inline memop_return_t tock_inline_memop(uint32_t op_type, int arg1) {
+  register uint32_t r0 __asm__ ("r0") = op_type;
+  register int r1 __asm__ ("r1")      = arg1;
+  register uint32_t val __asm__ ("r1");
+  register uint32_t code __asm__ ("r0");
+  __asm__ volatile (
+    "svc 5"
+    : "=r" (code), "=r" (val)
+    : "r" (r0), "r" (r1)
+    : "memory"
+    );
+  if (code == TOCK_SYSCALL_SUCCESS) {
+    memop_return_t rv = {TOCK_STATUSCODE_SUCCESS, 0};
+    return rv;
+  } else if (code == TOCK_SYSCALL_SUCCESS_U32) {
+    memop_return_t rv = {TOCK_STATUSCODE_SUCCESS, val};
+    return rv;
+  } else if (code == TOCK_SYSCALL_FAILURE) {
+    memop_return_t rv = {(statuscode_t) val, 0};
+    return rv;
+  } else {
+    // Invalid return type
+    exit(1);
+  }
+}
+
+
+#elif defined(__riscv)
+
+static inline subscribe_return_t tock_inline_subscribe(uint32_t driver, uint32_t subscribe,
+                                                       subscribe_upcall uc, void* userdata) {
+  register uint32_t a0  __asm__ ("a0") = driver;
+  register uint32_t a1  __asm__ ("a1") = subscribe;
+  register void*    a2  __asm__ ("a2") = uc;
+  register void*    a3  __asm__ ("a3") = userdata;
+  register uint32_t a4  __asm__ ("a4") = 1;
+  register int rtype __asm__ ("a0");
+  register int rv1 __asm__ ("a1");
+  register int rv2 __asm__ ("a2");
+  register int rv3 __asm__ ("a3");
+  __asm__ volatile (
+    "ecall\n"
+    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
+    : "r" (a0), "r" (a1), "r" (a2), "r" (a3), "r" (a4)
+    : "memory");
+  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
+    subscribe_return_t rval = {true, (subscribe_upcall*)rv1, (void*)rv2, 0};
+    return rval;
+  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
+    subscribe_return_t rval = {false, (subscribe_upcall*)rv2, (void*)rv3, (statuscode_t)rv1};
+    return rval;
+  } else {
+    exit(1);
+  }
+}
+
+static inline syscall_return_t tock_inline_command(uint32_t driver, uint32_t command,
+                                                   int arg1, int arg2) {
+  register uint32_t a0  __asm__ ("a0") = driver;
+  register uint32_t a1  __asm__ ("a1") = command;
+  register uint32_t a2  __asm__ ("a2") = arg1;
+  register uint32_t a3  __asm__ ("a3") = arg2;
+  register uint32_t a4  __asm__ ("a4") = 2;
+  register int rtype __asm__ ("a0");
+  register int rv1 __asm__ ("a1");
+  register int rv2 __asm__ ("a2");
+  register int rv3 __asm__ ("a3");
+  __asm__ volatile (
+    "ecall\n"
+    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
+    : "r" (a0), "r" (a1), "r" (a2), "r" (a3), "r" (a4)
+    : "memory");
+  syscall_return_t rval = {rtype, {rv1, rv2, rv3}};
+  return rval;
+}
+
+static inline allow_rw_return_t tock_inline_allow_readwrite(uint32_t driver, uint32_t allow,
+                                                            void* ptr, size_t size) {
+  register uint32_t a0  __asm__ ("a0") = driver;
+  register uint32_t a1  __asm__ ("a1") = allow;
+  register void*    a2  __asm__ ("a2") = ptr;
+  register size_t a3  __asm__ ("a3")   = size;
+  register uint32_t a4  __asm__ ("a4") = 3;
+  register int rtype __asm__ ("a0");
+  register int rv1  __asm__ ("a1");
+  register int rv2  __asm__ ("a2");
+  register int rv3  __asm__ ("a3");
+  __asm__ volatile (
+    "ecall\n"
+    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
+    : "r" (a0), "r" (a1), "r" (a2), "r" (a3), "r" (a4)
+    : "memory");
+  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
+    allow_rw_return_t rv = {true, (void*)rv1, (size_t)rv2, 0};
+    return rv;
+  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
+    allow_rw_return_t rv = {false, (void*)rv2, (size_t)rv3, (statuscode_t)rv1};
+    return rv;
+  } else {
+    // Invalid return type
+    exit(1);
+  }
+}
+
+static inline allow_userspace_r_return_t tock_inline_allow_userspace_read(uint32_t driver,
+                                                                          uint32_t allow, void* ptr,
+                                                                          size_t size) {
+  register uint32_t a0  __asm__ ("a0") = driver;
+  register uint32_t a1  __asm__ ("a1") = allow;
+  register void*    a2  __asm__ ("a2") = ptr;
+  register size_t a3  __asm__ ("a3")   = size;
+  register uint32_t a4  __asm__ ("a4") = 7;
+  register int rtype __asm__ ("a0");
+  register int rv1  __asm__ ("a1");
+  register int rv2  __asm__ ("a2");
+  register int rv3  __asm__ ("a3");
+  __asm__ volatile (
+    "ecall\n"
+    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
+    : "r" (a0), "r" (a1), "r" (a2), "r" (a3), "r" (a4)
+    : "memory");
+  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
+    allow_userspace_r_return_t rv = {true, (void*)rv1, (size_t)rv2, 0};
+    return rv;
+  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
+    allow_userspace_r_return_t rv = {false, (void*)rv2, (size_t)rv3, (statuscode_t)rv1};
+    return rv;
+  } else {
+    // Invalid return type
+    exit(-1);
+  }
+}
+
+static inline allow_ro_return_t tock_inline_allow_readonly(uint32_t driver, uint32_t allow,
+                                                           const void* ptr, size_t size) {
+  register uint32_t a0  __asm__ ("a0")    = driver;
+  register uint32_t a1  __asm__ ("a1")    = allow;
+  register const void* a2  __asm__ ("a2") = ptr;
+  register size_t a3  __asm__ ("a3")      = size;
+  register uint32_t a4  __asm__ ("a4")    = 4;
+  register int rtype __asm__ ("a0");
+  register int rv1 __asm__ ("a1");
+  register int rv2 __asm__ ("a2");
+  register int rv3 __asm__ ("a3");
+  __asm__ volatile (
+    "ecall\n"
+    : "=r" (rtype), "=r" (rv1), "=r" (rv2), "=r" (rv3)
+    : "r" (a0), "r" (a1), "r" (a2), "r" (a3), "r" (a4)
+    : "memory");
+  if (rtype == TOCK_SYSCALL_SUCCESS_U32_U32) {
+    allow_ro_return_t rv = {true, (const void*)rv1, (size_t)rv2, 0};
+    return rv;
+  } else if (rtype == TOCK_SYSCALL_FAILURE_U32_U32) {
+    allow_ro_return_t rv = {false, (const void*)rv2, (size_t)rv3, (statuscode_t)rv1};
+    return rv;
+  } else {
+    // Invalid return type
+    exit(1);
+  }
+}
+
+static inline memop_return_t tock_inline_memop(uint32_t op_type, int arg1) {
+  register uint32_t a0    __asm__ ("a0") = op_type;
+  register int a1         __asm__ ("a1") = arg1;
+  register uint32_t a4    __asm__ ("a4") = 5;
+  register uint32_t val   __asm__ ("a1");
+  register uint32_t code  __asm__ ("a0");
+  __asm__ volatile (
+    "ecall\n"
+    : "=r" (code), "=r" (val)
+    : "r" (a0), "r" (a1), "r" (a4)
+    : "memory"
+    );
+  if (code == TOCK_SYSCALL_SUCCESS) {
+    memop_return_t rv = {TOCK_STATUSCODE_SUCCESS, 0};
+    return rv;
+  } else if (code == TOCK_SYSCALL_SUCCESS_U32) {
+    memop_return_t rv = {TOCK_STATUSCODE_SUCCESS, val};
+    return rv;
+  } else if (code == TOCK_SYSCALL_FAILURE) {
+    memop_return_t rv = {(statuscode_t) val, 0};
+    return rv;
+  } else {
+    // Invalid return type
+    exit(1);
+  }
+}
+
+#elif defined(TOCK_HOST)
+
+// Host builds hand the system calls to the emulator in `host/`.
+
+#include "../host/emulator.h"
+
+static inline subscribe_return_t tock_inline_subscribe(uint32_t driver, uint32_t subscribe,
+                                                       subscribe_upcall cb, void* userdata) {
+  return tock_host_subscribe(driver, subscribe, cb, userdata);
+}
+
+static inline syscall_return_t tock_inline_command(uint32_t driver, uint32_t command,
+                                                   int arg1, int arg2) {
+  return tock_host_command(driver, command, arg1, arg2);
+}
+
+static inline allow_ro_return_t tock_inline_allow_readonly(uint32_t driver, uint32_t allow, const void* ptr, size_t size) {
+  return tock_host_allow_readonly(driver, allow, ptr, size);
+}
+
+static inline allow_rw_return_t tock_inline_allow_readwrite(uint32_t driver, uint32_t allow, void* ptr, size_t size) {
+  return tock_host_allow_readwrite(driver, allow, ptr, size);
+}
+
+static inline allow_userspace_r_return_t tock_inline_allow_userspace_read(uint32_t driver,
+                                                                          uint32_t allow, void* ptr,
+                                                                          size_t size) {
+  return tock_host_allow_userspace_read(driver, allow, ptr, size);
+}
+
+static inline memop_return_t tock_inline_memop(uint32_t op_type, int arg1) {
+  return tock_host_memop(op_type, arg1);
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,349 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "tock_record.h"
+
+#ifdef TOCK_HOST
+#include "../host/emulator.h"
+#endif
+
+// A read-write buffer shared with the kernel, and the hash of its contents
+// when it was last recorded or allowed, to tell what the kernel changed.
+typedef struct {
+  bool used;
+  uint32_t driver;
+  uint32_t allow;
+  uint8_t* ptr;
+  size_t size;
+  uint32_t hash;
+} record_allow_t;
+
+typedef struct {
+  bool used;
+  uint32_t driver;
+  uint32_t subscribe;
+  subscribe_upcall* cb;
+  void* userdata;
+  // What the slot held before the subscribe in progress.
+  subscribe_upcall* prev_cb;
+  void* prev_userdata;
+} record_upcall_t;
+
+// A process has one stream of system calls, so the recording is global.
+static struct {
+  uint8_t* buffer;
+  size_t len;
+  size_t used;
+  bool active;
+  bool truncated;
+  // Set once the current trap has run an upcall or returned a wait-for.
+  bool delivered;
+  record_allow_t allows[TOCK_RECORD_MAX_ALLOWS];
+  record_upcall_t upcalls[TOCK_RECORD_MAX_UPCALLS];
+} rec;
+
+// FNV-1a.
+static uint32_t hash_buffer(const uint8_t* data, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static uint8_t* put32(uint8_t* p, uint32_t value) {
+  p[0] = (uint8_t) value;
+  p[1] = (uint8_t) (value >> 8);
+  p[2] = (uint8_t) (value >> 16);
+  p[3] = (uint8_t) (value >> 24);
+  return p + 4;
+}
+
+static void truncate_recording(void) {
+  rec.active    = false;
+  rec.truncated = true;
+}
+
+// Space for an event of `len` bytes, or NULL after stopping the recording if
+// it does not fit.
+static uint8_t* reserve(size_t len) {
+  if (!rec.active) return NULL;
+  if (rec.len - rec.used < len) {
+    truncate_recording();
+    return NULL;
+  }
+  uint8_t* p = rec.buffer + rec.used;
+  rec.used += len;
+  return p;
+}
+
+returncode_t tock_record_start(__attribute__ ((unused)) uint8_t* buffer, __attribute__ ((unused)) size_t len) {
+#ifdef TOCK_HOST
+  tock_host_replay_start();
+#endif
+#ifndef TOCK_SYSCALL_RECORD
+  return RETURNCODE_ENOSUPPORT;
+#else
+  if (len < 8) return RETURNCODE_ESIZE;
+
+  rec.buffer    = buffer;
+  rec.len       = len;
+  rec.truncated = false;
+  memcpy(buffer, TOCK_RECORD_MAGIC, 4);
+  put32(buffer + 4, TOCK_RECORD_VERSION);
+  rec.used   = 8;
+  rec.active = true;
+  return RETURNCODE_SUCCESS;
+#endif
+}
+
+void tock_record_stop(void) {
+  rec.active = false;
+}
+
+void tock_record_resume(void) {
+  if (rec.buffer != NULL && !rec.truncated) rec.active = true;
+}
+
+bool tock_record_active(void) {
+  return rec.active;
+}
+
+bool tock_record_truncated(void) {
+  return rec.truncated;
+}
+
+const uint8_t* tock_record_data(size_t* len) {
+  *len = rec.used;
+  return rec.buffer;
+}
+
+void tock_record_dump(void) {
+  // The console writes that print it must not be recorded.
+  rec.active = false;
+
+  static const char hex[] = "0123456789abcdef";
+  for (size_t off = 0; off < rec.used; off += 32) {
+    char line[65];
+    size_t n = rec.used - off < 32 ? rec.used - off : 32;
+    for (size_t i = 0; i < n; i++) {
+      line[2 * i]     = hex[rec.buffer[off + i] >> 4];
+      line[2 * i + 1] = hex[rec.buffer[off + i] & 0xF];
+    }
+    line[2 * n] = '\0';
+    printf("tock-record: %s\n", line);
+  }
+  printf("tock-record: end %lu\n", (uint32_t) rec.used);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// System calls
+////////////////////////////////////////////////////////////////////////////////
+
+void tock_record_subscribe(uint32_t driver, uint32_t subscribe, const subscribe_return_t* ret) {
+  uint8_t* p = reserve(1 + 3 * 4);
+  if (p == NULL) return;
+  *p++ = TOCK_RECORD_SUBSCRIBE;
+  p    = put32(p, driver);
+  p    = put32(p, subscribe);
+  put32(p, ret->success ? TOCK_STATUSCODE_SUCCESS : ret->status);
+}
+
+void tock_record_command(uint32_t driver, uint32_t command, int arg1, int arg2, const syscall_return_t* ret) {
+  uint8_t* p = reserve(1 + 8 * 4);
+  if (p == NULL) return;
+  *p++ = TOCK_RECORD_COMMAND;
+  p    = put32(p, driver);
+  p    = put32(p, command);
+  p    = put32(p, (uint32_t) arg1);
+  p    = put32(p, (uint32_t) arg2);
+  p    = put32(p, ret->type);
+  for (int i = 0; i < 3; i++) p = put32(p, ret->data[i]);
+}
+
+static record_allow_t* find_allow(uint32_t driver, uint32_t allow) {
+  for (int i = 0; i < TOCK_RECORD_MAX_ALLOWS; i++) {
+    record_allow_t* a = &rec.allows[i];
+    if (a->used && a->driver == driver && a->allow == allow) return a;
+  }
+  return NULL;
+}
+
+static void record_allow(tock_record_kind_t kind, uint32_t driver, uint32_t allow, size_t size, bool success,
+                         statuscode_t status) {
+  uint8_t* p = reserve(1 + 4 * 4);
+  if (p == NULL) return;
+  *p++ = kind;
+  p    = put32(p, driver);
+  p    = put32(p, allow);
+  p    = put32(p, (uint32_t) size);
+  put32(p, success ? TOCK_STATUSCODE_SUCCESS : status);
+}
+
+void tock_record_allow_readwrite(uint32_t driver, uint32_t allow, void* ptr, size_t size,
+                                 const allow_rw_return_t* ret) {
+  record_allow_t* a = find_allow(driver, allow);
+
+  // The buffer handed back, if the kernel changed it.
+  size_t returned = 0;
+  uint32_t hash   = 0;
+  if (ret->success && a != NULL) {
+    hash = hash_buffer(a->ptr, a->size);
+    if (hash != a->hash) returned = a->size;
+  }
+
+  uint8_t* p = reserve(1 + 5 * 4 + returned);
+  if (p != NULL) {
+    *p++ = TOCK_RECORD_ALLOW_RW;
+    p    = put32(p, driver);
+    p    = put32(p, allow);
+    p    = put32(p, (uint32_t) size);
+    p    = put32(p, ret->success ? TOCK_STATUSCODE_SUCCESS : ret->status);
+    p    = put32(p, (uint32_t) returned);
+    if (returned != 0) memcpy(p, a->ptr, returned);
+  }
+  if (!ret->success) return;
+
+  if (ptr == NULL || size == 0) {
+    if (a != NULL) a->used = false;
+    return;
+  }
+  if (a == NULL) {
+    for (int i = 0; i < TOCK_RECORD_MAX_ALLOWS && a == NULL; i++) {
+      if (!rec.allows[i].used) a = &rec.allows[i];
+    }
+    if (a == NULL) {
+      // Later changes to this buffer would be missed.
+      if (rec.active) truncate_recording();
+      return;
+    }
+  }
+  *a = (record_allow_t) { true, driver, allow, (uint8_t*) ptr, size, hash_buffer(ptr, size) };
+}
+
+void tock_record_allow_readonly(uint32_t driver, uint32_t allow, size_t size, const allow_ro_return_t* ret) {
+  record_allow(TOCK_RECORD_ALLOW_RO, driver, allow, size, ret->success, ret->status);
+}
+
+void tock_record_allow_userspace_read(uint32_t driver, uint32_t allow, size_t size,
+                                      const allow_userspace_r_return_t* ret) {
+  record_allow(TOCK_RECORD_ALLOW_UR, driver, allow, size, ret->success, ret->status);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Yields and upcalls
+////////////////////////////////////////////////////////////////////////////////
+
+// Record an upcall or wait-for return of `driver`, with the driver's
+// read-write buffers the kernel changed since they were last recorded.
+static void record_delivery(tock_record_kind_t kind, uint32_t driver, uint32_t subscribe, int arg0, int arg1,
+                            int arg2) {
+  rec.delivered = true;
+  if (!rec.active) return;
+
+  uint32_t hashes[TOCK_RECORD_MAX_ALLOWS];
+  size_t len = 1 + 5 * 4 + 1;
+  for (int i = 0; i < TOCK_RECORD_MAX_ALLOWS; i++) {
+    record_allow_t* a = &rec.allows[i];
+    if (!a->used || a->driver != driver) continue;
+    hashes[i] = hash_buffer(a->ptr, a->size);
+    if (hashes[i] != a->hash) len += 2 * 4 + a->size;
+  }
+
+  uint8_t* p = reserve(len);
+  if (p == NULL) return;
+  *p++ = kind;
+  p    = put32(p, driver);
+  p    = put32(p, subscribe);
+  p    = put32(p, (uint32_t) arg0);
+  p    = put32(p, (uint32_t) arg1);
+  p    = put32(p, (uint32_t) arg2);
+  uint8_t* count = p++;
+  *count = 0;
+  for (int i = 0; i < TOCK_RECORD_MAX_ALLOWS; i++) {
+    record_allow_t* a = &rec.allows[i];
+    if (!a->used || a->driver != driver || hashes[i] == a->hash) continue;
+    p = put32(p, a->allow);
+    p = put32(p, (uint32_t) a->size);
+    memcpy(p, a->ptr, a->size);
+    p      += a->size;
+    a->hash = hashes[i];
+    (*count)++;
+  }
+}
+
+void tock_record_wait_for(uint32_t driver, uint32_t subscribe, const yield_waitfor_return_t* ret) {
+  record_delivery(TOCK_RECORD_WAIT_FOR, driver, subscribe, ret->data0, ret->data1, ret->data2);
+}
+
+void tock_record_yield_enter(void) {
+  rec.delivered = false;
+}
+
+void tock_record_yield_exit(void) {
+  if (rec.delivered) return;
+  uint8_t* p = reserve(1);
+  if (p != NULL) *p = TOCK_RECORD_YIELD_NONE;
+}
+
+static void upcall_trampoline(int arg0, int arg1, int arg2, void* userdata) {
+  record_upcall_t* slot = (record_upcall_t*) userdata;
+  subscribe_upcall* cb  = slot->cb;
+  if (cb == NULL) {
+    return;
+  }
+
+  record_delivery(TOCK_RECORD_UPCALL, slot->driver, slot->subscribe, arg0, arg1, arg2);
+  cb(arg0, arg1, arg2, slot->userdata);
+  // A yield inside the upcall must not make the trap that ran it look empty.
+  rec.delivered = true;
+}
+
+void* tock_record_upcall_wrap(uint32_t driver, uint32_t subscribe, subscribe_upcall** cb, void** userdata) {
+  record_upcall_t* slot = NULL;
+  for (int i = 0; i < TOCK_RECORD_MAX_UPCALLS; i++) {
+    record_upcall_t* s = &rec.upcalls[i];
+    if (s->used && s->driver == driver && s->subscribe == subscribe) {
+      slot = s;
+      break;
+    }
+    if (!s->used && slot == NULL) {
+      slot = s;
+    }
+  }
+  if (slot == NULL) {
+    // Upcalls to this subscription would be missed.
+    if (rec.active) truncate_recording();
+    return NULL;
+  }
+
+  if (!slot->used) {
+    *slot = (record_upcall_t) { .used = true, .driver = driver, .subscribe = subscribe };
+  }
+  slot->prev_cb       = slot->cb;
+  slot->prev_userdata = slot->userdata;
+  slot->cb            = *cb;
+  slot->userdata      = *userdata;
+
+  // The null upcall stays null, so the kernel drops the upcalls.
+  if (*cb != NULL) {
+    *cb       = upcall_trampoline;
+    *userdata = slot;
+  }
+  return slot;
+}
+
+void tock_record_upcall_done(void* token, subscribe_return_t* ret) {
+  record_upcall_t* slot = (record_upcall_t*) token;
+  if (slot != NULL && !ret->success) {
+    // The kernel kept the previous upcall.
+    slot->cb       = slot->prev_cb;
+    slot->userdata = slot->prev_userdata;
+  }
+  if (ret->callback == upcall_trampoline) {
+    record_upcall_t* prev = (record_upcall_t*) ret->userdata;
+    ret->callback = prev == slot ? slot->prev_cb : prev->cb;
+    ret->userdata = prev == slot ? slot->prev_userdata : prev->userdata;
+  }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+// Syscall recording, for replay on the host.
+//
+// When libtock is built with `TOCK_SYSCALL_RECORD` (through `LIBTOCK_CONFIG`,
+// see `config.h`), every system call the process makes after
+// `tock_record_start()` is appended to a buffer the app provides, together
+// with what the kernel answered and every upcall it delivered. The host
+// emulator can then run the same app against the recording instead of its
+// simulated drivers, so a workload seen on a board, with its exact upcall
+// order and data, can be reproduced and profiled off the board. See
+// `host/README.md` for replaying.
+//
+// What is recorded:
+//
+// - every `command()` with its arguments and result, which includes every
+//   reading of the alarm counter, so the app sees the same time on replay;
+// - every `subscribe()` and `allow_*()` with its result;
+// - data the kernel wrote into read-write buffers: when a buffer is handed
+//   back by an allow, and when an upcall of the buffer's driver runs. Only
+//   buffers whose contents changed since they were last recorded are stored;
+// - every trap into the kernel through the yields: the upcall it ran and its
+//   arguments, the values `yield_wait_for()` returned, or that
+//   `yield_no_wait()` found nothing.
+//
+// Not recorded: read-only allow contents, which the app writes itself, the
+// read-only state region, which is read without system calls, and the
+// console writes of `printf()`, which on the host goes to stdout without
+// system calls. Apps that time with `tock_trace_start()`, skip yields with
+// `tock_yield_use_read_only_state()`, or buffer stdout with
+// `libtock/services/stdout_buffer.h` do not replay the same way.
+// System calls made through `tock_inline.h` bypass recording as they bypass
+// tracing.
+//
+// The recording stops when the buffer is full, or when more upcalls are
+// subscribed than `TOCK_RECORD_MAX_UPCALLS` or more read-write buffers are
+// allowed than `TOCK_RECORD_MAX_ALLOWS`, and replay ends where it stopped.
+// `tock_record_dump()` prints the recording to the console, and
+// `tools/record_extract.py` turns the console output back into the file the
+// host replays. To keep it in flash instead, write `tock_record_data()` with
+// the nonvolatile storage driver once recording has stopped.
+//
+// Recording format, all numbers 32-bit little-endian:
+//
+//     "TKRC", version
+//     then events, each a kind byte and that kind's fields:
+//
+//     SUBSCRIBE    driver, subscribe, status
+//     COMMAND      driver, command, arg1, arg2, type, data[3]
+//     ALLOW_RW     driver, allow, size, status, returned buffer
+//     ALLOW_RO     driver, allow, size, status
+//     ALLOW_UR     driver, allow, size, status
+//     UPCALL       driver, subscribe, arg0, arg1, arg2, buffers
+//     WAIT_FOR     driver, subscribe, data0, data1, data2, buffers
+//     YIELD_NONE
+//
+// A buffer is its length followed by its bytes, with length 0 when unchanged.
+// `buffers` is a count byte followed by, per buffer, the allow number and a
+// buffer.
+
+#include "tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TOCK_RECORD_MAGIC   "TKRC"
+#define TOCK_RECORD_VERSION 1
+
+// Subscriptions whose upcalls can be recorded.
+#ifndef TOCK_RECORD_MAX_UPCALLS
+#define TOCK_RECORD_MAX_UPCALLS 16
+#endif
+
+// Read-write buffers that can be allowed at once while recording.
+#ifndef TOCK_RECORD_MAX_ALLOWS
+#define TOCK_RECORD_MAX_ALLOWS 16
+#endif
+
+// Event kinds. The syscall ones match the syscall class numbers.
+typedef enum {
+  TOCK_RECORD_SUBSCRIBE  = 1,
+  TOCK_RECORD_COMMAND    = 2,
+  TOCK_RECORD_ALLOW_RW   = 3,
+  TOCK_RECORD_ALLOW_RO   = 4,
+  TOCK_RECORD_ALLOW_UR   = 7,
+  TOCK_RECORD_UPCALL     = 0x10,
+  TOCK_RECORD_WAIT_FOR   = 0x11,
+  TOCK_RECORD_YIELD_NONE = 0x12,
+} tock_record_kind_t;
+
+// Start recording into `buffer`, replacing any earlier recording.
+//
+// Call it before the app subscribes or allows anything: the recording only
+// replays from a process that starts out the same way. On the host, this is
+// where a replay given with `TOCK_HOST_REPLAY` begins.
+//
+// Returns RETURNCODE_ENOSUPPORT if libtock was built without
+// `TOCK_SYSCALL_RECORD`, and RETURNCODE_ESIZE if `len` cannot hold the
+// header.
+returncode_t tock_record_start(uint8_t* buffer, size_t len);
+
+// Stop recording. The buffer keeps what was recorded.
+void tock_record_stop(void);
+
+// Continue a recording stopped with `tock_record_stop()`, unless it
+// stopped itself because something filled up.
+void tock_record_resume(void);
+
+// Whether recording is running.
+bool tock_record_active(void);
+
+// Whether recording stopped by itself, because the buffer or one of the
+// tables filled up.
+bool tock_record_truncated(void);
+
+// The recording so far, with its length in `*len`.
+const uint8_t* tock_record_data(size_t* len);
+
+// Stop recording and print it to the console as hex lines for
+// `tools/record_extract.py`:
+//
+//     tock-record: <up to 32 bytes as hex>
+//     tock-record: end <length>
+void tock_record_dump(void);
+
+// Hooks called by the recording build of libtock.
+//
+// `tock_record_upcall_wrap()` and `tock_record_upcall_done()` put a
+// recording trampoline in place of a subscribed upcall, as the yield
+// tracing hooks in `tock_trace.h` do. `tock_record_yield_enter()` and
+// `tock_record_yield_exit()` bracket a trap into the kernel.
+void tock_record_subscribe(uint32_t driver, uint32_t subscribe, const subscribe_return_t* ret);
+void tock_record_command(uint32_t driver, uint32_t command, int arg1, int arg2, const syscall_return_t* ret);
+void tock_record_allow_readwrite(uint32_t driver, uint32_t allow, void* ptr, size_t size,
+                                 const allow_rw_return_t* ret);
+void tock_record_allow_readonly(uint32_t driver, uint32_t allow, size_t size, const allow_ro_return_t* ret);
+void tock_record_allow_userspace_read(uint32_t driver, uint32_t allow, size_t size,
+                                      const allow_userspace_r_return_t* ret);
+void tock_record_wait_for(uint32_t driver, uint32_t subscribe, const yield_waitfor_return_t* ret);
+void tock_record_yield_enter(void);
+void tock_record_yield_exit(void);
+void* tock_record_upcall_wrap(uint32_t driver, uint32_t subscribe, subscribe_upcall** cb, void** userdata);
+void tock_record_upcall_done(void* token, subscribe_return_t* ret);
+
+#ifdef __cplusplus
+}
+#endif
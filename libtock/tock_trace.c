@@ -0,0 +1,304 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "kernel/read_only_state.h"
+#include "tock_trace.h"
+
+static void* trace_ros = NULL;
+
+static tock_trace_entry_t trace_ring[TOCK_TRACE_BUFFER_SIZE];
+static int trace_next  = 0;
+static int trace_count = 0;
+
+static tock_trace_driver_stats_t trace_drivers[TOCK_TRACE_MAX_DRIVERS];
+static int trace_num_drivers = 0;
+// Calls to drivers that did not fit in `trace_drivers`.
+static uint32_t trace_untracked = 0;
+
+// Don't record the console writes made while dumping the trace.
+static bool trace_paused = false;
+
+static int histogram_bucket(uint32_t ticks) {
+  int bucket = 0;
+  while (ticks != 0 && bucket < TOCK_TRACE_HISTOGRAM_BUCKETS - 1) {
+    ticks >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+static tock_trace_driver_stats_t* find_driver(uint32_t driver, bool create) {
+  for (int i = 0; i < trace_num_drivers; i++) {
+    if (trace_drivers[i].driver == driver) {
+      return &trace_drivers[i];
+    }
+  }
+
+  if (!create || trace_num_drivers == TOCK_TRACE_MAX_DRIVERS) {
+    return NULL;
+  }
+
+  tock_trace_driver_stats_t* stats = &trace_drivers[trace_num_drivers++];
+  memset(stats, 0, sizeof(tock_trace_driver_stats_t));
+  stats->driver = driver;
+  return stats;
+}
+
+void tock_trace_start(void* read_only_state) {
+  trace_ros = read_only_state;
+}
+
+uint32_t tock_trace_now(void) {
+  if (trace_ros == NULL) {
+    return 0;
+  }
+  return (uint32_t) libtock_read_only_state_get_ticks(trace_ros);
+}
+
+void tock_trace_record(tock_trace_class_t syscall_class, uint32_t driver, uint32_t number,
+                       uint32_t start, uint32_t end, syscall_rtype_t rtype) {
+  if (trace_paused) {
+    return;
+  }
+
+  tock_trace_entry_t* entry = &trace_ring[trace_next];
+  entry->driver        = driver;
+  entry->number        = number;
+  entry->start         = start;
+  entry->end           = end;
+  entry->syscall_class = syscall_class;
+  entry->rtype         = rtype;
+
+  trace_next = (trace_next + 1) % TOCK_TRACE_BUFFER_SIZE;
+  if (trace_count < TOCK_TRACE_BUFFER_SIZE) {
+    trace_count++;
+  }
+
+  tock_trace_driver_stats_t* stats = find_driver(driver, true);
+  if (stats == NULL) {
+    trace_untracked++;
+    return;
+  }
+
+  uint32_t ticks = end - start;
+  stats->count++;
+  stats->total_ticks += ticks;
+  if (ticks > stats->max_ticks) {
+    stats->max_ticks = ticks;
+  }
+  stats->histogram[histogram_bucket(ticks)]++;
+}
+
+int tock_trace_count(void) {
+  return trace_count;
+}
+
+returncode_t tock_trace_get(int index, tock_trace_entry_t* entry) {
+  if (index < 0 || index >= trace_count) {
+    return RETURNCODE_EINVAL;
+  }
+
+  int oldest = (trace_next - trace_count + TOCK_TRACE_BUFFER_SIZE) % TOCK_TRACE_BUFFER_SIZE;
+  *entry = trace_ring[(oldest + index) % TOCK_TRACE_BUFFER_SIZE];
+  return RETURNCODE_SUCCESS;
+}
+
+returncode_t tock_trace_driver_stats(uint32_t driver, tock_trace_driver_stats_t* stats) {
+  tock_trace_driver_stats_t* found = find_driver(driver, false);
+  if (found == NULL) {
+    return RETURNCODE_ENODEVICE;
+  }
+  *stats = *found;
+  return RETURNCODE_SUCCESS;
+}
+
+void tock_trace_dump(void) {
+  // Copy the statistics first so the dump reports a consistent snapshot.
+  tock_trace_driver_stats_t drivers[TOCK_TRACE_MAX_DRIVERS];
+  int num_drivers   = trace_num_drivers;
+  uint32_t untracked = trace_untracked;
+  memcpy(drivers, trace_drivers, sizeof(drivers));
+
+  trace_paused = true;
+
+  printf("Syscall trace: %d drivers\n", num_drivers);
+  for (int i = 0; i < num_drivers; i++) {
+    tock_trace_driver_stats_t* stats = &drivers[i];
+    uint32_t mean = stats->count == 0 ? 0 : (uint32_t) (stats->total_ticks / stats->count);
+    printf("  driver 0x%05lx: %lu calls, mean %lu ticks, max %lu ticks\n",
+           stats->driver, stats->count, mean, stats->max_ticks);
+    for (int b = 0; b < TOCK_TRACE_HISTOGRAM_BUCKETS; b++) {
+      if (stats->histogram[b] == 0) continue;
+      uint32_t low = b == 0 ? 0 : (1u << (b - 1));
+      if (b == TOCK_TRACE_HISTOGRAM_BUCKETS - 1) {
+        printf("    >= %5lu: %lu\n", low, stats->histogram[b]);
+      } else {
+        printf("    %8lu: %lu\n", low, stats->histogram[b]);
+      }
+    }
+  }
+  if (untracked != 0) {
+    printf("  %lu calls to other drivers not tracked\n", untracked);
+  }
+
+  trace_paused = false;
+}
+
+// Yield statistics, and the app's upcall and userdata for each subscription
+// whose upcall goes through the trampoline.
+static tock_trace_yield_stats_t yield_stats;
+// Tick the last trap returned at, valid once one has.
+static uint32_t yield_last_exit = 0;
+static bool yield_returned      = false;
+
+typedef struct {
+  bool used;
+  uint32_t driver;
+  uint32_t subscribe;
+  subscribe_upcall* cb;
+  void* userdata;
+  // What the slot held before the subscribe in progress.
+  subscribe_upcall* prev_cb;
+  void* prev_userdata;
+} upcall_slot_t;
+
+static upcall_slot_t upcall_slots[TOCK_TRACE_MAX_UPCALLS];
+
+void tock_trace_reset(void) {
+  trace_next        = 0;
+  trace_count       = 0;
+  trace_num_drivers = 0;
+  trace_untracked   = 0;
+
+  memset(&yield_stats, 0, sizeof(yield_stats));
+  yield_returned = false;
+}
+
+void tock_trace_yield_enter(tock_trace_yield_mark_t* mark) {
+  mark->start        = tock_trace_now();
+  mark->upcall_ticks = yield_stats.upcall_ticks;
+
+  if (yield_returned) {
+    uint32_t busy = mark->start - yield_last_exit;
+    if (busy > yield_stats.max_busy_ticks) yield_stats.max_busy_ticks = busy;
+  }
+}
+
+void tock_trace_yield_exit(const tock_trace_yield_mark_t* mark) {
+  uint32_t now = tock_trace_now();
+  // Upcalls run before the trap returns; count them as upcall time only.
+  uint64_t in_upcalls = yield_stats.upcall_ticks - mark->upcall_ticks;
+  uint32_t total      = now - mark->start;
+
+  yield_stats.yields++;
+  if (total > in_upcalls) yield_stats.yield_ticks += total - in_upcalls;
+  yield_last_exit = now;
+  yield_returned  = true;
+}
+
+void tock_trace_task(subscribe_upcall* cb, uint32_t enqueued, uint32_t start, uint32_t end) {
+  uint32_t ticks = end - start;
+  uint32_t wait  = start - enqueued;
+
+  yield_stats.tasks++;
+  yield_stats.task_ticks += ticks;
+  if (ticks > yield_stats.max_task_ticks) {
+    yield_stats.max_task_ticks = ticks;
+    yield_stats.max_task_cb    = cb;
+  }
+  yield_stats.task_wait_ticks += wait;
+  if (wait > yield_stats.max_task_wait_ticks) yield_stats.max_task_wait_ticks = wait;
+}
+
+static void upcall_trampoline(int arg0, int arg1, int arg2, void* userdata) {
+  upcall_slot_t* slot  = (upcall_slot_t*) userdata;
+  subscribe_upcall* cb = slot->cb;
+  if (cb == NULL) {
+    return;
+  }
+
+  uint32_t start = tock_trace_now();
+  cb(arg0, arg1, arg2, slot->userdata);
+  uint32_t ticks = tock_trace_now() - start;
+
+  yield_stats.upcalls++;
+  yield_stats.upcall_ticks += ticks;
+  if (ticks > yield_stats.max_upcall_ticks) {
+    yield_stats.max_upcall_ticks  = ticks;
+    yield_stats.max_upcall_driver = slot->driver;
+    yield_stats.max_upcall_cb     = cb;
+  }
+}
+
+void* tock_trace_upcall_wrap(uint32_t driver, uint32_t subscribe, subscribe_upcall** cb, void** userdata) {
+  upcall_slot_t* slot = NULL;
+  for (int i = 0; i < TOCK_TRACE_MAX_UPCALLS; i++) {
+    upcall_slot_t* s = &upcall_slots[i];
+    if (s->used && s->driver == driver && s->subscribe == subscribe) {
+      slot = s;
+      break;
+    }
+    if (!s->used && slot == NULL) {
+      slot = s;
+    }
+  }
+  if (slot == NULL) {
+    yield_stats.untimed_upcalls++;
+    return NULL;
+  }
+
+  if (!slot->used) {
+    *slot = (upcall_slot_t) { .used = true, .driver = driver, .subscribe = subscribe };
+  }
+  slot->prev_cb       = slot->cb;
+  slot->prev_userdata = slot->userdata;
+  slot->cb            = *cb;
+  slot->userdata      = *userdata;
+
+  // The null upcall stays null, so the kernel drops the upcalls.
+  if (*cb != NULL) {
+    *cb       = upcall_trampoline;
+    *userdata = slot;
+  }
+  return slot;
+}
+
+void tock_trace_upcall_done(void* token, subscribe_return_t* ret) {
+  upcall_slot_t* slot = (upcall_slot_t*) token;
+  if (slot != NULL && !ret->success) {
+    // The kernel kept the previous upcall.
+    slot->cb       = slot->prev_cb;
+    slot->userdata = slot->prev_userdata;
+  }
+  if (ret->callback == upcall_trampoline) {
+    upcall_slot_t* prev = (upcall_slot_t*) ret->userdata;
+    ret->callback = prev == slot ? slot->prev_cb : prev->cb;
+    ret->userdata = prev == slot ? slot->prev_userdata : prev->userdata;
+  }
+}
+
+void tock_trace_yield_stats(tock_trace_yield_stats_t* stats) {
+  *stats = yield_stats;
+}
+
+void tock_trace_yield_dump(void) {
+  // Printing yields, so report a snapshot from before it.
+  tock_trace_yield_stats_t s = yield_stats;
+
+  uint32_t upcall_mean = s.upcalls == 0 ? 0 : (uint32_t) (s.upcall_ticks / s.upcalls);
+  uint32_t task_mean   = s.tasks == 0 ? 0 : (uint32_t) (s.task_ticks / s.tasks);
+  uint32_t wait_mean   = s.tasks == 0 ? 0 : (uint32_t) (s.task_wait_ticks / s.tasks);
+
+  printf("Yield trace:\n");
+  printf("  %lu yields, %lu ticks in the kernel, at most %lu ticks between yields\n",
+         s.yields, (uint32_t) s.yield_ticks, s.max_busy_ticks);
+  printf("  %lu upcalls, %lu ticks, mean %lu, max %lu (driver 0x%05lx, upcall %p)\n",
+         s.upcalls, (uint32_t) s.upcall_ticks, upcall_mean, s.max_upcall_ticks, s.max_upcall_driver,
+         (void*) s.max_upcall_cb);
+  if (s.untimed_upcalls != 0) {
+    printf("  %lu subscriptions not timed\n", s.untimed_upcalls);
+  }
+  printf("  %lu tasks, %lu ticks, mean %lu, max %lu (task %p)\n",
+         s.tasks, (uint32_t) s.task_ticks, task_mean, s.max_task_ticks, (void*) s.max_task_cb);
+  printf("  tasks waited mean %lu, max %lu ticks\n", wait_mean, s.max_task_wait_ticks);
+}
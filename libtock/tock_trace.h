@@ -0,0 +1,175 @@
+#pragma once
+
+// Syscall tracing.
+//
+// When libtock is built with `TOCK_SYSCALL_TRACE` defined (e.g. `make
+// CFLAGS=-DTOCK_SYSCALL_TRACE` after cleaning libtock), every `command()`,
+// `subscribe()`, and `allow_*()` call is recorded into a fixed size ring
+// buffer, and per-driver call counts and latency histograms are kept.
+//
+// Timestamps come from the read-only state region shared with the kernel, so
+// recording a trace entry does not make any additional system calls. Call
+// `tock_trace_start()` with a region set up by
+// `libtock_read_only_state_allocate_region()` to enable timestamps; without
+// one, calls are still counted but all latencies are zero.
+//
+// System calls made through `tock_inline.h` bypass tracing.
+//
+// Yield tracing.
+//
+// With `TOCK_YIELD_TRACE` defined, libtock also times where the process
+// spends its time around `yield()`, to find callbacks that hurt
+// responsiveness:
+//
+// - time blocked in the kernel in `yield()`, `yield_no_wait()`, and
+//   `yield_wait_for()`,
+// - every upcall function, through a trampoline `subscribe()` installs in its
+//   place, and every deferred task run by `yield_check_tasks()`,
+// - how long deferred tasks wait in the queue before they run,
+// - the longest stretch the process ran without yielding. The kernel does not
+//   report when it queued an upcall, but an upcall can only run once the
+//   process yields, so this bounds how late any upcall runs.
+//
+// The longest upcall and task are reported with their function pointers,
+// which the app's `.lst` file maps to names. Timestamps share the region set
+// up with `tock_trace_start()`. As `tock_task_t` gains a field, set the
+// option through `LIBTOCK_CONFIG` so the app and libtock agree on it.
+
+#include "tock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of entries kept in the trace ring buffer.
+#define TOCK_TRACE_BUFFER_SIZE 64
+
+// Number of distinct drivers tracked in the per-driver statistics.
+#define TOCK_TRACE_MAX_DRIVERS 16
+
+// Number of latency histogram buckets. Bucket `i` counts calls that took
+// [2^(i-1), 2^i) ticks, with bucket 0 counting calls that took 0 ticks. The
+// last bucket also counts all longer calls.
+#define TOCK_TRACE_HISTOGRAM_BUCKETS 12
+
+// Kind of system call a trace entry records. These match the syscall class
+// numbers.
+typedef enum {
+  TOCK_TRACE_SUBSCRIBE            = 1,
+  TOCK_TRACE_COMMAND              = 2,
+  TOCK_TRACE_ALLOW_READWRITE      = 3,
+  TOCK_TRACE_ALLOW_READONLY       = 4,
+  TOCK_TRACE_ALLOW_USERSPACE_READ = 7,
+} tock_trace_class_t;
+
+// One traced system call.
+typedef struct {
+  uint32_t driver;
+  // Command, subscribe, or allow number.
+  uint32_t number;
+  // Low 32 bits of the tick counter when the call started and ended.
+  uint32_t start;
+  uint32_t end;
+  // `tock_trace_class_t`
+  uint8_t syscall_class;
+  // `syscall_rtype_t`
+  uint8_t rtype;
+} tock_trace_entry_t;
+
+// Accumulated statistics for one driver.
+typedef struct {
+  uint32_t driver;
+  uint32_t count;
+  uint32_t max_ticks;
+  uint64_t total_ticks;
+  uint32_t histogram[TOCK_TRACE_HISTOGRAM_BUCKETS];
+} tock_trace_driver_stats_t;
+
+// Enable timestamps using the read-only state region at `read_only_state`.
+// Pass NULL to stop taking timestamps.
+void tock_trace_start(void* read_only_state);
+
+// Current time in ticks from the read-only state region, or 0 if tracing has
+// not been started.
+uint32_t tock_trace_now(void);
+
+// Record one system call. Called by the tracing build of libtock.
+void tock_trace_record(tock_trace_class_t syscall_class, uint32_t driver, uint32_t number,
+                       uint32_t start, uint32_t end, syscall_rtype_t rtype);
+
+// Number of entries currently held in the ring buffer.
+int tock_trace_count(void);
+
+// Copy out entry `index` of the ring buffer, where 0 is the oldest entry.
+//
+// Returns `RETURNCODE_EINVAL` if `index` is out of range.
+returncode_t tock_trace_get(int index, tock_trace_entry_t* entry);
+
+// Get the statistics for `driver`.
+//
+// Returns `RETURNCODE_ENODEVICE` if no calls to `driver` have been traced.
+returncode_t tock_trace_driver_stats(uint32_t driver, tock_trace_driver_stats_t* stats);
+
+// Print the per-driver call counts and latency histograms to the console.
+void tock_trace_dump(void);
+
+// Clear the ring buffer and all statistics, including the yield statistics.
+void tock_trace_reset(void);
+
+// Time spent around `yield()`, in ticks.
+typedef struct {
+  // Traps into the kernel through `yield()`, `yield_no_wait()`, and
+  // `yield_wait_for()`, and the time spent there apart from upcalls.
+  uint32_t yields;
+  uint64_t yield_ticks;
+  // Longest time between two traps.
+  uint32_t max_busy_ticks;
+
+  uint32_t upcalls;
+  uint64_t upcall_ticks;
+  uint32_t max_upcall_ticks;
+  // Driver and function of that upcall.
+  uint32_t max_upcall_driver;
+  subscribe_upcall* max_upcall_cb;
+  // Upcalls that ran untimed because all trampolines were in use.
+  uint32_t untimed_upcalls;
+
+  uint32_t tasks;
+  uint64_t task_ticks;
+  uint32_t max_task_ticks;
+  subscribe_upcall* max_task_cb;
+  // Time tasks waited between `tock_enqueue()` and running.
+  uint64_t task_wait_ticks;
+  uint32_t max_task_wait_ticks;
+} tock_trace_yield_stats_t;
+
+// Number of subscriptions whose upcalls can be timed.
+#define TOCK_TRACE_MAX_UPCALLS 16
+
+// Read the yield statistics.
+void tock_trace_yield_stats(tock_trace_yield_stats_t* stats);
+
+// Print the yield statistics to the console.
+void tock_trace_yield_dump(void);
+
+// Hooks called by the yield tracing build of libtock.
+//
+// `tock_trace_yield_enter()` and `tock_trace_yield_exit()` bracket a trap into
+// the kernel. `tock_trace_upcall_wrap()` replaces the upcall and userdata
+// about to be subscribed with a timing trampoline, and returns a token for
+// `tock_trace_upcall_done()`, which undoes that if the subscribe failed and
+// maps the previous upcall the kernel returned back to the app's.
+typedef struct {
+  uint32_t start;
+  uint64_t upcall_ticks;
+} tock_trace_yield_mark_t;
+
+void tock_trace_yield_enter(tock_trace_yield_mark_t* mark);
+void tock_trace_yield_exit(const tock_trace_yield_mark_t* mark);
+void tock_trace_task(subscribe_upcall* cb, uint32_t enqueued, uint32_t start, uint32_t end);
+void* tock_trace_upcall_wrap(uint32_t driver, uint32_t subscribe, subscribe_upcall** cb, void** userdata);
+void tock_trace_upcall_done(void* token, subscribe_return_t* ret);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <lua/lauxlib.h>
+
+#include <libtock/services/time.h>
+
+#include "ltockalloc.h"
+
+static const uint32_t class_sizes[LTOCK_ALLOC_CLASSES] = {16, 32, 64, LTOCK_ALLOC_MAX_POOLED};
+
+// Smallest class holding `size` bytes, or -1 if it is too large for all.
+static int class_for(size_t size) {
+  for (int i = 0; i < LTOCK_ALLOC_CLASSES; i++) {
+    if (size <= class_sizes[i]) return i;
+  }
+  return -1;
+}
+
+// The pool `ptr` came from, or NULL if it came from `malloc()`. `size` is
+// the size Lua allocated it with, which picks the only pool it can be in.
+static libtock_pool_t* pool_of(ltock_alloc_t* a, const void* ptr, size_t size) {
+  int c = class_for(size);
+  if (c < 0 || !libtock_pool_owns(&a->pools[c], ptr)) return NULL;
+  return &a->pools[c];
+}
+
+static void* alloc_block(ltock_alloc_t* a, size_t size) {
+  int c = class_for(size);
+  if (c >= 0 && a->pools[c].count > 0) {
+    void* block = libtock_pool_alloc(&a->pools[c]);
+    if (block != NULL) return block;
+    a->overflows++;
+  } else {
+    a->large++;
+  }
+  return malloc(size);
+}
+
+static void free_block(ltock_alloc_t* a, void* ptr, size_t size) {
+  libtock_pool_t* pool = pool_of(a, ptr, size);
+  if (pool != NULL) {
+    libtock_pool_free(pool, ptr);
+  } else {
+    free(ptr);
+  }
+}
+
+void* ltock_alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+  ltock_alloc_t* a = (ltock_alloc_t*) ud;
+  // For new objects Lua passes the object's type as `osize`.
+  size_t old = ptr == NULL ? 0 : osize;
+
+  if (nsize == 0) {
+    if (ptr != NULL) free_block(a, ptr, old);
+    a->bytes -= old;
+    return NULL;
+  }
+
+  void* block;
+  if (ptr != NULL && class_for(old) >= 0 && class_for(old) == class_for(nsize) && pool_of(a, ptr, old) != NULL) {
+    // Still fits its block.
+    block = ptr;
+  } else {
+    block = alloc_block(a, nsize);
+    if (block == NULL) {
+      // Lua collects and retries once, then raises a memory error.
+      a->failures++;
+      return NULL;
+    }
+    if (ptr != NULL) {
+      memcpy(block, ptr, old < nsize ? old : nsize);
+      free_block(a, ptr, old);
+    }
+  }
+
+  a->bytes += nsize - old;
+  if (a->bytes > a->peak) a->peak = a->bytes;
+  return block;
+}
+
+static int panic(lua_State* L) {
+  printf("PANIC: unprotected error in call to Lua API (%s)\n", lua_tostring(L, -1));
+  return 0;
+}
+
+lua_State* ltock_newstate(ltock_alloc_t* alloc, const uint32_t counts[LTOCK_ALLOC_CLASSES]) {
+  static const uint32_t default_counts[LTOCK_ALLOC_CLASSES] = LTOCK_ALLOC_DEFAULT_COUNTS;
+  if (counts == NULL) counts = default_counts;
+
+  memset(alloc, 0, sizeof(*alloc));
+  for (int i = 0; i < LTOCK_ALLOC_CLASSES; i++) {
+    if (counts[i] == 0) continue;
+    if (libtock_pool_init(&alloc->pools[i], class_sizes[i], counts[i]) != RETURNCODE_SUCCESS) return NULL;
+  }
+
+  lua_State* L = lua_newstate(ltock_alloc, alloc);
+  if (L == NULL) return NULL;
+
+  lua_atpanic(L, panic);
+  lua_gc(L, LUA_GCSETPAUSE, LTOCK_GC_PAUSE);
+  lua_gc(L, LUA_GCSETSTEPMUL, LTOCK_GC_STEPMUL);
+  return L;
+}
+
+bool ltock_gc_step(lua_State* L, int kb, ltock_gc_stats_t* stats) {
+  uint64_t start   = libtock_time_now_us64();
+  bool finished    = lua_gc(L, LUA_GCSTEP, kb) != 0;
+  uint64_t pause   = libtock_time_now_us64() - start;
+  uint32_t pause32 = pause > UINT32_MAX ? UINT32_MAX : (uint32_t) pause;
+
+  stats->steps++;
+  if (finished) stats->cycles++;
+  stats->last_pause_us   = pause32;
+  stats->total_pause_us += pause;
+  if (pause32 > stats->max_pause_us) stats->max_pause_us = pause32;
+  return finished;
+}
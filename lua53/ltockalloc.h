@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <lua/lua.h>
+
+#include <libtock/services/pool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lua allocator and garbage collector settings for small heaps.
+//
+// `luaL_newstate()` allocates every Lua object with `realloc()`. Lua makes
+// many small allocations of a few sizes (strings, tables, closures, upvalues)
+// and frees them in arbitrary order, which fragments newlib's heap on boards
+// with little RAM, and a fragmented heap in turn forces Lua into full
+// collections when an allocation fails.
+//
+// `ltock_newstate()` instead serves requests of up to `LTOCK_ALLOC_MAX_POOLED`
+// bytes from `libtock_pool_t` size classes, in constant time and without
+// fragmenting, and only sends larger ones (table arrays and long strings) to
+// `malloc()`. A full class also falls back to `malloc()`, so the pools only
+// need to cover the common case:
+//
+//     static ltock_alloc_t alloc;
+//
+//     lua_State* L = ltock_newstate(&alloc, NULL);
+//     if (L == NULL) return -1;
+//     luaL_openlibs(L);
+//
+// The state starts with the GC preset below, which collects in small
+// increments and starts each cycle before the heap grows far past the live
+// data. Lua 5.3 has no generational mode, so this tunes its incremental one:
+//
+// - `LTOCK_GC_PAUSE`: start a cycle when the heap reaches this percentage of
+//   its size after the last one. Lua's default of 200 lets the heap double,
+//   which a small heap cannot spare.
+// - `LTOCK_GC_STEPMUL`: how much work each step does relative to allocation.
+//   Lower values make shorter pauses, but below 100 collection can fall
+//   behind allocation.
+//
+// Apps with idle time can also run the collector there with
+// `ltock_gc_step()`, which times every step so the longest pause a script
+// sees can be measured and bounded.
+
+// Block sizes of the pools, smallest first.
+#define LTOCK_ALLOC_CLASSES 4
+#define LTOCK_ALLOC_MAX_POOLED 128
+
+// Blocks per class when `ltock_newstate()` gets no counts, about 9 kB.
+#ifndef LTOCK_ALLOC_DEFAULT_COUNTS
+#define LTOCK_ALLOC_DEFAULT_COUNTS {128, 96, 32, 16}
+#endif
+
+#ifndef LTOCK_GC_PAUSE
+#define LTOCK_GC_PAUSE 110
+#endif
+
+#ifndef LTOCK_GC_STEPMUL
+#define LTOCK_GC_STEPMUL 200
+#endif
+
+typedef struct {
+  libtock_pool_t pools[LTOCK_ALLOC_CLASSES];
+  // Bytes Lua has allocated, as Lua counts them, and the most at once.
+  uint32_t bytes;
+  uint32_t peak;
+  // Allocations sent to `malloc()` because they were too large or their
+  // class was full.
+  uint32_t large;
+  uint32_t overflows;
+  // Allocations that failed entirely.
+  uint32_t failures;
+} ltock_alloc_t;
+
+typedef struct {
+  uint32_t steps;
+  // Cycles finished by `ltock_gc_step()`.
+  uint32_t cycles;
+  uint32_t last_pause_us;
+  uint32_t max_pause_us;
+  uint64_t total_pause_us;
+} ltock_gc_stats_t;
+
+// Create a Lua state that allocates from `alloc`, with `counts[i]` blocks for
+// size class `i`, or `LTOCK_ALLOC_DEFAULT_COUNTS` if `counts` is NULL. A
+// count of 0 leaves that class to `malloc()`.
+//
+// `alloc` must outlive the state. Returns NULL if the pools or the state
+// cannot be allocated.
+lua_State* ltock_newstate(ltock_alloc_t* alloc, const uint32_t counts[LTOCK_ALLOC_CLASSES]);
+
+// The `lua_Alloc` function behind `ltock_newstate()`, with an initialized
+// `ltock_alloc_t` as `ud`.
+void* ltock_alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+// Run one incremental GC step of about `kb` kilobytes of work, 0 for the
+// smallest step, and record how long it took in `stats`. Returns true if
+// the step finished a cycle.
+bool ltock_gc_step(lua_State* L, int kb, ltock_gc_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
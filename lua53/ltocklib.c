@@ -0,0 +1,894 @@
+#include <string.h>
+
+#include <lua/lauxlib.h>
+#include <lua/lua.h>
+
+#include <libtock-sync/interface/console.h>
+#include <libtock-sync/net/udp.h>
+#include <libtock-sync/peripherals/gpio.h>
+#include <libtock-sync/sensors/ambient_light.h>
+#include <libtock-sync/sensors/humidity.h>
+#include <libtock-sync/sensors/temperature.h>
+#include <libtock-sync/services/alarm.h>
+#include <libtock/interface/console.h>
+#include <libtock/peripherals/gpio.h>
+#include <libtock/sensors/ambient_light.h>
+#include <libtock/sensors/humidity.h>
+#include <libtock/sensors/temperature.h>
+#include <libtock/services/alarm.h>
+#include <libtock/services/time.h>
+
+#include "ltocklib.h"
+
+#define BUFFER_METATABLE "tock.buffer"
+
+// Most interfaces a board reports to `tock.udp.ifaces()`.
+#ifndef LTOCK_UDP_MAX_IFACES
+#define LTOCK_UDP_MAX_IFACES 4
+#endif
+
+typedef struct {
+  size_t len;
+  uint8_t data[];
+} buffer_t;
+
+// Push true, or nil, the message and the code of a failure.
+static int push_result(lua_State* L, returncode_t ret) {
+  if (ret == RETURNCODE_SUCCESS) {
+    lua_pushboolean(L, 1);
+    return 1;
+  }
+  lua_pushnil(L);
+  lua_pushstring(L, tock_strrcode(ret));
+  lua_pushinteger(L, ret);
+  return 3;
+}
+
+static int push_integer_result(lua_State* L, returncode_t ret, lua_Integer value) {
+  if (ret != RETURNCODE_SUCCESS) return push_result(L, ret);
+  lua_pushinteger(L, value);
+  return 1;
+}
+
+// Optional length argument at `arg`, at most `max`.
+static size_t opt_length(lua_State* L, int arg, size_t max) {
+  lua_Integer len = luaL_optinteger(L, arg, (lua_Integer) max);
+  luaL_argcheck(L, len >= 0 && (size_t) len <= max, arg, "length out of range");
+  return (size_t) len;
+}
+
+// Bytes of the string or buffer at `arg`, followed by an optional length.
+static const uint8_t* check_data(lua_State* L, int arg, size_t* len) {
+  buffer_t* b = luaL_testudata(L, arg, BUFFER_METATABLE);
+  if (b != NULL) {
+    *len = opt_length(L, arg + 1, b->len);
+    return b->data;
+  }
+  size_t size;
+  const char* s = luaL_checklstring(L, arg, &size);
+  *len = opt_length(L, arg + 1, size);
+  return (const uint8_t*) s;
+}
+
+static buffer_t* check_buffer(lua_State* L, int arg) {
+  return luaL_checkudata(L, arg, BUFFER_METATABLE);
+}
+
+// 1-based index into `b`.
+static size_t check_index(lua_State* L, int arg, const buffer_t* b) {
+  lua_Integer i = luaL_checkinteger(L, arg);
+  luaL_argcheck(L, i >= 1 && (size_t) i <= b->len, arg, "index out of range");
+  return (size_t) i - 1;
+}
+
+/*
+ * Tasks
+ */
+
+typedef struct task task_t;
+
+typedef struct {
+  task_t* head;
+  task_t* tail;
+} task_queue_t;
+
+// A driver that runs one operation at a time: the task whose operation is
+// running, or that has been handed the driver and is about to start, and
+// the tasks queued behind it.
+typedef struct {
+  task_t* active;
+  task_queue_t waiting;
+} slot_t;
+
+// How a call started from a task begins its operation, and pushes its
+// results once the upcall has come. `start` may read the call's arguments,
+// which are still on the task's stack.
+typedef struct {
+  slot_t* slot;
+  returncode_t (*start)(lua_State* L, task_t* t);
+  int (*finish)(lua_State* L, task_t* t);
+} async_op_t;
+
+typedef enum {
+  TASK_READY,
+  TASK_RUNNING,
+  TASK_QUEUED,
+  TASK_PENDING,
+} task_state_t;
+
+// A coroutine started with `tock.spawn()`. Kept as userdata in the tasks
+// table, so it does not move while the kernel or an alarm refers to it.
+struct task {
+  lua_State* thread;
+  task_t* next;
+  task_state_t state;
+  // Arguments of the first resume.
+  int nargs;
+
+  const async_op_t* op;
+  // Set by the upcall that finished `op`.
+  bool done;
+  returncode_t ret;
+  lua_Integer value;
+
+  libtock_alarm_t alarm;
+  bool timed;
+  uint32_t pin;
+  libtock_gpio_interrupt_mode_t mode;
+  sock_addr_t src;
+};
+
+// Upcalls carry no Lua state, so the scheduler is global and serves one
+// Lua state per app.
+static struct {
+  task_queue_t ready;
+  int live;
+  bool running;
+} sched;
+
+// Registry key of the table mapping each task's thread to its task.
+static const char tasks_key = 0;
+
+static void queue_push(task_queue_t* q, task_t* t) {
+  t->next = NULL;
+  if (q->tail == NULL) {
+    q->head = t;
+  } else {
+    q->tail->next = t;
+  }
+  q->tail = t;
+}
+
+static task_t* queue_pop(task_queue_t* q) {
+  task_t* t = q->head;
+  if (t == NULL) return NULL;
+  q->head = t->next;
+  if (q->head == NULL) q->tail = NULL;
+  return t;
+}
+
+static void make_ready(task_t* t) {
+  t->state = TASK_READY;
+  queue_push(&sched.ready, t);
+}
+
+// Finish the operation `t` waits on. Called from upcalls; `tock.run()`
+// resumes the task once `yield()` returns.
+static void task_done(task_t* t, returncode_t ret, lua_Integer value) {
+  t->ret   = ret;
+  t->value = value;
+  t->done  = true;
+  make_ready(t);
+}
+
+// Hand the driver to the next queued task.
+static void slot_release(slot_t* slot) {
+  slot->active = queue_pop(&slot->waiting);
+  if (slot->active != NULL) make_ready(slot->active);
+}
+
+static void slot_done(slot_t* slot, returncode_t ret, lua_Integer value) {
+  task_t* t = slot->active;
+  if (t == NULL) return;
+  task_done(t, ret, value);
+  slot_release(slot);
+}
+
+// Whether a blocking call would collide with a task's operation on `slot`.
+static bool slot_busy(const slot_t* slot) {
+  return slot->active != NULL;
+}
+
+// The task running on `L`, or NULL when `L` is not a task or cannot yield
+// here, e.g. under a metamethod. Calls then block the whole app.
+static task_t* current_task(lua_State* L) {
+  if (!sched.running || !lua_isyieldable(L)) return NULL;
+  lua_rawgetp(L, LUA_REGISTRYINDEX, &tasks_key);
+  lua_pushthread(L);
+  lua_rawget(L, -2);
+  task_t* t = lua_touserdata(L, -1);
+  lua_pop(L, 2);
+  return t;
+}
+
+static int await_continue(lua_State* L, __attribute__ ((unused)) int status, lua_KContext ctx) {
+  task_t* t = (task_t*) ctx;
+  if (t->done) {
+    t->done = false;
+    return t->op->finish(L, t);
+  }
+
+  slot_t* slot = t->op->slot;
+  if (slot != NULL) {
+    if (slot->active != NULL && slot->active != t) {
+      queue_push(&slot->waiting, t);
+      t->state = TASK_QUEUED;
+      return lua_yieldk(L, 0, ctx, await_continue);
+    }
+    slot->active = t;
+  }
+
+  returncode_t ret = t->op->start(L, t);
+  if (ret != RETURNCODE_SUCCESS) {
+    if (slot != NULL) slot_release(slot);
+    return push_result(L, ret);
+  }
+  t->state = TASK_PENDING;
+  return lua_yieldk(L, 0, ctx, await_continue);
+}
+
+// Start `op` for the task and yield to `tock.run()` until it finishes. The
+// call's arguments must have been checked: nothing may raise an error while
+// the task holds a driver.
+static int await(lua_State* L, task_t* t, const async_op_t* op) {
+  t->op   = op;
+  t->done = false;
+  return await_continue(L, LUA_YIELD, (lua_KContext) t);
+}
+
+static int finish_result(lua_State* L, task_t* t) {
+  return push_result(L, t->ret);
+}
+
+static int finish_integer(lua_State* L, task_t* t) {
+  return push_integer_result(L, t->ret, t->value);
+}
+
+// tock.spawn(f, ...) runs `f(...)` as a task under `tock.run()`.
+static int tock_spawn(lua_State* L) {
+  luaL_checktype(L, 1, LUA_TFUNCTION);
+  int nargs = lua_gettop(L) - 1;
+
+  lua_State* thread = lua_newthread(L);
+  task_t* t         = lua_newuserdata(L, sizeof(task_t));
+  memset(t, 0, sizeof(task_t));
+  t->thread = thread;
+  t->nargs  = nargs;
+
+  lua_rawgetp(L, LUA_REGISTRYINDEX, &tasks_key);
+  lua_pushvalue(L, -3);
+  lua_pushvalue(L, -3);
+  lua_rawset(L, -3);
+  lua_pop(L, 3);
+
+  lua_xmove(L, thread, nargs + 1);
+  sched.live++;
+  make_ready(t);
+  lua_pushboolean(L, 1);
+  return 1;
+}
+
+static void task_exit(lua_State* L, task_t* t) {
+  sched.live--;
+  lua_rawgetp(L, LUA_REGISTRYINDEX, &tasks_key);
+  lua_pushthread(t->thread);
+  lua_xmove(t->thread, L, 1);
+  lua_pushnil(L);
+  lua_rawset(L, -3);
+  lua_pop(L, 1);
+}
+
+// tock.run() resumes tasks as their operations finish, sleeping in
+// `yield()` while none can run, until every task has returned.
+static int tock_run(lua_State* L) {
+  if (sched.running) return luaL_error(L, "tock.run() called from a task");
+
+  sched.running = true;
+  while (sched.live > 0) {
+    task_t* t = queue_pop(&sched.ready);
+    if (t == NULL) {
+      yield();
+      continue;
+    }
+
+    int nargs = t->nargs;
+    t->nargs = 0;
+    t->state = TASK_RUNNING;
+    int status = lua_resume(t->thread, L, nargs);
+    if (status == LUA_YIELD) {
+      // Drop what a plain `coroutine.yield()` passed; it lets the other
+      // tasks run.
+      lua_pop(t->thread, lua_gettop(t->thread));
+      if (t->state == TASK_RUNNING) make_ready(t);
+    } else if (status == LUA_OK) {
+      task_exit(L, t);
+    } else {
+      lua_xmove(t->thread, L, 1);
+      task_exit(L, t);
+      sched.running = false;
+      return lua_error(L);
+    }
+  }
+  sched.running = false;
+  lua_pushboolean(L, 1);
+  return 1;
+}
+
+/*
+ * Buffers
+ */
+
+static int tock_buffer(lua_State* L) {
+  lua_Integer len = luaL_checkinteger(L, 1);
+  luaL_argcheck(L, len >= 0, 1, "negative length");
+
+  buffer_t* b = lua_newuserdata(L, sizeof(buffer_t) + (size_t) len);
+  b->len = (size_t) len;
+  memset(b->data, 0, b->len);
+  luaL_setmetatable(L, BUFFER_METATABLE);
+  return 1;
+}
+
+static int buffer_len(lua_State* L) {
+  lua_pushinteger(L, (lua_Integer) check_buffer(L, 1)->len);
+  return 1;
+}
+
+static int buffer_index(lua_State* L) {
+  buffer_t* b = check_buffer(L, 1);
+  if (lua_type(L, 2) == LUA_TSTRING) {
+    // Method lookup.
+    luaL_getmetatable(L, BUFFER_METATABLE);
+    lua_pushvalue(L, 2);
+    lua_rawget(L, -2);
+    return 1;
+  }
+  lua_Integer i = luaL_checkinteger(L, 2);
+  if (i < 1 || (size_t) i > b->len) return 0;
+  lua_pushinteger(L, b->data[i - 1]);
+  return 1;
+}
+
+static int buffer_newindex(lua_State* L) {
+  buffer_t* b   = check_buffer(L, 1);
+  size_t i      = check_index(L, 2, b);
+  lua_Integer v = luaL_checkinteger(L, 3);
+  luaL_argcheck(L, v >= 0 && v <= 255, 3, "not a byte");
+  b->data[i] = (uint8_t) v;
+  return 0;
+}
+
+// b:write(i, s) copies `s` into `b` starting at byte `i`.
+static int buffer_write(lua_State* L) {
+  buffer_t* b = check_buffer(L, 1);
+  size_t i    = check_index(L, 2, b);
+  size_t len;
+  const char* s = luaL_checklstring(L, 3, &len);
+  luaL_argcheck(L, len <= b->len - i, 3, "does not fit in the buffer");
+  memcpy(b->data + i, s, len);
+  return 0;
+}
+
+// b:tostring([i [, j]]) copies bytes `i` to `j` into a string, like
+// `string.sub()` without negative indices.
+static int buffer_tostring(lua_State* L) {
+  buffer_t* b   = check_buffer(L, 1);
+  lua_Integer i = luaL_optinteger(L, 2, 1);
+  lua_Integer j = luaL_optinteger(L, 3, (lua_Integer) b->len);
+  if (i < 1) i = 1;
+  if ((size_t) j > b->len) j = (lua_Integer) b->len;
+  if (i > j) {
+    lua_pushliteral(L, "");
+  } else {
+    lua_pushlstring(L, (const char*) b->data + i - 1, (size_t) (j - i + 1));
+  }
+  return 1;
+}
+
+static int buffer_fill(lua_State* L) {
+  buffer_t* b   = check_buffer(L, 1);
+  lua_Integer v = luaL_optinteger(L, 2, 0);
+  luaL_argcheck(L, v >= 0 && v <= 255, 2, "not a byte");
+  memset(b->data, (int) v, b->len);
+  return 0;
+}
+
+static const luaL_Reg buffer_meta[] = {
+  {"__len",      buffer_len     },
+  {"__index",    buffer_index   },
+  {"__newindex", buffer_newindex},
+  {"write",      buffer_write   },
+  {"tostring",   buffer_tostring},
+  {"fill",       buffer_fill    },
+  {NULL,         NULL           },
+};
+
+/*
+ * Alarm
+ */
+
+static void alarm_fired(__attribute__ ((unused)) uint32_t now,
+                        __attribute__ ((unused)) uint32_t scheduled,
+                        void*                             opaque) {
+  task_done(opaque, RETURNCODE_SUCCESS, 0);
+}
+
+static returncode_t delay_ms_start(lua_State* L, task_t* t) {
+  return libtock_alarm_in_ms((uint32_t) lua_tointeger(L, 1), alarm_fired, t, &t->alarm);
+}
+
+static returncode_t delay_us_start(lua_State* L, task_t* t) {
+  return libtock_alarm_in_us((uint32_t) lua_tointeger(L, 1), alarm_fired, t, &t->alarm);
+}
+
+static const async_op_t delay_ms_op = {NULL, delay_ms_start, finish_result};
+static const async_op_t delay_us_op = {NULL, delay_us_start, finish_result};
+
+static int alarm_delay_ms(lua_State* L) {
+  uint32_t ms = (uint32_t) luaL_checkinteger(L, 1);
+  task_t* t   = current_task(L);
+  if (t != NULL) return await(L, t, &delay_ms_op);
+  return push_result(L, libtocksync_alarm_delay_ms(ms));
+}
+
+static int alarm_delay_us(lua_State* L) {
+  uint32_t us = (uint32_t) luaL_checkinteger(L, 1);
+  task_t* t   = current_task(L);
+  if (t != NULL) return await(L, t, &delay_us_op);
+  return push_result(L, libtocksync_alarm_delay_us(us));
+}
+
+static int alarm_now_ms(lua_State* L) {
+  lua_pushinteger(L, (lua_Integer) (libtock_time_now_us64() / 1000));
+  return 1;
+}
+
+static int alarm_now_us(lua_State* L) {
+  lua_pushinteger(L, (lua_Integer) libtock_time_now_us64());
+  return 1;
+}
+
+static const luaL_Reg alarm_lib[] = {
+  {"delay_ms", alarm_delay_ms},
+  {"delay_us", alarm_delay_us},
+  {"now_ms",   alarm_now_ms  },
+  {"now_us",   alarm_now_us  },
+  {NULL,       NULL          },
+};
+
+/*
+ * Console
+ */
+
+static int console_write(lua_State* L) {
+  size_t len;
+  const uint8_t* data = check_data(L, 1, &len);
+  int written;
+  returncode_t ret = libtocksync_console_write(data, (uint32_t) len, &written);
+  return push_integer_result(L, ret, written);
+}
+
+static slot_t console_read_slot;
+
+static void console_read_done(returncode_t ret, uint32_t len) {
+  slot_done(&console_read_slot, ret, (lua_Integer) len);
+}
+
+static returncode_t console_read_start(lua_State* L, __attribute__ ((unused)) task_t* t) {
+  buffer_t* b = lua_touserdata(L, 1);
+  size_t len  = (size_t) luaL_optinteger(L, 2, (lua_Integer) b->len);
+  return libtock_console_read(b->data, (uint32_t) len, console_read_done);
+}
+
+static const async_op_t console_read_op = {&console_read_slot, console_read_start, finish_integer};
+
+static int console_read(lua_State* L) {
+  buffer_t* b = check_buffer(L, 1);
+  size_t len  = opt_length(L, 2, b->len);
+  task_t* t   = current_task(L);
+  if (t != NULL) return await(L, t, &console_read_op);
+  if (slot_busy(&console_read_slot)) return push_result(L, RETURNCODE_EBUSY);
+  int read;
+  returncode_t ret = libtocksync_console_read(b->data, (uint32_t) len, &read);
+  return push_integer_result(L, ret, read);
+}
+
+static const luaL_Reg console_lib[] = {
+  {"write", console_write},
+  {"read",  console_read },
+  {NULL,    NULL         },
+};
+
+/*
+ * GPIO
+ */
+
+static libtock_gpio_input_mode_t opt_pull(lua_State* L, int arg) {
+  static const char* const names[] = {"none", "up", "down", NULL};
+  static const libtock_gpio_input_mode_t modes[] = {libtock_pull_none, libtock_pull_up, libtock_pull_down};
+  return modes[luaL_checkoption(L, arg, "none", names)];
+}
+
+static uint32_t check_pin(lua_State* L, int arg) {
+  lua_Integer pin = luaL_checkinteger(L, arg);
+  luaL_argcheck(L, pin >= 0, arg, "negative pin");
+  return (uint32_t) pin;
+}
+
+static int gpio_output(lua_State* L) {
+  return push_result(L, libtock_gpio_enable_output(check_pin(L, 1)));
+}
+
+static int gpio_input(lua_State* L) {
+  return push_result(L, libtock_gpio_enable_input(check_pin(L, 1), opt_pull(L, 2)));
+}
+
+static int gpio_set(lua_State* L) {
+  return push_result(L, libtock_gpio_set(check_pin(L, 1)));
+}
+
+static int gpio_clear(lua_State* L) {
+  return push_result(L, libtock_gpio_clear(check_pin(L, 1)));
+}
+
+static int gpio_toggle(lua_State* L) {
+  return push_result(L, libtock_gpio_toggle(check_pin(L, 1)));
+}
+
+static int gpio_read(lua_State* L) {
+  int value;
+  returncode_t ret = libtock_gpio_read(check_pin(L, 1), &value);
+  return push_integer_result(L, ret, value);
+}
+
+// Tasks waiting for an edge. The interrupt callback is shared by all pins.
+static task_queue_t gpio_waiters;
+
+static void gpio_interrupt(uint32_t pin, bool value) {
+  task_queue_t waiting = gpio_waiters;
+  gpio_waiters = (task_queue_t) {NULL, NULL};
+
+  task_t* t;
+  while ((t = queue_pop(&waiting)) != NULL) {
+    bool edge = t->pin == pin &&
+                (t->mode == libtock_change ||
+                 (t->mode == libtock_rising_edge && value) ||
+                 (t->mode == libtock_falling_edge && !value));
+    if (edge) {
+      task_done(t, RETURNCODE_SUCCESS, 0);
+    } else {
+      queue_push(&gpio_waiters, t);
+    }
+  }
+}
+
+static returncode_t gpio_wait_start(lua_State* L, task_t* t) {
+  returncode_t ret = libtock_gpio_set_interrupt_callback(gpio_interrupt);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtock_gpio_enable_input(t->pin, opt_pull(L, 3));
+  if (ret != RETURNCODE_SUCCESS) return ret;
+  ret = libtock_gpio_enable_interrupt(t->pin, t->mode);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  queue_push(&gpio_waiters, t);
+  return RETURNCODE_SUCCESS;
+}
+
+static const async_op_t gpio_wait_op = {NULL, gpio_wait_start, finish_result};
+
+static int gpio_wait(lua_State* L) {
+  static const char* const edges[] = {"high", "low", "change", NULL};
+  static const libtock_gpio_interrupt_mode_t modes[] = {libtock_rising_edge, libtock_falling_edge, libtock_change};
+
+  uint32_t pin                   = check_pin(L, 1);
+  int edge                       = luaL_checkoption(L, 2, NULL, edges);
+  libtock_gpio_input_mode_t pull = opt_pull(L, 3);
+
+  task_t* t = current_task(L);
+  if (t != NULL) {
+    t->pin  = pin;
+    t->mode = modes[edge];
+    return await(L, t, &gpio_wait_op);
+  }
+  // A blocking wait takes over the interrupt callback.
+  if (gpio_waiters.head != NULL) return push_result(L, RETURNCODE_EBUSY);
+
+  returncode_t ret;
+  switch (edge) {
+    case 0:
+      ret = libtocksync_gpio_wait_until_high(pin, pull);
+      break;
+    case 1:
+      ret = libtocksync_gpio_wait_until_low(pin, pull);
+      break;
+    default:
+      ret = libtocksync_gpio_wait_until_changed(pin, pull);
+      break;
+  }
+  return push_result(L, ret);
+}
+
+static const luaL_Reg gpio_lib[] = {
+  {"output", gpio_output},
+  {"input",  gpio_input },
+  {"set",    gpio_set   },
+  {"clear",  gpio_clear },
+  {"toggle", gpio_toggle},
+  {"read",   gpio_read  },
+  {"wait",   gpio_wait  },
+  {NULL,     NULL       },
+};
+
+/*
+ * Sensors
+ */
+
+static slot_t temperature_slot;
+static slot_t humidity_slot;
+static slot_t light_slot;
+
+static void temperature_done(returncode_t ret, int value) {
+  slot_done(&temperature_slot, ret, value);
+}
+
+static void humidity_done(returncode_t ret, int value) {
+  slot_done(&humidity_slot, ret, value);
+}
+
+static void light_done(returncode_t ret, int value) {
+  slot_done(&light_slot, ret, value);
+}
+
+static returncode_t temperature_start(__attribute__ ((unused)) lua_State* L, __attribute__ ((unused)) task_t* t) {
+  return libtock_temperature_read(temperature_done);
+}
+
+static returncode_t humidity_start(__attribute__ ((unused)) lua_State* L, __attribute__ ((unused)) task_t* t) {
+  return libtock_humidity_read(humidity_done);
+}
+
+static returncode_t light_start(__attribute__ ((unused)) lua_State* L, __attribute__ ((unused)) task_t* t) {
+  return libtock_ambient_light_read_intensity(light_done);
+}
+
+static const async_op_t temperature_op = {&temperature_slot, temperature_start, finish_integer};
+static const async_op_t humidity_op    = {&humidity_slot, humidity_start, finish_integer};
+static const async_op_t light_op       = {&light_slot, light_start, finish_integer};
+
+static int sensors_temperature(lua_State* L) {
+  task_t* t = current_task(L);
+  if (t != NULL) return await(L, t, &temperature_op);
+  if (slot_busy(&temperature_slot)) return push_result(L, RETURNCODE_EBUSY);
+
+  int value;
+  returncode_t ret = libtocksync_temperature_read(&value);
+  return push_integer_result(L, ret, value);
+}
+
+static int sensors_humidity(lua_State* L) {
+  task_t* t = current_task(L);
+  if (t != NULL) return await(L, t, &humidity_op);
+  if (slot_busy(&humidity_slot)) return push_result(L, RETURNCODE_EBUSY);
+
+  int value;
+  returncode_t ret = libtocksync_humidity_read(&value);
+  return push_integer_result(L, ret, value);
+}
+
+static int sensors_light(lua_State* L) {
+  task_t* t = current_task(L);
+  if (t != NULL) return await(L, t, &light_op);
+  if (slot_busy(&light_slot)) return push_result(L, RETURNCODE_EBUSY);
+
+  int value;
+  returncode_t ret = libtocksync_ambient_light_read_intensity(&value);
+  return push_integer_result(L, ret, value);
+}
+
+static const luaL_Reg sensors_lib[] = {
+  {"temperature", sensors_temperature},
+  {"humidity",    sensors_humidity   },
+  {"light",       sensors_light      },
+  {NULL,          NULL               },
+};
+
+/*
+ * UDP
+ */
+
+// The kernel writes the source of each received datagram into one buffer per
+// app, so the binding is global.
+static struct {
+  sock_handle_t handle;
+  unsigned char cfg[2 * sizeof(sock_addr_t)];
+} udp;
+
+static void check_sock_addr(lua_State* L, int arg, sock_addr_t* addr) {
+  size_t len;
+  const char* ip = luaL_checklstring(L, arg, &len);
+  luaL_argcheck(L, len == sizeof(addr->addr.addr), arg, "address must be 16 bytes");
+  lua_Integer port = luaL_checkinteger(L, arg + 1);
+  luaL_argcheck(L, port >= 0 && port <= UINT16_MAX, arg + 1, "port out of range");
+
+  memcpy(addr->addr.addr, ip, len);
+  addr->port = (udp_port_t) port;
+}
+
+static int udp_ifaces(lua_State* L) {
+  ipv6_addr_t ifaces[LTOCK_UDP_MAX_IFACES];
+  memset(ifaces, 0, sizeof(ifaces));
+  returncode_t ret = libtock_udp_list_ifaces(ifaces, LTOCK_UDP_MAX_IFACES);
+  if (ret != RETURNCODE_SUCCESS) return push_result(L, ret);
+
+  // The kernel does not say how many it filled in, unused entries stay zero.
+  static const ipv6_addr_t unused;
+  lua_newtable(L);
+  lua_Integer n = 0;
+  for (int i = 0; i < LTOCK_UDP_MAX_IFACES; i++) {
+    if (memcmp(&ifaces[i], &unused, sizeof(unused)) == 0) continue;
+    lua_pushlstring(L, (const char*) ifaces[i].addr, sizeof(ifaces[i].addr));
+    lua_rawseti(L, -2, ++n);
+  }
+  return 1;
+}
+
+static int udp_bind(lua_State* L) {
+  sock_addr_t addr;
+  check_sock_addr(L, 1, &addr);
+  return push_result(L, libtock_udp_bind(&udp.handle, &addr, udp.cfg));
+}
+
+static int udp_close(lua_State* L) {
+  return push_result(L, libtock_udp_close(&udp.handle));
+}
+
+static slot_t udp_send_slot;
+static slot_t udp_recv_slot;
+
+static void udp_send_done(statuscode_t status) {
+  slot_done(&udp_send_slot, tock_status_to_returncode(status), 0);
+}
+
+static returncode_t udp_send_start(lua_State* L, __attribute__ ((unused)) task_t* t) {
+  sock_addr_t dst;
+  check_sock_addr(L, 2, &dst);
+  size_t len;
+  const uint8_t* data = check_data(L, 1, &len);
+  return libtock_udp_send((void*) data, len, &dst, udp_send_done);
+}
+
+static void udp_recv_done(statuscode_t status, int len) {
+  task_t* t = udp_recv_slot.active;
+  if (t == NULL) return;
+  if (t->timed) libtock_alarm_ms_cancel(&t->alarm);
+  // The next datagram overwrites the source, so keep it with the task.
+  memcpy(&t->src, udp.cfg, sizeof(t->src));
+  slot_done(&udp_recv_slot, tock_status_to_returncode(status), len);
+}
+
+static void udp_recv_timeout(__attribute__ ((unused)) uint32_t now,
+                             __attribute__ ((unused)) uint32_t scheduled,
+                             void*                             opaque) {
+  if (udp_recv_slot.active != opaque) return;
+
+  // Stop receiving into the task's buffer.
+  libtock_udp_set_upcall_frame_received(NULL, NULL);
+  libtock_udp_set_readwrite_allow_rx(NULL, 0);
+  slot_done(&udp_recv_slot, RETURNCODE_ECANCEL, 0);
+}
+
+static returncode_t udp_recv_start(lua_State* L, task_t* t) {
+  buffer_t* b      = lua_touserdata(L, 1);
+  returncode_t ret = libtock_udp_recv(b->data, b->len, udp_recv_done);
+  if (ret != RETURNCODE_SUCCESS) return ret;
+
+  t->timed = !lua_isnoneornil(L, 2);
+  if (t->timed) libtock_alarm_in_ms((uint32_t) lua_tointeger(L, 2), udp_recv_timeout, t, &t->alarm);
+  return RETURNCODE_SUCCESS;
+}
+
+static int push_datagram(lua_State* L, size_t received, const sock_addr_t* src) {
+  lua_pushinteger(L, (lua_Integer) received);
+  lua_pushlstring(L, (const char*) src->addr.addr, sizeof(src->addr.addr));
+  lua_pushinteger(L, src->port);
+  return 3;
+}
+
+static int udp_recv_finish(lua_State* L, task_t* t) {
+  if (t->ret != RETURNCODE_SUCCESS) return push_result(L, t->ret);
+  return push_datagram(L, (size_t) t->value, &t->src);
+}
+
+static const async_op_t udp_send_op = {&udp_send_slot, udp_send_start, finish_result};
+static const async_op_t udp_recv_op = {&udp_recv_slot, udp_recv_start, udp_recv_finish};
+
+static int udp_send(lua_State* L) {
+  sock_addr_t dst;
+  check_sock_addr(L, 2, &dst);
+  size_t len;
+  const uint8_t* data = check_data(L, 1, &len);
+
+  task_t* t = current_task(L);
+  if (t != NULL) return await(L, t, &udp_send_op);
+  if (slot_busy(&udp_send_slot)) return push_result(L, RETURNCODE_EBUSY);
+  // The kernel only reads the datagram.
+  return push_result(L, libtocksync_udp_send((void*) data, len, &dst));
+}
+
+static int udp_recv(lua_State* L) {
+  buffer_t* b = check_buffer(L, 1);
+  if (!lua_isnoneornil(L, 2)) luaL_checkinteger(L, 2);
+
+  task_t* t = current_task(L);
+  if (t != NULL) return await(L, t, &udp_recv_op);
+  if (slot_busy(&udp_recv_slot)) return push_result(L, RETURNCODE_EBUSY);
+
+  size_t received;
+  returncode_t ret;
+  if (lua_isnoneornil(L, 2)) {
+    ret = libtocksync_udp_recv(b->data, b->len, &received);
+  } else {
+    ret = libtocksync_udp_recv_timeout(b->data, b->len, &received, (uint32_t) luaL_checkinteger(L, 2));
+  }
+  if (ret != RETURNCODE_SUCCESS) return push_result(L, ret);
+
+  sock_addr_t src;
+  memcpy(&src, udp.cfg, sizeof(src));
+  return push_datagram(L, received, &src);
+}
+
+static const luaL_Reg udp_lib[] = {
+  {"ifaces", udp_ifaces},
+  {"bind",   udp_bind  },
+  {"close",  udp_close },
+  {"send",   udp_send  },
+  {"recv",   udp_recv  },
+  {NULL,     NULL      },
+};
+
+/*
+ * Module
+ */
+
+static const luaL_Reg tock_lib[] = {
+  {"buffer", tock_buffer},
+  {"spawn",  tock_spawn },
+  {"run",    tock_run   },
+  {NULL,     NULL       },
+};
+
+static void add_sublib(lua_State* L, const char* name, const luaL_Reg* funcs) {
+  lua_newtable(L);
+  luaL_setfuncs(L, funcs, 0);
+  lua_setfield(L, -2, name);
+}
+
+LUAMOD_API int luaopen_tock(lua_State* L) {
+  luaL_newmetatable(L, BUFFER_METATABLE);
+  luaL_setfuncs(L, buffer_meta, 0);
+  lua_pop(L, 1);
+
+  if (lua_rawgetp(L, LUA_REGISTRYINDEX, &tasks_key) != LUA_TTABLE) {
+    lua_newtable(L);
+    lua_rawsetp(L, LUA_REGISTRYINDEX, &tasks_key);
+  }
+  lua_pop(L, 1);
+
+  luaL_newlib(L, tock_lib);
+  add_sublib(L, "alarm", alarm_lib);
+  add_sublib(L, "console", console_lib);
+  add_sublib(L, "gpio", gpio_lib);
+  add_sublib(L, "sensors", sensors_lib);
+  add_sublib(L, "udp", udp_lib);
+  return 1;
+}
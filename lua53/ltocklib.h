@@ -0,0 +1,108 @@
+#pragma once
+
+#include <lua/lua.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lua bindings for libtock.
+//
+// Open the module like the standard libraries, before running any script:
+//
+//     luaL_requiref(L, LUA_TOCKLIBNAME, luaopen_tock, true);
+//
+// Scripts then reach the drivers through the `tock` table:
+//
+//     local msg = tock.buffer(32)
+//     msg:write(1, "temp ")
+//     while true do
+//       local t = tock.sensors.temperature()
+//       tock.console.write(msg, 5)
+//       print(t)
+//       tock.gpio.toggle(0)
+//       tock.alarm.delay_ms(1000)
+//     end
+//
+// `tock.buffer(n)` returns `n` zeroed bytes as userdata. Buffers and strings
+// are shared with the kernel in place, so passing one to a driver costs no
+// copy or allocation. Lua never moves a value while it is reachable, and
+// every call finishes with the buffer before returning, so no buffer stays
+// allowed after its call.
+//
+// Buffers index bytes from 1 like strings: `b[i]`, `b[i] = v` and `#b`, plus
+// `b:write(i, s)` to copy a string in, `b:tostring([i [, j]])` to copy bytes
+// out, and `b:fill(v)`. Functions taking data accept a string or a buffer
+// followed by an optional length, which defaults to the whole value.
+//
+// - `tock.alarm`: `delay_ms(ms)`, `delay_us(us)`, `now_ms()`, `now_us()`.
+//   Times wrap at the range of a Lua integer.
+// - `tock.console`: `write(data [, len])` returns the bytes written,
+//   `read(buffer [, len])` the bytes read.
+// - `tock.gpio`: `output(pin)`, `input(pin [, pull])`, `set(pin)`,
+//   `clear(pin)`, `toggle(pin)`, `read(pin)`, and
+//   `wait(pin, "high" | "low" | "change" [, pull])`. `pull` is "none" (the
+//   default), "up" or "down".
+// - `tock.sensors`: `temperature()` in hundredths of a degree centigrade,
+//   `humidity()` in hundredths of a percent, `light()` in lux.
+// - `tock.udp`: `ifaces()` lists interface addresses as 16 byte strings,
+//   `bind(addr, port)`, `close()`, `send(data, addr, port [, len])`, and
+//   `recv(buffer [, timeout_ms])`, which returns the length, source address
+//   and source port of one datagram.
+//
+// Functions that would return nothing return true. A failed call returns
+// nil, the `tock_strrcode()` message and the returncode, like the io library,
+// so scripts can use `assert()`. Bad arguments raise errors.
+//
+// Tasks
+// -----
+//
+// A call that waits for the kernel blocks the whole app, so one script
+// waiting on a socket holds up every other. Functions run as tasks wait
+// without blocking instead:
+//
+//     tock.spawn(function ()
+//       local packet = tock.buffer(64)
+//       while true do
+//         local len, addr, port = tock.udp.recv(packet)
+//         ...
+//       end
+//     end)
+//     tock.spawn(function ()
+//       while true do
+//         tock.sensors.temperature()
+//         tock.alarm.delay_ms(1000)
+//       end
+//     end)
+//     tock.run()
+//
+// `tock.spawn(f, ...)` makes a task that runs `f(...)` in its own coroutine.
+// `tock.run()` runs the tasks until all have returned. When a task calls
+// `tock.alarm.delay_ms()`, `delay_us()`, `tock.console.read()`,
+// `tock.gpio.wait()`, `tock.sensors.*()`, `tock.udp.send()` or
+// `tock.udp.recv()`, the call starts the driver operation and yields the
+// task's coroutine; the upcall that `yield()` delivers when the operation
+// finishes queues the task, and `tock.run()` resumes it with the call's
+// results. While no task can run, `tock.run()` sleeps in `yield()`.
+// Calling `coroutine.yield()` in a task lets the other tasks run first.
+//
+// Drivers that take one operation at a time (console reads, each sensor and
+// UDP sends and receives) serve tasks in the order they called. Alarms and
+// GPIO waits overlap freely.
+//
+// Calls still block when they are not made from a task, or from where a
+// task cannot yield, e.g. from a metamethod or a coroutine the script
+// created itself. A blocking call on a driver a task is waiting on returns
+// RETURNCODE_EBUSY. `tock.console.write()` and `print()` always block: they
+// share the console driver and finish quickly. If a task raises an error,
+// `tock.run()` raises it; calling `tock.run()` again continues the other
+// tasks. There is one scheduler per app, so only one Lua state should use
+// tasks.
+
+#define LUA_TOCKLIBNAME "tock"
+
+LUAMOD_API int luaopen_tock(lua_State* L);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,22 @@
+#include <string.h>
+
+#include <lua/lauxlib.h>
+
+#include "ltockscripts.h"
+
+int ltock_load_script(lua_State* L, const char* name) {
+  for (size_t i = 0; i < ltock_script_count; i++) {
+    const ltock_script_t* script = &ltock_scripts[i];
+    if (strcmp(script->name, name) != 0) continue;
+
+    // `luaL_loadbufferx()` hands the reader the buffer itself, so the
+    // bytecode is read in place. Mode "b" refuses anything but bytecode.
+    const char* chunkname = lua_pushfstring(L, "=%s", name);
+    int ret = luaL_loadbufferx(L, (const char*) script->code, script->len, chunkname, "b");
+    lua_remove(L, -2);
+    return ret;
+  }
+
+  lua_pushfstring(L, "no precompiled script '%s'", name);
+  return LUA_ERRFILE;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <lua/lua.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lua scripts precompiled into the app.
+//
+// Apps list scripts in `LUA_SRCS` in their Makefile:
+//
+//     LUA_SRCS := main.lua
+//
+// The build compiles each one to bytecode on the host and links it into the
+// app as read-only data, so it stays in flash. At run time the app loads a
+// script by its file name without `.lua`, and calls it like any chunk:
+//
+//     if (ltock_load_script(L, "main") != LUA_OK ||
+//         lua_pcall(L, 0, 0, 0) != LUA_OK) {
+//       printf("%s\n", lua_tostring(L, -1));
+//     }
+//
+// Loading reads the bytecode where it is in flash, so the device never holds
+// the source or runs the parser and compiler, and starts the script sooner
+// with less heap. Scripts are stripped of debug information by default, so
+// errors do not carry line numbers; set `LUAC_FLAGS :=` to keep it.
+
+typedef struct {
+  const char* name;
+  const unsigned char* code;
+  size_t len;
+} ltock_script_t;
+
+// Generated from `LUA_SRCS`.
+extern const ltock_script_t ltock_scripts[];
+extern const size_t ltock_script_count;
+
+// Push the precompiled script `name` as a function, like `luaL_loadbuffer()`.
+// Returns LUA_ERRFILE with a message on the stack if there is no such script.
+int ltock_load_script(lua_State* L, const char* name);
+
+#ifdef __cplusplus
+}
+#endif
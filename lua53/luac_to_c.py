@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Embed precompiled Lua chunks in a C source file.
+
+Writes the `ltock_scripts` table declared in `ltockscripts.h`, with one
+read-only byte array per chunk. Each script is named after its file without
+the extension, so `build/lua/main.luac` is loaded as "main".
+
+Usage:
+
+    luac_to_c.py OUTPUT CHUNK...
+"""
+
+import os
+import re
+import sys
+
+
+def main(argv):
+    if len(argv) < 2:
+        sys.exit(__doc__)
+    output, chunks = argv[0], argv[1:]
+
+    lines = ['// Generated by luac_to_c.py, do not edit.', '',
+             '#include <ltockscripts.h>', '']
+    entries = []
+    for i, path in enumerate(chunks):
+        name = os.path.splitext(os.path.basename(path))[0]
+        with open(path, 'rb') as f:
+            code = f.read()
+
+        array = 'chunk_{}_{}'.format(i, re.sub(r'\W', '_', name))
+        lines.append('static const unsigned char {}[] = {{'.format(array))
+        for start in range(0, len(code), 12):
+            row = code[start:start + 12]
+            lines.append('  ' + ' '.join('0x{:02x},'.format(b) for b in row))
+        lines.append('};')
+        lines.append('')
+        entries.append('  {{"{}", {}, sizeof({})}},'.format(name, array, array))
+
+    lines.append('const ltock_script_t ltock_scripts[] = {')
+    lines.extend(entries)
+    lines.append('};')
+    lines.append('const size_t ltock_script_count = {};'.format(len(chunks)))
+
+    with open(output, 'w') as f:
+        f.write('\n'.join(lines) + '\n')
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
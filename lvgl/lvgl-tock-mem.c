@@ -0,0 +1,143 @@
+#include <string.h>
+#include <unistd.h>
+
+#include "lvgl-tock.h"
+
+// lvgl's memory comes from one region taken from the heap break when lvgl
+// starts, so its allocations neither fragment the app's `malloc()` heap nor
+// compete with it. The region is managed as a first-fit free list in address
+// order, merging neighbours on free, which suits lvgl's mix of long-lived
+// objects and short-lived draw buffers.
+
+#define ALIGN 8
+
+typedef struct block {
+  // Size of the block including this header.
+  uint32_t size;
+  // Next free block, only valid while the block is free.
+  struct block* next;
+} block_t;
+
+#define HEADER ((sizeof(block_t) + ALIGN - 1) & ~(size_t) (ALIGN - 1))
+#define MIN_BLOCK (HEADER + ALIGN)
+
+// lvgl's allocator hooks carry no context, so the region is global.
+static struct {
+  uint8_t* start;
+  block_t* free_list;
+  lvgl_tock_mem_usage_t usage;
+} mem;
+
+static block_t* header_of(void* ptr) {
+  return (block_t*) ((uint8_t*) ptr - HEADER);
+}
+
+static void* payload_of(block_t* block) {
+  return (uint8_t*) block + HEADER;
+}
+
+returncode_t lvgl_tock_mem_init(uint32_t size) {
+  if (mem.start != NULL) return RETURNCODE_EALREADY;
+
+  size &= ~(uint32_t) (ALIGN - 1);
+  if (size < MIN_BLOCK) return RETURNCODE_EINVAL;
+
+  void* brk = sbrk((int) (size + ALIGN - 1));
+  if (brk == (void*) -1) return RETURNCODE_ENOMEM;
+
+  mem.start           = (uint8_t*) (((uintptr_t) brk + ALIGN - 1) & ~(uintptr_t) (ALIGN - 1));
+  mem.free_list       = (block_t*) mem.start;
+  mem.free_list->size = size;
+  mem.free_list->next = NULL;
+
+  memset(&mem.usage, 0, sizeof(mem.usage));
+  mem.usage.total = size;
+  return RETURNCODE_SUCCESS;
+}
+
+void* lvgl_tock_mem_alloc(size_t len) {
+  if (len == 0 || len > mem.usage.total) return NULL;
+  uint32_t need = (len + HEADER + ALIGN - 1) & ~(uint32_t) (ALIGN - 1);
+
+  block_t** link = &mem.free_list;
+  while (*link != NULL && (*link)->size < need) link = &(*link)->next;
+
+  block_t* block = *link;
+  if (block == NULL) {
+    mem.usage.failures++;
+    return NULL;
+  }
+
+  if (block->size - need >= MIN_BLOCK) {
+    // Keep the tail free, in the block's place in the list.
+    block_t* rest = (block_t*) ((uint8_t*) block + need);
+    rest->size  = block->size - need;
+    rest->next  = block->next;
+    *link       = rest;
+    block->size = need;
+  } else {
+    *link = block->next;
+  }
+
+  mem.usage.used += block->size;
+  if (mem.usage.used > mem.usage.peak) mem.usage.peak = mem.usage.used;
+  return payload_of(block);
+}
+
+void lvgl_tock_mem_free(void* ptr) {
+  if (ptr == NULL) return;
+
+  block_t* block = header_of(ptr);
+  mem.usage.used -= block->size;
+
+  block_t* prev = NULL;
+  block_t* next = mem.free_list;
+  while (next != NULL && next < block) {
+    prev = next;
+    next = next->next;
+  }
+
+  if (next != NULL && (uint8_t*) block + block->size == (uint8_t*) next) {
+    block->size += next->size;
+    block->next  = next->next;
+  } else {
+    block->next = next;
+  }
+
+  if (prev != NULL && (uint8_t*) prev + prev->size == (uint8_t*) block) {
+    prev->size += block->size;
+    prev->next  = block->next;
+  } else if (prev != NULL) {
+    prev->next = block;
+  } else {
+    mem.free_list = block;
+  }
+}
+
+void* lvgl_tock_mem_realloc(void* ptr, size_t len) {
+  if (ptr == NULL) return lvgl_tock_mem_alloc(len);
+  if (len == 0) {
+    lvgl_tock_mem_free(ptr);
+    return NULL;
+  }
+
+  block_t* block = header_of(ptr);
+  size_t have    = block->size - HEADER;
+  if (len <= have) return ptr;
+
+  void* moved = lvgl_tock_mem_alloc(len);
+  if (moved == NULL) return NULL;
+  memcpy(moved, ptr, have);
+  lvgl_tock_mem_free(ptr);
+  return moved;
+}
+
+void lvgl_tock_mem_usage(lvgl_tock_mem_usage_t* usage) {
+  *usage = mem.usage;
+
+  usage->largest_free = 0;
+  for (block_t* b = mem.free_list; b != NULL; b = b->next) {
+    uint32_t payload = b->size - HEADER;
+    if (payload > usage->largest_free) usage->largest_free = payload;
+  }
+}
@@ -0,0 +1,165 @@
+#include <libtock/display/screen.h>
+#include <libtock/kernel/read_only_state.h>
+#include <libtock/services/alarm.h>
+#include <libtock/services/time.h>
+#include <libtock/services/touch_queue.h>
+#include <libtock/tock.h>
+#include <lvgl/lvgl.h>
+
+#include "lvgl-tock.h"
+
+#define TOUCH_QUEUE_LEN 16
+
+static lv_disp_draw_buf_t disp_buf;
+static lv_disp_drv_t disp_drv;
+
+static lv_indev_drv_t indev_drv;
+
+static libtock_touch_event_t touch_events[TOUCH_QUEUE_LEN];
+static int touch_status = LIBTOCK_TOUCH_STATUS_UNSTARTED;
+static uint16_t touch_x = 0, touch_y = 0;
+
+static int buffer_size = 0;
+
+// Lets lvgl read the clock without a system call, when the kernel shares its
+// read-only state.
+static uint8_t read_only_state[LIBTOCK_READ_ONLY_STATE_BUFFER_LEN] __attribute__((aligned(8)));
+
+// Wakes `lvgl_tock_step()` when the next lvgl timer is due.
+static libtock_alarm_t wake_alarm;
+
+// Area being written to the screen.
+static lv_disp_drv_t* flushing_disp;
+static uint8_t* flushing_data;
+static size_t flushing_len;
+
+static void write_done(__attribute__ ((unused)) returncode_t ret) {
+  lv_disp_flush_ready(flushing_disp);
+}
+
+static void frame_done(returncode_t ret) {
+  if (ret == RETURNCODE_SUCCESS) {
+    ret = libtock_screen_write(flushing_data, buffer_size, flushing_len, write_done);
+  }
+  // lvgl waits for every flush, so a failed one must still complete.
+  if (ret != RETURNCODE_SUCCESS) lv_disp_flush_ready(flushing_disp);
+}
+
+/* screen driver */
+static void screen_lvgl_driver(lv_disp_drv_t* disp, const lv_area_t* area, lv_color_t* color_p) {
+  int w = area->x2 - area->x1 + 1;
+  int h = area->y2 - area->y1 + 1;
+  flushing_disp = disp;
+  flushing_data = (uint8_t*) color_p;
+  flushing_len  = (w * h) * sizeof(lv_color_t);
+
+  // lvgl carries on rendering into the other buffer while this one is sent.
+  if (libtock_screen_set_frame(area->x1, area->y1, w, h, frame_done) != RETURNCODE_SUCCESS) {
+    lv_disp_flush_ready(disp);
+  }
+}
+
+// Called by lvgl while it has no free draw buffer.
+static void screen_lvgl_wait(__attribute__ ((unused)) lv_disp_drv_t* disp) {
+  yield();
+}
+
+static void my_input_read(__attribute__((unused)) lv_indev_drv_t* drv, lv_indev_data_t* data) {
+  // Hand lvgl one queued event per read so no press or release is missed.
+  // lvgl follows the first touch only.
+  libtock_touch_event_t event;
+  while (libtock_touch_queue_pop(&event)) {
+    if (event.id != 0) continue;
+    touch_status = event.status;
+    touch_x      = event.x;
+    touch_y      = event.y;
+    break;
+  }
+  data->continue_reading = libtock_touch_queue_count() > 0;
+
+  if (touch_status == LIBTOCK_TOUCH_STATUS_PRESSED || touch_status == LIBTOCK_TOUCH_STATUS_MOVED) {
+    data->point.x = touch_x;
+    data->point.y = touch_y;
+    data->state   = LV_INDEV_STATE_PRESSED;
+  } else {
+    data->state = LV_INDEV_STATE_RELEASED;
+  }
+}
+
+int lvgl_tock_init_with_pool(int buffer_lines, uint32_t pool_size) {
+  uint32_t width, height;
+  int error = libtock_screen_get_resolution(&width, &height);
+  if (error != RETURNCODE_SUCCESS) return error;
+
+  uint8_t* first;
+  uint8_t* second;
+  buffer_size = width * buffer_lines * sizeof(lv_color_t);
+  error       = libtock_screen_buffer_init(buffer_size, &first);
+  if (error != RETURNCODE_SUCCESS) return error;
+  error = libtock_screen_buffer_init(buffer_size, &second);
+  if (error != RETURNCODE_SUCCESS) return error;
+
+  if (pool_size == 0) {
+    tock_heap_usage_t heap;
+    tock_heap_usage(&heap);
+    pool_size = (uint32_t) ((uint64_t) heap.free * LVGL_TOCK_POOL_PERCENT / 100);
+  }
+  if (pool_size < LVGL_TOCK_POOL_MIN) return RETURNCODE_ENOMEM;
+  error = lvgl_tock_mem_init(pool_size);
+  if (error != RETURNCODE_SUCCESS) return error;
+
+  // Without a read-only state the clock reads the alarm counter instead.
+  if (libtock_read_only_state_allocate_region(read_only_state, sizeof(read_only_state)) == RETURNCODE_SUCCESS) {
+    libtock_time_use_read_only_state(read_only_state);
+  }
+
+  /* initialize littlevgl */
+  lv_init();
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.flush_cb = screen_lvgl_driver;
+  disp_drv.wait_cb  = screen_lvgl_wait;
+  disp_drv.hor_res  = width;
+  disp_drv.ver_res  = height;
+  lv_disp_draw_buf_init(&disp_buf, (lv_color_t*) first, (lv_color_t*) second, width * buffer_lines);
+  disp_drv.draw_buf = &disp_buf;
+  lv_disp_drv_register(&disp_drv);
+
+  int touches;
+  if (libtock_touch_get_number_of_touches(&touches) == RETURNCODE_SUCCESS && touches >= 1) {
+    libtock_touch_queue_start(touch_events, TOUCH_QUEUE_LEN, NULL);
+    lv_indev_drv_init(&indev_drv);
+    indev_drv.type    = LV_INDEV_TYPE_POINTER;
+    indev_drv.read_cb = my_input_read;
+    lv_indev_drv_register(&indev_drv);
+  }
+
+  return RETURNCODE_SUCCESS;
+}
+
+int lvgl_tock_init(int buffer_lines) {
+  return lvgl_tock_init_with_pool(buffer_lines, 0);
+}
+
+uint32_t lvgl_tock_tick_ms(void) {
+  return (uint32_t) (libtock_time_now_us64() / 1000);
+}
+
+static void wake(__attribute__ ((unused)) uint32_t now,
+                 __attribute__ ((unused)) uint32_t scheduled,
+                 __attribute__ ((unused)) void*    opaque) {}
+
+void lvgl_tock_step(void) {
+  uint32_t next = lv_timer_handler();
+  if (next == 0) return;
+
+  // Any upcall, such as a touch or a finished screen write, also ends the
+  // sleep.
+  bool armed = next != LV_NO_TIMER_READY &&
+               libtock_alarm_in_ms(next, wake, NULL, &wake_alarm) == RETURNCODE_SUCCESS;
+  yield();
+  if (armed) libtock_alarm_ms_cancel(&wake_alarm);
+}
+
+void lvgl_tock_event(__attribute__ ((unused)) int millis) {
+  lv_timer_handler();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <libtock/tock.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Share of the app's free heap `lvgl_tock_init()` gives lvgl's memory pool,
+// in percent, after the draw buffers.
+#ifndef LVGL_TOCK_POOL_PERCENT
+#define LVGL_TOCK_POOL_PERCENT 50
+#endif
+
+// lvgl needs at least this much memory to start.
+#define LVGL_TOCK_POOL_MIN (2U * 1024U)
+
+// Set up lvgl on the screen, and on the touch device if there is one.
+//
+// lvgl renders into two draw buffers of `buffer_lines` screen lines each.
+// While one is being written to the screen, lvgl draws the next area into
+// the other, and waits with `yield()` only when both are busy.
+//
+// lvgl allocates its objects from a pool of `LVGL_TOCK_POOL_PERCENT` of the
+// heap left after the draw buffers, see `lvgl_tock_init_with_pool()`.
+int lvgl_tock_init(int buffer_lines);
+
+// Like `lvgl_tock_init()`, with a pool of `pool_size` bytes. 0 sizes it from
+// the free heap as `lvgl_tock_init()` does.
+int lvgl_tock_init_with_pool(int buffer_lines, uint32_t pool_size);
+
+// Run lvgl's due timers, then sleep until the next one is due or an upcall
+// arrives, whichever is first. Apps call it in a loop:
+//
+//     while (1) {
+//       lvgl_tock_step();
+//     }
+//
+// lvgl reads its clock itself, from the kernel's read-only state when the
+// kernel shares one, so the app neither polls nor counts time for it.
+void lvgl_tock_step(void);
+
+// Run lvgl's due timers without sleeping. lvgl reads its own clock, so
+// `millis` is ignored; it remains for apps written against the old tick.
+void lvgl_tock_event(int millis);
+
+// lvgl's clock in milliseconds, `LV_TICK_CUSTOM_SYS_TIME_EXPR` in lv_conf.h.
+uint32_t lvgl_tock_tick_ms(void);
+
+// lvgl's memory pool, `LV_MEM_CUSTOM_ALLOC` and friends in lv_conf.h.
+typedef struct {
+  // Bytes in the pool, allocated now including headers, and allocated at
+  // most.
+  uint32_t total;
+  uint32_t used;
+  uint32_t peak;
+  // Largest allocation that would succeed now.
+  uint32_t largest_free;
+  // Allocations that found no free block large enough.
+  uint32_t failures;
+} lvgl_tock_mem_usage_t;
+
+// Take a pool of `size` bytes from the heap. `lvgl_tock_init()` calls this.
+returncode_t lvgl_tock_mem_init(uint32_t size);
+void* lvgl_tock_mem_alloc(size_t len);
+void lvgl_tock_mem_free(void* ptr);
+void* lvgl_tock_mem_realloc(void* ptr, size_t len);
+void lvgl_tock_mem_usage(lvgl_tock_mem_usage_t* usage);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,6 +4,8 @@ set -x
 
 NEWLIB_SRC_DIR=$1
 NEWLIB_INSTALL_DIR=$2
+# Optimization flag, `-Os` unless building a speed variant.
+NEWLIB_OPT=${3:--Os}
 
 # We want to end up with newlib compiled for at least the `v6-m/nofp`,
 # `v7-m/nofp`, and `v7e-m/nofp` architectures. For that to happen the
@@ -36,5 +38,5 @@ $NEWLIB_SRC_DIR/configure --target=arm-none-eabi \
   --enable-newlib-nano-formatted-io \
   --prefix=`realpath $NEWLIB_INSTALL_DIR`
 
-make -j$(nproc) CFLAGS_FOR_TARGET='-g -Os -ffunction-sections -fdata-sections -fPIC -msingle-pic-base -mno-pic-data-is-text-relative'
+make -j$(nproc) CFLAGS_FOR_TARGET="-g $NEWLIB_OPT -ffunction-sections -fdata-sections -fPIC -msingle-pic-base -mno-pic-data-is-text-relative"
 make install
@@ -5,6 +5,8 @@ set -x
 NEWLIB_SRC_DIR=$1
 NEWLIB_INSTALL_DIR=$2
 TARGET=$3
+# Optimization flag, `-Os` unless building a speed variant.
+NEWLIB_OPT=${4:--Os}
 
 $NEWLIB_SRC_DIR/configure --target=$TARGET \
   --disable-newlib-supplied-syscalls \
@@ -20,5 +22,5 @@ $NEWLIB_SRC_DIR/configure --target=$TARGET \
   --enable-newlib-nano-formatted-io \
   --prefix=`realpath $NEWLIB_INSTALL_DIR`
 
-make -j$(nproc) CFLAGS_FOR_TARGET='-g -Os -ffunction-sections -fdata-sections'
+make -j$(nproc) CFLAGS_FOR_TARGET="-g $NEWLIB_OPT -ffunction-sections -fdata-sections"
 make install
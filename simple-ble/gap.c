@@ -77,3 +77,38 @@ int gap_add_manufacturer_specific_data(AdvData_t* adv_data, uint8_t* data, uint8
                                   size_b);
   }
 }
+
+int gap_reserve_adv_data_field(AdvData_t* adv_data, GapAdvertisementData_t type, uint8_t data_len) {
+  int new_length = 2 + data_len + adv_data->offset;
+  if (new_length > adv_data->capacity) {
+    return -1;
+  }
+  int data_offset = adv_data->offset + 2;
+  adv_data->buf[adv_data->offset]     = data_len + 1;
+  adv_data->buf[adv_data->offset + 1] = type;
+  memset(&adv_data->buf[data_offset], 0, data_len);
+  adv_data->offset = new_length;
+  return data_offset;
+}
+
+int gap_reserve_service_data(AdvData_t* adv_data, uint16_t uuid16, uint8_t data_len) {
+  int offset = gap_reserve_adv_data_field(adv_data, GAP_SERVICE_DATA, 2 + data_len);
+  if (offset < 0) return offset;
+  adv_data->buf[offset]     = uuid16 & 0xff;
+  adv_data->buf[offset + 1] = uuid16 >> 8;
+  return offset + 2;
+}
+
+int gap_update_field(AdvData_t* adv_data, int offset, const uint8_t* data, uint8_t len) {
+  if (data == NULL || offset < 0 || offset + len > adv_data->offset) {
+    return -1;
+  }
+  int changed = 0;
+  for (int i = 0; i < len; i++) {
+    if (adv_data->buf[offset + i] != data[i]) {
+      adv_data->buf[offset + i] = data[i];
+      changed++;
+    }
+  }
+  return changed;
+}
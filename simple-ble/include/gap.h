@@ -114,6 +114,47 @@ int gap_add_service_data(AdvData_t *adv_data, uint16_t uuid16, uint8_t *data, ui
 // len                  - length of manufacturer specific data
 int gap_add_manufacturer_specific_data(AdvData_t *adv_data, uint8_t *data, uint8_t len);
 
+// Reserve a data field to be filled in later
+//
+// Lays out the field header once and zeroes its data, so a field that changes
+// while advertising, such as a sensor reading, can be written in place with
+// `gap_update_field`.
+//
+// adv_data             - advertisement data structure to insert the field into
+// type                 - Data field type
+// data_len             - length of field data
+//
+// Returns the offset of the field data in the `adv_data` buffer, or -1 if it
+// does not fit.
+int gap_reserve_adv_data_field(AdvData_t *adv_data, GapAdvertisementData_t type, uint8_t data_len);
+
+// Reserve a service data field to be filled in later
+//
+// The field holds `uuid16` followed by `data_len` bytes of service data.
+//
+// adv_data             - advertisement data structure to insert the field into
+// uuid16               - 16 bit uuid to be associated with the data
+// data_len             - length of service data
+//
+// Returns the offset of the service data in the `adv_data` buffer, or -1 if
+// it does not fit.
+int gap_reserve_service_data(AdvData_t *adv_data, uint16_t uuid16, uint8_t data_len);
+
+// Update field data in place
+//
+// Only the bytes that differ are written. The kernel reads the advertising
+// buffer for every advertising event, so while advertising the new data goes
+// out with the next event without stopping and restarting.
+//
+// adv_data             - advertisement data structure holding the field
+// offset               - offset returned when the field was reserved
+// data                 - new field data
+// len                  - length of new field data
+//
+// Returns the number of bytes that changed, or -1 if the data lies outside
+// the laid out advertisement.
+int gap_update_field(AdvData_t *adv_data, int offset, const uint8_t *data, uint8_t len);
+
 #ifdef __cplusplus
 }
 #endif
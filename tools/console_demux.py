@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+"""Split a multiplexed libtock console stream into its channels.
+
+Reads the console output of an app that uses `libtock/services/console_mux.h`
+and undoes the framing. Plain text, and `LIBTOCK_LOG()` frames for
+`log_decode.py`, are passed through to stdout unchanged. See
+`libtock/services/console_mux.h` for the frame format.
+
+Usage:
+
+    console_demux.py [-c CHANNEL] [-d DIR] [INPUT]
+
+By default every channel's data is printed line by line with a `[N] ` prefix,
+between the plain text. With `-c` only that channel's bytes are written to
+stdout, as they were queued, for example to capture a binary dump. With `-d`
+each channel is written to `DIR/channel-N.bin` and only text goes to stdout.
+
+INPUT defaults to stdin and may be a serial device, e.g. /dev/ttyACM0
+(configure the baud rate with `stty` first).
+"""
+
+import argparse
+import os
+import sys
+
+FRAME_START = 0x00
+FRAME_MUX = 0xFE
+MAX_LOG_ARGS = 8
+FRAME_LOG_ANCHOR = 0xFF
+
+
+class Demux(object):
+
+    def __init__(self, text, channel_out):
+        # `channel_out(channel, data)` receives each frame's payload.
+        self.text = text
+        self.channel_out = channel_out
+
+    def _read(self, stream, n):
+        data = stream.read(n)
+        while data is not None and 0 < len(data) < n:
+            more = stream.read(n - len(data))
+            if not more:
+                break
+            data += more
+        return data if data is not None and len(data) == n else None
+
+    def run(self, stream):
+        while True:
+            b = stream.read(1)
+            if not b:
+                return
+            if b[0] != FRAME_START:
+                self.text(b)
+                continue
+
+            tag = self._read(stream, 1)
+            if tag is None:
+                return
+            if tag[0] != FRAME_MUX:
+                self._pass_log_frame(stream, b + tag)
+                continue
+
+            header = self._read(stream, 2)
+            if header is None:
+                return
+            data = self._read(stream, header[1])
+            if data is None:
+                return
+            self.channel_out(header[0], data)
+
+    def _pass_log_frame(self, stream, start):
+        # Log frames are passed on whole, so text is never written into the
+        # middle of one.
+        n = start[1]
+        if n == FRAME_LOG_ANCHOR:
+            length = 4
+        elif n <= MAX_LOG_ARGS:
+            length = 4 + 4 * n
+        else:
+            self.text(start)
+            return
+        rest = self._read(stream, length)
+        if rest is not None:
+            self.text(start + rest)
+
+
+class LinePrinter(object):
+    """Prints each channel's data a line at a time with a channel prefix."""
+
+    def __init__(self, out):
+        self.out = out
+        self.partial = {}
+
+    def text(self, data):
+        self.out.write(data)
+        self.out.flush()
+
+    def channel(self, channel, data):
+        pending = self.partial.get(channel, b'') + data
+        lines = pending.split(b'\n')
+        self.partial[channel] = lines.pop()
+        for line in lines:
+            self.out.write(b'[%d] %s\n' % (channel, line))
+        self.out.flush()
+
+    def finish(self):
+        for channel, rest in sorted(self.partial.items()):
+            if rest:
+                self.out.write(b'[%d] %s\n' % (channel, rest))
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('-c', '--channel', type=int, help='write only this channel to stdout')
+    parser.add_argument('-d', '--dir', help='write each channel to DIR/channel-N.bin')
+    parser.add_argument('input', nargs='?', help='console stream, default stdin')
+    args = parser.parse_args(argv[1:])
+
+    out = sys.stdout.buffer
+    files = {}
+    printer = None
+    if args.channel is not None:
+        def text(data):
+            pass
+
+        def channel_out(channel, data):
+            if channel == args.channel:
+                out.write(data)
+                out.flush()
+    elif args.dir is not None:
+        os.makedirs(args.dir, exist_ok=True)
+
+        def text(data):
+            out.write(data)
+            out.flush()
+
+        def channel_out(channel, data):
+            if channel not in files:
+                path = os.path.join(args.dir, 'channel-%d.bin' % channel)
+                files[channel] = open(path, 'wb')
+            files[channel].write(data)
+            files[channel].flush()
+    else:
+        printer = LinePrinter(out)
+        text = printer.text
+        channel_out = printer.channel
+
+    demux = Demux(text, channel_out)
+    try:
+        if args.input is not None:
+            with open(args.input, 'rb', buffering=0) as stream:
+                demux.run(stream)
+        else:
+            demux.run(sys.stdin.buffer)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if printer is not None:
+            printer.finish()
+        for f in files.values():
+            f.close()
+        out.flush()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""Print the CRC tables of `libtock/peripherals/crc_soft.c`.
+
+All three libtock CRCs are computed reflected: CRC-32 and CRC-32C are
+reflected algorithms, and the 16-bit CCITT CRC, which reflects its input but
+not its output, is computed reflected and has its result reversed. Each
+table has eight slices for slicing-by-8; slices after the first are only
+compiled with `LIBTOCK_CRC_SLICE_BY_8`.
+
+Usage:
+
+    crc_tables.py > tables.inc
+"""
+
+TABLES = [
+    ('crc32_table', 0xEDB88320, 8),
+    ('crc32c_table', 0x82F63B78, 8),
+    ('crc16_table', 0x8408, 1),
+]
+
+
+def slices(poly, count):
+    first = []
+    for byte in range(256):
+        crc = byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ poly if crc & 1 else crc >> 1
+        first.append(crc)
+    table = [first]
+    for _ in range(1, count):
+        prev = table[-1]
+        table.append([(v >> 8) ^ first[v & 0xFF] for v in prev])
+    return table
+
+
+def main():
+    for name, poly, count in TABLES:
+        ctype = 'uint32_t' if poly > 0xFFFF else 'uint16_t'
+        dims = '[LIBTOCK_CRC_SLICES][256]' if count > 1 else '[256]'
+        width = 8 if poly > 0xFFFF else 4
+        print('static const %s %s%s = {' % (ctype, name, dims))
+        for index, values in enumerate(slices(poly, count)):
+            if index == 1:
+                print('#if LIBTOCK_CRC_SLICE_BY_8')
+            indent = '    ' if count > 1 else '  '
+            if count > 1:
+                print('  {')
+            per_line = 8 if width == 8 else 12
+            for i in range(0, 256, per_line):
+                row = ', '.join('0x%0*x' % (width, v) for v in values[i:i + per_line])
+                print('%s%s,' % (indent, row))
+            if count > 1:
+                print('  },')
+        if count > 1:
+            print('#endif')
+        print('};')
+        print()
+
+
+if __name__ == '__main__':
+    main()
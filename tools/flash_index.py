@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Build a flash index image for `libtock/storage/flash_index.h`.
+
+Reads key/value pairs, one per line as KEY<TAB>VALUE, and writes an image
+with a perfect hash over the keys, which the app searches in place
+in flash. Blank lines and lines starting with `#` are skipped. Keys and
+values are taken as UTF-8 text, or as hex bytes with `--hex-keys` and
+`--hex-values`.
+
+Usage:
+
+    flash_index.py [--hex-keys] [--hex-values] [--c NAME] INPUT OUTPUT
+
+With `--c NAME` the image is written as a C source file defining
+`const uint8_t NAME[]` and `const uint32_t NAME_size`, to be compiled into
+the app. Otherwise the raw image is written, e.g. for a writeable flash
+region.
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = 0x58444946
+VERSION = 1
+HEADER = '<IHHIIIII'
+RECORD = '<IIHH'
+EMPTY = 0xFFFFFFFF
+# Average keys per bucket. Larger is smaller but slower to build.
+BUCKET_LOAD = 4
+# Keys per slot. Spare slots let the last buckets find a seed quickly.
+SLOT_LOAD = 0.9
+MAX_SEED = 0xFFFF
+
+
+def fmix32(h):
+    h ^= h >> 16
+    h = (h * 0x85EBCA6B) & 0xFFFFFFFF
+    h ^= h >> 13
+    h = (h * 0xC2B2AE35) & 0xFFFFFFFF
+    h ^= h >> 16
+    return h
+
+
+def key_hash(seed, key):
+    """FNV-1a seeded with `seed`, then mixed. Must match flash_index.c."""
+    h = 0x811C9DC5 ^ ((seed * 0x9E3779B9) & 0xFFFFFFFF)
+    for b in key:
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return fmix32(h)
+
+
+def crc32(data):
+    return zlib.crc32(data) & 0xFFFFFFFF
+
+
+def align(n):
+    return (n + 3) & ~3
+
+
+def build_hash(keys):
+    """Pick a seed per bucket so every key lands in its own slot."""
+    n = len(keys)
+    slot_count = max(1, int(n / SLOT_LOAD) + 1)
+    bucket_count = max(1, (n + BUCKET_LOAD - 1) // BUCKET_LOAD)
+    buckets = [[] for _ in range(bucket_count)]
+    for i, key in enumerate(keys):
+        buckets[key_hash(0, key) % bucket_count].append(i)
+
+    seeds = [0] * bucket_count
+    slot_of = [None] * n
+    taken = [False] * slot_count
+    for b in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+        members = buckets[b]
+        if not members:
+            break
+        for seed in range(1, MAX_SEED + 1):
+            slots = [key_hash(seed, keys[i]) % slot_count
+                     for i in members]
+            if len(set(slots)) == len(slots) and not any(taken[s] for s in slots):
+                break
+        else:
+            raise ValueError('no perfect hash found, try a smaller BUCKET_LOAD')
+        seeds[b] = seed
+        for i, s in zip(members, slots):
+            slot_of[i] = s
+            taken[s] = True
+    return seeds, slot_of, slot_count
+
+
+def build_image(pairs):
+    keys = [k for k, _ in pairs]
+    if len(set(keys)) != len(keys):
+        raise ValueError('duplicate keys')
+    for key, value in pairs:
+        if len(key) > 0xFFFF or len(value) > 0xFFFF:
+            raise ValueError('keys and values are limited to 65535 bytes')
+
+    n = len(pairs)
+    seeds, slot_of, slot_count = build_hash(keys) if n else ([], [], 0)
+    header_size = struct.calcsize(HEADER)
+    seeds_offset = header_size
+    slots_offset = align(seeds_offset + 2 * len(seeds))
+    records_offset = slots_offset + 4 * slot_count
+    data_offset = records_offset + struct.calcsize(RECORD) * n
+
+    # Values are four-byte aligned so they can be read as structs.
+    data = bytearray()
+    slots = [EMPTY] * slot_count
+    records = []
+    for i, (key, value) in enumerate(pairs):
+        value_offset = data_offset + len(data)
+        data += value
+        data += b'\0' * (align(len(data)) - len(data))
+        key_offset = data_offset + len(data)
+        data += key
+        data += b'\0' * (align(len(data)) - len(data))
+        slots[slot_of[i]] = i
+        records.append(struct.pack(RECORD, key_offset, value_offset, len(key),
+                                   len(value)))
+
+    body = bytearray()
+    body += struct.pack('<%dH' % len(seeds), *seeds)
+    body += b'\0' * (slots_offset - seeds_offset - len(body))
+    body += struct.pack('<%dI' % slot_count, *slots)
+    body += b''.join(records)
+    body += data
+
+    size = header_size + len(body)
+    header = struct.pack(HEADER, MAGIC, VERSION, 0, size, n, len(seeds),
+                         slot_count, crc32(bytes(body)))
+    return header + bytes(body)
+
+
+def parse(path, hex_keys, hex_values):
+    pairs = []
+    with open(path, 'r', encoding='utf-8') as f:
+        for number, line in enumerate(f, 1):
+            line = line.rstrip('\r\n')
+            if not line or line.startswith('#'):
+                continue
+            key, sep, value = line.partition('\t')
+            if not sep:
+                raise ValueError('%s:%d: expected KEY<TAB>VALUE' % (path, number))
+            key = bytes.fromhex(key) if hex_keys else key.encode('utf-8')
+            value = bytes.fromhex(value) if hex_values else value.encode('utf-8')
+            pairs.append((key, value))
+    return pairs
+
+
+def write_c(path, name, image):
+    with open(path, 'w') as f:
+        f.write('// Generated by tools/flash_index.py, do not edit.\n\n')
+        f.write('#include <stdint.h>\n\n')
+        f.write('__attribute__((aligned(4))) const uint8_t %s[%d] = {\n' %
+                (name, len(image)))
+        for i in range(0, len(image), 12):
+            f.write('  ' + ', '.join('0x%02x' % b for b in image[i:i + 12]) +
+                    ',\n')
+        f.write('};\n\n')
+        f.write('const uint32_t %s_size = %d;\n' % (name, len(image)))
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(
+        description='Build a flash index image for libtock.')
+    parser.add_argument('--hex-keys', action='store_true')
+    parser.add_argument('--hex-values', action='store_true')
+    parser.add_argument('--c', metavar='NAME',
+                        help='write a C source file defining NAME')
+    parser.add_argument('input')
+    parser.add_argument('output')
+    args = parser.parse_args(argv[1:])
+
+    try:
+        image = build_image(parse(args.input, args.hex_keys, args.hex_values))
+    except ValueError as e:
+        sys.stderr.write('flash_index.py: %s\n' % e)
+        return 1
+
+    if args.c:
+        write_c(args.output, args.c, image)
+    else:
+        with open(args.output, 'wb') as f:
+            f.write(image)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""Decode libtock deferred-format log frames.
+
+Reads the console output of an app that uses `LIBTOCK_LOG()` and prints it
+with every binary log frame expanded back into text. Plain stdout output is
+passed through unchanged. See `libtock/services/log.h` for the frame format.
+
+Usage:
+
+    log_decode.py APP.elf [INPUT]
+
+INPUT defaults to stdin and may be a serial device, e.g. /dev/ttyACM0
+(configure the baud rate with `stty` first).
+"""
+
+import re
+import struct
+import sys
+
+ANCHOR_SYMBOL = 'libtock_log_anchor'
+FRAME_START = 0x00
+FRAME_ANCHOR = 0xFF
+MAX_ARGS = 8
+
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+FORMAT_SPEC = re.compile(
+    r'%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|j|z|t)?([diuxXocsp%])')
+
+
+class Elf(object):
+    """The parts of a 32-bit little-endian ELF file the decoder needs."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError('%s is not a 32-bit little-endian ELF file' % path)
+
+        shoff, = struct.unpack_from('<I', self.data, 0x20)
+        shentsize, shnum = struct.unpack_from('<HH', self.data, 0x2e)
+        self.sections = []
+        for i in range(shnum):
+            (name, sh_type, flags, addr, offset, size, link, _, _,
+             entsize) = struct.unpack_from('<IIIIIIIIII', self.data,
+                                           shoff + i * shentsize)
+            self.sections.append((sh_type, flags, addr, offset, size, link,
+                                  entsize))
+
+    def symbol(self, wanted):
+        for sh_type, _, _, offset, size, link, entsize in self.sections:
+            if sh_type != SHT_SYMTAB:
+                continue
+            strtab = self.sections[link][3]
+            for pos in range(offset, offset + size, entsize):
+                name, value = struct.unpack_from('<II', self.data, pos)
+                if self._cstring(strtab + name) == wanted:
+                    return value
+        raise KeyError('symbol %s not found, was the app built with '
+                       'libtock/services/log.c?' % wanted)
+
+    def string_at(self, address):
+        for sh_type, flags, addr, offset, size, _, _ in self.sections:
+            if (flags & SHF_ALLOC and sh_type != SHT_NOBITS
+                    and addr <= address < addr + size):
+                return self._cstring(offset + address - addr)
+        return None
+
+    def _cstring(self, pos):
+        end = self.data.index(b'\0', pos)
+        return self.data[pos:end].decode('utf-8', 'replace')
+
+
+class Decoder(object):
+
+    def __init__(self, elf):
+        self.elf = elf
+        self.anchor = elf.symbol(ANCHOR_SYMBOL)
+        # Runtime address of the anchor, learned from the anchor frame.
+        self.runtime_anchor = None
+
+    def expand(self, format_id, args):
+        # IDs are signed offsets from the anchor, so wrap the sum.
+        fmt = self.elf.string_at((self.anchor + format_id) & 0xFFFFFFFF)
+        if fmt is None:
+            return '<unknown log format 0x%08x %s>\n' % (
+                format_id, ' '.join('0x%x' % a for a in args))
+
+        args = list(args)
+
+        def replace(match):
+            flags, width, precision, length, conv = match.groups()
+            if conv == '%':
+                return '%'
+            value = args.pop(0) if args else 0
+            spec = '%' + flags + width + ('.' + precision if precision else '')
+            if conv in 'di':
+                bits = {'hh': 8, 'h': 16}.get(length, 32)
+                value &= (1 << bits) - 1
+                if value >= 1 << (bits - 1):
+                    value -= 1 << bits
+                return (spec + 'd') % value
+            if conv in 'uxXo':
+                bits = {'hh': 8, 'h': 16}.get(length, 32)
+                return (spec + ('d' if conv == 'u' else conv)) % (
+                    value & ((1 << bits) - 1))
+            if conv == 'c':
+                return (spec + 's') % chr(value & 0xFF)
+            if conv == 'p':
+                return (spec + 's') % ('0x%08x' % value)
+            return (spec + 's') % self.resolve_string(value)
+
+        return FORMAT_SPEC.sub(replace, fmt)
+
+    def resolve_string(self, pointer):
+        # Only strings in flash can be recovered from the ELF.
+        if self.runtime_anchor is not None:
+            s = self.elf.string_at(
+                (pointer - self.runtime_anchor + self.anchor) & 0xFFFFFFFF)
+            if s is not None:
+                return s
+        return '<str@0x%08x>' % pointer
+
+    def run(self, stream, out):
+        while True:
+            b = stream.read(1)
+            if not b:
+                return
+            if b[0] != FRAME_START:
+                out.write(b)
+                continue
+
+            n = stream.read(1)
+            if not n:
+                return
+            n = n[0]
+            if n == FRAME_ANCHOR:
+                payload = stream.read(4)
+                if len(payload) < 4:
+                    return
+                self.runtime_anchor, = struct.unpack('<I', payload)
+                continue
+            if n > MAX_ARGS:
+                # Not a frame, pass it through.
+                out.write(b + bytes([n]))
+                continue
+
+            payload = stream.read(4 + 4 * n)
+            if len(payload) < 4 + 4 * n:
+                return
+            words = struct.unpack('<%dI' % (n + 1), payload)
+            out.write(self.expand(words[0], words[1:]).encode('utf-8'))
+            out.flush()
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        sys.stderr.write(__doc__)
+        return 1
+
+    decoder = Decoder(Elf(argv[1]))
+    out = sys.stdout.buffer
+    if len(argv) == 3:
+        with open(argv[2], 'rb', buffering=0) as stream:
+            decoder.run(stream, out)
+    else:
+        decoder.run(sys.stdin.buffer, out)
+    out.flush()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
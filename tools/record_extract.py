@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+"""Extract a libtock syscall recording from console output.
+
+Reads the console output of an app that called `tock_record_dump()` and
+writes the recording it printed to OUTPUT, for replay with the host build:
+
+    TOCK_HOST_REPLAY=OUTPUT ./host/build/APP/APP
+
+Other console output is ignored. See `libtock/tock_record.h` for the
+recording format.
+
+Usage:
+
+    record_extract.py OUTPUT [INPUT]
+
+INPUT defaults to stdin and may be a serial device, e.g. /dev/ttyACM0
+(configure the baud rate with `stty` first).
+"""
+
+import re
+import sys
+
+LINE = re.compile(r'tock-record: ([0-9a-f]*)\s*$')
+END = re.compile(r'tock-record: end (\d+)\s*$')
+
+
+def extract(lines):
+    data = bytearray()
+    for line in lines:
+        end = END.search(line)
+        if end:
+            if len(data) != int(end.group(1)):
+                raise ValueError('recording is %d bytes, the app reported %s' %
+                                 (len(data), end.group(1)))
+            return bytes(data)
+        match = LINE.search(line)
+        if match:
+            data += bytes.fromhex(match.group(1))
+    raise ValueError('no end of recording found')
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        sys.stderr.write(__doc__)
+        return 2
+
+    source = open(sys.argv[2], errors='replace') if len(sys.argv) == 3 else sys.stdin
+    try:
+        data = extract(source)
+    except ValueError as e:
+        sys.stderr.write('record_extract.py: %s\n' % e)
+        return 1
+    with open(sys.argv[1], 'wb') as f:
+        f.write(data)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
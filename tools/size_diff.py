@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Compare per-object sizes between two builds.
+
+Reads two reports written by the Berkeley-format `size` tool, as saved by
+`make size-objects` in `build/<arch>/objects.size`, and prints every object
+whose text, data or bss size changed, largest text change first, followed by
+the totals. Objects only present in one report are listed as added or
+removed. Library objects match across optimization profiles even though each
+profile builds into its own directory.
+
+Usage:
+
+    size_diff.py BASELINE CURRENT
+"""
+
+import re
+import sys
+
+FIELDS = ('text', 'data', 'bss')
+
+# Libraries built with a non-default profile live in `build-<profile>/`.
+PROFILE_BUILDDIR = re.compile(r'/build-[a-z-]+/')
+
+
+def read_report(path):
+    """Map each object name to its (text, data, bss) sizes."""
+    sizes = {}
+    with open(path) as f:
+        for line in f:
+            parts = line.split(None, 5)
+            if len(parts) < 6 or not parts[0].isdigit():
+                continue
+            name = PROFILE_BUILDDIR.sub('/build/', parts[5].strip())
+            sizes[name] = tuple(int(p) for p in parts[:3])
+    return sizes
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write(__doc__)
+        return 2
+
+    before = read_report(argv[1])
+    after = read_report(argv[2])
+    zero = (0, 0, 0)
+
+    rows = []
+    for name in sorted(set(before) | set(after)):
+        old = before.get(name, zero)
+        new = after.get(name, zero)
+        delta = tuple(n - o for o, n in zip(old, new))
+        if delta == zero and name in before and name in after:
+            continue
+        if name not in before:
+            name += ' (added)'
+        elif name not in after:
+            name += ' (removed)'
+        rows.append((delta, new, name))
+
+    rows.sort(key=lambda r: (-abs(r[0][0]), r[2]))
+    header = '%8s %8s %8s  %8s  %s' % ('text', 'data', 'bss', 'new text', 'object')
+    print(header)
+    for delta, new, name in rows:
+        print('%+8d %+8d %+8d  %8d  %s' % (delta + (new[0], name)))
+
+    totals = [sum(s[i] for s in after.values()) - sum(s[i] for s in before.values())
+              for i in range(len(FIELDS))]
+    print('%+8d %+8d %+8d            total (%d objects changed)' % tuple(totals + [len(rows)]))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -72,9 +72,12 @@ static uint8_t u8x8_d_ssd1306_tock(u8x8_t *u8x8,
   return 1;
 }
 
-// Initialize the u8g2 library for Tock use. Call this before using the rest of
-// the library.
-int u8g2_tock_init(u8g2_t *u8g2) {
+// Copy of the screen as last sent, or NULL if changes are not tracked.
+static uint8_t* shadow = NULL;
+// Whether `shadow` matches the screen. Until the first full send it does not.
+static bool shadow_valid = false;
+
+static int tock_setup(u8g2_t *u8g2, uint8_t tile_rows) {
   if (!driver_exists(DRIVER_NUM_SCREEN)) {
     return -1;
   }
@@ -83,17 +86,77 @@ int u8g2_tock_init(u8g2_t *u8g2) {
   // display_info.
   u8g2_SetupDisplay(u8g2, u8x8_d_ssd1306_tock, u8x8_dummy_cb, u8x8_dummy_cb, u8x8_dummy_cb);
 
-  // Allocate the buffer for the screen.
-  size_t screen_bytes = (u8g2_GetU8x8(u8g2)->display_info->pixel_width * u8g2_GetU8x8(u8g2)->display_info->pixel_height) / 8;
-  if (screen_bytes == 0) {
+  uint8_t tile_height = u8g2_GetU8x8(u8g2)->display_info->tile_height;
+  if (tile_rows == 0 || tile_rows > tile_height) {
+    tile_rows = tile_height;
+  }
+
+  // Allocate the buffer for `tile_rows` rows of tiles.
+  size_t buffer_bytes = u8g2_GetU8x8(u8g2)->display_info->tile_width * 8 * tile_rows;
+  if (buffer_bytes == 0) {
+    return -1;
+  }
+  uint8_t* buf = (uint8_t*) calloc(1, buffer_bytes);
+  if (buf == NULL) {
     return -1;
   }
-  uint8_t* buf = (uint8_t*) calloc(1, screen_bytes);
 
   // Setup the u8g2 struct.
-  uint8_t tile_buf_height = u8g2_GetU8x8(u8g2)->display_info->tile_height;
-  u8g2_SetupBuffer(u8g2, buf, tile_buf_height, u8g2_ll_hvline_vertical_top_lsb, U8G2_R0);
+  u8g2_SetupBuffer(u8g2, buf, tile_rows, u8g2_ll_hvline_vertical_top_lsb, U8G2_R0);
+
+  return 0;
+}
+
+// Initialize the u8g2 library for Tock use. Call this before using the rest of
+// the library.
+int u8g2_tock_init(u8g2_t *u8g2) {
+  return tock_setup(u8g2, 0);
+}
+
+// Initialize the u8g2 library with a buffer of `tile_rows` rows of 8 pixels.
+int u8g2_tock_init_pages(u8g2_t *u8g2, uint8_t tile_rows) {
+  return tock_setup(u8g2, tile_rows);
+}
 
+// Keep a copy of the screen and only send the tiles that changed.
+int u8g2_tock_enable_shadow(u8g2_t *u8g2) {
+  if (shadow != NULL) {
+    return 0;
+  }
+
+  u8x8_display_info_t* info = u8g2_GetU8x8(u8g2)->display_info;
+  shadow = (uint8_t*) malloc(info->tile_width * 8 * info->tile_height);
+  if (shadow == NULL) {
+    return -1;
+  }
+  shadow_valid = false;
+  return 0;
+}
+
+// Write tiles in the screen's layout straight from `tiles`, which can be in
+// flash since the kernel only reads them.
+int u8g2_tock_send_tiles(u8g2_t *u8g2, uint8_t tile_x, uint8_t tile_y, uint8_t tile_w, uint8_t tile_h,
+                         const uint8_t* tiles) {
+  u8x8_display_info_t* info = u8g2_GetU8x8(u8g2)->display_info;
+  if (tile_w == 0 || tile_h == 0 || tile_x + tile_w > info->tile_width || tile_y + tile_h > info->tile_height) {
+    return -1;
+  }
+
+  size_t length = (size_t) tile_w * tile_h * 8;
+  if (libtocksync_screen_set_frame(tile_x * 8, tile_y * 8, tile_w * 8, tile_h * 8) != RETURNCODE_SUCCESS) {
+    return -1;
+  }
+  if (libtocksync_screen_write((uint8_t*) tiles, length, length) != RETURNCODE_SUCCESS) {
+    return -1;
+  }
+
+  // Keep the shadow in step, so unchanged tiles of the image are not resent.
+  if (shadow != NULL) {
+    uint16_t row_bytes = info->tile_width * 8;
+    for (uint8_t r = 0; r < tile_h; r++) {
+      memcpy(shadow + (tile_y + r) * row_bytes + tile_x * 8, tiles + r * tile_w * 8, tile_w * 8);
+    }
+  }
   return 0;
 }
 
@@ -106,19 +169,58 @@ void u8g2_ClearBuffer(u8g2_t *u8g2) {
   memset(u8g2->tile_buf_ptr, 0, page_size_bytes(u8g2));
 }
 
-// Send entire buffer via Tock syscalls.
+// Write tiles `first` to `last` of `rows` rows of tiles, the first of which is
+// `tile_row`, from `data`.
+static void send_tiles(u8g2_t *u8g2, uint8_t* data, uint8_t tile_row, uint8_t rows, uint8_t first, uint8_t last) {
+  uint16_t row_bytes = u8g2_GetU8x8(u8g2)->display_info->tile_width * 8;
+  uint8_t* start = data + first * 8;
+  size_t length = (size_t) (rows - 1) * row_bytes + (last - first + 1) * 8;
+
+  libtocksync_screen_set_frame(first * 8, tile_row * 8, (last - first + 1) * 8, rows * 8);
+  libtocksync_screen_write(start, length, length);
+}
+
+// Send the rows of tiles in the buffer via Tock syscalls. With a shadow copy,
+// only the changed tiles of each row are sent.
 void u8g2_SendBuffer(u8g2_t *u8g2) {
+  u8x8_display_info_t* info = u8g2_GetU8x8(u8g2)->display_info;
+  uint8_t tile_row = u8g2->tile_curr_row;
+  uint8_t rows = u8g2->tile_buf_height;
+  if (tile_row + rows > info->tile_height) {
+    rows = info->tile_height - tile_row;
+  }
+  uint16_t row_bytes = info->tile_width * 8;
 
-  // Set the frame to the entire region.
-  uint16_t width = u8g2_GetU8x8(u8g2)->display_info->pixel_width;
-  uint16_t height = u8g2_GetU8x8(u8g2)->display_info->pixel_height;
-  libtocksync_screen_set_frame(0, 0, width, height);
+  if (shadow == NULL || !shadow_valid) {
+    // Set the frame to the rows in the buffer and write them.
+    send_tiles(u8g2, u8g2->tile_buf_ptr, tile_row, rows, 0, info->tile_width - 1);
+    if (shadow != NULL) {
+      memcpy(shadow + tile_row * row_bytes, u8g2->tile_buf_ptr, rows * row_bytes);
+      // The whole screen is known once the last page was sent.
+      shadow_valid = tile_row + rows == info->tile_height;
+    }
+    return;
+  }
 
-  // Write the data to the screen.
-  libtocksync_screen_write(u8g2->tile_buf_ptr, page_size_bytes(u8g2), page_size_bytes(u8g2));
-}
+  for (uint8_t r = 0; r < rows; r++) {
+    uint8_t* now = u8g2->tile_buf_ptr + r * row_bytes;
+    uint8_t* was = shadow + (tile_row + r) * row_bytes;
 
+    int first = -1, last = -1;
+    for (int t = 0; t < info->tile_width; t++) {
+      if (memcmp(now + t * 8, was + t * 8, 8) != 0) {
+        if (first < 0) first = t;
+        last = t;
+      }
+    }
+    if (first < 0) {
+      continue;
+    }
 
+    send_tiles(u8g2, now, tile_row + r, 1, first, last);
+    memcpy(was + first * 8, now + first * 8, (last - first + 1) * 8);
+  }
+}
 
 void u8g2_SetBufferCurrTileRow(u8g2_t *u8g2, uint8_t row)
 {
@@ -5,3 +5,25 @@
 // Call in the app that uses the u8g2 library to initialize the library and the
 // u8g2_t object.
 int u8g2_tock_init(u8g2_t *u8g2);
+
+// Like `u8g2_tock_init()`, but with a buffer of only `tile_rows` rows of 8
+// pixels. Draw with the `u8g2_FirstPage()`/`u8g2_NextPage()` loop, which
+// renders and sends the screen one page at a time.
+int u8g2_tock_init_pages(u8g2_t *u8g2, uint8_t tile_rows);
+
+// Keep a copy of what was sent, the size of the full screen, and only send the
+// tiles that changed since. Useful for mostly static screens.
+int u8g2_tock_enable_shadow(u8g2_t *u8g2);
+
+// Write `tile_w` by `tile_h` tiles of 8x8 pixels from `tiles` to the screen,
+// starting at tile column `tile_x` and row `tile_y`, bypassing the u8g2
+// buffer.
+//
+// `tiles` holds the tiles row by row in the screen's layout: one byte per
+// column of 8 pixels, least significant bit on top. `xbm2tiles.py` converts
+// XBM images to this layout. As the kernel reads `tiles` in place, a `const`
+// image stays in flash and costs neither RAM nor a per-pixel copy, which suits
+// splash screens and icons. The u8g2 buffer is not changed, so a later
+// `u8g2_SendBuffer()` of the same rows draws over the image.
+int u8g2_tock_send_tiles(u8g2_t *u8g2, uint8_t tile_x, uint8_t tile_y, uint8_t tile_w, uint8_t tile_h,
+                         const uint8_t* tiles);
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Convert an XBM image to tiles for `u8g2_tock_send_tiles()`.
+
+XBM stores rows of pixels, eight to a byte with the leftmost pixel in the
+least significant bit. Tock's monochrome screens take tiles of 8x8 pixels,
+one byte per column with the top pixel in the least significant bit, row of
+tiles by row of tiles. The image is padded with unset pixels to whole tiles.
+
+Prints a C header declaring `const uint8_t <name>_tiles[]`, which stays in
+flash, and `<NAME>_TILE_WIDTH` and `<NAME>_TILE_HEIGHT`.
+
+Usage:
+
+    xbm2tiles.py IMAGE.xbm [NAME] > IMAGE_tiles.h
+"""
+
+import os
+import re
+import sys
+
+
+def read_xbm(path):
+    with open(path) as f:
+        text = f.read()
+    width = int(re.search(r'_width\s+(\d+)', text).group(1))
+    height = int(re.search(r'_height\s+(\d+)', text).group(1))
+    body = text[text.index('{') + 1:text.rindex('}')]
+    data = [int(v, 16) for v in re.findall(r'0[xX][0-9a-fA-F]+', body)]
+
+    stride = (width + 7) // 8
+    if len(data) < stride * height:
+        sys.exit('{}: expected {} bytes, found {}'.format(path, stride * height, len(data)))
+
+    def pixel(x, y):
+        if x >= width or y >= height:
+            return 0
+        return (data[y * stride + x // 8] >> (x % 8)) & 1
+
+    return width, height, pixel
+
+
+def main(argv):
+    if not 1 <= len(argv) <= 2:
+        sys.exit(__doc__)
+    path = argv[0]
+    name = argv[1] if len(argv) == 2 else re.sub(r'\W', '_', os.path.splitext(os.path.basename(path))[0])
+
+    width, height, pixel = read_xbm(path)
+    tile_w = (width + 7) // 8
+    tile_h = (height + 7) // 8
+
+    tiles = []
+    for ty in range(tile_h):
+        for x in range(tile_w * 8):
+            tiles.append(sum(pixel(x, ty * 8 + b) << b for b in range(8)))
+
+    print('// Generated by xbm2tiles.py from {}, do not edit.'.format(os.path.basename(path)))
+    print()
+    print('#pragma once')
+    print()
+    print('#include <stdint.h>')
+    print()
+    print('#define {}_TILE_WIDTH {}'.format(name.upper(), tile_w))
+    print('#define {}_TILE_HEIGHT {}'.format(name.upper(), tile_h))
+    print()
+    print('static const uint8_t {}_tiles[] = {{'.format(name))
+    for start in range(0, len(tiles), 12):
+        print('  ' + ' '.join('0x{:02x},'.format(b) for b in tiles[start:start + 12]))
+    print('};')
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])